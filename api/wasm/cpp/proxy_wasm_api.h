@@ -68,6 +68,7 @@ public:
   StringView view() { return {data_, size_}; }
   std::string toString() { return std::string(view()); }
   std::vector<std::pair<StringView, StringView>> pairs();
+  std::vector<StringView> list();
   template<typename T> T proto() {
     T p;
     p.ParseFromArray(data_, size_);
@@ -83,6 +84,24 @@ private:
 };
 typedef std::unique_ptr<WasmData> WasmDataPtr;
 
+inline std::vector<StringView> WasmData::list() {
+  std::vector<StringView> result;
+  if (!data())
+    return result;
+  auto p = data();
+  int n = *reinterpret_cast<const int*>(p);
+  p += sizeof(int);
+  result.resize(n);
+  auto s = p + n * 4;
+  for (int i = 0; i < n; i++) {
+    int size = *reinterpret_cast<const int*>(p);
+    p += sizeof(int);
+    result[i] = StringView(s, size);
+    s += size + 1;
+  }
+  return result;
+}
+
 inline std::vector<std::pair<StringView, StringView>> WasmData::pairs() {
   std::vector<std::pair<StringView, StringView>> result;
   if (!data())
@@ -304,6 +323,8 @@ public:
   virtual void onStart(WasmDataPtr /* vm_configuration */) {}
   // Called when the timer goes off.
   virtual void onTick() {}
+  // Called with the log records of a batching access log: a list of records, each a list of pairs.
+  virtual void onLogBatch(std::unique_ptr<WasmData> /* records */) {}
   // Called when data arrives on a SharedQueue.
   virtual void onQueueReady(uint32_t /* token */) {}
 
@@ -388,6 +409,10 @@ public:
   virtual void onDone() {}  // Called when the stream has completed.
   virtual void onLog() {}  // Called after onDone when logging is requested.
   virtual void onDelete() {}  // Called to indicate that no more calls will come and this context is being deleted.
+  // Called instead of onDelete when the host reuses this context for a new stream, which is then
+  // started with onCreate as usual. Return true after resetting all of the per-stream state, or
+  // false to have the context deleted.
+  virtual bool onReset() { return false; }
 
   // Metadata
   bool isImmutable(MetadataType type);
@@ -890,6 +915,15 @@ inline WasmResult dequeueSharedQueue(uint32_t token, WasmDataPtr* data) {
   return result;
 }
 
+// The entries are available via WasmData::list().
+inline WasmResult dequeueSharedQueueBatch(uint32_t token, uint32_t max_entries, WasmDataPtr* data) {
+  const char* data_ptr = nullptr;
+  size_t data_size = 0;
+  auto result = proxy_dequeueSharedQueueBatch(token, max_entries, &data_ptr, &data_size);
+  *data = std::make_unique<WasmData>(data_ptr, data_size);
+  return result;
+}
+
 // Headers/Trailers
 inline WasmResult addHeaderMapValue(HeaderMapType type, StringView key, StringView value) {
   return proxy_addHeaderMapValue(type, key.data(), key.size(), value.data(), value.size());
@@ -928,6 +962,22 @@ inline WasmResult getHeaderMapSize(HeaderMapType type, size_t* size) {
   return proxy_getHeaderMapSize(type, size);
 }
 
+inline WasmResult getHeaderMapPairByIndex(HeaderMapType type, uint32_t index, WasmDataPtr* key,
+                                          WasmDataPtr* value) {
+  const char* key_ptr = nullptr;
+  size_t key_size = 0;
+  const char* value_ptr = nullptr;
+  size_t value_size = 0;
+  auto result =
+      proxy_getHeaderMapPairByIndex(type, index, &key_ptr, &key_size, &value_ptr, &value_size);
+  if (result != WasmResult::Ok) {
+    return result;
+  }
+  *key = std::make_unique<WasmData>(key_ptr, key_size);
+  *value = std::make_unique<WasmData>(value_ptr, value_size);
+  return WasmResult::Ok;
+}
+
 inline void addRequestHeader(StringView key, StringView value) {
   addHeaderMapValue(HeaderMapType::RequestHeaders, key, value);
 }
@@ -949,6 +999,10 @@ inline void setRequestHeaderPairs(const HeaderStringPairs &pairs) {
 inline WasmResult getRequestHeaderSize(size_t* size) {
   return getHeaderMapSize(HeaderMapType::RequestHeaders, size);
 }
+inline WasmResult getRequestHeaderPairByIndex(uint32_t index, WasmDataPtr* key,
+                                              WasmDataPtr* value) {
+  return getHeaderMapPairByIndex(HeaderMapType::RequestHeaders, index, key, value);
+}
 
 inline void addRequestTrailer(StringView key, StringView value) {
   addHeaderMapValue(HeaderMapType::RequestTrailers, key, value);
@@ -993,6 +1047,10 @@ inline void setResponseHeaderPairs(const HeaderStringPairs &pairs) {
 inline WasmResult getResponseHeaderSize(size_t* size) {
   return getHeaderMapSize(HeaderMapType::ResponseHeaders, size);
 }
+inline WasmResult getResponseHeaderPairByIndex(uint32_t index, WasmDataPtr* key,
+                                               WasmDataPtr* value) {
+  return getHeaderMapPairByIndex(HeaderMapType::ResponseHeaders, index, key, value);
+}
 
 inline void addResponseTrailer(StringView key, StringView value) {
   addHeaderMapValue(HeaderMapType::ResponseTrailers, key, value);
@@ -1031,6 +1089,22 @@ inline WasmDataPtr getResponseBodyBufferBytes(size_t start, size_t length) {
   return std::make_unique<WasmData>(ptr, size);
 }
 
+inline WasmResult getBodyBufferSlice(BodyBufferType type, uint32_t index, WasmDataPtr* slice) {
+  const char* ptr = nullptr;
+  size_t size = 0;
+  auto result = proxy_getBodyBufferSlice(type, index, &ptr, &size);
+  if (result != WasmResult::Ok) {
+    return result;
+  }
+  *slice = std::make_unique<WasmData>(ptr, size);
+  return WasmResult::Ok;
+}
+
+inline WasmResult setBodyBufferBytes(BodyBufferType type, size_t start, size_t length,
+                                     StringView data) {
+  return proxy_setBodyBufferBytes(type, start, length, data.data(), data.size());
+}
+
 // HTTP
 
 inline void MakeHeaderStringPairsBuffer(const HeaderStringPairs& headers, void** buffer_ptr,
@@ -1675,3 +1749,43 @@ inline uint64_t getCurrentTimeNanoseconds() {
   CHECK_RESULT(proxy_getCurrentTimeNanoseconds(&t));
   return t;
 }
+
+// Batched host calls. Queues several low-level calls and issues them with a single
+// proxy_callBatch() so that only one VM transition is made. Arguments are those of the
+// corresponding proxy_* call, with pointers passed as integers. e.g.
+//
+//   BatchCalls batch;
+//   batch.add(BatchCall::GetHeaderMapValue, {static_cast<uint64_t>(HeaderMapType::RequestHeaders),
+//       reinterpret_cast<uintptr_t>(key.data()), key.size(),
+//       reinterpret_cast<uintptr_t>(&value_ptr), reinterpret_cast<uintptr_t>(&value_size)});
+//   batch.add(BatchCall::IncrementMetric, {metric_id, 1});
+//   CHECK_RESULT(batch.run());
+//   if (batch.result(0) == WasmResult::Ok) ...
+class BatchCalls {
+public:
+  // Returns the index of the call's result.
+  size_t add(BatchCall call, std::initializer_list<uint64_t> args) {
+    uint32_t header[2] = {static_cast<uint32_t>(call), static_cast<uint32_t>(args.size())};
+    batch_.append(reinterpret_cast<const char*>(header), sizeof(header));
+    for (auto arg : args) {
+      batch_.append(reinterpret_cast<const char*>(&arg), sizeof(arg));
+    }
+    results_.push_back(WasmResult::Ok);
+    return results_.size() - 1;
+  }
+  // Run all queued calls. The individual results are available via result() until the next run().
+  WasmResult run() {
+    auto result = proxy_callBatch(batch_.data(), batch_.size(), results_.data(), results_.size());
+    batch_.clear();
+    last_results_.swap(results_);
+    results_.clear();
+    return result;
+  }
+  WasmResult result(size_t index) const { return last_results_[index]; }
+  size_t size() const { return last_results_.size(); }
+
+private:
+  std::string batch_;
+  std::vector<WasmResult> results_;
+  std::vector<WasmResult> last_results_;
+};
@@ -17,6 +17,8 @@
      uint32_t vm_configuration_ptr, uint32_t vm_configuration_size);
    extern "C" EMSCRIPTEN_KEEPALIVE void proxy_onConfigure(uint32_t root_context_id, uint32_t configuration_ptr, uint32_t configuration_size);
    extern "C" EMSCRIPTEN_KEEPALIVE void proxy_onTick(uint32_t root_context_id);
+   // The log records of a batching access log.
+   extern "C" EMSCRIPTEN_KEEPALIVE void proxy_onLogBatch(uint32_t root_context_id, uint32_t records_ptr, uint32_t records_size);
    extern "C" EMSCRIPTEN_KEEPALIVE void proxy_onQueueReady(uint32_t root_context_id, uint32_t token);
 
    // Stream calls.
@@ -37,6 +39,9 @@
    extern "C" EMSCRIPTEN_KEEPALIVE void proxy_onLog(uint32_t context_id);
    // The Context in the proxy has been destroyed and no further calls will be coming.
    extern "C" ENSCRIPTEN_KEEPALIVE void proxy_onDelete(uint32_t context_id);
+   // Instead of onDelete, the Context in the proxy is kept for a new stream which will start with
+   // onCreate. Returns 0 if the context was not reset, in which case onDelete follows.
+   extern "C" EMSCRIPTEN_KEEPALIVE uint32_t proxy_onReset(uint32_t context_id);
    extern "C" EMSCRIPTEN_KEEPALIVE proxy_onGrpcCreateInitialMetadata(uint32_t context_id, uint32_t token);
    extern "C" EMSCRIPTEN_KEEPALIVE proxy_onGrpcReceiveInitialMetadata(uint32_t context_id, uint32_t token);
    extern "C" EMSCRIPTEN_KEEPALIVE proxy_onGrpcTrailingMetadata(uint32_t context_id, uint32_t token);
@@ -54,6 +59,11 @@
 // Logging
 extern "C" WasmResult proxy_log(LogLevel level, const char* logMessage, size_t messageSize);
 
+// Batched calls. Runs a sequence of the calls in BatchCall with a single VM transition. The batch
+// is a sequence of records: uint32_t call, uint32_t argument count, uint64_t args[count]. One
+// WasmResult per call is written to results_ptr, which must have room for exactly that many.
+extern "C" WasmResult proxy_callBatch(const char* batch_ptr, size_t batch_size, WasmResult* results_ptr, size_t results_count);
+
 // Timer (must be called from a root context, e.g. onStart, onTick).
 extern "C" WasmResult proxy_setTickPeriodMilliseconds(uint32_t millisecond);
 
@@ -105,7 +115,12 @@ extern "C" WasmResult proxy_registerSharedQueue(const char* queue_name_ptr, size
 extern "C" WasmResult proxy_resolveSharedQueue(const char* vm_id, size_t vm_id_size, const char* queue_name_ptr, size_t queue_name_size, uint32_t* token);
 // Returns Ok, Empty, NotFound (token not registered).
 extern "C" WasmResult proxy_dequeueSharedQueue(uint32_t token, const char** data_ptr, size_t* data_size);
-// Returns false if the queue was not found and the data was not enqueued.
+// Dequeue up to max_entries entries in one call. The entries are returned serialized as the number
+// of entries, followed by the size of each entry, followed by the null terminated entries.
+// Returns Ok, Empty, NotFound (token not registered).
+extern "C" WasmResult proxy_dequeueSharedQueueBatch(uint32_t token, uint32_t max_entries, const char** data_ptr, size_t* data_size);
+// Returns Ok, NotFound (token not registered), Full (the queue is full and its overflow policy
+// drops the newest entries).
 extern "C" WasmResult proxy_enqueueSharedQueue(uint32_t token, const char* data_ptr, size_t data_size);
 
 // Headers/Trailers/Metadata Maps
@@ -116,12 +131,21 @@ extern "C" WasmResult proxy_setHeaderMapPairs(HeaderMapType type, const char* pt
 extern "C" WasmResult proxy_replaceHeaderMapValue(HeaderMapType type, const char* key_ptr, size_t key_size, const char* value_ptr, size_t value_size);
 extern "C" WasmResult proxy_removeHeaderMapValue(HeaderMapType type, const char* key_ptr, size_t key_size);
 extern "C" WasmResult proxy_getHeaderMapSize(HeaderMapType type, size_t* size);
+// Returns the key and value of the index-th entry of the map, NotFound if index is past the end.
+// Unlike proxy_getHeaderMapPairs only the requested entry is copied into the VM.
+extern "C" WasmResult proxy_getHeaderMapPairByIndex(HeaderMapType type, uint32_t index, const char** key_ptr, size_t* key_size, const char** value_ptr, size_t* value_size);
 
 // Body
 extern "C" WasmResult proxy_getRequestBodyBufferBytes(uint32_t start, uint32_t length, const char** ptr,
                                                 size_t* size);
 extern "C" WasmResult proxy_getResponseBodyBufferBytes(uint32_t start, uint32_t length, const char** ptr,
                                                  size_t* size);
+// Returns the index-th slice of the body buffer without linearizing it, NotFound past the last
+// slice. Iterating from index 0 visits the whole body one slice at a time.
+extern "C" WasmResult proxy_getBodyBufferSlice(BodyBufferType type, uint32_t index, const char** ptr, size_t* size);
+// Replaces length bytes at start with the given data. A length of 0 inserts the data, so start == 0
+// prepends and start == body_buffer_length appends. Returns BadArgument if the range is past the end.
+extern "C" WasmResult proxy_setBodyBufferBytes(BodyBufferType type, uint32_t start, uint32_t length, const char* data_ptr, size_t data_size);
 
 // HTTP
 // Returns token, used in callback onHttpCallResponse
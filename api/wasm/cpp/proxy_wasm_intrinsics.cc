@@ -109,6 +109,10 @@ extern "C" EMSCRIPTEN_KEEPALIVE void proxy_onConfigure(uint32_t root_context_id,
 
 extern "C" EMSCRIPTEN_KEEPALIVE void proxy_onTick(uint32_t root_context_id) { getRootContext(root_context_id)->onTick(); }
 
+extern "C" EMSCRIPTEN_KEEPALIVE void proxy_onLogBatch(uint32_t root_context_id, uint32_t ptr, uint32_t size) {
+  getRootContext(root_context_id)->onLogBatch(std::make_unique<WasmData>(reinterpret_cast<char*>(ptr), size));
+}
+
 extern "C" EMSCRIPTEN_KEEPALIVE void proxy_onCreate(uint32_t context_id, uint32_t root_context_id) {
   ensureContext(context_id, root_context_id)->onCreate();
 }
@@ -162,6 +166,10 @@ extern "C" EMSCRIPTEN_KEEPALIVE void proxy_onDelete(uint32_t context_id) {
   context_map.erase(context_id);
 }
 
+extern "C" EMSCRIPTEN_KEEPALIVE uint32_t proxy_onReset(uint32_t context_id) {
+  return getContext(context_id)->onReset() ? 1 : 0;
+}
+
 extern "C" EMSCRIPTEN_KEEPALIVE void
 proxy_onHttpCallResponse(uint32_t context_id, uint32_t token, uint32_t header_pairs_ptr,
                          uint32_t header_pairs_size, uint32_t body_ptr, uint32_t body_size,
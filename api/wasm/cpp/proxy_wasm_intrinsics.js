@@ -1,5 +1,6 @@
 mergeInto(LibraryManager.library, {
     proxy_log: function () {},
+    proxy_callBatch: function () {},
     proxy_setTickPeriodMilliseconds: function () {},
     proxy_getCurrentTimeNanoseconds: function() {},
     proxy_getProtocol: function () {},
@@ -17,12 +18,16 @@ mergeInto(LibraryManager.library, {
     proxy_getHeaderMapValue: function () {},
     proxy_getHeaderMapPairs: function () {},
     proxy_getHeaderMapSize: function () {},
+    proxy_getHeaderMapPairByIndex: function () {},
+    proxy_getBodyBufferSlice: function () {},
+    proxy_setBodyBufferBytes: function () {},
     proxy_getSharedData: function () {},
     proxy_setSharedData: function () {},
     proxy_registerSharedQueue: function () {},
     proxy_resolveSharedQueue: function () {},
     proxy_enqueueSharedQueue: function () {},
     proxy_dequeueSharedQueue: function () {},
+    proxy_dequeueSharedQueueBatch: function () {},
     proxy_replaceHeaderMapValue: function () {},
     proxy_removeHeaderMapValue: function () {},
     proxy_getRequestBodyBufferBytes: function () {},
@@ -45,6 +45,29 @@ enum class HeaderMapType : int32_t {
   MAX = 6,
 };
 
+enum class BodyBufferType : int32_t {
+  RequestBody = 0,  // Only available during the onRequestBody callback
+  ResponseBody = 1,  // Only available during the onResponseBody callback
+  MAX = 1,
+};
+
+// Calls which may be issued via proxy_callBatch. The arguments are those of the corresponding
+// proxy_* call.
+enum class BatchCall : int32_t {
+  GetHeaderMapValue = 0,
+  GetHeaderMapPairs = 1,
+  GetHeaderMapPairByIndex = 2,
+  AddHeaderMapValue = 3,
+  ReplaceHeaderMapValue = 4,
+  RemoveHeaderMapValue = 5,
+  GetMetadata = 6,
+  GetSharedData = 7,
+  IncrementMetric = 8,
+  RecordMetric = 9,
+  GetMetric = 10,
+  MAX = 10,
+};
+
 enum class PluginDirection : int32_t {
   Unspecified = 0,
   Inbound = 1,
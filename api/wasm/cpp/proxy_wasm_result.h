@@ -27,6 +27,8 @@ enum class WasmResult : uint32_t {
   CasMismatch = 8,
   // Returned result was unexpected, e.g. of the incorrect size.
   ResultMismatch = 9,
+  // Data could not be added to a full container, e.g. a bounded shared queue.
+  Full = 10,
 };
 
 inline std::string toString(WasmResult r) {
@@ -41,5 +43,6 @@ inline std::string toString(WasmResult r) {
     case WasmResult::Empty : return "Empty";
     case WasmResult::CasMismatch : return "CasMismatch";
     case WasmResult::ResultMismatch : return "ResultMismatch";
+    case WasmResult::Full : return "Full";
   }
 }
@@ -156,7 +156,7 @@ def envoy_dependencies(skip_targets = []):
     _com_lightstep_tracer_cpp()
     _io_opentracing_cpp()
     _net_zlib()
-    _repository_impl("com_googlesource_code_re2")
+    _com_googlesource_code_re2()
     _com_google_cel_cpp()
     _repository_impl("bazel_toolchains")
 
@@ -320,6 +320,13 @@ def _net_zlib():
         actual = "@envoy//bazel/foreign_cc:zlib",
     )
 
+def _com_googlesource_code_re2():
+    _repository_impl("com_googlesource_code_re2")
+    native.bind(
+        name = "re2",
+        actual = "@com_googlesource_code_re2//:re2",
+    )
+
 def _com_google_cel_cpp():
     _repository_impl("com_google_cel_cpp")
 
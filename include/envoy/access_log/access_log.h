@@ -111,6 +111,20 @@ public:
                              const Http::HeaderMap& response_headers,
                              const Http::HeaderMap& response_trailers,
                              const StreamInfo::StreamInfo& stream_info) const PURE;
+  /**
+   * Append a formatted access log line to a buffer. This allows a caller that logs many lines to
+   * reuse the buffer, rather than allocating a string per line.
+   * @param request_headers supplies the request headers.
+   * @param response_headers supplies the response headers.
+   * @param response_trailers supplies the response trailers.
+   * @param stream_info supplies the stream info.
+   * @param output supplies the buffer the complete formatted access log line is appended to.
+   */
+  virtual void formatInto(const Http::HeaderMap& request_headers,
+                          const Http::HeaderMap& response_headers,
+                          const Http::HeaderMap& response_trailers,
+                          const StreamInfo::StreamInfo& stream_info,
+                          std::string& output) const PURE;
 };
 
 using FormatterPtr = std::unique_ptr<Formatter>;
@@ -135,6 +149,20 @@ public:
                              const Http::HeaderMap& response_headers,
                              const Http::HeaderMap& response_trailers,
                              const StreamInfo::StreamInfo& stream_info) const PURE;
+  /**
+   * Append a value extracted from the provided headers/trailers/stream to a buffer, without
+   * building an intermediate string where the value allows it.
+   * @param request_headers supplies the request headers.
+   * @param response_headers supplies the response headers.
+   * @param response_trailers supplies the response trailers.
+   * @param stream_info supplies the stream info.
+   * @param output supplies the buffer the value is appended to.
+   */
+  virtual void formatInto(const Http::HeaderMap& request_headers,
+                          const Http::HeaderMap& response_headers,
+                          const Http::HeaderMap& response_trailers,
+                          const StreamInfo::StreamInfo& stream_info,
+                          std::string& output) const PURE;
 };
 
 using FormatterProviderPtr = std::unique_ptr<FormatterProvider>;
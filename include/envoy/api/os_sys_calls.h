@@ -59,6 +59,20 @@ public:
    */
   virtual SysCallSizeResult recvmsg(int sockfd, struct msghdr* msg, int flags) PURE;
 
+  /**
+   * @see recvmmsg (man 2 recvmmsg)
+   * @return rc_ = -1 and errno_ = ENOSYS on platforms which do not support recvmmsg.
+   */
+  virtual SysCallIntResult recvmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                    int flags, struct timespec* timeout) PURE;
+
+  /**
+   * @see sendmmsg (man 2 sendmmsg)
+   * @return rc_ = -1 and errno_ = ENOSYS on platforms which do not support sendmmsg.
+   */
+  virtual SysCallIntResult sendmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                    int flags) PURE;
+
   /**
    * Release all resources allocated for fd.
    * @return zero on success, -1 returned otherwise.
@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "envoy/common/pure.h"
 
@@ -36,6 +38,23 @@ public:
    * v. core clock frequency.
    */
   virtual int64_t lifetimeWaitCycles() const PURE;
+
+  /**
+   * The contention statistics of the mutexes sharing a name.
+   */
+  struct NamedContention {
+    std::string name_;
+    int64_t num_contentions_;
+    int64_t lifetime_wait_cycles_;
+    // The number of contentions by length of wait. The contentions counted at index i waited for
+    // less than 2^(i + 10) cycles, except at the last index, which counts all the longer waits.
+    std::vector<int64_t> wait_cycles_histogram_;
+  };
+
+  /**
+   * @return the contention statistics of the named mutexes, by name.
+   */
+  virtual std::vector<NamedContention> namedContentions() const PURE;
 };
 
 } // namespace Envoy
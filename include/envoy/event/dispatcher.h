@@ -30,8 +30,18 @@ namespace Event {
  */
 // clang-format off
 #define ALL_DISPATCHER_STATS(HISTOGRAM)                                                            \
+  HISTOGRAM(admin_post_delay_us)                                                                   \
+  HISTOGRAM(admin_post_duration_us)                                                                \
+  HISTOGRAM(background_post_delay_us)                                                              \
+  HISTOGRAM(background_post_duration_us)                                                           \
+  HISTOGRAM(callbacks_per_loop)                                                                    \
+  HISTOGRAM(control_plane_post_delay_us)                                                           \
+  HISTOGRAM(control_plane_post_duration_us)                                                        \
+  HISTOGRAM(health_check_post_delay_us)                                                            \
+  HISTOGRAM(health_check_post_duration_us)                                                         \
   HISTOGRAM(loop_duration_us)                                                                      \
-  HISTOGRAM(poll_delay_us)
+  HISTOGRAM(poll_delay_us)                                                                         \
+  HISTOGRAM(timer_delay_us)
 // clang-format on
 
 /**
@@ -46,6 +56,23 @@ struct DispatcherStats {
  */
 using PostCb = std::function<void()>;
 
+/**
+ * The priority of a callback posted to a dispatcher. The pending callbacks of a priority run before
+ * those of the lower priorities, and in the order they were posted within a priority.
+ */
+enum class PostPriority {
+  // Configuration updates, and any work that is not otherwise classified.
+  ControlPlane,
+  // The results of the health checks.
+  HealthCheck,
+  // Admin requests made through the server API rather than the admin listener.
+  Admin,
+  // Housekeeping that can wait, such as releasing the memory of deleted stats.
+  Background,
+};
+
+constexpr size_t NumPostPriorities = static_cast<size_t>(PostPriority::Background) + 1;
+
 /**
  * Abstract event dispatching loop.
  */
@@ -58,6 +85,14 @@ public:
    */
   virtual TimeSource& timeSource() PURE;
 
+  /**
+   * Returns the monotonic time of the time source as of the last time the event loop returned from
+   * polling, that is the time at which the events being handled became ready. It does not read the
+   * clock, and is suited to timestamping the arrival of data, but must not be used to measure the
+   * work done by a callback.
+   */
+  virtual MonotonicTime approximateMonotonicTime() PURE;
+
   /**
    * Initialize stats for this dispatcher. Note that this can't generally be done at construction
    * time, since the main and worker thread dispatchers are constructed before
@@ -152,6 +187,15 @@ public:
    */
   virtual Event::TimerPtr createTimer(TimerCb cb) PURE;
 
+  /**
+   * Allocate a coarse timer, which may fire up to a few milliseconds after its timeout but is
+   * cheaper to arm and disarm than a timer from createTimer(). Intended for timeouts that are
+   * frequently reset and rarely fire, such as idle timeouts. @see Timer for docs on how to use the
+   * timer.
+   * @param cb supplies the callback to invoke when the timer fires.
+   */
+  virtual Event::TimerPtr createCoarseTimer(TimerCb cb) PURE;
+
   /**
    * Submit an item for deferred delete. @see DeferredDeletable.
    */
@@ -178,6 +222,12 @@ public:
    */
   virtual void post(PostCb callback) PURE;
 
+  /**
+   * Post a functor to the dispatcher with a priority, which orders it against the other pending
+   * functors. post(callback) posts with PostPriority::ControlPlane.
+   */
+  virtual void post(PostCb callback, PostPriority priority) PURE;
+
   /**
    * Run the event loop. This will not return until exit() is called either from within a callback
    * or from a different thread.
@@ -212,6 +262,13 @@ public:
    */
   virtual const ScopeTrackedObject* setTrackedObject(const ScopeTrackedObject* object) PURE;
 
+  /**
+   * @return the object currently tracked, @see setTrackedObject(), or nullptr if there is none.
+   * This only reads a pointer, so that it can be called from a signal handler interrupting the
+   * thread of the dispatcher.
+   */
+  virtual const ScopeTrackedObject* trackedObject() const PURE;
+
   /**
    * Validates that an operation is thread-safe with respect to this dispatcher; i.e. that the
    * current thread of execution is on the same thread upon which the dispatcher loop is running.
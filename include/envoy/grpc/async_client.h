@@ -57,6 +57,13 @@ public:
    * stream object and no further callbacks will be invoked.
    */
   virtual void resetStream() PURE;
+
+  /**
+   * @return whether the messages sent on the stream are buffered above the write buffer high
+   *         watermark. Callers producing messages faster than the remote consumes them may use
+   *         this to apply backpressure, e.g. by dropping or delaying messages.
+   */
+  virtual bool isAboveWriteBufferHighWatermark() const PURE;
 };
 
 class RawAsyncRequestCallbacks {
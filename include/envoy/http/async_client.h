@@ -134,6 +134,12 @@ public:
      * Reset the stream.
      */
     virtual void reset() PURE;
+
+    /***
+     * @return whether the data written to the stream is buffered above the upstream write buffer
+     *         high watermark, i.e. whether the caller should hold off writing more.
+     */
+    virtual bool isAboveWriteBufferHighWatermark() const PURE;
   };
 
   virtual ~AsyncClient() = default;
@@ -158,11 +164,15 @@ public:
       send_xff = v;
       return *this;
     }
+    StreamOptions& setBufferLimit(uint32_t v) {
+      buffer_limit = v;
+      return *this;
+    }
 
     // For gmock test
     bool operator==(const StreamOptions& src) const {
       return timeout == src.timeout && buffer_body_for_retry == src.buffer_body_for_retry &&
-             send_xff == src.send_xff;
+             send_xff == src.send_xff && buffer_limit == src.buffer_limit;
     }
 
     // The timeout supplies the stream timeout, measured since when the frame with
@@ -177,6 +187,11 @@ public:
 
     // If true, x-forwarded-for header will be added.
     bool send_xff{true};
+
+    // The buffer_limit supplies the decoder buffer limit of the stream. The router buffers the
+    // request until it can be sent upstream, and the stream reports being above its write buffer
+    // high watermark once more than this is buffered. 0 means no limit.
+    uint32_t buffer_limit{0};
   };
 
   /**
@@ -199,6 +214,10 @@ public:
       StreamOptions::setSendXff(v);
       return *this;
     }
+    RequestOptions& setBufferLimit(uint32_t v) {
+      StreamOptions::setBufferLimit(v);
+      return *this;
+    }
 
     // For gmock test
     bool operator==(const RequestOptions& src) const { return StreamOptions::operator==(src); }
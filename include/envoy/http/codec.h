@@ -231,6 +231,8 @@ struct Http2Settings {
   // TODO(jwfang): support other HTTP/2 settings
   uint32_t hpack_table_size_{DEFAULT_HPACK_TABLE_SIZE};
   uint32_t max_concurrent_streams_{DEFAULT_MAX_CONCURRENT_STREAMS};
+  // The maximum advertised while the server is overloaded, or 0 to keep max_concurrent_streams_.
+  uint32_t overload_max_concurrent_streams_{0};
   uint32_t initial_stream_window_size_{DEFAULT_INITIAL_STREAM_WINDOW_SIZE};
   uint32_t initial_connection_window_size_{DEFAULT_INITIAL_CONNECTION_WINDOW_SIZE};
   bool allow_connect_{DEFAULT_ALLOW_CONNECT};
@@ -389,7 +391,15 @@ public:
 /**
  * A server side HTTP connection.
  */
-class ServerConnection : public virtual Connection {};
+class ServerConnection : public virtual Connection {
+public:
+  /**
+   * Advertise to the client the maximum number of concurrent streams of the overload settings, or
+   * restore the configured maximum. A no-op for the protocols without such a setting.
+   * @param reduce supplies whether to advertise the maximum of the overload settings.
+   */
+  virtual void reduceMaxConcurrentStreams(bool reduce) PURE;
+};
 
 using ServerConnectionPtr = std::unique_ptr<ServerConnection>;
 
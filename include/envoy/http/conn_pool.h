@@ -119,6 +119,14 @@ public:
    */
   virtual Cancellable* newStream(Http::StreamDecoder& response_decoder, Callbacks& callbacks) PURE;
 
+  /**
+   * Open connections ahead of the requests which will use them, as called for by the cluster's
+   * preconnect policy. Pools also do this themselves as requests are made.
+   * @param expected_requests supplies the number of requests expected shortly, in addition to
+   *                          those active or pending on the pool.
+   */
+  virtual void preconnect(uint32_t expected_requests) PURE;
+
   /**
    * @return Upstream::HostDescriptionConstSharedPtr the host for which connections are pooled.
    */
@@ -14,6 +14,8 @@
 #include "common/common/assert.h"
 #include "common/common/hash.h"
 #include "common/common/macros.h"
+#include "common/common/to_lower_table.h"
+#include "common/singleton/const_singleton.h"
 
 #include "absl/strings/string_view.h"
 
@@ -61,7 +63,7 @@ public:
   bool operator<(const LowerCaseString& rhs) const { return string_.compare(rhs.string_) < 0; }
 
 private:
-  void lower() { std::transform(string_.begin(), string_.end(), string_.begin(), tolower); }
+  void lower() { ConstSingleton<ToLowerTable>::get().toLowerCase(string_); }
   bool valid() const { return validHeaderString(string_); }
 
   std::string string_;
@@ -93,6 +93,17 @@ public:
     Stats::Counter* delayed_close_timeouts_;
   };
 
+  /**
+   * Counters updated by the read budget. @see setReadBudget().
+   */
+  struct ReadBudgetStats {
+    // Read events that stopped reading because the budget was used up.
+    Stats::Counter& read_budget_yield_;
+    // Adjustments of the adaptive read size.
+    Stats::Counter& read_size_grow_;
+    Stats::Counter& read_size_shrink_;
+  };
+
   ~Connection() override = default;
 
   /**
@@ -217,6 +228,12 @@ public:
   // TODO(snowp): Remove this in favor of StreamInfo::downstreamSslConnection.
   virtual const Ssl::ConnectionInfo* ssl() const PURE;
 
+  /**
+   * @return the IoHandle of the connection's socket. Callers must not read from or write to it
+   *         while the connection may do so itself.
+   */
+  virtual const IoHandle& ioHandle() const PURE;
+
   /**
    * @return requested server name (e.g. SNI in TLS), if any.
    */
@@ -254,6 +271,17 @@ public:
    */
   virtual uint32_t bufferLimit() const PURE;
 
+  /**
+   * Set a soft limit on the number of bytes read from the socket in a single read event. When the
+   * budget is used up the connection yields to the event loop and resumes reading on a later
+   * iteration, so that a busy connection can not starve the others on the same dispatcher. Setting
+   * a budget also makes the size of each socket read adapt to the connection: it grows while reads
+   * fill it and shrinks while they come back short.
+   * @param bytes supplies the per event budget. 0 disables the budget and the adaptive read size.
+   * @param stats supplies the counters to update. They must outlive the connection.
+   */
+  virtual void setReadBudget(uint32_t bytes, const ReadBudgetStats& stats) PURE;
+
   /**
    * @return boolean telling if the connection's local address has been restored to an original
    *         destination address, rather than the address the connection was accepted at.
@@ -265,6 +293,11 @@ public:
    */
   virtual bool aboveHighWatermark() const PURE;
 
+  /**
+   * @return uint64_t the number of bytes held in the read and write buffers of the connection.
+   */
+  virtual uint64_t bufferedBytes() const PURE;
+
   /**
    * Get the socket options set on this connection.
    */
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/pure.h"
+#include "envoy/network/listen_socket.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * A connection handler that a ConnectionBalancer can hand accepted sockets to. There is one for
+ * each worker listening on a balanced listener.
+ */
+class BalancedConnectionHandler {
+public:
+  virtual ~BalancedConnectionHandler() = default;
+
+  /**
+   * @return uint64_t the number of connections owned by the handler, including sockets that have
+   *         been posted to it but not yet delivered. May be called from any thread.
+   */
+  virtual uint64_t numConnections() const PURE;
+
+  /**
+   * Count a socket that is about to be posted to the handler. May be called from any thread.
+   */
+  virtual void incNumConnections() PURE;
+
+  /**
+   * Post an accepted socket to the handler's worker, where it is processed as if the handler's
+   * own listener had accepted it. The socket is counted by incNumConnections() until it arrives.
+   * @param socket supplies the socket that is moved into the callee.
+   */
+  virtual void post(ConnectionSocketPtr&& socket) PURE;
+};
+
+/**
+ * Picks the worker that should own each connection accepted by a listener, so that long-lived
+ * connections do not stay piled on whichever workers happened to accept them. There is one
+ * balancer per listener shared by all workers, so implementations must be thread safe.
+ */
+class ConnectionBalancer {
+public:
+  virtual ~ConnectionBalancer() = default;
+
+  /**
+   * Register a handler that can be picked by the balancer. Called on the handler's worker.
+   */
+  virtual void registerHandler(BalancedConnectionHandler& handler) PURE;
+
+  /**
+   * Unregister a handler so that it is no longer picked. Called on the handler's worker.
+   */
+  virtual void unregisterHandler(BalancedConnectionHandler& handler) PURE;
+
+  /**
+   * Pick the handler that should own a socket accepted by current_handler. If the returned handler
+   * is not current_handler, its incNumConnections() has been called and the caller must post() the
+   * socket to it.
+   * @param current_handler supplies the handler whose listener accepted the socket.
+   * @return BalancedConnectionHandler& the handler that should own the socket.
+   */
+  virtual BalancedConnectionHandler&
+  pickTargetHandler(BalancedConnectionHandler& current_handler) PURE;
+};
+
+using ConnectionBalancerPtr = std::unique_ptr<ConnectionBalancer>;
+
+} // namespace Network
+} // namespace Envoy
@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "envoy/network/connection.h"
 #include "envoy/network/filter.h"
@@ -12,6 +14,20 @@
 namespace Envoy {
 namespace Network {
 
+/**
+ * The data buffered by a connection owned by a connection handler.
+ */
+struct BufferedConnection {
+  // The id of the connection. @see Connection::id().
+  uint64_t id_;
+  // The name of the listener which accepted the connection.
+  std::string listener_name_;
+  // The remote address of the connection.
+  std::string remote_address_;
+  // The bytes held in the read and write buffers of the connection.
+  uint64_t buffered_bytes_;
+};
+
 /**
  * Abstract connection handler.
  */
@@ -68,6 +84,24 @@ public:
    * after they have been temporarily disabled.
    */
   virtual void enableListeners() PURE;
+
+  /**
+   * Disable reading on all the connections, including the ones accepted later, until
+   * enableConnectionReads() is called. This is used to stop the connections from buffering more
+   * data while the process holds too much of it, and does not stop them from writing.
+   */
+  virtual void disableConnectionReads() PURE;
+
+  /**
+   * Enable reading again on the connections after disableConnectionReads().
+   */
+  virtual void enableConnectionReads() PURE;
+
+  /**
+   * @param limit supplies the maximum number of connections to return.
+   * @return the connections buffering the most data, largest first.
+   */
+  virtual std::vector<BufferedConnection> topBufferedConnections(uint32_t limit) PURE;
 };
 
 using ConnectionHandlerPtr = std::unique_ptr<ConnectionHandler>;
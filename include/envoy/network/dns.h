@@ -36,7 +36,7 @@ struct DnsResponse {
   const std::chrono::seconds ttl_;
 };
 
-enum class DnsLookupFamily { V4Only, V6Only, Auto };
+enum class DnsLookupFamily { V4Only, V6Only, Auto, All };
 
 /**
  * An asynchronous DNS resolver.
@@ -1,12 +1,16 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
+#include "envoy/api/v2/core/base.pb.h"
 #include "envoy/buffer/buffer.h"
 #include "envoy/network/listen_socket.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/upstream/host_description.h"
 
+#include "common/protobuf/protobuf.h"
+
 namespace Envoy {
 
 namespace Event {
@@ -269,6 +273,20 @@ public:
    * @param success boolean telling whether the filter execution was successful or not.
    */
   virtual void continueFilterChain(bool success) PURE;
+
+  /**
+   * @param name the namespace used in the metadata in reverse DNS format, for example:
+   * envoy.test.my_filter.
+   * @param value the struct to set on the namespace. A merge will be performed with new values for
+   * the same key overriding existing. The metadata is set as the dynamic metadata of the
+   * connection created from the socket.
+   */
+  virtual void setDynamicMetadata(const std::string& name, const ProtobufWkt::Struct& value) PURE;
+
+  /**
+   * @return const envoy::api::v2::core::Metadata& the dynamic metadata set by the listener filters.
+   */
+  virtual const envoy::api::v2::core::Metadata& dynamicMetadata() const PURE;
 };
 
 /**
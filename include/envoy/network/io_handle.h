@@ -82,6 +82,24 @@ public:
                                           int flags, const Address::Ip* self_ip,
                                           const Address::Instance& peer_address) PURE;
 
+  /**
+   * Send a batch of datagrams to the same peer with a single system call.
+   * @param datagrams points to one slice per datagram.
+   * @param num_datagrams indicates number of slices |datagrams| contains.
+   * @param flags flags to pass to the underlying sendmmsg function (see man 2 sendmmsg).
+   * @param self_ip is the source address whose port should be ignored. Nullptr
+   *        if caller wants kernel to select source address.
+   * @param peer_address is the destination address.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the number of datagrams sent, which may be fewer than num_datagrams
+   * if the send buffer filled up. If the platform can not send multiple datagrams at once err_
+   * has the error code NoSupport; sendmsg() should be used instead.
+   */
+  virtual Api::IoCallUint64Result sendmmsg(const Buffer::RawSlice* datagrams,
+                                           uint64_t num_datagrams, int flags,
+                                           const Address::Ip* self_ip,
+                                           const Address::Instance& peer_address) PURE;
+
   struct RecvMsgOutput {
     /*
      * @param dropped_packets points to a variable to store how many packets are
@@ -112,6 +130,23 @@ public:
    */
   virtual Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                           uint32_t self_port, RecvMsgOutput& output) PURE;
+
+  /**
+   * Receive up to num_packets messages with a single system call, one into each of the given
+   * slices, and output overflow, source/destination addresses for each.
+   * @param slices points to one receiving buffer per message. The len_ of each slice which
+   * received a message is updated to the size of that message.
+   * @param num_packets indicates number of slices |slices| and of outputs |outputs| contains.
+   * @param self_port the port this handle is assigned to. This is used to populate
+   * local_address because local port can't be retrieved from control message.
+   * @param outputs one output per slice, filled in for each message received.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the number of messages received for success. If the platform can
+   * not receive multiple messages at once err_ has the error code NoSupport; recvmsg() should be
+   * used instead.
+   */
+  virtual Api::IoCallUint64Result recvmmsg(Buffer::RawSlice* slices, uint64_t num_packets,
+                                           uint32_t self_port, RecvMsgOutput* outputs) PURE;
 };
 
 using IoHandlePtr = std::unique_ptr<IoHandle>;
@@ -7,6 +7,7 @@
 #include "envoy/api/io_error.h"
 #include "envoy/common/exception.h"
 #include "envoy/network/connection.h"
+#include "envoy/network/connection_balancer.h"
 #include "envoy/network/listen_socket.h"
 #include "envoy/stats/scope.h"
 
@@ -41,6 +42,14 @@ public:
   virtual Socket& socket() PURE;
   virtual const Socket& socket() const PURE;
 
+  /**
+   * @param worker_index supplies the index of the worker that will listen on the socket.
+   * @return Socket& the socket the worker should listen on. This is socket() unless the listener
+   *         has its own SO_REUSEPORT socket for each worker, in which case socket() is the socket
+   *         of the first worker.
+   */
+  virtual Socket& workerSocket(uint32_t worker_index) PURE;
+
   /**
    * @return bool specifies whether the listener should actually listen on the port.
    *         A listener that doesn't listen on a port can only receive connections
@@ -62,6 +71,13 @@ public:
    */
   virtual uint32_t perConnectionBufferLimitBytes() const PURE;
 
+  /**
+   * @return uint32_t providing a soft limit on the bytes read from each of the listener's
+   *         connections in a single read event. 0 disables the limit. @see
+   *         Connection::setReadBudget().
+   */
+  virtual uint32_t perConnectionReadBudgetBytes() const PURE;
+
   /**
    * @return std::chrono::milliseconds the time to wait for all listener filters to complete
    *         operation. If the timeout is reached, the accepted socket is closed without a
@@ -81,6 +97,12 @@ public:
    */
   virtual Stats::Scope& listenerScope() PURE;
 
+  /**
+   * @return ConnectionBalancer& the balancer that picks the worker which owns each accepted
+   *         connection.
+   */
+  virtual ConnectionBalancer& connectionBalancer() PURE;
+
   /**
    * @return uint64_t the tag the listener should use for connection handler tracking.
    */
@@ -149,6 +171,18 @@ struct UdpSendData {
   Buffer::Instance& buffer_;
 };
 
+/**
+ * Encapsulates the information needed to send a batch of udp packets to a target.
+ */
+struct UdpSendBatchData {
+  const Address::Ip* local_ip_;
+  const Address::Instance& peer_address_;
+
+  // One slice per packet.
+  const Buffer::RawSlice* packets_;
+  uint64_t num_packets_;
+};
+
 /**
  * UDP listener callbacks.
  */
@@ -233,6 +267,17 @@ public:
    * sender.
    */
   virtual Api::IoCallUint64Result send(const UdpSendData& data) PURE;
+
+  /**
+   * Send a batch of packets to the same target through the underlying udp socket, with as few
+   * system calls as the platform allows. Sending stops at the first error, such as the send
+   * buffer of the socket FD being full.
+   *
+   * @param data Supplies the packets to send and their target.
+   * @return the error code of the underlying send api, if any. rc_ is the number of packets sent,
+   * also when an error is returned. The remaining packets can be retried by the sender.
+   */
+  virtual Api::IoCallUint64Result sendBatch(const UdpSendBatchData& data) PURE;
 };
 
 /**
@@ -75,6 +75,12 @@ public:
    */
   virtual void setReadBufferReady() PURE;
 
+  /**
+   * @return uint64_t the number of bytes the transport socket should request from each read of the
+   *         underlying socket.
+   */
+  virtual uint64_t readSizeHint() PURE;
+
   /**
    * Raise a connection event to the connection. This can be used by a secure socket (e.g. TLS)
    * to raise a connected event when handshake is done.
@@ -203,6 +209,7 @@ public:
 };
 
 using TransportSocketFactoryPtr = std::unique_ptr<TransportSocketFactory>;
+using TransportSocketFactorySharedPtr = std::shared_ptr<TransportSocketFactory>;
 
 } // namespace Network
 } // namespace Envoy
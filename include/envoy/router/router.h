@@ -110,6 +110,18 @@ public:
    */
   virtual const std::list<std::regex>& allowOriginRegexes() const PURE;
 
+  /**
+   * @param origin supplies the origin of a request.
+   * @return bool whether the origin is one of allowOrigins(), or any origin if they include "*".
+   */
+  virtual bool allowOriginsContain(absl::string_view origin) const PURE;
+
+  /**
+   * @param origin supplies the origin of a request.
+   * @return bool whether the origin matches one of allowOriginRegexes().
+   */
+  virtual bool allowOriginRegexesMatch(absl::string_view origin) const PURE;
+
   /**
    * @return std::string access-control-allow-methods value.
    */
@@ -350,6 +362,12 @@ public:
    *         present.
    */
   virtual const envoy::type::FractionalPercent& defaultValue() const PURE;
+
+  /**
+   * @return whether the request should be shadowed as it arrives rather than once it has been
+   *         received in full.
+   */
+  virtual bool streamBody() const PURE;
 };
 
 /**
@@ -367,7 +385,7 @@ public:
 };
 
 class RateLimitPolicy;
-class Config;
+class CommonConfig;
 
 /**
  * All route specific config returned by the method at
@@ -403,9 +421,11 @@ public:
   virtual const RateLimitPolicy& rateLimitPolicy() const PURE;
 
   /**
-   * @return const Config& the RouteConfiguration that owns this virtual host.
+   * @return const CommonConfig& the part of the RouteConfiguration that owns this virtual host
+   *         which does not depend on its virtual hosts. A virtual host may be shared by successive
+   *         versions of a RouteConfiguration as long as this part does not change.
    */
-  virtual const Config& routeConfig() const PURE;
+  virtual const CommonConfig& routeConfig() const PURE;
 
   /**
    * @return const RouteSpecificFilterConfig* the per-filter config pre-processed object for
@@ -484,6 +504,18 @@ public:
    * will be canceled immediately.
    */
   virtual bool hedgeOnPerTryTimeout() const PURE;
+
+  /**
+   * @return the percentile of the recent response times of the cluster after which a request
+   * which is still waiting for its response headers is hedged, if hedging on latency is enabled.
+   */
+  virtual absl::optional<double> hedgeOnLatencyPercentile() const PURE;
+
+  /**
+   * @return the maximum number of requests hedged on latency, in percent of the requests to the
+   * cluster.
+   */
+  virtual double hedgeBudgetPercent() const PURE;
 };
 
 class MetadataMatchCriterion {
@@ -837,27 +869,36 @@ public:
   template <class Derived> const Derived* perFilterConfigTyped(const std::string& name) const {
     return dynamic_cast<const Derived*>(perFilterConfig(name));
   }
+
+  /**
+   * @param filter_id supplies the id of the name of a filter, as assigned by
+   *        Router::PerFilterConfigIds.
+   * @return const RouteSpecificFilterConfig* the most specific per-filter config of the filter:
+   *         that of the weighted cluster, if any, else that of the route, else that of the virtual
+   *         host, or nullptr if none of them has one. Unlike perFilterConfig(), this does not
+   *         look up the filter name.
+   */
+  virtual const RouteSpecificFilterConfig*
+  mostSpecificPerFilterConfig(uint32_t filter_id) const PURE;
+
+  /**
+   * This is a helper on top of mostSpecificPerFilterConfig() that casts the return object to the
+   * specified type.
+   */
+  template <class Derived>
+  const Derived* mostSpecificPerFilterConfigTyped(uint32_t filter_id) const {
+    return dynamic_cast<const Derived*>(mostSpecificPerFilterConfig(filter_id));
+  }
 };
 
 using RouteConstSharedPtr = std::shared_ptr<const Route>;
 
 /**
- * The router configuration.
+ * The part of the router configuration which does not depend on its virtual hosts.
  */
-class Config {
+class CommonConfig {
 public:
-  virtual ~Config() = default;
-
-  /**
-   * Based on the incoming HTTP request headers, determine the target route (containing either a
-   * route entry or a direct response entry) for the request.
-   * @param headers supplies the request headers.
-   * @param random_value supplies the random seed to use if a runtime choice is required. This
-   *        allows stable choices between calls if desired.
-   * @return the route or nullptr if there is no matching route for the request.
-   */
-  virtual RouteConstSharedPtr route(const Http::HeaderMap& headers,
-                                    uint64_t random_value) const PURE;
+  virtual ~CommonConfig() = default;
 
   /**
    * Return a list of headers that will be cleaned from any requests that are not from an internal
@@ -876,6 +917,23 @@ public:
   virtual bool usesVhds() const PURE;
 };
 
+/**
+ * The router configuration.
+ */
+class Config : public CommonConfig {
+public:
+  /**
+   * Based on the incoming HTTP request headers, determine the target route (containing either a
+   * route entry or a direct response entry) for the request.
+   * @param headers supplies the request headers.
+   * @param random_value supplies the random seed to use if a runtime choice is required. This
+   *        allows stable choices between calls if desired.
+   * @return the route or nullptr if there is no matching route for the request.
+   */
+  virtual RouteConstSharedPtr route(const Http::HeaderMap& headers,
+                                    uint64_t random_value) const PURE;
+};
+
 using ConfigConstSharedPtr = std::shared_ptr<const Config>;
 
 } // namespace Router
@@ -4,15 +4,46 @@
 #include <memory>
 #include <string>
 
+#include "envoy/buffer/buffer.h"
+#include "envoy/http/header_map.h"
 #include "envoy/http/message.h"
 
 namespace Envoy {
 namespace Router {
 
 /**
- * Interface used to shadow complete requests to an alternate upstream cluster in a "fire and
- * forget" fashion. Right now this interface takes a fully buffered request and cannot be used for
- * streaming. This is sufficient for current use cases.
+ * A request being shadowed as it arrives. Destroying the stream before the whole request has been
+ * sent resets the shadow, otherwise the shadow completes on its own.
+ */
+class ShadowStream {
+public:
+  virtual ~ShadowStream() = default;
+
+  /**
+   * Send request body data to the shadow. This is a no-op once the shadow has completed.
+   * @param data supplies the data, which is drained.
+   * @param end_stream supplies whether this is the end of the request.
+   */
+  virtual void sendData(Buffer::Instance& data, bool end_stream) PURE;
+
+  /**
+   * Send the request trailers to the shadow, ending the request.
+   * @param trailers supplies the trailers, which are copied.
+   */
+  virtual void sendTrailers(const Http::HeaderMap& trailers) PURE;
+
+  /**
+   * @return whether the shadow has buffered more of the request than its buffer limit, i.e. it
+   *         is not keeping up with the request.
+   */
+  virtual bool aboveBufferLimit() const PURE;
+};
+
+using ShadowStreamPtr = std::unique_ptr<ShadowStream>;
+
+/**
+ * Interface used to shadow requests to an alternate upstream cluster in a "fire and forget"
+ * fashion, either fully buffered or as they arrive.
  */
 class ShadowWriter {
 public:
@@ -26,6 +57,21 @@ public:
    */
   virtual void shadow(const std::string& cluster, Http::MessagePtr&& request,
                       std::chrono::milliseconds timeout) PURE;
+
+  /**
+   * Start shadowing a request whose body is still arriving.
+   * @param cluster supplies the cluster name to shadow to.
+   * @param headers supplies the request headers.
+   * @param timeout supplies the shadowed request timeout.
+   * @param buffer_limit supplies how much of the request the shadow may buffer, 0 for no limit.
+   * @param end_stream supplies whether the request has no body.
+   * @return the stream to send the rest of the request on, or nullptr if the request cannot be
+   *         shadowed.
+   */
+  virtual ShadowStreamPtr streamingShadow(const std::string& cluster,
+                                          Http::HeaderMapPtr&& headers,
+                                          std::chrono::milliseconds timeout, uint32_t buffer_limit,
+                                          bool end_stream) PURE;
 };
 
 using ShadowWriterPtr = std::unique_ptr<ShadowWriter>;
@@ -44,6 +44,12 @@ public:
 
 using RandomGeneratorPtr = std::unique_ptr<RandomGenerator>;
 
+/**
+ * A runtime key registered ahead of its lookups, which snapshots look up by index rather than by
+ * name. @see common/runtime/runtime_keys.h.
+ */
+class Key;
+
 /**
  * A snapshot of runtime data.
  */
@@ -194,6 +200,19 @@ public:
    */
   virtual uint64_t getInteger(const std::string& key, uint64_t default_value) const PURE;
 
+  /**
+   * The following variants look a registered key up by index, which avoids hashing its name on
+   * hot paths. They are otherwise equivalent to the variants taking the name of the key.
+   */
+  virtual bool featureEnabled(const Key& key, uint64_t default_value) const PURE;
+  virtual bool featureEnabled(const Key& key, uint64_t default_value,
+                              uint64_t random_value) const PURE;
+  virtual bool featureEnabled(const Key& key,
+                              const envoy::type::FractionalPercent& default_value) const PURE;
+  virtual bool featureEnabled(const Key& key, const envoy::type::FractionalPercent& default_value,
+                              uint64_t random_value) const PURE;
+  virtual uint64_t getInteger(const Key& key, uint64_t default_value) const PURE;
+
   /**
    * Fetch the OverrideLayers that provide values in this snapshot. Layers are ordered from bottom
    * to top; for instance, the second layer's entries override the first layer's entries, and so on.
@@ -49,6 +49,23 @@ public:
    * request.
    */
   virtual const Http::HeaderMap& getRequestHeaders() const PURE;
+
+  /**
+   * Callback adding the next chunk of a streamed response body to a buffer.
+   * @return whether more chunks follow.
+   */
+  using ChunkCallback = std::function<bool(Buffer::Instance& chunk)>;
+
+  /**
+   * Streams the rest of the response body in chunks, after what the handler added to its response
+   * buffer. The chunks are produced as the downstream connection drains, each in its own event loop
+   * iteration, so that a large response is neither built in memory at once nor written while
+   * blocking the main thread. Requests not served over a connection, e.g. Admin::request(), get all
+   * the chunks added to the response buffer at once instead.
+   * @param response supplies the response buffer of the handler.
+   * @param next_chunk supplies the callback producing the chunks.
+   */
+  virtual void streamResponse(Buffer::Instance& response, ChunkCallback next_chunk) PURE;
 };
 
 /**
@@ -1,11 +1,29 @@
 #pragma once
 
+#include <chrono>
+#include <string>
+#include <vector>
+
 #include "envoy/common/pure.h"
+#include "envoy/common/time.h"
 #include "envoy/server/watchdog.h"
 
 namespace Envoy {
 namespace Server {
 
+/**
+ * A stall of a watched thread, sampled when it missed the watchdog.
+ */
+struct StallReport {
+  std::string thread_id_;
+  SystemTime time_;
+  std::chrono::milliseconds stalled_for_;
+  // The demangled class of the tracked object of the thread's dispatcher, or empty if none.
+  std::string tracked_object_;
+  // The stack of the thread, innermost frame first.
+  std::vector<std::string> frames_;
+};
+
 /**
  * The GuardDog runs a background thread which scans a number of shared WatchDog
  * objects periodically to verify that they have been recently touched. If some
@@ -38,6 +56,13 @@ public:
    * @param wd A WatchDogSharedPtr obtained from createWatchDog.
    */
   virtual void stopWatching(WatchDogSharedPtr wd) PURE;
+
+  /**
+   * @return the most recent stalls of the watched threads, oldest first. A stall is only sampled
+   *         on the platforms which support interrupting a given thread, and for the threads whose
+   *         WatchDog was started with a dispatcher.
+   */
+  virtual std::vector<StallReport> recentStalls() const PURE;
 };
 
 } // namespace Server
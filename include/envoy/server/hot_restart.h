@@ -5,6 +5,7 @@
 
 #include "envoy/common/pure.h"
 #include "envoy/event/dispatcher.h"
+#include "envoy/ssl/session_cache.h"
 #include "envoy/stats/allocator.h"
 #include "envoy/stats/store.h"
 #include "envoy/thread/thread.h"
@@ -26,6 +27,8 @@ public:
   struct ServerStatsFromParent {
     uint64_t parent_memory_allocated_ = 0;
     uint64_t parent_connections_ = 0;
+    // Whether there was a parent whose stats were merged.
+    bool stats_merged_ = false;
   };
 
   virtual ~HotRestart() = default;
@@ -40,9 +43,11 @@ public:
    * Retrieve a listening socket on the specified address from the parent process. The socket will
    * be duplicated across process boundaries.
    * @param address supplies the address of the socket to duplicate, e.g. tcp://127.0.0.1:5000.
+   * @param worker_index supplies the worker whose socket to duplicate when the listener has a
+   *        socket per worker. 0 for listeners that share one socket.
    * @return int the fd or -1 if there is no bound listen port in the parent.
    */
-  virtual int duplicateParentListenSocket(const std::string& address) PURE;
+  virtual int duplicateParentListenSocket(const std::string& address, uint32_t worker_index) PURE;
 
   /**
    * Initialize the parent logic of our restarter. Meant to be called after initialization of a
@@ -74,6 +79,14 @@ public:
    */
   virtual ServerStatsFromParent mergeParentStatsIfAny(Stats::StoreRoot& stats_store) PURE;
 
+  /**
+   * Retrieve the TLS sessions cached by our parent process and store them in session_cache, so that
+   * the connections made by this process can resume them rather than doing full handshakes.
+   * Does nothing if there is not currently a parent.
+   * @param session_cache the cache the sessions will be stored in.
+   */
+  virtual void importParentTlsSessions(Ssl::SessionCache& session_cache) PURE;
+
   /**
    * Shutdown the half of our hot restarter that acts as a parent.
    */
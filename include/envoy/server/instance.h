@@ -17,6 +17,7 @@
 #include "envoy/secret/secret_manager.h"
 #include "envoy/server/admin.h"
 #include "envoy/server/drain_manager.h"
+#include "envoy/server/guarddog.h"
 #include "envoy/server/hot_restart.h"
 #include "envoy/server/lifecycle_notifier.h"
 #include "envoy/server/listener_manager.h"
@@ -118,6 +119,11 @@ public:
    */
   virtual Envoy::MutexTracer* mutexTracer() PURE;
 
+  /**
+   * @return the server's guard dog, once the server is initialized. Nullptr otherwise.
+   */
+  virtual GuardDog* guardDog() PURE;
+
   /**
    * @return the server's overload manager.
    */
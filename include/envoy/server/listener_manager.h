@@ -1,6 +1,7 @@
 #pragma once
 
 #include "envoy/api/v2/listener/listener.pb.h"
+#include "envoy/network/connection_handler.h"
 #include "envoy/network/filter.h"
 #include "envoy/network/listen_socket.h"
 #include "envoy/network/listener.h"
@@ -54,6 +55,22 @@ public:
                      Network::Address::SocketType socket_type,
                      const Network::Socket::OptionsSharedPtr& options, bool bind_to_port) PURE;
 
+  /**
+   * Creates the socket of one worker of a listener that has a bound SO_REUSEPORT socket per
+   * worker. During a hot restart the socket of the same worker in the parent process is reused.
+   * @param address supplies the socket's address.
+   * @param socket_type the type of socket (stream or datagram) to create.
+   * @param options to be set on the created socket just before calling 'bind()'. They must enable
+   *        SO_REUSEPORT.
+   * @param worker_index supplies the index of the worker the socket is for.
+   * @return Network::SocketSharedPtr an initialized and bound socket.
+   */
+  virtual Network::SocketSharedPtr
+  createReusePortListenSocket(Network::Address::InstanceConstSharedPtr address,
+                              Network::Address::SocketType socket_type,
+                              const Network::Socket::OptionsSharedPtr& options,
+                              uint32_t worker_index) PURE;
+
   /**
    * Creates a list of filter factories.
    * @param filters supplies the proto configuration.
@@ -142,6 +159,15 @@ public:
    */
   virtual uint64_t numConnections() PURE;
 
+  /**
+   * Find the connections buffering the most data across all workers. This waits for the workers
+   * to look up their connections, so it is meant for the admin endpoint rather than the data path.
+   * @param limit supplies the maximum number of connections to return.
+   * @return the connections buffering the most data, largest first. A worker which does not answer
+   *         in time is left out.
+   */
+  virtual std::vector<Network::BufferedConnection> topBufferedConnections(uint32_t limit) PURE;
+
   /**
    * Remove a listener by name.
    * @param name supplies the listener name to remove.
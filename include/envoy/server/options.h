@@ -149,6 +149,12 @@ public:
    */
   virtual std::chrono::milliseconds fileFlushIntervalMsec() const PURE;
 
+  /**
+   * @return uint64_t the maximum number of bytes an access log file buffers before dropping new
+   *         lines, or 0 if it is unlimited.
+   */
+  virtual uint64_t fileMaxBufferedBytes() const PURE;
+
   /**
    * @return const std::string& the server's cluster.
    */
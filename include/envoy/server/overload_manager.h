@@ -1,11 +1,14 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 
+#include "envoy/common/callback.h"
 #include "envoy/common/pure.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/common/callback_impl.h"
 #include "common/common/macros.h"
 #include "common/singleton/const_singleton.h"
 
@@ -44,14 +47,41 @@ public:
   void setState(const std::string& action, OverloadActionState state) {
     auto it = actions_.find(action);
     if (it == actions_.end()) {
-      actions_[action] = state;
-    } else {
-      it->second = state;
+      it = actions_.insert(std::make_pair(action, OverloadActionState::Inactive)).first;
+    }
+    if (it->second == state) {
+      return;
     }
+    it->second = state;
+    auto callbacks = action_callbacks_.find(action);
+    if (callbacks != action_callbacks_.end()) {
+      callbacks->second.runCallbacks(state);
+    }
+  }
+
+  /**
+   * Add a callback run on this thread when the state of an overload action changes. Unlike
+   * OverloadManager::registerForAction(), this can be called once the overload manager started,
+   * e.g. by the objects of a connection.
+   * @param action supplies the name of the overload action.
+   * @param callback supplies the callback to run with the new state of the action.
+   * @return Common::CallbackHandle* the handle to remove the callback with before it is destroyed.
+   */
+  Common::CallbackHandle* addActionCallback(const std::string& action,
+                                            OverloadActionCb callback) {
+    return action_callbacks_[action].add(std::move(callback));
   }
 
+  /**
+   * @return the number of HTTP requests active on the thread, maintained by the HTTP connection
+   *         managers for the resource monitors.
+   */
+  uint64_t& activeRequests() { return active_requests_; }
+
 private:
   std::unordered_map<std::string, OverloadActionState> actions_;
+  std::unordered_map<std::string, Common::CallbackManager<OverloadActionState>> action_callbacks_;
+  uint64_t active_requests_{};
 };
 
 /**
@@ -70,6 +100,24 @@ public:
 
   // Overload action to try to shrink the heap by releasing free memory.
   const std::string ShrinkHeap = "envoy.overload_actions.shrink_heap";
+
+  // Overload action to bypass Wasm HTTP filters on new requests, i.e. to fail open.
+  const std::string DisableWasmPlugins = "envoy.overload_actions.disable_wasm_plugins";
+  // Overload action to lower the number of concurrent TLS handshakes of the listeners limiting
+  // them.
+  const std::string LimitTlsHandshakes = "envoy.overload_actions.limit_tls_handshakes";
+
+  // Overload action to advertise the overload maximum of concurrent streams to HTTP/2 clients.
+  const std::string ReduceHttp2MaxConcurrentStreams =
+      "envoy.overload_actions.reduce_http2_max_concurrent_streams";
+
+  // Overload action to lower the buffer limits of the HTTP connections and streams to their
+  // overload limit, resetting the streams buffering the most data beyond it.
+  const std::string ReduceBufferLimits = "envoy.overload_actions.reduce_buffer_limits";
+
+  // Overload action to stop reading from the downstream connections, so that they do not buffer
+  // more data until the overload subsides.
+  const std::string StopReadingConnections = "envoy.overload_actions.stop_reading_connections";
 };
 
 using OverloadActionNames = ConstSingleton<OverloadActionNameValues>;
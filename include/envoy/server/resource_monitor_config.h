@@ -3,7 +3,9 @@
 #include "envoy/api/api.h"
 #include "envoy/common/pure.h"
 #include "envoy/event/dispatcher.h"
+#include "envoy/server/overload_manager.h"
 #include "envoy/server/resource_monitor.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/protobuf/protobuf.h"
 
@@ -25,6 +27,18 @@ public:
    * @return reference to the Api object
    */
   virtual Api::Api& api() PURE;
+
+  /**
+   * @return ThreadLocal::SlotAllocator& the thread local storage, which the monitors sampling the
+   *         workers post through.
+   */
+  virtual ThreadLocal::SlotAllocator& threadLocal() PURE;
+
+  /**
+   * @return OverloadManager& the overload manager of the monitor, whose thread local state is
+   *         available once it has started.
+   */
+  virtual OverloadManager& overloadManager() PURE;
 };
 
 /**
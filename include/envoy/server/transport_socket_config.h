@@ -8,6 +8,7 @@
 #include "envoy/network/transport_socket.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/secret/secret_manager.h"
+#include "envoy/server/overload_manager.h"
 #include "envoy/singleton/manager.h"
 #include "envoy/ssl/context_manager.h"
 #include "envoy/stats/scope.h"
@@ -104,6 +105,12 @@ public:
    * @return reference to the Api object
    */
   virtual Api::Api& api() PURE;
+
+  /**
+   * @return the server's overload manager, or nullptr if the transport sockets are not those of
+   *         the connections of listeners.
+   */
+  virtual OverloadManager* overloadManager() PURE;
 };
 
 class TransportSocketConfigFactory {
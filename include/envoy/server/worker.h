@@ -1,7 +1,9 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 
+#include "envoy/network/connection_handler.h"
 #include "envoy/server/guarddog.h"
 #include "envoy/server/overload_manager.h"
 
@@ -79,6 +81,21 @@ public:
    * TODO(mattklein123): Same comment about the addition of a completion as stopListener().
    */
   virtual void stopListeners() PURE;
+
+  /**
+   * Completion called with the connections of a worker buffering the most data.
+   */
+  using BufferedConnectionsCompletion =
+      std::function<void(std::vector<Network::BufferedConnection>&& connections)>;
+
+  /**
+   * Find the connections of the worker buffering the most data.
+   * @param limit supplies the maximum number of connections to find.
+   * @param completion supplies the completion called with the connections, largest first. This
+   *        completion is called on the worker thread. No locking is performed by the worker.
+   */
+  virtual void topBufferedConnections(uint32_t limit,
+                                      BufferedConnectionsCompletion completion) PURE;
 };
 
 using WorkerPtr = std::unique_ptr<Worker>;
@@ -91,9 +108,10 @@ public:
   virtual ~WorkerFactory() = default;
 
   /**
+   * @param index supplies the index of the worker among the server's workers.
    * @return WorkerPtr a new worker.
    */
-  virtual WorkerPtr createWorker(OverloadManager& overload_manager) PURE;
+  virtual WorkerPtr createWorker(OverloadManager& overload_manager, uint32_t index) PURE;
 };
 
 } // namespace Server
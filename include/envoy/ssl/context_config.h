@@ -1,17 +1,31 @@
 #pragma once
 
 #include <array>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <vector>
 
 #include "envoy/common/pure.h"
 #include "envoy/ssl/certificate_validation_context_config.h"
+#include "envoy/ssl/private_key_offload.h"
 #include "envoy/ssl/tls_certificate_config.h"
 
 namespace Envoy {
 namespace Ssl {
 
+/**
+ * The sizing of the records written by the connections of a context.
+ */
+struct DynamicRecordSizing {
+  // The plaintext size of the records written until ramp_up_bytes_ are written.
+  uint32_t initial_record_size_;
+  uint64_t ramp_up_bytes_;
+  // Once a connection did not write for that long, its writes start with small records again.
+  std::chrono::milliseconds idle_timeout_;
+};
+
 /**
  * Supplies the configuration for an SSL context.
  */
@@ -58,6 +72,18 @@ public:
    */
   virtual unsigned maxProtocolVersion() const PURE;
 
+  /**
+   * @return whether record encryption should be offloaded to the kernel when the negotiated
+   *         protocol version and cipher allow it.
+   */
+  virtual bool kernelTlsOffload() const PURE;
+
+  /**
+   * @return the sizing of the records written by the connections, or nullptr if they are always
+   *         full-size.
+   */
+  virtual const DynamicRecordSizing* dynamicRecordSizing() const PURE;
+
   /**
    * @return true if the ContextConfig is able to provide secrets to create SSL context,
    * and false if dynamic secrets are expected but are not downloaded from SDS server yet.
@@ -90,6 +116,12 @@ public:
    */
   virtual size_t maxSessionKeys() const PURE;
 
+  /**
+   * @return true if the sessions are stored in the session cache shared by the contexts, so that
+   *         contexts with the same server name and validation settings resume each other's.
+   */
+  virtual bool sharedSessionCache() const PURE;
+
   /**
    * @return const std::string& with the signature algorithms for the context.
    *         This is a :-delimited list of algorithms, see
@@ -120,6 +152,18 @@ public:
    * are candidates for decrypting received tickets.
    */
   virtual const std::vector<SessionTicketKey>& sessionTicketKeys() const PURE;
+
+  /**
+   * @return the pool of threads the private key operations of the handshakes are offloaded to, or
+   *         nullptr if they are run by the workers during the handshakes.
+   */
+  virtual PrivateKeyOffloadPoolSharedPtr privateKeyOffloadPool() const PURE;
+
+  /**
+   * @return true if the sessions resumed by session ID are stored in the session cache shared by
+   *         the contexts rather than in the cache of the context.
+   */
+  virtual bool sharedSessionCache() const PURE;
 };
 
 using ServerContextConfigPtr = std::unique_ptr<ServerContextConfig>;
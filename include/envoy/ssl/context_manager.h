@@ -1,15 +1,30 @@
 #pragma once
 
 #include <functional>
+#include <memory>
+#include <vector>
 
+#include "envoy/api/api.h"
+#include "envoy/api/v2/auth/cert.pb.h"
 #include "envoy/common/time.h"
 #include "envoy/ssl/context.h"
 #include "envoy/ssl/context_config.h"
+#include "envoy/ssl/session_cache.h"
 #include "envoy/stats/scope.h"
 
 namespace Envoy {
 namespace Ssl {
 
+/**
+ * Keeps the data parsed by ContextManager::preloadCertificates() cached until it is destroyed.
+ */
+class CertificatePreload {
+public:
+  virtual ~CertificatePreload() = default;
+};
+
+using CertificatePreloadPtr = std::unique_ptr<CertificatePreload>;
+
 /**
  * Manages all of the SSL contexts in the process
  */
@@ -39,6 +54,31 @@ public:
    * Iterate through all currently allocated contexts.
    */
   virtual void iterateContexts(std::function<void(const Context&)> callback) PURE;
+
+  /**
+   * @return the cache of the sessions of the contexts configured to share them, or nullptr if
+   *         there is none.
+   */
+  virtual SessionCacheSharedPtr sessionCache() PURE;
+
+  /**
+   * Parse the certificate chains, private keys, trusted CAs and CRLs of contexts about to be
+   * created, on several threads, so that the creation of the contexts, which is serial, finds them
+   * already parsed. Data which cannot be read or parsed is skipped: the creation of the contexts
+   * reports the errors.
+   * @param tls_certificates supplies the certificates of the contexts.
+   * @param validation_contexts supplies the validation contexts of the contexts.
+   * @param api supplies the file system the data is read from and the thread factory.
+   * @param max_threads supplies the maximum number of threads parsing the data, including the
+   *        calling thread.
+   * @return a handle keeping the parsed data cached until it is destroyed, or nullptr if there is
+   *         nothing to keep.
+   */
+  virtual CertificatePreloadPtr preloadCertificates(
+      const std::vector<const envoy::api::v2::auth::TlsCertificate*>& tls_certificates,
+      const std::vector<const envoy::api::v2::auth::CertificateValidationContext*>&
+          validation_contexts,
+      Api::Api& api, uint32_t max_threads) PURE;
 };
 
 using ContextManagerPtr = std::unique_ptr<ContextManager>;
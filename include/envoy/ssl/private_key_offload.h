@@ -0,0 +1,29 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Ssl {
+
+/**
+ * A pool of threads running the private key operations of TLS handshakes off the worker threads.
+ */
+class PrivateKeyOffloadPool {
+public:
+  virtual ~PrivateKeyOffloadPool() = default;
+
+  /**
+   * Run an operation on one of the threads of the pool. The operations are run in order, as
+   * threads become available. Can be called from any thread.
+   * @param operation supplies the operation.
+   */
+  virtual void post(std::function<void()> operation) PURE;
+};
+
+using PrivateKeyOffloadPoolSharedPtr = std::shared_ptr<PrivateKeyOffloadPool>;
+
+} // namespace Ssl
+} // namespace Envoy
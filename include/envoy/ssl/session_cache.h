@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Ssl {
+
+/**
+ * A cache of serialized TLS sessions shared by the TLS contexts, and so by all the workers. The
+ * sessions being opaque bytes, it may be backed by storage outliving the process.
+ * All the operations may be called from any thread.
+ */
+class SessionCache {
+public:
+  virtual ~SessionCache() = default;
+
+  /**
+   * Store a session, replacing the one stored under the same key if any.
+   * @param key supplies the key of the session.
+   * @param session supplies the serialized session.
+   */
+  virtual void store(const std::string& key, std::vector<uint8_t>&& session) PURE;
+
+  /**
+   * @param key supplies the key of the session.
+   * @return the serialized session stored under the key, or an empty vector if there is none.
+   */
+  virtual std::vector<uint8_t> lookup(const std::string& key) PURE;
+
+  /**
+   * Remove the session stored under a key, if any.
+   * @param key supplies the key of the session.
+   */
+  virtual void remove(const std::string& key) PURE;
+
+  using IterateCb =
+      std::function<void(const std::string& key, const std::vector<uint8_t>& session)>;
+
+  /**
+   * Call a callback for every stored session, the least recently used first, so that storing them
+   * in the same order in another cache reproduces their recency. The cache must not be modified by
+   * the callback.
+   * @param cb supplies the callback.
+   */
+  virtual void iterate(const IterateCb& cb) PURE;
+};
+
+using SessionCacheSharedPtr = std::shared_ptr<SessionCache>;
+
+} // namespace Ssl
+} // namespace Envoy
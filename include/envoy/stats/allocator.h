@@ -38,6 +38,18 @@ public:
   virtual CounterSharedPtr makeCounter(StatName name, absl::string_view tag_extracted_name,
                                        const std::vector<Tag>& tags) PURE;
 
+  /**
+   * Like makeCounter(), but the counter is split into per-thread shards which are summed when it
+   * is read, so that increments from different threads do not contend on a cache line. If a
+   * counter of that name already exists, it is returned as is.
+   * @param name the full name of the stat.
+   * @param tag_extracted_name the name of the stat with tag-values stripped out.
+   * @param tags the extracted tag values.
+   * @return CounterSharedPtr a counter, or nullptr if allocation failed.
+   */
+  virtual CounterSharedPtr makeShardedCounter(StatName name, absl::string_view tag_extracted_name,
+                                              const std::vector<Tag>& tags) PURE;
+
   /**
    * @param name the full name of the stat.
    * @param tag_extracted_name the name of the stat with tag-values stripped out.
@@ -120,5 +120,22 @@ public:
 
 using ParentHistogramSharedPtr = RefcountPtr<ParentHistogram>;
 
+/**
+ * The bucket boundaries of the histograms, by histogram name.
+ */
+class HistogramSettings {
+public:
+  virtual ~HistogramSettings() = default;
+
+  /**
+   * @param stat_name the name of a histogram.
+   * @return the sorted upper bounds of the buckets of the histogram, which stay valid as long as
+   *         the settings.
+   */
+  virtual const std::vector<double>& buckets(const std::string& stat_name) const PURE;
+};
+
+using HistogramSettingsConstPtr = std::unique_ptr<const HistogramSettings>;
+
 } // namespace Stats
 } // namespace Envoy
@@ -35,6 +35,18 @@ public:
    * @return a snapshot of all histograms.
    */
   virtual const std::vector<std::reference_wrapper<const ParentHistogram>>& histograms() PURE;
+
+  /**
+   * @return a snapshot of the counters which changed since the previous flush, i.e. with non-zero
+   *         deltas. A subset of counters(), for sinks only reporting what changed.
+   */
+  virtual const std::vector<CounterSnapshot>& changedCounters() PURE;
+
+  /**
+   * @return a snapshot of the gauges whose value changed since the previous flush. A subset of
+   *         gauges(), for sinks only reporting what changed.
+   */
+  virtual const std::vector<std::reference_wrapper<const Gauge>>& changedGauges() PURE;
 };
 
 /**
@@ -50,6 +62,12 @@ public:
    */
   virtual void flush(MetricSnapshot& snapshot) PURE;
 
+  /**
+   * @return whether flush() may run on a thread other than the main thread, which is registered for
+   *         thread local updates like the workers, while other sinks flush the same snapshot.
+   */
+  virtual bool flushesOnAnyThread() const PURE;
+
   /**
    * Flush a single histogram sample. Note: this call is called synchronously as a part of recording
    * the metric, so implementations must be thread-safe.
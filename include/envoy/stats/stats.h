@@ -98,11 +98,13 @@ public:
    * Flags:
    * Used: used by all stats types to figure out whether they have been used.
    * Logic...: used by gauges to cache how they should be combined with a parent's value.
+   * Changed: used by gauges to track whether their value changed since the last flush.
    */
   struct Flags {
     static const uint8_t Used = 0x01;
     static const uint8_t LogicAccumulate = 0x02;
     static const uint8_t NeverImport = 0x04;
+    static const uint8_t Changed = 0x08;
   };
   virtual SymbolTable& symbolTable() PURE;
   virtual const SymbolTable& constSymbolTable() const PURE;
@@ -146,6 +148,12 @@ public:
   virtual void sub(uint64_t amount) PURE;
   virtual uint64_t value() const PURE;
 
+  /**
+   * Like Counter::latch(), called once per stats flush.
+   * @return whether the value of the gauge changed since the previous call.
+   */
+  virtual bool latchChanged() PURE;
+
   /**
    * @return the import mode, dictating behavior of the gauge across hot restarts.
    */
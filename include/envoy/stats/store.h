@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "envoy/common/pure.h"
+#include "envoy/stats/histogram.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_matcher.h"
 #include "envoy/stats/tag_producer.h"
@@ -73,6 +74,20 @@ public:
    */
   virtual void setStatsMatcher(StatsMatcherPtr&& stats_matcher) PURE;
 
+  /**
+   * Attach a StatsMatcher selecting the counters which are sharded per thread, trading memory for
+   * contention-free increments. Only affects the counters created afterwards.
+   * @param matcher a StatsMatcher whose accepted counters are sharded, or nullptr for none.
+   */
+  virtual void setShardedCounterMatcher(StatsMatcherPtr&& matcher) PURE;
+
+  /**
+   * Set the bucket boundaries of the histograms. Only affects the histograms created afterwards,
+   * and may only be called once.
+   * @param histogram_settings the settings, or nullptr for the default buckets.
+   */
+  virtual void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) PURE;
+
   /**
    * Initialize the store for threading. This will be called once after all worker threads have
    * been initialized. At this point the store can initialize itself for multi-threaded operation.
@@ -203,6 +203,14 @@ public:
    *                      should be done by resetting the connection.
    */
   virtual Cancellable* newConnection(Callbacks& callbacks) PURE;
+
+  /**
+   * Open connections ahead of the requests which will use them, as called for by the cluster's
+   * preconnect policy. Pools also do this themselves as connections are requested.
+   * @param expected_requests supplies the number of connection requests expected shortly, in
+   *                          addition to those assigned or pending on the pool.
+   */
+  virtual void preconnect(uint32_t expected_requests) PURE;
 };
 
 using InstancePtr = std::unique_ptr<Instance>;
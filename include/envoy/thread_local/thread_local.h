@@ -71,6 +71,9 @@ public:
    *                     returns the thread local object which is then stored. The storage is via
    *                     a shared_ptr. Thus, this is a flexible mechanism that can be used to share
    *                     the same data across all threads or to share different data on each thread.
+   *                     The updates posted to a thread are batched, and a functor may not be
+   *                     called on a thread at all if a newer one set on the same slot is already
+   *                     queued for it.
    */
   using InitializeCb = std::function<ThreadLocalObjectSharedPtr(Event::Dispatcher& dispatcher)>;
   virtual void set(InitializeCb cb) PURE;
@@ -119,6 +119,13 @@ public:
    * @param sampled whether the span and any subsequent child spans should be sampled
    */
   virtual void setSampled(bool sampled) PURE;
+
+  /**
+   * @return whether the span is reported to the tracing system, and thus whether the tags and
+   *         logs set on it are of any use. A span which is not reported is still started to
+   *         propagate the sampling decision.
+   */
+  virtual bool sampled() const PURE;
 };
 
 /**
@@ -146,6 +153,11 @@ class HttpTracer {
 public:
   virtual ~HttpTracer() = default;
 
+  /**
+   * Start the span of a request.
+   * @return the span, or nullptr if the request is not traced at all, in which case the caller
+   *         uses the NullSpan instance rather than allocating a span which does nothing.
+   */
   virtual SpanPtr startSpan(const Config& config, Http::HeaderMap& request_headers,
                             const StreamInfo::StreamInfo& stream_info,
                             const Tracing::Decision tracing_decision) PURE;
@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/api.h"
@@ -12,10 +13,12 @@
 #include "envoy/config/bootstrap/v2/bootstrap.pb.h"
 #include "envoy/config/grpc_mux.h"
 #include "envoy/config/subscription_factory.h"
+#include "envoy/event/dispatcher.h"
 #include "envoy/grpc/async_client_manager.h"
 #include "envoy/http/async_client.h"
 #include "envoy/http/conn_pool.h"
 #include "envoy/local_info/local_info.h"
+#include "envoy/network/dns.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/secret/secret_manager.h"
 #include "envoy/server/admin.h"
@@ -55,6 +58,33 @@ public:
   virtual void onClusterRemoval(const std::string& cluster_name) PURE;
 };
 
+/**
+ * Dedicated threads the cluster manager runs active health checks and DNS resolution on, rather
+ * than the main thread, so that they do not delay the main thread's other work.
+ */
+class OffloadThreads {
+public:
+  virtual ~OffloadThreads() = default;
+
+  /**
+   * @return Event::Dispatcher& the dispatcher of the thread to run the work of a cluster on.
+   *         Successive calls go round robin over the threads.
+   */
+  virtual Event::Dispatcher& nextDispatcher() PURE;
+
+  /**
+   * @return Event::Dispatcher& the dispatcher of the first thread, for work which must all run on
+   *         the same thread.
+   */
+  virtual Event::Dispatcher& firstDispatcher() PURE;
+
+  /**
+   * @return Network::DnsResolverSharedPtr a DNS resolver which resolves on the threads and calls
+   *         back with the responses on the main thread.
+   */
+  virtual Network::DnsResolverSharedPtr dnsResolver() PURE;
+};
+
 /**
  * ClusterUpdateCallbacksHandle is a RAII wrapper for a ClusterUpdateCallbacks. Deleting
  * the ClusterUpdateCallbacksHandle will remove the callbacks from ClusterManager in O(1).
@@ -225,6 +255,35 @@ public:
   virtual Config::SubscriptionFactory& subscriptionFactory() PURE;
 
   virtual std::size_t warmingClusterCount() const PURE;
+
+  /**
+   * @return OffloadThreads* the threads active health checks and DNS resolution are offloaded to,
+   *         or nullptr if they run on the main thread.
+   */
+  virtual OffloadThreads* offloadThreads() PURE;
+
+  /**
+   * @return Network::DnsResolverSharedPtr the DNS resolver the clusters resolve their hosts with,
+   *         shared with the other users of DNS on the main thread. It resolves on the offload
+   *         threads if any, and caches the responses if configured to.
+   */
+  virtual Network::DnsResolverSharedPtr dnsResolver() PURE;
+
+  /**
+   * Instantiate a cluster which was added via API while lazy cluster initialization is enabled,
+   * if it has not been instantiated yet. The cluster then warms as any added cluster. Must be
+   * called on the main thread.
+   *
+   * @param cluster supplies the name of the cluster.
+   * @return true if the cluster was waiting to be instantiated and now is.
+   */
+  virtual bool initializeLazyCluster(const std::string& cluster) PURE;
+
+  /**
+   * @return std::vector<std::string> the names of the clusters added via API which have not been
+   *         instantiated yet. @see initializeLazyCluster().
+   */
+  virtual std::vector<std::string> lazyClusters() PURE;
 };
 
 using ClusterManagerPtr = std::unique_ptr<ClusterManager>;
@@ -304,6 +363,11 @@ public:
    * Returns the secret manager.
    */
   virtual Secret::SecretManager& secretManager() PURE;
+
+  /**
+   * @return Network::DnsResolverSharedPtr the DNS resolver of the main thread.
+   */
+  virtual Network::DnsResolverSharedPtr dnsResolver() PURE;
 };
 
 /**
@@ -21,12 +21,14 @@ namespace Upstream {
  */
 #define ALL_HOST_STATS(COUNTER, GAUGE)                                                             \
   COUNTER(cx_connect_fail)                                                                         \
+  COUNTER(cx_retransmits)                                                                          \
   COUNTER(cx_total)                                                                                \
   COUNTER(rq_error)                                                                                \
   COUNTER(rq_success)                                                                              \
   COUNTER(rq_timeout)                                                                              \
   COUNTER(rq_total)                                                                                \
   GAUGE(cx_active, Accumulate)                                                                     \
+  GAUGE(cx_rtt_us, NeverImport)                                                                    \
   GAUGE(rq_active, Accumulate)
 
 /**
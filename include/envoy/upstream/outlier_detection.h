@@ -110,6 +110,13 @@ public:
    * and LocalOrigin type returns success rate for local origin errors.
    */
   virtual double successRate(SuccessRateMonitorType type) const PURE;
+
+  /**
+   * @return the latency of the host in milliseconds, an exponentially weighted moving average of
+   *         its mean response time in the intervals it had enough request volume in. -1 means that
+   *         the host did not have enough request volume in the last interval to calculate latency.
+   */
+  virtual double latency() const PURE;
 };
 
 using DetectorHostMonitorPtr = std::unique_ptr<DetectorHostMonitor>;
@@ -150,6 +157,22 @@ public:
    */
   virtual double
       successRateEjectionThreshold(DetectorHostMonitor::SuccessRateMonitorType) const PURE;
+
+  /**
+   * Returns the median latency in milliseconds of the hosts in the Detector for the last
+   * aggregation interval.
+   * @return the median latency, or -1 if there were not enough hosts with enough request volume to
+   *         proceed with latency based outlier ejection.
+   */
+  virtual double latencyMedian() const PURE;
+
+  /**
+   * Returns the latency threshold in milliseconds used in the last interval. The threshold is used
+   * to eject hosts based on their latency.
+   * @return the threshold, or -1 if there were not enough hosts with enough request volume to
+   *         proceed with latency based outlier ejection.
+   */
+  virtual double latencyEjectionThreshold() const PURE;
 };
 
 using DetectorSharedPtr = std::shared_ptr<Detector>;
@@ -1,12 +1,54 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
+
 #include "envoy/common/pure.h"
 #include "envoy/upstream/load_balancer.h"
 #include "envoy/upstream/upstream.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Upstream {
 
+/**
+ * Tracks the recent response times of the requests to a cluster on a worker, and the requests
+ * hedged on latency, to derive the delay after which a request is hedged and to bound the number
+ * of hedged requests.
+ */
+class HedgeTracker {
+public:
+  virtual ~HedgeTracker() = default;
+
+  /**
+   * Record the time a request waited for its response headers.
+   * @param response_time supplies the response time.
+   */
+  virtual void recordResponseTime(std::chrono::microseconds response_time) PURE;
+
+  /**
+   * @param percentile supplies the percentile in [0, 100].
+   * @return the percentile of the recent response times, or nullopt if too few responses were
+   *         recorded to estimate it.
+   */
+  virtual absl::optional<std::chrono::microseconds> responseTimePercentile(double percentile) PURE;
+
+  /**
+   * @param budget_percent supplies the maximum number of hedged requests, in percent of the recent
+   *        requests.
+   * @return whether one more request can be hedged within the budget.
+   */
+  virtual bool hedgeBudgetAvailable(double budget_percent) PURE;
+
+  /**
+   * Record that a request was hedged.
+   */
+  virtual void onHedge() PURE;
+};
+
+using HedgeTrackerSharedPtr = std::shared_ptr<HedgeTracker>;
+
 /**
  * A thread local cluster instance that can be used for direct load balancing and host set
  * interactions. In general, an instance of ThreadLocalCluster can only be safely used in the
@@ -32,6 +74,12 @@ public:
    * @return LoadBalancer& the backing load balancer.
    */
   virtual LoadBalancer& loadBalancer() PURE;
+
+  /**
+   * @return HedgeTrackerSharedPtr the tracker of the response times and hedged requests of this
+   * cluster on this thread. It is safe to store beyond the lifetime of the ThreadLocalCluster.
+   */
+  virtual HedgeTrackerSharedPtr hedgeTracker() PURE;
 };
 
 } // namespace Upstream
@@ -523,11 +523,16 @@ public:
   COUNTER(lb_zone_routing_cross_zone)                                                              \
   COUNTER(lb_zone_routing_sampled)                                                                 \
   COUNTER(membership_change)                                                                       \
+  COUNTER(original_dst_host_added)                                                                 \
   COUNTER(original_dst_host_invalid)                                                               \
+  COUNTER(original_dst_host_removed)                                                               \
   COUNTER(retry_or_shadow_abandoned)                                                               \
   COUNTER(update_attempt)                                                                          \
+  COUNTER(update_delta)                                                                            \
   COUNTER(update_empty)                                                                            \
   COUNTER(update_failure)                                                                          \
+  COUNTER(update_hosts_built)                                                                      \
+  COUNTER(update_localities_reused)                                                                \
   COUNTER(update_no_rebuild)                                                                       \
   COUNTER(update_success)                                                                          \
   COUNTER(upstream_cx_close_notify)                                                                \
@@ -547,7 +552,9 @@ public:
   COUNTER(upstream_cx_none_healthy)                                                                \
   COUNTER(upstream_cx_overflow)                                                                    \
   COUNTER(upstream_cx_pool_overflow)                                                               \
+  COUNTER(upstream_cx_preconnect)                                                                  \
   COUNTER(upstream_cx_protocol_error)                                                              \
+  COUNTER(upstream_cx_retransmits)                                                                 \
   COUNTER(upstream_cx_rx_bytes_total)                                                              \
   COUNTER(upstream_cx_total)                                                                       \
   COUNTER(upstream_cx_tx_bytes_total)                                                              \
@@ -559,6 +566,10 @@ public:
   COUNTER(upstream_internal_redirect_succeeded_total)                                              \
   COUNTER(upstream_rq_cancelled)                                                                   \
   COUNTER(upstream_rq_completed)                                                                   \
+  COUNTER(upstream_rq_hedge_abandoned)                                                             \
+  COUNTER(upstream_rq_hedge_budget_exceeded)                                                       \
+  COUNTER(upstream_rq_hedge_won)                                                                   \
+  COUNTER(upstream_rq_hedged)                                                                      \
   COUNTER(upstream_rq_maintenance_mode)                                                            \
   COUNTER(upstream_rq_pending_failure_eject)                                                       \
   COUNTER(upstream_rq_pending_overflow)                                                            \
@@ -583,8 +594,12 @@ public:
   GAUGE(upstream_rq_active, Accumulate)                                                            \
   GAUGE(upstream_rq_pending_active, Accumulate)                                                    \
   GAUGE(version, NeverImport)                                                                      \
+  HISTOGRAM(update_delta_duration_us)                                                              \
+  HISTOGRAM(update_full_duration_us)                                                               \
   HISTOGRAM(upstream_cx_connect_ms)                                                                \
-  HISTOGRAM(upstream_cx_length_ms)
+  HISTOGRAM(upstream_cx_http2_concurrent_streams)                                                  \
+  HISTOGRAM(upstream_cx_length_ms)                                                                 \
+  HISTOGRAM(upstream_cx_rtt_us)
 
 /**
  * All cluster load report stats. These are only use for EDS load reporting and not sent to the
@@ -597,7 +612,8 @@ public:
  * Cluster circuit breakers stats. Open circuit breaker stats and remaining resource stats
  * can be handled differently by passing in different macros.
  */
-#define ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(OPEN_GAUGE, REMAINING_GAUGE)                            \
+#define ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(COUNTER, OPEN_GAUGE, REMAINING_GAUGE)                   \
+  COUNTER(rq_retry_budget_exhausted)                                                               \
   OPEN_GAUGE(cx_open, Accumulate)                                                                  \
   OPEN_GAUGE(cx_pool_open, Accumulate)                                                             \
   OPEN_GAUGE(rq_open, Accumulate)                                                                  \
@@ -627,7 +643,8 @@ struct ClusterLoadReportStats {
  * Struct definition for cluster circuit breakers stats. @see stats_macros.h
  */
 struct ClusterCircuitBreakersStats {
-  ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(GENERATE_GAUGE_STRUCT, GENERATE_GAUGE_STRUCT)
+  ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                                     GENERATE_GAUGE_STRUCT)
 };
 
 /**
@@ -659,6 +676,9 @@ public:
     static const uint64_t USE_DOWNSTREAM_PROTOCOL = 0x2;
     // Whether connections should be immediately closed upon health failure.
     static const uint64_t CLOSE_CONNECTIONS_ON_HOST_HEALTH_FAILURE = 0x4;
+    // Whether the HTTP/2 connections to each host are owned by the main thread and shared by the
+    // workers. This is used when creating connection pools.
+    static const uint64_t SHARE_HTTP2_CONNECTIONS_ACROSS_WORKERS = 0x8;
   };
 
   virtual ~ClusterInfo() = default;
@@ -679,6 +699,11 @@ public:
    */
   virtual const absl::optional<std::chrono::milliseconds> idleTimeout() const PURE;
 
+  /**
+   * @return the interval at which the TCP state of the upstream connections is sampled, if it is.
+   */
+  virtual const absl::optional<std::chrono::milliseconds> tcpInfoSampleInterval() const PURE;
+
   /**
    * @return soft limit on size of the cluster's connections read and write buffers.
    */
@@ -764,6 +789,19 @@ public:
    */
   virtual uint64_t maxRequestsPerConnection() const PURE;
 
+  /**
+   * @return uint32_t the maximum number of connections that the HTTP/2 connection pool will open
+   *         to each upstream host, not counting connections which are draining. At least 1.
+   */
+  virtual uint32_t maxHttp2ConnectionsPerHost() const PURE;
+
+  /**
+   * @return double the number of connections that a connection pool keeps to each upstream host,
+   *         established or being established, as a ratio of the requests active or pending on
+   *         the pool. 1 indicates that connections are only opened as requests need them.
+   */
+  virtual double perUpstreamPreconnectRatio() const PURE;
+
   /**
    * @return the human readable name of the cluster.
    */
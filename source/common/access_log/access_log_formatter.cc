@@ -8,9 +8,11 @@
 #include "common/common/fmt.h"
 #include "common/common/utility.h"
 #include "common/config/metadata.h"
+#include "common/http/filter_latency.h"
 #include "common/http/utility.h"
 #include "common/stream_info/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "fmt/format.h"
 
@@ -61,6 +63,15 @@ StreamInfoFormatter::FieldExtractor sslConnectionInfoStringTimeExtractor(
       });
 }
 
+void appendDuration(const absl::optional<std::chrono::nanoseconds>& time, std::string& output) {
+  if (time) {
+    absl::StrAppend(&output,
+                    std::chrono::duration_cast<std::chrono::milliseconds>(time.value()).count());
+  } else {
+    output += UnspecifiedValueString;
+  }
+}
+
 } // namespace
 
 const std::string AccessLogFormatUtils::DEFAULT_FORMAT =
@@ -105,12 +116,18 @@ std::string FormatterImpl::format(const Http::HeaderMap& request_headers,
                                   const StreamInfo::StreamInfo& stream_info) const {
   std::string log_line;
   log_line.reserve(256);
+  formatInto(request_headers, response_headers, response_trailers, stream_info, log_line);
+  return log_line;
+}
 
+void FormatterImpl::formatInto(const Http::HeaderMap& request_headers,
+                               const Http::HeaderMap& response_headers,
+                               const Http::HeaderMap& response_trailers,
+                               const StreamInfo::StreamInfo& stream_info,
+                               std::string& output) const {
   for (const FormatterProviderPtr& provider : providers_) {
-    log_line += provider->format(request_headers, response_headers, response_trailers, stream_info);
+    provider->formatInto(request_headers, response_headers, response_trailers, stream_info, output);
   }
-
-  return log_line;
 }
 
 JsonFormatterImpl::JsonFormatterImpl(std::unordered_map<std::string, std::string>& format_mapping) {
@@ -143,6 +160,14 @@ std::string JsonFormatterImpl::format(const Http::HeaderMap& request_headers,
   return absl::StrCat(log_line, "\n");
 }
 
+void JsonFormatterImpl::formatInto(const Http::HeaderMap& request_headers,
+                                   const Http::HeaderMap& response_headers,
+                                   const Http::HeaderMap& response_trailers,
+                                   const StreamInfo::StreamInfo& stream_info,
+                                   std::string& output) const {
+  output += format(request_headers, response_headers, response_trailers, stream_info);
+}
+
 std::unordered_map<std::string, std::string> JsonFormatterImpl::toMap(
     const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
     const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo& stream_info) const {
@@ -310,10 +335,12 @@ std::vector<FormatterProviderPtr> AccessLogFormatParser::parse(const std::string
 StreamInfoFormatter::StreamInfoFormatter(const std::string& field_name) {
 
   if (field_name == "REQUEST_DURATION") {
+    direct_field_ = DirectField::RequestDuration;
     field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
       return AccessLogFormatUtils::durationToString(stream_info.lastDownstreamRxByteReceived());
     };
   } else if (field_name == "RESPONSE_DURATION") {
+    direct_field_ = DirectField::ResponseDuration;
     field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
       return AccessLogFormatUtils::durationToString(stream_info.firstUpstreamRxByteReceived());
     };
@@ -330,14 +357,17 @@ StreamInfoFormatter::StreamInfoFormatter(const std::string& field_name) {
       return UnspecifiedValueString;
     };
   } else if (field_name == "BYTES_RECEIVED") {
+    direct_field_ = DirectField::BytesReceived;
     field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
       return fmt::format_int(stream_info.bytesReceived()).str();
     };
   } else if (field_name == "PROTOCOL") {
+    direct_field_ = DirectField::Protocol;
     field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
       return AccessLogFormatUtils::protocolToString(stream_info.protocol());
     };
   } else if (field_name == "RESPONSE_CODE") {
+    direct_field_ = DirectField::ResponseCode;
     field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
       return stream_info.responseCode() ? fmt::format_int(stream_info.responseCode().value()).str()
                                         : "0";
@@ -348,10 +378,12 @@ StreamInfoFormatter::StreamInfoFormatter(const std::string& field_name) {
                                                : UnspecifiedValueString;
     };
   } else if (field_name == "BYTES_SENT") {
+    direct_field_ = DirectField::BytesSent;
     field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
       return fmt::format_int(stream_info.bytesSent()).str();
     };
   } else if (field_name == "DURATION") {
+    direct_field_ = DirectField::Duration;
     field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
       return AccessLogFormatUtils::durationToString(stream_info.requestComplete());
     };
@@ -360,6 +392,7 @@ StreamInfoFormatter::StreamInfoFormatter(const std::string& field_name) {
       return StreamInfo::ResponseFlagUtils::toShortString(stream_info);
     };
   } else if (field_name == "UPSTREAM_HOST") {
+    direct_field_ = DirectField::UpstreamHost;
     field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
       if (stream_info.upstreamHost()) {
         return stream_info.upstreamHost()->address()->asString();
@@ -487,6 +520,17 @@ StreamInfoFormatter::StreamInfoFormatter(const std::string& field_name) {
         return UnspecifiedValueString;
       }
     };
+  } else if (field_name == "FILTER_LATENCY") {
+    field_extractor_ = [](const StreamInfo::StreamInfo& stream_info) {
+      const StreamInfo::FilterState& filter_state = stream_info.filterState();
+      if (filter_state.hasData<Http::FilterLatencyState>(Http::FilterLatencyState::key())) {
+        return filter_state
+            .getDataReadOnly<Http::FilterLatencyState>(Http::FilterLatencyState::key())
+            .toString();
+      } else {
+        return UnspecifiedValueString;
+      }
+    };
   } else {
     throw EnvoyException(fmt::format("Not supported field in StreamInfo: {}", field_name));
   }
@@ -498,6 +542,45 @@ std::string StreamInfoFormatter::format(const Http::HeaderMap&, const Http::Head
   return field_extractor_(stream_info);
 }
 
+void StreamInfoFormatter::formatInto(const Http::HeaderMap&, const Http::HeaderMap&,
+                                     const Http::HeaderMap&,
+                                     const StreamInfo::StreamInfo& stream_info,
+                                     std::string& output) const {
+  // Each case must append the same value as the field extractor.
+  switch (direct_field_) {
+  case DirectField::RequestDuration:
+    appendDuration(stream_info.lastDownstreamRxByteReceived(), output);
+    return;
+  case DirectField::ResponseDuration:
+    appendDuration(stream_info.firstUpstreamRxByteReceived(), output);
+    return;
+  case DirectField::Duration:
+    appendDuration(stream_info.requestComplete(), output);
+    return;
+  case DirectField::BytesReceived:
+    absl::StrAppend(&output, stream_info.bytesReceived());
+    return;
+  case DirectField::BytesSent:
+    absl::StrAppend(&output, stream_info.bytesSent());
+    return;
+  case DirectField::ResponseCode:
+    absl::StrAppend(&output,
+                    stream_info.responseCode() ? stream_info.responseCode().value() : 0);
+    return;
+  case DirectField::Protocol:
+    output += AccessLogFormatUtils::protocolToString(stream_info.protocol());
+    return;
+  case DirectField::UpstreamHost:
+    output += stream_info.upstreamHost() ? stream_info.upstreamHost()->address()->asString()
+                                         : UnspecifiedValueString;
+    return;
+  case DirectField::None:
+    output += field_extractor_(stream_info);
+    return;
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
 PlainStringFormatter::PlainStringFormatter(const std::string& str) : str_(str) {}
 
 std::string PlainStringFormatter::format(const Http::HeaderMap&, const Http::HeaderMap&,
@@ -506,30 +589,37 @@ std::string PlainStringFormatter::format(const Http::HeaderMap&, const Http::Hea
   return str_;
 }
 
+void PlainStringFormatter::formatInto(const Http::HeaderMap&, const Http::HeaderMap&,
+                                      const Http::HeaderMap&, const StreamInfo::StreamInfo&,
+                                      std::string& output) const {
+  output += str_;
+}
+
 HeaderFormatter::HeaderFormatter(const std::string& main_header,
                                  const std::string& alternative_header,
                                  absl::optional<size_t> max_length)
     : main_header_(main_header), alternative_header_(alternative_header), max_length_(max_length) {}
 
 std::string HeaderFormatter::format(const Http::HeaderMap& headers) const {
+  std::string header_value_string;
+  formatInto(headers, header_value_string);
+  return header_value_string;
+}
+
+void HeaderFormatter::formatInto(const Http::HeaderMap& headers, std::string& output) const {
   const Http::HeaderEntry* header = headers.get(main_header_);
 
   if (!header && !alternative_header_.get().empty()) {
     header = headers.get(alternative_header_);
   }
 
-  std::string header_value_string;
-  if (!header) {
-    header_value_string = UnspecifiedValueString;
-  } else {
-    header_value_string = std::string(header->value().getStringView());
+  absl::string_view header_value =
+      header ? header->value().getStringView() : absl::string_view(UnspecifiedValueString);
+  if (max_length_ && header_value.length() > max_length_.value()) {
+    header_value = header_value.substr(0, max_length_.value());
   }
 
-  if (max_length_ && header_value_string.length() > max_length_.value()) {
-    return header_value_string.substr(0, max_length_.value());
-  }
-
-  return header_value_string;
+  output.append(header_value.data(), header_value.size());
 }
 
 ResponseHeaderFormatter::ResponseHeaderFormatter(const std::string& main_header,
@@ -544,6 +634,13 @@ std::string ResponseHeaderFormatter::format(const Http::HeaderMap&,
   return HeaderFormatter::format(response_headers);
 }
 
+void ResponseHeaderFormatter::formatInto(const Http::HeaderMap&,
+                                         const Http::HeaderMap& response_headers,
+                                         const Http::HeaderMap&, const StreamInfo::StreamInfo&,
+                                         std::string& output) const {
+  HeaderFormatter::formatInto(response_headers, output);
+}
+
 RequestHeaderFormatter::RequestHeaderFormatter(const std::string& main_header,
                                                const std::string& alternative_header,
                                                absl::optional<size_t> max_length)
@@ -555,6 +652,12 @@ std::string RequestHeaderFormatter::format(const Http::HeaderMap& request_header
   return HeaderFormatter::format(request_headers);
 }
 
+void RequestHeaderFormatter::formatInto(const Http::HeaderMap& request_headers,
+                                        const Http::HeaderMap&, const Http::HeaderMap&,
+                                        const StreamInfo::StreamInfo&, std::string& output) const {
+  HeaderFormatter::formatInto(request_headers, output);
+}
+
 ResponseTrailerFormatter::ResponseTrailerFormatter(const std::string& main_header,
                                                    const std::string& alternative_header,
                                                    absl::optional<size_t> max_length)
@@ -566,6 +669,13 @@ std::string ResponseTrailerFormatter::format(const Http::HeaderMap&, const Http:
   return HeaderFormatter::format(response_trailers);
 }
 
+void ResponseTrailerFormatter::formatInto(const Http::HeaderMap&, const Http::HeaderMap&,
+                                          const Http::HeaderMap& response_trailers,
+                                          const StreamInfo::StreamInfo&,
+                                          std::string& output) const {
+  HeaderFormatter::formatInto(response_trailers, output);
+}
+
 MetadataFormatter::MetadataFormatter(const std::string& filter_namespace,
                                      const std::vector<std::string>& path,
                                      absl::optional<size_t> max_length)
@@ -608,6 +718,13 @@ std::string DynamicMetadataFormatter::format(const Http::HeaderMap&, const Http:
   return MetadataFormatter::format(stream_info.dynamicMetadata());
 }
 
+void DynamicMetadataFormatter::formatInto(const Http::HeaderMap&, const Http::HeaderMap&,
+                                          const Http::HeaderMap&,
+                                          const StreamInfo::StreamInfo& stream_info,
+                                          std::string& output) const {
+  output += MetadataFormatter::format(stream_info.dynamicMetadata());
+}
+
 StartTimeFormatter::StartTimeFormatter(const std::string& format) : date_formatter_(format) {}
 
 std::string StartTimeFormatter::format(const Http::HeaderMap&, const Http::HeaderMap&,
@@ -620,5 +737,13 @@ std::string StartTimeFormatter::format(const Http::HeaderMap&, const Http::Heade
   }
 }
 
+void StartTimeFormatter::formatInto(const Http::HeaderMap& request_headers,
+                                    const Http::HeaderMap& response_headers,
+                                    const Http::HeaderMap& response_trailers,
+                                    const StreamInfo::StreamInfo& stream_info,
+                                    std::string& output) const {
+  output += format(request_headers, response_headers, response_trailers, stream_info);
+}
+
 } // namespace AccessLog
 } // namespace Envoy
@@ -94,6 +94,9 @@ public:
                      const Http::HeaderMap& response_headers,
                      const Http::HeaderMap& response_trailers,
                      const StreamInfo::StreamInfo& stream_info) const override;
+  void formatInto(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                  const Http::HeaderMap& response_trailers,
+                  const StreamInfo::StreamInfo& stream_info, std::string& output) const override;
 
 private:
   std::vector<FormatterProviderPtr> providers_;
@@ -108,6 +111,9 @@ public:
                      const Http::HeaderMap& response_headers,
                      const Http::HeaderMap& response_trailers,
                      const StreamInfo::StreamInfo& stream_info) const override;
+  void formatInto(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                  const Http::HeaderMap& response_trailers,
+                  const StreamInfo::StreamInfo& stream_info, std::string& output) const override;
 
 private:
   std::vector<FormatterProviderPtr> providers_;
@@ -129,6 +135,8 @@ public:
   // Formatter::format
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
                      const StreamInfo::StreamInfo&) const override;
+  void formatInto(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
+                  const StreamInfo::StreamInfo&, std::string& output) const override;
 
 private:
   std::string str_;
@@ -140,6 +148,7 @@ public:
                   absl::optional<size_t> max_length);
 
   std::string format(const Http::HeaderMap& headers) const;
+  void formatInto(const Http::HeaderMap& headers, std::string& output) const;
 
 private:
   Http::LowerCaseString main_header_;
@@ -158,6 +167,9 @@ public:
   // Formatter::format
   std::string format(const Http::HeaderMap& request_headers, const Http::HeaderMap&,
                      const Http::HeaderMap&, const StreamInfo::StreamInfo&) const override;
+  void formatInto(const Http::HeaderMap& request_headers, const Http::HeaderMap&,
+                  const Http::HeaderMap&, const StreamInfo::StreamInfo&,
+                  std::string& output) const override;
 };
 
 /**
@@ -171,6 +183,9 @@ public:
   // Formatter::format
   std::string format(const Http::HeaderMap&, const Http::HeaderMap& response_headers,
                      const Http::HeaderMap&, const StreamInfo::StreamInfo&) const override;
+  void formatInto(const Http::HeaderMap&, const Http::HeaderMap& response_headers,
+                  const Http::HeaderMap&, const StreamInfo::StreamInfo&,
+                  std::string& output) const override;
 };
 
 /**
@@ -185,6 +200,9 @@ public:
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&,
                      const Http::HeaderMap& response_trailers,
                      const StreamInfo::StreamInfo&) const override;
+  void formatInto(const Http::HeaderMap&, const Http::HeaderMap&,
+                  const Http::HeaderMap& response_trailers, const StreamInfo::StreamInfo&,
+                  std::string& output) const override;
 };
 
 /**
@@ -197,11 +215,28 @@ public:
   // Formatter::format
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
                      const StreamInfo::StreamInfo& stream_info) const override;
+  void formatInto(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
+                  const StreamInfo::StreamInfo& stream_info, std::string& output) const override;
 
   using FieldExtractor = std::function<std::string(const StreamInfo::StreamInfo&)>;
 
 private:
+  // Commonly logged fields, which formatInto() appends to the output directly rather than through
+  // the string returned by the field extractor.
+  enum class DirectField {
+    None,
+    RequestDuration,
+    ResponseDuration,
+    Duration,
+    BytesReceived,
+    BytesSent,
+    ResponseCode,
+    Protocol,
+    UpstreamHost,
+  };
+
   FieldExtractor field_extractor_;
+  DirectField direct_field_{DirectField::None};
 };
 
 /**
@@ -231,6 +266,8 @@ public:
   // FormatterProvider::format
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
                      const StreamInfo::StreamInfo& stream_info) const override;
+  void formatInto(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
+                  const StreamInfo::StreamInfo& stream_info, std::string& output) const override;
 };
 
 /**
@@ -241,6 +278,8 @@ public:
   StartTimeFormatter(const std::string& format);
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
                      const StreamInfo::StreamInfo&) const override;
+  void formatInto(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
+                  const StreamInfo::StreamInfo& stream_info, std::string& output) const override;
 
 private:
   const Envoy::DateFormatter date_formatter_;
@@ -23,6 +23,7 @@
 #include "common/stream_info/utility.h"
 #include "common/tracing/http_tracer_impl.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -53,7 +54,8 @@ bool ComparisonFilter::compareAgainstValue(uint64_t lhs) {
 
 FilterPtr
 FilterFactory::fromProto(const envoy::config::filter::accesslog::v2::AccessLogFilter& config,
-                         Runtime::Loader& runtime, Runtime::RandomGenerator& random) {
+                         Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+                         Stats::Scope& scope) {
   switch (config.filter_specifier_case()) {
   case envoy::config::filter::accesslog::v2::AccessLogFilter::kStatusCodeFilter:
     return FilterPtr{new StatusCodeFilter(config.status_code_filter(), runtime)};
@@ -66,9 +68,9 @@ FilterFactory::fromProto(const envoy::config::filter::accesslog::v2::AccessLogFi
   case envoy::config::filter::accesslog::v2::AccessLogFilter::kRuntimeFilter:
     return FilterPtr{new RuntimeFilter(config.runtime_filter(), runtime, random)};
   case envoy::config::filter::accesslog::v2::AccessLogFilter::kAndFilter:
-    return FilterPtr{new AndFilter(config.and_filter(), runtime, random)};
+    return FilterPtr{new AndFilter(config.and_filter(), runtime, random, scope)};
   case envoy::config::filter::accesslog::v2::AccessLogFilter::kOrFilter:
-    return FilterPtr{new OrFilter(config.or_filter(), runtime, random)};
+    return FilterPtr{new OrFilter(config.or_filter(), runtime, random, scope)};
   case envoy::config::filter::accesslog::v2::AccessLogFilter::kHeaderFilter:
     return FilterPtr{new HeaderFilter(config.header_filter())};
   case envoy::config::filter::accesslog::v2::AccessLogFilter::kResponseFlagFilter:
@@ -84,6 +86,9 @@ FilterFactory::fromProto(const envoy::config::filter::accesslog::v2::AccessLogFi
           config.extension_filter().name());
       return factory.createFilter(config.extension_filter(), runtime, random);
     }
+  case envoy::config::filter::accesslog::v2::AccessLogFilter::kAggregateFilter:
+    MessageUtil::validate(config);
+    return FilterPtr{new AggregateFilter(config.aggregate_filter(), runtime, random, scope)};
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
@@ -140,19 +145,22 @@ bool RuntimeFilter::evaluate(const StreamInfo::StreamInfo&, const Http::HeaderMa
 
 OperatorFilter::OperatorFilter(const Protobuf::RepeatedPtrField<
                                    envoy::config::filter::accesslog::v2::AccessLogFilter>& configs,
-                               Runtime::Loader& runtime, Runtime::RandomGenerator& random) {
+                               Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+                               Stats::Scope& scope) {
   for (const auto& config : configs) {
-    filters_.emplace_back(FilterFactory::fromProto(config, runtime, random));
+    filters_.emplace_back(FilterFactory::fromProto(config, runtime, random, scope));
   }
 }
 
 OrFilter::OrFilter(const envoy::config::filter::accesslog::v2::OrFilter& config,
-                   Runtime::Loader& runtime, Runtime::RandomGenerator& random)
-    : OperatorFilter(config.filters(), runtime, random) {}
+                   Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+                   Stats::Scope& scope)
+    : OperatorFilter(config.filters(), runtime, random, scope) {}
 
 AndFilter::AndFilter(const envoy::config::filter::accesslog::v2::AndFilter& config,
-                     Runtime::Loader& runtime, Runtime::RandomGenerator& random)
-    : OperatorFilter(config.filters(), runtime, random) {}
+                     Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+                     Stats::Scope& scope)
+    : OperatorFilter(config.filters(), runtime, random, scope) {}
 
 bool OrFilter::evaluate(const StreamInfo::StreamInfo& info, const Http::HeaderMap& request_headers,
                         const Http::HeaderMap& response_headers,
@@ -263,12 +271,70 @@ Grpc::Status::GrpcStatus GrpcStatusFilter::protoToGrpcStatus(
   return static_cast<Grpc::Status::GrpcStatus>(status);
 }
 
+constexpr size_t AggregateFilter::ResponseClasses;
+
+AggregateFilter::AggregateFilter(
+    const envoy::config::filter::accesslog::v2::AggregateFilter& config, Runtime::Loader& runtime,
+    Runtime::RandomGenerator& random, Stats::Scope& scope)
+    : filter_(config.has_filter() ? FilterFactory::fromProto(config.filter(), runtime, random, scope)
+                                  : nullptr),
+      scope_(scope), per_route_(config.per_route()), stat_names_(scope.symbolTable()),
+      prefix_(stat_names_.add(absl::StrCat("access_log.", config.stat_prefix()))),
+      route_(stat_names_.add("route")) {
+  static const char* const class_names[ResponseClasses] = {"no_response", "1xx", "2xx",
+                                                           "3xx",         "4xx", "5xx"};
+  for (size_t i = 0; i < ResponseClasses; i++) {
+    rq_class_[i] = stat_names_.add(absl::StrCat("rq_", class_names[i]));
+    rq_class_time_[i] = stat_names_.add(absl::StrCat("rq_", class_names[i], "_time"));
+  }
+}
+
+bool AggregateFilter::evaluate(const StreamInfo::StreamInfo& info,
+                               const Http::HeaderMap& request_headers,
+                               const Http::HeaderMap& response_headers,
+                               const Http::HeaderMap& response_trailers) {
+  size_t response_class = 0;
+  if (info.responseCode() && info.responseCode().value() >= 100 &&
+      info.responseCode().value() < 600) {
+    response_class = info.responseCode().value() / 100;
+  }
+
+  const Router::RouteEntry* route_entry = per_route_ ? info.routeEntry() : nullptr;
+  if (route_entry != nullptr && !route_entry->routeName().empty()) {
+    record({prefix_, route_, stat_names_.getStatName(route_entry->routeName())}, response_class,
+           info);
+  } else {
+    record({prefix_}, response_class, info);
+  }
+
+  return filter_ != nullptr &&
+         filter_->evaluate(info, request_headers, response_headers, response_trailers);
+}
+
+void AggregateFilter::record(const Stats::StatNameVec& prefix, size_t response_class,
+                             const StreamInfo::StreamInfo& info) {
+  Stats::StatNameVec names(prefix);
+  names.push_back(rq_class_[response_class]);
+  const Stats::SymbolTable::StoragePtr counter_name = scope_.symbolTable().join(names);
+  scope_.counterFromStatName(Stats::StatName(counter_name.get())).inc();
+
+  const absl::optional<std::chrono::nanoseconds> duration = info.requestComplete();
+  if (duration) {
+    names.back() = rq_class_time_[response_class];
+    const Stats::SymbolTable::StoragePtr histogram_name = scope_.symbolTable().join(names);
+    scope_.histogramFromStatName(Stats::StatName(histogram_name.get()))
+        .recordValue(std::chrono::duration_cast<std::chrono::milliseconds>(duration.value())
+                         .count());
+  }
+}
+
 InstanceSharedPtr
 AccessLogFactory::fromProto(const envoy::config::filter::accesslog::v2::AccessLog& config,
                             Server::Configuration::FactoryContext& context) {
   FilterPtr filter;
   if (config.has_filter()) {
-    filter = FilterFactory::fromProto(config.filter(), context.runtime(), context.random());
+    filter = FilterFactory::fromProto(config.filter(), context.runtime(), context.random(),
+                                      context.scope());
   }
 
   auto& factory =
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <string>
 #include <unordered_set>
@@ -9,10 +10,12 @@
 #include "envoy/config/filter/accesslog/v2/accesslog.pb.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/server/access_log_config.h"
+#include "envoy/stats/scope.h"
 
 #include "common/grpc/status.h"
 #include "common/http/header_utility.h"
 #include "common/protobuf/protobuf.h"
+#include "common/stats/symbol_table_impl.h"
 
 #include "absl/hash/hash.h"
 
@@ -28,7 +31,8 @@ public:
    * Read a filter definition from proto and instantiate a concrete filter class.
    */
   static FilterPtr fromProto(const envoy::config::filter::accesslog::v2::AccessLogFilter& config,
-                             Runtime::Loader& runtime, Runtime::RandomGenerator& random);
+                             Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+                             Stats::Scope& scope);
 };
 
 /**
@@ -82,7 +86,8 @@ class OperatorFilter : public Filter {
 public:
   OperatorFilter(const Protobuf::RepeatedPtrField<
                      envoy::config::filter::accesslog::v2::AccessLogFilter>& configs,
-                 Runtime::Loader& runtime, Runtime::RandomGenerator& random);
+                 Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+                 Stats::Scope& scope);
 
 protected:
   std::vector<FilterPtr> filters_;
@@ -94,7 +99,7 @@ protected:
 class AndFilter : public OperatorFilter {
 public:
   AndFilter(const envoy::config::filter::accesslog::v2::AndFilter& config, Runtime::Loader& runtime,
-            Runtime::RandomGenerator& random);
+            Runtime::RandomGenerator& random, Stats::Scope& scope);
 
   // AccessLog::Filter
   bool evaluate(const StreamInfo::StreamInfo& info, const Http::HeaderMap& request_headers,
@@ -108,7 +113,7 @@ public:
 class OrFilter : public OperatorFilter {
 public:
   OrFilter(const envoy::config::filter::accesslog::v2::OrFilter& config, Runtime::Loader& runtime,
-           Runtime::RandomGenerator& random);
+           Runtime::RandomGenerator& random, Stats::Scope& scope);
 
   // AccessLog::Filter
   bool evaluate(const StreamInfo::StreamInfo& info, const Http::HeaderMap& request_headers,
@@ -222,6 +227,40 @@ private:
   protoToGrpcStatus(envoy::config::filter::accesslog::v2::GrpcStatusFilter_Status status) const;
 };
 
+/**
+ * Filter that aggregates the requests it evaluates into per response code class counters and
+ * duration histograms, and only lets through the requests matching its sub filter, if any. The
+ * stats are looked up through the scope's per-thread caches, so each worker updates its own
+ * histograms and the rollups go out with the periodic stats flush.
+ */
+class AggregateFilter : public Filter {
+public:
+  AggregateFilter(const envoy::config::filter::accesslog::v2::AggregateFilter& config,
+                  Runtime::Loader& runtime, Runtime::RandomGenerator& random, Stats::Scope& scope);
+
+  // AccessLog::Filter
+  bool evaluate(const StreamInfo::StreamInfo& info, const Http::HeaderMap& request_headers,
+                const Http::HeaderMap& response_headers,
+                const Http::HeaderMap& response_trailers) override;
+
+private:
+  // The classes are indexed by the hundreds of the response code, 0 standing for no response code.
+  static constexpr size_t ResponseClasses = 6;
+
+  void record(const Stats::StatNameVec& prefix, size_t response_class,
+              const StreamInfo::StreamInfo& info);
+
+  FilterPtr filter_;
+  Stats::Scope& scope_;
+  const bool per_route_;
+  // Holds the fixed names, and the route names, which are only known as requests are evaluated.
+  Stats::StatNameSet stat_names_;
+  const Stats::StatName prefix_;
+  const Stats::StatName route_;
+  std::array<Stats::StatName, ResponseClasses> rq_class_;
+  std::array<Stats::StatName, ResponseClasses> rq_class_time_;
+};
+
 /**
  * Extension filter factory that reads from ExtensionFilter proto.
  */
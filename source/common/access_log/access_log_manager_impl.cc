@@ -1,6 +1,8 @@
 #include "common/access_log/access_log_manager_impl.h"
 
+#include <functional>
 #include <string>
+#include <thread>
 
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
@@ -23,13 +25,14 @@ AccessLogFileSharedPtr AccessLogManagerImpl::createAccessLog(const std::string&
 
   access_logs_[file_name] = std::make_shared<AccessLogFileImpl>(
       api_.fileSystem().createFile(file_name), dispatcher_, lock_, file_stats_,
-      file_flush_interval_msec_, api_.threadFactory());
+      file_flush_interval_msec_, file_max_buffered_bytes_, api_.threadFactory());
   return access_logs_[file_name];
 }
 
 AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                                      Thread::BasicLockable& lock, AccessLogFileStats& stats,
                                      std::chrono::milliseconds flush_interval_msec,
+                                     uint64_t max_buffered_bytes,
                                      Thread::ThreadFactory& thread_factory)
     : file_(std::move(file)), file_lock_(lock),
       flush_timer_(dispatcher.createTimer([this]() -> void {
@@ -37,7 +40,8 @@ AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatch
         flush_event_.notifyOne();
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
-      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {
+      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec),
+      max_buffered_bytes_(max_buffered_bytes), stats_(stats) {
   open();
 }
 
@@ -72,8 +76,9 @@ AccessLogFileImpl::~AccessLogFileImpl() {
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
+    collectWrites();
+    if (about_to_write_buffer_.length() > 0) {
+      doWrite(about_to_write_buffer_);
     }
 
     const Api::IoCallBoolResult result = file_->close();
@@ -82,6 +87,16 @@ AccessLogFileImpl::~AccessLogFileImpl() {
   }
 }
 
+void AccessLogFileImpl::collectWrites() {
+  uint64_t collected = 0;
+  for (WriteStripe& stripe : write_stripes_) {
+    Thread::LockGuard lock(stripe.lock_);
+    collected += stripe.buffer_.length();
+    about_to_write_buffer_.move(stripe.buffer_);
+  }
+  buffered_bytes_ -= collected;
+}
+
 void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
   uint64_t num_slices = buffer.getRawSlices(nullptr, 0);
   STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
@@ -117,9 +132,9 @@ void AccessLogFileImpl::flushThreadFunc() {
     {
       Thread::LockGuard write_lock(write_lock_);
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_) {
+      // flush_event_ can be woken up either by large enough write_stripes_ or by timer.
+      // In case it was timer, write_stripes_ can be empty.
+      while (buffered_bytes_ == 0 && !flush_thread_exit_) {
         // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
         flush_event_.wait(write_lock_);
       }
@@ -129,11 +144,12 @@ void AccessLogFileImpl::flushThreadFunc() {
       }
 
       flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      ASSERT(flush_buffer_.length() > 0);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
     }
 
+    // Writes only add data to write_stripes_, and flush() cannot collect it without write_lock_.
+    collectWrites();
+    ASSERT(about_to_write_buffer_.length() > 0);
+
     // if we failed to open file before, then simply ignore
     if (file_->isOpen()) {
       try {
@@ -161,39 +177,67 @@ void AccessLogFileImpl::flush() {
 
     // flush_lock_ must be held while checking this or else it is
     // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
+    // write_stripes_ to about_to_write_buffer_, has unlocked write_lock_,
     // but has not yet completed doWrite(). This would allow flush() to
     // return before the pending data has actually been written to disk.
     flush_buffer_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
 
-    if (flush_buffer_.length() == 0) {
+    collectWrites();
+    if (about_to_write_buffer_.length() == 0) {
       return;
     }
-
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
   }
 
   doWrite(about_to_write_buffer_);
 }
 
 void AccessLogFileImpl::write(absl::string_view data) {
-  Thread::LockGuard lock(write_lock_);
+  if (max_buffered_bytes_ != 0 && buffered_bytes_ + data.length() > max_buffered_bytes_) {
+    stats_.write_dropped_.inc();
+    return;
+  }
 
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
+  if (!flush_thread_created_) {
+    Thread::LockGuard lock(write_lock_);
+    if (flush_thread_ == nullptr) {
+      createFlushStructures();
+      // The data is buffered before the lock is released, so that the new flush thread finds it
+      // rather than waiting for the timer.
+      if (bufferWrite(data)) {
+        flush_event_.notifyOne();
+      }
+      return;
+    }
   }
 
-  stats_.write_buffered_.inc();
-  stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
+  if (bufferWrite(data)) {
+    Thread::LockGuard lock(write_lock_);
     flush_event_.notifyOne();
   }
 }
 
+bool AccessLogFileImpl::bufferWrite(absl::string_view data) {
+  WriteStripe& stripe =
+      write_stripes_[std::hash<std::thread::id>()(std::this_thread::get_id()) % WRITE_STRIPES];
+  uint64_t buffered;
+  {
+    Thread::LockGuard lock(stripe.lock_);
+    stripe.buffer_.add(data.data(), data.size());
+    // Counted under the lock of the stripe, so that collectWrites() never subtracts data that has
+    // not been counted yet.
+    buffered = buffered_bytes_ += data.length();
+  }
+
+  stats_.write_buffered_.inc();
+  stats_.write_total_buffered_.add(data.length());
+  // Only the write that takes the buffered data over MIN_FLUSH_SIZE wakes up the flush thread. If
+  // the flush thread is already busy, it checks buffered_bytes_ again before waiting.
+  return buffered > MIN_FLUSH_SIZE && buffered - data.length() <= MIN_FLUSH_SIZE;
+}
+
 void AccessLogFileImpl::createFlushStructures() {
   flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); });
+  flush_thread_created_ = true;
   flush_timer_->enableTimer(flush_interval_msec_);
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <unordered_map>
 
@@ -11,6 +12,7 @@
 #include "envoy/stats/store.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/common/mutex_tracer_impl.h"
 #include "common/common/thread.h"
 
 namespace Envoy {
@@ -20,6 +22,7 @@ namespace Envoy {
   COUNTER(reopen_failed)                                                                           \
   COUNTER(write_buffered)                                                                          \
   COUNTER(write_completed)                                                                         \
+  COUNTER(write_dropped)                                                                           \
   GAUGE(write_total_buffered, Accumulate)
 
 struct AccessLogFileStats {
@@ -30,10 +33,12 @@ namespace AccessLog {
 
 class AccessLogManagerImpl : public AccessLogManager {
 public:
-  AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
+  AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec,
+                       uint64_t file_max_buffered_bytes, Api::Api& api,
                        Event::Dispatcher& dispatcher, Thread::BasicLockable& lock,
                        Stats::Store& stats_store)
-      : file_flush_interval_msec_(file_flush_interval_msec), api_(api), dispatcher_(dispatcher),
+      : file_flush_interval_msec_(file_flush_interval_msec),
+        file_max_buffered_bytes_(file_max_buffered_bytes), api_(api), dispatcher_(dispatcher),
         lock_(lock), file_stats_{ACCESS_LOG_FILE_STATS(
                          POOL_COUNTER_PREFIX(stats_store, "access_log_file."),
                          POOL_GAUGE_PREFIX(stats_store, "access_log_file."))} {}
@@ -44,6 +49,7 @@ public:
 
 private:
   const std::chrono::milliseconds file_flush_interval_msec_;
+  const uint64_t file_max_buffered_bytes_;
   Api::Api& api_;
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
@@ -62,7 +68,7 @@ class AccessLogFileImpl : public AccessLogFile {
 public:
   AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                     Thread::BasicLockable& lock, AccessLogFileStats& stats_,
-                    std::chrono::milliseconds flush_interval_msec,
+                    std::chrono::milliseconds flush_interval_msec, uint64_t max_buffered_bytes,
                     Thread::ThreadFactory& thread_factory);
   ~AccessLogFileImpl() override;
 
@@ -78,6 +84,20 @@ public:
   void flush() override;
 
 private:
+  // Lines are buffered in one of several stripes, chosen by the writing thread, so that workers
+  // logging to the same file mostly take different locks. The lines of a thread stay in order, as
+  // they are always buffered in the same stripe.
+  struct WriteStripe {
+    Thread::MutexBasicLockable lock_;
+    MutexContentionName lock_name_{lock_.contentionId(), "access_log.file_stripe"};
+    Buffer::OwnedImpl buffer_ GUARDED_BY(lock_);
+  };
+
+  // Buffers the data in the stripe of the calling thread. Returns whether the flush thread should
+  // be woken up.
+  bool bufferWrite(absl::string_view data);
+  // Moves the data of all the stripes to about_to_write_buffer_. flush_lock_ must be held.
+  void collectWrites();
   void doWrite(Buffer::Instance& buffer);
   void flushThreadFunc();
   void open();
@@ -88,13 +108,15 @@ private:
 
   // Minimum size before the flush thread will be told to flush.
   static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+  static const size_t WRITE_STRIPES = 16;
 
   Filesystem::FilePtr file_;
 
   // These locks are always acquired in the following order if multiple locks are held:
   //    1) write_lock_
   //    2) flush_lock_
-  //    3) file_lock_
+  //    3) the lock of a WriteStripe
+  //    4) file_lock_
   Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
                                           // to disk. This is used to make sure that file blocks do
                                           // not get interleaved by multiple processes writing to
@@ -104,24 +126,27 @@ private:
                                           // concurrent access to the about_to_write_buffer_, fd_,
                                           // and all other data used during flushing and file
                                           // re-opening.
-  Thread::MutexBasicLockable
-      write_lock_; // The lock is used when filling the flush buffer. It allows
-                   // multiple threads to write to the same file at relatively
-                   // high performance. It is always local to the process.
+  Thread::MutexBasicLockable write_lock_; // This lock is used to create the flush thread, to
+                                          // wait for and signal flush_event_, and to start a
+                                          // flush. Writes only take it to wake up the flush thread
+                                          // once the buffered data reaches MIN_FLUSH_SIZE. It is
+                                          // always local to the process.
   Thread::ThreadPtr flush_thread_;
   Thread::CondVar flush_event_;
+  std::atomic<bool> flush_thread_created_{};
   std::atomic<bool> flush_thread_exit_{};
   std::atomic<bool> reopen_file_{};
-  Buffer::OwnedImpl
-      flush_buffer_ GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It gets
-                                             // filled and then flushed either when max size is
-                                             // reached or when a timer fires.
+  std::array<WriteStripe, WRITE_STRIPES> write_stripes_; // These buffers are used by multiple
+                                                         // threads. They get filled and then
+                                                         // flushed either when MIN_FLUSH_SIZE is
+                                                         // reached or when a timer fires.
+  std::atomic<uint64_t> buffered_bytes_{}; // Total size of the data in write_stripes_.
   // TODO(jmarantz): this should be GUARDED_BY(flush_lock_) but the analysis cannot poke through
   // the std::make_unique assignment. I do not believe it's possible to annotate this properly now
   // due to limitations in the clang thread annotation analysis.
   Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
+                                            // is moved from write_stripes_ under their locks,
+                                            // which are then released so that they can
                                             // continue to fill. This buffer is then used for the
                                             // final write to disk.
   Event::TimerPtr flush_timer_;
@@ -129,6 +154,8 @@ private:
   const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
+  const uint64_t max_buffered_bytes_; // Writes are dropped once this many bytes are buffered,
+                                      // unless it is 0.
   AccessLogFileStats& stats_;
 };
 
@@ -6,6 +6,8 @@
 
 #include <cerrno>
 
+#include "common/common/macros.h"
+
 namespace Envoy {
 namespace Api {
 
@@ -50,6 +52,35 @@ SysCallSizeResult OsSysCallsImpl::recvmsg(int sockfd, struct msghdr* msg, int fl
   return {rc, errno};
 }
 
+SysCallIntResult OsSysCallsImpl::recvmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags, struct timespec* timeout) {
+#if defined(__linux__)
+  const int rc = ::recvmmsg(sockfd, msgvec, vlen, flags, timeout);
+  return {rc, errno};
+#else
+  UNREFERENCED_PARAMETER(sockfd);
+  UNREFERENCED_PARAMETER(msgvec);
+  UNREFERENCED_PARAMETER(vlen);
+  UNREFERENCED_PARAMETER(flags);
+  UNREFERENCED_PARAMETER(timeout);
+  return {-1, ENOSYS};
+#endif
+}
+
+SysCallIntResult OsSysCallsImpl::sendmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags) {
+#if defined(__linux__)
+  const int rc = ::sendmmsg(sockfd, msgvec, vlen, flags);
+  return {rc, errno};
+#else
+  UNREFERENCED_PARAMETER(sockfd);
+  UNREFERENCED_PARAMETER(msgvec);
+  UNREFERENCED_PARAMETER(vlen);
+  UNREFERENCED_PARAMETER(flags);
+  return {-1, ENOSYS};
+#endif
+}
+
 SysCallIntResult OsSysCallsImpl::ftruncate(int fd, off_t length) {
   const int rc = ::ftruncate(fd, length);
   return {rc, errno};
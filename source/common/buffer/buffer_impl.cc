@@ -11,6 +11,8 @@
 namespace Envoy {
 namespace Buffer {
 
+thread_local uint64_t OwnedSlice::released_block_size_;
+
 void OwnedImpl::add(const void* data, uint64_t size) {
   if (old_impl_) {
     evbuffer_add(buffer_.get(), data, size);
@@ -591,8 +593,39 @@ void OwnedImpl::appendSliceForTest(absl::string_view data) {
   appendSliceForTest(data.data(), data.size());
 }
 
+void OwnedImpl::addShared(Instance& data) {
+  ASSERT(&data != this);
+  if (old_impl_ || !isSameBufferImpl(data)) {
+    add(data);
+    return;
+  }
+  OwnedImpl& other = static_cast<OwnedImpl&>(data);
+  for (size_t i = 0; i < other.slices_.size(); i++) {
+    SlicePtr& slice = other.slices_[i];
+    const uint64_t slice_size = slice->dataSize();
+    if (slice_size < MinSharedSliceSize) {
+      add(slice->data(), slice_size);
+    } else {
+      slices_.emplace_back(shareSlice(slice));
+      length_ += slice_size;
+    }
+  }
+}
+
 void OwnedImpl::useOldImpl(bool use_old_impl) { use_old_impl_ = use_old_impl; }
 
+SlicePtr OwnedImpl::shareSlice(SlicePtr& slice) {
+  const SharedSlice* shared_slice = dynamic_cast<const SharedSlice*>(slice.get());
+  if (shared_slice == nullptr) {
+    const uint8_t* data = slice->data();
+    const uint64_t size = slice->dataSize();
+    slice = std::make_unique<SharedSlice>(std::shared_ptr<const Slice>(std::move(slice)), data,
+                                          size);
+    shared_slice = static_cast<const SharedSlice*>(slice.get());
+  }
+  return shared_slice->share();
+}
+
 bool OwnedImpl::isSameBufferImpl(const Instance& rhs) const {
   const OwnedImpl* other = dynamic_cast<const OwnedImpl*>(&rhs);
   if (other == nullptr) {
@@ -8,6 +8,7 @@
 #include "envoy/buffer/buffer.h"
 #include "envoy/network/io_handle.h"
 
+#include "common/buffer/slice_pool.h"
 #include "common/common/assert.h"
 #include "common/common/non_copyable.h"
 #include "common/common/utility.h"
@@ -73,7 +74,7 @@ public:
    */
   uint64_t reservableSize() const {
     ASSERT(capacity_ >= reservable_);
-    return capacity_ - reservable_;
+    return read_only_ ? 0 : capacity_ - reservable_;
   }
 
   /**
@@ -98,7 +99,7 @@ public:
     // no data has been added or because all the added data has been drained, the data
     // section is at the very start of the slice.
     ASSERT(!(dataSize() == 0 && data_ > 0));
-    uint64_t available_size = capacity_ - reservable_;
+    uint64_t available_size = reservableSize();
     if (available_size == 0) {
       return {nullptr, 0};
     }
@@ -153,6 +154,9 @@ public:
    * @return number of bytes copied (may be a smaller than size, may even be zero).
    */
   uint64_t prepend(const void* data, uint64_t size) {
+    if (read_only_) {
+      return 0;
+    }
     const uint8_t* src = static_cast<const uint8_t*>(data);
     uint64_t copy_size;
     if (dataSize() == 0) {
@@ -175,8 +179,8 @@ public:
   }
 
 protected:
-  Slice(uint64_t data, uint64_t reservable, uint64_t capacity)
-      : data_(data), reservable_(reservable), capacity_(capacity) {}
+  Slice(uint64_t data, uint64_t reservable, uint64_t capacity, bool read_only = false)
+      : data_(data), reservable_(reservable), capacity_(capacity), read_only_(read_only) {}
 
   /** Start of the slice - subclasses must set this */
   uint8_t* base_{nullptr};
@@ -189,6 +193,9 @@ protected:
 
   /** Total number of bytes in the slice */
   uint64_t capacity_;
+
+  /** Whether the slice references memory which must not be written, so nothing can be added */
+  const bool read_only_;
 };
 
 using SlicePtr = std::unique_ptr<Slice>;
@@ -196,6 +203,17 @@ using SlicePtr = std::unique_ptr<Slice>;
 // OwnedSlice can not be derived from as it has variable sized array as member.
 class OwnedSlice final : public Slice, public InlineStorage {
 public:
+  ~OwnedSlice() override {
+    // The block size is needed by operator delete, which runs immediately after the destructor
+    // but is not passed the dynamic size of the object.
+    released_block_size_ = sizeof(OwnedSlice) + capacity_;
+  }
+
+  /**
+   * Return the slice's storage to the per-thread SlicePool. Hides InlineStorage's operators.
+   */
+  static void operator delete(void* address) { SlicePool::release(address, released_block_size_); }
+
   /**
    * Create an empty OwnedSlice.
    * @param capacity number of bytes of space the slice should have.
@@ -224,17 +242,23 @@ public:
 private:
   OwnedSlice(uint64_t size) : Slice(0, 0, size) { base_ = storage_; }
 
+  static void* operator new(size_t object_size, size_t data_size_bytes) {
+    return SlicePool::allocate(object_size + data_size_bytes);
+  }
+
   /**
    * Compute a slice size big enough to hold a specified amount of data.
    * @param data_size the minimum amount of data the slice must be able to store, in bytes.
    * @return a recommended slice size, in bytes.
    */
   static uint64_t sliceSize(uint64_t data_size) {
-    static constexpr uint64_t PageSize = 4096;
+    static constexpr uint64_t PageSize = SlicePool::PageSize;
     const uint64_t num_pages = (sizeof(OwnedSlice) + data_size + PageSize - 1) / PageSize;
     return num_pages * PageSize - sizeof(OwnedSlice);
   }
 
+  static thread_local uint64_t released_block_size_;
+
   uint8_t storage_[];
 };
 
@@ -395,7 +419,7 @@ private:
 class UnownedSlice : public Slice {
 public:
   UnownedSlice(BufferFragment& fragment)
-      : Slice(0, fragment.size(), fragment.size()), fragment_(fragment) {
+      : Slice(0, fragment.size(), fragment.size(), true), fragment_(fragment) {
     base_ = static_cast<uint8_t*>(const_cast<void*>(fragment.data()));
   }
 
@@ -405,6 +429,28 @@ private:
   BufferFragment& fragment_;
 };
 
+/**
+ * A read-only slice referencing the data of a slice whose storage is shared by several buffers.
+ * The storage is released once no SharedSlice references it. Since nothing can be added to a
+ * SharedSlice, a buffer which adds data next to it does so in a new slice: the shared bytes are
+ * copied on write rather than modified.
+ */
+class SharedSlice : public Slice {
+public:
+  SharedSlice(std::shared_ptr<const Slice> storage, const uint8_t* data, uint64_t size)
+      : Slice(0, size, size, true), storage_(std::move(storage)) {
+    base_ = const_cast<uint8_t*>(data);
+  }
+
+  /**
+   * @return a new SharedSlice referencing the data of this one.
+   */
+  SlicePtr share() const { return std::make_unique<SharedSlice>(storage_, data(), dataSize()); }
+
+private:
+  const std::shared_ptr<const Slice> storage_;
+};
+
 /**
  * An implementation of BufferFragment where a releasor callback is called when the data is
  * no longer needed.
@@ -480,6 +526,12 @@ private:
  */
 class OwnedImpl : public LibEventInstance {
 public:
+  /**
+   * The slices of at least this many bytes are shared rather than copied by addShared(). Sharing a
+   * slice costs an allocation, and leaves no room to add data to it in either buffer.
+   */
+  static constexpr uint64_t MinSharedSliceSize = 4096;
+
   OwnedImpl();
   OwnedImpl(absl::string_view data);
   OwnedImpl(const Instance& data);
@@ -523,6 +575,15 @@ public:
    */
   void appendSliceForTest(absl::string_view data);
 
+  /**
+   * Add the content of another buffer, sharing its slices of at least MinSharedSliceSize bytes
+   * instead of copying them. The shared slices become read-only in both buffers, so the data added
+   * after them goes to new slices. Unlike add(const Instance&), this changes the slices of data,
+   * which must not be used concurrently.
+   * @param data supplies the buffer to add, whose content is unchanged.
+   */
+  void addShared(Instance& data);
+
   // Support for choosing the buffer implementation at runtime.
   // TODO(brian-pane) remove this once the new implementation has been
   // running in production for a while.
@@ -551,6 +612,13 @@ private:
   /** Whether to use the old evbuffer implementation when constructing new OwnedImpl objects. */
   static bool use_old_impl_;
 
+  /**
+   * Make a slice shared, replacing it with a SharedSlice if it is not one already.
+   * @param slice supplies the slice to share.
+   * @return a new SharedSlice referencing the same data.
+   */
+  static SlicePtr shareSlice(SlicePtr& slice);
+
   /** Whether this buffer uses the old evbuffer implementation. */
   bool old_impl_;
 
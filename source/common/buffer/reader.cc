@@ -0,0 +1,124 @@
+#include "common/buffer/reader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/stack_array.h"
+
+namespace Envoy {
+namespace Buffer {
+
+Reader::Reader(const Instance& buffer, uint64_t start) {
+  const uint64_t num_slices = buffer.getRawSlices(nullptr, 0);
+  STACK_ARRAY(slices, RawSlice, num_slices);
+  buffer.getRawSlices(slices.begin(), num_slices);
+  for (const RawSlice& slice : slices) {
+    // The empty slices are left out, so the current slice always has data to read.
+    if (slice.len_ > 0) {
+      slices_.push_back(slice);
+      length_ += slice.len_;
+    }
+  }
+  skip(start);
+}
+
+void Reader::skip(uint64_t size) {
+  if (remaining() < size) {
+    throw EnvoyException("buffer underflow");
+  }
+  advance(size);
+}
+
+void Reader::read(void* data, uint64_t size) {
+  if (remaining() < size) {
+    throw EnvoyException("buffer underflow");
+  }
+  uint8_t* dest = static_cast<uint8_t*>(data);
+  while (size > 0) {
+    const RawSlice& slice = slices_[slice_index_];
+    const uint64_t copy_size = std::min(size, slice.len_ - slice_offset_);
+    memcpy(dest, static_cast<const uint8_t*>(slice.mem_) + slice_offset_, copy_size);
+    dest += copy_size;
+    size -= copy_size;
+    advance(copy_size);
+  }
+}
+
+std::string Reader::readString(uint64_t size) {
+  if (remaining() < size) {
+    throw EnvoyException("buffer underflow");
+  }
+  std::string value;
+  value.reserve(size);
+  while (size > 0) {
+    const RawSlice& slice = slices_[slice_index_];
+    const uint64_t copy_size = std::min(size, slice.len_ - slice_offset_);
+    value.append(static_cast<const char*>(slice.mem_) + slice_offset_, copy_size);
+    size -= copy_size;
+    advance(copy_size);
+  }
+  return value;
+}
+
+uint32_t Reader::readVarInt(uint64_t& value, uint32_t max_size) {
+  ASSERT(max_size <= 10);
+  const uint64_t last = std::min(remaining(), static_cast<uint64_t>(max_size));
+  if (last == 0) {
+    return 0;
+  }
+
+  const size_t slice_index = slice_index_;
+  const uint64_t slice_offset = slice_offset_;
+  uint64_t result = 0;
+  for (uint32_t i = 0; i < last; i++) {
+    const uint8_t b = readByte();
+    result |= static_cast<uint64_t>(b & 0x7f) << (7 * i);
+    if ((b & 0x80) == 0) {
+      value = result;
+      return i + 1;
+    }
+  }
+
+  // The varint is incomplete (or invalid), so nothing is consumed.
+  position_ -= last;
+  slice_index_ = slice_index;
+  slice_offset_ = slice_offset;
+  return 0;
+}
+
+ssize_t Reader::find(uint8_t byte) const {
+  uint64_t offset = 0;
+  uint64_t slice_offset = slice_offset_;
+  for (size_t i = slice_index_; i < slices_.size(); i++) {
+    const uint8_t* start = static_cast<const uint8_t*>(slices_[i].mem_) + slice_offset;
+    const uint64_t size = slices_[i].len_ - slice_offset;
+    const void* found = memchr(start, byte, size);
+    if (found != nullptr) {
+      return offset + (static_cast<const uint8_t*>(found) - start);
+    }
+    offset += size;
+    slice_offset = 0;
+  }
+  return -1;
+}
+
+void Reader::advance(uint64_t size) {
+  ASSERT(size <= remaining());
+  position_ += size;
+  while (size > 0) {
+    const uint64_t slice_remaining = slices_[slice_index_].len_ - slice_offset_;
+    if (size < slice_remaining) {
+      slice_offset_ += size;
+      return;
+    }
+    size -= slice_remaining;
+    slice_index_++;
+    slice_offset_ = 0;
+  }
+}
+
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "envoy/buffer/buffer.h"
+
+#include "common/common/byte_order.h"
+
+#include "absl/container/inlined_vector.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * Reads the data of a buffer sequentially across its slices, without linearizing the buffer.
+ * Instance::peekInt() and Instance::copyOut() look up the slice holding their start on each call,
+ * while the reader keeps track of its current slice, so parsing a message field by field walks the
+ * slices once. The reader references the raw slices of the buffer: the buffer must not be modified
+ * while the reader is used.
+ */
+class Reader {
+public:
+  /**
+   * @param buffer supplies the buffer to read.
+   * @param start supplies the offset in the buffer to start reading at.
+   * @throw EnvoyException if start is beyond the end of the buffer.
+   */
+  Reader(const Instance& buffer, uint64_t start = 0);
+
+  /**
+   * @return uint64_t the offset in the buffer of the next byte to read.
+   */
+  uint64_t position() const { return position_; }
+
+  /**
+   * @return uint64_t the number of bytes left to read.
+   */
+  uint64_t remaining() const { return length_ - position_; }
+
+  /**
+   * Skip data.
+   * @param size supplies the number of bytes to skip.
+   * @throw EnvoyException if fewer than size bytes remain.
+   */
+  void skip(uint64_t size);
+
+  /**
+   * Copy out data.
+   * @param data supplies the output buffer to fill.
+   * @param size supplies the number of bytes to copy out.
+   * @throw EnvoyException if fewer than size bytes remain.
+   */
+  void read(void* data, uint64_t size);
+
+  /**
+   * Copy out data as a string.
+   * @param size supplies the number of bytes to copy out.
+   * @return std::string the data.
+   * @throw EnvoyException if fewer than size bytes remain.
+   */
+  std::string readString(uint64_t size);
+
+  /**
+   * @return uint8_t the next byte.
+   * @throw EnvoyException if no byte remains.
+   */
+  uint8_t readByte() {
+    if (slice_index_ < slices_.size() && slice_offset_ + 1 < slices_[slice_index_].len_) {
+      position_++;
+      return static_cast<const uint8_t*>(slices_[slice_index_].mem_)[slice_offset_++];
+    }
+    uint8_t value;
+    read(&value, 1);
+    return value;
+  }
+
+  /**
+   * Copy out an integer, with the same semantics as Instance::peekInt().
+   * @param Size how many bytes to read out of the buffer.
+   * @param Endianness specifies the byte order to use when decoding the integer.
+   * @throw EnvoyException if fewer than Size bytes remain.
+   */
+  template <typename T, ByteOrder Endianness = ByteOrder::Host, size_t Size = sizeof(T)>
+  T readInt() {
+    static_assert(Size <= sizeof(T), "requested size is bigger than integer being read");
+
+    constexpr const auto displacement = Endianness == ByteOrder::BigEndian ? sizeof(T) - Size : 0;
+
+    auto result = static_cast<T>(0);
+    constexpr const auto all_bits_enabled = static_cast<T>(~static_cast<T>(0));
+
+    int8_t* bytes = reinterpret_cast<int8_t*>(std::addressof(result));
+    read(&bytes[displacement], Size);
+
+    constexpr const auto most_significant_read_byte =
+        Endianness == ByteOrder::BigEndian ? displacement : Size - 1;
+
+    const auto sign_extension_bits =
+        std::is_signed<T>::value && Size < sizeof(T) && bytes[most_significant_read_byte] < 0
+            ? static_cast<T>(static_cast<typename std::make_unsigned<T>::type>(all_bits_enabled)
+                             << ((Size % sizeof(T)) * CHAR_BIT))
+            : static_cast<T>(0);
+
+    return fromEndianness<Endianness>(static_cast<T>(result)) | sign_extension_bits;
+  }
+
+  /**
+   * Copy out a little endian integer.
+   * @param Size how many bytes to read out of the buffer.
+   */
+  template <typename T, size_t Size = sizeof(T)> T readLEInt() {
+    return readInt<T, ByteOrder::LittleEndian, Size>();
+  }
+
+  /**
+   * Copy out a big endian integer.
+   * @param Size how many bytes to read out of the buffer.
+   */
+  template <typename T, size_t Size = sizeof(T)> T readBEInt() {
+    return readInt<T, ByteOrder::BigEndian, Size>();
+  }
+
+  /**
+   * Read a base 128 varint, whose groups of 7 bits are stored least significant first with the
+   * high bit of each byte set on all but the last byte, as used by protobuf and Thrift's compact
+   * protocol.
+   * @param value supplies the decoded value, set if the varint is complete.
+   * @param max_size supplies the maximum number of bytes of the varint, at most 10.
+   * @return uint32_t the number of bytes read, or 0 if the varint does not end within max_size
+   *         bytes or the remaining data. The reader is then left unchanged.
+   */
+  uint32_t readVarInt(uint64_t& value, uint32_t max_size = 10);
+
+  /**
+   * Search the remaining data for a byte. The reader is left unchanged.
+   * @param byte supplies the byte to search for.
+   * @return ssize_t the offset of the byte from the position of the reader, or -1 if it is not
+   *         found.
+   */
+  ssize_t find(uint8_t byte) const;
+
+private:
+  void advance(uint64_t size);
+
+  absl::InlinedVector<RawSlice, 16> slices_;
+  uint64_t length_{};
+  uint64_t position_{};
+  size_t slice_index_{};
+  uint64_t slice_offset_{};
+};
+
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,134 @@
+#include "common/buffer/slice_pool.h"
+
+#include <atomic>
+#include <new>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Buffer {
+
+namespace {
+
+// Thread-local counts are folded into the process-wide totals after this many pool operations,
+// so that the totals do not become a contended cache line on the allocation path.
+constexpr uint32_t PublishInterval = 64;
+
+std::atomic<uint64_t> max_resident_bytes_per_thread{SlicePool::DefaultMaxResidentBytesPerThread};
+std::atomic<uint64_t> total_hits{0};
+std::atomic<uint64_t> total_misses{0};
+std::atomic<int64_t> total_resident_bytes{0};
+
+struct FreeBlock {
+  FreeBlock* next_;
+};
+
+// Trivially destructible so that it remains usable while other thread_local and static objects
+// holding slices are destroyed; FreeListsReaper empties it at thread exit.
+struct FreeLists {
+  FreeBlock* heads_[SlicePool::MaxPooledPages];
+  uint64_t resident_bytes_;
+  uint64_t hits_;
+  uint64_t misses_;
+  int64_t resident_bytes_delta_;
+  uint32_t unpublished_;
+  bool reaper_registered_;
+  bool destroyed_;
+
+  void publish() {
+    total_hits.fetch_add(hits_, std::memory_order_relaxed);
+    total_misses.fetch_add(misses_, std::memory_order_relaxed);
+    total_resident_bytes.fetch_add(resident_bytes_delta_, std::memory_order_relaxed);
+    hits_ = 0;
+    misses_ = 0;
+    resident_bytes_delta_ = 0;
+    unpublished_ = 0;
+  }
+
+  void maybePublish() {
+    if (++unpublished_ >= PublishInterval) {
+      publish();
+    }
+  }
+};
+
+thread_local FreeLists free_lists{};
+
+struct FreeListsReaper {
+  ~FreeListsReaper() {
+    for (uint64_t i = 0; i < SlicePool::MaxPooledPages; i++) {
+      while (free_lists.heads_[i] != nullptr) {
+        FreeBlock* block = free_lists.heads_[i];
+        free_lists.heads_[i] = block->next_;
+        ::operator delete(block);
+      }
+    }
+    free_lists.resident_bytes_delta_ -= free_lists.resident_bytes_;
+    free_lists.resident_bytes_ = 0;
+    free_lists.publish();
+    free_lists.destroyed_ = true;
+  }
+};
+
+thread_local FreeListsReaper free_lists_reaper;
+
+} // namespace
+
+void* SlicePool::allocate(uint64_t size) {
+  ASSERT(size > 0 && size % PageSize == 0);
+  const uint64_t pages = size / PageSize;
+  if (pages > MaxPooledPages) {
+    return ::operator new(size);
+  }
+  FreeBlock*& head = free_lists.heads_[pages - 1];
+  if (head != nullptr) {
+    FreeBlock* block = head;
+    head = block->next_;
+    free_lists.resident_bytes_ -= size;
+    free_lists.resident_bytes_delta_ -= size;
+    free_lists.hits_++;
+    free_lists.maybePublish();
+    return block;
+  }
+  free_lists.misses_++;
+  free_lists.maybePublish();
+  return ::operator new(size);
+}
+
+void SlicePool::release(void* block, uint64_t size) {
+  ASSERT(size > 0 && size % PageSize == 0);
+  const uint64_t pages = size / PageSize;
+  if (pages > MaxPooledPages || free_lists.destroyed_ ||
+      free_lists.resident_bytes_ + size >
+          max_resident_bytes_per_thread.load(std::memory_order_relaxed)) {
+    ::operator delete(block);
+    return;
+  }
+  if (!free_lists.reaper_registered_) {
+    // Odr-using the reaper constructs it, which registers its destructor for this thread.
+    (void)&free_lists_reaper;
+    free_lists.reaper_registered_ = true;
+  }
+  FreeBlock* free_block = static_cast<FreeBlock*>(block);
+  free_block->next_ = free_lists.heads_[pages - 1];
+  free_lists.heads_[pages - 1] = free_block;
+  free_lists.resident_bytes_ += size;
+  free_lists.resident_bytes_delta_ += size;
+  free_lists.maybePublish();
+}
+
+void SlicePool::setMaxResidentBytesPerThread(uint64_t max_bytes) {
+  max_resident_bytes_per_thread.store(max_bytes, std::memory_order_relaxed);
+}
+
+uint64_t SlicePool::hits() { return total_hits.load(std::memory_order_relaxed); }
+
+uint64_t SlicePool::misses() { return total_misses.load(std::memory_order_relaxed); }
+
+uint64_t SlicePool::residentBytes() {
+  const int64_t resident_bytes = total_resident_bytes.load(std::memory_order_relaxed);
+  return resident_bytes > 0 ? resident_bytes : 0;
+}
+
+} // namespace Buffer
+} // namespace Envoy
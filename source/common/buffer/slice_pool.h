@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * Per-thread pools of the page-multiple blocks which back OwnedSlice storage. Blocks of up to
+ * MaxPooledPages pages are kept on a free list per size class when released, and reused by the
+ * next allocation of the same size on the same thread. Larger blocks, and blocks released while
+ * the thread's pool is at its resident byte limit, go straight back to the heap.
+ *
+ * Blocks may be released on a different thread than the one they were allocated on, in which case
+ * they join the releasing thread's pool.
+ */
+class SlicePool {
+public:
+  static constexpr uint64_t PageSize = 4096;
+  static constexpr uint64_t MaxPooledPages = 16;
+  static constexpr uint64_t DefaultMaxResidentBytesPerThread = 4 * 1024 * 1024;
+
+  /**
+   * @param size the size of the block in bytes, which must be a nonzero multiple of PageSize.
+   * @return a block of at least size bytes, aligned for any type.
+   */
+  static void* allocate(uint64_t size);
+
+  /**
+   * Return a block obtained from allocate().
+   * @param block the block.
+   * @param size the size that was passed to allocate().
+   */
+  static void release(void* block, uint64_t size);
+
+  /**
+   * Set the maximum number of bytes each thread may hold in free blocks. Lowering the limit does
+   * not free blocks which are already cached.
+   * @param max_bytes the limit; zero disables pooling.
+   */
+  static void setMaxResidentBytesPerThread(uint64_t max_bytes);
+
+  /**
+   * @return uint64_t the number of pooled-size allocations satisfied from a free list.
+   * @note the values returned by hits(), misses() and residentBytes() are published periodically
+   *       by each thread so may lag slightly behind.
+   */
+  static uint64_t hits();
+
+  /**
+   * @return uint64_t the number of pooled-size allocations which had to go to the heap.
+   */
+  static uint64_t misses();
+
+  /**
+   * @return uint64_t the number of bytes held in free blocks across all threads.
+   */
+  static uint64_t residentBytes();
+};
+
+} // namespace Buffer
+} // namespace Envoy
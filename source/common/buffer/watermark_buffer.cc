@@ -1,9 +1,43 @@
 #include "common/buffer/watermark_buffer.h"
 
+#include <algorithm>
+#include <atomic>
+
 #include "common/common/assert.h"
 
 namespace Envoy {
 namespace Buffer {
+namespace {
+
+// The changes of the lengths of the buffers of a thread are published to the total of the process
+// once they add up to this many bytes, rather than contending for the total on every change.
+constexpr int64_t BufferedBytesBatch = 64 * 1024;
+
+std::atomic<int64_t> total_buffered_bytes{0};
+thread_local int64_t pending_buffered_bytes = 0;
+thread_local int64_t thread_buffered_bytes = 0;
+
+void addBufferedBytes(int64_t delta) {
+  thread_buffered_bytes += delta;
+  pending_buffered_bytes += delta;
+  if (pending_buffered_bytes >= BufferedBytesBatch ||
+      pending_buffered_bytes <= -BufferedBytesBatch) {
+    total_buffered_bytes.fetch_add(pending_buffered_bytes, std::memory_order_relaxed);
+    pending_buffered_bytes = 0;
+  }
+}
+
+} // namespace
+
+WatermarkBuffer::~WatermarkBuffer() { addBufferedBytes(-static_cast<int64_t>(accounted_length_)); }
+
+uint64_t WatermarkBuffer::totalBufferedBytes() {
+  return std::max<int64_t>(0, total_buffered_bytes.load(std::memory_order_relaxed));
+}
+
+uint64_t WatermarkBuffer::threadBufferedBytes() {
+  return std::max<int64_t>(0, thread_buffered_bytes);
+}
 
 void WatermarkBuffer::add(const void* data, uint64_t size) {
   OwnedImpl::add(data, size);
@@ -76,7 +110,16 @@ void WatermarkBuffer::setWatermarks(uint32_t low_watermark, uint32_t high_waterm
   checkLowWatermark();
 }
 
+void WatermarkBuffer::updateBufferedBytes() {
+  const uint64_t length = OwnedImpl::length();
+  if (length != accounted_length_) {
+    addBufferedBytes(static_cast<int64_t>(length) - static_cast<int64_t>(accounted_length_));
+    accounted_length_ = length;
+  }
+}
+
 void WatermarkBuffer::checkLowWatermark() {
+  updateBufferedBytes();
   if (!above_high_watermark_called_ ||
       (high_watermark_ != 0 && OwnedImpl::length() >= low_watermark_)) {
     return;
@@ -87,6 +130,7 @@ void WatermarkBuffer::checkLowWatermark() {
 }
 
 void WatermarkBuffer::checkHighWatermark() {
+  updateBufferedBytes();
   if (above_high_watermark_called_ || high_watermark_ == 0 ||
       OwnedImpl::length() <= high_watermark_) {
     return;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <string>
 
@@ -18,6 +19,7 @@ public:
   WatermarkBuffer(std::function<void()> below_low_watermark,
                   std::function<void()> above_high_watermark)
       : below_low_watermark_(below_low_watermark), above_high_watermark_(above_high_watermark) {}
+  ~WatermarkBuffer() override;
 
   // Override all functions from Instance which can result in changing the size
   // of the underlying buffer.
@@ -39,9 +41,23 @@ public:
   void setWatermarks(uint32_t low_watermark, uint32_t high_watermark);
   uint32_t highWatermark() const { return high_watermark_; }
 
+  /**
+   * @return the approximate number of bytes held by all the watermark buffers of the process. The
+   *         changes of the buffers of each thread are published in batches, so the total may be
+   *         off by up to a batch per thread.
+   */
+  static uint64_t totalBufferedBytes();
+
+  /**
+   * @return the number of bytes held by the watermark buffers of the calling thread, as added and
+   *         drained on that thread. Unlike totalBufferedBytes(), it is not batched.
+   */
+  static uint64_t threadBufferedBytes();
+
 private:
   void checkHighWatermark();
   void checkLowWatermark();
+  void updateBufferedBytes();
 
   std::function<void()> below_low_watermark_;
   std::function<void()> above_high_watermark_;
@@ -54,6 +70,8 @@ private:
   // True between the time above_high_watermark_ has been called until above_high_watermark_ has
   // been called.
   bool above_high_watermark_called_{false};
+  // The length of the buffer last accounted for in the total of the process.
+  uint64_t accounted_length_{0};
 };
 
 using WatermarkBufferPtr = std::unique_ptr<WatermarkBuffer>;
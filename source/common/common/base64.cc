@@ -1,8 +1,10 @@
 #include "common/common/base64.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 
+#include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/stack_array.h"
 
@@ -47,95 +49,217 @@ constexpr unsigned char URL_REVERSE_LOOKUP_TABLE[256] = {
     64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64};
 // clang-format on
 
-inline bool decodeBase(const uint8_t cur_char, uint64_t pos, std::string& ret,
-                       const unsigned char* const reverse_lookup_table) {
-  const unsigned char c = reverse_lookup_table[static_cast<uint32_t>(cur_char)];
-  if (c == 64) {
-    // Invalid character
+// The value of the chars out of the alphabet in the reverse lookup tables, the only one with this
+// bit set.
+constexpr unsigned char INVALID_CHAR = 64;
+
+// Decodes a block of 4 chars into 3 bytes, returning false if any of the chars is invalid.
+inline bool decodeBlock(const uint8_t* input, uint8_t* output,
+                        const unsigned char* const reverse_lookup_table) {
+  const uint32_t a = reverse_lookup_table[input[0]];
+  const uint32_t b = reverse_lookup_table[input[1]];
+  const uint32_t c = reverse_lookup_table[input[2]];
+  const uint32_t d = reverse_lookup_table[input[3]];
+  if ((a | b | c | d) & INVALID_CHAR) {
     return false;
   }
-
-  switch (pos % 4) {
-  case 0:
-    ret.push_back(c << 2);
-    break;
-  case 1:
-    ret.back() |= c >> 4;
-    ret.push_back(c << 4);
-    break;
-  case 2:
-    ret.back() |= c >> 2;
-    ret.push_back(c << 6);
-    break;
-  case 3:
-    ret.back() |= c;
-    break;
-  }
+  const uint32_t value = (a << 18) | (b << 12) | (c << 6) | d;
+  output[0] = value >> 16;
+  output[1] = value >> 8;
+  output[2] = value;
   return true;
 }
 
-inline bool decodeLast(const uint8_t cur_char, uint64_t pos, std::string& ret,
+// Decodes the chars following the last complete block, without their padding. 2 chars decode into
+// 1 byte and 3 chars into 2, whose trailing bits must be zero.
+inline bool decodeTail(const uint8_t* input, uint64_t length, uint8_t* output,
                        const unsigned char* const reverse_lookup_table) {
-  const unsigned char c = reverse_lookup_table[static_cast<uint32_t>(cur_char)];
-  if (c == 64) {
-    // Invalid character
+  if (length == 0) {
+    return true;
+  }
+  if (length == 1) {
+    return false;
+  }
+  const uint32_t a = reverse_lookup_table[input[0]];
+  const uint32_t b = reverse_lookup_table[input[1]];
+  const uint32_t c = length == 3 ? reverse_lookup_table[input[2]] : 0;
+  if ((a | b | c) & INVALID_CHAR) {
     return false;
   }
+  const uint32_t value = (a << 18) | (b << 12) | (c << 6);
+  output[0] = value >> 16;
+  if (length == 3) {
+    output[1] = value >> 8;
+    return (value & 0xff) == 0;
+  }
+  return (value & 0xffff) == 0;
+}
+
+// Decodes chars, which are not padded, into output, which must hold decodedLength(length) bytes.
+inline bool decodeChars(const uint8_t* input, uint64_t length, uint8_t* output,
+                        const unsigned char* const reverse_lookup_table) {
+  const uint8_t* const blocks_end = input + length / 4 * 4;
+  for (; input != blocks_end; input += 4, output += 3) {
+    if (!decodeBlock(input, output, reverse_lookup_table)) {
+      return false;
+    }
+  }
+  return decodeTail(input, length % 4, output, reverse_lookup_table);
+}
 
-  switch (pos % 4) {
-  case 0:
+// The number of bytes the given number of chars, which are not padded, decode into.
+inline uint64_t decodedLength(uint64_t length) {
+  return length / 4 * 3 + (length % 4 == 0 ? 0 : length % 4 - 1);
+}
+
+// Decodes the last block of padded input, returning the number of bytes decoded, or 0 if the block
+// is invalid.
+inline uint64_t decodePaddedBlock(const uint8_t* input, uint8_t* output) {
+  if (input[3] != '=') {
+    return decodeBlock(input, output, REVERSE_LOOKUP_TABLE) ? 3 : 0;
+  }
+  const uint64_t length = input[2] == '=' ? 2 : 3;
+  return decodeTail(input, length, output, REVERSE_LOOKUP_TABLE) ? length - 1 : 0;
+}
+
+// Decodes a padded buffer slice by slice into output, which must hold length / 4 * 3 bytes, where
+// length is the length of the buffer, a non zero multiple of 4. Only the chars spanning two slices
+// are copied before being decoded.
+bool decodeBuffer(const Buffer::Instance& buffer, uint8_t* output, uint64_t& decoded) {
+  uint64_t num_slices = buffer.getRawSlices(nullptr, 0);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  buffer.getRawSlices(slices.begin(), num_slices);
+
+  uint8_t* const output_begin = output;
+  // The last block is decoded on its own, as it may be padded.
+  uint64_t blocks_left = buffer.length() / 4 - 1;
+  uint8_t block[4];
+  uint64_t carried = 0;
+  for (const Buffer::RawSlice& slice : slices) {
+    const uint8_t* input = static_cast<const uint8_t*>(slice.mem_);
+    uint64_t remaining = slice.len_;
+    while (remaining != 0) {
+      if (carried == 0 && blocks_left != 0 && remaining >= 4) {
+        const uint64_t blocks = std::min(remaining / 4, blocks_left);
+        if (!decodeChars(input, blocks * 4, output, REVERSE_LOOKUP_TABLE)) {
+          return false;
+        }
+        input += blocks * 4;
+        output += blocks * 3;
+        remaining -= blocks * 4;
+        blocks_left -= blocks;
+        continue;
+      }
+      block[carried++] = *input++;
+      remaining--;
+      if (carried == 4 && blocks_left != 0) {
+        if (!decodeBlock(block, output, REVERSE_LOOKUP_TABLE)) {
+          return false;
+        }
+        output += 3;
+        blocks_left--;
+        carried = 0;
+      }
+    }
+  }
+  ASSERT(carried == 4 && blocks_left == 0);
+
+  const uint64_t last_decoded = decodePaddedBlock(block, output);
+  if (last_decoded == 0) {
     return false;
-  case 1:
-    ret.back() |= c >> 4;
-    return (c & 0b1111) == 0;
-  case 2:
-    ret.back() |= c >> 2;
-    return (c & 0b11) == 0;
-  case 3:
-    ret.back() |= c;
-    break;
   }
+  decoded = output - output_begin + last_decoded;
   return true;
 }
 
-inline void encodeBase(const uint8_t cur_char, uint64_t pos, uint8_t& next_c, std::string& ret,
-                       const char* const char_table) {
-  switch (pos % 3) {
-  case 0:
-    ret.push_back(char_table[cur_char >> 2]);
-    next_c = (cur_char & 0x03) << 4;
-    break;
-  case 1:
-    ret.push_back(char_table[next_c | (cur_char >> 4)]);
-    next_c = (cur_char & 0x0f) << 2;
-    break;
-  case 2:
-    ret.push_back(char_table[next_c | (cur_char >> 6)]);
-    ret.push_back(char_table[cur_char & 0x3f]);
-    next_c = 0;
-    break;
+// Encodes a block of 3 bytes into 4 chars.
+inline void encodeBlock(const uint8_t* input, char* output, const char* const char_table) {
+  const uint32_t value = (input[0] << 16) | (input[1] << 8) | input[2];
+  output[0] = char_table[value >> 18];
+  output[1] = char_table[(value >> 12) & 0x3f];
+  output[2] = char_table[(value >> 6) & 0x3f];
+  output[3] = char_table[value & 0x3f];
+}
+
+// Encodes the 1 or 2 bytes following the last complete block, returning the number of chars
+// written.
+inline uint64_t encodeTail(const uint8_t* input, uint64_t length, char* output,
+                           const char* const char_table, bool add_padding) {
+  if (length == 0) {
+    return 0;
+  }
+  const uint32_t value = (input[0] << 16) | (length == 2 ? input[1] << 8 : 0);
+  output[0] = char_table[value >> 18];
+  output[1] = char_table[(value >> 12) & 0x3f];
+  if (length == 2) {
+    output[2] = char_table[(value >> 6) & 0x3f];
+  }
+  if (!add_padding) {
+    return length + 1;
+  }
+  if (length == 1) {
+    output[2] = '=';
+  }
+  output[3] = '=';
+  return 4;
+}
+
+// The number of chars the given number of bytes encode into.
+inline uint64_t encodedLength(uint64_t length, bool add_padding) {
+  if (add_padding) {
+    return (length + 2) / 3 * 4;
+  }
+  return length / 3 * 4 + (length % 3 == 0 ? 0 : length % 3 + 1);
+}
+
+// Encodes bytes into output, which must hold encodedLength(length, add_padding) chars.
+inline uint64_t encodeBytes(const uint8_t* input, uint64_t length, char* output,
+                            const char* const char_table, bool add_padding) {
+  const uint8_t* const blocks_end = input + length / 3 * 3;
+  char* const output_begin = output;
+  for (; input != blocks_end; input += 3, output += 4) {
+    encodeBlock(input, output, char_table);
   }
+  output += encodeTail(input, length % 3, output, char_table, add_padding);
+  return output - output_begin;
 }
 
-inline void encodeLast(uint64_t pos, uint8_t last_char, std::string& ret,
-                       const char* const char_table, bool add_padding) {
-  switch (pos % 3) {
-  case 1:
-    ret.push_back(char_table[last_char]);
-    if (add_padding) {
-      ret.push_back('=');
-      ret.push_back('=');
+// Encodes the first length bytes of a buffer slice by slice into output, which must hold
+// encodedLength(length, true) chars. Only the bytes spanning two slices are copied before being
+// encoded.
+void encodeBuffer(const Buffer::Instance& buffer, uint64_t length, char* output) {
+  uint64_t num_slices = buffer.getRawSlices(nullptr, 0);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  buffer.getRawSlices(slices.begin(), num_slices);
+
+  uint8_t block[3];
+  uint64_t carried = 0;
+  for (const Buffer::RawSlice& slice : slices) {
+    if (length == 0) {
+      break;
+    }
+    const uint8_t* input = static_cast<const uint8_t*>(slice.mem_);
+    uint64_t remaining = std::min(slice.len_, length);
+    length -= remaining;
+    // Completes the block started by the previous slices.
+    while (carried != 0 && remaining != 0) {
+      block[carried++] = *input++;
+      remaining--;
+      if (carried == 3) {
+        encodeBlock(block, output, CHAR_TABLE);
+        output += 4;
+        carried = 0;
+      }
     }
-    break;
-  case 2:
-    ret.push_back(char_table[last_char]);
-    if (add_padding) {
-      ret.push_back('=');
+    const uint64_t blocks_length = remaining / 3 * 3;
+    output += encodeBytes(input, blocks_length, output, CHAR_TABLE, true);
+    input += blocks_length;
+    remaining -= blocks_length;
+    while (remaining-- != 0) {
+      block[carried++] = *input++;
     }
-    break;
-  default:
-    break;
   }
+  encodeTail(block, carried, output, CHAR_TABLE, true);
 }
 
 } // namespace
@@ -148,71 +272,67 @@ std::string Base64::decode(const std::string& input) {
 }
 
 std::string Base64::decodeWithoutPadding(absl::string_view input) {
-  if (input.empty()) {
-    return EMPTY_STRING;
-  }
-
   // At most last two chars can be '='.
   size_t n = input.length();
-  if (input[n - 1] == '=') {
+  if (n > 0 && input[n - 1] == '=') {
     n--;
     if (n > 0 && input[n - 1] == '=') {
       n--;
     }
   }
-  // Last position before "valid" padding character.
-  uint64_t last = n - 1;
-  // Determine output length.
-  size_t max_length = (n + 3) / 4 * 3;
-  if (n % 4 == 3) {
-    max_length -= 1;
-  }
-  if (n % 4 == 2) {
-    max_length -= 2;
-  }
-
-  std::string ret;
-  ret.reserve(max_length);
-  for (uint64_t i = 0; i < last; ++i) {
-    if (!decodeBase(input[i], i, ret, REVERSE_LOOKUP_TABLE)) {
-      return EMPTY_STRING;
-    }
+  if (n == 0) {
+    return EMPTY_STRING;
   }
 
-  if (!decodeLast(input[last], last, ret, REVERSE_LOOKUP_TABLE)) {
+  std::string ret(decodedLength(n), '\0');
+  if (!decodeChars(reinterpret_cast<const uint8_t*>(input.data()), n,
+                   reinterpret_cast<uint8_t*>(&ret[0]), REVERSE_LOOKUP_TABLE)) {
     return EMPTY_STRING;
   }
-
-  ASSERT(ret.size() == max_length);
   return ret;
 }
 
-std::string Base64::encode(const Buffer::Instance& buffer, uint64_t length) {
-  uint64_t output_length = (std::min(length, buffer.length()) + 2) / 3 * 4;
-  std::string ret;
-  ret.reserve(output_length);
-
-  uint64_t num_slices = buffer.getRawSlices(nullptr, 0);
-  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
-  buffer.getRawSlices(slices.begin(), num_slices);
+bool Base64::decode(const Buffer::Instance& input, Buffer::Instance& output) {
+  ASSERT(&input != &output);
+  const uint64_t length = input.length();
+  if (length == 0) {
+    return true;
+  }
+  if (length % 4) {
+    return false;
+  }
 
-  uint64_t j = 0;
-  uint8_t next_c = 0;
-  for (const Buffer::RawSlice& slice : slices) {
-    const uint8_t* slice_mem = static_cast<const uint8_t*>(slice.mem_);
+  Buffer::RawSlice slice;
+  output.reserve(length / 4 * 3, &slice, 1);
+  uint64_t decoded;
+  if (!decodeBuffer(input, static_cast<uint8_t*>(slice.mem_), decoded)) {
+    // The reservation is left uncommitted, so nothing is added to the output.
+    return false;
+  }
+  slice.len_ = decoded;
+  output.commit(&slice, 1);
+  return true;
+}
 
-    for (uint64_t i = 0; i < slice.len_ && j < length; ++i, ++j) {
-      encodeBase(slice_mem[i], j, next_c, ret, CHAR_TABLE);
-    }
+std::string Base64::encode(const Buffer::Instance& buffer, uint64_t length) {
+  length = std::min(length, buffer.length());
+  std::string ret(encodedLength(length, true), '\0');
+  encodeBuffer(buffer, length, &ret[0]);
+  return ret;
+}
 
-    if (j == length) {
-      break;
-    }
+void Base64::encode(const Buffer::Instance& input, uint64_t length, Buffer::Instance& output) {
+  ASSERT(&input != &output);
+  length = std::min(length, input.length());
+  if (length == 0) {
+    return;
   }
 
-  encodeLast(j, next_c, ret, CHAR_TABLE, true);
-
-  return ret;
+  Buffer::RawSlice slice;
+  output.reserve(encodedLength(length, true), &slice, 1);
+  encodeBuffer(input, length, static_cast<char*>(slice.mem_));
+  slice.len_ = encodedLength(length, true);
+  output.commit(&slice, 1);
 }
 
 std::string Base64::encode(const char* input, uint64_t length) {
@@ -220,19 +340,8 @@ std::string Base64::encode(const char* input, uint64_t length) {
 }
 
 std::string Base64::encode(const char* input, uint64_t length, bool add_padding) {
-  uint64_t output_length = (length + 2) / 3 * 4;
-  std::string ret;
-  ret.reserve(output_length);
-
-  uint64_t pos = 0;
-  uint8_t next_c = 0;
-
-  for (uint64_t i = 0; i < length; ++i) {
-    encodeBase(input[i], pos++, next_c, ret, CHAR_TABLE);
-  }
-
-  encodeLast(pos, next_c, ret, CHAR_TABLE, add_padding);
-
+  std::string ret(encodedLength(length, add_padding), '\0');
+  encodeBytes(reinterpret_cast<const uint8_t*>(input), length, &ret[0], CHAR_TABLE, add_padding);
   return ret;
 }
 
@@ -241,37 +350,17 @@ std::string Base64Url::decode(const std::string& input) {
     return EMPTY_STRING;
   }
 
-  std::string ret;
-  ret.reserve(input.length() / 4 * 3 + 3);
-
-  uint64_t last = input.length() - 1;
-  for (uint64_t i = 0; i < last; ++i) {
-    if (!decodeBase(input[i], i, ret, URL_REVERSE_LOOKUP_TABLE)) {
-      return EMPTY_STRING;
-    }
-  }
-
-  if (!decodeLast(input[last], last, ret, URL_REVERSE_LOOKUP_TABLE)) {
+  std::string ret(decodedLength(input.length()), '\0');
+  if (!decodeChars(reinterpret_cast<const uint8_t*>(input.data()), input.length(),
+                   reinterpret_cast<uint8_t*>(&ret[0]), URL_REVERSE_LOOKUP_TABLE)) {
     return EMPTY_STRING;
   }
-
   return ret;
 }
 
 std::string Base64Url::encode(const char* input, uint64_t length) {
-  uint64_t output_length = (length + 2) / 3 * 4;
-  std::string ret;
-  ret.reserve(output_length);
-
-  uint64_t pos = 0;
-  uint8_t next_c = 0;
-
-  for (uint64_t i = 0; i < length; ++i) {
-    encodeBase(input[i], pos++, next_c, ret, URL_CHAR_TABLE);
-  }
-
-  encodeLast(pos, next_c, ret, URL_CHAR_TABLE, false);
-
+  std::string ret(encodedLength(length, false), '\0');
+  encodeBytes(reinterpret_cast<const uint8_t*>(input), length, &ret[0], URL_CHAR_TABLE, false);
   return ret;
 }
 
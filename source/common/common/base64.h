@@ -22,6 +22,15 @@ public:
    */
   static std::string encode(const Buffer::Instance& buffer, uint64_t length);
 
+  /**
+   * Base64 encode an input buffer into an output buffer, slice by slice, without copying the input
+   * or the output through a string.
+   * @param input supplies the buffer to encode.
+   * @param length supplies the length to encode which may be <= the input length.
+   * @param output supplies the buffer to add the encoded data to, which must not be the input.
+   */
+  static void encode(const Buffer::Instance& input, uint64_t length, Buffer::Instance& output);
+
   /**
    * Base64 encode an input char buffer with a given length.
    * @param input char array to encode.
@@ -46,6 +55,15 @@ public:
    */
   static std::string decode(const std::string& input);
 
+  /**
+   * Base64 decode an input buffer into an output buffer, slice by slice, without copying the input
+   * or the output through a string. Padding is required.
+   * @param input supplies the buffer to decode.
+   * @param output supplies the buffer to add the decoded data to, which must not be the input.
+   * @return false if the input is not valid base64, in which case nothing is added to the output.
+   */
+  static bool decode(const Buffer::Instance& input, Buffer::Instance& output);
+
   /**
    * Base64 decode an input string. Padding is not required.
    * @param input supplies the input to decode.
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+#include "common/common/thread_annotations.h"
+
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+
+/**
+ * A thread-safe pool of immutable values, shared between the objects holding equal ones. The pool
+ * only holds weak references: a value is freed along with its last holder, and the expired entries
+ * are purged as the pool grows.
+ */
+template <class Value> class Interner {
+public:
+  using ValueSharedPtr = std::shared_ptr<Value>;
+
+  /**
+   * Returns the pooled value equal to the one described, creating it if there is none.
+   * @param hash supplies the hash of the value.
+   * @param equal supplies whether a pooled value with the same hash is equal to the one described.
+   * @param create supplies the value, when none is pooled.
+   * @return the pooled value.
+   */
+  ValueSharedPtr intern(uint64_t hash, const std::function<bool(const Value&)>& equal,
+                        const std::function<ValueSharedPtr()>& create) {
+    absl::MutexLock lock(&mutex_);
+    auto range = values_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      ValueSharedPtr value = it->second.lock();
+      if (value != nullptr && equal(*value)) {
+        return value;
+      }
+    }
+
+    ValueSharedPtr value = create();
+    values_.emplace(hash, value);
+    if (values_.size() >= purge_threshold_) {
+      purgeExpired();
+    }
+    return value;
+  }
+
+  /**
+   * Calls cb with each live pooled value.
+   */
+  void iterate(const std::function<void(const Value&)>& cb) const {
+    absl::MutexLock lock(&mutex_);
+    for (const auto& entry : values_) {
+      ValueSharedPtr value = entry.second.lock();
+      if (value != nullptr) {
+        cb(*value);
+      }
+    }
+  }
+
+private:
+  static constexpr size_t MinPurgeThreshold = 64;
+
+  // Purging is amortized by only doing it once the pool has doubled since the last purge.
+  void purgeExpired() EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    for (auto it = values_.begin(); it != values_.end();) {
+      if (it->second.expired()) {
+        it = values_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    purge_threshold_ = std::max(MinPurgeThreshold, 2 * values_.size());
+  }
+
+  mutable absl::Mutex mutex_;
+  std::unordered_multimap<uint64_t, std::weak_ptr<Value>> values_ GUARDED_BY(mutex_);
+  size_t purge_threshold_ GUARDED_BY(mutex_){MinPurgeThreshold};
+};
+
+template <class Value> constexpr size_t Interner<Value>::MinPurgeThreshold;
+
+} // namespace Envoy
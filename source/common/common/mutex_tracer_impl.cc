@@ -1,14 +1,161 @@
 #include "common/common/mutex_tracer_impl.h"
 
+#include <array>
+#include <cstring>
 #include <iostream>
 #include <memory>
 
 #include "common/common/assert.h"
+#include "common/common/macros.h"
 
 #include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 
+namespace {
+
+constexpr size_t MaxMutexNames = 64;
+constexpr size_t MaxNamedMutexes = 1024;
+constexpr size_t WaitCyclesHistogramBuckets = 16;
+
+size_t waitCyclesBucket(int64_t wait_cycles) {
+  size_t bucket = 0;
+  for (int64_t bound = 1024; bucket < WaitCyclesHistogramBuckets - 1 && wait_cycles >= bound;
+       bound <<= 1) {
+    bucket++;
+  }
+  return bucket;
+}
+
+/**
+ * The names and named mutexes. Both are kept in fixed arrays which are never freed, so that the
+ * contention hook can look up a mutex without taking a lock, as the hook is itself called on the
+ * contention of a lock. Naming a mutex takes mutex_, and only happens on construction of the
+ * owner of the mutex.
+ */
+class NamedMutexRegistry {
+public:
+  size_t add(const void* mutex, const char* name);
+  void remove(size_t slot);
+  void record(const void* mutex, int64_t wait_cycles);
+  void reset();
+  std::vector<MutexTracer::NamedContention> contentions();
+
+private:
+  struct NameStats {
+    const char* name_{};
+    std::atomic<int64_t> num_contentions_{};
+    std::atomic<int64_t> lifetime_wait_cycles_{};
+    std::array<std::atomic<int64_t>, WaitCyclesHistogramBuckets> wait_cycles_histogram_{};
+  };
+
+  struct NamedMutex {
+    std::atomic<const void*> mutex_{};
+    std::atomic<NameStats*> stats_{};
+  };
+
+  static constexpr std::memory_order order_{std::memory_order_relaxed};
+
+  absl::Mutex mutex_;
+  std::array<NameStats, MaxMutexNames> names_;
+  std::atomic<size_t> num_names_{};
+  std::array<NamedMutex, MaxNamedMutexes> mutexes_;
+  // One past the highest slot used so far, which bounds the search of the contention hook.
+  std::atomic<size_t> num_slots_{};
+};
+
+NamedMutexRegistry& registry() { MUTABLE_CONSTRUCT_ON_FIRST_USE(NamedMutexRegistry); }
+
+size_t NamedMutexRegistry::add(const void* mutex, const char* name) {
+  absl::MutexLock lock(&mutex_);
+  NameStats* stats = nullptr;
+  const size_t num_names = num_names_.load(order_);
+  for (size_t i = 0; i < num_names; i++) {
+    if (strcmp(names_[i].name_, name) == 0) {
+      stats = &names_[i];
+      break;
+    }
+  }
+  if (stats == nullptr) {
+    if (num_names == MaxMutexNames) {
+      return MaxNamedMutexes;
+    }
+    stats = &names_[num_names];
+    stats->name_ = name;
+    num_names_.store(num_names + 1, std::memory_order_release);
+  }
+
+  for (size_t slot = 0; slot < MaxNamedMutexes; slot++) {
+    if (mutexes_[slot].mutex_.load(order_) == nullptr) {
+      // The stats are published before the mutex, which the contention hook matches first.
+      mutexes_[slot].stats_.store(stats, order_);
+      mutexes_[slot].mutex_.store(mutex, std::memory_order_release);
+      if (slot >= num_slots_.load(order_)) {
+        num_slots_.store(slot + 1, std::memory_order_release);
+      }
+      return slot;
+    }
+  }
+  return MaxNamedMutexes;
+}
+
+void NamedMutexRegistry::remove(size_t slot) {
+  if (slot == MaxNamedMutexes) {
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  mutexes_[slot].mutex_.store(nullptr, std::memory_order_release);
+}
+
+void NamedMutexRegistry::record(const void* mutex, int64_t wait_cycles) {
+  const size_t num_slots = num_slots_.load(std::memory_order_acquire);
+  for (size_t slot = 0; slot < num_slots; slot++) {
+    if (mutexes_[slot].mutex_.load(std::memory_order_acquire) == mutex) {
+      NameStats& stats = *mutexes_[slot].stats_.load(order_);
+      stats.num_contentions_.fetch_add(1, order_);
+      stats.lifetime_wait_cycles_.fetch_add(wait_cycles, order_);
+      stats.wait_cycles_histogram_[waitCyclesBucket(wait_cycles)].fetch_add(1, order_);
+      return;
+    }
+  }
+}
+
+void NamedMutexRegistry::reset() {
+  absl::MutexLock lock(&mutex_);
+  for (NameStats& stats : names_) {
+    stats.num_contentions_.store(0, order_);
+    stats.lifetime_wait_cycles_.store(0, order_);
+    for (auto& bucket : stats.wait_cycles_histogram_) {
+      bucket.store(0, order_);
+    }
+  }
+}
+
+std::vector<MutexTracer::NamedContention> NamedMutexRegistry::contentions() {
+  absl::MutexLock lock(&mutex_);
+  std::vector<MutexTracer::NamedContention> contentions;
+  const size_t num_names = num_names_.load(order_);
+  contentions.reserve(num_names);
+  for (size_t i = 0; i < num_names; i++) {
+    const NameStats& stats = names_[i];
+    std::vector<int64_t> histogram;
+    histogram.reserve(WaitCyclesHistogramBuckets);
+    for (const auto& bucket : stats.wait_cycles_histogram_) {
+      histogram.push_back(bucket.load(order_));
+    }
+    contentions.push_back({stats.name_, stats.num_contentions_.load(order_),
+                           stats.lifetime_wait_cycles_.load(order_), std::move(histogram)});
+  }
+  return contentions;
+}
+
+} // namespace
+
+MutexContentionName::MutexContentionName(const void* mutex, const char* name)
+    : slot_(registry().add(mutex, name)) {}
+
+MutexContentionName::~MutexContentionName() { registry().remove(slot_); }
+
 MutexTracerImpl* MutexTracerImpl::singleton_ = nullptr;
 
 MutexTracerImpl& MutexTracerImpl::getOrCreateTracer() {
@@ -31,12 +178,18 @@ void MutexTracerImpl::reset() {
   num_contentions_.store(0, order_);
   current_wait_cycles_.store(0, order_);
   lifetime_wait_cycles_.store(0, order_);
+  registry().reset();
+}
+
+std::vector<MutexTracer::NamedContention> MutexTracerImpl::namedContentions() const {
+  return registry().contentions();
 }
 
-inline void MutexTracerImpl::recordContention(const char*, const void*, int64_t wait_cycles) {
+inline void MutexTracerImpl::recordContention(const char*, const void* obj, int64_t wait_cycles) {
   num_contentions_.fetch_add(1, order_);
   current_wait_cycles_.store(wait_cycles, order_);
   lifetime_wait_cycles_.fetch_add(wait_cycles, order_);
+  registry().record(obj, wait_cycles);
 }
 
 } // namespace Envoy
@@ -3,6 +3,7 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include "envoy/common/mutex_tracer.h"
 
@@ -30,6 +31,7 @@ public:
   int64_t numContentions() const override { return num_contentions_.load(order_); }
   int64_t currentWaitCycles() const override { return current_wait_cycles_.load(order_); }
   int64_t lifetimeWaitCycles() const override { return lifetime_wait_cycles_.load(order_); }
+  std::vector<NamedContention> namedContentions() const override;
 
 private:
   friend class MutexTracerTest;
@@ -38,7 +40,7 @@ private:
   static void contentionHook(const char* msg, const void* obj, int64_t wait_cycles);
 
   // Utility function for contentionHook.
-  inline void recordContention(const char*, const void*, int64_t wait_cycles);
+  inline void recordContention(const char*, const void* obj, int64_t wait_cycles);
 
   // Keeping singleton_ as a static class member avoids the barrier-lookup for the tracer object on
   // every contention.
@@ -56,4 +58,27 @@ private:
   static constexpr std::memory_order order_{std::memory_order_relaxed};
 };
 
+/**
+ * Names a mutex in the per name contention statistics of the mutex tracer, for the lifetime of
+ * this object, which should be declared right after the mutex. The contentions of the mutexes
+ * sharing a name are aggregated. The tracer has room for 1024 mutexes under 64 names, and the
+ * mutexes beyond that are only counted in the totals.
+ */
+class MutexContentionName {
+public:
+  /**
+   * @param mutex supplies the address of the absl::Mutex, as passed to the contention hook. See
+   *        Thread::MutexBasicLockable::contentionId().
+   * @param name supplies the name, which must outlive the process, e.g. a string literal.
+   */
+  MutexContentionName(const void* mutex, const char* name);
+  ~MutexContentionName();
+
+  MutexContentionName(const MutexContentionName&) = delete;
+  MutexContentionName& operator=(const MutexContentionName&) = delete;
+
+private:
+  const size_t slot_;
+};
+
 } // namespace Envoy
@@ -0,0 +1,98 @@
+#include "common/common/regex.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+#include "common/common/utility.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Regex {
+
+RE2::Options Re2Utility::options() {
+  RE2::Options options;
+  options.set_encoding(RE2::Options::EncodingLatin1);
+  options.set_never_capture(true);
+  options.set_log_errors(false);
+  return options;
+}
+
+bool Re2Utility::compatible(const std::string& regex) {
+  // std::regex treats unknown letter escapes such as \A, \z or \Q as literal letters and digit
+  // escapes as back references, while RE2 gives them other meanings. Other ECMAScript constructs
+  // which RE2 does not support, such as lookahead assertions, are rejected by RE2 itself.
+  for (size_t i = 0; i < regex.size(); i++) {
+    if (regex[i] != '\\') {
+      continue;
+    }
+    if (++i == regex.size()) {
+      return false;
+    }
+    const char c = regex[i];
+    if (absl::ascii_isdigit(c) ||
+        (absl::ascii_isalpha(c) && absl::string_view("bBdDfnrsStvwWx").find(c) ==
+                                       absl::string_view::npos)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Re2Utility::canMatch(absl::string_view value) {
+  return value.find('\v') == absl::string_view::npos;
+}
+
+PrefilteredRegex::PrefilteredRegex(const std::string& regex)
+    : regex_(RegexUtil::parseRegex(regex)) {
+  if (Re2Utility::compatible(regex)) {
+    auto prefilter = std::make_unique<const RE2>(regex, Re2Utility::options());
+    if (prefilter->ok()) {
+      prefilter_ = std::move(prefilter);
+    }
+  }
+}
+
+bool PrefilteredRegex::matches(absl::string_view value) const {
+  if (prefilter_ != nullptr && Re2Utility::canMatch(value) &&
+      !RE2::FullMatch(re2::StringPiece(value.data(), value.size()), *prefilter_)) {
+    return false;
+  }
+  return std::regex_match(value.begin(), value.end(), regex_);
+}
+
+PrefilterSet::PrefilterSet() : set_(Re2Utility::options(), RE2::ANCHOR_BOTH) {}
+
+bool PrefilterSet::add(const std::string& regex) {
+  ASSERT(!compiled_);
+  if (!Re2Utility::compatible(regex) || set_.Add(regex, nullptr) < 0) {
+    return false;
+  }
+  size_++;
+  return true;
+}
+
+void PrefilterSet::compile() {
+  ASSERT(!compiled_);
+  compiled_ = size_ == 0 || set_.Compile();
+}
+
+bool PrefilterSet::match(absl::string_view value, std::vector<int>& indices) const {
+  indices.clear();
+  if (size_ == 0) {
+    return true;
+  }
+  if (!compiled_ || !Re2Utility::canMatch(value)) {
+    return false;
+  }
+  RE2::Set::ErrorInfo error_info;
+  if (!set_.Match(re2::StringPiece(value.data(), value.size()), &indices, &error_info)) {
+    // Running out of memory for the DFA is reported as a failure to match.
+    return error_info.kind == RE2::Set::kNoError;
+  }
+  std::sort(indices.begin(), indices.end());
+  return true;
+}
+
+} // namespace Regex
+} // namespace Envoy
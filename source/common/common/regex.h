@@ -0,0 +1,112 @@
+#pragma once
+
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "re2/re2.h"
+#include "re2/set.h"
+
+namespace Envoy {
+namespace Regex {
+
+/**
+ * Utilities for evaluating regular expressions configured with std::regex ECMAScript syntax with
+ * RE2, which matches in linear time without backtracking. RE2 does not support every ECMAScript
+ * construct, and gives meaning to some escapes which std::regex treats as literals, so only the
+ * patterns for which both describe the same strings are handed to RE2. std::regex's \s matches a
+ * vertical tab while RE2's does not, so RE2 is not consulted on values containing one.
+ */
+class Re2Utility {
+public:
+  /**
+   * @return the options under which RE2 matches bytes, as std::regex does, rather than UTF-8
+   *         characters.
+   */
+  static RE2::Options options();
+
+  /**
+   * @param regex supplies a pattern accepted by std::regex.
+   * @return whether RE2 interprets the pattern as std::regex does, if RE2 accepts it.
+   */
+  static bool compatible(const std::string& regex);
+
+  /**
+   * @param value supplies a value to be matched.
+   * @return whether RE2 may be used in place of std::regex to match the value.
+   */
+  static bool canMatch(absl::string_view value);
+};
+
+/**
+ * A regular expression which must match a whole value. Where RE2 supports the pattern, values are
+ * first matched with RE2, so most values which do not match are rejected in linear time. Values
+ * which RE2 matches are confirmed with std::regex, so the result is always that of std::regex.
+ */
+class PrefilteredRegex {
+public:
+  /**
+   * @param regex supplies the pattern, with std::regex ECMAScript syntax.
+   * @throw EnvoyException if the regex string is invalid.
+   */
+  explicit PrefilteredRegex(const std::string& regex);
+
+  /**
+   * @return whether the whole value matches the regular expression.
+   */
+  bool matches(absl::string_view value) const;
+
+private:
+  std::regex regex_;
+  std::unique_ptr<const RE2> prefilter_;
+};
+
+/**
+ * A set of regular expressions, each of which must match a whole value, matched against a value
+ * in a single pass. Patterns which RE2 does not support are not added to the set, and have to be
+ * matched separately.
+ */
+class PrefilterSet {
+public:
+  PrefilterSet();
+
+  /**
+   * Adds a pattern to the set. Patterns are identified by their index in the order they were
+   * added, counting only the patterns for which this returned true.
+   * @param regex supplies the pattern, with std::regex ECMAScript syntax.
+   * @return whether the pattern was added.
+   */
+  bool add(const std::string& regex);
+
+  /**
+   * Compiles the set. This must be called once, after all patterns have been added and before the
+   * set is matched.
+   */
+  void compile();
+
+  /**
+   * @return the number of patterns in the set.
+   */
+  uint32_t size() const { return size_; }
+
+  /**
+   * Finds the patterns in the set which may match a value. Patterns which are not found do not
+   * match the value with std::regex either, while patterns which are found still have to be
+   * confirmed with std::regex.
+   * @param value supplies the value to be matched.
+   * @param indices returns the indices of the patterns which may match, in increasing order.
+   * @return false if the set could not be matched against the value, in which case every pattern
+   *         in the set may match.
+   */
+  bool match(absl::string_view value, std::vector<int>& indices) const;
+
+private:
+  RE2::Set set_;
+  uint32_t size_{};
+  bool compiled_{};
+};
+
+} // namespace Regex
+} // namespace Envoy
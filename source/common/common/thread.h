@@ -20,6 +20,12 @@ public:
   bool tryLock() EXCLUSIVE_TRYLOCK_FUNCTION(true) override { return mutex_.TryLock(); }
   void unlock() UNLOCK_FUNCTION() override { mutex_.Unlock(); }
 
+  /**
+   * @return the address which identifies the mutex to the contention hook of the mutex tracer,
+   *         see MutexContentionName.
+   */
+  const void* contentionId() const { return &mutex_; }
+
 private:
   friend class CondVar;
   absl::Mutex mutex_;
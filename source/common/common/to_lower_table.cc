@@ -1,5 +1,8 @@
 #include "common/common/to_lower_table.h"
 
+#include <cstdint>
+#include <cstring>
+
 namespace Envoy {
 ToLowerTable::ToLowerTable() {
   for (size_t c = 0; c < 256; c++) {
@@ -11,7 +14,26 @@ ToLowerTable::ToLowerTable() {
 }
 
 void ToLowerTable::toLowerCase(char* buffer, uint32_t size) const {
-  for (size_t i = 0; i < size; i++) {
+  constexpr uint64_t Ones = 0x0101010101010101ULL;
+  constexpr uint64_t HighBits = 0x80 * Ones;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, buffer + i, sizeof(word));
+    // For each byte of the word, adding to its low 7 bits never carries into the next byte, and
+    // sets the high bit if the byte is at least 'A', respectively greater than 'Z'. Only the
+    // bytes without their own high bit set are ASCII.
+    const uint64_t low_bits = word & ~HighBits;
+    const uint64_t at_least_a = low_bits + (0x80 - 'A') * Ones;
+    const uint64_t above_z = low_bits + (0x7f - 'Z') * Ones;
+    const uint64_t upper = (at_least_a ^ above_z) & ~word & HighBits;
+    if (upper != 0) {
+      // 0x80 >> 2 is the 0x20 bit which differs between upper and lower case letters.
+      word |= upper >> 2;
+      memcpy(buffer + i, &word, sizeof(word));
+    }
+  }
+  for (; i < size; i++) {
     buffer[i] = table_[static_cast<uint8_t>(buffer[i])];
   }
 }
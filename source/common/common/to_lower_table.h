@@ -5,8 +5,8 @@
 
 namespace Envoy {
 /**
- * Convenience class for converting ASCII strings to lower case using a lookup table for maximum
- * speed.
+ * Convenience class for converting ASCII strings to lower case. The string is converted a word of
+ * 8 bytes at a time, using a lookup table for the remaining bytes.
  */
 class ToLowerTable {
 public:
@@ -72,6 +72,13 @@ public:
    */
   uint64_t checksum();
 
+  /**
+   * Resets the compressor so that it starts a new stream, with the parameters it was initialized
+   * with. Unlike initializing a new compressor, this keeps the memory allocated by zlib for the
+   * compression state. The data of the current stream which was not output yet is discarded.
+   */
+  void reset();
+
   // Compressor
   void compress(Buffer::Instance& buffer, State state) override;
 
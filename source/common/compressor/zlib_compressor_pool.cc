@@ -0,0 +1,27 @@
+#include "common/compressor/zlib_compressor_pool.h"
+
+namespace Envoy {
+namespace Compressor {
+
+ZlibCompressorImplPtr ZlibCompressorPool::acquire() {
+  if (!compressors_.empty()) {
+    ZlibCompressorImplPtr compressor = std::move(compressors_.back());
+    compressors_.pop_back();
+    return compressor;
+  }
+
+  auto compressor = std::make_unique<ZlibCompressorImpl>();
+  compressor->init(level_, strategy_, window_bits_, memory_level_);
+  return compressor;
+}
+
+void ZlibCompressorPool::release(ZlibCompressorImplPtr&& compressor) {
+  if (compressors_.size() >= max_size_) {
+    return;
+  }
+  compressor->reset();
+  compressors_.push_back(std::move(compressor));
+}
+
+} // namespace Compressor
+} // namespace Envoy
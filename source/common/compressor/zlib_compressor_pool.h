@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/compressor/zlib_compressor_impl.h"
+
+namespace Envoy {
+namespace Compressor {
+
+using ZlibCompressorImplPtr = std::unique_ptr<ZlibCompressorImpl>;
+
+/**
+ * A pool of zlib compressors initialized with the same parameters. The compression state of a
+ * deflate stream takes up to several hundred KB with large windows and memory levels, and a
+ * compressor released at the end of a stream is reset and handed to the next one rather than
+ * allocating it again. It is not thread safe, and meant to be held per thread.
+ */
+class ZlibCompressorPool {
+public:
+  /**
+   * @param level, strategy, window_bits and memory_level supply the parameters of the compressors,
+   *        @see ZlibCompressorImpl::init().
+   * @param max_size supplies the maximum number of compressors kept for reuse.
+   */
+  ZlibCompressorPool(ZlibCompressorImpl::CompressionLevel level,
+                     ZlibCompressorImpl::CompressionStrategy strategy, int64_t window_bits,
+                     uint64_t memory_level, uint32_t max_size)
+      : level_(level), strategy_(strategy), window_bits_(window_bits), memory_level_(memory_level),
+        max_size_(max_size) {}
+
+  /**
+   * @return an initialized compressor, ready to start a stream.
+   */
+  ZlibCompressorImplPtr acquire();
+
+  /**
+   * Returns a compressor acquired from the pool, whether its stream finished or not. It is kept
+   * for reuse unless the pool is full.
+   */
+  void release(ZlibCompressorImplPtr&& compressor);
+
+  /**
+   * @return the number of compressors kept for reuse.
+   */
+  size_t size() const { return compressors_.size(); }
+
+private:
+  const ZlibCompressorImpl::CompressionLevel level_;
+  const ZlibCompressorImpl::CompressionStrategy strategy_;
+  const int64_t window_bits_;
+  const uint64_t memory_level_;
+  const uint32_t max_size_;
+  std::vector<ZlibCompressorImplPtr> compressors_;
+};
+
+} // namespace Compressor
+} // namespace Envoy
@@ -1,11 +1,124 @@
 #include "common/config/datasource.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cstring>
+
+#include "envoy/api/os_sys_calls.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/cleanup.h"
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+
+#include "absl/container/flat_hash_map.h"
 #include "fmt/format.h"
 
 namespace Envoy {
 namespace Config {
 namespace DataSource {
 
+namespace {
+
+// Tells whether a file was replaced or modified since it was mapped.
+struct FileIdentity {
+  explicit FileIdentity(const struct stat& file_stat)
+      : device_(file_stat.st_dev), inode_(file_stat.st_ino), size_(file_stat.st_size),
+        modified_(file_stat.st_mtime) {}
+
+  bool operator==(const FileIdentity& other) const {
+    return device_ == other.device_ && inode_ == other.inode_ && size_ == other.size_ &&
+           modified_ == other.modified_;
+  }
+
+  dev_t device_;
+  ino_t inode_;
+  off_t size_;
+  time_t modified_;
+};
+
+class MappedFile : public Contents {
+public:
+  MappedFile(void* data, size_t size) : data_(data), size_(size) {}
+  ~MappedFile() override { ::munmap(data_, size_); }
+
+  // Config::DataSource::Contents
+  absl::string_view data() const override {
+    return absl::string_view(static_cast<const char*>(data_), size_);
+  }
+
+private:
+  void* const data_;
+  const size_t size_;
+};
+
+/**
+ * The files mapped by readShared(), by path. A mapping is unmapped once its last reader releases
+ * it, and replaced once the file changes.
+ */
+class MappedFiles {
+public:
+  ContentsConstSharedPtr map(const std::string& path) {
+    Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+    Thread::LockGuard lock(mutex_);
+    struct stat file_stat;
+    if (os_sys_calls.stat(path.c_str(), &file_stat).rc_ == 0) {
+      const auto it = files_.find(path);
+      if (it != files_.end() && it->second.first == FileIdentity(file_stat)) {
+        ContentsConstSharedPtr mapped = it->second.second.lock();
+        if (mapped != nullptr) {
+          return mapped;
+        }
+      }
+    }
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+      throw EnvoyException(fmt::format("unable to read file: {}", path));
+    }
+    Cleanup close_fd([&os_sys_calls, fd]() { os_sys_calls.close(fd); });
+    // The identity of the file actually mapped, which may have been replaced since the stat().
+    if (::fstat(fd, &file_stat) == -1) {
+      throw EnvoyException(fmt::format("unable to read file: {}", path));
+    }
+    const size_t size = file_stat.st_size;
+    if (size == 0) {
+      return std::make_shared<StringContents>(std::string());
+    }
+    const Api::SysCallPtrResult mmap_result =
+        os_sys_calls.mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mmap_result.rc_ == MAP_FAILED) {
+      throw EnvoyException(fmt::format("unable to map file: {}: {}", path,
+                                       strerror(mmap_result.errno_)));
+    }
+    auto mapped = std::make_shared<const MappedFile>(mmap_result.rc_, size);
+
+    // Drop the entries of the files no longer mapped, so that the map does not grow with each
+    // file ever read.
+    for (auto it = files_.begin(); it != files_.end();) {
+      auto current = it++;
+      if (current->second.second.expired()) {
+        files_.erase(current);
+      }
+    }
+    files_.insert_or_assign(path, std::make_pair(FileIdentity(file_stat), mapped));
+    return mapped;
+  }
+
+private:
+  Thread::MutexBasicLockable mutex_;
+  absl::flat_hash_map<std::string, std::pair<FileIdentity, std::weak_ptr<const MappedFile>>>
+      files_ GUARDED_BY(mutex_);
+};
+
+MappedFiles& mappedFiles() { MUTABLE_CONSTRUCT_ON_FIRST_USE(MappedFiles); }
+
+} // namespace
+
 std::string read(const envoy::api::v2::core::DataSource& source, bool allow_empty, Api::Api& api) {
   switch (source.specifier_case()) {
   case envoy::api::v2::core::DataSource::kFilename:
@@ -29,6 +142,19 @@ absl::optional<std::string> getPath(const envoy::api::v2::core::DataSource& sour
              : absl::nullopt;
 }
 
+ContentsConstSharedPtr readShared(const envoy::api::v2::core::DataSource& source, bool allow_empty,
+                                  Api::Api& api) {
+  if (source.specifier_case() == envoy::api::v2::core::DataSource::kFilename) {
+    const std::string& path = source.filename();
+    // Small files, and the paths which can not be read, are left to read().
+    const ssize_t size = api.fileSystem().fileSize(path);
+    if (size >= static_cast<ssize_t>(MinMappedFileSize) && !api.fileSystem().illegalPath(path)) {
+      return mappedFiles().map(path);
+    }
+  }
+  return std::make_shared<StringContents>(read(source, allow_empty, api));
+}
+
 } // namespace DataSource
 } // namespace Config
 } // namespace Envoy
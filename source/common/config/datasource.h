@@ -2,6 +2,7 @@
 
 #include "envoy/api/api.h"
 #include "envoy/api/v2/core/base.pb.h"
+#include "envoy/common/pure.h"
 #include "envoy/init/manager.h"
 #include "envoy/upstream/cluster_manager.h"
 
@@ -32,6 +33,54 @@ std::string read(const envoy::api::v2::core::DataSource& source, bool allow_empt
  */
 absl::optional<std::string> getPath(const envoy::api::v2::core::DataSource& source);
 
+/**
+ * The contents of a DataSource, which may be shared by several readers.
+ */
+class Contents {
+public:
+  virtual ~Contents() = default;
+
+  /**
+   * @return absl::string_view the data, valid as long as the contents are.
+   */
+  virtual absl::string_view data() const PURE;
+};
+
+using ContentsConstSharedPtr = std::shared_ptr<const Contents>;
+
+/**
+ * Contents held in a string.
+ */
+class StringContents : public Contents {
+public:
+  explicit StringContents(std::string&& data) : data_(std::move(data)) {}
+
+  // Config::DataSource::Contents
+  absl::string_view data() const override { return data_; }
+
+private:
+  const std::string data_;
+};
+
+// Files at least this large are mapped into memory by readShared() rather than read.
+constexpr uint64_t MinMappedFileSize = 64 * 1024;
+
+/**
+ * Read contents of the DataSource like read(), without copying large files. A file of at least
+ * MinMappedFileSize bytes is mapped into memory, and the mapping is shared with the other readers
+ * of the file for as long as any of them holds it and the file is unchanged, as told by its inode,
+ * size and modification time. The file must be replaced, e.g. renamed over, rather than rewritten
+ * in place while it is mapped.
+ * @param source data source.
+ * @param allow_empty return empty contents if no DataSource case is specified.
+ * @param api reference to the Api object.
+ * @return ContentsConstSharedPtr the DataSource contents.
+ * @throw EnvoyException if no DataSource case is specified and !allow_empty, or the file can not
+ *        be read.
+ */
+ContentsConstSharedPtr readShared(const envoy::api::v2::core::DataSource& source, bool allow_empty,
+                                  Api::Api& api);
+
 /**
  * Callback for async data source.
  */
@@ -1,5 +1,6 @@
 #include "common/config/grpc_mux_impl.h"
 
+#include <algorithm>
 #include <unordered_set>
 
 #include "common/config/utility.h"
@@ -160,15 +161,22 @@ void GrpcMuxImpl::onDiscoveryResponse(
     // build a map here from resource name to resource and then walk watches_.
     // We have to walk all watches (and need an efficient map as a result) to
     // ensure we deliver empty config updates when a resource is dropped.
+    // Wildcard watches (e.g. CDS and LDS) take the whole response, so the map, which unpacks every
+    // resource for its name, is only built if some watch names its resources.
     std::unordered_map<std::string, ProtobufWkt::Any> resources;
     GrpcMuxCallbacks& callbacks = api_state_[type_url].watches_.front()->callbacks_;
+    const bool any_named_watch =
+        std::any_of(api_state_[type_url].watches_.begin(), api_state_[type_url].watches_.end(),
+                    [](const GrpcMuxWatchImpl* watch) { return !watch->resources_.empty(); });
     for (const auto& resource : message->resources()) {
       if (type_url != resource.type_url()) {
         throw EnvoyException(fmt::format("{} does not match {} type URL in DiscoveryResponse {}",
                                          resource.type_url(), type_url, message->DebugString()));
       }
-      const std::string resource_name = callbacks.resourceName(resource);
-      resources.emplace(resource_name, resource);
+      if (any_named_watch) {
+        const std::string resource_name = callbacks.resourceName(resource);
+        resources.emplace(resource_name, resource);
+      }
     }
     for (auto watch : api_state_[type_url].watches_) {
       // onConfigUpdate should be called in all cases for single watch xDS (Cluster and
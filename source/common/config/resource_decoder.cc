@@ -0,0 +1,59 @@
+#include "common/config/resource_decoder.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Config {
+
+void SynchronizedValidationVisitor::onUnknownField(absl::string_view description) {
+  Thread::LockGuard lock(lock_);
+  validation_visitor_.onUnknownField(description);
+}
+
+constexpr size_t ResourceDecoder::MinResourcesPerThread;
+
+ResourceDecoder::ResourceDecoder(Api::Api& api, Stats::Scope& scope, const std::string& prefix,
+                                 uint32_t max_threads)
+    : thread_factory_(api.threadFactory()), time_source_(api.timeSource()),
+      stats_({ALL_RESOURCE_DECODING_STATS(POOL_HISTOGRAM_PREFIX(scope, prefix))}),
+      max_threads_(std::max(max_threads, 1U)) {}
+
+std::shared_ptr<const Runtime::Snapshot> ResourceDecoder::threadsafeSnapshot() {
+  // Runtime is not set up in e.g. standalone config validation, in which case deprecated fields
+  // only warn, as in MessageUtil::checkForDeprecation().
+  Runtime::Loader* runtime = Runtime::LoaderSingleton::getExisting();
+  return runtime != nullptr ? runtime->threadsafeSnapshot() : nullptr;
+}
+
+void ResourceDecoder::forEachChunk(size_t count, const std::function<void(size_t, size_t)>& cb) {
+  const size_t chunks = std::min<size_t>(max_threads_, count / MinResourcesPerThread);
+  if (chunks <= 1) {
+    cb(0, count);
+    return;
+  }
+
+  const size_t chunk_size = (count + chunks - 1) / chunks;
+  std::vector<Thread::ThreadPtr> threads;
+  for (size_t begin = chunk_size; begin < count; begin += chunk_size) {
+    const size_t end = std::min(count, begin + chunk_size);
+    threads.emplace_back(
+        thread_factory_.createThread([&cb, begin, end]() -> void { cb(begin, end); }));
+  }
+  ENVOY_LOG(debug, "decoding {} resources on {} threads", count, threads.size() + 1);
+  cb(0, chunk_size);
+  for (auto& thread : threads) {
+    thread->join();
+  }
+}
+
+void ResourceDecoder::recordDuration(Stats::Histogram& histogram, MonotonicTime start) {
+  histogram.recordValue(std::chrono::duration_cast<std::chrono::microseconds>(
+                            time_source_.monotonicTime() - start)
+                            .count());
+}
+
+} // namespace Config
+} // namespace Envoy
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/common/time.h"
+#include "envoy/protobuf/message_validator.h"
+#include "envoy/runtime/runtime.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+#include "common/protobuf/protobuf.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Config {
+
+/**
+ * All resource decoding stats. @see stats_macros.h
+ */
+#define ALL_RESOURCE_DECODING_STATS(HISTOGRAM)                                                     \
+  HISTOGRAM(apply_duration_us)                                                                     \
+  HISTOGRAM(decode_duration_us)
+
+/**
+ * Struct definition for all resource decoding stats. @see stats_macros.h
+ */
+struct ResourceDecodingStats {
+  ALL_RESOURCE_DECODING_STATS(GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * A resource of a config update, unpacked and validated.
+ */
+template <class ResourceType> struct DecodedResource {
+  ResourceType resource_;
+  // Whether the resource was unpacked, i.e. whether resource_ holds at least its name.
+  bool unpacked_{};
+  // Set if the resource could not be unpacked or is invalid. It is rethrown when the resource is
+  // applied, so that a bad resource is rejected on its own, as if it had been decoded in place.
+  std::exception_ptr error_;
+};
+
+/**
+ * A validation visitor which serializes the calls to another visitor, so that it may be shared by
+ * the decoding threads.
+ */
+class SynchronizedValidationVisitor : public ProtobufMessage::ValidationVisitor {
+public:
+  explicit SynchronizedValidationVisitor(ProtobufMessage::ValidationVisitor& validation_visitor)
+      : validation_visitor_(validation_visitor) {}
+
+  // ProtobufMessage::ValidationVisitor
+  void onUnknownField(absl::string_view description) override;
+
+private:
+  ProtobufMessage::ValidationVisitor& validation_visitor_;
+  Thread::MutexBasicLockable lock_;
+};
+
+/**
+ * Unpacks and validates the resources of a config update. Large updates are split into chunks,
+ * which are decoded on transient threads while the calling thread decodes the first one. The
+ * decoded resources are then applied serially, on the calling thread, by the subscriber.
+ */
+class ResourceDecoder : Logger::Loggable<Logger::Id::config> {
+public:
+  /**
+   * @param api supplies the thread factory and time source.
+   * @param scope supplies the scope of the stats.
+   * @param prefix supplies the prefix of the stats, e.g. "control_plane.cds.".
+   * @param max_threads supplies the maximum number of threads decoding an update, including the
+   *        calling thread.
+   */
+  ResourceDecoder(Api::Api& api, Stats::Scope& scope, const std::string& prefix,
+                  uint32_t max_threads = std::thread::hardware_concurrency());
+
+  /**
+   * Decodes the resources of a config update. Must be called on the main thread.
+   * @param count supplies the number of resources.
+   * @param resource supplies the resource at an index. It is called on the decoding threads.
+   * @param validation_visitor supplies the visitor of unknown fields.
+   * @return the decoded resources, in order.
+   */
+  template <class ResourceType>
+  std::vector<DecodedResource<ResourceType>>
+  decode(size_t count, const std::function<const ProtobufWkt::Any&(size_t)>& resource,
+         ProtobufMessage::ValidationVisitor& validation_visitor) {
+    const MonotonicTime start = time_source_.monotonicTime();
+    std::vector<DecodedResource<ResourceType>> decoded(count);
+    // The runtime loader may only be used on the main thread, unlike its snapshot.
+    std::shared_ptr<const Runtime::Snapshot> snapshot = threadsafeSnapshot();
+    SynchronizedValidationVisitor synchronized_visitor(validation_visitor);
+    forEachChunk(count, [&](size_t begin, size_t end) -> void {
+      for (size_t i = begin; i < end; i++) {
+        try {
+          decoded[i].resource_ =
+              MessageUtil::anyConvert<ResourceType>(resource(i), synchronized_visitor);
+          decoded[i].unpacked_ = true;
+          MessageUtil::validate(decoded[i].resource_, snapshot.get());
+        } catch (const EnvoyException&) {
+          decoded[i].error_ = std::current_exception();
+        }
+      }
+    });
+    recordDuration(stats_.decode_duration_us_, start);
+    return decoded;
+  }
+
+  /**
+   * Records the time spent applying a decoded config update.
+   * @param start supplies the time the update started being applied.
+   */
+  void recordApplyDuration(MonotonicTime start) {
+    recordDuration(stats_.apply_duration_us_, start);
+  }
+
+  TimeSource& timeSource() { return time_source_; }
+
+  // Below this many resources per thread, the cost of a thread outweighs the decoding it saves.
+  static constexpr size_t MinResourcesPerThread = 128;
+
+private:
+  static std::shared_ptr<const Runtime::Snapshot> threadsafeSnapshot();
+
+  // Calls cb with consecutive [begin, end) chunks covering [0, count), concurrently when there
+  // are enough resources, and returns once all of them have been processed.
+  void forEachChunk(size_t count, const std::function<void(size_t, size_t)>& cb);
+  void recordDuration(Stats::Histogram& histogram, MonotonicTime start);
+
+  Thread::ThreadFactory& thread_factory_;
+  TimeSource& time_source_;
+  ResourceDecodingStats stats_;
+  const uint32_t max_threads_;
+};
+
+} // namespace Config
+} // namespace Envoy
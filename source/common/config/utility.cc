@@ -15,6 +15,7 @@
 #include "common/json/config_schemas.h"
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
+#include "common/stats/histogram_impl.h"
 #include "common/stats/stats_matcher_impl.h"
 #include "common/stats/tag_producer_impl.h"
 
@@ -222,6 +223,22 @@ Utility::createStatsMatcher(const envoy::config::bootstrap::v2::Bootstrap& boots
   return std::make_unique<Stats::StatsMatcherImpl>(bootstrap.stats_config());
 }
 
+Stats::StatsMatcherPtr
+Utility::createShardedCounterMatcher(const envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
+  if (!bootstrap.stats_config().has_sharded_counters()) {
+    return nullptr;
+  }
+  return std::make_unique<Stats::StatsMatcherImpl>(bootstrap.stats_config().sharded_counters());
+}
+
+Stats::HistogramSettingsConstPtr
+Utility::createHistogramSettings(const envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
+  if (bootstrap.stats_config().histogram_bucket_settings().empty()) {
+    return nullptr;
+  }
+  return std::make_unique<Stats::HistogramSettingsImpl>(bootstrap.stats_config());
+}
+
 Grpc::AsyncClientFactoryPtr Utility::factoryForGrpcApiConfigSource(
     Grpc::AsyncClientManager& async_client_manager,
     const envoy::api::v2::core::ApiConfigSource& api_config_source, Stats::Scope& scope) {
@@ -10,6 +10,7 @@
 #include "envoy/local_info/local_info.h"
 #include "envoy/registry/registry.h"
 #include "envoy/server/filter_config.h"
+#include "envoy/stats/histogram.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_matcher.h"
 #include "envoy/stats/tag_producer.h"
@@ -255,6 +256,21 @@ public:
   static Stats::StatsMatcherPtr
   createStatsMatcher(const envoy::config::bootstrap::v2::Bootstrap& bootstrap);
 
+  /**
+   * Create the StatsMatcher selecting the sharded counters.
+   * @return StatsMatcherPtr the matcher, or nullptr if no counters are sharded.
+   */
+  static Stats::StatsMatcherPtr
+  createShardedCounterMatcher(const envoy::config::bootstrap::v2::Bootstrap& bootstrap);
+
+  /**
+   * Create the bucket boundaries of the histograms.
+   * @return HistogramSettingsConstPtr the settings, or nullptr if all the histograms have the
+   *         default buckets.
+   */
+  static Stats::HistogramSettingsConstPtr
+  createHistogramSettings(const envoy::config::bootstrap::v2::Bootstrap& bootstrap);
+
   /**
    * Obtain gRPC async client factory from a envoy::api::v2::core::ApiConfigSource.
    * @param async_client_manager gRPC async client manager.
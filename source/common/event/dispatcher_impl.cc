@@ -32,6 +32,8 @@
 namespace Envoy {
 namespace Event {
 
+constexpr std::chrono::milliseconds DispatcherImpl::CoarseTimerResolution;
+
 DispatcherImpl::DispatcherImpl(Api::Api& api, Event::TimeSystem& time_system)
     : DispatcherImpl(std::make_unique<Buffer::WatermarkBufferFactory>(), api, time_system) {}
 
@@ -39,9 +41,12 @@ DispatcherImpl::DispatcherImpl(Buffer::WatermarkFactoryPtr&& factory, Api::Api&
                                Event::TimeSystem& time_system)
     : api_(api), buffer_factory_(std::move(factory)),
       scheduler_(time_system.createScheduler(base_scheduler_)),
+      timer_wheel_(*scheduler_, api.timeSource(), CoarseTimerResolution),
       deferred_delete_timer_(createTimerInternal([this]() -> void { clearDeferredDeleteList(); })),
       post_timer_(createTimerInternal([this]() -> void { runPostCallbacks(); })),
       current_to_delete_(&to_delete_1_) {
+  updateApproximateMonotonicTime();
+  base_scheduler_.registerOnCheckCallback([this]() { updateApproximateMonotonicTime(); });
 #ifdef ENVOY_HANDLE_SIGNALS
   SignalAction::registerFatalErrorHandler(*this);
 #endif
@@ -60,6 +65,14 @@ void DispatcherImpl::initializeStats(Stats::Scope& scope, const std::string& pre
     stats_ = std::make_unique<DispatcherStats>(
         DispatcherStats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
     base_scheduler_.initializeStats(stats_.get());
+    post_stats_[static_cast<size_t>(PostPriority::ControlPlane)] = {
+        &stats_->control_plane_post_delay_us_, &stats_->control_plane_post_duration_us_};
+    post_stats_[static_cast<size_t>(PostPriority::HealthCheck)] = {
+        &stats_->health_check_post_delay_us_, &stats_->health_check_post_duration_us_};
+    post_stats_[static_cast<size_t>(PostPriority::Admin)] = {&stats_->admin_post_delay_us_,
+                                                             &stats_->admin_post_duration_us_};
+    post_stats_[static_cast<size_t>(PostPriority::Background)] = {
+        &stats_->background_post_delay_us_, &stats_->background_post_duration_us_};
     ENVOY_LOG(debug, "running {} on thread {}", stats_prefix_, run_tid_.debugString());
   });
 }
@@ -147,6 +160,11 @@ Network::ListenerPtr DispatcherImpl::createUdpListener(Network::Socket& socket,
 
 TimerPtr DispatcherImpl::createTimer(TimerCb cb) { return createTimerInternal(cb); }
 
+TimerPtr DispatcherImpl::createCoarseTimer(TimerCb cb) {
+  ASSERT(isThreadSafe());
+  return timer_wheel_.createTimer(cb);
+}
+
 TimerPtr DispatcherImpl::createTimerInternal(TimerCb cb) {
   ASSERT(isThreadSafe());
   return scheduler_->createTimer(cb);
@@ -169,11 +187,18 @@ SignalEventPtr DispatcherImpl::listenForSignal(int signal_num, SignalCb cb) {
 }
 
 void DispatcherImpl::post(std::function<void()> callback) {
-  bool do_post;
+  post(std::move(callback), PostPriority::ControlPlane);
+}
+
+void DispatcherImpl::post(std::function<void()> callback, PostPriority priority) {
+  const MonotonicTime post_time = api_.timeSource().monotonicTime();
+  bool do_post = true;
   {
     Thread::LockGuard lock(post_lock_);
-    do_post = post_callbacks_.empty();
-    post_callbacks_.push_back(callback);
+    for (const auto& callbacks : post_callbacks_) {
+      do_post = do_post && callbacks.empty();
+    }
+    post_callbacks_[static_cast<size_t>(priority)].push_back({std::move(callback), post_time});
   }
 
   if (do_post) {
@@ -189,9 +214,14 @@ void DispatcherImpl::run(RunType type) {
   // not guarantee that events are run in any particular order. So even if we post() and call
   // event_base_once() before some other event, the other event might get called first.
   runPostCallbacks();
+  updateApproximateMonotonicTime();
   base_scheduler_.run(type);
 }
 
+void DispatcherImpl::updateApproximateMonotonicTime() {
+  approximate_monotonic_time_ = api_.timeSource().monotonicTime();
+}
+
 void DispatcherImpl::runPostCallbacks() {
   while (true) {
     // It is important that this declaration is inside the body of the loop so that the callback is
@@ -200,16 +230,34 @@ void DispatcherImpl::runPostCallbacks() {
     // re-assigned, which happens while holding the lock. This can lead to a deadlock (via
     // recursive mutex acquisition) if destroying the callback runs a destructor, which through some
     // callstack calls post() on this dispatcher.
-    std::function<void()> callback;
+    PostedCallback posted;
+    size_t priority = 0;
     {
       Thread::LockGuard lock(post_lock_);
-      if (post_callbacks_.empty()) {
+      // Run the oldest callback of the highest priority that has any.
+      while (priority < NumPostPriorities && post_callbacks_[priority].empty()) {
+        priority++;
+      }
+      if (priority == NumPostPriorities) {
         return;
       }
-      callback = post_callbacks_.front();
-      post_callbacks_.pop_front();
+      posted = std::move(post_callbacks_[priority].front());
+      post_callbacks_[priority].pop_front();
+    }
+    base_scheduler_.onCallbackRun();
+    if (stats_ == nullptr) {
+      posted.callback_();
+      continue;
     }
-    callback();
+
+    const PostStats& post_stats = post_stats_[priority];
+    const MonotonicTime start = api_.timeSource().monotonicTime();
+    post_stats.delay_us_->recordValue(
+        std::chrono::duration_cast<std::chrono::microseconds>(start - posted.post_time_).count());
+    posted.callback_();
+    post_stats.duration_us_->recordValue(std::chrono::duration_cast<std::chrono::microseconds>(
+                                             api_.timeSource().monotonicTime() - start)
+                                             .count());
   }
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -15,9 +16,11 @@
 #include "envoy/stats/scope.h"
 
 #include "common/common/logger.h"
+#include "common/common/mutex_tracer_impl.h"
 #include "common/common/thread.h"
 #include "common/event/libevent.h"
 #include "common/event/libevent_scheduler.h"
+#include "common/event/timer_wheel.h"
 #include "common/signal/fatal_error_handler.h"
 
 namespace Envoy {
@@ -40,8 +43,14 @@ public:
    */
   event_base& base() { return base_scheduler_.base(); }
 
+  /**
+   * @return LibeventScheduler& the scheduler that runs the event loop.
+   */
+  LibeventScheduler& baseScheduler() { return base_scheduler_; }
+
   // Event::Dispatcher
   TimeSource& timeSource() override { return api_.timeSource(); }
+  MonotonicTime approximateMonotonicTime() override { return approximate_monotonic_time_; }
   void initializeStats(Stats::Scope& scope, const std::string& prefix) override;
   void clearDeferredDeleteList() override;
   Network::ConnectionPtr
@@ -63,10 +72,12 @@ public:
   Network::ListenerPtr createUdpListener(Network::Socket& socket,
                                          Network::UdpListenerCallbacks& cb) override;
   TimerPtr createTimer(TimerCb cb) override;
+  TimerPtr createCoarseTimer(TimerCb cb) override;
   void deferredDelete(DeferredDeletablePtr&& to_delete) override;
   void exit() override;
   SignalEventPtr listenForSignal(int signal_num, SignalCb cb) override;
   void post(std::function<void()> callback) override;
+  void post(std::function<void()> callback, PostPriority priority) override;
   void run(RunType type) override;
   Buffer::WatermarkFactory& getWatermarkFactory() override { return *buffer_factory_; }
   const ScopeTrackedObject* setTrackedObject(const ScopeTrackedObject* object) override {
@@ -74,6 +85,7 @@ public:
     current_object_ = object;
     return return_object;
   }
+  const ScopeTrackedObject* trackedObject() const override { return current_object_; }
 
   // FatalErrorInterface
   void onFatalError() const override {
@@ -86,9 +98,24 @@ public:
     }
   }
 
+  // The tick of the wheel that runs the coarse timers.
+  static constexpr std::chrono::milliseconds CoarseTimerResolution{4};
+
 private:
+  struct PostedCallback {
+    std::function<void()> callback_;
+    MonotonicTime post_time_;
+  };
+
+  // The histograms of the callbacks posted with a priority.
+  struct PostStats {
+    Stats::Histogram* delay_us_;
+    Stats::Histogram* duration_us_;
+  };
+
   TimerPtr createTimerInternal(TimerCb cb);
   void runPostCallbacks();
+  void updateApproximateMonotonicTime();
 
   // Validate that an operation is thread safe, i.e. it's invoked on the same thread that the
   // dispatcher run loop is executing on. We allow run_tid_ to be empty for tests where we don't
@@ -104,15 +131,20 @@ private:
   Buffer::WatermarkFactoryPtr buffer_factory_;
   LibeventScheduler base_scheduler_;
   SchedulerPtr scheduler_;
+  TimerWheel timer_wheel_;
   TimerPtr deferred_delete_timer_;
   TimerPtr post_timer_;
   std::vector<DeferredDeletablePtr> to_delete_1_;
   std::vector<DeferredDeletablePtr> to_delete_2_;
   std::vector<DeferredDeletablePtr>* current_to_delete_;
   Thread::MutexBasicLockable post_lock_;
-  std::list<std::function<void()>> post_callbacks_ GUARDED_BY(post_lock_);
+  MutexContentionName post_lock_name_{post_lock_.contentionId(), "dispatcher.post"};
+  // Indexed by PostPriority.
+  std::array<std::list<PostedCallback>, NumPostPriorities> post_callbacks_ GUARDED_BY(post_lock_);
+  std::array<PostStats, NumPostPriorities> post_stats_{};
   const ScopeTrackedObject* current_object_{};
   bool deferred_deleting_{};
+  MonotonicTime approximate_monotonic_time_;
 };
 
 } // namespace Event
@@ -12,7 +12,8 @@ namespace Event {
 
 FileEventImpl::FileEventImpl(DispatcherImpl& dispatcher, int fd, FileReadyCb cb,
                              FileTriggerType trigger, uint32_t events)
-    : cb_(cb), base_(&dispatcher.base()), fd_(fd), trigger_(trigger) {
+    : cb_(cb), scheduler_(dispatcher.baseScheduler()), base_(&dispatcher.base()), fd_(fd),
+      trigger_(trigger) {
 #ifdef WIN32
   RELEASE_ASSERT(trigger_ == FileTriggerType::Level,
                  "libevent does not support edge triggers on Windows");
@@ -62,6 +63,7 @@ void FileEventImpl::assignEvents(uint32_t events) {
         }
 
         ASSERT(events);
+        event->scheduler_.onCallbackRun();
         event->cb_(events);
       },
       this);
@@ -27,6 +27,7 @@ private:
   void assignEvents(uint32_t events);
 
   FileReadyCb cb_;
+  LibeventScheduler& scheduler_;
   event_base* base_;
   int fd_;
   FileTriggerType trigger_;
@@ -20,7 +20,7 @@ LibeventScheduler::LibeventScheduler() : libevent_(event_base_new()) {
 }
 
 TimerPtr LibeventScheduler::createTimer(const TimerCb& cb) {
-  return std::make_unique<TimerImpl>(libevent_, cb);
+  return std::make_unique<TimerImpl>(*this, cb);
 };
 
 void LibeventScheduler::run(Dispatcher::RunType mode) {
@@ -56,6 +56,13 @@ void LibeventScheduler::initializeStats(DispatcherStats* stats) {
   evwatch_check_new(libevent_.get(), &onCheck, this);
 }
 
+void LibeventScheduler::registerOnCheckCallback(std::function<void()>&& callback) {
+  ASSERT(callback);
+  ASSERT(!on_check_callback_);
+  on_check_callback_ = std::move(callback);
+  evwatch_check_new(libevent_.get(), &runOnCheckCallback, this);
+}
+
 void LibeventScheduler::onPrepare(evwatch*, const evwatch_prepare_cb_info* info, void* arg) {
   // `self` is `this`, passed in from evwatch_prepare_new.
   auto self = static_cast<LibeventScheduler*>(arg);
@@ -73,6 +80,7 @@ void LibeventScheduler::onPrepare(evwatch*, const evwatch_prepare_cb_info* info,
     timeval delta;
     evutil_timersub(&self->prepare_time_, &self->check_time_, &delta);
     recordTimeval(self->stats_->loop_duration_us_, delta);
+    self->stats_->callbacks_per_loop_.recordValue(self->callbacks_run_);
   }
 }
 
@@ -84,6 +92,7 @@ void LibeventScheduler::onCheck(evwatch*, const evwatch_check_cb_info*, void* ar
   // from above to compute the actual polling duration, and store it for the next iteration of the
   // event loop to compute the loop duration.
   evutil_gettimeofday(&self->check_time_, nullptr);
+  self->callbacks_run_ = 0;
   if (self->timeout_set_) {
     timeval delta, delay;
     evutil_timersub(&self->check_time_, &self->prepare_time_, &delta);
@@ -99,5 +108,11 @@ void LibeventScheduler::onCheck(evwatch*, const evwatch_check_cb_info*, void* ar
   }
 }
 
+void LibeventScheduler::runOnCheckCallback(evwatch*, const evwatch_check_cb_info*, void* arg) {
+  // `self` is `this`, passed in from evwatch_check_new.
+  auto self = static_cast<LibeventScheduler*>(arg);
+  self->on_check_callback_();
+}
+
 } // namespace Event
 } // namespace Envoy
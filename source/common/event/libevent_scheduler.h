@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
 
@@ -47,9 +49,28 @@ public:
    */
   void initializeStats(DispatcherStats* stats_);
 
+  /**
+   * @return DispatcherStats* the stats of the containing dispatcher, or nullptr if they have not
+   *         been initialized.
+   */
+  DispatcherStats* stats() { return stats_; }
+
+  /**
+   * Count a file event, timer or posted callback run in the current event loop iteration, for the
+   * callbacks_per_loop stat.
+   */
+  void onCallbackRun() { callbacks_run_++; }
+
+  /**
+   * Registers a callback run each time the event loop returns from polling, before any event is
+   * handled. Only one callback may be registered.
+   */
+  void registerOnCheckCallback(std::function<void()>&& callback);
+
 private:
   static void onPrepare(evwatch*, const evwatch_prepare_cb_info* info, void* arg);
   static void onCheck(evwatch*, const evwatch_check_cb_info*, void* arg);
+  static void runOnCheckCallback(evwatch*, const evwatch_check_cb_info*, void* arg);
 
   Libevent::BasePtr libevent_;
   DispatcherStats* stats_{}; // stats owned by the containing DispatcherImpl
@@ -57,6 +78,8 @@ private:
   timeval timeout_{};        // the poll timeout for the current event loop iteration, if available
   timeval prepare_time_{};   // timestamp immediately before polling
   timeval check_time_{};     // timestamp immediately after polling
+  uint64_t callbacks_run_{}; // callbacks run since the last check
+  std::function<void()> on_check_callback_;
 };
 
 } // namespace Event
@@ -17,25 +17,48 @@ void TimerUtils::millisecondsToTimeval(const std::chrono::milliseconds& d, timev
   tv.tv_usec = usecs.count();
 }
 
-TimerImpl::TimerImpl(Libevent::BasePtr& libevent, TimerCb cb) : cb_(cb) {
+TimerImpl::TimerImpl(LibeventScheduler& scheduler, TimerCb cb) : scheduler_(scheduler), cb_(cb) {
   ASSERT(cb_);
   evtimer_assign(
-      &raw_event_, libevent.get(),
-      [](evutil_socket_t, short, void* arg) -> void { static_cast<TimerImpl*>(arg)->cb_(); }, this);
+      &raw_event_, &scheduler_.base(),
+      [](evutil_socket_t, short, void* arg) -> void { static_cast<TimerImpl*>(arg)->onTimer(); },
+      this);
 }
 
 void TimerImpl::disableTimer() { event_del(&raw_event_); }
 
 void TimerImpl::enableTimer(const std::chrono::milliseconds& d) {
   if (d.count() == 0) {
+    evutil_timerclear(&deadline_);
     event_active(&raw_event_, EV_TIMEOUT, 0);
   } else {
     timeval tv;
     TimerUtils::millisecondsToTimeval(d, tv);
+    if (scheduler_.stats() != nullptr) {
+      event_base_gettimeofday_cached(&scheduler_.base(), &deadline_);
+      evutil_timeradd(&deadline_, &tv, &deadline_);
+    }
     event_add(&raw_event_, &tv);
   }
 }
 
+void TimerImpl::onTimer() {
+  scheduler_.onCallbackRun();
+  DispatcherStats* stats = scheduler_.stats();
+  if (stats != nullptr && evutil_timerisset(&deadline_)) {
+    timeval now, delay;
+    event_base_gettimeofday_cached(&scheduler_.base(), &now);
+    evutil_timersub(&now, &deadline_, &delay);
+    evutil_timerclear(&deadline_);
+    // libevent fires a timer no earlier than its deadline in the cached time, so the delay is
+    // only negative if the wall clock stepped back.
+    if (delay.tv_sec >= 0) {
+      stats->timer_delay_us_.recordValue(delay.tv_sec * 1000000 + delay.tv_usec);
+    }
+  }
+  cb_();
+}
+
 bool TimerImpl::enabled() { return 0 != evtimer_pending(&raw_event_, nullptr); }
 
 } // namespace Event
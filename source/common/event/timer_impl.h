@@ -6,6 +6,7 @@
 
 #include "common/event/event_impl_base.h"
 #include "common/event/libevent.h"
+#include "common/event/libevent_scheduler.h"
 
 namespace Envoy {
 namespace Event {
@@ -23,7 +24,7 @@ public:
  */
 class TimerImpl : public Timer, ImplBase {
 public:
-  TimerImpl(Libevent::BasePtr& libevent, TimerCb cb);
+  TimerImpl(LibeventScheduler& scheduler, TimerCb cb);
 
   // Timer
   void disableTimer() override;
@@ -31,7 +32,13 @@ public:
   bool enabled() override;
 
 private:
+  void onTimer();
+
+  LibeventScheduler& scheduler_;
   TimerCb cb_;
+  // When the timer is due, in the libevent cached time that libevent also schedules it by. Zero
+  // if the timer was activated rather than scheduled, which is not recorded in timer_delay_us.
+  timeval deadline_{};
 };
 
 } // namespace Event
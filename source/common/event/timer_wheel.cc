@@ -0,0 +1,209 @@
+#include "common/event/timer_wheel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Event {
+
+constexpr uint32_t TimerWheel::kSlotBits;
+constexpr uint32_t TimerWheel::kSlots;
+constexpr uint32_t TimerWheel::kLevels;
+
+class TimerWheel::TimerEntry : public Timer, public TimerWheel::Link {
+public:
+  TimerEntry(TimerWheel& wheel, TimerCb cb) : wheel_(wheel), cb_(cb) { ASSERT(cb_); }
+  ~TimerEntry() override { disableTimer(); }
+
+  // Timer
+  void disableTimer() override { wheel_.disarm(*this); }
+  void enableTimer(const std::chrono::milliseconds& d) override { wheel_.arm(*this, d); }
+  bool enabled() override { return linked(); }
+
+  void fire() { cb_(); }
+
+  TimerWheel& wheel_;
+  TimerCb cb_;
+  // The first tick at which the timeout has elapsed.
+  uint64_t expiry_tick_{};
+};
+
+void TimerWheel::Link::unlink() {
+  prev_->next_ = next_;
+  next_->prev_ = prev_;
+  prev_ = next_ = nullptr;
+}
+
+void TimerWheel::Link::insertBefore(Link& link) {
+  prev_ = link.prev_;
+  next_ = &link;
+  link.prev_->next_ = this;
+  link.prev_ = this;
+}
+
+void TimerWheel::Link::take(Link& from) {
+  ASSERT(empty());
+  if (from.empty()) {
+    return;
+  }
+  prev_ = from.prev_;
+  next_ = from.next_;
+  prev_->next_ = this;
+  next_->prev_ = this;
+  from.initSentinel();
+}
+
+TimerWheel::TimerWheel(Scheduler& scheduler, TimeSource& time_source,
+                       std::chrono::milliseconds resolution)
+    : time_source_(time_source), start_(time_source.monotonicTime()),
+      resolution_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(resolution).count()),
+      tick_timer_(scheduler.createTimer([this]() { onTick(); })) {
+  ASSERT(resolution_ns_ > 0);
+  for (auto& level : slots_) {
+    for (auto& slot : level) {
+      slot.initSentinel();
+    }
+  }
+}
+
+TimerWheel::~TimerWheel() { ASSERT(armed_timers_ == 0); }
+
+TimerPtr TimerWheel::createTimer(TimerCb cb) { return std::make_unique<TimerEntry>(*this, cb); }
+
+uint64_t TimerWheel::currentTick() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time_source_.monotonicTime() - start_)
+             .count() /
+         resolution_ns_;
+}
+
+void TimerWheel::arm(TimerEntry& timer, const std::chrono::milliseconds& d) {
+  disarm(timer);
+  const uint64_t elapsed_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(time_source_.monotonicTime() - start_ + d)
+          .count();
+  if (armed_timers_ == 0) {
+    // Nothing else is on the wheel, so skip straight to the current tick.
+    processed_tick_ = currentTick();
+  }
+  // Round up so that the timer never fires early. A timer which is due immediately fires on the
+  // next tick, as the current tick has already been processed.
+  timer.expiry_tick_ =
+      std::max((elapsed_ns + resolution_ns_ - 1) / resolution_ns_, processed_tick_ + 1);
+  const uint64_t due_tick = place(timer);
+  armed_timers_++;
+  // Disarming never reschedules, so the tick timer may be armed for a tick on which nothing is due.
+  // That costs one wasted wakeup, which is cheaper than finding the next occupied slot here.
+  if (!tick_timer_->enabled() || due_tick < scheduled_tick_) {
+    scheduleTick(due_tick);
+  }
+}
+
+void TimerWheel::disarm(TimerEntry& timer) {
+  if (timer.linked()) {
+    timer.unlink();
+    ASSERT(armed_timers_ > 0);
+    armed_timers_--;
+  }
+}
+
+uint64_t TimerWheel::place(TimerEntry& timer) {
+  // A cascaded timer may be due on the tick being processed, which places it in the level zero
+  // slot that is drained next.
+  ASSERT(timer.expiry_tick_ >= processed_tick_);
+  const uint64_t remaining = timer.expiry_tick_ - processed_tick_;
+  for (uint32_t level = 0; level < kLevels; level++) {
+    if (remaining < (uint64_t(1) << (kSlotBits * (level + 1)))) {
+      const uint32_t shift = kSlotBits * level;
+      timer.insertBefore(slots_[level][(timer.expiry_tick_ >> shift) & (kSlots - 1)]);
+      return (timer.expiry_tick_ >> shift) << shift;
+    }
+  }
+  // Beyond the range of the wheel, so park the timer in the furthest top level slot.
+  const uint32_t shift = kSlotBits * (kLevels - 1);
+  const uint64_t parked_tick = processed_tick_ + (uint64_t(1) << (kSlotBits * kLevels)) - 1;
+  timer.insertBefore(slots_[kLevels - 1][(parked_tick >> shift) & (kSlots - 1)]);
+  return (parked_tick >> shift) << shift;
+}
+
+void TimerWheel::cascade(uint32_t level) {
+  Link pending;
+  pending.initSentinel();
+  pending.take(slots_[level][(processed_tick_ >> (kSlotBits * level)) & (kSlots - 1)]);
+  while (!pending.empty()) {
+    TimerEntry& timer = static_cast<TimerEntry&>(*pending.next_);
+    timer.unlink();
+    place(timer);
+  }
+}
+
+uint64_t TimerWheel::nextDueTick() const {
+  uint64_t next = std::numeric_limits<uint64_t>::max();
+  for (uint32_t level = 0; level < kLevels; level++) {
+    // Level zero slots expire on every tick and higher level slots cascade each time the level
+    // below wraps. Every slot of a level is visited within kSlots of its steps.
+    const uint32_t shift = kSlotBits * level;
+    for (uint64_t step = (processed_tick_ >> shift) + 1;
+         step <= (processed_tick_ >> shift) + kSlots && (step << shift) < next; step++) {
+      if (!slots_[level][step & (kSlots - 1)].empty()) {
+        next = step << shift;
+        break;
+      }
+    }
+  }
+  return next;
+}
+
+void TimerWheel::scheduleTick(uint64_t tick) {
+  const std::chrono::nanoseconds until =
+      start_ + std::chrono::nanoseconds(tick * resolution_ns_) - time_source_.monotonicTime();
+  // Round up, as firing before the tick is due would only wake the wheel up again.
+  const std::chrono::milliseconds delay(
+      until.count() > 0 ? (until.count() + 999999) / 1000000 : 0);
+  tick_timer_->enableTimer(delay);
+  scheduled_tick_ = tick;
+}
+
+void TimerWheel::advance(uint64_t tick) {
+  while (processed_tick_ < tick) {
+    const uint64_t next = armed_timers_ > 0 ? nextDueTick() : tick + 1;
+    if (next > tick) {
+      // No slot is due before the target, so the ticks in between have nothing to do.
+      processed_tick_ = tick;
+      break;
+    }
+    processed_tick_ = next;
+    // Each time a level wraps, the next slot of the level above is due to be spread out below it.
+    for (uint32_t level = kLevels - 1; level > 0; level--) {
+      if ((processed_tick_ & ((uint64_t(1) << (kSlotBits * level)) - 1)) == 0) {
+        cascade(level);
+      }
+    }
+
+    // Timers may be disarmed, re-armed or freed by the callbacks of other timers, so the expired
+    // slot is moved aside and drained one timer at a time.
+    Link expired;
+    expired.initSentinel();
+    expired.take(slots_[0][processed_tick_ & (kSlots - 1)]);
+    while (!expired.empty()) {
+      TimerEntry& timer = static_cast<TimerEntry&>(*expired.next_);
+      ASSERT(timer.expiry_tick_ == processed_tick_);
+      timer.unlink();
+      armed_timers_--;
+      timer.fire();
+    }
+  }
+}
+
+void TimerWheel::onTick() {
+  advance(currentTick());
+  if (armed_timers_ > 0) {
+    scheduleTick(nextDueTick());
+  }
+}
+
+} // namespace Event
+} // namespace Envoy
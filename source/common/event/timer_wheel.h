@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+#include "envoy/event/timer.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * A hierarchical timer wheel for timers that tolerate firing a little late, such as idle and
+ * request timeouts. Arming and disarming a timer are O(1) list operations, where libevent timers
+ * pay for a min-heap update. The wheel is driven by a single scheduler timer, armed for the next
+ * tick on which an occupied slot is due rather than for every tick, so a wheel holding only distant
+ * timeouts rarely wakes up. Timers never fire before their timeout has elapsed, and fire at most
+ * one resolution plus the millisecond rounding of the scheduler timer late.
+ *
+ * The wheel has kLevels levels of kSlots slots, each level kSlots times as coarse as the one below.
+ * A timer is placed in the lowest level that covers its remaining time and moved down (cascaded) as
+ * the wheel turns. Timeouts beyond the range of the top level are parked in its furthest slot and
+ * re-placed when that slot is cascaded.
+ *
+ * Not thread safe; the wheel and its timers must only be used from the thread of the scheduler.
+ */
+class TimerWheel {
+public:
+  TimerWheel(Scheduler& scheduler, TimeSource& time_source, std::chrono::milliseconds resolution);
+  ~TimerWheel();
+
+  /**
+   * Creates a timer on the wheel. The timer must be freed before the wheel.
+   */
+  TimerPtr createTimer(TimerCb cb);
+
+  /**
+   * @return the number of armed timers.
+   */
+  uint64_t armedTimers() const { return armed_timers_; }
+
+  static constexpr uint32_t kSlotBits = 6;
+  static constexpr uint32_t kSlots = 1 << kSlotBits;
+  static constexpr uint32_t kLevels = 4;
+
+private:
+  class TimerEntry;
+
+  // An intrusive circular list link. Each slot is a sentinel and each armed timer is linked into
+  // exactly one slot, so unlinking needs no knowledge of which slot holds the timer.
+  struct Link {
+    Link() = default;
+    Link(const Link&) = delete;
+    Link& operator=(const Link&) = delete;
+
+    bool linked() const { return next_ != nullptr; }
+    void unlink();
+    void insertBefore(Link& link);
+    // Moves the links of the sentinel `from` to this initialized sentinel, leaving `from` empty.
+    void take(Link& from);
+    void initSentinel() { prev_ = next_ = this; }
+    bool empty() const { return next_ == this; }
+
+    Link* prev_{};
+    Link* next_{};
+  };
+
+  uint64_t currentTick() const;
+  void arm(TimerEntry& timer, const std::chrono::milliseconds& d);
+  void disarm(TimerEntry& timer);
+  // Links the timer into its slot and returns the tick on which that slot is next processed.
+  uint64_t place(TimerEntry& timer);
+  void cascade(uint32_t level);
+  // Returns the first tick after processed_tick_ on which an occupied slot is expired or cascaded.
+  uint64_t nextDueTick() const;
+  void scheduleTick(uint64_t tick);
+  void advance(uint64_t tick);
+  void onTick();
+
+  TimeSource& time_source_;
+  const MonotonicTime start_;
+  const uint64_t resolution_ns_;
+  TimerPtr tick_timer_;
+  // The last tick processed. Only meaningful while timers are armed; the wheel catches up to the
+  // current time when the first timer is armed.
+  uint64_t processed_tick_{};
+  uint64_t armed_timers_{};
+  // The tick tick_timer_ is armed for, while it is enabled.
+  uint64_t scheduled_tick_{};
+  std::array<std::array<Link, kSlots>, kLevels> slots_;
+};
+
+} // namespace Event
+} // namespace Envoy
@@ -6,15 +6,58 @@
 #include "common/grpc/common.h"
 #include "common/http/header_map_impl.h"
 #include "common/http/utility.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_split.h"
 
 namespace Envoy {
 namespace Grpc {
+namespace {
+
+constexpr uint32_t DefaultMinCompressedMessageBytes = 1024;
+// The maximum window size, with 16 added to write a gzip header and trailer.
+constexpr int64_t GzipWindowBits = 15 | 16;
+constexpr uint64_t GzipMemoryLevel = 8;
+
+// A response without grpc-accept-encoding says nothing about the encodings the service accepts.
+bool rejectsGzip(const Http::HeaderMap& headers) {
+  const Http::HeaderEntry* accept_encoding = headers.GrpcAcceptEncoding();
+  if (accept_encoding == nullptr) {
+    return false;
+  }
+  for (absl::string_view encoding :
+       absl::StrSplit(accept_encoding->value().getStringView(), ',')) {
+    if (absl::StripAsciiWhitespace(encoding) == Http::Headers::get().GrpcEncodingValues.Gzip) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+ClusterCompressionStats::ClusterCompressionStats(Upstream::ClusterInfoConstSharedPtr cluster)
+    : cluster_(std::move(cluster)),
+      stats_{ALL_GRPC_CLIENT_COMPRESSION_STATS(
+          POOL_COUNTER_PREFIX(cluster_->statsScope(), "grpc.compression."),
+          POOL_HISTOGRAM_PREFIX(cluster_->statsScope(), "grpc.compression."))} {}
 
 AsyncClientImpl::AsyncClientImpl(Upstream::ClusterManager& cm,
                                  const envoy::api::v2::core::GrpcService& config,
                                  TimeSource& time_source)
     : cm_(cm), remote_cluster_name_(config.envoy_grpc().cluster_name()),
-      initial_metadata_(config.initial_metadata()), time_source_(time_source) {}
+      initial_metadata_(config.initial_metadata()), time_source_(time_source),
+      min_compressed_message_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config.envoy_grpc().compression(), min_message_bytes, DefaultMinCompressedMessageBytes)) {
+  if (config.envoy_grpc().has_compression()) {
+    // Each message is compressed in one go, so a single compressor is kept for reuse.
+    compressor_pool_ = std::make_unique<Compressor::ZlibCompressorPool>(
+        Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
+        Compressor::ZlibCompressorImpl::CompressionStrategy::Standard, GzipWindowBits,
+        GzipMemoryLevel, 1);
+  }
+}
 
 AsyncClientImpl::~AsyncClientImpl() {
   while (!active_streams_.empty()) {
@@ -56,6 +99,15 @@ RawAsyncStream* AsyncClientImpl::startRaw(absl::string_view service_full_name,
   return active_streams_.front().get();
 }
 
+const ClusterCompressionStatsSharedPtr&
+AsyncClientImpl::compressionStats(const Upstream::ClusterInfoConstSharedPtr& cluster) {
+  // The stats are only looked up again when the cluster was replaced.
+  if (compression_stats_ == nullptr || compression_stats_->cluster_ != cluster) {
+    compression_stats_ = std::make_shared<ClusterCompressionStats>(cluster);
+  }
+  return compression_stats_;
+}
+
 AsyncStreamImpl::AsyncStreamImpl(AsyncClientImpl& parent, absl::string_view service_full_name,
                                  absl::string_view method_name, RawAsyncStreamCallbacks& callbacks,
                                  const absl::optional<std::chrono::milliseconds>& timeout)
@@ -63,7 +115,8 @@ AsyncStreamImpl::AsyncStreamImpl(AsyncClientImpl& parent, absl::string_view serv
       callbacks_(callbacks), timeout_(timeout) {}
 
 void AsyncStreamImpl::initialize(bool buffer_body_for_retry) {
-  if (parent_.cm_.get(parent_.remote_cluster_name_) == nullptr) {
+  Upstream::ThreadLocalCluster* cluster = parent_.cm_.get(parent_.remote_cluster_name_);
+  if (cluster == nullptr) {
     callbacks_.onRemoteClose(Status::GrpcStatus::Unavailable, "Cluster not available");
     http_reset_ = true;
     return;
@@ -91,6 +144,12 @@ void AsyncStreamImpl::initialize(bool buffer_body_for_retry) {
     headers_message_->headers().addCopy(Http::LowerCaseString(header_value.key()),
                                         header_value.value());
   }
+  if (parent_.compressor_pool_ != nullptr && parent_.service_accepts_gzip_) {
+    compress_ = true;
+    compression_stats_ = parent_.compressionStats(cluster->info());
+    headers_message_->headers().addReference(Http::Headers::get().GrpcEncoding,
+                                             Http::Headers::get().GrpcEncodingValues.Gzip);
+  }
   callbacks_.onCreateInitialMetadata(headers_message_->headers());
   stream_->sendHeaders(headers_message_->headers(), false);
 }
@@ -98,6 +157,11 @@ void AsyncStreamImpl::initialize(bool buffer_body_for_retry) {
 // TODO(htuch): match Google gRPC base64 encoding behavior for *-bin headers, see
 // https://github.com/envoyproxy/envoy/pull/2444#discussion_r163914459.
 void AsyncStreamImpl::onHeaders(Http::HeaderMapPtr&& headers, bool end_stream) {
+  if (compress_ && rejectsGzip(*headers)) {
+    // The rest of the messages of this stream and the later streams are sent uncompressed.
+    compress_ = false;
+    parent_.service_accepts_gzip_ = false;
+  }
   const auto http_response_status = Http::Utility::getResponseStatus(*headers);
   const auto grpc_status = Common::getGrpcStatus(*headers);
   callbacks_.onReceiveInitialMetadata(end_stream ? std::make_unique<Http::HeaderMapImpl>()
@@ -180,14 +244,45 @@ void AsyncStreamImpl::onReset() {
 }
 
 void AsyncStreamImpl::sendMessage(const Protobuf::Message& request, bool end_stream) {
+  if (compress_) {
+    sendMessageRaw(Common::serializeMessage(request), end_stream);
+    return;
+  }
   stream_->sendData(*Common::serializeToGrpcFrame(request), end_stream);
 }
 
 void AsyncStreamImpl::sendMessageRaw(Buffer::InstancePtr&& buffer, bool end_stream) {
-  Common::prependGrpcFrameHeader(*buffer);
+  if (compress_) {
+    compressMessage(*buffer);
+  } else {
+    Common::prependGrpcFrameHeader(*buffer);
+  }
   stream_->sendData(*buffer, end_stream);
 }
 
+void AsyncStreamImpl::compressMessage(Buffer::Instance& message) {
+  GrpcClientCompressionStats& stats = compression_stats_->stats_;
+  const uint64_t length = message.length();
+  if (length < parent_.min_compressed_message_bytes_) {
+    stats.messages_uncompressed_.inc();
+    Common::prependGrpcFrameHeader(message);
+    return;
+  }
+
+  Compressor::ZlibCompressorImplPtr compressor = parent_.compressor_pool_->acquire();
+  compressor->compress(message, Compressor::State::Finish);
+  parent_.compressor_pool_->release(std::move(compressor));
+  stats.messages_compressed_.inc();
+  stats.bytes_before_compression_.add(length);
+  stats.bytes_after_compression_.add(message.length());
+  bytes_before_compression_ += length;
+  bytes_after_compression_ += message.length();
+
+  std::array<uint8_t, GRPC_FRAME_HEADER_SIZE> header;
+  Encoder().newFrame(GRPC_FH_COMPRESSED, message.length(), header);
+  message.prepend(absl::string_view(reinterpret_cast<const char*>(header.data()), header.size()));
+}
+
 void AsyncStreamImpl::closeStream() {
   Buffer::OwnedImpl empty_buffer;
   stream_->sendData(empty_buffer, true);
@@ -196,6 +291,13 @@ void AsyncStreamImpl::closeStream() {
 void AsyncStreamImpl::resetStream() { cleanup(); }
 
 void AsyncStreamImpl::cleanup() {
+  if (bytes_before_compression_ > 0) {
+    // The size of the compressed messages of the stream in percent of their original size.
+    compression_stats_->stats_.stream_compression_ratio_.recordValue(
+        bytes_after_compression_ * 100 / bytes_before_compression_);
+    bytes_before_compression_ = 0;
+  }
+
   if (!http_reset_) {
     http_reset_ = true;
     stream_->reset();
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "envoy/grpc/async_client.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/upstream/upstream.h"
 
 #include "common/common/linked_object.h"
+#include "common/compressor/zlib_compressor_pool.h"
 #include "common/grpc/codec.h"
 #include "common/grpc/typed_async_client.h"
 #include "common/http/async_client_impl.h"
@@ -13,6 +16,38 @@ namespace Grpc {
 class AsyncRequestImpl;
 class AsyncStreamImpl;
 
+/**
+ * All stats of the message compression of the Envoy gRPC client. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_GRPC_CLIENT_COMPRESSION_STATS(COUNTER, HISTOGRAM)                                      \
+  COUNTER(messages_compressed)                                                                     \
+  COUNTER(messages_uncompressed)                                                                   \
+  COUNTER(bytes_before_compression)                                                                \
+  COUNTER(bytes_after_compression)                                                                 \
+  HISTOGRAM(stream_compression_ratio)
+// clang-format on
+
+/**
+ * Struct definition for the compression stats. @see stats_macros.h
+ */
+struct GrpcClientCompressionStats {
+  ALL_GRPC_CLIENT_COMPRESSION_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * The compression stats in the scope of a cluster, which keeps the cluster info and thereby its
+ * scope alive for as long as a stream refers to them.
+ */
+struct ClusterCompressionStats {
+  ClusterCompressionStats(Upstream::ClusterInfoConstSharedPtr cluster);
+
+  const Upstream::ClusterInfoConstSharedPtr cluster_;
+  GrpcClientCompressionStats stats_;
+};
+
+using ClusterCompressionStatsSharedPtr = std::shared_ptr<ClusterCompressionStats>;
+
 class AsyncClientImpl final : public RawAsyncClient {
 public:
   AsyncClientImpl(Upstream::ClusterManager& cm, const envoy::api::v2::core::GrpcService& config,
@@ -28,11 +63,21 @@ public:
                            RawAsyncStreamCallbacks& callbacks) override;
 
 private:
+  const ClusterCompressionStatsSharedPtr&
+  compressionStats(const Upstream::ClusterInfoConstSharedPtr& cluster);
+
   Upstream::ClusterManager& cm_;
   const std::string remote_cluster_name_;
   const Protobuf::RepeatedPtrField<envoy::api::v2::core::HeaderValue> initial_metadata_;
   std::list<std::unique_ptr<AsyncStreamImpl>> active_streams_;
   TimeSource& time_source_;
+  // Only set if the messages are compressed. All the streams share the compressors, since they
+  // compress each message in one go.
+  std::unique_ptr<Compressor::ZlibCompressorPool> compressor_pool_;
+  const uint32_t min_compressed_message_bytes_;
+  // Cleared once the service responds that it does not accept gzip.
+  bool service_accepts_gzip_{true};
+  ClusterCompressionStatsSharedPtr compression_stats_;
 
   friend class AsyncRequestImpl;
   friend class AsyncStreamImpl;
@@ -62,6 +107,9 @@ public:
   void sendMessageRaw(Buffer::InstancePtr&& request, bool end_stream) override;
   void closeStream() override;
   void resetStream() override;
+  bool isAboveWriteBufferHighWatermark() const override {
+    return stream_ && stream_->isAboveWriteBufferHighWatermark();
+  }
 
   bool hasResetStream() const { return http_reset_; }
 
@@ -70,6 +118,7 @@ private:
   void streamError(Status::GrpcStatus grpc_status) { streamError(grpc_status, EMPTY_STRING); }
 
   void cleanup();
+  void compressMessage(Buffer::Instance& message);
   void trailerResponse(absl::optional<Status::GrpcStatus> grpc_status,
                        const std::string& grpc_message);
 
@@ -85,6 +134,11 @@ private:
   Decoder decoder_;
   // This is a member to avoid reallocation on every onData().
   std::vector<Frame> decoded_frames_;
+  // Only set while the messages of the stream are compressed.
+  ClusterCompressionStatsSharedPtr compression_stats_;
+  bool compress_{};
+  uint64_t bytes_before_compression_{};
+  uint64_t bytes_after_compression_{};
 
   friend class AsyncClientImpl;
 };
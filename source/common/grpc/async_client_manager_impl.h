@@ -42,8 +42,13 @@ private:
 
 class AsyncClientManagerImpl : public AsyncClientManager {
 public:
+  /**
+   * @param google_grpc_completion_threads supplies the number of threads polling the completion
+   *        queue of the Google gRPC clients of each thread.
+   */
   AsyncClientManagerImpl(Upstream::ClusterManager& cm, ThreadLocal::Instance& tls,
-                         TimeSource& time_source, Api::Api& api);
+                         TimeSource& time_source, Api::Api& api,
+                         uint32_t google_grpc_completion_threads);
 
   // Grpc::AsyncClientManager
   AsyncClientFactoryPtr factoryForGrpcService(const envoy::api::v2::core::GrpcService& config,
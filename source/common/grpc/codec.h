@@ -40,8 +40,10 @@ public:
 
   // Decodes the given buffer with GRPC data frame. Drains the input buffer when
   // decoding succeeded (returns true). If the input is not sufficient to make a
-  // complete GRPC data frame, it will be buffered in the decoder. If a decoding
-  // error happened, the input buffer remains unchanged.
+  // complete GRPC data frame, it will be buffered in the decoder. The data of
+  // the frames is moved out of the input, so whole slices are not copied. If a
+  // decoding error happened, the frames decoded before the error are drained
+  // from the input and the rest of the input remains unchanged.
   // @param input supplies the binary octets wrapped in a GRPC data frame.
   // @param output supplies the buffer to store the decoded data.
   // @return bool whether the decoding succeeded or not.
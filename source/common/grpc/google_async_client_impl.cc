@@ -15,8 +15,16 @@
 namespace Envoy {
 namespace Grpc {
 
-GoogleAsyncClientThreadLocal::GoogleAsyncClientThreadLocal(Api::Api& api)
-    : completion_thread_(api.threadFactory().createThread([this] { completionThread(); })) {}
+GoogleAsyncClientThreadLocal::GoogleAsyncClientThreadLocal(Api::Api& api,
+                                                           Event::Dispatcher& dispatcher,
+                                                           uint32_t completion_threads)
+    : dispatcher_(dispatcher), time_source_(api.timeSource()) {
+  ASSERT(completion_threads > 0);
+  for (uint32_t i = 0; i < completion_threads; ++i) {
+    completion_threads_.emplace_back(
+        api.threadFactory().createThread([this] { completionThread(); }));
+  }
+}
 
 GoogleAsyncClientThreadLocal::~GoogleAsyncClientThreadLocal() {
   // Force streams to shutdown and invoke TryCancel() to start the drain of
@@ -31,12 +39,14 @@ GoogleAsyncClientThreadLocal::~GoogleAsyncClientThreadLocal() {
   }
   cq_.Shutdown();
   ENVOY_LOG(debug, "Joining completionThread");
-  completion_thread_->join();
-  ENVOY_LOG(debug, "Joined completionThread");
-  // Ensure that we have cleaned up all orphan streams, now that CQ is gone.
-  while (!streams_.empty()) {
-    (*streams_.begin())->onCompletedOps();
+  for (Thread::ThreadPtr& completion_thread : completion_threads_) {
+    completion_thread->join();
   }
+  ENVOY_LOG(debug, "Joined completionThread");
+  // Ensure that we have cleaned up all orphan streams, now that CQ is gone and all of their ops
+  // are queued.
+  onCompletedOps();
+  ASSERT(streams_.empty());
 }
 
 void GoogleAsyncClientThreadLocal::completionThread() {
@@ -46,26 +56,39 @@ void GoogleAsyncClientThreadLocal::completionThread() {
   while (cq_.Next(&tag, &ok)) {
     const auto& google_async_tag = *reinterpret_cast<GoogleAsyncTag*>(tag);
     const GoogleAsyncTag::Operation op = google_async_tag.op_;
-    GoogleAsyncStreamImpl& stream = google_async_tag.stream_;
     ENVOY_LOG(trace, "completionThread CQ event {} {}", op, ok);
-    Thread::LockGuard lock(stream.completed_ops_lock_);
+    const MonotonicTime completed_at = time_source_.monotonicTime();
+    Thread::LockGuard lock(completed_ops_lock_);
 
-    // It's an invariant that there must only be one pending post for arbitrary
-    // length completed_ops_, otherwise we can race in stream destruction, where
-    // we process multiple events in onCompletedOps() but have only partially
-    // consumed the posts on the dispatcher.
+    // There is only one pending post for arbitrary length completed_ops_. A
+    // stream is only freed once all of its tags completed, so the streams of the
+    // queued ops are alive until the post processes them.
     // TODO(htuch): This may result in unbounded processing on the silo thread
     // in onCompletedOps() in extreme cases, when we emplace_back() in
     // completionThread() at a high rate, consider bounding the length of such
     // sequences if this behavior becomes an issue.
-    if (stream.completed_ops_.empty()) {
-      stream.dispatcher_.post([&stream] { stream.onCompletedOps(); });
+    if (completed_ops_.empty()) {
+      dispatcher_.post([this] { onCompletedOps(); });
     }
-    stream.completed_ops_.emplace_back(op, ok);
+    completed_ops_.push_back({&google_async_tag.stream_, op, ok, completed_at});
   }
   ENVOY_LOG(debug, "completionThread exiting");
 }
 
+void GoogleAsyncClientThreadLocal::onCompletedOps() {
+  ASSERT(processing_ops_.empty());
+  {
+    Thread::LockGuard lock(completed_ops_lock_);
+    processing_ops_.swap(completed_ops_);
+  }
+  const MonotonicTime now = time_source_.monotonicTime();
+  for (const CompletedOp& completed_op : processing_ops_) {
+    completed_op.stream_->handleOpCompletion(completed_op.op_, completed_op.ok_,
+                                             now - completed_op.completed_at_);
+  }
+  processing_ops_.clear();
+}
+
 GoogleAsyncClientImpl::GoogleAsyncClientImpl(Event::Dispatcher& dispatcher,
                                              GoogleAsyncClientThreadLocal& tls,
                                              GoogleStubFactory& stub_factory,
@@ -86,6 +109,7 @@ GoogleAsyncClientImpl::GoogleAsyncClientImpl(Event::Dispatcher& dispatcher,
   for (uint32_t i = 0; i <= Status::GrpcStatus::MaximumValid; ++i) {
     stats_.streams_closed_[i] = &scope_->counter(fmt::format("streams_closed_{}", i));
   }
+  stats_.completion_delay_us_ = &scope_->histogram("completion_delay_us");
 }
 
 GoogleAsyncClientImpl::~GoogleAsyncClientImpl() {
@@ -202,8 +226,8 @@ void GoogleAsyncStreamImpl::notifyRemoteClose(Status::GrpcStatus grpc_status,
 
 void GoogleAsyncStreamImpl::sendMessageRaw(Buffer::InstancePtr&& request, bool end_stream) {
   write_pending_queue_.emplace(std::move(request), end_stream);
-  ENVOY_LOG(trace, "Queued message to write ({} bytes)",
-            write_pending_queue_.back().buf_.value().Length());
+  bytes_in_write_pending_queue_ += write_pending_queue_.back().length();
+  ENVOY_LOG(trace, "Queued message to write ({} bytes)", write_pending_queue_.back().length());
   writeQueued();
 }
 
@@ -241,18 +265,8 @@ void GoogleAsyncStreamImpl::writeQueued() {
   ENVOY_LOG(trace, "Write op dispatched");
 }
 
-void GoogleAsyncStreamImpl::onCompletedOps() {
-  Thread::LockGuard lock(completed_ops_lock_);
-  while (!completed_ops_.empty()) {
-    GoogleAsyncTag::Operation op;
-    bool ok;
-    std::tie(op, ok) = completed_ops_.front();
-    completed_ops_.pop_front();
-    handleOpCompletion(op, ok);
-  }
-}
-
-void GoogleAsyncStreamImpl::handleOpCompletion(GoogleAsyncTag::Operation op, bool ok) {
+void GoogleAsyncStreamImpl::handleOpCompletion(GoogleAsyncTag::Operation op, bool ok,
+                                               std::chrono::steady_clock::duration delay) {
   ENVOY_LOG(trace, "handleOpCompletion op={} ok={} inflight={}", op, ok, inflight_tags_);
   ASSERT(inflight_tags_ > 0);
   --inflight_tags_;
@@ -263,6 +277,9 @@ void GoogleAsyncStreamImpl::handleOpCompletion(GoogleAsyncTag::Operation op, boo
     // Ignore op completions while draining CQ.
     return;
   }
+  // Streams which are not draining are still owned by parent_.
+  parent_.stats_.completion_delay_us_->recordValue(
+      std::chrono::duration_cast<std::chrono::microseconds>(delay).count());
   // Consider failure cases first.
   if (!ok) {
     // Early fails can be just treated as Internal.
@@ -306,6 +323,7 @@ void GoogleAsyncStreamImpl::handleOpCompletion(GoogleAsyncTag::Operation op, boo
   case GoogleAsyncTag::Operation::Write: {
     ASSERT(ok);
     write_pending_ = false;
+    bytes_in_write_pending_queue_ -= write_pending_queue_.front().length();
     write_pending_queue_.pop();
     writeQueued();
     break;
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <chrono>
 #include <queue>
+#include <vector>
 
 #include "envoy/api/api.h"
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
 #include "envoy/grpc/async_client.h"
 #include "envoy/stats/scope.h"
 #include "envoy/thread/thread.h"
@@ -65,7 +69,13 @@ struct GoogleAsyncTag {
 class GoogleAsyncClientThreadLocal : public ThreadLocal::ThreadLocalObject,
                                      Logger::Loggable<Logger::Id::grpc> {
 public:
-  GoogleAsyncClientThreadLocal(Api::Api& api);
+  /**
+   * @param api supplies the API used to create the completion threads.
+   * @param dispatcher supplies the dispatcher of the silo thread, which processes the completions.
+   * @param completion_threads supplies the number of threads polling the completion queue.
+   */
+  GoogleAsyncClientThreadLocal(Api::Api& api, Event::Dispatcher& dispatcher,
+                               uint32_t completion_threads);
   ~GoogleAsyncClientThreadLocal() override;
 
   grpc::CompletionQueue& completionQueue() { return cq_; }
@@ -82,10 +92,29 @@ public:
   }
 
 private:
+  struct CompletedOp {
+    GoogleAsyncStreamImpl* stream_;
+    GoogleAsyncTag::Operation op_;
+    bool ok_;
+    MonotonicTime completed_at_;
+  };
+
   void completionThread();
+  // Process the ops queued in completed_ops_ with handleOpCompletion() on the silo thread.
+  void onCompletedOps();
 
-  // The CompletionQueue for in-flight operations. This must precede completion_thread_ to ensure it
-  // is constructed before the thread runs.
+  Event::Dispatcher& dispatcher_;
+  TimeSource& time_source_;
+  // Queue of the ops completed by the completion threads since the silo thread last processed them.
+  // Only one post to the silo dispatcher is pending for all of them, whichever streams they
+  // belong to, so a busy CQ costs one dispatcher wakeup per batch rather than per op or stream.
+  std::vector<CompletedOp> completed_ops_ GUARDED_BY(completed_ops_lock_);
+  Thread::MutexBasicLockable completed_ops_lock_;
+  // The ops being processed by onCompletedOps(), swapped with completed_ops_ to keep the capacity
+  // of both.
+  std::vector<CompletedOp> processing_ops_;
+  // The CompletionQueue for in-flight operations. This must precede completion_threads_ to ensure
+  // it is constructed before the threads run.
   grpc::CompletionQueue cq_;
   // The threading model for the Google gRPC C++ library is not directly compatible with Envoy's
   // siloed model. We resolve this by issuing non-blocking asynchronous
@@ -94,9 +123,9 @@ private:
   // are delivered, we cross-post to the silo dispatcher to continue the
   // operation.
   //
-  // We have an independent completion thread for each TLS silo (i.e. one per worker and
-  // also one for the main thread).
-  Thread::ThreadPtr completion_thread_;
+  // We have independent completion threads for each TLS silo (i.e. for each worker and
+  // also for the main thread), as many as configured.
+  std::vector<Thread::ThreadPtr> completion_threads_;
   // Track all streams that are currently using this CQ, so we can notify them
   // on shutdown.
   std::unordered_set<GoogleAsyncStreamImpl*> streams_;
@@ -109,6 +138,8 @@ struct GoogleAsyncClientStats {
   Stats::Counter* streams_total_;
   // .streams_closed_<gRPC status code>
   std::array<Stats::Counter*, Status::GrpcStatus::MaximumValid + 1> streams_closed_;
+  // .completion_delay_us
+  Stats::Histogram* completion_delay_us_;
 };
 
 // Interface to allow the gRPC stub to be mocked out by tests.
@@ -207,17 +238,19 @@ public:
   void sendMessageRaw(Buffer::InstancePtr&& request, bool end_stream) override;
   void closeStream() override;
   void resetStream() override;
+  bool isAboveWriteBufferHighWatermark() const override {
+    return bytes_in_write_pending_queue_ > WriteBufferHighWatermarkBytes;
+  }
 
 protected:
   bool call_failed() const { return call_failed_; }
 
 private:
-  // Process queued events in completed_ops_ with handleOpCompletion() on
-  // GoogleAsyncClient silo thread.
-  void onCompletedOps();
   // Handle Operation completion on GoogleAsyncClient silo thread. This is posted by
   // GoogleAsyncClientThreadLocal::completionThread() when a message is received on cq_.
-  void handleOpCompletion(GoogleAsyncTag::Operation op, bool ok);
+  // @param delay supplies the time between the completion on cq_ and its handling.
+  void handleOpCompletion(GoogleAsyncTag::Operation op, bool ok,
+                          std::chrono::steady_clock::duration delay);
   // Convert from Google gRPC client std::multimap metadata to Envoy Http::HeaderMap.
   void metadataTranslate(const std::multimap<grpc::string_ref, grpc::string_ref>& grpc_metadata,
                          Http::HeaderMap& header_map);
@@ -239,6 +272,8 @@ private:
     // End-of-stream with no additional message.
     PendingMessage() = default;
 
+    uint64_t length() const { return buf_ ? buf_.value().Length() : 0; }
+
     const absl::optional<grpc::ByteBuffer> buf_;
     const bool end_stream_{true};
   };
@@ -252,7 +287,7 @@ private:
 
   GoogleAsyncClientImpl& parent_;
   GoogleAsyncClientThreadLocal& tls_;
-  // Latch our own version of this reference, so that completionThread() doesn't
+  // Latch our own version of this reference, so that deferredDelete() doesn't
   // try and access via parent_, which might not exist in teardown. We assume
   // that the dispatcher lives longer than completionThread() life, which should
   // hold for the expected server object lifetimes.
@@ -267,6 +302,11 @@ private:
   grpc::ClientContext ctxt_;
   std::unique_ptr<grpc::GenericClientAsyncReaderWriter> rw_;
   std::queue<PendingMessage> write_pending_queue_;
+  // Total length of the messages in write_pending_queue_.
+  uint64_t bytes_in_write_pending_queue_{};
+  // Google gRPC has no connection buffer limit to report on, so the stream considers itself above
+  // the high watermark once this much is queued behind the in-flight write.
+  static constexpr uint64_t WriteBufferHighWatermarkBytes = 1024 * 1024;
   grpc::ByteBuffer read_buf_;
   grpc::Status status_;
   // Has Operation::Init completed?
@@ -283,11 +323,6 @@ private:
   // Count of the tags in-flight. This must hit zero before the stream can be
   // freed.
   uint32_t inflight_tags_{};
-  // Queue of completed (op, ok) passed from completionThread() to
-  // handleOpCompletion().
-  std::deque<std::pair<GoogleAsyncTag::Operation, bool>>
-      completed_ops_ GUARDED_BY(completed_ops_lock_);
-  Thread::MutexBasicLockable completed_ops_lock_;
 
   friend class GoogleAsyncClientImpl;
   friend class GoogleAsyncClientThreadLocal;
@@ -77,7 +77,7 @@ AsyncStreamImpl::AsyncStreamImpl(AsyncClientImpl& parent, AsyncClient::StreamCal
       router_(parent.config_), stream_info_(Protocol::Http11, parent.dispatcher().timeSource()),
       tracing_config_(Tracing::EgressConfig::get()),
       route_(std::make_shared<RouteImpl>(parent_.cluster_->name(), options.timeout)),
-      send_xff_(options.send_xff) {
+      send_xff_(options.send_xff), buffer_limit_(options.buffer_limit) {
   if (options.buffer_body_for_retry) {
     buffered_body_ = std::make_unique<Buffer::OwnedImpl>();
   }
@@ -85,6 +85,7 @@ public:
   void sendData(Buffer::Instance& data, bool end_stream) override;
   void sendTrailers(HeaderMap& trailers) override;
   void reset() override;
+  bool isAboveWriteBufferHighWatermark() const override { return high_watermark_calls_ > 0; }
 
 protected:
   bool remoteClosed() { return remote_closed_; }
@@ -100,6 +101,8 @@ private:
       return additional_request_chance_;
     }
     bool hedgeOnPerTryTimeout() const override { return false; }
+    absl::optional<double> hedgeOnLatencyPercentile() const override { return absl::nullopt; }
+    double hedgeBudgetPercent() const override { return 0; }
 
     const envoy::type::FractionalPercent additional_request_chance_;
   };
@@ -145,6 +148,7 @@ private:
     const std::string& cluster() const override { return EMPTY_STRING; }
     const std::string& runtimeKey() const override { return EMPTY_STRING; }
     const envoy::type::FractionalPercent& defaultValue() const override { return default_value_; }
+    bool streamBody() const override { return false; }
 
   private:
     envoy::type::FractionalPercent default_value_;
@@ -277,6 +281,9 @@ private:
     const Router::RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override {
       return nullptr;
     }
+    const Router::RouteSpecificFilterConfig* mostSpecificPerFilterConfig(uint32_t) const override {
+      return nullptr;
+    }
 
     RouteEntryImpl route_entry_;
   };
@@ -335,12 +342,15 @@ private:
   void encodeData(Buffer::Instance& data, bool end_stream) override;
   void encodeTrailers(HeaderMapPtr&& trailers) override;
   void encodeMetadata(MetadataMapPtr&&) override {}
-  void onDecoderFilterAboveWriteBufferHighWatermark() override {}
-  void onDecoderFilterBelowWriteBufferLowWatermark() override {}
+  void onDecoderFilterAboveWriteBufferHighWatermark() override { ++high_watermark_calls_; }
+  void onDecoderFilterBelowWriteBufferLowWatermark() override {
+    ASSERT(high_watermark_calls_ != 0);
+    --high_watermark_calls_;
+  }
   void addDownstreamWatermarkCallbacks(DownstreamWatermarkCallbacks&) override {}
   void removeDownstreamWatermarkCallbacks(DownstreamWatermarkCallbacks&) override {}
   void setDecoderBufferLimit(uint32_t) override {}
-  uint32_t decoderBufferLimit() override { return 0; }
+  uint32_t decoderBufferLimit() override { return buffer_limit_; }
   bool recreateStream() override { return false; }
   const ScopeTrackedObject& scope() override { return *this; }
   void addUpstreamSocketOptions(const Network::Socket::OptionsSharedPtr&) override {}
@@ -366,6 +376,10 @@ private:
   bool is_grpc_request_{};
   bool is_head_request_{false};
   bool send_xff_{true};
+  const uint32_t buffer_limit_;
+  // The router may report the upstream above the high watermark more than once, e.g. across
+  // retries, so the calls are counted rather than latched.
+  uint32_t high_watermark_calls_{};
 
   friend class AsyncClientImpl;
   friend class AsyncClientImplRouteTest;
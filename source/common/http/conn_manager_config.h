@@ -46,6 +46,7 @@ namespace Http {
   COUNTER(downstream_rq_idle_timeout)                                                              \
   COUNTER(downstream_rq_non_relative_path)                                                         \
   COUNTER(downstream_rq_overload_close)                                                            \
+  COUNTER(downstream_rq_overload_reset)                                                            \
   COUNTER(downstream_rq_response_before_rq_complete)                                               \
   COUNTER(downstream_rq_rx_reset)                                                                  \
   COUNTER(downstream_rq_timeout)                                                                   \
@@ -63,6 +64,8 @@ namespace Http {
   GAUGE(downstream_cx_upgrades_active, Accumulate)                                                 \
   GAUGE(downstream_rq_active, Accumulate)                                                          \
   HISTOGRAM(downstream_cx_length_ms)                                                               \
+  HISTOGRAM(downstream_rq_allocated_bytes)                                                         \
+  HISTOGRAM(downstream_rq_allocations)                                                             \
   HISTOGRAM(downstream_rq_time)
 
 /**
@@ -228,6 +231,12 @@ public:
    */
   virtual uint32_t maxRequestHeadersKb() const PURE;
 
+  /**
+   * @return the buffer limit of the connection and of its streams while the reduce buffer limits
+   *         overload action is active. Zero indicates that the limits are not reduced.
+   */
+  virtual uint32_t overloadBufferLimit() const PURE;
+
   /**
    * @return per-stream idle timeout for incoming connection manager connections. Zero indicates a
    *         disabled idle timeout.
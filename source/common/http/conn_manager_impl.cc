@@ -1,10 +1,12 @@
 #include "common/http/conn_manager_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <list>
 #include <memory>
 #include <string>
+#include <typeinfo>
 #include <vector>
 
 #include "envoy/buffer/buffer.h"
@@ -35,6 +37,7 @@
 #include "common/network/utility.h"
 #include "common/runtime/runtime_impl.h"
 
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/match.h"
 
@@ -43,7 +46,7 @@ namespace Http {
 
 namespace {
 
-template <class T> using FilterList = std::list<std::unique_ptr<T>>;
+template <class T> using FilterList = std::vector<std::unique_ptr<T>>;
 
 // Shared helper for recording the latest filter used.
 template <class T>
@@ -112,7 +115,27 @@ ConnectionManagerImpl::ConnectionManagerImpl(ConnectionManagerConfig& config,
           overload_manager ? overload_manager->getThreadLocalOverloadState().getState(
                                  Server::OverloadActionNames::get().DisableHttpKeepAlive)
                            : Server::OverloadManager::getInactiveState()),
-      time_source_(time_source) {}
+      overload_reduce_http2_max_concurrent_streams_ref_(
+          overload_manager
+              ? overload_manager->getThreadLocalOverloadState().getState(
+                    Server::OverloadActionNames::get().ReduceHttp2MaxConcurrentStreams)
+              : Server::OverloadManager::getInactiveState()),
+      overload_active_requests_(
+          overload_manager ? &overload_manager->getThreadLocalOverloadState().activeRequests()
+                           : nullptr),
+      overload_reduce_buffer_limits_ref_(
+          overload_manager ? overload_manager->getThreadLocalOverloadState().getState(
+                                 Server::OverloadActionNames::get().ReduceBufferLimits)
+                           : Server::OverloadManager::getInactiveState()),
+      overload_buffer_limit_(overload_manager ? config_.overloadBufferLimit() : 0),
+      time_source_(time_source) {
+  if (overload_buffer_limit_ > 0) {
+    overload_reduce_buffer_limits_cb_ =
+        overload_manager->getThreadLocalOverloadState().addActionCallback(
+            Server::OverloadActionNames::get().ReduceBufferLimits,
+            [this](Server::OverloadActionState state) { onReduceBufferLimits(state); });
+  }
+}
 
 const HeaderMapImpl& ConnectionManagerImpl::continueHeader() {
   CONSTRUCT_ON_FIRST_USE(HeaderMapImpl,
@@ -131,7 +154,7 @@ void ConnectionManagerImpl::initializeReadFilterCallbacks(Network::ReadFilterCal
   read_callbacks_->connection().addConnectionCallbacks(*this);
 
   if (config_.idleTimeout()) {
-    connection_idle_timer_ = read_callbacks_->connection().dispatcher().createTimer(
+    connection_idle_timer_ = read_callbacks_->connection().dispatcher().createCoarseTimer(
         [this]() -> void { onIdleTimeout(); });
     connection_idle_timer_->enableTimer(config_.idleTimeout().value());
   }
@@ -142,9 +165,18 @@ void ConnectionManagerImpl::initializeReadFilterCallbacks(Network::ReadFilterCal
       {stats_.named_.downstream_cx_rx_bytes_total_, stats_.named_.downstream_cx_rx_bytes_buffered_,
        stats_.named_.downstream_cx_tx_bytes_total_, stats_.named_.downstream_cx_tx_bytes_buffered_,
        nullptr, &stats_.named_.downstream_cx_delayed_close_timeout_});
+
+  connection_buffer_limit_ = read_callbacks_->connection().bufferLimit();
+  if (overload_buffer_limit_ > 0 &&
+      overload_reduce_buffer_limits_ref_ == Server::OverloadActionState::Active) {
+    onReduceBufferLimits(Server::OverloadActionState::Active);
+  }
 }
 
 ConnectionManagerImpl::~ConnectionManagerImpl() {
+  if (overload_reduce_buffer_limits_cb_ != nullptr) {
+    overload_reduce_buffer_limits_cb_->remove();
+  }
   stats_.named_.downstream_cx_destroy_.inc();
   stats_.named_.downstream_cx_active_.dec();
   if (read_callbacks_->connection().ssl()) {
@@ -245,11 +277,19 @@ StreamDecoder& ConnectionManagerImpl::newStream(StreamEncoder& response_encoder,
   }
 
   ENVOY_CONN_LOG(debug, "new stream", read_callbacks_->connection());
+  // The codec advertises the change to the client at most once per change of the overload state.
+  codec_->reduceMaxConcurrentStreams(overload_reduce_http2_max_concurrent_streams_ref_ ==
+                                     Server::OverloadActionState::Active);
   ActiveStreamPtr new_stream(new ActiveStream(*this));
   new_stream->state_.is_internally_created_ = is_internally_created;
   new_stream->response_encoder_ = &response_encoder;
   new_stream->response_encoder_->getStream().addCallbacks(*new_stream);
   new_stream->buffer_limit_ = new_stream->response_encoder_->getStream().bufferLimit();
+  if (overload_buffer_limit_ > 0 &&
+      overload_reduce_buffer_limits_ref_ == Server::OverloadActionState::Active &&
+      (new_stream->buffer_limit_ == 0 || new_stream->buffer_limit_ > overload_buffer_limit_)) {
+    new_stream->buffer_limit_ = overload_buffer_limit_;
+  }
   // If the network connection is backed up, the stream should be made aware of it on creation.
   // Both HTTP/1.x and HTTP/2 codecs handle this in StreamCallbackHelper::addCallbacks_.
   ASSERT(read_callbacks_->connection().aboveHighWatermark() == false ||
@@ -348,6 +388,55 @@ void ConnectionManagerImpl::resetAllStreams() {
   }
 }
 
+void ConnectionManagerImpl::onReduceBufferLimits(Server::OverloadActionState state) {
+  Network::Connection& connection = read_callbacks_->connection();
+  if (state == Server::OverloadActionState::Inactive) {
+    // The streams keep their reduced limits, the new ones get those of the codec again.
+    connection.setBufferLimits(connection_buffer_limit_);
+    return;
+  }
+
+  if (connection_buffer_limit_ == 0 || connection_buffer_limit_ > overload_buffer_limit_) {
+    connection.setBufferLimits(overload_buffer_limit_);
+  }
+  resetLargestStreams(overload_buffer_limit_);
+  for (ActiveStreamPtr& stream : streams_) {
+    if (stream->buffer_limit_ == 0 || stream->buffer_limit_ > overload_buffer_limit_) {
+      stream->setBufferLimit(overload_buffer_limit_);
+    }
+  }
+}
+
+void ConnectionManagerImpl::resetLargestStreams(uint64_t limit) {
+  std::vector<std::pair<uint64_t, ActiveStream*>> buffered_streams;
+  uint64_t buffered_bytes = 0;
+  for (ActiveStreamPtr& stream : streams_) {
+    const uint64_t stream_bytes = stream->bufferedBytes();
+    if (stream_bytes > 0) {
+      buffered_streams.emplace_back(stream_bytes, stream.get());
+      buffered_bytes += stream_bytes;
+    }
+  }
+  if (buffered_bytes <= limit) {
+    return;
+  }
+
+  std::sort(buffered_streams.begin(), buffered_streams.end(),
+            [](const std::pair<uint64_t, ActiveStream*>& lhs,
+               const std::pair<uint64_t, ActiveStream*>& rhs) { return lhs.first > rhs.first; });
+  for (const auto& buffered_stream : buffered_streams) {
+    // Resetting an HTTP/1 stream closes the connection, along with its other streams.
+    if (buffered_bytes <= limit || drain_state_ == DrainState::Closing) {
+      break;
+    }
+    ENVOY_STREAM_LOG(debug, "resetting stream buffering {} bytes due to overload",
+                     *buffered_stream.second, buffered_stream.first);
+    buffered_bytes -= buffered_stream.first;
+    stats_.named_.downstream_rq_overload_reset_.inc();
+    doEndStream(*buffered_stream.second);
+  }
+}
+
 void ConnectionManagerImpl::onEvent(Network::ConnectionEvent event) {
   if (event == Network::ConnectionEvent::LocalClose) {
     stats_.named_.downstream_cx_destroy_local_.inc();
@@ -436,12 +525,17 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
       request_response_timespan_(new Stats::Timespan(
           connection_manager_.stats_.named_.downstream_rq_time_, connection_manager_.timeSource())),
       stream_info_(connection_manager_.codec_->protocol(), connection_manager_.timeSource()),
+      track_allocations_(Memory::AllocationTracker::enabled()),
       upstream_options_(std::make_shared<Network::Socket::Options>()) {
   ScopeTrackerScopeState scope(this,
                                connection_manager_.read_callbacks_->connection().dispatcher());
+  Memory::AllocationScope allocation_scope(allocationCounts());
 
   connection_manager_.stats_.named_.downstream_rq_total_.inc();
   connection_manager_.stats_.named_.downstream_rq_active_.inc();
+  if (connection_manager_.overload_active_requests_ != nullptr) {
+    ++*connection_manager_.overload_active_requests_;
+  }
   if (connection_manager_.codec_->protocol() == Protocol::Http2) {
     connection_manager_.stats_.named_.downstream_rq_http2_total_.inc();
   } else {
@@ -462,15 +556,17 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
 
   if (connection_manager_.config_.streamIdleTimeout().count()) {
     idle_timeout_ms_ = connection_manager_.config_.streamIdleTimeout();
-    stream_idle_timer_ = connection_manager_.read_callbacks_->connection().dispatcher().createTimer(
-        [this]() -> void { onIdleTimeout(); });
+    stream_idle_timer_ =
+        connection_manager_.read_callbacks_->connection().dispatcher().createCoarseTimer(
+            [this]() -> void { onIdleTimeout(); });
     resetIdleTimer();
   }
 
   if (connection_manager_.config_.requestTimeout().count()) {
     std::chrono::milliseconds request_timeout_ms_ = connection_manager_.config_.requestTimeout();
-    request_timer_ = connection_manager.read_callbacks_->connection().dispatcher().createTimer(
-        [this]() -> void { onRequestTimeout(); });
+    request_timer_ =
+        connection_manager.read_callbacks_->connection().dispatcher().createCoarseTimer(
+            [this]() -> void { onRequestTimeout(); });
     request_timer_->enableTimer(request_timeout_ms_);
   }
 
@@ -488,6 +584,12 @@ ConnectionManagerImpl::ActiveStream::~ActiveStream() {
   }
 
   connection_manager_.stats_.named_.downstream_rq_active_.dec();
+  if (connection_manager_.overload_active_requests_ != nullptr) {
+    --*connection_manager_.overload_active_requests_;
+  }
+  if (track_allocations_) {
+    recordAllocations();
+  }
   for (const AccessLog::InstanceSharedPtr& access_log : connection_manager_.config_.accessLogs()) {
     access_log->log(request_headers_.get(), response_headers_.get(), response_trailers_.get(),
                     stream_info_);
@@ -512,6 +614,38 @@ ConnectionManagerImpl::ActiveStream::~ActiveStream() {
   ASSERT(state_.filter_call_state_ == 0);
 }
 
+void ConnectionManagerImpl::ActiveStream::recordAllocations() {
+  // A filter added for both directions has a wrapper in each, whose counts are merged.
+  absl::InlinedVector<std::pair<const std::type_info*, Memory::AllocationCounts>, 8> filters;
+  const auto add_filter = [&filters](const std::type_info& type,
+                                     const Memory::AllocationCounts& counts) {
+    for (auto& filter : filters) {
+      if (*filter.first == type) {
+        filter.second.add(counts);
+        return;
+      }
+    }
+    filters.emplace_back(&type, counts);
+  };
+  for (const ActiveStreamDecoderFilterPtr& filter : decoder_filters_) {
+    const StreamDecoderFilter& handle = *filter->handle_;
+    add_filter(typeid(handle), filter->allocation_counts_);
+  }
+  for (const ActiveStreamEncoderFilterPtr& filter : encoder_filters_) {
+    const StreamEncoderFilter& handle = *filter->handle_;
+    add_filter(typeid(handle), filter->allocation_counts_);
+  }
+
+  Memory::AllocationCounts total = allocation_counts_;
+  Memory::AllocationTracker::record("http_connection_manager", allocation_counts_);
+  for (const auto& filter : filters) {
+    Memory::AllocationTracker::record(*filter.first, filter.second);
+    total.add(filter.second);
+  }
+  connection_manager_.stats_.named_.downstream_rq_allocations_.recordValue(total.allocations_);
+  connection_manager_.stats_.named_.downstream_rq_allocated_bytes_.recordValue(total.bytes_);
+}
+
 void ConnectionManagerImpl::ActiveStream::resetIdleTimer() {
   if (stream_idle_timer_ != nullptr) {
     // TODO(htuch): If this shows up in performance profiles, optimize by only
@@ -548,14 +682,16 @@ void ConnectionManagerImpl::ActiveStream::addStreamDecoderFilterWorker(
     StreamDecoderFilterSharedPtr filter, bool dual_filter) {
   ActiveStreamDecoderFilterPtr wrapper(new ActiveStreamDecoderFilter(*this, filter, dual_filter));
   filter->setDecoderFilterCallbacks(*wrapper);
-  wrapper->moveIntoListBack(std::move(wrapper), decoder_filters_);
+  wrapper->index_ = decoder_filters_.size();
+  decoder_filters_.push_back(std::move(wrapper));
 }
 
 void ConnectionManagerImpl::ActiveStream::addStreamEncoderFilterWorker(
     StreamEncoderFilterSharedPtr filter, bool dual_filter) {
   ActiveStreamEncoderFilterPtr wrapper(new ActiveStreamEncoderFilter(*this, filter, dual_filter));
   filter->setEncoderFilterCallbacks(*wrapper);
-  wrapper->moveIntoList(std::move(wrapper), encoder_filters_);
+  wrapper->index_from_end_ = encoder_filters_.size() + 1;
+  encoder_filters_.insert(encoder_filters_.begin(), std::move(wrapper));
 }
 
 void ConnectionManagerImpl::ActiveStream::addAccessLogHandler(
@@ -611,6 +747,7 @@ const Network::Connection* ConnectionManagerImpl::ActiveStream::connection() {
 void ConnectionManagerImpl::ActiveStream::decodeHeaders(HeaderMapPtr&& headers, bool end_stream) {
   ScopeTrackerScopeState scope(this,
                                connection_manager_.read_callbacks_->connection().dispatcher());
+  Memory::AllocationScope allocation_scope(allocationCounts());
   request_headers_ = std::move(headers);
   if (Http::Headers::get().MethodValues.Head ==
       request_headers_->Method()->value().getStringView()) {
@@ -782,7 +919,7 @@ void ConnectionManagerImpl::ActiveStream::decodeHeaders(HeaderMapPtr&& headers,
         // If we have a route-level idle timeout but no global stream idle timeout, create a timer.
         if (stream_idle_timer_ == nullptr) {
           stream_idle_timer_ =
-              connection_manager_.read_callbacks_->connection().dispatcher().createTimer(
+              connection_manager_.read_callbacks_->connection().dispatcher().createCoarseTimer(
                   [this]() -> void { onIdleTimeout(); });
         }
       } else if (stream_idle_timer_ != nullptr) {
@@ -821,9 +958,12 @@ void ConnectionManagerImpl::ActiveStream::traceRequest() {
   // TODO: Need to investigate the following code based on the cached route, as may
   // be broken in the case a filter changes the route.
 
-  // If a decorator has been defined, apply it to the active span.
+  // If a decorator has been defined, apply it to the active span if the span is reported. Its
+  // operation is propagated either way.
   if (hasCachedRoute() && cached_route_.value()->decorator()) {
-    cached_route_.value()->decorator()->apply(*active_span_);
+    if (active_span_->sampled()) {
+      cached_route_.value()->decorator()->apply(*active_span_);
+    }
 
     // Cache decorated operation.
     if (!cached_route_.value()->decorator()->getOperation().empty()) {
@@ -860,11 +1000,12 @@ void ConnectionManagerImpl::ActiveStream::traceRequest() {
 void ConnectionManagerImpl::ActiveStream::decodeHeaders(ActiveStreamDecoderFilter* filter,
                                                         HeaderMap& headers, bool end_stream) {
   // Headers filter iteration should always start with the next filter if available.
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry =
+  std::vector<ActiveStreamDecoderFilterPtr>::iterator entry =
       commonDecodePrefix(filter, FilterIterationStartState::AlwaysStartFromNext);
-  std::list<ActiveStreamDecoderFilterPtr>::iterator continue_data_entry = decoder_filters_.end();
+  std::vector<ActiveStreamDecoderFilterPtr>::iterator continue_data_entry = decoder_filters_.end();
 
   for (; entry != decoder_filters_.end(); entry++) {
+    Memory::AllocationScope allocation_scope((*entry)->allocationCounts());
     ASSERT(!(state_.filter_call_state_ & FilterCallState::DecodeHeaders));
     state_.filter_call_state_ |= FilterCallState::DecodeHeaders;
     (*entry)->end_stream_ =
@@ -923,6 +1064,7 @@ void ConnectionManagerImpl::ActiveStream::decodeHeaders(ActiveStreamDecoderFilte
 void ConnectionManagerImpl::ActiveStream::decodeData(Buffer::Instance& data, bool end_stream) {
   ScopeTrackerScopeState scope(this,
                                connection_manager_.read_callbacks_->connection().dispatcher());
+  Memory::AllocationScope allocation_scope(allocationCounts());
   maybeEndDecode(end_stream);
   stream_info_.addBytesReceived(data.length());
 
@@ -934,6 +1076,7 @@ void ConnectionManagerImpl::ActiveStream::decodeData(
     FilterIterationStartState filter_iteration_start_state) {
   ScopeTrackerScopeState scope(this,
                                connection_manager_.read_callbacks_->connection().dispatcher());
+  Memory::AllocationScope allocation_scope(allocationCounts());
   resetIdleTimer();
 
   // If we previously decided to decode only the headers, do nothing here.
@@ -950,10 +1093,11 @@ void ConnectionManagerImpl::ActiveStream::decodeData(
   auto trailers_added_entry = decoder_filters_.end();
   const bool trailers_exists_at_start = request_trailers_ != nullptr;
   // Filter iteration may start at the current filter.
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry =
+  std::vector<ActiveStreamDecoderFilterPtr>::iterator entry =
       commonDecodePrefix(filter, filter_iteration_start_state);
 
   for (; entry != decoder_filters_.end(); entry++) {
+    Memory::AllocationScope allocation_scope((*entry)->allocationCounts());
     // If the filter pointed by entry has stopped for all frame types, return now.
     if (handleDataIfStopAll(**entry, data, state_.decoder_filters_streaming_)) {
       return;
@@ -1081,6 +1225,7 @@ MetadataMapVector& ConnectionManagerImpl::ActiveStream::addDecodedMetadata() {
 void ConnectionManagerImpl::ActiveStream::decodeTrailers(HeaderMapPtr&& trailers) {
   ScopeTrackerScopeState scope(this,
                                connection_manager_.read_callbacks_->connection().dispatcher());
+  Memory::AllocationScope allocation_scope(allocationCounts());
   resetIdleTimer();
   maybeEndDecode(true);
   request_trailers_ = std::move(trailers);
@@ -1100,10 +1245,11 @@ void ConnectionManagerImpl::ActiveStream::decodeTrailers(ActiveStreamDecoderFilt
   }
 
   // Filter iteration may start at the current filter.
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry =
+  std::vector<ActiveStreamDecoderFilterPtr>::iterator entry =
       commonDecodePrefix(filter, FilterIterationStartState::CanStartFromCurrent);
 
   for (; entry != decoder_filters_.end(); entry++) {
+    Memory::AllocationScope allocation_scope((*entry)->allocationCounts());
     // If the filter pointed by entry has stopped for all frame type, return now.
     if ((*entry)->stoppedAll()) {
       return;
@@ -1138,10 +1284,11 @@ void ConnectionManagerImpl::ActiveStream::decodeMetadata(MetadataMapPtr&& metada
 void ConnectionManagerImpl::ActiveStream::decodeMetadata(ActiveStreamDecoderFilter* filter,
                                                          MetadataMap& metadata_map) {
   // Filter iteration may start at the current filter.
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry =
+  std::vector<ActiveStreamDecoderFilterPtr>::iterator entry =
       commonDecodePrefix(filter, FilterIterationStartState::CanStartFromCurrent);
 
   for (; entry != decoder_filters_.end(); entry++) {
+    Memory::AllocationScope allocation_scope((*entry)->allocationCounts());
     // If the filter pointed by entry has stopped for all frame type, stores metadata and returns.
     // If the filter pointed by entry hasn't returned from decodeHeaders, stores newly added
     // metadata in case decodeHeaders returns StopAllIteration. The latter can happen when headers
@@ -1174,7 +1321,7 @@ void ConnectionManagerImpl::ActiveStream::disarmRequestTimeout() {
   }
 }
 
-std::list<ConnectionManagerImpl::ActiveStreamEncoderFilterPtr>::iterator
+std::vector<ConnectionManagerImpl::ActiveStreamEncoderFilterPtr>::iterator
 ConnectionManagerImpl::ActiveStream::commonEncodePrefix(
     ActiveStreamEncoderFilter* filter, bool end_stream,
     FilterIterationStartState filter_iteration_start_state) {
@@ -1186,28 +1333,30 @@ ConnectionManagerImpl::ActiveStream::commonEncodePrefix(
     return encoder_filters_.begin();
   }
 
+  auto entry = encoder_filters_.end() - filter->index_from_end_;
   if (filter_iteration_start_state == FilterIterationStartState::CanStartFromCurrent &&
-      (*(filter->entry()))->iterate_from_current_filter_) {
+      (*entry)->iterate_from_current_filter_) {
     // The filter iteration has been stopped for all frame types, and now the iteration continues.
     // The current filter's encoding callback has not be called. Call it now.
-    return filter->entry();
+    return entry;
   }
-  return std::next(filter->entry());
+  return std::next(entry);
 }
 
-std::list<ConnectionManagerImpl::ActiveStreamDecoderFilterPtr>::iterator
+std::vector<ConnectionManagerImpl::ActiveStreamDecoderFilterPtr>::iterator
 ConnectionManagerImpl::ActiveStream::commonDecodePrefix(
     ActiveStreamDecoderFilter* filter, FilterIterationStartState filter_iteration_start_state) {
   if (!filter) {
     return decoder_filters_.begin();
   }
+  auto entry = decoder_filters_.begin() + filter->index_;
   if (filter_iteration_start_state == FilterIterationStartState::CanStartFromCurrent &&
-      (*(filter->entry()))->iterate_from_current_filter_) {
+      (*entry)->iterate_from_current_filter_) {
     // The filter iteration has been stopped for all frame types, and now the iteration continues.
     // The current filter's callback function has not been called. Call it now.
-    return filter->entry();
+    return entry;
   }
-  return std::next(filter->entry());
+  return std::next(entry);
 }
 
 void ConnectionManagerImpl::startDrainSequence() {
@@ -1268,6 +1417,7 @@ void ConnectionManagerImpl::ActiveStream::sendLocalReply(
 
 void ConnectionManagerImpl::ActiveStream::encode100ContinueHeaders(
     ActiveStreamEncoderFilter* filter, HeaderMap& headers) {
+  Memory::AllocationScope allocation_scope(allocationCounts());
   resetIdleTimer();
   ASSERT(connection_manager_.config_.proxy100Continue());
   // Make sure commonContinue continues encode100ContinueHeaders.
@@ -1278,9 +1428,10 @@ void ConnectionManagerImpl::ActiveStream::encode100ContinueHeaders(
   // end-stream, and because there are normal headers coming there's no need for
   // complex continuation logic.
   // 100-continue filter iteration should always start with the next filter if available.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry =
+  std::vector<ActiveStreamEncoderFilterPtr>::iterator entry =
       commonEncodePrefix(filter, false, FilterIterationStartState::AlwaysStartFromNext);
   for (; entry != encoder_filters_.end(); entry++) {
+    Memory::AllocationScope allocation_scope((*entry)->allocationCounts());
     ASSERT(!(state_.filter_call_state_ & FilterCallState::Encode100ContinueHeaders));
     state_.filter_call_state_ |= FilterCallState::Encode100ContinueHeaders;
     FilterHeadersStatus status = (*entry)->handle_->encode100ContinueHeaders(headers);
@@ -1307,15 +1458,17 @@ void ConnectionManagerImpl::ActiveStream::encode100ContinueHeaders(
 
 void ConnectionManagerImpl::ActiveStream::encodeHeaders(ActiveStreamEncoderFilter* filter,
                                                         HeaderMap& headers, bool end_stream) {
+  Memory::AllocationScope allocation_scope(allocationCounts());
   resetIdleTimer();
   disarmRequestTimeout();
 
   // Headers filter iteration should always start with the next filter if available.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry =
+  std::vector<ActiveStreamEncoderFilterPtr>::iterator entry =
       commonEncodePrefix(filter, end_stream, FilterIterationStartState::AlwaysStartFromNext);
-  std::list<ActiveStreamEncoderFilterPtr>::iterator continue_data_entry = encoder_filters_.end();
+  std::vector<ActiveStreamEncoderFilterPtr>::iterator continue_data_entry = encoder_filters_.end();
 
   for (; entry != encoder_filters_.end(); entry++) {
+    Memory::AllocationScope allocation_scope((*entry)->allocationCounts());
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeHeaders));
     state_.filter_call_state_ |= FilterCallState::EncodeHeaders;
     (*entry)->end_stream_ =
@@ -1456,12 +1609,14 @@ void ConnectionManagerImpl::ActiveStream::encodeHeaders(ActiveStreamEncoderFilte
 
 void ConnectionManagerImpl::ActiveStream::encodeMetadata(ActiveStreamEncoderFilter* filter,
                                                          MetadataMapPtr&& metadata_map_ptr) {
+  Memory::AllocationScope allocation_scope(allocationCounts());
   resetIdleTimer();
 
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry =
+  std::vector<ActiveStreamEncoderFilterPtr>::iterator entry =
       commonEncodePrefix(filter, false, FilterIterationStartState::CanStartFromCurrent);
 
   for (; entry != encoder_filters_.end(); entry++) {
+    Memory::AllocationScope allocation_scope((*entry)->allocationCounts());
     // If the filter pointed by entry has stopped for all frame type, stores metadata and returns.
     // If the filter pointed by entry hasn't returned from encodeHeaders, stores newly added
     // metadata in case encodeHeaders returns StopAllIteration. The latter can happen when headers
@@ -1521,6 +1676,7 @@ void ConnectionManagerImpl::ActiveStream::addEncodedData(ActiveStreamEncoderFilt
 void ConnectionManagerImpl::ActiveStream::encodeData(
     ActiveStreamEncoderFilter* filter, Buffer::Instance& data, bool end_stream,
     FilterIterationStartState filter_iteration_start_state) {
+  Memory::AllocationScope allocation_scope(allocationCounts());
   resetIdleTimer();
 
   // If we previously decided to encode only the headers, do nothing here.
@@ -1529,12 +1685,13 @@ void ConnectionManagerImpl::ActiveStream::encodeData(
   }
 
   // Filter iteration may start at the current filter.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry =
+  std::vector<ActiveStreamEncoderFilterPtr>::iterator entry =
       commonEncodePrefix(filter, end_stream, filter_iteration_start_state);
   auto trailers_added_entry = encoder_filters_.end();
 
   const bool trailers_exists_at_start = response_trailers_ != nullptr;
   for (; entry != encoder_filters_.end(); entry++) {
+    Memory::AllocationScope allocation_scope((*entry)->allocationCounts());
     // If the filter pointed by entry has stopped for all frame type, return now.
     if (handleDataIfStopAll(**entry, data, state_.encoder_filters_streaming_)) {
       return;
@@ -1596,6 +1753,7 @@ void ConnectionManagerImpl::ActiveStream::encodeData(
 
 void ConnectionManagerImpl::ActiveStream::encodeTrailers(ActiveStreamEncoderFilter* filter,
                                                          HeaderMap& trailers) {
+  Memory::AllocationScope allocation_scope(allocationCounts());
   resetIdleTimer();
 
   // If we previously decided to encode only the headers, do nothing here.
@@ -1604,9 +1762,10 @@ void ConnectionManagerImpl::ActiveStream::encodeTrailers(ActiveStreamEncoderFilt
   }
 
   // Filter iteration may start at the current filter.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry =
+  std::vector<ActiveStreamEncoderFilterPtr>::iterator entry =
       commonEncodePrefix(filter, true, FilterIterationStartState::CanStartFromCurrent);
   for (; entry != encoder_filters_.end(); entry++) {
+    Memory::AllocationScope allocation_scope((*entry)->allocationCounts());
     // If the filter pointed by entry has stopped for all frame type, return now.
     if ((*entry)->stoppedAll()) {
       return;
@@ -1713,6 +1872,11 @@ void ConnectionManagerImpl::ActiveStream::callLowWatermarkCallbacks() {
   }
 }
 
+uint64_t ConnectionManagerImpl::ActiveStream::bufferedBytes() const {
+  return (buffered_request_data_ ? buffered_request_data_->length() : 0) +
+         (buffered_response_data_ ? buffered_response_data_->length() : 0);
+}
+
 void ConnectionManagerImpl::ActiveStream::setBufferLimit(uint32_t new_limit) {
   ENVOY_STREAM_LOG(debug, "setting buffer limit to {}", *this, new_limit);
   buffer_limit_ = new_limit;
@@ -1731,6 +1895,11 @@ bool ConnectionManagerImpl::ActiveStream::createFilterChain() {
   bool upgrade_rejected = false;
   auto upgrade = request_headers_ ? request_headers_->Upgrade() : nullptr;
   state_.created_filter_chain_ = true;
+  // The streams of a connection mostly get the same filter chain, so the storage for the filters
+  // is sized from the largest chain created so far rather than grown as filters are added.
+  decoder_filters_.reserve(connection_manager_.decoder_filters_capacity_);
+  encoder_filters_.reserve(connection_manager_.encoder_filters_capacity_);
+  bool created_upgrade_filter_chain = false;
   if (upgrade != nullptr) {
     const Router::RouteEntry::UpgradeMap* upgrade_map = nullptr;
 
@@ -1745,7 +1914,7 @@ bool ConnectionManagerImpl::ActiveStream::createFilterChain() {
       state_.successful_upgrade_ = true;
       connection_manager_.stats_.named_.downstream_cx_upgrades_total_.inc();
       connection_manager_.stats_.named_.downstream_cx_upgrades_active_.inc();
-      return true;
+      created_upgrade_filter_chain = true;
     } else {
       upgrade_rejected = true;
       // Fall through to the default filter chain. The function calling this
@@ -1753,10 +1922,20 @@ bool ConnectionManagerImpl::ActiveStream::createFilterChain() {
     }
   }
 
-  connection_manager_.config_.filterFactory().createFilterChain(*this);
+  if (!created_upgrade_filter_chain) {
+    connection_manager_.config_.filterFactory().createFilterChain(*this);
+  }
+  connection_manager_.decoder_filters_capacity_ =
+      std::max(connection_manager_.decoder_filters_capacity_, decoder_filters_.size());
+  connection_manager_.encoder_filters_capacity_ =
+      std::max(connection_manager_.encoder_filters_capacity_, encoder_filters_.size());
   return !upgrade_rejected;
 }
 
+Memory::AllocationCounts* ConnectionManagerImpl::ActiveStreamFilterBase::allocationCounts() {
+  return parent_.track_allocations_ ? &allocation_counts_ : nullptr;
+}
+
 void ConnectionManagerImpl::ActiveStreamFilterBase::commonContinue() {
   // TODO(mattklein123): Raise an error if this is called during a callback.
   if (!canContinue()) {
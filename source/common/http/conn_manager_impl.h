@@ -34,6 +34,7 @@
 #include "common/http/conn_manager_config.h"
 #include "common/http/user_agent.h"
 #include "common/http/utility.h"
+#include "common/memory/allocation_tracker.h"
 #include "common/stream_info/stream_info_impl.h"
 #include "common/tracing/http_tracer_impl.h"
 
@@ -133,6 +134,10 @@ private:
     // TODO(soya3129): make this pure when adding impl to encodefilter.
     virtual void handleMetadataAfterHeadersCallback() PURE;
 
+    // The counts of the allocations made while the filter processes a frame, or nullptr if the
+    // allocations of the stream are not tracked.
+    Memory::AllocationCounts* allocationCounts();
+
     // Http::StreamFilterCallbacks
     const Network::Connection* connection() override;
     Event::Dispatcher& dispatcher() override;
@@ -198,14 +203,14 @@ private:
     const bool dual_filter_ : 1;
     bool decode_headers_called_ : 1;
     bool encode_headers_called_ : 1;
+    Memory::AllocationCounts allocation_counts_;
   };
 
   /**
    * Wrapper for a stream decoder filter.
    */
   struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
-                                     public StreamDecoderFilterCallbacks,
-                                     LinkedObject<ActiveStreamDecoderFilter> {
+                                     public StreamDecoderFilterCallbacks {
     ActiveStreamDecoderFilter(ActiveStream& parent, StreamDecoderFilterSharedPtr filter,
                               bool dual_filter)
         : ActiveStreamFilterBase(parent, dual_filter), handle_(filter) {}
@@ -310,6 +315,8 @@ private:
     void requestDataDrained();
 
     StreamDecoderFilterSharedPtr handle_;
+    // The position of the filter in the stream's decoder filters, which are only ever appended to.
+    size_t index_{};
     bool is_grpc_request_{};
   };
 
@@ -319,8 +326,7 @@ private:
    * Wrapper for a stream encoder filter.
    */
   struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
-                                     public StreamEncoderFilterCallbacks,
-                                     LinkedObject<ActiveStreamEncoderFilter> {
+                                     public StreamEncoderFilterCallbacks {
     ActiveStreamEncoderFilter(ActiveStream& parent, StreamEncoderFilterSharedPtr filter,
                               bool dual_filter)
         : ActiveStreamFilterBase(parent, dual_filter), handle_(filter) {}
@@ -379,6 +385,9 @@ private:
     void responseDataDrained();
 
     StreamEncoderFilterSharedPtr handle_;
+    // The position of the filter in the stream's encoder filters, counted from the end since they
+    // are only ever prepended to.
+    size_t index_from_end_{};
   };
 
   using ActiveStreamEncoderFilterPtr = std::unique_ptr<ActiveStreamEncoderFilter>;
@@ -404,11 +413,11 @@ private:
     void addStreamEncoderFilterWorker(StreamEncoderFilterSharedPtr filter, bool dual_filter);
     void chargeStats(const HeaderMap& headers);
     // Returns the encoder filter to start iteration with.
-    std::list<ActiveStreamEncoderFilterPtr>::iterator
+    std::vector<ActiveStreamEncoderFilterPtr>::iterator
     commonEncodePrefix(ActiveStreamEncoderFilter* filter, bool end_stream,
                        FilterIterationStartState filter_iteration_start_state);
     // Returns the decoder filter to start iteration with.
-    std::list<ActiveStreamDecoderFilterPtr>::iterator
+    std::vector<ActiveStreamDecoderFilterPtr>::iterator
     commonDecodePrefix(ActiveStreamDecoderFilter* filter,
                        FilterIterationStartState filter_iteration_start_state);
     const Network::Connection* connection();
@@ -596,8 +605,10 @@ private:
     HeaderMapPtr request_headers_;
     Buffer::WatermarkBufferPtr buffered_request_data_;
     HeaderMapPtr request_trailers_;
-    std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
-    std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
+    // The filters are stored contiguously, as they are iterated over for every frame. Their
+    // wrappers stay put as the filters hold on to them as their callbacks.
+    std::vector<ActiveStreamDecoderFilterPtr> decoder_filters_;
+    std::vector<ActiveStreamEncoderFilterPtr> encoder_filters_;
     std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
     Stats::TimespanPtr request_response_timespan_;
     // Per-stream idle timeout.
@@ -614,6 +625,15 @@ private:
     // processing the next filter. The storage is created on demand. We need to store metadata
     // temporarily in the filter in case the filter has stopped all while processing headers.
     std::unique_ptr<MetadataMapVector> request_metadata_map_vector_{nullptr};
+    // The request and response data buffered by the filters of the stream.
+    uint64_t bufferedBytes() const;
+    // The counts of the allocations made while processing the stream outside of its filters, or
+    // nullptr if the allocations were not tracked when the stream started.
+    Memory::AllocationCounts* allocationCounts() {
+      return track_allocations_ ? &allocation_counts_ : nullptr;
+    }
+    void recordAllocations();
+
     uint32_t buffer_limit_{0};
     uint32_t high_watermark_count_{0};
     const std::string* decorated_operation_{nullptr};
@@ -626,6 +646,8 @@ private:
     // Whether a filter has indicated that the response should be treated as a headers only
     // response.
     bool encoding_headers_only_{};
+    const bool track_allocations_;
+    Memory::AllocationCounts allocation_counts_;
     Network::Socket::OptionsSharedPtr upstream_options_;
   };
 
@@ -649,6 +671,8 @@ private:
   void doEndStream(ActiveStream& stream);
 
   void resetAllStreams();
+  void onReduceBufferLimits(Server::OverloadActionState state);
+  void resetLargestStreams(uint64_t limit);
   void onIdleTimeout();
   void onDrainTimeout();
   void startDrainSequence();
@@ -662,6 +686,10 @@ private:
                                   // config in the hot path.
   ServerConnectionPtr codec_;
   std::list<ActiveStreamPtr> streams_;
+  // The largest filter chains created for the streams of the connection, used to size the filter
+  // storage of new streams up front.
+  size_t decoder_filters_capacity_{};
+  size_t encoder_filters_capacity_{};
   Stats::TimespanPtr conn_length_;
   const Network::DrainDecision& drain_close_;
   DrainState drain_state_{DrainState::NotDraining};
@@ -682,6 +710,16 @@ private:
   // lookup in the hot path of processing each request.
   const Server::OverloadActionState& overload_stop_accepting_requests_ref_;
   const Server::OverloadActionState& overload_disable_keepalive_ref_;
+  const Server::OverloadActionState& overload_reduce_http2_max_concurrent_streams_ref_;
+  // The count of the requests active on the thread in the overload manager thread local state, or
+  // nullptr without an overload manager.
+  uint64_t* const overload_active_requests_;
+  const Server::OverloadActionState& overload_reduce_buffer_limits_ref_;
+  // The buffer limit while the reduce buffer limits overload action is active, zero if disabled.
+  const uint32_t overload_buffer_limit_;
+  // The buffer limit of the connection while the limits are not reduced.
+  uint32_t connection_buffer_limit_{};
+  Common::CallbackHandle* overload_reduce_buffer_limits_cb_{};
   TimeSource& time_source_;
 };
 
@@ -13,7 +13,9 @@
 #include "common/http/path_utility.h"
 #include "common/http/utility.h"
 #include "common/network/utility.h"
+#include "common/runtime/runtime_keys.h"
 #include "common/runtime/uuid_util.h"
+#include "common/singleton/const_singleton.h"
 #include "common/tracing/http_tracer_impl.h"
 
 #include "absl/strings/str_cat.h"
@@ -21,6 +23,16 @@
 
 namespace Envoy {
 namespace Http {
+namespace {
+
+struct TracingRuntimeKeyValues {
+  const Runtime::Key ClientEnabled{"tracing.client_enabled"};
+  const Runtime::Key RandomSampling{"tracing.random_sampling"};
+  const Runtime::Key GlobalEnabled{"tracing.global_enabled"};
+};
+using TracingRuntimeKeys = ConstSingleton<TracingRuntimeKeyValues>;
+
+} // namespace
 
 std::string ConnectionManagerUtility::determineNextProtocol(Network::Connection& connection,
                                                             const Buffer::Instance& data) {
@@ -251,17 +263,19 @@ void ConnectionManagerUtility::mutateTracingRequestHeader(HeaderMap& request_hea
   // Do not apply tracing transformations if we are currently tracing.
   if (UuidTraceStatus::NoTrace == UuidUtils::isTraceableUuid(x_request_id)) {
     if (request_headers.ClientTraceId() &&
-        runtime.snapshot().featureEnabled("tracing.client_enabled", *client_sampling)) {
+        runtime.snapshot().featureEnabled(TracingRuntimeKeys::get().ClientEnabled,
+                                          *client_sampling)) {
       UuidUtils::setTraceableUuid(x_request_id, UuidTraceStatus::Client);
     } else if (request_headers.EnvoyForceTrace()) {
       UuidUtils::setTraceableUuid(x_request_id, UuidTraceStatus::Forced);
-    } else if (runtime.snapshot().featureEnabled("tracing.random_sampling", *random_sampling,
-                                                 result)) {
+    } else if (runtime.snapshot().featureEnabled(TracingRuntimeKeys::get().RandomSampling,
+                                                 *random_sampling, result)) {
       UuidUtils::setTraceableUuid(x_request_id, UuidTraceStatus::Sampled);
     }
   }
 
-  if (!runtime.snapshot().featureEnabled("tracing.global_enabled", *overall_sampling, result)) {
+  if (!runtime.snapshot().featureEnabled(TracingRuntimeKeys::get().GlobalEnabled,
+                                         *overall_sampling, result)) {
     UuidUtils::setTraceableUuid(x_request_id, UuidTraceStatus::NoTrace);
   }
 
@@ -0,0 +1,184 @@
+#include "common/http/filter_latency.h"
+
+#include "common/common/macros.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+struct LatencyFilterConfig {
+  LatencyFilterConfig(const std::string& filter_name, const std::string& stat_prefix,
+                      Stats::Scope& scope, TimeSource& time_source)
+      : filter_name_(filter_name),
+        decode_time_us_(
+            scope.histogram(absl::StrCat(stat_prefix, "filter.", filter_name, ".decode_time_us"))),
+        encode_time_us_(
+            scope.histogram(absl::StrCat(stat_prefix, "filter.", filter_name, ".encode_time_us"))),
+        time_source_(time_source) {}
+
+  const std::string filter_name_;
+  Stats::Histogram& decode_time_us_;
+  Stats::Histogram& encode_time_us_;
+  TimeSource& time_source_;
+};
+
+using LatencyFilterConfigConstSharedPtr = std::shared_ptr<const LatencyFilterConfig>;
+
+/**
+ * Forwards the callbacks to the wrapped filter, timing them. The decoder and encoder are the same
+ * filter if it was added as a dual filter, and either may be null otherwise, in which case the
+ * latency filter is only added to the chain of the other.
+ */
+class LatencyFilter : public StreamFilter {
+public:
+  LatencyFilter(StreamDecoderFilterSharedPtr decoder, StreamEncoderFilterSharedPtr encoder,
+                LatencyFilterConfigConstSharedPtr config)
+      : decoder_(std::move(decoder)), encoder_(std::move(encoder)), config_(std::move(config)) {}
+
+  // Http::StreamFilterBase
+  void onDestroy() override {
+    if (decoder_ != nullptr) {
+      decoder_->onDestroy();
+      config_->decode_time_us_.recordValue(toMicroseconds(decode_time_).count());
+    } else {
+      encoder_->onDestroy();
+    }
+    if (encoder_ != nullptr) {
+      config_->encode_time_us_.recordValue(toMicroseconds(encode_time_).count());
+    }
+
+    if (stream_info_ != nullptr) {
+      StreamInfo::FilterState& filter_state = stream_info_->filterState();
+      if (!filter_state.hasData<FilterLatencyState>(FilterLatencyState::key())) {
+        filter_state.setData(FilterLatencyState::key(), std::make_unique<FilterLatencyState>(),
+                             StreamInfo::FilterState::StateType::Mutable);
+      }
+      filter_state.getDataMutable<FilterLatencyState>(FilterLatencyState::key())
+          .add(config_->filter_name_, toMicroseconds(decode_time_ + encode_time_));
+    }
+  }
+
+  // Http::StreamDecoderFilter
+  FilterHeadersStatus decodeHeaders(HeaderMap& headers, bool end_stream) override {
+    return timed(decode_time_, [&] { return decoder_->decodeHeaders(headers, end_stream); });
+  }
+  FilterDataStatus decodeData(Buffer::Instance& data, bool end_stream) override {
+    return timed(decode_time_, [&] { return decoder_->decodeData(data, end_stream); });
+  }
+  FilterTrailersStatus decodeTrailers(HeaderMap& trailers) override {
+    return timed(decode_time_, [&] { return decoder_->decodeTrailers(trailers); });
+  }
+  FilterMetadataStatus decodeMetadata(MetadataMap& metadata_map) override {
+    return timed(decode_time_, [&] { return decoder_->decodeMetadata(metadata_map); });
+  }
+  void setDecoderFilterCallbacks(StreamDecoderFilterCallbacks& callbacks) override {
+    stream_info_ = &callbacks.streamInfo();
+    decoder_->setDecoderFilterCallbacks(callbacks);
+  }
+  void decodeComplete() override { decoder_->decodeComplete(); }
+
+  // Http::StreamEncoderFilter
+  FilterHeadersStatus encode100ContinueHeaders(HeaderMap& headers) override {
+    return timed(encode_time_, [&] { return encoder_->encode100ContinueHeaders(headers); });
+  }
+  FilterHeadersStatus encodeHeaders(HeaderMap& headers, bool end_stream) override {
+    return timed(encode_time_, [&] { return encoder_->encodeHeaders(headers, end_stream); });
+  }
+  FilterDataStatus encodeData(Buffer::Instance& data, bool end_stream) override {
+    return timed(encode_time_, [&] { return encoder_->encodeData(data, end_stream); });
+  }
+  FilterTrailersStatus encodeTrailers(HeaderMap& trailers) override {
+    return timed(encode_time_, [&] { return encoder_->encodeTrailers(trailers); });
+  }
+  FilterMetadataStatus encodeMetadata(MetadataMap& metadata_map) override {
+    return timed(encode_time_, [&] { return encoder_->encodeMetadata(metadata_map); });
+  }
+  void setEncoderFilterCallbacks(StreamEncoderFilterCallbacks& callbacks) override {
+    stream_info_ = &callbacks.streamInfo();
+    encoder_->setEncoderFilterCallbacks(callbacks);
+  }
+  void encodeComplete() override { encoder_->encodeComplete(); }
+
+private:
+  template <class Callback>
+  auto timed(std::chrono::nanoseconds& total, Callback callback) -> decltype(callback()) {
+    const MonotonicTime start = config_->time_source_.monotonicTime();
+    const auto status = callback();
+    total += config_->time_source_.monotonicTime() - start;
+    return status;
+  }
+
+  static std::chrono::microseconds toMicroseconds(std::chrono::nanoseconds duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration);
+  }
+
+  const StreamDecoderFilterSharedPtr decoder_;
+  const StreamEncoderFilterSharedPtr encoder_;
+  const LatencyFilterConfigConstSharedPtr config_;
+  StreamInfo::StreamInfo* stream_info_{};
+  std::chrono::nanoseconds decode_time_{};
+  std::chrono::nanoseconds encode_time_{};
+};
+
+/**
+ * Wraps the filters added by a factory in latency filters.
+ */
+class LatencyFilterChainFactoryCallbacks : public FilterChainFactoryCallbacks {
+public:
+  LatencyFilterChainFactoryCallbacks(FilterChainFactoryCallbacks& parent,
+                                     const LatencyFilterConfigConstSharedPtr& config)
+      : parent_(parent), config_(config) {}
+
+  // Http::FilterChainFactoryCallbacks
+  void addStreamDecoderFilter(StreamDecoderFilterSharedPtr filter) override {
+    parent_.addStreamDecoderFilter(
+        std::make_shared<LatencyFilter>(std::move(filter), nullptr, config_));
+  }
+  void addStreamEncoderFilter(StreamEncoderFilterSharedPtr filter) override {
+    parent_.addStreamEncoderFilter(
+        std::make_shared<LatencyFilter>(nullptr, std::move(filter), config_));
+  }
+  void addStreamFilter(StreamFilterSharedPtr filter) override {
+    parent_.addStreamFilter(std::make_shared<LatencyFilter>(filter, filter, config_));
+  }
+  void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) override {
+    parent_.addAccessLogHandler(std::move(handler));
+  }
+
+private:
+  FilterChainFactoryCallbacks& parent_;
+  const LatencyFilterConfigConstSharedPtr& config_;
+};
+
+} // namespace
+
+const std::string& FilterLatencyState::key() {
+  CONSTRUCT_ON_FIRST_USE(std::string, "envoy.http.filter_latency");
+}
+
+std::string FilterLatencyState::toString() const {
+  std::string output;
+  for (const auto& latency : latencies_) {
+    absl::StrAppend(&output, output.empty() ? "" : ",", latency.first, "=",
+                    latency.second.count());
+  }
+  return output;
+}
+
+FilterFactoryCb FilterLatency::wrapFilterFactory(FilterFactoryCb factory,
+                                                 const std::string& filter_name,
+                                                 const std::string& stat_prefix,
+                                                 Stats::Scope& scope, TimeSource& time_source) {
+  LatencyFilterConfigConstSharedPtr config =
+      std::make_shared<const LatencyFilterConfig>(filter_name, stat_prefix, scope, time_source);
+  return [factory, config](FilterChainFactoryCallbacks& callbacks) {
+    LatencyFilterChainFactoryCallbacks latency_callbacks(callbacks, config);
+    factory(latency_callbacks);
+  };
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/http/filter.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats.h"
+#include "envoy/stream_info/filter_state.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * The time spent in the callbacks of each filter of a request, in the order in which the filters
+ * were destroyed. It is kept in the filter state of the request, for the %FILTER_LATENCY% access
+ * log field.
+ */
+class FilterLatencyState : public StreamInfo::FilterState::Object {
+public:
+  /**
+   * @return the name of the filter state data.
+   */
+  static const std::string& key();
+
+  void add(absl::string_view filter_name, std::chrono::microseconds latency) {
+    latencies_.emplace_back(std::string(filter_name), latency);
+  }
+
+  /**
+   * @return the latencies as a comma separated list of <filter name>=<microseconds>.
+   */
+  std::string toString() const;
+
+private:
+  std::vector<std::pair<std::string, std::chrono::microseconds>> latencies_;
+};
+
+/**
+ * Records how long the filters of a chain take to process requests.
+ */
+class FilterLatency {
+public:
+  /**
+   * Wraps a filter factory so that each filter it adds to a chain records the time spent in its
+   * decode and encode callbacks, including the work they trigger synchronously, such as a local
+   * reply. At the end of each request, the times are recorded in the
+   * <stat_prefix>filter.<filter_name>.decode_time_us and encode_time_us histograms, and added to
+   * the FilterLatencyState of the request.
+   * @param factory supplies the factory to wrap.
+   * @param filter_name supplies the name of the filters added by the factory.
+   * @param stat_prefix supplies the prefix of the histograms.
+   * @param scope supplies the scope of the histograms.
+   * @param time_source supplies the time source used to time the callbacks.
+   * @return FilterFactoryCb the wrapping factory.
+   */
+  static FilterFactoryCb wrapFilterFactory(FilterFactoryCb factory, const std::string& filter_name,
+                                           const std::string& stat_prefix, Stats::Scope& scope,
+                                           TimeSource& time_source);
+};
+
+} // namespace Http
+} // namespace Envoy
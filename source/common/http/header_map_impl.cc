@@ -1,5 +1,7 @@
 #include "common/http/header_map_impl.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -8,6 +10,7 @@
 #include "common/common/assert.h"
 #include "common/common/dump_state_utils.h"
 #include "common/common/empty_string.h"
+#include "common/common/hash.h"
 #include "common/common/utility.h"
 #include "common/singleton/const_singleton.h"
 
@@ -18,6 +21,10 @@ namespace Http {
 
 namespace {
 constexpr size_t MinDynamicCapacity{32};
+// The largest block of entries allocated by an EntryArena at once.
+constexpr uint32_t MaxEntriesPerBlock{32};
+// The smallest header list with a key index.
+constexpr size_t IndexMinHeaders{16};
 // This includes the NULL (StringUtil::itoa technically only needs 21).
 constexpr size_t MaxIntegerLength{32};
 
@@ -296,6 +303,173 @@ struct HeaderMapImpl::StaticLookupTable : public TrieLookupTable<EntryCb> {
   }
 };
 
+void* HeaderMapImpl::EntryArena::allocate(size_t entry_size) {
+  // Keep entries aligned for any type, as the blocks are.
+  entry_size = (entry_size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+  ASSERT(entry_size_ == 0 || entry_size_ == entry_size);
+  if (free_entries_ != nullptr) {
+    FreeEntry* entry = free_entries_;
+    free_entries_ = entry->next_;
+    return entry;
+  }
+
+  if (entries_left_in_block_ == 0) {
+    entry_size_ = entry_size;
+    Block* block =
+        static_cast<Block*>(::operator new(sizeof(Block) + entry_size_ * next_block_entries_));
+    block->next_ = blocks_;
+    blocks_ = block;
+    next_entry_ = reinterpret_cast<char*>(block + 1);
+    entries_left_in_block_ = next_block_entries_;
+    // Double the block size up to a limit, so that small maps stay small and large maps need only a
+    // few blocks.
+    next_block_entries_ = std::min<uint32_t>(next_block_entries_ * 2, MaxEntriesPerBlock);
+  }
+
+  void* entry = next_entry_;
+  next_entry_ += entry_size_;
+  entries_left_in_block_--;
+  return entry;
+}
+
+HeaderMapImpl::EntryArena::~EntryArena() {
+  while (blocks_ != nullptr) {
+    Block* next = blocks_->next_;
+    ::operator delete(blocks_);
+    blocks_ = next;
+  }
+}
+
+void HeaderMapImpl::EntryArena::deallocate(void* entry) {
+  FreeEntry* free_entry = static_cast<FreeEntry*>(entry);
+  free_entry->next_ = free_entries_;
+  free_entries_ = free_entry;
+}
+
+HeaderMapImpl::HeaderEntryImpl* HeaderMapImpl::HeaderList::find(absl::string_view key) const {
+  if (index_.empty()) {
+    for (const HeaderEntryImpl& header : headers_) {
+      if (header.key() == key) {
+        return const_cast<HeaderEntryImpl*>(&header);
+      }
+    }
+    return nullptr;
+  }
+
+  return index_[findSlot(key, HashUtil::xxHash64(key))].entry_;
+}
+
+size_t HeaderMapImpl::HeaderList::findSlot(absl::string_view key, uint64_t hash) const {
+  const size_t mask = index_.size() - 1;
+  size_t slot = hash & mask;
+  while (index_[slot].entry_ != nullptr &&
+         (index_[slot].hash_ != hash || !(index_[slot].entry_->key() == key))) {
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+void HeaderMapImpl::HeaderList::indexInsert(HeaderEntryImpl& entry) {
+  if (index_.empty()) {
+    if (headers_.size() >= IndexMinHeaders) {
+      rebuildIndex();
+    }
+    return;
+  }
+  if ((indexed_keys_ + 1) * 2 > index_.size()) {
+    growIndex();
+  }
+
+  const absl::string_view key = entry.key().getStringView();
+  const uint64_t hash = HashUtil::xxHash64(key);
+  IndexSlot& slot = index_[findSlot(key, hash)];
+  // Pseudo headers are inserted after any existing pseudo headers and other headers at the end of
+  // the list, so an entry already in the index still comes first.
+  if (slot.entry_ == nullptr) {
+    slot = {&entry, hash};
+    indexed_keys_++;
+  }
+}
+
+void HeaderMapImpl::HeaderList::indexErase(HeaderEntryList::iterator i) {
+  if (index_.empty()) {
+    return;
+  }
+
+  const absl::string_view key = i->key().getStringView();
+  size_t slot = findSlot(key, HashUtil::xxHash64(key));
+  ASSERT(index_[slot].entry_ != nullptr);
+  if (index_[slot].entry_ != &*i) {
+    return;
+  }
+  for (auto next = std::next(i); next != headers_.end(); ++next) {
+    if (next->key() == key) {
+      index_[slot].entry_ = &*next;
+      return;
+    }
+  }
+
+  // This was the only entry with the key. Shift back any entries after the slot that would no
+  // longer be found past the gap left by removing it.
+  const size_t mask = index_.size() - 1;
+  size_t next = slot;
+  while (true) {
+    next = (next + 1) & mask;
+    if (index_[next].entry_ == nullptr) {
+      break;
+    }
+    const size_t home = index_[next].hash_ & mask;
+    const bool movable = slot <= next ? (home <= slot || home > next) : (home <= slot && home > next);
+    if (movable) {
+      index_[slot] = index_[next];
+      slot = next;
+    }
+  }
+  index_[slot].entry_ = nullptr;
+  indexed_keys_--;
+}
+
+void HeaderMapImpl::HeaderList::growIndex() {
+  // The indexed keys are distinct and their hashes are kept, so they are re-placed without hashing
+  // or comparing keys.
+  std::vector<IndexSlot> old_index(index_.size() * 2, {nullptr, 0});
+  index_.swap(old_index);
+  const size_t mask = index_.size() - 1;
+  for (const IndexSlot& old_slot : old_index) {
+    if (old_slot.entry_ != nullptr) {
+      size_t slot = old_slot.hash_ & mask;
+      while (index_[slot].entry_ != nullptr) {
+        slot = (slot + 1) & mask;
+      }
+      index_[slot] = old_slot;
+    }
+  }
+}
+
+void HeaderMapImpl::HeaderList::rebuildIndex() {
+  if (headers_.size() < IndexMinHeaders) {
+    std::vector<IndexSlot>().swap(index_);
+    indexed_keys_ = 0;
+    return;
+  }
+
+  size_t slots = 1;
+  while (slots < headers_.size() * 4) {
+    slots <<= 1;
+  }
+  index_.assign(slots, {nullptr, 0});
+  indexed_keys_ = 0;
+  for (HeaderEntryImpl& header : headers_) {
+    const absl::string_view key = header.key().getStringView();
+    const uint64_t hash = HashUtil::xxHash64(key);
+    IndexSlot& slot = index_[findSlot(key, hash)];
+    if (slot.entry_ == nullptr) {
+      slot = {&header, hash};
+      indexed_keys_++;
+    }
+  }
+}
+
 void HeaderMapImpl::appendToHeader(HeaderString& header, absl::string_view data) {
   if (data.empty()) {
     return;
@@ -364,7 +538,7 @@ void HeaderMapImpl::insertByKey(HeaderString&& key, HeaderString&& value) {
       value.clear();
     }
   } else {
-    std::list<HeaderEntryImpl>::iterator i = headers_.insert(std::move(key), std::move(value));
+    HeaderEntryList::iterator i = headers_.insert(std::move(key), std::move(value));
     i->entry_ = i;
   }
 }
@@ -463,24 +637,10 @@ uint64_t HeaderMapImpl::byteSize() const {
 }
 
 const HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) const {
-  for (const HeaderEntryImpl& header : headers_) {
-    if (header.key() == key.get().c_str()) {
-      return &header;
-    }
-  }
-
-  return nullptr;
+  return headers_.find(key.get());
 }
 
-HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) {
-  for (HeaderEntryImpl& header : headers_) {
-    if (header.key() == key.get().c_str()) {
-      return &header;
-    }
-  }
-
-  return nullptr;
-}
+HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) { return headers_.find(key.get()); }
 
 void HeaderMapImpl::iterate(ConstIterateCb cb, void* context) const {
   for (const HeaderEntryImpl& header : headers_) {
@@ -575,7 +735,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
     return **entry;
   }
 
-  std::list<HeaderEntryImpl>::iterator i = headers_.insert(key);
+  HeaderEntryList::iterator i = headers_.insert(key);
   i->entry_ = i;
   *entry = &(*i);
   return **entry;
@@ -589,7 +749,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
     return **entry;
   }
 
-  std::list<HeaderEntryImpl>::iterator i = headers_.insert(key, std::move(value));
+  HeaderEntryList::iterator i = headers_.insert(key, std::move(value));
   i->entry_ = i;
   *entry = &(*i);
   return **entry;
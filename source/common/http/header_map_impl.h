@@ -1,10 +1,12 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/http/header_map.h"
 
@@ -88,6 +90,87 @@ protected:
   void copyFrom(const HeaderMap& rhs);
   void clear() { removePrefix(LowerCaseString("")); }
 
+  /**
+   * Storage for the entries of one header map. Entries are carved out of a few blocks, which grow
+   * in size as the map does, rather than each being a separate heap allocation. Entries removed
+   * from the map are reused by later insertions, and all of the blocks are freed with the map.
+   */
+  class EntryArena : NonCopyable {
+  public:
+    EntryArena() = default;
+    ~EntryArena();
+
+    /**
+     * @return storage for one entry of entry_size bytes. All entries of an arena must have the
+     *         same size.
+     */
+    void* allocate(size_t entry_size);
+
+    /**
+     * Return the storage of an entry to the arena for reuse.
+     */
+    void deallocate(void* entry);
+
+  private:
+    struct FreeEntry {
+      FreeEntry* next_;
+    };
+
+    // Blocks are chained through a header at their start, which is padded to keep the entries
+    // after it aligned.
+    struct alignas(std::max_align_t) Block {
+      Block* next_;
+    };
+
+    Block* blocks_{};
+    char* next_entry_{};
+    uint32_t entries_left_in_block_{};
+    uint32_t next_block_entries_{1};
+    size_t entry_size_{};
+    FreeEntry* free_entries_{};
+  };
+
+  /**
+   * Allocator placing list nodes in an EntryArena. Anything other than a single node, which lists
+   * never ask for in practice, comes from the heap.
+   */
+  template <class T> class EntryAllocator {
+  public:
+    using value_type = T;
+
+    explicit EntryAllocator(EntryArena& arena) : arena_(&arena) {}
+    template <class U> EntryAllocator(const EntryAllocator<U>& other) : arena_(other.arena_) {}
+
+    T* allocate(size_t n) {
+      if (n != 1) {
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+      }
+      return static_cast<T*>(arena_->allocate(sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) {
+      if (n != 1) {
+        ::operator delete(p);
+        return;
+      }
+      arena_->deallocate(p);
+    }
+
+    template <class U> bool operator==(const EntryAllocator<U>& other) const {
+      return arena_ == other.arena_;
+    }
+    template <class U> bool operator!=(const EntryAllocator<U>& other) const {
+      return arena_ != other.arena_;
+    }
+
+  private:
+    template <class U> friend class EntryAllocator;
+
+    EntryArena* arena_;
+  };
+
+  struct HeaderEntryImpl;
+  using HeaderEntryList = std::list<HeaderEntryImpl, EntryAllocator<HeaderEntryImpl>>;
+
   struct HeaderEntryImpl : public HeaderEntry, NonCopyable {
     HeaderEntryImpl(const LowerCaseString& key);
     HeaderEntryImpl(const LowerCaseString& key, HeaderString&& value);
@@ -104,7 +187,7 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+    HeaderEntryList::iterator entry_;
   };
 
   struct StaticLookupResponse {
@@ -137,25 +220,28 @@ protected:
    */
   class HeaderList : NonCopyable {
   public:
-    HeaderList() : pseudo_headers_end_(headers_.end()) {}
+    HeaderList()
+        : headers_(EntryAllocator<HeaderEntryImpl>(arena_)), pseudo_headers_end_(headers_.end()) {}
 
     template <class Key> bool isPseudoHeader(const Key& key) {
       return !key.getStringView().empty() && key.getStringView()[0] == ':';
     }
 
     template <class Key, class... Value>
-    std::list<HeaderEntryImpl>::iterator insert(Key&& key, Value&&... value) {
+    HeaderEntryList::iterator insert(Key&& key, Value&&... value) {
       const bool is_pseudo_header = isPseudoHeader(key);
-      std::list<HeaderEntryImpl>::iterator i =
+      HeaderEntryList::iterator i =
           headers_.emplace(is_pseudo_header ? pseudo_headers_end_ : headers_.end(),
                            std::forward<Key>(key), std::forward<Value>(value)...);
       if (!is_pseudo_header && pseudo_headers_end_ == headers_.end()) {
         pseudo_headers_end_ = i;
       }
+      indexInsert(*i);
       return i;
     }
 
-    std::list<HeaderEntryImpl>::iterator erase(std::list<HeaderEntryImpl>::iterator i) {
+    HeaderEntryList::iterator erase(HeaderEntryList::iterator i) {
+      indexErase(i);
       if (pseudo_headers_end_ == i) {
         pseudo_headers_end_++;
       }
@@ -172,20 +258,48 @@ protected:
         }
         return to_remove;
       });
+      rebuildIndex();
     }
 
-    std::list<HeaderEntryImpl>::iterator begin() { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::iterator end() { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_iterator begin() const { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::const_iterator end() const { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
+    /**
+     * @return the first entry with a key, or nullptr if there is none.
+     */
+    HeaderEntryImpl* find(absl::string_view key) const;
+
+    HeaderEntryList::iterator begin() { return headers_.begin(); }
+    HeaderEntryList::iterator end() { return headers_.end(); }
+    HeaderEntryList::const_iterator begin() const { return headers_.begin(); }
+    HeaderEntryList::const_iterator end() const { return headers_.end(); }
+    HeaderEntryList::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
+    HeaderEntryList::const_reverse_iterator rend() const { return headers_.rend(); }
     size_t size() const { return headers_.size(); }
     bool empty() const { return headers_.empty(); }
 
   private:
-    std::list<HeaderEntryImpl> headers_;
-    std::list<HeaderEntryImpl>::iterator pseudo_headers_end_;
+    /**
+     * A slot of the key index, which is an open-addressed hash table with linear probing mapping
+     * each key to the first entry with that key. The index is only kept for lists of at least
+     * IndexMinHeaders, below which a scan of the list is as fast. It is updated as the list
+     * changes rather than built on lookup, so that lookups on a const map do not write to it.
+     */
+    struct IndexSlot {
+      HeaderEntryImpl* entry_;
+      uint64_t hash_;
+    };
+
+    void indexInsert(HeaderEntryImpl& entry);
+    void indexErase(HeaderEntryList::iterator i);
+    void growIndex();
+    void rebuildIndex();
+    // @return the slot holding a key, or the empty slot where it would be inserted.
+    size_t findSlot(absl::string_view key, uint64_t hash) const;
+
+    // Declared before headers_ so that it outlives the entries.
+    EntryArena arena_;
+    HeaderEntryList headers_;
+    HeaderEntryList::iterator pseudo_headers_end_;
+    std::vector<IndexSlot> index_;
+    size_t indexed_keys_{};
   };
 
   void insertByKey(HeaderString&& key, HeaderString&& value);
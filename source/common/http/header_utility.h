@@ -1,6 +1,6 @@
 #pragma once
 
-#include <regex>
+#include <memory>
 #include <vector>
 
 #include "envoy/api/v2/route/route.pb.h"
@@ -8,6 +8,8 @@
 #include "envoy/json/json_object.h"
 #include "envoy/type/range.pb.h"
 
+#include "common/common/regex.h"
+
 namespace Envoy {
 namespace Http {
 
@@ -39,7 +41,7 @@ public:
     const Http::LowerCaseString name_;
     HeaderMatchType header_match_type_;
     std::string value_;
-    std::regex regex_pattern_;
+    std::shared_ptr<const Regex::PrefilteredRegex> regex_pattern_;
     envoy::type::Int64Range range_;
     const bool invert_match_;
   };
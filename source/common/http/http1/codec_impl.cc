@@ -1,5 +1,6 @@
 #include "common/http/http1/codec_impl.h"
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -18,6 +19,8 @@
 #include "common/http/utility.h"
 #include "common/runtime/runtime_impl.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Http {
 namespace Http1 {
@@ -234,6 +237,45 @@ uint32_t StreamEncoderImpl::bufferLimit() { return connection_.bufferLimit(); }
 static const char RESPONSE_PREFIX[] = "HTTP/1.1 ";
 static const char HTTP_10_RESPONSE_PREFIX[] = "HTTP/1.0 ";
 
+namespace {
+
+constexpr uint64_t MinTabledStatus = 100;
+constexpr uint64_t MaxTabledStatus = 599;
+
+/**
+ * The serialized status line of each response code, less the protocol version, so that encoding
+ * the status line of a response is a single copy.
+ */
+class StatusLineTable {
+public:
+  StatusLineTable() {
+    for (uint64_t status = MinTabledStatus; status <= MaxTabledStatus; status++) {
+      lines_[status - MinTabledStatus] =
+          absl::StrCat(status, " ", CodeUtility::toString(static_cast<Code>(status)), "\r\n");
+    }
+  }
+
+  /**
+   * @return the status line for a response code, or an empty view if it is not in the table.
+   */
+  absl::string_view get(uint64_t status) const {
+    if (status < MinTabledStatus || status > MaxTabledStatus) {
+      return {};
+    }
+    return lines_[status - MinTabledStatus];
+  }
+
+private:
+  std::array<std::string, MaxTabledStatus - MinTabledStatus + 1> lines_;
+};
+
+const StatusLineTable& statusLineTable() {
+  static auto* table = new StatusLineTable();
+  return *table;
+}
+
+} // namespace
+
 void ResponseStreamEncoderImpl::encodeHeaders(const HeaderMap& headers, bool end_stream) {
   started_response_ = true;
   uint64_t numeric_status = Utility::getResponseStatus(headers);
@@ -244,15 +286,21 @@ void ResponseStreamEncoderImpl::encodeHeaders(const HeaderMap& headers, bool end
   } else {
     connection_.copyToBuffer(RESPONSE_PREFIX, sizeof(RESPONSE_PREFIX) - 1);
   }
-  connection_.addIntToBuffer(numeric_status);
-  connection_.addCharToBuffer(' ');
 
-  const char* status_string = CodeUtility::toString(static_cast<Code>(numeric_status));
-  uint32_t status_string_len = strlen(status_string);
-  connection_.copyToBuffer(status_string, status_string_len);
+  const absl::string_view status_line = statusLineTable().get(numeric_status);
+  if (!status_line.empty()) {
+    connection_.copyToBuffer(status_line.data(), status_line.size());
+  } else {
+    connection_.addIntToBuffer(numeric_status);
+    connection_.addCharToBuffer(' ');
 
-  connection_.addCharToBuffer('\r');
-  connection_.addCharToBuffer('\n');
+    const char* status_string = CodeUtility::toString(static_cast<Code>(numeric_status));
+    uint32_t status_string_len = strlen(status_string);
+    connection_.copyToBuffer(status_string, status_string_len);
+
+    connection_.addCharToBuffer('\r');
+    connection_.addCharToBuffer('\n');
+  }
 
   if (numeric_status == 204 || numeric_status < 200) {
     // Per https://tools.ietf.org/html/rfc7230#section-3.3.2
@@ -342,6 +390,7 @@ void ConnectionImpl::completeLastHeader() {
   ENVOY_CONN_LOG(trace, "completed header: key={} value={}", connection_,
                  current_header_field_.getStringView(), current_header_value_.getStringView());
   if (!current_header_field_.empty()) {
+    current_header_map_byte_size_ += current_header_field_.size() + current_header_value_.size();
     toLowerTable().toLowerCase(current_header_field_.buffer(), current_header_field_.size());
     current_header_map_->addViaMove(std::move(current_header_field_),
                                     std::move(current_header_value_));
@@ -451,8 +500,8 @@ void ConnectionImpl::onHeaderValue(const char* data, size_t length) {
   header_parsing_state_ = HeaderParsingState::Value;
   current_header_value_.append(data, length);
 
-  const uint32_t total =
-      current_header_field_.size() + current_header_value_.size() + current_header_map_->byteSize();
+  const uint64_t total =
+      current_header_field_.size() + current_header_value_.size() + current_header_map_byte_size_;
   if (total > (max_request_headers_kb_ * 1024)) {
     error_code_ = Http::Code::RequestHeaderFieldsTooLarge;
     sendProtocolError();
@@ -502,6 +551,7 @@ void ConnectionImpl::onMessageBeginBase() {
   protocol_ = Protocol::Http11;
   ASSERT(!current_header_map_);
   current_header_map_ = std::make_unique<HeaderMapImpl>();
+  current_header_map_byte_size_ = 0;
   header_parsing_state_ = HeaderParsingState::Field;
   onMessageBegin();
 }
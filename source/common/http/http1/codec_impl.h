@@ -295,6 +295,11 @@ private:
   HeaderParsingState header_parsing_state_{HeaderParsingState::Field};
   HeaderString current_header_field_;
   HeaderString current_header_value_;
+  // The size of the headers already added to current_header_map_, kept here rather than computed
+  // with byteSize() so that checking the limit on each header value is not quadratic. Headers that
+  // are merged into an existing inline header are counted with their key, so this may slightly
+  // overestimate the size.
+  uint64_t current_header_map_byte_size_{};
   bool reset_stream_called_{};
   Buffer::WatermarkBuffer output_buffer_;
   Buffer::RawSlice reserved_iovec_;
@@ -316,6 +321,9 @@ public:
 
   bool supports_http_10() override { return codec_settings_.accept_http_10_; }
 
+  // Http::ServerConnection
+  void reduceMaxConcurrentStreams(bool) override {}
+
 private:
   /**
    * An active HTTP/1.1 request.
@@ -1,5 +1,6 @@
 #include "common/http/http2/codec_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -254,15 +255,13 @@ int ConnectionImpl::StreamImpl::onDataSourceSend(const uint8_t* framehd, size_t
 
   parent_.outbound_data_frames_++;
 
-  Buffer::OwnedImpl output;
-  if (!parent_.addOutboundFrameFragment(output, framehd, FRAME_HEADER_SIZE)) {
+  if (!parent_.addOutboundFrameFragment(parent_.pending_output_, framehd, FRAME_HEADER_SIZE)) {
     ENVOY_CONN_LOG(debug, "error sending data frame: Too many frames in the outbound queue",
                    parent_.connection_);
     return NGHTTP2_ERR_FLOODED;
   }
 
-  output.move(pending_send_data_, length);
-  parent_.connection_.write(output, false);
+  parent_.pending_output_.move(pending_send_data_, length);
   return 0;
 }
 
@@ -621,6 +620,9 @@ int ConnectionImpl::onFrameSend(const nghttp2_frame* frame) {
   case NGHTTP2_DATA: {
     StreamImpl* stream = getStream(frame->hd.stream_id);
     stream->local_end_stream_sent_ = frame->hd.flags & NGHTTP2_FLAG_END_STREAM;
+    if (frame->hd.type == NGHTTP2_HEADERS) {
+      updateHeaderBlockStats(frame->hd, frame->headers);
+    }
     break;
   }
   }
@@ -628,6 +630,19 @@ int ConnectionImpl::onFrameSend(const nghttp2_frame* frame) {
   return 0;
 }
 
+void ConnectionImpl::updateHeaderBlockStats(const nghttp2_frame_hd& hd,
+                                            const nghttp2_headers& headers) {
+  // The frame length covers the whole HPACK encoded header block, including any CONTINUATION
+  // frames it was split into, plus the padding and priority fields.
+  uint64_t header_field_bytes = 0;
+  for (size_t i = 0; i < headers.nvlen; i++) {
+    header_field_bytes += headers.nva[i].namelen + headers.nva[i].valuelen;
+  }
+  const size_t priority_length = (hd.flags & NGHTTP2_FLAG_PRIORITY) ? 5 : 0;
+  stats_.tx_header_field_bytes_.add(header_field_bytes);
+  stats_.tx_header_block_bytes_.add(hd.length - headers.padlen - priority_length);
+}
+
 int ConnectionImpl::onInvalidFrame(int32_t stream_id, int error_code) {
   ENVOY_CONN_LOG(debug, "invalid frame: {} on stream {}", connection_, nghttp2_strerror(error_code),
                  stream_id);
@@ -708,22 +723,33 @@ void ConnectionImpl::releaseOutboundControlFrame(const Buffer::OwnedBufferFragme
 
 ssize_t ConnectionImpl::onSend(const uint8_t* data, size_t length) {
   ENVOY_CONN_LOG(trace, "send data: bytes={}", connection_, length);
-  Buffer::OwnedImpl buffer;
-  if (!addOutboundFrameFragment(buffer, data, length)) {
+  if (!addOutboundFrameFragment(pending_output_, data, length)) {
     ENVOY_CONN_LOG(debug, "error sending frame: Too many frames in the outbound queue.",
                    connection_);
     return NGHTTP2_ERR_FLOODED;
   }
 
-  // While the buffer is transient the fragment it contains will be moved into the
+  return length;
+}
+
+void ConnectionImpl::writePendingOutput() {
+  if (pending_output_.length() == 0) {
+    return;
+  }
+
+  // The frames are moved out of pending_output_ first, as writing may re-enter
+  // sendPendingFrames() before the write returns.
+  //
+  // While the buffer is transient the fragments it contains will be moved into the
   // write_buffer_ of the underlying connection_ by the write method below.
   // This creates lifetime dependency between the write_buffer_ of the underlying connection
   // and the codec object. Specifically the write_buffer_ MUST be either fully drained or
   // deleted before the codec object is deleted. This is presently guaranteed by the
   // destruction order of the Network::ConnectionImpl object where write_buffer_ is
   // destroyed before the filter_manager_ which owns the codec through Http::ConnectionManagerImpl.
-  connection_.write(buffer, false);
-  return length;
+  Buffer::OwnedImpl output;
+  output.move(pending_output_);
+  connection_.write(output, false);
 }
 
 int ConnectionImpl::onStreamClose(int32_t stream_id, uint32_t error_code) {
@@ -825,6 +851,9 @@ void ConnectionImpl::sendPendingFrames() {
   }
 
   int rc = nghttp2_session_send(session_);
+  // Frames serialized before a failure are still written, as they would have been when each frame
+  // was written as it was serialized.
+  writePendingOutput();
   if (rc != 0) {
     ASSERT(rc == NGHTTP2_ERR_CALLBACK_FAILURE);
     // For errors caused by the pending outbound frame flood the FrameFloodException has
@@ -1121,7 +1150,9 @@ ServerConnectionImpl::ServerConnectionImpl(Network::Connection& connection,
                                            Stats::Scope& scope, const Http2Settings& http2_settings,
                                            const uint32_t max_request_headers_kb)
     : ConnectionImpl(connection, scope, http2_settings, max_request_headers_kb),
-      callbacks_(callbacks) {
+      callbacks_(callbacks), max_concurrent_streams_(http2_settings.max_concurrent_streams_),
+      overload_max_concurrent_streams_(
+          std::min(http2_settings.overload_max_concurrent_streams_, max_concurrent_streams_)) {
   Http2Options http2_options(http2_settings);
   nghttp2_session_server_new2(&session_, http2_callbacks_.callbacks(), base(),
                               http2_options.options());
@@ -1129,6 +1160,23 @@ ServerConnectionImpl::ServerConnectionImpl(Network::Connection& connection,
   allow_metadata_ = http2_settings.allow_metadata_;
 }
 
+void ServerConnectionImpl::reduceMaxConcurrentStreams(bool reduce) {
+  if (overload_max_concurrent_streams_ == 0 || reduce == max_concurrent_streams_reduced_) {
+    return;
+  }
+  max_concurrent_streams_reduced_ = reduce;
+
+  // Once the client acknowledged the settings, nghttp2 refuses the streams opened beyond the
+  // maximum with REFUSED_STREAM, which clients may retry on another connection.
+  nghttp2_settings_entry settings{NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS,
+                                  reduce ? overload_max_concurrent_streams_
+                                         : max_concurrent_streams_};
+  ENVOY_CONN_LOG(debug, "advertising max concurrent streams {}", connection_, settings.value);
+  int rc = nghttp2_submit_settings(session_, NGHTTP2_FLAG_NONE, &settings, 1);
+  ASSERT(rc == 0);
+  sendPendingFrames();
+}
+
 int ServerConnectionImpl::onBeginHeaders(const nghttp2_frame* frame) {
   // For a server connection, we should never get push promise frames.
   ASSERT(frame->hd.type == NGHTTP2_HEADERS);
@@ -51,6 +51,8 @@ const std::string CLIENT_MAGIC_PREFIX = "PRI * HTTP/2";
   COUNTER(rx_reset)                                                                                \
   COUNTER(too_many_header_frames)                                                                  \
   COUNTER(trailers)                                                                                \
+  COUNTER(tx_header_block_bytes)                                                                   \
+  COUNTER(tx_header_field_bytes)                                                                   \
   COUNTER(tx_reset)
 
 /**
@@ -357,6 +359,7 @@ private:
   int onFrameReceived(const nghttp2_frame* frame);
   int onBeforeFrameSend(const nghttp2_frame* frame);
   int onFrameSend(const nghttp2_frame* frame);
+  void updateHeaderBlockStats(const nghttp2_frame_hd& hd, const nghttp2_headers& headers);
   virtual int onHeader(const nghttp2_frame* frame, HeaderString&& name, HeaderString&& value) PURE;
   int onInvalidFrame(int32_t stream_id, int error_code);
 
@@ -366,6 +369,10 @@ private:
   // this changes in the future. Also it is important that onSend does not do partial writes, as the
   // nghttp2 library will keep calling this callback to write the rest of the frame.
   ssize_t onSend(const uint8_t* data, size_t length);
+  // Writes the frames collected in pending_output_ by onSend and onDataSourceSend during a call to
+  // nghttp2_session_send(), which are written to the connection in one batch rather than a write
+  // per frame.
+  void writePendingOutput();
   int onStreamClose(int32_t stream_id, uint32_t error_code);
   int onMetadataReceived(int32_t stream_id, const uint8_t* data, size_t len);
   int onMetadataFrameComplete(int32_t stream_id, bool end_metadata);
@@ -382,6 +389,9 @@ private:
   void releaseOutboundFrame(const Buffer::OwnedBufferFragmentImpl* fragment);
   void releaseOutboundControlFrame(const Buffer::OwnedBufferFragmentImpl* fragment);
 
+  // The frames serialized by the current call to nghttp2_session_send(). Empty outside of
+  // sendPendingFrames().
+  Buffer::OwnedImpl pending_output_;
   bool dispatching_ : 1;
   bool raised_goaway_ : 1;
   bool pending_deferred_reset_ : 1;
@@ -428,6 +438,9 @@ public:
                        Stats::Scope& scope, const Http2Settings& http2_settings,
                        const uint32_t max_request_headers_kb);
 
+  // Http::ServerConnection
+  void reduceMaxConcurrentStreams(bool reduce) override;
+
 private:
   // ConnectionImpl
   ConnectionCallbacks& callbacks() override { return callbacks_; }
@@ -451,6 +464,11 @@ private:
   // This flag indicates that downstream data is being dispatched and turns on flood mitigation
   // in the checkMaxOutbound*Framed methods.
   bool dispatching_downstream_data_{false};
+
+  const uint32_t max_concurrent_streams_;
+  // The maximum advertised while reduced, or 0 if the maximum is never reduced.
+  const uint32_t overload_max_concurrent_streams_;
+  bool max_concurrent_streams_reduced_{false};
 };
 
 } // namespace Http2
@@ -1,5 +1,6 @@
 #include "common/http/http2/conn_pool.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 
@@ -22,12 +23,12 @@ ConnPoolImpl::ConnPoolImpl(Event::Dispatcher& dispatcher, Upstream::HostConstSha
       socket_options_(options) {}
 
 ConnPoolImpl::~ConnPoolImpl() {
-  if (primary_client_) {
-    primary_client_->client_->close();
+  while (!clients_.empty()) {
+    clients_.front()->client_->close();
   }
 
-  if (draining_client_) {
-    draining_client_->client_->close();
+  while (!draining_clients_.empty()) {
+    draining_clients_.front()->client_->close();
   }
 
   // Make sure all clients are destroyed before we are destroyed.
@@ -35,8 +36,8 @@ ConnPoolImpl::~ConnPoolImpl() {
 }
 
 void ConnPoolImpl::ConnPoolImpl::drainConnections() {
-  if (primary_client_ != nullptr) {
-    movePrimaryClientToDraining();
+  while (!clients_.empty()) {
+    moveClientToDraining(*clients_.front());
   }
 }
 
@@ -46,12 +47,16 @@ void ConnPoolImpl::addDrainedCallback(DrainedCb cb) {
 }
 
 bool ConnPoolImpl::hasActiveConnections() const {
-  if (primary_client_ && primary_client_->client_->numActiveRequests() > 0) {
-    return true;
+  for (const ActiveClientPtr& client : clients_) {
+    if (client->client_->numActiveRequests() > 0) {
+      return true;
+    }
   }
 
-  if (draining_client_ && draining_client_->client_->numActiveRequests() > 0) {
-    return true;
+  for (const ActiveClientPtr& client : draining_clients_) {
+    if (client->client_->numActiveRequests() > 0) {
+      return true;
+    }
   }
 
   return !pending_requests_.empty();
@@ -63,17 +68,22 @@ void ConnPoolImpl::checkForDrained() {
   }
 
   bool drained = true;
-  if (primary_client_) {
-    if (primary_client_->client_->numActiveRequests() == 0) {
-      primary_client_->client_->close();
-      ASSERT(!primary_client_);
+  for (auto it = clients_.begin(); it != clients_.end();) {
+    // Closing the client removes it from the list, so advance past it first.
+    ActiveClient& client = **it++;
+    if (client.client_->numActiveRequests() == 0) {
+      client.client_->close();
     } else {
       drained = false;
     }
   }
 
-  ASSERT(!draining_client_ || (draining_client_->client_->numActiveRequests() > 0));
-  if (draining_client_ && draining_client_->client_->numActiveRequests() > 0) {
+  // Draining clients are closed as soon as they have no active requests.
+  ASSERT(std::all_of(draining_clients_.begin(), draining_clients_.end(),
+                     [](const ActiveClientPtr& client) {
+                       return client->client_->numActiveRequests() > 0;
+                     }));
+  if (!draining_clients_.empty()) {
     drained = false;
   }
 
@@ -85,7 +95,34 @@ void ConnPoolImpl::checkForDrained() {
   }
 }
 
-void ConnPoolImpl::newClientStream(Http::StreamDecoder& response_decoder,
+ConnPoolImpl::ActiveClient* ConnPoolImpl::leastLoadedClient() {
+  ActiveClient* least_loaded_client = nullptr;
+  for (const ActiveClientPtr& client : clients_) {
+    if (client->upstream_ready_ &&
+        (least_loaded_client == nullptr || client->client_->numActiveRequests() <
+                                               least_loaded_client->client_->numActiveRequests())) {
+      least_loaded_client = client.get();
+    }
+  }
+  return least_loaded_client;
+}
+
+bool ConnPoolImpl::shouldCreateClient(const ActiveClient* least_loaded_client) const {
+  if (clients_.empty()) {
+    return true;
+  }
+
+  // Only open another connection once every connection carries streams, and not while one is
+  // still being established, as it will take the load off the others once it is ready.
+  if (least_loaded_client == nullptr || least_loaded_client->client_->numActiveRequests() == 0 ||
+      clients_.size() >= host_->cluster().maxHttp2ConnectionsPerHost()) {
+    return false;
+  }
+  return std::all_of(clients_.begin(), clients_.end(),
+                     [](const ActiveClientPtr& client) { return client->upstream_ready_; });
+}
+
+void ConnPoolImpl::newClientStream(ActiveClient& client, Http::StreamDecoder& response_decoder,
                                    ConnectionPool::Callbacks& callbacks) {
   if (!host_->cluster().resourceManager(priority_).requests().canCreate()) {
     ENVOY_LOG(debug, "max requests overflow");
@@ -93,15 +130,17 @@ void ConnPoolImpl::newClientStream(Http::StreamDecoder& response_decoder,
                             nullptr);
     host_->cluster().stats().upstream_rq_pending_overflow_.inc();
   } else {
-    ENVOY_CONN_LOG(debug, "creating stream", *primary_client_->client_);
-    primary_client_->total_streams_++;
+    ENVOY_CONN_LOG(debug, "creating stream", *client.client_);
+    client.total_streams_++;
     host_->stats().rq_total_.inc();
     host_->stats().rq_active_.inc();
     host_->cluster().stats().upstream_rq_total_.inc();
     host_->cluster().stats().upstream_rq_active_.inc();
+    host_->cluster().stats().upstream_cx_http2_concurrent_streams_.recordValue(
+        client.client_->numActiveRequests() + 1);
     host_->cluster().resourceManager(priority_).requests().inc();
-    callbacks.onPoolReady(primary_client_->client_->newStream(response_decoder),
-                          primary_client_->real_host_description_);
+    callbacks.onPoolReady(client.client_->newStream(response_decoder),
+                          client.real_host_description_);
   }
 }
 
@@ -115,16 +154,22 @@ ConnectionPool::Cancellable* ConnPoolImpl::newStream(Http::StreamDecoder& respon
     max_streams = maxTotalStreams();
   }
 
-  if (primary_client_ && primary_client_->total_streams_ >= max_streams) {
-    movePrimaryClientToDraining();
+  for (auto it = clients_.begin(); it != clients_.end();) {
+    // Draining the client removes it from the list, so advance past it first.
+    ActiveClient& client = **it++;
+    if (client.total_streams_ >= max_streams) {
+      moveClientToDraining(client);
+    }
   }
 
-  if (!primary_client_) {
-    primary_client_ = std::make_unique<ActiveClient>(*this);
+  ActiveClient* client = leastLoadedClient();
+  if (shouldCreateClient(client)) {
+    ActiveClientPtr new_client = std::make_unique<ActiveClient>(*this);
+    new_client->moveIntoListBack(std::move(new_client), clients_);
   }
 
-  // If the primary client is not connected yet, queue up the request.
-  if (!primary_client_->upstream_ready_) {
+  // If no client is connected yet, queue up the request.
+  if (client == nullptr) {
     // If we're not allowed to enqueue more requests, fail fast.
     if (!host_->cluster().resourceManager(priority_).pendingRequests().canCreate()) {
       ENVOY_LOG(debug, "max pending requests overflow");
@@ -138,11 +183,25 @@ ConnectionPool::Cancellable* ConnPoolImpl::newStream(Http::StreamDecoder& respon
   }
 
   // We already have an active client that's connected to upstream, so attempt to establish a
-  // new stream.
-  newClientStream(response_decoder, callbacks);
+  // new stream. If a new client is being created as well it will take subsequent streams once it
+  // is connected.
+  newClientStream(*client, response_decoder, callbacks);
   return nullptr;
 }
 
+void ConnPoolImpl::preconnect(uint32_t expected_requests) {
+  // Streams are multiplexed, so a single connection is opened ahead of the expected requests,
+  // and any more as the streams on it become concurrent.
+  if (host_->cluster().perUpstreamPreconnectRatio() <= 1.0 || !drained_callbacks_.empty() ||
+      !clients_.empty() || expected_requests == 0) {
+    return;
+  }
+
+  host_->cluster().stats().upstream_cx_preconnect_.inc();
+  ActiveClientPtr client = std::make_unique<ActiveClient>(*this);
+  client->moveIntoListBack(std::move(client), clients_);
+}
+
 void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEvent event) {
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
@@ -167,12 +226,12 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
                            client.client_->connectionFailureReason());
     }
 
-    if (&client == primary_client_.get()) {
-      ENVOY_CONN_LOG(debug, "destroying primary client", *client.client_);
-      dispatcher_.deferredDelete(std::move(primary_client_));
-    } else {
+    if (client.draining_) {
       ENVOY_CONN_LOG(debug, "destroying draining client", *client.client_);
-      dispatcher_.deferredDelete(std::move(draining_client_));
+      dispatcher_.deferredDelete(client.removeFromList(draining_clients_));
+    } else {
+      ENVOY_CONN_LOG(debug, "destroying client", *client.client_);
+      dispatcher_.deferredDelete(client.removeFromList(clients_));
     }
 
     if (client.closed_with_active_rq_) {
@@ -193,25 +252,16 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
   }
 }
 
-void ConnPoolImpl::movePrimaryClientToDraining() {
-  ENVOY_CONN_LOG(debug, "moving primary to draining", *primary_client_->client_);
-  if (draining_client_) {
-    // This should pretty much never happen, but is possible if we start draining and then get
-    // a goaway for example. In this case just kill the current draining connection. It's not
-    // worth keeping a list.
-    draining_client_->client_->close();
-  }
-
-  ASSERT(!draining_client_);
-  if (primary_client_->client_->numActiveRequests() == 0) {
-    // If we are making a new connection and the primary does not have any active requests just
-    // close it now.
-    primary_client_->client_->close();
+void ConnPoolImpl::moveClientToDraining(ActiveClient& client) {
+  ENVOY_CONN_LOG(debug, "moving client to draining", *client.client_);
+  ASSERT(!client.draining_);
+  if (client.client_->numActiveRequests() == 0) {
+    // If the client does not have any active requests just close it now.
+    client.client_->close();
   } else {
-    draining_client_ = std::move(primary_client_);
+    client.draining_ = true;
+    client.moveBetweenLists(clients_, draining_clients_);
   }
-
-  ASSERT(!primary_client_);
 }
 
 void ConnPoolImpl::onConnectTimeout(ActiveClient& client) {
@@ -223,8 +273,8 @@ void ConnPoolImpl::onConnectTimeout(ActiveClient& client) {
 void ConnPoolImpl::onGoAway(ActiveClient& client) {
   ENVOY_CONN_LOG(debug, "remote goaway", *client.client_);
   host_->cluster().stats().upstream_cx_close_notify_.inc();
-  if (&client == primary_client_.get()) {
-    movePrimaryClientToDraining();
+  if (!client.draining_) {
+    moveClientToDraining(client);
   }
 }
 
@@ -234,7 +284,7 @@ void ConnPoolImpl::onStreamDestroy(ActiveClient& client) {
   host_->stats().rq_active_.dec();
   host_->cluster().stats().upstream_rq_active_.dec();
   host_->cluster().resourceManager(priority_).requests().dec();
-  if (&client == draining_client_.get() && client.client_->numActiveRequests() == 0) {
+  if (client.draining_ && client.client_->numActiveRequests() == 0) {
     // Close out the draining client if we no long have active requests.
     client.client_->close();
   }
@@ -260,9 +310,12 @@ void ConnPoolImpl::onStreamReset(ActiveClient& client, Http::StreamResetReason r
 }
 
 void ConnPoolImpl::onUpstreamReady() {
-  // Establishes new codec streams for each pending request.
+  // Establishes new codec streams for each pending request, each on the least loaded client.
   while (!pending_requests_.empty()) {
-    newClientStream(pending_requests_.back()->decoder_, pending_requests_.back()->callbacks_);
+    ActiveClient* client = leastLoadedClient();
+    ASSERT(client != nullptr);
+    newClientStream(*client, pending_requests_.back()->decoder_,
+                    pending_requests_.back()->callbacks_);
     pending_requests_.pop_back();
   }
 }
@@ -0,0 +1,418 @@
+#include "common/http/shared_conn_pool.h"
+
+#include <memory>
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
+
+namespace Envoy {
+namespace Http {
+
+SharedConnPool::SharedConnPool(Event::Dispatcher& dispatcher, Protocol protocol,
+                               Upstream::HostDescriptionConstSharedPtr host, PoolFactory factory,
+                               std::function<void()> destroyed_cb)
+    : dispatcher_(dispatcher), protocol_(protocol), host_(std::move(host)),
+      factory_(std::move(factory)), destroyed_cb_(std::move(destroyed_cb)) {}
+
+SharedConnPool::~SharedConnPool() {
+  pool_.reset();
+  if (destroyed_cb_) {
+    destroyed_cb_();
+  }
+}
+
+ConnectionPool::InstancePtr SharedConnPool::createClient(Event::Dispatcher& dispatcher) {
+  return std::make_unique<ClientPool>(shared_from_this(), dispatcher);
+}
+
+void SharedConnPool::shutdown() {
+  shutdown_ = true;
+  while (!pending_streams_.empty()) {
+    SharedStream& stream = **pending_streams_.begin();
+    stream.handle_->cancel();
+    stream.onPoolFailure(ConnectionPool::PoolFailureReason::ConnectionFailure, absl::string_view(),
+                         nullptr);
+  }
+  pool_.reset();
+}
+
+ConnectionPool::Instance* SharedConnPool::pool() {
+  if (pool_ == nullptr && !shutdown_) {
+    ENVOY_LOG(debug, "creating shared connection pool");
+    pool_ = factory_();
+  }
+  return pool_.get();
+}
+
+void SharedConnPool::SharedStream::start(SharedConnPool& parent) {
+  parent_ = &parent;
+  ConnectionPool::Instance* pool = parent.pool();
+  if (pool == nullptr) {
+    onPoolFailure(ConnectionPool::PoolFailureReason::ConnectionFailure, absl::string_view(),
+                  nullptr);
+    return;
+  }
+  // The pool may call back before this returns, in which case there is no handle.
+  ConnectionPool::Cancellable* handle = pool->newStream(*this, *this);
+  if (handle != nullptr) {
+    handle_ = handle;
+    parent.pending_streams_.insert(this);
+  }
+}
+
+void SharedConnPool::SharedStream::cancel() {
+  if (handle_ != nullptr) {
+    ConnectionPool::Cancellable* handle = handle_;
+    clearHandle();
+    handle->cancel();
+  } else {
+    resetStream(StreamResetReason::LocalReset);
+  }
+}
+
+void SharedConnPool::SharedStream::clearHandle() {
+  if (handle_ != nullptr) {
+    parent_->pending_streams_.erase(this);
+    handle_ = nullptr;
+  }
+}
+
+void SharedConnPool::SharedStream::encodeHeaders(const HeaderMap& headers, bool end_stream) {
+  if (encoder_ == nullptr) {
+    return;
+  }
+  encoder_->encodeHeaders(headers, end_stream);
+  if (end_stream) {
+    onLocalComplete();
+  }
+}
+
+void SharedConnPool::SharedStream::encodeData(Buffer::Instance& data, bool end_stream) {
+  if (encoder_ == nullptr) {
+    return;
+  }
+  encoder_->encodeData(data, end_stream);
+  if (end_stream) {
+    onLocalComplete();
+  }
+}
+
+void SharedConnPool::SharedStream::encodeTrailers(const HeaderMap& trailers) {
+  if (encoder_ == nullptr) {
+    return;
+  }
+  encoder_->encodeTrailers(trailers);
+  onLocalComplete();
+}
+
+void SharedConnPool::SharedStream::encodeMetadata(const MetadataMapVector& metadata_map_vector) {
+  if (encoder_ != nullptr) {
+    encoder_->encodeMetadata(metadata_map_vector);
+  }
+}
+
+void SharedConnPool::SharedStream::resetStream(StreamResetReason reason) {
+  if (encoder_ == nullptr) {
+    return;
+  }
+  Stream& stream = encoder_->getStream();
+  encoder_ = nullptr;
+  stream.removeCallbacks(*this);
+  stream.resetStream(reason);
+}
+
+void SharedConnPool::SharedStream::readDisable(bool disable) {
+  if (encoder_ != nullptr) {
+    encoder_->getStream().readDisable(disable);
+  }
+}
+
+void SharedConnPool::SharedStream::onLocalComplete() {
+  // Encoding may have reset the stream.
+  if (encoder_ == nullptr) {
+    return;
+  }
+  local_complete_ = true;
+  if (remote_complete_) {
+    onComplete();
+  }
+}
+
+void SharedConnPool::SharedStream::onRemoteComplete() {
+  if (encoder_ == nullptr) {
+    return;
+  }
+  remote_complete_ = true;
+  if (local_complete_) {
+    onComplete();
+  }
+}
+
+void SharedConnPool::SharedStream::onComplete() {
+  // The codec stream may be destroyed after this stream is, so it must stop calling back into it.
+  encoder_->getStream().removeCallbacks(*this);
+  encoder_ = nullptr;
+}
+
+void SharedConnPool::SharedStream::postToClient(std::function<void(ActiveStream&)> event) {
+  SharedStreamSharedPtr stream = shared_from_this();
+  client_dispatcher_.post([stream, event]() -> void {
+    if (stream->active_stream_ != nullptr) {
+      event(*stream->active_stream_);
+    }
+  });
+}
+
+void SharedConnPool::SharedStream::decode100ContinueHeaders(HeaderMapPtr&& headers) {
+  auto shared_headers = std::make_shared<HeaderMapPtr>(std::move(headers));
+  postToClient([shared_headers](ActiveStream& stream) -> void {
+    stream.response_decoder_.decode100ContinueHeaders(std::move(*shared_headers));
+  });
+}
+
+void SharedConnPool::SharedStream::decodeHeaders(HeaderMapPtr&& headers, bool end_stream) {
+  if (end_stream) {
+    onRemoteComplete();
+  }
+  auto shared_headers = std::make_shared<HeaderMapPtr>(std::move(headers));
+  postToClient([shared_headers, end_stream](ActiveStream& stream) -> void {
+    stream.remote_complete_ = end_stream;
+    stream.response_decoder_.decodeHeaders(std::move(*shared_headers), end_stream);
+    stream.checkComplete();
+  });
+}
+
+void SharedConnPool::SharedStream::decodeData(Buffer::Instance& data, bool end_stream) {
+  if (end_stream) {
+    onRemoteComplete();
+  }
+  auto shared_data = std::make_shared<Buffer::OwnedImpl>();
+  shared_data->move(data);
+  postToClient([shared_data, end_stream](ActiveStream& stream) -> void {
+    stream.remote_complete_ = end_stream;
+    stream.response_decoder_.decodeData(*shared_data, end_stream);
+    stream.checkComplete();
+  });
+}
+
+void SharedConnPool::SharedStream::decodeTrailers(HeaderMapPtr&& trailers) {
+  onRemoteComplete();
+  auto shared_trailers = std::make_shared<HeaderMapPtr>(std::move(trailers));
+  postToClient([shared_trailers](ActiveStream& stream) -> void {
+    stream.remote_complete_ = true;
+    stream.response_decoder_.decodeTrailers(std::move(*shared_trailers));
+    stream.checkComplete();
+  });
+}
+
+void SharedConnPool::SharedStream::decodeMetadata(MetadataMapPtr&& metadata_map) {
+  auto shared_metadata_map = std::make_shared<MetadataMapPtr>(std::move(metadata_map));
+  postToClient([shared_metadata_map](ActiveStream& stream) -> void {
+    stream.response_decoder_.decodeMetadata(std::move(*shared_metadata_map));
+  });
+}
+
+void SharedConnPool::SharedStream::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                                 absl::string_view transport_failure_reason,
+                                                 Upstream::HostDescriptionConstSharedPtr host) {
+  clearHandle();
+  const std::string failure_reason(transport_failure_reason);
+  postToClient([reason, failure_reason, host](ActiveStream& stream) -> void {
+    stream.onPoolFailure(reason, failure_reason, host);
+  });
+}
+
+void SharedConnPool::SharedStream::onPoolReady(StreamEncoder& encoder,
+                                               Upstream::HostDescriptionConstSharedPtr host) {
+  clearHandle();
+  encoder_ = &encoder;
+  encoder.getStream().addCallbacks(*this);
+  const uint32_t buffer_limit = encoder.getStream().bufferLimit();
+  postToClient([host, buffer_limit](ActiveStream& stream) -> void {
+    stream.onPoolReady(host, buffer_limit);
+  });
+}
+
+void SharedConnPool::SharedStream::onResetStream(StreamResetReason reason, absl::string_view) {
+  encoder_ = nullptr;
+  postToClient([reason](ActiveStream& stream) -> void { stream.onResetStream(reason); });
+}
+
+void SharedConnPool::SharedStream::onAboveWriteBufferHighWatermark() {
+  postToClient([](ActiveStream& stream) -> void { stream.runHighWatermarkCallbacks(); });
+}
+
+void SharedConnPool::SharedStream::onBelowWriteBufferLowWatermark() {
+  postToClient([](ActiveStream& stream) -> void { stream.runLowWatermarkCallbacks(); });
+}
+
+SharedConnPool::ActiveStream::ActiveStream(ClientPool& parent, StreamDecoder& response_decoder,
+                                           ConnectionPool::Callbacks& callbacks)
+    : parent_(parent), response_decoder_(response_decoder), callbacks_(callbacks),
+      shared_(std::make_shared<SharedStream>(parent.dispatcher_)) {
+  shared_->active_stream_ = this;
+}
+
+SharedConnPool::ActiveStream::~ActiveStream() { shared_->active_stream_ = nullptr; }
+
+void SharedConnPool::ActiveStream::onPoolReady(Upstream::HostDescriptionConstSharedPtr host,
+                                               uint32_t buffer_limit) {
+  buffer_limit_ = buffer_limit;
+  callbacks_.onPoolReady(*this, host);
+}
+
+void SharedConnPool::ActiveStream::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                                 absl::string_view transport_failure_reason,
+                                                 Upstream::HostDescriptionConstSharedPtr host) {
+  done();
+  callbacks_.onPoolFailure(reason, transport_failure_reason, host);
+}
+
+void SharedConnPool::ActiveStream::checkComplete() {
+  if (remote_complete_ && local_end_stream_) {
+    done();
+  }
+}
+
+void SharedConnPool::ActiveStream::onResetStream(StreamResetReason reason) {
+  done();
+  runResetCallbacks(reason);
+}
+
+void SharedConnPool::ActiveStream::done() {
+  if (done_) {
+    return;
+  }
+  done_ = true;
+  shared_->active_stream_ = nullptr;
+  parent_.onStreamDone(*this);
+}
+
+void SharedConnPool::ActiveStream::postToShared(std::function<void(SharedStream&)> event) {
+  SharedStreamSharedPtr stream = shared_;
+  parent_.postToShared([stream, event]() -> void { event(*stream); });
+}
+
+void SharedConnPool::ActiveStream::cancel() {
+  postToShared([](SharedStream& stream) -> void { stream.cancel(); });
+  done();
+}
+
+void SharedConnPool::ActiveStream::encodeHeaders(const HeaderMap& headers, bool end_stream) {
+  local_end_stream_ = end_stream;
+  auto shared_headers = std::make_shared<HeaderMapImpl>(headers);
+  postToShared([shared_headers, end_stream](SharedStream& stream) -> void {
+    stream.encodeHeaders(*shared_headers, end_stream);
+  });
+  checkComplete();
+}
+
+void SharedConnPool::ActiveStream::encodeData(Buffer::Instance& data, bool end_stream) {
+  local_end_stream_ = end_stream;
+  auto shared_data = std::make_shared<Buffer::OwnedImpl>();
+  shared_data->move(data);
+  postToShared([shared_data, end_stream](SharedStream& stream) -> void {
+    stream.encodeData(*shared_data, end_stream);
+  });
+  checkComplete();
+}
+
+void SharedConnPool::ActiveStream::encodeTrailers(const HeaderMap& trailers) {
+  local_end_stream_ = true;
+  auto shared_trailers = std::make_shared<HeaderMapImpl>(trailers);
+  postToShared(
+      [shared_trailers](SharedStream& stream) -> void { stream.encodeTrailers(*shared_trailers); });
+  checkComplete();
+}
+
+void SharedConnPool::ActiveStream::encodeMetadata(const MetadataMapVector& metadata_map_vector) {
+  auto shared_metadata_map_vector = std::make_shared<MetadataMapVector>();
+  for (const MetadataMapPtr& metadata_map : metadata_map_vector) {
+    shared_metadata_map_vector->push_back(std::make_unique<MetadataMap>(*metadata_map));
+  }
+  postToShared([shared_metadata_map_vector](SharedStream& stream) -> void {
+    stream.encodeMetadata(*shared_metadata_map_vector);
+  });
+}
+
+void SharedConnPool::ActiveStream::resetStream(StreamResetReason reason) {
+  // As with codec streams, the reset callbacks are run before this returns.
+  postToShared([reason](SharedStream& stream) -> void { stream.resetStream(reason); });
+  done();
+  runResetCallbacks(reason);
+}
+
+void SharedConnPool::ActiveStream::readDisable(bool disable) {
+  postToShared([disable](SharedStream& stream) -> void { stream.readDisable(disable); });
+}
+
+SharedConnPool::ClientPool::ClientPool(SharedConnPoolSharedPtr parent,
+                                       Event::Dispatcher& dispatcher)
+    : dispatcher_(dispatcher), parent_(std::move(parent)) {}
+
+SharedConnPool::ClientPool::~ClientPool() {
+  for (const ActiveStreamPtr& stream : streams_) {
+    SharedStreamSharedPtr shared = stream->shared_;
+    postToShared([shared]() -> void { shared->cancel(); });
+  }
+  streams_.clear();
+
+  // The shared pool must be destroyed on the owner's thread. The reference to it is released by
+  // the owner, after the events this client has already posted to it, rather than with whichever
+  // copy of the posted callback happens to be destroyed last.
+  Event::Dispatcher& owner_dispatcher = parent_->dispatcher_;
+  auto parent = std::make_shared<SharedConnPoolSharedPtr>(std::move(parent_));
+  owner_dispatcher.post([parent]() -> void { parent->reset(); });
+}
+
+void SharedConnPool::ClientPool::onStreamDone(ActiveStream& stream) {
+  dispatcher_.deferredDelete(stream.removeFromList(streams_));
+  checkForDrained();
+}
+
+void SharedConnPool::ClientPool::addDrainedCallback(DrainedCb cb) {
+  drained_callbacks_.push_back(cb);
+  checkForDrained();
+}
+
+void SharedConnPool::ClientPool::drainConnections() {
+  SharedConnPool* parent = parent_.get();
+  postToShared([parent]() -> void {
+    if (parent->pool_ != nullptr) {
+      parent->pool_->drainConnections();
+    }
+  });
+}
+
+ConnectionPool::Cancellable*
+SharedConnPool::ClientPool::newStream(StreamDecoder& response_decoder,
+                                      ConnectionPool::Callbacks& callbacks) {
+  ActiveStreamPtr stream = std::make_unique<ActiveStream>(*this, response_decoder, callbacks);
+  stream->moveIntoList(std::move(stream), streams_);
+  SharedConnPool* parent = parent_.get();
+  SharedStreamSharedPtr shared = streams_.front()->shared_;
+  postToShared([parent, shared]() -> void { shared->start(*parent); });
+  return streams_.front().get();
+}
+
+void SharedConnPool::ClientPool::preconnect(uint32_t expected_requests) {
+  SharedConnPool* parent = parent_.get();
+  postToShared([parent, expected_requests]() -> void {
+    ConnectionPool::Instance* pool = parent->pool();
+    if (pool != nullptr) {
+      pool->preconnect(expected_requests);
+    }
+  });
+}
+
+void SharedConnPool::ClientPool::checkForDrained() {
+  if (!drained_callbacks_.empty() && streams_.empty()) {
+    for (const DrainedCb& cb : drained_callbacks_) {
+      cb();
+    }
+  }
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/codec.h"
+#include "envoy/http/conn_pool.h"
+#include "envoy/upstream/host_description.h"
+
+#include "common/common/assert.h"
+#include "common/common/linked_object.h"
+#include "common/common/logger.h"
+#include "common/http/codec_helper.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+
+class SharedConnPool;
+using SharedConnPoolSharedPtr = std::shared_ptr<SharedConnPool>;
+
+/**
+ * A connection pool used on one thread, the owner, whose streams are made from other threads.
+ * Each thread makes streams through a client pool of its own, which hands the events of each
+ * stream between its thread and the owner's by posting them to the threads' dispatchers. Headers,
+ * trailers and metadata are copied between the threads, and bodies are moved. This lets the
+ * threads share the connections of one pool, at the cost of two posts for each event.
+ */
+class SharedConnPool : public std::enable_shared_from_this<SharedConnPool>,
+                       Logger::Loggable<Logger::Id::pool> {
+public:
+  using PoolFactory = std::function<ConnectionPool::InstancePtr()>;
+
+  /**
+   * @param dispatcher supplies the owner's dispatcher.
+   * @param protocol supplies the protocol of the pool.
+   * @param host supplies the host the pool connects to.
+   * @param factory supplies the factory of the pool, which is called on the owner's thread when
+   *                the first stream is made.
+   * @param destroyed_cb supplies a callback called on the owner's thread when the shared pool is
+   *                     destroyed.
+   */
+  SharedConnPool(Event::Dispatcher& dispatcher, Protocol protocol,
+                 Upstream::HostDescriptionConstSharedPtr host, PoolFactory factory,
+                 std::function<void()> destroyed_cb);
+  ~SharedConnPool();
+
+  /**
+   * Creates a client pool through which a thread makes streams on the shared pool. The client
+   * may be created on any thread, but must only be used and destroyed on the dispatcher's thread.
+   * The shared pool is destroyed on the owner's thread once all of its clients are destroyed.
+   * @param dispatcher supplies the dispatcher of the thread using the client.
+   * @return ConnectionPool::InstancePtr the client pool.
+   */
+  ConnectionPool::InstancePtr createClient(Event::Dispatcher& dispatcher);
+
+  /**
+   * Destroys the pool, closing its connections. Streams on them are reset, pending streams and
+   * streams made afterwards fail. Must be called on the owner's thread.
+   */
+  void shutdown();
+
+private:
+  struct ActiveStream;
+  using ActiveStreamPtr = std::unique_ptr<ActiveStream>;
+
+  /**
+   * The part of a stream used on the owner's thread, which makes the stream on the pool.
+   * Everything but active_stream_ is only touched on the owner's thread.
+   */
+  struct SharedStream : public StreamDecoder,
+                        public ConnectionPool::Callbacks,
+                        public StreamCallbacks,
+                        public std::enable_shared_from_this<SharedStream> {
+    SharedStream(Event::Dispatcher& client_dispatcher) : client_dispatcher_(client_dispatcher) {}
+
+    void start(SharedConnPool& parent);
+    void cancel();
+    void clearHandle();
+    void encodeHeaders(const HeaderMap& headers, bool end_stream);
+    void encodeData(Buffer::Instance& data, bool end_stream);
+    void encodeTrailers(const HeaderMap& trailers);
+    void encodeMetadata(const MetadataMapVector& metadata_map_vector);
+    void resetStream(StreamResetReason reason);
+    void readDisable(bool disable);
+    void onLocalComplete();
+    void onRemoteComplete();
+    void onComplete();
+
+    // Posts an event to the client's thread, where it is dropped if the client's part of the
+    // stream is gone.
+    void postToClient(std::function<void(ActiveStream&)> event);
+
+    // Http::StreamDecoder
+    void decode100ContinueHeaders(HeaderMapPtr&& headers) override;
+    void decodeHeaders(HeaderMapPtr&& headers, bool end_stream) override;
+    void decodeData(Buffer::Instance& data, bool end_stream) override;
+    void decodeTrailers(HeaderMapPtr&& trailers) override;
+    void decodeMetadata(MetadataMapPtr&& metadata_map) override;
+
+    // ConnectionPool::Callbacks
+    void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                       absl::string_view transport_failure_reason,
+                       Upstream::HostDescriptionConstSharedPtr host) override;
+    void onPoolReady(StreamEncoder& encoder, Upstream::HostDescriptionConstSharedPtr host) override;
+
+    // Http::StreamCallbacks
+    void onResetStream(StreamResetReason reason,
+                       absl::string_view transport_failure_reason) override;
+    void onAboveWriteBufferHighWatermark() override;
+    void onBelowWriteBufferLowWatermark() override;
+
+    Event::Dispatcher& client_dispatcher_;
+    SharedConnPool* parent_{};
+    // Only touched on the client's thread, and cleared once the client is done with the stream.
+    ActiveStream* active_stream_{};
+    ConnectionPool::Cancellable* handle_{};
+    // Cleared once the stream on the pool is done, i.e. complete or reset.
+    StreamEncoder* encoder_{};
+    bool local_complete_{};
+    bool remote_complete_{};
+  };
+
+  using SharedStreamSharedPtr = std::shared_ptr<SharedStream>;
+
+  class ClientPool;
+
+  /**
+   * The part of a stream used on the client's thread, which stands in for the stream on the pool.
+   */
+  struct ActiveStream : public LinkedObject<ActiveStream>,
+                        public Event::DeferredDeletable,
+                        public ConnectionPool::Cancellable,
+                        public StreamEncoder,
+                        public Stream,
+                        public StreamCallbackHelper {
+    ActiveStream(ClientPool& parent, StreamDecoder& response_decoder,
+                 ConnectionPool::Callbacks& callbacks);
+    ~ActiveStream() override;
+
+    void onPoolReady(Upstream::HostDescriptionConstSharedPtr host, uint32_t buffer_limit);
+    void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                       absl::string_view transport_failure_reason,
+                       Upstream::HostDescriptionConstSharedPtr host);
+    void checkComplete();
+    void onResetStream(StreamResetReason reason);
+    void done();
+
+    // Posts an event to the owner's thread.
+    void postToShared(std::function<void(SharedStream&)> event);
+
+    // ConnectionPool::Cancellable
+    void cancel() override;
+
+    // Http::StreamEncoder
+    void encode100ContinueHeaders(const HeaderMap&) override { NOT_REACHED_GCOVR_EXCL_LINE; }
+    void encodeHeaders(const HeaderMap& headers, bool end_stream) override;
+    void encodeData(Buffer::Instance& data, bool end_stream) override;
+    void encodeTrailers(const HeaderMap& trailers) override;
+    Stream& getStream() override { return *this; }
+    void encodeMetadata(const MetadataMapVector& metadata_map_vector) override;
+
+    // Http::Stream
+    void addCallbacks(StreamCallbacks& callbacks) override { addCallbacks_(callbacks); }
+    void removeCallbacks(StreamCallbacks& callbacks) override { removeCallbacks_(callbacks); }
+    void resetStream(StreamResetReason reason) override;
+    void readDisable(bool disable) override;
+    uint32_t bufferLimit() override { return buffer_limit_; }
+
+    ClientPool& parent_;
+    StreamDecoder& response_decoder_;
+    ConnectionPool::Callbacks& callbacks_;
+    const SharedStreamSharedPtr shared_;
+    uint32_t buffer_limit_{};
+    bool remote_complete_{};
+    bool done_{};
+  };
+
+  /**
+   * The pool through which a thread makes streams on the shared pool.
+   */
+  class ClientPool : public ConnectionPool::Instance {
+  public:
+    ClientPool(SharedConnPoolSharedPtr parent, Event::Dispatcher& dispatcher);
+    ~ClientPool() override;
+
+    void onStreamDone(ActiveStream& stream);
+    void postToShared(std::function<void()> event) { parent_->dispatcher_.post(event); }
+
+    // ConnectionPool::Instance
+    Protocol protocol() const override { return parent_->protocol_; }
+    void addDrainedCallback(DrainedCb cb) override;
+    void drainConnections() override;
+    bool hasActiveConnections() const override { return !streams_.empty(); }
+    ConnectionPool::Cancellable* newStream(StreamDecoder& response_decoder,
+                                           ConnectionPool::Callbacks& callbacks) override;
+    void preconnect(uint32_t expected_requests) override;
+    Upstream::HostDescriptionConstSharedPtr host() const override { return parent_->host_; }
+
+    Event::Dispatcher& dispatcher_;
+
+  private:
+    void checkForDrained();
+
+    SharedConnPoolSharedPtr parent_;
+    std::list<ActiveStreamPtr> streams_;
+    std::list<DrainedCb> drained_callbacks_;
+  };
+
+  // @return the pool, created if need be, or nullptr if the shared pool has been shut down.
+  ConnectionPool::Instance* pool();
+
+  Event::Dispatcher& dispatcher_;
+  const Protocol protocol_;
+  const Upstream::HostDescriptionConstSharedPtr host_;
+  PoolFactory factory_;
+  std::function<void()> destroyed_cb_;
+  ConnectionPool::InstancePtr pool_;
+  // The streams waiting on the pool, which are failed on shutdown as the pool drops them silently.
+  std::unordered_set<SharedStream*> pending_streams_;
+  bool shutdown_{};
+};
+
+} // namespace Http
+} // namespace Envoy
@@ -131,6 +131,41 @@ Utility::QueryParams Utility::parseParameters(absl::string_view data, size_t sta
   return params;
 }
 
+absl::optional<absl::string_view> Utility::QueryParamsView::find(absl::string_view name) const {
+  if (!parsed_) {
+    parse();
+  }
+  for (const auto& param : params_) {
+    if (param.first == name) {
+      return param.second;
+    }
+  }
+  return absl::nullopt;
+}
+
+void Utility::QueryParamsView::parse() const {
+  parsed_ = true;
+  size_t start = url_.find('?');
+  if (start == absl::string_view::npos) {
+    return;
+  }
+  start++;
+  while (start < url_.size()) {
+    size_t end = url_.find('&', start);
+    if (end == absl::string_view::npos) {
+      end = url_.size();
+    }
+    const absl::string_view param = url_.substr(start, end - start);
+    const size_t equal = param.find('=');
+    if (equal != absl::string_view::npos) {
+      params_.emplace_back(param.substr(0, equal), param.substr(equal + 1));
+    } else {
+      params_.emplace_back(param, absl::string_view());
+    }
+    start = end + 1;
+  }
+}
+
 absl::string_view Utility::findQueryStringStart(const HeaderString& path) {
   absl::string_view path_str = path.getStringView();
   size_t query_offset = path_str.find('?');
@@ -245,6 +280,8 @@ Utility::parseHttp2Settings(const envoy::api::v2::core::Http2ProtocolOptions& co
       config, hpack_table_size, Http::Http2Settings::DEFAULT_HPACK_TABLE_SIZE);
   ret.max_concurrent_streams_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
       config, max_concurrent_streams, Http::Http2Settings::DEFAULT_MAX_CONCURRENT_STREAMS);
+  ret.overload_max_concurrent_streams_ =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, overload_max_concurrent_streams, 0);
   ret.initial_stream_window_size_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
       config, initial_stream_window_size, Http::Http2Settings::DEFAULT_INITIAL_STREAM_WINDOW_SIZE);
   ret.initial_connection_window_size_ =
@@ -15,6 +15,7 @@
 
 #include "common/json/json_loader.h"
 
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 
@@ -39,6 +40,33 @@ private:
   absl::string_view path_and_query_params_;
 };
 
+/**
+ * The query parameters of a URL, as views into it, for matching them without copying them into
+ * QueryParams. The query string is split the first time a parameter is looked up, so a view made
+ * once per request is shared by all the matchers of the request, and costs nothing when none of
+ * them looks at the query. The URL must outlive the view, which is not thread safe.
+ */
+class QueryParamsView {
+public:
+  explicit QueryParamsView(absl::string_view url) : url_(url) {}
+
+  /**
+   * @param name supplies the name of a parameter.
+   * @return the value of the parameter, or absl::nullopt if the URL has no parameter by that name.
+   *         A parameter appearing more than once has the value of its first occurrence, as with
+   *         parseQueryString().
+   */
+  absl::optional<absl::string_view> find(absl::string_view name) const;
+
+private:
+  void parse() const;
+
+  const absl::string_view url_;
+  mutable bool parsed_{};
+  // Most query strings have a handful of parameters, which are held without allocating.
+  mutable absl::InlinedVector<std::pair<absl::string_view, absl::string_view>, 8> params_;
+};
+
 class PercentEncoding {
 public:
   /**
@@ -334,6 +362,25 @@ const ConfigType* resolveMostSpecificPerFilterConfig(const std::string& filter_n
   return dynamic_cast<const ConfigType*>(generic_config);
 }
 
+/**
+ * Retrieves the most specific route config of a filter, as resolveMostSpecificPerFilterConfig does,
+ * from the configs the route merged when it was loaded, @see Router::PerFilterConfigIds.
+ *
+ * @param filter_id The id of the filter's name, resolved once when the filter config is loaded.
+ * @param route The route to check for route configs. nullptr routes will result in nullptr being
+ * returned.
+ *
+ * @return The route config if found. nullptr if not found. The returned pointer's lifetime is the
+ * same as the route parameter.
+ */
+template <class ConfigType>
+const ConfigType* resolveMostSpecificPerFilterConfig(uint32_t filter_id,
+                                                     const Router::RouteConstSharedPtr& route) {
+  static_assert(std::is_base_of<Router::RouteSpecificFilterConfig, ConfigType>::value,
+                "ConfigType must be a subclass of Router::RouteSpecificFilterConfig");
+  return route ? route->mostSpecificPerFilterConfigTyped<ConfigType>(filter_id) : nullptr;
+}
+
 /**
  * The non template implementation of traversePerFilterConfig. see
  * traversePerFilterConfig for docs.
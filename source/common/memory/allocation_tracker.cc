@@ -0,0 +1,120 @@
+#include "common/memory/allocation_tracker.h"
+
+#include <cxxabi.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+
+#include "absl/container/flat_hash_map.h"
+
+#ifdef TCMALLOC
+#include "gperftools/malloc_hook.h"
+#endif
+
+namespace Envoy {
+namespace Memory {
+
+thread_local AllocationCounts* AllocationScope::current_ = nullptr;
+
+namespace {
+
+std::atomic<bool> tracking_enabled{false};
+
+struct Totals {
+  Thread::MutexBasicLockable mutex_;
+  // Keyed by the address of the name, as the subsystems pass the same static name on each request.
+  absl::flat_hash_map<const char*, SubsystemAllocations> subsystems_ GUARDED_BY(mutex_);
+};
+
+Totals& totals() { MUTABLE_CONSTRUCT_ON_FIRST_USE(Totals); }
+
+std::string demangle(const char* name) {
+  int status;
+  char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+  if (status != 0) {
+    return name;
+  }
+  std::string result(demangled);
+  ::free(demangled);
+  return result;
+}
+
+#ifdef TCMALLOC
+// Called by tcmalloc on each allocation, so it must not allocate itself.
+void onNewHook(const void*, size_t size) {
+  AllocationCounts* counts = AllocationScope::current();
+  if (counts != nullptr) {
+    counts->allocations_++;
+    counts->bytes_ += size;
+  }
+}
+#endif
+
+void recordSubsystem(const char* subsystem, bool mangled, const AllocationCounts& counts) {
+  Totals& state = totals();
+  Thread::LockGuard lock(state.mutex_);
+  auto it = state.subsystems_.find(subsystem);
+  if (it == state.subsystems_.end()) {
+    it = state.subsystems_.emplace(subsystem, SubsystemAllocations()).first;
+    it->second.name_ = mangled ? demangle(subsystem) : subsystem;
+  }
+  it->second.requests_++;
+  it->second.counts_.add(counts);
+}
+
+} // namespace
+
+bool AllocationTracker::setEnabled(bool enabled) {
+#ifdef TCMALLOC
+  if (enabled == tracking_enabled.exchange(enabled)) {
+    return true;
+  }
+  if (enabled) {
+    {
+      Totals& state = totals();
+      Thread::LockGuard lock(state.mutex_);
+      state.subsystems_.clear();
+    }
+    MallocHook::AddNewHook(&onNewHook);
+  } else {
+    MallocHook::RemoveNewHook(&onNewHook);
+  }
+  return true;
+#else
+  return !enabled;
+#endif
+}
+
+bool AllocationTracker::enabled() { return tracking_enabled.load(std::memory_order_relaxed); }
+
+void AllocationTracker::record(const char* subsystem, const AllocationCounts& counts) {
+  recordSubsystem(subsystem, false, counts);
+}
+
+void AllocationTracker::record(const std::type_info& subsystem, const AllocationCounts& counts) {
+  recordSubsystem(subsystem.name(), true, counts);
+}
+
+std::vector<SubsystemAllocations> AllocationTracker::subsystems() {
+  Totals& state = totals();
+  Thread::LockGuard lock(state.mutex_);
+  std::vector<SubsystemAllocations> subsystems;
+  subsystems.reserve(state.subsystems_.size());
+  for (const auto& subsystem : state.subsystems_) {
+    subsystems.push_back(subsystem.second);
+  }
+  std::sort(subsystems.begin(), subsystems.end(),
+            [](const SubsystemAllocations& a, const SubsystemAllocations& b) {
+              return a.name_ < b.name_;
+            });
+  return subsystems;
+}
+
+} // namespace Memory
+} // namespace Envoy
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace Envoy {
+namespace Memory {
+
+/**
+ * The heap allocations made within a scope.
+ */
+struct AllocationCounts {
+  void add(const AllocationCounts& other) {
+    allocations_ += other.allocations_;
+    bytes_ += other.bytes_;
+  }
+
+  uint64_t allocations_{};
+  uint64_t bytes_{};
+};
+
+/**
+ * The allocations attributed to a subsystem, such as an HTTP filter, summed over the requests.
+ */
+struct SubsystemAllocations {
+  std::string name_;
+  uint64_t requests_{};
+  AllocationCounts counts_;
+};
+
+/**
+ * Attributes the heap allocations of each thread to its innermost AllocationScope, through a
+ * tcmalloc new hook installed while tracking is enabled. The hook costs every allocation of the
+ * process a call, so tracking is meant to be enabled while investigating, not left on.
+ */
+class AllocationTracker {
+public:
+  /**
+   * Install or remove the allocation hook.
+   * @return bool false if the build does not support tracking the allocations.
+   */
+  static bool setEnabled(bool enabled);
+
+  /**
+   * @return bool whether the allocations are tracked. The scopes opened while tracking is disabled
+   *         count nothing.
+   */
+  static bool enabled();
+
+  /**
+   * Add the allocations of a request to the totals of a subsystem.
+   * @param subsystem supplies the name of the subsystem, which must outlive the process.
+   * @param counts supplies the allocations of the subsystem for the request.
+   */
+  static void record(const char* subsystem, const AllocationCounts& counts);
+
+  /**
+   * Add the allocations of a request to the totals of a subsystem named after its type, such as
+   * the class of an HTTP filter.
+   */
+  static void record(const std::type_info& subsystem, const AllocationCounts& counts);
+
+  /**
+   * @return the totals of the subsystems recorded since tracking was last enabled, by name.
+   */
+  static std::vector<SubsystemAllocations> subsystems();
+};
+
+/**
+ * Attributes the allocations of the current thread to a set of counts while it is alive, and to
+ * the enclosing scope again once destroyed, like ScopeTrackerScopeState does for the tracked
+ * object of a dispatcher.
+ */
+class AllocationScope {
+public:
+  /**
+   * @param counts supplies the counts to add the allocations to, or nullptr to not count them.
+   */
+  explicit AllocationScope(AllocationCounts* counts) : latched_counts_(current_) {
+    current_ = counts;
+  }
+  ~AllocationScope() { current_ = latched_counts_; }
+
+  /**
+   * @return the counts of the innermost scope of the thread, or nullptr if none.
+   */
+  static AllocationCounts* current() { return current_; }
+
+private:
+  static thread_local AllocationCounts* current_;
+
+  AllocationCounts* const latched_counts_;
+};
+
+} // namespace Memory
+} // namespace Envoy
@@ -0,0 +1,198 @@
+#include "common/network/caching_dns_resolver_impl.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Network {
+
+CachingDnsResolverImpl::CachingDnsResolverImpl(
+    DnsResolverSharedPtr resolver, Event::Dispatcher& dispatcher,
+    const envoy::config::bootstrap::v2::ClusterManager::DnsCache& config, Stats::Scope& scope)
+    : resolver_(std::move(resolver)), dispatcher_(dispatcher),
+      stats_{ALL_DNS_RESOLVER_CACHE_STATS(POOL_COUNTER_PREFIX(scope, "dns_resolver_cache."),
+                                          POOL_GAUGE_PREFIX(scope, "dns_resolver_cache."))},
+      max_entries_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entries, 1024)),
+      min_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, min_ttl, 0)),
+      max_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, max_ttl, 300000)),
+      negative_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, negative_ttl, 5000)),
+      prefetch_percent_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, prefetch_percent, 90)) {}
+
+CachingDnsResolverImpl::~CachingDnsResolverImpl() {
+  // The entries cancel their queries to the resolver.
+  entries_.clear();
+  stats_.entries_.set(0);
+}
+
+ActiveDnsQuery* CachingDnsResolverImpl::resolve(const std::string& dns_name,
+                                                DnsLookupFamily dns_lookup_family,
+                                                ResolveCb callback) {
+  const Key key{dns_name, dns_lookup_family};
+  auto it = entries_.find(key);
+  Entry& entry = it != entries_.end() ? *it->second : createEntry(key);
+  lru_.splice(lru_.begin(), lru_, entry.lru_position_);
+
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  if (entry.resolved_ && now < entry.expiry_) {
+    entry.used_ = true;
+    if (entry.response_.empty()) {
+      stats_.negative_hit_.inc();
+    } else {
+      stats_.hit_.inc();
+    }
+
+    const auto ttl = std::chrono::duration_cast<std::chrono::seconds>(entry.expiry_ - now);
+    std::list<DnsResponse> response;
+    for (const DnsResponse& cached : entry.response_) {
+      response.emplace_back(cached.address_, ttl);
+    }
+    callback(std::move(response));
+    return nullptr;
+  }
+
+  if (entry.resolving_) {
+    stats_.coalesced_.inc();
+    return addPendingQuery(entry, std::move(callback));
+  }
+
+  stats_.miss_.inc();
+  ActiveDnsQuery* query = addPendingQuery(entry, std::move(callback));
+  startResolution(entry);
+  // The resolver may have completed the resolution, and invoked the callback, inline.
+  return entry.resolving_ ? query : nullptr;
+}
+
+CachingDnsResolverImpl::Entry& CachingDnsResolverImpl::createEntry(const Key& key) {
+  if (entries_.size() >= max_entries_) {
+    // Evict the least recently used entry that no query is waiting on, if any.
+    auto victim = std::find_if(lru_.rbegin(), lru_.rend(), [](const Entry* entry) {
+      return entry->pending_queries_.empty();
+    });
+    if (victim != lru_.rend()) {
+      stats_.evicted_.inc();
+      removeEntry(**victim);
+    }
+  }
+
+  EntryPtr new_entry = std::make_unique<Entry>(*this, key);
+  Entry& entry = *new_entry;
+  lru_.push_front(&entry);
+  entry.lru_position_ = lru_.begin();
+  entries_.emplace(key, std::move(new_entry));
+  stats_.entries_.set(entries_.size());
+  return entry;
+}
+
+void CachingDnsResolverImpl::removeEntry(Entry& entry) {
+  ASSERT(entry.pending_queries_.empty());
+  auto it = entries_.find(entry.key_);
+  ASSERT(it != entries_.end());
+  EntryPtr removed = std::move(it->second);
+  entries_.erase(it);
+  lru_.erase(removed->lru_position_);
+  stats_.entries_.set(entries_.size());
+
+  // The entry may be removed from its own timer callback.
+  if (removed->resolving_) {
+    removed->active_query_->cancel();
+    removed->resolving_ = false;
+  }
+  removed->timer_->disableTimer();
+  dispatcher_.deferredDelete(std::move(removed));
+}
+
+void CachingDnsResolverImpl::startResolution(Entry& entry) {
+  ASSERT(!entry.resolving_);
+  entry.resolving_ = true;
+  entry.timer_->disableTimer();
+  ActiveDnsQuery* query = resolver_->resolve(
+      entry.key_.first, entry.key_.second,
+      [this, &entry](std::list<DnsResponse>&& response) -> void {
+        entry.active_query_ = nullptr;
+        onResolved(entry, std::move(response));
+      });
+  if (entry.resolving_) {
+    entry.active_query_ = query;
+  }
+}
+
+void CachingDnsResolverImpl::onResolved(Entry& entry, std::list<DnsResponse>&& response) {
+  entry.resolving_ = false;
+
+  std::chrono::milliseconds ttl = negative_ttl_;
+  if (!response.empty()) {
+    ttl = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::min_element(response.begin(), response.end(),
+                         [](const DnsResponse& lhs, const DnsResponse& rhs) {
+                           return lhs.ttl_ < rhs.ttl_;
+                         })
+            ->ttl_);
+    ttl = std::min(std::max(ttl, min_ttl_), max_ttl_);
+  }
+  ENVOY_LOG(trace, "dns resolver cache: caching {} responses for {} for {}ms", response.size(),
+            entry.key_.first, ttl.count());
+
+  // DnsResponse is not assignable.
+  entry.response_.clear();
+  entry.response_.insert(entry.response_.end(), response.begin(), response.end());
+  entry.resolved_ = true;
+  entry.used_ = false;
+  entry.expiry_ = dispatcher_.timeSource().monotonicTime() + ttl;
+  // Failed resolutions are not prefetched, nor are responses which are not cached at all. The
+  // timer removes them once they expire.
+  entry.timer_->enableTimer(response.empty() || ttl.count() == 0
+                                ? ttl
+                                : std::chrono::milliseconds(ttl.count() * prefetch_percent_ / 100));
+
+  // The callbacks may cancel the other queries.
+  while (!entry.pending_queries_.empty()) {
+    PendingQueryPtr query = entry.pending_queries_.front()->removeFromList(entry.pending_queries_);
+    query->callback_(std::list<DnsResponse>(response));
+  }
+}
+
+void CachingDnsResolverImpl::onTimer(Entry& entry) {
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  if (now < entry.expiry_) {
+    if (entry.used_ && !entry.response_.empty()) {
+      ENVOY_LOG(trace, "dns resolver cache: prefetching {}", entry.key_.first);
+      stats_.prefetch_.inc();
+      startResolution(entry);
+    } else {
+      entry.timer_->enableTimer(
+          std::chrono::duration_cast<std::chrono::milliseconds>(entry.expiry_ - now));
+    }
+    return;
+  }
+
+  ENVOY_LOG(trace, "dns resolver cache: {} expired", entry.key_.first);
+  stats_.expired_.inc();
+  removeEntry(entry);
+}
+
+ActiveDnsQuery* CachingDnsResolverImpl::addPendingQuery(Entry& entry, ResolveCb callback) {
+  PendingQueryPtr query = std::make_unique<PendingQuery>(entry, std::move(callback));
+  ActiveDnsQuery* handle = query.get();
+  query->moveIntoList(std::move(query), entry.pending_queries_);
+  return handle;
+}
+
+void CachingDnsResolverImpl::PendingQuery::cancel() {
+  // The query to the resolver is kept, so that its response is cached.
+  PendingQueryPtr removed = removeFromList(entry_.pending_queries_);
+}
+
+CachingDnsResolverImpl::Entry::Entry(CachingDnsResolverImpl& parent, const Key& key)
+    : parent_(parent), key_(key),
+      timer_(parent.dispatcher_.createTimer([this]() -> void { parent_.onTimer(*this); })) {}
+
+CachingDnsResolverImpl::Entry::~Entry() {
+  if (resolving_) {
+    active_query_->cancel();
+  }
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "envoy/common/time.h"
+#include "envoy/config/bootstrap/v2/bootstrap.pb.h"
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/network/dns.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/linked_object.h"
+#include "common/common/logger.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * All DNS resolver cache stats. @see stats_macros.h
+ */
+#define ALL_DNS_RESOLVER_CACHE_STATS(COUNTER, GAUGE)                                               \
+  COUNTER(coalesced)                                                                               \
+  COUNTER(evicted)                                                                                 \
+  COUNTER(expired)                                                                                 \
+  COUNTER(hit)                                                                                     \
+  COUNTER(miss)                                                                                    \
+  COUNTER(negative_hit)                                                                            \
+  COUNTER(prefetch)                                                                                \
+  GAUGE(entries, NeverImport)
+
+/**
+ * Struct definition for all DNS resolver cache stats. @see stats_macros.h
+ */
+struct DnsResolverCacheStats {
+  ALL_DNS_RESOLVER_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * A DNS resolver caching the responses of another one for their TTL, within configured bounds.
+ * Failed resolutions are cached for a shorter time, as the resolvers do not tell the names which
+ * do not exist from other failures. The entries used since they were resolved are resolved again
+ * ahead of their expiry, and the concurrent resolutions of a name share a single query. Cached
+ * responses are passed to the callbacks before resolve() returns, with their remaining TTL. All
+ * calls and callbacks happen on the thread of the dispatcher.
+ */
+class CachingDnsResolverImpl : public DnsResolver, Logger::Loggable<Logger::Id::upstream> {
+public:
+  CachingDnsResolverImpl(DnsResolverSharedPtr resolver, Event::Dispatcher& dispatcher,
+                         const envoy::config::bootstrap::v2::ClusterManager::DnsCache& config,
+                         Stats::Scope& scope);
+  ~CachingDnsResolverImpl() override;
+
+  // Network::DnsResolver
+  ActiveDnsQuery* resolve(const std::string& dns_name, DnsLookupFamily dns_lookup_family,
+                          ResolveCb callback) override;
+
+private:
+  struct Entry;
+  using EntryPtr = std::unique_ptr<Entry>;
+  using Key = std::pair<std::string, DnsLookupFamily>;
+
+  struct PendingQuery : public ActiveDnsQuery, LinkedObject<PendingQuery> {
+    PendingQuery(Entry& entry, ResolveCb callback)
+        : entry_(entry), callback_(std::move(callback)) {}
+
+    // Network::ActiveDnsQuery
+    void cancel() override;
+
+    Entry& entry_;
+    ResolveCb callback_;
+  };
+
+  using PendingQueryPtr = std::unique_ptr<PendingQuery>;
+
+  struct Entry : public Event::DeferredDeletable {
+    Entry(CachingDnsResolverImpl& parent, const Key& key);
+    ~Entry() override;
+
+    CachingDnsResolverImpl& parent_;
+    const Key key_;
+    Event::TimerPtr timer_;
+    // The query to the resolver, while resolving_ is set.
+    ActiveDnsQuery* active_query_{};
+    bool resolving_{};
+    // The queries waiting for the first response, or for a response to replace an expired one.
+    std::list<PendingQueryPtr> pending_queries_;
+    // The latest response, empty for failed resolutions, which is valid until expiry_.
+    std::list<DnsResponse> response_;
+    bool resolved_{};
+    MonotonicTime expiry_;
+    // Whether the response was used since it was received, and so should be prefetched.
+    bool used_{};
+    std::list<Entry*>::iterator lru_position_;
+  };
+
+  Entry& createEntry(const Key& key);
+  void removeEntry(Entry& entry);
+  void startResolution(Entry& entry);
+  void onResolved(Entry& entry, std::list<DnsResponse>&& response);
+  void onTimer(Entry& entry);
+  ActiveDnsQuery* addPendingQuery(Entry& entry, ResolveCb callback);
+
+  DnsResolverSharedPtr resolver_;
+  Event::Dispatcher& dispatcher_;
+  DnsResolverCacheStats stats_;
+  const uint32_t max_entries_;
+  const std::chrono::milliseconds min_ttl_;
+  const std::chrono::milliseconds max_ttl_;
+  const std::chrono::milliseconds negative_ttl_;
+  const uint32_t prefetch_percent_;
+  absl::flat_hash_map<Key, EntryPtr> entries_;
+  // The entries, the most recently used first.
+  std::list<Entry*> lru_;
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,40 @@
+#include "common/network/connection_balancer_impl.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Network {
+
+void ExactConnectionBalancerImpl::registerHandler(BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&lock_);
+  handlers_.push_back(&handler);
+}
+
+void ExactConnectionBalancerImpl::unregisterHandler(BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&lock_);
+  auto it = std::find(handlers_.begin(), handlers_.end(), &handler);
+  ASSERT(it != handlers_.end());
+  handlers_.erase(it);
+}
+
+BalancedConnectionHandler&
+ExactConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler& current_handler) {
+  absl::MutexLock lock(&lock_);
+  // Ties go to the current handler so that an even load does not cause needless posts.
+  BalancedConnectionHandler* min_connection_handler = &current_handler;
+  for (BalancedConnectionHandler* handler : handlers_) {
+    if (handler->numConnections() < min_connection_handler->numConnections()) {
+      min_connection_handler = handler;
+    }
+  }
+  // Count the socket before releasing the lock so that concurrent picks see it.
+  if (min_connection_handler != &current_handler) {
+    min_connection_handler->incNumConnections();
+  }
+  return *min_connection_handler;
+}
+
+} // namespace Network
+} // namespace Envoy
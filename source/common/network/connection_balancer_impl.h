@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+
+#include "envoy/network/connection_balancer.h"
+
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * A balancer that hands each accepted connection to the handler with the fewest connections. All
+ * workers take a shared lock for each accepted connection, so this is meant for listeners with
+ * long-lived connections and a modest accept rate, where keeping the workers even matters more
+ * than the cost of the lock and of posting the socket to another worker.
+ */
+class ExactConnectionBalancerImpl : public ConnectionBalancer {
+public:
+  // ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler& handler) override;
+  void unregisterHandler(BalancedConnectionHandler& handler) override;
+  BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override;
+
+private:
+  absl::Mutex lock_;
+  std::vector<BalancedConnectionHandler*> handlers_ GUARDED_BY(lock_);
+};
+
+/**
+ * A balancer that leaves each connection on the worker that accepted it.
+ */
+class NopConnectionBalancerImpl : public ConnectionBalancer {
+public:
+  // ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler&) override {}
+  void unregisterHandler(BalancedConnectionHandler&) override {}
+  BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override {
+    return current_handler;
+  }
+};
+
+} // namespace Network
+} // namespace Envoy
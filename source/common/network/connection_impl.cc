@@ -5,6 +5,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <memory>
@@ -43,6 +44,9 @@ void ConnectionImplUtility::updateBufferStats(uint64_t delta, uint64_t new_total
 }
 
 std::atomic<uint64_t> ConnectionImpl::next_global_id_;
+constexpr uint64_t ConnectionImpl::DefaultReadSize;
+constexpr uint64_t ConnectionImpl::MinReadSize;
+constexpr uint64_t ConnectionImpl::MaxReadSize;
 
 ConnectionImpl::ConnectionImpl(Event::Dispatcher& dispatcher, ConnectionSocketPtr&& socket,
                                TransportSocketPtr&& transport_socket, bool connected)
@@ -194,6 +198,8 @@ void ConnectionImpl::closeSocket(ConnectionEvent close_type) {
   updateReadBufferStats(0, 0);
   updateWriteBufferStats(0, 0);
   connection_stats_.reset();
+  read_budget_stats_.reset();
+  read_budget_ = 0;
 
   file_event_.reset();
   socket_->close();
@@ -436,6 +442,50 @@ void ConnectionImpl::setBufferLimits(uint32_t limit) {
   }
 }
 
+void ConnectionImpl::setReadBudget(uint32_t bytes, const ReadBudgetStats& stats) {
+  read_budget_ = bytes;
+  if (bytes == 0) {
+    read_budget_stats_.reset();
+    max_read_size_ = DefaultReadSize;
+    read_size_ = DefaultReadSize;
+    return;
+  }
+
+  read_budget_stats_ = std::make_unique<ReadBudgetStats>(stats);
+  // A single read should not be able to overrun the budget by more than the minimum read size.
+  max_read_size_ = std::max(MinReadSize, std::min<uint64_t>(MaxReadSize, bytes));
+  read_size_ = std::min(read_size_, max_read_size_);
+}
+
+bool ConnectionImpl::shouldDrainReadBuffer() {
+  if (read_buffer_limit_ > 0 && read_buffer_.length() >= read_buffer_limit_) {
+    return true;
+  }
+  if (read_budget_ > 0 && read_buffer_.length() >= read_event_start_size_ + read_budget_) {
+    read_budget_exhausted_ = true;
+    return true;
+  }
+  return false;
+}
+
+void ConnectionImpl::updateReadSize(uint64_t num_read) {
+  if (read_budget_exhausted_) {
+    read_budget_exhausted_ = false;
+    read_budget_stats_->read_budget_yield_.inc();
+  }
+
+  // An event that needed more than one read of the current size grows the read size, and an event
+  // that did not fill a quarter of one read shrinks it. Events that read nothing, e.g. on remote
+  // close, say nothing about the read pattern.
+  if (num_read > read_size_ && read_size_ < max_read_size_) {
+    read_size_ = std::min(read_size_ * 2, max_read_size_);
+    read_budget_stats_->read_size_grow_.inc();
+  } else if (num_read > 0 && num_read < read_size_ / 4 && read_size_ > MinReadSize) {
+    read_size_ = std::max(read_size_ / 2, MinReadSize);
+    read_budget_stats_->read_size_shrink_.inc();
+  }
+}
+
 void ConnectionImpl::onLowWatermark() {
   ENVOY_CONN_LOG(debug, "onBelowWriteBufferLowWatermark", *this);
   ASSERT(above_high_watermark_);
@@ -497,9 +547,13 @@ void ConnectionImpl::onReadReady() {
 
   ASSERT(!connecting_);
 
+  read_event_start_size_ = read_buffer_.length();
   IoResult result = transport_socket_->doRead(read_buffer_);
   uint64_t new_buffer_size = read_buffer_.length();
   updateReadBufferStats(result.bytes_processed_, new_buffer_size);
+  if (read_budget_ > 0) {
+    updateReadSize(result.bytes_processed_);
+  }
 
   // If this connection doesn't have half-close semantics, translate end_stream into
   // a connection close.
@@ -86,8 +86,12 @@ public:
   void write(Buffer::Instance& data, bool end_stream) override;
   void setBufferLimits(uint32_t limit) override;
   uint32_t bufferLimit() const override { return read_buffer_limit_; }
+  void setReadBudget(uint32_t bytes, const ReadBudgetStats& stats) override;
   bool localAddressRestored() const override { return socket_->localAddressRestored(); }
   bool aboveHighWatermark() const override { return above_high_watermark_; }
+  uint64_t bufferedBytes() const override {
+    return read_buffer_.length() + write_buffer_->length();
+  }
   const ConnectionSocket::OptionsSharedPtr& socketOptions() const override {
     return socket_->options();
   }
@@ -112,15 +116,19 @@ public:
   Connection& connection() override { return *this; }
   void raiseEvent(ConnectionEvent event) override;
   // Should the read buffer be drained?
-  bool shouldDrainReadBuffer() override {
-    return read_buffer_limit_ > 0 && read_buffer_.length() >= read_buffer_limit_;
-  }
+  bool shouldDrainReadBuffer() override;
   // Mark read buffer ready to read in the event loop. This is used when yielding following
   // shouldDrainReadBuffer().
   // TODO(htuch): While this is the basis for also yielding to other connections to provide some
   // fair sharing of CPU resources, the underlying event loop does not make any fairness guarantees.
   // Reconsider how to make fairness happen.
   void setReadBufferReady() override { file_event_->activate(Event::FileReadyType::Read); }
+  uint64_t readSizeHint() override { return read_size_; }
+
+  // Bounds of the adaptive read size. 16K is the size used when there is no read budget.
+  static constexpr uint64_t DefaultReadSize = 16384;
+  static constexpr uint64_t MinReadSize = 4096;
+  static constexpr uint64_t MaxReadSize = 262144;
 
   // Obtain global next connection ID. This should only be used in tests.
   static uint64_t nextGlobalIdForTest() { return next_global_id_; }
@@ -168,6 +176,7 @@ private:
   void onWriteReady();
   void updateReadBufferStats(uint64_t num_read, uint64_t new_size);
   void updateWriteBufferStats(uint64_t num_written, uint64_t new_size);
+  void updateReadSize(uint64_t num_read);
 
   // Write data to the connection bypassing filter chain (optionally).
   void write(Buffer::Instance& data, bool end_stream, bool through_filter_chain);
@@ -215,6 +224,14 @@ private:
   uint64_t last_read_buffer_size_{};
   uint64_t last_write_buffer_size_{};
   std::unique_ptr<ConnectionStats> connection_stats_;
+  // @see setReadBudget(). read_event_start_size_ is the read buffer size when the current read
+  // event started.
+  uint32_t read_budget_{0};
+  uint64_t max_read_size_{DefaultReadSize};
+  uint64_t read_size_{DefaultReadSize};
+  uint64_t read_event_start_size_{0};
+  bool read_budget_exhausted_{false};
+  std::unique_ptr<ReadBudgetStats> read_budget_stats_;
   // Tracks the number of times reads have been disabled. If N different components call
   // readDisabled(true) this allows the connection to only resume reads when readDisabled(false)
   // has been called N times.
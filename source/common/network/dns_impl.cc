@@ -81,9 +81,10 @@ void DnsResolverImpl::PendingResolution::onAresGetAddrInfoCallback(int status, i
 
   std::list<DnsResponse> address_list;
   if (status == ARES_SUCCESS) {
-    if (addrinfo != nullptr && addrinfo->nodes != nullptr) {
-      if (addrinfo->nodes->ai_family == AF_INET) {
-        for (const ares_addrinfo_node* ai = addrinfo->nodes; ai != nullptr; ai = ai->ai_next) {
+    if (addrinfo != nullptr) {
+      // Each node is parsed by its own family, as both are returned for an AF_UNSPEC lookup.
+      for (const ares_addrinfo_node* ai = addrinfo->nodes; ai != nullptr; ai = ai->ai_next) {
+        if (ai->ai_family == AF_INET) {
           sockaddr_in address;
           memset(&address, 0, sizeof(address));
           address.sin_family = AF_INET;
@@ -93,9 +94,7 @@ void DnsResolverImpl::PendingResolution::onAresGetAddrInfoCallback(int status, i
           address_list.emplace_back(
               DnsResponse(std::make_shared<const Address::Ipv4Instance>(&address),
                           std::chrono::seconds(ai->ai_ttl)));
-        }
-      } else if (addrinfo->nodes->ai_family == AF_INET6) {
-        for (const ares_addrinfo_node* ai = addrinfo->nodes; ai != nullptr; ai = ai->ai_next) {
+        } else if (ai->ai_family == AF_INET6) {
           sockaddr_in6 address;
           memset(&address, 0, sizeof(address));
           address.sin6_family = AF_INET6;
@@ -205,6 +204,8 @@ ActiveDnsQuery* DnsResolverImpl::resolve(const std::string& dns_name,
 
   if (dns_lookup_family == DnsLookupFamily::V4Only) {
     pending_resolution->getAddrInfo(AF_INET);
+  } else if (dns_lookup_family == DnsLookupFamily::All) {
+    pending_resolution->getAddrInfo(AF_UNSPEC);
   } else {
     pending_resolution->getAddrInfo(AF_INET6);
   }
@@ -0,0 +1,303 @@
+#include "common/network/happy_eyeballs_connection_impl.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Network {
+
+constexpr std::chrono::milliseconds HappyEyeballsConnectionImpl::ConnectionAttemptDelay;
+
+HappyEyeballsConnectionImpl::Attempt::Attempt(HappyEyeballsConnectionImpl& parent,
+                                              ClientConnectionPtr&& connection)
+    : parent_(parent), connection_(std::move(connection)) {
+  connection_->addConnectionCallbacks(*this);
+}
+
+void HappyEyeballsConnectionImpl::Attempt::onEvent(ConnectionEvent event) {
+  if (!detached_) {
+    parent_.onAttemptEvent(*this, event);
+  }
+}
+
+void HappyEyeballsConnectionImpl::Attempt::onAboveWriteBufferHighWatermark() {
+  if (parent_.attempt_kept_ == this) {
+    for (ConnectionCallbacks* callbacks : parent_.callbacks_) {
+      callbacks->onAboveWriteBufferHighWatermark();
+    }
+  }
+}
+
+void HappyEyeballsConnectionImpl::Attempt::onBelowWriteBufferLowWatermark() {
+  if (parent_.attempt_kept_ == this) {
+    for (ConnectionCallbacks* callbacks : parent_.callbacks_) {
+      callbacks->onBelowWriteBufferLowWatermark();
+    }
+  }
+}
+
+HappyEyeballsConnectionImpl::HappyEyeballsConnectionImpl(
+    Event::Dispatcher& dispatcher, const std::vector<Address::InstanceConstSharedPtr>& address_list,
+    ConnectionFactory factory)
+    : dispatcher_(dispatcher), address_list_(sortAddresses(address_list)),
+      factory_(std::move(factory)),
+      next_attempt_timer_(dispatcher.createTimer([this]() -> void { startNextAttempt(); })) {
+  ASSERT(!address_list_.empty());
+  attempts_.emplace_back(
+      std::make_unique<Attempt>(*this, factory_(address_list_[next_address_++])));
+  id_ = attempts_.front()->connection_->id();
+}
+
+HappyEyeballsConnectionImpl::~HappyEyeballsConnectionImpl() {
+  // The attempt kept is closed by the owner of the connection, as any connection is.
+  for (AttemptPtr& attempt : attempts_) {
+    if (attempt.get() != attempt_kept_ && attempt->connection_->state() != State::Closed) {
+      attempt->detached_ = true;
+      attempt->connection_->close(ConnectionCloseType::NoFlush);
+    }
+  }
+}
+
+std::vector<Address::InstanceConstSharedPtr> HappyEyeballsConnectionImpl::sortAddresses(
+    const std::vector<Address::InstanceConstSharedPtr>& address_list) {
+  std::vector<Address::InstanceConstSharedPtr> ipv6_addresses;
+  std::vector<Address::InstanceConstSharedPtr> other_addresses;
+  for (const auto& address : address_list) {
+    if (address->ip() != nullptr && address->ip()->version() == Address::IpVersion::v6) {
+      ipv6_addresses.push_back(address);
+    } else {
+      other_addresses.push_back(address);
+    }
+  }
+
+  std::vector<Address::InstanceConstSharedPtr> sorted;
+  sorted.reserve(address_list.size());
+  for (size_t i = 0; i < std::max(ipv6_addresses.size(), other_addresses.size()); i++) {
+    if (i < ipv6_addresses.size()) {
+      sorted.push_back(ipv6_addresses[i]);
+    }
+    if (i < other_addresses.size()) {
+      sorted.push_back(other_addresses[i]);
+    }
+  }
+  return sorted;
+}
+
+void HappyEyeballsConnectionImpl::connect() {
+  ENVOY_CONN_LOG(debug, "connecting to {}, out of {} addresses", *this,
+                 address_list_.front()->asString(), address_list_.size());
+  attempts_.front()->connection_->connect();
+  if (next_address_ < address_list_.size()) {
+    next_attempt_timer_->enableTimer(ConnectionAttemptDelay);
+  }
+}
+
+void HappyEyeballsConnectionImpl::startNextAttempt() {
+  ASSERT(attempt_kept_ == nullptr && next_address_ < address_list_.size());
+  const Address::InstanceConstSharedPtr& address = address_list_[next_address_++];
+  ENVOY_CONN_LOG(debug, "starting connection attempt to {}", *this, address->asString());
+  attempts_.emplace_back(std::make_unique<Attempt>(*this, factory_(address)));
+  attempts_.back()->connection_->connect();
+  if (next_address_ < address_list_.size()) {
+    next_attempt_timer_->enableTimer(ConnectionAttemptDelay);
+  }
+}
+
+void HappyEyeballsConnectionImpl::onAttemptEvent(Attempt& attempt, ConnectionEvent event) {
+  if (attempt_kept_ == nullptr) {
+    if (event == ConnectionEvent::Connected) {
+      ENVOY_CONN_LOG(debug, "connected to {}", *this,
+                     attempt.connection_->remoteAddress()->asString());
+      keepAttempt(attempt);
+      replayOnConnectionKept();
+    } else if (attempts_.size() == 1 && next_address_ == address_list_.size()) {
+      // The last attempt failed, and its failure is that of the connection.
+      keepAttempt(attempt);
+    } else {
+      ENVOY_CONN_LOG(debug, "connection attempt to {} failed", *this,
+                     attempt.connection_->remoteAddress()->asString());
+      auto it = std::find_if(attempts_.begin(), attempts_.end(),
+                             [&attempt](const AttemptPtr& item) { return item.get() == &attempt; });
+      ASSERT(it != attempts_.end());
+      // The connection raising the event is deleted once it is done with it.
+      dispatcher_.deferredDelete(std::move(*it));
+      attempts_.erase(it);
+      if (next_address_ < address_list_.size()) {
+        startNextAttempt();
+      }
+      return;
+    }
+  }
+
+  ASSERT(&attempt == attempt_kept_);
+  for (ConnectionCallbacks* callbacks : callbacks_) {
+    callbacks->onEvent(event);
+  }
+}
+
+void HappyEyeballsConnectionImpl::keepAttempt(Attempt& attempt) {
+  next_attempt_timer_->disableTimer();
+  attempt_kept_ = &attempt;
+  for (auto it = attempts_.begin(); it != attempts_.end();) {
+    if (it->get() == &attempt) {
+      ++it;
+      continue;
+    }
+    AttemptPtr lost = std::move(*it);
+    it = attempts_.erase(it);
+    closeAttempt(std::move(lost));
+  }
+}
+
+void HappyEyeballsConnectionImpl::closeAttempt(AttemptPtr&& attempt) {
+  attempt->detached_ = true;
+  attempt->connection_->close(ConnectionCloseType::NoFlush);
+  dispatcher_.deferredDelete(std::move(attempt));
+}
+
+void HappyEyeballsConnectionImpl::replayOnConnectionKept() {
+  ClientConnection& connection = *attempt_kept_->connection_;
+  for (const auto& call : recorded_calls_) {
+    call(connection);
+  }
+  recorded_calls_.clear();
+  for (uint32_t i = 0; i < read_disable_count_; i++) {
+    connection.readDisable(true);
+  }
+  if (pending_write_buffer_.length() > 0 || pending_end_stream_) {
+    connection.write(pending_write_buffer_, pending_end_stream_);
+  }
+}
+
+void HappyEyeballsConnectionImpl::callOrRecord(std::function<void(ClientConnection&)> call) {
+  if (attempt_kept_ != nullptr) {
+    call(*attempt_kept_->connection_);
+  } else {
+    recorded_calls_.push_back(std::move(call));
+  }
+}
+
+ClientConnection& HappyEyeballsConnectionImpl::connection() const {
+  return attempt_kept_ != nullptr ? *attempt_kept_->connection_ : *attempts_.front()->connection_;
+}
+
+void HappyEyeballsConnectionImpl::addWriteFilter(WriteFilterSharedPtr filter) {
+  callOrRecord([filter](ClientConnection& connection) { connection.addWriteFilter(filter); });
+}
+
+void HappyEyeballsConnectionImpl::addFilter(FilterSharedPtr filter) {
+  read_filters_added_ = true;
+  callOrRecord([filter](ClientConnection& connection) { connection.addFilter(filter); });
+}
+
+void HappyEyeballsConnectionImpl::addReadFilter(ReadFilterSharedPtr filter) {
+  read_filters_added_ = true;
+  callOrRecord([filter](ClientConnection& connection) { connection.addReadFilter(filter); });
+}
+
+bool HappyEyeballsConnectionImpl::initializeReadFilters() {
+  if (attempt_kept_ != nullptr) {
+    return attempt_kept_->connection_->initializeReadFilters();
+  }
+  recorded_calls_.push_back(
+      [](ClientConnection& connection) { connection.initializeReadFilters(); });
+  return read_filters_added_;
+}
+
+void HappyEyeballsConnectionImpl::addBytesSentCallback(BytesSentCb cb) {
+  callOrRecord([cb](ClientConnection& connection) { connection.addBytesSentCallback(cb); });
+}
+
+void HappyEyeballsConnectionImpl::enableHalfClose(bool enabled) {
+  callOrRecord([enabled](ClientConnection& connection) { connection.enableHalfClose(enabled); });
+}
+
+void HappyEyeballsConnectionImpl::close(ConnectionCloseType type) {
+  if (attempt_kept_ == nullptr) {
+    // No attempt connected yet: the first one in flight is kept for its close event to be that of
+    // the connection.
+    keepAttempt(*attempts_.front());
+  }
+  attempt_kept_->connection_->close(type);
+}
+
+void HappyEyeballsConnectionImpl::noDelay(bool enable) {
+  callOrRecord([enable](ClientConnection& connection) { connection.noDelay(enable); });
+}
+
+void HappyEyeballsConnectionImpl::readDisable(bool disable) {
+  if (attempt_kept_ != nullptr) {
+    attempt_kept_->connection_->readDisable(disable);
+  } else if (disable) {
+    read_disable_count_++;
+  } else {
+    ASSERT(read_disable_count_ > 0);
+    read_disable_count_--;
+  }
+}
+
+void HappyEyeballsConnectionImpl::detectEarlyCloseWhenReadDisabled(bool should_detect) {
+  callOrRecord([should_detect](ClientConnection& connection) {
+    connection.detectEarlyCloseWhenReadDisabled(should_detect);
+  });
+}
+
+bool HappyEyeballsConnectionImpl::readEnabled() const {
+  return attempt_kept_ != nullptr ? attempt_kept_->connection_->readEnabled()
+                                  : read_disable_count_ == 0;
+}
+
+void HappyEyeballsConnectionImpl::setConnectionStats(const ConnectionStats& stats) {
+  callOrRecord([stats](ClientConnection& connection) { connection.setConnectionStats(stats); });
+}
+
+Connection::State HappyEyeballsConnectionImpl::state() const {
+  return attempt_kept_ != nullptr ? attempt_kept_->connection_->state() : State::Open;
+}
+
+void HappyEyeballsConnectionImpl::write(Buffer::Instance& data, bool end_stream) {
+  if (attempt_kept_ != nullptr) {
+    attempt_kept_->connection_->write(data, end_stream);
+    return;
+  }
+  pending_write_buffer_.move(data);
+  pending_end_stream_ = end_stream;
+}
+
+void HappyEyeballsConnectionImpl::setBufferLimits(uint32_t limit) {
+  buffer_limit_ = limit;
+  callOrRecord([limit](ClientConnection& connection) { connection.setBufferLimits(limit); });
+}
+
+uint32_t HappyEyeballsConnectionImpl::bufferLimit() const {
+  return attempt_kept_ != nullptr ? attempt_kept_->connection_->bufferLimit() : buffer_limit_;
+}
+
+void HappyEyeballsConnectionImpl::setReadBudget(uint32_t bytes, const ReadBudgetStats& stats) {
+  callOrRecord(
+      [bytes, stats](ClientConnection& connection) { connection.setReadBudget(bytes, stats); });
+}
+
+bool HappyEyeballsConnectionImpl::aboveHighWatermark() const {
+  return attempt_kept_ != nullptr && attempt_kept_->connection_->aboveHighWatermark();
+}
+
+uint64_t HappyEyeballsConnectionImpl::bufferedBytes() const {
+  return attempt_kept_ != nullptr ? attempt_kept_->connection_->bufferedBytes()
+                                  : pending_write_buffer_.length();
+}
+
+void HappyEyeballsConnectionImpl::setDelayedCloseTimeout(std::chrono::milliseconds timeout) {
+  delayed_close_timeout_ = timeout;
+  callOrRecord(
+      [timeout](ClientConnection& connection) { connection.setDelayedCloseTimeout(timeout); });
+}
+
+std::chrono::milliseconds HappyEyeballsConnectionImpl::delayedCloseTimeout() const {
+  return attempt_kept_ != nullptr ? attempt_kept_->connection_->delayedCloseTimeout()
+                                  : delayed_close_timeout_;
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/network/connection.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * A client connection to a host resolved to several addresses, which races connection attempts
+ * across them as described by RFC 8305 (Happy Eyeballs). The addresses are interleaved by family,
+ * starting with IPv6. The next attempt starts when the previous one has not connected within
+ * ConnectionAttemptDelay, or as soon as it fails. The first attempt to connect is kept and the
+ * others are closed.
+ *
+ * The connection callbacks only see the events of the attempt kept. The filters, settings and data
+ * written before then are recorded, and replayed on the attempt kept once it connects. The filters
+ * are thus installed on the connection of the attempt, which their callbacks refer to.
+ */
+class HappyEyeballsConnectionImpl : public ClientConnection,
+                                    Logger::Loggable<Logger::Id::connection> {
+public:
+  /**
+   * Creates the connection of an attempt, not yet connected, to the given address.
+   */
+  using ConnectionFactory =
+      std::function<ClientConnectionPtr(const Address::InstanceConstSharedPtr& address)>;
+
+  // The Connection Attempt Delay recommended by RFC 8305.
+  static constexpr std::chrono::milliseconds ConnectionAttemptDelay{250};
+
+  /**
+   * @param address_list supplies the addresses of the host, at least one.
+   * @param factory supplies the factory of the connections of the attempts. It is only called
+   *        while the connection is connecting.
+   */
+  HappyEyeballsConnectionImpl(Event::Dispatcher& dispatcher,
+                              const std::vector<Address::InstanceConstSharedPtr>& address_list,
+                              ConnectionFactory factory);
+  ~HappyEyeballsConnectionImpl() override;
+
+  /**
+   * @return the addresses in the order they are attempted: alternating between the IPv6 and the
+   *         other addresses, starting with IPv6, each family keeping its resolution order.
+   */
+  static std::vector<Address::InstanceConstSharedPtr>
+  sortAddresses(const std::vector<Address::InstanceConstSharedPtr>& address_list);
+
+  // Network::ClientConnection
+  void connect() override;
+
+  // Network::FilterManager
+  void addWriteFilter(WriteFilterSharedPtr filter) override;
+  void addFilter(FilterSharedPtr filter) override;
+  void addReadFilter(ReadFilterSharedPtr filter) override;
+  bool initializeReadFilters() override;
+
+  // Network::Connection
+  void addConnectionCallbacks(ConnectionCallbacks& cb) override { callbacks_.push_back(&cb); }
+  void addBytesSentCallback(BytesSentCb cb) override;
+  void enableHalfClose(bool enabled) override;
+  void close(ConnectionCloseType type) override;
+  Event::Dispatcher& dispatcher() override { return dispatcher_; }
+  uint64_t id() const override { return id_; }
+  std::string nextProtocol() const override { return connection().nextProtocol(); }
+  void noDelay(bool enable) override;
+  void readDisable(bool disable) override;
+  void detectEarlyCloseWhenReadDisabled(bool should_detect) override;
+  bool readEnabled() const override;
+  const Address::InstanceConstSharedPtr& remoteAddress() const override {
+    return connection().remoteAddress();
+  }
+  absl::optional<UnixDomainSocketPeerCredentials> unixSocketPeerCredentials() const override {
+    return connection().unixSocketPeerCredentials();
+  }
+  const Address::InstanceConstSharedPtr& localAddress() const override {
+    return connection().localAddress();
+  }
+  void setConnectionStats(const ConnectionStats& stats) override;
+  const Ssl::ConnectionInfo* ssl() const override { return connection().ssl(); }
+  const IoHandle& ioHandle() const override { return connection().ioHandle(); }
+  absl::string_view requestedServerName() const override {
+    return connection().requestedServerName();
+  }
+  State state() const override;
+  void write(Buffer::Instance& data, bool end_stream) override;
+  void setBufferLimits(uint32_t limit) override;
+  uint32_t bufferLimit() const override;
+  void setReadBudget(uint32_t bytes, const ReadBudgetStats& stats) override;
+  bool localAddressRestored() const override { return connection().localAddressRestored(); }
+  bool aboveHighWatermark() const override;
+  uint64_t bufferedBytes() const override;
+  const ConnectionSocket::OptionsSharedPtr& socketOptions() const override {
+    return connection().socketOptions();
+  }
+  StreamInfo::StreamInfo& streamInfo() override { return connection().streamInfo(); }
+  const StreamInfo::StreamInfo& streamInfo() const override { return connection().streamInfo(); }
+  void setDelayedCloseTimeout(std::chrono::milliseconds timeout) override;
+  std::chrono::milliseconds delayedCloseTimeout() const override;
+  absl::string_view transportFailureReason() const override {
+    return connection().transportFailureReason();
+  }
+
+private:
+  /**
+   * A connection attempt, observing the events of its connection.
+   */
+  class Attempt : public ConnectionCallbacks, public Event::DeferredDeletable {
+  public:
+    Attempt(HappyEyeballsConnectionImpl& parent, ClientConnectionPtr&& connection);
+
+    // Network::ConnectionCallbacks
+    void onEvent(ConnectionEvent event) override;
+    void onAboveWriteBufferHighWatermark() override;
+    void onBelowWriteBufferLowWatermark() override;
+
+    HappyEyeballsConnectionImpl& parent_;
+    ClientConnectionPtr connection_;
+    // Set once the attempt lost the race, after which its events are ignored.
+    bool detached_{};
+  };
+
+  using AttemptPtr = std::unique_ptr<Attempt>;
+
+  // The connection of the attempt kept, or of the first attempt in flight before then.
+  ClientConnection& connection() const;
+  void startNextAttempt();
+  void onAttemptEvent(Attempt& attempt, ConnectionEvent event);
+  // Keeps the given attempt, closing the others.
+  void keepAttempt(Attempt& attempt);
+  // Closes an attempt which lost the race, without raising its events.
+  void closeAttempt(AttemptPtr&& attempt);
+  // Replays the filters, settings and data recorded before the attempt kept connected.
+  void replayOnConnectionKept();
+  // Makes a call on the connection of the attempt kept, or records it to be replayed on it.
+  void callOrRecord(std::function<void(ClientConnection&)> call);
+
+  Event::Dispatcher& dispatcher_;
+  const std::vector<Address::InstanceConstSharedPtr> address_list_;
+  const ConnectionFactory factory_;
+  // The id of the first attempt, which the connection keeps whichever attempt wins.
+  uint64_t id_{};
+  size_t next_address_{};
+  Event::TimerPtr next_attempt_timer_;
+  std::list<AttemptPtr> attempts_;
+  Attempt* attempt_kept_{};
+  std::list<ConnectionCallbacks*> callbacks_;
+
+  // The state recorded before an attempt is kept.
+  std::vector<std::function<void(ClientConnection&)>> recorded_calls_;
+  bool read_filters_added_{};
+  uint32_t read_disable_count_{};
+  uint32_t buffer_limit_{};
+  std::chrono::milliseconds delayed_close_timeout_{};
+  Buffer::OwnedImpl pending_write_buffer_;
+  bool pending_end_stream_{};
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -12,6 +12,7 @@ Api::IoError::IoErrorCode IoSocketError::getErrorCode() const {
            "Didn't use getIoSocketEagainInstance() to generate `Again`.");
     return IoErrorCode::Again;
   case ENOTSUP:
+  case ENOSYS:
     return IoErrorCode::NoSupport;
   case EAFNOSUPPORT:
     return IoErrorCode::AddressFamilyNoSupport;
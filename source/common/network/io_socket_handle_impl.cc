@@ -1,11 +1,13 @@
 #include "common/network/io_socket_handle_impl.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <iostream>
 
 #include "envoy/buffer/buffer.h"
 
 #include "common/api/os_sys_calls_impl.h"
+#include "common/common/macros.h"
 #include "common/common/stack_array.h"
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_error_impl.h"
@@ -82,6 +84,45 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendto(const Buffer::RawSlice& slice
   return sysCallResultToIoCallResult(result);
 }
 
+namespace {
+
+// The control message space needed to set the source address of a message, for both IPv4 and
+// IPv6. FreeBSD only needs in_addr size, but allocates more to unify code in two platforms.
+constexpr size_t selfIpControlMessageSpace() {
+  return std::max(CMSG_SPACE(sizeof(in_pktinfo)), CMSG_SPACE(sizeof(in6_pktinfo)));
+}
+
+// Sets the source address of a message in its control message buffer, which must be
+// selfIpControlMessageSpace() zeroed bytes.
+void setSelfIpControlMessage(msghdr& message, const Address::Ip& self_ip) {
+  cmsghdr* const cmsg = CMSG_FIRSTHDR(&message);
+  RELEASE_ASSERT(cmsg != nullptr, fmt::format("cbuf with size {} is not enough, cmsghdr size {}",
+                                              message.msg_controllen, sizeof(cmsghdr)));
+  if (self_ip.version() == Address::IpVersion::v4) {
+    cmsg->cmsg_level = IPPROTO_IP;
+#ifndef IP_SENDSRCADDR
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+    cmsg->cmsg_type = IP_PKTINFO;
+    auto pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
+    pktinfo->ipi_ifindex = 0;
+    pktinfo->ipi_spec_dst.s_addr = self_ip.ipv4()->address();
+#else
+    cmsg->cmsg_type = IP_SENDSRCADDR;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in_addr));
+    *(reinterpret_cast<struct in_addr*>(CMSG_DATA(cmsg))).s_addr = self_ip.ipv4()->address();
+#endif
+  } else if (self_ip.version() == Address::IpVersion::v6) {
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
+    cmsg->cmsg_level = IPPROTO_IPV6;
+    cmsg->cmsg_type = IPV6_PKTINFO;
+    auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
+    pktinfo->ipi6_ifindex = 0;
+    *(reinterpret_cast<absl::uint128*>(pktinfo->ipi6_addr.s6_addr)) = self_ip.ipv6()->address();
+  }
+}
+
+} // namespace
+
 Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slices,
                                                     uint64_t num_slice, int flags,
                                                     const Address::Ip* self_ip,
@@ -115,45 +156,59 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slic
     const Api::SysCallSizeResult result = os_syscalls.sendmsg(fd_, &message, flags);
     return sysCallResultToIoCallResult(result);
   } else {
-    const size_t space_v6 = CMSG_SPACE(sizeof(in6_pktinfo));
-    // FreeBSD only needs in_addr size, but allocates more to unify code in two platforms.
-    const size_t space_v4 = CMSG_SPACE(sizeof(in_pktinfo));
-    const size_t cmsg_space = (space_v4 < space_v6) ? space_v6 : space_v4;
-    // kSpaceForIp should be big enough to hold both IPv4 and IPv6 packet info.
-    STACK_ARRAY(cbuf, char, cmsg_space);
-    memset(cbuf.begin(), 0, cmsg_space);
-
-    message.msg_control = cbuf.begin();
-    message.msg_controllen = cmsg_space * sizeof(char);
-    cmsghdr* const cmsg = CMSG_FIRSTHDR(&message);
-    RELEASE_ASSERT(cmsg != nullptr, fmt::format("cbuf with size {} is not enough, cmsghdr size {}",
-                                                sizeof(cbuf), sizeof(cmsghdr)));
-    if (self_ip->version() == Address::IpVersion::v4) {
-      cmsg->cmsg_level = IPPROTO_IP;
-#ifndef IP_SENDSRCADDR
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
-      cmsg->cmsg_type = IP_PKTINFO;
-      auto pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
-      pktinfo->ipi_ifindex = 0;
-      pktinfo->ipi_spec_dst.s_addr = self_ip->ipv4()->address();
-#else
-      cmsg->cmsg_type = IP_SENDSRCADDR;
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in_addr));
-      *(reinterpret_cast<struct in_addr*>(CMSG_DATA(cmsg))).s_addr = self_ip->ipv4()->address();
-#endif
-    } else if (self_ip->version() == Address::IpVersion::v6) {
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
-      cmsg->cmsg_level = IPPROTO_IPV6;
-      cmsg->cmsg_type = IPV6_PKTINFO;
-      auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
-      pktinfo->ipi6_ifindex = 0;
-      *(reinterpret_cast<absl::uint128*>(pktinfo->ipi6_addr.s6_addr)) = self_ip->ipv6()->address();
-    }
+    alignas(cmsghdr) char cbuf[selfIpControlMessageSpace()] = {};
+    message.msg_control = cbuf;
+    message.msg_controllen = sizeof(cbuf);
+    setSelfIpControlMessage(message, *self_ip);
     const Api::SysCallSizeResult result = os_syscalls.sendmsg(fd_, &message, flags);
     return sysCallResultToIoCallResult(result);
   }
 }
 
+Api::IoCallUint64Result IoSocketHandleImpl::sendmmsg(const Buffer::RawSlice* datagrams,
+                                                     uint64_t num_datagrams, int flags,
+                                                     const Address::Ip* self_ip,
+                                                     const Address::Instance& peer_address) {
+#if defined(__linux__)
+  ASSERT(num_datagrams > 0);
+  const auto* address_base = dynamic_cast<const Address::InstanceBase*>(&peer_address);
+  sockaddr* sock_addr = const_cast<sockaddr*>(address_base->sockAddr());
+
+  // All the datagrams have the same source address, so they share one control message.
+  alignas(cmsghdr) char cbuf[selfIpControlMessageSpace()] = {};
+  STACK_ARRAY(iov, iovec, num_datagrams);
+  STACK_ARRAY(mmsg_hdrs, mmsghdr, num_datagrams);
+  for (uint64_t i = 0; i < num_datagrams; i++) {
+    iov[i].iov_base = datagrams[i].mem_;
+    iov[i].iov_len = datagrams[i].len_;
+    msghdr& message = mmsg_hdrs[i].msg_hdr;
+    message.msg_name = reinterpret_cast<void*>(sock_addr);
+    message.msg_namelen = address_base->sockAddrLen();
+    message.msg_iov = &iov[i];
+    message.msg_iovlen = 1;
+    message.msg_flags = 0;
+    message.msg_control = self_ip == nullptr ? nullptr : cbuf;
+    message.msg_controllen = self_ip == nullptr ? 0 : sizeof(cbuf);
+    mmsg_hdrs[i].msg_len = 0;
+  }
+  if (self_ip != nullptr) {
+    setSelfIpControlMessage(mmsg_hdrs[0].msg_hdr, *self_ip);
+  }
+
+  auto& os_syscalls = Api::OsSysCallsSingleton::get();
+  const SysCallIntResult result =
+      os_syscalls.sendmmsg(fd_, mmsg_hdrs.begin(), num_datagrams, flags);
+  return sysCallResultToIoCallResult(SysCallSizeResult{result.rc_, result.errno_});
+#else
+  UNREFERENCED_PARAMETER(datagrams);
+  UNREFERENCED_PARAMETER(num_datagrams);
+  UNREFERENCED_PARAMETER(flags);
+  UNREFERENCED_PARAMETER(self_ip);
+  UNREFERENCED_PARAMETER(peer_address);
+  return sysCallResultToIoCallResult(SysCallSizeResult{-1, ENOSYS});
+#endif
+}
+
 Api::IoCallUint64Result
 IoSocketHandleImpl::sysCallResultToIoCallResult(const Api::SysCallSizeResult& result) {
   if (result.rc_ >= 0) {
@@ -218,46 +273,8 @@ absl::optional<uint32_t> maybeGetPacketsDroppedFromHeader(
   return absl::nullopt;
 }
 
-Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
-                                                    const uint64_t num_slice, uint32_t self_port,
-                                                    RecvMsgOutput& output) {
-
-  // The minimum cmsg buffer size to filled in destination address and packets dropped when
-  // receiving a packet. It is possible for a received packet to contain both IPv4 and IPv6
-  // addresses.
-  const size_t cmsg_space = CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(struct in_pktinfo)) +
-                            CMSG_SPACE(sizeof(struct in6_pktinfo));
-  STACK_ARRAY(cbuf, char, cmsg_space);
-  memset(cbuf.begin(), 0, cmsg_space);
-
-  STACK_ARRAY(iov, iovec, num_slice);
-  uint64_t num_slices_for_read = 0;
-  for (uint64_t i = 0; i < num_slice; i++) {
-    if (slices[i].mem_ != nullptr && slices[i].len_ != 0) {
-      iov[num_slices_for_read].iov_base = slices[i].mem_;
-      iov[num_slices_for_read].iov_len = slices[i].len_;
-      ++num_slices_for_read;
-    }
-  }
-
-  sockaddr_storage peer_addr;
-  msghdr hdr;
-  hdr.msg_name = &peer_addr;
-  hdr.msg_namelen = sizeof(sockaddr_storage);
-  hdr.msg_iov = iov.begin();
-  hdr.msg_iovlen = num_slices_for_read;
-  hdr.msg_flags = 0;
-
-  auto cmsg = reinterpret_cast<struct cmsghdr*>(cbuf.begin());
-  cmsg->cmsg_len = cmsg_space;
-  hdr.msg_control = cmsg;
-  hdr.msg_controllen = cmsg_space;
-  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
-  const Api::SysCallSizeResult result = os_sys_calls.recvmsg(fd_, &hdr, 0);
-  if (result.rc_ < 0) {
-    return sysCallResultToIoCallResult(result);
-  }
-
+void IoSocketHandleImpl::parseReceivedMessage(msghdr& hdr, const sockaddr_storage& peer_addr,
+                                              uint32_t self_port, RecvMsgOutput& output) {
   RELEASE_ASSERT((hdr.msg_flags & MSG_CTRUNC) == 0,
                  fmt::format("Incorrectly set control message length: {}", hdr.msg_controllen));
   RELEASE_ASSERT(hdr.msg_namelen > 0,
@@ -301,8 +318,101 @@ Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
       }
     }
   }
+}
+
+Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
+                                                    const uint64_t num_slice, uint32_t self_port,
+                                                    RecvMsgOutput& output) {
+
+  // The minimum cmsg buffer size to filled in destination address and packets dropped when
+  // receiving a packet. It is possible for a received packet to contain both IPv4 and IPv6
+  // addresses.
+  const size_t cmsg_space = CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(struct in_pktinfo)) +
+                            CMSG_SPACE(sizeof(struct in6_pktinfo));
+  STACK_ARRAY(cbuf, char, cmsg_space);
+  memset(cbuf.begin(), 0, cmsg_space);
+
+  STACK_ARRAY(iov, iovec, num_slice);
+  uint64_t num_slices_for_read = 0;
+  for (uint64_t i = 0; i < num_slice; i++) {
+    if (slices[i].mem_ != nullptr && slices[i].len_ != 0) {
+      iov[num_slices_for_read].iov_base = slices[i].mem_;
+      iov[num_slices_for_read].iov_len = slices[i].len_;
+      ++num_slices_for_read;
+    }
+  }
+
+  sockaddr_storage peer_addr;
+  msghdr hdr;
+  hdr.msg_name = &peer_addr;
+  hdr.msg_namelen = sizeof(sockaddr_storage);
+  hdr.msg_iov = iov.begin();
+  hdr.msg_iovlen = num_slices_for_read;
+  hdr.msg_flags = 0;
+
+  auto cmsg = reinterpret_cast<struct cmsghdr*>(cbuf.begin());
+  cmsg->cmsg_len = cmsg_space;
+  hdr.msg_control = cmsg;
+  hdr.msg_controllen = cmsg_space;
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const Api::SysCallSizeResult result = os_sys_calls.recvmsg(fd_, &hdr, 0);
+  if (result.rc_ < 0) {
+    return sysCallResultToIoCallResult(result);
+  }
+
+  parseReceivedMessage(hdr, peer_addr, self_port, output);
   return sysCallResultToIoCallResult(result);
 }
 
+Api::IoCallUint64Result IoSocketHandleImpl::recvmmsg(Buffer::RawSlice* slices,
+                                                     uint64_t num_packets, uint32_t self_port,
+                                                     RecvMsgOutput* outputs) {
+#if defined(__linux__)
+  ASSERT(num_packets > 0);
+  // See recvmsg() for the control message buffer size.
+  const size_t cmsg_space = CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(struct in_pktinfo)) +
+                            CMSG_SPACE(sizeof(struct in6_pktinfo));
+  STACK_ARRAY(cbuf, char, cmsg_space * num_packets);
+  memset(cbuf.begin(), 0, cmsg_space * num_packets);
+  STACK_ARRAY(iov, iovec, num_packets);
+  STACK_ARRAY(peer_addrs, sockaddr_storage, num_packets);
+  STACK_ARRAY(mmsg_hdrs, mmsghdr, num_packets);
+  for (uint64_t i = 0; i < num_packets; i++) {
+    iov[i].iov_base = slices[i].mem_;
+    iov[i].iov_len = slices[i].len_;
+    msghdr& hdr = mmsg_hdrs[i].msg_hdr;
+    hdr.msg_name = &peer_addrs[i];
+    hdr.msg_namelen = sizeof(sockaddr_storage);
+    hdr.msg_iov = &iov[i];
+    hdr.msg_iovlen = 1;
+    hdr.msg_flags = 0;
+    auto cmsg = reinterpret_cast<struct cmsghdr*>(cbuf.begin() + i * cmsg_space);
+    cmsg->cmsg_len = cmsg_space;
+    hdr.msg_control = cmsg;
+    hdr.msg_controllen = cmsg_space;
+    mmsg_hdrs[i].msg_len = 0;
+  }
+
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const SysCallIntResult result =
+      os_sys_calls.recvmmsg(fd_, mmsg_hdrs.begin(), num_packets, 0, nullptr);
+  if (result.rc_ < 0) {
+    return sysCallResultToIoCallResult(SysCallSizeResult{result.rc_, result.errno_});
+  }
+
+  for (int i = 0; i < result.rc_; i++) {
+    slices[i].len_ = std::min(slices[i].len_, static_cast<size_t>(mmsg_hdrs[i].msg_len));
+    parseReceivedMessage(mmsg_hdrs[i].msg_hdr, peer_addrs[i], self_port, outputs[i]);
+  }
+  return sysCallResultToIoCallResult(SysCallSizeResult{result.rc_, 0});
+#else
+  UNREFERENCED_PARAMETER(slices);
+  UNREFERENCED_PARAMETER(num_packets);
+  UNREFERENCED_PARAMETER(self_port);
+  UNREFERENCED_PARAMETER(outputs);
+  return sysCallResultToIoCallResult(SysCallSizeResult{-1, ENOSYS});
+#endif
+}
+
 } // namespace Network
 } // namespace Envoy
@@ -38,13 +38,24 @@ public:
                                   const Address::Ip* self_ip,
                                   const Address::Instance& peer_address) override;
 
+  Api::IoCallUint64Result sendmmsg(const Buffer::RawSlice* datagrams, uint64_t num_datagrams,
+                                   int flags, const Address::Ip* self_ip,
+                                   const Address::Instance& peer_address) override;
+
   Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                   uint32_t self_port, RecvMsgOutput& output) override;
 
+  Api::IoCallUint64Result recvmmsg(Buffer::RawSlice* slices, uint64_t num_packets,
+                                   uint32_t self_port, RecvMsgOutput* outputs) override;
+
 private:
   // Converts a SysCallSizeResult to IoCallUint64Result.
   Api::IoCallUint64Result sysCallResultToIoCallResult(const Api::SysCallSizeResult& result);
 
+  // Fills in output from the peer address and control messages of a received message.
+  void parseReceivedMessage(msghdr& hdr, const sockaddr_storage& peer_addr, uint32_t self_port,
+                            RecvMsgOutput& output);
+
   int fd_;
 };
 
@@ -10,10 +10,12 @@
 #include "envoy/network/address.h"
 
 #include "common/common/assert.h"
+#include "common/common/macros.h"
 #include "common/network/address_impl.h"
 #include "common/network/cidr_range.h"
 #include "common/network/utility.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/numeric/int128.h"
 #include "fmt/format.h"
 
@@ -178,9 +180,11 @@ public:
    * @param  ip_address supplies the IP address.
    * @return a vector of data from the CIDR ranges and IP addresses that contains 'ip_address'. An
    * empty vector is returned if no prefix contains 'ip_address' or there is no data for the IP
-   * version of the ip_address.
+   * version of the ip_address. The vector is owned by the trie, and remains valid as long as the
+   * trie does, so lookups do not allocate.
    */
-  std::vector<T> getData(const Network::Address::InstanceConstSharedPtr& ip_address) const {
+  const std::vector<T>&
+  getData(const Network::Address::InstanceConstSharedPtr& ip_address) const {
     if (ip_address->ip()->version() == Address::IpVersion::v4) {
       Ipv4 ip = ntohl(ip_address->ip()->ipv4()->address());
       return ipv4_trie_->getData(ip);
@@ -230,6 +234,33 @@ private:
   using Ipv4 = uint32_t;
   using Ipv6 = absl::uint128;
 
+  /**
+   * Extract the n bits of a branch, starting at position p, while walking the trie.
+   * @param p supplies the position.
+   * @param n supplies the number of bits to extract, between 1 and 31.
+   * @param input supplies the IP address to extract bits from, in host byte order.
+   * @return the extracted bits.
+   */
+  static uint32_t extractBranchBits(uint32_t p, uint32_t n, Ipv4 input) {
+    return static_cast<uint32_t>(extractBits<Ipv4>(p, n, input));
+  }
+  static uint32_t extractBranchBits(uint32_t p, uint32_t n, const Ipv6& input) {
+    // Most branches fall within one half of the address, where 64-bit shifts are enough; the
+    // 128-bit shifts are only needed for the branches straddling both halves.
+    if (p + n <= 64) {
+      return static_cast<uint32_t>(absl::Uint128High64(input) << p >> (64 - n));
+    }
+    if (p >= 64) {
+      return static_cast<uint32_t>(absl::Uint128Low64(input) << (p - 64) >> (64 - n));
+    }
+    return static_cast<uint32_t>(extractBits<Ipv6>(p, n, input));
+  }
+
+  /**
+   * @return the empty data returned by lookups which match no prefix.
+   */
+  static const std::vector<T>& emptyData() { CONSTRUCT_ON_FIRST_USE(std::vector<T>); }
+
   using DataSet = std::unordered_set<T>;
   using DataSetSharedPtr = std::shared_ptr<DataSet>;
 
@@ -430,7 +461,7 @@ private:
      * @return a vector of data from the CIDR ranges and IP addresses that encompasses the input.
      * An empty vector is returned if the LC Trie is empty.
      */
-    std::vector<T> getData(const IpType& ip_address) const;
+    const std::vector<T>& getData(const IpType& ip_address) const;
 
   private:
     /**
@@ -454,8 +485,38 @@ private:
       ASSERT(next_free_index <= trie_.size());
       trie_.resize(next_free_index);
       trie_.shrink_to_fit();
+
+      // The prefixes are only needed to build the trie. Lookups check the compact leaves_
+      // instead, whose data sets are interned: the leaves pushed from the same nested prefixes
+      // have the same data, which is kept once.
+      absl::flat_hash_map<DataSet, uint32_t, DataSetHash> data_set_indexes;
+      leaves_.reserve(ip_prefixes_.size());
+      for (const auto& prefix : ip_prefixes_) {
+        auto it = data_set_indexes.find(prefix.data_);
+        if (it == data_set_indexes.end()) {
+          it = data_set_indexes.emplace(prefix.data_, data_sets_.size()).first;
+          data_sets_.emplace_back(prefix.data_.begin(), prefix.data_.end());
+        }
+        leaves_.push_back({prefix.ip_, prefix.length_, it->second});
+      }
+      data_sets_.shrink_to_fit();
+      ip_prefixes_.clear();
+      ip_prefixes_.shrink_to_fit();
     }
 
+    /**
+     * Hash of a DataSet which does not depend on the iteration order of its elements.
+     */
+    struct DataSetHash {
+      size_t operator()(const DataSet& data_set) const {
+        size_t hash = data_set.size();
+        for (const auto& data : data_set) {
+          hash += std::hash<T>()(data);
+        }
+        return hash;
+      }
+    };
+
     // Thin wrapper around computeBranch output to facilitate code readability.
     struct ComputePair {
       ComputePair(int branch, int prefix) : branch_(branch), prefix_(prefix) {}
@@ -678,12 +739,32 @@ private:
       uint32_t address_ : 20; // If this 20-bit size changes, please change MaxLcTrieNodes too.
     };
 
+    /**
+     * The CIDR range of a leaf of the trie, and the index of its data in data_sets_.
+     */
+    struct LcLeaf {
+      bool contains(const IpType& address) const {
+        return (extractBits<IpType, address_size>(0, length_, ip_) ==
+                extractBits<IpType, address_size>(0, length_, address));
+      }
+
+      IpType ip_;
+      uint32_t length_;
+      uint32_t data_index_;
+    };
+
+    // The sorted CIDR ranges and data the trie is built from, released once it is built.
+    std::vector<IpPrefix<IpType>> ip_prefixes_;
+
     // The CIDR range and data needs to be maintained separately from the LC-Trie. A LC-Trie skips
     // chunks of data while searching for a match. This means that the node found in the LC-Trie
     // is not guaranteed to have the IP address in range. The last step prior to returning
     // associated data is to check the CIDR range pointed to by the node in the LC-Trie has
     // the IP address in range.
-    std::vector<IpPrefix<IpType>> ip_prefixes_;
+    std::vector<LcLeaf> leaves_;
+
+    // The distinct data sets of the leaves.
+    std::vector<std::vector<T>> data_sets_;
 
     // Main trie search structure.
     std::vector<LcNode> trie_;
@@ -707,11 +788,10 @@ LcTrie<T>::LcTrieInternal<IpType, address_size>::LcTrieInternal(std::vector<IpPr
 
 template <class T>
 template <class IpType, uint32_t address_size>
-std::vector<T>
+const std::vector<T>&
 LcTrie<T>::LcTrieInternal<IpType, address_size>::getData(const IpType& ip_address) const {
-  std::vector<T> return_vector;
   if (trie_.empty()) {
-    return return_vector;
+    return emptyData();
   }
 
   LcNode node = trie_[0];
@@ -721,10 +801,8 @@ LcTrie<T>::LcTrieInternal<IpType, address_size>::getData(const IpType& ip_addres
 
   // branch == 0 is a leaf node.
   while (branch != 0) {
-    // branch is at most 2^5-1= 31 bits to extract, so we can safely cast the
-    // output of extractBits to uint32_t without any data loss.
-    node = trie_[address + static_cast<uint32_t>(
-                               extractBits<IpType, address_size>(position, branch, ip_address))];
+    // branch is at most 2^5-1= 31 bits to extract, so the bits fit in a uint32_t.
+    node = trie_[address + extractBranchBits(position, branch, ip_address)];
     position += branch + node.skip_;
     branch = node.branch_;
     address = node.address_;
@@ -733,11 +811,11 @@ LcTrie<T>::LcTrieInternal<IpType, address_size>::getData(const IpType& ip_addres
   // The path taken through the trie to match the ip_address may have contained skips,
   // so it is necessary to check whether the matched prefix really contains the
   // ip_address.
-  const auto& prefix = ip_prefixes_[address];
-  if (prefix.contains(ip_address)) {
-    return std::vector<T>(prefix.data_.begin(), prefix.data_.end());
+  const LcLeaf& leaf = leaves_[address];
+  if (leaf.contains(ip_address)) {
+    return data_sets_[leaf.data_index_];
   }
-  return std::vector<T>();
+  return emptyData();
 }
 
 } // namespace LcTrie
@@ -18,6 +18,7 @@
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_error_impl.h"
 
+#include "absl/container/inlined_vector.h"
 #include "event2/listener.h"
 
 #define ENVOY_UDP_LOG(LEVEL, FORMAT, ...)                                                          \
@@ -75,16 +76,38 @@ void UdpListenerImpl::handleReadCallback() {
   // TODO(danzh) make this variable configurable to support jumbo frames.
   const uint64_t read_buffer_length = MAX_UDP_PACKET_SIZE;
   do {
-    Buffer::InstancePtr buffer = std::make_unique<Buffer::OwnedImpl>();
-    Buffer::RawSlice slice;
-    const uint64_t num_slices = buffer->reserve(read_buffer_length, &slice, 1);
-    ASSERT(num_slices == 1);
+    const uint64_t num_packets = use_recvmmsg_ ? NUM_PACKETS_PER_READ : 1;
+    Buffer::RawSlice slices[NUM_PACKETS_PER_READ];
+    for (uint64_t i = 0; i < num_packets; i++) {
+      // Buffers which did not receive a packet in the previous read are reused.
+      if (read_buffers_[i] == nullptr) {
+        read_buffers_[i] = std::make_unique<Buffer::OwnedImpl>();
+      }
+      const uint64_t num_slices = read_buffers_[i]->reserve(read_buffer_length, &slices[i], 1);
+      ASSERT(num_slices == 1);
+    }
 
-    IoHandle::RecvMsgOutput output(&packets_dropped_);
+    absl::InlinedVector<IoHandle::RecvMsgOutput, NUM_PACKETS_PER_READ> outputs(
+        num_packets, IoHandle::RecvMsgOutput(&packets_dropped_));
     uint32_t old_packets_dropped = packets_dropped_;
     MonotonicTime receive_time = time_source_.monotonicTime();
-    Api::IoCallUint64Result result = socket_.ioHandle().recvmsg(
-        &slice, num_slices, socket_.localAddress()->ip()->port(), output);
+    const uint32_t self_port = socket_.localAddress()->ip()->port();
+    Api::IoCallUint64Result result = Api::ioCallUint64ResultNoError();
+    uint64_t packets_received;
+    if (use_recvmmsg_) {
+      result = socket_.ioHandle().recvmmsg(slices, num_packets, self_port, outputs.data());
+      if (!result.ok() && result.err_->getErrorCode() == Api::IoError::IoErrorCode::NoSupport) {
+        ENVOY_UDP_LOG(debug, "recvmmsg is not supported, falling back to recvmsg");
+        use_recvmmsg_ = false;
+        continue;
+      }
+      packets_received = result.rc_;
+    } else {
+      result = socket_.ioHandle().recvmsg(&slices[0], 1, self_port, outputs[0]);
+      // Adjust used memory length.
+      slices[0].len_ = std::min(slices[0].len_, static_cast<size_t>(result.rc_));
+      packets_received = 1;
+    }
 
     if (!result.ok()) {
       // No more to read or encountered a system error.
@@ -98,14 +121,6 @@ void UdpListenerImpl::handleReadCallback() {
       return;
     }
 
-    if (result.rc_ == 0) {
-      // TODO(conqerAtapple): Is zero length packet interesting? If so add stats
-      // for it. Otherwise remove the warning log below.
-      ENVOY_UDP_LOG(trace, "received 0-length packet");
-    }
-
-    RELEASE_ASSERT(output.local_address_ != nullptr, "fail to get local address from IP header");
-
     if (packets_dropped_ != old_packets_dropped) {
       // The kernel tracks SO_RXQ_OVFL as a uint32 which can overflow to a smaller
       // value. So as long as this count differs from previously recorded value,
@@ -119,27 +134,46 @@ void UdpListenerImpl::handleReadCallback() {
                     delta);
     }
 
-    // Adjust used memory length.
-    slice.len_ = std::min(slice.len_, static_cast<size_t>(result.rc_));
-    buffer->commit(&slice, 1);
+    // Deliver the packets in the order they were received.
+    for (uint64_t i = 0; i < packets_received; i++) {
+      processPacket(std::move(read_buffers_[i]), slices[i], outputs[i], receive_time);
+    }
 
-    ENVOY_UDP_LOG(trace, "recvmsg bytes {}", result.rc_);
+    if (packets_received < num_packets) {
+      // The socket has been drained.
+      return;
+    }
+  } while (true);
+}
 
-    RELEASE_ASSERT(output.peer_address_ != nullptr,
-                   fmt::format("Unable to get remote address for fd: {}, local address: {} ",
-                               socket_.ioHandle().fd(), socket_.localAddress()->asString()));
+void UdpListenerImpl::processPacket(Buffer::InstancePtr buffer, Buffer::RawSlice& slice,
+                                    IoHandle::RecvMsgOutput& output, MonotonicTime receive_time) {
+  if (slice.len_ == 0) {
+    // TODO(conqerAtapple): Is zero length packet interesting? If so add stats
+    // for it. Otherwise remove the warning log below.
+    ENVOY_UDP_LOG(trace, "received 0-length packet");
+  }
 
-    // Unix domain sockets are not supported
-    RELEASE_ASSERT(output.peer_address_->type() == Address::Type::Ip,
-                   fmt::format("Unsupported remote address: {} local address: {}, receive size: "
-                               "{}",
-                               output.peer_address_->asString(), socket_.localAddress()->asString(),
-                               result.rc_));
+  RELEASE_ASSERT(output.local_address_ != nullptr, "fail to get local address from IP header");
 
-    UdpRecvData recvData{std::move(output.local_address_), std::move(output.peer_address_),
-                         std::move(buffer), receive_time};
-    cb_.onData(recvData);
-  } while (true);
+  buffer->commit(&slice, 1);
+
+  ENVOY_UDP_LOG(trace, "recvmsg bytes {}", slice.len_);
+
+  RELEASE_ASSERT(output.peer_address_ != nullptr,
+                 fmt::format("Unable to get remote address for fd: {}, local address: {} ",
+                             socket_.ioHandle().fd(), socket_.localAddress()->asString()));
+
+  // Unix domain sockets are not supported
+  RELEASE_ASSERT(output.peer_address_->type() == Address::Type::Ip,
+                 fmt::format("Unsupported remote address: {} local address: {}, receive size: "
+                             "{}",
+                             output.peer_address_->asString(), socket_.localAddress()->asString(),
+                             slice.len_));
+
+  UdpRecvData recvData{std::move(output.local_address_), std::move(output.peer_address_),
+                       std::move(buffer), receive_time};
+  cb_.onData(recvData);
 }
 
 void UdpListenerImpl::handleWriteCallback() {
@@ -184,5 +218,53 @@ Api::IoCallUint64Result UdpListenerImpl::send(const UdpSendData& send_data) {
   return send_result;
 }
 
+Api::IoCallUint64Result UdpListenerImpl::sendBatch(const UdpSendBatchData& send_data) {
+  ENVOY_UDP_LOG(trace, "sendBatch of {} packets", send_data.num_packets_);
+  uint64_t packets_sent = 0;
+  while (packets_sent < send_data.num_packets_) {
+    const Buffer::RawSlice* packets = send_data.packets_ + packets_sent;
+    const uint64_t num_packets = send_data.num_packets_ - packets_sent;
+    Api::IoCallUint64Result send_result = Api::ioCallUint64ResultNoError();
+    if (use_sendmmsg_) {
+      send_result = socket_.ioHandle().sendmmsg(packets, num_packets, 0, send_data.local_ip_,
+                                                send_data.peer_address_);
+      if (!send_result.ok() &&
+          send_result.err_->getErrorCode() == Api::IoError::IoErrorCode::NoSupport) {
+        ENVOY_UDP_LOG(debug, "sendmmsg is not supported, falling back to sendmsg");
+        use_sendmmsg_ = false;
+        continue;
+      }
+    } else {
+      send_result =
+          socket_.ioHandle().sendmsg(packets, 1, 0, send_data.local_ip_, send_data.peer_address_);
+      if (send_result.ok()) {
+        ASSERT(send_result.rc_ == packets[0].len_);
+        send_result.rc_ = 1;
+      }
+    }
+
+    if (!send_result.ok()) {
+      if (send_result.err_->getErrorCode() == Api::IoError::IoErrorCode::Interrupt) {
+        // Send again if interrupted.
+        continue;
+      }
+      ENVOY_UDP_LOG(debug, "sendmmsg failed after {} packets with error code {}: {}",
+                    packets_sent, static_cast<int>(send_result.err_->getErrorCode()),
+                    send_result.err_->getErrorDetails());
+      send_result.rc_ = packets_sent;
+      return send_result;
+    }
+    if (send_result.rc_ == 0) {
+      // Nothing was sent without an error, which leaves the rest to be retried by the sender.
+      break;
+    }
+    packets_sent += send_result.rc_;
+  }
+
+  ENVOY_UDP_LOG(trace, "sendBatch sent:{} packets", packets_sent);
+  return Api::IoCallUint64Result(packets_sent,
+                                 Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+}
+
 } // namespace Network
 } // namespace Envoy
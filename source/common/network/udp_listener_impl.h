@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 
 #include "envoy/common/time.h"
@@ -33,8 +34,12 @@ public:
   Event::Dispatcher& dispatcher() override;
   const Address::InstanceConstSharedPtr& localAddress() const override;
   Api::IoCallUint64Result send(const UdpSendData& data) override;
+  Api::IoCallUint64Result sendBatch(const UdpSendBatchData& data) override;
 
 protected:
+  // Number of packets read with each recvmmsg() call.
+  static constexpr uint64_t NUM_PACKETS_PER_READ = 16;
+
   void handleWriteCallback();
   void handleReadCallback();
 
@@ -43,9 +48,17 @@ protected:
 
 private:
   void onSocketEvent(short flags);
+  void processPacket(Buffer::InstancePtr buffer, Buffer::RawSlice& slice,
+                     IoHandle::RecvMsgOutput& output, MonotonicTime receive_time);
 
   TimeSource& time_source_;
   Event::FileEventPtr file_event_;
+  // Cleared if the platform can not receive multiple packets with one system call.
+  bool use_recvmmsg_{true};
+  // Cleared if the platform can not send multiple packets with one system call.
+  bool use_sendmmsg_{true};
+  // Receive buffers, each of which is handed off with the packet read into it.
+  std::array<Buffer::InstancePtr, NUM_PACKETS_PER_READ> read_buffers_;
 };
 
 } // namespace Network
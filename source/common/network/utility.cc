@@ -4,6 +4,7 @@
 #include <ifaddrs.h>
 
 #if defined(__linux__)
+#include <linux/filter.h>
 #include <linux/netfilter_ipv4.h>
 #endif
 
@@ -13,6 +14,7 @@
 #endif
 
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sys/socket.h>
 
 #include <cstdint>
@@ -395,6 +397,25 @@ Address::InstanceConstSharedPtr Utility::getOriginalDst(int fd) {
 #endif
 }
 
+absl::optional<TcpInfo> Utility::getTcpInfo(int fd) {
+#ifdef TCP_INFO
+  struct tcp_info info;
+  socklen_t info_len = sizeof(info);
+  if (Api::OsSysCallsSingleton::get().getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &info_len).rc_ !=
+      0) {
+    return absl::nullopt;
+  }
+  TcpInfo tcp_info;
+  tcp_info.rtt_ = std::chrono::microseconds(info.tcpi_rtt);
+  tcp_info.rtt_var_ = std::chrono::microseconds(info.tcpi_rttvar);
+  tcp_info.total_retransmits_ = info.tcpi_total_retrans;
+  return tcp_info;
+#else
+  UNREFERENCED_PARAMETER(fd);
+  return absl::nullopt;
+#endif
+}
+
 void Utility::parsePortRangeList(absl::string_view string, std::list<PortRange>& list) {
   const auto ranges = StringUtil::splitToken(string, ",");
   for (const auto& s : ranges) {
@@ -506,5 +527,38 @@ Utility::protobufAddressSocketType(const envoy::api::v2::core::Address& proto_ad
   }
 }
 
+void Utility::steerReusePortByCpu(const std::vector<SocketSharedPtr>& sockets) {
+  ASSERT(!sockets.empty());
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+  for (const auto& socket : sockets) {
+    // This is the backlog libevent uses, so it does not change when the worker listens again.
+    if (socket->socketType() == Address::SocketType::Stream &&
+        ::listen(socket->ioHandle().fd(), 128) != 0) {
+      throw EnvoyException(fmt::format("cannot listen on {}: {}",
+                                       socket->localAddress()->asString(), strerror(errno)));
+    }
+  }
+
+  sock_filter code[] = {
+      // A = the CPU that processed the packet.
+      BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)),
+      // A = A % the number of sockets.
+      BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, static_cast<uint32_t>(sockets.size())),
+      // Select the socket at index A.
+      BPF_STMT(BPF_RET | BPF_A, 0),
+  };
+  sock_fprog program{sizeof(code) / sizeof(code[0]), code};
+  const Api::SysCallIntResult result = Api::OsSysCallsSingleton::get().setsockopt(
+      sockets[0]->ioHandle().fd(), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program));
+  if (result.rc_ != 0) {
+    throw EnvoyException(fmt::format("cannot attach reuse port CPU steering program on {}: {}",
+                                     sockets[0]->localAddress()->asString(),
+                                     strerror(result.errno_)));
+  }
+#else
+  throw EnvoyException("reuse port CPU steering is not supported on this platform");
+#endif
+}
+
 } // namespace Network
 } // namespace Envoy
@@ -1,13 +1,17 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <list>
 #include <string>
+#include <vector>
 
 #include "envoy/api/v2/core/address.pb.h"
 #include "envoy/network/connection.h"
+#include "envoy/network/listen_socket.h"
 
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Network {
@@ -28,6 +32,17 @@ private:
 
 using PortRangeList = std::list<PortRange>;
 
+/**
+ * The state of a TCP connection which the kernel keeps up to date, as sampled from TCP_INFO.
+ */
+struct TcpInfo {
+  // The smoothed round trip time, and its mean deviation.
+  std::chrono::microseconds rtt_{};
+  std::chrono::microseconds rtt_var_{};
+  // The segments retransmitted over the life of the connection.
+  uint32_t total_retransmits_{};
+};
+
 /**
  * Common network utility routines.
  */
@@ -206,6 +221,15 @@ public:
    */
   static Address::InstanceConstSharedPtr getOriginalDst(int fd);
 
+  /**
+   * Samples the TCP state of a connected socket. This is a single getsockopt() call, cheap enough
+   * to be made periodically on every connection.
+   * @param fd supplies the descriptor of the socket.
+   * @return the state of the connection, or absl::nullopt if the socket is not a TCP socket or the
+   *         platform does not support TCP_INFO.
+   */
+  static absl::optional<TcpInfo> getTcpInfo(int fd);
+
   /**
    * Parses a string containing a comma-separated list of port numbers and/or
    * port ranges and appends the values to a caller-provided list of PortRange structures.
@@ -258,6 +282,16 @@ public:
   static Address::SocketType
   protobufAddressSocketType(const envoy::api::v2::core::Address& proto_address);
 
+  /**
+   * Makes the kernel pick the socket of a SO_REUSEPORT group for each new connection or datagram
+   * by the CPU that processed its first packet: the socket at that CPU's index modulo the number
+   * of sockets. The kernel orders the group by when stream sockets start listening, so stream
+   * sockets are put in listening state here, in order.
+   * @param sockets supplies the bound SO_REUSEPORT sockets of the group, in steering order.
+   * @throw EnvoyException if the sockets can not listen or the program can not be attached.
+   */
+  static void steerReusePortByCpu(const std::vector<SocketSharedPtr>& sockets);
+
 private:
   static void throwWithMalformedIp(const std::string& ip_address);
 
@@ -10,12 +10,29 @@
 namespace Envoy {
 namespace Profiler {
 
+namespace {
+
+thread_local bool is_worker_thread = false;
+
+// Called from the profiling signal handler, on the thread being sampled.
+int filterWorkerThread(void*) { return is_worker_thread; }
+
+} // namespace
+
 bool Cpu::profilerEnabled() { return ProfilingIsEnabledForAllThreads(); }
 
 bool Cpu::startProfiler(const std::string& output_path) {
   return ProfilerStart(output_path.c_str());
 }
 
+bool Cpu::startWorkerProfiler(const std::string& output_path) {
+  ProfilerOptions options{};
+  options.filter_in_thread = &filterWorkerThread;
+  return ProfilerStartWithOptions(output_path.c_str(), &options);
+}
+
+void Cpu::registerWorkerThread() { is_worker_thread = true; }
+
 void Cpu::stopProfiler() { ProfilerStop(); }
 
 bool Heap::profilerEnabled() {
@@ -48,6 +65,8 @@ namespace Profiler {
 
 bool Cpu::profilerEnabled() { return false; }
 bool Cpu::startProfiler(const std::string&) { return false; }
+bool Cpu::startWorkerProfiler(const std::string&) { return false; }
+void Cpu::registerWorkerThread() {}
 void Cpu::stopProfiler() {}
 
 bool Heap::profilerEnabled() { return false; }
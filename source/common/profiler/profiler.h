@@ -28,6 +28,19 @@ public:
    */
   static bool startProfiler(const std::string& output_path);
 
+  /**
+   * Start the profiler and write to the specified path, sampling only the threads which called
+   * registerWorkerThread(). This keeps the main thread, which serves admin requests, applies xDS
+   * updates and flushes stats, out of the profile of the request path.
+   * @return bool whether the call to start the profiler succeeded.
+   */
+  static bool startWorkerProfiler(const std::string& output_path);
+
+  /**
+   * Mark the calling thread as a worker thread, to be sampled by startWorkerProfiler().
+   */
+  static void registerWorkerThread();
+
   /**
    * Stop the profiler.
    */
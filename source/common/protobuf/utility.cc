@@ -24,6 +24,68 @@ absl::string_view filenameFromPath(absl::string_view full_path) {
   return full_path.substr(index + 1, full_path.size());
 }
 
+// Checks for use of deprecated fields in message and all sub-messages, getting the runtime
+// snapshot for their deprecation status from get_snapshot.
+void checkForDeprecationImpl(const Protobuf::Message& message,
+                             const std::function<const Runtime::Snapshot*()>& get_snapshot) {
+  const Protobuf::Descriptor* descriptor = message.GetDescriptor();
+  const Protobuf::Reflection* reflection = message.GetReflection();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const auto* field = descriptor->field(i);
+
+    // If this field is not in use, continue.
+    if ((field->is_repeated() && reflection->FieldSize(message, field) == 0) ||
+        (!field->is_repeated() && !reflection->HasField(message, field))) {
+      continue;
+    }
+
+    bool warn_only = true;
+    absl::string_view filename = filenameFromPath(field->file()->name());
+    // Allow runtime to be null both to not crash if this is called before server initialization,
+    // and so proto validation works in context where runtime singleton is not set up (e.g.
+    // standalone config validation utilities)
+    if (field->options().deprecated()) {
+      const Runtime::Snapshot* snapshot = get_snapshot();
+      if (snapshot != nullptr &&
+          !snapshot->deprecatedFeatureEnabled(
+              absl::StrCat("envoy.deprecated_features.", filename, ":", field->name()))) {
+        warn_only = false;
+      }
+    }
+
+    // If this field is deprecated, warn or throw an error.
+    if (field->options().deprecated()) {
+      std::string err = fmt::format(
+          "Using deprecated option '{}' from file {}. This configuration will be removed from "
+          "Envoy soon. Please see https://www.envoyproxy.io/docs/envoy/latest/intro/deprecated "
+          "for details.",
+          field->full_name(), filename);
+      if (warn_only) {
+        ENVOY_LOG_MISC(warn, "{}", err);
+      } else {
+        const char fatal_error[] =
+            " If continued use of this field is absolutely necessary, see "
+            "https://www.envoyproxy.io/docs/envoy/latest/configuration/runtime"
+            "#using-runtime-overrides-for-deprecated-features for how to apply a temporary and "
+            "highly discouraged override.";
+        throw ProtoValidationException(err + fatal_error, message);
+      }
+    }
+
+    // If this is a message, recurse to check for deprecated fields in the sub-message.
+    if (field->cpp_type() == Protobuf::FieldDescriptor::CPPTYPE_MESSAGE) {
+      if (field->is_repeated()) {
+        const int size = reflection->FieldSize(message, field);
+        for (int j = 0; j < size; ++j) {
+          checkForDeprecationImpl(reflection->GetRepeatedMessage(message, field, j), get_snapshot);
+        }
+      } else {
+        checkForDeprecationImpl(reflection->GetMessage(message, field), get_snapshot);
+      }
+    }
+  }
+}
+
 void blockFormat(YAML::Node node) {
   node.SetStyle(YAML::EmitterStyle::Block);
 
@@ -166,59 +228,15 @@ void MessageUtil::loadFromFile(const std::string& path, Protobuf::Message& messa
 }
 
 void MessageUtil::checkForDeprecation(const Protobuf::Message& message, Runtime::Loader* runtime) {
-  const Protobuf::Descriptor* descriptor = message.GetDescriptor();
-  const Protobuf::Reflection* reflection = message.GetReflection();
-  for (int i = 0; i < descriptor->field_count(); ++i) {
-    const auto* field = descriptor->field(i);
-
-    // If this field is not in use, continue.
-    if ((field->is_repeated() && reflection->FieldSize(message, field) == 0) ||
-        (!field->is_repeated() && !reflection->HasField(message, field))) {
-      continue;
-    }
-
-    bool warn_only = true;
-    absl::string_view filename = filenameFromPath(field->file()->name());
-    // Allow runtime to be null both to not crash if this is called before server initialization,
-    // and so proto validation works in context where runtime singleton is not set up (e.g.
-    // standalone config validation utilities)
-    if (runtime && field->options().deprecated() &&
-        !runtime->snapshot().deprecatedFeatureEnabled(
-            absl::StrCat("envoy.deprecated_features.", filename, ":", field->name()))) {
-      warn_only = false;
-    }
-
-    // If this field is deprecated, warn or throw an error.
-    if (field->options().deprecated()) {
-      std::string err = fmt::format(
-          "Using deprecated option '{}' from file {}. This configuration will be removed from "
-          "Envoy soon. Please see https://www.envoyproxy.io/docs/envoy/latest/intro/deprecated "
-          "for details.",
-          field->full_name(), filename);
-      if (warn_only) {
-        ENVOY_LOG_MISC(warn, "{}", err);
-      } else {
-        const char fatal_error[] =
-            " If continued use of this field is absolutely necessary, see "
-            "https://www.envoyproxy.io/docs/envoy/latest/configuration/runtime"
-            "#using-runtime-overrides-for-deprecated-features for how to apply a temporary and "
-            "highly discouraged override.";
-        throw ProtoValidationException(err + fatal_error, message);
-      }
-    }
+  // The snapshot is only taken if a deprecated field is in use.
+  checkForDeprecationImpl(message, [runtime]() -> const Runtime::Snapshot* {
+    return runtime != nullptr ? &runtime->snapshot() : nullptr;
+  });
+}
 
-    // If this is a message, recurse to check for deprecated fields in the sub-message.
-    if (field->cpp_type() == Protobuf::FieldDescriptor::CPPTYPE_MESSAGE) {
-      if (field->is_repeated()) {
-        const int size = reflection->FieldSize(message, field);
-        for (int j = 0; j < size; ++j) {
-          checkForDeprecation(reflection->GetRepeatedMessage(message, field, j), runtime);
-        }
-      } else {
-        checkForDeprecation(reflection->GetMessage(message, field), runtime);
-      }
-    }
-  }
+void MessageUtil::checkForDeprecationWithSnapshot(const Protobuf::Message& message,
+                                                  const Runtime::Snapshot* snapshot) {
+  checkForDeprecationImpl(message, [snapshot]() { return snapshot; });
 }
 
 std::string MessageUtil::getYamlStringFromMessage(const Protobuf::Message& message,
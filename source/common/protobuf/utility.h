@@ -249,6 +249,35 @@ public:
     }
   }
 
+  /**
+   * Checks for use of deprecated fields in message and all sub-messages.
+   * @param message message to validate.
+   * @param snapshot optional a pointer to a runtime snapshot for the deprecation status. Unlike
+   *    the runtime loader, a snapshot from Runtime::Loader::threadsafeSnapshot() may be used on
+   *    any thread.
+   * @throw ProtoValidationException if deprecated fields are used and listed
+   *    in disallowed_features in runtime_features.h
+   */
+  static void checkForDeprecationWithSnapshot(const Protobuf::Message& message,
+                                              const Runtime::Snapshot* snapshot);
+
+  /**
+   * Validate protoc-gen-validate constraints on a given protobuf, checking deprecated fields
+   * against a runtime snapshot. This may be called on any thread.
+   * @param message message to validate.
+   * @param snapshot optional a pointer to a runtime snapshot for the deprecation status.
+   * @throw ProtoValidationException if the message does not satisfy its type constraints.
+   */
+  template <class MessageType>
+  static void validate(const MessageType& message, const Runtime::Snapshot* snapshot) {
+    checkForDeprecationWithSnapshot(message, snapshot);
+
+    std::string err;
+    if (!Validate(message, &err)) {
+      throw ProtoValidationException(err, message);
+    }
+  }
+
   template <class MessageType>
   static void loadFromFileAndValidate(const std::string& path, MessageType& message,
                                       ProtobufMessage::ValidationVisitor& validation_visitor) {
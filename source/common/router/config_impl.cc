@@ -29,6 +29,7 @@
 #include "common/http/utility.h"
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
+#include "common/router/per_filter_config_ids.h"
 #include "common/router/retry_state_impl.h"
 
 #include "extensions/filters/http/well_known_names.h"
@@ -39,6 +40,8 @@ namespace Envoy {
 namespace Router {
 namespace {
 
+constexpr double DefaultHedgeBudgetPercent = 10;
+
 InternalRedirectAction
 convertInternalRedirectAction(const envoy::api::v2::route::RouteAction& route) {
   switch (route.internal_redirect_action()) {
@@ -60,10 +63,17 @@ std::string SslRedirector::newPath(const Http::HeaderMap& headers) const {
 HedgePolicyImpl::HedgePolicyImpl(const envoy::api::v2::route::HedgePolicy& hedge_policy)
     : initial_requests_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(hedge_policy, initial_requests, 1)),
       additional_request_chance_(hedge_policy.additional_request_chance()),
-      hedge_on_per_try_timeout_(hedge_policy.hedge_on_per_try_timeout()) {}
+      hedge_on_per_try_timeout_(hedge_policy.hedge_on_per_try_timeout()),
+      hedge_budget_percent_(hedge_policy.has_hedge_budget() ? hedge_policy.hedge_budget().value()
+                                                            : DefaultHedgeBudgetPercent) {
+  if (hedge_policy.has_hedge_on_latency_percentile()) {
+    hedge_on_latency_percentile_ = hedge_policy.hedge_on_latency_percentile().value();
+  }
+}
 
 HedgePolicyImpl::HedgePolicyImpl()
-    : initial_requests_(1), additional_request_chance_({}), hedge_on_per_try_timeout_(false) {}
+    : initial_requests_(1), additional_request_chance_({}), hedge_on_per_try_timeout_(false),
+      hedge_budget_percent_(DefaultHedgeBudgetPercent) {}
 
 RetryPolicyImpl::RetryPolicyImpl(const envoy::api::v2::route::RetryPolicy& retry_policy,
                                  ProtobufMessage::ValidationVisitor& validation_visitor) {
@@ -152,21 +162,54 @@ CorsPolicyImpl::CorsPolicyImpl(const envoy::api::v2::route::CorsPolicy& config,
       legacy_enabled_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, enabled, true)) {
   for (const auto& origin : config.allow_origin()) {
     allow_origin_.push_back(origin);
+    allow_origin_set_.insert(origin);
   }
+  allow_any_origin_ = allow_origin_set_.contains("*");
   for (const auto& regex : config.allow_origin_regex()) {
     allow_origin_regex_.push_back(RegexUtil::parseRegex(regex));
+    if (allow_origin_regex_set_.add(regex)) {
+      set_regexes_.push_back(&allow_origin_regex_.back());
+    } else {
+      unfiltered_regexes_.push_back(&allow_origin_regex_.back());
+    }
   }
+  allow_origin_regex_set_.compile();
   if (config.has_allow_credentials()) {
     allow_credentials_ = PROTOBUF_GET_WRAPPED_REQUIRED(config, allow_credentials);
   }
 }
 
+bool CorsPolicyImpl::allowOriginsContain(absl::string_view origin) const {
+  return allow_any_origin_ || allow_origin_set_.contains(origin);
+}
+
+bool CorsPolicyImpl::allowOriginRegexesMatch(absl::string_view origin) const {
+  const auto regex_matches = [origin](const std::regex* regex) {
+    return std::regex_match(origin.begin(), origin.end(), *regex);
+  };
+  if (std::any_of(unfiltered_regexes_.begin(), unfiltered_regexes_.end(), regex_matches)) {
+    return true;
+  }
+  if (set_regexes_.empty()) {
+    return false;
+  }
+  std::vector<int> indices;
+  if (!allow_origin_regex_set_.match(origin, indices)) {
+    return std::any_of(set_regexes_.begin(), set_regexes_.end(), regex_matches);
+  }
+  // The set may report regexes std::regex does not match, so they are confirmed.
+  return std::any_of(indices.begin(), indices.end(), [this, &regex_matches](int index) {
+    return regex_matches(set_regexes_[index]);
+  });
+}
+
 ShadowPolicyImpl::ShadowPolicyImpl(const envoy::api::v2::route::RouteAction& config) {
   if (!config.has_request_mirror_policy()) {
     return;
   }
 
   cluster_ = config.request_mirror_policy().cluster();
+  stream_body_ = config.request_mirror_policy().stream_body();
 
   if (config.request_mirror_policy().has_runtime_fraction()) {
     runtime_key_ = config.request_mirror_policy().runtime_fraction().runtime_key();
@@ -405,6 +448,9 @@ RouteEntryImplBase::RouteEntryImplBase(const VirtualHostImpl& vhost,
                           factory_context),
       route_name_(route.name()), time_source_(factory_context.dispatcher().timeSource()),
       internal_redirect_action_(convertInternalRedirectAction(route.route())) {
+  vhost_.perFilterConfigs().mergeInto(most_specific_per_filter_configs_);
+  per_filter_configs_.mergeInto(most_specific_per_filter_configs_);
+
   if (route.route().has_metadata_match()) {
     const auto filter_it = route.route().metadata_match().filter_metadata().find(
         Envoy::Config::MetadataFilters::get().ENVOY_LB);
@@ -480,7 +526,9 @@ bool RouteEntryImplBase::evaluateRuntimeMatch(const uint64_t random_value) const
                                                        random_value);
 }
 
-bool RouteEntryImplBase::matchRoute(const Http::HeaderMap& headers, uint64_t random_value) const {
+bool RouteEntryImplBase::matchRoute(const Http::HeaderMap& headers,
+                                    const Http::Utility::QueryParamsView& query_params,
+                                    uint64_t random_value) const {
   bool matches = true;
 
   matches &= evaluateRuntimeMatch(random_value);
@@ -495,9 +543,7 @@ bool RouteEntryImplBase::matchRoute(const Http::HeaderMap& headers, uint64_t ran
 
   matches &= Http::HeaderUtility::matchHeaders(headers, config_headers_);
   if (!config_query_parameters_.empty()) {
-    Http::Utility::QueryParams query_parameters =
-        Http::Utility::parseQueryString(headers.Path()->value().getStringView());
-    matches &= ConfigUtility::matchQueryParams(query_parameters, config_query_parameters_);
+    matches &= ConfigUtility::matchQueryParams(query_params, config_query_parameters_);
   }
 
   return matches;
@@ -780,13 +826,15 @@ void RouteEntryImplBase::validateClusters(Upstream::ClusterManager& cm) const {
   // change we will make it so that dynamically loaded route tables do *not* perform CM checks.
   // In the future we might decide to also have a config option that turns off checks for static
   // route tables. This would enable the all CDS with static route table case.
+  //
+  // A cluster which was added lazily is instantiated here, and is known although it is warming.
   if (!cluster_name_.empty()) {
-    if (!cm.get(cluster_name_)) {
+    if (!cm.initializeLazyCluster(cluster_name_) && !cm.get(cluster_name_)) {
       throw EnvoyException(fmt::format("route: unknown cluster '{}'", cluster_name_));
     }
   } else if (!weighted_clusters_.empty()) {
     for (const WeightedClusterEntrySharedPtr& cluster : weighted_clusters_) {
-      if (!cm.get(cluster->clusterName())) {
+      if (!cm.initializeLazyCluster(cluster->clusterName()) && !cm.get(cluster->clusterName())) {
         throw EnvoyException(
             fmt::format("route: unknown weighted cluster '{}'", cluster->clusterName()));
       }
@@ -794,6 +842,22 @@ void RouteEntryImplBase::validateClusters(Upstream::ClusterManager& cm) const {
   }
 }
 
+void RouteEntryImplBase::initializeLazyClusters(Upstream::ClusterManager& cm) const {
+  if (isDirectResponse()) {
+    return;
+  }
+
+  if (!cluster_name_.empty()) {
+    cm.initializeLazyCluster(cluster_name_);
+  }
+  for (const WeightedClusterEntrySharedPtr& cluster : weighted_clusters_) {
+    cm.initializeLazyCluster(cluster->clusterName());
+  }
+  if (!shadow_policy_.cluster().empty()) {
+    cm.initializeLazyCluster(shadow_policy_.cluster());
+  }
+}
+
 const RouteSpecificFilterConfig*
 RouteEntryImplBase::perFilterConfig(const std::string& name) const {
   return per_filter_configs_.get(name);
@@ -811,7 +875,9 @@ RouteEntryImplBase::WeightedClusterEntry::WeightedClusterEntry(
       response_headers_parser_(HeaderParser::configure(cluster.response_headers_to_add(),
                                                        cluster.response_headers_to_remove())),
       per_filter_configs_(cluster.typed_per_filter_config(), cluster.per_filter_config(),
-                          factory_context) {
+                          factory_context),
+      most_specific_per_filter_configs_(parent->most_specific_per_filter_configs_) {
+  per_filter_configs_.mergeInto(most_specific_per_filter_configs_);
   if (cluster.has_metadata_match()) {
     const auto filter_it = cluster.metadata_match().filter_metadata().find(
         Envoy::Config::MetadataFilters::get().ENVOY_LB);
@@ -843,9 +909,11 @@ void PrefixRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers,
   finalizePathHeader(headers, prefix_, insert_envoy_original_path);
 }
 
-RouteConstSharedPtr PrefixRouteEntryImpl::matches(const Http::HeaderMap& headers,
-                                                  uint64_t random_value) const {
-  if (RouteEntryImplBase::matchRoute(headers, random_value) &&
+RouteConstSharedPtr
+PrefixRouteEntryImpl::matches(const Http::HeaderMap& headers,
+                              const Http::Utility::QueryParamsView& query_params,
+                              uint64_t random_value) const {
+  if (RouteEntryImplBase::matchRoute(headers, query_params, random_value) &&
       (case_sensitive_
            ? absl::StartsWith(headers.Path()->value().getStringView(), prefix_)
            : absl::StartsWithIgnoreCase(headers.Path()->value().getStringView(), prefix_))) {
@@ -865,8 +933,9 @@ void PathRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers,
 }
 
 RouteConstSharedPtr PathRouteEntryImpl::matches(const Http::HeaderMap& headers,
+                                                const Http::Utility::QueryParamsView& query_params,
                                                 uint64_t random_value) const {
-  if (RouteEntryImplBase::matchRoute(headers, random_value)) {
+  if (RouteEntryImplBase::matchRoute(headers, query_params, random_value)) {
     const Http::HeaderString& path = headers.Path()->value();
     absl::string_view query_string = Http::Utility::findQueryStringStart(path);
     size_t compare_length = path.size();
@@ -915,8 +984,9 @@ void RegexRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers,
 }
 
 RouteConstSharedPtr RegexRouteEntryImpl::matches(const Http::HeaderMap& headers,
+                                                 const Http::Utility::QueryParamsView& query_params,
                                                  uint64_t random_value) const {
-  if (RouteEntryImplBase::matchRoute(headers, random_value)) {
+  if (RouteEntryImplBase::matchRoute(headers, query_params, random_value)) {
     const Http::HeaderString& path = headers.Path()->value();
     const absl::string_view query_string = Http::Utility::findQueryStringStart(path);
     if (std::regex_match(path.getStringView().begin(),
@@ -929,7 +999,7 @@ RouteConstSharedPtr RegexRouteEntryImpl::matches(const Http::HeaderMap& headers,
 }
 
 VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtual_host,
-                                 const ConfigImpl& global_route_config,
+                                 const CommonConfigImplSharedPtr& global_route_config,
                                  Server::Configuration::FactoryContext& factory_context,
                                  bool validate_clusters)
     : stat_name_pool_(factory_context.scope().symbolTable()),
@@ -973,25 +1043,44 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kPath;
     const bool has_regex =
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex;
+    // Case insensitive matches are not indexed, as they are rare and the index compares bytes.
+    const bool case_sensitive =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(route.match(), case_sensitive, true);
+    const uint32_t position = routes_.size();
     if (has_prefix) {
       routes_.emplace_back(new PrefixRouteEntryImpl(*this, route, factory_context));
+      if (case_sensitive) {
+        route_path_index_.addPrefix(route.match().prefix(), position);
+      } else {
+        route_path_index_.addUnindexed(position);
+      }
     } else if (has_path) {
       routes_.emplace_back(new PathRouteEntryImpl(*this, route, factory_context));
+      if (case_sensitive) {
+        route_path_index_.addPath(route.match().path(), position);
+      } else {
+        route_path_index_.addUnindexed(position);
+      }
     } else {
       ASSERT(has_regex);
       routes_.emplace_back(new RegexRouteEntryImpl(*this, route, factory_context));
+      route_path_index_.addRegex(route.match().regex(), position);
     }
 
     if (validate_clusters) {
-      routes_.back()->validateClusters(factory_context.clusterManager());
-      if (!routes_.back()->shadowPolicy().cluster().empty()) {
-        if (!factory_context.clusterManager().get(routes_.back()->shadowPolicy().cluster())) {
-          throw EnvoyException(fmt::format("route: unknown shadow cluster '{}'",
-                                           routes_.back()->shadowPolicy().cluster()));
+      Upstream::ClusterManager& cm = factory_context.clusterManager();
+      routes_.back()->validateClusters(cm);
+      const std::string& shadow_cluster = routes_.back()->shadowPolicy().cluster();
+      if (!shadow_cluster.empty()) {
+        if (!cm.initializeLazyCluster(shadow_cluster) && !cm.get(shadow_cluster)) {
+          throw EnvoyException(fmt::format("route: unknown shadow cluster '{}'", shadow_cluster));
         }
       }
+    } else {
+      routes_.back()->initializeLazyClusters(factory_context.clusterManager());
     }
   }
+  route_path_index_.compile();
 
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
     virtual_clusters_.push_back(VirtualClusterEntry(virtual_cluster, stat_name_pool_));
@@ -1011,41 +1100,30 @@ VirtualHostImpl::VirtualClusterEntry::VirtualClusterEntry(
   }
 }
 
-const Config& VirtualHostImpl::routeConfig() const { return global_route_config_; }
+const CommonConfig& VirtualHostImpl::routeConfig() const { return *global_route_config_; }
 
 const RouteSpecificFilterConfig* VirtualHostImpl::perFilterConfig(const std::string& name) const {
   return per_filter_configs_.get(name);
 }
 
-const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
-    const std::string& host, const RouteMatcher::WildcardVirtualHosts& wildcard_virtual_hosts,
-    RouteMatcher::SubstringFunction substring_function) const {
-  // We do a longest wildcard match against the host that's passed in
-  // (e.g. foo-bar.baz.com should match *-bar.baz.com before matching *.baz.com for suffix
-  // wildcards). This is done by scanning the length => wildcards map looking for every wildcard
-  // whose size is < length.
-  for (const auto& iter : wildcard_virtual_hosts) {
-    const uint32_t wildcard_length = iter.first;
-    const auto& wildcard_map = iter.second;
-    // >= because *.foo.com shouldn't match .foo.com.
-    if (wildcard_length >= host.size()) {
-      continue;
-    }
-    const auto& match = wildcard_map.find(substring_function(host, wildcard_length));
-    if (match != wildcard_map.end()) {
-      return match->second.get();
-    }
-  }
-  return nullptr;
-}
-
 RouteMatcher::RouteMatcher(const envoy::api::v2::RouteConfiguration& route_config,
-                           const ConfigImpl& global_route_config,
+                           const CommonConfigImplSharedPtr& global_route_config,
                            Server::Configuration::FactoryContext& factory_context,
-                           bool validate_clusters) {
+                           bool validate_clusters, const RouteMatcher* previous) {
   for (const auto& virtual_host_config : route_config.virtual_hosts()) {
-    VirtualHostSharedPtr virtual_host(new VirtualHostImpl(virtual_host_config, global_route_config,
-                                                          factory_context, validate_clusters));
+    const uint64_t hash = MessageUtil::hash(virtual_host_config);
+    VirtualHostSharedPtr virtual_host;
+    if (previous != nullptr) {
+      const auto reusable = previous->virtual_hosts_by_hash_.find(hash);
+      if (reusable != previous->virtual_hosts_by_hash_.end()) {
+        virtual_host = reusable->second;
+      }
+    }
+    if (virtual_host == nullptr) {
+      virtual_host = std::make_shared<VirtualHostImpl>(virtual_host_config, global_route_config,
+                                                       factory_context, validate_clusters);
+    }
+    virtual_hosts_by_hash_.emplace(hash, virtual_host);
     for (const std::string& domain_name : virtual_host_config.domains()) {
       const std::string domain = Http::LowerCaseString(domain_name).get();
       bool duplicate_found = false;
@@ -1055,13 +1133,11 @@ RouteMatcher::RouteMatcher(const envoy::api::v2::RouteConfiguration& route_confi
         }
         default_virtual_host_ = virtual_host;
       } else if (!domain.empty() && '*' == domain[0]) {
-        duplicate_found = !wildcard_virtual_host_suffixes_[domain.size() - 1]
-                               .emplace(domain.substr(1), virtual_host)
-                               .second;
+        duplicate_found =
+            !wildcard_virtual_host_suffixes_.add(absl::string_view(domain).substr(1), virtual_host);
       } else if (!domain.empty() && '*' == domain[domain.size() - 1]) {
-        duplicate_found = !wildcard_virtual_host_prefixes_[domain.size() - 1]
-                               .emplace(domain.substr(0, domain.size() - 1), virtual_host)
-                               .second;
+        duplicate_found = !wildcard_virtual_host_prefixes_.add(
+            absl::string_view(domain).substr(0, domain.size() - 1), virtual_host);
       } else {
         duplicate_found = !virtual_hosts_.emplace(domain, virtual_host).second;
       }
@@ -1090,15 +1166,21 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const Http::HeaderMap&
     return SSL_REDIRECT_ROUTE;
   }
 
-  // Check for a route that matches the request.
-  for (const RouteEntryImplBaseConstSharedPtr& route : routes_) {
-    RouteConstSharedPtr route_entry = route->matches(headers, random_value);
-    if (nullptr != route_entry) {
-      return route_entry;
-    }
+  // Every route matches on the path, so there is no route for a request without one.
+  if (headers.Path() == nullptr) {
+    return nullptr;
   }
 
-  return nullptr;
+  // Check for a route that matches the request. Only the routes whose path specifier may match the
+  // path are evaluated, in the order of the route table, so the first matching route is returned.
+  const absl::string_view path = headers.Path()->value().getStringView();
+  const Http::Utility::QueryParamsView query_params(path);
+  RouteConstSharedPtr route_entry;
+  route_path_index_.forEachCandidate(path, [&](uint32_t position) {
+    route_entry = routes_[position]->matches(headers, query_params, random_value);
+    return route_entry == nullptr;
+  });
+  return route_entry;
 }
 
 const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::HeaderMap& headers) const {
@@ -1116,21 +1198,14 @@ const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::HeaderMap& head
   if (iter != virtual_hosts_.end()) {
     return iter->second.get();
   }
-  if (!wildcard_virtual_host_suffixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_suffixes_,
-        [](const std::string& h, int l) -> std::string { return h.substr(h.size() - l); });
-    if (vhost != nullptr) {
-      return vhost;
-    }
+  // Suffix wildcards take precedence over prefix wildcards, longer wildcard domains over shorter
+  // ones (e.g. foo-bar.baz.com should match *-bar.baz.com before matching *.baz.com).
+  const VirtualHostSharedPtr* vhost = wildcard_virtual_host_suffixes_.find(host);
+  if (vhost == nullptr) {
+    vhost = wildcard_virtual_host_prefixes_.find(host);
   }
-  if (!wildcard_virtual_host_prefixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_prefixes_,
-        [](const std::string& h, int l) -> std::string { return h.substr(0, l); });
-    if (vhost != nullptr) {
-      return vhost;
-    }
+  if (vhost != nullptr) {
+    return vhost->get();
   }
   return default_virtual_host_.get();
 }
@@ -1168,15 +1243,29 @@ VirtualHostImpl::virtualClusterFromEntries(const Http::HeaderMap& headers) const
   return nullptr;
 }
 
-ConfigImpl::ConfigImpl(const envoy::api::v2::RouteConfiguration& config,
-                       Server::Configuration::FactoryContext& factory_context,
-                       bool validate_clusters_default)
-    : name_(config.name()), symbol_table_(factory_context.scope().symbolTable()),
-      uses_vhds_(config.has_vhds()) {
-  route_matcher_ = std::make_unique<RouteMatcher>(
-      config, *this, factory_context,
-      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default));
+namespace {
+
+// @return the route configuration without the fields CommonConfigImpl does not depend on.
+envoy::api::v2::RouteConfiguration
+commonRouteConfiguration(const envoy::api::v2::RouteConfiguration& config) {
+  envoy::api::v2::RouteConfiguration common;
+  common.set_name(config.name());
+  if (config.has_vhds()) {
+    *common.mutable_vhds() = config.vhds();
+  }
+  *common.mutable_internal_only_headers() = config.internal_only_headers();
+  *common.mutable_response_headers_to_add() = config.response_headers_to_add();
+  *common.mutable_response_headers_to_remove() = config.response_headers_to_remove();
+  *common.mutable_request_headers_to_add() = config.request_headers_to_add();
+  *common.mutable_request_headers_to_remove() = config.request_headers_to_remove();
+  return common;
+}
 
+} // namespace
+
+CommonConfigImpl::CommonConfigImpl(const envoy::api::v2::RouteConfiguration& config)
+    : name_(config.name()), uses_vhds_(config.has_vhds()),
+      hash_(MessageUtil::hash(commonRouteConfiguration(config))) {
   for (const std::string& header : config.internal_only_headers()) {
     internal_only_headers_.push_back(Http::LowerCaseString(header));
   }
@@ -1187,6 +1276,24 @@ ConfigImpl::ConfigImpl(const envoy::api::v2::RouteConfiguration& config,
                                                      config.response_headers_to_remove());
 }
 
+ConfigImpl::ConfigImpl(const envoy::api::v2::RouteConfiguration& config,
+                       Server::Configuration::FactoryContext& factory_context,
+                       bool validate_clusters_default, const ConfigImpl* previous_config)
+    : shared_config_(std::make_shared<const CommonConfigImpl>(config)) {
+  const bool validate_clusters =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default);
+  // The virtual hosts of the previous configuration refer to its shared configuration, so they can
+  // only be reused along with it.
+  const RouteMatcher* previous_matcher = nullptr;
+  if (previous_config != nullptr && !validate_clusters &&
+      previous_config->shared_config_->hash() == shared_config_->hash()) {
+    shared_config_ = previous_config->shared_config_;
+    previous_matcher = previous_config->route_matcher_.get();
+  }
+  route_matcher_ = std::make_unique<RouteMatcher>(config, shared_config_, factory_context,
+                                                  validate_clusters, previous_matcher);
+}
+
 namespace {
 
 RouteSpecificFilterConfigConstSharedPtr
@@ -1233,5 +1340,15 @@ const RouteSpecificFilterConfig* PerFilterConfigs::get(const std::string& name)
   return it == configs_.end() ? nullptr : it->second.get();
 }
 
+void PerFilterConfigs::mergeInto(std::vector<const RouteSpecificFilterConfig*>& configs) const {
+  for (const auto& it : configs_) {
+    const uint32_t id = PerFilterConfigIds::id(it.first);
+    if (id >= configs.size()) {
+      configs.resize(id + 1);
+    }
+    configs[id] = it.second.get();
+  }
+}
+
 } // namespace Router
 } // namespace Envoy
@@ -17,15 +17,19 @@
 #include "envoy/server/filter_config.h"
 #include "envoy/upstream/cluster_manager.h"
 
+#include "common/common/regex.h"
 #include "common/config/metadata.h"
 #include "common/http/header_utility.h"
 #include "common/router/config_utility.h"
 #include "common/router/header_formatter.h"
 #include "common/router/header_parser.h"
 #include "common/router/metadatamatchcriteria_impl.h"
+#include "common/router/route_path_index.h"
 #include "common/router/router_ratelimit.h"
+#include "common/router/wildcard_domain_trie.h"
 #include "common/stats/symbol_table_impl.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -41,11 +45,14 @@ public:
   /**
    * See if this object matches the incoming headers.
    * @param headers supplies the headers to match.
+   * @param query_params supplies the query parameters of the path header, shared by the objects
+   *        matched against the same request so that the query string is split at most once.
    * @param random_value supplies the random seed to use if a runtime choice is required. This
    *        allows stable choices between calls if desired.
    * @return true if input headers match this object.
    */
   virtual RouteConstSharedPtr matches(const Http::HeaderMap& headers,
+                                      const Http::Utility::QueryParamsView& query_params,
                                       uint64_t random_value) const PURE;
 };
 
@@ -57,6 +64,12 @@ public:
 
   const RouteSpecificFilterConfig* get(const std::string& name) const;
 
+  /**
+   * Adds the configs to an array indexed by filter id, @see PerFilterConfigIds, overriding the
+   * configs of the same filters already in the array and growing it as needed.
+   */
+  void mergeInto(std::vector<const RouteSpecificFilterConfig*>& configs) const;
+
 private:
   std::unordered_map<std::string, RouteSpecificFilterConfigConstSharedPtr> configs_;
 };
@@ -91,6 +104,9 @@ public:
   const RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override {
     return nullptr;
   }
+  const RouteSpecificFilterConfig* mostSpecificPerFilterConfig(uint32_t) const override {
+    return nullptr;
+  }
 
 private:
   static const SslRedirector SSL_REDIRECTOR;
@@ -106,6 +122,8 @@ public:
   // Router::CorsPolicy
   const std::list<std::string>& allowOrigins() const override { return allow_origin_; };
   const std::list<std::regex>& allowOriginRegexes() const override { return allow_origin_regex_; }
+  bool allowOriginsContain(absl::string_view origin) const override;
+  bool allowOriginRegexesMatch(absl::string_view origin) const override;
   const std::string& allowMethods() const override { return allow_methods_; };
   const std::string& allowHeaders() const override { return allow_headers_; };
   const std::string& exposeHeaders() const override { return expose_headers_; };
@@ -133,6 +151,14 @@ private:
   Runtime::Loader& loader_;
   std::list<std::string> allow_origin_;
   std::list<std::regex> allow_origin_regex_;
+  // The allowed origins, hashed so an origin is found without walking the whole list.
+  absl::flat_hash_set<std::string> allow_origin_set_;
+  bool allow_any_origin_{};
+  // The regexes RE2 supports, compiled into a single set matched in one pass over an origin, and
+  // the other regexes, which are matched one at a time.
+  Regex::PrefilterSet allow_origin_regex_set_;
+  std::vector<const std::regex*> set_regexes_;
+  std::vector<const std::regex*> unfiltered_regexes_;
   const std::string allow_methods_;
   const std::string allow_headers_;
   const std::string expose_headers_;
@@ -141,28 +167,64 @@ private:
   const bool legacy_enabled_;
 };
 
-class ConfigImpl;
+/**
+ * Holds the routing configuration of a route configuration which does not depend on its virtual
+ * hosts. It is shared by the virtual hosts, so they can outlive the configuration they were built
+ * for and be reused by its next version.
+ */
+class CommonConfigImpl : public CommonConfig {
+public:
+  CommonConfigImpl(const envoy::api::v2::RouteConfiguration& config);
+
+  const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; };
+  const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; };
+
+  /**
+   * @return a hash of every field of the route configuration this was built from except its
+   *         virtual hosts and the validate_clusters field, which only applies to building them.
+   */
+  uint64_t hash() const { return hash_; }
+
+  // Router::CommonConfig
+  const std::list<Http::LowerCaseString>& internalOnlyHeaders() const override {
+    return internal_only_headers_;
+  }
+  const std::string& name() const override { return name_; }
+  bool usesVhds() const override { return uses_vhds_; }
+
+private:
+  std::list<Http::LowerCaseString> internal_only_headers_;
+  HeaderParserPtr request_headers_parser_;
+  HeaderParserPtr response_headers_parser_;
+  const std::string name_;
+  const bool uses_vhds_;
+  const uint64_t hash_;
+};
+
+using CommonConfigImplSharedPtr = std::shared_ptr<const CommonConfigImpl>;
+
 /**
  * Holds all routing configuration for an entire virtual host.
  */
 class VirtualHostImpl : public VirtualHost {
 public:
   VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtual_host,
-                  const ConfigImpl& global_route_config,
+                  const CommonConfigImplSharedPtr& global_route_config,
                   Server::Configuration::FactoryContext& factory_context, bool validate_clusters);
 
   RouteConstSharedPtr getRouteFromEntries(const Http::HeaderMap& headers,
                                           uint64_t random_value) const;
   const VirtualCluster* virtualClusterFromEntries(const Http::HeaderMap& headers) const;
-  const ConfigImpl& globalRouteConfig() const { return global_route_config_; }
+  const CommonConfigImpl& globalRouteConfig() const { return *global_route_config_; }
   const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; }
   const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; }
+  const PerFilterConfigs& perFilterConfigs() const { return per_filter_configs_; }
 
   // Router::VirtualHost
   const CorsPolicy* corsPolicy() const override { return cors_policy_.get(); }
   Stats::StatName statName() const override { return stat_name_; }
   const RateLimitPolicy& rateLimitPolicy() const override { return rate_limit_policy_; }
-  const Config& routeConfig() const override;
+  const CommonConfig& routeConfig() const override;
   const RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override;
   bool includeAttemptCount() const override { return include_attempt_count_; }
   const absl::optional<envoy::api::v2::route::RetryPolicy>& retryPolicy() const {
@@ -203,12 +265,13 @@ private:
   Stats::StatNamePool stat_name_pool_;
   const Stats::StatName stat_name_;
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  // Finds the routes whose path specifier may match a request, by position in routes_.
+  RoutePathIndex route_path_index_;
   std::vector<VirtualClusterEntry> virtual_clusters_;
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
   std::unique_ptr<const CorsPolicyImpl> cors_policy_;
-  const ConfigImpl& global_route_config_; // See note in RouteEntryImplBase::clusterEntry() on why
-                                          // raw ref to the top level config is currently safe.
+  const CommonConfigImplSharedPtr global_route_config_;
   HeaderParserPtr request_headers_parser_;
   HeaderParserPtr response_headers_parser_;
   PerFilterConfigs per_filter_configs_;
@@ -271,11 +334,13 @@ public:
   const std::string& cluster() const override { return cluster_; }
   const std::string& runtimeKey() const override { return runtime_key_; }
   const envoy::type::FractionalPercent& defaultValue() const override { return default_value_; }
+  bool streamBody() const override { return stream_body_; }
 
 private:
   std::string cluster_;
   std::string runtime_key_;
   envoy::type::FractionalPercent default_value_;
+  bool stream_body_{};
 };
 
 /**
@@ -325,11 +390,17 @@ public:
     return additional_request_chance_;
   }
   bool hedgeOnPerTryTimeout() const override { return hedge_on_per_try_timeout_; }
+  absl::optional<double> hedgeOnLatencyPercentile() const override {
+    return hedge_on_latency_percentile_;
+  }
+  double hedgeBudgetPercent() const override { return hedge_budget_percent_; }
 
 private:
   const uint32_t initial_requests_;
   const envoy::type::FractionalPercent additional_request_chance_;
   const bool hedge_on_per_try_timeout_;
+  absl::optional<double> hedge_on_latency_percentile_;
+  const double hedge_budget_percent_;
 };
 
 /**
@@ -397,8 +468,12 @@ public:
     return !host_redirect_.empty() || !path_redirect_.empty() || !prefix_rewrite_redirect_.empty();
   }
 
-  bool matchRoute(const Http::HeaderMap& headers, uint64_t random_value) const;
+  bool matchRoute(const Http::HeaderMap& headers,
+                  const Http::Utility::QueryParamsView& query_params, uint64_t random_value) const;
   void validateClusters(Upstream::ClusterManager& cm) const;
+  // Instantiates the clusters referenced by the route which were added lazily.
+  // @see Upstream::ClusterManager::initializeLazyCluster().
+  void initializeLazyClusters(Upstream::ClusterManager& cm) const;
 
   // Router::RouteEntry
   const std::string& clusterName() const override;
@@ -463,6 +538,11 @@ public:
   const Decorator* decorator() const override { return decorator_.get(); }
   const RouteTracing* tracingConfig() const override { return route_tracing_.get(); }
   const RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override;
+  const RouteSpecificFilterConfig* mostSpecificPerFilterConfig(uint32_t filter_id) const override {
+    return filter_id < most_specific_per_filter_configs_.size()
+               ? most_specific_per_filter_configs_[filter_id]
+               : nullptr;
+  }
 
 protected:
   const bool case_sensitive_;
@@ -566,6 +646,10 @@ private:
     const RouteSpecificFilterConfig* perFilterConfig(const std::string& name) const override {
       return parent_->perFilterConfig(name);
     };
+    const RouteSpecificFilterConfig*
+    mostSpecificPerFilterConfig(uint32_t filter_id) const override {
+      return parent_->mostSpecificPerFilterConfig(filter_id);
+    }
 
   private:
     const RouteEntryImplBase* parent_;
@@ -607,6 +691,12 @@ private:
     }
 
     const RouteSpecificFilterConfig* perFilterConfig(const std::string& name) const override;
+    const RouteSpecificFilterConfig*
+    mostSpecificPerFilterConfig(uint32_t filter_id) const override {
+      return filter_id < most_specific_per_filter_configs_.size()
+                 ? most_specific_per_filter_configs_[filter_id]
+                 : nullptr;
+    }
 
   private:
     const std::string runtime_key_;
@@ -616,6 +706,8 @@ private:
     HeaderParserPtr request_headers_parser_;
     HeaderParserPtr response_headers_parser_;
     PerFilterConfigs per_filter_configs_;
+    // Those of the parent route, overridden by per_filter_configs_, indexed by filter id.
+    std::vector<const RouteSpecificFilterConfig*> most_specific_per_filter_configs_;
   };
 
   using WeightedClusterEntrySharedPtr = std::shared_ptr<WeightedClusterEntry>;
@@ -691,6 +783,9 @@ private:
   const absl::optional<Http::Code> direct_response_code_;
   std::string direct_response_body_;
   PerFilterConfigs per_filter_configs_;
+  // Those of the virtual host, overridden by per_filter_configs_, indexed by filter id, so a filter
+  // resolves its config without looking up its name at each level.
+  std::vector<const RouteSpecificFilterConfig*> most_specific_per_filter_configs_;
   const std::string route_name_;
   TimeSource& time_source_;
   InternalRedirectAction internal_redirect_action_;
@@ -709,7 +804,9 @@ public:
   PathMatchType matchType() const override { return PathMatchType::Prefix; }
 
   // Router::Matchable
-  RouteConstSharedPtr matches(const Http::HeaderMap& headers, uint64_t random_value) const override;
+  RouteConstSharedPtr matches(const Http::HeaderMap& headers,
+                              const Http::Utility::QueryParamsView& query_params,
+                              uint64_t random_value) const override;
 
   // Router::DirectResponseEntry
   void rewritePathHeader(Http::HeaderMap& headers, bool insert_envoy_original_path) const override;
@@ -731,7 +828,9 @@ public:
   PathMatchType matchType() const override { return PathMatchType::Exact; }
 
   // Router::Matchable
-  RouteConstSharedPtr matches(const Http::HeaderMap& headers, uint64_t random_value) const override;
+  RouteConstSharedPtr matches(const Http::HeaderMap& headers,
+                              const Http::Utility::QueryParamsView& query_params,
+                              uint64_t random_value) const override;
 
   // Router::DirectResponseEntry
   void rewritePathHeader(Http::HeaderMap& headers, bool insert_envoy_original_path) const override;
@@ -753,7 +852,9 @@ public:
   PathMatchType matchType() const override { return PathMatchType::Regex; }
 
   // Router::Matchable
-  RouteConstSharedPtr matches(const Http::HeaderMap& headers, uint64_t random_value) const override;
+  RouteConstSharedPtr matches(const Http::HeaderMap& headers,
+                              const Http::Utility::QueryParamsView& query_params,
+                              uint64_t random_value) const override;
 
   // Router::DirectResponseEntry
   void rewritePathHeader(Http::HeaderMap& headers, bool insert_envoy_original_path) const override;
@@ -769,34 +870,29 @@ private:
  */
 class RouteMatcher {
 public:
+  /**
+   * @param previous supplies the matcher of the previous version of the route configuration, whose
+   *        virtual hosts are reused where their configuration has not changed, or nullptr. It must
+   *        have been built with the same global_route_config and factory_context.
+   */
   RouteMatcher(const envoy::api::v2::RouteConfiguration& config,
-               const ConfigImpl& global_http_config,
-               Server::Configuration::FactoryContext& factory_context, bool validate_clusters);
+               const CommonConfigImplSharedPtr& global_route_config,
+               Server::Configuration::FactoryContext& factory_context, bool validate_clusters,
+               const RouteMatcher* previous);
 
   RouteConstSharedPtr route(const Http::HeaderMap& headers, uint64_t random_value) const;
 
 private:
   const VirtualHostImpl* findVirtualHost(const Http::HeaderMap& headers) const;
 
-  using WildcardVirtualHosts =
-      std::map<int64_t, std::unordered_map<std::string, VirtualHostSharedPtr>, std::greater<>>;
-  using SubstringFunction = std::function<std::string(const std::string&, int)>;
-  const VirtualHostImpl* findWildcardVirtualHost(const std::string& host,
-                                                 const WildcardVirtualHosts& wildcard_virtual_hosts,
-                                                 SubstringFunction substring_function) const;
-
+  // The virtual hosts by the hash of their configuration.
+  std::unordered_map<uint64_t, VirtualHostSharedPtr> virtual_hosts_by_hash_;
   std::unordered_map<std::string, VirtualHostSharedPtr> virtual_hosts_;
-  // std::greater as a minor optimization to iterate from more to less specific
-  //
-  // A note on using an unordered_map versus a vector of (string, VirtualHostSharedPtr) pairs:
-  //
-  // Based on local benchmarks, each vector entry costs around 20ns for recall and (string)
-  // comparison with a fixed cost of about 25ns. For unordered_map, the empty map costs about 65ns
-  // and climbs to about 110ns once there are any entries.
-  //
-  // The break-even is 4 entries.
-  WildcardVirtualHosts wildcard_virtual_host_suffixes_;
-  WildcardVirtualHosts wildcard_virtual_host_prefixes_;
+  // The longest matching wildcard domain is found with a single walk of the host.
+  WildcardDomainTrie<VirtualHostSharedPtr> wildcard_virtual_host_suffixes_{
+      WildcardDomainTrie<VirtualHostSharedPtr>::Wildcard::Suffix};
+  WildcardDomainTrie<VirtualHostSharedPtr> wildcard_virtual_host_prefixes_{
+      WildcardDomainTrie<VirtualHostSharedPtr>::Wildcard::Prefix};
 
   VirtualHostSharedPtr default_virtual_host_;
 };
@@ -806,12 +902,20 @@ private:
  */
 class ConfigImpl : public Config {
 public:
+  /**
+   * @param previous_config supplies the previous version of the route configuration, built with
+   *        the same factory_context, whose virtual hosts are reused where neither their
+   *        configuration nor the rest of the route configuration has changed, or nullptr. Virtual
+   *        hosts are never reused when clusters are validated, as that happens while building them.
+   */
   ConfigImpl(const envoy::api::v2::RouteConfiguration& config,
-             Server::Configuration::FactoryContext& factory_context,
-             bool validate_clusters_default);
+             Server::Configuration::FactoryContext& factory_context, bool validate_clusters_default,
+             const ConfigImpl* previous_config = nullptr);
 
-  const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; };
-  const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; };
+  const HeaderParser& requestHeaderParser() const { return shared_config_->requestHeaderParser(); };
+  const HeaderParser& responseHeaderParser() const {
+    return shared_config_->responseHeaderParser();
+  };
 
   // Router::Config
   RouteConstSharedPtr route(const Http::HeaderMap& headers, uint64_t random_value) const override {
@@ -819,21 +923,16 @@ public:
   }
 
   const std::list<Http::LowerCaseString>& internalOnlyHeaders() const override {
-    return internal_only_headers_;
+    return shared_config_->internalOnlyHeaders();
   }
 
-  const std::string& name() const override { return name_; }
+  const std::string& name() const override { return shared_config_->name(); }
 
-  bool usesVhds() const override { return uses_vhds_; }
+  bool usesVhds() const override { return shared_config_->usesVhds(); }
 
 private:
+  CommonConfigImplSharedPtr shared_config_;
   std::unique_ptr<RouteMatcher> route_matcher_;
-  std::list<Http::LowerCaseString> internal_only_headers_;
-  HeaderParserPtr request_headers_parser_;
-  HeaderParserPtr response_headers_parser_;
-  const std::string name_;
-  Stats::SymbolTable& symbol_table_;
-  const bool uses_vhds_;
 };
 
 /**
@@ -10,16 +10,17 @@ namespace Envoy {
 namespace Router {
 
 bool ConfigUtility::QueryParameterMatcher::matches(
-    const Http::Utility::QueryParams& request_query_params) const {
-  auto query_param = request_query_params.find(name_);
-  if (query_param == request_query_params.end()) {
+    const Http::Utility::QueryParamsView& request_query_params) const {
+  const absl::optional<absl::string_view> query_param = request_query_params.find(name_);
+  if (!query_param.has_value()) {
     return false;
   } else if (is_regex_) {
-    return std::regex_match(query_param->second, regex_pattern_);
+    return std::regex_match(query_param.value().begin(), query_param.value().end(),
+                            regex_pattern_);
   } else if (value_.length() == 0) {
     return true;
   } else {
-    return (value_ == query_param->second);
+    return (value_ == query_param.value());
   }
 }
 
@@ -36,7 +37,7 @@ ConfigUtility::parsePriority(const envoy::api::v2::core::RoutingPriority& priori
 }
 
 bool ConfigUtility::matchQueryParams(
-    const Http::Utility::QueryParams& query_params,
+    const Http::Utility::QueryParamsView& query_params,
     const std::vector<QueryParameterMatcher>& config_query_params) {
   for (const auto& config_query_param : config_query_params) {
     if (!config_query_param.matches(query_params)) {
@@ -40,10 +40,10 @@ public:
     /**
      * Check if the query parameters for a request contain a match for this
      * QueryParameterMatcher.
-     * @param request_query_params supplies the parsed query parameters from a request.
+     * @param request_query_params supplies the query parameters of a request.
      * @return bool true if a match for this QueryParameterMatcher exists in request_query_params.
      */
-    bool matches(const Http::Utility::QueryParams& request_query_params) const;
+    bool matches(const Http::Utility::QueryParamsView& request_query_params) const;
 
   private:
     const std::string name_;
@@ -65,7 +65,7 @@ public:
    * @return bool true if all the query params (and values) in the config_params are found in the
    *         query_params
    */
-  static bool matchQueryParams(const Http::Utility::QueryParams& query_params,
+  static bool matchQueryParams(const Http::Utility::QueryParamsView& query_params,
                                const std::vector<QueryParameterMatcher>& config_query_params);
 
   /**
@@ -0,0 +1,46 @@
+#include "common/router/per_filter_config_ids.h"
+
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Router {
+
+namespace {
+
+struct Registry {
+  absl::Mutex lock_;
+  absl::flat_hash_map<std::string, uint32_t> ids_ ABSL_GUARDED_BY(lock_);
+  std::vector<std::string> names_ ABSL_GUARDED_BY(lock_);
+};
+
+// Ids are resolved while loading configs on the main thread and while creating filters on the
+// workers, so the registry is shared, and never destroyed.
+Registry& registry() { MUTABLE_CONSTRUCT_ON_FIRST_USE(Registry); }
+
+} // namespace
+
+uint32_t PerFilterConfigIds::id(const std::string& name) {
+  Registry& registry = Router::registry();
+  absl::MutexLock lock(&registry.lock_);
+  const auto result = registry.ids_.try_emplace(name, registry.names_.size());
+  if (result.second) {
+    registry.names_.push_back(name);
+  }
+  return result.first->second;
+}
+
+std::string PerFilterConfigIds::name(uint32_t id) {
+  Registry& registry = Router::registry();
+  absl::MutexLock lock(&registry.lock_);
+  ASSERT(id < registry.names_.size());
+  return registry.names_[id];
+}
+
+} // namespace Router
+} // namespace Envoy
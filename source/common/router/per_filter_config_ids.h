@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Process wide ids of the names of the filters which take per route configs. The configs of a
+ * route are held in a dense array indexed by filter id, so filters resolving their config on every
+ * request index the array with an id resolved once, rather than hashing their name at each level
+ * of the route. Ids are assigned in increasing order from 0 the first time a name is seen, and
+ * never reused.
+ */
+class PerFilterConfigIds {
+public:
+  /**
+   * @param name supplies the name of a filter.
+   * @return the id of the name, assigning it if it has none yet.
+   */
+  static uint32_t id(const std::string& name);
+
+  /**
+   * @param id supplies an id returned by id().
+   * @return the name the id was assigned to.
+   */
+  static std::string name(uint32_t id);
+};
+
+} // namespace Router
+} // namespace Envoy
@@ -172,8 +172,9 @@ RdsRouteConfigProviderImpl::RdsRouteConfigProviderImpl(
       tls_(factory_context.threadLocal().allocateSlot()) {
   ConfigConstSharedPtr initial_config;
   if (config_update_info_->configInfo().has_value()) {
-    initial_config = std::make_shared<ConfigImpl>(config_update_info_->routeConfiguration(),
-                                                  factory_context_, false);
+    config_ = std::make_shared<const ConfigImpl>(config_update_info_->routeConfiguration(),
+                                                 factory_context_, false);
+    initial_config = config_;
   } else {
     initial_config = std::make_shared<NullConfigImpl>();
   }
@@ -192,8 +193,9 @@ Router::ConfigConstSharedPtr RdsRouteConfigProviderImpl::config() {
 }
 
 void RdsRouteConfigProviderImpl::onConfigUpdate() {
-  ConfigConstSharedPtr new_config(
-      new ConfigImpl(config_update_info_->routeConfiguration(), factory_context_, false));
+  config_ = std::make_shared<const ConfigImpl>(config_update_info_->routeConfiguration(),
+                                               factory_context_, false, config_.get());
+  ConfigConstSharedPtr new_config = config_;
   tls_->runOnAllThreads(
       [this, new_config]() -> void { tls_->getTyped<ThreadLocalConfig>().config_ = new_config; });
 }
@@ -25,6 +25,7 @@
 #include "common/common/logger.h"
 #include "common/init/target_impl.h"
 #include "common/protobuf/utility.h"
+#include "common/router/config_impl.h"
 #include "common/router/route_config_update_receiver_impl.h"
 #include "common/router/vhds.h"
 
@@ -180,6 +181,8 @@ private:
   RdsRouteConfigSubscriptionSharedPtr subscription_;
   RouteConfigUpdatePtr& config_update_info_;
   Server::Configuration::FactoryContext& factory_context_;
+  // The latest configuration, whose unchanged virtual hosts are reused by the next one.
+  std::shared_ptr<const ConfigImpl> config_;
   ThreadLocal::SlotPtr tls_;
 
   friend class RouteConfigProviderManagerImpl;
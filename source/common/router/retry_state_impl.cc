@@ -11,9 +11,20 @@
 #include "common/http/codes.h"
 #include "common/http/headers.h"
 #include "common/http/utility.h"
+#include "common/runtime/runtime_keys.h"
+#include "common/singleton/const_singleton.h"
 
 namespace Envoy {
 namespace Router {
+namespace {
+
+struct RetryRuntimeKeyValues {
+  const Runtime::Key BaseRetryBackoffMs{"upstream.base_retry_backoff_ms"};
+  const Runtime::Key UseRetry{"upstream.use_retry"};
+};
+using RetryRuntimeKeys = ConstSingleton<RetryRuntimeKeyValues>;
+
+} // namespace
 
 // These are defined in envoy/router/router.h, however during certain cases the compiler is
 // refusing to use the header version so allocate space here.
@@ -62,7 +73,7 @@ RetryStateImpl::RetryStateImpl(const RetryPolicy& route_policy, Http::HeaderMap&
   retries_remaining_ = std::max(retries_remaining_, route_policy.numRetries());
 
   std::chrono::milliseconds base_interval(
-      runtime_.snapshot().getInteger("upstream.base_retry_backoff_ms", 25));
+      runtime_.snapshot().getInteger(RetryRuntimeKeys::get().BaseRetryBackoffMs, 25));
   if (route_policy.baseInterval()) {
     base_interval = *route_policy.baseInterval();
   }
@@ -195,7 +206,7 @@ RetryStatus RetryStateImpl::shouldRetry(bool would_retry, DoRetryCallback callba
     return RetryStatus::NoOverflow;
   }
 
-  if (!runtime_.snapshot().featureEnabled("upstream.use_retry", 100)) {
+  if (!runtime_.snapshot().featureEnabled(RetryRuntimeKeys::get().UseRetry, 100)) {
     return RetryStatus::No;
   }
 
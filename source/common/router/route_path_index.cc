@@ -0,0 +1,120 @@
+#include "common/router/route_path_index.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Router {
+
+namespace {
+
+void addPosition(std::vector<uint32_t>& positions, uint32_t position) {
+  ASSERT(positions.empty() || positions.back() < position);
+  positions.push_back(position);
+}
+
+} // namespace
+
+bool RoutePathIndex::labelBefore(const std::unique_ptr<Node>& node, char c) {
+  return node->label_[0] < c;
+}
+
+void RoutePathIndex::addPrefix(absl::string_view prefix, uint32_t position) {
+  addPosition(insert(prefix).prefix_routes_, position);
+}
+
+void RoutePathIndex::addPath(absl::string_view path, uint32_t position) {
+  addPosition(insert(path).path_routes_, position);
+}
+
+void RoutePathIndex::addRegex(const std::string& regex, uint32_t position) {
+  if (regex_set_.add(regex)) {
+    addPosition(regex_routes_, position);
+  } else {
+    addUnindexed(position);
+  }
+}
+
+void RoutePathIndex::addUnindexed(uint32_t position) { addPosition(unindexed_routes_, position); }
+
+void RoutePathIndex::compile() { regex_set_.compile(); }
+
+RoutePathIndex::Node& RoutePathIndex::insert(absl::string_view key) {
+  Node* node = &root_;
+  while (!key.empty()) {
+    auto child =
+        std::lower_bound(node->children_.begin(), node->children_.end(), key[0], labelBefore);
+    if (child == node->children_.end() || (*child)->label_[0] != key[0]) {
+      child = node->children_.insert(child, std::make_unique<Node>());
+      (*child)->label_ = std::string(key);
+      return **child;
+    }
+
+    const std::string& label = (*child)->label_;
+    const size_t common =
+        std::mismatch(label.begin(), label.begin() + std::min(label.size(), key.size()),
+                      key.begin())
+            .first -
+        label.begin();
+    if (common < label.size()) {
+      // The key ends or diverges within the edge, so split it at that point.
+      auto split = std::make_unique<Node>();
+      split->label_ = label.substr(0, common);
+      (*child)->label_.erase(0, common);
+      split->children_.push_back(std::move(*child));
+      *child = std::move(split);
+    }
+    node = child->get();
+    key.remove_prefix(common);
+  }
+  return *node;
+}
+
+void RoutePathIndex::findCandidateLists(absl::string_view path, CandidateLists& lists,
+                                        std::vector<uint32_t>& regex_candidates) const {
+  const auto addList = [&lists](const std::vector<uint32_t>& positions) {
+    if (!positions.empty()) {
+      lists.push_back({positions.data(), positions.data() + positions.size()});
+    }
+  };
+  // Exact paths are compared without the query string, while prefixes are compared with it.
+  const size_t path_length = std::min(path.find('?'), path.size());
+
+  addList(unindexed_routes_);
+  if (!regex_routes_.empty()) {
+    std::vector<int> indices;
+    if (regex_set_.match(path.substr(0, path_length), indices)) {
+      // The indices are in increasing order, as are the positions of the routes they identify.
+      for (const int index : indices) {
+        regex_candidates.push_back(regex_routes_[index]);
+      }
+      addList(regex_candidates);
+    } else {
+      addList(regex_routes_);
+    }
+  }
+  const Node* node = &root_;
+  size_t depth = 0;
+  while (true) {
+    addList(node->prefix_routes_);
+    if (depth == path_length) {
+      addList(node->path_routes_);
+    }
+    if (depth == path.size()) {
+      break;
+    }
+
+    const char c = path[depth];
+    auto child = std::lower_bound(node->children_.begin(), node->children_.end(), c, labelBefore);
+    if (child == node->children_.end() || (*child)->label_[0] != c ||
+        path.substr(depth, (*child)->label_.size()) != (*child)->label_) {
+      break;
+    }
+    depth += (*child)->label_.size();
+    node = child->get();
+  }
+}
+
+} // namespace Router
+} // namespace Envoy
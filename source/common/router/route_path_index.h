@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/common/regex.h"
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * An index of the path specifiers of the routes of a virtual host, used to find the routes whose
+ * path specifier may match a request path without evaluating every route. Routes are identified by
+ * their position in the route table.
+ *
+ * Prefixes and exact paths are held in a radix trie, so the routes they may match are found in a
+ * single walk of the path. Regular expressions are compiled into a single RE2 set, so the routes
+ * they may match are found in a single pass over the path. Routes whose path specifier cannot be
+ * indexed, such as case insensitive matches and regular expressions RE2 does not support, are
+ * candidates for every path. Candidates still have to be evaluated in full, as the index does not
+ * account for header, query parameter or runtime constraints.
+ */
+class RoutePathIndex {
+public:
+  /**
+   * Adds a route which matches paths starting with a prefix, including any query string.
+   */
+  void addPrefix(absl::string_view prefix, uint32_t position);
+
+  /**
+   * Adds a route which matches a path exactly, excluding any query string.
+   */
+  void addPath(absl::string_view path, uint32_t position);
+
+  /**
+   * Adds a route which matches a regular expression against the whole path, excluding any query
+   * string.
+   */
+  void addRegex(const std::string& regex, uint32_t position);
+
+  /**
+   * Adds a route which is a candidate for every path.
+   */
+  void addUnindexed(uint32_t position);
+
+  /**
+   * Compiles the index. This must be called once, after all routes have been added and before
+   * candidates are found.
+   */
+  void compile();
+
+  /**
+   * Calls a callback with the positions of the routes that may match a path, in increasing order,
+   * until the callback returns false. Routes must have been added in increasing order of position.
+   * @param path supplies the request path, including any query string.
+   * @param cb supplies the callback, which is called with a position and returns whether to
+   *           continue.
+   */
+  template <class Callback> void forEachCandidate(absl::string_view path, Callback cb) const {
+    CandidateLists lists;
+    std::vector<uint32_t> regex_candidates;
+    findCandidateLists(path, lists, regex_candidates);
+    // Each list is sorted, so repeatedly taking the lowest head visits the positions in order.
+    // There are at most a few lists, one for each indexed prefix of the path.
+    while (true) {
+      CandidateList* next = nullptr;
+      for (CandidateList& list : lists) {
+        if (list.begin_ != list.end_ && (next == nullptr || *list.begin_ < *next->begin_)) {
+          next = &list;
+        }
+      }
+      if (next == nullptr || !cb(*next->begin_++)) {
+        return;
+      }
+    }
+  }
+
+private:
+  struct Node {
+    // The bytes on the edge from the parent node.
+    std::string label_;
+    // The positions of the routes whose prefix ends at this node.
+    std::vector<uint32_t> prefix_routes_;
+    // The positions of the routes whose exact path ends at this node.
+    std::vector<uint32_t> path_routes_;
+    // Sorted by the first byte of their label, which differs between siblings.
+    std::vector<std::unique_ptr<Node>> children_;
+  };
+
+  struct CandidateList {
+    const uint32_t* begin_;
+    const uint32_t* end_;
+  };
+  using CandidateLists = absl::InlinedVector<CandidateList, 8>;
+
+  static bool labelBefore(const std::unique_ptr<Node>& node, char c);
+  // @return the node at the end of a key, inserting nodes and splitting edges as needed.
+  Node& insert(absl::string_view key);
+  // @param regex_candidates supplies storage for the positions of the regex routes which may match.
+  void findCandidateLists(absl::string_view path, CandidateLists& lists,
+                          std::vector<uint32_t>& regex_candidates) const;
+
+  Node root_;
+  std::vector<uint32_t> unindexed_routes_;
+  Regex::PrefilterSet regex_set_;
+  // The positions of the routes in regex_set_, by their index in the set.
+  std::vector<uint32_t> regex_routes_;
+};
+
+} // namespace Router
+} // namespace Envoy
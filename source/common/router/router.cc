@@ -395,6 +395,9 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool e
     return Http::FilterHeadersStatus::StopIteration;
   }
   cluster_ = cluster->info();
+  if (route_entry_->hedgePolicy().hedgeOnLatencyPercentile()) {
+    hedge_tracker_ = cluster->hedgeTracker();
+  }
 
   // Set up stat prefixes, etc.
   request_vcluster_ = route_entry_->virtualCluster(headers);
@@ -511,6 +514,13 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool e
                        config_.random_, callbacks_->dispatcher(), route_entry_->priority());
   do_shadowing_ = FilterUtility::shouldShadow(route_entry_->shadowPolicy(), config_.runtime_,
                                               callbacks_->streamId());
+  if (do_shadowing_ && route_entry_->shadowPolicy().streamBody()) {
+    // The shadow is sent the request as it arrives, so nothing is buffered for it.
+    shadow_stream_ = config_.shadowWriter().streamingShadow(
+        route_entry_->shadowPolicy().cluster(), std::make_unique<Http::HeaderMapImpl>(headers),
+        timeout_.global_timeout_, buffer_limit_, end_stream);
+    do_shadowing_ = false;
+  }
 
   ENVOY_STREAM_LOG(debug, "router decoding headers:\n{}", *callbacks_, headers);
 
@@ -558,6 +568,19 @@ Http::FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_strea
   // try timeout timer is not started until onUpstreamComplete().
   ASSERT(upstream_requests_.size() == 1);
 
+  if (shadow_stream_ != nullptr && shadow_stream_->aboveBufferLimit()) {
+    // Give up on a shadow which is not keeping up rather than buffer the request for it without
+    // bound.
+    cluster_->stats().retry_or_shadow_abandoned_.inc();
+    shadow_stream_.reset();
+  }
+  if (shadow_stream_ != nullptr) {
+    // The large slices of data are shared with the shadow rather than copied.
+    Buffer::OwnedImpl shadow_data;
+    shadow_data.addShared(data);
+    shadow_stream_->sendData(shadow_data, end_stream);
+  }
+
   bool buffering = (retry_state_ && retry_state_->enabled()) || do_shadowing_;
   if (buffering && buffer_limit_ > 0 &&
       getLength(callbacks_->decodingBuffer()) + data.length() > buffer_limit_) {
@@ -600,6 +623,9 @@ Http::FilterTrailersStatus Filter::decodeTrailers(Http::HeaderMap& trailers) {
   // try timeout timer is not started until onUpstreamComplete().
   ASSERT(upstream_requests_.size() == 1);
   downstream_trailers_ = &trailers;
+  if (shadow_stream_ != nullptr) {
+    shadow_stream_->sendTrailers(trailers);
+  }
   for (auto& upstream_request : upstream_requests_) {
     upstream_request->encodeTrailers(trailers);
   }
@@ -658,7 +684,10 @@ void Filter::onRequestComplete() {
   ASSERT(!downstream_end_stream_);
   downstream_end_stream_ = true;
   Event::Dispatcher& dispatcher = callbacks_->dispatcher();
-  downstream_request_complete_time_ = dispatcher.timeSource().monotonicTime();
+  // The request completes on the arrival of its last bytes, so the time at which the event loop
+  // returned from polling is accurate enough and saves reading the clock. The same applies to the
+  // arrival of the response below.
+  downstream_request_complete_time_ = dispatcher.approximateMonotonicTime();
 
   // Possible that we got an immediate reset.
   if (!upstream_requests_.empty()) {
@@ -683,6 +712,8 @@ void Filter::onDestroy() {
   // Reset any in-flight upstream requests.
   resetAll();
   cleanup();
+  // This resets the shadow if the request was not received in full.
+  shadow_stream_.reset();
 }
 
 void Filter::onResponseTimeout() {
@@ -753,6 +784,29 @@ void Filter::onSoftPerTryTimeout(UpstreamRequest& upstream_request) {
   }
 }
 
+void Filter::onHedgeTimeout(UpstreamRequest& upstream_request) {
+  if (downstream_response_started_ || !upstream_request.awaiting_headers_ || !retry_state_ ||
+      upstream_request.retried_) {
+    return;
+  }
+
+  if (!hedge_tracker_->hedgeBudgetAvailable(route_entry_->hedgePolicy().hedgeBudgetPercent())) {
+    cluster_->stats().upstream_rq_hedge_budget_exceeded_.inc();
+    return;
+  }
+
+  const RetryStatus retry_status =
+      retry_state_->shouldHedgeRetryPerTryTimeout([this]() -> void { doRetry(); });
+  if (retry_status == RetryStatus::Yes && setupRetry()) {
+    ENVOY_STREAM_LOG(debug, "hedging upstream request on latency", *callbacks_);
+    // The original request keeps going, the first response of either is used.
+    upstream_request.retried_ = true;
+    upstream_request.hedged_on_latency_ = true;
+    hedge_tracker_->onHedge();
+    cluster_->stats().upstream_rq_hedged_.inc();
+  }
+}
+
 void Filter::onPerTryTimeout(UpstreamRequest& upstream_request) {
   if (hedging_params_.hedge_on_per_try_timeout_) {
     onSoftPerTryTimeout(upstream_request);
@@ -777,6 +831,12 @@ void Filter::onPerTryTimeout(UpstreamRequest& upstream_request) {
 
   // Remove this upstream request from the list now that we're done with it.
   upstream_request.removeFromList(upstream_requests_);
+
+  // If the request was hedged on latency, wait for the hedged request.
+  if (numRequestsAwaitingHeaders() > 0 || pending_retries_ > 0) {
+    return;
+  }
+
   onUpstreamTimeoutAbort(StreamInfo::ResponseFlag::UpstreamRequestTimeout,
                          StreamInfo::ResponseCodeDetails::get().UpstreamPerTryTimeout);
 }
@@ -986,7 +1046,11 @@ void Filter::resetOtherUpstreams(UpstreamRequest& upstream_request) {
     if (upstream_request_tmp.get() != &upstream_request) {
       upstream_request_tmp->resetStream();
       // TODO: per-host stat for hedge abandoned.
-      // TODO: cluster stat for hedge abandoned.
+      cluster_->stats().upstream_rq_hedge_abandoned_.inc();
+      if (upstream_request_tmp->hedged_on_latency_) {
+        // The request hedged on latency lost to its hedge.
+        cluster_->stats().upstream_rq_hedge_won_.inc();
+      }
     } else {
       final_upstream_request = std::move(upstream_request_tmp);
     }
@@ -1003,6 +1067,12 @@ void Filter::onUpstreamHeaders(uint64_t response_code, Http::HeaderMapPtr&& head
 
   modify_headers_(*headers);
 
+  if (upstream_request.hedge_tracking_start_time_) {
+    hedge_tracker_->recordResponseTime(std::chrono::duration_cast<std::chrono::microseconds>(
+        callbacks_->dispatcher().approximateMonotonicTime() -
+        *upstream_request.hedge_tracking_start_time_));
+  }
+
   upstream_request.upstream_host_->outlierDetector().putHttpResponseCode(response_code);
 
   if (headers->EnvoyImmediateHealthCheckFail() != nullptr) {
@@ -1077,7 +1147,7 @@ void Filter::onUpstreamHeaders(uint64_t response_code, Http::HeaderMapPtr&& head
   // premature response.
   if (DateUtil::timePointValid(downstream_request_complete_time_)) {
     Event::Dispatcher& dispatcher = callbacks_->dispatcher();
-    MonotonicTime response_received_time = dispatcher.timeSource().monotonicTime();
+    MonotonicTime response_received_time = dispatcher.approximateMonotonicTime();
     std::chrono::milliseconds ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         response_received_time - downstream_request_complete_time_);
     if (!config_.suppress_envoy_headers_) {
@@ -1167,7 +1237,7 @@ void Filter::onUpstreamComplete(UpstreamRequest& upstream_request) {
       DateUtil::timePointValid(downstream_request_complete_time_)) {
     Event::Dispatcher& dispatcher = callbacks_->dispatcher();
     std::chrono::milliseconds response_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-        dispatcher.timeSource().monotonicTime() - downstream_request_complete_time_);
+        dispatcher.approximateMonotonicTime() - downstream_request_complete_time_);
 
     upstream_request.upstream_host_->outlierDetector().putResponseTime(response_time);
 
@@ -1307,8 +1377,8 @@ Filter::UpstreamRequest::UpstreamRequest(Filter& parent, Http::ConnectionPool::I
     : parent_(parent), conn_pool_(pool), grpc_rq_success_deferred_(false),
       stream_info_(pool.protocol(), parent_.callbacks_->dispatcher().timeSource()),
       calling_encode_headers_(false), upstream_canary_(false), decode_complete_(false),
-      encode_complete_(false), encode_trailers_(false), retried_(false), awaiting_headers_(true),
-      outlier_detection_timeout_recorded_(false),
+      encode_complete_(false), encode_trailers_(false), retried_(false), hedged_on_latency_(false),
+      awaiting_headers_(true), outlier_detection_timeout_recorded_(false),
       create_per_try_timeout_on_request_complete_(false) {
 
   if (parent_.config_.start_child_span_) {
@@ -1330,6 +1400,9 @@ Filter::UpstreamRequest::~UpstreamRequest() {
     // Allows for testing.
     per_try_timeout_->disableTimer();
   }
+  if (hedge_timeout_ != nullptr) {
+    hedge_timeout_->disableTimer();
+  }
   clearRequestEncoder();
 
   stream_info_.setUpstreamTiming(upstream_timing_);
@@ -1502,6 +1575,27 @@ void Filter::UpstreamRequest::setupPerTryTimeout() {
         parent_.callbacks_->dispatcher().createTimer([this]() -> void { onPerTryTimeout(); });
     per_try_timeout_->enableTimer(parent_.timeout_.per_try_timeout_);
   }
+  // The response time is tracked from the same point as the per try timeout.
+  if (parent_.hedge_tracker_ != nullptr) {
+    setupHedgeTimeout();
+  }
+}
+
+void Filter::UpstreamRequest::setupHedgeTimeout() {
+  Event::Dispatcher& dispatcher = parent_.callbacks_->dispatcher();
+  hedge_tracking_start_time_ = dispatcher.approximateMonotonicTime();
+  // Only the first request is hedged on latency.
+  if (parent_.attempt_count_ > 1) {
+    return;
+  }
+  const absl::optional<std::chrono::microseconds> delay =
+      parent_.hedge_tracker_->responseTimePercentile(
+          parent_.route_entry_->hedgePolicy().hedgeOnLatencyPercentile().value());
+  if (delay) {
+    hedge_timeout_ = dispatcher.createTimer([this]() -> void { parent_.onHedgeTimeout(*this); });
+    // The timers have a resolution of a millisecond, rounding down would hedge too early.
+    hedge_timeout_->enableTimer(std::chrono::milliseconds((delay->count() + 999) / 1000));
+  }
 }
 
 void Filter::UpstreamRequest::onPerTryTimeout() {
@@ -368,6 +368,7 @@ private:
     void resetStream();
     void setupPerTryTimeout();
     void onPerTryTimeout();
+    void setupHedgeTimeout();
     void maybeEndDecode(bool end_stream);
 
     void onUpstreamHostSelected(Upstream::HostDescriptionConstSharedPtr host) {
@@ -448,6 +449,9 @@ private:
     Http::ConnectionPool::Instance& conn_pool_;
     bool grpc_rq_success_deferred_;
     Event::TimerPtr per_try_timeout_;
+    Event::TimerPtr hedge_timeout_;
+    // When the request was complete, if the response time is tracked for hedging on latency.
+    absl::optional<MonotonicTime> hedge_tracking_start_time_;
     Http::ConnectionPool::Cancellable* conn_pool_stream_handle_{};
     Http::StreamEncoder* request_encoder_{};
     absl::optional<Http::StreamResetReason> deferred_reset_reason_;
@@ -469,6 +473,8 @@ private:
     bool encode_complete_ : 1;
     bool encode_trailers_ : 1;
     bool retried_ : 1;
+    // Whether this request was hedged after a percentile of the response times of the cluster.
+    bool hedged_on_latency_ : 1;
     bool awaiting_headers_ : 1;
     bool outlier_detection_timeout_recorded_ : 1;
     // Tracks whether we deferred a per try timeout because the downstream request
@@ -499,6 +505,8 @@ private:
   uint32_t numRequestsAwaitingHeaders();
   void onGlobalTimeout();
   void onPerTryTimeout(UpstreamRequest& upstream_request);
+  // Handle an upstream request still awaiting headers after a percentile of the response times.
+  void onHedgeTimeout(UpstreamRequest& upstream_request);
   void onRequestComplete();
   void onResponseTimeout();
   void onUpstream100ContinueHeaders(Http::HeaderMapPtr&& headers,
@@ -550,6 +558,10 @@ private:
   Event::TimerPtr response_timeout_;
   FilterUtility::TimeoutData timeout_;
   FilterUtility::HedgingParams hedging_params_;
+  // Set if the route hedges requests on latency.
+  Upstream::HedgeTrackerSharedPtr hedge_tracker_;
+  // Set while the request is shadowed as it arrives.
+  ShadowStreamPtr shadow_stream_;
   Http::Code timeout_response_code_ = Http::Code::GatewayTimeout;
   std::list<UpstreamRequestPtr> upstream_requests_;
   // Tracks which upstream request "wins" and will have the corresponding
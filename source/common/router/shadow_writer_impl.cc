@@ -4,12 +4,75 @@
 #include <string>
 
 #include "common/common/assert.h"
+#include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 
 #include "absl/strings/str_join.h"
 
 namespace Envoy {
 namespace Router {
+namespace {
+
+// Switch authority to add a shadow postfix. This allows upstream logging to make more sense.
+void addShadowPostfix(Http::HeaderMap& headers) {
+  ASSERT(!headers.Host()->value().empty());
+  auto parts = StringUtil::splitToken(headers.Host()->value().getStringView(), ":");
+  ASSERT(!parts.empty() && parts.size() <= 2);
+  headers.Host()->value(parts.size() == 2
+                            ? absl::StrJoin(parts, "-shadow:")
+                            : absl::StrCat(headers.Host()->value().getStringView(), "-shadow"));
+}
+
+} // namespace
+
+ShadowStreamImpl::ShadowStreamImpl(Http::AsyncClient& client, Http::HeaderMapPtr&& headers,
+                                   const Http::AsyncClient::StreamOptions& options,
+                                   bool end_stream)
+    : active_(std::make_shared<ActiveStream>()), local_complete_(end_stream) {
+  Http::AsyncClient::Stream* stream = client.start(*active_, options);
+  if (stream == nullptr) {
+    return;
+  }
+  active_->headers_ = std::move(headers);
+  active_->stream_ = stream;
+  active_->self_ = active_;
+  // This may complete the shadow immediately, e.g. if the cluster has no healthy hosts.
+  stream->sendHeaders(*active_->headers_, end_stream);
+}
+
+ShadowStreamImpl::~ShadowStreamImpl() {
+  // A shadow which is missing the end of the request is of no use.
+  if (active_->stream_ != nullptr && !local_complete_) {
+    active_->stream_->reset();
+  }
+}
+
+void ShadowStreamImpl::sendData(Buffer::Instance& data, bool end_stream) {
+  ASSERT(!local_complete_);
+  local_complete_ = end_stream;
+  if (active_->stream_ != nullptr) {
+    active_->stream_->sendData(data, end_stream);
+  }
+}
+
+void ShadowStreamImpl::sendTrailers(const Http::HeaderMap& trailers) {
+  ASSERT(!local_complete_);
+  local_complete_ = true;
+  if (active_->stream_ != nullptr) {
+    active_->trailers_ = std::make_unique<Http::HeaderMapImpl>(trailers);
+    active_->stream_->sendTrailers(*active_->trailers_);
+  }
+}
+
+bool ShadowStreamImpl::aboveBufferLimit() const {
+  return active_->stream_ != nullptr && active_->stream_->isAboveWriteBufferHighWatermark();
+}
+
+void ShadowStreamImpl::ActiveStream::onDone() {
+  stream_ = nullptr;
+  // This may be the last reference to this object, which is then destroyed on return.
+  std::shared_ptr<ActiveStream> self = std::move(self_);
+}
 
 void ShadowWriterImpl::shadow(const std::string& cluster, Http::MessagePtr&& request,
                               std::chrono::milliseconds timeout) {
@@ -21,18 +84,27 @@ void ShadowWriterImpl::shadow(const std::string& cluster, Http::MessagePtr&& req
     return;
   }
 
-  ASSERT(!request->headers().Host()->value().empty());
-  // Switch authority to add a shadow postfix. This allows upstream logging to make more sense.
-  auto parts = StringUtil::splitToken(request->headers().Host()->value().getStringView(), ":");
-  ASSERT(!parts.empty() && parts.size() <= 2);
-  request->headers().Host()->value(
-      parts.size() == 2
-          ? absl::StrJoin(parts, "-shadow:")
-          : absl::StrCat(request->headers().Host()->value().getStringView(), "-shadow"));
+  addShadowPostfix(request->headers());
   // This is basically fire and forget. We don't handle cancelling.
   cm_.httpAsyncClientForCluster(cluster).send(
       std::move(request), *this, Http::AsyncClient::RequestOptions().setTimeout(timeout));
 }
 
+ShadowStreamPtr ShadowWriterImpl::streamingShadow(const std::string& cluster,
+                                                  Http::HeaderMapPtr&& headers,
+                                                  std::chrono::milliseconds timeout,
+                                                  uint32_t buffer_limit, bool end_stream) {
+  if (!cm_.get(cluster)) {
+    ENVOY_LOG(debug, "shadow cluster '{}' does not exist", cluster);
+    return nullptr;
+  }
+
+  addShadowPostfix(*headers);
+  return std::make_unique<ShadowStreamImpl>(
+      cm_.httpAsyncClientForCluster(cluster), std::move(headers),
+      Http::AsyncClient::StreamOptions().setTimeout(timeout).setBufferLimit(buffer_limit),
+      end_stream);
+}
+
 } // namespace Router
 } // namespace Envoy
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <memory>
 #include <string>
 
 #include "envoy/router/shadow_writer.h"
@@ -9,6 +10,44 @@
 namespace Envoy {
 namespace Router {
 
+/**
+ * A request shadowed as it arrives. The async stream of the shadow may outlive both this object
+ * and the request being shadowed, so the state it calls back into is kept alive by the stream
+ * until it completes.
+ */
+class ShadowStreamImpl : public ShadowStream {
+public:
+  ShadowStreamImpl(Http::AsyncClient& client, Http::HeaderMapPtr&& headers,
+                   const Http::AsyncClient::StreamOptions& options, bool end_stream);
+  ~ShadowStreamImpl() override;
+
+  // Router::ShadowStream
+  void sendData(Buffer::Instance& data, bool end_stream) override;
+  void sendTrailers(const Http::HeaderMap& trailers) override;
+  bool aboveBufferLimit() const override;
+
+private:
+  struct ActiveStream : public Http::AsyncClient::StreamCallbacks {
+    // Http::AsyncClient::StreamCallbacks
+    void onHeaders(Http::HeaderMapPtr&&, bool) override {}
+    void onData(Buffer::Instance&, bool) override {}
+    void onTrailers(Http::HeaderMapPtr&&) override {}
+    void onComplete() override { onDone(); }
+    void onReset() override { onDone(); }
+
+    void onDone();
+
+    // The router of the async stream refers to the headers and trailers until it is destroyed.
+    Http::HeaderMapPtr headers_;
+    Http::HeaderMapPtr trailers_;
+    Http::AsyncClient::Stream* stream_{};
+    std::shared_ptr<ActiveStream> self_;
+  };
+
+  std::shared_ptr<ActiveStream> active_;
+  bool local_complete_{};
+};
+
 /**
  * Implementation of ShadowWriter that takes incoming requests to shadow and implements "fire and
  * forget" behavior using an async client.
@@ -22,6 +61,9 @@ public:
   // Router::ShadowWriter
   void shadow(const std::string& cluster, Http::MessagePtr&& request,
               std::chrono::milliseconds timeout) override;
+  ShadowStreamPtr streamingShadow(const std::string& cluster, Http::HeaderMapPtr&& headers,
+                                  std::chrono::milliseconds timeout, uint32_t buffer_limit,
+                                  bool end_stream) override;
 
   // Http::AsyncClient::Callbacks
   void onSuccess(Http::MessagePtr&&) override {}
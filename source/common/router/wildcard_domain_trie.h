@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * A radix trie of wildcard domains, used to find the longest wildcard domain matching a host in a
+ * single walk of the host. Suffix wildcards such as *.foo.com are held with their fixed part
+ * reversed and walked from the end of the host, while prefix wildcards such as foo.* are walked
+ * from the start. The wildcard must match at least one character, so *.foo.com does not match
+ * .foo.com. Domains are compared byte by byte, so they and the hosts should have the same case.
+ */
+template <class Value> class WildcardDomainTrie {
+public:
+  enum class Wildcard { Prefix, Suffix };
+
+  explicit WildcardDomainTrie(Wildcard wildcard) : suffix_(wildcard == Wildcard::Suffix) {}
+
+  /**
+   * Adds a wildcard domain.
+   * @param domain supplies the domain without the wildcard character, e.g. .foo.com for *.foo.com.
+   * @param value supplies the value associated with the domain.
+   * @return false if the domain has already been added.
+   */
+  bool add(absl::string_view domain, Value value) {
+    Node* node = &root_;
+    size_t depth = 0;
+    while (depth < domain.size()) {
+      const char c = at(domain, depth);
+      auto child = std::lower_bound(node->children_.begin(), node->children_.end(), c, labelBefore);
+      if (child == node->children_.end() || (*child)->label_[0] != c) {
+        auto leaf = std::make_unique<Node>();
+        for (; depth < domain.size(); depth++) {
+          leaf->label_.push_back(at(domain, depth));
+        }
+        child = node->children_.insert(child, std::move(leaf));
+        node = child->get();
+        break;
+      }
+
+      const std::string& label = (*child)->label_;
+      size_t common = 0;
+      while (common < label.size() && depth + common < domain.size() &&
+             label[common] == at(domain, depth + common)) {
+        common++;
+      }
+      if (common < label.size()) {
+        // The domain ends or diverges within the edge, so split it at that point.
+        auto split = std::make_unique<Node>();
+        split->label_ = label.substr(0, common);
+        (*child)->label_.erase(0, common);
+        split->children_.push_back(std::move(*child));
+        *child = std::move(split);
+      }
+      node = child->get();
+      depth += common;
+    }
+
+    if (node->has_value_) {
+      return false;
+    }
+    node->value_ = std::move(value);
+    node->has_value_ = true;
+    empty_ = false;
+    return true;
+  }
+
+  /**
+   * @param host supplies the host to match.
+   * @return the value of the longest wildcard domain which matches the host, or nullptr if none
+   *         does.
+   */
+  const Value* find(absl::string_view host) const {
+    const Value* longest = nullptr;
+    const Node* node = &root_;
+    size_t depth = 0;
+    // >= because *.foo.com shouldn't match .foo.com.
+    while (depth < host.size()) {
+      if (node->has_value_) {
+        longest = &node->value_;
+      }
+      const char c = at(host, depth);
+      auto child = std::lower_bound(node->children_.begin(), node->children_.end(), c, labelBefore);
+      if (child == node->children_.end() || (*child)->label_[0] != c) {
+        break;
+      }
+      const std::string& label = (*child)->label_;
+      if (label.size() > host.size() - depth) {
+        break;
+      }
+      for (size_t i = 1; i < label.size(); i++) {
+        if (label[i] != at(host, depth + i)) {
+          return longest;
+        }
+      }
+      node = child->get();
+      depth += label.size();
+    }
+    return longest;
+  }
+
+  /**
+   * @return whether no domains have been added.
+   */
+  bool empty() const { return empty_; }
+
+private:
+  struct Node {
+    // The bytes on the edge from the parent node, in the order they are walked.
+    std::string label_;
+    Value value_{};
+    bool has_value_{};
+    // Sorted by the first byte of their label, which differs between siblings.
+    std::vector<std::unique_ptr<Node>> children_;
+  };
+
+  static bool labelBefore(const std::unique_ptr<Node>& node, char c) {
+    return node->label_[0] < c;
+  }
+
+  // @return the byte of a domain or host walked at a depth.
+  char at(absl::string_view key, size_t depth) const {
+    return suffix_ ? key[key.size() - 1 - depth] : key[depth];
+  }
+
+  const bool suffix_;
+  Node root_;
+  bool empty_{true};
+};
+
+} // namespace Router
+} // namespace Envoy
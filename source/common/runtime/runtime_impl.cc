@@ -1,6 +1,7 @@
 #include "common/runtime/runtime_impl.h"
 
 #include <cstdint>
+#include <memory>
 #include <random>
 #include <string>
 #include <unordered_map>
@@ -205,8 +206,12 @@ bool SnapshotImpl::featureEnabled(const std::string& key, uint64_t default_value
 }
 
 bool SnapshotImpl::featureEnabled(const std::string& key, uint64_t default_value) const {
+  return featureEnabled(find(key), default_value);
+}
+
+bool SnapshotImpl::featureEnabled(const Entry* entry, uint64_t default_value) const {
   // Avoid PRNG if we know we don't need it.
-  uint64_t cutoff = std::min(getInteger(key, default_value), static_cast<uint64_t>(100));
+  uint64_t cutoff = std::min(getInteger(entry, default_value), static_cast<uint64_t>(100));
   if (cutoff == 0) {
     return false;
   } else if (cutoff == 100) {
@@ -238,22 +243,27 @@ bool SnapshotImpl::featureEnabled(const std::string& key,
 bool SnapshotImpl::featureEnabled(const std::string& key,
                                   const envoy::type::FractionalPercent& default_value,
                                   uint64_t random_value) const {
-  const auto& entry = values_.find(key);
+  return featureEnabled(find(key), default_value, random_value);
+}
+
+bool SnapshotImpl::featureEnabled(const Entry* entry,
+                                  const envoy::type::FractionalPercent& default_value,
+                                  uint64_t random_value) {
   envoy::type::FractionalPercent percent;
-  if (entry != values_.end() && entry->second.fractional_percent_value_.has_value()) {
-    percent = entry->second.fractional_percent_value_.value();
-  } else if (entry != values_.end() && entry->second.uint_value_.has_value()) {
+  if (entry != nullptr && entry->fractional_percent_value_.has_value()) {
+    percent = entry->fractional_percent_value_.value();
+  } else if (entry != nullptr && entry->uint_value_.has_value()) {
     // Check for > 100 because the runtime value is assumed to be specified as
     // an integer, and it also ensures that truncating the uint64_t runtime
     // value into a uint32_t percent numerator later is safe
-    if (entry->second.uint_value_.value() > 100) {
+    if (entry->uint_value_.value() > 100) {
       return true;
     }
 
     // The runtime value was specified as an integer rather than a fractional
     // percent proto. To preserve legacy semantics, we treat it as a percentage
     // (i.e. denominator of 100).
-    percent.set_numerator(entry->second.uint_value_.value());
+    percent.set_numerator(entry->uint_value_.value());
     percent.set_denominator(envoy::type::FractionalPercent::HUNDRED);
   } else {
     percent = default_value;
@@ -263,18 +273,58 @@ bool SnapshotImpl::featureEnabled(const std::string& key,
 }
 
 uint64_t SnapshotImpl::getInteger(const std::string& key, uint64_t default_value) const {
-  auto entry = values_.find(key);
-  if (entry == values_.end() || !entry->second.uint_value_) {
+  return getInteger(find(key), default_value);
+}
+
+uint64_t SnapshotImpl::getInteger(const Entry* entry, uint64_t default_value) {
+  if (entry == nullptr || !entry->uint_value_) {
     return default_value;
   } else {
-    return entry->second.uint_value_.value();
+    return entry->uint_value_.value();
   }
 }
 
+bool SnapshotImpl::featureEnabled(const Key& key, uint64_t default_value) const {
+  return featureEnabled(find(key), default_value);
+}
+
+bool SnapshotImpl::featureEnabled(const Key& key, uint64_t default_value,
+                                  uint64_t random_value) const {
+  return random_value % 100 <
+         std::min(getInteger(find(key), default_value), static_cast<uint64_t>(100));
+}
+
+bool SnapshotImpl::featureEnabled(const Key& key,
+                                  const envoy::type::FractionalPercent& default_value) const {
+  return featureEnabled(find(key), default_value, generator_.random());
+}
+
+bool SnapshotImpl::featureEnabled(const Key& key,
+                                  const envoy::type::FractionalPercent& default_value,
+                                  uint64_t random_value) const {
+  return featureEnabled(find(key), default_value, random_value);
+}
+
+uint64_t SnapshotImpl::getInteger(const Key& key, uint64_t default_value) const {
+  return getInteger(find(key), default_value);
+}
+
+const Snapshot::Entry* SnapshotImpl::find(absl::string_view key) const {
+  const auto entry = values_.find(key);
+  return entry != values_.end() ? &entry->second : nullptr;
+}
+
+const Snapshot::Entry* SnapshotImpl::find(const Key& key) const {
+  if (key.index() < indexed_values_.size()) {
+    return indexed_values_[key.index()];
+  }
+  return find(key.name());
+}
+
 bool SnapshotImpl::getBoolean(absl::string_view key, bool& value) const {
-  auto entry = values_.find(key);
-  if (entry != values_.end() && entry->second.bool_value_.has_value()) {
-    value = entry->second.bool_value_.value();
+  const Entry* entry = find(key);
+  if (entry != nullptr && entry->bool_value_.has_value()) {
+    value = entry->bool_value_.value();
     return true;
   }
   return false;
@@ -294,6 +344,10 @@ SnapshotImpl::SnapshotImpl(RandomGenerator& generator, RuntimeStats& stats,
     }
   }
   stats.num_keys_.set(values_.size());
+
+  // The values map is not modified anymore, so that the pointers to its entries remain valid.
+  KeyRegistry::get().iterate(
+      [this](const std::string& name) -> void { indexed_values_.push_back(find(name)); });
 }
 
 SnapshotImpl::Entry SnapshotImpl::createEntry(const std::string& value) {
@@ -571,10 +625,7 @@ void LoaderImpl::loadNewSnapshot() {
     return std::static_pointer_cast<ThreadLocal::ThreadLocalObject>(ptr);
   });
 
-  {
-    absl::MutexLock lock(&snapshot_mutex_);
-    thread_safe_snapshot_ = ptr;
-  }
+  std::atomic_store(&thread_safe_snapshot_, std::shared_ptr<const Snapshot>(std::move(ptr)));
 }
 
 const Snapshot& LoaderImpl::snapshot() {
@@ -587,10 +638,7 @@ std::shared_ptr<const Snapshot> LoaderImpl::threadsafeSnapshot() {
     return std::dynamic_pointer_cast<const Snapshot>(tls_->get());
   }
 
-  {
-    absl::ReaderMutexLock lock(&snapshot_mutex_);
-    return thread_safe_snapshot_;
-  }
+  return std::atomic_load(&thread_safe_snapshot_);
 }
 
 void LoaderImpl::mergeValues(const std::unordered_map<std::string, std::string>& values) {
@@ -23,6 +23,7 @@
 #include "common/common/logger.h"
 #include "common/common/thread.h"
 #include "common/init/target_impl.h"
+#include "common/runtime/runtime_keys.h"
 #include "common/singleton/threadsafe_singleton.h"
 
 #include "spdlog/spdlog.h"
@@ -92,6 +93,13 @@ public:
                       uint64_t random_value) const override;
   const std::string& get(const std::string& key) const override;
   uint64_t getInteger(const std::string& key, uint64_t default_value) const override;
+  bool featureEnabled(const Key& key, uint64_t default_value) const override;
+  bool featureEnabled(const Key& key, uint64_t default_value, uint64_t random_value) const override;
+  bool featureEnabled(const Key& key,
+                      const envoy::type::FractionalPercent& default_value) const override;
+  bool featureEnabled(const Key& key, const envoy::type::FractionalPercent& default_value,
+                      uint64_t random_value) const override;
+  uint64_t getInteger(const Key& key, uint64_t default_value) const override;
   const std::vector<OverrideLayerConstPtr>& getLayers() const override;
 
   static Entry createEntry(const std::string& value);
@@ -116,8 +124,19 @@ private:
   static bool parseEntryUintValue(Entry& entry);
   static void parseEntryFractionalPercentValue(Entry& entry);
 
+  const Entry* find(absl::string_view key) const;
+  const Entry* find(const Key& key) const;
+  bool featureEnabled(const Entry* entry, uint64_t default_value) const;
+  static bool featureEnabled(const Entry* entry,
+                             const envoy::type::FractionalPercent& default_value,
+                             uint64_t random_value);
+  static uint64_t getInteger(const Entry* entry, uint64_t default_value);
+
   const std::vector<OverrideLayerConstPtr> layers_;
   EntryMap values_;
+  // The values of the registered keys, by key index, or nullptr for the keys without a value. Keys
+  // registered after the snapshot was created are looked up by name.
+  std::vector<const Entry*> indexed_values_;
   RandomGenerator& generator_;
   RuntimeStats& stats_;
 };
@@ -269,8 +288,9 @@ private:
   std::vector<RtdsSubscriptionPtr> subscriptions_;
   Upstream::ClusterManager* cm_{};
 
-  absl::Mutex snapshot_mutex_;
-  std::shared_ptr<const Snapshot> thread_safe_snapshot_ GUARDED_BY(snapshot_mutex_);
+  // Published and read with the atomic shared_ptr operations, so that the readers on non-worker
+  // threads never contend on a lock. A replaced snapshot is freed once its last reader releases it.
+  std::shared_ptr<const Snapshot> thread_safe_snapshot_;
 };
 
 } // namespace Runtime
@@ -0,0 +1,34 @@
+#include "common/runtime/runtime_keys.h"
+
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+
+namespace Envoy {
+namespace Runtime {
+
+Key::Key(absl::string_view name) : name_(name), index_(KeyRegistry::get().registerKey(name)) {}
+
+KeyRegistry& KeyRegistry::get() { MUTABLE_CONSTRUCT_ON_FIRST_USE(KeyRegistry); }
+
+uint32_t KeyRegistry::registerKey(absl::string_view name) {
+  Thread::LockGuard lock(mutex_);
+  const auto it = indexes_.find(name);
+  if (it != indexes_.end()) {
+    return it->second;
+  }
+
+  const uint32_t index = names_.size();
+  names_.emplace_back(name);
+  indexes_.emplace(name, index);
+  return index;
+}
+
+void KeyRegistry::iterate(const std::function<void(const std::string& name)>& cb) const {
+  Thread::LockGuard lock(mutex_);
+  for (const std::string& name : names_) {
+    cb(name);
+  }
+}
+
+} // namespace Runtime
+} // namespace Envoy
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "common/common/thread.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Runtime {
+
+/**
+ * A runtime key registered ahead of its lookups, typically at configuration time. Registering a
+ * key assigns it a process-wide index, with which snapshots look its value up in an array rather
+ * than hashing its name. As registered keys are never forgotten, keys whose names are built per
+ * request, e.g. from the downstream cluster, should be looked up by name instead.
+ */
+class Key {
+public:
+  /**
+   * Register a key, or get the index of a key registered already.
+   * @param name supplies the name of the key.
+   */
+  explicit Key(absl::string_view name);
+
+  /**
+   * @return const std::string& the name of the key.
+   */
+  const std::string& name() const { return name_; }
+
+  /**
+   * @return uint32_t the index of the key, shared by all the keys with the same name.
+   */
+  uint32_t index() const { return index_; }
+
+private:
+  const std::string name_;
+  const uint32_t index_;
+};
+
+/**
+ * The process-wide registry of the runtime keys. Keys may be registered from any thread.
+ */
+class KeyRegistry {
+public:
+  static KeyRegistry& get();
+
+  /**
+   * @return uint32_t the index of a key, registering it if needed.
+   */
+  uint32_t registerKey(absl::string_view name);
+
+  /**
+   * Iterate over the registered keys, by increasing index.
+   * @param cb supplies the callback invoked with the name of each key. Keys must not be registered
+   *        from it.
+   */
+  void iterate(const std::function<void(const std::string& name)>& cb) const;
+
+private:
+  mutable Thread::MutexBasicLockable mutex_;
+  std::vector<std::string> names_ GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, uint32_t> indexes_ GUARDED_BY(mutex_);
+};
+
+} // namespace Runtime
+} // namespace Envoy
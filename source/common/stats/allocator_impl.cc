@@ -1,5 +1,7 @@
 #include "common/stats/allocator_impl.h"
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 
 #include "envoy/stats/stats.h"
@@ -142,20 +144,27 @@ public:
   // Stats::Gauge
   void add(uint64_t amount) override {
     value_ += amount;
-    flags_ |= Flags::Used;
+    flags_ |= amount != 0 ? (Flags::Used | Flags::Changed) : Flags::Used;
   }
   void dec() override { sub(1); }
   void inc() override { add(1); }
   void set(uint64_t value) override {
-    value_ = value;
-    flags_ |= Flags::Used;
+    flags_ |= value_.exchange(value) != value ? (Flags::Used | Flags::Changed) : Flags::Used;
   }
   void sub(uint64_t amount) override {
     ASSERT(value_ >= amount);
     ASSERT(used() || amount == 0);
     value_ -= amount;
+    if (amount != 0) {
+      flags_ |= Flags::Changed;
+    }
   }
   uint64_t value() const override { return value_; }
+  bool latchChanged() override {
+    // Setting the flag is not ordered with updating the value, so a change racing with the flush
+    // may be reported in the following one instead.
+    return flags_.fetch_and(static_cast<uint16_t>(~Flags::Changed)) & Flags::Changed;
+  }
 
   ImportMode importMode() const override {
     if (flags_ & Flags::NeverImport) {
@@ -194,19 +203,97 @@ public:
   }
 };
 
-CounterSharedPtr AllocatorImpl::makeCounter(StatName name, absl::string_view tag_extracted_name,
-                                            const std::vector<Tag>& tags) {
+namespace {
+
+// Assigns the shards of the sharded counters to the threads in turn.
+std::atomic<uint32_t> next_counter_shard{0};
+
+uint32_t counterShard() {
+  static thread_local const uint32_t shard =
+      next_counter_shard++ % AllocatorImpl::NumCounterShards;
+  return shard;
+}
+
+} // namespace
+
+constexpr uint32_t AllocatorImpl::NumCounterShards;
+
+class ShardedCounterImpl : public StatsSharedImpl<Counter> {
+public:
+  ShardedCounterImpl(StatName name, AllocatorImpl& alloc, absl::string_view tag_extracted_name,
+                     const std::vector<Tag>& tags)
+      : StatsSharedImpl(name, alloc, tag_extracted_name, tags) {}
+  ~ShardedCounterImpl() override { alloc_.removeCounterFromSet(this); }
+
+  // Stats::Counter
+  void add(uint64_t amount) override {
+    Shard& shard = shards_[counterShard()];
+    shard.value_.fetch_add(amount, std::memory_order_relaxed);
+    shard.pending_increment_.fetch_add(amount, std::memory_order_relaxed);
+    // The flags share a cache line with the other stats, so they are only written once.
+    if (!(flags_.load(std::memory_order_relaxed) & Flags::Used)) {
+      flags_ |= Flags::Used;
+    }
+  }
+  void inc() override { add(1); }
+  uint64_t latch() override {
+    uint64_t pending = 0;
+    for (Shard& shard : shards_) {
+      pending += shard.pending_increment_.exchange(0);
+    }
+    return pending;
+  }
+  void reset() override {
+    for (Shard& shard : shards_) {
+      shard.value_ = 0;
+    }
+  }
+  uint64_t value() const override {
+    uint64_t value = 0;
+    for (const Shard& shard : shards_) {
+      value += shard.value_.load(std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+private:
+  // Rather than aligning the shards, which new does not honor in C++14, a cache line of padding
+  // separates the values of neighbouring shards, wherever the counter is allocated.
+  struct Shard {
+    std::atomic<uint64_t> value_{0};
+    std::atomic<uint64_t> pending_increment_{0};
+    char padding_[64];
+  };
+
+  std::array<Shard, AllocatorImpl::NumCounterShards> shards_;
+};
+
+template <class CounterType>
+CounterSharedPtr AllocatorImpl::makeCounterInternal(StatName name,
+                                                    absl::string_view tag_extracted_name,
+                                                    const std::vector<Tag>& tags) {
   Thread::LockGuard lock(mutex_);
   ASSERT(gauges_.find(name) == gauges_.end());
   auto iter = counters_.find(name);
   if (iter != counters_.end()) {
     return CounterSharedPtr(*iter);
   }
-  auto counter = CounterSharedPtr(new CounterImpl(name, *this, tag_extracted_name, tags));
+  auto counter = CounterSharedPtr(new CounterType(name, *this, tag_extracted_name, tags));
   counters_.insert(counter.get());
   return counter;
 }
 
+CounterSharedPtr AllocatorImpl::makeCounter(StatName name, absl::string_view tag_extracted_name,
+                                            const std::vector<Tag>& tags) {
+  return makeCounterInternal<CounterImpl>(name, tag_extracted_name, tags);
+}
+
+CounterSharedPtr AllocatorImpl::makeShardedCounter(StatName name,
+                                                   absl::string_view tag_extracted_name,
+                                                   const std::vector<Tag>& tags) {
+  return makeCounterInternal<ShardedCounterImpl>(name, tag_extracted_name, tags);
+}
+
 GaugeSharedPtr AllocatorImpl::makeGauge(StatName name, absl::string_view tag_extracted_name,
                                         const std::vector<Tag>& tags,
                                         Gauge::ImportMode import_mode) {
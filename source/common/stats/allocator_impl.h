@@ -1,11 +1,13 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include "envoy/stats/allocator.h"
 #include "envoy/stats/stats.h"
 #include "envoy/stats/symbol_table.h"
 
+#include "common/common/mutex_tracer_impl.h"
 #include "common/stats/metric_impl.h"
 
 #include "absl/container/flat_hash_set.h"
@@ -25,6 +27,8 @@ public:
   // Allocator
   CounterSharedPtr makeCounter(StatName name, absl::string_view tag_extracted_name,
                                const std::vector<Tag>& tags) override;
+  CounterSharedPtr makeShardedCounter(StatName name, absl::string_view tag_extracted_name,
+                                      const std::vector<Tag>& tags) override;
   GaugeSharedPtr makeGauge(StatName name, absl::string_view tag_extracted_name,
                            const std::vector<Tag>& tags, Gauge::ImportMode import_mode) override;
   SymbolTable& symbolTable() override { return symbol_table_; }
@@ -34,7 +38,14 @@ public:
   void debugPrint();
 #endif
 
+  // The number of shards of a sharded counter. Threads beyond that share shards.
+  static constexpr uint32_t NumCounterShards = 16;
+
 private:
+  template <class CounterType>
+  CounterSharedPtr makeCounterInternal(StatName name, absl::string_view tag_extracted_name,
+                                       const std::vector<Tag>& tags);
+
   struct HeapStatHash {
     using is_transparent = void;
     size_t operator()(const Metric* a) const { return a->statName().hash(); }
@@ -65,6 +76,7 @@ private:
   // free() operations are made from the destructors of the individual stat objects, which are not
   // protected by locks.
   Thread::MutexBasicLockable mutex_;
+  MutexContentionName mutex_name_{mutex_.contentionId(), "stats.allocator"};
 };
 
 } // namespace Stats
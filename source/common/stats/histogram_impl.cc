@@ -10,19 +10,45 @@
 namespace Envoy {
 namespace Stats {
 
-HistogramStatisticsImpl::HistogramStatisticsImpl(const histogram_t* histogram_ptr)
-    : computed_quantiles_(supportedQuantiles().size(), 0.0) {
-  hist_approx_quantile(histogram_ptr, supportedQuantiles().data(), supportedQuantiles().size(),
-                       computed_quantiles_.data());
-
-  sample_count_ = hist_sample_count(histogram_ptr);
-  sample_sum_ = hist_approx_sum(histogram_ptr);
+HistogramSettingsImpl::HistogramSettingsImpl(
+    const envoy::config::metrics::v2::StatsConfig& config) {
+  configs_.reserve(config.histogram_bucket_settings_size());
+  for (const auto& settings : config.histogram_bucket_settings()) {
+    std::vector<double> buckets(settings.buckets().begin(), settings.buckets().end());
+    std::sort(buckets.begin(), buckets.end());
+    buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+    configs_.emplace_back(Matchers::StringMatcher(settings.match()), std::move(buckets));
+  }
+}
 
-  const std::vector<double>& supported_buckets = supportedBuckets();
-  computed_buckets_.reserve(supported_buckets.size());
-  for (const auto bucket : supported_buckets) {
-    computed_buckets_.emplace_back(hist_approx_count_below(histogram_ptr, bucket));
+const std::vector<double>& HistogramSettingsImpl::buckets(const std::string& stat_name) const {
+  for (const auto& config : configs_) {
+    if (config.first.match(stat_name)) {
+      return config.second;
+    }
   }
+  return defaultBuckets();
+}
+
+const std::vector<double>& HistogramSettingsImpl::defaultBuckets() {
+  static const std::vector<double> default_buckets = {
+      0.5,  1,    5,     10,    25,    50,     100,    250,     500,    1000,
+      2500, 5000, 10000, 30000, 60000, 300000, 600000, 1800000, 3600000};
+  return default_buckets;
+}
+
+HistogramStatisticsImpl::HistogramStatisticsImpl(const histogram_t* histogram_ptr,
+                                                 const std::vector<double>& supported_buckets)
+    : HistogramStatisticsImpl(supported_buckets) {
+  refresh(histogram_ptr);
+}
+
+void HistogramStatisticsImpl::swap(HistogramStatisticsImpl& other) {
+  computed_quantiles_.swap(other.computed_quantiles_);
+  std::swap(supported_buckets_, other.supported_buckets_);
+  computed_buckets_.swap(other.computed_buckets_);
+  std::swap(sample_count_, other.sample_count_);
+  std::swap(sample_sum_, other.sample_sum_);
 }
 
 const std::vector<double>& HistogramStatisticsImpl::supportedQuantiles() const {
@@ -31,13 +57,6 @@ const std::vector<double>& HistogramStatisticsImpl::supportedQuantiles() const {
   return supported_quantiles;
 }
 
-const std::vector<double>& HistogramStatisticsImpl::supportedBuckets() const {
-  static const std::vector<double> supported_buckets = {
-      0.5,  1,    5,     10,    25,    50,     100,    250,     500,    1000,
-      2500, 5000, 10000, 30000, 60000, 300000, 600000, 1800000, 3600000};
-  return supported_buckets;
-}
-
 std::string HistogramStatisticsImpl::quantileSummary() const {
   std::vector<std::string> summary;
   const std::vector<double>& supported_quantiles = supportedQuantiles();
@@ -70,12 +89,11 @@ void HistogramStatisticsImpl::refresh(const histogram_t* new_histogram_ptr) {
   sample_count_ = hist_sample_count(new_histogram_ptr);
   sample_sum_ = hist_approx_sum(new_histogram_ptr);
 
+  // The buckets are computed here, once per merge, rather than each time they are output.
   ASSERT(supportedBuckets().size() == computed_buckets_.size());
-  computed_buckets_.clear();
   const std::vector<double>& supported_buckets = supportedBuckets();
-  computed_buckets_.reserve(supported_buckets.size());
-  for (const auto bucket : supported_buckets) {
-    computed_buckets_.emplace_back(hist_approx_count_below(new_histogram_ptr, bucket));
+  for (size_t i = 0; i < supported_buckets.size(); ++i) {
+    computed_buckets_[i] = hist_approx_count_below(new_histogram_ptr, supported_buckets[i]);
   }
 }
 
@@ -2,11 +2,15 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "envoy/config/metrics/v2/stats.pb.h"
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/stats.h"
 #include "envoy/stats/store.h"
 
+#include "common/common/matchers.h"
 #include "common/common/non_copyable.h"
 #include "common/stats/metric_impl.h"
 
@@ -15,33 +19,69 @@
 namespace Envoy {
 namespace Stats {
 
+/**
+ * The bucket boundaries of the histograms, from the histogram_bucket_settings of a StatsConfig.
+ */
+class HistogramSettingsImpl : public HistogramSettings {
+public:
+  explicit HistogramSettingsImpl(const envoy::config::metrics::v2::StatsConfig& config);
+
+  // HistogramSettings
+  const std::vector<double>& buckets(const std::string& stat_name) const override;
+
+  /**
+   * @return the buckets of the histograms not matched by any setting.
+   */
+  static const std::vector<double>& defaultBuckets();
+
+private:
+  std::vector<std::pair<Matchers::StringMatcher, std::vector<double>>> configs_;
+};
+
 /**
  * Implementation of HistogramStatistics for circllhist.
  */
 class HistogramStatisticsImpl : public HistogramStatistics, NonCopyable {
 public:
-  HistogramStatisticsImpl() : computed_quantiles_(supportedQuantiles().size(), 0.0) {}
+  /**
+   * @param supported_buckets the buckets to compute, which must outlive the object.
+   */
+  explicit HistogramStatisticsImpl(
+      const std::vector<double>& supported_buckets = HistogramSettingsImpl::defaultBuckets())
+      : computed_quantiles_(supportedQuantiles().size(), 0.0),
+        supported_buckets_(&supported_buckets), computed_buckets_(supported_buckets.size(), 0),
+        sample_count_(0), sample_sum_(0) {}
+
   /**
    * HistogramStatisticsImpl object is constructed using the passed in histogram.
    * @param histogram_ptr pointer to the histogram for which stats will be calculated. This pointer
    * will not be retained.
+   * @param supported_buckets the buckets to compute, which must outlive the object.
    */
-  HistogramStatisticsImpl(const histogram_t* histogram_ptr);
+  HistogramStatisticsImpl(
+      const histogram_t* histogram_ptr,
+      const std::vector<double>& supported_buckets = HistogramSettingsImpl::defaultBuckets());
 
   void refresh(const histogram_t* new_histogram_ptr);
 
+  /**
+   * Exchanges the computed values with those of another object, without copying them.
+   */
+  void swap(HistogramStatisticsImpl& other);
+
   // HistogramStatistics
   std::string quantileSummary() const override;
   std::string bucketSummary() const override;
   const std::vector<double>& supportedQuantiles() const override;
   const std::vector<double>& computedQuantiles() const override { return computed_quantiles_; }
-  const std::vector<double>& supportedBuckets() const override;
+  const std::vector<double>& supportedBuckets() const override { return *supported_buckets_; }
   const std::vector<uint64_t>& computedBuckets() const override { return computed_buckets_; }
   uint64_t sampleCount() const override { return sample_count_; }
   double sampleSum() const override { return sample_sum_; }
 
 private:
   std::vector<double> computed_quantiles_;
+  const std::vector<double>* supported_buckets_;
   std::vector<uint64_t> computed_buckets_;
   uint64_t sample_count_;
   double sample_sum_;
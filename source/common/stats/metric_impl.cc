@@ -20,6 +20,13 @@ MetricHelper::MetricHelper(absl::string_view name, absl::string_view tag_extract
   // required bytes. 2 is added to account for the name and tag_extracted_name,
   // and we multiply the number of tags by 2 to account for the name and value
   // of each tag.
+  //
+  // Stats without tags usually have a tag-extracted name equal to their name,
+  // in which case only the name is stored, and is used for both.
+  if (tags.empty() && tag_extracted_name == name) {
+    symbol_table.populateList(&name, 1, stat_names_);
+    return;
+  }
   const uint32_t num_names = 2 + 2 * tags.size();
   STACK_ARRAY(names, absl::string_view, num_names);
   names[0] = name;
@@ -44,17 +51,18 @@ StatName MetricHelper::statName() const {
 StatName MetricHelper::tagExtractedStatName() const {
   // The name is the first element in stat_names_. The second is the
   // tag-extracted-name. We don't have random access in that format,
-  // so we iterate through them, skipping the first element (name),
+  // so we iterate through them, capturing the first element (name),
   // and terminating the iteration after capturing the tag-extracted
-  // name by returning false from the lambda.
+  // name by returning false from the lambda. If there is no second
+  // element, the tag-extracted name is the name.
   StatName tag_extracted_stat_name;
   bool skip = true;
   stat_names_.iterate([&tag_extracted_stat_name, &skip](StatName s) -> bool {
+    tag_extracted_stat_name = s;
     if (skip) {
       skip = false;
       return true;
     }
-    tag_extracted_stat_name = s;
     return false; // Returning 'false' stops the iteration.
   });
   return tag_extracted_stat_name;
@@ -13,64 +13,67 @@ void StatMerger::mergeCounters(const Protobuf::Map<std::string, uint64_t>& count
 
 void StatMerger::mergeGauges(const Protobuf::Map<std::string, uint64_t>& gauges) {
   for (const auto& gauge : gauges) {
-    // Merging gauges via RPC from the parent has 3 cases; case 1 and 3b are the
-    // most common.
-    //
-    // 1. Child thinks gauge is Accumulate : data is combined in
-    //    gauge_ref.add() below.
-    // 2. Child thinks gauge is NeverImport: we skip this loop entry via
-    //    'continue'.
-    // 3. Child has not yet initialized gauge yet -- this merge is the
-    //    first time the child learns of the gauge. It's possible the child
-    //    will think the gauge is NeverImport due to a code change. But for
-    //    now we will leave the gauge in the child process as
-    //    import_mode==Uninitialized, and accumulate the parent value in
-    //    gauge_ref.add(). Gauges in this mode will not be included in
-    //    stats-sinks or the admin /stats calls, until the child initializes
-    //    the gauge, in which case:
-    // 3a. Child later initializes gauges as NeverImport: the parent value is
-    //     cleared during the mergeImportMode call.
-    // 3b. Child later initializes gauges as Accumulate: the parent value is
-    //     retained.
-
     StatNameManagedStorage storage(gauge.first, temp_scope_->symbolTable());
-    StatName stat_name = storage.statName();
-    OptionalGauge gauge_opt = temp_scope_->findGauge(stat_name);
+    mergeGauge(storage.statName(), gauge.second);
+  }
+}
 
-    Gauge::ImportMode import_mode = Gauge::ImportMode::Uninitialized;
-    if (gauge_opt) {
-      import_mode = gauge_opt->get().importMode();
-      if (import_mode == Gauge::ImportMode::NeverImport) {
-        continue;
-      }
-    }
+void StatMerger::mergeGauge(StatName stat_name, uint64_t value) {
+  // Merging gauges via RPC from the parent has 3 cases; case 1 and 3b are the
+  // most common.
+  //
+  // 1. Child thinks gauge is Accumulate : data is combined in
+  //    gauge_ref.add() below.
+  // 2. Child thinks gauge is NeverImport: we skip this gauge via
+  //    'return'.
+  // 3. Child has not yet initialized gauge yet -- this merge is the
+  //    first time the child learns of the gauge. It's possible the child
+  //    will think the gauge is NeverImport due to a code change. But for
+  //    now we will leave the gauge in the child process as
+  //    import_mode==Uninitialized, and accumulate the parent value in
+  //    gauge_ref.add(). Gauges in this mode will not be included in
+  //    stats-sinks or the admin /stats calls, until the child initializes
+  //    the gauge, in which case:
+  // 3a. Child later initializes gauges as NeverImport: the parent value is
+  //     cleared during the mergeImportMode call.
+  // 3b. Child later initializes gauges as Accumulate: the parent value is
+  //     retained.
 
-    auto& gauge_ref = temp_scope_->gaugeFromStatName(stat_name, import_mode);
-    if (gauge_ref.importMode() == Gauge::ImportMode::NeverImport) {
-      // On the first iteration through the loop, the gauge will not be loaded into the scope
-      // cache even though it might exist in another scope. Thus, we need to check again for
-      // the import status to see if we should skip this gauge.
-      //
-      // TODO(mattklein123): There is a race condition here. It's technically possible that
-      // between the time we created this stat, the stat might be created by the child as a
-      // never import stat, making the below math invalid. A follow up solution is to take the
-      // store lock starting from gaugeFromStatName() to the end of this function, but this will
-      // require adding some type of mergeGauge() function to the scope and dealing with recursive
-      // lock acquisition, etc. so we will leave this as a follow up. This race should be incredibly
-      // rare.
-      continue;
-    }
+  OptionalGauge gauge_opt = temp_scope_->findGauge(stat_name);
 
-    uint64_t& parent_value_ref = parent_gauge_values_[gauge_ref.statName()];
-    uint64_t old_parent_value = parent_value_ref;
-    uint64_t new_parent_value = gauge.second;
-    parent_value_ref = new_parent_value;
+  Gauge::ImportMode import_mode = Gauge::ImportMode::Uninitialized;
+  if (gauge_opt) {
+    import_mode = gauge_opt->get().importMode();
+    if (import_mode == Gauge::ImportMode::NeverImport) {
+      return;
+    }
+  }
 
-    // Note that new_parent_value may be less than old_parent_value, in which
-    // case 2s complement does its magic (-1 == 0xffffffffffffffff) and adding
-    // that to the gauge's current value works the same as subtraction.
-    gauge_ref.add(new_parent_value - old_parent_value);
+  auto& gauge_ref = temp_scope_->gaugeFromStatName(stat_name, import_mode);
+  if (gauge_ref.importMode() == Gauge::ImportMode::NeverImport) {
+    // The first time the gauge is merged, it will not be loaded into the scope
+    // cache even though it might exist in another scope. Thus, we need to check again for
+    // the import status to see if we should skip this gauge.
+    //
+    // TODO(mattklein123): There is a race condition here. It's technically possible that
+    // between the time we created this stat, the stat might be created by the child as a
+    // never import stat, making the below math invalid. A follow up solution is to take the
+    // store lock starting from gaugeFromStatName() to the end of this function, but this will
+    // require adding some type of mergeGauge() function to the scope and dealing with recursive
+    // lock acquisition, etc. so we will leave this as a follow up. This race should be incredibly
+    // rare.
+    return;
   }
+
+  uint64_t& parent_value_ref = parent_gauge_values_[gauge_ref.statName()];
+  uint64_t old_parent_value = parent_value_ref;
+  uint64_t new_parent_value = value;
+  parent_value_ref = new_parent_value;
+
+  // Note that new_parent_value may be less than old_parent_value, in which
+  // case 2s complement does its magic (-1 == 0xffffffffffffffff) and adding
+  // that to the gauge's current value works the same as subtraction.
+  gauge_ref.add(new_parent_value - old_parent_value);
 }
 
 void StatMerger::mergeStats(const Protobuf::Map<std::string, uint64_t>& counter_deltas,
@@ -79,5 +82,14 @@ void StatMerger::mergeStats(const Protobuf::Map<std::string, uint64_t>& counter_
   mergeGauges(gauges);
 }
 
+void StatMerger::mergeStats(const StatNameValues& counter_deltas, const StatNameValues& gauges) {
+  for (const auto& counter : counter_deltas) {
+    temp_scope_->counterFromStatName(counter.first).add(counter.second);
+  }
+  for (const auto& gauge : gauges) {
+    mergeGauge(gauge.first, gauge.second);
+  }
+}
+
 } // namespace Stats
 } // namespace Envoy
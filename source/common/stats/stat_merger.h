@@ -1,5 +1,8 @@
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include "envoy/stats/store.h"
 
 #include "common/protobuf/protobuf.h"
@@ -14,6 +17,8 @@ namespace Stats {
 // (typically hot restart parent+child) Envoy processes.
 class StatMerger {
 public:
+  using StatNameValues = std::vector<std::pair<StatName, uint64_t>>;
+
   StatMerger(Stats::Store& target_store);
 
   // Merge the values of stats_proto into stats_store. Counters are always straightforward
@@ -21,9 +26,14 @@ public:
   void mergeStats(const Protobuf::Map<std::string, uint64_t>& counter_deltas,
                   const Protobuf::Map<std::string, uint64_t>& gauges);
 
+  // Same as above, for stats whose names are already encoded in the symbol table of the target
+  // store, which saves encoding each name again.
+  void mergeStats(const StatNameValues& counter_deltas, const StatNameValues& gauges);
+
 private:
   void mergeCounters(const Protobuf::Map<std::string, uint64_t>& counter_deltas);
   void mergeGauges(const Protobuf::Map<std::string, uint64_t>& gauges);
+  void mergeGauge(StatName stat_name, uint64_t value);
   StatNameHashMap<uint64_t> parent_gauge_values_;
   // A stats Scope for our in-the-merging-process counters to live in. Scopes conceptually hold
   // shared_ptrs to the stats that live in them, with the question of which stats are living in a
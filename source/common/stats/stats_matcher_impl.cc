@@ -10,22 +10,25 @@ namespace Stats {
 
 // TODO(ambuc): Refactor this into common/matchers.cc, since StatsMatcher is really just a thin
 // wrapper around what might be called a StringMatcherList.
-StatsMatcherImpl::StatsMatcherImpl(const envoy::config::metrics::v2::StatsConfig& config) {
-  switch (config.stats_matcher().stats_matcher_case()) {
+StatsMatcherImpl::StatsMatcherImpl(const envoy::config::metrics::v2::StatsConfig& config)
+    : StatsMatcherImpl(config.stats_matcher()) {}
+
+StatsMatcherImpl::StatsMatcherImpl(const envoy::config::metrics::v2::StatsMatcher& config) {
+  switch (config.stats_matcher_case()) {
   case envoy::config::metrics::v2::StatsMatcher::kRejectAll:
     // In this scenario, there are no matchers to store.
-    is_inclusive_ = !config.stats_matcher().reject_all();
+    is_inclusive_ = !config.reject_all();
     break;
   case envoy::config::metrics::v2::StatsMatcher::kInclusionList:
     // If we have an inclusion list, we are being default-exclusive.
-    for (const auto& stats_matcher : config.stats_matcher().inclusion_list().patterns()) {
+    for (const auto& stats_matcher : config.inclusion_list().patterns()) {
       matchers_.push_back(Matchers::StringMatcher(stats_matcher));
     }
     is_inclusive_ = false;
     break;
   case envoy::config::metrics::v2::StatsMatcher::kExclusionList:
     // If we have an exclusion list, we are being default-inclusive.
-    for (const auto& stats_matcher : config.stats_matcher().exclusion_list().patterns()) {
+    for (const auto& stats_matcher : config.exclusion_list().patterns()) {
       matchers_.push_back(Matchers::StringMatcher(stats_matcher));
     }
     FALLTHRU;
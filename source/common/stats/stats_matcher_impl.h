@@ -19,6 +19,7 @@ namespace Stats {
 class StatsMatcherImpl : public StatsMatcher {
 public:
   explicit StatsMatcherImpl(const envoy::config::metrics::v2::StatsConfig& config);
+  explicit StatsMatcherImpl(const envoy::config::metrics::v2::StatsMatcher& config);
 
   // Default constructor simply allows everything.
   StatsMatcherImpl() = default;
@@ -119,15 +119,30 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
   // We want to hold the lock for the minimum amount of time, so we do the
   // string-splitting and prepare a temp vector of Symbol first.
   const std::vector<absl::string_view> tokens = absl::StrSplit(name, '.');
-  std::vector<Symbol> symbols;
-  symbols.reserve(tokens.size());
+  std::vector<Symbol> symbols(tokens.size());
 
-  // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
+  // Now populate the Symbol objects, which involves bumping ref-counts in this.
+  // The tokens with established symbols only need the lock shared, so that
+  // threads encoding known names at request time do not serialize.
+  std::vector<uint32_t> new_tokens;
   {
-    Thread::LockGuard lock(lock_);
-    for (auto& token : tokens) {
-      symbols.push_back(toSymbol(token));
+    absl::ReaderMutexLock lock(&lock_);
+    for (uint32_t i = 0; i < tokens.size(); ++i) {
+      const SharedSymbol* shared_symbol = findSharedSymbol(tokens[i]);
+      if (shared_symbol == nullptr) {
+        new_tokens.push_back(i);
+      } else {
+        ++shared_symbol->ref_count_;
+        symbols[i] = shared_symbol->symbol_;
+      }
+    }
+  }
+  if (!new_tokens.empty()) {
+    // Another thread may have added some of the symbols in the meantime, which
+    // toSymbol() handles.
+    absl::MutexLock lock(&lock_);
+    for (uint32_t i : new_tokens) {
+      symbols[i] = toSymbol(tokens[i]);
     }
   }
 
@@ -138,7 +153,7 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
 }
 
 uint64_t SymbolTableImpl::numSymbols() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   ASSERT(encode_map_.size() == decode_map_.size());
   return encode_map_.size();
 }
@@ -157,7 +172,7 @@ std::string SymbolTableImpl::decodeSymbolVec(const SymbolVec& symbols) const {
   name_tokens.reserve(symbols.size());
   {
     // Hold the lock only while decoding symbols.
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
     for (Symbol symbol : symbols) {
       name_tokens.push_back(fromSymbol(symbol));
     }
@@ -169,15 +184,9 @@ void SymbolTableImpl::incRefCount(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
 
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-    ASSERT(decode_search != decode_map_.end());
-
-    auto encode_search = encode_map_.find(decode_search->second->toStringView());
-    ASSERT(encode_search != encode_map_.end());
-
-    ++encode_search->second.ref_count_;
+    ++sharedSymbol(symbol).ref_count_;
   }
 }
 
@@ -185,8 +194,23 @@ void SymbolTableImpl::free(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
 
-  Thread::LockGuard lock(lock_);
-  for (Symbol symbol : symbols) {
+  // Only the last references, which remove their symbols, need the lock exclusively.
+  SymbolVec last_references;
+  {
+    absl::ReaderMutexLock lock(&lock_);
+    for (Symbol symbol : symbols) {
+      if (!sharedSymbol(symbol).releaseUnlessLast()) {
+        last_references.push_back(symbol);
+      }
+    }
+  }
+  if (last_references.empty()) {
+    return;
+  }
+
+  absl::MutexLock lock(&lock_);
+  for (Symbol symbol : last_references) {
+    // Another thread may have referenced the symbol again in the meantime.
     auto decode_search = decode_map_.find(symbol);
     ASSERT(decode_search != decode_map_.end());
 
@@ -206,6 +230,7 @@ void SymbolTableImpl::free(const StatName& stat_name) {
     }
   }
 }
+
 Symbol SymbolTableImpl::toSymbol(absl::string_view sv) {
   Symbol result;
   auto encode_find = encode_map_.find(sv);
@@ -233,12 +258,25 @@ Symbol SymbolTableImpl::toSymbol(absl::string_view sv) {
 }
 
 absl::string_view SymbolTableImpl::fromSymbol(const Symbol symbol) const
-    EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    SHARED_LOCKS_REQUIRED(lock_) {
   auto search = decode_map_.find(symbol);
   RELEASE_ASSERT(search != decode_map_.end(), "no such symbol");
   return search->second->toStringView();
 }
 
+const SymbolTableImpl::SharedSymbol*
+SymbolTableImpl::findSharedSymbol(absl::string_view token) const SHARED_LOCKS_REQUIRED(lock_) {
+  auto search = encode_map_.find(token);
+  return search == encode_map_.end() ? nullptr : &search->second;
+}
+
+const SymbolTableImpl::SharedSymbol& SymbolTableImpl::sharedSymbol(Symbol symbol) const
+    SHARED_LOCKS_REQUIRED(lock_) {
+  const SharedSymbol* shared_symbol = findSharedSymbol(fromSymbol(symbol));
+  ASSERT(shared_symbol != nullptr);
+  return *shared_symbol;
+}
+
 void SymbolTableImpl::newSymbol() EXCLUSIVE_LOCKS_REQUIRED(lock_) {
   if (pool_.empty()) {
     next_symbol_ = ++monotonic_counter_;
@@ -260,7 +298,7 @@ bool SymbolTableImpl::lessThan(const StatName& a, const StatName& b) const {
 
   // Calling fromSymbol requires holding the lock, as it needs read-access to
   // the maps that are written when adding new symbols.
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   for (uint64_t i = 0, n = std::min(av.size(), bv.size()); i < n; ++i) {
     if (av[i] != bv[i]) {
       bool ret = fromSymbol(av[i]) < fromSymbol(bv[i]);
@@ -272,7 +310,7 @@ bool SymbolTableImpl::lessThan(const StatName& a, const StatName& b) const {
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTableImpl::debugPrint() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   std::vector<Symbol> symbols;
   for (const auto& p : decode_map_) {
     symbols.push_back(p.first);
@@ -281,7 +319,8 @@ void SymbolTableImpl::debugPrint() const {
   for (Symbol symbol : symbols) {
     const InlineString& token = *decode_map_.find(symbol)->second;
     const SharedSymbol& shared_symbol = encode_map_.find(token.toStringView())->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.ref_count_);
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(),
+                   shared_symbol.ref_count_.load());
   }
 }
 #endif
@@ -442,6 +481,12 @@ void StatNameSet::rememberBuiltin(absl::string_view str) {
   builtin_stat_names_[str] = stat_name;
 }
 
+void StatNameSet::rememberBuiltins(const std::vector<absl::string_view>& names) {
+  for (absl::string_view name : names) {
+    rememberBuiltin(name);
+  }
+}
+
 Stats::StatName StatNameSet::getStatName(absl::string_view token) {
   // If token was recorded as a built-in during initialization, we can
   // service this request lock-free.
@@ -455,6 +500,7 @@ Stats::StatName StatNameSet::getStatName(absl::string_view token) {
   Stats::StatName& stat_name = dynamic_stat_names_[token];
   if (stat_name.empty()) { // Note that builtin_stat_names_ already has one for "".
     stat_name = pool_.add(token);
+    ++dynamic_encodings_;
   }
   return stat_name;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <memory>
 #include <stack>
@@ -14,6 +15,7 @@
 #include "common/common/assert.h"
 #include "common/common/hash.h"
 #include "common/common/lock_guard.h"
+#include "common/common/mutex_tracer_impl.h"
 #include "common/common/non_copyable.h"
 #include "common/common/stack_array.h"
 #include "common/common/thread.h"
@@ -165,13 +167,35 @@ private:
 
   struct SharedSymbol {
     SharedSymbol(Symbol symbol) : symbol_(symbol), ref_count_(1) {}
+    // The encode map moves its values when it grows, which only happens with lock_ held
+    // exclusively, so no reference can be taken concurrently.
+    SharedSymbol(SharedSymbol&& src) : symbol_(src.symbol_), ref_count_(src.ref_count_.load()) {}
+
+    /**
+     * Drops a reference unless it is the last one, which can only be dropped with lock_ held
+     * exclusively, as the symbol is then removed.
+     * @return bool whether the reference was dropped.
+     */
+    bool releaseUnlessLast() const {
+      uint32_t count = ref_count_.load();
+      while (count > 1) {
+        if (ref_count_.compare_exchange_weak(count, count - 1)) {
+          return true;
+        }
+      }
+      return false;
+    }
 
     Symbol symbol_;
-    uint32_t ref_count_;
+    // The reference count of an established symbol is updated with lock_ only held shared, so
+    // that concurrent encodings of known names do not serialize.
+    mutable std::atomic<uint32_t> ref_count_;
   };
 
-  // This must be held during both encode() and free().
-  mutable Thread::MutexBasicLockable lock_;
+  // Held shared to look up or reference established symbols, and exclusively to add or remove
+  // symbols. Most encodings at request time only reference established symbols.
+  mutable absl::Mutex lock_;
+  MutexContentionName lock_name_{&lock_, "stats.symbol_table"};
 
   /**
    * Decodes a vector of symbols back into its period-delimited stat name. If
@@ -198,7 +222,19 @@ private:
    * @param symbol the individual symbol to be decoded.
    * @return absl::string_view the decoded string.
    */
-  absl::string_view fromSymbol(Symbol symbol) const EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  absl::string_view fromSymbol(Symbol symbol) const SHARED_LOCKS_REQUIRED(lock_);
+
+  /**
+   * @param token an individual string segment.
+   * @return const SharedSymbol* the established symbol of the token, or nullptr if there is none.
+   */
+  const SharedSymbol* findSharedSymbol(absl::string_view token) const SHARED_LOCKS_REQUIRED(lock_);
+
+  /**
+   * @param symbol an established symbol.
+   * @return const SharedSymbol& the symbol and its reference count.
+   */
+  const SharedSymbol& sharedSymbol(Symbol symbol) const SHARED_LOCKS_REQUIRED(lock_);
 
   /**
    * Stages a new symbol for use. To be called after a successful insertion.
@@ -215,7 +251,7 @@ private:
   void addTokensToEncoding(absl::string_view name, Encoding& encoding);
 
   Symbol monotonicCounter() {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
     return monotonic_counter_;
   }
 
@@ -651,6 +687,13 @@ public:
    */
   void rememberBuiltin(absl::string_view str);
 
+  /**
+   * Adds each of the strings to the builtin map, e.g. all the tokens a filter
+   * expects to see in its stat names, so that building those names at request
+   * time does not take any lock. See rememberBuiltin().
+   */
+  void rememberBuiltins(const std::vector<absl::string_view>& names);
+
   /**
    * Finds a StatName by name. If 'token' has been remembered as a built-in, then
    * no lock is required. Otherwise we first consult dynamic_stat_names_ under a
@@ -668,8 +711,16 @@ public:
    */
   StatName add(absl::string_view str) { return pool_.add(str); }
 
+  /**
+   * @return uint64_t the number of tokens getStatName() had to encode, as they were neither
+   *     builtins nor seen before. Once a set has seen the tokens of its traffic, this stops
+   *     growing, and stat names are built without encoding anything.
+   */
+  uint64_t dynamicEncodings() const { return dynamic_encodings_; }
+
 private:
   Stats::StatNamePool pool_;
+  std::atomic<uint64_t> dynamic_encodings_{0};
   absl::Mutex mutex_;
   using StringStatNameMap = absl::flat_hash_map<std::string, Stats::StatName>;
   StringStatNameMap builtin_stat_names_;
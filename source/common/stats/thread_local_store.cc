@@ -1,5 +1,6 @@
 #include "common/stats/thread_local_store.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <list>
@@ -89,6 +90,20 @@ bool ThreadLocalStoreImpl::rejects(StatName stat_name) const {
          stats_matcher_->rejects(constSymbolTable().toString(stat_name));
 }
 
+bool ThreadLocalStoreImpl::isShardedCounter(StatName name) const {
+  // Like rejects(), this elaborates the name, but only when a counter is created.
+  return sharded_counter_matcher_ != nullptr && !sharded_counter_matcher_->rejectsAll() &&
+         (sharded_counter_matcher_->acceptsAll() ||
+          !sharded_counter_matcher_->rejects(constSymbolTable().toString(name)));
+}
+
+const std::vector<double>& ThreadLocalStoreImpl::histogramBuckets(StatName name) const {
+  if (histogram_settings_ == nullptr) {
+    return HistogramSettingsImpl::defaultBuckets();
+  }
+  return histogram_settings_->buckets(constSymbolTable().toString(name));
+}
+
 std::vector<CounterSharedPtr> ThreadLocalStoreImpl::counters() const {
   // Handle de-dup due to overlapping scopes.
   std::vector<CounterSharedPtr> ret;
@@ -186,14 +201,47 @@ void ThreadLocalStoreImpl::mergeHistograms(PostMergeCb merge_complete_cb) {
 
 void ThreadLocalStoreImpl::mergeInternal(PostMergeCb merge_complete_cb) {
   if (!shutting_down_) {
-    for (const ParentHistogramSharedPtr& histogram : histograms()) {
-      histogram->merge();
+    // The histograms are merged on all the threads, each claiming batches of them until none are
+    // left, and the results are published on the main thread once all the threads are done.
+    auto merge = std::make_shared<ParallelHistogramMerge>(parentHistograms());
+    tls_->runOnAllThreads([merge]() -> void { merge->run(); },
+                          [this, merge, merge_complete_cb]() -> void {
+                            if (shutting_down_) {
+                              return;
+                            }
+                            for (const ParentHistogramImplSharedPtr& histogram :
+                                 merge->histograms_) {
+                              histogram->publishMergedStatistics();
+                            }
+                            merge_complete_cb();
+                            merge_in_progress_ = false;
+                          });
+  }
+}
+
+constexpr size_t ThreadLocalStoreImpl::ParallelHistogramMerge::BatchSize;
+
+void ThreadLocalStoreImpl::ParallelHistogramMerge::run() {
+  for (size_t start = next_.fetch_add(BatchSize); start < histograms_.size();
+       start = next_.fetch_add(BatchSize)) {
+    const size_t end = std::min(start + BatchSize, histograms_.size());
+    for (size_t i = start; i < end; i++) {
+      histograms_[i]->mergeTlsHistograms();
     }
-    merge_complete_cb();
-    merge_in_progress_ = false;
   }
 }
 
+std::vector<ParentHistogramImplSharedPtr> ThreadLocalStoreImpl::parentHistograms() const {
+  std::vector<ParentHistogramImplSharedPtr> ret;
+  Thread::LockGuard lock(lock_);
+  for (ScopeImpl* scope : scopes_) {
+    for (const auto& name_histogram_pair : scope->central_cache_.histograms_) {
+      ret.push_back(name_histogram_pair.second);
+    }
+  }
+  return ret;
+}
+
 void ThreadLocalStoreImpl::releaseScopeCrossThread(ScopeImpl* scope) {
   Thread::ReleasableLockGuard lock(lock_);
   ASSERT(scopes_.count(scope) == 1);
@@ -233,9 +281,11 @@ void ThreadLocalStoreImpl::releaseScopeCrossThread(ScopeImpl* scope) {
       delete rejected_stats;
     };
     lock.release();
-    main_thread_dispatcher_->post([this, clean_central_cache, scope_id]() {
-      clearScopeFromCaches(scope_id, clean_central_cache);
-    });
+    main_thread_dispatcher_->post(
+        [this, clean_central_cache, scope_id]() {
+          clearScopeFromCaches(scope_id, clean_central_cache);
+        },
+        Event::PostPriority::Background);
   } else {
     rejected_stats->free(symbolTable());
     delete rejected_stats;
@@ -400,8 +450,11 @@ Counter& ThreadLocalStoreImpl::ScopeImpl::counterFromStatName(StatName name) {
 
   return safeMakeStat<Counter>(
       final_stat_name, central_cache_.counters_, central_cache_.rejected_stats_,
-      [](Allocator& allocator, StatName name, absl::string_view tag_extracted_name,
-         const std::vector<Tag>& tags) -> CounterSharedPtr {
+      [this](Allocator& allocator, StatName name, absl::string_view tag_extracted_name,
+             const std::vector<Tag>& tags) -> CounterSharedPtr {
+        if (parent_.isShardedCounter(name)) {
+          return allocator.makeShardedCounter(name, tag_extracted_name, tags);
+        }
         return allocator.makeCounter(name, tag_extracted_name, tags);
       },
       tls_cache, tls_rejected_stats, parent_.null_counter_);
@@ -502,7 +555,8 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatName(StatName name)
     TagExtraction extraction(parent_, final_stat_name);
 
     RefcountPtr<ParentHistogramImpl> stat(new ParentHistogramImpl(
-        final_stat_name, parent_, *this, extraction.tagExtractedName(), extraction.tags()));
+        final_stat_name, parent_, *this, extraction.tagExtractedName(), extraction.tags(),
+        parent_.histogramBuckets(final_stat_name)));
     central_ref = &central_cache_.histograms_[stat->statName()];
     *central_ref = stat;
   }
@@ -592,11 +646,14 @@ void ThreadLocalHistogramImpl::merge(histogram_t* target) {
 
 ParentHistogramImpl::ParentHistogramImpl(StatName name, Store& parent, TlsScope& tls_scope,
                                          absl::string_view tag_extracted_name,
-                                         const std::vector<Tag>& tags)
+                                         const std::vector<Tag>& tags,
+                                         const std::vector<double>& supported_buckets)
     : MetricImpl(name, tag_extracted_name, tags, parent.symbolTable()), parent_(parent),
       tls_scope_(tls_scope), interval_histogram_(hist_alloc()), cumulative_histogram_(hist_alloc()),
-      interval_statistics_(interval_histogram_), cumulative_statistics_(cumulative_histogram_),
-      merged_(false) {}
+      interval_statistics_(interval_histogram_, supported_buckets),
+      cumulative_statistics_(cumulative_histogram_, supported_buckets),
+      pending_interval_statistics_(supported_buckets),
+      pending_cumulative_statistics_(supported_buckets), merged_(false) {}
 
 ParentHistogramImpl::~ParentHistogramImpl() {
   MetricImpl::clear(symbolTable());
@@ -616,6 +673,11 @@ bool ParentHistogramImpl::used() const {
 }
 
 void ParentHistogramImpl::merge() {
+  mergeTlsHistograms();
+  publishMergedStatistics();
+}
+
+void ParentHistogramImpl::mergeTlsHistograms() {
   Thread::ReleasableLockGuard lock(merge_lock_);
   if (merged_ || usedLockHeld()) {
     hist_clear(interval_histogram_);
@@ -628,10 +690,32 @@ void ParentHistogramImpl::merge() {
     }
     // Since TLS merge is done, we can release the lock here.
     lock.release();
-    hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
-    cumulative_statistics_.refresh(cumulative_histogram_);
-    interval_statistics_.refresh(interval_histogram_);
+    const bool interval_empty = hist_sample_count(interval_histogram_) == 0;
+    if (!interval_empty) {
+      hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
+      pending_cumulative_statistics_.refresh(cumulative_histogram_);
+      cumulative_pending_ = true;
+    }
+    if (!interval_empty || interval_statistics_.sampleCount() != 0) {
+      pending_interval_statistics_.refresh(interval_histogram_);
+      interval_pending_ = true;
+    }
+    merge_pending_ = true;
+  }
+}
+
+void ParentHistogramImpl::publishMergedStatistics() {
+  if (cumulative_pending_) {
+    cumulative_statistics_.swap(pending_cumulative_statistics_);
+    cumulative_pending_ = false;
+  }
+  if (interval_pending_) {
+    interval_statistics_.swap(pending_interval_statistics_);
+    interval_pending_ = false;
+  }
+  if (merge_pending_) {
     merged_ = true;
+    merge_pending_ = false;
   }
 }
 
@@ -9,6 +9,7 @@
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/common/hash.h"
+#include "common/common/mutex_tracer_impl.h"
 #include "common/stats/allocator_impl.h"
 #include "common/stats/histogram_impl.h"
 #include "common/stats/null_counter.h"
@@ -72,7 +73,8 @@ class TlsScope;
 class ParentHistogramImpl : public MetricImpl<ParentHistogram> {
 public:
   ParentHistogramImpl(StatName name, Store& parent, TlsScope& tlsScope,
-                      absl::string_view tag_extracted_name, const std::vector<Tag>& tags);
+                      absl::string_view tag_extracted_name, const std::vector<Tag>& tags,
+                      const std::vector<double>& supported_buckets);
   ~ParentHistogramImpl() override;
 
   void addTlsHistogram(const TlsHistogramSharedPtr& hist_ptr);
@@ -86,6 +88,15 @@ public:
    */
   void merge() override;
 
+  /**
+   * The two halves of merge(), for merging many histograms in parallel. mergeTlsHistograms() may
+   * run on any thread, as it only computes the new statistics aside, while the main thread may
+   * still be reading the current ones. publishMergedStatistics() then makes them current, on the
+   * main thread once all the merges are complete.
+   */
+  void mergeTlsHistograms();
+  void publishMergedStatistics();
+
   const HistogramStatistics& intervalStatistics() const override { return interval_statistics_; }
   const HistogramStatistics& cumulativeStatistics() const override {
     return cumulative_statistics_;
@@ -111,6 +122,13 @@ private:
   histogram_t* cumulative_histogram_;
   HistogramStatisticsImpl interval_statistics_;
   HistogramStatisticsImpl cumulative_statistics_;
+  // The statistics computed by mergeTlsHistograms(), until they are published. The statistics of
+  // a histogram without new samples are not computed again, as they would not change.
+  HistogramStatisticsImpl pending_interval_statistics_;
+  HistogramStatisticsImpl pending_cumulative_statistics_;
+  bool interval_pending_{};
+  bool cumulative_pending_{};
+  bool merge_pending_{};
   mutable Thread::MutexBasicLockable merge_lock_;
   std::list<TlsHistogramSharedPtr> tls_histograms_ GUARDED_BY(merge_lock_);
   bool merged_;
@@ -210,6 +228,14 @@ public:
     tag_producer_ = std::move(tag_producer);
   }
   void setStatsMatcher(StatsMatcherPtr&& stats_matcher) override;
+  void setShardedCounterMatcher(StatsMatcherPtr&& matcher) override {
+    sharded_counter_matcher_ = std::move(matcher);
+  }
+  void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) override {
+    // The histograms refer to the buckets of the settings, so these are never replaced.
+    ASSERT(histogram_settings_ == nullptr);
+    histogram_settings_ = std::move(histogram_settings);
+  }
   void initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                            ThreadLocal::Instance& tls) override;
   void shutdownThreading() override;
@@ -336,12 +362,31 @@ private:
     absl::flat_hash_map<uint64_t, TlsCacheEntry> scope_cache_;
   };
 
+  // The histograms of a flush, merged by all the threads, @see mergeInternal().
+  struct ParallelHistogramMerge {
+    explicit ParallelHistogramMerge(std::vector<ParentHistogramImplSharedPtr>&& histograms)
+        : histograms_(std::move(histograms)) {}
+
+    // Merges batches of histograms not yet claimed by another thread, until none are left.
+    void run();
+
+    // Small enough to spread the histograms of a flush over the threads, large enough for the
+    // threads to rarely contend on next_.
+    static constexpr size_t BatchSize = 64;
+
+    const std::vector<ParentHistogramImplSharedPtr> histograms_;
+    std::atomic<size_t> next_{0};
+  };
+
   std::string getTagsForName(const std::string& name, std::vector<Tag>& tags) const;
   void clearScopeFromCaches(uint64_t scope_id, const Event::PostCb& clean_central_cache);
   void releaseScopeCrossThread(ScopeImpl* scope);
   void mergeInternal(PostMergeCb mergeCb);
+  std::vector<ParentHistogramImplSharedPtr> parentHistograms() const;
   bool rejects(StatName name) const;
   bool rejectsAll() const { return stats_matcher_->rejectsAll(); }
+  bool isShardedCounter(StatName name) const;
+  const std::vector<double>& histogramBuckets(StatName name) const;
   template <class StatMapClass, class StatListClass>
   void removeRejectedStats(StatMapClass& map, StatListClass& list);
   bool checkAndRememberRejection(StatName name, StatNameStorageSet& central_rejected_stats,
@@ -351,11 +396,16 @@ private:
   Event::Dispatcher* main_thread_dispatcher_{};
   ThreadLocal::SlotPtr tls_;
   mutable Thread::MutexBasicLockable lock_;
+  MutexContentionName lock_name_{lock_.contentionId(), "stats.thread_local_store"};
   absl::flat_hash_set<ScopeImpl*> scopes_ GUARDED_BY(lock_);
   ScopePtr default_scope_;
   std::list<std::reference_wrapper<Sink>> timer_sinks_;
   TagProducerPtr tag_producer_;
   StatsMatcherPtr stats_matcher_;
+  // Selects the counters made by Allocator::makeShardedCounter(), null if there are none.
+  StatsMatcherPtr sharded_counter_matcher_;
+  // The buckets of the histograms, null if they all have the default buckets.
+  HistogramSettingsConstPtr histogram_settings_;
   std::atomic<bool> threading_ever_initialized_{};
   std::atomic<bool> shutting_down_{};
   std::atomic<bool> merge_in_progress_{};
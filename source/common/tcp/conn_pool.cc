@@ -1,5 +1,6 @@
 #include "common/tcp/conn_pool.h"
 
+#include <cmath>
 #include <memory>
 
 #include "envoy/event/dispatcher.h"
@@ -89,6 +90,7 @@ ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbac
     ready_conns_.front()->moveBetweenLists(ready_conns_, busy_conns_);
     ENVOY_CONN_LOG(debug, "using existing connection", *busy_conns_.front()->conn_);
     assignConnection(*busy_conns_.front(), callbacks);
+    preconnect(0);
     return nullptr;
   }
 
@@ -108,6 +110,7 @@ ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbac
     ENVOY_LOG(debug, "queueing request due to no available connections");
     PendingRequestPtr pending_request(new PendingRequest(*this, callbacks));
     pending_request->moveIntoList(std::move(pending_request), pending_requests_);
+    preconnect(0);
     return pending_requests_.front().get();
   } else {
     ENVOY_LOG(debug, "max pending requests overflow");
@@ -117,6 +120,21 @@ ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbac
   }
 }
 
+void ConnPoolImpl::preconnect(uint32_t expected_requests) {
+  const double ratio = host_->cluster().perUpstreamPreconnectRatio();
+  if (ratio <= 1.0 || !drained_callbacks_.empty()) {
+    return;
+  }
+
+  const uint64_t requests = pending_requests_.size() + busy_conns_.size() + expected_requests;
+  const uint64_t target = std::ceil(requests * ratio);
+  while (pending_conns_.size() + ready_conns_.size() + busy_conns_.size() < target &&
+         host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    host_->cluster().stats().upstream_cx_preconnect_.inc();
+    createNewConnection();
+  }
+}
+
 void ConnPoolImpl::onConnectionEvent(ActiveConn& conn, Network::ConnectionEvent event) {
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
@@ -31,6 +31,7 @@ public:
   void addDrainedCallback(DrainedCb cb) override;
   void drainConnections() override;
   ConnectionPool::Cancellable* newConnection(ConnectionPool::Callbacks& callbacks) override;
+  void preconnect(uint32_t expected_requests) override;
 
 protected:
   struct ActiveConn;
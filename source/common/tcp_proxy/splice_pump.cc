@@ -0,0 +1,164 @@
+#include "common/tcp_proxy/splice_pump.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+
+#if defined(__linux__)
+#include "common/api/os_sys_calls_impl_linux.h"
+#endif
+
+namespace Envoy {
+namespace TcpProxy {
+
+#if defined(__linux__)
+
+SplicePump::SplicePump(Event::Dispatcher& dispatcher, int downstream_fd, int upstream_fd,
+                       uint32_t pipe_size, SplicePumpCallbacks& callbacks)
+    : callbacks_(callbacks), downstream_to_upstream_{downstream_fd, upstream_fd},
+      upstream_to_downstream_{upstream_fd, downstream_fd} {
+  auto& os_sys_calls = Api::LinuxOsSysCallsSingleton::get();
+  for (Direction* direction : {&downstream_to_upstream_, &upstream_to_downstream_}) {
+    const Api::SysCallIntResult result =
+        os_sys_calls.pipe2(direction->pipe_, O_NONBLOCK | O_CLOEXEC);
+    if (result.rc_ != 0) {
+      closePipes();
+      throw EnvoyException(fmt::format("unable to create splice pipe: {}", strerror(result.errno_)));
+    }
+    if (pipe_size > 0) {
+      // Best effort, the default capacity is used if the size is above the system limit.
+      fcntl(direction->pipe_[1], F_SETPIPE_SZ, pipe_size);
+    }
+    const int capacity = fcntl(direction->pipe_[1], F_GETPIPE_SZ);
+    direction->pipe_capacity_ = capacity > 0 ? capacity : 65536;
+  }
+
+  downstream_event_ = dispatcher.createFileEvent(
+      downstream_fd, [this](uint32_t) { onFileEvent(); }, Event::FileTriggerType::Edge,
+      Event::FileReadyType::Read | Event::FileReadyType::Write);
+  upstream_event_ = dispatcher.createFileEvent(
+      upstream_fd, [this](uint32_t) { onFileEvent(); }, Event::FileTriggerType::Edge,
+      Event::FileReadyType::Read | Event::FileReadyType::Write);
+  // Data may already be waiting in either socket, and with edge triggering no event would be
+  // raised for it.
+  downstream_event_->activate(Event::FileReadyType::Read);
+}
+
+SplicePump::~SplicePump() { closePipes(); }
+
+void SplicePump::closePipes() {
+  for (Direction* direction : {&downstream_to_upstream_, &upstream_to_downstream_}) {
+    for (int& fd : direction->pipe_) {
+      if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+      }
+    }
+  }
+}
+
+bool SplicePump::isSupported() { return true; }
+
+void SplicePump::onFileEvent() {
+  // Keep going until neither direction makes progress. Moving bytes out of a pipe makes room to
+  // read more, and with edge triggering nothing else would wake us for data already queued.
+  Progress downstream_progress;
+  Progress upstream_progress;
+  do {
+    uint64_t downstream_bytes = 0;
+    uint64_t upstream_bytes = 0;
+    downstream_progress = pump(downstream_to_upstream_, downstream_bytes);
+    upstream_progress = pump(upstream_to_downstream_, upstream_bytes);
+    if (downstream_bytes > 0) {
+      callbacks_.onDownstreamBytesSpliced(downstream_bytes);
+    }
+    if (upstream_bytes > 0) {
+      callbacks_.onUpstreamBytesSpliced(upstream_bytes);
+    }
+    if (downstream_progress == Progress::Error || upstream_progress == Progress::Error) {
+      callbacks_.onSpliceComplete(true);
+      return;
+    }
+  } while (downstream_progress == Progress::Some || upstream_progress == Progress::Some);
+
+  if (downstream_to_upstream_.shutdown_ && upstream_to_downstream_.shutdown_) {
+    callbacks_.onSpliceComplete(false);
+  }
+}
+
+SplicePump::Progress SplicePump::pump(Direction& direction, uint64_t& bytes_written) {
+  if (direction.shutdown_) {
+    return Progress::None;
+  }
+  auto& os_sys_calls = Api::LinuxOsSysCallsSingleton::get();
+  Progress progress = Progress::None;
+
+  if (!direction.read_end_stream_ && direction.pipe_bytes_ < direction.pipe_capacity_) {
+    const Api::SysCallSizeResult result =
+        os_sys_calls.splice(direction.in_fd_, nullptr, direction.pipe_[1], nullptr,
+                            direction.pipe_capacity_ - direction.pipe_bytes_,
+                            SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (result.rc_ > 0) {
+      direction.pipe_bytes_ += result.rc_;
+      progress = Progress::Some;
+    } else if (result.rc_ == 0) {
+      direction.read_end_stream_ = true;
+      progress = Progress::Some;
+    } else if (result.errno_ != EAGAIN) {
+      ENVOY_LOG(debug, "splice from fd {} failed: {}", direction.in_fd_, strerror(result.errno_));
+      return Progress::Error;
+    }
+  }
+
+  if (direction.pipe_bytes_ > 0) {
+    const Api::SysCallSizeResult result =
+        os_sys_calls.splice(direction.pipe_[0], nullptr, direction.out_fd_, nullptr,
+                            direction.pipe_bytes_, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (result.rc_ > 0) {
+      direction.pipe_bytes_ -= result.rc_;
+      bytes_written += result.rc_;
+      progress = Progress::Some;
+    } else if (result.rc_ < 0 && result.errno_ != EAGAIN) {
+      ENVOY_LOG(debug, "splice to fd {} failed: {}", direction.out_fd_, strerror(result.errno_));
+      return Progress::Error;
+    }
+  }
+
+  if (direction.read_end_stream_ && direction.pipe_bytes_ == 0) {
+    // Ignore the result, as in RawBufferSocket. A failed connection is detected by the other
+    // direction.
+    ::shutdown(direction.out_fd_, SHUT_WR);
+    direction.shutdown_ = true;
+  }
+  return progress;
+}
+
+#else
+
+SplicePump::SplicePump(Event::Dispatcher&, int, int, uint32_t, SplicePumpCallbacks& callbacks)
+    : callbacks_(callbacks), downstream_to_upstream_{-1, -1}, upstream_to_downstream_{-1, -1} {
+  throw EnvoyException("splice is not supported on this platform");
+}
+
+SplicePump::~SplicePump() = default;
+
+bool SplicePump::isSupported() { return false; }
+
+void SplicePump::closePipes() {}
+
+void SplicePump::onFileEvent() { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+SplicePump::Progress SplicePump::pump(Direction&, uint64_t&) { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+#endif
+
+} // namespace TcpProxy
+} // namespace Envoy
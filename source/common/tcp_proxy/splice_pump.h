@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/pure.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+
+#include "common/common/logger.h"
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace TcpProxy {
+
+/**
+ * Callbacks from a SplicePump.
+ */
+class SplicePumpCallbacks {
+public:
+  virtual ~SplicePumpCallbacks() = default;
+
+  /**
+   * Called when bytes were moved from the downstream socket to the upstream socket.
+   */
+  virtual void onDownstreamBytesSpliced(uint64_t bytes) PURE;
+
+  /**
+   * Called when bytes were moved from the upstream socket to the downstream socket.
+   */
+  virtual void onUpstreamBytesSpliced(uint64_t bytes) PURE;
+
+  /**
+   * Called once when both directions have reached end of stream and were flushed, or when either
+   * socket failed. The pump must not be used after this, but may be destroyed from within the
+   * callback.
+   * @param error whether a splice failed rather than both directions completing.
+   */
+  virtual void onSpliceComplete(bool error) PURE;
+};
+
+/**
+ * Moves bytes in both directions between two connected, non-blocking stream sockets with
+ * splice(2) through a pipe per direction, so that the payload never enters user space. It takes
+ * over the I/O of both sockets: the owning connections must have reads disabled and nothing
+ * buffered for as long as the pump is alive. Backpressure is provided by the pipe, which holds at
+ * most the configured number of bytes per direction: when it is full the pump stops reading the
+ * source socket until the destination socket drains it, which mirrors the high/low watermark
+ * behaviour of the buffered path. When one direction reaches end of stream and its pipe is empty
+ * the write side of its destination socket is shut down, so half close is preserved.
+ */
+class SplicePump : NonCopyable, Logger::Loggable<Logger::Id::filter> {
+public:
+  /**
+   * @param pipe_size the bytes to buffer per direction, or 0 to keep the system default. The
+   *        kernel rounds it up to a whole number of pages.
+   * @throw EnvoyException if the pipes cannot be created.
+   */
+  SplicePump(Event::Dispatcher& dispatcher, int downstream_fd, int upstream_fd,
+             uint32_t pipe_size, SplicePumpCallbacks& callbacks);
+  ~SplicePump();
+
+  /**
+   * @return whether splice(2) is available on this platform.
+   */
+  static bool isSupported();
+
+private:
+  struct Direction {
+    int in_fd_;
+    int out_fd_;
+    int pipe_[2]{-1, -1};
+    uint64_t pipe_bytes_{};
+    uint64_t pipe_capacity_{};
+    bool read_end_stream_{};
+    bool shutdown_{};
+  };
+
+  enum class Progress { None, Some, Error };
+
+  void closePipes();
+  void onFileEvent();
+  Progress pump(Direction& direction, uint64_t& bytes_written);
+
+  SplicePumpCallbacks& callbacks_;
+  Direction downstream_to_upstream_;
+  Direction upstream_to_downstream_;
+  Event::FileEventPtr downstream_event_;
+  Event::FileEventPtr upstream_event_;
+};
+
+using SplicePumpPtr = std::unique_ptr<SplicePump>;
+
+} // namespace TcpProxy
+} // namespace Envoy
@@ -67,6 +67,7 @@ Config::SharedConfig::SharedConfig(
 Config::Config(const envoy::config::filter::network::tcp_proxy::v2::TcpProxy& config,
                Server::Configuration::FactoryContext& context)
     : max_connect_attempts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_connect_attempts, 1)),
+      splice_(config.splice()),
       upstream_drain_manager_slot_(context.threadLocal().allocateSlot()),
       shared_config_(std::make_shared<SharedConfig>(config, context)),
       random_generator_(context.random()) {
@@ -467,6 +468,9 @@ Network::FilterStatus Filter::onData(Buffer::Instance& data, bool end_stream) {
 }
 
 void Filter::onDownstreamEvent(Network::ConnectionEvent event) {
+  // The pump must stop using the sockets before either connection closes them.
+  splice_pump_.reset();
+
   if (upstream_conn_data_) {
     if (event == Network::ConnectionEvent::RemoteClose) {
       upstream_conn_data_->connection().close(Network::ConnectionCloseType::FlushWrite);
@@ -515,6 +519,7 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
 
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
+    splice_pump_.reset();
     upstream_conn_data_.reset();
     disableIdleTimer();
 
@@ -532,9 +537,11 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
       }
     }
   } else if (event == Network::ConnectionEvent::Connected) {
-    // Re-enable downstream reads now that the upstream connection is established
-    // so we have a place to send downstream data to.
-    read_callbacks_->connection().readDisable(false);
+    if (!startSplice()) {
+      // Re-enable downstream reads now that the upstream connection is established
+      // so we have a place to send downstream data to.
+      read_callbacks_->connection().readDisable(false);
+    }
 
     read_callbacks_->upstreamHost()->outlierDetector().putResult(
         Upstream::Outlier::Result::LOCAL_ORIGIN_CONNECT_SUCCESS_FINAL);
@@ -559,6 +566,54 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
   }
 }
 
+bool Filter::startSplice() {
+  if (!config_->splice() || !SplicePump::isSupported()) {
+    return false;
+  }
+  Network::Connection& downstream = read_callbacks_->connection();
+  Network::ClientConnection& upstream = upstream_conn_data_->connection();
+  if (downstream.ssl() != nullptr || upstream.ssl() != nullptr) {
+    // The payload has to pass through the TLS transport sockets.
+    return false;
+  }
+
+  // Downstream reads are still disabled since initialize(). With reads disabled on both
+  // connections, neither touches its socket other than to flush an empty write buffer, and the
+  // pump owns all payload I/O.
+  upstream.readDisable(true);
+  try {
+    splice_pump_ =
+        std::make_unique<SplicePump>(downstream.dispatcher(), downstream.ioHandle().fd(),
+                                     upstream.ioHandle().fd(), downstream.bufferLimit(), *this);
+  } catch (const EnvoyException& e) {
+    ENVOY_CONN_LOG(debug, "unable to splice: {}", downstream, e.what());
+    upstream.readDisable(false);
+    return false;
+  }
+
+  ENVOY_CONN_LOG(debug, "splicing to upstream connection", downstream);
+  config_->stats().downstream_cx_splice_total_.inc();
+  return true;
+}
+
+void Filter::onDownstreamBytesSpliced(uint64_t bytes) {
+  getStreamInfo().addBytesReceived(bytes);
+  config_->stats().downstream_cx_rx_bytes_total_.add(bytes);
+  resetIdleTimer();
+}
+
+void Filter::onUpstreamBytesSpliced(uint64_t bytes) {
+  getStreamInfo().addBytesSent(bytes);
+  config_->stats().downstream_cx_tx_bytes_total_.add(bytes);
+  resetIdleTimer();
+}
+
+void Filter::onSpliceComplete(bool error) {
+  ENVOY_CONN_LOG(debug, "splice complete, error={}", read_callbacks_->connection(), error);
+  // Nothing is buffered in either connection. This destroys the pump and closes the upstream.
+  read_callbacks_->connection().close(Network::ConnectionCloseType::NoFlush);
+}
+
 void Filter::onIdleTimeout() {
   ENVOY_CONN_LOG(debug, "Session timed out", read_callbacks_->connection());
   config_->stats().idle_timeout_.inc();
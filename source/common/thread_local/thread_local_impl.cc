@@ -1,5 +1,6 @@
 #include "common/thread_local/thread_local_impl.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <list>
@@ -55,6 +56,7 @@ void InstanceImpl::registerThread(Event::Dispatcher& dispatcher, bool main_threa
     thread_local_data_.dispatcher_ = &dispatcher;
   } else {
     ASSERT(!containsReference(registered_threads_, dispatcher));
+    closeSetBatch();
     registered_threads_.push_back(dispatcher);
     dispatcher.post([&dispatcher] { thread_local_data_.dispatcher_ = &dispatcher; });
   }
@@ -86,6 +88,7 @@ void InstanceImpl::removeSlot(SlotImpl& slot) {
 void InstanceImpl::runOnAllThreads(Event::PostCb cb) {
   ASSERT(std::this_thread::get_id() == main_thread_id_);
   ASSERT(!shutdown_);
+  closeSetBatch();
 
   for (Event::Dispatcher& dispatcher : registered_threads_) {
     dispatcher.post(cb);
@@ -98,6 +101,7 @@ void InstanceImpl::runOnAllThreads(Event::PostCb cb) {
 void InstanceImpl::runOnAllThreads(Event::PostCb cb, Event::PostCb all_threads_complete_cb) {
   ASSERT(std::this_thread::get_id() == main_thread_id_);
   ASSERT(!shutdown_);
+  closeSetBatch();
   // Handle main thread first so that when the last worker thread wins, we could just call the
   // all_threads_complete_cb method. Parallelism of main thread execution is being traded off
   // for programming simplicity here.
@@ -118,15 +122,47 @@ void InstanceImpl::SlotImpl::set(InitializeCb cb) {
   ASSERT(std::this_thread::get_id() == parent_.main_thread_id_);
   ASSERT(!parent_.shutdown_);
 
-  for (Event::Dispatcher& dispatcher : parent_.registered_threads_) {
-    const uint32_t index = index_;
-    dispatcher.post([index, cb, &dispatcher]() -> void { setThreadLocal(index, cb(dispatcher)); });
-  }
+  parent_.postSet(index_, cb);
 
   // Handle main thread.
   setThreadLocal(index_, cb(*parent_.main_thread_dispatcher_));
 }
 
+void InstanceImpl::postSet(uint32_t index, Slot::InitializeCb cb) {
+  if (set_batch_ != nullptr) {
+    Thread::LockGuard lock(set_batch_->mutex_);
+    if (!set_batch_->started_) {
+      auto& updates = set_batch_->updates_;
+      updates.erase(std::remove_if(updates.begin(), updates.end(),
+                                   [index](const std::pair<uint32_t, Slot::InitializeCb>& update) {
+                                     return update.first == index;
+                                   }),
+                    updates.end());
+      updates.emplace_back(index, cb);
+      return;
+    }
+  }
+
+  // No worker has started the new batch yet, as it is not posted.
+  set_batch_ = std::make_shared<SetBatch>();
+  set_batch_->updates_.emplace_back(index, cb);
+  for (Event::Dispatcher& dispatcher : registered_threads_) {
+    SetBatchSharedPtr batch = set_batch_;
+    dispatcher.post([batch, &dispatcher]() -> void { batch->run(dispatcher); });
+  }
+}
+
+void InstanceImpl::SetBatch::run(Event::Dispatcher& dispatcher) {
+  {
+    Thread::LockGuard lock(mutex_);
+    started_ = true;
+  }
+
+  for (const auto& update : updates_) {
+    setThreadLocal(update.first, update.second(dispatcher));
+  }
+}
+
 void InstanceImpl::setThreadLocal(uint32_t index, ThreadLocalObjectSharedPtr object) {
   if (thread_local_data_.data_.size() <= index) {
     thread_local_data_.data_.resize(index + 1);
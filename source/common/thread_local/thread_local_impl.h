@@ -7,7 +7,9 @@
 
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/common/lock_guard.h"
 #include "common/common/logger.h"
+#include "common/common/thread.h"
 
 namespace Envoy {
 namespace ThreadLocal {
@@ -50,7 +52,25 @@ private:
     std::vector<ThreadLocalObjectSharedPtr> data_;
   };
 
+  /**
+   * The slot updates posted to the workers with a single callback each. Updates are added to the
+   * batch until a worker starts running it, and replace the older updates of the same slot, which
+   * the workers then skip.
+   */
+  struct SetBatch {
+    void run(Event::Dispatcher& dispatcher);
+
+    Thread::MutexBasicLockable mutex_;
+    bool started_ GUARDED_BY(mutex_){};
+    // Only modified before the batch is started, in order of the latest update of each slot.
+    std::vector<std::pair<uint32_t, Slot::InitializeCb>> updates_;
+  };
+
+  using SetBatchSharedPtr = std::shared_ptr<SetBatch>;
+
   void removeSlot(SlotImpl& slot);
+  void postSet(uint32_t index, Slot::InitializeCb cb);
+  void closeSetBatch() { set_batch_ = nullptr; }
   void runOnAllThreads(Event::PostCb cb);
   void runOnAllThreads(Event::PostCb cb, Event::PostCb main_callback);
   static void setThreadLocal(uint32_t index, ThreadLocalObjectSharedPtr object);
@@ -60,6 +80,9 @@ private:
   std::list<std::reference_wrapper<Event::Dispatcher>> registered_threads_;
   std::thread::id main_thread_id_;
   Event::Dispatcher* main_thread_dispatcher_{};
+  // The batch the next slot updates are added to. It is closed by any other post to the workers,
+  // so that the updates are not reordered with them.
+  SetBatchSharedPtr set_batch_;
   std::atomic<bool> shutdown_{};
 };
 
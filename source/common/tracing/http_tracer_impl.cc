@@ -123,6 +123,12 @@ static void annotateVerbose(Span& span, const StreamInfo::StreamInfo& stream_inf
 void HttpTracerUtility::finalizeSpan(Span& span, const Http::HeaderMap* request_headers,
                                      const StreamInfo::StreamInfo& stream_info,
                                      const Config& tracing_config) {
+  if (!span.sampled()) {
+    // The tags of a span which is not reported are not worth building.
+    span.finishSpan();
+    return;
+  }
+
   // Pre response data.
   if (request_headers) {
     if (request_headers->RequestId()) {
@@ -189,7 +195,7 @@ SpanPtr HttpTracerImpl::startSpan(const Config& config, Http::HeaderMap& request
 
   SpanPtr active_span = driver_->startSpan(config, request_headers, span_name,
                                            stream_info.startTime(), tracing_decision);
-  if (active_span) {
+  if (active_span && active_span->sampled()) {
     active_span->setTag(Tracing::Tags::get().Component, Tracing::Tags::get().Proxy);
     active_span->setTag(Tracing::Tags::get().NodeId, local_info_.nodeName());
     active_span->setTag(Tracing::Tags::get().Zone, local_info_.zoneName());
@@ -139,6 +139,7 @@ public:
     return SpanPtr{new NullSpan()};
   }
   void setSampled(bool) override {}
+  bool sampled() const override { return false; }
 };
 
 class HttpNullTracer : public HttpTracer {
@@ -146,7 +147,7 @@ public:
   // Tracing::HttpTracer
   SpanPtr startSpan(const Config&, Http::HeaderMap&, const StreamInfo::StreamInfo&,
                     const Tracing::Decision) override {
-    return SpanPtr{new NullSpan()};
+    return nullptr;
   }
 };
 
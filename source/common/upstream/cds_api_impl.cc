@@ -1,6 +1,7 @@
 #include "common/upstream/cds_api_impl.h"
 
 #include <string>
+#include <unordered_set>
 
 #include "envoy/api/v2/cds.pb.validate.h"
 #include "envoy/api/v2/cluster/outlier_detection.pb.validate.h"
@@ -17,14 +18,16 @@ namespace Upstream {
 
 CdsApiPtr CdsApiImpl::create(const envoy::api::v2::core::ConfigSource& cds_config,
                              ClusterManager& cm, Stats::Scope& scope,
-                             ProtobufMessage::ValidationVisitor& validation_visitor) {
-  return CdsApiPtr{new CdsApiImpl(cds_config, cm, scope, validation_visitor)};
+                             ProtobufMessage::ValidationVisitor& validation_visitor,
+                             Api::Api& api) {
+  return CdsApiPtr{new CdsApiImpl(cds_config, cm, scope, validation_visitor, api)};
 }
 
 CdsApiImpl::CdsApiImpl(const envoy::api::v2::core::ConfigSource& cds_config, ClusterManager& cm,
-                       Stats::Scope& scope, ProtobufMessage::ValidationVisitor& validation_visitor)
+                       Stats::Scope& scope, ProtobufMessage::ValidationVisitor& validation_visitor,
+                       Api::Api& api)
     : cm_(cm), scope_(scope.createScope("cluster_manager.cds.")),
-      validation_visitor_(validation_visitor) {
+      validation_visitor_(validation_visitor), decoder_(api, scope, "control_plane.cds.") {
   subscription_ = cm_.subscriptionFactory().subscriptionFromConfigSource(
       cds_config, Grpc::Common::typeUrl(envoy::api::v2::Cluster().GetDescriptor()->full_name()),
       *scope_, *this);
@@ -32,48 +35,75 @@ CdsApiImpl::CdsApiImpl(const envoy::api::v2::core::ConfigSource& cds_config, Clu
 
 void CdsApiImpl::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
                                 const std::string& version_info) {
+  const std::vector<Config::DecodedResource<envoy::api::v2::Cluster>> clusters =
+      decoder_.decode<envoy::api::v2::Cluster>(
+          resources.size(),
+          [&resources](size_t i) -> const ProtobufWkt::Any& { return resources[i]; },
+          validation_visitor_);
   ClusterManager::ClusterInfoMap clusters_to_remove = cm_.clusters();
-  std::vector<envoy::api::v2::Cluster> clusters;
-  for (const auto& cluster_blob : resources) {
-    clusters.push_back(
-        MessageUtil::anyConvert<envoy::api::v2::Cluster>(cluster_blob, validation_visitor_));
-    clusters_to_remove.erase(clusters.back().name());
+  // The clusters which have not been instantiated yet must be removed as well.
+  std::unordered_set<std::string> lazy_clusters_to_remove;
+  for (std::string& lazy_cluster : cm_.lazyClusters()) {
+    lazy_clusters_to_remove.insert(std::move(lazy_cluster));
+  }
+  for (const auto& cluster : clusters) {
+    // Without its name, the clusters to remove are unknown, so the whole update is rejected.
+    if (!cluster.unpacked_) {
+      std::rethrow_exception(cluster.error_);
+    }
+    clusters_to_remove.erase(cluster.resource_.name());
+    lazy_clusters_to_remove.erase(cluster.resource_.name());
   }
   Protobuf::RepeatedPtrField<std::string> to_remove_repeated;
   for (const auto& cluster : clusters_to_remove) {
     *to_remove_repeated.Add() = cluster.first;
   }
-  Protobuf::RepeatedPtrField<envoy::api::v2::Resource> to_add_repeated;
-  for (const auto& cluster : clusters) {
-    envoy::api::v2::Resource* to_add = to_add_repeated.Add();
-    to_add->set_name(cluster.name());
-    to_add->set_version(version_info);
-    to_add->mutable_resource()->PackFrom(cluster);
+  for (const auto& cluster : lazy_clusters_to_remove) {
+    *to_remove_repeated.Add() = cluster;
   }
-  onConfigUpdate(to_add_repeated, to_remove_repeated, version_info);
+  applyConfigUpdate(
+      clusters, [&version_info](size_t) -> const std::string& { return version_info; },
+      to_remove_repeated, version_info);
 }
 
 void CdsApiImpl::onConfigUpdate(
     const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>& added_resources,
     const Protobuf::RepeatedPtrField<std::string>& removed_resources,
     const std::string& system_version_info) {
+  applyConfigUpdate(
+      decoder_.decode<envoy::api::v2::Cluster>(
+          added_resources.size(),
+          [&added_resources](size_t i) -> const ProtobufWkt::Any& {
+            return added_resources[i].resource();
+          },
+          validation_visitor_),
+      [&added_resources](size_t i) -> const std::string& { return added_resources[i].version(); },
+      removed_resources, system_version_info);
+}
+
+void CdsApiImpl::applyConfigUpdate(
+    const std::vector<Config::DecodedResource<envoy::api::v2::Cluster>>& clusters,
+    const std::function<const std::string&(size_t)>& version,
+    const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+    const std::string& system_version_info) {
+  const MonotonicTime start = decoder_.timeSource().monotonicTime();
   cm_.adsMux().pause(Config::TypeUrl::get().ClusterLoadAssignment);
   Cleanup eds_resume([this] { cm_.adsMux().resume(Config::TypeUrl::get().ClusterLoadAssignment); });
 
   std::vector<std::string> exception_msgs;
   std::unordered_set<std::string> cluster_names;
   bool any_applied = false;
-  for (const auto& resource : added_resources) {
-    envoy::api::v2::Cluster cluster;
+  for (size_t i = 0; i < clusters.size(); i++) {
+    const envoy::api::v2::Cluster& cluster = clusters[i].resource_;
     try {
-      cluster = MessageUtil::anyConvert<envoy::api::v2::Cluster>(resource.resource(),
-                                                                 validation_visitor_);
-      MessageUtil::validate(cluster);
+      if (clusters[i].error_ != nullptr) {
+        std::rethrow_exception(clusters[i].error_);
+      }
       if (!cluster_names.insert(cluster.name()).second) {
         // NOTE: at this point, the first of these duplicates has already been successfully applied.
         throw EnvoyException(fmt::format("duplicate cluster {} found", cluster.name()));
       }
-      if (cm_.addOrUpdateCluster(cluster, resource.version())) {
+      if (cm_.addOrUpdateCluster(cluster, version(i))) {
         any_applied = true;
         ENVOY_LOG(debug, "cds: add/update cluster '{}'", cluster.name());
       }
@@ -91,6 +121,7 @@ void CdsApiImpl::onConfigUpdate(
   if (any_applied) {
     system_version_info_ = system_version_info;
   }
+  decoder_.recordApplyDuration(start);
   runInitializeCallbackIfAny();
   if (!exception_msgs.empty()) {
     throw EnvoyException(
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <functional>
+#include <string>
+#include <vector>
 
 #include "envoy/api/api.h"
 #include "envoy/api/v2/cds.pb.h"
@@ -11,6 +13,7 @@
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/common/logger.h"
+#include "common/config/resource_decoder.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -24,7 +27,7 @@ class CdsApiImpl : public CdsApi,
 public:
   static CdsApiPtr create(const envoy::api::v2::core::ConfigSource& cds_config, ClusterManager& cm,
                           Stats::Scope& scope,
-                          ProtobufMessage::ValidationVisitor& validation_visitor);
+                          ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api);
 
   // Upstream::CdsApi
   void initialize() override { subscription_->start({}); }
@@ -47,7 +50,15 @@ private:
   }
 
   CdsApiImpl(const envoy::api::v2::core::ConfigSource& cds_config, ClusterManager& cm,
-             Stats::Scope& scope, ProtobufMessage::ValidationVisitor& validation_visitor);
+             Stats::Scope& scope, ProtobufMessage::ValidationVisitor& validation_visitor,
+             Api::Api& api);
+  // Applies the decoded clusters in order, then removes removed_resources. version supplies the
+  // version of the cluster at an index.
+  void applyConfigUpdate(
+      const std::vector<Config::DecodedResource<envoy::api::v2::Cluster>>& clusters,
+      const std::function<const std::string&(size_t)>& version,
+      const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+      const std::string& system_version_info);
   void runInitializeCallbackIfAny();
 
   ClusterManager& cm_;
@@ -56,6 +67,7 @@ private:
   std::function<void()> initialize_callback_;
   Stats::ScopePtr scope_;
   ProtobufMessage::ValidationVisitor& validation_visitor_;
+  Config::ResourceDecoder decoder_;
 };
 
 } // namespace Upstream
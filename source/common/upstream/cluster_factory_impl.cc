@@ -109,7 +109,8 @@ ClusterFactoryImplBase::create(const envoy::api::v2::Cluster& cluster,
     } else {
       new_cluster_pair.first->setHealthChecker(HealthCheckerFactory::create(
           cluster.health_checks()[0], *new_cluster_pair.first, context.runtime(), context.random(),
-          context.dispatcher(), context.logManager(), context.messageValidationVisitor()));
+          context.dispatcher(), context.logManager(), context.messageValidationVisitor(),
+          context.singletonManager(), context.clusterManager().offloadThreads()));
     }
   }
 
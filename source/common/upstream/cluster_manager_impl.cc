@@ -1,11 +1,13 @@
 #include "common/upstream/cluster_manager_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "envoy/admin/v2alpha/config_dump.pb.h"
@@ -25,6 +27,7 @@
 #include "common/http/http1/conn_pool.h"
 #include "common/http/http2/conn_pool.h"
 #include "common/json/config_schemas.h"
+#include "common/network/caching_dns_resolver_impl.h"
 #include "common/network/resolver_impl.h"
 #include "common/network/utility.h"
 #include "common/protobuf/utility.h"
@@ -195,9 +198,23 @@ ClusterManagerImpl::ClusterManagerImpl(
       http_context_(http_context),
       subscription_factory_(local_info, main_thread_dispatcher, *this, random,
                             validation_context.dynamicValidationVisitor(), api) {
-  async_client_manager_ =
-      std::make_unique<Grpc::AsyncClientManagerImpl>(*this, tls, time_source_, api);
   const auto& cm_config = bootstrap.cluster_manager();
+  async_client_manager_ = std::make_unique<Grpc::AsyncClientManagerImpl>(
+      *this, tls, time_source_, api,
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(cm_config, google_grpc_completion_threads, 1));
+  lazy_cluster_initialization_ = cm_config.lazy_cluster_initialization();
+  max_concurrent_warming_clusters_ = cm_config.max_concurrent_warming_clusters();
+  // The offload threads are created before any cluster is loaded, as the clusters pick them up.
+  if (cm_config.offload_threads() > 0) {
+    offload_threads_ = std::make_unique<OffloadThreadsImpl>(cm_config.offload_threads(), api,
+                                                            main_thread_dispatcher);
+  }
+  dns_resolver_ =
+      offload_threads_ != nullptr ? offload_threads_->dnsResolver() : factory.dnsResolver();
+  if (cm_config.has_dns_cache()) {
+    dns_resolver_ = std::make_shared<Network::CachingDnsResolverImpl>(
+        dns_resolver_, main_thread_dispatcher, cm_config.dns_cache(), stats);
+  }
   if (cm_config.has_outlier_detection()) {
     const std::string event_log_file_path = cm_config.outlier_detection().event_log_path();
     if (!event_log_file_path.empty()) {
@@ -298,7 +315,8 @@ ClusterManagerImpl::ClusterManagerImpl(
 ClusterManagerStats ClusterManagerImpl::generateStats(Stats::Scope& scope) {
   const std::string final_prefix = "cluster_manager.";
   return {ALL_CLUSTER_MANAGER_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
-                                    POOL_GAUGE_PREFIX(scope, final_prefix))};
+                                    POOL_GAUGE_PREFIX(scope, final_prefix),
+                                    POOL_HISTOGRAM_PREFIX(scope, final_prefix))};
 }
 
 void ClusterManagerImpl::onClusterInit(Cluster& cluster) {
@@ -462,6 +480,13 @@ bool ClusterManagerImpl::addOrUpdateCluster(const envoy::api::v2::Cluster& clust
     return false;
   }
 
+  // A new cluster is only instantiated on first use when lazy cluster initialization is enabled.
+  // An instantiated cluster is updated as usual.
+  if (lazy_cluster_initialization_ && existing_active_cluster == active_clusters_.end() &&
+      existing_warming_cluster == warming_clusters_.end()) {
+    return addLazyCluster(cluster, version_info, new_hash);
+  }
+
   if (existing_active_cluster != active_clusters_.end() ||
       existing_warming_cluster != warming_clusters_.end()) {
     // The following init manager remove call is a NOP in the case we are already initialized. It's
@@ -472,6 +497,13 @@ bool ClusterManagerImpl::addOrUpdateCluster(const envoy::api::v2::Cluster& clust
     cm_stats_.cluster_added_.inc();
   }
 
+  loadAndWarmCluster(cluster, version_info);
+  return true;
+}
+
+void ClusterManagerImpl::loadAndWarmCluster(const envoy::api::v2::Cluster& cluster,
+                                            const std::string& version_info) {
+  const std::string& cluster_name = cluster.name();
   // There are two discrete paths here depending on when we are adding/updating a cluster.
   // 1) During initial server load we use the init manager which handles complex logic related to
   //    primary/secondary init, static/CDS init, warming all clusters, etc.
@@ -491,32 +523,138 @@ bool ClusterManagerImpl::addOrUpdateCluster(const envoy::api::v2::Cluster& clust
     auto& cluster_entry = active_clusters_.at(cluster_name);
     createOrUpdateThreadLocalCluster(*cluster_entry);
     init_helper_.addCluster(*cluster_entry->cluster_);
+  } else if (std::find(queued_warming_clusters_.begin(), queued_warming_clusters_.end(),
+                       cluster_name) == queued_warming_clusters_.end()) {
+    // The update of a warming cluster takes over its place, whether it is warming or queued.
+    if (max_concurrent_warming_clusters_ == 0 ||
+        warming_clusters_.size() - queued_warming_clusters_.size() <=
+            max_concurrent_warming_clusters_) {
+      startWarming(cluster_name);
+    } else {
+      ENVOY_LOG(info, "add/update cluster {} queued for warming", cluster_name);
+      queued_warming_clusters_.push_back(cluster_name);
+    }
+  }
+
+  updateClusterCounts();
+}
+
+void ClusterManagerImpl::startWarming(const std::string& cluster_name) {
+  auto& cluster_entry = warming_clusters_.at(cluster_name);
+  ENVOY_LOG(info, "add/update cluster {} starting warming", cluster_name);
+  cluster_entry->warming_started_ = time_source_.monotonicTime();
+  cluster_entry->cluster_->initialize([this, cluster_name] {
+    auto warming_it = warming_clusters_.find(cluster_name);
+    auto& cluster_entry = *warming_it->second;
+
+    // If the cluster is being updated, we need to cancel any pending merged updates.
+    // Otherwise, applyUpdates() will fire with a dangling cluster reference.
+    updates_map_.erase(cluster_name);
+
+    active_clusters_[cluster_name] = std::move(warming_it->second);
+    warming_clusters_.erase(warming_it);
+
+    ENVOY_LOG(info, "warming cluster {} complete", cluster_name);
+    cm_stats_.cluster_warming_duration_ms_.recordValue(
+        std::chrono::duration_cast<std::chrono::milliseconds>(time_source_.monotonicTime() -
+                                                              cluster_entry.warming_started_)
+            .count());
+    createOrUpdateThreadLocalCluster(cluster_entry);
+    onClusterInit(*cluster_entry.cluster_);
+    startQueuedWarming();
+    updateClusterCounts();
+  });
+}
+
+void ClusterManagerImpl::startQueuedWarming() {
+  while (!queued_warming_clusters_.empty() &&
+         warming_clusters_.size() - queued_warming_clusters_.size() <
+             max_concurrent_warming_clusters_) {
+    const std::string cluster_name = std::move(queued_warming_clusters_.front());
+    queued_warming_clusters_.pop_front();
+    startWarming(cluster_name);
+  }
+}
+
+bool ClusterManagerImpl::addLazyCluster(const envoy::api::v2::Cluster& cluster,
+                                        const std::string& version_info, uint64_t config_hash) {
+  const std::string& cluster_name = cluster.name();
+  auto existing_lazy_cluster = lazy_clusters_.find(cluster_name);
+  if (existing_lazy_cluster != lazy_clusters_.end()) {
+    if (existing_lazy_cluster->second.config_hash_ == config_hash) {
+      return false;
+    }
+    cm_stats_.cluster_modified_.inc();
   } else {
-    auto& cluster_entry = warming_clusters_.at(cluster_name);
-    ENVOY_LOG(info, "add/update cluster {} starting warming", cluster_name);
-    cluster_entry->cluster_->initialize([this, cluster_name] {
-      auto warming_it = warming_clusters_.find(cluster_name);
-      auto& cluster_entry = *warming_it->second;
-
-      // If the cluster is being updated, we need to cancel any pending merged updates.
-      // Otherwise, applyUpdates() will fire with a dangling cluster reference.
-      updates_map_.erase(cluster_name);
-
-      active_clusters_[cluster_name] = std::move(warming_it->second);
-      warming_clusters_.erase(warming_it);
-
-      ENVOY_LOG(info, "warming cluster {} complete", cluster_name);
-      createOrUpdateThreadLocalCluster(cluster_entry);
-      onClusterInit(*cluster_entry.cluster_);
-      updateClusterCounts();
-    });
+    cm_stats_.cluster_added_.inc();
+    absl::MutexLock lock(&lazy_cluster_names_->mutex_);
+    lazy_cluster_names_->requested_.emplace(cluster_name, false);
   }
 
+  ENVOY_LOG(debug, "add/update cluster {} for lazy initialization", cluster_name);
+  lazy_clusters_[cluster_name] = LazyCluster{cluster, version_info, config_hash};
   updateClusterCounts();
   return true;
 }
 
+bool ClusterManagerImpl::initializeLazyCluster(const std::string& cluster_name) {
+  auto lazy_cluster = lazy_clusters_.find(cluster_name);
+  if (lazy_cluster == lazy_clusters_.end()) {
+    return false;
+  }
+
+  // From now on the cluster is added, updated and removed as any other cluster.
+  const LazyCluster cluster = std::move(lazy_cluster->second);
+  lazy_clusters_.erase(lazy_cluster);
+  {
+    absl::MutexLock lock(&lazy_cluster_names_->mutex_);
+    lazy_cluster_names_->requested_.erase(cluster_name);
+  }
+
+  ENVOY_LOG(info, "initializing lazy cluster {}", cluster_name);
+  try {
+    loadAndWarmCluster(cluster.cluster_config_, cluster.version_info_);
+  } catch (const EnvoyException& e) {
+    // The configuration was accepted when the cluster was added, so the failure is not reported
+    // to the management server. The cluster is dropped until it is added again.
+    ENVOY_LOG(warn, "failed to initialize lazy cluster {}: {}", cluster_name, e.what());
+    cm_stats_.lazy_cluster_initialization_failed_.inc();
+    updateClusterCounts();
+    return false;
+  }
+  cm_stats_.lazy_cluster_initialized_.inc();
+  return true;
+}
+
+std::vector<std::string> ClusterManagerImpl::lazyClusters() {
+  std::vector<std::string> names;
+  names.reserve(lazy_clusters_.size());
+  for (const auto& lazy_cluster : lazy_clusters_) {
+    names.push_back(lazy_cluster.first);
+  }
+  return names;
+}
+
+void ClusterManagerImpl::requestLazyClusterInitialization(absl::string_view cluster) {
+  {
+    absl::MutexLock lock(&lazy_cluster_names_->mutex_);
+    auto requested = lazy_cluster_names_->requested_.find(cluster);
+    if (requested == lazy_cluster_names_->requested_.end() || requested->second) {
+      return;
+    }
+    requested->second = true;
+  }
+
+  std::weak_ptr<LazyClusterNames> weak_lazy_cluster_names = lazy_cluster_names_;
+  dispatcher_.post([this, weak_lazy_cluster_names, cluster_name = std::string(cluster)]() -> void {
+    if (weak_lazy_cluster_names.lock() != nullptr) {
+      initializeLazyCluster(cluster_name);
+    }
+  });
+}
+
 void ClusterManagerImpl::createOrUpdateThreadLocalCluster(ClusterData& cluster) {
+  postPendingClusterUpdates();
   tls_->runOnAllThreads([this, new_cluster = cluster.cluster_->info(),
                          thread_aware_lb_factory = cluster.loadBalancerFactory()]() -> void {
     ThreadLocalClusterManagerImpl& cluster_manager =
@@ -538,6 +676,17 @@ void ClusterManagerImpl::createOrUpdateThreadLocalCluster(ClusterData& cluster)
 }
 
 bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
+  if (lazy_clusters_.erase(cluster_name) > 0) {
+    {
+      absl::MutexLock lock(&lazy_cluster_names_->mutex_);
+      lazy_cluster_names_->requested_.erase(cluster_name);
+    }
+    ENVOY_LOG(info, "removing lazy cluster {}", cluster_name);
+    cm_stats_.cluster_removed_.inc();
+    updateClusterCounts();
+    return true;
+  }
+
   bool removed = false;
   auto existing_active_cluster = active_clusters_.find(cluster_name);
   if (existing_active_cluster != active_clusters_.end() &&
@@ -547,6 +696,7 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
     active_clusters_.erase(existing_active_cluster);
 
     ENVOY_LOG(info, "removing cluster {}", cluster_name);
+    postPendingClusterUpdates();
     tls_->runOnAllThreads([this, cluster_name]() -> void {
       ThreadLocalClusterManagerImpl& cluster_manager =
           tls_->getTyped<ThreadLocalClusterManagerImpl>();
@@ -565,7 +715,9 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
       existing_warming_cluster->second->added_via_api_) {
     removed = true;
     warming_clusters_.erase(existing_warming_cluster);
+    queued_warming_clusters_.remove(cluster_name);
     ENVOY_LOG(info, "removing warming cluster {}", cluster_name);
+    startQueuedWarming();
   }
 
   if (removed) {
@@ -614,6 +766,10 @@ void ClusterManagerImpl::loadCluster(const envoy::api::v2::Cluster& cluster,
           if (changed_state == HealthTransition::Changed &&
               host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
             postThreadLocalHealthFailure(host);
+          } else if (changed_state == HealthTransition::Changed &&
+                     host->health() == Host::Health::Healthy &&
+                     host->cluster().perUpstreamPreconnectRatio() > 1.0) {
+            postThreadLocalHostHealthy(host);
           }
         });
   }
@@ -670,6 +826,8 @@ void ClusterManagerImpl::updateClusterCounts() {
     }
   }
   cm_stats_.active_clusters_.set(active_clusters_.size());
+  cm_stats_.lazy_clusters_.set(lazy_clusters_.size());
+  cm_stats_.queued_warming_clusters_.set(queued_warming_clusters_.size());
   cm_stats_.warming_clusters_.set(warming_clusters_.size());
 }
 
@@ -679,9 +837,13 @@ ThreadLocalCluster* ClusterManagerImpl::get(absl::string_view cluster) {
   auto entry = cluster_manager.thread_local_clusters_.find(cluster);
   if (entry != cluster_manager.thread_local_clusters_.end()) {
     return entry->second.get();
-  } else {
-    return nullptr;
   }
+
+  // A lazy cluster is instantiated on the main thread, so the caller only finds it once it is warm.
+  if (lazy_cluster_initialization_) {
+    requestLazyClusterInitialization(cluster);
+  }
+  return nullptr;
 }
 
 Http::ConnectionPool::Instance*
@@ -714,9 +876,13 @@ Tcp::ConnectionPool::Instance* ClusterManagerImpl::tcpConnPoolForCluster(
 
 void ClusterManagerImpl::postThreadLocalHostRemoval(const Cluster& cluster,
                                                     const HostVector& hosts_removed) {
-  tls_->runOnAllThreads([this, name = cluster.info()->name(), hosts_removed]() {
-    ThreadLocalClusterManagerImpl::removeHosts(name, hosts_removed, *tls_);
-  });
+  // Queued behind the membership update which removed the hosts, so that the workers drain their
+  // connection pools once they are out of the host sets.
+  PendingClusterUpdate removal;
+  removal.name_ = cluster.info()->name();
+  removal.host_removal_ = true;
+  removal.hosts_removed_ = std::make_shared<const HostVector>(hosts_removed);
+  queueClusterUpdate(std::move(removal));
 }
 
 void ClusterManagerImpl::postThreadLocalClusterUpdate(const Cluster& cluster, uint32_t priority,
@@ -724,21 +890,179 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(const Cluster& cluster, ui
                                                       const HostVector& hosts_removed) {
   const auto& host_set = cluster.prioritySet().hostSetsPerPriority()[priority];
 
-  tls_->runOnAllThreads([this, name = cluster.info()->name(), priority,
-                         update_params = HostSetImpl::updateHostsParams(*host_set),
-                         locality_weights = host_set->localityWeights(), hosts_added, hosts_removed,
-                         overprovisioning_factor = host_set->overprovisioningFactor()]() {
-    ThreadLocalClusterManagerImpl::updateClusterMembership(
-        name, priority, update_params, locality_weights, hosts_added, hosts_removed, *tls_,
-        overprovisioning_factor);
+  PendingClusterUpdate update;
+  update.name_ = cluster.info()->name();
+  update.priority_ = priority;
+  update.update_params_ = HostSetImpl::updateHostsParams(*host_set);
+  update.locality_weights_ = host_set->localityWeights();
+  update.hosts_added_ = std::make_shared<const HostVector>(hosts_added);
+  update.hosts_removed_ = std::make_shared<const HostVector>(hosts_removed);
+  update.overprovisioning_factor_ = host_set->overprovisioningFactor();
+  queueClusterUpdate(std::move(update));
+}
+
+void ClusterManagerImpl::queueClusterUpdate(PendingClusterUpdate&& update) {
+  PendingClusterUpdates& pending = *pending_cluster_updates_;
+  const bool first_pending_update = pending.updates_.empty();
+  if (update.host_removal_) {
+    pending.updates_.emplace_back(std::move(update));
+  } else {
+    auto last_update = pending.last_update_.find({update.name_, update.priority_});
+    if (last_update != pending.last_update_.end() &&
+        coalesceClusterUpdate(pending.updates_[last_update->second], update)) {
+      cm_stats_.update_coalesced_.inc();
+    } else {
+      pending.last_update_[{update.name_, update.priority_}] = pending.updates_.size();
+      pending.updates_.emplace_back(std::move(update));
+    }
+  }
+
+  // The batch is posted once per dispatcher iteration, however many clusters are updated in it.
+  if (first_pending_update) {
+    std::weak_ptr<PendingClusterUpdates> weak_pending = pending_cluster_updates_;
+    dispatcher_.post([this, weak_pending]() -> void {
+      if (weak_pending.lock() != nullptr) {
+        postPendingClusterUpdates();
+      }
+    });
+  }
+}
+
+bool ClusterManagerImpl::coalesceClusterUpdate(PendingClusterUpdate& pending,
+                                               PendingClusterUpdate& update) {
+  // The workers must still see every added and removed host, so a later update can only be folded
+  // into a pending one if no host is both added by one of them and removed by the other.
+  const auto intersects = [](const HostVector& lhs, const HostVector& rhs) -> bool {
+    if (lhs.empty() || rhs.empty()) {
+      return false;
+    }
+    const std::unordered_set<HostSharedPtr> hosts(lhs.begin(), lhs.end());
+    return std::any_of(rhs.begin(), rhs.end(),
+                       [&hosts](const HostSharedPtr& host) { return hosts.count(host) > 0; });
+  };
+  if (intersects(*pending.hosts_added_, *update.hosts_removed_) ||
+      intersects(*pending.hosts_removed_, *update.hosts_added_)) {
+    return false;
+  }
+
+  const auto concat = [](const HostVectorConstSharedPtr& first,
+                         const HostVectorConstSharedPtr& second) -> HostVectorConstSharedPtr {
+    if (second->empty()) {
+      return first;
+    }
+    if (first->empty()) {
+      return second;
+    }
+    auto hosts = std::make_shared<HostVector>(*first);
+    hosts->insert(hosts->end(), second->begin(), second->end());
+    return hosts;
+  };
+  pending.hosts_added_ = concat(pending.hosts_added_, update.hosts_added_);
+  pending.hosts_removed_ = concat(pending.hosts_removed_, update.hosts_removed_);
+
+  // The host set snapshot is complete, so the latest one replaces the pending one.
+  pending.update_params_ = std::move(update.update_params_);
+  pending.locality_weights_ = std::move(update.locality_weights_);
+  pending.overprovisioning_factor_ = update.overprovisioning_factor_;
+  return true;
+}
+
+void ClusterManagerImpl::postPendingClusterUpdates() {
+  PendingClusterUpdates& pending = *pending_cluster_updates_;
+  if (pending.updates_.empty()) {
+    return;
+  }
+
+  // A single callback is posted to each worker for the whole batch, sharing the updates.
+  auto updates = std::make_shared<const std::vector<PendingClusterUpdate>>(
+      std::move(pending.updates_));
+  pending.updates_.clear();
+  pending.last_update_.clear();
+  cm_stats_.update_batch_posted_.inc();
+
+  tls_->runOnAllThreads([this, updates]() {
+    for (const PendingClusterUpdate& update : *updates) {
+      if (update.host_removal_) {
+        ThreadLocalClusterManagerImpl::removeHosts(update.name_, *update.hosts_removed_, *tls_);
+        continue;
+      }
+      ThreadLocalClusterManagerImpl::updateClusterMembership(
+          update.name_, update.priority_, update.update_params_, update.locality_weights_,
+          *update.hosts_added_, *update.hosts_removed_, *tls_, update.overprovisioning_factor_);
+    }
   });
 }
 
 void ClusterManagerImpl::postThreadLocalHealthFailure(const HostSharedPtr& host) {
+  postPendingClusterUpdates();
   tls_->runOnAllThreads(
       [this, host] { ThreadLocalClusterManagerImpl::onHostHealthFailure(host, *tls_); });
 }
 
+void ClusterManagerImpl::postThreadLocalHostHealthy(const HostSharedPtr& host) {
+  postPendingClusterUpdates();
+  tls_->runOnAllThreads(
+      [this, host] { ThreadLocalClusterManagerImpl::onHostHealthy(host, *tls_); });
+}
+
+Http::SharedConnPoolSharedPtr
+ClusterManagerImpl::sharedHttp2ConnPool(const HostConstSharedPtr& host,
+                                        ResourcePriority priority) {
+  absl::MutexLock lock(&shared_http2_conn_pools_->mutex_);
+  std::weak_ptr<Http::SharedConnPool>& entry =
+      shared_http2_conn_pools_->pools_[host][enumToInt(priority)];
+  Http::SharedConnPoolSharedPtr pool = entry.lock();
+  if (pool == nullptr) {
+    // The pool may outlive the cluster manager, though not the factory or the main thread's
+    // dispatcher, so it must not capture this.
+    std::weak_ptr<SharedHttp2ConnPools> weak_pools = shared_http2_conn_pools_;
+    pool = std::make_shared<Http::SharedConnPool>(
+        dispatcher_, Http::Protocol::Http2, host,
+        [&factory = factory_, &dispatcher = dispatcher_, host, priority]() {
+          return factory.allocateConnPool(dispatcher, host, priority, Http::Protocol::Http2,
+                                          nullptr);
+        },
+        [weak_pools, host]() {
+          std::shared_ptr<SharedHttp2ConnPools> pools = weak_pools.lock();
+          if (pools != nullptr) {
+            pools->removeExpired(host);
+          }
+        });
+    entry = pool;
+  }
+  return pool;
+}
+
+void ClusterManagerImpl::SharedHttp2ConnPools::removeExpired(const HostConstSharedPtr& host) {
+  absl::MutexLock lock(&mutex_);
+  auto it = pools_.find(host);
+  if (it != pools_.end() &&
+      std::all_of(it->second.begin(), it->second.end(),
+                  [](const std::weak_ptr<Http::SharedConnPool>& pool) { return pool.expired(); })) {
+    pools_.erase(it);
+  }
+}
+
+void ClusterManagerImpl::SharedHttp2ConnPools::shutdown() {
+  // The pools are shut down without the lock held, since the last reference to a pool may be
+  // released here, and its destruction removes it from the map.
+  std::vector<Http::SharedConnPoolSharedPtr> to_shutdown;
+  {
+    absl::MutexLock lock(&mutex_);
+    for (const auto& host_pools : pools_) {
+      for (const auto& weak_pool : host_pools.second) {
+        Http::SharedConnPoolSharedPtr pool = weak_pool.lock();
+        if (pool != nullptr) {
+          to_shutdown.push_back(pool);
+        }
+      }
+    }
+  }
+  for (const Http::SharedConnPoolSharedPtr& pool : to_shutdown) {
+    pool->shutdown();
+  }
+}
+
 Host::CreateConnectionData ClusterManagerImpl::tcpConnForCluster(
     const std::string& cluster, LoadBalancerContext* context,
     Network::TransportSocketOptionsSharedPtr transport_socket_options) {
@@ -1007,6 +1331,80 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
     ENVOY_LOG(debug, "re-creating local LB for TLS cluster {}", name);
     cluster_entry->lb_ = cluster_entry->lb_factory_->create();
   }
+
+  if (!hosts_added.empty()) {
+    config.preconnectHosts(*cluster_entry, hosts_added);
+  }
+}
+
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::onHostHealthy(const HostSharedPtr& host,
+                                                                     ThreadLocal::Slot& tls) {
+  ThreadLocalClusterManagerImpl& config = tls.getTyped<ThreadLocalClusterManagerImpl>();
+  const auto cluster_entry = config.thread_local_clusters_.find(host->cluster().name());
+  if (cluster_entry != config.thread_local_clusters_.end()) {
+    config.preconnectHosts(*cluster_entry->second, {host});
+  }
+}
+
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::preconnectHosts(
+    ClusterEntry& cluster_entry, const HostVector& hosts) {
+  const ClusterInfo& cluster_info = *cluster_entry.cluster_info_;
+  if (cluster_info.perUpstreamPreconnectRatio() <= 1.0) {
+    return;
+  }
+
+  // Only open the kinds of connections which this worker has recently used for the cluster, as
+  // shown by it having connection pools to the cluster's other hosts.
+  bool http = false;
+  bool tcp = false;
+  for (const auto& host_set : cluster_entry.priority_set_.hostSetsPerPriority()) {
+    for (const HostSharedPtr& host : host_set->hosts()) {
+      http = http || host_http_conn_pool_map_.count(host) > 0;
+      tcp = tcp || host_tcp_conn_pool_map_.count(host) > 0;
+      if (http && tcp) {
+        break;
+      }
+    }
+  }
+  if (!http && !tcp) {
+    return;
+  }
+
+  // Connections are opened for requests without any socket options of their own, which most
+  // requests are.
+  const ResourcePriority priority = ResourcePriority::Default;
+  const Http::Protocol protocol = (cluster_info.features() & ClusterInfo::Features::HTTP2)
+                                      ? Http::Protocol::Http2
+                                      : Http::Protocol::Http11;
+  for (const HostSharedPtr& host : hosts) {
+    if (host->health() != Host::Health::Healthy) {
+      continue;
+    }
+
+    ENVOY_LOG(debug, "preconnecting to host {} of TLS cluster {}", host->address()->asString(),
+              cluster_info.name());
+    if (http) {
+      ConnPoolsContainer& container = *getHttpConnPoolsContainer(host, true);
+      ConnPoolsContainer::ConnPools::OptPoolRef pool =
+          container.pools_->getPool(priority, {uint8_t(protocol)}, [&]() {
+            return parent_.factory_.allocateConnPool(thread_local_dispatcher_, host, priority,
+                                                     protocol, nullptr);
+          });
+      if (pool.has_value()) {
+        pool.value().get().preconnect(1);
+      }
+    }
+
+    if (tcp) {
+      Tcp::ConnectionPool::InstancePtr& pool =
+          host_tcp_conn_pool_map_[host].pools_[{uint8_t(priority)}];
+      if (!pool) {
+        pool = parent_.factory_.allocateTcpConnPool(thread_local_dispatcher_, host, priority,
+                                                    nullptr, nullptr);
+      }
+      pool->preconnect(1);
+    }
+  }
 }
 
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::onHostHealthFailure(
@@ -1171,7 +1569,13 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
   // Note: to simplify this, we assume that the factory is only called in the scope of this
   // function. Otherwise, we'd need to capture a few of these variables by value.
   ConnPoolsContainer::ConnPools::OptPoolRef pool =
-      container.pools_->getPool(priority, hash_key, [&]() {
+      container.pools_->getPool(priority, hash_key, [&]() -> Http::ConnectionPool::InstancePtr {
+        if (protocol == Http::Protocol::Http2 && upstream_options->empty() &&
+            (cluster_info_->features() &
+             ClusterInfo::Features::SHARE_HTTP2_CONNECTIONS_ACROSS_WORKERS)) {
+          return parent_.parent_.sharedHttp2ConnPool(host, priority)
+              ->createClient(parent_.thread_local_dispatcher_);
+        }
         return parent_.parent_.factory_.allocateConnPool(
             parent_.thread_local_dispatcher_, host, priority, protocol,
             !upstream_options->empty() ? upstream_options : nullptr);
@@ -1260,7 +1664,7 @@ std::pair<ClusterSharedPtr, ThreadAwareLoadBalancerPtr> ProdClusterManagerFactor
     const envoy::api::v2::Cluster& cluster, ClusterManager& cm,
     Outlier::EventLoggerSharedPtr outlier_event_logger, bool added_via_api) {
   return ClusterFactoryImplBase::create(
-      cluster, cm, stats_, tls_, dns_resolver_, ssl_context_manager_, runtime_, random_,
+      cluster, cm, stats_, tls_, cm.dnsResolver(), ssl_context_manager_, runtime_, random_,
       main_thread_dispatcher_, log_manager_, local_info_, admin_, singleton_manager_,
       outlier_event_logger, added_via_api,
       added_via_api ? validation_context_.dynamicValidationVisitor()
@@ -1271,7 +1675,8 @@ std::pair<ClusterSharedPtr, ThreadAwareLoadBalancerPtr> ProdClusterManagerFactor
 CdsApiPtr ProdClusterManagerFactory::createCds(const envoy::api::v2::core::ConfigSource& cds_config,
                                                ClusterManager& cm) {
   // TODO(htuch): Differentiate static vs. dynamic validation visitors.
-  return CdsApiImpl::create(cds_config, cm, stats_, validation_context_.dynamicValidationVisitor());
+  return CdsApiImpl::create(cds_config, cm, stats_, validation_context_.dynamicValidationVisitor(),
+                            api_);
 }
 
 } // namespace Upstream
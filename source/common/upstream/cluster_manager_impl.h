@@ -7,6 +7,8 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "envoy/api/api.h"
@@ -24,10 +26,16 @@
 #include "common/config/grpc_mux_impl.h"
 #include "common/config/subscription_factory_impl.h"
 #include "common/http/async_client_impl.h"
+#include "common/http/shared_conn_pool.h"
+#include "common/upstream/hedge_tracker_impl.h"
 #include "common/upstream/load_stats_reporter.h"
+#include "common/upstream/offload_threads_impl.h"
 #include "common/upstream/priority_conn_pool_map.h"
 #include "common/upstream/upstream_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -71,6 +79,7 @@ public:
   CdsApiPtr createCds(const envoy::api::v2::core::ConfigSource& cds_config,
                       ClusterManager& cm) override;
   Secret::SecretManager& secretManager() override { return secret_manager_; }
+  Network::DnsResolverSharedPtr dnsResolver() override { return dns_resolver_; }
 
 protected:
   Event::Dispatcher& main_thread_dispatcher_;
@@ -143,7 +152,7 @@ private:
 /**
  * All cluster manager stats. @see stats_macros.h
  */
-#define ALL_CLUSTER_MANAGER_STATS(COUNTER, GAUGE)                                                  \
+#define ALL_CLUSTER_MANAGER_STATS(COUNTER, GAUGE, HISTOGRAM)                                       \
   COUNTER(cluster_added)                                                                           \
   COUNTER(cluster_modified)                                                                        \
   COUNTER(cluster_removed)                                                                         \
@@ -151,14 +160,22 @@ private:
   COUNTER(cluster_updated_via_merge)                                                               \
   COUNTER(update_merge_cancelled)                                                                  \
   COUNTER(update_out_of_merge_window)                                                              \
+  COUNTER(update_coalesced)                                                                        \
+  COUNTER(update_batch_posted)                                                                     \
+  COUNTER(lazy_cluster_initialized)                                                                \
+  COUNTER(lazy_cluster_initialization_failed)                                                      \
   GAUGE(active_clusters, NeverImport)                                                              \
-  GAUGE(warming_clusters, NeverImport)
+  GAUGE(lazy_clusters, NeverImport)                                                                \
+  GAUGE(queued_warming_clusters, NeverImport)                                                      \
+  GAUGE(warming_clusters, NeverImport)                                                             \
+  HISTOGRAM(cluster_warming_duration_ms)
 
 /**
  * Struct definition for all cluster manager stats. @see stats_macros.h
  */
 struct ClusterManagerStats {
-  ALL_CLUSTER_MANAGER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  ALL_CLUSTER_MANAGER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                            GENERATE_HISTOGRAM_STRUCT)
 };
 
 /**
@@ -212,6 +229,11 @@ public:
     ads_mux_.reset();
     active_clusters_.clear();
     warming_clusters_.clear();
+    queued_warming_clusters_.clear();
+    lazy_clusters_.clear();
+    pending_cluster_updates_->updates_.clear();
+    pending_cluster_updates_->last_update_.clear();
+    shared_http2_conn_pools_->shutdown();
     updateClusterCounts();
   }
 
@@ -231,6 +253,13 @@ public:
 
   std::size_t warmingClusterCount() const override { return warming_clusters_.size(); }
 
+  OffloadThreads* offloadThreads() override { return offload_threads_.get(); }
+
+  Network::DnsResolverSharedPtr dnsResolver() override { return dns_resolver_; }
+
+  bool initializeLazyCluster(const std::string& cluster) override;
+  std::vector<std::string> lazyClusters() override;
+
 protected:
   virtual void postThreadLocalHostRemoval(const Cluster& cluster, const HostVector& hosts_removed);
   virtual void postThreadLocalClusterUpdate(const Cluster& cluster, uint32_t priority,
@@ -306,6 +335,7 @@ private:
       const PrioritySet& prioritySet() override { return priority_set_; }
       ClusterInfoConstSharedPtr info() override { return cluster_info_; }
       LoadBalancer& loadBalancer() override { return *lb_; }
+      HedgeTrackerSharedPtr hedgeTracker() override { return hedge_tracker_; }
 
       ThreadLocalClusterManagerImpl& parent_;
       PrioritySetImpl priority_set_;
@@ -317,6 +347,7 @@ private:
       LoadBalancerPtr lb_;
       ClusterInfoConstSharedPtr cluster_info_;
       Http::AsyncClientImpl http_async_client_;
+      HedgeTrackerSharedPtr hedge_tracker_{std::make_shared<HedgeTrackerImpl>()};
     };
 
     using ClusterEntryPtr = std::unique_ptr<ClusterEntry>;
@@ -338,6 +369,8 @@ private:
                                         const HostVector& hosts_removed, ThreadLocal::Slot& tls,
                                         uint64_t overprovisioning_factor);
     static void onHostHealthFailure(const HostSharedPtr& host, ThreadLocal::Slot& tls);
+    static void onHostHealthy(const HostSharedPtr& host, ThreadLocal::Slot& tls);
+    void preconnectHosts(ClusterEntry& cluster_entry, const HostVector& hosts);
 
     ConnPoolsContainer* getHttpConnPoolsContainer(const HostConstSharedPtr& host,
                                                   bool allocate = false);
@@ -382,6 +415,8 @@ private:
     // Optional thread aware LB depending on the LB type. Not all clusters have one.
     ThreadAwareLoadBalancerPtr thread_aware_lb_;
     SystemTime last_updated_;
+    // When the warming of the cluster started, if it is warming.
+    MonotonicTime warming_started_;
   };
 
   struct ClusterUpdateCallbacksHandleImpl : public ClusterUpdateCallbacksHandle,
@@ -425,6 +460,64 @@ private:
     MonotonicTime last_updated_;
   };
 
+  /**
+   * The HTTP/2 pools shared by the workers, by host and priority. The pools are owned by the
+   * clients the workers make streams through, so only weak references are held here. Workers look
+   * pools up while the main thread removes them, hence the lock.
+   */
+  struct SharedHttp2ConnPools {
+    // Removes the pools of a host which have been destroyed.
+    void removeExpired(const HostConstSharedPtr& host);
+    // Shuts all of the pools down, closing their connections.
+    void shutdown();
+
+    absl::Mutex mutex_;
+    std::unordered_map<HostConstSharedPtr,
+                       std::array<std::weak_ptr<Http::SharedConnPool>, NumResourcePriorities>>
+        pools_ GUARDED_BY(mutex_);
+  };
+
+  // A cluster membership update waiting to be posted to the worker threads. The host vectors are
+  // immutable and shared by all the workers rather than copied for each of them.
+  struct PendingClusterUpdate {
+    std::string name_;
+    // Set if the update only drains the connection pools of hosts_removed_.
+    bool host_removal_{};
+    uint32_t priority_{};
+    PrioritySet::UpdateHostsParams update_params_;
+    LocalityWeightsConstSharedPtr locality_weights_;
+    HostVectorConstSharedPtr hosts_added_;
+    HostVectorConstSharedPtr hosts_removed_;
+    uint64_t overprovisioning_factor_{};
+  };
+
+  // The cluster membership updates made during the current dispatcher iteration. They are posted
+  // to the workers as a single batch at the end of the iteration, or before any other cross-thread
+  // cluster event so that the workers see the events in order.
+  struct PendingClusterUpdates {
+    std::vector<PendingClusterUpdate> updates_;
+    // The index in updates_ of the last membership update of each cluster and priority.
+    std::map<std::pair<std::string, uint32_t>, size_t> last_update_;
+  };
+
+  // A cluster added via API while lazy cluster initialization is enabled, which has not been
+  // instantiated yet. Only its configuration is kept.
+  struct LazyCluster {
+    envoy::api::v2::Cluster cluster_config_;
+    std::string version_info_;
+    uint64_t config_hash_;
+  };
+
+  /**
+   * The names of the lazy clusters, looked up by the workers when a cluster they are asked for is
+   * missing. The value is whether the initialization of the cluster was requested already, so that
+   * it is only posted to the main thread once.
+   */
+  struct LazyClusterNames {
+    absl::Mutex mutex_;
+    absl::flat_hash_map<std::string, bool> requested_ GUARDED_BY(mutex_);
+  };
+
   using PendingUpdatesPtr = std::unique_ptr<PendingUpdates>;
   using PendingUpdatesByPriorityMap = std::unordered_map<uint32_t, PendingUpdatesPtr>;
   using PendingUpdatesByPriorityMapPtr = std::unique_ptr<PendingUpdatesByPriorityMap>;
@@ -433,15 +526,33 @@ private:
   void applyUpdates(const Cluster& cluster, uint32_t priority, PendingUpdates& updates);
   bool scheduleUpdate(const Cluster& cluster, uint32_t priority, bool mergeable,
                       const uint64_t timeout);
+  bool addLazyCluster(const envoy::api::v2::Cluster& cluster, const std::string& version_info,
+                      uint64_t config_hash);
   void createOrUpdateThreadLocalCluster(ClusterData& cluster);
   ProtobufTypes::MessagePtr dumpClusterConfigs();
   static ClusterManagerStats generateStats(Stats::Scope& scope);
   void loadCluster(const envoy::api::v2::Cluster& cluster, const std::string& version_info,
                    bool added_via_api, ClusterMap& cluster_map);
+  void loadAndWarmCluster(const envoy::api::v2::Cluster& cluster, const std::string& version_info);
+  void startWarming(const std::string& cluster_name);
+  // Starts warming the queued clusters while fewer than max_concurrent_warming_clusters_ warm.
+  void startQueuedWarming();
   void onClusterInit(Cluster& cluster);
   void postThreadLocalHealthFailure(const HostSharedPtr& host);
+  void postThreadLocalHostHealthy(const HostSharedPtr& host);
+  void queueClusterUpdate(PendingClusterUpdate&& update);
+  void requestLazyClusterInitialization(absl::string_view cluster);
+  void postPendingClusterUpdates();
+  static bool coalesceClusterUpdate(PendingClusterUpdate& pending, PendingClusterUpdate& update);
+  Http::SharedConnPoolSharedPtr sharedHttp2ConnPool(const HostConstSharedPtr& host,
+                                                    ResourcePriority priority);
   void updateClusterCounts();
 
+  // Declared first so that the threads outlive the clusters, whose health checkers are deleted on
+  // them.
+  std::unique_ptr<OffloadThreadsImpl> offload_threads_;
+  // Declared after the offload threads, as it may use them.
+  Network::DnsResolverSharedPtr dns_resolver_;
   ClusterManagerFactory& factory_;
   Runtime::Loader& runtime_;
   Stats::Store& stats_;
@@ -453,6 +564,14 @@ protected:
 
 private:
   ClusterMap warming_clusters_;
+  // The warming clusters waiting for one of the max_concurrent_warming_clusters_ to complete before
+  // starting to warm, in the order they were added. They are in warming_clusters_ too.
+  std::list<std::string> queued_warming_clusters_;
+  // Only set from the configuration in the constructor. 0 means no limit.
+  uint32_t max_concurrent_warming_clusters_{};
+  // Only set from the configuration in the constructor, so that the workers may read it.
+  bool lazy_cluster_initialization_{};
+  std::unordered_map<std::string, LazyCluster> lazy_clusters_;
   envoy::api::v2::core::BindConfig bind_config_;
   Outlier::EventLoggerSharedPtr outlier_event_logger_;
   const LocalInfo::LocalInfo& local_info_;
@@ -470,6 +589,16 @@ private:
   Event::Dispatcher& dispatcher_;
   Http::Context& http_context_;
   Config::SubscriptionFactoryImpl subscription_factory_;
+  // Shared so that the pools, which may outlive the cluster manager until their last clients are
+  // destroyed, can remove themselves if it still exists.
+  std::shared_ptr<SharedHttp2ConnPools> shared_http2_conn_pools_{
+      std::make_shared<SharedHttp2ConnPools>()};
+  // Shared so that the posted flush of the batch is a no-op once the cluster manager is destroyed.
+  std::shared_ptr<PendingClusterUpdates> pending_cluster_updates_{
+      std::make_shared<PendingClusterUpdates>()};
+  // Shared so that the initializations requested by the workers are dropped once the cluster
+  // manager is destroyed.
+  std::shared_ptr<LazyClusterNames> lazy_cluster_names_{std::make_shared<LazyClusterNames>()};
 };
 
 } // namespace Upstream
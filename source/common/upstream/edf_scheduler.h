@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <queue>
+#include <vector>
 
 #include "common/common/assert.h"
 
@@ -67,6 +69,24 @@ public:
     ASSERT(queue_.top().deadline_ >= current_time_);
   }
 
+  /**
+   * Insert entries into an empty queue, as add() would one by one but in O(n) rather than
+   * O(n log n) time.
+   * @param entries supplies the shared pointers to the entries.
+   * @param weight supplies a function returning the floating point weight of an entry.
+   */
+  template <class Entries, class WeightFn> void addAll(const Entries& entries, WeightFn weight) {
+    ASSERT(queue_.empty());
+    std::vector<EdfEntry> edf_entries;
+    edf_entries.reserve(entries.size());
+    for (const auto& entry : entries) {
+      const double entry_weight = weight(*entry);
+      ASSERT(entry_weight > 0);
+      edf_entries.push_back({current_time_ + 1.0 / entry_weight, order_offset_++, entry});
+    }
+    queue_ = std::priority_queue<EdfEntry>(std::less<EdfEntry>(), std::move(edf_entries));
+  }
+
   /**
    * Implements empty() on the internal queue. Does not attempt to discard expired elements.
    * @return bool whether or not the internal queue is empty.
@@ -1,8 +1,13 @@
 #include "common/upstream/eds.h"
 
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
+
 #include "envoy/api/v2/eds.pb.validate.h"
 
 #include "common/common/utility.h"
+#include "common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -17,6 +22,7 @@ EdsClusterImpl::EdsClusterImpl(
       cluster_name_(cluster.eds_cluster_config().service_name().empty()
                         ? cluster.name()
                         : cluster.eds_cluster_config().service_name()),
+      time_source_(factory_context.dispatcher().timeSource()),
       validation_visitor_(factory_context.messageValidationVisitor()) {
   Event::Dispatcher& dispatcher = factory_context.dispatcher();
   assignment_timeout_ = dispatcher.createTimer([this]() -> void { onAssignmentTimeout(); });
@@ -32,16 +38,38 @@ EdsClusterImpl::EdsClusterImpl(
 void EdsClusterImpl::startPreInit() { subscription_->start({cluster_name_}); }
 
 void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& host_update_cb) {
-  std::unordered_map<std::string, HostSharedPtr> updated_hosts;
-  PriorityStateManager priority_state_manager(parent_, parent_.local_info_, &host_update_cb);
   for (const auto& locality_lb_endpoint : cluster_load_assignment_.endpoints()) {
-    const uint32_t priority = locality_lb_endpoint.priority();
-
-    if (priority > 0 && !parent_.cluster_name_.empty() &&
+    if (locality_lb_endpoint.priority() > 0 && !parent_.cluster_name_.empty() &&
         parent_.cluster_name_ == parent_.cm_.localClusterName()) {
       throw EnvoyException(fmt::format("Unexpected non-zero priority for local cluster '{}'.",
                                        parent_.cluster_name_));
     }
+  }
+
+  const MonotonicTime start = parent_.time_source_.monotonicTime();
+  if (parent_.priority_hosts_valid_ && applyDelta(host_update_cb)) {
+    parent_.info_->stats().update_delta_.inc();
+    parent_.info_->stats().update_delta_duration_us_.recordValue(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            parent_.time_source_.monotonicTime() - start)
+            .count());
+  } else {
+    applyFull(host_update_cb);
+    parent_.info_->stats().update_full_duration_us_.recordValue(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            parent_.time_source_.monotonicTime() - start)
+            .count());
+  }
+
+  // If we didn't setup to initialize when our first round of health checking is complete, just
+  // do it now.
+  parent_.onPreInitComplete();
+}
+
+void EdsClusterImpl::BatchUpdateHelper::applyFull(PrioritySet::HostUpdateCb& host_update_cb) {
+  std::unordered_map<std::string, HostSharedPtr> updated_hosts;
+  PriorityStateManager priority_state_manager(parent_, parent_.local_info_, &host_update_cb);
+  for (const auto& locality_lb_endpoint : cluster_load_assignment_.endpoints()) {
     priority_state_manager.initializePriorityFor(locality_lb_endpoint);
 
     for (const auto& lb_endpoint : locality_lb_endpoint.lb_endpoints()) {
@@ -49,6 +77,7 @@ void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& h
           "", parent_.resolveProtoAddress(lb_endpoint.endpoint().address()), locality_lb_endpoint,
           lb_endpoint);
     }
+    parent_.info_->stats().update_hosts_built_.add(locality_lb_endpoint.lb_endpoints_size());
   }
 
   // Track whether we rebuilt any LB structures.
@@ -86,14 +115,229 @@ void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& h
   }
 
   parent_.all_hosts_ = std::move(updated_hosts);
+  parent_.priority_hosts_valid_ = parent_.rebuildPriorityHosts(cluster_load_assignment_);
 
   if (!cluster_rebuilt) {
     parent_.info_->stats().update_no_rebuild_.inc();
   }
+}
 
-  // If we didn't setup to initialize when our first round of health checking is complete, just
-  // do it now.
-  parent_.onPreInitComplete();
+bool EdsClusterImpl::BatchUpdateHelper::applyDelta(PrioritySet::HostUpdateCb& host_update_cb) {
+  struct LocalityUpdate {
+    const envoy::api::v2::endpoint::LocalityLbEndpoints* locality_lb_endpoint_;
+    uint64_t hash_;
+    bool changed_;
+  };
+  struct PriorityUpdate {
+    std::vector<LocalityUpdate> localities_;
+    std::unordered_set<envoy::api::v2::core::Locality, LocalityHash, LocalityEqualTo>
+        locality_keys_;
+    std::unordered_set<envoy::api::v2::core::Locality, LocalityHash, LocalityEqualTo>
+        changed_locality_keys_;
+    // The previous hosts of the changed and removed localities, and the hosts pending removal.
+    HostVector current_hosts_;
+    bool touched_{};
+  };
+
+  auto& priority_hosts = parent_.priority_hosts_;
+  std::vector<PriorityUpdate> priority_updates;
+  PriorityStateManager priority_state_manager(parent_, parent_.local_info_, &host_update_cb);
+  uint64_t localities_reused = 0;
+  for (const auto& locality_lb_endpoint : cluster_load_assignment_.endpoints()) {
+    const uint32_t priority = locality_lb_endpoint.priority();
+    if (priority_updates.size() <= priority) {
+      priority_updates.resize(priority + 1);
+    }
+    PriorityUpdate& priority_update = priority_updates[priority];
+    if (!priority_update.locality_keys_.insert(locality_lb_endpoint.locality()).second) {
+      // The same locality twice in a priority can't be told apart.
+      return false;
+    }
+
+    const uint64_t hash = MessageUtil::hash(locality_lb_endpoint);
+    bool changed = true;
+    if (priority < priority_hosts.size()) {
+      auto existing = priority_hosts[priority].localities_.find(locality_lb_endpoint.locality());
+      changed = existing == priority_hosts[priority].localities_.end() ||
+                existing->second.hash_ != hash;
+    }
+    if (changed) {
+      priority_update.changed_locality_keys_.insert(locality_lb_endpoint.locality());
+    }
+    priority_update.localities_.push_back({&locality_lb_endpoint, hash, changed});
+    priority_state_manager.initializePriorityFor(locality_lb_endpoint);
+  }
+
+  const uint32_t overprovisioning_factor = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      cluster_load_assignment_.policy(), overprovisioning_factor, kDefaultOverProvisioningFactor);
+  const auto& host_sets = parent_.priority_set_.hostSetsPerPriority();
+  const size_t priority_count = std::max(priority_updates.size(), host_sets.size());
+  priority_updates.resize(priority_count);
+  priority_hosts.resize(priority_count);
+  auto& priority_state = priority_state_manager.priorityState();
+
+  // Find the priorities to update, building the hosts of their changed localities only.
+  std::unordered_set<std::string> built_addresses;
+  for (size_t i = 0; i < priority_count; ++i) {
+    PriorityUpdate& priority_update = priority_updates[i];
+    // Like a full update, leave alone the priorities below the highest one of the assignment which
+    // it has no localities for.
+    if (priority_update.localities_.empty() && i < priority_state.size()) {
+      continue;
+    }
+
+    HostMap current_hosts_by_address;
+    for (const auto& locality : priority_hosts[i].localities_) {
+      if (priority_update.locality_keys_.count(locality.first) > 0 &&
+          priority_update.changed_locality_keys_.count(locality.first) == 0) {
+        continue;
+      }
+      for (const HostSharedPtr& host : locality.second.hosts_) {
+        priority_update.current_hosts_.push_back(host);
+        current_hosts_by_address.emplace(host->address()->asString(), host);
+      }
+      priority_update.touched_ = true;
+    }
+    for (const HostSharedPtr& host : priority_hosts[i].pending_removal_) {
+      priority_update.current_hosts_.push_back(host);
+      current_hosts_by_address.emplace(host->address()->asString(), host);
+    }
+
+    const LocalityWeightsMap empty_locality_weights_map;
+    const LocalityWeightsMap& locality_weights_map =
+        i < priority_state.size() ? priority_state[i].second : empty_locality_weights_map;
+    if (i >= host_sets.size() || host_sets[i]->overprovisioningFactor() != overprovisioning_factor ||
+        i >= parent_.locality_weights_map_.size() ||
+        parent_.locality_weights_map_[i] != locality_weights_map) {
+      priority_update.touched_ = true;
+    }
+
+    for (const LocalityUpdate& update : priority_update.localities_) {
+      if (!update.changed_) {
+        localities_reused++;
+        continue;
+      }
+      priority_update.touched_ = true;
+      for (const auto& lb_endpoint : update.locality_lb_endpoint_->lb_endpoints()) {
+        auto address = parent_.resolveProtoAddress(lb_endpoint.endpoint().address());
+        const std::string address_string = address->asString();
+        if (!built_addresses.insert(address_string).second) {
+          // A duplicate address is only dropped by diffing all the hosts.
+          return false;
+        }
+        if (parent_.all_hosts_.count(address_string) > 0) {
+          // An existing host must come from the localities being updated and keep its locality,
+          // as it is matched by address and keeps the locality it was built with. A host which
+          // moved from another priority or locality needs all the hosts to be diffed.
+          auto current = current_hosts_by_address.find(address_string);
+          if (current == current_hosts_by_address.end() ||
+              !LocalityEqualTo()(current->second->locality(),
+                                 update.locality_lb_endpoint_->locality())) {
+            return false;
+          }
+        }
+        priority_state_manager.registerHostForPriority("", address, *update.locality_lb_endpoint_,
+                                                       lb_endpoint);
+      }
+      parent_.info_->stats().update_hosts_built_.add(
+          update.locality_lb_endpoint_->lb_endpoints_size());
+    }
+  }
+
+  // Diff the hosts of the changed localities and update their priorities.
+  bool cluster_rebuilt = false;
+  HostVector all_hosts_removed;
+  HostMap all_updated_hosts;
+  for (size_t i = 0; i < priority_count; ++i) {
+    PriorityUpdate& priority_update = priority_updates[i];
+    if (!priority_update.touched_) {
+      continue;
+    }
+
+    const auto& host_set = parent_.priority_set_.getOrCreateHostSet(i, overprovisioning_factor);
+    const HostVector empty_hosts;
+    const HostVector& new_hosts = i < priority_state.size() && priority_state[i].first != nullptr
+                                      ? *priority_state[i].first
+                                      : empty_hosts;
+    HostVector& current_hosts = priority_update.current_hosts_;
+    HostVector hosts_added;
+    HostVector hosts_removed;
+    const bool hosts_updated =
+        parent_.updateDynamicHostList(new_hosts, current_hosts, hosts_added, hosts_removed,
+                                      all_updated_hosts, parent_.all_hosts_);
+    all_hosts_removed.insert(all_hosts_removed.end(), hosts_removed.begin(), hosts_removed.end());
+
+    // Regroup the hosts by locality, replacing the changed and removed localities.
+    PriorityHosts& hosts = priority_hosts[i];
+    for (auto it = hosts.localities_.begin(); it != hosts.localities_.end();) {
+      if (priority_update.locality_keys_.count(it->first) == 0) {
+        it = hosts.localities_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    for (const LocalityUpdate& update : priority_update.localities_) {
+      if (update.changed_) {
+        hosts.localities_[update.locality_lb_endpoint_->locality()] = {update.hash_, {}};
+      }
+    }
+    hosts.pending_removal_.clear();
+    for (const HostSharedPtr& host : current_hosts) {
+      if (host->healthFlagGet(Host::HealthFlag::PENDING_DYNAMIC_REMOVAL)) {
+        hosts.pending_removal_.push_back(host);
+      } else {
+        ASSERT(priority_update.changed_locality_keys_.count(host->locality()) > 0);
+        hosts.localities_[host->locality()].hosts_.push_back(host);
+      }
+    }
+
+    // The hosts of the priority, in the order of the assignment, like a full update.
+    HostVectorSharedPtr priority_hosts_vector = std::make_shared<HostVector>();
+    for (const LocalityUpdate& update : priority_update.localities_) {
+      const HostVector& locality_hosts =
+          hosts.localities_[update.locality_lb_endpoint_->locality()].hosts_;
+      priority_hosts_vector->insert(priority_hosts_vector->end(), locality_hosts.begin(),
+                                    locality_hosts.end());
+    }
+    priority_hosts_vector->insert(priority_hosts_vector->end(), hosts.pending_removal_.begin(),
+                                  hosts.pending_removal_.end());
+
+    if (parent_.locality_weights_map_.size() <= i) {
+      parent_.locality_weights_map_.resize(i + 1);
+    }
+    LocalityWeightsMap empty_locality_weights_map;
+    LocalityWeightsMap& new_locality_weights_map =
+        i < priority_state.size() ? priority_state[i].second : empty_locality_weights_map;
+    if (hosts_updated || host_set.overprovisioningFactor() != overprovisioning_factor ||
+        parent_.locality_weights_map_[i] != new_locality_weights_map) {
+      parent_.locality_weights_map_[i] = new_locality_weights_map;
+      ENVOY_LOG(debug,
+                "EDS hosts or locality weights changed for cluster: {} current hosts {} priority "
+                "{} (delta)",
+                parent_.info_->name(), host_set.hosts().size(), host_set.priority());
+      priority_state_manager.updateClusterPrioritySet(i, std::move(priority_hosts_vector),
+                                                      hosts_added, hosts_removed, absl::nullopt,
+                                                      overprovisioning_factor);
+      cluster_rebuilt = true;
+    }
+  }
+
+  // The removed hosts go first, as a host replaced by one of the same address is also removed.
+  for (const HostSharedPtr& host : all_hosts_removed) {
+    auto existing = parent_.all_hosts_.find(host->address()->asString());
+    if (existing != parent_.all_hosts_.end() && existing->second == host) {
+      parent_.all_hosts_.erase(existing);
+    }
+  }
+  for (auto& host : all_updated_hosts) {
+    parent_.all_hosts_[host.first] = std::move(host.second);
+  }
+
+  parent_.info_->stats().update_localities_reused_.add(localities_reused);
+  if (!cluster_rebuilt) {
+    parent_.info_->stats().update_no_rebuild_.inc();
+  }
+  return true;
 }
 
 void EdsClusterImpl::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
@@ -127,14 +371,21 @@ void EdsClusterImpl::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt
 }
 
 void EdsClusterImpl::onConfigUpdate(
-    const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>& resources,
-    const Protobuf::RepeatedPtrField<std::string>&, const std::string&) {
-  if (!validateUpdateSize(resources.size())) {
+    const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>& added_resources,
+    const Protobuf::RepeatedPtrField<std::string>& removed_resources, const std::string&) {
+  // A removed assignment leaves the cluster without endpoints.
+  if (added_resources.empty() &&
+      std::find(removed_resources.begin(), removed_resources.end(), cluster_name_) !=
+          removed_resources.end()) {
+    applyEmptyAssignment();
+    return;
+  }
+  if (!validateUpdateSize(added_resources.size())) {
     return;
   }
   Protobuf::RepeatedPtrField<ProtobufWkt::Any> unwrapped_resource;
-  *unwrapped_resource.Add() = resources[0].resource();
-  onConfigUpdate(unwrapped_resource, resources[0].version());
+  *unwrapped_resource.Add() = added_resources[0].resource();
+  onConfigUpdate(unwrapped_resource, added_resources[0].version());
 }
 
 bool EdsClusterImpl::validateUpdateSize(int num_resources) {
@@ -156,13 +407,60 @@ void EdsClusterImpl::onAssignmentTimeout() {
   // TODO(vishalpowar) This is not going to work for incremental updates, and we
   // need to instead change the health status to indicate the assignments are
   // stale.
+  applyEmptyAssignment();
+  // Stat to track how often we end up with stale assignments.
+  info_->stats().assignment_stale_.inc();
+}
+
+void EdsClusterImpl::applyEmptyAssignment() {
   Protobuf::RepeatedPtrField<ProtobufWkt::Any> resources;
   envoy::api::v2::ClusterLoadAssignment resource;
   resource.set_cluster_name(cluster_name_);
   resources.Add()->PackFrom(resource);
   onConfigUpdate(resources, "");
-  // Stat to track how often we end up with stale assignments.
-  info_->stats().assignment_stale_.inc();
+}
+
+bool EdsClusterImpl::rebuildPriorityHosts(
+    const envoy::api::v2::ClusterLoadAssignment& cluster_load_assignment) {
+  const auto& host_sets = priority_set_.hostSetsPerPriority();
+  priority_hosts_.clear();
+  priority_hosts_.resize(host_sets.size());
+  for (const auto& locality_lb_endpoint : cluster_load_assignment.endpoints()) {
+    ASSERT(locality_lb_endpoint.priority() < priority_hosts_.size());
+    if (!priority_hosts_[locality_lb_endpoint.priority()]
+             .localities_
+             .emplace(locality_lb_endpoint.locality(),
+                      LocalityHosts{MessageUtil::hash(locality_lb_endpoint), {}})
+             .second) {
+      return false;
+    }
+  }
+
+  for (size_t priority = 0; priority < host_sets.size(); ++priority) {
+    PriorityHosts& priority_hosts = priority_hosts_[priority];
+    for (const HostSharedPtr& host : host_sets[priority]->hosts()) {
+      if (host->healthFlagGet(Host::HealthFlag::PENDING_DYNAMIC_REMOVAL)) {
+        priority_hosts.pending_removal_.push_back(host);
+        continue;
+      }
+      auto locality = priority_hosts.localities_.find(host->locality());
+      if (locality == priority_hosts.localities_.end()) {
+        return false;
+      }
+      locality->second.hosts_.push_back(host);
+    }
+  }
+
+  // Every locality must have a host per endpoint, which duplicate addresses or hosts which moved
+  // across localities would break.
+  for (const auto& locality_lb_endpoint : cluster_load_assignment.endpoints()) {
+    if (priority_hosts_[locality_lb_endpoint.priority()]
+            .localities_[locality_lb_endpoint.locality()]
+            .hosts_.size() != static_cast<size_t>(locality_lb_endpoint.lb_endpoints_size())) {
+      return false;
+    }
+  }
+  return true;
 }
 
 void EdsClusterImpl::reloadHealthyHostsHelper(const HostSharedPtr& host) {
@@ -208,6 +506,9 @@ void EdsClusterImpl::reloadHealthyHostsHelper(const HostSharedPtr& host) {
   if (host_to_exclude != nullptr) {
     ASSERT(all_hosts_.find(host_to_exclude->address()->asString()) != all_hosts_.end());
     all_hosts_.erase(host_to_exclude->address()->asString());
+    // The hosts by locality still have the excluded host, so the next assignment is applied in
+    // full.
+    priority_hosts_valid_ = false;
   }
 }
 
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "envoy/api/v2/core/base.pb.h"
 #include "envoy/api/v2/eds.pb.h"
 #include "envoy/config/subscription.h"
 #include "envoy/config/subscription_factory.h"
 #include "envoy/local_info/local_info.h"
 #include "envoy/secret/secret_manager.h"
+#include "envoy/common/time.h"
 #include "envoy/stats/scope.h"
 #include "envoy/upstream/locality.h"
 
@@ -51,6 +57,8 @@ private:
                               PriorityStateManager& priority_state_manager,
                               std::unordered_map<std::string, HostSharedPtr>& updated_hosts);
   bool validateUpdateSize(int num_resources);
+  void applyEmptyAssignment();
+  bool rebuildPriorityHosts(const envoy::api::v2::ClusterLoadAssignment& cluster_load_assignment);
 
   // ClusterImplBase
   void reloadHealthyHostsHelper(const HostSharedPtr& host) override;
@@ -67,16 +75,41 @@ private:
     void batchUpdate(PrioritySet::HostUpdateCb& host_update_cb) override;
 
   private:
+    // Applies the assignment to the localities which changed since the last one only. Returns
+    // false, without changing anything, if it can't, e.g. if a host moved across priorities.
+    bool applyDelta(PrioritySet::HostUpdateCb& host_update_cb);
+    void applyFull(PrioritySet::HostUpdateCb& host_update_cb);
+
     EdsClusterImpl& parent_;
     const envoy::api::v2::ClusterLoadAssignment& cluster_load_assignment_;
   };
 
+  // The hosts built from a LocalityLbEndpoints of the last assignment, and the hash of the
+  // LocalityLbEndpoints.
+  struct LocalityHosts {
+    uint64_t hash_{};
+    HostVector hosts_;
+  };
+  using LocalityHostsMap = std::unordered_map<envoy::api::v2::core::Locality, LocalityHosts,
+                                              LocalityHash, LocalityEqualTo>;
+  // The hosts of a priority by locality.
+  struct PriorityHosts {
+    LocalityHostsMap localities_;
+    // The hosts no longer in the assignment, kept while they pass active health checking.
+    HostVector pending_removal_;
+  };
+
   const ClusterManager& cm_;
   std::unique_ptr<Config::Subscription> subscription_;
   const LocalInfo::LocalInfo& local_info_;
   const std::string cluster_name_;
   std::vector<LocalityWeightsMap> locality_weights_map_;
   HostMap all_hosts_;
+  // The hosts of each priority by locality, valid if priority_hosts_valid_ is set, letting the next
+  // assignment be applied as a delta.
+  std::vector<PriorityHosts> priority_hosts_;
+  bool priority_hosts_valid_{};
+  TimeSource& time_source_;
   Event::TimerPtr assignment_timeout_;
   ProtobufMessage::ValidationVisitor& validation_visitor_;
 };
@@ -1,11 +1,17 @@
 #include "common/upstream/health_checker_base_impl.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "envoy/data/core/v2alpha/health_check_event.pb.h"
 #include "envoy/stats/scope.h"
 
 #include "common/network/utility.h"
+#include "common/protobuf/utility.h"
 #include "common/router/router.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -16,7 +22,7 @@ HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
                                              Runtime::RandomGenerator& random,
                                              HealthCheckEventLoggerPtr&& event_logger)
     : always_log_health_check_failures_(config.always_log_health_check_failures()),
-      cluster_(cluster), dispatcher_(dispatcher),
+      cluster_(cluster), cluster_info_(cluster.info()), dispatcher_(dispatcher),
       timeout_(PROTOBUF_GET_MS_REQUIRED(config, timeout)),
       unhealthy_threshold_(PROTOBUF_GET_WRAPPED_REQUIRED(config, unhealthy_threshold)),
       healthy_threshold_(PROTOBUF_GET_WRAPPED_REQUIRED(config, healthy_threshold)),
@@ -25,6 +31,7 @@ HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
       event_logger_(std::move(event_logger)), interval_(PROTOBUF_GET_MS_REQUIRED(config, interval)),
       no_traffic_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, no_traffic_interval, 60000)),
       initial_jitter_(PROTOBUF_GET_MS_OR_DEFAULT(config, initial_jitter, 0)),
+      spread_initial_checks_(config.spread_initial_checks()),
       interval_jitter_(PROTOBUF_GET_MS_OR_DEFAULT(config, interval_jitter, 0)),
       interval_jitter_percent_(config.interval_jitter_percent()),
       unhealthy_interval_(
@@ -32,7 +39,8 @@ HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
       unhealthy_edge_interval_(
           PROTOBUF_GET_MS_OR_DEFAULT(config, unhealthy_edge_interval, unhealthy_interval_.count())),
       healthy_edge_interval_(
-          PROTOBUF_GET_MS_OR_DEFAULT(config, healthy_edge_interval, interval_.count())) {
+          PROTOBUF_GET_MS_OR_DEFAULT(config, healthy_edge_interval, interval_.count())),
+      shared_config_hash_(config.share_across_clusters() ? MessageUtil::hash(config) : 0) {
   cluster_.prioritySet().addMemberUpdateCb(
       [this](const HostVector& hosts_added, const HostVector& hosts_removed) -> void {
         onClusterMemberUpdate(hosts_added, hosts_removed);
@@ -83,7 +91,7 @@ std::chrono::milliseconds HealthCheckerImplBase::interval(HealthState state,
   // If a connection has been established, we choose an interval based on the host's health. Please
   // refer to the HealthCheck API documentation for more details.
   uint64_t base_time_ms;
-  if (cluster_.info()->stats().upstream_cx_total_.used()) {
+  if (cluster_info_->stats().upstream_cx_total_.used()) {
     // When healthy/unhealthy threshold is configured the health transition of a host will be
     // delayed. In this situation Envoy should use the edge interval settings between health checks.
     //
@@ -133,19 +141,48 @@ HealthCheckerImplBase::intervalWithJitter(uint64_t base_time_ms,
   return std::chrono::milliseconds(final_ms);
 }
 
-void HealthCheckerImplBase::addHosts(const HostVector& hosts) {
-  for (const HostSharedPtr& host : hosts) {
+void HealthCheckerImplBase::addSessions(const HostVector& hosts) {
+  for (size_t i = 0; i < hosts.size(); i++) {
+    const HostSharedPtr& host = hosts[i];
     active_sessions_[host] = makeSession(host);
+    // Spread the first checks of the hosts evenly over the interval if configured.
+    const uint64_t initial_offset_ms =
+        spread_initial_checks_ ? interval_.count() * i / hosts.size() : 0;
+    active_sessions_[host]->start(std::chrono::milliseconds(initial_offset_ms));
+  }
+}
+
+std::string HealthCheckerImplBase::sharedKey(const Host& host) const {
+  return absl::StrCat(host.healthCheckAddress()->asString(), "_", shared_config_hash_);
+}
+
+void HealthCheckerImplBase::onClusterMemberUpdate(const HostVector& hosts_added,
+                                                  const HostVector& hosts_removed) {
+  // The hosts are set up on the main thread even when the checks are offloaded, as they are read
+  // on the main thread and the workers.
+  for (const HostSharedPtr& host : hosts_added) {
     host->setActiveHealthFailureType(Host::ActiveHealthFailureType::UNKNOWN);
     host->setHealthChecker(
         HealthCheckHostMonitorPtr{new HealthCheckHostMonitorImpl(shared_from_this(), host)});
-    active_sessions_[host]->start();
   }
+
+  if (main_thread_dispatcher_ == nullptr) {
+    updateSessions(hosts_added, hosts_removed);
+    return;
+  }
+
+  std::weak_ptr<HealthCheckerImplBase> weak_this = weak_this_;
+  dispatcher_.post([weak_this, hosts_added, hosts_removed]() -> void {
+    std::shared_ptr<HealthCheckerImplBase> shared_this = weak_this.lock();
+    if (shared_this != nullptr) {
+      shared_this->updateSessions(hosts_added, hosts_removed);
+    }
+  });
 }
 
-void HealthCheckerImplBase::onClusterMemberUpdate(const HostVector& hosts_added,
-                                                  const HostVector& hosts_removed) {
-  addHosts(hosts_added);
+void HealthCheckerImplBase::updateSessions(const HostVector& hosts_added,
+                                           const HostVector& hosts_removed) {
+  addSessions(hosts_added);
   for (const HostSharedPtr& host : hosts_removed) {
     auto session_iter = active_sessions_.find(host);
     ASSERT(active_sessions_.end() != session_iter);
@@ -170,11 +207,48 @@ void HealthCheckerImplBase::runCallbacks(HostSharedPtr host, HealthTransition ch
   // any HC happens against a host so just refresh the healthy stat here so that it is correct.
   refreshHealthyStat();
 
+  if (main_thread_dispatcher_ != nullptr) {
+    // The callbacks update the cluster, so when the checks are offloaded they run on the main
+    // thread. The checks completed in the same dispatcher loop iteration are handed over together.
+    offloaded_callbacks_.emplace_back(host, changed_state);
+    if (offloaded_callbacks_.size() == 1) {
+      std::weak_ptr<HealthCheckerImplBase> weak_this = weak_this_;
+      dispatcher_.post([weak_this]() -> void {
+        std::shared_ptr<HealthCheckerImplBase> shared_this = weak_this.lock();
+        if (shared_this != nullptr) {
+          shared_this->runOffloadedCallbacks();
+        }
+      });
+    }
+    return;
+  }
+
   for (const HostStatusCb& cb : callbacks_) {
     cb(host, changed_state);
   }
 }
 
+void HealthCheckerImplBase::runOffloadedCallbacks() {
+  std::vector<std::pair<HostSharedPtr, HealthTransition>> completed_checks;
+  completed_checks.swap(offloaded_callbacks_);
+  std::weak_ptr<HealthCheckerImplBase> weak_this = weak_this_;
+  main_thread_dispatcher_->post(
+      [weak_this, completed_checks]() -> void {
+        // The cluster may have been destroyed, along with its reference to the health checker.
+        std::shared_ptr<HealthCheckerImplBase> shared_this = weak_this.lock();
+        if (shared_this == nullptr) {
+          return;
+        }
+
+        for (const auto& completed_check : completed_checks) {
+          for (const HostStatusCb& cb : shared_this->callbacks_) {
+            cb(completed_check.first, completed_check.second);
+          }
+        }
+      },
+      Event::PostPriority::HealthCheck);
+}
+
 void HealthCheckerImplBase::HealthCheckHostMonitorImpl::setUnhealthy() {
   // This is called cross thread. The cluster/health checker might already be gone.
   std::shared_ptr<HealthCheckerImplBase> health_checker = health_checker_.lock();
@@ -188,8 +262,8 @@ void HealthCheckerImplBase::setUnhealthyCrossThread(const HostSharedPtr& host) {
   // checker. It might go away when we post to the main thread from a worker thread. To deal with
   // this we use the following sequence of events:
   // 1) We capture a weak reference to the health checker and post it from worker thread to main
-  //    thread.
-  // 2) On the main thread, we make sure it is still valid (as the cluster may have been destroyed).
+  //    thread, or to the thread the checks are offloaded to.
+  // 2) On that thread, we make sure it is still valid (as the cluster may have been destroyed).
   // 3) Additionally, the host/session may also be gone by then so we check that also.
   std::weak_ptr<HealthCheckerImplBase> weak_this = shared_from_this();
   dispatcher_.post([weak_this, host]() -> void {
@@ -208,8 +282,90 @@ void HealthCheckerImplBase::setUnhealthyCrossThread(const HostSharedPtr& host) {
 }
 
 void HealthCheckerImplBase::start() {
+  // The hosts of all priorities are added together, so that their first checks are spread over
+  // the interval together.
+  HostVector hosts;
   for (auto& host_set : cluster_.prioritySet().hostSetsPerPriority()) {
-    addHosts(host_set->hosts());
+    hosts.insert(hosts.end(), host_set->hosts().begin(), host_set->hosts().end());
+  }
+  onClusterMemberUpdate(hosts, {});
+}
+
+bool HealthCheckerImplBase::SharedSessions::add(ActiveHealthCheckSession& session,
+                                                const std::string& key) {
+  session.shared_key_ = key;
+  KeySessions& key_sessions = keys_[key];
+  key_sessions.sessions_.push_back(&session);
+  if (key_sessions.sessions_.size() == 1) {
+    return true;
+  }
+
+  if (key_sessions.last_result_.has_value()) {
+    session.interval_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+  return false;
+}
+
+void HealthCheckerImplBase::SharedSessions::remove(ActiveHealthCheckSession& session) {
+  auto key_sessions = keys_.find(session.shared_key_);
+  if (key_sessions == keys_.end()) {
+    return;
+  }
+
+  std::list<ActiveHealthCheckSession*>& sessions = key_sessions->second.sessions_;
+  const bool was_leader = sessions.front() == &session;
+  sessions.remove(&session);
+  if (sessions.empty()) {
+    keys_.erase(key_sessions);
+  } else if (was_leader) {
+    sessions.front()->interval_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
+bool HealthCheckerImplBase::SharedSessions::leader(const ActiveHealthCheckSession& session) const {
+  const auto key_sessions = keys_.find(session.shared_key_);
+  return key_sessions != keys_.end() && key_sessions->second.sessions_.front() == &session;
+}
+
+void HealthCheckerImplBase::SharedSessions::onResult(
+    ActiveHealthCheckSession& leader,
+    absl::optional<envoy::data::core::v2alpha::HealthCheckFailureType> failure_type,
+    bool degraded) {
+  const std::string key = leader.shared_key_;
+  auto key_sessions = keys_.find(key);
+  ASSERT(key_sessions != keys_.end() && key_sessions->second.sessions_.front() == &leader);
+  const Result result{failure_type, degraded};
+  key_sessions->second.last_result_ = result;
+
+  // A session taking on the result may be removed by it, if its cluster removes the host in
+  // response, so the sessions are looked up again for every one of them.
+  const std::vector<ActiveHealthCheckSession*> followers(
+      std::next(key_sessions->second.sessions_.begin()), key_sessions->second.sessions_.end());
+  for (ActiveHealthCheckSession* follower : followers) {
+    key_sessions = keys_.find(key);
+    if (key_sessions == keys_.end()) {
+      return;
+    }
+    const std::list<ActiveHealthCheckSession*>& sessions = key_sessions->second.sessions_;
+    if (std::find(sessions.begin(), sessions.end(), follower) != sessions.end()) {
+      applyResult(*follower, result);
+    }
+  }
+}
+
+void HealthCheckerImplBase::SharedSessions::takeLastResult(ActiveHealthCheckSession& session) {
+  const auto key_sessions = keys_.find(session.shared_key_);
+  if (key_sessions != keys_.end() && key_sessions->second.last_result_.has_value()) {
+    applyResult(session, key_sessions->second.last_result_.value());
+  }
+}
+
+void HealthCheckerImplBase::SharedSessions::applyResult(ActiveHealthCheckSession& session,
+                                                        const Result& result) {
+  if (result.failure_type_.has_value()) {
+    session.handleFailure(result.failure_type_.value());
+  } else {
+    session.handleSuccess(result.degraded_);
   }
 }
 
@@ -234,7 +390,23 @@ HealthCheckerImplBase::ActiveHealthCheckSession::~ActiveHealthCheckSession() {
   ASSERT(interval_timer_ == nullptr && timeout_timer_ == nullptr);
 }
 
+void HealthCheckerImplBase::ActiveHealthCheckSession::start(
+    std::chrono::milliseconds initial_offset) {
+  if (parent_.shared_sessions_ != nullptr &&
+      !parent_.shared_sessions_->add(*this, parent_.sharedKey(*host_))) {
+    return;
+  }
+  onInitialInterval(initial_offset);
+}
+
+bool HealthCheckerImplBase::ActiveHealthCheckSession::sharedFollower() const {
+  return parent_.shared_sessions_ != nullptr && !parent_.shared_sessions_->leader(*this);
+}
+
 void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
+  if (parent_.shared_sessions_ != nullptr) {
+    parent_.shared_sessions_->remove(*this);
+  }
   // The session is about to be deferred deleted. Make sure all timers are gone and any
   // implementation specific state is destroyed.
   interval_timer_.reset();
@@ -298,7 +470,13 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degrade
   parent_.runCallbacks(host_, changed_state);
 
   timeout_timer_->disableTimer();
+  if (sharedFollower()) {
+    return;
+  }
   interval_timer_->enableTimer(parent_.interval(HealthState::Healthy, changed_state));
+  if (parent_.shared_sessions_ != nullptr) {
+    parent_.shared_sessions_->onResult(*this, absl::nullopt, degraded);
+  }
 }
 
 HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::setUnhealthy(
@@ -347,8 +525,11 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleFailure(
     timeout_timer_->disableTimer();
   }
 
-  if (interval_timer_ != nullptr) {
+  if (interval_timer_ != nullptr && !sharedFollower()) {
     interval_timer_->enableTimer(parent_.interval(HealthState::Unhealthy, changed_state));
+    if (parent_.shared_sessions_ != nullptr) {
+      parent_.shared_sessions_->onResult(*this, type, false);
+    }
   }
 }
 
@@ -365,6 +546,12 @@ HealthCheckerImplBase::ActiveHealthCheckSession::clearPendingFlag(HealthTransiti
 }
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::onIntervalBase() {
+  if (sharedFollower()) {
+    // The interval timer of a session which does not send checks only fires when it is added, to
+    // take on the last result of the checks.
+    parent_.shared_sessions_->takeLastResult(*this);
+    return;
+  }
   onInterval();
   timeout_timer_->enableTimer(parent_.timeout_);
   parent_.stats_.attempt_.inc();
@@ -375,12 +562,17 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onTimeoutBase() {
   handleFailure(envoy::data::core::v2alpha::HealthCheckFailureType::NETWORK);
 }
 
-void HealthCheckerImplBase::ActiveHealthCheckSession::onInitialInterval() {
+void HealthCheckerImplBase::ActiveHealthCheckSession::onInitialInterval(
+    std::chrono::milliseconds initial_offset) {
   if (parent_.initial_jitter_.count() == 0) {
-    onIntervalBase();
+    if (initial_offset.count() == 0) {
+      onIntervalBase();
+    } else {
+      interval_timer_->enableTimer(initial_offset);
+    }
   } else {
-    interval_timer_->enableTimer(
-        std::chrono::milliseconds(parent_.intervalWithJitter(0, parent_.initial_jitter_)));
+    interval_timer_->enableTimer(initial_offset +
+                                 parent_.intervalWithJitter(0, parent_.initial_jitter_));
   }
 }
 
@@ -1,14 +1,23 @@
 #pragma once
 
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/v2/core/health_check.pb.h"
 #include "envoy/event/timer.h"
 #include "envoy/runtime/runtime.h"
+#include "envoy/singleton/instance.h"
 #include "envoy/stats/scope.h"
 #include "envoy/upstream/health_checker.h"
 
 #include "common/common/logger.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -39,17 +48,40 @@ class HealthCheckerImplBase : public HealthChecker,
                               protected Logger::Loggable<Logger::Id::hc>,
                               public std::enable_shared_from_this<HealthCheckerImplBase> {
 public:
+  class SharedSessions;
+  using SharedSessionsSharedPtr = std::shared_ptr<SharedSessions>;
+
   // Upstream::HealthChecker
   void addHostCheckCompleteCb(HostStatusCb callback) override { callbacks_.push_back(callback); }
   void start() override;
 
+  /**
+   * Shares the health checks of the hosts with the other health checkers using the same shared
+   * sessions. Must be called before start().
+   * @param shared_sessions supplies the sessions of the health checkers sharing their checks.
+   */
+  void shareChecks(SharedSessionsSharedPtr shared_sessions) {
+    shared_sessions_ = std::move(shared_sessions);
+  }
+
+  /**
+   * Runs the health checks off the main thread, on the thread of the dispatcher the health checker
+   * was created with, and hands the completed checks to the main thread in batches. The health
+   * checker must then be deleted on that thread. Must be called before start().
+   * @param main_thread_dispatcher supplies the main thread's dispatcher.
+   */
+  void offloadFrom(Event::Dispatcher& main_thread_dispatcher) {
+    main_thread_dispatcher_ = &main_thread_dispatcher;
+    weak_this_ = shared_from_this();
+  }
+
 protected:
   class ActiveHealthCheckSession : public Event::DeferredDeletable {
   public:
     ~ActiveHealthCheckSession() override;
     HealthTransition setUnhealthy(envoy::data::core::v2alpha::HealthCheckFailureType type);
     void onDeferredDeleteBase();
-    void start() { onInitialInterval(); }
+    void start(std::chrono::milliseconds initial_offset);
 
   protected:
     ActiveHealthCheckSession(HealthCheckerImplBase& parent, HostSharedPtr host);
@@ -61,6 +93,8 @@ protected:
     HostSharedPtr host_;
 
   private:
+    friend class SharedSessions;
+
     // Clears the pending flag if it is set. By clearing this flag we're marking the host as having
     // been health checked.
     // Returns the changed state to use following the flag update.
@@ -70,7 +104,10 @@ protected:
     virtual void onTimeout() PURE;
     void onTimeoutBase();
     virtual void onDeferredDelete() PURE;
-    void onInitialInterval();
+    void onInitialInterval(std::chrono::milliseconds initial_offset);
+    // @return whether the session takes on the results of the checks of another cluster's session
+    //         rather than sending checks.
+    bool sharedFollower() const;
 
     HealthCheckerImplBase& parent_;
     Event::TimerPtr interval_timer_;
@@ -78,10 +115,75 @@ protected:
     uint32_t num_unhealthy_{};
     uint32_t num_healthy_{};
     bool first_check_{true};
+    std::string shared_key_;
   };
 
   using ActiveHealthCheckSessionPtr = std::unique_ptr<ActiveHealthCheckSession>;
 
+public:
+  /**
+   * The sessions of the health checkers sharing their checks across clusters, keyed by the health
+   * check address of the host and the health check configuration. The first session of a key
+   * sends the checks, and the others take on the results of its checks. Only used on the thread
+   * the health checks run on.
+   */
+  class SharedSessions : public Singleton::Instance {
+  public:
+    /**
+     * Adds a session. A session which does not send the checks takes on the last result of the
+     * checks, if there is one, from its interval timer.
+     * @param session supplies the session.
+     * @param key supplies the key of the session.
+     * @return whether the session sends the checks of its key.
+     */
+    bool add(ActiveHealthCheckSession& session, const std::string& key);
+
+    /**
+     * Removes a session. If it sent the checks of its key, the next session of the key takes over
+     * from its interval timer.
+     * @param session supplies the session.
+     */
+    void remove(ActiveHealthCheckSession& session);
+
+    /**
+     * @param session supplies the session.
+     * @return whether the session sends the checks of its key.
+     */
+    bool leader(const ActiveHealthCheckSession& session) const;
+
+    /**
+     * Hands the result of a check to the other sessions of its key.
+     * @param leader supplies the session which sent the check.
+     * @param failure_type supplies the type of the failure, if the check failed.
+     * @param degraded supplies whether a successful check found the host to be degraded.
+     */
+    void onResult(ActiveHealthCheckSession& leader,
+                  absl::optional<envoy::data::core::v2alpha::HealthCheckFailureType> failure_type,
+                  bool degraded);
+
+    /**
+     * Hands the last result of the checks of its key to a session which does not send them.
+     * @param session supplies the session.
+     */
+    void takeLastResult(ActiveHealthCheckSession& session);
+
+  private:
+    struct Result {
+      absl::optional<envoy::data::core::v2alpha::HealthCheckFailureType> failure_type_;
+      bool degraded_;
+    };
+
+    struct KeySessions {
+      std::list<ActiveHealthCheckSession*> sessions_;
+      absl::optional<Result> last_result_;
+    };
+
+    static void applyResult(ActiveHealthCheckSession& session, const Result& result);
+
+    std::unordered_map<std::string, KeySessions> keys_;
+  };
+
+protected:
   HealthCheckerImplBase(const Cluster& cluster, const envoy::api::v2::core::HealthCheck& config,
                         Event::Dispatcher& dispatcher, Runtime::Loader& runtime,
                         Runtime::RandomGenerator& random, HealthCheckEventLoggerPtr&& event_logger);
@@ -92,6 +194,9 @@ protected:
 
   const bool always_log_health_check_failures_;
   const Cluster& cluster_;
+  // The sessions use the cluster's info rather than the cluster, as when the checks are offloaded
+  // they may run while the main thread destroys the cluster.
+  const ClusterInfoConstSharedPtr cluster_info_;
   Event::Dispatcher& dispatcher_;
   const std::chrono::milliseconds timeout_;
   const uint32_t unhealthy_threshold_;
@@ -115,7 +220,8 @@ private:
     std::weak_ptr<Host> host_;
   };
 
-  void addHosts(const HostVector& hosts);
+  void addSessions(const HostVector& hosts);
+  std::string sharedKey(const Host& host) const;
   void decHealthy();
   void decDegraded();
   HealthCheckerStats generateStats(Stats::Scope& scope);
@@ -125,8 +231,10 @@ private:
   std::chrono::milliseconds intervalWithJitter(uint64_t base_time_ms,
                                                std::chrono::milliseconds interval_jitter) const;
   void onClusterMemberUpdate(const HostVector& hosts_added, const HostVector& hosts_removed);
+  void updateSessions(const HostVector& hosts_added, const HostVector& hosts_removed);
   void refreshHealthyStat();
   void runCallbacks(HostSharedPtr host, HealthTransition changed_state);
+  void runOffloadedCallbacks();
   void setUnhealthyCrossThread(const HostSharedPtr& host);
 
   static const std::chrono::milliseconds NO_TRAFFIC_INTERVAL;
@@ -135,11 +243,22 @@ private:
   const std::chrono::milliseconds interval_;
   const std::chrono::milliseconds no_traffic_interval_;
   const std::chrono::milliseconds initial_jitter_;
+  const bool spread_initial_checks_;
   const std::chrono::milliseconds interval_jitter_;
   const uint32_t interval_jitter_percent_;
   const std::chrono::milliseconds unhealthy_interval_;
   const std::chrono::milliseconds unhealthy_edge_interval_;
   const std::chrono::milliseconds healthy_edge_interval_;
+  // The hash of the configuration, when the checks are shared across clusters.
+  const uint64_t shared_config_hash_;
+  SharedSessionsSharedPtr shared_sessions_;
+  // The main thread's dispatcher, and a weak reference to the health checker for the callbacks
+  // posted across threads, when the checks are offloaded.
+  Event::Dispatcher* main_thread_dispatcher_{};
+  std::weak_ptr<HealthCheckerImplBase> weak_this_;
+  // The completed checks whose callbacks have yet to be run on the main thread, when the checks are
+  // offloaded.
+  std::vector<std::pair<HostSharedPtr, HealthTransition>> offloaded_callbacks_;
   std::unordered_map<HostSharedPtr, ActiveHealthCheckSessionPtr> active_sessions_;
   uint64_t local_process_healthy_{};
   uint64_t local_process_degraded_{};
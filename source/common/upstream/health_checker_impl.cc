@@ -50,31 +50,64 @@ private:
   ProtobufMessage::ValidationVisitor& validation_visitor_;
 };
 
+SINGLETON_MANAGER_REGISTRATION(shared_health_check_sessions);
+SINGLETON_MANAGER_REGISTRATION(offloaded_shared_health_check_sessions);
+
 HealthCheckerSharedPtr
 HealthCheckerFactory::create(const envoy::api::v2::core::HealthCheck& health_check_config,
                              Upstream::Cluster& cluster, Runtime::Loader& runtime,
                              Runtime::RandomGenerator& random, Event::Dispatcher& dispatcher,
                              AccessLog::AccessLogManager& log_manager,
-                             ProtobufMessage::ValidationVisitor& validation_visitor) {
+                             ProtobufMessage::ValidationVisitor& validation_visitor,
+                             Singleton::Manager& singleton_manager,
+                             OffloadThreads* offload_threads) {
   HealthCheckEventLoggerPtr event_logger;
   if (!health_check_config.event_log_path().empty()) {
     event_logger = std::make_unique<HealthCheckEventLoggerImpl>(
         log_manager, dispatcher.timeSource(), health_check_config.event_log_path());
   }
+
+  // The built in health checkers run their checks on an offload thread if there are any. The
+  // checks shared across clusters all run on the first one, as their shared sessions are only used
+  // on one thread. An offloaded health checker is deleted on its thread, as its sessions are.
+  Event::Dispatcher* check_dispatcher = &dispatcher;
+  if (offload_threads != nullptr) {
+    check_dispatcher = health_check_config.share_across_clusters()
+                           ? &offload_threads->firstDispatcher()
+                           : &offload_threads->nextDispatcher();
+  }
+  const bool offloaded = check_dispatcher != &dispatcher;
+  const auto make_health_checker =
+      [offloaded, check_dispatcher](
+          HealthCheckerImplBase* new_health_checker) -> std::shared_ptr<HealthCheckerImplBase> {
+    if (!offloaded) {
+      return std::shared_ptr<HealthCheckerImplBase>(new_health_checker);
+    }
+    return std::shared_ptr<HealthCheckerImplBase>(
+        new_health_checker, [check_dispatcher](HealthCheckerImplBase* offloaded_health_checker) {
+          check_dispatcher->post(
+              [offloaded_health_checker]() -> void { delete offloaded_health_checker; });
+        });
+  };
+
+  std::shared_ptr<HealthCheckerImplBase> health_checker;
   switch (health_check_config.health_checker_case()) {
   case envoy::api::v2::core::HealthCheck::HealthCheckerCase::kHttpHealthCheck:
-    return std::make_shared<ProdHttpHealthCheckerImpl>(cluster, health_check_config, dispatcher,
-                                                       runtime, random, std::move(event_logger));
+    health_checker = make_health_checker(new ProdHttpHealthCheckerImpl(
+        cluster, health_check_config, *check_dispatcher, runtime, random, std::move(event_logger)));
+    break;
   case envoy::api::v2::core::HealthCheck::HealthCheckerCase::kTcpHealthCheck:
-    return std::make_shared<TcpHealthCheckerImpl>(cluster, health_check_config, dispatcher, runtime,
-                                                  random, std::move(event_logger));
+    health_checker = make_health_checker(new TcpHealthCheckerImpl(
+        cluster, health_check_config, *check_dispatcher, runtime, random, std::move(event_logger)));
+    break;
   case envoy::api::v2::core::HealthCheck::HealthCheckerCase::kGrpcHealthCheck:
     if (!(cluster.info()->features() & Upstream::ClusterInfo::Features::HTTP2)) {
       throw EnvoyException(fmt::format("{} cluster must support HTTP/2 for gRPC healthchecking",
                                        cluster.info()->name()));
     }
-    return std::make_shared<ProdGrpcHealthCheckerImpl>(cluster, health_check_config, dispatcher,
-                                                       runtime, random, std::move(event_logger));
+    health_checker = make_health_checker(new ProdGrpcHealthCheckerImpl(
+        cluster, health_check_config, *check_dispatcher, runtime, random, std::move(event_logger)));
+    break;
   case envoy::api::v2::core::HealthCheck::HealthCheckerCase::kCustomHealthCheck: {
     auto& factory =
         Config::Utility::getAndCheckFactory<Server::Configuration::CustomHealthCheckerFactory>(
@@ -88,6 +121,17 @@ HealthCheckerFactory::create(const envoy::api::v2::core::HealthCheck& health_che
     // Checked by schema.
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
+
+  if (offloaded) {
+    health_checker->offloadFrom(dispatcher);
+  }
+  if (health_check_config.share_across_clusters()) {
+    health_checker->shareChecks(singleton_manager.getTyped<HealthCheckerImplBase::SharedSessions>(
+        offloaded ? SINGLETON_MANAGER_REGISTERED_NAME(offloaded_shared_health_check_sessions)
+                  : SINGLETON_MANAGER_REGISTERED_NAME(shared_health_check_sessions),
+        [] { return std::make_shared<HealthCheckerImplBase::SharedSessions>(); }));
+  }
+  return health_checker;
 }
 
 HttpHealthCheckerImpl::HttpHealthCheckerImpl(const Cluster& cluster,
@@ -153,7 +197,7 @@ bool HttpHealthCheckerImpl::HttpStatusChecker::inRange(uint64_t http_status) con
 HttpHealthCheckerImpl::HttpActiveHealthCheckSession::HttpActiveHealthCheckSession(
     HttpHealthCheckerImpl& parent, const HostSharedPtr& host)
     : ActiveHealthCheckSession(parent, host), parent_(parent),
-      hostname_(parent_.host_value_.empty() ? parent_.cluster_.info()->name()
+      hostname_(parent_.host_value_.empty() ? parent_.cluster_info_->name()
                                             : parent_.host_value_),
       protocol_(parent_.codec_client_type_ == Http::CodecClient::Type::HTTP1
                     ? Http::Protocol::Http11
@@ -210,7 +254,7 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onInterval() {
       {Http::Headers::get().Host, hostname_},
       {Http::Headers::get().Path, parent_.path_},
       {Http::Headers::get().UserAgent, Http::Headers::get().UserAgentValues.EnvoyHealthChecker}};
-  Router::FilterUtility::setUpstreamScheme(request_headers, *parent_.cluster_.info());
+  Router::FilterUtility::setUpstreamScheme(request_headers, *parent_.cluster_info_);
   StreamInfo::StreamInfoImpl stream_info(protocol_, parent_.dispatcher_.timeSource());
   stream_info.setDownstreamLocalAddress(local_address_);
   stream_info.setDownstreamRemoteAddress(local_address_);
@@ -605,13 +649,13 @@ void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::onInterval() {
 
   const std::string& authority = parent_.authority_value_.has_value()
                                      ? parent_.authority_value_.value()
-                                     : parent_.cluster_.info()->name();
+                                     : parent_.cluster_info_->name();
   auto headers_message =
       Grpc::Common::prepareHeaders(authority, parent_.service_method_.service()->full_name(),
                                    parent_.service_method_.name(), absl::nullopt);
   headers_message->headers().insertUserAgent().value().setReference(
       Http::Headers::get().UserAgentValues.EnvoyHealthChecker);
-  Router::FilterUtility::setUpstreamScheme(headers_message->headers(), *parent_.cluster_.info());
+  Router::FilterUtility::setUpstreamScheme(headers_message->headers(), *parent_.cluster_info_);
 
   request_encoder_->encodeHeaders(headers_message->headers(), false);
 
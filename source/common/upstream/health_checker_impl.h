@@ -3,6 +3,8 @@
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/v2/core/health_check.pb.h"
 #include "envoy/grpc/status.h"
+#include "envoy/singleton/manager.h"
+#include "envoy/upstream/cluster_manager.h"
 
 #include "common/common/logger.h"
 #include "common/grpc/codec.h"
@@ -28,8 +30,12 @@ public:
    * @param runtime supplies the runtime loader.
    * @param random supplies the random generator.
    * @param dispatcher supplies the dispatcher.
-   * @param event_logger supplies the event_logger.
+   * @param log_manager supplies the access log manager of the event_logger.
    * @param validation_visitor message validation visitor instance.
+   * @param singleton_manager supplies the singleton manager holding the health check sessions
+   *                          shared across clusters.
+   * @param offload_threads supplies the threads to run the health checks on rather than the main
+   *                        thread, or nullptr to run them on the main thread.
    * @return a health checker.
    */
   static HealthCheckerSharedPtr create(const envoy::api::v2::core::HealthCheck& health_check_config,
@@ -37,7 +43,9 @@ public:
                                        Runtime::RandomGenerator& random,
                                        Event::Dispatcher& dispatcher,
                                        AccessLog::AccessLogManager& log_manager,
-                                       ProtobufMessage::ValidationVisitor& validation_visitor);
+                                       ProtobufMessage::ValidationVisitor& validation_visitor,
+                                       Singleton::Manager& singleton_manager,
+                                       OffloadThreads* offload_threads);
 };
 
 /**
@@ -0,0 +1,73 @@
+#include "common/upstream/hedge_tracker_impl.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Upstream {
+
+uint32_t HedgeTrackerImpl::bucket(uint64_t response_time_us) {
+  response_time_us = std::min<uint64_t>(response_time_us, (1ULL << 32) - 1);
+  if (response_time_us < 4) {
+    return response_time_us;
+  }
+  // The power of two selects 4 buckets, and the 2 bits below the leading one select among them.
+  const uint32_t exponent = 63 - __builtin_clzll(response_time_us);
+  return 4 * (exponent - 1) + ((response_time_us >> (exponent - 2)) & 3);
+}
+
+uint64_t HedgeTrackerImpl::bucketUpperBound(uint32_t bucket) {
+  ASSERT(bucket < NumBuckets);
+  if (bucket < 4) {
+    return bucket;
+  }
+  const uint32_t exponent = bucket / 4 + 1;
+  return ((4ULL + bucket % 4 + 1) << (exponent - 2)) - 1;
+}
+
+void HedgeTrackerImpl::recordResponseTime(std::chrono::microseconds response_time) {
+  ++buckets_[bucket(std::max<int64_t>(response_time.count(), 0))];
+  ++responses_;
+  if (++responses_since_decay_ == DecayInterval) {
+    decay();
+  }
+}
+
+absl::optional<std::chrono::microseconds>
+HedgeTrackerImpl::responseTimePercentile(double percentile) {
+  if (responses_ < MinResponses) {
+    return absl::nullopt;
+  }
+  // The rank of the response time at the percentile, among the responses in increasing order.
+  const uint64_t rank = std::max<uint64_t>(
+      1, std::ceil(std::min(std::max(percentile, 0.0), 100.0) / 100 * responses_));
+  uint64_t count = 0;
+  for (uint32_t i = 0; i < NumBuckets; ++i) {
+    count += buckets_[i];
+    if (count >= rank) {
+      return std::chrono::microseconds(bucketUpperBound(i));
+    }
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+bool HedgeTrackerImpl::hedgeBudgetAvailable(double budget_percent) {
+  return (hedges_ + 1) * 100 <= budget_percent * responses_;
+}
+
+void HedgeTrackerImpl::onHedge() { ++hedges_; }
+
+void HedgeTrackerImpl::decay() {
+  responses_ = 0;
+  for (uint64_t& count : buckets_) {
+    count /= 2;
+    responses_ += count;
+  }
+  hedges_ /= 2;
+  responses_since_decay_ = 0;
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/upstream/thread_local_cluster.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * A HedgeTracker which keeps a histogram of the response times with 4 buckets per power of two
+ * microseconds, so the percentiles are within 25% of the recorded times. The counts of the
+ * histogram and of the hedged requests are halved every DecayInterval responses, so the tracker
+ * follows the recent latency of the cluster. It is only used on the thread of its cluster entry.
+ */
+class HedgeTrackerImpl : public HedgeTracker {
+public:
+  // The number of responses below which no percentile is estimated.
+  static constexpr uint64_t MinResponses = 100;
+  // The number of responses after which the counts are halved.
+  static constexpr uint64_t DecayInterval = 4096;
+  // Response times are capped at 2^32 microseconds, more than an hour.
+  static constexpr uint32_t NumBuckets = 124;
+
+  // Upstream::HedgeTracker
+  void recordResponseTime(std::chrono::microseconds response_time) override;
+  absl::optional<std::chrono::microseconds> responseTimePercentile(double percentile) override;
+  bool hedgeBudgetAvailable(double budget_percent) override;
+  void onHedge() override;
+
+  /**
+   * @return the bucket of the histogram of a response time in microseconds.
+   */
+  static uint32_t bucket(uint64_t response_time_us);
+
+  /**
+   * @return the largest response time in microseconds of a bucket of the histogram.
+   */
+  static uint64_t bucketUpperBound(uint32_t bucket);
+
+private:
+  void decay();
+
+  std::array<uint64_t, NumBuckets> buckets_{};
+  // The sum of the counts of the buckets.
+  uint64_t responses_{};
+  uint64_t responses_since_decay_{};
+  uint64_t hedges_{};
+};
+
+} // namespace Upstream
+} // namespace Envoy
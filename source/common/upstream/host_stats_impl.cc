@@ -0,0 +1,155 @@
+#include "common/upstream/host_stats_impl.h"
+
+namespace Envoy {
+namespace Upstream {
+
+namespace {
+
+#define HOST_STATS_NAME_COUNTER_(NAME) #NAME,
+#define HOST_STATS_NAME_GAUGE_(NAME, MODE) #NAME,
+
+const char* const CounterNames[] = {
+    ALL_HOST_STATS(HOST_STATS_NAME_COUNTER_, HOST_STATS_IGNORE_GAUGE_)};
+const char* const GaugeNames[] = {
+    ALL_HOST_STATS(HOST_STATS_IGNORE_COUNTER_, HOST_STATS_NAME_GAUGE_)};
+
+} // namespace
+
+constexpr size_t HostStatNames::CounterCount;
+constexpr size_t HostStatNames::GaugeCount;
+
+HostStatNames::HostStatNames(Stats::SymbolTable& symbol_table)
+    : symbol_table_(symbol_table), pool_(symbol_table) {
+  for (size_t i = 0; i < CounterCount; i++) {
+    names_[i] = CounterNames[i];
+  }
+  for (size_t i = 0; i < GaugeCount; i++) {
+    names_[CounterCount + i] = GaugeNames[i];
+  }
+  for (size_t i = 0; i < names_.size(); i++) {
+    stat_names_[i] = pool_.add(names_[i]);
+  }
+}
+
+template <class BaseClass> std::string HostMetric<BaseClass>::name() const {
+  return block_->names_->name(index_);
+}
+
+template <class BaseClass> Stats::StatName HostMetric<BaseClass>::statName() const {
+  return block_->names_->statName(index_);
+}
+
+template <class BaseClass> bool HostMetric<BaseClass>::used() const {
+  return block_->used_ & (1 << index_);
+}
+
+template <class BaseClass> Stats::SymbolTable& HostMetric<BaseClass>::symbolTable() {
+  return block_->names_->symbolTable();
+}
+
+template <class BaseClass>
+const Stats::SymbolTable& HostMetric<BaseClass>::constSymbolTable() const {
+  return block_->names_->symbolTable();
+}
+
+template <class BaseClass> void HostMetric<BaseClass>::incRefCount() { block_->incRefCount(); }
+
+template <class BaseClass> bool HostMetric<BaseClass>::decRefCount() {
+  // The stat belongs to the block, so it is never deleted on its own.
+  if (block_->decRefCount()) {
+    delete block_;
+  }
+  return false;
+}
+
+template <class BaseClass> uint32_t HostMetric<BaseClass>::use_count() const {
+  return block_->use_count();
+}
+
+template class HostMetric<Stats::Counter>;
+template class HostMetric<Stats::Gauge>;
+
+void HostCounter::add(uint64_t amount) {
+  // As in the stats store, a reader may see a new value but an old pending increment.
+  block_->counter_values_[index_] += amount;
+  block_->pending_increments_[index_] += amount;
+  block_->used_ |= (1 << index_);
+}
+
+uint64_t HostCounter::latch() { return block_->pending_increments_[index_].exchange(0); }
+
+void HostCounter::reset() { block_->counter_values_[index_] = 0; }
+
+uint64_t HostCounter::value() const { return block_->counter_values_[index_]; }
+
+void HostGauge::add(uint64_t amount) {
+  block_->gaugeValue(index_) += amount;
+  block_->used_ |= (1 << index_);
+  if (amount != 0) {
+    block_->changed_ |= (1 << index_);
+  }
+}
+
+void HostGauge::set(uint64_t value) {
+  if (block_->gaugeValue(index_).exchange(value) != value) {
+    block_->changed_ |= (1 << index_);
+  }
+  block_->used_ |= (1 << index_);
+}
+
+void HostGauge::sub(uint64_t amount) {
+  ASSERT(block_->gaugeValue(index_) >= amount);
+  ASSERT(used() || amount == 0);
+  block_->gaugeValue(index_) -= amount;
+  if (amount != 0) {
+    block_->changed_ |= (1 << index_);
+  }
+}
+
+uint64_t HostGauge::value() const { return block_->gaugeValue(index_); }
+
+bool HostGauge::latchChanged() {
+  const uint16_t bit = 1 << index_;
+  return block_->changed_.fetch_and(static_cast<uint16_t>(~bit)) & bit;
+}
+
+HostStatsBlock::HostStatsBlock(HostStatNamesConstSharedPtr names)
+    : names_(std::move(names)), stats_(makeStats()) {
+  for (size_t i = 0; i < counters_.size(); i++) {
+    counters_[i].init(*this, i);
+  }
+  // The gauges are indexed after the counters, as their names.
+  for (size_t i = 0; i < gauges_.size(); i++) {
+    gauges_[i].init(*this, HostStatNames::CounterCount + i);
+  }
+}
+
+HostStats HostStatsBlock::makeStats() {
+  // The members of a braced initializer list are evaluated in order.
+  size_t counter = 0;
+  size_t gauge = 0;
+#define HOST_STATS_REF_COUNTER_(NAME) counters_[counter++],
+#define HOST_STATS_REF_GAUGE_(NAME, MODE) gauges_[gauge++],
+  return {ALL_HOST_STATS(HOST_STATS_REF_COUNTER_, HOST_STATS_REF_GAUGE_)};
+}
+
+std::vector<Stats::CounterSharedPtr> HostStatsBlock::counters() {
+  std::vector<Stats::CounterSharedPtr> counters;
+  counters.reserve(counters_.size());
+  for (HostCounter& counter : counters_) {
+    counters.emplace_back(&counter);
+  }
+  return counters;
+}
+
+std::vector<Stats::GaugeSharedPtr> HostStatsBlock::gauges() {
+  std::vector<Stats::GaugeSharedPtr> gauges;
+  gauges.reserve(gauges_.size());
+  for (HostGauge& gauge : gauges_) {
+    gauges.emplace_back(&gauge);
+  }
+  return gauges;
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/refcount_ptr.h"
+#include "envoy/stats/stats.h"
+#include "envoy/stats/symbol_table.h"
+#include "envoy/upstream/host_description.h"
+
+#include "common/common/assert.h"
+#include "common/stats/symbol_table_impl.h"
+
+namespace Envoy {
+namespace Upstream {
+
+#define HOST_STATS_COUNT_COUNTER_(NAME) +1
+#define HOST_STATS_COUNT_GAUGE_(NAME, MODE) +1
+#define HOST_STATS_IGNORE_COUNTER_(NAME)
+#define HOST_STATS_IGNORE_GAUGE_(NAME, MODE)
+
+/**
+ * The names of the per host stats, shared by the hosts whose stats use the same symbol table.
+ * Counters come first, then gauges, each in the order of ALL_HOST_STATS.
+ */
+class HostStatNames {
+public:
+  static constexpr size_t CounterCount =
+      0 ALL_HOST_STATS(HOST_STATS_COUNT_COUNTER_, HOST_STATS_IGNORE_GAUGE_);
+  static constexpr size_t GaugeCount =
+      0 ALL_HOST_STATS(HOST_STATS_IGNORE_COUNTER_, HOST_STATS_COUNT_GAUGE_);
+
+  explicit HostStatNames(Stats::SymbolTable& symbol_table);
+
+  Stats::StatName statName(size_t index) const { return stat_names_[index]; }
+  const std::string& name(size_t index) const { return names_[index]; }
+  Stats::SymbolTable& symbolTable() const { return symbol_table_; }
+
+private:
+  Stats::SymbolTable& symbol_table_;
+  Stats::StatNamePool pool_;
+  std::array<Stats::StatName, CounterCount + GaugeCount> stat_names_;
+  // The names are kept as strings too, so that rendering the stats of many hosts, e.g. in the
+  // admin /clusters output, does not go through the symbol table.
+  std::array<std::string, CounterCount + GaugeCount> names_;
+};
+
+using HostStatNamesConstSharedPtr = std::shared_ptr<const HostStatNames>;
+
+class HostStatsBlock;
+
+/**
+ * Partial implementation of the Metric interface for the stats of a HostStatsBlock. The stats have
+ * no tags, and their values are stored in the block, which they keep alive.
+ */
+template <class BaseClass> class HostMetric : public BaseClass {
+public:
+  void init(HostStatsBlock& block, uint8_t index) {
+    block_ = &block;
+    index_ = index;
+  }
+
+  // Stats::Metric
+  std::string name() const override;
+  Stats::StatName statName() const override;
+  std::vector<Stats::Tag> tags() const override { return {}; }
+  std::string tagExtractedName() const override { return name(); }
+  Stats::StatName tagExtractedStatName() const override { return statName(); }
+  void iterateTagStatNames(const Stats::Metric::TagStatNameIterFn&) const override {}
+  void iterateTags(const Stats::Metric::TagIterFn&) const override {}
+  bool used() const override;
+  Stats::SymbolTable& symbolTable() override;
+  const Stats::SymbolTable& constSymbolTable() const override;
+
+  // Stats::RefcountInterface
+  void incRefCount() override;
+  bool decRefCount() override;
+  uint32_t use_count() const override;
+
+protected:
+  HostStatsBlock* block_{};
+  uint8_t index_{};
+};
+
+class HostCounter : public HostMetric<Stats::Counter> {
+public:
+  // Stats::Counter
+  void add(uint64_t amount) override;
+  void inc() override { add(1); }
+  uint64_t latch() override;
+  void reset() override;
+  uint64_t value() const override;
+};
+
+class HostGauge : public HostMetric<Stats::Gauge> {
+public:
+  // Stats::Gauge
+  void add(uint64_t amount) override;
+  void dec() override { sub(1); }
+  void inc() override { add(1); }
+  void set(uint64_t value) override;
+  void sub(uint64_t amount) override;
+  uint64_t value() const override;
+  bool latchChanged() override;
+  ImportMode importMode() const override { return ImportMode::Accumulate; }
+  void mergeImportMode(ImportMode) override {}
+};
+
+/**
+ * The stats of a host, in a single compact allocation. Unlike a stats store, the block does not
+ * hold names, maps or locks of its own: the names are shared with the other hosts, and the values
+ * are stored as arrays indexed by stat. The block is reference counted, as the counters and gauges
+ * handed out by Host::counters() and Host::gauges() may outlive their host.
+ */
+class HostStatsBlock {
+public:
+  explicit HostStatsBlock(HostStatNamesConstSharedPtr names);
+
+  const HostStats& stats() const { return stats_; }
+  std::vector<Stats::CounterSharedPtr> counters();
+  std::vector<Stats::GaugeSharedPtr> gauges();
+
+  // Stats::RefcountInterface
+  void incRefCount() { ++ref_count_; }
+  bool decRefCount() {
+    ASSERT(ref_count_ >= 1);
+    return --ref_count_ == 0;
+  }
+  uint32_t use_count() const { return ref_count_; }
+
+private:
+  template <class BaseClass> friend class HostMetric;
+  friend class HostCounter;
+  friend class HostGauge;
+
+  HostStats makeStats();
+  std::atomic<uint64_t>& gaugeValue(uint8_t index) {
+    return gauge_values_[index - HostStatNames::CounterCount];
+  }
+
+  const HostStatNamesConstSharedPtr names_;
+  std::array<HostCounter, HostStatNames::CounterCount> counters_;
+  std::array<HostGauge, HostStatNames::GaugeCount> gauges_;
+  std::array<std::atomic<uint64_t>, HostStatNames::CounterCount> counter_values_{};
+  std::array<std::atomic<uint64_t>, HostStatNames::CounterCount> pending_increments_{};
+  std::array<std::atomic<uint64_t>, HostStatNames::GaugeCount> gauge_values_{};
+  // One bit per stat, set once it has been updated, by index as in HostStatNames.
+  std::atomic<uint16_t> used_{};
+  // One bit per gauge, set when it changed since the last flush, by index as in used_.
+  std::atomic<uint16_t> changed_{};
+  std::atomic<uint32_t> ref_count_{};
+  const HostStats stats_;
+
+  static_assert(HostStatNames::CounterCount + HostStatNames::GaugeCount <= 16,
+                "HostStatsBlock::used_ has one bit per stat");
+};
+
+using HostStatsBlockSharedPtr = Stats::RefcountPtr<HostStatsBlock>;
+
+} // namespace Upstream
+} // namespace Envoy
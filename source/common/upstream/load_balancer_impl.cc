@@ -9,6 +9,7 @@
 #include "envoy/upstream/upstream.h"
 
 #include "common/common/assert.h"
+#include "common/common/hash.h"
 #include "common/common/stack_array.h"
 #include "common/protobuf/utility.h"
 
@@ -64,6 +65,17 @@ bool hostWeightsAreEqual(const HostVector& hosts) {
   return true;
 }
 
+// @return a hash of the identity and weight of each host, in order.
+uint64_t hashHostsAndWeights(const HostVector& hosts) {
+  uint64_t hash = 0;
+  for (const auto& host : hosts) {
+    const uint64_t key[] = {reinterpret_cast<uintptr_t>(host.get()), host->weight()};
+    hash = HashUtil::xxHash64(absl::string_view(reinterpret_cast<const char*>(key), sizeof(key)),
+                              hash);
+  }
+  return hash;
+}
+
 } // namespace
 
 std::pair<uint32_t, LoadBalancerBase::HostAvailability>
@@ -622,10 +634,10 @@ EdfLoadBalancerBase::EdfLoadBalancerBase(
     : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
                                 common_config),
       seed_(random_.random()) {
-  // We fully recompute the schedulers for a given host set here on membership change, which is
-  // consistent with what other LB implementations do (e.g. thread aware).
-  // The downside of a full recompute is that time complexity is O(n * log n),
-  // so we will need to do better at delta tracking to scale (see
+  // We recompute the schedulers for a given host set here on membership change, which is
+  // consistent with what other LB implementations do (e.g. thread aware). Only the schedulers
+  // whose hosts or weights changed are rebuilt, in O(n) time, so an update which touches one
+  // locality leaves the schedules of the others as they are (see
   // https://github.com/envoyproxy/envoy/issues/2874).
   priority_set.addPriorityUpdateCb(
       [this](uint32_t priority, const HostVector&, const HostVector&) { refresh(priority); });
@@ -639,14 +651,23 @@ void EdfLoadBalancerBase::initialize() {
 
 void EdfLoadBalancerBase::refresh(uint32_t priority) {
   const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
+    // Keep the existing scheduler if it was built from the same hosts and weights, as rebuilding
+    // it would only restart its schedule.
+    const uint64_t hosts_hash = hashHostsAndWeights(hosts);
+    auto existing = scheduler_.find(source);
+    if (existing != scheduler_.end() && existing->second.hosts_hash_ == hosts_hash) {
+      return;
+    }
+
     // Nuke existing scheduler if it exists.
     auto& scheduler = scheduler_[source] = Scheduler{};
+    scheduler.hosts_hash_ = hosts_hash;
     refreshHostSource(source);
 
     // Check if the original host weights are equal and skip EDF creation if they are. When all
     // original weights are equal we can rely on unweighted host pick to do optimal round robin and
     // least-loaded host selection with lower memory and CPU overhead.
-    if (hostWeightsAreEqual(hosts)) {
+    if (!scheduleWeightedHosts() || hostWeightsAreEqual(hosts)) {
       // Skip edf creation.
       return;
     }
@@ -658,13 +679,11 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
     // weighted 1. This is because currently we don't refresh host sets if only weights change.
     // We should probably change this to refresh at all times. See the comment in
     // BaseDynamicClusterImpl::updateDynamicHostList about this.
-    for (const auto& host : hosts) {
-      // We use a fixed weight here. While the weight may change without
-      // notification, this will only be stale until this host is next picked,
-      // at which point it is reinserted into the EdfScheduler with its new
-      // weight in chooseHost().
-      scheduler.edf_->add(hostWeight(*host), host);
-    }
+    // We use a fixed weight here. While the weight may change without
+    // notification, this will only be stale until this host is next picked,
+    // at which point it is reinserted into the EdfScheduler with its new
+    // weight in chooseHost().
+    scheduler.edf_->addAll(hosts, [this](const Host& host) { return hostWeight(host); });
 
     // Cycle through hosts to achieve the intended offset behavior.
     // TODO(htuch): Consider how we can avoid biasing towards earlier hosts in the schedule across
@@ -727,25 +746,35 @@ HostConstSharedPtr EdfLoadBalancerBase::chooseHostOnce(LoadBalancerContext* cont
 
 HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector& hosts_to_use,
                                                                 const HostsSource&) {
-  HostSharedPtr candidate_host = nullptr;
-  for (uint32_t choice_idx = 0; choice_idx < choice_count_; ++choice_idx) {
-    const int rand_idx = random_.random() % hosts_to_use.size();
-    HostSharedPtr sampled_host = hosts_to_use[rand_idx];
-
-    if (candidate_host == nullptr) {
-      // Make a first choice to start the comparisons.
-      candidate_host = sampled_host;
-      continue;
-    }
-
-    const auto candidate_active_rq = candidate_host->stats().rq_active_.value();
-    const auto sampled_active_rq = sampled_host->stats().rq_active_.value();
-    if (sampled_active_rq < candidate_active_rq) {
-      candidate_host = sampled_host;
+  // The samples are compared through references into the host vector, so that only the chosen
+  // host's reference count is touched, and the candidate's load is only read once.
+  const HostSharedPtr* candidate_host = &hosts_to_use[random_.random() % hosts_to_use.size()];
+  uint64_t candidate_active_rq = (*candidate_host)->stats().rq_active_.value();
+  uint64_t candidate_weight = weighted_choices_ ? (*candidate_host)->weight() : 1;
+  uint64_t candidate_rtt = rtt_aware_ ? (*candidate_host)->stats().cx_rtt_us_.value() : 0;
+  for (uint32_t choice_idx = 1; choice_idx < choice_count_; ++choice_idx) {
+    const HostSharedPtr& sampled_host = hosts_to_use[random_.random() % hosts_to_use.size()];
+    const uint64_t sampled_active_rq = sampled_host->stats().rq_active_.value();
+    if (weighted_choices_ || rtt_aware_) {
+      // Compare (active requests + 1) * RTT / weight without dividing. The RTTs are left out unless
+      // both hosts have been sampled.
+      const uint64_t sampled_weight = weighted_choices_ ? sampled_host->weight() : 1;
+      const uint64_t sampled_rtt = rtt_aware_ ? sampled_host->stats().cx_rtt_us_.value() : 0;
+      const bool compare_rtt = sampled_rtt != 0 && candidate_rtt != 0;
+      if ((sampled_active_rq + 1) * candidate_weight * (compare_rtt ? sampled_rtt : 1) <
+          (candidate_active_rq + 1) * sampled_weight * (compare_rtt ? candidate_rtt : 1)) {
+        candidate_host = &sampled_host;
+        candidate_active_rq = sampled_active_rq;
+        candidate_weight = sampled_weight;
+        candidate_rtt = sampled_rtt;
+      }
+    } else if (sampled_active_rq < candidate_active_rq) {
+      candidate_host = &sampled_host;
+      candidate_active_rq = sampled_active_rq;
     }
   }
 
-  return candidate_host;
+  return *candidate_host;
 }
 
 HostConstSharedPtr RandomLoadBalancer::chooseHostOnce(LoadBalancerContext* context) {
@@ -350,6 +350,9 @@ protected:
     // host weights of 2 or more hosts differ. When not present, the
     // implementation of chooseHostOnce falls back to unweightedHostPick.
     std::unique_ptr<EdfScheduler<const Host>> edf_;
+    // Hash of the hosts and weights the scheduler was built from, so that it is only rebuilt when
+    // they change.
+    uint64_t hosts_hash_{};
   };
 
   void initialize();
@@ -363,6 +366,9 @@ protected:
 
 private:
   void refresh(uint32_t priority);
+  // @return whether hosts are picked from an EDF schedule when their weights differ. If not,
+  //         unweightedHostPick() is always used and must take the weights into account itself.
+  virtual bool scheduleWeightedHosts() const { return true; }
   virtual void refreshHostSource(const HostsSource& source) PURE;
   virtual double hostWeight(const Host& host) PURE;
   virtual HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
@@ -436,11 +442,15 @@ public:
         choice_count_(
             least_request_config.has_value()
                 ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(least_request_config.value(), choice_count, 2)
-                : 2) {
+                : 2),
+        weighted_choices_(least_request_config.has_value() &&
+                          least_request_config.value().weighted_choices()),
+        rtt_aware_(least_request_config.has_value() && least_request_config.value().rtt_aware()) {
     initialize();
   }
 
 private:
+  bool scheduleWeightedHosts() const override { return !weighted_choices_; }
   void refreshHostSource(const HostsSource&) override {}
   double hostWeight(const Host& host) override {
     // Here we scale host weight by the number of active requests at the time we do the pick. We
@@ -456,6 +466,8 @@ private:
   HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
                                         const HostsSource& source) override;
   const uint32_t choice_count_;
+  const bool weighted_choices_;
+  const bool rtt_aware_;
 };
 
 /**
@@ -1,5 +1,6 @@
 #include "common/upstream/logical_dns_cluster.h"
 
+#include <algorithm>
 #include <chrono>
 #include <list>
 #include <string>
@@ -80,9 +81,18 @@ void LogicalDnsCluster::startResolve() {
         if (!response.empty()) {
           // TODO(mattklein123): Move port handling into the DNS interface.
           ASSERT(response.front().address_ != nullptr);
-          Network::Address::InstanceConstSharedPtr new_address =
-              Network::Utility::getAddressWithPort(*(response.front().address_),
-                                                   Network::Utility::portFromTcpUrl(dns_url_));
+          const uint32_t port = Network::Utility::portFromTcpUrl(dns_url_);
+          // With both families resolved, connections race across all the addresses rather than
+          // using the first one.
+          std::vector<Network::Address::InstanceConstSharedPtr> new_address_list;
+          for (const auto& resolved : response) {
+            new_address_list.push_back(
+                Network::Utility::getAddressWithPort(*resolved.address_, port));
+            if (dns_lookup_family_ != Network::DnsLookupFamily::All) {
+              break;
+            }
+          }
+          const Network::Address::InstanceConstSharedPtr& new_address = new_address_list.front();
 
           if (respect_dns_ttl_ && response.front().ttl_ != std::chrono::seconds(0)) {
             refresh_rate = response.front().ttl_;
@@ -103,12 +113,15 @@ void LogicalDnsCluster::startResolve() {
                 absl::nullopt, absl::nullopt, absl::nullopt);
           }
 
-          if (!current_resolved_address_ || !(*new_address == *current_resolved_address_)) {
-            current_resolved_address_ = new_address;
+          if (!std::equal(new_address_list.begin(), new_address_list.end(),
+                          current_resolved_address_list_.begin(),
+                          current_resolved_address_list_.end(),
+                          [](const auto& lhs, const auto& rhs) { return *lhs == *rhs; })) {
+            current_resolved_address_list_ = std::move(new_address_list);
 
             // Make sure that we have an updated address for admin display, health
             // checking, and creating real host connections.
-            logical_host_->setNewAddress(new_address, lbEndpoint());
+            logical_host_->setNewAddresses(current_resolved_address_list_, lbEndpoint());
           }
         }
 
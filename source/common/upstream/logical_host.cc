@@ -1,16 +1,28 @@
 #include "common/upstream/logical_host.h"
 
+#include "common/upstream/tcp_info_sampler.h"
+
 namespace Envoy {
 namespace Upstream {
 
 Upstream::Host::CreateConnectionData LogicalHost::createConnection(
     Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
     Network::TransportSocketOptionsSharedPtr transport_socket_options) const {
-  const auto current_address = address();
-  return {HostImpl::createConnection(dispatcher, cluster(), current_address, options,
-                                     override_transport_socket_options_ != nullptr
-                                         ? override_transport_socket_options_
-                                         : transport_socket_options),
+  Network::Address::InstanceConstSharedPtr current_address;
+  std::vector<Network::Address::InstanceConstSharedPtr> current_address_list;
+  {
+    absl::ReaderMutexLock lock(&address_lock_);
+    current_address = HostImpl::address();
+    current_address_list = address_list_;
+  }
+  Network::ClientConnectionPtr connection = HostImpl::createConnection(
+      dispatcher, cluster(), current_address_list, options,
+      override_transport_socket_options_ != nullptr ? override_transport_socket_options_
+                                                    : transport_socket_options);
+  // The TCP state is sampled into the stats of the logical host, which the real hosts share.
+  TcpInfoSampler::addToConnection(*connection, shared_from_this());
+  // The real host has the first address, whichever address the connection ends up using.
+  return {std::move(connection),
           std::make_shared<RealHostDescription>(current_address, shared_from_this())};
 }
 
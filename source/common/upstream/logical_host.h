@@ -20,7 +20,8 @@ public:
                  lb_endpoint.load_balancing_weight().value(), locality_lb_endpoint.locality(),
                  lb_endpoint.endpoint().health_check_config(), locality_lb_endpoint.priority(),
                  lb_endpoint.health_status()),
-        override_transport_socket_options_(override_transport_socket_options) {}
+        override_transport_socket_options_(override_transport_socket_options),
+        address_list_({address}) {}
 
   // Set the new address. Updates are typically rare so a R/W lock is used for address updates.
   // Note that the health check address update requires no lock to be held since it is only
@@ -28,12 +29,22 @@ public:
   // future proof the code.
   void setNewAddress(const Network::Address::InstanceConstSharedPtr& address,
                      const envoy::api::v2::endpoint::LbEndpoint& lb_endpoint) {
+    setNewAddresses({address}, lb_endpoint);
+  }
+
+  // Set the new addresses, the first being the address of the host. Connections to the host race
+  // connection attempts across all of them. @see Network::HappyEyeballsConnectionImpl.
+  void setNewAddresses(const std::vector<Network::Address::InstanceConstSharedPtr>& address_list,
+                       const envoy::api::v2::endpoint::LbEndpoint& lb_endpoint) {
+    ASSERT(!address_list.empty());
+    const auto& address = address_list.front();
     const auto& port_value = lb_endpoint.endpoint().health_check_config().port_value();
     auto health_check_address =
         port_value == 0 ? address : Network::Utility::getAddressWithPort(*address, port_value);
 
     absl::WriterMutexLock lock(&address_lock_);
     address_ = address;
+    address_list_ = address_list;
     health_check_address_ = health_check_address;
   }
 
@@ -55,6 +66,7 @@ public:
 private:
   const Network::TransportSocketOptionsSharedPtr override_transport_socket_options_;
   mutable absl::Mutex address_lock_;
+  std::vector<Network::Address::InstanceConstSharedPtr> address_list_ GUARDED_BY(address_lock_);
 };
 
 using LogicalHostSharedPtr = std::shared_ptr<LogicalHost>;
@@ -31,6 +31,9 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
   }
 
   table_.resize(table_size_);
+  // Which table entries have been filled, kept apart from the table so that the probes of the build
+  // touch a bit per entry rather than a shared pointer.
+  std::vector<bool> filled(table_size_);
 
   // Iterate through the table build entries as many times as it takes to fill up the table.
   uint64_t table_index = 0;
@@ -45,14 +48,13 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
         continue;
       }
       entry.target_weight_ += max_normalized_weight;
-      uint64_t c = permutation(entry);
-      while (table_[c] != nullptr) {
-        entry.next_++;
-        c = permutation(entry);
+      while (filled[entry.permutation_]) {
+        nextPermutation(entry);
       }
 
-      table_[c] = entry.host_;
-      entry.next_++;
+      filled[entry.permutation_] = true;
+      table_[entry.permutation_] = entry.host_;
+      nextPermutation(entry);
       entry.count_++;
       table_index++;
     }
@@ -74,16 +76,22 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
   }
 }
 
-HostConstSharedPtr MaglevTable::chooseHost(uint64_t hash) const {
+HostConstSharedPtr MaglevTable::chooseHost(uint64_t hash, uint32_t attempt) const {
   if (table_.empty()) {
     return nullptr;
   }
 
-  return table_[hash % table_size_];
+  // Each further attempt moves on to the next entry of the table.
+  return table_[(hash % table_size_ + attempt) % table_size_];
 }
 
-uint64_t MaglevTable::permutation(const TableBuildEntry& entry) {
-  return (entry.offset_ + (entry.skip_ * entry.next_)) % table_size_;
+void MaglevTable::nextPermutation(TableBuildEntry& entry) {
+  // This is (offset + skip * next) % table_size for the next value of next, without dividing, as
+  // both the last permutation and skip are less than the table size.
+  entry.permutation_ += entry.skip_;
+  if (entry.permutation_ >= table_size_) {
+    entry.permutation_ -= table_size_;
+  }
 }
 
 MaglevLoadBalancer::MaglevLoadBalancer(const PrioritySet& priority_set, ClusterStats& stats,
@@ -0,0 +1,96 @@
+#include "common/upstream/offload_threads_impl.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Upstream {
+
+OffloadThread::OffloadThread(Api::Api& api) : dispatcher_(api.allocateDispatcher()) {
+  thread_ = api.threadFactory().createThread([this]() -> void { threadRoutine(); });
+}
+
+OffloadThread::~OffloadThread() {
+  // The exit is posted rather than called directly so that the callbacks posted before it, e.g.
+  // the deletion of health checkers, still run on the thread.
+  dispatcher_->post([this]() -> void { dispatcher_->exit(); });
+  thread_->join();
+}
+
+void OffloadThread::threadRoutine() {
+  // The DNS resolver is created and destroyed on the thread, as it is driven by its dispatcher.
+  dns_resolver_ = dispatcher_->createDnsResolver({});
+  ENVOY_LOG(debug, "offload thread entering dispatch loop");
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ENVOY_LOG(debug, "offload thread exited dispatch loop");
+  dns_resolver_.reset();
+  dispatcher_->clearDeferredDeleteList();
+}
+
+OffloadedDnsResolver::OffloadedDnsResolver(const std::vector<OffloadThreadPtr>& threads,
+                                           Event::Dispatcher& main_thread_dispatcher)
+    : threads_(threads), main_thread_dispatcher_(main_thread_dispatcher) {}
+
+Network::ActiveDnsQuery* OffloadedDnsResolver::resolve(const std::string& dns_name,
+                                                       Network::DnsLookupFamily dns_lookup_family,
+                                                       ResolveCb callback) {
+  const uint64_t id = next_query_id_++;
+  auto query = std::make_unique<PendingQuery>(*this, id, std::move(callback));
+  Network::ActiveDnsQuery* active_query = query.get();
+  pending_queries_.emplace(id, std::move(query));
+
+  // The resolver may be gone by the time the response is posted back to the main thread, so only a
+  // weak reference to it is handed to the offload thread.
+  std::weak_ptr<OffloadedDnsResolver> weak_this = shared_from_this();
+  OffloadThread& thread = *threads_[id % threads_.size()];
+  Event::Dispatcher& main_thread_dispatcher = main_thread_dispatcher_;
+  thread.dispatcher().post([&thread, &main_thread_dispatcher, weak_this, id, dns_name,
+                            dns_lookup_family]() -> void {
+    thread.dnsResolver().resolve(
+        dns_name, dns_lookup_family,
+        [&main_thread_dispatcher, weak_this, id](std::list<Network::DnsResponse>&& response) {
+          main_thread_dispatcher.post([weak_this, id, response]() mutable -> void {
+            std::shared_ptr<OffloadedDnsResolver> shared_this = weak_this.lock();
+            if (shared_this != nullptr) {
+              shared_this->onResolved(id, std::move(response));
+            }
+          });
+        });
+  });
+  return active_query;
+}
+
+void OffloadedDnsResolver::onResolved(uint64_t id, std::list<Network::DnsResponse>&& response) {
+  auto query = pending_queries_.find(id);
+  if (query == pending_queries_.end()) {
+    return;
+  }
+
+  // The query is removed before its callback runs, as the callback may start another query.
+  PendingQueryPtr pending_query = std::move(query->second);
+  pending_queries_.erase(query);
+  pending_query->callback_(std::move(response));
+}
+
+void OffloadedDnsResolver::PendingQuery::cancel() {
+  // Erasing the query deletes it, so its id is copied first.
+  const uint64_t id = id_;
+  parent_.pending_queries_.erase(id);
+}
+
+OffloadThreadsImpl::OffloadThreadsImpl(uint32_t thread_count, Api::Api& api,
+                                       Event::Dispatcher& main_thread_dispatcher) {
+  ASSERT(thread_count > 0);
+  for (uint32_t i = 0; i < thread_count; i++) {
+    threads_.emplace_back(std::make_unique<OffloadThread>(api));
+  }
+  dns_resolver_ = std::make_shared<OffloadedDnsResolver>(threads_, main_thread_dispatcher);
+}
+
+Event::Dispatcher& OffloadThreadsImpl::nextDispatcher() {
+  Event::Dispatcher& dispatcher = threads_[next_thread_]->dispatcher();
+  next_thread_ = (next_thread_ + 1) % threads_.size();
+  return dispatcher;
+}
+
+} // namespace Upstream
+} // namespace Envoy
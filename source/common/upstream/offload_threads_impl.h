@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/network/dns.h"
+#include "envoy/thread/thread.h"
+#include "envoy/upstream/cluster_manager.h"
+
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * A thread of the cluster manager's offload threads. It runs its own dispatcher, with its own DNS
+ * resolver.
+ */
+class OffloadThread : Logger::Loggable<Logger::Id::upstream> {
+public:
+  explicit OffloadThread(Api::Api& api);
+
+  /**
+   * Exits the thread once the callbacks already posted to it have run, and blocks until it joins.
+   */
+  ~OffloadThread();
+
+  Event::Dispatcher& dispatcher() { return *dispatcher_; }
+
+  /**
+   * @return Network::DnsResolver& the DNS resolver of the thread. Only used on the thread.
+   */
+  Network::DnsResolver& dnsResolver() { return *dns_resolver_; }
+
+private:
+  void threadRoutine();
+
+  Event::DispatcherPtr dispatcher_;
+  Network::DnsResolverSharedPtr dns_resolver_;
+  Thread::ThreadPtr thread_;
+};
+
+using OffloadThreadPtr = std::unique_ptr<OffloadThread>;
+
+/**
+ * A DNS resolver which resolves on the offload threads, round robin, with their DNS resolvers and
+ * calls back with the responses on the main thread. Only used on the main thread.
+ */
+class OffloadedDnsResolver : public Network::DnsResolver,
+                             public std::enable_shared_from_this<OffloadedDnsResolver> {
+public:
+  OffloadedDnsResolver(const std::vector<OffloadThreadPtr>& threads,
+                       Event::Dispatcher& main_thread_dispatcher);
+
+  // Network::DnsResolver
+  Network::ActiveDnsQuery* resolve(const std::string& dns_name,
+                                   Network::DnsLookupFamily dns_lookup_family,
+                                   ResolveCb callback) override;
+
+private:
+  struct PendingQuery : public Network::ActiveDnsQuery {
+    PendingQuery(OffloadedDnsResolver& parent, uint64_t id, ResolveCb callback)
+        : parent_(parent), id_(id), callback_(std::move(callback)) {}
+
+    // Network::ActiveDnsQuery
+    void cancel() override;
+
+    OffloadedDnsResolver& parent_;
+    const uint64_t id_;
+    ResolveCb callback_;
+  };
+
+  using PendingQueryPtr = std::unique_ptr<PendingQuery>;
+
+  void onResolved(uint64_t id, std::list<Network::DnsResponse>&& response);
+
+  const std::vector<OffloadThreadPtr>& threads_;
+  Event::Dispatcher& main_thread_dispatcher_;
+  // The queries waiting for their responses, by id. A cancelled query is removed, and its response
+  // is dropped when it comes in.
+  std::unordered_map<uint64_t, PendingQueryPtr> pending_queries_;
+  uint64_t next_query_id_{};
+};
+
+/**
+ * Implementation of OffloadThreads.
+ */
+class OffloadThreadsImpl : public OffloadThreads {
+public:
+  OffloadThreadsImpl(uint32_t thread_count, Api::Api& api,
+                     Event::Dispatcher& main_thread_dispatcher);
+
+  // Upstream::OffloadThreads
+  Event::Dispatcher& nextDispatcher() override;
+  Event::Dispatcher& firstDispatcher() override { return threads_.front()->dispatcher(); }
+  Network::DnsResolverSharedPtr dnsResolver() override { return dns_resolver_; }
+
+private:
+  std::vector<OffloadThreadPtr> threads_;
+  std::shared_ptr<OffloadedDnsResolver> dns_resolver_;
+  uint32_t next_thread_{};
+};
+
+} // namespace Upstream
+} // namespace Envoy
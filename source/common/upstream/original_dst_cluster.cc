@@ -7,15 +7,58 @@
 
 #include "envoy/stats/scope.h"
 
+#include "common/common/hash.h"
 #include "common/http/headers.h"
 #include "common/network/address_impl.h"
 #include "common/network/utility.h"
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Upstream {
 
+constexpr size_t OriginalDstHostMap::NumShards;
+
+OriginalDstHostMap::Shard& OriginalDstHostMap::shard(const std::string& address) {
+  return shards_[HashUtil::xxHash64(address) % NumShards];
+}
+
+HostSharedPtr OriginalDstHostMap::find(const std::string& address) {
+  Shard& shard = this->shard(address);
+  absl::ReaderMutexLock lock(&shard.lock_);
+  const auto it = shard.hosts_.find(address);
+  if (it == shard.hosts_.end()) {
+    return nullptr;
+  }
+  // Marked under the lock, so that a sweep either sees the host used or removes it beforehand.
+  it->second->used(true);
+  return it->second;
+}
+
+HostSharedPtr OriginalDstHostMap::insert(const std::string& address, const HostSharedPtr& host) {
+  Shard& shard = this->shard(address);
+  absl::MutexLock lock(&shard.lock_);
+  return shard.hosts_.try_emplace(address, host).first->second;
+}
+
+void OriginalDstHostMap::sweep(HostVector& removed) {
+  // One shard at a time, so that the workers are only held back from the shard being swept.
+  for (Shard& shard : shards_) {
+    absl::MutexLock lock(&shard.lock_);
+    for (auto it = shard.hosts_.begin(); it != shard.hosts_.end();) {
+      if (it->second->used()) {
+        it->second->used(false); // Mark to be removed during the next round.
+        ++it;
+      } else {
+        removed.emplace_back(std::move(it->second));
+        shard.hosts_.erase(it++);
+      }
+    }
+  }
+}
+
 HostConstSharedPtr OriginalDstCluster::LoadBalancer::chooseHost(LoadBalancerContext* context) {
   if (context) {
     // Check if override host header is present, if yes use it otherwise check local address.
@@ -34,13 +77,11 @@ HostConstSharedPtr OriginalDstCluster::LoadBalancer::chooseHost(LoadBalancerCont
 
     if (dst_host) {
       const Network::Address::Instance& dst_addr = *dst_host.get();
-      // Check if a host with the destination address is already in the host set.
-      auto it = host_map_->find(dst_addr.asString());
-      if (it != host_map_->end()) {
-        HostSharedPtr host(it->second); // takes a reference
-        ENVOY_LOG(debug, "Using existing host {}.", host->address()->asString());
-        host->used(true); // Mark as used.
-        return host;
+      // Check if a host with the destination address is already in the host map.
+      HostSharedPtr existing_host = parent_->host_map_.find(dst_addr.asString());
+      if (existing_host != nullptr) {
+        ENVOY_LOG(debug, "Using existing host {}.", existing_host->address()->asString());
+        return existing_host;
       }
       // Add a new host
       const Network::Address::Ip* dst_ip = dst_addr.ip();
@@ -55,17 +96,27 @@ HostConstSharedPtr OriginalDstCluster::LoadBalancer::chooseHost(LoadBalancerCont
             envoy::api::v2::core::Locality().default_instance(),
             envoy::api::v2::endpoint::Endpoint::HealthCheckConfig().default_instance(), 0,
             envoy::api::v2::core::HealthStatus::UNKNOWN));
+        // Another thread may have added a host with the same address meanwhile.
+        existing_host = parent_->host_map_.insert(dst_addr.asString(), host);
+        if (existing_host != host) {
+          ENVOY_LOG(debug, "Using existing host {}.", existing_host->address()->asString());
+          existing_host->used(true);
+          return existing_host;
+        }
         ENVOY_LOG(debug, "Created host {}.", host->address()->asString());
+        info->stats().original_dst_host_added_.inc();
 
-        // Tell the cluster about the new host
-        // lambda cannot capture a member by value.
-        std::weak_ptr<OriginalDstCluster> post_parent = parent_;
-        parent_->dispatcher_.post([post_parent, host]() mutable {
-          // The main cluster may have disappeared while this post was queued.
-          if (std::shared_ptr<OriginalDstCluster> parent = post_parent.lock()) {
-            parent->addHost(host);
-          }
-        });
+        // Tell the cluster about the new host, unless a post adding the queued hosts is pending.
+        if (parent_->queueHost(host)) {
+          // lambda cannot capture a member by value.
+          std::weak_ptr<OriginalDstCluster> post_parent = parent_;
+          parent_->dispatcher_.post([post_parent]() {
+            // The main cluster may have disappeared while this post was queued.
+            if (std::shared_ptr<OriginalDstCluster> parent = post_parent.lock()) {
+              parent->addPendingHosts();
+            }
+          });
+        }
         return host;
       } else {
         ENVOY_LOG(debug, "Failed to create host for {}.", dst_addr.asString());
@@ -109,8 +160,7 @@ OriginalDstCluster::OriginalDstCluster(
       cleanup_timer_(dispatcher_.createTimer([this]() -> void { cleanup(); })),
       use_http_header_(info_->lbOriginalDstConfig()
                            ? info_->lbOriginalDstConfig().value().use_http_header()
-                           : false),
-      host_map_(std::make_shared<HostMap>()) {
+                           : false) {
   // TODO(dio): Remove hosts check once the hosts field is removed.
   if (config.has_load_assignment() || !config.hosts().empty()) {
     throw EnvoyException("ORIGINAL_DST clusters must have no load assignment or hosts configured");
@@ -118,51 +168,56 @@ OriginalDstCluster::OriginalDstCluster(
   cleanup_timer_->enableTimer(cleanup_interval_ms_);
 }
 
-void OriginalDstCluster::addHost(HostSharedPtr& host) {
-  HostMapSharedPtr new_host_map = std::make_shared<HostMap>(*getCurrentHostMap());
-  auto pair = new_host_map->emplace(host->address()->asString(), host);
-  bool added = pair.second;
-  if (added) {
+bool OriginalDstCluster::queueHost(const HostSharedPtr& host) {
+  absl::MutexLock lock(&pending_hosts_lock_);
+  pending_hosts_.emplace_back(host);
+  return pending_hosts_.size() == 1;
+}
+
+void OriginalDstCluster::addPendingHosts() {
+  HostVector hosts_added;
+  {
+    absl::MutexLock lock(&pending_hosts_lock_);
+    hosts_added.swap(pending_hosts_);
+  }
+  if (hosts_added.empty()) {
+    return;
+  }
+  for (const HostSharedPtr& host : hosts_added) {
     ENVOY_LOG(debug, "addHost() adding {}", host->address()->asString());
-    setHostMap(new_host_map);
-    // Given the current config, only EDS clusters support multiple priorities.
-    ASSERT(priority_set_.hostSetsPerPriority().size() == 1);
-    const auto& first_host_set = priority_set_.getOrCreateHostSet(0);
-    HostVectorSharedPtr all_hosts(new HostVector(first_host_set.hosts()));
-    all_hosts->emplace_back(host);
-    priority_set_.updateHosts(0,
-                              HostSetImpl::partitionHosts(all_hosts, HostsPerLocalityImpl::empty()),
-                              {}, {std::move(host)}, {}, absl::nullopt);
   }
+  // Given the current config, only EDS clusters support multiple priorities.
+  ASSERT(priority_set_.hostSetsPerPriority().size() == 1);
+  const auto& first_host_set = priority_set_.getOrCreateHostSet(0);
+  HostVectorSharedPtr all_hosts(new HostVector(first_host_set.hosts()));
+  all_hosts->insert(all_hosts->end(), hosts_added.begin(), hosts_added.end());
+  priority_set_.updateHosts(0,
+                            HostSetImpl::partitionHosts(all_hosts, HostsPerLocalityImpl::empty()),
+                            {}, hosts_added, {}, absl::nullopt);
 }
 
 void OriginalDstCluster::cleanup() {
-  HostVectorSharedPtr keeping_hosts(new HostVector);
-  HostVector to_be_removed;
   ENVOY_LOG(trace, "Stale original dst hosts cleanup triggered.");
-  auto host_map = getCurrentHostMap();
-  if (!host_map->empty()) {
-    ENVOY_LOG(trace, "Cleaning up stale original dst hosts.");
-    for (const auto& pair : *host_map) {
-      const std::string& addr = pair.first;
-      const HostSharedPtr& host = pair.second;
-      if (host->used()) {
-        ENVOY_LOG(trace, "Keeping active host {}.", addr);
-        keeping_hosts->emplace_back(host);
-        host->used(false); // Mark to be removed during the next round.
-      } else {
-        ENVOY_LOG(trace, "Removing stale host {}.", addr);
-        to_be_removed.emplace_back(host);
-      }
-    }
-  }
+  // The hosts removed from the host map must be in the host set already.
+  addPendingHosts();
+  HostVector to_be_removed;
+  host_map_.sweep(to_be_removed);
 
   if (!to_be_removed.empty()) {
-    HostMapSharedPtr new_host_map = std::make_shared<HostMap>(*host_map);
+    absl::flat_hash_set<const Host*> removed;
     for (const HostSharedPtr& host : to_be_removed) {
-      new_host_map->erase(host->address()->asString());
+      ENVOY_LOG(trace, "Removing stale host {}.", host->address()->asString());
+      removed.insert(host.get());
+    }
+    info_->stats().original_dst_host_removed_.add(to_be_removed.size());
+    const HostVector& hosts = priority_set_.getOrCreateHostSet(0).hosts();
+    HostVectorSharedPtr keeping_hosts(new HostVector);
+    keeping_hosts->reserve(hosts.size());
+    for (const HostSharedPtr& host : hosts) {
+      if (!removed.contains(host.get())) {
+        keeping_hosts->emplace_back(host);
+      }
     }
-    setHostMap(new_host_map);
     priority_set_.updateHosts(
         0, HostSetImpl::partitionHosts(keeping_hosts, HostsPerLocalityImpl::empty()), {}, {},
         to_be_removed, absl::nullopt);
@@ -1,9 +1,9 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <string>
-#include <unordered_map>
 
 #include "envoy/secret/secret_manager.h"
 #include "envoy/server/transport_socket_config.h"
@@ -17,11 +17,48 @@
 
 #include "extensions/clusters/well_known_names.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
 namespace Envoy {
 namespace Upstream {
 
-using HostMapSharedPtr = std::shared_ptr<HostMap>;
-using HostMapConstSharedPtr = std::shared_ptr<const HostMap>;
+/**
+ * The hosts of an OriginalDstCluster keyed by address, shared by the main thread and the workers.
+ * The map is split into shards, each under a lock of its own, so that the workers looking up hosts
+ * only take a shared lock of one shard, and adding or removing a host does not copy the map.
+ */
+class OriginalDstHostMap {
+public:
+  /**
+   * @return the host with the address, marked used, or nullptr if there is none.
+   */
+  HostSharedPtr find(const std::string& address);
+
+  /**
+   * Adds a host unless one with the same address was added meanwhile.
+   * @return the host with the address, which is the one given if it was added.
+   */
+  HostSharedPtr insert(const std::string& address, const HostSharedPtr& host);
+
+  /**
+   * Removes the hosts which were not used since the previous sweep, and marks the others unused.
+   * @param removed supplies the vector to add the removed hosts to.
+   */
+  void sweep(HostVector& removed);
+
+private:
+  static constexpr size_t NumShards = 64;
+
+  struct Shard {
+    absl::Mutex lock_;
+    absl::flat_hash_map<std::string, HostSharedPtr> hosts_ ABSL_GUARDED_BY(lock_);
+  };
+
+  Shard& shard(const std::string& address);
+
+  std::array<Shard, NumShards> shards_;
+};
 
 /**
  * The OriginalDstCluster is a dynamic cluster that automatically adds hosts as needed based on the
@@ -44,15 +81,13 @@ public:
    * Load balancer gets called with the downstream context which can be used to make sure the
    * Original Dst cluster has a Host for the original destination. Normally load balancers can't
    * modify clusters, but in this case we access a singleton OriginalDstCluster that we can ask to
-   * add hosts on demand. Additions are synced with all other threads so that the host set in the
-   * cluster remains (eventually) consistent. If multiple threads add a host to the same upstream
-   * address then two distinct HostSharedPtr's (with the same upstream IP address) will be added,
-   * and both of them will eventually time out.
+   * add hosts on demand. A new host is visible to all the threads as soon as it is added to the
+   * shared host map, and the hosts added meanwhile are moved into the host set of the cluster
+   * together on the main thread, so that the host set remains (eventually) consistent.
    */
   class LoadBalancer : public Upstream::LoadBalancer {
   public:
-    LoadBalancer(const std::shared_ptr<OriginalDstCluster>& parent)
-        : parent_(parent), host_map_(parent->getCurrentHostMap()) {}
+    LoadBalancer(const std::shared_ptr<OriginalDstCluster>& parent) : parent_(parent) {}
 
     // Upstream::LoadBalancer
     HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
@@ -61,7 +96,6 @@ public:
     Network::Address::InstanceConstSharedPtr requestOverrideHost(LoadBalancerContext* context);
 
     const std::shared_ptr<OriginalDstCluster> parent_;
-    HostMapConstSharedPtr host_map_;
   };
 
 private:
@@ -87,17 +121,11 @@ private:
     const std::shared_ptr<OriginalDstCluster> cluster_;
   };
 
-  HostMapConstSharedPtr getCurrentHostMap() {
-    absl::ReaderMutexLock lock(&host_map_lock_);
-    return host_map_;
-  }
-
-  void setHostMap(const HostMapConstSharedPtr& new_host_map) {
-    absl::WriterMutexLock lock(&host_map_lock_);
-    host_map_ = new_host_map;
-  }
-
-  void addHost(HostSharedPtr&);
+  // Queues a host added to the host map by a worker to be added to the host set. Returns whether
+  // it is the first one queued, in which case the caller posts addPendingHosts().
+  bool queueHost(const HostSharedPtr& host);
+  // Adds the queued hosts to the host set, on the main thread.
+  void addPendingHosts();
   void cleanup();
 
   // ClusterImplBase
@@ -108,8 +136,12 @@ private:
   Event::TimerPtr cleanup_timer_;
   const bool use_http_header_;
 
-  absl::Mutex host_map_lock_;
-  HostMapConstSharedPtr host_map_ ABSL_GUARDED_BY(host_map_lock_);
+  OriginalDstHostMap host_map_;
+
+  absl::Mutex pending_hosts_lock_;
+  // The hosts added to the host map but not yet to the host set. A single post to the main thread
+  // adds all of them.
+  HostVector pending_hosts_ ABSL_GUARDED_BY(pending_hosts_lock_);
 
   friend class OriginalDstClusterFactory;
 };
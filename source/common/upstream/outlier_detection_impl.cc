@@ -1,5 +1,6 @@
 #include "common/upstream/outlier_detection_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -45,6 +46,8 @@ DetectorHostMonitorImpl::DetectorHostMonitorImpl(std::shared_ptr<DetectorImpl> d
   put_result_func_ = detector->config().splitExternalLocalOriginErrors()
                          ? &DetectorHostMonitorImpl::putResultWithLocalExternalSplit
                          : &DetectorHostMonitorImpl::putResultNoLocalExternalSplit;
+  // Point the latency_accumulator_bucket_ pointer to a bucket.
+  updateCurrentLatencyBucket();
 }
 
 void DetectorHostMonitorImpl::eject(MonotonicTime ejection_time) {
@@ -63,6 +66,12 @@ void DetectorHostMonitorImpl::updateCurrentSuccessRateBucket() {
   local_origin_SR_monitor_.updateCurrentSuccessRateBucket();
 }
 
+void DetectorHostMonitorImpl::putResponseTime(std::chrono::milliseconds time) {
+  LatencyAccumulatorBucket* bucket = latency_accumulator_bucket_.load();
+  bucket->response_time_ms_counter_ += time.count();
+  bucket->total_request_counter_++;
+}
+
 void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
   external_origin_SR_monitor_.incTotalReqCounter();
   if (Http::CodeUtility::is5xx(response_code)) {
@@ -235,7 +244,15 @@ DetectorConfig::DetectorConfig(const envoy::api::v2::cluster::OutlierDetection&
           static_cast<uint64_t>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
               config, enforcing_consecutive_local_origin_failure, 100))),
       enforcing_local_origin_success_rate_(static_cast<uint64_t>(
-          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, enforcing_local_origin_success_rate, 100))) {}
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, enforcing_local_origin_success_rate, 100))),
+      enforcing_latency_(
+          static_cast<uint64_t>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, enforcing_latency, 0))),
+      latency_minimum_hosts_(
+          static_cast<uint64_t>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, latency_minimum_hosts, 5))),
+      latency_request_volume_(static_cast<uint64_t>(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, latency_request_volume, 100))),
+      latency_factor_(
+          static_cast<uint64_t>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, latency_factor, 3000))) {}
 
 DetectorImpl::DetectorImpl(const Cluster& cluster,
                            const envoy::api::v2::cluster::OutlierDetection& config,
@@ -355,6 +372,9 @@ bool DetectorImpl::enforceEjection(envoy::data::cluster::v2alpha::OutlierEjectio
     return runtime_.snapshot().featureEnabled(
         "outlier_detection.enforcing_local_origin_success_rate",
         config_.enforcingLocalOriginSuccessRate());
+  case envoy::data::cluster::v2alpha::OutlierEjectionType::LATENCY:
+    return runtime_.snapshot().featureEnabled("outlier_detection.enforcing_latency",
+                                              config_.enforcingLatency());
   default:
     // Checked by schema.
     NOT_REACHED_GCOVR_EXCL_LINE;
@@ -382,6 +402,9 @@ void DetectorImpl::updateEnforcedEjectionStats(
   case envoy::data::cluster::v2alpha::OutlierEjectionType::SUCCESS_RATE_LOCAL_ORIGIN:
     stats_.ejections_enforced_local_origin_success_rate_.inc();
     break;
+  case envoy::data::cluster::v2alpha::OutlierEjectionType::LATENCY:
+    stats_.ejections_enforced_latency_.inc();
+    break;
   default:
     // Checked by schema.
     NOT_REACHED_GCOVR_EXCL_LINE;
@@ -406,6 +429,9 @@ void DetectorImpl::updateDetectedEjectionStats(
   case envoy::data::cluster::v2alpha::OutlierEjectionType::SUCCESS_RATE_LOCAL_ORIGIN:
     stats_.ejections_detected_local_origin_success_rate_.inc();
     break;
+  case envoy::data::cluster::v2alpha::OutlierEjectionType::LATENCY:
+    stats_.ejections_detected_latency_.inc();
+    break;
   default:
     // Checked by schema.
     NOT_REACHED_GCOVR_EXCL_LINE;
@@ -609,6 +635,72 @@ void DetectorImpl::processSuccessRateEjections(
   }
 }
 
+void DetectorImpl::processLatencyEjections() {
+  uint64_t latency_minimum_hosts = runtime_.snapshot().getInteger(
+      "outlier_detection.latency_minimum_hosts", config_.latencyMinimumHosts());
+  uint64_t latency_request_volume = runtime_.snapshot().getInteger(
+      "outlier_detection.latency_request_volume", config_.latencyRequestVolume());
+  std::vector<std::pair<HostSharedPtr, double>> valid_latency_hosts;
+
+  // Reset the Detector's latency median and threshold.
+  latency_median_ = -1;
+  latency_ejection_threshold_ = -1;
+
+  // reserve upper bound of vector size to avoid reallocation.
+  valid_latency_hosts.reserve(host_monitors_.size());
+
+  for (const auto& host : host_monitors_) {
+    absl::optional<double> mean_response_time =
+        host.second->latencyAccumulator().getMeanResponseTime(latency_request_volume);
+
+    // The latency of a host is dropped when it misses an interval, so that a host brought back in
+    // after an ejection starts over rather than being judged by the latency it was ejected for.
+    if (!mean_response_time || host.first->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
+      host.second->latency(-1);
+      continue;
+    }
+
+    // The moving average weighs the last interval as much as all of the earlier ones together.
+    const double latency = host.second->latency() < 0
+                               ? mean_response_time.value()
+                               : (host.second->latency() + mean_response_time.value()) / 2;
+    host.second->latency(latency);
+    valid_latency_hosts.emplace_back(host.first, latency);
+  }
+
+  if (valid_latency_hosts.empty() || valid_latency_hosts.size() < latency_minimum_hosts) {
+    return;
+  }
+
+  // The median rather than the mean, so that the outliers do not pull the threshold up with them.
+  auto median = valid_latency_hosts.begin() + valid_latency_hosts.size() / 2;
+  std::nth_element(valid_latency_hosts.begin(), median, valid_latency_hosts.end(),
+                   [](const std::pair<HostSharedPtr, double>& lhs,
+                      const std::pair<HostSharedPtr, double>& rhs) -> bool {
+                     return lhs.second < rhs.second;
+                   });
+  const double latency_factor =
+      runtime_.snapshot().getInteger("outlier_detection.latency_factor", config_.latencyFactor()) /
+      1000.0;
+  latency_median_ = median->second;
+  latency_ejection_threshold_ = latency_median_ * latency_factor;
+
+  // Response times have a millisecond resolution, so hosts cannot be told apart when most of them
+  // respond within a millisecond.
+  if (latency_median_ == 0) {
+    return;
+  }
+
+  for (const auto& host_latency_pair : valid_latency_hosts) {
+    if (host_latency_pair.second > latency_ejection_threshold_) {
+      const envoy::data::cluster::v2alpha::OutlierEjectionType type =
+          envoy::data::cluster::v2alpha::OutlierEjectionType::LATENCY;
+      updateDetectedEjectionStats(type);
+      ejectHost(host_latency_pair.first, type);
+    }
+  }
+}
+
 void DetectorImpl::onIntervalTimer() {
   MonotonicTime now = time_source_.monotonicTime();
 
@@ -617,6 +709,7 @@ void DetectorImpl::onIntervalTimer() {
 
     // Need to update the writer bucket to keep the data valid.
     host.second->updateCurrentSuccessRateBucket();
+    host.second->updateCurrentLatencyBucket();
     // Refresh host success rate stat for the /clusters endpoint. If there is a new valid value, it
     // will get updated in processSuccessRateEjections().
     host.second->successRate(DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin, -1);
@@ -625,6 +718,7 @@ void DetectorImpl::onIntervalTimer() {
 
   processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin);
   processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin);
+  processLatencyEjections();
 
   armIntervalTimer();
 }
@@ -660,6 +754,11 @@ void EventLoggerImpl::logEject(const HostDescriptionConstSharedPtr& host, Detect
         detector.successRateEjectionThreshold(monitor_type));
     event.mutable_eject_success_rate_event()->set_host_success_rate(
         host->outlierDetector().successRate(monitor_type));
+  } else if (type == envoy::data::cluster::v2alpha::OutlierEjectionType::LATENCY) {
+    event.mutable_eject_latency_event()->set_host_latency_ms(host->outlierDetector().latency());
+    event.mutable_eject_latency_event()->set_cluster_median_latency_ms(detector.latencyMedian());
+    event.mutable_eject_latency_event()->set_cluster_latency_ejection_threshold_ms(
+        detector.latencyEjectionThreshold());
   } else {
     event.mutable_eject_consecutive_event();
   }
@@ -717,6 +816,27 @@ SuccessRateAccumulator::getSuccessRate(uint64_t success_rate_request_volume) {
           backup_success_rate_bucket_->total_request_counter_};
 }
 
+LatencyAccumulatorBucket* LatencyAccumulator::updateCurrentWriter() {
+  // Right now current is being written to and backup is not. Flush the backup and swap.
+  backup_latency_bucket_->response_time_ms_counter_ = 0;
+  backup_latency_bucket_->total_request_counter_ = 0;
+
+  current_latency_bucket_.swap(backup_latency_bucket_);
+
+  return current_latency_bucket_.get();
+}
+
+absl::optional<double> LatencyAccumulator::getMeanResponseTime(uint64_t latency_request_volume) {
+  // A volume of zero still needs a response time to take the mean of.
+  if (backup_latency_bucket_->total_request_counter_ == 0 ||
+      backup_latency_bucket_->total_request_counter_ < latency_request_volume) {
+    return {};
+  }
+
+  return {static_cast<double>(backup_latency_bucket_->response_time_ms_counter_) /
+          backup_latency_bucket_->total_request_counter_};
+}
+
 } // namespace Outlier
 } // namespace Upstream
 } // namespace Envoy
@@ -36,6 +36,7 @@ public:
   const absl::optional<MonotonicTime>& lastEjectionTime() override { return time_; }
   const absl::optional<MonotonicTime>& lastUnejectionTime() override { return time_; }
   double successRate(SuccessRateMonitorType) const override { return -1; }
+  double latency() const override { return -1; }
 
 private:
   const absl::optional<MonotonicTime> time_;
@@ -128,6 +129,42 @@ private:
   double success_rate_;
 };
 
+struct LatencyAccumulatorBucket {
+  std::atomic<uint64_t> response_time_ms_counter_;
+  std::atomic<uint64_t> total_request_counter_;
+};
+
+/**
+ * The LatencyAccumulator uses the LatencyAccumulatorBucket to get per host mean response times.
+ * Like the SuccessRateAccumulator, it has a fixed window size of time, and thus only needs a
+ * bucket to write to, and a bucket to accumulate/run stats over.
+ */
+class LatencyAccumulator {
+public:
+  LatencyAccumulator()
+      : current_latency_bucket_(new LatencyAccumulatorBucket()),
+        backup_latency_bucket_(new LatencyAccumulatorBucket()) {}
+
+  /**
+   * This function updates the bucket to write data to.
+   * @return a pointer to the LatencyAccumulatorBucket.
+   */
+  LatencyAccumulatorBucket* updateCurrentWriter();
+  /**
+   * This function returns the mean response time of a host over a window of time if the request
+   * volume is high enough.
+   * @param latency_request_volume the threshold of requests an accumulator has to have in order to
+   *                               be able to return a significant mean response time.
+   * @return a valid absl::optional<double> with the mean response time in milliseconds. If there
+   * were not enough requests, an invalid absl::optional<double> is returned.
+   */
+  absl::optional<double> getMeanResponseTime(uint64_t latency_request_volume);
+
+private:
+  std::unique_ptr<LatencyAccumulatorBucket> current_latency_bucket_;
+  std::unique_ptr<LatencyAccumulatorBucket> backup_latency_bucket_;
+};
+
 class DetectorImpl;
 
 /**
@@ -149,7 +186,7 @@ public:
   uint32_t numEjections() override { return num_ejections_; }
   void putHttpResponseCode(uint64_t response_code) override;
   void putResult(Result result, absl::optional<uint64_t> code) override;
-  void putResponseTime(std::chrono::milliseconds) override {}
+  void putResponseTime(std::chrono::milliseconds time) override;
   const absl::optional<MonotonicTime>& lastEjectionTime() override { return last_ejection_time_; }
   const absl::optional<MonotonicTime>& lastUnejectionTime() override {
     return last_unejection_time_;
@@ -174,6 +211,13 @@ public:
     getSRMonitor(type).setSuccessRate(new_success_rate);
   }
 
+  double latency() const override { return latency_; }
+  LatencyAccumulator& latencyAccumulator() { return latency_accumulator_; }
+  void updateCurrentLatencyBucket() {
+    latency_accumulator_bucket_.store(latency_accumulator_.updateCurrentWriter());
+  }
+  void latency(double new_latency) { latency_ = new_latency; }
+
   // handlers for reporting local origin errors
   void localOriginFailure();
   void localOriginNoFailure();
@@ -200,6 +244,12 @@ private:
   SuccessRateMonitor external_origin_SR_monitor_;
   SuccessRateMonitor local_origin_SR_monitor_;
 
+  // Response times are written to the bucket from the workers, and the latency is only touched on
+  // the main thread.
+  LatencyAccumulator latency_accumulator_;
+  std::atomic<LatencyAccumulatorBucket*> latency_accumulator_bucket_;
+  double latency_{-1};
+
   void putResultNoLocalExternalSplit(Result result, absl::optional<uint64_t> code);
   void putResultWithLocalExternalSplit(Result result, absl::optional<uint64_t> code);
   std::function<void(DetectorHostMonitorImpl*, Result, absl::optional<uint64_t> code)>
@@ -213,9 +263,11 @@ private:
   COUNTER(ejections_consecutive_5xx)                                                               \
   COUNTER(ejections_detected_consecutive_5xx)                                                      \
   COUNTER(ejections_detected_consecutive_gateway_failure)                                          \
+  COUNTER(ejections_detected_latency)                                                              \
   COUNTER(ejections_detected_success_rate)                                                         \
   COUNTER(ejections_enforced_consecutive_5xx)                                                      \
   COUNTER(ejections_enforced_consecutive_gateway_failure)                                          \
+  COUNTER(ejections_enforced_latency)                                                              \
   COUNTER(ejections_enforced_success_rate)                                                         \
   COUNTER(ejections_detected_consecutive_local_origin_failure)                                     \
   COUNTER(ejections_enforced_consecutive_local_origin_failure)                                     \
@@ -260,6 +312,10 @@ public:
     return enforcing_consecutive_local_origin_failure_;
   }
   uint64_t enforcingLocalOriginSuccessRate() const { return enforcing_local_origin_success_rate_; }
+  uint64_t enforcingLatency() const { return enforcing_latency_; }
+  uint64_t latencyMinimumHosts() const { return latency_minimum_hosts_; }
+  uint64_t latencyRequestVolume() const { return latency_request_volume_; }
+  uint64_t latencyFactor() const { return latency_factor_; }
 
 private:
   const uint64_t interval_ms_;
@@ -277,6 +333,10 @@ private:
   const uint64_t consecutive_local_origin_failure_;
   const uint64_t enforcing_consecutive_local_origin_failure_;
   const uint64_t enforcing_local_origin_success_rate_;
+  const uint64_t enforcing_latency_;
+  const uint64_t latency_minimum_hosts_;
+  const uint64_t latency_request_volume_;
+  const uint64_t latency_factor_;
 };
 
 /**
@@ -308,6 +368,8 @@ public:
       DetectorHostMonitor::SuccessRateMonitorType monitor_type) const override {
     return getSRNums(monitor_type).ejection_threshold_;
   }
+  double latencyMedian() const override { return latency_median_; }
+  double latencyEjectionThreshold() const override { return latency_ejection_threshold_; }
 
   /**
    * This function returns pair of double values for success rate outlier detection. The pair
@@ -348,6 +410,7 @@ private:
   void updateEnforcedEjectionStats(envoy::data::cluster::v2alpha::OutlierEjectionType type);
   void updateDetectedEjectionStats(envoy::data::cluster::v2alpha::OutlierEjectionType type);
   void processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType monitor_type);
+  void processLatencyEjections();
 
   DetectorConfig config_;
   Event::Dispatcher& dispatcher_;
@@ -367,6 +430,11 @@ private:
   EjectionPair external_origin_SR_num_;
   EjectionPair local_origin_SR_num_;
 
+  // Median host latency and latency ejection threshold of the last interval, or -1 if there were
+  // not enough hosts with enough request volume.
+  double latency_median_{-1};
+  double latency_ejection_threshold_{-1};
+
   const EjectionPair& getSRNums(DetectorHostMonitor::SuccessRateMonitorType monitor_type) const {
     return (DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin == monitor_type)
                ? external_origin_SR_num_
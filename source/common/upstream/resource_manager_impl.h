@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <memory>
@@ -11,6 +12,8 @@
 
 #include "common/common/assert.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -22,29 +25,42 @@ namespace Upstream {
  *    occur during high contention.
  * 2) Though atomics are used, it is possible for resources to temporarily go above the supplied
  *    maximums. This should not effect overall behavior.
+ * If a retry budget is configured, the maximum number of retries is a percentage of the active and
+ * pending requests instead of max_retries, with a floor of min_retry_concurrency.
  */
 class ResourceManagerImpl : public ResourceManager {
 public:
   ResourceManagerImpl(Runtime::Loader& runtime, const std::string& runtime_key,
                       uint64_t max_connections, uint64_t max_pending_requests,
                       uint64_t max_requests, uint64_t max_retries, uint64_t max_connection_pools,
-                      ClusterCircuitBreakersStats cb_stats)
+                      ClusterCircuitBreakersStats cb_stats,
+                      absl::optional<double> retry_budget_percent = absl::nullopt,
+                      uint32_t min_retry_concurrency = 0)
       : connections_(max_connections, runtime, runtime_key + "max_connections", cb_stats.cx_open_,
                      cb_stats.remaining_cx_),
         pending_requests_(max_pending_requests, runtime, runtime_key + "max_pending_requests",
                           cb_stats.rq_pending_open_, cb_stats.remaining_pending_),
         requests_(max_requests, runtime, runtime_key + "max_requests", cb_stats.rq_open_,
                   cb_stats.remaining_rq_),
-        retries_(max_retries, runtime, runtime_key + "max_retries", cb_stats.rq_retry_open_,
-                 cb_stats.remaining_retries_),
         connection_pools_(max_connection_pools, runtime, runtime_key + "max_connection_pools",
-                          cb_stats.cx_pool_open_, cb_stats.remaining_cx_pools_) {}
+                          cb_stats.cx_pool_open_, cb_stats.remaining_cx_pools_) {
+    if (retry_budget_percent.has_value()) {
+      retries_ = std::make_unique<RetryBudgetImpl>(
+          retry_budget_percent.value(), min_retry_concurrency, runtime, runtime_key,
+          cb_stats.rq_retry_open_, cb_stats.remaining_retries_,
+          cb_stats.rq_retry_budget_exhausted_, requests_, pending_requests_);
+    } else {
+      retries_ = std::make_unique<ResourceImpl>(max_retries, runtime, runtime_key + "max_retries",
+                                                cb_stats.rq_retry_open_,
+                                                cb_stats.remaining_retries_);
+    }
+  }
 
   // Upstream::ResourceManager
   Resource& connections() override { return connections_; }
   Resource& pendingRequests() override { return pending_requests_; }
   Resource& requests() override { return requests_; }
-  Resource& retries() override { return retries_; }
+  Resource& retries() override { return *retries_; }
   Resource& connectionPools() override { return connection_pools_; }
 
 private:
@@ -62,14 +78,14 @@ private:
     void inc() override {
       current_++;
       updateRemaining();
-      open_gauge_.set(canCreate() ? 0 : 1);
+      open_gauge_.set(current_ < max() ? 0 : 1);
     }
     void dec() override { decBy(1); }
     void decBy(uint64_t amount) override {
       ASSERT(current_ >= amount);
       current_ -= amount;
       updateRemaining();
-      open_gauge_.set(canCreate() ? 0 : 1);
+      open_gauge_.set(current_ < max() ? 0 : 1);
     }
     uint64_t max() override { return runtime_.snapshot().getInteger(runtime_key_, max_); }
 
@@ -105,10 +121,44 @@ private:
     Stats::Gauge& remaining_;
   };
 
+  /**
+   * Active retries bounded by a percentage of the active and pending requests, so the retries scale
+   * with the traffic to the cluster. The minimum concurrency allows retries at low traffic. Like
+   * the other resources, the counts are atomics which are not synchronized with each other.
+   */
+  struct RetryBudgetImpl : public ResourceImpl {
+    RetryBudgetImpl(double budget_percent, uint32_t min_retry_concurrency,
+                    Runtime::Loader& runtime, const std::string& runtime_key,
+                    Stats::Gauge& open_gauge, Stats::Gauge& remaining, Stats::Counter& exhausted,
+                    const ResourceImpl& requests, const ResourceImpl& pending_requests)
+        : ResourceImpl(min_retry_concurrency, runtime,
+                       runtime_key + "retry_budget.min_retry_concurrency", open_gauge, remaining),
+          budget_percent_(budget_percent), exhausted_(exhausted), requests_(requests),
+          pending_requests_(pending_requests) {}
+
+    // Upstream::Resource
+    bool canCreate() override {
+      if (ResourceImpl::canCreate()) {
+        return true;
+      }
+      exhausted_.inc();
+      return false;
+    }
+    uint64_t max() override {
+      const uint64_t active_requests = requests_.current_ + pending_requests_.current_;
+      return std::max<uint64_t>(budget_percent_ / 100 * active_requests, ResourceImpl::max());
+    }
+
+    const double budget_percent_;
+    Stats::Counter& exhausted_;
+    const ResourceImpl& requests_;
+    const ResourceImpl& pending_requests_;
+  };
+
   ResourceImpl connections_;
   ResourceImpl pending_requests_;
   ResourceImpl requests_;
-  ResourceImpl retries_;
+  std::unique_ptr<ResourceImpl> retries_;
   ResourceImpl connection_pools_;
 };
 
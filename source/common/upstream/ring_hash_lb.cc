@@ -40,41 +40,25 @@ RingHashLoadBalancerStats RingHashLoadBalancer::generateStats(Stats::Scope& scop
   return {ALL_RING_HASH_LOAD_BALANCER_STATS(POOL_GAUGE(scope))};
 }
 
-HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h) const {
-  if (ring_.empty()) {
+HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h, uint32_t attempt) const {
+  if (hashes_.empty()) {
     return nullptr;
   }
 
-  // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c (ketama_get_server)
-  // I've generally kept the variable names to make the code easier to compare.
-  // NOTE: The algorithm depends on using signed integers for lowp, midp, and highp. Do not
-  //       change them!
-  int64_t lowp = 0;
-  int64_t highp = ring_.size();
-  while (true) {
-    int64_t midp = (lowp + highp) / 2;
-
-    if (midp == static_cast<int64_t>(ring_.size())) {
-      return ring_[0].host_;
-    }
-
-    uint64_t midval = ring_[midp].hash_;
-    uint64_t midval1 = midp == 0 ? 0 : ring_[midp - 1].hash_;
-
-    if (h <= midval && h > midval1) {
-      return ring_[midp].host_;
-    }
-
-    if (midval < h) {
-      lowp = midp + 1;
-    } else {
-      highp = midp - 1;
-    }
-
-    if (lowp > highp) {
-      return ring_[0].host_;
-    }
+  // Find the first entry whose hash is at least h, wrapping around to the first entry if there is
+  // none, as ketama does. The search halves the range without branching on the comparison, which
+  // is unpredictable, so that it compiles to conditional moves.
+  const uint64_t* base = hashes_.data();
+  size_t length = hashes_.size();
+  while (length > 1) {
+    const size_t half = length / 2;
+    base = base[half - 1] < h ? base + half : base;
+    length -= half;
   }
+  const size_t index = (base - hashes_.data()) + (*base < h);
+
+  // Each further attempt walks on to the next entry clockwise around the ring.
+  return hosts_[host_indexes_[(index + attempt) % hashes_.size()]];
 }
 
 using HashFunction = envoy::api::v2::Cluster_RingHashLbConfig_HashFunction;
@@ -99,9 +83,12 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
       std::min(std::ceil(min_normalized_weight * min_ring_size) / min_normalized_weight,
                static_cast<double>(max_ring_size));
 
-  // Reserve memory for the entire ring up front.
+  // Reserve memory for the entire ring up front. The entries are built as (hash, host index) pairs
+  // which are sorted together, and then split into the ring's arrays.
   const uint64_t ring_size = std::ceil(scale);
-  ring_.reserve(ring_size);
+  std::vector<std::pair<uint64_t, uint32_t>> ring_entries;
+  ring_entries.reserve(ring_size);
+  hosts_.reserve(normalized_host_weights.size());
 
   // Populate the hash ring by walking through the (host, weight) pairs in normalized_host_weights,
   // and generating (scale * weight) hashes for each host. Since these aren't necessarily whole
@@ -127,6 +114,8 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
   uint64_t max_hashes_per_host = 0;
   for (const auto& entry : normalized_host_weights) {
     const auto& host = entry.first;
+    const uint32_t host_index = hosts_.size();
+    hosts_.push_back(host);
     const std::string& address_string = host->address()->asString();
     uint64_t offset_start = address_string.size();
 
@@ -158,7 +147,7 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
               : HashUtil::xxHash64(hash_key);
 
       ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key.data(), hash);
-      ring_.push_back({hash, host});
+      ring_entries.emplace_back(hash, host_index);
       ++i;
       ++current_hashes;
     }
@@ -166,17 +155,26 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
     max_hashes_per_host = std::max(i, max_hashes_per_host);
   }
 
-  std::sort(ring_.begin(), ring_.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
-    return lhs.hash_ < rhs.hash_;
-  });
+  std::sort(ring_entries.begin(), ring_entries.end(),
+            [](const std::pair<uint64_t, uint32_t>& lhs,
+               const std::pair<uint64_t, uint32_t>& rhs) -> bool { return lhs.first < rhs.first; });
+  hashes_.reserve(ring_entries.size());
+  host_indexes_.reserve(ring_entries.size());
+  for (const auto& entry : ring_entries) {
+    hashes_.push_back(entry.first);
+    host_indexes_.push_back(entry.second);
+  }
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
-    for (const auto& entry : ring_) {
-      ENVOY_LOG(trace, "ring hash: host={} hash={}", entry.host_->address()->asString(),
-                entry.hash_);
+    for (const auto& entry : ring_entries) {
+      ENVOY_LOG(trace, "ring hash: host={} hash={}", hosts_[entry.second]->address()->asString(),
+                entry.first);
     }
   }
 
   stats_.size_.set(ring_size);
+  stats_.memory_bytes_.set(hosts_.capacity() * sizeof(HostConstSharedPtr) +
+                           hashes_.capacity() * sizeof(uint64_t) +
+                           host_indexes_.capacity() * sizeof(uint32_t));
   stats_.min_hashes_per_host_.set(min_hashes_per_host);
   stats_.max_hashes_per_host_.set(max_hashes_per_host);
 }
@@ -17,6 +17,7 @@ namespace Upstream {
  */
 #define ALL_RING_HASH_LOAD_BALANCER_STATS(GAUGE)                                                   \
   GAUGE(max_hashes_per_host, Accumulate)                                                           \
+  GAUGE(memory_bytes, Accumulate)                                                                  \
   GAUGE(min_hashes_per_host, Accumulate)                                                           \
   GAUGE(size, Accumulate)
 
@@ -49,20 +50,20 @@ public:
 private:
   using HashFunction = envoy::api::v2::Cluster_RingHashLbConfig_HashFunction;
 
-  struct RingEntry {
-    uint64_t hash_;
-    HostConstSharedPtr host_;
-  };
-
   struct Ring : public HashingLoadBalancer {
     Ring(const NormalizedHostWeightVector& normalized_host_weights, double min_normalized_weight,
          uint64_t min_ring_size, uint64_t max_ring_size, HashFunction hash_function,
          RingHashLoadBalancerStats& stats);
 
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
-    HostConstSharedPtr chooseHost(uint64_t hash) const override;
-
-    std::vector<RingEntry> ring_;
+    HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
+
+    // The hosts on the ring, which the entries refer to by index rather than by shared pointer.
+    std::vector<HostConstSharedPtr> hosts_;
+    // The hashes of the entries in ascending order, and the index into hosts_ of each entry's host.
+    // They are kept apart so that a lookup's binary search only touches the hashes.
+    std::vector<uint64_t> hashes_;
+    std::vector<uint32_t> host_indexes_;
 
     RingHashLoadBalancerStats& stats_;
   };
@@ -69,22 +69,12 @@ SubsetLoadBalancer::SubsetLoadBalancer(
   initSubsetSelectorMap();
 
   // Configure future updates.
+  // It's possible that metadata changed, with or without hosts being added or removed. update()
+  // finds the hosts whose metadata changed and regroups them along with the added hosts, adding
+  // any new subsets and removing unused ones.
   original_priority_set_callback_handle_ = priority_set.addPriorityUpdateCb(
       [this](uint32_t priority, const HostVector& hosts_added, const HostVector& hosts_removed) {
-        if (hosts_added.empty() && hosts_removed.empty()) {
-          // It's possible that metadata changed, without hosts being added nor removed.
-          // If so we need to add any new subsets, remove unused ones, and regroup hosts into
-          // the right subsets.
-          //
-          // Note, note, note: if metadata for existing endpoints changed _and_ hosts were also
-          // added or removed, we don't need to hit this path. That's fine, given that
-          // findOrCreateSubset() will be called from processSubsets because it'll be triggered by
-          // either hosts_added or hosts_removed. That's where the new subsets will be created.
-          refreshSubsets(priority);
-        } else {
-          // This is a regular update with deltas.
-          update(priority, hosts_added, hosts_removed);
-        }
+        update(priority, hosts_added, hosts_removed);
       });
 }
 
@@ -106,12 +96,6 @@ void SubsetLoadBalancer::refreshSubsets() {
   }
 }
 
-void SubsetLoadBalancer::refreshSubsets(uint32_t priority) {
-  const auto& host_sets = original_priority_set_.hostSetsPerPriority();
-  ASSERT(priority < host_sets.size());
-  update(priority, host_sets[priority]->hosts(), {});
-}
-
 void SubsetLoadBalancer::initSubsetSelectorMap() {
   selectors_ = std::make_shared<SubsetSelectorMap>();
   SubsetSelectorMapPtr selectors;
@@ -315,15 +299,17 @@ SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::findSubset(
 }
 
 void SubsetLoadBalancer::updateFallbackSubset(uint32_t priority, const HostVector& hosts_added,
-                                              const HostVector& hosts_removed) {
+                                              const HostVector& hosts_removed,
+                                              const HostVector& hosts_to_match) {
 
   if (selector_fallback_subset_any_ != nullptr) {
-    selector_fallback_subset_any_->priority_subset_->update(priority, hosts_added, hosts_removed);
+    selector_fallback_subset_any_->priority_subset_->update(priority, hosts_added, hosts_removed,
+                                                            hosts_to_match);
   }
 
   if (selector_fallback_subset_default_ != nullptr) {
     selector_fallback_subset_default_->priority_subset_->update(priority, hosts_added,
-                                                                hosts_removed);
+                                                                hosts_removed, hosts_to_match);
   }
 
   if (fallback_subset_ == nullptr) {
@@ -332,15 +318,16 @@ void SubsetLoadBalancer::updateFallbackSubset(uint32_t priority, const HostVecto
   }
 
   // Add/remove hosts.
-  fallback_subset_->priority_subset_->update(priority, hosts_added, hosts_removed);
+  fallback_subset_->priority_subset_->update(priority, hosts_added, hosts_removed, hosts_to_match);
 
   // Same thing for the panic mode subset.
   if (panic_mode_subset_ != nullptr) {
-    panic_mode_subset_->priority_subset_->update(priority, hosts_added, hosts_removed);
+    panic_mode_subset_->priority_subset_->update(priority, hosts_added, hosts_removed,
+                                                 hosts_to_match);
   }
 }
 
-// Iterates over the added and removed hosts, looking up an LbSubsetEntryPtr for each. For every
+// Iterates over the hosts to match and removed hosts, looking up an LbSubsetEntryPtr for each. For every
 // unique LbSubsetEntryPtr found, it either invokes new_cb or update_cb depending on whether the
 // LbSubsetEntryPtr is already initialized (update_cb) or not (new_cb). In addition, update_cb is
 // invoked for any otherwise unmodified but active and initialized LbSubsetEntryPtr to allow host
@@ -401,13 +388,14 @@ void SubsetLoadBalancer::processSubsets(
 // new subsets as necessary.
 void SubsetLoadBalancer::update(uint32_t priority, const HostVector& hosts_added,
                                 const HostVector& hosts_removed) {
-  updateFallbackSubset(priority, hosts_added, hosts_removed);
+  const HostVector hosts_to_match = hostsToMatch(priority, hosts_added, hosts_removed);
+  updateFallbackSubset(priority, hosts_added, hosts_removed, hosts_to_match);
 
   processSubsets(
-      hosts_added, hosts_removed,
+      hosts_to_match, hosts_removed,
       [&](LbSubsetEntryPtr entry) {
         const bool active_before = entry->active();
-        entry->priority_subset_->update(priority, hosts_added, hosts_removed);
+        entry->priority_subset_->update(priority, hosts_added, hosts_removed, hosts_to_match);
 
         if (active_before && !entry->active()) {
           stats_.lb_subsets_active_.dec();
@@ -434,6 +422,31 @@ void SubsetLoadBalancer::update(uint32_t priority, const HostVector& hosts_added
       });
 }
 
+// Returns the hosts which must be matched against the subsets: the added hosts, and those whose
+// metadata changed since the last update. Metadata is replaced rather than modified when it
+// changes, so comparing pointers finds the changes without comparing the metadata itself.
+HostVector SubsetLoadBalancer::hostsToMatch(uint32_t priority, const HostVector& hosts_added,
+                                            const HostVector& hosts_removed) {
+  for (const auto& host : hosts_removed) {
+    host_metadata_.erase(host.get());
+  }
+
+  HostVector hosts_to_match;
+  for (const auto& host : hosts_added) {
+    host_metadata_[host.get()] = host->metadata();
+    hosts_to_match.emplace_back(host);
+  }
+  for (const auto& host : original_priority_set_.hostSetsPerPriority()[priority]->hosts()) {
+    auto metadata = host->metadata();
+    auto& last_metadata = host_metadata_[host.get()];
+    if (last_metadata != metadata) {
+      last_metadata = std::move(metadata);
+      hosts_to_match.emplace_back(host);
+    }
+  }
+  return hosts_to_match;
+}
+
 bool SubsetLoadBalancer::hostMatches(const SubsetMetadata& kvs, const Host& host) {
   const envoy::api::v2::core::Metadata& host_metadata = *host.metadata();
   const auto filter_it =
@@ -623,7 +636,8 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
   }
 
   for (size_t i = 0; i < subset_lb.original_priority_set_.hostSetsPerPriority().size(); ++i) {
-    update(i, subset_lb.original_priority_set_.hostSetsPerPriority()[i]->hosts(), {});
+    const HostVector& hosts = subset_lb.original_priority_set_.hostSetsPerPriority()[i]->hosts();
+    update(i, hosts, {}, hosts);
   }
 
   switch (subset_lb.lb_type_) {
@@ -682,25 +696,36 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
 // they are not currently a member of this subset.
 void SubsetLoadBalancer::HostSubsetImpl::update(const HostVector& hosts_added,
                                                 const HostVector& hosts_removed,
+                                                const HostVector& hosts_to_match,
                                                 std::function<bool(const Host&)> predicate) {
-  // We cache the result of matching the host against the predicate. This ensures
-  // that we maintain a consistent view of the metadata and saves on computation
-  // since metadata lookups can be expensive.
-  //
-  // We use an unordered_set because this can potentially be in the tens of thousands.
-  std::unordered_set<const Host*> matching_hosts;
+  // The removed hosts which belonged to the subset are those it reports as removed.
+  HostVector filtered_removed;
+  for (const auto& host : hosts_removed) {
+    if (matching_hosts_.erase(host.get()) == 1) {
+      filtered_removed.emplace_back(host);
+    }
+  }
+
+  // We cache the result of matching the host against the predicate across updates, and only
+  // match the hosts which were added or whose metadata changed. This ensures that we maintain a
+  // consistent view of the metadata and saves on computation since metadata lookups can be
+  // expensive.
+  for (const auto& host : hosts_to_match) {
+    if (predicate(*host)) {
+      matching_hosts_.insert(host.get());
+    } else {
+      matching_hosts_.erase(host.get());
+    }
+  }
 
-  auto cached_predicate = [&matching_hosts](const auto& host) {
-    return matching_hosts.count(&host) == 1;
-  };
+  auto cached_predicate = [this](const auto& host) { return matching_hosts_.count(&host) == 1; };
 
   // TODO(snowp): If we had a unhealthyHosts() function we could avoid potentially traversing
   // the list of hosts twice.
   auto hosts = std::make_shared<HostVector>();
   hosts->reserve(original_host_set_.hosts().size());
   for (const auto& host : original_host_set_.hosts()) {
-    if (predicate(*host)) {
-      matching_hosts.insert(host.get());
+    if (cached_predicate(*host)) {
       hosts->emplace_back(host);
     }
   }
@@ -758,15 +783,6 @@ void SubsetLoadBalancer::HostSubsetImpl::update(const HostVector& hosts_added,
     }
   }
 
-  // Since the removed hosts would not be present in the list of all hosts, we need to evaluate
-  // the predicate directly for these hosts.
-  HostVector filtered_removed;
-  for (const auto& host : hosts_removed) {
-    if (predicate(*host)) {
-      filtered_removed.emplace_back(host);
-    }
-  }
-
   HostSetImpl::updateHosts(HostSetImpl::updateHostsParams(
                                hosts, hosts_per_locality, healthy_hosts, healthy_hosts_per_locality,
                                degraded_hosts, degraded_hosts_per_locality, excluded_hosts,
@@ -824,9 +840,10 @@ HostSetImplPtr SubsetLoadBalancer::PrioritySubsetImpl::createHostSet(
 
 void SubsetLoadBalancer::PrioritySubsetImpl::update(uint32_t priority,
                                                     const HostVector& hosts_added,
-                                                    const HostVector& hosts_removed) {
+                                                    const HostVector& hosts_removed,
+                                                    const HostVector& hosts_to_match) {
   const auto& host_subset = getOrCreateHostSet(priority);
-  updateSubset(priority, hosts_added, hosts_removed, predicate_);
+  updateSubset(priority, hosts_added, hosts_removed, hosts_to_match, predicate_);
 
   if (host_subset.hosts().empty() != empty_) {
     empty_ = true;
@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
@@ -54,8 +55,10 @@ private:
           original_host_set_(original_host_set), locality_weight_aware_(locality_weight_aware),
           scale_locality_weight_(scale_locality_weight) {}
 
+    // Only the hosts in hosts_to_match, i.e. those added or whose metadata changed, are matched
+    // against the predicate. The other hosts keep the membership of earlier updates.
     void update(const HostVector& hosts_added, const HostVector& hosts_removed,
-                HostPredicate predicate);
+                const HostVector& hosts_to_match, HostPredicate predicate);
     LocalityWeightsConstSharedPtr
     determineLocalityWeights(const HostsPerLocality& hosts_per_locality) const;
 
@@ -66,6 +69,9 @@ private:
     const HostSet& original_host_set_;
     const bool locality_weight_aware_;
     const bool scale_locality_weight_;
+    // The hosts of the original host set which belong to the subset. We use an unordered_set
+    // because this can potentially be in the tens of thousands.
+    std::unordered_set<const Host*> matching_hosts_;
   };
 
   // Represents a subset of an original PrioritySet.
@@ -74,7 +80,8 @@ private:
     PrioritySubsetImpl(const SubsetLoadBalancer& subset_lb, HostPredicate predicate,
                        bool locality_weight_aware, bool scale_locality_weight);
 
-    void update(uint32_t priority, const HostVector& hosts_added, const HostVector& hosts_removed);
+    void update(uint32_t priority, const HostVector& hosts_added, const HostVector& hosts_removed,
+                const HostVector& hosts_to_match);
 
     bool empty() { return empty_; }
 
@@ -89,9 +96,10 @@ private:
     }
 
     void updateSubset(uint32_t priority, const HostVector& hosts_added,
-                      const HostVector& hosts_removed, HostPredicate predicate) {
+                      const HostVector& hosts_removed, const HostVector& hosts_to_match,
+                      HostPredicate predicate) {
       reinterpret_cast<HostSubsetImpl*>(host_sets_[priority].get())
-          ->update(hosts_added, hosts_removed, predicate);
+          ->update(hosts_added, hosts_removed, hosts_to_match, predicate);
 
       runUpdateCallbacks(hosts_added, hosts_removed);
     }
@@ -148,13 +156,14 @@ private:
 
   // Create filtered default subset (if necessary) and other subsets based on current hosts.
   void refreshSubsets();
-  void refreshSubsets(uint32_t priority);
 
   // Called by HostSet::MemberUpdateCb
   void update(uint32_t priority, const HostVector& hosts_added, const HostVector& hosts_removed);
+  HostVector hostsToMatch(uint32_t priority, const HostVector& hosts_added,
+                          const HostVector& hosts_removed);
 
   void updateFallbackSubset(uint32_t priority, const HostVector& hosts_added,
-                            const HostVector& hosts_removed);
+                            const HostVector& hosts_removed, const HostVector& hosts_to_match);
   void processSubsets(
       const HostVector& hosts_added, const HostVector& hosts_removed,
       std::function<void(LbSubsetEntryPtr)> update_cb,
@@ -204,6 +213,8 @@ private:
 
   // Forms a trie-like structure. Requires lexically sorted Host and Route metadata.
   LbSubsetMap subsets_;
+  // The metadata of each host as of the last update, to find the hosts whose metadata changed.
+  std::unordered_map<const Host*, std::shared_ptr<envoy::api::v2::core::Metadata>> host_metadata_;
   // Forms a trie-like structure of lexically sorted keys+fallback policy from subset
   // selectors configuration
   SubsetSelectorMapPtr selectors_;
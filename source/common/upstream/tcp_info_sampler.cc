@@ -0,0 +1,82 @@
+#include "common/upstream/tcp_info_sampler.h"
+
+#include "envoy/upstream/upstream.h"
+
+#include "common/network/utility.h"
+
+namespace Envoy {
+namespace Upstream {
+
+TcpInfoSampler::TcpInfoSampler(Event::Dispatcher& dispatcher, HostDescriptionConstSharedPtr host,
+                               std::chrono::milliseconds interval)
+    : host_(std::move(host)), interval_(interval),
+      sample_timer_(dispatcher.createTimer([this]() -> void { onSampleTimer(); })) {}
+
+void TcpInfoSampler::addToConnection(Network::Connection& connection,
+                                     HostDescriptionConstSharedPtr host) {
+  const absl::optional<std::chrono::milliseconds> interval =
+      host->cluster().tcpInfoSampleInterval();
+  if (interval.has_value()) {
+    connection.addReadFilter(std::make_shared<TcpInfoSampler>(connection.dispatcher(),
+                                                              std::move(host), interval.value()));
+  }
+}
+
+uint64_t TcpInfoSampler::smoothRtt(uint64_t smoothed_rtt_us, uint64_t sample_rtt_us) {
+  if (smoothed_rtt_us == 0) {
+    return sample_rtt_us;
+  }
+  // SRTT <- (1 - 1/8) * SRTT + 1/8 * R'
+  return (7 * smoothed_rtt_us + sample_rtt_us) / 8;
+}
+
+void TcpInfoSampler::initializeReadFilterCallbacks(Network::ReadFilterCallbacks& callbacks) {
+  // The filter may be installed after the connection connected, e.g. on the connection kept by a
+  // Happy Eyeballs connection, so sampling starts right away and skips the samples taken while
+  // connecting.
+  connection_ = &callbacks.connection();
+  connection_->addConnectionCallbacks(*this);
+  sample_timer_->enableTimer(interval_);
+}
+
+void TcpInfoSampler::onEvent(Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::RemoteClose ||
+      event == Network::ConnectionEvent::LocalClose) {
+    sample_timer_->disableTimer();
+  }
+}
+
+void TcpInfoSampler::onSampleTimer() {
+  if (connection_->state() != Network::Connection::State::Open) {
+    return;
+  }
+
+  const absl::optional<Network::TcpInfo> tcp_info =
+      Network::Utility::getTcpInfo(connection_->ioHandle().fd());
+  if (!tcp_info.has_value()) {
+    // The socket can not be sampled, and will not be at the next interval either.
+    return;
+  }
+
+  // There is no round trip time measured until the handshake completed.
+  const uint64_t rtt_us = tcp_info->rtt_.count();
+  if (rtt_us != 0) {
+    host_->cluster().stats().upstream_cx_rtt_us_.recordValue(rtt_us);
+    // The gauge is updated from the workers without a lock. Concurrent samples of the connections
+    // to the host may overwrite each other, which only loses one of them.
+    Stats::Gauge& host_rtt = host_->stats().cx_rtt_us_;
+    host_rtt.set(smoothRtt(host_rtt.value(), rtt_us));
+  }
+
+  if (tcp_info->total_retransmits_ > total_retransmits_) {
+    const uint32_t retransmits = tcp_info->total_retransmits_ - total_retransmits_;
+    host_->cluster().stats().upstream_cx_retransmits_.add(retransmits);
+    host_->stats().cx_retransmits_.add(retransmits);
+    total_retransmits_ = tcp_info->total_retransmits_;
+  }
+
+  sample_timer_->enableTimer(interval_);
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/network/connection.h"
+#include "envoy/network/filter.h"
+#include "envoy/upstream/host_description.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Samples the TCP state of an upstream connection at a fixed interval, recording the round trip
+ * time and the retransmissions into the stats of its cluster and host. It is installed as a read
+ * filter, which lets all the data through, so that it lives as long as the connection.
+ *
+ * The smoothed round trip time of the host, in its cx_rtt_us gauge, is the exponentially weighted
+ * moving average of the samples of all its connections, with the gain of RFC 6298.
+ */
+class TcpInfoSampler : public Network::ReadFilter, public Network::ConnectionCallbacks {
+public:
+  TcpInfoSampler(Event::Dispatcher& dispatcher, HostDescriptionConstSharedPtr host,
+                 std::chrono::milliseconds interval);
+
+  /**
+   * Adds a sampler to a connection to the given host if the cluster of the host samples the TCP
+   * state of its upstream connections.
+   */
+  static void addToConnection(Network::Connection& connection, HostDescriptionConstSharedPtr host);
+
+  /**
+   * @return the smoothed round trip time updated with a new sample, or the sample if there is no
+   *         smoothed round trip time yet.
+   */
+  static uint64_t smoothRtt(uint64_t smoothed_rtt_us, uint64_t sample_rtt_us);
+
+  // Network::ReadFilter
+  Network::FilterStatus onData(Buffer::Instance&, bool) override {
+    return Network::FilterStatus::Continue;
+  }
+  Network::FilterStatus onNewConnection() override { return Network::FilterStatus::Continue; }
+  void initializeReadFilterCallbacks(Network::ReadFilterCallbacks& callbacks) override;
+
+  // Network::ConnectionCallbacks
+  void onEvent(Network::ConnectionEvent event) override;
+  void onAboveWriteBufferHighWatermark() override {}
+  void onBelowWriteBufferLowWatermark() override {}
+
+private:
+  void onSampleTimer();
+
+  const HostDescriptionConstSharedPtr host_;
+  const std::chrono::milliseconds interval_;
+  Event::TimerPtr sample_timer_;
+  Network::Connection* connection_{};
+  // The total retransmits of the connection at the last sample, which the stats are counted from.
+  uint32_t total_retransmits_{};
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -1,5 +1,6 @@
 #include "common/upstream/thread_aware_lb_impl.h"
 
+#include <cmath>
 #include <memory>
 
 namespace Envoy {
@@ -109,6 +110,10 @@ void ThreadAwareLoadBalancerBase::refresh() {
                      min_normalized_weight, max_normalized_weight);
     per_priority_state->current_lb_ =
         createLoadBalancer(normalized_host_weights, min_normalized_weight, max_normalized_weight);
+    if (hash_balance_factor_ > 0) {
+      per_priority_state->current_lb_ = std::make_shared<BoundedLoadHashingLoadBalancer>(
+          per_priority_state->current_lb_, normalized_host_weights, hash_balance_factor_, stats_);
+    }
   }
 
   {
@@ -142,7 +147,47 @@ ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* c
   if (per_priority_state->global_panic_) {
     stats_.lb_healthy_panic_.inc();
   }
-  return per_priority_state->current_lb_->chooseHost(h);
+  return per_priority_state->current_lb_->chooseHost(h, 0);
+}
+
+ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::BoundedLoadHashingLoadBalancer(
+    HashingLoadBalancerSharedPtr hashing_lb,
+    const NormalizedHostWeightVector& normalized_host_weights, uint32_t hash_balance_factor,
+    ClusterStats& stats)
+    : hashing_lb_(std::move(hashing_lb)), hash_balance_factor_(hash_balance_factor / 100.0),
+      stats_(stats) {
+  ASSERT(hash_balance_factor >= 100);
+  for (const auto& host_weight : normalized_host_weights) {
+    normalized_host_weights_.emplace(host_weight.first.get(), host_weight.second);
+  }
+}
+
+HostConstSharedPtr
+ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t hash,
+                                                                        uint32_t attempt) const {
+  // Try as many hosts as there are, in the order of the hashing load balancer, and fall back to
+  // the first one if none of those tried has room. The walk may visit a host more than once, e.g.
+  // when it has several entries in a row on a ring.
+  const uint64_t total_active_rq = stats_.upstream_rq_active_.value() + 1;
+  HostConstSharedPtr first_host;
+  for (uint32_t i = 0; i < normalized_host_weights_.size(); ++i) {
+    HostConstSharedPtr host = hashing_lb_->chooseHost(hash, attempt + i);
+    if (host == nullptr || !overloaded(*host, total_active_rq)) {
+      return host;
+    }
+    if (first_host == nullptr) {
+      first_host = std::move(host);
+    }
+  }
+  return first_host;
+}
+
+bool ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::overloaded(
+    const Host& host, uint64_t total_active_rq) const {
+  const auto weight = normalized_host_weights_.find(&host);
+  ASSERT(weight != normalized_host_weights_.end());
+  const double bound = std::ceil(total_active_rq * hash_balance_factor_ * weight->second);
+  return host.stats().rq_active_.value() + 1 > bound;
 }
 
 LoadBalancerPtr ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::create() {
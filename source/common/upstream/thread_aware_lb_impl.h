@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unordered_map>
+
 #include "common/upstream/load_balancer_impl.h"
 
 #include "absl/synchronization/mutex.h"
@@ -22,7 +24,16 @@ public:
   class HashingLoadBalancer {
   public:
     virtual ~HashingLoadBalancer() = default;
-    virtual HostConstSharedPtr chooseHost(uint64_t hash) const PURE;
+
+    /**
+     * @param hash supplies the hash of the request.
+     * @param attempt supplies the number of hosts already tried for the request. Each attempt
+     *                moves on to the host after the previous attempt's, e.g. the next entry
+     *                around the ring, so that a request can be handed past hosts which are too
+     *                loaded.
+     * @return the host to use.
+     */
+    virtual HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const PURE;
   };
   using HashingLoadBalancerSharedPtr = std::shared_ptr<HashingLoadBalancer>;
 
@@ -40,9 +51,39 @@ protected:
                               Runtime::Loader& runtime, Runtime::RandomGenerator& random,
                               const envoy::api::v2::Cluster::CommonLbConfig& common_config)
       : LoadBalancerBase(priority_set, stats, runtime, random, common_config),
-        factory_(new LoadBalancerFactoryImpl(stats, random)) {}
+        factory_(new LoadBalancerFactoryImpl(stats, random)),
+        hash_balance_factor_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+            common_config.consistent_hashing_lb_config(), hash_balance_factor, 0)) {}
 
 private:
+  /**
+   * Consistent hashing with bounded loads, as described in https://arxiv.org/abs/1608.01350. A
+   * host whose active requests would exceed its weighted share of the cluster's active requests,
+   * times the balance factor, is passed over for the next host of the hashing load balancer. The
+   * loads are read from the hosts' and cluster's stats, so that they are shared by the workers
+   * without locking.
+   */
+  class BoundedLoadHashingLoadBalancer : public HashingLoadBalancer {
+  public:
+    BoundedLoadHashingLoadBalancer(HashingLoadBalancerSharedPtr hashing_lb,
+                                   const NormalizedHostWeightVector& normalized_host_weights,
+                                   uint32_t hash_balance_factor, ClusterStats& stats);
+
+    // ThreadAwareLoadBalancerBase::HashingLoadBalancer
+    HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
+
+  private:
+    // @return whether the host would be loaded beyond its bound by one more request, given the
+    //         active requests of the cluster including the new one.
+    bool overloaded(const Host& host, uint64_t total_active_rq) const;
+
+    const HashingLoadBalancerSharedPtr hashing_lb_;
+    std::unordered_map<const Host*, double> normalized_host_weights_;
+    const double hash_balance_factor_;
+    ClusterStats& stats_;
+  };
+
+
   struct PerPriorityState {
     std::shared_ptr<HashingLoadBalancer> current_lb_;
     bool global_panic_{};
@@ -85,6 +126,9 @@ private:
   void refresh();
 
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
+  // The percentage of its share of the load a host may take before it is passed over, or 0 if
+  // loads are not bounded.
+  const uint32_t hash_balance_factor_;
 };
 
 } // namespace Upstream
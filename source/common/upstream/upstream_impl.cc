@@ -21,11 +21,15 @@
 
 #include "common/common/enum_to_int.h"
 #include "common/common/fmt.h"
+#include "common/common/hash.h"
+#include "common/common/interner.h"
+#include "common/common/macros.h"
 #include "common/common/utility.h"
 #include "common/config/protocol_json.h"
 #include "common/config/utility.h"
 #include "common/http/utility.h"
 #include "common/network/address_impl.h"
+#include "common/network/happy_eyeballs_connection_impl.h"
 #include "common/network/resolver_impl.h"
 #include "common/network/socket_option_factory.h"
 #include "common/protobuf/protobuf.h"
@@ -34,6 +38,7 @@
 #include "common/upstream/health_checker_impl.h"
 #include "common/upstream/logical_dns_cluster.h"
 #include "common/upstream/original_dst_cluster.h"
+#include "common/upstream/tcp_info_sampler.h"
 
 #include "server/transport_socket_config_impl.h"
 
@@ -43,6 +48,9 @@ namespace Envoy {
 namespace Upstream {
 namespace {
 
+constexpr double DefaultRetryBudgetPercent = 20;
+constexpr uint32_t DefaultMinRetryConcurrency = 3;
+
 const Network::Address::InstanceConstSharedPtr
 getSourceAddress(const envoy::api::v2::Cluster& cluster,
                  const envoy::api::v2::core::BindConfig& bind_config) {
@@ -70,6 +78,9 @@ uint64_t parseFeatures(const envoy::api::v2::Cluster& config) {
   if (config.close_connections_on_host_health_failure()) {
     features |= ClusterInfoImpl::Features::CLOSE_CONNECTIONS_ON_HOST_HEALTH_FAILURE;
   }
+  if (config.share_http2_connections_across_workers()) {
+    features |= ClusterInfoImpl::Features::SHARE_HTTP2_CONNECTIONS_ACROSS_WORKERS;
+  }
   return features;
 }
 
@@ -214,13 +225,157 @@ HostVector filterHosts(const std::unordered_set<HostSharedPtr>& hosts,
   return net_hosts;
 }
 
+// The interned values shared by the hosts of all clusters. @see HostDescriptionImpl.
+Interner<const Network::Address::Instance>& addressInterner() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(Interner<const Network::Address::Instance>);
+}
+
+Interner<const SharedLocality>& localityInterner() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(Interner<const SharedLocality>);
+}
+
+Interner<envoy::api::v2::core::Metadata>& metadataInterner() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(Interner<envoy::api::v2::core::Metadata>);
+}
+
+Interner<const HostStatNames>& hostStatNamesInterner() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(Interner<const HostStatNames>);
+}
+
+std::atomic<uint64_t>& liveHosts() { MUTABLE_CONSTRUCT_ON_FIRST_USE(std::atomic<uint64_t>, 0); }
+
+std::atomic<uint64_t>& liveHostsWithStats() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(std::atomic<uint64_t>, 0);
+}
+
+Network::Address::InstanceConstSharedPtr
+internAddress(const Network::Address::InstanceConstSharedPtr& address) {
+  const std::string& address_string = address->asString();
+  return addressInterner().intern(
+      HashUtil::xxHash64(address_string),
+      [&address, &address_string](const Network::Address::Instance& interned) -> bool {
+        return interned.type() == address->type() && interned.asString() == address_string;
+      },
+      [&address]() -> Network::Address::InstanceConstSharedPtr { return address; });
+}
+
+SharedLocalityConstSharedPtr internLocality(const envoy::api::v2::core::Locality& locality,
+                                            Stats::SymbolTable& symbol_table) {
+  // The zone stat name belongs to a symbol table, so localities are only shared within one.
+  return localityInterner().intern(
+      LocalityHash()(locality),
+      [&locality, &symbol_table](const SharedLocality& interned) -> bool {
+        return &interned.zone_stat_name_.constSymbolTable() == &symbol_table &&
+               LocalityEqualTo()(interned.locality_, locality);
+      },
+      [&locality, &symbol_table]() -> SharedLocalityConstSharedPtr {
+        return std::make_shared<const SharedLocality>(locality, symbol_table);
+      });
+}
+
+HostStatNamesConstSharedPtr hostStatNames(Stats::SymbolTable& symbol_table) {
+  return hostStatNamesInterner().intern(
+      reinterpret_cast<uintptr_t>(&symbol_table),
+      [&symbol_table](const HostStatNames& interned) -> bool {
+        return &interned.symbolTable() == &symbol_table;
+      },
+      [&symbol_table]() -> HostStatNamesConstSharedPtr {
+        return std::make_shared<const HostStatNames>(symbol_table);
+      });
+}
+
+std::shared_ptr<envoy::api::v2::core::Metadata>
+internMetadata(const envoy::api::v2::core::Metadata& metadata) {
+  return metadataInterner().intern(
+      MessageUtil::hash(metadata),
+      [&metadata](const envoy::api::v2::core::Metadata& interned) -> bool {
+        return Protobuf::util::MessageDifferencer::Equivalent(interned, metadata);
+      },
+      [&metadata]() -> std::shared_ptr<envoy::api::v2::core::Metadata> {
+        return std::make_shared<envoy::api::v2::core::Metadata>(metadata);
+      });
+}
+
 } // namespace
 
+HostDescriptionImpl::HostDescriptionImpl(
+    ClusterInfoConstSharedPtr cluster, const std::string& hostname,
+    Network::Address::InstanceConstSharedPtr dest_address,
+    const envoy::api::v2::core::Metadata& metadata, const envoy::api::v2::core::Locality& locality,
+    const envoy::api::v2::endpoint::Endpoint::HealthCheckConfig& health_check_config,
+    uint32_t priority)
+    : cluster_(cluster), hostname_(hostname), address_(internAddress(dest_address)),
+      canary_(Config::Metadata::metadataValue(metadata, Config::MetadataFilters::get().ENVOY_LB,
+                                              Config::MetadataEnvoyLbKeys::get().CANARY)
+                  .bool_value()),
+      metadata_(internMetadata(metadata)),
+      locality_(internLocality(locality, cluster->statsScope().symbolTable())),
+      priority_(priority) {
+  if (health_check_config.port_value() != 0 &&
+      dest_address->type() != Network::Address::Type::Ip) {
+    // Setting the health check port to non-0 only works for IP-type addresses. Setting the port
+    // for a pipe address is a misconfiguration. Throw an exception.
+    throw EnvoyException(
+        fmt::format("Invalid host configuration: non-zero port for non-IP address"));
+  }
+  health_check_address_ = health_check_config.port_value() == 0
+                              ? address_
+                              : internAddress(Network::Utility::getAddressWithPort(
+                                    *dest_address, health_check_config.port_value()));
+  liveHosts()++;
+}
+
+HostDescriptionImpl::~HostDescriptionImpl() {
+  liveHosts()--;
+  if (stats_allocated_) {
+    liveHostsWithStats()--;
+  }
+}
+
+void HostDescriptionImpl::metadata(const envoy::api::v2::core::Metadata& new_metadata) {
+  std::shared_ptr<envoy::api::v2::core::Metadata> interned_metadata = internMetadata(new_metadata);
+  absl::WriterMutexLock lock(&metadata_mutex_);
+  metadata_ = std::move(interned_metadata);
+}
+
+HostStatsBlock& HostDescriptionImpl::statsBlock() const {
+  absl::call_once(stats_once_, [this]() -> void {
+    stats_block_ = new HostStatsBlock(hostStatNames(cluster_->statsScope().symbolTable()));
+    stats_allocated_ = true;
+    liveHostsWithStats()++;
+  });
+  return *stats_block_;
+}
+
+HostStatsBlockSharedPtr HostDescriptionImpl::statsBlockIfAllocated() const {
+  if (stats_allocated_) {
+    return stats_block_;
+  }
+  return new HostStatsBlock(hostStatNames(cluster_->statsScope().symbolTable()));
+}
+
+HostMemoryStats HostDescriptionImpl::memoryStats() {
+  HostMemoryStats stats;
+  stats.hosts_ = liveHosts();
+  stats.hosts_with_stats_ = liveHostsWithStats();
+  addressInterner().iterate(
+      [&stats](const Network::Address::Instance&) -> void { stats.unique_addresses_++; });
+  localityInterner().iterate(
+      [&stats](const SharedLocality&) -> void { stats.unique_localities_++; });
+  metadataInterner().iterate([&stats](const envoy::api::v2::core::Metadata& metadata) -> void {
+    stats.unique_metadata_++;
+    stats.unique_metadata_bytes_ += metadata.SpaceUsedLong();
+  });
+  return stats;
+}
+
 Host::CreateConnectionData HostImpl::createConnection(
     Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
     Network::TransportSocketOptionsSharedPtr transport_socket_options) const {
-  return {createConnection(dispatcher, *cluster_, address_, options, transport_socket_options),
-          shared_from_this()};
+  Network::ClientConnectionPtr connection =
+      createConnection(dispatcher, *cluster_, address_, options, transport_socket_options);
+  TcpInfoSampler::addToConnection(*connection, shared_from_this());
+  return {std::move(connection), shared_from_this()};
 }
 
 void HostImpl::setEdsHealthFlag(envoy::api::v2::core::HealthStatus health_status) {
@@ -247,29 +402,63 @@ HostImpl::createHealthCheckConnection(Event::Dispatcher& dispatcher) const {
           shared_from_this()};
 }
 
+namespace {
+
+Network::ConnectionSocket::OptionsSharedPtr
+combineConnectionSocketOptions(const ClusterInfo& cluster,
+                               const Network::ConnectionSocket::OptionsSharedPtr& options) {
+  if (cluster.clusterSocketOptions() == nullptr) {
+    return options;
+  }
+  if (!options) {
+    return cluster.clusterSocketOptions();
+  }
+  auto connection_options = std::make_shared<Network::ConnectionSocket::Options>();
+  *connection_options = *options;
+  std::copy(cluster.clusterSocketOptions()->begin(), cluster.clusterSocketOptions()->end(),
+            std::back_inserter(*connection_options));
+  return connection_options;
+}
+
+} // namespace
+
 Network::ClientConnectionPtr
 HostImpl::createConnection(Event::Dispatcher& dispatcher, const ClusterInfo& cluster,
                            Network::Address::InstanceConstSharedPtr address,
                            const Network::ConnectionSocket::OptionsSharedPtr& options,
                            Network::TransportSocketOptionsSharedPtr transport_socket_options) {
-  Network::ConnectionSocket::OptionsSharedPtr connection_options;
-  if (cluster.clusterSocketOptions() != nullptr) {
-    if (options) {
-      connection_options = std::make_shared<Network::ConnectionSocket::Options>();
-      *connection_options = *options;
-      std::copy(cluster.clusterSocketOptions()->begin(), cluster.clusterSocketOptions()->end(),
-                std::back_inserter(*connection_options));
-    } else {
-      connection_options = cluster.clusterSocketOptions();
-    }
-  } else {
-    connection_options = options;
-  }
-
   Network::ClientConnectionPtr connection = dispatcher.createClientConnection(
       address, cluster.sourceAddress(),
       cluster.transportSocketFactory().createTransportSocket(transport_socket_options),
-      connection_options);
+      combineConnectionSocketOptions(cluster, options));
+  connection->setBufferLimits(cluster.perConnectionBufferLimitBytes());
+  cluster.createNetworkFilterChain(*connection);
+  return connection;
+}
+
+Network::ClientConnectionPtr HostImpl::createConnection(
+    Event::Dispatcher& dispatcher, const ClusterInfo& cluster,
+    const std::vector<Network::Address::InstanceConstSharedPtr>& address_list,
+    const Network::ConnectionSocket::OptionsSharedPtr& options,
+    Network::TransportSocketOptionsSharedPtr transport_socket_options) {
+  if (address_list.size() == 1) {
+    return createConnection(dispatcher, cluster, address_list.front(), options,
+                            transport_socket_options);
+  }
+
+  // The attempts are only created while the connection is connecting, which the cluster outlives
+  // as the connection pools hold on to the host.
+  Network::ConnectionSocket::OptionsSharedPtr connection_options =
+      combineConnectionSocketOptions(cluster, options);
+  Network::ClientConnectionPtr connection = std::make_unique<Network::HappyEyeballsConnectionImpl>(
+      dispatcher, address_list,
+      [&dispatcher, &cluster, connection_options,
+       transport_socket_options](const Network::Address::InstanceConstSharedPtr& address) {
+        return dispatcher.createClientConnection(
+            address, cluster.sourceAddress(),
+            cluster.transportSocketFactory().createTransportSocket(transport_socket_options),
+            connection_options);
+      });
   connection->setBufferLimits(cluster.perConnectionBufferLimitBytes());
   cluster.createNetworkFilterChain(*connection);
   return connection;
@@ -593,6 +782,10 @@ ClusterInfoImpl::ClusterInfoImpl(
     : runtime_(runtime), name_(config.name()), type_(config.type()),
       max_requests_per_connection_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_requests_per_connection, 0)),
+      max_http2_connections_per_host_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_http2_connections_per_host, 1)),
+      per_upstream_preconnect_ratio_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config.preconnect_policy(), per_upstream_preconnect_ratio, 1.0)),
       connect_timeout_(
           std::chrono::milliseconds(PROTOBUF_GET_MS_REQUIRED(config, connect_timeout))),
       per_connection_buffer_limit_bytes_(
@@ -674,6 +867,10 @@ ClusterInfoImpl::ClusterInfoImpl(
     idle_timeout_ = std::chrono::milliseconds(
         DurationUtil::durationToMilliseconds(config.common_http_protocol_options().idle_timeout()));
   }
+  if (config.upstream_connection_options().has_tcp_info_sample_interval()) {
+    tcp_info_sample_interval_ = std::chrono::milliseconds(DurationUtil::durationToMilliseconds(
+        config.upstream_connection_options().tcp_info_sample_interval()));
+  }
   if (config.has_eds_cluster_config()) {
     if (config.type() != envoy::api::v2::Cluster::EDS) {
       throw EnvoyException("eds_cluster_config set in a non-EDS cluster");
@@ -963,10 +1160,12 @@ ClusterInfoImpl::generateCircuitBreakersStats(Stats::Scope& scope, const std::st
                                               bool track_remaining) {
   std::string prefix(fmt::format("circuit_breakers.{}.", stat_prefix));
   if (track_remaining) {
-    return {ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(POOL_GAUGE_PREFIX(scope, prefix),
+    return {ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                               POOL_GAUGE_PREFIX(scope, prefix),
                                                POOL_GAUGE_PREFIX(scope, prefix))};
   } else {
-    return {ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(POOL_GAUGE_PREFIX(scope, prefix),
+    return {ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                               POOL_GAUGE_PREFIX(scope, prefix),
                                                NULL_POOL_GAUGE(scope))};
   }
 }
@@ -981,6 +1180,8 @@ ClusterInfoImpl::ResourceManagers::load(const envoy::api::v2::Cluster& config,
   uint64_t max_requests = 1024;
   uint64_t max_retries = 3;
   uint64_t max_connection_pools = std::numeric_limits<uint64_t>::max();
+  absl::optional<double> retry_budget_percent;
+  uint32_t min_retry_concurrency = 0;
 
   bool track_remaining = false;
 
@@ -1014,11 +1215,20 @@ ClusterInfoImpl::ResourceManagers::load(const envoy::api::v2::Cluster& config,
     track_remaining = it->track_remaining();
     max_connection_pools =
         PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_connection_pools, max_connection_pools);
+    if (it->has_retry_budget()) {
+      const auto& retry_budget = it->retry_budget();
+      retry_budget_percent = retry_budget.has_budget_percent()
+                                 ? retry_budget.budget_percent().value()
+                                 : DefaultRetryBudgetPercent;
+      min_retry_concurrency = PROTOBUF_GET_WRAPPED_OR_DEFAULT(retry_budget, min_retry_concurrency,
+                                                              DefaultMinRetryConcurrency);
+    }
   }
   return std::make_unique<ResourceManagerImpl>(
       runtime, runtime_prefix, max_connections, max_pending_requests, max_requests, max_retries,
       max_connection_pools,
-      ClusterInfoImpl::generateCircuitBreakersStats(stats_scope, priority_name, track_remaining));
+      ClusterInfoImpl::generateCircuitBreakersStats(stats_scope, priority_name, track_remaining),
+      retry_budget_percent, min_retry_concurrency);
 }
 
 PriorityStateManager::PriorityStateManager(ClusterImplBase& cluster,
@@ -1348,6 +1558,8 @@ getDnsLookupFamilyFromEnum(envoy::api::v2::Cluster::DnsLookupFamily family) {
     return Network::DnsLookupFamily::V4Only;
   case envoy::api::v2::Cluster::AUTO:
     return Network::DnsLookupFamily::Auto;
+  case envoy::api::v2::Cluster::ALL:
+    return Network::DnsLookupFamily::All;
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
@@ -39,10 +39,12 @@
 #include "common/init/manager_impl.h"
 #include "common/network/utility.h"
 #include "common/stats/isolated_store_impl.h"
+#include "common/upstream/host_stats_impl.h"
 #include "common/upstream/load_balancer_impl.h"
 #include "common/upstream/outlier_detection_impl.h"
 #include "common/upstream/resource_manager_impl.h"
 
+#include "absl/base/call_once.h"
 #include "absl/synchronization/mutex.h"
 
 namespace Envoy {
@@ -57,8 +59,37 @@ public:
   void setUnhealthy() override {}
 };
 
+/**
+ * A locality shared by the hosts of the same locality, along with the stat name of its zone.
+ */
+struct SharedLocality {
+  SharedLocality(const envoy::api::v2::core::Locality& locality, Stats::SymbolTable& symbol_table)
+      : locality_(locality), zone_stat_name_(locality.zone(), symbol_table) {}
+
+  const envoy::api::v2::core::Locality locality_;
+  Stats::StatNameManagedStorage zone_stat_name_;
+};
+
+using SharedLocalityConstSharedPtr = std::shared_ptr<const SharedLocality>;
+
+/**
+ * Process-wide accounting of the memory held by hosts. @see HostDescriptionImpl::memoryStats().
+ */
+struct HostMemoryStats {
+  uint64_t hosts_{};
+  uint64_t hosts_with_stats_{};
+  uint64_t unique_addresses_{};
+  uint64_t unique_localities_{};
+  uint64_t unique_metadata_{};
+  uint64_t unique_metadata_bytes_{};
+};
+
 /**
  * Implementation of Upstream::HostDescription.
+ *
+ * As a cluster may have hundreds of thousands of hosts, hosts are kept compact: the addresses,
+ * localities and metadata of hosts are interned process-wide, so that duplicates share a single
+ * object, and the stats of a host are only allocated once they are first used.
  */
 class HostDescriptionImpl : virtual public HostDescription {
 public:
@@ -68,27 +99,8 @@ public:
       const envoy::api::v2::core::Metadata& metadata,
       const envoy::api::v2::core::Locality& locality,
       const envoy::api::v2::endpoint::Endpoint::HealthCheckConfig& health_check_config,
-      uint32_t priority)
-      : cluster_(cluster), hostname_(hostname), address_(dest_address),
-        canary_(Config::Metadata::metadataValue(metadata, Config::MetadataFilters::get().ENVOY_LB,
-                                                Config::MetadataEnvoyLbKeys::get().CANARY)
-                    .bool_value()),
-        metadata_(std::make_shared<envoy::api::v2::core::Metadata>(metadata)), locality_(locality),
-        locality_zone_stat_name_(locality.zone(), cluster->statsScope().symbolTable()),
-        stats_{ALL_HOST_STATS(POOL_COUNTER(stats_store_), POOL_GAUGE(stats_store_))},
-        priority_(priority) {
-    if (health_check_config.port_value() != 0 &&
-        dest_address->type() != Network::Address::Type::Ip) {
-      // Setting the health check port to non-0 only works for IP-type addresses. Setting the port
-      // for a pipe address is a misconfiguration. Throw an exception.
-      throw EnvoyException(
-          fmt::format("Invalid host configuration: non-zero port for non-IP address"));
-    }
-    health_check_address_ =
-        health_check_config.port_value() == 0
-            ? dest_address
-            : Network::Utility::getAddressWithPort(*dest_address, health_check_config.port_value());
-  }
+      uint32_t priority);
+  ~HostDescriptionImpl() override;
 
   // Upstream::HostDescription
   bool canary() const override { return canary_; }
@@ -103,14 +115,13 @@ public:
   //
   // TODO(rgs1): we should move to absl locks, once there's support for R/W locks. We should
   // also add lock annotations, once they work correctly with R/W locks.
+  //
+  // The metadata is interned, and thus shared with other hosts: it must not be modified in place.
   const std::shared_ptr<envoy::api::v2::core::Metadata> metadata() const override {
     absl::ReaderMutexLock lock(&metadata_mutex_);
     return metadata_;
   }
-  void metadata(const envoy::api::v2::core::Metadata& new_metadata) override {
-    absl::WriterMutexLock lock(&metadata_mutex_);
-    metadata_ = std::make_shared<envoy::api::v2::core::Metadata>(new_metadata);
-  }
+  void metadata(const envoy::api::v2::core::Metadata& new_metadata) override;
 
   const ClusterInfo& cluster() const override { return *cluster_; }
   HealthCheckHostMonitor& healthChecker() const override {
@@ -131,20 +142,30 @@ public:
       return *null_outlier_detector;
     }
   }
-  const HostStats& stats() const override { return stats_; }
+  const HostStats& stats() const override { return statsBlock().stats(); }
   const std::string& hostname() const override { return hostname_; }
   Network::Address::InstanceConstSharedPtr address() const override { return address_; }
   Network::Address::InstanceConstSharedPtr healthCheckAddress() const override {
     return health_check_address_;
   }
-  const envoy::api::v2::core::Locality& locality() const override { return locality_; }
+  const envoy::api::v2::core::Locality& locality() const override { return locality_->locality_; }
   Stats::StatName localityZoneStatName() const override {
-    return locality_zone_stat_name_.statName();
+    return locality_->zone_stat_name_.statName();
   }
   uint32_t priority() const override { return priority_; }
   void priority(uint32_t priority) override { priority_ = priority; }
 
+  /**
+   * @return the memory held by the hosts of all clusters.
+   */
+  static HostMemoryStats memoryStats();
+
 protected:
+  HostStatsBlock& statsBlock() const;
+  // The stats of the host if they are allocated, or else a transient block of zero stats, which
+  // is freed along with the counters or gauges handed out from it.
+  HostStatsBlockSharedPtr statsBlockIfAllocated() const;
+
   ClusterInfoConstSharedPtr cluster_;
   const std::string hostname_;
   Network::Address::InstanceConstSharedPtr address_;
@@ -152,10 +173,10 @@ protected:
   std::atomic<bool> canary_;
   mutable absl::Mutex metadata_mutex_;
   std::shared_ptr<envoy::api::v2::core::Metadata> metadata_ GUARDED_BY(metadata_mutex_);
-  const envoy::api::v2::core::Locality locality_;
-  Stats::StatNameManagedStorage locality_zone_stat_name_;
-  Stats::IsolatedStoreImpl stats_store_;
-  HostStats stats_;
+  const SharedLocalityConstSharedPtr locality_;
+  mutable absl::once_flag stats_once_;
+  mutable HostStatsBlockSharedPtr stats_block_;
+  mutable std::atomic<bool> stats_allocated_{};
   Outlier::DetectorHostMonitorPtr outlier_detector_;
   HealthCheckHostMonitorPtr health_checker_;
   std::atomic<uint32_t> priority_;
@@ -182,12 +203,16 @@ public:
   }
 
   // Upstream::Host
-  std::vector<Stats::CounterSharedPtr> counters() const override { return stats_store_.counters(); }
+  std::vector<Stats::CounterSharedPtr> counters() const override {
+    return statsBlockIfAllocated()->counters();
+  }
   CreateConnectionData createConnection(
       Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
       Network::TransportSocketOptionsSharedPtr transport_socket_options) const override;
   CreateConnectionData createHealthCheckConnection(Event::Dispatcher& dispatcher) const override;
-  std::vector<Stats::GaugeSharedPtr> gauges() const override { return stats_store_.gauges(); }
+  std::vector<Stats::GaugeSharedPtr> gauges() const override {
+    return statsBlockIfAllocated()->gauges();
+  }
   void healthFlagClear(HealthFlag flag) override { health_flags_ &= ~enumToInt(flag); }
   bool healthFlagGet(HealthFlag flag) const override { return health_flags_ & enumToInt(flag); }
   void healthFlagSet(HealthFlag flag) override { health_flags_ |= enumToInt(flag); }
@@ -236,6 +261,16 @@ protected:
                    const Network::ConnectionSocket::OptionsSharedPtr& options,
                    Network::TransportSocketOptionsSharedPtr transport_socket_options);
 
+  /**
+   * Creates a connection to a host resolved to several addresses, which races connection attempts
+   * across them. @see Network::HappyEyeballsConnectionImpl.
+   */
+  static Network::ClientConnectionPtr
+  createConnection(Event::Dispatcher& dispatcher, const ClusterInfo& cluster,
+                   const std::vector<Network::Address::InstanceConstSharedPtr>& address_list,
+                   const Network::ConnectionSocket::OptionsSharedPtr& options,
+                   Network::TransportSocketOptionsSharedPtr transport_socket_options);
+
 private:
   void setEdsHealthFlag(envoy::api::v2::core::HealthStatus health_status);
 
@@ -528,6 +563,9 @@ public:
   const absl::optional<std::chrono::milliseconds> idleTimeout() const override {
     return idle_timeout_;
   }
+  const absl::optional<std::chrono::milliseconds> tcpInfoSampleInterval() const override {
+    return tcp_info_sample_interval_;
+  }
   uint32_t perConnectionBufferLimitBytes() const override {
     return per_connection_buffer_limit_bytes_;
   }
@@ -554,6 +592,8 @@ public:
   }
   bool maintenanceMode() const override;
   uint64_t maxRequestsPerConnection() const override { return max_requests_per_connection_; }
+  uint32_t maxHttp2ConnectionsPerHost() const override { return max_http2_connections_per_host_; }
+  double perUpstreamPreconnectRatio() const override { return per_upstream_preconnect_ratio_; }
   const std::string& name() const override { return name_; }
   ResourceManager& resourceManager(ResourcePriority priority) const override;
   Network::TransportSocketFactory& transportSocketFactory() const override {
@@ -597,8 +637,11 @@ private:
   const std::string name_;
   const envoy::api::v2::Cluster::DiscoveryType type_;
   const uint64_t max_requests_per_connection_;
+  const uint32_t max_http2_connections_per_host_;
+  const double per_upstream_preconnect_ratio_;
   const std::chrono::milliseconds connect_timeout_;
   absl::optional<std::chrono::milliseconds> idle_timeout_;
+  absl::optional<std::chrono::milliseconds> tcp_info_sample_interval_;
   const uint32_t per_connection_buffer_limit_bytes_;
   Network::TransportSocketFactoryPtr transport_socket_factory_;
   Stats::ScopePtr stats_scope_;
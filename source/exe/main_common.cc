@@ -117,12 +117,14 @@ void MainCommonBase::adminRequest(absl::string_view path_and_query, absl::string
                                   const AdminRequestFn& handler) {
   std::string path_and_query_buf = std::string(path_and_query);
   std::string method_buf = std::string(method);
-  server_->dispatcher().post([this, path_and_query_buf, method_buf, handler]() {
-    Http::HeaderMapImpl response_headers;
-    std::string body;
-    server_->admin().request(path_and_query_buf, method_buf, response_headers, body);
-    handler(response_headers, body);
-  });
+  server_->dispatcher().post(
+      [this, path_and_query_buf, method_buf, handler]() {
+        Http::HeaderMapImpl response_headers;
+        std::string body;
+        server_->admin().request(path_and_query_buf, method_buf, response_headers, body);
+        handler(response_headers, body);
+      },
+      Event::PostPriority::Admin);
 }
 
 MainCommon::MainCommon(int argc, const char* const* argv)
@@ -5,6 +5,8 @@ namespace Extensions {
 namespace AccessLoggers {
 namespace File {
 
+thread_local std::string FileAccessLog::log_line_;
+
 FileAccessLog::FileAccessLog(const std::string& access_log_path, AccessLog::FilterPtr&& filter,
                              AccessLog::FormatterPtr&& formatter,
                              AccessLog::AccessLogManager& log_manager)
@@ -16,8 +18,10 @@ void FileAccessLog::emitLog(const Http::HeaderMap& request_headers,
                             const Http::HeaderMap& response_headers,
                             const Http::HeaderMap& response_trailers,
                             const StreamInfo::StreamInfo& stream_info) {
-  log_file_->write(
-      formatter_->format(request_headers, response_headers, response_trailers, stream_info));
+  log_line_.clear();
+  formatter_->formatInto(request_headers, response_headers, response_trailers, stream_info,
+                         log_line_);
+  log_file_->write(log_line_);
 }
 
 } // namespace File
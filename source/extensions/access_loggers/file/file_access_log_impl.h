@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include "extensions/access_loggers/common/access_log_base.h"
 
 namespace Envoy {
@@ -23,6 +25,9 @@ private:
 
   AccessLog::AccessLogFileSharedPtr log_file_;
   AccessLog::FormatterPtr formatter_;
+  // Use static thread_local to reuse the capacity of the line across the logs of a worker, rather
+  // than allocating a string per line.
+  static thread_local std::string log_line_;
 };
 
 } // namespace File
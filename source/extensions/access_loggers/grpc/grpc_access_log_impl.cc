@@ -25,8 +25,11 @@ GrpcAccessLoggerImpl::GrpcAccessLoggerImpl(Grpc::RawAsyncClientPtr&& client, std
                                            std::chrono::milliseconds buffer_flush_interval_msec,
                                            uint64_t buffer_size_bytes,
                                            Event::Dispatcher& dispatcher,
-                                           const LocalInfo::LocalInfo& local_info)
-    : client_(std::move(client)), log_name_(log_name),
+                                           const LocalInfo::LocalInfo& local_info,
+                                           Stats::Scope& scope)
+    : stats_({ALL_GRPC_ACCESS_LOGGER_STATS(
+          POOL_COUNTER_PREFIX(scope, "access_logs.grpc_access_log."))}),
+      client_(std::move(client)), log_name_(log_name),
       buffer_flush_interval_msec_(buffer_flush_interval_msec),
       flush_timer_(dispatcher.createTimer([this]() {
         flush();
@@ -37,6 +40,9 @@ GrpcAccessLoggerImpl::GrpcAccessLoggerImpl(Grpc::RawAsyncClientPtr&& client, std
 }
 
 void GrpcAccessLoggerImpl::log(envoy::data::accesslog::v2::HTTPAccessLogEntry&& entry) {
+  if (!canLogMore()) {
+    return;
+  }
   approximate_message_size_bytes_ += entry.ByteSizeLong();
   message_.mutable_http_logs()->add_log_entry()->Swap(&entry);
   if (approximate_message_size_bytes_ >= buffer_size_bytes_) {
@@ -44,6 +50,23 @@ void GrpcAccessLoggerImpl::log(envoy::data::accesslog::v2::HTTPAccessLogEntry&&
   }
 }
 
+bool GrpcAccessLoggerImpl::canLogMore() {
+  if (!message_.has_http_logs() || approximate_message_size_bytes_ < buffer_size_bytes_) {
+    stats_.logs_written_.inc();
+    return true;
+  }
+  // A full batch is still buffered, so the last flush was held back by the stream being above its
+  // high watermark. Retry it, and drop the entry if the stream is still backed up, rather than
+  // buffering without bound.
+  flush();
+  if (!message_.has_http_logs()) {
+    stats_.logs_written_.inc();
+    return true;
+  }
+  stats_.logs_dropped_.inc();
+  return false;
+}
+
 void GrpcAccessLoggerImpl::flush() {
   if (!message_.has_http_logs()) {
     // Nothing to flush.
@@ -66,6 +89,10 @@ void GrpcAccessLoggerImpl::flush() {
   }
 
   if (stream_->stream_ != nullptr) {
+    if (stream_->stream_->isAboveWriteBufferHighWatermark()) {
+      // Keep the batch buffered until the stream drains, it is retried by the next flush.
+      return;
+    }
     stream_->stream_->sendMessage(message_, false);
   } else {
     // Clear out the stream data due to stream creation failure.
@@ -103,7 +130,7 @@ GrpcAccessLoggerSharedPtr GrpcAccessLoggerCacheImpl::getOrCreateLogger(
       factory->create(), config.log_name(),
       std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, buffer_flush_interval, 1000)),
       PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384), cache.dispatcher_,
-      local_info_);
+      local_info_, scope_);
   cache.access_loggers_.emplace(cache_key, logger);
   return logger;
 }
@@ -10,6 +10,8 @@
 #include "envoy/local_info/local_info.h"
 #include "envoy/service/accesslog/v2/als.pb.h"
 #include "envoy/singleton/instance.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/grpc/typed_async_client.h"
@@ -21,7 +23,19 @@ namespace Extensions {
 namespace AccessLoggers {
 namespace GrpcCommon {
 
-// TODO(mattklein123): Stats
+/**
+ * All stats for the gRPC access loggers. @see stats_macros.h
+ */
+#define ALL_GRPC_ACCESS_LOGGER_STATS(COUNTER)                                                      \
+  COUNTER(logs_written)                                                                            \
+  COUNTER(logs_dropped)
+
+/**
+ * Wrapper struct for gRPC access logger stats. @see stats_macros.h
+ */
+struct GrpcAccessLoggerStats {
+  ALL_GRPC_ACCESS_LOGGER_STATS(GENERATE_COUNTER_STRUCT)
+};
 
 /**
  * Interface for an access logger. The logger provides abstraction on top of gRPC stream, deals with
@@ -64,7 +78,7 @@ public:
   GrpcAccessLoggerImpl(Grpc::RawAsyncClientPtr&& client, std::string log_name,
                        std::chrono::milliseconds buffer_flush_interval_msec,
                        uint64_t buffer_size_bytes, Event::Dispatcher& dispatcher,
-                       const LocalInfo::LocalInfo& local_info);
+                       const LocalInfo::LocalInfo& local_info, Stats::Scope& scope);
 
   void log(envoy::data::accesslog::v2::HTTPAccessLogEntry&& entry) override;
 
@@ -86,7 +100,9 @@ private:
   };
 
   void flush();
+  bool canLogMore();
 
+  GrpcAccessLoggerStats stats_;
   Grpc::AsyncClient<envoy::service::accesslog::v2::StreamAccessLogsMessage,
                     envoy::service::accesslog::v2::StreamAccessLogsResponse>
       client_;
@@ -1,15 +1,41 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "envoy/data/accesslog/v2/accesslog.pb.h"
+#include "envoy/http/header_map.h"
 #include "envoy/stream_info/stream_info.h"
 
+#include "common/protobuf/protobuf.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace AccessLoggers {
 namespace GrpcCommon {
 
+/**
+ * The headers and trailers an HTTP access log entry records in addition to the well known ones.
+ */
+struct HttpHeadersToLog {
+  HttpHeadersToLog(const Protobuf::RepeatedPtrField<std::string>& request_headers,
+                   const Protobuf::RepeatedPtrField<std::string>& response_headers,
+                   const Protobuf::RepeatedPtrField<std::string>& response_trailers);
+
+  std::vector<Http::LowerCaseString> request_headers_;
+  std::vector<Http::LowerCaseString> response_headers_;
+  std::vector<Http::LowerCaseString> response_trailers_;
+};
+
 class Utility {
 public:
+  static void extractHttpAccessLogEntry(envoy::data::accesslog::v2::HTTPAccessLogEntry& log_entry,
+                                        const HttpHeadersToLog& headers_to_log,
+                                        const Http::HeaderMap& request_headers,
+                                        const Http::HeaderMap& response_headers,
+                                        const Http::HeaderMap& response_trailers,
+                                        const StreamInfo::StreamInfo& stream_info);
+
   static void
   extractCommonAccessLogProperties(envoy::data::accesslog::v2::AccessLogCommon& common_access_log,
                                    const StreamInfo::StreamInfo& stream_info);
@@ -16,6 +16,7 @@
 
 #include "extensions/access_loggers/common/access_log_base.h"
 #include "extensions/access_loggers/grpc/grpc_access_log_impl.h"
+#include "extensions/access_loggers/grpc/grpc_access_log_utils.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -52,9 +53,7 @@ private:
   const envoy::config::accesslog::v2::HttpGrpcAccessLogConfig config_;
   const ThreadLocal::SlotPtr tls_slot_;
   const GrpcCommon::GrpcAccessLoggerCacheSharedPtr access_logger_cache_;
-  std::vector<Http::LowerCaseString> request_headers_to_log_;
-  std::vector<Http::LowerCaseString> response_headers_to_log_;
-  std::vector<Http::LowerCaseString> response_trailers_to_log_;
+  const GrpcCommon::HttpHeadersToLog headers_to_log_;
 };
 
 } // namespace HttpGrpc
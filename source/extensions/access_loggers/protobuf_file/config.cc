@@ -0,0 +1,46 @@
+#include "extensions/access_loggers/protobuf_file/config.h"
+
+#include <memory>
+
+#include "envoy/config/accesslog/v2/protobuf_file.pb.validate.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/filter_config.h"
+
+#include "common/protobuf/protobuf.h"
+
+#include "extensions/access_loggers/protobuf_file/protobuf_file_access_log_impl.h"
+#include "extensions/access_loggers/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace ProtobufFile {
+
+AccessLog::InstanceSharedPtr HttpProtobufFileAccessLogFactory::createAccessLogInstance(
+    const Protobuf::Message& config, AccessLog::FilterPtr&& filter,
+    Server::Configuration::FactoryContext& context) {
+  const auto& proto_config = MessageUtil::downcastAndValidate<
+      const envoy::config::accesslog::v2::HttpProtobufFileAccessLogConfig&>(config);
+
+  return std::make_shared<HttpProtobufFileAccessLog>(std::move(filter), proto_config,
+                                                     context.accessLogManager());
+}
+
+ProtobufTypes::MessagePtr HttpProtobufFileAccessLogFactory::createEmptyConfigProto() {
+  return ProtobufTypes::MessagePtr{
+      new envoy::config::accesslog::v2::HttpProtobufFileAccessLogConfig()};
+}
+
+std::string HttpProtobufFileAccessLogFactory::name() const {
+  return AccessLogNames::get().HttpProtobufFile;
+}
+
+/**
+ * Static registration for the HTTP protobuf file access log. @see RegisterFactory.
+ */
+REGISTER_FACTORY(HttpProtobufFileAccessLogFactory, Server::Configuration::AccessLogInstanceFactory);
+
+} // namespace ProtobufFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
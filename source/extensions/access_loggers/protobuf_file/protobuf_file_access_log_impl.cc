@@ -0,0 +1,48 @@
+#include "extensions/access_loggers/protobuf_file/protobuf_file_access_log_impl.h"
+
+#include "common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace ProtobufFile {
+
+thread_local std::string HttpProtobufFileAccessLog::record_;
+
+HttpProtobufFileAccessLog::HttpProtobufFileAccessLog(
+    AccessLog::FilterPtr&& filter,
+    const envoy::config::accesslog::v2::HttpProtobufFileAccessLogConfig& config,
+    AccessLog::AccessLogManager& log_manager)
+    : ImplBase(std::move(filter)), log_file_(log_manager.createAccessLog(config.path())),
+      headers_to_log_(config.additional_request_headers_to_log(),
+                      config.additional_response_headers_to_log(),
+                      config.additional_response_trailers_to_log()) {}
+
+void HttpProtobufFileAccessLog::appendDelimited(
+    const envoy::data::accesslog::v2::HTTPAccessLogEntry& entry, std::string& output) {
+  const uint32_t size = static_cast<uint32_t>(entry.ByteSizeLong());
+  const size_t offset = output.size();
+  output.resize(offset + Protobuf::io::CodedOutputStream::VarintSize32(size) + size);
+  uint8_t* target = reinterpret_cast<uint8_t*>(&output[offset]);
+  target = Protobuf::io::CodedOutputStream::WriteVarint32ToArray(size, target);
+  // ByteSizeLong() above cached the sizes of the nested messages.
+  entry.SerializeWithCachedSizesToArray(target);
+}
+
+void HttpProtobufFileAccessLog::emitLog(const Http::HeaderMap& request_headers,
+                                        const Http::HeaderMap& response_headers,
+                                        const Http::HeaderMap& response_trailers,
+                                        const StreamInfo::StreamInfo& stream_info) {
+  envoy::data::accesslog::v2::HTTPAccessLogEntry log_entry;
+  GrpcCommon::Utility::extractHttpAccessLogEntry(log_entry, headers_to_log_, request_headers,
+                                                 response_headers, response_trailers, stream_info);
+
+  record_.clear();
+  appendDelimited(log_entry, record_);
+  log_file_->write(record_);
+}
+
+} // namespace ProtobufFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/config/accesslog/v2/protobuf_file.pb.h"
+#include "envoy/data/accesslog/v2/accesslog.pb.h"
+
+#include "extensions/access_loggers/common/access_log_base.h"
+#include "extensions/access_loggers/grpc/grpc_access_log_utils.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace ProtobufFile {
+
+/**
+ * Access log Instance that writes HTTP logs to a file as length-delimited HTTPAccessLogEntry
+ * protos, i.e. each serialized entry preceded by its size as a varint.
+ */
+class HttpProtobufFileAccessLog : public Common::ImplBase {
+public:
+  HttpProtobufFileAccessLog(
+      AccessLog::FilterPtr&& filter,
+      const envoy::config::accesslog::v2::HttpProtobufFileAccessLogConfig& config,
+      AccessLog::AccessLogManager& log_manager);
+
+  /**
+   * Append an entry to a buffer in the length-delimited encoding.
+   * @param entry supplies the entry to serialize.
+   * @param output supplies the buffer to append to.
+   */
+  static void appendDelimited(const envoy::data::accesslog::v2::HTTPAccessLogEntry& entry,
+                              std::string& output);
+
+private:
+  // Common::ImplBase
+  void emitLog(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+               const Http::HeaderMap& response_trailers,
+               const StreamInfo::StreamInfo& stream_info) override;
+
+  AccessLog::AccessLogFileSharedPtr log_file_;
+  const GrpcCommon::HttpHeadersToLog headers_to_log_;
+  // Use static thread_local to reuse the capacity of the record across the logs of a worker, as
+  // the file access log does.
+  static thread_local std::string record_;
+};
+
+} // namespace ProtobufFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
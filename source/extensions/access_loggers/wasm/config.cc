@@ -9,6 +9,7 @@
 #include "common/access_log/access_log_formatter.h"
 #include "common/common/logger.h"
 #include "common/protobuf/protobuf.h"
+#include "common/protobuf/utility.h"
 
 #include "extensions/access_loggers/wasm/wasm_access_log_impl.h"
 #include "extensions/access_loggers/well_known_names.h"
@@ -30,6 +31,7 @@ WasmAccessLogFactory::createAccessLogInstance(const Protobuf::Message& proto_con
   auto root_id = config.root_id();
   auto configuration = std::make_shared<std::string>(config.configuration());
   auto tls_slot = context.threadLocal().allocateSlot();
+  std::function<std::shared_ptr<Common::Wasm::Wasm>(Event::Dispatcher&)> thread_local_wasm;
   if (config.has_vm_config()) {
     // Create a base WASM to verify that the code loads before setting/cloning the for the
     // individual threads.
@@ -38,22 +40,44 @@ WasmAccessLogFactory::createAccessLogInstance(const Protobuf::Message& proto_con
         context.api(), context.scope(),
         Common::Wasm::pluginDirectionFromTrafficDirection(context.direction()), context.localInfo(),
         &context.listenerMetadata(), nullptr /* owned_scope */);
-    // NB: the Slot set() call doesn't complete inline, so all arguments must outlive this call.
-    tls_slot->set([base_wasm, root_id, configuration](Event::Dispatcher& dispatcher) {
-      auto result =
-          Common::Wasm::createThreadLocalWasm(*base_wasm, root_id, *configuration, dispatcher);
-      return std::static_pointer_cast<ThreadLocal::ThreadLocalObject>(result);
-    });
+    thread_local_wasm = [base_wasm, root_id, configuration](Event::Dispatcher& dispatcher) {
+      return Common::Wasm::createThreadLocalWasm(*base_wasm, root_id, *configuration, dispatcher);
+    };
   } else {
     if (vm_id.empty()) {
       throw Common::Wasm::WasmVmException("No WASM VM Id or vm_config specified");
     }
-    tls_slot->set([vm_id, root_id, configuration](Event::Dispatcher&) {
-      auto result = Common::Wasm::getThreadLocalWasm(vm_id, root_id, *configuration);
-      return std::static_pointer_cast<ThreadLocal::ThreadLocalObject>(result);
-    });
+    thread_local_wasm = [vm_id, root_id, configuration](Event::Dispatcher&) {
+      return Common::Wasm::getThreadLocalWasm(vm_id, root_id, *configuration);
+    };
   }
-  return std::make_shared<WasmAccessLog>(root_id, std::move(tls_slot), std::move(filter));
+
+  LogRecordFormatterConstSharedPtr record_formatter;
+  uint32_t max_records = 0;
+  std::chrono::milliseconds flush_interval{};
+  if (config.has_batching()) {
+    record_formatter = std::make_shared<LogRecordFormatter>(config.batching().fields());
+    max_records = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.batching(), max_records, 100);
+    flush_interval = std::chrono::milliseconds(
+        PROTOBUF_GET_MS_OR_DEFAULT(config.batching(), flush_interval, 1000));
+  }
+
+  // NB: the Slot set() call doesn't complete inline, so all arguments must outlive this call.
+  tls_slot->set([thread_local_wasm, root_id, max_records,
+                 flush_interval](Event::Dispatcher& dispatcher) {
+    std::shared_ptr<Common::Wasm::Wasm> wasm = thread_local_wasm(dispatcher);
+    LogBatchPtr batch;
+    if (max_records > 0) {
+      Common::Wasm::Wasm* batch_wasm = wasm.get();
+      batch = std::make_unique<LogBatch>(dispatcher, max_records, flush_interval,
+                                         [batch_wasm, root_id](absl::string_view records) {
+                                           batch_wasm->logBatch(root_id, records);
+                                         });
+    }
+    return std::make_shared<ThreadLocalWasmLog>(std::move(wasm), std::move(batch));
+  });
+  return std::make_shared<WasmAccessLog>(root_id, std::move(tls_slot), std::move(filter),
+                                         std::move(record_formatter));
 }
 
 ProtobufTypes::MessagePtr WasmAccessLogFactory::createEmptyConfigProto() {
@@ -0,0 +1,95 @@
+#include "extensions/access_loggers/wasm/log_batch.h"
+
+#include <algorithm>
+
+#include "common/access_log/access_log_formatter.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Wasm {
+
+namespace {
+
+void appendUint32(std::string& output, uint32_t value) {
+  output.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+LogRecordFormatter::LogRecordFormatter(const Protobuf::Map<std::string, std::string>& fields) {
+  for (const auto& field : fields) {
+    fields_.emplace_back(field.first, std::make_unique<AccessLog::FormatterImpl>(field.second));
+  }
+  std::sort(fields_.begin(), fields_.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+}
+
+std::string LogRecordFormatter::format(const Http::HeaderMap& request_headers,
+                                       const Http::HeaderMap& response_headers,
+                                       const Http::HeaderMap& response_trailers,
+                                       const StreamInfo::StreamInfo& stream_info) const {
+  std::vector<std::string> values;
+  values.reserve(fields_.size());
+  size_t size = sizeof(uint32_t) + fields_.size() * 2 * sizeof(uint32_t);
+  for (const auto& field : fields_) {
+    values.push_back(
+        field.second->format(request_headers, response_headers, response_trailers, stream_info));
+    size += field.first.size() + values.back().size() + 2;
+  }
+
+  std::string record;
+  record.reserve(size);
+  appendUint32(record, fields_.size());
+  for (size_t i = 0; i < fields_.size(); i++) {
+    appendUint32(record, fields_[i].first.size());
+    appendUint32(record, values[i].size());
+  }
+  for (size_t i = 0; i < fields_.size(); i++) {
+    record.append(fields_[i].first);
+    record.push_back('\0');
+    record.append(values[i]);
+    record.push_back('\0');
+  }
+  return record;
+}
+
+LogBatch::LogBatch(Event::Dispatcher& dispatcher, uint32_t max_records,
+                   std::chrono::milliseconds flush_interval, FlushCb flush_cb)
+    : max_records_(max_records), flush_interval_(flush_interval), flush_cb_(std::move(flush_cb)),
+      flush_timer_(dispatcher.createTimer([this]() -> void { flush(); })) {
+  records_.reserve(max_records_);
+}
+
+void LogBatch::add(std::string&& record) {
+  records_.push_back(std::move(record));
+  if (records_.size() >= max_records_) {
+    flush();
+  } else if (records_.size() == 1) {
+    flush_timer_->enableTimer(flush_interval_);
+  }
+}
+
+void LogBatch::flush() {
+  if (records_.empty()) {
+    return;
+  }
+  flush_timer_->disableTimer();
+
+  serialized_.clear();
+  appendUint32(serialized_, records_.size());
+  for (const std::string& record : records_) {
+    appendUint32(serialized_, record.size());
+  }
+  for (const std::string& record : records_) {
+    serialized_.append(record);
+    serialized_.push_back('\0');
+  }
+  records_.clear();
+  flush_cb_(serialized_);
+}
+
+} // namespace Wasm
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
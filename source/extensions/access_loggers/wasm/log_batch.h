@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+
+#include "common/protobuf/protobuf.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Wasm {
+
+/**
+ * Formats the fields declared by a batching Wasm access log into a record. The record is serialized
+ * as the pairs read by WasmData::pairs() in the plugin: the number of fields, the size of each name
+ * and value, then each name and value followed by a null character.
+ */
+class LogRecordFormatter {
+public:
+  /**
+   * @param fields supplies the name and the format string of each field.
+   */
+  explicit LogRecordFormatter(const Protobuf::Map<std::string, std::string>& fields);
+
+  std::string format(const Http::HeaderMap& request_headers,
+                     const Http::HeaderMap& response_headers,
+                     const Http::HeaderMap& response_trailers,
+                     const StreamInfo::StreamInfo& stream_info) const;
+
+private:
+  // Sorted by name, so the fields of the records are in a stable order.
+  std::vector<std::pair<std::string, AccessLog::FormatterPtr>> fields_;
+};
+
+using LogRecordFormatterConstSharedPtr = std::shared_ptr<const LogRecordFormatter>;
+
+/**
+ * The log records of a thread, delivered in one call when the batch reaches its maximum number of
+ * records or when the flush interval has elapsed since the first record of the batch was added. The
+ * records are serialized as the list read by WasmData::list() in the plugin: the number of records,
+ * the size of each record, then each record followed by a null character.
+ */
+class LogBatch {
+public:
+  using FlushCb = std::function<void(absl::string_view records)>;
+
+  LogBatch(Event::Dispatcher& dispatcher, uint32_t max_records,
+           std::chrono::milliseconds flush_interval, FlushCb flush_cb);
+
+  /**
+   * Add a record to the batch, delivering the batch if it is full.
+   * @param record supplies the serialized record.
+   */
+  void add(std::string&& record);
+
+  /**
+   * Deliver the records of the batch, if any.
+   */
+  void flush();
+
+private:
+  const uint32_t max_records_;
+  const std::chrono::milliseconds flush_interval_;
+  const FlushCb flush_cb_;
+  const Event::TimerPtr flush_timer_;
+  std::vector<std::string> records_;
+  // Reused across the batches, as their sizes are similar.
+  std::string serialized_;
+};
+
+using LogBatchPtr = std::unique_ptr<LogBatch>;
+
+} // namespace Wasm
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -1,9 +1,13 @@
 #pragma once
 
 #include "envoy/access_log/access_log.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/common/logger.h"
+#include "common/http/header_map_impl.h"
+#include "common/singleton/const_singleton.h"
 
+#include "extensions/access_loggers/wasm/log_batch.h"
 #include "extensions/access_loggers/well_known_names.h"
 #include "extensions/common/wasm/wasm.h"
 
@@ -12,11 +16,24 @@ namespace Extensions {
 namespace AccessLoggers {
 namespace Wasm {
 
+/**
+ * The Wasm of a thread, and the batch of its log records when the records are delivered in batches.
+ */
+struct ThreadLocalWasmLog : public ThreadLocal::ThreadLocalObject {
+  ThreadLocalWasmLog(std::shared_ptr<Common::Wasm::Wasm> wasm, LogBatchPtr batch)
+      : wasm_(std::move(wasm)), batch_(std::move(batch)) {}
+
+  // Declared before batch_, which delivers its records to it.
+  const std::shared_ptr<Common::Wasm::Wasm> wasm_;
+  const LogBatchPtr batch_;
+};
+
 class WasmAccessLog : public AccessLog::Instance {
 public:
   WasmAccessLog(absl::string_view root_id, ThreadLocal::SlotPtr tls_slot,
-                AccessLog::FilterPtr filter)
-      : root_id_(root_id), tls_slot_(std::move(tls_slot)), filter_(std::move(filter)) {}
+                AccessLog::FilterPtr filter, LogRecordFormatterConstSharedPtr record_formatter)
+      : root_id_(root_id), tls_slot_(std::move(tls_slot)), filter_(std::move(filter)),
+        record_formatter_(std::move(record_formatter)) {}
   void log(const Http::HeaderMap* request_headers, const Http::HeaderMap* response_headers,
            const Http::HeaderMap* response_trailers,
            const StreamInfo::StreamInfo& stream_info) override {
@@ -26,14 +43,24 @@ public:
         return;
       }
     }
-    tls_slot_->getTyped<Common::Wasm::Wasm>().log(root_id_, request_headers, response_headers,
-                                                  response_trailers, stream_info);
+    auto& thread_local_log = tls_slot_->getTyped<ThreadLocalWasmLog>();
+    if (record_formatter_ != nullptr) {
+      const Http::HeaderMap& empty_headers = ConstSingleton<Http::HeaderMapImpl>::get();
+      thread_local_log.batch_->add(record_formatter_->format(
+          request_headers ? *request_headers : empty_headers,
+          response_headers ? *response_headers : empty_headers,
+          response_trailers ? *response_trailers : empty_headers, stream_info));
+      return;
+    }
+    thread_local_log.wasm_->log(root_id_, request_headers, response_headers, response_trailers,
+                                stream_info);
   }
 
 private:
   std::string root_id_;
   ThreadLocal::SlotPtr tls_slot_;
   AccessLog::FilterPtr filter_;
+  const LogRecordFormatterConstSharedPtr record_formatter_;
 };
 
 } // namespace Wasm
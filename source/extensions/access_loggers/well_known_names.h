@@ -18,6 +18,8 @@ public:
   const std::string File = "envoy.file_access_log";
   // HTTP gRPC access log
   const std::string HttpGrpc = "envoy.http_grpc_access_log";
+  // HTTP protobuf file access log
+  const std::string HttpProtobufFile = "envoy.access_loggers.http_protobuf_file";
   // WASM access log
   const std::string Wasm = "envoy.wasm_access_log";
 };
@@ -1,5 +1,6 @@
 #include "extensions/clusters/dynamic_forward_proxy/cluster.h"
 
+#include "common/common/hash.h"
 #include "common/network/transport_socket_options_impl.h"
 
 #include "extensions/common/dynamic_forward_proxy/dns_cache_manager_impl.h"
@@ -14,14 +15,13 @@ Cluster::Cluster(
     const envoy::config::cluster::dynamic_forward_proxy::v2alpha::ClusterConfig& config,
     Runtime::Loader& runtime,
     Extensions::Common::DynamicForwardProxy::DnsCacheManagerFactory& cache_manager_factory,
-    const LocalInfo::LocalInfo& local_info,
     Server::Configuration::TransportSocketFactoryContext& factory_context,
     Stats::ScopePtr&& stats_scope, bool added_via_api)
     : Upstream::BaseDynamicClusterImpl(cluster, runtime, factory_context, std::move(stats_scope),
                                        added_via_api),
       dns_cache_manager_(cache_manager_factory.get()),
       dns_cache_(dns_cache_manager_->getCache(config.dns_cache_config())),
-      update_callbacks_handle_(dns_cache_->addUpdateCallbacks(*this)), local_info_(local_info),
+      update_callbacks_handle_(dns_cache_->addUpdateCallbacks(*this)),
       host_map_(std::make_shared<HostInfoMap>()) {
   // TODO(mattklein123): Technically, we should support attaching to an already warmed DNS cache.
   //                     This will require adding a hosts() or similar API to the cache and
@@ -54,8 +54,8 @@ void Cluster::onDnsHostAddOrUpdate(
   // connection/request circuit breakers is sufficient. We may have to revisit this in the future.
 
   HostInfoMapSharedPtr current_map = getCurrentHostMap();
-  const auto host_map_it = current_map->find(host);
-  if (host_map_it != current_map->end()) {
+  const HostInfo* existing_host = current_map->find(host);
+  if (existing_host != nullptr) {
     // If we only have an address change, we can do that swap inline without any other updates.
     // The appropriate R/W locking is in place to allow this. The details of this locking are:
     //  - Hosts are not thread local, they are global.
@@ -72,11 +72,10 @@ void Cluster::onDnsHostAddOrUpdate(
     //                     semantics, meaning the cache would expose multiple addresses and the
     //                     cluster would create multiple logical hosts based on those addresses.
     //                     We will leave this is a follow up depending on need.
-    ASSERT(host_info == host_map_it->second.shared_host_info_);
-    ASSERT(host_map_it->second.shared_host_info_->address() !=
-           host_map_it->second.logical_host_->address());
+    ASSERT(host_info == existing_host->shared_host_info_);
+    ASSERT(existing_host->shared_host_info_->address() != existing_host->logical_host_->address());
     ENVOY_LOG(debug, "updating dfproxy cluster host address '{}'", host);
-    host_map_it->second.logical_host_->setNewAddress(host_info->address(), dummy_lb_endpoint_);
+    existing_host->logical_host_->setNewAddresses(host_info->addressList(), dummy_lb_endpoint_);
     return;
   }
 
@@ -89,21 +88,30 @@ void Cluster::onDnsHostAddOrUpdate(
           !host_info->isIpAddress() ? host_info->resolvedHost() : "",
           std::vector<std::string>{host_info->resolvedHost()});
 
+  auto logical_host = std::make_shared<Upstream::LogicalHost>(
+      info(), host, host_info->address(), dummy_locality_lb_endpoint_, dummy_lb_endpoint_,
+      transport_socket_options);
+  logical_host->setNewAddresses(host_info->addressList(), dummy_lb_endpoint_);
+
   const auto new_host_map = std::make_shared<HostInfoMap>(*current_map);
-  const auto emplaced =
-      new_host_map->try_emplace(host, host_info,
-                                std::make_shared<Upstream::LogicalHost>(
-                                    info(), host, host_info->address(), dummy_locality_lb_endpoint_,
-                                    dummy_lb_endpoint_, transport_socket_options));
+  auto new_shard = std::make_shared<HostInfoMapShard>(*new_host_map->shard(host));
+  const auto emplaced = new_shard->try_emplace(host, host_info, std::move(logical_host));
   Upstream::HostVector hosts_added;
   hosts_added.emplace_back(emplaced.first->second.logical_host_);
+  new_host_map->shard(host) = std::move(new_shard);
+
+  // The hosts are appended to the current ones, rather than rebuilt from the map.
+  Upstream::HostVectorSharedPtr hosts =
+      std::make_shared<Upstream::HostVector>(prioritySet().hostSetsPerPriority()[0]->hosts());
+  hosts->emplace_back(hosts_added.front());
 
   // Swap in the new map. This will be picked up when the per-worker LBs are recreated via
   // the host set update.
-  swapAndUpdateMap(new_host_map, hosts_added, {});
+  swapAndUpdateMap(new_host_map, std::move(hosts), hosts_added, {});
 }
 
 void Cluster::swapAndUpdateMap(const HostInfoMapSharedPtr& new_hosts_map,
+                               Upstream::HostVectorSharedPtr&& hosts,
                                const Upstream::HostVector& hosts_added,
                                const Upstream::HostVector& hosts_removed) {
   {
@@ -111,30 +119,60 @@ void Cluster::swapAndUpdateMap(const HostInfoMapSharedPtr& new_hosts_map,
     host_map_ = new_hosts_map;
   }
 
-  Upstream::PriorityStateManager priority_state_manager(*this, local_info_, nullptr);
-  priority_state_manager.initializePriorityFor(dummy_locality_lb_endpoint_);
-  for (const auto& host : (*new_hosts_map)) {
-    priority_state_manager.registerHostForPriority(host.second.logical_host_,
-                                                   dummy_locality_lb_endpoint_);
-  }
-  priority_state_manager.updateClusterPrioritySet(
-      0, std::move(priority_state_manager.priorityState()[0].first), hosts_added, hosts_removed,
-      absl::nullopt, absl::nullopt);
+  // All the hosts share a single dummy locality, so they are not split per locality.
+  priority_set_.updateHosts(
+      0, Upstream::HostSetImpl::partitionHosts(hosts, Upstream::HostsPerLocalityImpl::empty()),
+      {}, hosts_added, hosts_removed, absl::nullopt);
 }
 
 void Cluster::onDnsHostRemove(const std::string& host) {
   HostInfoMapSharedPtr current_map = getCurrentHostMap();
-  const auto host_map_it = current_map->find(host);
-  ASSERT(host_map_it != current_map->end());
-  const auto new_host_map = std::make_shared<HostInfoMap>(*current_map);
+  const HostInfo* existing_host = current_map->find(host);
+  ASSERT(existing_host != nullptr);
   Upstream::HostVector hosts_removed;
-  hosts_removed.emplace_back(host_map_it->second.logical_host_);
-  new_host_map->erase(host);
+  hosts_removed.emplace_back(existing_host->logical_host_);
+
+  const auto new_host_map = std::make_shared<HostInfoMap>(*current_map);
+  auto new_shard = std::make_shared<HostInfoMapShard>(*new_host_map->shard(host));
+  new_shard->erase(host);
+  new_host_map->shard(host) = std::move(new_shard);
   ENVOY_LOG(debug, "removing dfproxy cluster host '{}'", host);
 
+  Upstream::HostVectorSharedPtr hosts = std::make_shared<Upstream::HostVector>();
+  const Upstream::HostVector& current_hosts = prioritySet().hostSetsPerPriority()[0]->hosts();
+  hosts->reserve(current_hosts.size() - 1);
+  for (const Upstream::HostSharedPtr& current_host : current_hosts) {
+    if (current_host != hosts_removed.front()) {
+      hosts->emplace_back(current_host);
+    }
+  }
+
   // Swap in the new map. This will be picked up when the per-worker LBs are recreated via
   // the host set update.
-  swapAndUpdateMap(new_host_map, {}, hosts_removed);
+  swapAndUpdateMap(new_host_map, std::move(hosts), {}, hosts_removed);
+}
+
+Cluster::HostInfoMap::HostInfoMap() {
+  // The empty shards of a new map are all the same.
+  const auto empty_shard = std::make_shared<const HostInfoMapShard>();
+  shards_.fill(empty_shard);
+}
+
+const Cluster::HostInfo* Cluster::HostInfoMap::find(absl::string_view host) const {
+  const HostInfoMapShard& host_shard = *shard(host);
+  const auto host_it = host_shard.find(host);
+  return host_it != host_shard.end() ? &host_it->second : nullptr;
+}
+
+const Cluster::HostInfoMapShardSharedPtr&
+Cluster::HostInfoMap::shard(absl::string_view host) const {
+  // The shards are picked with a hash other than that of the maps, so that the hosts of a shard
+  // do not share the bits used by the map to place them.
+  return shards_[HashUtil::xxHash64(host) % NumShards];
+}
+
+Cluster::HostInfoMapShardSharedPtr& Cluster::HostInfoMap::shard(absl::string_view host) {
+  return shards_[HashUtil::xxHash64(host) % NumShards];
 }
 
 Upstream::HostConstSharedPtr
@@ -143,13 +181,13 @@ Cluster::LoadBalancer::chooseHost(Upstream::LoadBalancerContext* context) {
     return nullptr;
   }
 
-  const auto host_it =
+  const HostInfo* host_info =
       host_map_->find(context->downstreamHeaders()->Host()->value().getStringView());
-  if (host_it == host_map_->end()) {
+  if (host_info == nullptr) {
     return nullptr;
   } else {
-    host_it->second.shared_host_info_->touch();
-    return host_it->second.logical_host_;
+    host_info->shared_host_info_->touch();
+    return host_info->logical_host_;
   }
 }
 
@@ -161,10 +199,11 @@ ClusterFactory::createClusterWithConfig(
     Server::Configuration::TransportSocketFactoryContext& socket_factory_context,
     Stats::ScopePtr&& stats_scope) {
   Extensions::Common::DynamicForwardProxy::DnsCacheManagerFactoryImpl cache_manager_factory(
-      context.singletonManager(), context.dispatcher(), context.tls(), context.stats());
+      context.singletonManager(), context.dispatcher(), context.clusterManager().dnsResolver(),
+      context.tls(), context.stats());
   auto new_cluster = std::make_shared<Cluster>(
-      cluster, proto_config, context.runtime(), cache_manager_factory, context.localInfo(),
-      socket_factory_context, std::move(stats_scope), context.addedViaApi());
+      cluster, proto_config, context.runtime(), cache_manager_factory, socket_factory_context,
+      std::move(stats_scope), context.addedViaApi());
   auto lb = std::make_unique<Cluster::ThreadAwareLoadBalancer>(*new_cluster);
   return std::make_pair(new_cluster, std::move(lb));
 }
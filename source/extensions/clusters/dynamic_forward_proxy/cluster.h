@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include "envoy/config/cluster/dynamic_forward_proxy/v2alpha/cluster.pb.h"
 #include "envoy/config/cluster/dynamic_forward_proxy/v2alpha/cluster.pb.validate.h"
 
@@ -21,7 +23,6 @@ public:
           const envoy::config::cluster::dynamic_forward_proxy::v2alpha::ClusterConfig& config,
           Runtime::Loader& runtime,
           Extensions::Common::DynamicForwardProxy::DnsCacheManagerFactory& cache_manager_factory,
-          const LocalInfo::LocalInfo& local_info,
           Server::Configuration::TransportSocketFactoryContext& factory_context,
           Stats::ScopePtr&& stats_scope, bool added_via_api);
 
@@ -52,7 +53,23 @@ private:
     const Upstream::LogicalHostSharedPtr logical_host_;
   };
 
-  using HostInfoMap = absl::flat_hash_map<std::string, HostInfo>;
+  using HostInfoMapShard = absl::flat_hash_map<std::string, HostInfo>;
+  using HostInfoMapShardSharedPtr = std::shared_ptr<const HostInfoMapShard>;
+
+  // The hosts are split into shards, which the maps share until they are modified, so that adding
+  // or removing a host only copies the hosts of its shard rather than all of them.
+  struct HostInfoMap {
+    static constexpr size_t NumShards = 256;
+
+    HostInfoMap();
+
+    const HostInfo* find(absl::string_view host) const;
+    const HostInfoMapShardSharedPtr& shard(absl::string_view host) const;
+    HostInfoMapShardSharedPtr& shard(absl::string_view host);
+
+    std::array<HostInfoMapShardSharedPtr, NumShards> shards_;
+  };
+
   using HostInfoMapSharedPtr = std::shared_ptr<const HostInfoMap>;
 
   struct LoadBalancer : public Upstream::LoadBalancer {
@@ -93,6 +110,7 @@ private:
   }
 
   void swapAndUpdateMap(const HostInfoMapSharedPtr& new_hosts_map,
+                        Upstream::HostVectorSharedPtr&& hosts,
                         const Upstream::HostVector& hosts_added,
                         const Upstream::HostVector& hosts_removed);
 
@@ -102,7 +120,6 @@ private:
       update_callbacks_handle_;
   const envoy::api::v2::endpoint::LocalityLbEndpoints dummy_locality_lb_endpoint_;
   const envoy::api::v2::endpoint::LbEndpoint dummy_lb_endpoint_;
-  const LocalInfo::LocalInfo& local_info_;
 
   absl::Mutex host_map_lock_;
   HostInfoMapSharedPtr host_map_ ABSL_GUARDED_BY(host_map_lock_);
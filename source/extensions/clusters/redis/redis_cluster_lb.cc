@@ -94,22 +94,47 @@ Upstream::LoadBalancerPtr RedisClusterLoadBalancerFactory::create() {
 }
 
 namespace {
-Upstream::HostConstSharedPtr chooseRandomHost(const Upstream::HostSetImpl& host_set,
-                                              Runtime::RandomGenerator& random) {
-  auto hosts = host_set.healthyHosts();
-  if (hosts.empty()) {
-    hosts = host_set.degradedHosts();
+bool acceptHost(const Upstream::Host& host, Upstream::LoadBalancerContext* context) {
+  return context == nullptr || !context->shouldSelectAnotherHost(host);
+}
+
+// Returns the host at the index, or the first following one accepted by the context.
+Upstream::HostConstSharedPtr acceptedHost(const Upstream::HostVector& hosts, uint64_t index,
+                                          Upstream::LoadBalancerContext* context) {
+  for (size_t i = 0; i < hosts.size(); i++) {
+    const Upstream::HostSharedPtr& host = hosts[(index + i) % hosts.size()];
+    if (acceptHost(*host, context)) {
+      return host;
+    }
   }
+  return nullptr;
+}
 
-  if (hosts.empty()) {
-    hosts = host_set.hosts();
+// Chooses among two random hosts the one with the fewest active requests, which steers the reads
+// away from the slower nodes. Healthy hosts have precedence over degraded hosts, which have
+// precedence over unhealthy hosts.
+Upstream::HostConstSharedPtr chooseLeastRequestHost(const Upstream::HostSetImpl& host_set,
+                                                    Runtime::RandomGenerator& random,
+                                                    Upstream::LoadBalancerContext* context) {
+  const Upstream::HostVector* hosts = &host_set.healthyHosts();
+  if (hosts->empty()) {
+    hosts = &host_set.degradedHosts();
   }
 
-  if (!hosts.empty()) {
-    return hosts[random.random() % hosts.size()];
-  } else {
+  if (hosts->empty()) {
+    hosts = &host_set.hosts();
+  }
+
+  if (hosts->empty()) {
     return nullptr;
   }
+
+  Upstream::HostConstSharedPtr first = acceptedHost(*hosts, random.random(), context);
+  if (first == nullptr || hosts->size() == 1) {
+    return first;
+  }
+  Upstream::HostConstSharedPtr second = acceptedHost(*hosts, random.random(), context);
+  return second->stats().rq_active_.value() < first->stats().rq_active_.value() ? second : first;
 }
 } // namespace
 
@@ -136,21 +161,25 @@ Upstream::HostConstSharedPtr RedisClusterLoadBalancerFactory::RedisClusterLoadBa
     case NetworkFilters::Common::Redis::Client::ReadPolicy::Master:
       return shard->master();
     case NetworkFilters::Common::Redis::Client::ReadPolicy::PreferMaster:
-      if (shard->master()->health() == Upstream::Host::Health::Healthy) {
+      if (shard->master()->health() == Upstream::Host::Health::Healthy &&
+          acceptHost(*shard->master(), context)) {
         return shard->master();
       } else {
-        return chooseRandomHost(shard->allHosts(), random_);
+        return chooseLeastRequestHost(shard->allHosts(), random_, context);
       }
     case NetworkFilters::Common::Redis::Client::ReadPolicy::Replica:
-      return chooseRandomHost(shard->replicas(), random_);
+      return chooseLeastRequestHost(shard->replicas(), random_, context);
     case NetworkFilters::Common::Redis::Client::ReadPolicy::PreferReplica:
       if (!shard->replicas().healthyHosts().empty()) {
-        return chooseRandomHost(shard->replicas(), random_);
-      } else {
-        return chooseRandomHost(shard->allHosts(), random_);
+        Upstream::HostConstSharedPtr replica =
+            chooseLeastRequestHost(shard->replicas(), random_, context);
+        if (replica != nullptr) {
+          return replica;
+        }
       }
+      return chooseLeastRequestHost(shard->allHosts(), random_, context);
     case NetworkFilters::Common::Redis::Client::ReadPolicy::Any:
-      return chooseRandomHost(shard->allHosts(), random_);
+      return chooseLeastRequestHost(shard->allHosts(), random_, context);
     }
   }
   return shard->master();
@@ -161,7 +190,7 @@ bool isReadRequest(const NetworkFilters::Common::Redis::RespValue& request) {
   if (request.type() != NetworkFilters::Common::Redis::RespType::Array) {
     return false;
   }
-  auto first = request.asArray()[0];
+  const auto& first = request.asArray()[0];
   if (first.type() != NetworkFilters::Common::Redis::RespType::SimpleString &&
       first.type() != NetworkFilters::Common::Redis::RespType::BulkString) {
     return false;
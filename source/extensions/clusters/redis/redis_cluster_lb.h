@@ -81,8 +81,15 @@ public:
     return read_policy_;
   }
 
+  /**
+   * @param v supplies a key.
+   * @param enabled supplies whether hashtagging is enabled.
+   * @return the part of the key that is hashed, its hashtag if it has one and hashtagging is
+   *         enabled, or else the whole key.
+   */
+  static absl::string_view hashtag(absl::string_view v, bool enabled);
+
 private:
-  absl::string_view hashtag(absl::string_view v, bool enabled);
 
   const absl::optional<uint64_t> hash_key_;
   const bool is_read_;
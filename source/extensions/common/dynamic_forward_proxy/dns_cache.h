@@ -1,7 +1,10 @@
 #pragma once
 
+#include <vector>
+
 #include "envoy/config/common/dynamic_forward_proxy/v2alpha/dns_cache.pb.h"
 #include "envoy/event/dispatcher.h"
+#include "envoy/network/dns.h"
 #include "envoy/singleton/manager.h"
 #include "envoy/thread_local/thread_local.h"
 
@@ -23,6 +26,13 @@ public:
    */
   virtual Network::Address::InstanceConstSharedPtr address() PURE;
 
+  /**
+   * Returns all the addresses resolved for the host when the cache resolves both address families,
+   * the first being address(), or only address() otherwise. Connections to the host race
+   * connection attempts across them.
+   */
+  virtual std::vector<Network::Address::InstanceConstSharedPtr> addressList() PURE;
+
   /**
    * Returns the host that was actually resolved via DNS. If port was originally specified it will
    * be stripped from this return value.
@@ -166,10 +176,12 @@ public:
 using DnsCacheManagerSharedPtr = std::shared_ptr<DnsCacheManager>;
 
 /**
- * Get the singleton cache manager for the entire server.
+ * Get the singleton cache manager for the entire server. Its caches resolve the hosts with the
+ * resolver, which is only used on the main thread.
  */
 DnsCacheManagerSharedPtr getCacheManager(Singleton::Manager& manager,
                                          Event::Dispatcher& main_thread_dispatcher,
+                                         Network::DnsResolverSharedPtr resolver,
                                          ThreadLocal::SlotAllocator& tls, Stats::Scope& root_scope);
 
 /**
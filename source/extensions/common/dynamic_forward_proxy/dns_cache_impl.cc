@@ -1,5 +1,8 @@
 #include "extensions/common/dynamic_forward_proxy/dns_cache_impl.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "common/network/utility.h"
 
 // TODO(mattklein123): Move DNS family helpers to a smaller include.
@@ -11,28 +14,22 @@ namespace Common {
 namespace DynamicForwardProxy {
 
 DnsCacheImpl::DnsCacheImpl(
-    Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls,
-    Stats::Scope& root_scope,
+    Event::Dispatcher& main_thread_dispatcher, Network::DnsResolverSharedPtr resolver,
+    ThreadLocal::SlotAllocator& tls, Stats::Scope& root_scope,
     const envoy::config::common::dynamic_forward_proxy::v2alpha::DnsCacheConfig& config)
     : main_thread_dispatcher_(main_thread_dispatcher),
       dns_lookup_family_(Upstream::getDnsLookupFamilyFromEnum(config.dns_lookup_family())),
-      resolver_(main_thread_dispatcher.createDnsResolver({})), tls_slot_(tls.allocateSlot()),
+      resolver_(std::move(resolver)), tls_slot_(tls.allocateSlot()),
       scope_(root_scope.createScope(fmt::format("dns_cache.{}.", config.name()))),
       stats_{ALL_DNS_CACHE_STATS(POOL_COUNTER(*scope_), POOL_GAUGE(*scope_))},
       refresh_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, dns_refresh_rate, 60000)),
       host_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, host_ttl, 300000)),
-      max_hosts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_hosts, 1024)) {
+      max_hosts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_hosts, 1024)),
+      evict_least_recently_used_hosts_(config.evict_least_recently_used_hosts()) {
   tls_slot_->set([](Event::Dispatcher&) { return std::make_shared<ThreadLocalHostInfo>(); });
-  updateTlsHostsMap();
 }
 
 DnsCacheImpl::~DnsCacheImpl() {
-  for (const auto& primary_host : primary_hosts_) {
-    if (primary_host.second->active_query_ != nullptr) {
-      primary_host.second->active_query_->cancel();
-    }
-  }
-
   for (auto update_callbacks : update_callbacks_) {
     update_callbacks->cancel();
   }
@@ -43,11 +40,11 @@ DnsCacheImpl::loadDnsCacheEntry(absl::string_view host, uint16_t default_port,
                                 LoadDnsCacheEntryCallbacks& callbacks) {
   ENVOY_LOG(debug, "thread local lookup for host '{}'", host);
   auto& tls_host_info = tls_slot_->getTyped<ThreadLocalHostInfo>();
-  auto tls_host = tls_host_info.host_map_->find(host);
-  if (tls_host != tls_host_info.host_map_->end()) {
+  auto tls_host = tls_host_info.host_map_.find(host);
+  if (tls_host != tls_host_info.host_map_.end()) {
     ENVOY_LOG(debug, "thread local hit for host '{}'", host);
     return {LoadDnsCacheEntryStatus::InCache, nullptr};
-  } else if (tls_host_info.host_map_->size() >= max_hosts_) {
+  } else if (!evict_least_recently_used_hosts_ && tls_host_info.host_map_.size() >= max_hosts_) {
     // Given that we do this check in thread local context, it's possible for two threads to race
     // and potentially go slightly above the configured max hosts. This is an OK given compromise
     // given how much simpler the implementation is.
@@ -79,6 +76,10 @@ void DnsCacheImpl::startCacheLoad(const std::string& host, uint16_t default_port
     return;
   }
 
+  if (evict_least_recently_used_hosts_ && primary_hosts_.size() >= max_hosts_) {
+    evictLeastRecentlyUsedHosts();
+  }
+
   // First try to see if there is a port included. This also checks to see that there is not a ']'
   // as the last character which is indicative of an IPv6 address without a port. This is a best
   // effort attempt.
@@ -142,9 +143,7 @@ void DnsCacheImpl::onReResolve(const std::string& host) {
             primary_host_it->second->host_info_->last_used_time_.load().count());
   if (now_duration - primary_host_it->second->host_info_->last_used_time_.load() > host_ttl_) {
     ENVOY_LOG(debug, "host='{}' TTL expired, removing", host);
-    runRemoveCallbacks(host);
-    primary_hosts_.erase(primary_host_it);
-    updateTlsHostsMap();
+    removeHost(host);
   } else {
     startResolve(host, *primary_host_it->second);
   }
@@ -174,10 +173,17 @@ void DnsCacheImpl::finishResolve(const std::string& host,
   const bool first_resolve = !primary_host_info.host_info_->first_resolve_complete_;
   primary_host_info.host_info_->first_resolve_complete_ = true;
 
-  const auto new_address = !response.empty()
-                               ? Network::Utility::getAddressWithPort(*(response.front().address_),
-                                                                      primary_host_info.port_)
-                               : nullptr;
+  // With both families resolved, connections race across all the addresses rather than using the
+  // first one.
+  std::vector<Network::Address::InstanceConstSharedPtr> new_address_list;
+  for (const auto& resolved : response) {
+    new_address_list.push_back(
+        Network::Utility::getAddressWithPort(*resolved.address_, primary_host_info.port_));
+    if (dns_lookup_family_ != Network::DnsLookupFamily::All) {
+      break;
+    }
+  }
+  const auto new_address = !new_address_list.empty() ? new_address_list.front() : nullptr;
 
   if (response.empty()) {
     stats_.dns_query_failure_.inc();
@@ -188,22 +194,26 @@ void DnsCacheImpl::finishResolve(const std::string& host,
   // Only the change the address if:
   // 1) The new address is valid &&
   // 2a) The host doesn't yet have an address ||
-  // 2b) The host has a changed address.
+  // 2b) The host has a changed address, or changed addresses when racing across them.
   //
   // This means that once a host gets an address it will stick even in the case of a subsequent
   // resolution failure.
-  bool address_changed = false;
-  if (new_address != nullptr && (primary_host_info.host_info_->address_ == nullptr ||
-                                 *primary_host_info.host_info_->address_ != *new_address)) {
+  const auto& current_address_list = primary_host_info.host_info_->address_list_;
+  if (new_address != nullptr &&
+      !std::equal(new_address_list.begin(), new_address_list.end(), current_address_list.begin(),
+                  current_address_list.end(),
+                  [](const auto& lhs, const auto& rhs) { return *lhs == *rhs; })) {
     ENVOY_LOG(debug, "host '{}' address has changed", host);
     primary_host_info.host_info_->address_ = new_address;
+    primary_host_info.host_info_->address_list_ = std::move(new_address_list);
     runAddUpdateCallbacks(host, primary_host_info.host_info_);
-    address_changed = true;
     stats_.host_address_changed_.inc();
   }
 
-  if (first_resolve || address_changed) {
-    updateTlsHostsMap();
+  // Address changes are seen by the threads through the shared host info, so they only need to
+  // learn about the host once.
+  if (first_resolve) {
+    postHostMapUpdate(host, primary_host_info.host_info_);
   }
 
   // Kick off the refresh timer.
@@ -225,18 +235,44 @@ void DnsCacheImpl::runRemoveCallbacks(const std::string& host) {
   }
 }
 
-void DnsCacheImpl::updateTlsHostsMap() {
-  TlsHostMapSharedPtr new_host_map = std::make_shared<TlsHostMap>();
+void DnsCacheImpl::postHostMapUpdate(const std::string& host,
+                                     const DnsHostInfoSharedPtr& host_info) {
+  tls_slot_->runOnAllThreads([this, host, host_info]() {
+    tls_slot_->getTyped<ThreadLocalHostInfo>().onHostMapUpdate(host, host_info);
+  });
+}
+
+void DnsCacheImpl::removeHost(const std::string& host) {
+  tls_slot_->runOnAllThreads([this, host]() {
+    tls_slot_->getTyped<ThreadLocalHostInfo>().onHostMapRemove(host);
+  });
+  runRemoveCallbacks(host);
+  primary_hosts_.erase(host);
+}
+
+void DnsCacheImpl::evictLeastRecentlyUsedHosts() {
+  // Finding the least recently used hosts takes a pass over all of them, so a batch of hosts is
+  // evicted at once for the pass to be amortized over the following additions. Hosts which have
+  // not resolved yet are kept, as threads may be waiting on them.
+  using Candidate = std::pair<std::chrono::steady_clock::duration, std::string>;
+  std::vector<Candidate> candidates;
+  candidates.reserve(primary_hosts_.size());
   for (const auto& primary_host : primary_hosts_) {
-    // Do not include hosts that have not resolved at least once.
     if (primary_host.second->host_info_->first_resolve_complete_) {
-      new_host_map->emplace(primary_host.first, primary_host.second->host_info_);
+      candidates.emplace_back(primary_host.second->host_info_->last_used_time_.load(),
+                              primary_host.first);
     }
   }
 
-  tls_slot_->runOnAllThreads([this, new_host_map]() {
-    tls_slot_->getTyped<ThreadLocalHostInfo>().updateHostMap(new_host_map);
-  });
+  const size_t batch_size = std::min<size_t>(candidates.size(), std::max(1U, max_hosts_ / 16));
+  std::nth_element(
+      candidates.begin(), candidates.begin() + batch_size, candidates.end(),
+      [](const Candidate& lhs, const Candidate& rhs) { return lhs.first < rhs.first; });
+  for (size_t i = 0; i < batch_size; ++i) {
+    ENVOY_LOG(debug, "evicting least recently used host '{}'", candidates[i].second);
+    stats_.host_evicted_.inc();
+    removeHost(candidates[i].second);
+  }
 }
 
 DnsCacheImpl::ThreadLocalHostInfo::~ThreadLocalHostInfo() {
@@ -246,12 +282,13 @@ DnsCacheImpl::ThreadLocalHostInfo::~ThreadLocalHostInfo() {
   }
 }
 
-void DnsCacheImpl::ThreadLocalHostInfo::updateHostMap(const TlsHostMapSharedPtr& new_host_map) {
-  host_map_ = new_host_map;
+void DnsCacheImpl::ThreadLocalHostInfo::onHostMapUpdate(const std::string& host,
+                                                        const DnsHostInfoSharedPtr& host_info) {
+  host_map_[host] = host_info;
   for (auto pending_resolution_it = pending_resolutions_.begin();
        pending_resolution_it != pending_resolutions_.end();) {
     auto& pending_resolution = **pending_resolution_it;
-    if (host_map_->count(pending_resolution.host_) != 0) {
+    if (pending_resolution.host_ == host) {
       auto& callbacks = pending_resolution.callbacks_;
       pending_resolution.cancel();
       pending_resolution_it = pending_resolutions_.erase(pending_resolution_it);
@@ -262,6 +299,10 @@ void DnsCacheImpl::ThreadLocalHostInfo::updateHostMap(const TlsHostMapSharedPtr&
   }
 }
 
+void DnsCacheImpl::ThreadLocalHostInfo::onHostMapRemove(const std::string& host) {
+  host_map_.erase(host);
+}
+
 DnsCacheImpl::PrimaryHostInfo::PrimaryHostInfo(DnsCacheImpl& parent,
                                                absl::string_view host_to_resolve, uint16_t port,
                                                bool is_ip_address, const Event::TimerCb& timer_cb)
@@ -274,6 +315,9 @@ DnsCacheImpl::PrimaryHostInfo::PrimaryHostInfo(DnsCacheImpl& parent,
 }
 
 DnsCacheImpl::PrimaryHostInfo::~PrimaryHostInfo() {
+  if (active_query_ != nullptr) {
+    active_query_->cancel();
+  }
   parent_.stats_.host_removed_.inc();
   parent_.stats_.num_hosts_.dec();
 }
@@ -23,6 +23,7 @@ namespace DynamicForwardProxy {
   COUNTER(dns_query_success)                                                                       \
   COUNTER(host_added)                                                                              \
   COUNTER(host_address_changed)                                                                    \
+  COUNTER(host_evicted)                                                                            \
   COUNTER(host_overflow)                                                                           \
   COUNTER(host_removed)                                                                            \
   GAUGE(num_hosts, NeverImport)
@@ -36,8 +37,8 @@ struct DnsCacheStats {
 
 class DnsCacheImpl : public DnsCache, Logger::Loggable<Logger::Id::forward_proxy> {
 public:
-  DnsCacheImpl(Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls,
-               Stats::Scope& root_scope,
+  DnsCacheImpl(Event::Dispatcher& main_thread_dispatcher, Network::DnsResolverSharedPtr resolver,
+               ThreadLocal::SlotAllocator& tls, Stats::Scope& root_scope,
                const envoy::config::common::dynamic_forward_proxy::v2alpha::DnsCacheConfig& config);
   ~DnsCacheImpl() override;
 
@@ -48,7 +49,6 @@ public:
 
 private:
   using TlsHostMap = absl::flat_hash_map<std::string, DnsHostInfoSharedPtr>;
-  using TlsHostMapSharedPtr = std::shared_ptr<TlsHostMap>;
 
   struct LoadDnsCacheEntryHandleImpl : public LoadDnsCacheEntryHandle,
                                        RaiiListElement<LoadDnsCacheEntryHandleImpl*> {
@@ -62,11 +62,14 @@ private:
   };
 
   // Per-thread DNS cache info including the currently known hosts as well as any pending callbacks.
+  // Each thread owns its host map, which the main thread updates one host at a time rather than
+  // publishing whole new maps, so that adding a host does not copy all the others.
   struct ThreadLocalHostInfo : public ThreadLocal::ThreadLocalObject {
     ~ThreadLocalHostInfo() override;
-    void updateHostMap(const TlsHostMapSharedPtr& new_host_map);
+    void onHostMapUpdate(const std::string& host, const DnsHostInfoSharedPtr& host_info);
+    void onHostMapRemove(const std::string& host);
 
-    TlsHostMapSharedPtr host_map_;
+    TlsHostMap host_map_;
     std::list<LoadDnsCacheEntryHandleImpl*> pending_resolutions_;
   };
 
@@ -78,6 +81,9 @@ private:
 
     // DnsHostInfo
     Network::Address::InstanceConstSharedPtr address() override { return address_; }
+    std::vector<Network::Address::InstanceConstSharedPtr> addressList() override {
+      return address_list_;
+    }
     const std::string& resolvedHost() override { return resolved_host_; }
     bool isIpAddress() override { return is_ip_address_; }
     void touch() override { last_used_time_ = time_source_.monotonicTime().time_since_epoch(); }
@@ -87,6 +93,7 @@ private:
     const bool is_ip_address_;
     bool first_resolve_complete_{};
     Network::Address::InstanceConstSharedPtr address_;
+    std::vector<Network::Address::InstanceConstSharedPtr> address_list_;
     // Using std::chrono::steady_clock::duration is required for compilation within an atomic vs.
     // using MonotonicTime.
     std::atomic<std::chrono::steady_clock::duration> last_used_time_;
@@ -123,7 +130,9 @@ private:
   void finishResolve(const std::string& host, std::list<Network::DnsResponse>&& response);
   void runAddUpdateCallbacks(const std::string& host, const DnsHostInfoSharedPtr& host_info);
   void runRemoveCallbacks(const std::string& host);
-  void updateTlsHostsMap();
+  void postHostMapUpdate(const std::string& host, const DnsHostInfoSharedPtr& host_info);
+  void removeHost(const std::string& host);
+  void evictLeastRecentlyUsedHosts();
   void onReResolve(const std::string& host);
 
   Event::Dispatcher& main_thread_dispatcher_;
@@ -137,6 +146,7 @@ private:
   const std::chrono::milliseconds refresh_interval_;
   const std::chrono::milliseconds host_ttl_;
   const uint32_t max_hosts_;
+  const bool evict_least_recently_used_hosts_;
 };
 
 } // namespace DynamicForwardProxy
@@ -11,9 +11,11 @@ namespace DynamicForwardProxy {
 
 class DnsCacheManagerImpl : public DnsCacheManager, public Singleton::Instance {
 public:
-  DnsCacheManagerImpl(Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls,
+  DnsCacheManagerImpl(Event::Dispatcher& main_thread_dispatcher,
+                      Network::DnsResolverSharedPtr resolver, ThreadLocal::SlotAllocator& tls,
                       Stats::Scope& root_scope)
-      : main_thread_dispatcher_(main_thread_dispatcher), tls_(tls), root_scope_(root_scope) {}
+      : main_thread_dispatcher_(main_thread_dispatcher), resolver_(std::move(resolver)), tls_(tls),
+        root_scope_(root_scope) {}
 
   // DnsCacheManager
   DnsCacheSharedPtr getCache(
@@ -30,6 +32,7 @@ private:
   };
 
   Event::Dispatcher& main_thread_dispatcher_;
+  const Network::DnsResolverSharedPtr resolver_;
   ThreadLocal::SlotAllocator& tls_;
   Stats::Scope& root_scope_;
   absl::flat_hash_map<std::string, ActiveCache> caches_;
@@ -38,17 +41,19 @@ private:
 class DnsCacheManagerFactoryImpl : public DnsCacheManagerFactory {
 public:
   DnsCacheManagerFactoryImpl(Singleton::Manager& singleton_manager, Event::Dispatcher& dispatcher,
+                             Network::DnsResolverSharedPtr resolver,
                              ThreadLocal::SlotAllocator& tls, Stats::Scope& root_scope)
-      : singleton_manager_(singleton_manager), dispatcher_(dispatcher), tls_(tls),
-        root_scope_(root_scope) {}
+      : singleton_manager_(singleton_manager), dispatcher_(dispatcher),
+        resolver_(std::move(resolver)), tls_(tls), root_scope_(root_scope) {}
 
   DnsCacheManagerSharedPtr get() override {
-    return getCacheManager(singleton_manager_, dispatcher_, tls_, root_scope_);
+    return getCacheManager(singleton_manager_, dispatcher_, resolver_, tls_, root_scope_);
   }
 
 private:
   Singleton::Manager& singleton_manager_;
   Event::Dispatcher& dispatcher_;
+  const Network::DnsResolverSharedPtr resolver_;
   ThreadLocal::SlotAllocator& tls_;
   Stats::Scope& root_scope_;
 };
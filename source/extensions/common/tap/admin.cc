@@ -108,26 +108,28 @@ void AdminHandler::AdminPerTapSinkHandle::submitTrace(
   std::shared_ptr<envoy::data::tap::v2alpha::TraceWrapper> shared_trace{std::move(trace)};
   // The handle can be destroyed before the cross thread post is complete. Thus, we capture a
   // reference to our parent.
-  parent_.main_thread_dispatcher_.post([& parent = parent_, trace = shared_trace, format]() {
-    if (!parent.attached_request_.has_value()) {
-      return;
-    }
-
-    std::string output_string;
-    switch (format) {
-    case envoy::service::tap::v2alpha::OutputSink::JSON_BODY_AS_STRING:
-    case envoy::service::tap::v2alpha::OutputSink::JSON_BODY_AS_BYTES:
-      output_string = MessageUtil::getJsonStringFromMessage(*trace, true, true);
-      break;
-    default:
-      NOT_REACHED_GCOVR_EXCL_LINE;
-    }
-
-    ENVOY_LOG(debug, "admin writing buffered trace to response");
-    Buffer::OwnedImpl output_buffer{output_string};
-    parent.attached_request_.value().admin_stream_->getDecoderFilterCallbacks().encodeData(
-        output_buffer, false);
-  });
+  parent_.main_thread_dispatcher_.post(
+      [& parent = parent_, trace = shared_trace, format]() {
+        if (!parent.attached_request_.has_value()) {
+          return;
+        }
+
+        std::string output_string;
+        switch (format) {
+        case envoy::service::tap::v2alpha::OutputSink::JSON_BODY_AS_STRING:
+        case envoy::service::tap::v2alpha::OutputSink::JSON_BODY_AS_BYTES:
+          output_string = MessageUtil::getJsonStringFromMessage(*trace, true, true);
+          break;
+        default:
+          NOT_REACHED_GCOVR_EXCL_LINE;
+        }
+
+        ENVOY_LOG(debug, "admin writing buffered trace to response");
+        Buffer::OwnedImpl output_buffer{output_string};
+        parent.attached_request_.value().admin_stream_->getDecoderFilterCallbacks().encodeData(
+            output_buffer, false);
+      },
+      Event::PostPriority::Admin);
 }
 
 } // namespace Tap
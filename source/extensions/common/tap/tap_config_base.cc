@@ -1,6 +1,9 @@
 #include "extensions/common/tap/tap_config_base.h"
 
+#include "envoy/common/exception.h"
+
 #include "common/common/assert.h"
+#include "common/common/lock_guard.h"
 #include "common/common/stack_array.h"
 #include "common/protobuf/utility.h"
 
@@ -40,15 +43,14 @@ bool Utility::addBufferToProtoBytes(envoy::data::tap::v2alpha::Body& output_body
 }
 
 TapConfigBaseImpl::TapConfigBaseImpl(envoy::service::tap::v2alpha::TapConfig&& proto_config,
-                                     Common::Tap::Sink* admin_streamer)
+                                     Common::Tap::Sink* admin_streamer, TimeSource& time_source)
     : max_buffered_rx_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           proto_config.output_config(), max_buffered_rx_bytes, DefaultMaxBufferedBytes)),
       max_buffered_tx_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           proto_config.output_config(), max_buffered_tx_bytes, DefaultMaxBufferedBytes)),
       streaming_(proto_config.output_config().streaming()) {
   ASSERT(proto_config.output_config().sinks().size() == 1);
-  // TODO(mattklein123): Add per-sink checks to make sure format makes sense. I.e., when using
-  // streaming, we should require the length delimited version of binary proto, etc.
+  // TODO(mattklein123): Add per-sink checks to make sure format makes sense for the other sinks.
   sink_format_ = proto_config.output_config().sinks()[0].format();
   switch (proto_config.output_config().sinks()[0].output_sink_type_case()) {
   case envoy::service::tap::v2alpha::OutputSink::kStreamingAdmin:
@@ -66,11 +68,21 @@ TapConfigBaseImpl::TapConfigBaseImpl(envoy::service::tap::v2alpha::TapConfig&& p
         std::make_unique<FilePerTapSink>(proto_config.output_config().sinks()[0].file_per_tap());
     sink_to_use_ = sink_.get();
     break;
+  case envoy::service::tap::v2alpha::OutputSink::kStreamingFile:
+    // The traces of all taps share the file, so they must be delimited.
+    if (sink_format_ != envoy::service::tap::v2alpha::OutputSink::PROTO_BINARY_LENGTH_DELIMITED) {
+      throw EnvoyException("streaming file output only supports the PROTO_BINARY_LENGTH_DELIMITED "
+                           "format");
+    }
+    sink_ = std::make_unique<StreamingFileSink>(
+        proto_config.output_config().sinks()[0].streaming_file());
+    sink_to_use_ = sink_.get();
+    break;
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
 
-  buildMatcher(proto_config.match_config(), matchers_);
+  buildMatcher(proto_config.match_config(), matchers_, time_source);
 }
 
 const Matcher& TapConfigBaseImpl::rootMatcher() const {
@@ -195,6 +207,60 @@ void FilePerTapSink::FilePerTapSinkHandle::submitTrace(
   }
 }
 
+StreamingFileSink::StreamingFileSink(const envoy::service::tap::v2alpha::StreamingFileSink& config)
+    : max_batch_bytes_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_batch_bytes, DefaultMaxBatchBytes)) {
+  ENVOY_LOG_MISC(debug, "Opening streaming tap file {}", config.path());
+  output_file_.open(config.path(), std::ios_base::app | std::ios_base::binary);
+  if (!output_file_.is_open()) {
+    throw EnvoyException(fmt::format("unable to open streaming tap file {}", config.path()));
+  }
+}
+
+void StreamingFileSink::write(absl::string_view data) {
+  Thread::LockGuard lock(lock_);
+  output_file_.write(data.data(), data.size());
+  output_file_.flush();
+}
+
+StreamingFileSink::StreamingFileSinkHandle::~StreamingFileSinkHandle() {
+  if (!batch_.empty()) {
+    parent_.write(batch_);
+  }
+}
+
+void StreamingFileSink::StreamingFileSinkHandle::submitTrace(
+    TraceWrapperPtr&& trace, envoy::service::tap::v2alpha::OutputSink::Format format) {
+  ASSERT(format == envoy::service::tap::v2alpha::OutputSink::PROTO_BINARY_LENGTH_DELIMITED);
+  ENVOY_LOG_MISC(trace, "Streaming tap: {}", trace->DebugString());
+
+  const uint32_t size = static_cast<uint32_t>(trace->ByteSizeLong());
+  const uint32_t delimited_size = Protobuf::io::CodedOutputStream::VarintSize32(size) + size;
+  if (batch_.size() + delimited_size > parent_.max_batch_bytes_) {
+    if (!batch_.empty()) {
+      parent_.write(batch_);
+      batch_.clear();
+    }
+  }
+  if (batch_.capacity() < parent_.max_batch_bytes_) {
+    batch_.reserve(parent_.max_batch_bytes_);
+  }
+
+  // The trace is serialized in place at the end of the batch. A trace larger than the batch goes
+  // through it on its own, and grows it only for that write.
+  const size_t offset = batch_.size();
+  batch_.resize(offset + delimited_size);
+  uint8_t* target = reinterpret_cast<uint8_t*>(&batch_[offset]);
+  target = Protobuf::io::CodedOutputStream::WriteVarint32ToArray(size, target);
+  // ByteSizeLong() above cached the sizes of the nested messages.
+  trace->SerializeWithCachedSizesToArray(target);
+  if (batch_.size() > parent_.max_batch_bytes_) {
+    parent_.write(batch_);
+    batch_.clear();
+    batch_.shrink_to_fit();
+  }
+}
+
 } // namespace Tap
 } // namespace Common
 } // namespace Extensions
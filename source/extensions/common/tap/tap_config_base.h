@@ -3,8 +3,12 @@
 #include <fstream>
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/common/time.h"
 #include "envoy/service/tap/v2alpha/common.pb.h"
 
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+
 #include "extensions/common/tap/tap.h"
 #include "extensions/common/tap/tap_matcher.h"
 
@@ -95,7 +99,7 @@ public:
 
 protected:
   TapConfigBaseImpl(envoy::service::tap::v2alpha::TapConfig&& proto_config,
-                    Common::Tap::Sink* admin_streamer);
+                    Common::Tap::Sink* admin_streamer, TimeSource& time_source);
 
 private:
   // This is the default setting for both RX/TX max buffered bytes. (This means that per tap, the
@@ -140,6 +144,44 @@ private:
   const envoy::service::tap::v2alpha::FilePerTapSink config_;
 };
 
+/**
+ * A tap sink that streams the traces of all taps to a single file as length-delimited binary
+ * protos. Each tap serializes its traces into a batch buffer of fixed size, which is written to
+ * the file, shared by the workers, when it is full and when the tap ends.
+ */
+class StreamingFileSink : public Sink {
+public:
+  StreamingFileSink(const envoy::service::tap::v2alpha::StreamingFileSink& config);
+
+  // Sink
+  PerTapSinkHandlePtr createPerTapSinkHandle(uint64_t) override {
+    return std::make_unique<StreamingFileSinkHandle>(*this);
+  }
+
+private:
+  struct StreamingFileSinkHandle : public PerTapSinkHandle {
+    StreamingFileSinkHandle(StreamingFileSink& parent) : parent_(parent) {}
+    ~StreamingFileSinkHandle() override;
+
+    // PerTapSinkHandle
+    void submitTrace(TraceWrapperPtr&& trace,
+                     envoy::service::tap::v2alpha::OutputSink::Format format) override;
+
+    StreamingFileSink& parent_;
+    // Reserved on the first trace, so that taps which never submit one cost no buffer.
+    std::string batch_;
+  };
+
+  void write(absl::string_view data);
+
+  // This is the default size of the batch buffer of each tap.
+  static constexpr uint32_t DefaultMaxBatchBytes = 64 * 1024;
+
+  const uint32_t max_batch_bytes_;
+  Thread::MutexBasicLockable lock_;
+  std::ofstream output_file_ GUARDED_BY(lock_);
+};
+
 } // namespace Tap
 } // namespace Common
 } // namespace Extensions
@@ -1,6 +1,9 @@
 #include "extensions/common/tap/tap_matcher.h"
 
+#include <chrono>
+
 #include "common/common/assert.h"
+#include "common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -8,7 +11,7 @@ namespace Common {
 namespace Tap {
 
 void buildMatcher(const envoy::service::tap::v2alpha::MatchPredicate& match_config,
-                  std::vector<MatcherPtr>& matchers) {
+                  std::vector<MatcherPtr>& matchers, TimeSource& time_source) {
   // In order to store indexes and build our matcher tree inline, we must reserve a slot where
   // the matcher we are about to create will go. This allows us to know its future index and still
   // construct more of the tree in each called constructor (e.g., multiple OR/AND conditions).
@@ -20,14 +23,14 @@ void buildMatcher(const envoy::service::tap::v2alpha::MatchPredicate& match_conf
   switch (match_config.rule_case()) {
   case envoy::service::tap::v2alpha::MatchPredicate::kOrMatch:
     new_matcher = std::make_unique<SetLogicMatcher>(match_config.or_match(), matchers,
-                                                    SetLogicMatcher::Type::Or);
+                                                    SetLogicMatcher::Type::Or, time_source);
     break;
   case envoy::service::tap::v2alpha::MatchPredicate::kAndMatch:
     new_matcher = std::make_unique<SetLogicMatcher>(match_config.and_match(), matchers,
-                                                    SetLogicMatcher::Type::And);
+                                                    SetLogicMatcher::Type::And, time_source);
     break;
   case envoy::service::tap::v2alpha::MatchPredicate::kNotMatch:
-    new_matcher = std::make_unique<NotMatcher>(match_config.not_match(), matchers);
+    new_matcher = std::make_unique<NotMatcher>(match_config.not_match(), matchers, time_source);
     break;
   case envoy::service::tap::v2alpha::MatchPredicate::kAnyMatch:
     new_matcher = std::make_unique<AnyMatcher>(matchers);
@@ -48,6 +51,10 @@ void buildMatcher(const envoy::service::tap::v2alpha::MatchPredicate& match_conf
     new_matcher = std::make_unique<HttpResponseTrailersMatcher>(
         match_config.http_response_trailers_match(), matchers);
     break;
+  case envoy::service::tap::v2alpha::MatchPredicate::kSampleMatch:
+    new_matcher =
+        std::make_unique<SampleMatcher>(match_config.sample_match(), matchers, time_source);
+    break;
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
@@ -58,11 +65,11 @@ void buildMatcher(const envoy::service::tap::v2alpha::MatchPredicate& match_conf
 
 SetLogicMatcher::SetLogicMatcher(
     const envoy::service::tap::v2alpha::MatchPredicate::MatchSet& configs,
-    std::vector<MatcherPtr>& matchers, Type type)
+    std::vector<MatcherPtr>& matchers, Type type, TimeSource& time_source)
     : LogicMatcherBase(matchers), matchers_(matchers), type_(type) {
   for (const auto& config : configs.rules()) {
     indexes_.push_back(matchers_.size());
-    buildMatcher(config, matchers_);
+    buildMatcher(config, matchers_, time_source);
   }
 }
 
@@ -92,9 +99,9 @@ void SetLogicMatcher::updateLocalStatus(MatchStatusVector& statuses,
 }
 
 NotMatcher::NotMatcher(const envoy::service::tap::v2alpha::MatchPredicate& config,
-                       std::vector<MatcherPtr>& matchers)
+                       std::vector<MatcherPtr>& matchers, TimeSource& time_source)
     : LogicMatcherBase(matchers), matchers_(matchers), not_index_(matchers.size()) {
-  buildMatcher(config, matchers);
+  buildMatcher(config, matchers, time_source);
 }
 
 void NotMatcher::updateLocalStatus(MatchStatusVector& statuses,
@@ -108,6 +115,39 @@ void NotMatcher::updateLocalStatus(MatchStatusVector& statuses,
   statuses[my_index_].might_change_status_ = statuses[not_index_].might_change_status_;
 }
 
+SampleMatcher::SampleMatcher(const envoy::service::tap::v2alpha::SampleMatch& config,
+                             const std::vector<MatcherPtr>& matchers, TimeSource& time_source)
+    : SimpleMatcher(matchers), numerator_(config.percentage().numerator()),
+      denominator_(ProtobufPercentHelper::fractionalPercentDenominatorToInt(
+          config.percentage().denominator())),
+      max_streams_per_second_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_streams_per_second, UINT32_MAX)),
+      time_source_(time_source) {}
+
+bool SampleMatcher::sample() const {
+  // The n-th stream is sampled when n * numerator / denominator reaches the next integer, which
+  // spreads the sampled streams evenly without drawing a random number per stream.
+  const uint64_t stream = streams_.fetch_add(1, std::memory_order_relaxed) % denominator_;
+  if ((stream + 1) * numerator_ / denominator_ == stream * numerator_ / denominator_) {
+    return false;
+  }
+  if (max_streams_per_second_ == UINT32_MAX) {
+    return true;
+  }
+
+  const int64_t second = std::chrono::duration_cast<std::chrono::seconds>(
+                             time_source_.monotonicTime().time_since_epoch())
+                             .count();
+  int64_t window_second = window_second_.load(std::memory_order_relaxed);
+  // The worker which moves the window to the current second restarts its count. Streams counted
+  // by other workers meanwhile may be lost, which only lets a few more streams be sampled.
+  if (window_second != second &&
+      window_second_.compare_exchange_strong(window_second, second, std::memory_order_relaxed)) {
+    window_streams_.store(0, std::memory_order_relaxed);
+  }
+  return window_streams_.fetch_add(1, std::memory_order_relaxed) < max_streams_per_second_;
+}
+
 HttpHeaderMatcherBase::HttpHeaderMatcherBase(
     const envoy::service::tap::v2alpha::HttpHeadersMatch& config,
     const std::vector<MatcherPtr>& matchers)
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+
+#include "envoy/common/time.h"
 #include "envoy/service/tap/v2alpha/common.pb.h"
 
 #include "common/http/header_utility.h"
@@ -118,9 +121,10 @@ protected:
  * Factory method to build a matcher given a match config. Calling this function may end
  * up recursively building many matchers, which will all be added to the passed in vector
  * of matchers. See the comments in tap.h for the general structure of how tap matchers work.
+ * @param time_source supplies the time source used by the matchers which rate limit.
  */
 void buildMatcher(const envoy::service::tap::v2alpha::MatchPredicate& match_config,
-                  std::vector<MatcherPtr>& matchers);
+                  std::vector<MatcherPtr>& matchers, TimeSource& time_source);
 
 /**
  * Base class for logic matchers that need to forward update calls to child matchers.
@@ -173,7 +177,7 @@ public:
   enum class Type { And, Or };
 
   SetLogicMatcher(const envoy::service::tap::v2alpha::MatchPredicate::MatchSet& configs,
-                  std::vector<MatcherPtr>& matchers, Type type);
+                  std::vector<MatcherPtr>& matchers, Type type, TimeSource& time_source);
 
 private:
   void updateLocalStatus(MatchStatusVector& statuses, const UpdateFunctor& functor) const override;
@@ -189,7 +193,7 @@ private:
 class NotMatcher : public LogicMatcherBase {
 public:
   NotMatcher(const envoy::service::tap::v2alpha::MatchPredicate& config,
-             std::vector<MatcherPtr>& matchers);
+             std::vector<MatcherPtr>& matchers, TimeSource& time_source);
 
 private:
   void updateLocalStatus(MatchStatusVector& statuses, const UpdateFunctor& functor) const override;
@@ -228,6 +232,34 @@ public:
   }
 };
 
+/**
+ * Sample matcher. Matches an evenly spread fraction of the new streams, up to a maximum number per
+ * second. The matcher is shared by the workers, so its state is kept in atomics.
+ */
+class SampleMatcher : public SimpleMatcher {
+public:
+  SampleMatcher(const envoy::service::tap::v2alpha::SampleMatch& config,
+                const std::vector<MatcherPtr>& matchers, TimeSource& time_source);
+
+  // Extensions::Common::Tap::Matcher
+  void onNewStream(MatchStatusVector& statuses) const override {
+    statuses[my_index_].matches_ = sample();
+    statuses[my_index_].might_change_status_ = false;
+  }
+
+private:
+  bool sample() const;
+
+  const uint64_t numerator_;
+  const uint64_t denominator_;
+  const uint32_t max_streams_per_second_;
+  TimeSource& time_source_;
+  mutable std::atomic<uint64_t> streams_{};
+  // The monotonic second whose sampled streams are counted, and their count.
+  mutable std::atomic<int64_t> window_second_{-1};
+  mutable std::atomic<uint32_t> window_streams_{};
+};
+
 /**
  * Base class for the various HTTP header matchers.
  */
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Wasm {
+
+/**
+ * A bounded, lock-free multi-producer, multi-consumer queue (D. Vyukov's array based queue). Each
+ * slot carries a sequence number which tells producers and consumers whether the slot is free or
+ * full for the current lap around the ring, so that tryPush() and tryPop() only need a single CAS
+ * on the enqueue or dequeue position respectively.
+ */
+template <class T> class BoundedQueue {
+public:
+  /**
+   * @param capacity the maximum number of entries, rounded up to the next power of two.
+   */
+  explicit BoundedQueue(size_t capacity)
+      : mask_(roundUpToPowerOfTwo(capacity) - 1), slots_(new Slot[mask_ + 1]) {
+    for (size_t i = 0; i <= mask_; i++) {
+      slots_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  /**
+   * @return the maximum number of entries in the queue.
+   */
+  size_t capacity() const { return mask_ + 1; }
+
+  /**
+   * Add an entry at the tail of the queue.
+   * @param value the entry, which is only moved from on success.
+   * @return false if the queue is full.
+   */
+  bool tryPush(T&& value) {
+    Slot* slot;
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    while (true) {
+      slot = &slots_[position & mask_];
+      const size_t sequence = slot->sequence_.load(std::memory_order_acquire);
+      const intptr_t difference =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+      if (difference == 0) {
+        if (enqueue_position_.compare_exchange_weak(position, position + 1,
+                                                    std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->value_ = std::move(value);
+    slot->sequence_.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Remove the entry at the head of the queue.
+   * @param value receives the entry.
+   * @return false if the queue is empty.
+   */
+  bool tryPop(T* value) {
+    Slot* slot;
+    size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    while (true) {
+      slot = &slots_[position & mask_];
+      const size_t sequence = slot->sequence_.load(std::memory_order_acquire);
+      const intptr_t difference =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+      if (difference == 0) {
+        if (dequeue_position_.compare_exchange_weak(position, position + 1,
+                                                    std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = dequeue_position_.load(std::memory_order_relaxed);
+      }
+    }
+    *value = std::move(slot->value_);
+    slot->value_ = T();
+    slot->sequence_.store(position + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @return an approximation of the number of entries in the queue.
+   */
+  size_t size() const {
+    const size_t enqueued = enqueue_position_.load(std::memory_order_relaxed);
+    const size_t dequeued = dequeue_position_.load(std::memory_order_relaxed);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+  }
+
+private:
+  static size_t roundUpToPowerOfTwo(size_t n) {
+    ASSERT(n > 0);
+    size_t result = 1;
+    while (result < n) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  struct Slot {
+    std::atomic<size_t> sequence_;
+    T value_;
+  };
+
+  const size_t mask_;
+  const std::unique_ptr<Slot[]> slots_;
+  // Keep producers and consumers on separate cache lines.
+  alignas(64) std::atomic<size_t> enqueue_position_{0};
+  alignas(64) std::atomic<size_t> dequeue_position_{0};
+};
+
+} // namespace Wasm
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
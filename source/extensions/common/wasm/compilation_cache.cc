@@ -0,0 +1,119 @@
+#include "extensions/common/wasm/compilation_cache.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/hex.h"
+#include "common/common/version.h"
+
+#include "absl/strings/str_cat.h"
+#include "openssl/sha.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Wasm {
+
+CompilationCache::CompilationCache(Api::Api& api, absl::string_view directory)
+    : api_(api), directory_(directory) {
+  if (!api_.fileSystem().directoryExists(directory_)) {
+    throw EnvoyException(
+        fmt::format("Wasm compilation cache directory does not exist: {}", directory_));
+  }
+}
+
+const std::string& CompilationCache::cpuFeatures() {
+  static const std::string* features = [] {
+    std::string features;
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    features = "x86_64";
+    for (const char* feature : {"sse4.1", "sse4.2", "popcnt", "avx", "avx2", "bmi", "bmi2",
+                                "avx512f"}) {
+      if (__builtin_cpu_supports(feature)) {
+        absl::StrAppend(&features, "+", feature);
+      }
+    }
+#elif defined(__aarch64__)
+    features = "aarch64";
+#else
+    features = "unknown";
+#endif
+    return new std::string(std::move(features));
+  }();
+  return *features;
+}
+
+std::string CompilationCache::key(absl::string_view vm, absl::string_view code) {
+  uint8_t digest[SHA256_DIGEST_LENGTH];
+  SHA256_CTX ctx;
+  SHA256_Init(&ctx);
+  SHA256_Update(&ctx, code.data(), code.size());
+  // The runtimes are built into Envoy, so the Envoy revision identifies the runtime version.
+  for (absl::string_view part : {vm, absl::string_view(VersionInfo::revision()),
+                                 absl::string_view(cpuFeatures())}) {
+    SHA256_Update(&ctx, "\0", 1);
+    SHA256_Update(&ctx, part.data(), part.size());
+  }
+  SHA256_Final(digest, &ctx);
+  return Hex::encode(digest, sizeof(digest));
+}
+
+absl::optional<std::string> CompilationCache::lookup(const std::string& key) {
+  const std::string file = path(key);
+  if (!api_.fileSystem().fileExists(file)) {
+    ENVOY_LOG(debug, "compilation cache miss: {}", file);
+    return absl::nullopt;
+  }
+  try {
+    auto precompiled = api_.fileSystem().fileReadToEnd(file);
+    ENVOY_LOG(debug, "compilation cache hit: {} ({} bytes)", file, precompiled.size());
+    return precompiled;
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "failed to read compilation cache entry {}: {}", file, e.what());
+    return absl::nullopt;
+  }
+}
+
+void CompilationCache::insert(const std::string& key, absl::string_view precompiled) {
+  if (precompiled.empty()) {
+    return;
+  }
+  static std::atomic<uint64_t> next_temporary_id{0};
+  const std::string file = path(key);
+  // Write to a temporary file and rename it, so that concurrent readers (e.g. another Envoy
+  // process during hot restart) never observe a partially written entry.
+  const std::string temporary_file =
+      absl::StrCat(file, ".tmp.", ::getpid(), ".", next_temporary_id++);
+  {
+    auto output = api_.fileSystem().createFile(temporary_file);
+    Filesystem::FlagSet flags{1 << Filesystem::File::Operation::Write |
+                              1 << Filesystem::File::Operation::Create};
+    if (!output->open(flags).rc_) {
+      ENVOY_LOG(warn, "failed to create compilation cache entry {}", temporary_file);
+      return;
+    }
+    const auto result = output->write(precompiled);
+    output->close();
+    if (result.rc_ != static_cast<ssize_t>(precompiled.size())) {
+      ENVOY_LOG(warn, "failed to write compilation cache entry {}", temporary_file);
+      ::unlink(temporary_file.c_str());
+      return;
+    }
+  }
+  if (::rename(temporary_file.c_str(), file.c_str()) != 0) {
+    ENVOY_LOG(warn, "failed to rename compilation cache entry {} to {}", temporary_file, file);
+    ::unlink(temporary_file.c_str());
+    return;
+  }
+  ENVOY_LOG(debug, "compilation cache insert: {} ({} bytes)", file, precompiled.size());
+}
+
+} // namespace Wasm
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "envoy/api/api.h"
+
+#include "common/common/logger.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Wasm {
+
+/**
+ * A content-addressed, on-disk cache of native code produced by the Wasm runtimes. Entries are
+ * keyed by the SHA-256 of the Wasm module together with the runtime, the Envoy build (which pins
+ * the runtime version) and the CPU features of the host, so that stale or foreign native code is
+ * never loaded.
+ */
+class CompilationCache : Logger::Loggable<Logger::Id::wasm> {
+public:
+  CompilationCache(Api::Api& api, absl::string_view directory);
+
+  /**
+   * @param vm the name of the Wasm runtime (e.g. "envoy.wasm.vm.v8").
+   * @param code the Wasm module bytecode.
+   * @return the cache key for the native code produced by the given runtime from the given code.
+   */
+  static std::string key(absl::string_view vm, absl::string_view code);
+
+  /**
+   * @param key a key returned by key().
+   * @return the cached native code or absl::nullopt on a cache miss.
+   */
+  absl::optional<std::string> lookup(const std::string& key);
+
+  /**
+   * Store native code in the cache. Failures are logged and otherwise ignored.
+   * @param key a key returned by key().
+   * @param precompiled the native code produced by WasmVm::getPrecompiledCode().
+   */
+  void insert(const std::string& key, absl::string_view precompiled);
+
+  /**
+   * @return a string identifying the CPU features of the host which affect code generation.
+   */
+  static const std::string& cpuFeatures();
+
+private:
+  std::string path(const std::string& key) const { return absl::StrCat(directory_, "/", key); }
+
+  Api::Api& api_;
+  const std::string directory_;
+};
+
+using CompilationCacheSharedPtr = std::shared_ptr<CompilationCache>;
+
+} // namespace Wasm
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
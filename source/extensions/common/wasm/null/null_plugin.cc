@@ -116,6 +116,12 @@ void NullPlugin::getFunction(absl::string_view function_name, WasmCall3Void* f)
       SaveRestoreContext saved_context(context);
       plugin->onConfigure(context_id.u64, ptr.u64, size.u64);
     };
+  } else if (function_name == "_proxy_onLogBatch") {
+    auto plugin = this;
+    *f = [plugin](Common::Wasm::Context* context, Word context_id, Word ptr, Word size) {
+      SaveRestoreContext saved_context(context);
+      plugin->onLogBatch(context_id.u64, ptr.u64, size.u64);
+    };
   } else {
     throw WasmVmException(fmt::format("Missing getFunction for: {}", function_name));
   }
@@ -183,6 +189,12 @@ void NullPlugin::getFunction(absl::string_view function_name, WasmCall1Word* f)
       SaveRestoreContext saved_context(context);
       return Word(plugin->onRequestHeaders(context_id.u64));
     };
+  } else if (function_name == "_proxy_onReset") {
+    auto plugin = this;
+    *f = [plugin](Common::Wasm::Context* context, Word context_id) -> Word {
+      SaveRestoreContext saved_context(context);
+      return Word(plugin->onReset(context_id.u64));
+    };
   } else if (function_name == "_proxy_onRequestTrailers") {
     auto plugin = this;
     *f = [plugin](Common::Wasm::Context* context, Word context_id) -> Word {
@@ -322,6 +334,11 @@ void NullPlugin::onConfigure(uint64_t root_context_id, uint64_t ptr, uint64_t si
       ->onConfigure(std::make_unique<WasmData>(reinterpret_cast<char*>(ptr), size));
 }
 
+void NullPlugin::onLogBatch(uint64_t root_context_id, uint64_t ptr, uint64_t size) {
+  getRootContext(root_context_id)
+      ->onLogBatch(std::make_unique<WasmData>(reinterpret_cast<char*>(ptr), size));
+}
+
 void NullPlugin::onTick(uint64_t root_context_id) { getRootContext(root_context_id)->onTick(); }
 
 void NullPlugin::onCreate(uint64_t context_id, uint64_t root_context_id) {
@@ -414,6 +431,8 @@ void NullPlugin::onLog(uint64_t context_id) { getContext(context_id)->onLog(); }
 
 void NullPlugin::onDone(uint64_t context_id) { getContext(context_id)->onDone(); }
 
+uint64_t NullPlugin::onReset(uint64_t context_id) { return getContext(context_id)->onReset(); }
+
 void NullPlugin::onDelete(uint64_t context_id) {
   getContext(context_id)->onDelete();
   context_map_.erase(context_id);
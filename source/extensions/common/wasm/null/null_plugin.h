@@ -67,6 +67,7 @@ public:
   void onStart(uint64_t root_context_id, uint64_t root_id_ptr, uint64_t root_id_size,
                uint64_t vm_configuration_ptr, uint64_t vm_configuration_size);
   void onConfigure(uint64_t root_context_id, uint64_t ptr, uint64_t size);
+  void onLogBatch(uint64_t root_context_id, uint64_t ptr, uint64_t size);
   void onTick(uint64_t root_context_id);
   void onQueueReady(uint64_t root_context_id, uint64_t token);
 
@@ -97,6 +98,7 @@ public:
   void onLog(uint64_t context_id);
   void onDone(uint64_t context_id);
   void onDelete(uint64_t context_id);
+  uint64_t onReset(uint64_t context_id);
 
   Plugin::RootContext* getRoot(absl::string_view root_id);
 
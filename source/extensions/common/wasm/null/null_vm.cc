@@ -19,12 +19,12 @@ namespace Null {
 
 std::unique_ptr<WasmVm> NullVm::clone() { return std::make_unique<NullVm>(*this); }
 
-bool NullVm::load(const std::string& name, bool /* allow_precompiled */) {
-  auto factory = Registry::FactoryRegistry<NullPluginFactory>::getFactory(name);
+bool NullVm::load(absl::string_view name, bool /* allow_precompiled */) {
+  auto factory = Registry::FactoryRegistry<NullPluginFactory>::getFactory(std::string(name));
   if (!factory) {
     return false;
   }
-  plugin_name_ = name;
+  plugin_name_ = std::string(name);
   plugin_ = factory->create();
   return true;
 }
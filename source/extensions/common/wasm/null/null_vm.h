@@ -24,9 +24,14 @@ struct NullVm : public WasmVm {
 
   // WasmVm
   absl::string_view vm() override { return WasmVmNames::get().Null; }
-  bool clonable() override { return true; };
+  Cloneable cloneable() override { return Cloneable::InstantiatedModule; };
   std::unique_ptr<WasmVm> clone() override;
-  bool load(const std::string& code, bool allow_precompiled) override;
+  bool load(absl::string_view code, bool allow_precompiled) override;
+  // Null VM plugins are native code already.
+  bool loadPrecompiled(absl::string_view code, absl::string_view) override {
+    return load(code, false);
+  }
+  std::string getPrecompiledCode() override { return ""; }
   void link(absl::string_view debug_name, bool needs_emscripten) override;
   void setMemoryLayout(uint64_t, uint64_t, uint64_t) override {}
   void start(Common::Wasm::Context* context) override;
@@ -21,9 +21,47 @@ namespace Plugin {
 
 inline WasmResult wordToWasmResult(Word w) { return static_cast<WasmResult>(w.u64); }
 
+// The plugins share the address space of the host, so the most frequent host calls below call the
+// context directly with typed arguments rather than going through the Word handlers used by the
+// Wasm VMs, which translate VM addresses and copy the results into the VM memory.
+inline Envoy::Extensions::Common::Wasm::Context* hostContext() {
+  return ContextOrEffectiveContext(current_context_);
+}
+
+// As getMemory() of the VMs, a null pointer only refers to empty data.
+inline bool validMemory(const void* ptr, size_t size) { return ptr != nullptr || size == 0; }
+
+// Copy data to the pointer-size pair. The data is owned by the plugin, which frees it with ::free()
+// as it does for the data copied by Wasm::copyToPointerSize().
+inline bool copyToPointerSize(StringView data, const char** ptr_ptr, size_t* size_ptr) {
+  if (ptr_ptr == nullptr || size_ptr == nullptr) {
+    return false;
+  }
+  char* ptr = nullptr;
+  if (!data.empty()) {
+    ptr = static_cast<char*>(::malloc(data.size()));
+    memcpy(ptr, data.data(), data.size());
+  }
+  *ptr_ptr = ptr;
+  *size_ptr = data.size();
+  return true;
+}
+
 // Logging
 inline WasmResult proxy_log(LogLevel level, const char* logMessage, size_t messageSize) {
-  return wordToWasmResult(logHandler(current_context_, WS(level), WR(logMessage), WS(messageSize)));
+  if (!validMemory(logMessage, messageSize)) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  hostContext()->scriptLog(static_cast<spdlog::level::level_enum>(level),
+                           StringView(logMessage, messageSize));
+  return WasmResult::Ok;
+}
+
+// Batched calls
+inline WasmResult proxy_callBatch(const char* batch_ptr, size_t batch_size,
+                                  WasmResult* results_ptr, size_t results_count) {
+  return wordToWasmResult(callBatchHandler(current_context_, WR(batch_ptr), WS(batch_size),
+                                           WR(results_ptr), WS(results_count)));
 }
 
 // Timer
@@ -71,10 +109,12 @@ inline WasmResult proxy_getSelectorExpression(const char* path_ptr, size_t path_
 
 // Continue
 inline WasmResult proxy_continueRequest() {
-  return wordToWasmResult(continueRequestHandler(current_context_));
+  hostContext()->continueRequest();
+  return WasmResult::Ok;
 }
 inline WasmResult proxy_continueResponse() {
-  return wordToWasmResult(continueResponseHandler(current_context_));
+  hostContext()->continueResponse();
+  return WasmResult::Ok;
 }
 inline WasmResult
 proxy_sendLocalResponse(uint32_t response_code, const char* response_code_details_ptr,
@@ -88,7 +128,8 @@ proxy_sendLocalResponse(uint32_t response_code, const char* response_code_detail
                                WS(additional_response_header_pairs_size), WS(grpc_status)));
 }
 inline WasmResult proxy_clearRouteCache() {
-  return wordToWasmResult(clearRouteCacheHandler(current_context_));
+  hostContext()->clearRouteCache();
+  return WasmResult::Ok;
 }
 
 // SharedData
@@ -128,7 +169,14 @@ inline WasmResult proxy_dequeueSharedQueue(uint32_t token, const char** data_ptr
   return wordToWasmResult(
       dequeueSharedQueueHandler(current_context_, WS(token), WR(data_ptr), WR(data_size)));
 }
-// Returns false if the queue was not found and the data was not enqueued.
+// Dequeues up to max_entries entries, serialized as for WasmData::list().
+inline WasmResult proxy_dequeueSharedQueueBatch(uint32_t token, uint32_t max_entries,
+                                                const char** data_ptr, size_t* data_size) {
+  return wordToWasmResult(dequeueSharedQueueBatchHandler(current_context_, WS(token),
+                                                         WS(max_entries), WR(data_ptr),
+                                                         WR(data_size)));
+}
+// Returns NotFound if the queue was not found and Full if the queue is full and drops new entries.
 inline WasmResult proxy_enqueueSharedQueue(uint32_t token, const char* data_ptr, size_t data_size) {
   return wordToWasmResult(
       enqueueSharedQueueHandler(current_context_, WS(token), WR(data_ptr), WS(data_size)));
@@ -137,13 +185,29 @@ inline WasmResult proxy_enqueueSharedQueue(uint32_t token, const char* data_ptr,
 // Headers/Trailers/Metadata Maps
 inline WasmResult proxy_addHeaderMapValue(HeaderMapType type, const char* key_ptr, size_t key_size,
                                           const char* value_ptr, size_t value_size) {
-  return wordToWasmResult(addHeaderMapValueHandler(current_context_, WS(type), WR(key_ptr),
-                                                   WS(key_size), WR(value_ptr), WS(value_size)));
+  if (type > HeaderMapType::MAX) {
+    return WasmResult::BadArgument;
+  }
+  if (!validMemory(key_ptr, key_size) || !validMemory(value_ptr, value_size)) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  hostContext()->addHeaderMapValue(type, StringView(key_ptr, key_size),
+                                   StringView(value_ptr, value_size));
+  return WasmResult::Ok;
 }
 inline WasmResult proxy_getHeaderMapValue(HeaderMapType type, const char* key_ptr, size_t key_size,
                                           const char** value_ptr, size_t* value_size) {
-  return wordToWasmResult(getHeaderMapValueHandler(current_context_, WS(type), WR(key_ptr),
-                                                   WS(key_size), WR(value_ptr), WR(value_size)));
+  if (type > HeaderMapType::MAX) {
+    return WasmResult::BadArgument;
+  }
+  if (!validMemory(key_ptr, key_size)) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  if (!copyToPointerSize(hostContext()->getHeaderMapValue(type, StringView(key_ptr, key_size)),
+                         value_ptr, value_size)) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  return WasmResult::Ok;
 }
 inline WasmResult proxy_getHeaderMapPairs(HeaderMapType type, const char** ptr, size_t* size) {
   return wordToWasmResult(getHeaderMapPairsHandler(current_context_, WS(type), WR(ptr), WR(size)));
@@ -154,16 +218,53 @@ inline WasmResult proxy_setHeaderMapPairs(HeaderMapType type, const char* ptr, s
 inline WasmResult proxy_replaceHeaderMapValue(HeaderMapType type, const char* key_ptr,
                                               size_t key_size, const char* value_ptr,
                                               size_t value_size) {
-  return wordToWasmResult(replaceHeaderMapValueHandler(
-      current_context_, WS(type), WR(key_ptr), WS(key_size), WR(value_ptr), WS(value_size)));
+  if (type > HeaderMapType::MAX) {
+    return WasmResult::BadArgument;
+  }
+  if (!validMemory(key_ptr, key_size) || !validMemory(value_ptr, value_size)) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  hostContext()->replaceHeaderMapValue(type, StringView(key_ptr, key_size),
+                                       StringView(value_ptr, value_size));
+  return WasmResult::Ok;
 }
 inline WasmResult proxy_removeHeaderMapValue(HeaderMapType type, const char* key_ptr,
                                              size_t key_size) {
-  return wordToWasmResult(
-      removeHeaderMapValueHandler(current_context_, WS(type), WR(key_ptr), WS(key_size)));
+  if (type > HeaderMapType::MAX) {
+    return WasmResult::BadArgument;
+  }
+  if (!validMemory(key_ptr, key_size)) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  hostContext()->removeHeaderMapValue(type, StringView(key_ptr, key_size));
+  return WasmResult::Ok;
 }
 inline WasmResult proxy_getHeaderMapSize(HeaderMapType type, size_t* size) {
-  return wordToWasmResult(getHeaderMapSizeHandler(current_context_, WS(type), WR(size)));
+  if (type > HeaderMapType::MAX) {
+    return WasmResult::BadArgument;
+  }
+  if (size == nullptr) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  *size = hostContext()->getHeaderMapSize(type);
+  return WasmResult::Ok;
+}
+inline WasmResult proxy_getHeaderMapPairByIndex(HeaderMapType type, uint32_t index,
+                                                const char** key_ptr, size_t* key_size,
+                                                const char** value_ptr, size_t* value_size) {
+  if (type > HeaderMapType::MAX) {
+    return WasmResult::BadArgument;
+  }
+  std::pair<StringView, StringView> pair;
+  const WasmResult result = hostContext()->getHeaderMapPairByIndex(type, index, &pair);
+  if (result != WasmResult::Ok) {
+    return result;
+  }
+  if (!copyToPointerSize(pair.first, key_ptr, key_size) ||
+      !copyToPointerSize(pair.second, value_ptr, value_size)) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  return WasmResult::Ok;
 }
 
 // Body
@@ -177,6 +278,16 @@ inline WasmResult proxy_getResponseBodyBufferBytes(uint64_t start, uint64_t leng
   return wordToWasmResult(getResponseBodyBufferBytesHandler(current_context_, WS(start), WS(length),
                                                             WR(ptr), WR(size)));
 }
+inline WasmResult proxy_getBodyBufferSlice(BodyBufferType type, uint32_t index, const char** ptr,
+                                           size_t* size) {
+  return wordToWasmResult(
+      getBodyBufferSliceHandler(current_context_, WS(type), WS(index), WR(ptr), WR(size)));
+}
+inline WasmResult proxy_setBodyBufferBytes(BodyBufferType type, uint64_t start, uint64_t length,
+                                           const char* data_ptr, size_t data_size) {
+  return wordToWasmResult(setBodyBufferBytesHandler(current_context_, WS(type), WS(start),
+                                                    WS(length), WR(data_ptr), WS(data_size)));
+}
 
 // HTTP
 // Returns token, used in callback onHttpCallResponse
@@ -226,13 +337,22 @@ inline WasmResult proxy_defineMetric(MetricType type, const char* name_ptr, size
       defineMetricHandler(current_context_, WS(type), WR(name_ptr), WS(name_size), WR(metric_id)));
 }
 inline WasmResult proxy_incrementMetric(uint32_t metric_id, int64_t offset) {
-  return wordToWasmResult(incrementMetricHandler(current_context_, WS(metric_id), WS(offset)));
+  return hostContext()->incrementMetric(metric_id, offset);
 }
 inline WasmResult proxy_recordMetric(uint32_t metric_id, uint64_t value) {
-  return wordToWasmResult(recordMetricHandler(current_context_, WS(metric_id), WS(value)));
+  return hostContext()->recordMetric(metric_id, value);
 }
 inline WasmResult proxy_getMetric(uint32_t metric_id, uint64_t* value) {
-  return wordToWasmResult(getMetricHandler(current_context_, WS(metric_id), WR(value)));
+  uint64_t result = 0;
+  const WasmResult status = hostContext()->getMetric(metric_id, &result);
+  if (status != WasmResult::Ok) {
+    return status;
+  }
+  if (value == nullptr) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  *value = result;
+  return WasmResult::Ok;
 }
 inline WasmResult proxy_setEffectiveContext(uint64_t context_id) {
   return wordToWasmResult(setEffectiveContextHandler(current_context_, WS(context_id)));
@@ -40,7 +40,9 @@ public:
   // Extensions::Common::Wasm::WasmVm
   absl::string_view vm() override { return WasmVmNames::get().v8; }
 
-  bool load(const std::string& code, bool allow_precompiled) override;
+  bool load(absl::string_view code, bool allow_precompiled) override;
+  bool loadPrecompiled(absl::string_view code, absl::string_view precompiled) override;
+  std::string getPrecompiledCode() override;
   absl::string_view getUserSection(absl::string_view name) override;
   void link(absl::string_view debug_name, bool needs_emscripten) override;
   void setMemoryLayout(uint64_t stack_base, uint64_t heap_base,
@@ -49,9 +51,9 @@ public:
   // We don't care about this.
   void makeModule(absl::string_view) override {}
 
-  // v8 is currently not clonable.
-  bool clonable() override { return false; }
-  std::unique_ptr<WasmVm> clone() override { return nullptr; }
+  // Clones share the compiled module, but each one gets its own Store, Instance and Memory.
+  Cloneable cloneable() override { return Cloneable::CompiledBytecode; }
+  std::unique_ptr<WasmVm> clone() override;
 
   void start(Context* context) override;
 
@@ -86,6 +88,8 @@ public:
 #undef _GET_MODULE_FUNCTION
 
 private:
+  bool loadModule(absl::string_view code, absl::string_view precompiled);
+
   void callModuleFunction(Context* context, absl::string_view function_name, const wasm::Val args[],
                           wasm::Val results[]);
   void callModuleFunction(Context* context, absl::string_view function_name, const wasm::Func* func,
@@ -114,6 +118,8 @@ private:
   wasm::vec<byte_t> source_ = wasm::vec<byte_t>::invalid();
   wasm::own<wasm::Store> store_;
   wasm::own<wasm::Module> module_;
+  // Compiled module shared between this VM and all of its clones.
+  std::shared_ptr<wasm::Shared<wasm::Module>> shared_module_;
   wasm::own<wasm::Instance> instance_;
   wasm::own<wasm::Memory> memory_;
   wasm::own<wasm::Table> table_;
@@ -245,16 +251,70 @@ template <typename T, typename U> constexpr T convertValTypesToArgsTuple(const U
 
 // V8 implementation.
 
-bool V8::load(const std::string& code, bool /* allow_precompiled */) {
+bool V8::load(absl::string_view code, bool /* allow_precompiled */) {
   ENVOY_LOG(trace, "[wasm] load()");
+  return loadModule(code, "");
+}
+
+bool V8::loadPrecompiled(absl::string_view code, absl::string_view precompiled) {
+  ENVOY_LOG(trace, "[wasm] loadPrecompiled({} bytes)", precompiled.size());
+  return loadModule(code, precompiled);
+}
+
+bool V8::loadModule(absl::string_view code, absl::string_view precompiled) {
   store_ = wasm::Store::make(engine());
   RELEASE_ASSERT(store_ != nullptr, "");
 
   source_ = wasm::vec<byte_t>::make_uninitialized(code.size());
   ::memcpy(source_.get(), code.data(), code.size());
 
-  module_ = wasm::Module::make(store_.get(), source_);
-  return module_ != nullptr;
+  if (!precompiled.empty()) {
+    auto serialized = wasm::vec<byte_t>::make_uninitialized(precompiled.size());
+    ::memcpy(serialized.get(), precompiled.data(), precompiled.size());
+    module_ = wasm::Module::deserialize(store_.get(), serialized);
+    if (module_ == nullptr) {
+      ENVOY_LOG(debug, "[wasm] failed to deserialize precompiled module, compiling from source");
+    }
+  }
+  if (module_ == nullptr) {
+    module_ = wasm::Module::make(store_.get(), source_);
+  }
+  if (module_ == nullptr) {
+    return false;
+  }
+
+  shared_module_ = module_->share();
+  return shared_module_ != nullptr;
+}
+
+std::string V8::getPrecompiledCode() {
+  ENVOY_LOG(trace, "[wasm] getPrecompiledCode()");
+  ASSERT(module_ != nullptr);
+  auto serialized = module_->serialize();
+  if (serialized.get() == nullptr) {
+    return "";
+  }
+  return std::string(serialized.get(), serialized.size());
+}
+
+std::unique_ptr<WasmVm> V8::clone() {
+  ENVOY_LOG(trace, "[wasm] clone()");
+  ASSERT(shared_module_ != nullptr);
+
+  auto clone = std::make_unique<V8>();
+  clone->store_ = wasm::Store::make(engine());
+  RELEASE_ASSERT(clone->store_ != nullptr, "");
+
+  // The source is only used to read user sections, so copying it is cheap compared to compiling.
+  clone->source_ = wasm::vec<byte_t>::make_uninitialized(source_.size());
+  ::memcpy(clone->source_.get(), source_.get(), source_.size());
+
+  clone->shared_module_ = shared_module_;
+  clone->module_ = wasm::Module::obtain(clone->store_.get(), shared_module_.get());
+  if (clone->module_ == nullptr) {
+    return nullptr;
+  }
+  return clone;
 }
 
 absl::string_view V8::getUserSection(absl::string_view name) {
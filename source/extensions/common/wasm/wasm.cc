@@ -2,9 +2,13 @@
 
 #include <stdio.h>
 
+#include <array>
+#include <atomic>
 #include <limits>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "envoy/common/exception.h"
 #include "envoy/config/wasm/v2/wasm.pb.validate.h"
@@ -16,6 +20,7 @@
 
 #include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
+#include "common/common/cleanup.h"
 #include "common/common/empty_string.h"
 #include "common/common/enum_to_int.h"
 #include "common/common/logger.h"
@@ -23,14 +28,17 @@
 #include "common/http/header_map_impl.h"
 #include "common/http/message_impl.h"
 #include "common/http/utility.h"
+#include "common/protobuf/utility.h"
 #include "common/tracing/http_tracer_impl.h"
 
+#include "extensions/common/wasm/bounded_queue.h"
 #include "extensions/common/wasm/well_known_names.h"
 #include "extensions/filters/common/expr/context.h"
 
 #include "absl/base/casts.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/hash/hash.h"
 #include "absl/synchronization/mutex.h"
 #include "eval/eval/field_access.h"
 #include "eval/eval/field_backed_list_impl.h"
@@ -70,13 +78,49 @@ struct ConvertFunctionWordToUint32<void(Args...), F> {
   }
 };
 
+// Acquires a reader or writer lock on a mutex, recording whether the acquisition was contended.
+class ContendedReaderMutexLock {
+public:
+  ContendedReaderMutexLock(absl::Mutex& mutex, bool* contended) : mutex_(mutex) {
+    *contended = !mutex_.ReaderTryLock();
+    if (*contended) {
+      mutex_.ReaderLock();
+    }
+  }
+  ~ContendedReaderMutexLock() { mutex_.ReaderUnlock(); }
+
+private:
+  absl::Mutex& mutex_;
+};
+
+class ContendedWriterMutexLock {
+public:
+  ContendedWriterMutexLock(absl::Mutex& mutex, bool* contended) : mutex_(mutex) {
+    *contended = !mutex_.TryLock();
+    if (*contended) {
+      mutex_.Lock();
+    }
+  }
+  ~ContendedWriterMutexLock() { mutex_.Unlock(); }
+
+private:
+  absl::Mutex& mutex_;
+};
+
 class SharedData {
 public:
+  // The key-value data is striped across shards by the hash of (vm_id, key) so that workers
+  // accessing different keys (or different VMs) do not contend on the same lock.
+  static constexpr size_t kDataShards = 64;
+  // Capacity of a shared queue when SharedQueueConfig.max_entries is not set.
+  static constexpr uint32_t kDefaultSharedQueueMaxEntries = 4096;
+
   WasmResult get(absl::string_view vm_id, const absl::string_view key,
-                 std::pair<std::string, uint32_t>* result) {
-    absl::ReaderMutexLock l(&mutex);
-    auto map = data.find(vm_id);
-    if (map == data.end()) {
+                 std::pair<std::string, uint32_t>* result, bool* contended) {
+    auto& shard = dataShard(vm_id, key);
+    ContendedReaderMutexLock l(shard.mutex, contended);
+    auto map = shard.data.find(vm_id);
+    if (map == shard.data.end()) {
       return WasmResult::NotFound;
     }
     auto it = map->second.find(key);
@@ -88,12 +132,13 @@ public:
   }
 
   WasmResult set(absl::string_view vm_id, absl::string_view key, absl::string_view value,
-                 uint32_t cas) {
-    absl::WriterMutexLock l(&mutex);
+                 uint32_t cas, bool* contended) {
+    auto& shard = dataShard(vm_id, key);
+    ContendedWriterMutexLock l(shard.mutex, contended);
     absl::flat_hash_map<std::string, std::pair<std::string, uint32_t>>* map;
-    auto map_it = data.find(vm_id);
-    if (map_it == data.end()) {
-      map = &data[vm_id];
+    auto map_it = shard.data.find(vm_id);
+    if (map_it == shard.data.end()) {
+      map = &shard.data[vm_id];
     } else {
       map = &map_it->second;
     }
@@ -102,7 +147,8 @@ public:
       if (cas && cas != it->second.second) {
         return WasmResult::CasMismatch;
       }
-      it->second = std::make_pair(std::string(value), nextCas());
+      it->second.first.assign(value.data(), value.size());
+      it->second.second = nextCas();
     } else {
       map->emplace(key, std::make_pair(std::string(value), nextCas()));
     }
@@ -110,8 +156,9 @@ public:
   }
 
   uint32_t registerQueue(absl::string_view vm_id, absl::string_view queue_name, uint32_t context_id,
-                         Event::Dispatcher& dispatcher) {
-    absl::WriterMutexLock l(&mutex);
+                         Event::Dispatcher& dispatcher,
+                         const envoy::config::wasm::v2::SharedQueueConfig& config) {
+    absl::WriterMutexLock l(&queue_mutex);
     auto key = std::make_pair(std::string(vm_id), std::string(queue_name));
     auto it = queue_tokens.insert(std::make_pair(key, static_cast<uint32_t>(0)));
     if (it.second) {
@@ -123,12 +170,18 @@ public:
     q.vm_id = std::string(vm_id);
     q.context_id = context_id;
     q.dispatcher = &dispatcher;
+    q.drop_oldest =
+        config.overflow_policy() == envoy::config::wasm::v2::SharedQueueConfig::DROP_OLDEST;
     // Preserve any existing data.
+    if (!q.queue) {
+      q.queue = std::make_unique<BoundedQueue<std::string>>(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entries, kDefaultSharedQueueMaxEntries));
+    }
     return token;
   }
 
   uint32_t resolveQueue(absl::string_view vm_id, absl::string_view queue_name) {
-    absl::WriterMutexLock l(&mutex);
+    absl::WriterMutexLock l(&queue_mutex);
     auto key = std::make_pair(std::string(vm_id), std::string(queue_name));
     auto it = queue_tokens.find(key);
     if (it != queue_tokens.end()) {
@@ -137,30 +190,52 @@ public:
     return 0; // N.B. zero indicates that the queue was not found.
   }
 
+  // The queue map only changes on registration, so enqueue and dequeue only take the reader lock
+  // and the lock-free queue itself arbitrates between concurrent producers and consumers.
   WasmResult dequeue(uint32_t token, std::string* data) {
-    absl::ReaderMutexLock l(&mutex);
+    absl::ReaderMutexLock l(&queue_mutex);
     auto it = queues.find(token);
     if (it == queues.end()) {
       return WasmResult::NotFound;
     }
-    if (it->second.queue.empty()) {
+    if (!it->second.queue->tryPop(data)) {
       return WasmResult::Empty;
     }
-    *data = it->second.queue.front();
-    it->second.queue.pop_front();
     return WasmResult::Ok;
   }
 
-  WasmResult enqueue(uint32_t token, absl::string_view value) {
-    absl::WriterMutexLock l(&mutex);
+  WasmResult dequeueBatch(uint32_t token, uint32_t max_entries, std::vector<std::string>* data) {
+    absl::ReaderMutexLock l(&queue_mutex);
     auto it = queues.find(token);
     if (it == queues.end()) {
       return WasmResult::NotFound;
     }
-    it->second.queue.push_back(std::string(value));
-    auto vm_id = it->second.vm_id;
-    auto context_id = it->second.context_id;
-    it->second.dispatcher->post([vm_id, context_id, token] {
+    std::string entry;
+    while (data->size() < max_entries && it->second.queue->tryPop(&entry)) {
+      data->push_back(std::move(entry));
+    }
+    return data->empty() ? WasmResult::Empty : WasmResult::Ok;
+  }
+
+  WasmResult enqueue(uint32_t token, absl::string_view value, WasmStats& stats) {
+    absl::ReaderMutexLock l(&queue_mutex);
+    auto it = queues.find(token);
+    if (it == queues.end()) {
+      return WasmResult::NotFound;
+    }
+    auto& q = it->second;
+    std::string entry(value);
+    while (!q.queue->tryPush(std::move(entry))) {
+      stats.shared_queue_overflow_.inc();
+      if (!q.drop_oldest) {
+        return WasmResult::Full;
+      }
+      std::string dropped;
+      q.queue->tryPop(&dropped);
+    }
+    auto vm_id = q.vm_id;
+    auto context_id = q.context_id;
+    q.dispatcher->post([vm_id, context_id, token] {
       auto wasm = getThreadLocalWasmOrNull(vm_id);
       if (wasm) {
         wasm->queueReady(context_id, token);
@@ -170,15 +245,27 @@ public:
   }
 
   uint32_t nextCas() {
-    auto result = cas;
-    cas++;
-    if (!cas) { // 0 is not a valid CAS value.
-      cas++;
-    }
+    uint32_t result;
+    do {
+      result = cas.fetch_add(1, std::memory_order_relaxed);
+    } while (!result); // 0 is not a valid CAS value.
     return result;
   }
 
 private:
+  struct DataShard {
+    absl::Mutex mutex;
+    absl::node_hash_map<std::string,
+                        absl::flat_hash_map<std::string, std::pair<std::string, uint32_t>>>
+        data;
+  };
+
+  DataShard& dataShard(absl::string_view vm_id, absl::string_view key) {
+    return data_shards[absl::Hash<std::pair<absl::string_view, absl::string_view>>()(
+                           std::make_pair(vm_id, key)) %
+                       kDataShards];
+  }
+
   uint32_t nextQueueToken() {
     while (true) {
       uint32_t token = next_queue_token++;
@@ -195,15 +282,16 @@ private:
     std::string vm_id;
     uint32_t context_id;
     Event::Dispatcher* dispatcher;
-    std::deque<std::string> queue;
+    bool drop_oldest;
+    std::unique_ptr<BoundedQueue<std::string>> queue;
   };
 
-  absl::Mutex mutex;
-  uint32_t cas = 1;
+  std::atomic<uint32_t> cas{1};
+  std::array<DataShard, kDataShards> data_shards;
+
+  // Queues are registered rarely, so the map of queues is guarded by a single lock.
+  absl::Mutex queue_mutex;
   uint32_t next_queue_token = 1;
-  absl::node_hash_map<std::string,
-                      absl::flat_hash_map<std::string, std::pair<std::string, uint32_t>>>
-      data;
   absl::node_hash_map<uint32_t, Queue> queues;
   struct pair_hash {
     template <class T1, class T2> std::size_t operator()(const std::pair<T1, T2>& pair) const {
@@ -216,6 +304,10 @@ private:
 
 SharedData global_shared_data;
 
+// Sums over all Wasm VMs in the process, see getTotalMemoryBytes() and getTotalGuestCallTime().
+std::atomic<uint64_t> total_memory_bytes{0};
+std::atomic<uint64_t> total_guest_call_time_us{0};
+
 // Map from Wasm ID to the local Wasm instance.
 thread_local absl::flat_hash_map<std::string, std::shared_ptr<Wasm>> local_wasms;
 
@@ -356,6 +448,8 @@ const uint8_t* decodeVarint(const uint8_t* pos, const uint8_t* end, uint32_t* ou
   return pos;
 }
 
+} // namespace
+
 Context* ContextOrEffectiveContext(Context* context) {
   if (effective_context_id_ == 0) {
     return context;
@@ -368,7 +462,11 @@ Context* ContextOrEffectiveContext(Context* context) {
   return context;
 }
 
-} // namespace
+uint64_t getTotalMemoryBytes() { return total_memory_bytes.load(std::memory_order_relaxed); }
+
+std::chrono::microseconds getTotalGuestCallTime() {
+  return std::chrono::microseconds(total_guest_call_time_us.load(std::memory_order_relaxed));
+}
 
 // Test support.
 
@@ -606,6 +704,44 @@ Word dequeueSharedQueueHandler(void* raw_context, Word token, Word data_ptr_ptr,
   return wasmResultToWord(WasmResult::Ok);
 }
 
+Word dequeueSharedQueueBatchHandler(void* raw_context, Word token, Word max_entries,
+                                    Word data_ptr_ptr, Word data_size_ptr) {
+  auto context = WASM_CONTEXT(raw_context);
+  std::vector<std::string> data;
+  WasmResult result = context->dequeueSharedQueueBatch(token.u32(), max_entries.u32(), &data);
+  if (result != WasmResult::Ok) {
+    return wasmResultToWord(result);
+  }
+  uint64_t size = sizeof(uint32_t);
+  for (auto& entry : data) {
+    size += sizeof(uint32_t) + entry.size() + 1;
+  }
+  uint64_t ptr = 0;
+  void* buffer = context->wasm()->allocMemory(size, &ptr);
+  if (!buffer) {
+    return wasmResultToWord(WasmResult::InvalidMemoryAccess);
+  }
+  char* b = static_cast<char*>(buffer);
+  *reinterpret_cast<uint32_t*>(b) = data.size();
+  b += sizeof(uint32_t);
+  for (auto& entry : data) {
+    *reinterpret_cast<uint32_t*>(b) = entry.size();
+    b += sizeof(uint32_t);
+  }
+  for (auto& entry : data) {
+    memcpy(b, entry.data(), entry.size());
+    b += entry.size();
+    *b++ = 0;
+  }
+  if (!context->wasmVm()->setWord(data_ptr_ptr, Word(ptr))) {
+    return wasmResultToWord(WasmResult::InvalidMemoryAccess);
+  }
+  if (!context->wasmVm()->setWord(data_size_ptr, Word(size))) {
+    return wasmResultToWord(WasmResult::InvalidMemoryAccess);
+  }
+  return wasmResultToWord(WasmResult::Ok);
+}
+
 Word resolveSharedQueueHandler(void* raw_context, Word vm_id_ptr, Word vm_id_size,
                                Word queue_name_ptr, Word queue_name_size, Word token_ptr) {
   auto context = WASM_CONTEXT(raw_context);
@@ -718,6 +854,25 @@ Word setHeaderMapPairsHandler(void* raw_context, Word type, Word ptr, Word size)
   return wasmResultToWord(WasmResult::Ok);
 }
 
+Word getHeaderMapPairByIndexHandler(void* raw_context, Word type, Word index, Word key_ptr_ptr,
+                                    Word key_size_ptr, Word value_ptr_ptr, Word value_size_ptr) {
+  if (type > static_cast<uint64_t>(HeaderMapType::MAX)) {
+    return wasmResultToWord(WasmResult::BadArgument);
+  }
+  auto context = WASM_CONTEXT(raw_context);
+  std::pair<absl::string_view, absl::string_view> pair;
+  auto result =
+      context->getHeaderMapPairByIndex(static_cast<HeaderMapType>(type.u64), index.u32(), &pair);
+  if (result != WasmResult::Ok) {
+    return wasmResultToWord(result);
+  }
+  if (!context->wasm()->copyToPointerSize(pair.first, key_ptr_ptr, key_size_ptr) ||
+      !context->wasm()->copyToPointerSize(pair.second, value_ptr_ptr, value_size_ptr)) {
+    return wasmResultToWord(WasmResult::InvalidMemoryAccess);
+  }
+  return wasmResultToWord(WasmResult::Ok);
+}
+
 Word getHeaderMapSizeHandler(void* raw_context, Word type, Word result_ptr) {
   if (type > static_cast<uint64_t>(HeaderMapType::MAX)) {
     return wasmResultToWord(WasmResult::BadArgument);
@@ -747,6 +902,38 @@ Word getResponseBodyBufferBytesHandler(void* raw_context, Word start, Word lengt
   return wasmResultToWord(WasmResult::Ok);
 }
 
+Word getBodyBufferSliceHandler(void* raw_context, Word type, Word index, Word ptr_ptr,
+                               Word size_ptr) {
+  if (type > static_cast<uint64_t>(BodyBufferType::MAX)) {
+    return wasmResultToWord(WasmResult::BadArgument);
+  }
+  auto context = WASM_CONTEXT(raw_context);
+  absl::string_view slice;
+  auto result =
+      context->getBodyBufferSlice(static_cast<BodyBufferType>(type.u64), index.u32(), &slice);
+  if (result != WasmResult::Ok) {
+    return wasmResultToWord(result);
+  }
+  if (!context->wasm()->copyToPointerSize(slice, ptr_ptr, size_ptr)) {
+    return wasmResultToWord(WasmResult::InvalidMemoryAccess);
+  }
+  return wasmResultToWord(WasmResult::Ok);
+}
+
+Word setBodyBufferBytesHandler(void* raw_context, Word type, Word start, Word length,
+                               Word data_ptr, Word data_size) {
+  if (type > static_cast<uint64_t>(BodyBufferType::MAX)) {
+    return wasmResultToWord(WasmResult::BadArgument);
+  }
+  auto context = WASM_CONTEXT(raw_context);
+  auto data = context->wasmVm()->getMemory(data_ptr, data_size);
+  if (!data) {
+    return wasmResultToWord(WasmResult::InvalidMemoryAccess);
+  }
+  return wasmResultToWord(context->setBodyBufferBytes(static_cast<BodyBufferType>(type.u64),
+                                                      start.u64, length.u64, data.value()));
+}
+
 Word httpCallHandler(void* raw_context, Word uri_ptr, Word uri_size, Word header_pairs_ptr,
                      Word header_pairs_size, Word body_ptr, Word body_size, Word trailer_pairs_ptr,
                      Word trailer_pairs_size, Word timeout_milliseconds) {
@@ -1029,6 +1216,109 @@ Word logHandler(void* raw_context, Word level, Word address, Word size) {
   return wasmResultToWord(WasmResult::Ok);
 }
 
+namespace {
+
+// Upper bound on the arity of any call in batch_calls.
+constexpr uint32_t kMaxBatchCallArgs = 8;
+
+// Adapts a host call handler to be invoked with its arguments taken from an array of uint64_t
+// values decoded from a proxy_callBatch() buffer.
+template <typename F, F f> struct BatchCallAdapter;
+
+template <typename... Args, Word (*f)(void*, Args...)>
+struct BatchCallAdapter<Word (*)(void*, Args...), f> {
+  static constexpr uint32_t kArity = sizeof...(Args);
+  static_assert(kArity <= kMaxBatchCallArgs, "batch call handler has too many arguments");
+  static Word call(void* raw_context, const uint64_t* args) {
+    return callWithArgs(raw_context, args, std::index_sequence_for<Args...>{});
+  }
+
+private:
+  template <size_t... I>
+  static Word callWithArgs(void* raw_context, const uint64_t* args, std::index_sequence<I...>) {
+    return f(raw_context, static_cast<Args>(args[I])...);
+  }
+};
+
+struct BatchCallEntry {
+  uint32_t arity;
+  Word (*call)(void* raw_context, const uint64_t* args);
+};
+
+#define _BATCH_CALL(_fn)                                                                           \
+  BatchCallEntry {                                                                                 \
+    BatchCallAdapter<decltype(&_fn##Handler), &_fn##Handler>::kArity,                              \
+        &BatchCallAdapter<decltype(&_fn##Handler), &_fn##Handler>::call                            \
+  }
+
+// Indexed by BatchCall.
+const BatchCallEntry batch_calls[] = {
+    _BATCH_CALL(getHeaderMapValue),       _BATCH_CALL(getHeaderMapPairs),
+    _BATCH_CALL(getHeaderMapPairByIndex), _BATCH_CALL(addHeaderMapValue),
+    _BATCH_CALL(replaceHeaderMapValue),   _BATCH_CALL(removeHeaderMapValue),
+    _BATCH_CALL(getMetadata),             _BATCH_CALL(getSharedData),
+    _BATCH_CALL(incrementMetric),         _BATCH_CALL(recordMetric),
+    _BATCH_CALL(getMetric),
+};
+
+#undef _BATCH_CALL
+
+static_assert(sizeof(batch_calls) / sizeof(batch_calls[0]) ==
+                  static_cast<size_t>(BatchCall::MAX) + 1,
+              "batch_calls must have an entry for every BatchCall");
+
+} // namespace
+
+// The batch is a sequence of records, each of which is a uint32_t BatchCall, a uint32_t argument
+// count and then that many uint64_t arguments, all in little-endian order. The result of each call
+// is written as a uint32_t WasmResult to the corresponding entry of the results array. The batch
+// is validated in full before any call is made, so a malformed batch has no side effects.
+Word callBatchHandler(void* raw_context, Word batch_ptr, Word batch_size, Word results_ptr,
+                      Word results_count) {
+  auto context = WASM_CONTEXT(raw_context);
+  auto batch = context->wasmVm()->getMemory(batch_ptr, batch_size);
+  if (!batch) {
+    return wasmResultToWord(WasmResult::InvalidMemoryAccess);
+  }
+  struct DecodedCall {
+    const BatchCallEntry* entry;
+    uint64_t args[kMaxBatchCallArgs];
+  };
+  std::vector<DecodedCall> calls;
+  const char* p = batch.value().data();
+  const char* end = p + batch.value().size();
+  while (p < end) {
+    uint32_t call;
+    uint32_t arg_count;
+    if (static_cast<size_t>(end - p) < 2 * sizeof(uint32_t)) {
+      return wasmResultToWord(WasmResult::BadArgument);
+    }
+    memcpy(&call, p, sizeof(uint32_t));
+    memcpy(&arg_count, p + sizeof(uint32_t), sizeof(uint32_t));
+    p += 2 * sizeof(uint32_t);
+    if (call > static_cast<uint32_t>(BatchCall::MAX) || batch_calls[call].arity != arg_count ||
+        static_cast<size_t>(end - p) < arg_count * sizeof(uint64_t)) {
+      return wasmResultToWord(WasmResult::BadArgument);
+    }
+    calls.emplace_back();
+    calls.back().entry = &batch_calls[call];
+    memcpy(calls.back().args, p, arg_count * sizeof(uint64_t));
+    p += arg_count * sizeof(uint64_t);
+  }
+  if (calls.size() != results_count.u64) {
+    return wasmResultToWord(WasmResult::BadArgument);
+  }
+  std::vector<uint32_t> results(calls.size());
+  for (size_t i = 0; i < calls.size(); i++) {
+    results[i] = calls[i].entry->call(raw_context, calls[i].args).u32();
+  }
+  if (!context->wasmVm()->setMemory(results_ptr, calls.size() * sizeof(uint32_t),
+                                    results.data())) {
+    return wasmResultToWord(WasmResult::InvalidMemoryAccess);
+  }
+  return wasmResultToWord(WasmResult::Ok);
+}
+
 WasmResult Context::setTickPeriod(std::chrono::milliseconds tick_period) {
   wasm_->setTickPeriod(root_context_id_ ? root_context_id_ : id_, tick_period);
   return WasmResult::Ok;
@@ -1189,19 +1479,30 @@ WasmResult Context::getSelectorExpression(absl::string_view path, std::string* r
 
 // Shared Data
 WasmResult Context::getSharedData(absl::string_view key, std::pair<std::string, uint32_t>* data) {
-  return global_shared_data.get(wasm_->id(), key, data);
+  bool contended;
+  auto result = global_shared_data.get(wasm_->id(), key, data, &contended);
+  if (contended) {
+    wasm_->stats().shared_data_read_contended_.inc();
+  }
+  return result;
 }
 
 WasmResult Context::setSharedData(absl::string_view key, absl::string_view value, uint32_t cas) {
-  return global_shared_data.set(wasm_->id(), key, value, cas);
+  bool contended;
+  auto result = global_shared_data.set(wasm_->id(), key, value, cas, &contended);
+  if (contended) {
+    wasm_->stats().shared_data_write_contended_.inc();
+  }
+  return result;
 }
 
 // Shared Queue
 
 uint32_t Context::registerSharedQueue(absl::string_view queue_name) {
   // Get the id of the root context if this is a stream context because onQueueReady is on the root.
-  return global_shared_data.registerQueue(
-      wasm_->id(), queue_name, isRootContext() ? id_ : root_context_id_, wasm_->dispatcher_);
+  return global_shared_data.registerQueue(wasm_->id(), queue_name,
+                                         isRootContext() ? id_ : root_context_id_,
+                                         wasm_->dispatcher_, wasm_->sharedQueueConfig());
 }
 
 WasmResult Context::resolveSharedQueue(absl::string_view vm_id, absl::string_view queue_name,
@@ -1218,8 +1519,13 @@ WasmResult Context::dequeueSharedQueue(uint32_t token, std::string* data) {
   return global_shared_data.dequeue(token, data);
 }
 
+WasmResult Context::dequeueSharedQueueBatch(uint32_t token, uint32_t max_entries,
+                                            std::vector<std::string>* data) {
+  return global_shared_data.dequeueBatch(token, max_entries, data);
+}
+
 WasmResult Context::enqueueSharedQueue(uint32_t token, absl::string_view value) {
-  return global_shared_data.enqueue(token, value);
+  return global_shared_data.enqueue(token, value, wasm_->stats());
 }
 
 // Header/Trailer/Metadata Maps.
@@ -1314,6 +1620,30 @@ Pairs headerMapToPairs(const Http::HeaderMap* map) {
 
 Pairs Context::getHeaderMapPairs(HeaderMapType type) { return headerMapToPairs(getConstMap(type)); }
 
+WasmResult Context::getHeaderMapPairByIndex(HeaderMapType type, uint32_t index,
+                                            std::pair<absl::string_view, absl::string_view>* pair) {
+  auto map = getConstMap(type);
+  if (!map || index >= map->size()) {
+    return WasmResult::NotFound;
+  }
+  // Walk the map up to the entry rather than materializing all of the pairs.
+  struct IterateState {
+    uint32_t remaining;
+    std::pair<absl::string_view, absl::string_view>* pair;
+  } state{index, pair};
+  map->iterate(
+      [](const Http::HeaderEntry& header, void* state) -> Http::HeaderMap::Iterate {
+        auto s = static_cast<IterateState*>(state);
+        if (s->remaining-- > 0) {
+          return Http::HeaderMap::Iterate::Continue;
+        }
+        *s->pair = std::make_pair(header.key().getStringView(), header.value().getStringView());
+        return Http::HeaderMap::Iterate::Break;
+      },
+      &state);
+  return WasmResult::Ok;
+}
+
 void Context::setHeaderMapPairs(HeaderMapType type, const Pairs& pairs) {
   auto map = getMap(type);
   if (!map) {
@@ -1391,6 +1721,61 @@ absl::string_view Context::getResponseBodyBufferBytes(uint32_t start, uint32_t l
       static_cast<char*>(responseBodyBuffer_->linearize(start + length)) + start, length);
 }
 
+Buffer::Instance* Context::getBodyBuffer(BodyBufferType type) {
+  switch (type) {
+  case BodyBufferType::RequestBody:
+    return requestBodyBuffer_;
+  case BodyBufferType::ResponseBody:
+    return responseBodyBuffer_;
+  }
+  return nullptr;
+}
+
+WasmResult Context::getBodyBufferSlice(BodyBufferType type, uint32_t index,
+                                       absl::string_view* slice) {
+  auto buffer = getBodyBuffer(type);
+  if (!buffer) {
+    return WasmResult::NotFound;
+  }
+  uint64_t num_slices = buffer->getRawSlices(nullptr, 0);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  buffer->getRawSlices(slices.begin(), num_slices);
+  // Empty slices are skipped so that the guest sees only the slices which carry data.
+  for (const Buffer::RawSlice& raw_slice : slices) {
+    if (raw_slice.len_ == 0) {
+      continue;
+    }
+    if (index-- == 0) {
+      *slice = absl::string_view(static_cast<const char*>(raw_slice.mem_), raw_slice.len_);
+      return WasmResult::Ok;
+    }
+  }
+  return WasmResult::NotFound;
+}
+
+WasmResult Context::setBodyBufferBytes(BodyBufferType type, uint64_t start, uint64_t length,
+                                       absl::string_view data) {
+  auto buffer = getBodyBuffer(type);
+  if (!buffer) {
+    return WasmResult::NotFound;
+  }
+  if (start > buffer->length() || length > buffer->length() - start) {
+    return WasmResult::BadArgument;
+  }
+  if (start == buffer->length()) {
+    buffer->add(data);
+    return WasmResult::Ok;
+  }
+  // Move the untouched prefix aside so that the replaced range can be drained from the front
+  // without linearizing the buffer.
+  Buffer::OwnedImpl prefix;
+  prefix.move(*buffer, start);
+  buffer->drain(length);
+  buffer->prepend(data);
+  buffer->prepend(prefix);
+  return WasmResult::Ok;
+}
+
 // Async call via HTTP
 uint32_t Context::httpCall(absl::string_view cluster, const Pairs& request_headers,
                            absl::string_view request_body, const Pairs& request_trailers,
@@ -1935,7 +2320,17 @@ void Context::onConfigure(absl::string_view configuration) {
   wasm_->onConfigure_(this, id_, address, configuration.size());
 }
 
+void Context::onLogBatch(absl::string_view records) {
+  if (!wasm_->onLogBatch_)
+    return;
+  if (records.empty())
+    return;
+  auto address = wasm_->copyString(records);
+  wasm_->onLogBatch_(this, id_, address, records.size());
+}
+
 void Context::onCreate(uint32_t root_context_id) {
+  created_ = true;
   if (wasm_->onCreate_) {
     wasm_->onCreate_(this, id_, root_context_id);
   }
@@ -2188,7 +2583,8 @@ Wasm::Wasm(absl::string_view vm, absl::string_view id, absl::string_view vm_conf
     : cluster_manager_(cluster_manager), dispatcher_(dispatcher), scope_(scope),
       direction_(direction), local_info_(local_info), listener_metadata_(listener_metadata),
       owned_scope_(owned_scope), time_source_(dispatcher.timeSource()),
-      vm_configuration_(vm_configuration), stat_name_set_(scope_.symbolTable()) {
+      stats_(generateStats(scope_)), vm_configuration_(vm_configuration),
+      stat_name_set_(scope_.symbolTable()) {
   wasm_vm_ = Common::Wasm::createWasmVm(vm);
   id_ = std::string(id);
 }
@@ -2260,6 +2656,7 @@ void Wasm::registerCallbacks() {
       &ConvertFunctionWordToUint32<decltype(_fn##Handler),                                         \
                                    _fn##Handler>::convertFunctionWordToUint32);
   _REGISTER_PROXY(log);
+  _REGISTER_PROXY(callBatch);
 
   _REGISTER_PROXY(getMetadata);
   _REGISTER_PROXY(setMetadata);
@@ -2279,6 +2676,7 @@ void Wasm::registerCallbacks() {
   _REGISTER_PROXY(registerSharedQueue);
   _REGISTER_PROXY(resolveSharedQueue);
   _REGISTER_PROXY(dequeueSharedQueue);
+  _REGISTER_PROXY(dequeueSharedQueueBatch);
   _REGISTER_PROXY(enqueueSharedQueue);
 
   _REGISTER_PROXY(getHeaderMapValue);
@@ -2288,9 +2686,12 @@ void Wasm::registerCallbacks() {
   _REGISTER_PROXY(getHeaderMapPairs);
   _REGISTER_PROXY(setHeaderMapPairs);
   _REGISTER_PROXY(getHeaderMapSize);
+  _REGISTER_PROXY(getHeaderMapPairByIndex);
 
   _REGISTER_PROXY(getRequestBodyBufferBytes);
   _REGISTER_PROXY(getResponseBodyBufferBytes);
+  _REGISTER_PROXY(getBodyBufferSlice);
+  _REGISTER_PROXY(setBodyBufferBytes);
 
   _REGISTER_PROXY(httpCall);
 
@@ -2328,6 +2729,52 @@ void Wasm::establishEnvironment() {
   }
 }
 
+template <typename R, typename... Args>
+void Wasm::accountGuestCalls(std::function<R(Context*, Args...)>* function) {
+  if (!*function) {
+    return;
+  }
+  *function = [this, call = std::move(*function)](Context* context, Args... args) -> R {
+    onGuestCallStart();
+    Cleanup end([this] { onGuestCallEnd(); });
+    return call(context, args...);
+  };
+}
+
+void Wasm::onGuestCallStart() {
+  if (guest_call_depth_++ == 0) {
+    guest_call_start_ = time_source_.monotonicTime();
+  }
+}
+
+void Wasm::onGuestCallEnd() {
+  if (--guest_call_depth_ != 0) {
+    return;
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      time_source_.monotonicTime() - guest_call_start_);
+  stats_.guest_calls_.inc();
+  stats_.guest_call_time_us_.add(elapsed.count());
+  total_guest_call_time_us.fetch_add(elapsed.count(), std::memory_order_relaxed);
+  // Linear memory only grows, but keep the accounting symmetric so ~Wasm can release it.
+  const uint64_t memory_bytes = wasm_vm_->getMemorySize();
+  if (memory_bytes != accounted_memory_bytes_) {
+    if (memory_bytes > accounted_memory_bytes_) {
+      stats_.memory_bytes_.add(memory_bytes - accounted_memory_bytes_);
+    } else {
+      stats_.memory_bytes_.sub(accounted_memory_bytes_ - memory_bytes);
+    }
+    total_memory_bytes.fetch_add(memory_bytes - accounted_memory_bytes_,
+                                 std::memory_order_relaxed);
+    accounted_memory_bytes_ = memory_bytes;
+  }
+}
+
+Wasm::~Wasm() {
+  stats_.memory_bytes_.sub(accounted_memory_bytes_);
+  total_memory_bytes.fetch_sub(accounted_memory_bytes_, std::memory_order_relaxed);
+}
+
 void Wasm::getFunctions() {
 #define _GET(_fn) wasm_vm_->getFunction("_" #_fn, &_fn##_);
   _GET(malloc);
@@ -2335,10 +2782,13 @@ void Wasm::getFunctions() {
   _GET(__errno_location);
 #undef _GET
 
-#define _GET_PROXY(_fn) wasm_vm_->getFunction("_proxy_" #_fn, &_fn##_);
+#define _GET_PROXY(_fn)                                                                            \
+  wasm_vm_->getFunction("_proxy_" #_fn, &_fn##_);                                                  \
+  accountGuestCalls(&_fn##_);
   _GET_PROXY(onStart);
   _GET_PROXY(onConfigure);
   _GET_PROXY(onTick);
+  _GET_PROXY(onLogBatch);
 
   _GET_PROXY(onCreate);
   _GET_PROXY(onRequestHeaders);
@@ -2359,6 +2809,7 @@ void Wasm::getFunctions() {
   _GET_PROXY(onDone);
   _GET_PROXY(onLog);
   _GET_PROXY(onDelete);
+  _GET_PROXY(onReset);
 #undef _GET_PROXY
 
   if (!malloc_ || !free_) {
@@ -2371,19 +2822,48 @@ Wasm::Wasm(const Wasm& wasm, Event::Dispatcher& dispatcher)
       dispatcher_(dispatcher), scope_(wasm.scope_), direction_(wasm.direction_),
       local_info_(wasm.local_info_), listener_metadata_(wasm.listener_metadata_), id_(wasm.id_),
       owned_scope_(wasm.owned_scope_), time_source_(dispatcher.timeSource()),
-      stat_name_set_(scope_.symbolTable()) {
+      stats_(generateStats(scope_)), stat_name_set_(scope_.symbolTable()) {
   wasm_vm_ = wasm.wasmVm()->clone();
-  vm_context_ = std::make_shared<Context>(this);
-  getFunctions();
+  started_from_ = wasm.wasmVm()->cloneable();
+  shared_queue_config_ = wasm.sharedQueueConfig();
+  if (started_from_ == Cloneable::InstantiatedModule) {
+    vm_context_ = std::make_shared<Context>(this);
+    getFunctions();
+  }
+  // Otherwise the clone shares the compiled module and initialize() must be called to link and
+  // start it.
+}
+
+bool Wasm::loadCode(absl::string_view code, bool allow_precompiled) {
+  if (!compilation_cache_) {
+    return wasm_vm_->load(code, allow_precompiled);
+  }
+  const auto key = CompilationCache::key(wasm_vm_->vm(), code);
+  auto precompiled = compilation_cache_->lookup(key);
+  if (precompiled) {
+    return wasm_vm_->loadPrecompiled(code, precompiled.value());
+  }
+  if (!wasm_vm_->load(code, allow_precompiled)) {
+    return false;
+  }
+  compilation_cache_->insert(key, wasm_vm_->getPrecompiledCode());
+  return true;
 }
 
 bool Wasm::initialize(const std::string& code, absl::string_view name, bool allow_precompiled) {
+  return initialize(std::make_shared<Config::DataSource::StringContents>(std::string(code)), name,
+                    allow_precompiled);
+}
+
+bool Wasm::initialize(Config::DataSource::ContentsConstSharedPtr code, absl::string_view name,
+                      bool allow_precompiled) {
   if (!wasm_vm_) {
     return false;
   }
-  auto ok = wasm_vm_->load(code, allow_precompiled);
-  if (!ok) {
-    return false;
+  if (started_from_ == Cloneable::NotCloneable) {
+    if (!loadCode(code->data(), allow_precompiled)) {
+      return false;
+    }
   }
   auto metadata = wasm_vm_->getUserSection("emscripten_metadata");
   if (!metadata.empty()) {
@@ -2424,7 +2904,10 @@ bool Wasm::initialize(const std::string& code, absl::string_view name, bool allo
     ASSERT(std::isnan(global_NaN_->get()));
     ASSERT(std::isinf(global_Infinity_->get()));
   }
-  code_ = code;
+  // Clones are never used as a base_wasm, so there is no need to keep another copy of the code.
+  if (started_from_ == Cloneable::NotCloneable) {
+    code_ = std::move(code);
+  }
   allow_precompiled_ = allow_precompiled;
   return true;
 }
@@ -2506,6 +2989,39 @@ uint32_t Wasm::allocContextId() {
   }
 }
 
+std::shared_ptr<Context> Wasm::createStreamContext(uint32_t root_context_id) {
+  if (!onReset_) {
+    return std::make_shared<Context>(this, root_context_id);
+  }
+  Context* context;
+  auto& pool = context_pool_[root_context_id];
+  if (!pool.empty()) {
+    context = pool.back().release();
+    pool.pop_back();
+    stats_.recycled_contexts_.inc();
+  } else {
+    context = new Context(this, root_context_id);
+  }
+  context->pooled_ = true;
+  // The deleter keeps this Wasm alive so that the context can be returned to the pool.
+  return std::shared_ptr<Context>(context, [wasm = shared_from_this()](Context* context) {
+    wasm->releaseStreamContext(context);
+  });
+}
+
+void Wasm::releaseStreamContext(Context* released) {
+  std::unique_ptr<Context> context(released);
+  auto& pool = context_pool_[context->root_context_id_];
+  if (pool.size() < kMaxPooledContexts && context->recycle()) {
+    pool.push_back(std::move(context));
+    return;
+  }
+  context->pooled_ = false;
+  if (context->created_) {
+    context->onDelete();
+  }
+}
+
 void Wasm::queueReady(uint32_t root_context_id, uint32_t token) {
   auto it = contexts_.find(root_context_id);
   if (it == contexts_.end() || !it->second->isRootContext()) {
@@ -2534,6 +3050,14 @@ void Wasm::log(absl::string_view root_id, const Http::HeaderMap* request_headers
   context->log(request_headers, response_headers, response_trailers, stream_info);
 }
 
+void Wasm::logBatch(absl::string_view root_id, absl::string_view records) {
+  Context* context = getRootContext(root_id);
+  if (!context) {
+    return;
+  }
+  context->onLogBatch(records);
+}
+
 void Context::log(const Http::HeaderMap* request_headers, const Http::HeaderMap* response_headers,
                   const Http::HeaderMap* response_trailers,
                   const StreamInfo::StreamInfo& stream_info) {
@@ -2575,11 +3099,55 @@ void Context::onLog() {
 }
 
 void Context::onDelete() {
+  if (pooled_) {
+    return; // Either onReset() or onDelete() is called by Wasm::releaseStreamContext().
+  }
   if (wasm_->onDelete_) {
     wasm_->onDelete_(this, id_);
   }
 }
 
+bool Context::onReset() {
+  if (wasm_->onReset_) {
+    return wasm_->onReset_(this, id_).u64 != 0;
+  }
+  return false;
+}
+
+bool Context::recycle() {
+  // Pending async calls still reference this context.
+  if (!created_ || !http_request_.empty() || !grpc_call_request_.empty() || !grpc_stream_.empty()) {
+    return false;
+  }
+  if (!onReset()) {
+    return false;
+  }
+  destroyed_ = false;
+  decoder_callbacks_ = nullptr;
+  encoder_callbacks_ = nullptr;
+  // A guest call which failed may have left pointers into the previous stream behind.
+  request_headers_ = nullptr;
+  response_headers_ = nullptr;
+  requestBodyBuffer_ = nullptr;
+  responseBodyBuffer_ = nullptr;
+  request_end_of_stream_ = false;
+  response_end_of_stream_ = false;
+  request_trailers_ = nullptr;
+  response_trailers_ = nullptr;
+  request_metadata_ = nullptr;
+  response_metadata_ = nullptr;
+  grpc_create_initial_metadata_ = nullptr;
+  grpc_receive_initial_metadata_.reset();
+  grpc_receive_trailing_metadata_.reset();
+  access_log_stream_info_ = nullptr;
+  access_log_request_headers_ = nullptr;
+  access_log_response_headers_ = nullptr;
+  access_log_request_trailers_ = nullptr;
+  access_log_response_trailers_ = nullptr;
+  temporary_metadata_.Clear();
+  return true;
+}
+
 Http::FilterHeadersStatus Context::decodeHeaders(Http::HeaderMap& headers, bool end_stream) {
   request_headers_ = &headers;
   request_end_of_stream_ = end_stream;
@@ -2805,10 +3373,16 @@ static std::shared_ptr<Wasm> createWasmInternal(
   auto wasm = std::make_shared<Wasm>(vm_config.vm(), vm_id, vm_config.configuration(),
                                      cluster_manager, dispatcher, scope, direction, local_info,
                                      listener_metadata, scope_ptr);
-  const auto& code = Config::DataSource::read(vm_config.code(), true, api);
+  if (!vm_config.compilation_cache_dir().empty()) {
+    wasm->setCompilationCache(
+        std::make_shared<CompilationCache>(api, vm_config.compilation_cache_dir()));
+  }
+  wasm->setSharedQueueConfig(vm_config.shared_queue_config());
+  Config::DataSource::ContentsConstSharedPtr code =
+      Config::DataSource::readShared(vm_config.code(), true, api);
   const auto& path = Config::DataSource::getPath(vm_config.code())
-                         .value_or(code.empty() ? EMPTY_STRING : INLINE_STRING);
-  if (code.empty()) {
+                         .value_or(code->data().empty() ? EMPTY_STRING : INLINE_STRING);
+  if (code->data().empty()) {
     throw WasmException(fmt::format("Failed to load WASM code from {}", path));
   }
   if (!wasm->initialize(code, vm_id, vm_config.allow_precompiled())) {
@@ -2851,18 +3425,30 @@ std::shared_ptr<Wasm> createThreadLocalWasm(Wasm& base_wasm, absl::string_view r
                                             Event::Dispatcher& dispatcher) {
   std::shared_ptr<Wasm> wasm;
   Context* root_context;
-  if (base_wasm.wasmVm()->clonable()) {
+  switch (base_wasm.wasmVm()->cloneable()) {
+  case Cloneable::InstantiatedModule:
     wasm = std::make_shared<Wasm>(base_wasm, dispatcher);
     root_context = wasm->start(root_id, base_wasm.vm_configuration());
-  } else {
+    break;
+  case Cloneable::CompiledBytecode:
+    wasm = std::make_shared<Wasm>(base_wasm, dispatcher);
+    if (!wasm->initialize(base_wasm.code(), base_wasm.id(), base_wasm.allow_precompiled())) {
+      throw WasmException("Failed to initialize WASM code");
+    }
+    root_context = wasm->start(root_id, base_wasm.vm_configuration());
+    break;
+  case Cloneable::NotCloneable:
     wasm = std::make_shared<Wasm>(
         base_wasm.wasmVm()->vm(), base_wasm.id(), base_wasm.vm_configuration(),
         base_wasm.clusterManager(), dispatcher, base_wasm.scope(), base_wasm.direction(),
         base_wasm.localInfo(), base_wasm.listenerMetadata(), nullptr /* owned scope */);
+    wasm->setCompilationCache(base_wasm.compilationCache());
+    wasm->setSharedQueueConfig(base_wasm.sharedQueueConfig());
     if (!wasm->initialize(base_wasm.code(), base_wasm.id(), base_wasm.allow_precompiled())) {
       throw WasmException("Failed to initialize WASM code");
     }
     root_context = wasm->start(root_id, base_wasm.vm_configuration());
+    break;
   }
   wasm->configure(root_context, configuration);
   if (!wasm->id().empty()) {
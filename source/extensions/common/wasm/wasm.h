@@ -11,14 +11,17 @@
 #include "envoy/server/wasm.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/common/assert.h"
 #include "common/common/logger.h"
 #include "common/common/stack_array.h"
+#include "common/config/datasource.h"
 #include "common/stats/symbol_table_impl.h"
 
+#include "extensions/common/wasm/compilation_cache.h"
 #include "extensions/common/wasm/wasm_vm.h"
 #include "extensions/common/wasm/well_known_names.h"
 #include "extensions/filters/http/well_known_names.h"
@@ -40,6 +43,10 @@ using PairsWithStringValues = std::vector<std::pair<absl::string_view, std::stri
 
 enum class StreamType : int32_t { Request = 0, Response = 1, MAX = 1 };
 
+// The context host calls apply to: the effective context set by the VM if it still exists, else
+// the given context.
+Context* ContextOrEffectiveContext(Context* context);
+
 // Handlers for functions exported from envoy to wasm.
 Word logHandler(void* raw_context, Word level, Word address, Word size);
 Word getMetadataHandler(void* raw_context, Word type, Word key_ptr, Word key_size,
@@ -70,6 +77,8 @@ Word resolveSharedQueueHandler(void* raw_context, Word vm_id_ptr, Word vm_id_siz
                                Word queue_name_ptr, Word queue_name_size, Word token_ptr);
 Word dequeueSharedQueueHandler(void* raw_context, Word token, Word data_ptr_ptr,
                                Word data_size_ptr);
+Word dequeueSharedQueueBatchHandler(void* raw_context, Word token, Word max_entries,
+                                    Word data_ptr_ptr, Word data_size_ptr);
 Word enqueueSharedQueueHandler(void* raw_context, Word token, Word data_ptr, Word data_size);
 Word addHeaderMapValueHandler(void* raw_context, Word type, Word key_ptr, Word key_size,
                               Word value_ptr, Word value_size);
@@ -81,8 +90,14 @@ Word removeHeaderMapValueHandler(void* raw_context, Word type, Word key_ptr, Wor
 Word getHeaderMapPairsHandler(void* raw_context, Word type, Word ptr_ptr, Word size_ptr);
 Word setHeaderMapPairsHandler(void* raw_context, Word type, Word ptr, Word size);
 Word getHeaderMapSizeHandler(void* raw_context, Word type, Word result_ptr);
+Word getHeaderMapPairByIndexHandler(void* raw_context, Word type, Word index, Word key_ptr_ptr,
+                                    Word key_size_ptr, Word value_ptr_ptr, Word value_size_ptr);
 Word getRequestBodyBufferBytesHandler(void* raw_context, Word start, Word length, Word ptr_ptr,
                                       Word size_ptr);
+Word getBodyBufferSliceHandler(void* raw_context, Word type, Word index, Word ptr_ptr,
+                               Word size_ptr);
+Word setBodyBufferBytesHandler(void* raw_context, Word type, Word start, Word length,
+                               Word data_ptr, Word data_size);
 Word getResponseBodyBufferBytesHandler(void* raw_context, Word start, Word length, Word ptr_ptr,
                                        Word size_ptr);
 Word httpCallHandler(void* raw_context, Word uri_ptr, Word uri_size, Word header_pairs_ptr,
@@ -108,6 +123,8 @@ Word setTickPeriodMillisecondsHandler(void* raw_context, Word tick_period_millis
 Word getCurrentTimeNanosecondsHandler(void* raw_context, Word result_uint64_ptr);
 
 Word setEffectiveContextHandler(void* raw_context, Word context_id);
+Word callBatchHandler(void* raw_context, Word batch_ptr, Word batch_size, Word results_ptr,
+                      Word results_count);
 
 inline MetadataType StreamType2MetadataType(StreamType type) {
   return static_cast<MetadataType>(type);
@@ -180,6 +197,8 @@ public:
   //
   virtual void onStart(absl::string_view root_id, absl::string_view vm_configuration);
   virtual void onConfigure(absl::string_view configuration);
+  // Log records delivered in a batch, serialized as a list of pairs.
+  virtual void onLogBatch(absl::string_view records);
 
   //
   // Stream downcalls on Context(id > 0).
@@ -206,6 +225,9 @@ public:
   virtual void onLog();
   // General stream downcall when no further stream calls will occur.
   virtual void onDelete();
+  // General stream downcall when the context is recycled for a new stream instead of being
+  // deleted. Returns false if the VM did not reset its state, in which case it is deleted.
+  virtual bool onReset();
 
   //
   // General Callbacks.
@@ -305,6 +327,8 @@ public:
   virtual WasmResult resolveSharedQueue(absl::string_view vm_id, absl::string_view queue_name,
                                         uint32_t* token);
   virtual WasmResult dequeueSharedQueue(uint32_t token, std::string* data);
+  virtual WasmResult dequeueSharedQueueBatch(uint32_t token, uint32_t max_entries,
+                                             std::vector<std::string>* data);
   virtual WasmResult enqueueSharedQueue(uint32_t token, absl::string_view value);
 
   // Header/Trailer/Metadata Maps
@@ -312,6 +336,9 @@ public:
                                  absl::string_view value);
   virtual absl::string_view getHeaderMapValue(HeaderMapType type, absl::string_view key);
   virtual Pairs getHeaderMapPairs(HeaderMapType type);
+  // Returns NotFound if index is past the end of the map.
+  virtual WasmResult getHeaderMapPairByIndex(HeaderMapType type, uint32_t index,
+                                             std::pair<absl::string_view, absl::string_view>* pair);
   virtual void setHeaderMapPairs(HeaderMapType type, const Pairs& pairs);
 
   virtual void removeHeaderMapValue(HeaderMapType type, absl::string_view key);
@@ -323,6 +350,13 @@ public:
   // Body Buffer
   virtual absl::string_view getRequestBodyBufferBytes(uint32_t start, uint32_t length);
   virtual absl::string_view getResponseBodyBufferBytes(uint32_t start, uint32_t length);
+  // Returns the index-th non-empty slice of the body buffer, NotFound past the last slice.
+  virtual WasmResult getBodyBufferSlice(BodyBufferType type, uint32_t index,
+                                        absl::string_view* slice);
+  // Replaces [start, start + length) of the body buffer with data. A zero length inserts, e.g.
+  // start == 0 prepends and start == buffer length appends.
+  virtual WasmResult setBodyBufferBytes(BodyBufferType type, uint64_t start, uint64_t length,
+                                        absl::string_view data);
 
   // HTTP
   // Returns a token which will be used with the corresponding onHttpCallResponse.
@@ -388,8 +422,11 @@ protected:
 
   Http::HeaderMap* getMap(HeaderMapType type);
   const Http::HeaderMap* getConstMap(HeaderMapType type);
+  Buffer::Instance* getBodyBuffer(BodyBufferType type);
 
   std::string makeLogPrefix() const;
+  // Reset the per-stream state so that the context can be reused by Wasm::createStreamContext().
+  bool recycle();
 
   Wasm* wasm_;
   uint32_t id_;
@@ -398,6 +435,8 @@ protected:
   const std::string root_id_;      // set only in roots.
   std::string log_prefix_;
   bool destroyed_ = false;
+  bool created_ = false; // onCreate() has been called in the VM.
+  bool pooled_ = false;  // Released to the Wasm context pool, so onDelete() is deferred.
 
   uint32_t next_http_call_token_ = 1;
   uint32_t next_grpc_token_ = 1; // Odd tokens are for Calls even for Streams.
@@ -434,6 +473,30 @@ protected:
   ProtobufWkt::Struct temporary_metadata_;
 };
 
+/**
+ * All Wasm stats. @see stats_macros.h
+ */
+#define ALL_WASM_STATS(COUNTER, GAUGE)                                                             \
+  COUNTER(guest_calls)                                                                             \
+  COUNTER(guest_call_time_us)                                                                      \
+  COUNTER(overload_bypassed)                                                                       \
+  COUNTER(recycled_contexts)                                                                       \
+  COUNTER(shared_data_read_contended)                                                              \
+  COUNTER(shared_data_write_contended)                                                             \
+  COUNTER(shared_queue_overflow)                                                                   \
+  GAUGE(memory_bytes, NeverImport)
+
+/**
+ * Struct definition for all Wasm stats. @see stats_macros.h
+ */
+struct WasmStats {
+  ALL_WASM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+// Process-wide resource usage of all Wasm VMs, e.g. for the Wasm resource monitor.
+uint64_t getTotalMemoryBytes();
+std::chrono::microseconds getTotalGuestCallTime();
+
 // Wasm execution instance. Manages the Envoy side of the Wasm interface.
 class Wasm : public Envoy::Server::Wasm,
              public ThreadLocal::ThreadLocalObject,
@@ -446,8 +509,11 @@ public:
        const envoy::api::v2::core::Metadata* listener_metadata,
        Stats::ScopeSharedPtr owned_scope = nullptr);
   Wasm(const Wasm& other, Event::Dispatcher& dispatcher);
-  ~Wasm() {}
+  ~Wasm();
 
+  // The code is shared with the other Wasm(s) loading the same DataSource, e.g. a mapped file.
+  bool initialize(Config::DataSource::ContentsConstSharedPtr code, absl::string_view name,
+                  bool allow_precompiled);
   bool initialize(const std::string& code, absl::string_view name, bool allow_precompiled);
   void configure(Context* root_context, absl::string_view configuration);
   Context* start(absl::string_view root_id,
@@ -465,6 +531,7 @@ public:
   }
   Upstream::ClusterManager& clusterManager() const { return cluster_manager_; }
   Stats::Scope& scope() const { return scope_; }
+  WasmStats& stats() { return stats_; }
   PluginDirection direction() { return direction_; }
   const LocalInfo::LocalInfo& localInfo() { return local_info_; }
   const envoy::api::v2::core::Metadata* listenerMetadata() { return listener_metadata_; }
@@ -474,10 +541,25 @@ public:
   void queueReady(uint32_t root_context_id, uint32_t token);
 
   uint32_t allocContextId();
+  // Create a stream context, reusing a released one if the VM supports onReset(). With a steady
+  // stream rate this avoids allocating a context on both sides of the VM for each stream.
+  std::shared_ptr<Context> createStreamContext(uint32_t root_context_id);
 
-  const std::string& code() const { return code_; }
+  const Config::DataSource::ContentsConstSharedPtr& code() const { return code_; }
   const std::string& vm_configuration() const { return vm_configuration_; }
   bool allow_precompiled() const { return allow_precompiled_; }
+  // If set, native code is loaded from and stored into the cache by initialize().
+  void setCompilationCache(CompilationCacheSharedPtr cache) {
+    compilation_cache_ = std::move(cache);
+  }
+  const CompilationCacheSharedPtr& compilationCache() const { return compilation_cache_; }
+  // Applied to the shared queues registered by this Wasm.
+  void setSharedQueueConfig(const envoy::config::wasm::v2::SharedQueueConfig& config) {
+    shared_queue_config_ = config;
+  }
+  const envoy::config::wasm::v2::SharedQueueConfig& sharedQueueConfig() const {
+    return shared_queue_config_;
+  }
   void setInitialConfiguration(const std::string& vm_configuration) {
     vm_configuration_ = vm_configuration;
   }
@@ -488,6 +570,7 @@ public:
   void log(absl::string_view root_id, const Http::HeaderMap* request_headers,
            const Http::HeaderMap* response_headers, const Http::HeaderMap* response_trailers,
            const StreamInfo::StreamInfo& stream_info);
+  void logBatch(absl::string_view root_id, absl::string_view records);
 
   // Support functions.
   void* allocMemory(uint64_t size, uint64_t* address);
@@ -531,6 +614,8 @@ private:
   static const uint32_t kMetricTypeHistogram = 0x2;
   static const uint32_t kMetricTypeMask = 0x3;
   static const uint32_t kMetricIdIncrement = 0x4;
+  // Maximum number of released stream contexts kept per root context.
+  static const size_t kMaxPooledContexts = 1024;
   static void StaticAsserts() {
     static_assert(static_cast<uint32_t>(Context::MetricType::Counter) == kMetricTypeCounter, "");
     static_assert(static_cast<uint32_t>(Context::MetricType::Gauge) == kMetricTypeGauge, "");
@@ -551,6 +636,21 @@ private:
   uint32_t nextGaugeMetricId() { return next_gauge_metric_id_ += kMetricIdIncrement; }
   uint32_t nextHistogramMetricId() { return next_histogram_metric_id_ += kMetricIdIncrement; }
 
+  // Load the code, using and populating the compilation cache if one is set.
+  bool loadCode(absl::string_view code, bool allow_precompiled);
+  static WasmStats generateStats(Stats::Scope& scope) {
+    return {ALL_WASM_STATS(POOL_COUNTER_PREFIX(scope, "wasm."),
+                           POOL_GAUGE_PREFIX(scope, "wasm."))};
+  }
+
+  // Wrap a call into the VM so that the time spent in the guest and its memory are accounted.
+  template <typename R, typename... Args>
+  void accountGuestCalls(std::function<R(Context*, Args...)>* function);
+  void onGuestCallStart();
+  void onGuestCallEnd();
+
+  void releaseStreamContext(Context* context);
+
   void registerCallbacks();    // Register functions called out from WASM.
   void establishEnvironment(); // Language specific environments.
   void getFunctions();         // Get functions call into WASM.
@@ -568,11 +668,19 @@ private:
                                         // (e.g. for global constructors).
   absl::flat_hash_map<std::string, std::unique_ptr<Context>> root_contexts_;
   absl::flat_hash_map<uint32_t, Context*> contexts_;                    // Contains all contexts.
+  // Released stream contexts per root context id. Must be destroyed before contexts_.
+  absl::flat_hash_map<uint32_t, std::vector<std::unique_ptr<Context>>> context_pool_;
   std::unordered_map<uint32_t, std::chrono::milliseconds> tick_period_; // per root_id.
   std::unordered_map<uint32_t, Event::TimerPtr> timer_;                 // per root_id.
   Stats::ScopeSharedPtr
       owned_scope_; // When scope_ is not owned by a higher level (e.g. for WASM services).
   TimeSource& time_source_;
+  WasmStats stats_;
+  // Guest calls can nest (e.g. a local reply sent from onRequestHeaders runs onResponseHeaders),
+  // in which case only the outermost call is timed.
+  uint32_t guest_call_depth_ = 0;
+  MonotonicTime guest_call_start_;
+  uint64_t accounted_memory_bytes_ = 0;
 
   WasmCall1Word malloc_;
   WasmCall1Void free_;
@@ -582,6 +690,7 @@ private:
   WasmCall5Void onStart_;
   WasmCall3Void onConfigure_;
   WasmCall1Void onTick_;
+  WasmCall3Void onLogBatch_;
 
   WasmCall2Void onCreate_;
 
@@ -608,11 +717,16 @@ private:
   WasmCall1Void onDone_;
   WasmCall1Void onLog_;
   WasmCall1Void onDelete_;
+  WasmCall1Word onReset_;
 
   // Used by the base_wasm to enable non-clonable thread local Wasm(s) to be constructed.
-  std::string code_;
+  Config::DataSource::ContentsConstSharedPtr code_;
+  // How the VM of this Wasm was created: from scratch (NotCloneable) or cloned from a base VM.
+  Cloneable started_from_ = Cloneable::NotCloneable;
   std::string vm_configuration_;
   bool allow_precompiled_ = false;
+  CompilationCacheSharedPtr compilation_cache_;
+  envoy::config::wasm::v2::SharedQueueConfig shared_queue_config_;
 
   bool is_emscripten_ = false;
   uint32_t emscripten_metadata_major_version_ = 0;
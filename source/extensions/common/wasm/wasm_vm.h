@@ -100,20 +100,36 @@ using WasmCallback9Word = Word (*)(void*, Word, Word, Word, Word, Word, Word, Wo
 using WasmCallback_WWl = Word (*)(void*, Word, int64_t);
 using WasmCallback_WWm = Word (*)(void*, Word, uint64_t);
 
+// The cloneable attribute of a WasmVm implementation.
+enum class Cloneable {
+  NotCloneable,      // VMs can not be cloned and must be created from scratch.
+  CompiledBytecode,  // VMs can be cloned with compiled bytecode, but must be instantiated.
+  InstantiatedModule // VMs can be cloned from an instantiated module.
+};
+
 // Wasm VM instance. Provides the low level WASM interface.
 class WasmVm : public Logger::Loggable<Logger::Id::wasm> {
 public:
   virtual ~WasmVm() {}
   virtual absl::string_view vm() PURE;
 
-  // Whether or not the VM implementation supports cloning.
-  virtual bool clonable() PURE;
+  // Whether or not the VM implementation supports cloning, and at which stage. VMs which clone
+  // CompiledBytecode share the compiled module with the original VM, but the clone must still
+  // be linked and started (see Wasm::initialize()). VMs which clone InstantiatedModule return a
+  // ready to use copy, including the state of the linear memory.
+  virtual Cloneable cloneable() PURE;
   // Make a thread-specific copy. This may not be supported by the underlying VM system in which
   // case it will return nullptr and the caller will need to create a new VM from scratch.
   virtual std::unique_ptr<WasmVm> clone() PURE;
 
   // Load the WASM code from a file. Return true on success.
-  virtual bool load(const std::string& code, bool allow_precompiled) PURE;
+  virtual bool load(absl::string_view code, bool allow_precompiled) PURE;
+  // Load the WASM code along with the native code previously returned by getPrecompiledCode() for
+  // the same code and runtime (e.g. from a CompilationCache). If the native code can not be used,
+  // the code is compiled as in load(). Return true on success.
+  virtual bool loadPrecompiled(absl::string_view code, absl::string_view precompiled) PURE;
+  // Get the native code of the loaded module or "" if the VM does not support precompiled code.
+  virtual std::string getPrecompiledCode() PURE;
   // Link to registered function.
   virtual void link(absl::string_view debug_name, bool needs_emscripten) PURE;
 
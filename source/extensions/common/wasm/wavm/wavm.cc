@@ -161,15 +161,16 @@ private:
 
 const uint64_t WasmPageSize = 1 << 16;
 
-bool loadModule(const std::string& code, IR::Module& out_module) {
+bool loadModule(absl::string_view code, IR::Module& out_module) {
   // If the code starts with the WASM binary magic number, load it as a binary IR::Module.
   static const uint8_t WasmMagicNumber[4] = {0x00, 0x61, 0x73, 0x6d};
   if (code.size() >= 4 && !memcmp(code.data(), WasmMagicNumber, 4)) {
     return WASM::loadBinaryModule(code.data(), code.size(), out_module);
   } else {
-    // Load it as a text IR::Module.
+    // Load it as a text IR::Module, which the parser expects to be null terminated.
+    const std::string text(code);
     std::vector<WAST::Error> parseErrors;
-    if (!WAST::parseModule(code.c_str(), code.size() + 1, out_module, parseErrors)) {
+    if (!WAST::parseModule(text.c_str(), text.size() + 1, out_module, parseErrors)) {
       return false;
     }
     return true;
@@ -213,9 +214,11 @@ struct Wavm : public WasmVm {
 
   // WasmVm
   absl::string_view vm() override { return WasmVmNames::get().Wavm; }
-  bool clonable() override { return true; };
+  Cloneable cloneable() override { return Cloneable::InstantiatedModule; };
   std::unique_ptr<WasmVm> clone() override;
-  bool load(const std::string& code, bool allow_precompiled) override;
+  bool load(absl::string_view code, bool allow_precompiled) override;
+  bool loadPrecompiled(absl::string_view code, absl::string_view precompiled) override;
+  std::string getPrecompiledCode() override;
   void setMemoryLayout(uint64_t, uint64_t, uint64_t) override {}
   void link(absl::string_view debug_name, bool needs_emscripten) override;
   void start(Context* context) override;
@@ -303,7 +306,7 @@ std::unique_ptr<WasmVm> Wavm::clone() {
   return wavm;
 }
 
-bool Wavm::load(const std::string& code, bool allow_precompiled) {
+bool Wavm::load(absl::string_view code, bool allow_precompiled) {
   ASSERT(!has_instantiated_module_);
   has_instantiated_module_ = true;
   compartment_ = WAVM::Runtime::createCompartment();
@@ -330,6 +333,30 @@ bool Wavm::load(const std::string& code, bool allow_precompiled) {
   return true;
 }
 
+bool Wavm::loadPrecompiled(absl::string_view code, absl::string_view precompiled) {
+  ASSERT(!has_instantiated_module_);
+  has_instantiated_module_ = true;
+  compartment_ = WAVM::Runtime::createCompartment();
+  context_ = WAVM::Runtime::createContext(compartment_);
+  if (!loadModule(code, ir_module_)) {
+    return false;
+  }
+  if (precompiled.empty()) {
+    module_ = WAVM::Runtime::compileModule(ir_module_);
+  } else {
+    module_ = WAVM::Runtime::loadPrecompiledModule(
+        ir_module_, std::vector<U8>(precompiled.begin(), precompiled.end()));
+  }
+  makeModule("envoy");
+  return true;
+}
+
+std::string Wavm::getPrecompiledCode() {
+  ASSERT(module_ != nullptr);
+  const auto object_code = WAVM::Runtime::getObjectCode(module_);
+  return std::string(object_code.begin(), object_code.end());
+}
+
 void Wavm::link(absl::string_view debug_name, bool needs_emscripten) {
   RootResolver rootResolver(compartment_);
   for (auto& p : intrinsic_modules_) {
@@ -6,6 +6,7 @@ EXTENSIONS = {
 
     "envoy.access_loggers.file":                        "//source/extensions/access_loggers/file:config",
     "envoy.access_loggers.http_grpc":                   "//source/extensions/access_loggers/grpc:http_config",
+    "envoy.access_loggers.http_protobuf_file":          "//source/extensions/access_loggers/protobuf_file:config",
     "envoy.access_loggers.wasm":                        "//source/extensions/access_loggers/wasm:config",
 
     #
@@ -36,10 +37,9 @@ EXTENSIONS = {
     # HTTP filters
     #
 
-    # NOTE: The adaptive concurrency filter does not have a proper filter
-    #       implemented right now. We are just referencing the filter lib here.
-    "envoy.filters.http.adaptive_concurrency":          "//source/extensions/filters/http/adaptive_concurrency:adaptive_concurrency_filter_lib",
+    "envoy.filters.http.adaptive_concurrency":          "//source/extensions/filters/http/adaptive_concurrency:config",
     "envoy.filters.http.buffer":                        "//source/extensions/filters/http/buffer:config",
+    "envoy.filters.http.cache":                         "//source/extensions/filters/http/cache:config",
     "envoy.filters.http.cors":                          "//source/extensions/filters/http/cors:config",
     "envoy.filters.http.csrf":                          "//source/extensions/filters/http/csrf:config",
     "envoy.filters.http.dynamic_forward_proxy":         "//source/extensions/filters/http/dynamic_forward_proxy:config",
@@ -104,8 +104,13 @@ EXTENSIONS = {
     # Resource monitors
     #
 
+    "envoy.resource_monitors.active_requests":          "//source/extensions/resource_monitors/active_requests:config",
+    "envoy.resource_monitors.buffer_memory":            "//source/extensions/resource_monitors/buffer_memory:config",
+    "envoy.resource_monitors.cgroup_memory":            "//source/extensions/resource_monitors/cgroup_memory:config",
+    "envoy.resource_monitors.event_loop_lag":           "//source/extensions/resource_monitors/event_loop_lag:config",
     "envoy.resource_monitors.fixed_heap":               "//source/extensions/resource_monitors/fixed_heap:config",
     "envoy.resource_monitors.injected_resource":        "//source/extensions/resource_monitors/injected_resource:config",
+    "envoy.resource_monitors.wasm":                     "//source/extensions/resource_monitors/wasm:config",
 
     #
     # Stat sinks
@@ -156,6 +161,7 @@ WINDOWS_EXTENSIONS = {
 
     "envoy.access_loggers.file":                        "//source/extensions/access_loggers/file:config",
     #"envoy.access_loggers.http_grpc":                   "//source/extensions/access_loggers/grpc:http_config",
+    "envoy.access_loggers.http_protobuf_file":          "//source/extensions/access_loggers/protobuf_file:config",
 
     #
     # gRPC Credentials Plugins
@@ -24,8 +24,14 @@ absl::optional<CelValue> HeadersWrapper::operator[](CelValue key) const {
   if (value_ == nullptr || !key.IsString()) {
     return {};
   }
-  auto out = value_->get(Http::LowerCaseString(std::string(key.StringOrDie().value())));
-  return convertHeaderEntry(out);
+  const absl::string_view name = key.StringOrDie().value();
+  const auto it = lookups_.find(name);
+  if (it != lookups_.end()) {
+    return it->second;
+  }
+  auto out = convertHeaderEntry(value_->get(Http::LowerCaseString(std::string(name))));
+  lookups_.emplace(std::string(name), out);
+  return out;
 }
 
 absl::optional<CelValue> RequestWrapper::operator[](CelValue key) const {
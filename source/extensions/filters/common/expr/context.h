@@ -4,6 +4,7 @@
 
 #include "common/http/headers.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "eval/public/cel_value.h"
 
 namespace Envoy {
@@ -55,6 +56,8 @@ constexpr absl::string_view Destination = "destination";
 
 class RequestWrapper;
 
+// Header values are memoized by name, as an activation is evaluated against unchanging headers
+// and the expressions evaluated with it commonly look up the same headers.
 class HeadersWrapper : public google::api::expr::runtime::CelMap {
 public:
   HeadersWrapper(const Http::HeaderMap* value) : value_(value) {}
@@ -68,6 +71,7 @@ public:
 private:
   friend class RequestWrapper;
   const Http::HeaderMap* value_;
+  mutable absl::flat_hash_map<std::string, absl::optional<CelValue>> lookups_;
 };
 
 class BaseWrapper : public google::api::expr::runtime::CelMap {
@@ -11,6 +11,35 @@ namespace Filters {
 namespace Common {
 namespace Expr {
 
+namespace {
+
+// The attributes of a request, owning the wrappers it exposes.
+class RequestActivation : public google::api::expr::runtime::Activation {
+public:
+  RequestActivation(Protobuf::Arena* arena, const StreamInfo::StreamInfo& info,
+                    const Http::HeaderMap* request_headers,
+                    const Http::HeaderMap* response_headers,
+                    const Http::HeaderMap* response_trailers)
+      : request_(request_headers, info), response_(response_headers, response_trailers, info),
+        connection_(info), source_(info, false), destination_(info, true) {
+    InsertValue(Request, CelValue::CreateMap(&request_));
+    InsertValue(Response, CelValue::CreateMap(&response_));
+    InsertValue(Metadata, CelValue::CreateMessage(&info.dynamicMetadata(), arena));
+    InsertValue(Connection, CelValue::CreateMap(&connection_));
+    InsertValue(Source, CelValue::CreateMap(&source_));
+    InsertValue(Destination, CelValue::CreateMap(&destination_));
+  }
+
+private:
+  const RequestWrapper request_;
+  const ResponseWrapper response_;
+  const ConnectionWrapper connection_;
+  const PeerWrapper source_;
+  const PeerWrapper destination_;
+};
+
+} // namespace
+
 BuilderPtr createBuilder(Protobuf::Arena* arena) {
   google::api::expr::runtime::InterpreterOptions options;
 
@@ -42,24 +71,26 @@ ExpressionPtr createExpression(Builder& builder, const google::api::expr::v1alph
   return std::move(cel_expression_status.ValueOrDie());
 }
 
+ActivationPtr createActivation(Protobuf::Arena& arena, const StreamInfo::StreamInfo& info,
+                               const Http::HeaderMap* request_headers,
+                               const Http::HeaderMap* response_headers,
+                               const Http::HeaderMap* response_trailers) {
+  return std::make_unique<RequestActivation>(&arena, info, request_headers, response_headers,
+                                             response_trailers);
+}
+
 absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena* arena,
                                   const StreamInfo::StreamInfo& info,
                                   const Http::HeaderMap* request_headers,
                                   const Http::HeaderMap* response_headers,
                                   const Http::HeaderMap* response_trailers) {
-  google::api::expr::runtime::Activation activation;
-  const RequestWrapper request(request_headers, info);
-  const ResponseWrapper response(response_headers, response_trailers, info);
-  const ConnectionWrapper connection(info);
-  const PeerWrapper source(info, false);
-  const PeerWrapper destination(info, true);
-  activation.InsertValue(Request, CelValue::CreateMap(&request));
-  activation.InsertValue(Response, CelValue::CreateMap(&response));
-  activation.InsertValue(Metadata, CelValue::CreateMessage(&info.dynamicMetadata(), arena));
-  activation.InsertValue(Connection, CelValue::CreateMap(&connection));
-  activation.InsertValue(Source, CelValue::CreateMap(&source));
-  activation.InsertValue(Destination, CelValue::CreateMap(&destination));
+  const RequestActivation activation(arena, info, request_headers, response_headers,
+                                     response_trailers);
+  return evaluate(expr, arena, activation);
+}
 
+absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena* arena,
+                                  const Activation& activation) {
   auto eval_status = expr.Evaluate(activation, arena);
   if (!eval_status.ok()) {
     return {};
@@ -71,7 +102,12 @@ absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena* arena
 bool matches(const Expression& expr, const StreamInfo::StreamInfo& info,
              const Http::HeaderMap& headers) {
   Protobuf::Arena arena;
-  auto eval_status = Expr::evaluate(expr, &arena, info, &headers, nullptr, nullptr);
+  const RequestActivation activation(&arena, info, &headers, nullptr, nullptr);
+  return matches(expr, arena, activation);
+}
+
+bool matches(const Expression& expr, Protobuf::Arena& arena, const Activation& activation) {
+  auto eval_status = Expr::evaluate(expr, &arena, activation);
   if (!eval_status.has_value()) {
     return false;
   }
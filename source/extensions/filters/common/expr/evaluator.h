@@ -7,6 +7,7 @@
 
 #include "extensions/filters/common/expr/context.h"
 
+#include "eval/public/activation.h"
 #include "eval/public/cel_expression.h"
 #include "eval/public/cel_value.h"
 
@@ -20,6 +21,8 @@ using Builder = google::api::expr::runtime::CelExpressionBuilder;
 using BuilderPtr = std::unique_ptr<Builder>;
 using Expression = google::api::expr::runtime::CelExpression;
 using ExpressionPtr = std::unique_ptr<Expression>;
+using Activation = google::api::expr::runtime::BaseActivation;
+using ActivationPtr = std::unique_ptr<Activation>;
 
 // Creates an expression builder. The optional arena is used to enable constant folding
 // for intermediate evaluation results.
@@ -30,6 +33,14 @@ BuilderPtr createBuilder(Protobuf::Arena* arena);
 // Throws an exception if fails to construct a runtime expression.
 ExpressionPtr createExpression(Builder& builder, const google::api::expr::v1alpha1::Expr& expr);
 
+// Creates an activation holding the attributes of a request, so that several expressions evaluated
+// against the same request share it and its memoized header lookups. The stream info and headers
+// must outlive the activation, and must not be modified while it is in use.
+ActivationPtr createActivation(Protobuf::Arena& arena, const StreamInfo::StreamInfo& info,
+                               const Http::HeaderMap* request_headers,
+                               const Http::HeaderMap* response_headers,
+                               const Http::HeaderMap* response_trailers);
+
 // Evaluates an expression for a request. The arena is used to hold intermediate computational
 // results and potentially the final value.
 absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena* arena,
@@ -38,11 +49,18 @@ absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena* arena
                                   const Http::HeaderMap* response_headers,
                                   const Http::HeaderMap* response_trailers);
 
+// Evaluates an expression against an activation created by createActivation().
+absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena* arena,
+                                  const Activation& activation);
+
 // Evaluates an expression and returns true if the expression evaluates to "true".
 // Returns false if the expression fails to evaluate.
 bool matches(const Expression& expr, const StreamInfo::StreamInfo& info,
              const Http::HeaderMap& headers);
 
+// As above, against an activation created by createActivation() with the same arena.
+bool matches(const Expression& expr, Protobuf::Arena& arena, const Activation& activation);
+
 } // namespace Expr
 } // namespace Common
 } // namespace Filters
@@ -17,6 +17,7 @@ FaultDelayConfig::FaultDelayConfig(const envoy::config::filter::fault::v2::Fault
     break;
   case envoy::config::filter::fault::v2::FaultDelay::kHeaderDelay:
     provider_ = std::make_unique<HeaderDelayProvider>();
+    from_header_ = true;
     break;
   case envoy::config::filter::fault::v2::FaultDelay::FAULT_DELAY_SECIFIER_NOT_SET:
     NOT_REACHED_GCOVR_EXCL_LINE;
@@ -47,6 +48,7 @@ FaultRateLimitConfig::FaultRateLimitConfig(
     break;
   case envoy::config::filter::fault::v2::FaultRateLimit::kHeaderLimit:
     provider_ = std::make_unique<HeaderRateLimitProvider>();
+    from_header_ = true;
     break;
   case envoy::config::filter::fault::v2::FaultRateLimit::LIMIT_TYPE_NOT_SET:
     NOT_REACHED_GCOVR_EXCL_LINE;
@@ -34,6 +34,8 @@ public:
   absl::optional<std::chrono::milliseconds> duration(const Http::HeaderEntry* header) const {
     return provider_->duration(header);
   }
+  // Whether the delay is read from the request headers, which can otherwise be left unparsed.
+  bool fromHeader() const { return from_header_; }
 
 private:
   // Abstract delay provider.
@@ -73,6 +75,7 @@ private:
 
   DelayProviderPtr provider_;
   const envoy::type::FractionalPercent percentage_;
+  bool from_header_{};
 };
 
 using FaultDelayConfigPtr = std::unique_ptr<FaultDelayConfig>;
@@ -89,6 +92,8 @@ public:
   absl::optional<uint64_t> rateKbps(const Http::HeaderEntry* header) const {
     return provider_->rateKbps(header);
   }
+  // Whether the rate limit is read from the request headers, which can otherwise be left unparsed.
+  bool fromHeader() const { return from_header_; }
 
 private:
   // Abstract rate limit provider.
@@ -123,6 +128,7 @@ private:
 
   RateLimitProviderPtr provider_;
   const envoy::type::FractionalPercent percentage_;
+  bool from_header_{};
 };
 
 using FaultRateLimitConfigPtr = std::unique_ptr<FaultRateLimitConfig>;
@@ -12,8 +12,45 @@ namespace Filters {
 namespace Common {
 namespace Lua {
 
-Coroutine::Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state)
-    : coroutine_state_(new_thread_state, false) {}
+CoroutinePool::~CoroutinePool() {
+  for (int ref : refs_) {
+    luaL_unref(state_, LUA_REGISTRYINDEX, ref);
+  }
+}
+
+lua_State* CoroutinePool::pushThread() {
+  if (refs_.empty()) {
+    return lua_newthread(state_);
+  }
+
+  lua_rawgeti(state_, LUA_REGISTRYINDEX, refs_.back());
+  luaL_unref(state_, LUA_REGISTRYINDEX, refs_.back());
+  refs_.pop_back();
+  return lua_tothread(state_, -1);
+}
+
+void CoroutinePool::releaseThread() {
+  ASSERT(lua_isthread(state_, -1));
+  if (refs_.size() < max_size_) {
+    refs_.push_back(luaL_ref(state_, LUA_REGISTRYINDEX));
+  } else {
+    lua_pop(state_, 1);
+  }
+}
+
+Coroutine::Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state,
+                     CoroutinePool* pool)
+    : coroutine_state_(new_thread_state, false), pool_(pool) {}
+
+Coroutine::~Coroutine() {
+  // Only a coroutine which returned is back at the base of its thread. A yielded one would be
+  // resumed from where it left off, and one which raised an error cannot be resumed at all.
+  if (pool_ != nullptr && state_ == State::Finished && !failed_) {
+    lua_settop(coroutine_state_.get(), 0);
+    coroutine_state_.pushStack();
+    pool_->releaseThread();
+  }
+}
 
 void Coroutine::start(int function_ref, int num_args, const std::function<void()>& yield_callback) {
   ASSERT(state_ == State::NotStarted);
@@ -41,6 +78,7 @@ void Coroutine::resume(int num_args, const std::function<void()>& yield_callback
     yield_callback();
   } else {
     state_ = State::Finished;
+    failed_ = true;
     const char* error = lua_tostring(coroutine_state_.get(), -1);
     throw LuaException(error);
   }
@@ -86,11 +124,23 @@ uint64_t ThreadLocalState::registerGlobal(const std::string& global) {
 }
 
 CoroutinePtr ThreadLocalState::createCoroutine() {
-  lua_State* state = tls_slot_->getTyped<LuaThreadLocal>().state_.get();
-  return std::make_unique<Coroutine>(std::make_pair(lua_newthread(state), state));
+  LuaThreadLocal& tls = tls_slot_->getTyped<LuaThreadLocal>();
+  lua_State* thread = tls.coroutine_pool_.pushThread();
+  return std::make_unique<Coroutine>(std::make_pair(thread, tls.state_.get()),
+                                     &tls.coroutine_pool_);
 }
 
-ThreadLocalState::LuaThreadLocal::LuaThreadLocal(const std::string& code) : state_(lua_open()) {
+void ThreadLocalState::setRuntimeGCParameter(int option, int value) {
+  ASSERT(option == LUA_GCSETPAUSE || option == LUA_GCSETSTEPMUL);
+  tls_slot_->runOnAllThreads([this, option, value]() {
+    lua_gc(tls_slot_->getTyped<LuaThreadLocal>().state_.get(), option, value);
+  });
+}
+
+constexpr uint32_t ThreadLocalState::MaxPooledCoroutines;
+
+ThreadLocalState::LuaThreadLocal::LuaThreadLocal(const std::string& code)
+    : state_(lua_open()), coroutine_pool_(state_.get(), MaxPooledCoroutines) {
   luaL_openlibs(state_.get());
   int rc = luaL_dostring(state_.get(), code.c_str());
   ASSERT(rc == 0);
@@ -316,6 +316,38 @@ public:
   }
 };
 
+/**
+ * A pool of the Lua threads of coroutines which returned normally. Such a thread has an empty
+ * stack and can start another function, so reusing it saves creating a new thread and later
+ * collecting the old one for every coroutine. There is one pool per Lua state.
+ */
+class CoroutinePool {
+public:
+  CoroutinePool(lua_State* state, uint32_t max_size) : state_(state), max_size_(max_size) {}
+  ~CoroutinePool();
+
+  /**
+   * Push a Lua thread onto the stack of the pool's state, reusing a pooled one if possible.
+   * @return the thread.
+   */
+  lua_State* pushThread();
+
+  /**
+   * Return the thread at the top of the stack of the pool's state to the pool, and pop it.
+   */
+  void releaseThread();
+
+  /**
+   * @return the number of threads in the pool.
+   */
+  size_t size() const { return refs_.size(); }
+
+private:
+  lua_State* const state_;
+  const uint32_t max_size_;
+  std::vector<int> refs_;
+};
+
 /**
  * This is a wrapper for a Lua coroutine. Lua intermixes coroutine and "thread." Lua does not have
  * real threads, only cooperatively scheduled coroutines.
@@ -324,7 +356,15 @@ class Coroutine : Logger::Loggable<Logger::Id::lua> {
 public:
   enum class State { NotStarted, Yielded, Finished };
 
-  Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state);
+  /**
+   * @param new_thread_state supplies the coroutine thread and its parent state. The thread must be
+   *        at the top of the stack of the parent state.
+   * @param pool supplies the pool the thread is returned to if the coroutine returns normally.
+   */
+  Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state,
+            CoroutinePool* pool = nullptr);
+  ~Coroutine();
+
   lua_State* luaState() { return coroutine_state_.get(); }
   State state() { return state_; }
 
@@ -348,7 +388,9 @@ public:
 
 private:
   LuaRef<lua_State> coroutine_state_;
+  CoroutinePool* const pool_;
   State state_{State::NotStarted};
+  bool failed_{};
 };
 
 using CoroutinePtr = std::unique_ptr<Coroutine>;
@@ -405,12 +447,29 @@ public:
    */
   void runtimeGC() { lua_gc(tls_slot_->getTyped<LuaThreadLocal>().state_.get(), LUA_GCCOLLECT, 0); }
 
+  /**
+   * Tune the incremental GC of the runtime on all threads.
+   * @param option supplies LUA_GCSETPAUSE or LUA_GCSETSTEPMUL.
+   * @param value supplies the new value of the parameter, in percent.
+   */
+  void setRuntimeGCParameter(int option, int value);
+
+  /**
+   * @return the number of coroutine threads pooled for reuse on the current thread.
+   */
+  size_t pooledCoroutines() { return tls_slot_->getTyped<LuaThreadLocal>().coroutine_pool_.size(); }
+
+  // The maximum number of coroutine threads pooled per worker.
+  static constexpr uint32_t MaxPooledCoroutines = 256;
+
 private:
   struct LuaThreadLocal : public ThreadLocal::ThreadLocalObject {
     LuaThreadLocal(const std::string& code);
 
     CSmartPtr<lua_State, lua_close> state_;
     std::vector<int> global_slots_;
+    // Declared after the state, so that it is destroyed before the state is closed.
+    CoroutinePool coroutine_pool_;
   };
 
   ThreadLocal::SlotPtr tls_slot_;
@@ -0,0 +1,73 @@
+#include "extensions/filters/common/ratelimit/quota_lease.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RateLimit {
+
+std::string QuotaLeases::key(const std::string& domain,
+                             const std::vector<Envoy::RateLimit::Descriptor>& descriptors) {
+  // Keys and values are prefixed with their length so that they can not run into each other.
+  std::string key = absl::StrCat(domain.size(), ":", domain);
+  for (const Envoy::RateLimit::Descriptor& descriptor : descriptors) {
+    key.push_back('|');
+    for (const Envoy::RateLimit::DescriptorEntry& entry : descriptor.entries_) {
+      absl::StrAppend(&key, entry.key_.size(), ":", entry.key_, entry.value_.size(), ":",
+                      entry.value_);
+    }
+  }
+  return key;
+}
+
+bool QuotaLeases::tryConsume(const std::string& key) {
+  const auto it = leases_.find(key);
+  if (it == leases_.end()) {
+    return false;
+  }
+  if (it->second.remaining_ == 0 || it->second.expiry_ <= time_source_.monotonicTime()) {
+    leases_.erase(it);
+    return false;
+  }
+  it->second.remaining_--;
+  return true;
+}
+
+void QuotaLeases::addLease(const std::string& key) {
+  const MonotonicTime now = time_source_.monotonicTime();
+  // The hits left from a previous lease are dropped rather than carried over, as their window of
+  // the limit may be over.
+  const Lease lease{lease_size_ - 1, now + lease_duration_};
+  const auto it = leases_.find(key);
+  if (it != leases_.end()) {
+    it->second = lease;
+    return;
+  }
+
+  if (leases_.size() >= max_leases_) {
+    removeExpired(now);
+    if (leases_.size() >= max_leases_) {
+      // The hits are forgone, the following requests will query the service.
+      return;
+    }
+  }
+  leases_.emplace(key, lease);
+}
+
+void QuotaLeases::removeExpired(MonotonicTime now) {
+  for (auto it = leases_.begin(); it != leases_.end();) {
+    if (it->second.remaining_ == 0 || it->second.expiry_ <= now) {
+      leases_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+} // namespace RateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/ratelimit/ratelimit.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RateLimit {
+
+/**
+ * The quotas of requests leased from the rate limit service, by domain and descriptors. A lease is
+ * obtained by checking the limits for several hits at once, and its hits are then used by the
+ * following requests with the same descriptors, which are admitted without querying the service
+ * until the lease is used up or expires. It is per thread, and its operations are not protected.
+ */
+class QuotaLeases {
+public:
+  /**
+   * @param lease_size supplies the number of hits leased at once.
+   * @param lease_duration supplies how long the hits of a lease may be used for.
+   * @param max_leases supplies the maximum number of leases held at once.
+   * @param time_source supplies the time the leases expire with.
+   */
+  QuotaLeases(uint32_t lease_size, std::chrono::milliseconds lease_duration, uint32_t max_leases,
+              TimeSource& time_source)
+      : lease_size_(lease_size), lease_duration_(lease_duration), max_leases_(max_leases),
+        time_source_(time_source) {}
+
+  /**
+   * @return the key of the leases of the given domain and descriptors.
+   */
+  static std::string key(const std::string& domain,
+                         const std::vector<Envoy::RateLimit::Descriptor>& descriptors);
+
+  /**
+   * Use a hit of the lease of a key, if there is one left.
+   * @return whether the request was admitted by the lease.
+   */
+  bool tryConsume(const std::string& key);
+
+  /**
+   * Record a lease granted by the service, one hit of which was used by the request that asked
+   * for it.
+   */
+  void addLease(const std::string& key);
+
+  /**
+   * @return the number of hits to ask the service for.
+   */
+  uint32_t leaseSize() const { return lease_size_; }
+
+  /**
+   * @return the number of leases held.
+   */
+  size_t size() const { return leases_.size(); }
+
+private:
+  struct Lease {
+    uint32_t remaining_;
+    MonotonicTime expiry_;
+  };
+
+  void removeExpired(MonotonicTime now);
+
+  const uint32_t lease_size_;
+  const std::chrono::milliseconds lease_duration_;
+  const uint32_t max_leases_;
+  TimeSource& time_source_;
+  absl::flat_hash_map<std::string, Lease> leases_;
+};
+
+} // namespace RateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -72,6 +72,17 @@ public:
   virtual void limit(RequestCallbacks& callbacks, const std::string& domain,
                      const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
                      Tracing::Span& parent_span) PURE;
+
+  /**
+   * Request a limit check adding several hits at once to the matched limits, so as to lease a
+   * quota of requests which are then admitted without querying the service. The check is
+   * otherwise the same as with limit(): in particular, the status is over limit if the limits do
+   * not allow for all the hits.
+   * @param hits_addend supplies the number of hits to add.
+   */
+  virtual void lease(RequestCallbacks& callbacks, const std::string& domain,
+                     const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                     Tracing::Span& parent_span, uint32_t hits_addend) PURE;
 };
 
 using ClientPtr = std::unique_ptr<Client>;
@@ -50,11 +50,21 @@ void GrpcClientImpl::createRequest(envoy::service::ratelimit::v2::RateLimitReque
 void GrpcClientImpl::limit(RequestCallbacks& callbacks, const std::string& domain,
                            const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
                            Tracing::Span& parent_span) {
+  lease(callbacks, domain, descriptors, parent_span, 1);
+}
+
+void GrpcClientImpl::lease(RequestCallbacks& callbacks, const std::string& domain,
+                           const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                           Tracing::Span& parent_span, uint32_t hits_addend) {
   ASSERT(callbacks_ == nullptr);
   callbacks_ = &callbacks;
 
   envoy::service::ratelimit::v2::RateLimitRequest request;
   createRequest(request, domain, descriptors);
+  // A single hit is the default of the service.
+  if (hits_addend > 1) {
+    request.set_hits_addend(hits_addend);
+  }
 
   request_ = async_client_->send(service_method_, request, *this, parent_span, timeout_);
 }
@@ -15,12 +15,15 @@ struct StatNames {
   explicit StatNames(Stats::SymbolTable& symbol_table)
       : pool_(symbol_table), ok_(pool_.add("ratelimit.ok")), error_(pool_.add("ratelimit.error")),
         failure_mode_allowed_(pool_.add("ratelimit.failure_mode_allowed")),
-        over_limit_(pool_.add("ratelimit.over_limit")) {}
+        over_limit_(pool_.add("ratelimit.over_limit")),
+        leased_ok_(pool_.add("ratelimit.leased_ok")) {}
   Stats::StatNamePool pool_;
   Stats::StatName ok_;
   Stats::StatName error_;
   Stats::StatName failure_mode_allowed_;
   Stats::StatName over_limit_;
+  // Requests admitted with the hits of a lease, without querying the service.
+  Stats::StatName leased_ok_;
 };
 
 } // namespace RateLimit
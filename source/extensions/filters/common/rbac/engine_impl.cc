@@ -30,9 +30,12 @@ bool RoleBasedAccessControlEngineImpl::allowed(const Network::Connection& connec
                                                const StreamInfo::StreamInfo& info,
                                                std::string* effective_policy_id) const {
   bool matched = false;
+  // The conditions of all policies are evaluated in one arena, against one activation.
+  Protobuf::Arena arena;
+  Expr::ActivationPtr activation;
 
   for (const auto& policy : policies_) {
-    if (policy.second->matches(connection, headers, info)) {
+    if (policy.second->matches(connection, headers, info, arena, activation)) {
       matched = true;
       if (effective_policy_id != nullptr) {
         *effective_policy_id = policy.first;
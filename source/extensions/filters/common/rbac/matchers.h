@@ -10,9 +10,12 @@
 #include "common/common/matchers.h"
 #include "common/http/header_utility.h"
 #include "common/network/cidr_range.h"
+#include "common/network/lc_trie.h"
 
 #include "extensions/filters/common/expr/evaluator.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
@@ -82,7 +85,9 @@ private:
 
 /**
  * A composite matcher where only one sub-matcher must match for this to return true. Evaluation
- * short-circuits on the first match.
+ * short-circuits on the first match. Two or more IP matchers of the same direction are merged into
+ * an IPSetMatcher, and two or more destination port matchers into a PortSetMatcher, both of which
+ * are evaluated first.
  */
 class OrMatcher : public Matcher {
 public:
@@ -95,6 +100,9 @@ public:
                const StreamInfo::StreamInfo&) const override;
 
 private:
+  void addMergedMatchers(std::vector<Network::Address::CidrRange>&& ranges, bool destination,
+                         absl::flat_hash_set<uint32_t>&& ports);
+
   std::vector<MatcherConstSharedPtr> matchers_;
 };
 
@@ -144,6 +152,37 @@ private:
   const bool destination_;
 };
 
+/**
+ * Perform a match against a set of IP CIDR ranges, looked up in an LC trie. This rule can be
+ * applied to either the source (remote) or the destination (local) IP.
+ */
+class IPSetMatcher : public Matcher {
+public:
+  IPSetMatcher(const std::vector<Network::Address::CidrRange>& ranges, bool destination)
+      : trie_({{true, ranges}}), destination_(destination) {}
+
+  bool matches(const Network::Connection& connection, const Envoy::Http::HeaderMap& headers,
+               const StreamInfo::StreamInfo&) const override;
+
+private:
+  const Network::LcTrie::LcTrie<bool> trie_;
+  const bool destination_;
+};
+
+/**
+ * Matches the port number of the destination (local) address against a set of ports.
+ */
+class PortSetMatcher : public Matcher {
+public:
+  PortSetMatcher(absl::flat_hash_set<uint32_t>&& ports) : ports_(std::move(ports)) {}
+
+  bool matches(const Network::Connection& connection, const Envoy::Http::HeaderMap& headers,
+               const StreamInfo::StreamInfo&) const override;
+
+private:
+  const absl::flat_hash_set<uint32_t> ports_;
+};
+
 /**
  * Matches the port number of the destination (local) address.
  */
@@ -194,6 +233,14 @@ public:
   bool matches(const Network::Connection& connection, const Envoy::Http::HeaderMap& headers,
                const StreamInfo::StreamInfo&) const override;
 
+  /**
+   * Matches as above, evaluating the condition against the given activation. The activation is
+   * created in the arena on first use, so that the policies checked for one request share it.
+   */
+  bool matches(const Network::Connection& connection, const Envoy::Http::HeaderMap& headers,
+               const StreamInfo::StreamInfo& info, Protobuf::Arena& arena,
+               Expr::ActivationPtr& activation) const;
+
 private:
   const OrMatcher permissions_;
   const OrMatcher principals_;
@@ -26,21 +26,34 @@ AdaptiveConcurrencyFilter::AdaptiveConcurrencyFilter(
 
 Http::FilterHeadersStatus AdaptiveConcurrencyFilter::decodeHeaders(Http::HeaderMap&, bool) {
   if (controller_->forwardingDecision() == ConcurrencyController::RequestForwardingAction::Block) {
-    // TODO (tonya11en): Remove filler words.
-    decoder_callbacks_->sendLocalReply(Http::Code::ServiceUnavailable, "filler words", nullptr,
-                                       absl::nullopt, "more filler words");
+    decoder_callbacks_->sendLocalReply(Http::Code::ServiceUnavailable, "reached concurrency limit",
+                                       nullptr, absl::nullopt, "reached_concurrency_limit");
     return Http::FilterHeadersStatus::StopIteration;
   }
 
+  forwarded_ = true;
   rq_start_time_ = config_->timeSource().monotonicTime();
   return Http::FilterHeadersStatus::Continue;
 }
 
 void AdaptiveConcurrencyFilter::encodeComplete() {
+  // The local reply of a blocked request is not sampled.
+  if (!forwarded_) {
+    return;
+  }
+  forwarded_ = false;
   const auto rq_latency = config_->timeSource().monotonicTime() - rq_start_time_;
   controller_->recordLatencySample(rq_latency);
 }
 
+void AdaptiveConcurrencyFilter::onDestroy() {
+  // The request was reset before its response completed.
+  if (forwarded_) {
+    forwarded_ = false;
+    controller_->cancelLatencySample();
+  }
+}
+
 } // namespace AdaptiveConcurrency
 } // namespace HttpFilters
 } // namespace Extensions
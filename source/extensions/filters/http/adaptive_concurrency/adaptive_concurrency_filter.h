@@ -52,6 +52,9 @@ public:
   AdaptiveConcurrencyFilter(AdaptiveConcurrencyFilterConfigSharedPtr config,
                             ConcurrencyControllerSharedPtr controller);
 
+  // Http::StreamFilterBase
+  void onDestroy() override;
+
   // Http::StreamDecoderFilter
   Http::FilterHeadersStatus decodeHeaders(Http::HeaderMap&, bool) override;
 
@@ -62,7 +65,8 @@ private:
   AdaptiveConcurrencyFilterConfigSharedPtr config_;
   const ConcurrencyControllerSharedPtr controller_;
   MonotonicTime rq_start_time_;
-  std::unique_ptr<ConcurrencyController::RequestForwardingAction> forwarding_action_;
+  // Set while the request counts against the concurrency limit.
+  bool forwarded_{};
 };
 
 } // namespace AdaptiveConcurrency
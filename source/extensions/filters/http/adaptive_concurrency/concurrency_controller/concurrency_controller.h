@@ -44,6 +44,12 @@ public:
    * @param rq_latency is the clocked round-trip time for the request.
    */
   virtual void recordLatencySample(const std::chrono::nanoseconds& rq_latency) PURE;
+
+  /**
+   * Called instead of recordLatencySample() when a forwarded request ends without a response, so
+   * that it is no longer counted as outstanding.
+   */
+  virtual void cancelLatencySample() PURE;
 };
 
 } // namespace ConcurrencyController
@@ -0,0 +1,247 @@
+#include "extensions/filters/http/adaptive_concurrency/concurrency_controller/gradient_controller.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "common/common/assert.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace AdaptiveConcurrency {
+namespace ConcurrencyController {
+
+GradientControllerConfig::GradientControllerConfig(
+    const envoy::config::filter::http::adaptive_concurrency::v2alpha::GradientControllerConfig&
+        proto_config)
+    : min_rtt_calc_interval_(
+          PROTOBUF_GET_MS_REQUIRED(proto_config.min_rtt_calc_params(), interval)),
+      sample_rtt_calc_interval_(PROTOBUF_GET_MS_REQUIRED(proto_config.concurrency_limit_params(),
+                                                         concurrency_update_interval)),
+      max_concurrency_limit_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          proto_config.concurrency_limit_params(), max_concurrency_limit, 1000)),
+      min_rtt_aggregate_request_count_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config.min_rtt_calc_params(), request_count, 50)),
+      min_concurrency_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config.min_rtt_calc_params(), min_concurrency, 3)),
+      max_gradient_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config.concurrency_limit_params(),
+                                                    max_gradient, 2.0)),
+      jitter_(std::min(PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config.min_rtt_calc_params(), jitter,
+                                                       15.0),
+                       100.0) /
+              100),
+      sample_aggregate_percentile_(
+          std::min(PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, sample_aggregate_percentile, 50.0),
+                   100.0) /
+          100) {}
+
+uint32_t LatencyHistogram::bucket(uint64_t latency_us) {
+  latency_us = std::min<uint64_t>(latency_us, (1ULL << 32) - 1);
+  if (latency_us < 4) {
+    return latency_us;
+  }
+  // The power of two selects 4 buckets, and the 2 bits below the leading one select among them.
+  const uint32_t exponent = 63 - __builtin_clzll(latency_us);
+  return 4 * (exponent - 1) + ((latency_us >> (exponent - 2)) & 3);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(uint32_t bucket) {
+  ASSERT(bucket < NumBuckets);
+  if (bucket < 4) {
+    return bucket;
+  }
+  const uint32_t exponent = bucket / 4 + 1;
+  return ((4ULL + bucket % 4 + 1) << (exponent - 2)) - 1;
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) {
+  const int64_t latency_us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+  buckets_[bucket(std::max<int64_t>(latency_us, 0))].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::chrono::microseconds LatencyHistogram::percentile(double percentile) const {
+  // The buckets may be recorded into meanwhile, so the total is summed from the same loads as the
+  // rank is searched in.
+  std::array<uint64_t, NumBuckets> counts;
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < NumBuckets; ++i) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) {
+    return std::chrono::microseconds(0);
+  }
+  // The rank of the latency at the percentile, among the latencies in increasing order.
+  const uint64_t rank = std::max<uint64_t>(1, std::ceil(percentile * total));
+  uint64_t count = 0;
+  for (uint32_t i = 0; i < NumBuckets; ++i) {
+    count += counts[i];
+    if (count >= rank) {
+      return std::chrono::microseconds(bucketUpperBound(i));
+    }
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void LatencyHistogram::clear() {
+  for (std::atomic<uint64_t>& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+}
+
+GradientController::GradientController(GradientControllerConfigSharedPtr config,
+                                       TimeSource& time_source, Runtime::RandomGenerator& random,
+                                       const std::string& stats_prefix, Stats::Scope& scope)
+    : config_(std::move(config)), time_source_(time_source), random_(random),
+      stats_(generateStats(scope, stats_prefix)), concurrency_limit_(config_->minConcurrency()),
+      deferred_limit_(config_->minConcurrency()) {
+  // The minimum round-trip time is measured first, as the limit has nothing to be based on until
+  // then.
+  const MonotonicTime now = time_source_.monotonicTime();
+  in_min_rtt_window_ = true;
+  stats_.min_rtt_calculation_active_.set(1);
+  stats_.concurrency_limit_.set(concurrency_limit_.load());
+  setNextUpdateTime(now + config_->sampleRTTCalcInterval());
+}
+
+GradientControllerStats GradientController::generateStats(Stats::Scope& scope,
+                                                          const std::string& stats_prefix) {
+  const std::string final_prefix = stats_prefix + "gradient_controller.";
+  return {ALL_GRADIENT_CONTROLLER_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
+                                        POOL_GAUGE_PREFIX(scope, final_prefix))};
+}
+
+RequestForwardingAction GradientController::forwardingDecision() {
+  maybeUpdate();
+
+  uint32_t outstanding = num_rq_outstanding_.load();
+  do {
+    if (outstanding >= concurrency_limit_.load()) {
+      stats_.rq_blocked_.inc();
+      return RequestForwardingAction::Block;
+    }
+  } while (!num_rq_outstanding_.compare_exchange_weak(outstanding, outstanding + 1));
+  return RequestForwardingAction::Forward;
+}
+
+void GradientController::recordLatencySample(const std::chrono::nanoseconds& rq_latency) {
+  ASSERT(num_rq_outstanding_.load() > 0);
+  --num_rq_outstanding_;
+  histogram_.record(rq_latency);
+
+  // The measurement of the minimum round-trip time ends as soon as enough requests are sampled,
+  // rather than at the next update, since the limit is pinned meanwhile.
+  if (in_min_rtt_window_.load(std::memory_order_relaxed) &&
+      histogram_.count() >= config_->minRTTAggregateRequestCount()) {
+    next_update_time_.store(0, std::memory_order_relaxed);
+  }
+}
+
+void GradientController::cancelLatencySample() {
+  ASSERT(num_rq_outstanding_.load() > 0);
+  --num_rq_outstanding_;
+}
+
+void GradientController::maybeUpdate() {
+  const MonotonicTime now = time_source_.monotonicTime();
+  const int64_t now_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+  if (now_ns < next_update_time_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  // Only one worker runs the update, the others go on with the current limit.
+  if (updating_.exchange(true, std::memory_order_acquire)) {
+    return;
+  }
+  // The update may have just been run by another worker.
+  if (now_ns >= next_update_time_.load(std::memory_order_relaxed)) {
+    update(now);
+  }
+  updating_.store(false, std::memory_order_release);
+}
+
+void GradientController::update(MonotonicTime now) {
+  setNextUpdateTime(now + config_->sampleRTTCalcInterval());
+
+  if (in_min_rtt_window_.load(std::memory_order_relaxed)) {
+    if (histogram_.count() < config_->minRTTAggregateRequestCount()) {
+      return;
+    }
+    min_rtt_ = histogram_.percentile(config_->sampleAggregatePercentile());
+    histogram_.clear();
+    stats_.min_rtt_msecs_.set(
+        std::chrono::duration_cast<std::chrono::milliseconds>(min_rtt_).count());
+    in_min_rtt_window_.store(false, std::memory_order_relaxed);
+    stats_.min_rtt_calculation_active_.set(0);
+    concurrency_limit_.store(deferred_limit_);
+    stats_.concurrency_limit_.set(deferred_limit_);
+    next_min_rtt_calc_time_ = nextMinRTTCalcTime(now);
+    ENVOY_LOG(debug, "adaptive concurrency: minimum round-trip time {}us", min_rtt_.count());
+    return;
+  }
+
+  if (now >= next_min_rtt_calc_time_) {
+    enterMinRTTWindow();
+    return;
+  }
+
+  if (histogram_.count() > 0) {
+    const std::chrono::microseconds sample_rtt =
+        histogram_.percentile(config_->sampleAggregatePercentile());
+    histogram_.clear();
+    updateConcurrencyLimit(sample_rtt);
+  }
+}
+
+void GradientController::enterMinRTTWindow() {
+  deferred_limit_ = concurrency_limit_.load();
+  concurrency_limit_.store(config_->minConcurrency());
+  stats_.concurrency_limit_.set(config_->minConcurrency());
+  histogram_.clear();
+  in_min_rtt_window_.store(true, std::memory_order_relaxed);
+  stats_.min_rtt_calculation_active_.set(1);
+}
+
+void GradientController::updateConcurrencyLimit(std::chrono::microseconds sample_rtt) {
+  stats_.sample_rtt_msecs_.set(
+      std::chrono::duration_cast<std::chrono::milliseconds>(sample_rtt).count());
+
+  // Latencies below a microsecond count as one, which keeps the gradient finite.
+  const double gradient =
+      std::max(0.5, std::min(config_->maxGradient(),
+                             static_cast<double>(std::max<int64_t>(min_rtt_.count(), 1)) /
+                                 std::max<int64_t>(sample_rtt.count(), 1)));
+  const double limit = concurrency_limit_.load() * gradient;
+  const double burst_headroom = std::sqrt(limit);
+  stats_.burst_queue_size_.set(static_cast<uint64_t>(burst_headroom));
+
+  const uint32_t new_limit = std::min<double>(
+      config_->maxConcurrencyLimit(), std::max<double>(config_->minConcurrency(),
+                                                       limit + burst_headroom));
+  concurrency_limit_.store(new_limit);
+  stats_.concurrency_limit_.set(new_limit);
+}
+
+MonotonicTime GradientController::nextMinRTTCalcTime(MonotonicTime now) {
+  const std::chrono::milliseconds interval = config_->minRTTCalcInterval();
+  // The jitter spreads the measurements of the controllers of different listeners and Envoys,
+  // which would otherwise pin their limits at the same time.
+  const uint64_t max_jitter_ms = interval.count() * config_->jitter();
+  return now + interval + std::chrono::milliseconds(random_.random() % (max_jitter_ms + 1));
+}
+
+void GradientController::setNextUpdateTime(MonotonicTime time) {
+  next_update_time_.store(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count(),
+      std::memory_order_relaxed);
+}
+
+} // namespace ConcurrencyController
+} // namespace AdaptiveConcurrency
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/config/filter/http/adaptive_concurrency/v2alpha/adaptive_concurrency.pb.h"
+#include "envoy/runtime/runtime.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/logger.h"
+
+#include "extensions/filters/http/adaptive_concurrency/concurrency_controller/concurrency_controller.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace AdaptiveConcurrency {
+namespace ConcurrencyController {
+
+/**
+ * All stats for the gradient controller.
+ */
+// clang-format off
+#define ALL_GRADIENT_CONTROLLER_STATS(COUNTER, GAUGE)                                              \
+  COUNTER(rq_blocked)                                                                              \
+  GAUGE(burst_queue_size, NeverImport)                                                             \
+  GAUGE(concurrency_limit, NeverImport)                                                            \
+  GAUGE(min_rtt_calculation_active, NeverImport)                                                   \
+  GAUGE(min_rtt_msecs, NeverImport)                                                                \
+  GAUGE(sample_rtt_msecs, NeverImport)
+// clang-format on
+
+/**
+ * Wrapper struct for gradient controller stats. @see stats_macros.h
+ */
+struct GradientControllerStats {
+  ALL_GRADIENT_CONTROLLER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+class GradientControllerConfig {
+public:
+  explicit GradientControllerConfig(
+      const envoy::config::filter::http::adaptive_concurrency::v2alpha::GradientControllerConfig&
+          proto_config);
+
+  std::chrono::milliseconds minRTTCalcInterval() const { return min_rtt_calc_interval_; }
+  std::chrono::milliseconds sampleRTTCalcInterval() const { return sample_rtt_calc_interval_; }
+  uint32_t maxConcurrencyLimit() const { return max_concurrency_limit_; }
+  uint32_t minRTTAggregateRequestCount() const { return min_rtt_aggregate_request_count_; }
+  uint32_t minConcurrency() const { return min_concurrency_; }
+  double maxGradient() const { return max_gradient_; }
+  // The jitter and the percentile are fractions in [0, 1].
+  double jitter() const { return jitter_; }
+  double sampleAggregatePercentile() const { return sample_aggregate_percentile_; }
+
+private:
+  const std::chrono::milliseconds min_rtt_calc_interval_;
+  const std::chrono::milliseconds sample_rtt_calc_interval_;
+  const uint32_t max_concurrency_limit_;
+  const uint32_t min_rtt_aggregate_request_count_;
+  const uint32_t min_concurrency_;
+  const double max_gradient_;
+  const double jitter_;
+  const double sample_aggregate_percentile_;
+};
+
+using GradientControllerConfigSharedPtr = std::shared_ptr<const GradientControllerConfig>;
+
+/**
+ * A histogram of request latencies with 4 buckets per power of two microseconds, so the
+ * percentiles are within 25% of the recorded latencies. Latencies are recorded concurrently by the
+ * workers with a relaxed increment of a bucket, and the histogram is read and cleared by the thread
+ * running an update of the controller.
+ */
+class LatencyHistogram {
+public:
+  // Latencies are capped at 2^32 microseconds, more than an hour.
+  static constexpr uint32_t NumBuckets = 124;
+
+  void record(std::chrono::nanoseconds latency);
+
+  /**
+   * @param percentile supplies the percentile, in [0, 1].
+   * @return the latency at the percentile of the recorded latencies, or 0 if there are none.
+   */
+  std::chrono::microseconds percentile(double percentile) const;
+
+  /**
+   * @return the number of latencies recorded since the histogram was last cleared.
+   */
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+  void clear();
+
+  static uint32_t bucket(uint64_t latency_us);
+  static uint64_t bucketUpperBound(uint32_t bucket);
+
+private:
+  std::array<std::atomic<uint64_t>, NumBuckets> buckets_{};
+  std::atomic<uint64_t> count_{};
+};
+
+/**
+ * A concurrency controller which sets the concurrency limit from the gradient between the minimum
+ * round-trip time of the requests and the round-trip time sampled over the last interval. A
+ * smaller gradient means the requests are queuing upstream, so the limit shrinks, and a gradient
+ * close to 1 lets the limit grow by its square root, which leaves room for bursts.
+ *
+ * The minimum round-trip time is measured at jittered intervals with the limit pinned to a small
+ * concurrency, so that the measurement is not skewed by queuing.
+ *
+ * The controller is shared by the workers without locks. The limit and the number of outstanding
+ * requests are atomics, and the updates are run by the first worker to handle a request once one
+ * is due, which the others skip.
+ */
+class GradientController : public ConcurrencyController,
+                           Logger::Loggable<Logger::Id::filter> {
+public:
+  GradientController(GradientControllerConfigSharedPtr config, TimeSource& time_source,
+                     Runtime::RandomGenerator& random, const std::string& stats_prefix,
+                     Stats::Scope& scope);
+
+  // ConcurrencyController
+  RequestForwardingAction forwardingDecision() override;
+  void recordLatencySample(const std::chrono::nanoseconds& rq_latency) override;
+  void cancelLatencySample() override;
+
+  uint32_t concurrencyLimit() const { return concurrency_limit_.load(); }
+  uint32_t numRequestsOutstanding() const { return num_rq_outstanding_.load(); }
+
+private:
+  static GradientControllerStats generateStats(Stats::Scope& scope,
+                                               const std::string& stats_prefix);
+  void maybeUpdate();
+  void update(MonotonicTime now);
+  void enterMinRTTWindow();
+  void updateConcurrencyLimit(std::chrono::microseconds sample_rtt);
+  MonotonicTime nextMinRTTCalcTime(MonotonicTime now);
+  void setNextUpdateTime(MonotonicTime time);
+
+  const GradientControllerConfigSharedPtr config_;
+  TimeSource& time_source_;
+  Runtime::RandomGenerator& random_;
+  GradientControllerStats stats_;
+  LatencyHistogram histogram_;
+  std::atomic<uint32_t> concurrency_limit_;
+  std::atomic<uint32_t> num_rq_outstanding_{};
+  // The monotonic time in nanoseconds at which the next update is due.
+  std::atomic<int64_t> next_update_time_{};
+  // Held by the thread running an update.
+  std::atomic<bool> updating_{};
+  std::atomic<bool> in_min_rtt_window_{};
+
+  // Only accessed by the thread running an update.
+  MonotonicTime next_min_rtt_calc_time_;
+  std::chrono::microseconds min_rtt_{};
+  // The limit to restore once the minimum round-trip time has been measured.
+  uint32_t deferred_limit_;
+};
+
+using GradientControllerSharedPtr = std::shared_ptr<GradientController>;
+
+} // namespace ConcurrencyController
+} // namespace AdaptiveConcurrency
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,47 @@
+#include "extensions/filters/http/adaptive_concurrency/config.h"
+
+#include "envoy/registry/registry.h"
+
+#include "extensions/filters/http/adaptive_concurrency/adaptive_concurrency_filter.h"
+#include "extensions/filters/http/adaptive_concurrency/concurrency_controller/gradient_controller.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace AdaptiveConcurrency {
+
+Http::FilterFactoryCb AdaptiveConcurrencyFilterFactory::createFilterFactoryFromProtoTyped(
+    const envoy::config::filter::http::adaptive_concurrency::v2alpha::AdaptiveConcurrency&
+        proto_config,
+    const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
+  const std::string acc_stats_prefix = stats_prefix + "adaptive_concurrency.";
+
+  // The gradient controller is the only one, as enforced by the validation of the config.
+  ASSERT(proto_config.has_gradient_controller_config());
+  auto gradient_controller_config =
+      std::make_shared<const ConcurrencyController::GradientControllerConfig>(
+          proto_config.gradient_controller_config());
+  // The controller is shared by the filters of all the workers.
+  ConcurrencyControllerSharedPtr controller =
+      std::make_shared<ConcurrencyController::GradientController>(
+          std::move(gradient_controller_config), context.timeSource(), context.random(),
+          acc_stats_prefix, context.scope());
+
+  AdaptiveConcurrencyFilterConfigSharedPtr filter_config(
+      new AdaptiveConcurrencyFilterConfig(proto_config, context.runtime(), acc_stats_prefix,
+                                          context.scope(), context.timeSource()));
+  return [filter_config, controller](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addStreamFilter(std::make_shared<AdaptiveConcurrencyFilter>(filter_config, controller));
+  };
+}
+
+/**
+ * Static registration for the adaptive concurrency limit filter. @see RegisterFactory.
+ */
+REGISTER_FACTORY(AdaptiveConcurrencyFilterFactory,
+                 Server::Configuration::NamedHttpFilterConfigFactory);
+
+} // namespace AdaptiveConcurrency
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -2,6 +2,7 @@
 
 #include "envoy/event/dispatcher.h"
 #include "envoy/http/codes.h"
+#include "envoy/stream_info/stream_info.h"
 
 #include "common/common/assert.h"
 #include "common/common/enum_to_int.h"
@@ -9,7 +10,9 @@
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 #include "common/http/utility.h"
+#include "common/router/per_filter_config_ids.h"
 #include "common/runtime/runtime_impl.h"
+#include "common/singleton/const_singleton.h"
 
 #include "extensions/filters/http/well_known_names.h"
 
@@ -18,6 +21,21 @@ namespace Extensions {
 namespace HttpFilters {
 namespace BufferFilter {
 
+struct RcDetailsValues {
+  const std::string SpillBudgetExceeded = "buffer_spill_budget_exceeded";
+  const std::string SpillFailed = "buffer_spill_failed";
+};
+using RcDetails = ConstSingleton<RcDetailsValues>;
+
+namespace {
+
+BufferFilterStats generateStats(const std::string& prefix, Stats::Scope& scope) {
+  const std::string final_prefix = prefix + "buffer.";
+  return BufferFilterStats{ALL_BUFFER_FILTER_STATS(POOL_COUNTER_PREFIX(scope, final_prefix))};
+}
+
+} // namespace
+
 BufferFilterSettings::BufferFilterSettings(
     const envoy::config::filter::http::buffer::v2::Buffer& proto_config)
     : disabled_(false),
@@ -32,8 +50,16 @@ BufferFilterSettings::BufferFilterSettings(
               : 0) {}
 
 BufferFilterConfig::BufferFilterConfig(
-    const envoy::config::filter::http::buffer::v2::Buffer& proto_config)
-    : settings_(proto_config) {}
+    const envoy::config::filter::http::buffer::v2::Buffer& proto_config,
+    const std::string& stats_prefix, Stats::Scope& scope)
+    : settings_(proto_config),
+      per_filter_config_id_(Router::PerFilterConfigIds::id(HttpFilterNames::get().Buffer)),
+      stats_(generateStats(stats_prefix, scope)),
+      spill_directory_(proto_config.spill().directory()),
+      spill_memory_threshold_bytes_(proto_config.spill().memory_threshold_bytes().value()),
+      spill_budget_(proto_config.has_spill() ? std::make_shared<SpillBudget>(
+                                                   proto_config.spill().max_spill_bytes().value())
+                                             : nullptr) {}
 
 BufferFilter::BufferFilter(BufferFilterConfigSharedPtr config)
     : config_(config), settings_(config->settings()) {}
@@ -48,12 +74,9 @@ void BufferFilter::initConfig() {
     return;
   }
 
-  const std::string& name = HttpFilterNames::get().Buffer;
-  const auto* entry = callbacks_->route()->routeEntry();
-
-  const BufferFilterSettings* tmp = entry->perFilterConfigTyped<BufferFilterSettings>(name);
   const BufferFilterSettings* route_local =
-      tmp ? tmp : entry->virtualHost().perFilterConfigTyped<BufferFilterSettings>(name);
+      callbacks_->route()->mostSpecificPerFilterConfigTyped<BufferFilterSettings>(
+          config_->perFilterConfigId());
 
   settings_ = route_local ? route_local : settings_;
 }
@@ -70,7 +93,11 @@ Http::FilterHeadersStatus BufferFilter::decodeHeaders(Http::HeaderMap& headers,
     return Http::FilterHeadersStatus::Continue;
   }
 
-  callbacks_->setDecoderBufferLimit(settings_->maxRequestBytes());
+  // When spilling, the filter holds the body and enforces its maximum size itself.
+  spilling_ = config_->spillEnabled();
+  if (!spilling_) {
+    callbacks_->setDecoderBufferLimit(settings_->maxRequestBytes());
+  }
   request_headers_ = &headers;
 
   return Http::FilterHeadersStatus::StopIteration;
@@ -78,15 +105,11 @@ Http::FilterHeadersStatus BufferFilter::decodeHeaders(Http::HeaderMap& headers,
 
 Http::FilterDataStatus BufferFilter::decodeData(Buffer::Instance& data, bool end_stream) {
   content_length_ += data.length();
+  if (spilling_) {
+    return spillData(data, end_stream);
+  }
   if (end_stream || settings_->disabled()) {
-    // request_headers_ is initialized iff plugin is enabled.
-    if (request_headers_ != nullptr && request_headers_->ContentLength() == nullptr) {
-      ASSERT(!settings_->disabled());
-      if (Runtime::runtimeFeatureEnabled(
-              "envoy.reloadable_features.buffer_filter_populate_content_length")) {
-        request_headers_->insertContentLength().value(content_length_);
-      }
-    }
+    populateContentLength();
     return Http::FilterDataStatus::Continue;
   }
 
@@ -95,9 +118,116 @@ Http::FilterDataStatus BufferFilter::decodeData(Buffer::Instance& data, bool end
 }
 
 Http::FilterTrailersStatus BufferFilter::decodeTrailers(Http::HeaderMap&) {
+  if (spilling_) {
+    if (rejected_) {
+      return Http::FilterTrailersStatus::StopIteration;
+    }
+    Buffer::OwnedImpl body;
+    if (!releaseBody(body)) {
+      return Http::FilterTrailersStatus::StopIteration;
+    }
+    if (body.length() > 0) {
+      callbacks_->addDecodedData(body, false);
+    }
+  }
   return Http::FilterTrailersStatus::Continue;
 }
 
+void BufferFilter::populateContentLength() {
+  // request_headers_ is initialized iff plugin is enabled.
+  if (request_headers_ != nullptr && request_headers_->ContentLength() == nullptr) {
+    ASSERT(!settings_->disabled());
+    if (Runtime::runtimeFeatureEnabled(
+            "envoy.reloadable_features.buffer_filter_populate_content_length")) {
+      request_headers_->insertContentLength().value(content_length_);
+    }
+  }
+}
+
+Http::FilterDataStatus BufferFilter::spillData(Buffer::Instance& data, bool end_stream) {
+  if (rejected_) {
+    data.drain(data.length());
+    return Http::FilterDataStatus::StopIterationNoBuffer;
+  }
+  if (content_length_ > settings_->maxRequestBytes()) {
+    config_->stats().rq_too_large_.inc();
+    reject(Http::Code::PayloadTooLarge,
+           StreamInfo::ResponseCodeDetails::get().RequestPayloadTooLarge);
+    data.drain(data.length());
+    return Http::FilterDataStatus::StopIterationNoBuffer;
+  }
+  if (!holdData(data) || !end_stream) {
+    return Http::FilterDataStatus::StopIterationNoBuffer;
+  }
+
+  // The data of the last frame was held along with the rest, so the whole body takes its place.
+  if (!releaseBody(data)) {
+    return Http::FilterDataStatus::StopIterationNoBuffer;
+  }
+  populateContentLength();
+  return Http::FilterDataStatus::Continue;
+}
+
+bool BufferFilter::holdData(Buffer::Instance& data) {
+  const uint64_t memory_threshold_bytes = config_->spillMemoryThresholdBytes();
+  if (spill_file_ == nullptr) {
+    if (body_.length() + data.length() <= memory_threshold_bytes) {
+      body_.move(data);
+      return true;
+    }
+    // Once the memory is full, the rest of the body goes to the file, so the body is the data
+    // held in memory followed by the file.
+    body_.move(data, memory_threshold_bytes - body_.length());
+    spill_file_ = SpillFile::create(config_->spillDirectory(), config_->spillBudget());
+    if (spill_file_ == nullptr) {
+      config_->stats().rq_spill_failed_.inc();
+      reject(Http::Code::InternalServerError, RcDetails::get().SpillFailed);
+      data.drain(data.length());
+      return false;
+    }
+    config_->stats().rq_spilled_.inc();
+  }
+
+  const uint64_t length = data.length();
+  switch (spill_file_->write(data)) {
+  case SpillFile::WriteResult::Written:
+    config_->stats().spilled_bytes_.add(length);
+    return true;
+  case SpillFile::WriteResult::OverBudget:
+    config_->stats().rq_spill_budget_exceeded_.inc();
+    reject(Http::Code::InsufficientStorage, RcDetails::get().SpillBudgetExceeded);
+    break;
+  case SpillFile::WriteResult::Failed:
+    config_->stats().rq_spill_failed_.inc();
+    reject(Http::Code::InternalServerError, RcDetails::get().SpillFailed);
+    break;
+  }
+  data.drain(data.length());
+  return false;
+}
+
+bool BufferFilter::releaseBody(Buffer::Instance& output) {
+  if (spill_file_ != nullptr) {
+    const bool mapped = spill_file_->moveTo(body_);
+    spill_file_.reset();
+    if (!mapped) {
+      config_->stats().rq_spill_failed_.inc();
+      reject(Http::Code::InternalServerError, RcDetails::get().SpillFailed);
+      return false;
+    }
+  }
+  output.move(body_);
+  return true;
+}
+
+void BufferFilter::reject(Http::Code code, absl::string_view details) {
+  rejected_ = true;
+  body_.drain(body_.length());
+  spill_file_.reset();
+  callbacks_->sendLocalReply(code, Http::CodeUtility::toString(code), nullptr, absl::nullopt,
+                             details);
+}
+
 void BufferFilter::setDecoderFilterCallbacks(Http::StreamDecoderFilterCallbacks& callbacks) {
   callbacks_ = &callbacks;
 }
@@ -7,14 +7,35 @@
 
 #include "envoy/config/filter/http/buffer/v2/buffer.pb.h"
 #include "envoy/http/filter.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "common/buffer/buffer_impl.h"
 
+#include "extensions/filters/http/buffer/spill_file.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
 namespace BufferFilter {
 
+/**
+ * All buffer filter stats. @see stats_macros.h
+ */
+#define ALL_BUFFER_FILTER_STATS(COUNTER)                                                           \
+  COUNTER(rq_spill_budget_exceeded)                                                                \
+  COUNTER(rq_spill_failed)                                                                         \
+  COUNTER(rq_spilled)                                                                              \
+  COUNTER(rq_too_large)                                                                            \
+  COUNTER(spilled_bytes)
+
+/**
+ * Struct definition for buffer filter stats. @see stats_macros.h
+ */
+struct BufferFilterStats {
+  ALL_BUFFER_FILTER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
 class BufferFilterSettings : public Router::RouteSpecificFilterConfig {
 public:
   BufferFilterSettings(const envoy::config::filter::http::buffer::v2::Buffer&);
@@ -33,12 +54,29 @@ private:
  */
 class BufferFilterConfig {
 public:
-  BufferFilterConfig(const envoy::config::filter::http::buffer::v2::Buffer& proto_config);
+  BufferFilterConfig(const envoy::config::filter::http::buffer::v2::Buffer& proto_config,
+                     const std::string& stats_prefix, Stats::Scope& scope);
 
   const BufferFilterSettings* settings() const { return &settings_; }
+  uint32_t perFilterConfigId() const { return per_filter_config_id_; }
+  BufferFilterStats& stats() { return stats_; }
+
+  /**
+   * @return whether the request bodies are spilled to temporary files beyond
+   *         spillMemoryThresholdBytes(), rather than buffered by the connection manager.
+   */
+  bool spillEnabled() const { return spill_budget_ != nullptr; }
+  const std::string& spillDirectory() const { return spill_directory_; }
+  uint64_t spillMemoryThresholdBytes() const { return spill_memory_threshold_bytes_; }
+  const SpillBudgetSharedPtr& spillBudget() const { return spill_budget_; }
 
 private:
   const BufferFilterSettings settings_;
+  const uint32_t per_filter_config_id_;
+  BufferFilterStats stats_;
+  const std::string spill_directory_;
+  const uint64_t spill_memory_threshold_bytes_;
+  const SpillBudgetSharedPtr spill_budget_;
 };
 
 using BufferFilterConfigSharedPtr = std::shared_ptr<BufferFilterConfig>;
@@ -61,6 +99,15 @@ public:
 
 private:
   void initConfig();
+  void populateContentLength();
+  Http::FilterDataStatus spillData(Buffer::Instance& data, bool end_stream);
+  // Holds the data in memory, or in the spill file once the memory threshold is reached. Returns
+  // false if the request was rejected.
+  bool holdData(Buffer::Instance& data);
+  // Moves the whole body held to the output, mapping the spill file if any. Returns false if the
+  // request was rejected.
+  bool releaseBody(Buffer::Instance& output);
+  void reject(Http::Code code, absl::string_view details);
 
   BufferFilterConfigSharedPtr config_;
   const BufferFilterSettings* settings_;
@@ -68,6 +115,11 @@ private:
   Http::HeaderMap* request_headers_{};
   uint64_t content_length_{};
   bool config_initialized_{};
+  // Set when the filter holds the body itself, spilling it beyond the memory threshold.
+  bool spilling_{};
+  bool rejected_{};
+  Buffer::OwnedImpl body_;
+  SpillFilePtr spill_file_;
 };
 
 } // namespace BufferFilter
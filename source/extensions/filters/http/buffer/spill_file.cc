@@ -0,0 +1,127 @@
+#include "extensions/filters/http/buffer/spill_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "envoy/api/os_sys_calls.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace BufferFilter {
+
+bool SpillBudget::tryReserve(uint64_t bytes) {
+  uint64_t used_bytes = used_bytes_.load();
+  do {
+    if (bytes > max_bytes_ - used_bytes) {
+      return false;
+    }
+  } while (!used_bytes_.compare_exchange_weak(used_bytes, used_bytes + bytes));
+  return true;
+}
+
+std::unique_ptr<SpillFile> SpillFile::create(const std::string& directory,
+                                             SpillBudgetSharedPtr budget) {
+  std::string path = directory + "/envoy_buffer_XXXXXX";
+  const int fd = ::mkostemp(&path[0], O_CLOEXEC);
+  if (fd == -1) {
+    ENVOY_LOG(warn, "unable to create a spill file in '{}': {}", directory, strerror(errno));
+    return nullptr;
+  }
+  ::unlink(path.c_str());
+  return std::unique_ptr<SpillFile>(new SpillFile(fd, std::move(budget)));
+}
+
+SpillFile::~SpillFile() {
+  close();
+  budget_->release(size_);
+}
+
+void SpillFile::close() {
+  if (fd_ != -1) {
+    Api::OsSysCallsSingleton::get().close(fd_);
+    fd_ = -1;
+  }
+}
+
+SpillFile::WriteResult SpillFile::write(Buffer::Instance& data) {
+  ASSERT(fd_ != -1);
+  const uint64_t length = data.length();
+  if (!budget_->tryReserve(length)) {
+    return WriteResult::OverBudget;
+  }
+  size_ += length;
+
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  constexpr uint64_t MaxSlices = 16;
+  while (data.length() > 0) {
+    Buffer::RawSlice slices[MaxSlices];
+    const uint64_t num_slices = std::min(data.getRawSlices(slices, MaxSlices), MaxSlices);
+    iovec iov[MaxSlices];
+    int num_iov = 0;
+    for (uint64_t i = 0; i < num_slices; i++) {
+      if (slices[i].len_ != 0) {
+        iov[num_iov].iov_base = slices[i].mem_;
+        iov[num_iov].iov_len = slices[i].len_;
+        num_iov++;
+      }
+    }
+    const Api::SysCallSizeResult result = os_sys_calls.writev(fd_, iov, num_iov);
+    if (result.rc_ == -1) {
+      if (result.errno_ == EINTR) {
+        continue;
+      }
+      ENVOY_LOG(warn, "unable to write a spill file: {}", strerror(result.errno_));
+      return WriteResult::Failed;
+    }
+    data.drain(result.rc_);
+  }
+  return WriteResult::Written;
+}
+
+bool SpillFile::moveTo(Buffer::Instance& output) {
+  ASSERT(fd_ != -1);
+  if (size_ == 0) {
+    close();
+    return true;
+  }
+
+  // The mapping outlives the file descriptor, so the file is closed right away.
+  const Api::SysCallPtrResult result =
+      Api::OsSysCallsSingleton::get().mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+  close();
+  if (result.rc_ == MAP_FAILED) {
+    ENVOY_LOG(warn, "unable to map a spill file: {}", strerror(result.errno_));
+    return false;
+  }
+  ::madvise(result.rc_, size_, MADV_SEQUENTIAL);
+
+  // From now on the bytes are released from the budget along with the mapping.
+  SpillBudgetSharedPtr budget = budget_;
+  auto* fragment = new Buffer::BufferFragmentImpl(
+      result.rc_, size_,
+      [budget](const void* data, size_t size, const Buffer::BufferFragmentImpl* fragment) {
+        ::munmap(const_cast<void*>(data), size);
+        budget->release(size);
+        delete fragment;
+      });
+  size_ = 0;
+  output.addBufferFragment(*fragment);
+  return true;
+}
+
+} // namespace BufferFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/buffer/buffer.h"
+
+#include "common/common/logger.h"
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace BufferFilter {
+
+/**
+ * The bytes that the spill files of a filter may hold at once. It is shared by the workers, and by
+ * the buffers holding mapped spill files, which may outlive the filter config.
+ */
+class SpillBudget {
+public:
+  explicit SpillBudget(uint64_t max_bytes) : max_bytes_(max_bytes) {}
+
+  /**
+   * @param bytes supplies the number of bytes to reserve.
+   * @return whether the bytes fit in the budget, in which case they are reserved.
+   */
+  bool tryReserve(uint64_t bytes);
+
+  /**
+   * @param bytes supplies the number of bytes reserved to give back to the budget.
+   */
+  void release(uint64_t bytes) { used_bytes_ -= bytes; }
+
+  /**
+   * @return the number of bytes reserved.
+   */
+  uint64_t usedBytes() const { return used_bytes_; }
+
+private:
+  const uint64_t max_bytes_;
+  std::atomic<uint64_t> used_bytes_{};
+};
+
+using SpillBudgetSharedPtr = std::shared_ptr<SpillBudget>;
+
+/**
+ * A temporary file holding the part of a request body spilled out of memory. The file is unlinked
+ * as soon as it is created, so its space is reclaimed once it is closed and unmapped, whatever
+ * happens to the process. The bytes written are reserved in the budget until the file is closed,
+ * or, once the file is mapped, until the buffer holding the mapping releases it.
+ */
+class SpillFile : NonCopyable, Logger::Loggable<Logger::Id::filter> {
+public:
+  enum class WriteResult { Written, OverBudget, Failed };
+
+  /**
+   * @param directory supplies the directory to create the file in.
+   * @param budget supplies the budget the bytes written are reserved in.
+   * @return the file, or nullptr if it could not be created.
+   */
+  static std::unique_ptr<SpillFile> create(const std::string& directory,
+                                           SpillBudgetSharedPtr budget);
+
+  ~SpillFile();
+
+  /**
+   * Writes a buffer to the end of the file, draining it. The write is blocking, which for a file
+   * only waits for the page cache.
+   * @param data supplies the buffer to write.
+   * @return Written once the whole buffer has been written, OverBudget if it does not fit in the
+   *         budget, in which case the buffer is left as is, or Failed if it could not be written.
+   */
+  WriteResult write(Buffer::Instance& data);
+
+  /**
+   * Maps the file into memory and adds it to the end of a buffer, as a fragment unmapped once the
+   * buffer releases it. The file is closed, so it can not be written anymore.
+   * @param output supplies the buffer to add the file to.
+   * @return whether the file could be mapped.
+   */
+  bool moveTo(Buffer::Instance& output);
+
+private:
+  SpillFile(int fd, SpillBudgetSharedPtr budget) : fd_(fd), budget_(std::move(budget)) {}
+
+  void close();
+
+  int fd_;
+  const SpillBudgetSharedPtr budget_;
+  // The bytes written to the file, and reserved in the budget, which are not mapped yet.
+  uint64_t size_{};
+};
+
+using SpillFilePtr = std::unique_ptr<SpillFile>;
+
+} // namespace BufferFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,350 @@
+#include "extensions/filters/http/cache/cache_filter.h"
+
+#include "envoy/http/codes.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/enum_to_int.h"
+#include "common/common/macros.h"
+#include "common/common/stack_array.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/headers.h"
+#include "common/http/utility.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/filters/http/cache/lru_http_cache.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+namespace {
+
+const uint32_t DefaultMaxEntries = 1024;
+const uint64_t DefaultMaxTotalBodyBytes = 64 * 1024 * 1024;
+const uint32_t DefaultMaxBodyBytes = 1024 * 1024;
+
+const Http::LowerCaseString& ageHeader() { CONSTRUCT_ON_FIRST_USE(Http::LowerCaseString, "age"); }
+
+const Http::LowerCaseString& ifNoneMatchHeader() {
+  CONSTRUCT_ON_FIRST_USE(Http::LowerCaseString, "if-none-match");
+}
+
+struct ThreadLocalCache : public ThreadLocal::ThreadLocalObject {
+  ThreadLocalCache(uint32_t max_entries, uint64_t max_total_body_bytes, TimeSource& time_source)
+      : cache_(max_entries, max_total_body_bytes, time_source) {}
+
+  LruHttpCache cache_;
+  FillTracker fills_;
+};
+
+CacheStats generateStats(const std::string& prefix, Stats::Scope& scope) {
+  return CacheStats{ALL_CACHE_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
+}
+
+// Splits a comma separated header value into its trimmed elements.
+std::vector<absl::string_view> headerElements(absl::string_view value) {
+  std::vector<absl::string_view> elements;
+  for (absl::string_view element : absl::StrSplit(value, ',')) {
+    element = absl::StripAsciiWhitespace(element);
+    if (!element.empty()) {
+      elements.push_back(element);
+    }
+  }
+  return elements;
+}
+
+// Whether a Cache-Control header has a directive, regardless of its value.
+bool hasDirective(const Http::HeaderEntry* cache_control, absl::string_view directive) {
+  if (cache_control == nullptr) {
+    return false;
+  }
+  for (absl::string_view element : headerElements(cache_control->value().getStringView())) {
+    if (absl::EqualsIgnoreCase(element.substr(0, element.find('=')), directive)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Parses a number of seconds, possibly quoted, as found in Cache-Control directives and Age.
+absl::optional<std::chrono::seconds> parseSeconds(absl::string_view value) {
+  if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+    value = value.substr(1, value.size() - 2);
+  }
+  uint32_t seconds;
+  if (!absl::SimpleAtoi(value, &seconds)) {
+    return absl::nullopt;
+  }
+  return std::chrono::seconds(seconds);
+}
+
+// Whether an If-None-Match header matches an entity tag, with the weak comparison of RFC 7232.
+bool etagMatches(absl::string_view if_none_match, absl::string_view etag) {
+  absl::ConsumePrefix(&etag, "W/");
+  for (absl::string_view candidate : headerElements(if_none_match)) {
+    absl::ConsumePrefix(&candidate, "W/");
+    if (candidate == "*" || candidate == etag) {
+      return true;
+    }
+  }
+  return false;
+}
+
+absl::string_view headerValue(const Http::HeaderMap& headers, const Http::LowerCaseString& name) {
+  const Http::HeaderEntry* entry = headers.get(name);
+  return entry != nullptr ? entry->value().getStringView() : absl::string_view();
+}
+
+} // namespace
+
+CacheFilterConfig::CacheFilterConfig(
+    const envoy::config::filter::http::cache::v2alpha::CacheConfig& config,
+    const std::string& stats_prefix, Stats::Scope& scope, ThreadLocal::SlotAllocator& tls)
+    : stats_(generateStats(stats_prefix + "cache.", scope)),
+      max_body_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_body_bytes, DefaultMaxBodyBytes)),
+      tls_(tls.allocateSlot()) {
+  const uint32_t max_entries =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entries, DefaultMaxEntries);
+  const uint64_t max_total_body_bytes =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_total_body_bytes, DefaultMaxTotalBodyBytes);
+  tls_->set([max_entries, max_total_body_bytes](
+                Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<ThreadLocalCache>(max_entries, max_total_body_bytes,
+                                              dispatcher.timeSource());
+  });
+}
+
+HttpCache& CacheFilterConfig::cache() { return tls_->getTyped<ThreadLocalCache>().cache_; }
+
+FillTracker& CacheFilterConfig::fills() { return tls_->getTyped<ThreadLocalCache>().fills_; }
+
+absl::optional<std::chrono::seconds>
+CacheFilter::freshnessLifetime(const Http::HeaderMap& response_headers) {
+  if (response_headers.CacheControl() == nullptr) {
+    // Heuristic freshness is not supported, responses are only stored when explicitly allowed.
+    return absl::nullopt;
+  }
+
+  absl::optional<std::chrono::seconds> max_age;
+  absl::optional<std::chrono::seconds> s_maxage;
+  for (absl::string_view directive :
+       headerElements(response_headers.CacheControl()->value().getStringView())) {
+    const std::pair<absl::string_view, absl::string_view> name_value =
+        absl::StrSplit(directive, absl::MaxSplits('=', 1));
+    const absl::string_view name = absl::StripAsciiWhitespace(name_value.first);
+    const absl::string_view value = absl::StripAsciiWhitespace(name_value.second);
+    if (absl::EqualsIgnoreCase(name, "no-store") || absl::EqualsIgnoreCase(name, "no-cache") ||
+        absl::EqualsIgnoreCase(name, "private")) {
+      return absl::nullopt;
+    } else if (absl::EqualsIgnoreCase(name, "max-age")) {
+      max_age = parseSeconds(value);
+    } else if (absl::EqualsIgnoreCase(name, "s-maxage")) {
+      s_maxage = parseSeconds(value);
+    }
+  }
+
+  // As a shared cache, s-maxage takes precedence over max-age.
+  const absl::optional<std::chrono::seconds> lifetime = s_maxage ? s_maxage : max_age;
+  if (!lifetime || lifetime.value().count() == 0) {
+    return absl::nullopt;
+  }
+  return lifetime;
+}
+
+void CacheFilter::onDestroy() {
+  destroyed_ = true;
+  if (state_ == State::Filling) {
+    endFill();
+  } else if (state_ == State::Waiting) {
+    config_->fills().leave(key_, *this);
+    state_ = State::PassThrough;
+  }
+}
+
+Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::HeaderMap& headers, bool) {
+  // Requests with credentials are not served from nor stored in the cache, nor are those asking
+  // not to be served from it.
+  if (headers.Method() == nullptr ||
+      headers.Method()->value().getStringView() != Http::Headers::get().MethodValues.Get ||
+      headers.Host() == nullptr || headers.Path() == nullptr ||
+      headers.Authorization() != nullptr ||
+      hasDirective(headers.CacheControl(), Http::Headers::get().CacheControlValues.NoCache)) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  request_headers_ = &headers;
+  key_ = absl::StrCat(headers.Host()->value().getStringView(),
+                      headers.Path()->value().getStringView());
+  if (serveFromCache()) {
+    config_->stats().hit_.inc();
+    return Http::FilterHeadersStatus::StopIteration;
+  }
+
+  config_->stats().miss_.inc();
+  if (config_->fills().join(key_, *this)) {
+    ENVOY_STREAM_LOG(trace, "cache: waiting for the fill of {}", *decoder_callbacks_, key_);
+    config_->stats().coalesced_.inc();
+    state_ = State::Waiting;
+    return Http::FilterHeadersStatus::StopIteration;
+  }
+  state_ = State::Filling;
+  return Http::FilterHeadersStatus::Continue;
+}
+
+Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::HeaderMap& headers, bool end_stream) {
+  if (state_ != State::Filling) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  const absl::optional<std::chrono::seconds> lifetime = freshnessLifetime(headers);
+  const std::chrono::seconds age =
+      parseSeconds(headerValue(headers, ageHeader())).value_or(std::chrono::seconds(0));
+  if (Http::Utility::getResponseStatus(headers) != enumToInt(Http::Code::OK) || !lifetime ||
+      age >= lifetime.value()) {
+    endFill();
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  auto fill = std::make_shared<CachedResponse>();
+  if (headers.Vary() != nullptr) {
+    for (absl::string_view name : headerElements(headers.Vary()->value().getStringView())) {
+      if (name == "*") {
+        endFill();
+        return Http::FilterHeadersStatus::Continue;
+      }
+      Http::LowerCaseString header(std::string{name});
+      std::string value{headerValue(*request_headers_, header)};
+      fill->vary_.emplace_back(std::move(header), std::move(value));
+    }
+  }
+  const MonotonicTime now = encoder_callbacks_->dispatcher().timeSource().monotonicTime();
+  fill->headers_ = std::make_unique<Http::HeaderMapImpl>(headers);
+  fill->response_time_ = now;
+  fill->initial_age_ = age;
+  fill->expiry_ = now + (lifetime.value() - age);
+  fill_ = std::move(fill);
+
+  if (end_stream) {
+    insertFill();
+  }
+  return Http::FilterHeadersStatus::Continue;
+}
+
+Http::FilterDataStatus CacheFilter::encodeData(Buffer::Instance& data, bool end_stream) {
+  if (state_ != State::Filling) {
+    return Http::FilterDataStatus::Continue;
+  }
+
+  if (fill_->body_.size() + data.length() > config_->maxBodyBytes()) {
+    endFill();
+    return Http::FilterDataStatus::Continue;
+  }
+  const uint64_t num_slices = data.getRawSlices(nullptr, 0);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  data.getRawSlices(slices.begin(), num_slices);
+  for (const Buffer::RawSlice& slice : slices) {
+    fill_->body_.append(static_cast<const char*>(slice.mem_), slice.len_);
+  }
+
+  if (end_stream) {
+    insertFill();
+  }
+  return Http::FilterDataStatus::Continue;
+}
+
+Http::FilterTrailersStatus CacheFilter::encodeTrailers(Http::HeaderMap&) {
+  // Responses with trailers are not stored.
+  if (state_ == State::Filling) {
+    endFill();
+  }
+  return Http::FilterTrailersStatus::Continue;
+}
+
+void CacheFilter::onFillComplete() {
+  state_ = State::PassThrough;
+  if (serveFromCache()) {
+    return;
+  }
+  // The response of the fill could not be stored or does not match the request, which goes
+  // upstream in turn.
+  decoder_callbacks_->continueDecoding();
+}
+
+bool CacheFilter::serveFromCache() {
+  CachedResponseConstSharedPtr response = config_->cache().lookup(key_);
+  if (response == nullptr) {
+    return false;
+  }
+  for (const auto& vary : response->vary_) {
+    if (headerValue(*request_headers_, vary.first) != vary.second) {
+      return false;
+    }
+  }
+  serve(response);
+  return true;
+}
+
+void CacheFilter::serve(const CachedResponseConstSharedPtr& response) {
+  ENVOY_STREAM_LOG(debug, "cache: serving {} from the cache", *decoder_callbacks_, key_);
+  state_ = State::Serving;
+
+  const MonotonicTime now = decoder_callbacks_->dispatcher().timeSource().monotonicTime();
+  const std::chrono::seconds age =
+      response->initial_age_ +
+      std::chrono::duration_cast<std::chrono::seconds>(now - response->response_time_);
+  auto headers = std::make_unique<Http::HeaderMapImpl>(*response->headers_);
+  headers->remove(ageHeader());
+  headers->addReferenceKey(ageHeader(), age.count());
+
+  const Http::HeaderEntry* if_none_match = request_headers_->get(ifNoneMatchHeader());
+  if (if_none_match != nullptr && response->headers_->Etag() != nullptr &&
+      etagMatches(if_none_match->value().getStringView(),
+                  response->headers_->Etag()->value().getStringView())) {
+    config_->stats().not_modified_.inc();
+    headers->insertStatus().value(enumToInt(Http::Code::NotModified));
+    headers->removeContentLength();
+    decoder_callbacks_->encodeHeaders(std::move(headers), true);
+    return;
+  }
+
+  const bool has_body = !response->body_.empty();
+  decoder_callbacks_->encodeHeaders(std::move(headers), !has_body);
+  if (!has_body || destroyed_) {
+    return;
+  }
+  // The body is referenced rather than copied, the response being kept alive until the buffer is
+  // done with it.
+  auto* fragment = new Buffer::BufferFragmentImpl(
+      response->body_.data(), response->body_.size(),
+      [response](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+        delete fragment;
+      });
+  Buffer::OwnedImpl body;
+  body.addBufferFragment(*fragment);
+  decoder_callbacks_->encodeData(body, true);
+}
+
+void CacheFilter::insertFill() {
+  config_->cache().insert(key_, std::move(fill_));
+  config_->stats().insert_.inc();
+  endFill();
+}
+
+void CacheFilter::endFill() {
+  fill_.reset();
+  state_ = State::PassThrough;
+  config_->fills().complete(key_);
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "envoy/config/filter/http/cache/v2alpha/cache.pb.h"
+#include "envoy/http/filter.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/logger.h"
+
+#include "extensions/filters/http/cache/fill_tracker.h"
+#include "extensions/filters/http/cache/http_cache.h"
+#include "extensions/filters/http/common/pass_through_filter.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All cache filter stats. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_CACHE_STATS(COUNTER) \
+  COUNTER(hit)                   \
+  COUNTER(miss)                  \
+  COUNTER(coalesced)             \
+  COUNTER(not_modified)          \
+  COUNTER(insert)
+// clang-format on
+
+/**
+ * Struct definition for cache filter stats. @see stats_macros.h
+ */
+struct CacheStats {
+  ALL_CACHE_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Configuration for the cache filter, holding the cache and the fills in flight of each worker.
+ */
+class CacheFilterConfig {
+public:
+  CacheFilterConfig(const envoy::config::filter::http::cache::v2alpha::CacheConfig& config,
+                    const std::string& stats_prefix, Stats::Scope& scope,
+                    ThreadLocal::SlotAllocator& tls);
+
+  CacheStats& stats() { return stats_; }
+  uint32_t maxBodyBytes() const { return max_body_bytes_; }
+
+  /**
+   * @return the cache of the current worker.
+   */
+  HttpCache& cache();
+
+  /**
+   * @return the fills in flight of the current worker.
+   */
+  FillTracker& fills();
+
+private:
+  CacheStats stats_;
+  const uint32_t max_body_bytes_;
+  ThreadLocal::SlotPtr tls_;
+};
+using CacheFilterConfigSharedPtr = std::shared_ptr<CacheFilterConfig>;
+
+/**
+ * A filter which stores the fresh responses to GET requests per their Cache-Control header, and
+ * serves them to the following requests for the same host and path.
+ */
+class CacheFilter : public Http::PassThroughFilter,
+                    public FillTracker::Waiter,
+                    Logger::Loggable<Logger::Id::filter> {
+public:
+  CacheFilter(const CacheFilterConfigSharedPtr& config) : config_(config) {}
+
+  /**
+   * @return how long a response may be stored and served for per its Cache-Control header, or
+   *         absl::nullopt if it may not be stored.
+   */
+  static absl::optional<std::chrono::seconds>
+  freshnessLifetime(const Http::HeaderMap& response_headers);
+
+  // Http::StreamFilterBase
+  void onDestroy() override;
+
+  // Http::StreamDecoderFilter
+  Http::FilterHeadersStatus decodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+
+  // Http::StreamEncoderFilter
+  Http::FilterHeadersStatus encodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
+  Http::FilterDataStatus encodeData(Buffer::Instance& data, bool end_stream) override;
+  Http::FilterTrailersStatus encodeTrailers(Http::HeaderMap& trailers) override;
+
+  // FillTracker::Waiter
+  void onFillComplete() override;
+
+private:
+  enum class State {
+    // The request is not handled by the cache, or no longer.
+    PassThrough,
+    // The request waits for the fill of its key by another request.
+    Waiting,
+    // The response of the request is stored once complete.
+    Filling,
+    // The request was served from the cache.
+    Serving
+  };
+
+  bool serveFromCache();
+  void serve(const CachedResponseConstSharedPtr& response);
+  void insertFill();
+  void endFill();
+
+  const CacheFilterConfigSharedPtr config_;
+  State state_{State::PassThrough};
+  bool destroyed_{};
+  std::string key_;
+  const Http::HeaderMap* request_headers_{};
+  std::shared_ptr<CachedResponse> fill_;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,46 @@
+#include "extensions/filters/http/cache/fill_tracker.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+bool FillTracker::join(const std::string& key, Waiter& waiter) {
+  const auto it = fills_.find(key);
+  if (it == fills_.end()) {
+    fills_.emplace(key, std::list<Waiter*>());
+    return false;
+  }
+  it->second.push_back(&waiter);
+  return true;
+}
+
+void FillTracker::leave(const std::string& key, Waiter& waiter) {
+  const auto it = fills_.find(key);
+  if (it != fills_.end()) {
+    it->second.remove(&waiter);
+  }
+}
+
+void FillTracker::complete(const std::string& key) {
+  // The waiters are taken one at a time, as serving one request may destroy others, which then
+  // leave the fill.
+  while (true) {
+    const auto it = fills_.find(key);
+    ASSERT(it != fills_.end());
+    if (it->second.empty()) {
+      fills_.erase(it);
+      return;
+    }
+    Waiter* waiter = it->second.front();
+    it->second.pop_front();
+    waiter->onFillComplete();
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <list>
+#include <string>
+
+#include "envoy/common/pure.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Tracks the requests filling the cache, so that the concurrent misses for a key wait for the
+ * response of the first one rather than all going upstream. Like the filters using it, it is per
+ * thread and its operations are not protected.
+ */
+class FillTracker {
+public:
+  /**
+   * A request waiting for the fill of its key.
+   */
+  class Waiter {
+  public:
+    virtual ~Waiter() = default;
+
+    /**
+     * Called once the fill is over, whether its response was stored or not.
+     */
+    virtual void onFillComplete() PURE;
+  };
+
+  /**
+   * Join the fill in flight for a key, if there is one.
+   * @return true if the waiter was added to the fill in flight, in which case it is called back
+   *         once it completes. Otherwise the caller is recorded as filling the key, and must call
+   *         complete() later.
+   */
+  bool join(const std::string& key, Waiter& waiter);
+
+  /**
+   * Stop waiting for the fill of a key, e.g. as the request was destroyed.
+   */
+  void leave(const std::string& key, Waiter& waiter);
+
+  /**
+   * Complete the fill of a key, calling back its waiters.
+   */
+  void complete(const std::string& key);
+
+private:
+  // The waiters of the fills in flight, by key.
+  absl::flat_hash_map<std::string, std::list<Waiter*>> fills_;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/common/pure.h"
+#include "envoy/common/time.h"
+#include "envoy/http/header_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * A response stored in a cache. It is immutable once inserted, and shared with the requests it is
+ * served to for as long as they need its body.
+ */
+struct CachedResponse {
+  Http::HeaderMapPtr headers_;
+  std::string body_;
+  // The request headers named by the Vary header of the response, with their values in the request
+  // the response was stored for. A request only matches the response if it has the same values.
+  std::vector<std::pair<Http::LowerCaseString, std::string>> vary_;
+  // The time the response was received, and its age at that time per its Age header.
+  MonotonicTime response_time_;
+  std::chrono::seconds initial_age_;
+  // The time the response stops being fresh.
+  MonotonicTime expiry_;
+};
+
+using CachedResponseConstSharedPtr = std::shared_ptr<const CachedResponse>;
+
+/**
+ * The storage of the cache filter, keyed by the host and path of the requests.
+ */
+class HttpCache {
+public:
+  virtual ~HttpCache() = default;
+
+  /**
+   * @return the response stored for a key, or nullptr if there is none or it is no longer fresh.
+   */
+  virtual CachedResponseConstSharedPtr lookup(const std::string& key) PURE;
+
+  /**
+   * Store a response, replacing the one stored for the same key if any.
+   */
+  virtual void insert(const std::string& key, CachedResponseConstSharedPtr response) PURE;
+};
+
+using HttpCachePtr = std::unique_ptr<HttpCache>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,50 @@
+#include "extensions/filters/http/cache/lru_http_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+CachedResponseConstSharedPtr LruHttpCache::lookup(const std::string& key) {
+  const auto it = map_.find(key);
+  if (it == map_.end()) {
+    return nullptr;
+  }
+  const LruList::iterator entry = it->second;
+  if (entry->second->expiry_ <= time_source_.monotonicTime()) {
+    remove(entry);
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, entry);
+  return entry->second;
+}
+
+void LruHttpCache::insert(const std::string& key, CachedResponseConstSharedPtr response) {
+  const auto it = map_.find(key);
+  if (it != map_.end()) {
+    remove(it->second);
+  }
+
+  const uint64_t body_bytes = response->body_.size();
+  if (max_entries_ == 0 || body_bytes > max_total_body_bytes_) {
+    return;
+  }
+  while (!lru_.empty() &&
+         (lru_.size() >= max_entries_ || total_body_bytes_ + body_bytes > max_total_body_bytes_)) {
+    remove(std::prev(lru_.end()));
+  }
+  total_body_bytes_ += body_bytes;
+  lru_.emplace_front(key, std::move(response));
+  map_.emplace(lru_.front().first, lru_.begin());
+}
+
+void LruHttpCache::remove(LruList::iterator entry) {
+  total_body_bytes_ -= entry->second->body_.size();
+  map_.erase(entry->first);
+  lru_.erase(entry);
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
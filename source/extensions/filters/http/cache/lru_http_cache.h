@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+
+#include "envoy/common/time.h"
+
+#include "extensions/filters/http/cache/http_cache.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * An in-memory cache bounded by its number of responses and the total size of their bodies, which
+ * evicts the least recently used responses first. Like the filters using it, it is per thread and
+ * its operations are not protected.
+ */
+class LruHttpCache : public HttpCache {
+public:
+  /**
+   * @param max_entries supplies the maximum number of stored responses.
+   * @param max_total_body_bytes supplies the maximum total size of the stored bodies.
+   * @param time_source supplies the time the freshness of the responses is checked with.
+   */
+  LruHttpCache(uint32_t max_entries, uint64_t max_total_body_bytes, TimeSource& time_source)
+      : max_entries_(max_entries), max_total_body_bytes_(max_total_body_bytes),
+        time_source_(time_source) {}
+
+  // HttpCache
+  CachedResponseConstSharedPtr lookup(const std::string& key) override;
+  void insert(const std::string& key, CachedResponseConstSharedPtr response) override;
+
+  /**
+   * @return the number of stored responses.
+   */
+  size_t size() const { return lru_.size(); }
+
+  /**
+   * @return the total size of the stored bodies.
+   */
+  uint64_t totalBodyBytes() const { return total_body_bytes_; }
+
+private:
+  using LruList = std::list<std::pair<std::string, CachedResponseConstSharedPtr>>;
+
+  void remove(LruList::iterator entry);
+
+  const uint32_t max_entries_;
+  const uint64_t max_total_body_bytes_;
+  TimeSource& time_source_;
+  uint64_t total_body_bytes_{};
+  // Most recently used first.
+  LruList lru_;
+  // Keyed by views of the keys held in lru_.
+  absl::flat_hash_map<absl::string_view, LruList::iterator> map_;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
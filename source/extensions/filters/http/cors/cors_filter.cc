@@ -74,16 +74,18 @@ Http::FilterHeadersStatus CorsFilter::decodeHeaders(Http::HeaderMap& headers, bo
         Http::Headers::get().CORSValues.True);
   }
 
+  // The following setReference() calls are safe because the policies belong to the route
+  // configuration, which the stream holds onto for as long as its headers.
   if (!allowMethods().empty()) {
-    response_headers->insertAccessControlAllowMethods().value(allowMethods());
+    response_headers->insertAccessControlAllowMethods().value().setReference(allowMethods());
   }
 
   if (!allowHeaders().empty()) {
-    response_headers->insertAccessControlAllowHeaders().value(allowHeaders());
+    response_headers->insertAccessControlAllowHeaders().value().setReference(allowHeaders());
   }
 
   if (!maxAge().empty()) {
-    response_headers->insertAccessControlMaxAge().value(maxAge());
+    response_headers->insertAccessControlMaxAge().value().setReference(maxAge());
   }
 
   decoder_callbacks_->encodeHeaders(std::move(response_headers), true);
@@ -104,7 +106,7 @@ Http::FilterHeadersStatus CorsFilter::encodeHeaders(Http::HeaderMap& headers, bo
   }
 
   if (!exposeHeaders().empty()) {
-    headers.insertAccessControlExposeHeaders().value(exposeHeaders());
+    headers.insertAccessControlExposeHeaders().value().setReference(exposeHeaders());
   }
 
   return Http::FilterHeadersStatus::Continue;
@@ -119,43 +121,28 @@ bool CorsFilter::isOriginAllowed(const Http::HeaderString& origin) {
 }
 
 bool CorsFilter::isOriginAllowedString(const Http::HeaderString& origin) {
-  if (allowOrigins() == nullptr) {
-    return false;
-  }
-  for (const auto& o : *allowOrigins()) {
-    if (o == "*" || origin == o.c_str()) {
-      return true;
-    }
-  }
-  return false;
+  const Router::CorsPolicy* policy = allowOriginsPolicy();
+  return policy != nullptr && policy->allowOriginsContain(origin.getStringView());
 }
 
 bool CorsFilter::isOriginAllowedRegex(const Http::HeaderString& origin) {
-  if (allowOriginRegexes() == nullptr) {
-    return false;
-  }
-  for (const auto& regex : *allowOriginRegexes()) {
-    const absl::string_view origin_view = origin.getStringView();
-    if (std::regex_match(origin_view.begin(), origin_view.end(), regex)) {
-      return true;
-    }
-  }
-  return false;
+  const Router::CorsPolicy* policy = allowOriginRegexesPolicy();
+  return policy != nullptr && policy->allowOriginRegexesMatch(origin.getStringView());
 }
 
-const std::list<std::string>* CorsFilter::allowOrigins() {
+const Router::CorsPolicy* CorsFilter::allowOriginsPolicy() {
   for (const auto policy : policies_) {
     if (policy && !policy->allowOrigins().empty()) {
-      return &policy->allowOrigins();
+      return policy;
     }
   }
   return nullptr;
 }
 
-const std::list<std::regex>* CorsFilter::allowOriginRegexes() {
+const Router::CorsPolicy* CorsFilter::allowOriginRegexesPolicy() {
   for (const auto policy : policies_) {
     if (policy && !policy->allowOriginRegexes().empty()) {
-      return &policy->allowOriginRegexes();
+      return policy;
     }
   }
   return nullptr;
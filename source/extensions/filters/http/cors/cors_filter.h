@@ -82,8 +82,9 @@ public:
 private:
   friend class CorsFilterTest;
 
-  const std::list<std::string>* allowOrigins();
-  const std::list<std::regex>* allowOriginRegexes();
+  // @return the first policy with allowed origins, or with allowed origin regexes.
+  const Router::CorsPolicy* allowOriginsPolicy();
+  const Router::CorsPolicy* allowOriginRegexesPolicy();
   const std::string& allowMethods();
   const std::string& allowHeaders();
   const std::string& exposeHeaders();
@@ -6,6 +6,7 @@
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 #include "common/http/utility.h"
+#include "common/router/per_filter_config_ids.h"
 
 #include "extensions/filters/http/well_known_names.h"
 
@@ -69,7 +70,9 @@ generatePolicy(const envoy::config::filter::http::csrf::v2::CsrfPolicy& policy,
 CsrfFilterConfig::CsrfFilterConfig(const envoy::config::filter::http::csrf::v2::CsrfPolicy& policy,
                                    const std::string& stats_prefix, Stats::Scope& scope,
                                    Runtime::Loader& runtime)
-    : stats_(generateStats(stats_prefix, scope)), policy_(generatePolicy(policy, runtime)) {}
+    : stats_(generateStats(stats_prefix, scope)), policy_(generatePolicy(policy, runtime)),
+      per_filter_config_id_(
+          Router::PerFilterConfigIds::id(Extensions::HttpFilters::HttpFilterNames::get().Csrf)) {}
 
 CsrfFilter::CsrfFilter(const CsrfFilterConfigSharedPtr config) : config_(config) {}
 
@@ -111,9 +114,8 @@ Http::FilterHeadersStatus CsrfFilter::decodeHeaders(Http::HeaderMap& headers, bo
 }
 
 void CsrfFilter::determinePolicy() {
-  const std::string& name = Extensions::HttpFilters::HttpFilterNames::get().Csrf;
-  const CsrfPolicy* policy =
-      Http::Utility::resolveMostSpecificPerFilterConfig<CsrfPolicy>(name, callbacks_->route());
+  const CsrfPolicy* policy = Http::Utility::resolveMostSpecificPerFilterConfig<CsrfPolicy>(
+      config_->perFilterConfigId(), callbacks_->route());
   if (policy != nullptr) {
     policy_ = policy;
   } else {
@@ -78,10 +78,12 @@ public:
 
   CsrfStats& stats() { return stats_; }
   const CsrfPolicy* policy() { return &policy_; }
+  uint32_t perFilterConfigId() const { return per_filter_config_id_; }
 
 private:
   CsrfStats stats_;
   const CsrfPolicy policy_;
+  const uint32_t per_filter_config_id_;
 };
 using CsrfFilterConfigSharedPtr = std::shared_ptr<CsrfFilterConfig>;
 
@@ -0,0 +1,103 @@
+#include "extensions/filters/http/ext_authz/decision_cache.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+
+const Filters::Common::ExtAuthz::Response* DecisionCache::find(absl::string_view key) {
+  const auto it = map_.find(key);
+  if (it == map_.end()) {
+    return nullptr;
+  }
+  const LruList::iterator entry = it->second;
+  if (entry->second.expiry_ <= time_source_.monotonicTime()) {
+    map_.erase(it);
+    lru_.erase(entry);
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, entry);
+  return &entry->second.response_;
+}
+
+bool DecisionCache::joinCheck(const std::string& key, Waiter& waiter) {
+  const auto it = checks_.find(key);
+  if (it == checks_.end()) {
+    checks_.emplace(key, std::list<Waiter*>());
+    return false;
+  }
+  it->second.push_back(&waiter);
+  return true;
+}
+
+void DecisionCache::leaveCheck(const std::string& key, Waiter& waiter) {
+  const auto it = checks_.find(key);
+  if (it != checks_.end()) {
+    it->second.remove(&waiter);
+  }
+}
+
+void DecisionCache::completeCheck(const std::string& key,
+                                  const Filters::Common::ExtAuthz::Response& response,
+                                  absl::optional<std::chrono::milliseconds> ttl) {
+  if (ttl.has_value()) {
+    insert(key, response, ttl.value());
+  }
+
+  // The waiters are taken one at a time, as applying the decision to one request may destroy
+  // others, which then leave the check.
+  while (true) {
+    const auto it = checks_.find(key);
+    ASSERT(it != checks_.end());
+    if (it->second.empty()) {
+      checks_.erase(it);
+      return;
+    }
+    Waiter* waiter = it->second.front();
+    it->second.pop_front();
+    waiter->onDecision(response);
+  }
+}
+
+void DecisionCache::cancelCheck(const std::string& key) {
+  const auto it = checks_.find(key);
+  if (it == checks_.end()) {
+    return;
+  }
+  if (it->second.empty()) {
+    checks_.erase(it);
+    return;
+  }
+  Waiter* waiter = it->second.front();
+  it->second.pop_front();
+  waiter->onCheckCancelled();
+}
+
+void DecisionCache::insert(const std::string& key,
+                           const Filters::Common::ExtAuthz::Response& response,
+                           std::chrono::milliseconds ttl) {
+  const MonotonicTime expiry = time_source_.monotonicTime() + ttl;
+  const auto it = map_.find(key);
+  if (it != map_.end()) {
+    it->second->second = Entry{response, expiry};
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return;
+  }
+
+  if (max_entries_ == 0) {
+    return;
+  }
+  if (lru_.size() >= max_entries_) {
+    map_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+  lru_.emplace_front(key, Entry{response, expiry});
+  map_.emplace(lru_.front().first, lru_.begin());
+}
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
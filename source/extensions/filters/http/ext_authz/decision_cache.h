@@ -0,0 +1,115 @@
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/common/pure.h"
+#include "envoy/common/time.h"
+
+#include "extensions/filters/common/ext_authz/ext_authz.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+
+/**
+ * A bounded LRU cache of the decisions of the authorization service, each valid until its TTL
+ * expires. It also tracks the checks in flight, so that requests with the same key wait for the
+ * decision of the first one rather than checking on their own. Like the filters using it, it is
+ * per thread and its operations are not protected.
+ */
+class DecisionCache {
+public:
+  /**
+   * A request waiting for the decision of an identical check in flight.
+   */
+  class Waiter {
+  public:
+    virtual ~Waiter() = default;
+
+    /**
+     * Called with the decision of the check.
+     */
+    virtual void onDecision(const Filters::Common::ExtAuthz::Response& response) PURE;
+
+    /**
+     * Called when the check was cancelled before completing. The waiter becomes the one checking
+     * the key, and must either complete or cancel it in turn.
+     */
+    virtual void onCheckCancelled() PURE;
+  };
+
+  /**
+   * @param max_entries supplies the maximum number of cached decisions, beyond which the least
+   *        recently used one is evicted.
+   * @param time_source supplies the time the TTLs of the decisions are measured with.
+   */
+  DecisionCache(uint32_t max_entries, TimeSource& time_source)
+      : max_entries_(max_entries), time_source_(time_source) {}
+
+  /**
+   * @return the decision cached for a key, or nullptr if there is none or it expired. The
+   *         decision is only valid until the cache is modified.
+   */
+  const Filters::Common::ExtAuthz::Response* find(absl::string_view key);
+
+  /**
+   * Join the check in flight for a key, if there is one.
+   * @return true if the waiter was added to the check in flight, in which case it is called back
+   *         once it completes. Otherwise the caller is recorded as checking the key, and must call
+   *         completeCheck() or cancelCheck() later.
+   */
+  bool joinCheck(const std::string& key, Waiter& waiter);
+
+  /**
+   * Stop waiting for the check of a key, e.g. as the request was destroyed.
+   */
+  void leaveCheck(const std::string& key, Waiter& waiter);
+
+  /**
+   * Complete the check of a key: cache its decision if it has a TTL, and pass it on to the waiters.
+   */
+  void completeCheck(const std::string& key, const Filters::Common::ExtAuthz::Response& response,
+                     absl::optional<std::chrono::milliseconds> ttl);
+
+  /**
+   * Cancel the check of a key. The first waiter, if any, is asked to check the key instead.
+   */
+  void cancelCheck(const std::string& key);
+
+  /**
+   * @return the number of cached decisions.
+   */
+  size_t size() const { return lru_.size(); }
+
+private:
+  struct Entry {
+    Filters::Common::ExtAuthz::Response response_;
+    MonotonicTime expiry_;
+  };
+  using LruList = std::list<std::pair<std::string, Entry>>;
+
+  void insert(const std::string& key, const Filters::Common::ExtAuthz::Response& response,
+              std::chrono::milliseconds ttl);
+
+  const uint32_t max_entries_;
+  TimeSource& time_source_;
+  // Most recently used first.
+  LruList lru_;
+  // Keyed by views of the keys held in lru_.
+  absl::flat_hash_map<absl::string_view, LruList::iterator> map_;
+  // The waiters of the checks in flight, by key.
+  absl::flat_hash_map<std::string, std::list<Waiter*>> checks_;
+};
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -1,12 +1,19 @@
 #include "extensions/filters/http/ext_authz/ext_authz.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "common/common/assert.h"
 #include "common/common/enum_to_int.h"
 #include "common/http/utility.h"
+#include "common/protobuf/utility.h"
 #include "common/router/config_impl.h"
 
 #include "extensions/filters/http/well_known_names.h"
 
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -20,6 +27,101 @@ struct RcDetailsValues {
 };
 using RcDetails = ConstSingleton<RcDetailsValues>;
 
+namespace {
+
+struct ThreadLocalDecisionCache : public ThreadLocal::ThreadLocalObject {
+  ThreadLocalDecisionCache(uint32_t max_entries, TimeSource& time_source)
+      : cache_(max_entries, time_source) {}
+
+  DecisionCache cache_;
+};
+
+} // namespace
+
+void FilterConfig::initializeDecisionCache(
+    const envoy::config::filter::http::ext_authz::v2::DecisionCache& config,
+    ThreadLocal::SlotAllocator& tls) {
+  for (const std::string& name : config.key_headers()) {
+    decision_cache_key_headers_.emplace_back(name);
+  }
+  if (!config.ttl_header().empty()) {
+    decision_ttl_header_.emplace(config.ttl_header());
+  }
+  if (config.has_default_ttl()) {
+    default_decision_ttl_ =
+        std::chrono::milliseconds(DurationUtil::durationToMilliseconds(config.default_ttl()));
+  }
+
+  tls_ = tls.allocateSlot();
+  const uint32_t max_entries = config.max_entries();
+  tls_->set(
+      [max_entries](Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+        return std::make_shared<ThreadLocalDecisionCache>(max_entries, dispatcher.timeSource());
+      });
+}
+
+DecisionCache* FilterConfig::decisionCache() const {
+  return tls_ != nullptr ? &tls_->getTyped<ThreadLocalDecisionCache>().cache_ : nullptr;
+}
+
+std::string
+FilterConfig::decisionCacheKey(const Http::HeaderMap& headers,
+                               const Protobuf::Map<std::string, std::string>& extensions) const {
+  // Values are prefixed with their length so that they can not run into each other, and missing
+  // headers are told apart from empty ones.
+  std::string key;
+  for (const Http::LowerCaseString& name : decision_cache_key_headers_) {
+    const Http::HeaderEntry* entry = headers.get(name);
+    if (entry == nullptr) {
+      key.push_back('-');
+      continue;
+    }
+    const absl::string_view value = entry->value().getStringView();
+    absl::StrAppend(&key, value.size(), ":", value);
+  }
+
+  // The extensions map is unordered.
+  std::vector<std::pair<absl::string_view, absl::string_view>> sorted_extensions(
+      extensions.begin(), extensions.end());
+  std::sort(sorted_extensions.begin(), sorted_extensions.end());
+  for (const auto& extension : sorted_extensions) {
+    absl::StrAppend(&key, extension.first.size(), ":", extension.first, extension.second.size(),
+                    ":", extension.second);
+  }
+  return key;
+}
+
+absl::optional<std::chrono::milliseconds>
+FilterConfig::takeDecisionTtl(Filters::Common::ExtAuthz::Response& response) const {
+  if (response.status == Filters::Common::ExtAuthz::CheckStatus::Error) {
+    return absl::nullopt;
+  }
+
+  absl::optional<std::chrono::milliseconds> ttl = default_decision_ttl_;
+  if (decision_ttl_header_.has_value()) {
+    auto& headers = response.headers_to_add;
+    const auto it = std::find_if(headers.begin(), headers.end(),
+                                 [this](const Http::HeaderVector::value_type& header) {
+                                   return header.first == decision_ttl_header_.value();
+                                 });
+    if (it != headers.end()) {
+      uint64_t seconds;
+      // A TTL that can not be parsed is taken as a request not to cache the decision.
+      if (absl::SimpleAtoi(it->second, &seconds)) {
+        ttl = std::chrono::seconds(seconds);
+      } else {
+        ttl = absl::nullopt;
+      }
+      headers.erase(it);
+    }
+  }
+
+  if (ttl.has_value() && ttl.value().count() == 0) {
+    return absl::nullopt;
+  }
+  return ttl;
+}
+
 void FilterConfigPerRoute::merge(const FilterConfigPerRoute& other) {
   disabled_ = other.disabled_;
   auto begin_it = other.context_extensions_.begin();
@@ -65,6 +167,41 @@ void Filter::initiateCall(const Http::HeaderMap& headers) {
   if (maybe_merged_per_route_config) {
     context_extensions = maybe_merged_per_route_config.value().takeContextExtensions();
   }
+
+  DecisionCache* decision_cache = config_->decisionCache();
+  if (decision_cache != nullptr) {
+    decision_cache_key_ = config_->decisionCacheKey(headers, context_extensions);
+    const Filters::Common::ExtAuthz::Response* cached = decision_cache->find(decision_cache_key_);
+    if (cached != nullptr) {
+      ENVOY_STREAM_LOG(trace, "ext_authz filter found a cached decision", *callbacks_);
+      config_->incCounter(cluster_->statsScope(), config_->ext_authz_decision_cache_hit_);
+      filter_return_ = FilterReturn::StopDecoding;
+      initiating_call_ = true;
+      onComplete(std::make_unique<Filters::Common::ExtAuthz::Response>(*cached));
+      initiating_call_ = false;
+      return;
+    }
+    config_->incCounter(cluster_->statsScope(), config_->ext_authz_decision_cache_miss_);
+
+    if (decision_cache->joinCheck(decision_cache_key_, *this)) {
+      ENVOY_STREAM_LOG(trace, "ext_authz filter waiting for the decision of an identical call",
+                       *callbacks_);
+      config_->incCounter(cluster_->statsScope(), config_->ext_authz_decision_cache_coalesced_);
+      context_extensions_ = std::move(context_extensions);
+      state_ = State::Waiting;
+      filter_return_ = FilterReturn::StopDecoding;
+      return;
+    }
+    checking_for_cache_ = true;
+  }
+
+  initiating_call_ = true;
+  callAuthorizationService(headers, std::move(context_extensions));
+  initiating_call_ = false;
+}
+
+void Filter::callAuthorizationService(
+    const Http::HeaderMap& headers, Protobuf::Map<std::string, std::string>&& context_extensions) {
   Filters::Common::ExtAuthz::CheckRequestUtils::createHttpCheck(
       callbacks_, headers, std::move(context_extensions), check_request_,
       config_->maxRequestBytes());
@@ -73,9 +210,7 @@ void Filter::initiateCall(const Http::HeaderMap& headers) {
   state_ = State::Calling;
   filter_return_ = FilterReturn::StopDecoding; // Don't let the filter chain continue as we are
                                                // going to invoke check call.
-  initiating_call_ = true;
   client_->check(*this, check_request_, callbacks_->activeSpan());
-  initiating_call_ = false;
 }
 
 Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool end_stream) {
@@ -136,12 +271,37 @@ void Filter::onDestroy() {
   if (state_ == State::Calling) {
     state_ = State::Complete;
     client_->cancel();
+    if (checking_for_cache_) {
+      checking_for_cache_ = false;
+      config_->decisionCache()->cancelCheck(decision_cache_key_);
+    }
+  } else if (state_ == State::Waiting) {
+    state_ = State::Complete;
+    config_->decisionCache()->leaveCheck(decision_cache_key_, *this);
   }
 }
 
+void Filter::onDecision(const Filters::Common::ExtAuthz::Response& response) {
+  ASSERT(state_ == State::Waiting);
+  onComplete(std::make_unique<Filters::Common::ExtAuthz::Response>(response));
+}
+
+void Filter::onCheckCancelled() {
+  ASSERT(state_ == State::Waiting);
+  ENVOY_STREAM_LOG(trace, "ext_authz filter calling in place of a cancelled identical call",
+                   *callbacks_);
+  checking_for_cache_ = true;
+  callAuthorizationService(*request_headers_, std::move(context_extensions_));
+}
+
 void Filter::onComplete(Filters::Common::ExtAuthz::ResponsePtr&& response) {
   ASSERT(cluster_);
   state_ = State::Complete;
+  if (checking_for_cache_) {
+    checking_for_cache_ = false;
+    const auto ttl = config_->takeDecisionTtl(*response);
+    config_->decisionCache()->completeCheck(decision_cache_key_, *response, ttl);
+  }
   using Filters::Common::ExtAuthz::CheckStatus;
   Stats::StatName empty_stat_name;
 
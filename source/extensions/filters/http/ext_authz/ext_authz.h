@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -10,6 +11,7 @@
 #include "envoy/local_info/local_info.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
+#include "envoy/thread_local/thread_local.h"
 #include "envoy/type/http_status.pb.h"
 #include "envoy/upstream/cluster_manager.h"
 
@@ -22,6 +24,7 @@
 #include "extensions/filters/common/ext_authz/ext_authz.h"
 #include "extensions/filters/common/ext_authz/ext_authz_grpc_impl.h"
 #include "extensions/filters/common/ext_authz/ext_authz_http_impl.h"
+#include "extensions/filters/http/ext_authz/decision_cache.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -40,7 +43,8 @@ class FilterConfig {
 public:
   FilterConfig(const envoy::config::filter::http::ext_authz::v2::ExtAuthz& config,
                const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
-               Runtime::Loader& runtime, Http::Context& http_context)
+               Runtime::Loader& runtime, Http::Context& http_context,
+               ThreadLocal::SlotAllocator& tls)
       : allow_partial_message_(config.with_request_body().allow_partial_message()),
         failure_mode_allow_(config.failure_mode_allow()),
         clear_route_cache_(config.clear_route_cache()),
@@ -49,7 +53,14 @@ public:
         scope_(scope), runtime_(runtime), http_context_(http_context), pool_(scope.symbolTable()),
         ext_authz_ok_(pool_.add("ext_authz.ok")), ext_authz_denied_(pool_.add("ext_authz.denied")),
         ext_authz_error_(pool_.add("ext_authz.error")),
-        ext_authz_failure_mode_allowed_(pool_.add("ext_authz.failure_mode_allowed")) {}
+        ext_authz_failure_mode_allowed_(pool_.add("ext_authz.failure_mode_allowed")),
+        ext_authz_decision_cache_hit_(pool_.add("ext_authz.decision_cache_hit")),
+        ext_authz_decision_cache_miss_(pool_.add("ext_authz.decision_cache_miss")),
+        ext_authz_decision_cache_coalesced_(pool_.add("ext_authz.decision_cache_coalesced")) {
+    if (config.has_decision_cache()) {
+      initializeDecisionCache(config.decision_cache(), tls);
+    }
+  }
 
   bool allowPartialMessage() const { return allow_partial_message_; }
 
@@ -75,7 +86,30 @@ public:
     scope.counterFromStatName(name).inc();
   }
 
+  /**
+   * @return the decision cache of the current worker, or nullptr if decisions are not cached.
+   */
+  DecisionCache* decisionCache() const;
+
+  /**
+   * @return the key of the cached decision of a request, made of the values of the configured
+   *         headers and of the context extensions of its route.
+   */
+  std::string decisionCacheKey(const Http::HeaderMap& headers,
+                               const Protobuf::Map<std::string, std::string>& extensions) const;
+
+  /**
+   * Remove the TTL header from a response of the authorization service.
+   * @return how long its decision may be cached for, if at all.
+   */
+  absl::optional<std::chrono::milliseconds>
+  takeDecisionTtl(Filters::Common::ExtAuthz::Response& response) const;
+
 private:
+  void initializeDecisionCache(
+      const envoy::config::filter::http::ext_authz::v2::DecisionCache& config,
+      ThreadLocal::SlotAllocator& tls);
+
   static Http::Code toErrorCode(uint64_t status) {
     const auto code = static_cast<Http::Code>(status);
     if (code >= Http::Code::Continue && code <= Http::Code::NetworkAuthenticationRequired) {
@@ -94,12 +128,19 @@ private:
   Runtime::Loader& runtime_;
   Http::Context& http_context_;
   Stats::StatNamePool pool_;
+  ThreadLocal::SlotPtr tls_;
+  std::vector<Http::LowerCaseString> decision_cache_key_headers_;
+  absl::optional<Http::LowerCaseString> decision_ttl_header_;
+  absl::optional<std::chrono::milliseconds> default_decision_ttl_;
 
 public:
   const Stats::StatName ext_authz_ok_;
   const Stats::StatName ext_authz_denied_;
   const Stats::StatName ext_authz_error_;
   const Stats::StatName ext_authz_failure_mode_allowed_;
+  const Stats::StatName ext_authz_decision_cache_hit_;
+  const Stats::StatName ext_authz_decision_cache_miss_;
+  const Stats::StatName ext_authz_decision_cache_coalesced_;
 };
 
 using FilterConfigSharedPtr = std::shared_ptr<FilterConfig>;
@@ -142,7 +183,8 @@ private:
  */
 class Filter : public Logger::Loggable<Logger::Id::filter>,
                public Http::StreamDecoderFilter,
-               public Filters::Common::ExtAuthz::RequestCallbacks {
+               public Filters::Common::ExtAuthz::RequestCallbacks,
+               public DecisionCache::Waiter {
 public:
   Filter(FilterConfigSharedPtr config, Filters::Common::ExtAuthz::ClientPtr&& client)
       : config_(config), client_(std::move(client)) {}
@@ -159,16 +201,22 @@ public:
   // ExtAuthz::RequestCallbacks
   void onComplete(Filters::Common::ExtAuthz::ResponsePtr&&) override;
 
+  // DecisionCache::Waiter
+  void onDecision(const Filters::Common::ExtAuthz::Response& response) override;
+  void onCheckCancelled() override;
+
 private:
   void addResponseHeaders(Http::HeaderMap& header_map, const Http::HeaderVector& headers);
   void initiateCall(const Http::HeaderMap& headers);
+  void callAuthorizationService(const Http::HeaderMap& headers,
+                                Protobuf::Map<std::string, std::string>&& context_extensions);
   void continueDecoding();
   bool isBufferFull();
 
   // State of this filter's communication with the external authorization service.
   // The filter has either not started calling the external service, in the middle of calling
-  // it or has completed.
-  enum class State { NotStarted, Calling, Complete };
+  // it, waiting for the decision of an identical call of another request or has completed.
+  enum class State { NotStarted, Calling, Waiting, Complete };
 
   // FilterReturn is used to capture what the return code should be to the filter chain.
   // if this filter is either in the middle of calling the service or the result is denied then
@@ -188,6 +236,12 @@ private:
   bool initiating_call_{};
   bool buffer_data_{};
   envoy::service::auth::v2::CheckRequest check_request_{};
+  // The key of the request in the decision cache, if decisions are cached.
+  std::string decision_cache_key_;
+  // Whether the decision of this request's call is awaited by the decision cache.
+  bool checking_for_cache_{};
+  // Kept while waiting for another request's call, in case this request has to call in turn.
+  Protobuf::Map<std::string, std::string> context_extensions_;
 };
 
 } // namespace ExtAuthz
@@ -18,6 +18,7 @@
 #include "common/http/headers.h"
 #include "common/http/utility.h"
 #include "common/protobuf/utility.h"
+#include "common/router/per_filter_config_ids.h"
 
 #include "extensions/filters/http/well_known_names.h"
 
@@ -75,13 +76,18 @@ FaultSettings::FaultSettings(const envoy::config::filter::http::fault::v2::HTTPF
     response_rate_limit_ =
         std::make_unique<Filters::Common::Fault::FaultRateLimitConfig>(fault.response_rate_limit());
   }
+
+  faults_configured_ = fault.has_abort() || request_delay_config_ != nullptr ||
+                       response_rate_limit_ != nullptr;
 }
 
 FaultFilterConfig::FaultFilterConfig(const envoy::config::filter::http::fault::v2::HTTPFault& fault,
                                      Runtime::Loader& runtime, const std::string& stats_prefix,
                                      Stats::Scope& scope, TimeSource& time_source)
     : settings_(fault), runtime_(runtime), stats_(generateStats(stats_prefix, scope)),
-      stats_prefix_(stats_prefix), scope_(scope), time_source_(time_source) {}
+      stats_prefix_(stats_prefix), scope_(scope), time_source_(time_source),
+      per_filter_config_id_(
+          Router::PerFilterConfigIds::id(Extensions::HttpFilters::HttpFilterNames::get().Fault)) {}
 
 FaultFilter::FaultFilter(FaultFilterConfigSharedPtr config) : config_(config) {}
 
@@ -101,15 +107,18 @@ Http::FilterHeadersStatus FaultFilter::decodeHeaders(Http::HeaderMap& headers, b
   // configured at the filter level.
   fault_settings_ = config_->settings();
   if (decoder_callbacks_->route() && decoder_callbacks_->route()->routeEntry()) {
-    const std::string& name = Extensions::HttpFilters::HttpFilterNames::get().Fault;
-    const auto* route_entry = decoder_callbacks_->route()->routeEntry();
-
-    const FaultSettings* tmp = route_entry->perFilterConfigTyped<FaultSettings>(name);
     const FaultSettings* per_route_settings =
-        tmp ? tmp : route_entry->virtualHost().perFilterConfigTyped<FaultSettings>(name);
+        decoder_callbacks_->route()->mostSpecificPerFilterConfigTyped<FaultSettings>(
+            config_->perFilterConfigId());
     fault_settings_ = per_route_settings ? per_route_settings : fault_settings_;
   }
 
+  // Most requests go through filters which do not inject any fault, so these skip the runtime
+  // lookups and the active faults gauge unless the abort runtime keys are set.
+  if (!fault_settings_->faultsConfigured() && !runtimeAbortPossible(headers)) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
   if (faultOverflow()) {
     return Http::FilterHeadersStatus::Continue;
   }
@@ -167,8 +176,12 @@ void FaultFilter::maybeSetupResponseRateLimit(const Http::HeaderMap& request_hea
     return;
   }
 
-  absl::optional<uint64_t> rate_kbps = fault_settings_->responseRateLimit()->rateKbps(
-      request_headers.get(Filters::Common::Fault::HeaderNames::get().ThroughputResponse));
+  const Filters::Common::Fault::FaultRateLimitConfig& rate_limit =
+      *fault_settings_->responseRateLimit();
+  absl::optional<uint64_t> rate_kbps = rate_limit.rateKbps(
+      rate_limit.fromHeader()
+          ? request_headers.get(Filters::Common::Fault::HeaderNames::get().ThroughputResponse)
+          : nullptr);
   if (!rate_kbps.has_value()) {
     return;
   }
@@ -195,11 +208,22 @@ void FaultFilter::maybeSetupResponseRateLimit(const Http::HeaderMap& request_hea
       decoder_callbacks_->dispatcher());
 }
 
+bool FaultFilter::runtimeAbortPossible(const Http::HeaderMap& headers) {
+  // The keys of the downstream cluster are built per request, so a request from a downstream
+  // cluster is assumed to possibly abort rather than formatting the key here.
+  return headers.EnvoyDownstreamServiceCluster() != nullptr ||
+         !config_->runtime().snapshot().get(fault_settings_->abortPercentRuntime().name()).empty();
+}
+
 bool FaultFilter::faultOverflow() {
   const uint64_t max_faults = config_->runtime().snapshot().getInteger(
       fault_settings_->maxActiveFaultsRuntime(), fault_settings_->maxActiveFaults().has_value()
                                                      ? fault_settings_->maxActiveFaults().value()
                                                      : std::numeric_limits<uint64_t>::max());
+  if (max_faults == std::numeric_limits<uint64_t>::max()) {
+    // Without a limit, the gauge shared by the workers is not read.
+    return false;
+  }
   // Note: Since we don't compare/swap here this is a fuzzy limit which is similar to how the
   // other circuit breakers work.
   if (config_->stats().active_faults_.value() >= max_faults) {
@@ -244,8 +268,11 @@ FaultFilter::delayDuration(const Http::HeaderMap& request_headers) {
 
   // See if the configured delay provider has a default delay, if not there is no delay (e.g.,
   // header configuration and no/invalid header).
-  auto config_duration = fault_settings_->requestDelay()->duration(
-      request_headers.get(Filters::Common::Fault::HeaderNames::get().DelayRequest));
+  const Filters::Common::Fault::FaultDelayConfig& delay = *fault_settings_->requestDelay();
+  auto config_duration = delay.duration(
+      delay.fromHeader()
+          ? request_headers.get(Filters::Common::Fault::HeaderNames::get().DelayRequest)
+          : nullptr);
   if (!config_duration.has_value()) {
     return ret;
   }
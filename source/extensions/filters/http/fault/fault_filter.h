@@ -16,6 +16,7 @@
 #include "common/buffer/watermark_buffer.h"
 #include "common/common/token_bucket_impl.h"
 #include "common/http/header_utility.h"
+#include "common/runtime/runtime_keys.h"
 
 #include "extensions/filters/common/fault/fault_config.h"
 
@@ -62,15 +63,21 @@ public:
   const Filters::Common::Fault::FaultRateLimitConfig* responseRateLimit() const {
     return response_rate_limit_.get();
   }
-  const std::string& abortPercentRuntime() const { return abort_percent_runtime_; }
-  const std::string& delayPercentRuntime() const { return delay_percent_runtime_; }
-  const std::string& abortHttpStatusRuntime() const { return abort_http_status_runtime_; }
-  const std::string& delayDurationRuntime() const { return delay_duration_runtime_; }
-  const std::string& maxActiveFaultsRuntime() const { return max_active_faults_runtime_; }
-  const std::string& responseRateLimitPercentRuntime() const {
+  const Runtime::Key& abortPercentRuntime() const { return abort_percent_runtime_; }
+  const Runtime::Key& delayPercentRuntime() const { return delay_percent_runtime_; }
+  const Runtime::Key& abortHttpStatusRuntime() const { return abort_http_status_runtime_; }
+  const Runtime::Key& delayDurationRuntime() const { return delay_duration_runtime_; }
+  const Runtime::Key& maxActiveFaultsRuntime() const { return max_active_faults_runtime_; }
+  const Runtime::Key& responseRateLimitPercentRuntime() const {
     return response_rate_limit_percent_runtime_;
   }
 
+  /**
+   * @return whether an abort, a delay or a response rate limit is configured. Otherwise, only the
+   *         abort runtime keys, which apply regardless of the configuration, can inject a fault.
+   */
+  bool faultsConfigured() const { return faults_configured_; }
+
 private:
   class RuntimeKeyValues {
   public:
@@ -92,12 +99,13 @@ private:
   absl::flat_hash_set<std::string> downstream_nodes_{}; // Inject failures for specific downstream
   absl::optional<uint64_t> max_active_faults_;
   Filters::Common::Fault::FaultRateLimitConfigPtr response_rate_limit_;
-  const std::string delay_percent_runtime_;
-  const std::string abort_percent_runtime_;
-  const std::string delay_duration_runtime_;
-  const std::string abort_http_status_runtime_;
-  const std::string max_active_faults_runtime_;
-  const std::string response_rate_limit_percent_runtime_;
+  const Runtime::Key delay_percent_runtime_;
+  const Runtime::Key abort_percent_runtime_;
+  const Runtime::Key delay_duration_runtime_;
+  const Runtime::Key abort_http_status_runtime_;
+  const Runtime::Key max_active_faults_runtime_;
+  const Runtime::Key response_rate_limit_percent_runtime_;
+  bool faults_configured_{};
 };
 
 /**
@@ -115,6 +123,7 @@ public:
   Stats::Scope& scope() { return scope_; }
   const FaultSettings* settings() { return &settings_; }
   TimeSource& timeSource() { return time_source_; }
+  uint32_t perFilterConfigId() const { return per_filter_config_id_; }
 
 private:
   static FaultFilterStats generateStats(const std::string& prefix, Stats::Scope& scope);
@@ -125,6 +134,7 @@ private:
   const std::string stats_prefix_;
   Stats::Scope& scope_;
   TimeSource& time_source_;
+  const uint32_t per_filter_config_id_;
 };
 
 using FaultFilterConfigSharedPtr = std::shared_ptr<FaultFilterConfig>;
@@ -225,6 +235,7 @@ public:
 
 private:
   bool faultOverflow();
+  bool runtimeAbortPossible(const Http::HeaderMap& headers);
   void recordAbortsInjectedStats();
   void recordDelaysInjectedStats();
   void resetTimerState();
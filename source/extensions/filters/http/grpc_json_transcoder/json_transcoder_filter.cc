@@ -311,6 +311,7 @@ Http::FilterDataStatus JsonTranscoderFilter::decodeData(Buffer::Instance& data,
   }
 
   readToBuffer(*transcoder_->RequestOutput(), data);
+  request_in_.drainConsumed();
 
   const auto& request_status = transcoder_->RequestStatus();
 
@@ -341,6 +342,7 @@ Http::FilterTrailersStatus JsonTranscoderFilter::decodeTrailers(Http::HeaderMap&
 
   Buffer::OwnedImpl data;
   readToBuffer(*transcoder_->RequestOutput(), data);
+  request_in_.drainConsumed();
 
   if (data.length()) {
     decoder_callbacks_->addDecodedData(data, true);
@@ -398,6 +400,9 @@ Http::FilterDataStatus JsonTranscoderFilter::encodeData(Buffer::Instance& data,
   }
 
   readToBuffer(*transcoder_->ResponseOutput(), data);
+  // Release the gRPC frames transcoded so far, so that the buffered JSON of a unary response is
+  // not held alongside them until the end of the stream.
+  response_in_.drainConsumed();
 
   if (!method_->server_streaming() && !end_stream) {
     // Buffer until the response is complete.
@@ -417,6 +422,7 @@ Http::FilterTrailersStatus JsonTranscoderFilter::encodeTrailers(Http::HeaderMap&
 
   Buffer::OwnedImpl data;
   readToBuffer(*transcoder_->ResponseOutput(), data);
+  response_in_.drainConsumed();
 
   if (data.length()) {
     encoder_callbacks_->addEncodedData(data, true);
@@ -9,6 +9,11 @@ int64_t TranscoderInputStreamImpl::BytesAvailable() const { return buffer_->leng
 
 bool TranscoderInputStreamImpl::Finished() const { return finished_; }
 
+void TranscoderInputStreamImpl::drainConsumed() {
+  buffer_->drain(position_);
+  position_ = 0;
+}
+
 } // namespace GrpcJsonTranscoder
 } // namespace HttpFilters
 } // namespace Extensions
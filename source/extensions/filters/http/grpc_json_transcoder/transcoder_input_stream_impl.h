@@ -15,6 +15,13 @@ public:
   // TranscoderInputStream
   int64_t BytesAvailable() const override;
   bool Finished() const override;
+
+  /**
+   * Drain the bytes already read by the transcoder, which are otherwise only released by the next
+   * call to Next(). This keeps a message from being held both as input and as transcoded output
+   * once the transcoder is done with it. Must not be called between Next() and BackUp().
+   */
+  void drainConsumed();
 };
 
 } // namespace GrpcJsonTranscoder
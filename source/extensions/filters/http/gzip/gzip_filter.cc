@@ -3,6 +3,7 @@
 #include "envoy/stats/scope.h"
 
 #include "common/common/macros.h"
+#include "common/protobuf/utility.h"
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
@@ -26,6 +27,9 @@ const uint64_t MinimumContentLength = 30;
 // When summed to window bits, this sets a gzip header and trailer around the compressed data.
 const uint64_t GzipHeaderValue = 16;
 
+// Default number of compressors kept for reuse by each worker.
+const uint32_t DefaultCompressorPoolSize = 16;
+
 // Used for verifying accept-encoding values.
 const char ZeroQvalueString[] = "q=0";
 
@@ -37,11 +41,19 @@ const std::vector<std::string>& defaultContentEncoding() {
                           "application/xhtml+xml"});
 }
 
+struct ThreadLocalCompressorPool : public ThreadLocal::ThreadLocalObject {
+  ThreadLocalCompressorPool(const GzipFilterConfig& config, uint32_t max_size)
+      : pool_(config.compressionLevel(), config.compressionStrategy(), config.windowBits(),
+              config.memoryLevel(), max_size) {}
+
+  Compressor::ZlibCompressorPool pool_;
+};
+
 } // namespace
 
 GzipFilterConfig::GzipFilterConfig(const envoy::config::filter::http::gzip::v2::Gzip& gzip,
                                    const std::string& stats_prefix, Stats::Scope& scope,
-                                   Runtime::Loader& runtime)
+                                   Runtime::Loader& runtime, ThreadLocal::SlotAllocator& tls)
     : compression_level_(compressionLevelEnum(gzip.compression_level())),
       compression_strategy_(compressionStrategyEnum(gzip.compression_strategy())),
       content_length_(contentLengthUint(gzip.content_length().value())),
@@ -50,7 +62,31 @@ GzipFilterConfig::GzipFilterConfig(const envoy::config::filter::http::gzip::v2::
       content_type_values_(contentTypeSet(gzip.content_type())),
       disable_on_etag_header_(gzip.disable_on_etag_header()),
       remove_accept_encoding_header_(gzip.remove_accept_encoding_header()),
-      stats_(generateStats(stats_prefix + "gzip.", scope)), runtime_(runtime) {}
+      stats_(generateStats(stats_prefix + "gzip.", scope)), runtime_(runtime) {
+  const uint32_t pool_size =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(gzip, compressor_pool_size, DefaultCompressorPoolSize);
+  if (pool_size > 0) {
+    tls_ = tls.allocateSlot();
+    tls_->set([this, pool_size](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+      return std::make_shared<ThreadLocalCompressorPool>(*this, pool_size);
+    });
+  }
+}
+
+Compressor::ZlibCompressorImplPtr GzipFilterConfig::acquireCompressor() {
+  if (tls_ != nullptr) {
+    return tls_->getTyped<ThreadLocalCompressorPool>().pool_.acquire();
+  }
+  auto compressor = std::make_unique<Compressor::ZlibCompressorImpl>();
+  compressor->init(compressionLevel(), compressionStrategy(), windowBits(), memoryLevel());
+  return compressor;
+}
+
+void GzipFilterConfig::releaseCompressor(Compressor::ZlibCompressorImplPtr&& compressor) {
+  if (tls_ != nullptr) {
+    tls_->getTyped<ThreadLocalCompressorPool>().pool_.release(std::move(compressor));
+  }
+}
 
 Compressor::ZlibCompressorImpl::CompressionLevel GzipFilterConfig::compressionLevelEnum(
     envoy::config::filter::http::gzip::v2::Gzip_CompressionLevel_Enum compression_level) {
@@ -105,6 +141,12 @@ uint64_t GzipFilterConfig::windowBitsUint(Protobuf::uint32 window_bits) {
 GzipFilter::GzipFilter(const GzipFilterConfigSharedPtr& config)
     : skip_compression_{true}, config_(config) {}
 
+void GzipFilter::onDestroy() {
+  if (compressor_ != nullptr) {
+    config_->releaseCompressor(std::move(compressor_));
+  }
+}
+
 Http::FilterHeadersStatus GzipFilter::decodeHeaders(Http::HeaderMap& headers, bool) {
   if (config_->runtime().snapshot().featureEnabled("gzip.filter_enabled", 100) &&
       isAcceptEncodingAllowed(headers)) {
@@ -127,8 +169,7 @@ Http::FilterHeadersStatus GzipFilter::encodeHeaders(Http::HeaderMap& headers, bo
     insertVaryHeader(headers);
     headers.removeContentLength();
     headers.insertContentEncoding().value(Http::Headers::get().ContentEncodingValues.Gzip);
-    compressor_.init(config_->compressionLevel(), config_->compressionStrategy(),
-                     config_->windowBits(), config_->memoryLevel());
+    compressor_ = config_->acquireCompressor();
     config_->stats().compressed_.inc();
   } else if (!skip_compression_) {
     skip_compression_ = true;
@@ -140,7 +181,7 @@ Http::FilterHeadersStatus GzipFilter::encodeHeaders(Http::HeaderMap& headers, bo
 Http::FilterDataStatus GzipFilter::encodeData(Buffer::Instance& data, bool end_stream) {
   if (!skip_compression_) {
     config_->stats().total_uncompressed_bytes_.add(data.length());
-    compressor_.compress(data, end_stream ? Compressor::State::Finish : Compressor::State::Flush);
+    compressor_->compress(data, end_stream ? Compressor::State::Finish : Compressor::State::Flush);
     config_->stats().total_compressed_bytes_.add(data.length());
   }
   return Http::FilterDataStatus::Continue;
@@ -149,7 +190,7 @@ Http::FilterDataStatus GzipFilter::encodeData(Buffer::Instance& data, bool end_s
 Http::FilterTrailersStatus GzipFilter::encodeTrailers(Http::HeaderMap&) {
   if (!skip_compression_) {
     Buffer::OwnedImpl empty_buffer;
-    compressor_.compress(empty_buffer, Compressor::State::Finish);
+    compressor_->compress(empty_buffer, Compressor::State::Finish);
     config_->stats().total_compressed_bytes_.add(empty_buffer.length());
     encoder_callbacks_->addEncodedData(empty_buffer, true);
   }
@@ -7,9 +7,11 @@
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/buffer/buffer_impl.h"
 #include "common/compressor/zlib_compressor_impl.h"
+#include "common/compressor/zlib_compressor_pool.h"
 #include "common/http/header_map_impl.h"
 #include "common/protobuf/protobuf.h"
 
@@ -58,7 +60,8 @@ class GzipFilterConfig {
 public:
   GzipFilterConfig(const envoy::config::filter::http::gzip::v2::Gzip& gzip,
                    const std::string& stats_prefix,
-                   Stats::Scope& scope, Runtime::Loader& runtime);
+                   Stats::Scope& scope, Runtime::Loader& runtime,
+                   ThreadLocal::SlotAllocator& tls);
 
   Compressor::ZlibCompressorImpl::CompressionLevel compressionLevel() const {
     return compression_level_;
@@ -76,6 +79,16 @@ public:
   uint64_t minimumLength() const { return content_length_; }
   uint64_t windowBits() const { return window_bits_; }
 
+  /**
+   * @return an initialized compressor, reused from the pool of the current worker if possible.
+   */
+  Compressor::ZlibCompressorImplPtr acquireCompressor();
+
+  /**
+   * Returns a compressor once its response is complete, for reuse.
+   */
+  void releaseCompressor(Compressor::ZlibCompressorImplPtr&& compressor);
+
 private:
   static Compressor::ZlibCompressorImpl::CompressionLevel compressionLevelEnum(
       envoy::config::filter::http::gzip::v2::Gzip_CompressionLevel_Enum compression_level);
@@ -104,6 +117,7 @@ private:
   bool remove_accept_encoding_header_;
   GzipStats stats_;
   Runtime::Loader& runtime_;
+  ThreadLocal::SlotPtr tls_;
 };
 using GzipFilterConfigSharedPtr = std::shared_ptr<GzipFilterConfig>;
 
@@ -115,7 +129,7 @@ public:
   GzipFilter(const GzipFilterConfigSharedPtr& config);
 
   // Http::StreamFilterBase
-  void onDestroy() override{};
+  void onDestroy() override;
 
   // Http::StreamDecoderFilter
   Http::FilterHeadersStatus decodeHeaders(Http::HeaderMap& headers, bool end_stream) override;
@@ -160,7 +174,7 @@ private:
 
   bool skip_compression_;
   Buffer::OwnedImpl compressed_data_;
-  Compressor::ZlibCompressorImpl compressor_;
+  Compressor::ZlibCompressorImplPtr compressor_;
   GzipFilterConfigSharedPtr config_;
 
   Http::StreamDecoderFilterCallbacks* decoder_callbacks_{nullptr};
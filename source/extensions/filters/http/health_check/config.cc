@@ -47,11 +47,21 @@ Http::FilterFactoryCb HealthCheckFilterConfig::createFilterFactoryFromProtoTyped
     cluster_min_healthy_percentages = std::move(cluster_to_percentage);
   }
 
+  ClusterHealthCacheSharedPtr cluster_health_cache;
+  const int64_t cluster_health_cache_time_ms =
+      PROTOBUF_GET_MS_OR_DEFAULT(proto_config, cluster_health_cache_time, 0);
+  if (cluster_min_healthy_percentages != nullptr && cluster_health_cache_time_ms > 0) {
+    cluster_health_cache = std::make_shared<ClusterHealthCache>(
+        context.dispatcher(), context.clusterManager(), cluster_min_healthy_percentages,
+        std::chrono::milliseconds(cluster_health_cache_time_ms));
+  }
+
   return [&context, pass_through_mode, cache_manager, header_match_data,
-          cluster_min_healthy_percentages](Http::FilterChainFactoryCallbacks& callbacks) -> void {
-    callbacks.addStreamFilter(std::make_shared<HealthCheckFilter>(context, pass_through_mode,
-                                                                  cache_manager, header_match_data,
-                                                                  cluster_min_healthy_percentages));
+          cluster_min_healthy_percentages,
+          cluster_health_cache](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addStreamFilter(std::make_shared<HealthCheckFilter>(
+        context, pass_through_mode, cache_manager, header_match_data,
+        cluster_min_healthy_percentages, cluster_health_cache));
   };
 }
 
@@ -50,6 +50,55 @@ void HealthCheckCacheManager::onTimer() {
   clear_cache_timer_->enableTimer(timeout_);
 }
 
+ClusterHealth
+evaluateClusterHealth(Upstream::ClusterManager& cluster_manager,
+                      const ClusterMinHealthyPercentages& cluster_min_healthy_percentages) {
+  for (const auto& item : cluster_min_healthy_percentages) {
+    const std::string& cluster_name = item.first;
+    const double min_healthy_percentage = item.second;
+    auto* cluster = cluster_manager.get(cluster_name);
+    if (cluster == nullptr) {
+      // If the cluster does not exist at all, consider the service unhealthy.
+      return ClusterHealth::NoCluster;
+    }
+    const auto& stats = cluster->info()->stats();
+    const uint64_t membership_total = stats.membership_total_.value();
+    if (membership_total == 0) {
+      // If the cluster exists but is empty, consider the service unhealthy unless
+      // the specified minimum percent healthy for the cluster happens to be zero.
+      if (min_healthy_percentage == 0.0) {
+        continue;
+      }
+      return ClusterHealth::Empty;
+    }
+    // In the general case, consider the service unhealthy if fewer than the
+    // specified percentage of the servers in the cluster are available (healthy + degraded).
+    // TODO(brian-pane) switch to purely integer-based math here, because the
+    //                  int-to-float conversions and floating point division are slow.
+    if ((stats.membership_healthy_.value() + stats.membership_degraded_.value()) <
+        membership_total * min_healthy_percentage / 100.0) {
+      return ClusterHealth::Unhealthy;
+    }
+  }
+  return ClusterHealth::Healthy;
+}
+
+ClusterHealthCache::ClusterHealthCache(
+    Event::Dispatcher& dispatcher, Upstream::ClusterManager& cluster_manager,
+    ClusterMinHealthyPercentagesConstSharedPtr cluster_min_healthy_percentages,
+    std::chrono::milliseconds interval)
+    : cluster_manager_(cluster_manager),
+      cluster_min_healthy_percentages_(std::move(cluster_min_healthy_percentages)),
+      evaluate_timer_(dispatcher.createTimer([this]() -> void { onTimer(); })),
+      interval_(interval) {
+  onTimer();
+}
+
+void ClusterHealthCache::onTimer() {
+  cluster_health_ = evaluateClusterHealth(cluster_manager_, *cluster_min_healthy_percentages_);
+  evaluate_timer_->enableTimer(interval_);
+}
+
 Http::FilterHeadersStatus HealthCheckFilter::decodeHeaders(Http::HeaderMap& headers,
                                                            bool end_stream) {
   if (Http::HeaderUtility::matchHeaders(headers, *header_match_data_)) {
@@ -130,42 +179,26 @@ void HealthCheckFilter::onComplete() {
     } else if (cluster_min_healthy_percentages_ != nullptr &&
                !cluster_min_healthy_percentages_->empty()) {
       // Check the status of the specified upstream cluster(s) to determine the right response.
-      auto& clusterManager = context_.clusterManager();
-      for (const auto& item : *cluster_min_healthy_percentages_) {
+      const ClusterHealth cluster_health =
+          cluster_health_cache_ != nullptr
+              ? cluster_health_cache_->clusterHealth()
+              : evaluateClusterHealth(context_.clusterManager(), *cluster_min_healthy_percentages_);
+      switch (cluster_health) {
+      case ClusterHealth::Healthy:
         details = &RcDetails::get().HealthCheckClusterHealthy;
-        const std::string& cluster_name = item.first;
-        const double min_healthy_percentage = item.second;
-        auto* cluster = clusterManager.get(cluster_name);
-        if (cluster == nullptr) {
-          // If the cluster does not exist at all, consider the service unhealthy.
-          final_status = Http::Code::ServiceUnavailable;
-          details = &RcDetails::get().HealthCheckNoCluster;
-
-          break;
-        }
-        const auto& stats = cluster->info()->stats();
-        const uint64_t membership_total = stats.membership_total_.value();
-        if (membership_total == 0) {
-          // If the cluster exists but is empty, consider the service unhealthy unless
-          // the specified minimum percent healthy for the cluster happens to be zero.
-          if (min_healthy_percentage == 0.0) {
-            continue;
-          } else {
-            final_status = Http::Code::ServiceUnavailable;
-            details = &RcDetails::get().HealthCheckClusterEmpty;
-            break;
-          }
-        }
-        // In the general case, consider the service unhealthy if fewer than the
-        // specified percentage of the servers in the cluster are available (healthy + degraded).
-        // TODO(brian-pane) switch to purely integer-based math here, because the
-        //                  int-to-float conversions and floating point division are slow.
-        if ((stats.membership_healthy_.value() + stats.membership_degraded_.value()) <
-            membership_total * min_healthy_percentage / 100.0) {
-          final_status = Http::Code::ServiceUnavailable;
-          details = &RcDetails::get().HealthCheckClusterUnhealthy;
-          break;
-        }
+        break;
+      case ClusterHealth::NoCluster:
+        final_status = Http::Code::ServiceUnavailable;
+        details = &RcDetails::get().HealthCheckNoCluster;
+        break;
+      case ClusterHealth::Empty:
+        final_status = Http::Code::ServiceUnavailable;
+        details = &RcDetails::get().HealthCheckClusterEmpty;
+        break;
+      case ClusterHealth::Unhealthy:
+        final_status = Http::Code::ServiceUnavailable;
+        details = &RcDetails::get().HealthCheckClusterUnhealthy;
+        break;
       }
     }
 
@@ -8,6 +8,7 @@
 #include "envoy/http/codes.h"
 #include "envoy/http/filter.h"
 #include "envoy/server/filter_config.h"
+#include "envoy/upstream/cluster_manager.h"
 
 #include "common/http/header_utility.h"
 
@@ -53,6 +54,57 @@ using ClusterMinHealthyPercentages = std::map<std::string, double>;
 using ClusterMinHealthyPercentagesConstSharedPtr =
     std::shared_ptr<const ClusterMinHealthyPercentages>;
 
+/**
+ * The health of the upstream clusters of cluster_min_healthy_percentages.
+ */
+enum class ClusterHealth : uint8_t {
+  // Every cluster has at least its minimum percentage of healthy or degraded hosts.
+  Healthy,
+  // A cluster does not exist.
+  NoCluster,
+  // A cluster has no host while its minimum percentage is not zero.
+  Empty,
+  // A cluster has fewer than its minimum percentage of healthy or degraded hosts.
+  Unhealthy,
+};
+
+/**
+ * Evaluate the health of the upstream clusters.
+ * @param cluster_manager supplies the cluster manager to look the clusters up in.
+ * @param cluster_min_healthy_percentages supplies the minimum percentage of healthy or degraded
+ *        hosts of each cluster.
+ * @return ClusterHealth the health of the first cluster which is not healthy, or Healthy.
+ */
+ClusterHealth
+evaluateClusterHealth(Upstream::ClusterManager& cluster_manager,
+                      const ClusterMinHealthyPercentages& cluster_min_healthy_percentages);
+
+/**
+ * Shared cache of the health of the upstream clusters, used by all instances of a health check
+ * filter configuration as well as all threads. This sets up a timer that evaluates the health of
+ * the clusters on the main thread, so the health check requests are answered with the last
+ * evaluation rather than looking the clusters up on each request.
+ */
+class ClusterHealthCache {
+public:
+  ClusterHealthCache(Event::Dispatcher& dispatcher, Upstream::ClusterManager& cluster_manager,
+                     ClusterMinHealthyPercentagesConstSharedPtr cluster_min_healthy_percentages,
+                     std::chrono::milliseconds interval);
+
+  ClusterHealth clusterHealth() const { return cluster_health_; }
+
+private:
+  void onTimer();
+
+  Upstream::ClusterManager& cluster_manager_;
+  const ClusterMinHealthyPercentagesConstSharedPtr cluster_min_healthy_percentages_;
+  Event::TimerPtr evaluate_timer_;
+  const std::chrono::milliseconds interval_;
+  std::atomic<ClusterHealth> cluster_health_{};
+};
+
+using ClusterHealthCacheSharedPtr = std::shared_ptr<ClusterHealthCache>;
+
 using HeaderDataVectorSharedPtr = std::shared_ptr<std::vector<Http::HeaderUtility::HeaderData>>;
 
 /**
@@ -63,10 +115,12 @@ public:
   HealthCheckFilter(Server::Configuration::FactoryContext& context, bool pass_through_mode,
                     HealthCheckCacheManagerSharedPtr cache_manager,
                     HeaderDataVectorSharedPtr header_match_data,
-                    ClusterMinHealthyPercentagesConstSharedPtr cluster_min_healthy_percentages)
+                    ClusterMinHealthyPercentagesConstSharedPtr cluster_min_healthy_percentages,
+                    ClusterHealthCacheSharedPtr cluster_health_cache)
       : context_(context), pass_through_mode_(pass_through_mode), cache_manager_(cache_manager),
         header_match_data_(std::move(header_match_data)),
-        cluster_min_healthy_percentages_(cluster_min_healthy_percentages) {}
+        cluster_min_healthy_percentages_(cluster_min_healthy_percentages),
+        cluster_health_cache_(std::move(cluster_health_cache)) {}
 
   // Http::StreamFilterBase
   void onDestroy() override {}
@@ -106,6 +160,7 @@ private:
   HealthCheckCacheManagerSharedPtr cache_manager_;
   const HeaderDataVectorSharedPtr header_match_data_;
   ClusterMinHealthyPercentagesConstSharedPtr cluster_min_healthy_percentages_;
+  const ClusterHealthCacheSharedPtr cluster_health_cache_;
 };
 
 } // namespace HealthCheck
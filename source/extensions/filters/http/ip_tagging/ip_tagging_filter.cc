@@ -10,6 +10,76 @@ namespace Extensions {
 namespace HttpFilters {
 namespace IpTagging {
 
+IpTaggingFilterConfig::IpTaggingFilterConfig(
+    const envoy::config::filter::http::ip_tagging::v2::IPTagging& config,
+    const std::string& stat_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+    Event::Dispatcher& dispatcher, ThreadLocal::SlotAllocator& tls)
+    : request_type_(requestTypeEnum(config.request_type())), scope_(scope), runtime_(runtime),
+      stats_prefix_(stat_prefix + "ip_tagging."), ip_tags_path_(config.ip_tags_path()) {
+  if (config.ip_tags().empty() == ip_tags_path_.empty()) {
+    throw EnvoyException(
+        "HTTP IP Tagging Filter requires exactly one of ip_tags and ip_tags_path to be specified.");
+  }
+
+  if (ip_tags_path_.empty()) {
+    trie_ = std::make_shared<const Trie>(tagDataFromConfig(config));
+    return;
+  }
+
+  // The file is read on the main thread, and the workers share the resulting trie. A file which
+  // can not be read at startup rejects the configuration.
+  TrieSharedPtr trie = std::make_shared<const Trie>(readIpTagsFile(ip_tags_path_));
+  tls_ = tls.allocateSlot();
+  setIpTagsFileTrie(std::move(trie));
+  watcher_ = dispatcher.createFilesystemWatcher();
+  watcher_->addWatch(ip_tags_path_, Filesystem::Watcher::Events::MovedTo,
+                     [this](uint32_t) { onIpTagsFileMoved(); });
+}
+
+IpTagData IpTaggingFilterConfig::tagDataFromConfig(
+    const envoy::config::filter::http::ip_tagging::v2::IPTagging& config) {
+  IpTagData tag_data;
+  tag_data.reserve(config.ip_tags().size());
+  for (const auto& ip_tag : config.ip_tags()) {
+    std::vector<Network::Address::CidrRange> cidr_set;
+    cidr_set.reserve(ip_tag.ip_list().size());
+    for (const envoy::api::v2::core::CidrRange& entry : ip_tag.ip_list()) {
+
+      // Currently, CidrRange::create doesn't guarantee that the CidrRanges are valid.
+      Network::Address::CidrRange cidr_entry = Network::Address::CidrRange::create(entry);
+      if (cidr_entry.isValid()) {
+        cidr_set.emplace_back(std::move(cidr_entry));
+      } else {
+        throw EnvoyException(
+            fmt::format("invalid ip/mask combo '{}/{}' (format is <ip>/<# mask bits>)",
+                        entry.address_prefix(), entry.prefix_len().value()));
+      }
+    }
+    tag_data.emplace_back(ip_tag.ip_tag_name(), cidr_set);
+  }
+  return tag_data;
+}
+
+void IpTaggingFilterConfig::setIpTagsFileTrie(TrieSharedPtr trie) {
+  tls_->set([trie](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<ThreadLocalTrie>(trie);
+  });
+}
+
+void IpTaggingFilterConfig::onIpTagsFileMoved() {
+  TrieSharedPtr trie;
+  try {
+    trie = std::make_shared<const Trie>(readIpTagsFile(ip_tags_path_));
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "ip tagging: keeping the previous IP tags, unable to reload '{}': {}",
+              ip_tags_path_, e.what());
+    scope_.counter(fmt::format("{}file_reload_failed", stats_prefix_)).inc();
+    return;
+  }
+  setIpTagsFileTrie(std::move(trie));
+  scope_.counter(fmt::format("{}file_reload", stats_prefix_)).inc();
+}
+
 IpTaggingFilter::IpTaggingFilter(IpTaggingFilterConfigSharedPtr config) : config_(config) {}
 
 IpTaggingFilter::~IpTaggingFilter() = default;
@@ -27,7 +97,7 @@ Http::FilterHeadersStatus IpTaggingFilter::decodeHeaders(Http::HeaderMap& header
     return Http::FilterHeadersStatus::Continue;
   }
 
-  std::vector<std::string> tags =
+  const std::vector<std::string>& tags =
       config_->trie().getData(callbacks_->streamInfo().downstreamRemoteAddress());
 
   if (!tags.empty()) {
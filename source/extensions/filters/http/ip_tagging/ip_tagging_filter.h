@@ -8,13 +8,19 @@
 
 #include "envoy/common/exception.h"
 #include "envoy/config/filter/http/ip_tagging/v2/ip_tagging.pb.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/filesystem/watcher.h"
 #include "envoy/http/filter.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
+#include "envoy/thread_local/thread_local.h"
 
+#include "common/common/logger.h"
 #include "common/network/cidr_range.h"
 #include "common/network/lc_trie.h"
 
+#include "extensions/filters/http/ip_tagging/ip_tags_file.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -28,52 +34,35 @@ enum class FilterRequestType { INTERNAL, EXTERNAL, BOTH };
 /**
  * Configuration for the HTTP IP Tagging filter.
  */
-class IpTaggingFilterConfig {
+class IpTaggingFilterConfig : public Logger::Loggable<Logger::Id::filter> {
 public:
+  using Trie = Network::LcTrie::LcTrie<std::string>;
+
   IpTaggingFilterConfig(const envoy::config::filter::http::ip_tagging::v2::IPTagging& config,
                         const std::string& stat_prefix, Stats::Scope& scope,
-                        Runtime::Loader& runtime)
-      : request_type_(requestTypeEnum(config.request_type())), scope_(scope), runtime_(runtime),
-        stats_prefix_(stat_prefix + "ip_tagging.") {
-
-    // Once loading IP tags from a file system is supported, the restriction on the size
-    // of the set should be removed and observability into what tags are loaded needs
-    // to be implemented.
-    // TODO(ccaraman): Remove size check once file system support is implemented.
-    // Work is tracked by issue https://github.com/envoyproxy/envoy/issues/2695.
-    if (config.ip_tags().empty()) {
-      throw EnvoyException("HTTP IP Tagging Filter requires ip_tags to be specified.");
-    }
-
-    std::vector<std::pair<std::string, std::vector<Network::Address::CidrRange>>> tag_data;
-    tag_data.reserve(config.ip_tags().size());
-    for (const auto& ip_tag : config.ip_tags()) {
-      std::vector<Network::Address::CidrRange> cidr_set;
-      cidr_set.reserve(ip_tag.ip_list().size());
-      for (const envoy::api::v2::core::CidrRange& entry : ip_tag.ip_list()) {
-
-        // Currently, CidrRange::create doesn't guarantee that the CidrRanges are valid.
-        Network::Address::CidrRange cidr_entry = Network::Address::CidrRange::create(entry);
-        if (cidr_entry.isValid()) {
-          cidr_set.emplace_back(std::move(cidr_entry));
-        } else {
-          throw EnvoyException(
-              fmt::format("invalid ip/mask combo '{}/{}' (format is <ip>/<# mask bits>)",
-                          entry.address_prefix(), entry.prefix_len().value()));
-        }
-      }
-      tag_data.emplace_back(ip_tag.ip_tag_name(), cidr_set);
-    }
-    trie_ = std::make_unique<Network::LcTrie::LcTrie<std::string>>(tag_data);
-  }
+                        Runtime::Loader& runtime, Event::Dispatcher& dispatcher,
+                        ThreadLocal::SlotAllocator& tls);
 
   Runtime::Loader& runtime() { return runtime_; }
   Stats::Scope& scope() { return scope_; }
   FilterRequestType requestType() const { return request_type_; }
-  const Network::LcTrie::LcTrie<std::string>& trie() const { return *trie_; }
+  const Trie& trie() const {
+    return tls_ == nullptr ? *trie_ : *tls_->getTyped<ThreadLocalTrie>().trie_;
+  }
   const std::string& statsPrefix() const { return stats_prefix_; }
 
 private:
+  using TrieSharedPtr = std::shared_ptr<const Trie>;
+
+  /**
+   * The trie of the IP tags file, shared by the workers until the file is reloaded.
+   */
+  struct ThreadLocalTrie : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalTrie(TrieSharedPtr trie) : trie_(std::move(trie)) {}
+
+    const TrieSharedPtr trie_;
+  };
+
   static FilterRequestType requestTypeEnum(
       envoy::config::filter::http::ip_tagging::v2::IPTagging::RequestType request_type) {
     switch (request_type) {
@@ -88,11 +77,21 @@ private:
     }
   }
 
+  static IpTagData
+  tagDataFromConfig(const envoy::config::filter::http::ip_tagging::v2::IPTagging& config);
+  void setIpTagsFileTrie(TrieSharedPtr trie);
+  void onIpTagsFileMoved();
+
   const FilterRequestType request_type_;
   Stats::Scope& scope_;
   Runtime::Loader& runtime_;
   const std::string stats_prefix_;
-  std::unique_ptr<Network::LcTrie::LcTrie<std::string>> trie_;
+  // The trie of the inline IP tags.
+  TrieSharedPtr trie_;
+  // The trie of the IP tags file, swapped on all the threads when the file is reloaded.
+  const std::string ip_tags_path_;
+  ThreadLocal::SlotPtr tls_;
+  Filesystem::WatcherPtr watcher_;
 };
 
 using IpTaggingFilterConfigSharedPtr = std::shared_ptr<IpTaggingFilterConfig>;
@@ -0,0 +1,166 @@
+#include "extensions/filters/http/ip_tagging/ip_tags_file.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/common/exception.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/cleanup.h"
+#include "common/network/address_impl.h"
+
+#include "absl/strings/string_view.h"
+#include "fmt/format.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace IpTagging {
+
+namespace {
+
+constexpr absl::string_view IpTagsFileMagic = "IPTG";
+constexpr uint32_t IpTagsFileVersion = 1;
+
+/**
+ * Reads the fields of an IP tags file, throwing on truncated files.
+ */
+class IpTagsFileReader {
+public:
+  IpTagsFileReader(const std::string& path, absl::string_view contents)
+      : path_(path), contents_(contents) {}
+
+  size_t remaining() const { return contents_.size(); }
+
+  absl::string_view readBytes(size_t length) {
+    if (contents_.size() < length) {
+      throw EnvoyException(fmt::format("truncated IP tags file '{}'", path_));
+    }
+    const absl::string_view bytes = contents_.substr(0, length);
+    contents_.remove_prefix(length);
+    return bytes;
+  }
+
+  uint8_t readUint8() { return static_cast<uint8_t>(readBytes(1)[0]); }
+
+  uint16_t readUint16() {
+    uint16_t value;
+    memcpy(&value, readBytes(sizeof(value)).data(), sizeof(value));
+    return ntohs(value);
+  }
+
+  uint32_t readUint32() {
+    uint32_t value;
+    memcpy(&value, readBytes(sizeof(value)).data(), sizeof(value));
+    return ntohl(value);
+  }
+
+private:
+  const std::string& path_;
+  absl::string_view contents_;
+};
+
+Network::Address::InstanceConstSharedPtr readAddress(IpTagsFileReader& reader,
+                                                     uint8_t ip_version) {
+  if (ip_version == 4) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    memcpy(&address.sin_addr, reader.readBytes(sizeof(address.sin_addr)).data(),
+           sizeof(address.sin_addr));
+    return std::make_shared<Network::Address::Ipv4Instance>(&address);
+  }
+  sockaddr_in6 address{};
+  address.sin6_family = AF_INET6;
+  memcpy(&address.sin6_addr, reader.readBytes(sizeof(address.sin6_addr)).data(),
+         sizeof(address.sin6_addr));
+  return std::make_shared<Network::Address::Ipv6Instance>(address);
+}
+
+IpTagData parseIpTagsFile(const std::string& path, absl::string_view contents) {
+  IpTagsFileReader reader(path, contents);
+  if (reader.readBytes(IpTagsFileMagic.size()) != IpTagsFileMagic) {
+    throw EnvoyException(fmt::format("'{}' is not an IP tags file", path));
+  }
+  const uint32_t version = reader.readUint32();
+  if (version != IpTagsFileVersion) {
+    throw EnvoyException(
+        fmt::format("unsupported version {} of the IP tags file '{}'", version, path));
+  }
+
+  const uint32_t num_tags = reader.readUint32();
+  // Each tag name takes at least the 2 bytes of its length.
+  if (num_tags > reader.remaining() / sizeof(uint16_t)) {
+    throw EnvoyException(fmt::format("truncated IP tags file '{}'", path));
+  }
+  IpTagData tag_data(num_tags);
+  for (auto& tag : tag_data) {
+    tag.first = std::string(reader.readBytes(reader.readUint16()));
+  }
+
+  while (reader.remaining() > 0) {
+    const uint16_t tag_index = reader.readUint16();
+    const uint8_t ip_version = reader.readUint8();
+    const uint8_t prefix_length = reader.readUint8();
+    if (tag_index >= tag_data.size()) {
+      throw EnvoyException(
+          fmt::format("invalid tag index {} in the IP tags file '{}'", tag_index, path));
+    }
+    if (ip_version != 4 && ip_version != 6) {
+      throw EnvoyException(
+          fmt::format("invalid IP version {} in the IP tags file '{}'", ip_version, path));
+    }
+    if (prefix_length > (ip_version == 4 ? 32 : 128)) {
+      throw EnvoyException(fmt::format("invalid prefix length {} in the IP tags file '{}'",
+                                       prefix_length, path));
+    }
+    tag_data[tag_index].second.emplace_back(
+        Network::Address::CidrRange::create(readAddress(reader, ip_version), prefix_length));
+  }
+  return tag_data;
+}
+
+} // namespace
+
+IpTagData readIpTagsFile(const std::string& path) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw EnvoyException(
+        fmt::format("unable to open the IP tags file '{}': {}", path, strerror(errno)));
+  }
+  Cleanup close_fd([&os_sys_calls, fd]() { os_sys_calls.close(fd); });
+
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) == -1) {
+    throw EnvoyException(
+        fmt::format("unable to stat the IP tags file '{}': {}", path, strerror(errno)));
+  }
+  const size_t size = file_stat.st_size;
+  if (size == 0) {
+    throw EnvoyException(fmt::format("'{}' is not an IP tags file", path));
+  }
+
+  // The file is mapped rather than read, so large files are not copied before being parsed.
+  const Api::SysCallPtrResult mmap_result =
+      os_sys_calls.mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (mmap_result.rc_ == MAP_FAILED) {
+    throw EnvoyException(fmt::format("unable to map the IP tags file '{}': {}", path,
+                                     strerror(mmap_result.errno_)));
+  }
+  Cleanup unmap([&mmap_result, size]() { ::munmap(mmap_result.rc_, size); });
+  ::madvise(mmap_result.rc_, size, MADV_SEQUENTIAL);
+
+  return parseIpTagsFile(path,
+                         absl::string_view(static_cast<const char*>(mmap_result.rc_), size));
+}
+
+} // namespace IpTagging
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
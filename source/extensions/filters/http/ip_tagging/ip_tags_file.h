@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/network/cidr_range.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace IpTagging {
+
+using IpTagData = std::vector<std::pair<std::string, std::vector<Network::Address::CidrRange>>>;
+
+/**
+ * Reads an IP tags file, built offline, which is memory mapped while it is parsed. All the
+ * integers are in network byte order:
+ *   - the magic bytes "IPTG", and the format version as a uint32 (currently 1).
+ *   - the number of tags as a uint32, followed by the name of each tag: its length as a uint16
+ *     and its bytes.
+ *   - the CIDR ranges, until the end of the file. Each range is the index of its tag as a uint16,
+ *     the IP version as a uint8 (4 or 6), the prefix length as a uint8 and the 4 or 16 bytes of
+ *     the address.
+ * @param path supplies the path of the file.
+ * @return the tags and their CIDR ranges.
+ * @throw EnvoyException if the file can not be read or is malformed.
+ */
+IpTagData readIpTagsFile(const std::string& path);
+
+} // namespace IpTagging
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
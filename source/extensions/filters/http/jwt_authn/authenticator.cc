@@ -30,9 +30,10 @@ class AuthenticatorImpl : public Logger::Loggable<Logger::Id::jwt>,
 public:
   AuthenticatorImpl(const CheckAudience* check_audience,
                     const absl::optional<std::string>& provider, bool allow_failed,
-                    JwksCache& jwks_cache, Upstream::ClusterManager& cluster_manager,
+                    JwksCache& jwks_cache, TokenCache* token_cache,
+                    Upstream::ClusterManager& cluster_manager,
                     CreateJwksFetcherCb create_jwks_fetcher_cb, TimeSource& time_source)
-      : jwks_cache_(jwks_cache), cm_(cluster_manager),
+      : jwks_cache_(jwks_cache), token_cache_(token_cache), cm_(cluster_manager),
         create_jwks_fetcher_cb_(create_jwks_fetcher_cb), check_audience_(check_audience),
         provider_(provider), is_allow_failed_(allow_failed), time_source_(time_source) {}
 
@@ -59,6 +60,8 @@ private:
 
   // The jwks cache object.
   JwksCache& jwks_cache_;
+  // The cache of verified tokens, if enabled.
+  TokenCache* const token_cache_;
   // the cluster manager object.
   Upstream::ClusterManager& cm_;
 
@@ -72,7 +75,9 @@ private:
   std::vector<JwtLocationConstPtr> tokens_;
   JwtLocationConstPtr curr_token_;
   // The JWT object.
-  std::unique_ptr<::google::jwt_verify::Jwt> jwt_;
+  JwtConstSharedPtr jwt_;
+  // The token cache entry of the JWT, if it was cached.
+  absl::optional<TokenCache::Entry> cached_;
   // The JWKS data object
   JwksCache::JwksData* jwks_data_{};
 
@@ -111,11 +116,17 @@ void AuthenticatorImpl::startVerify() {
   ASSERT(!tokens_.empty());
   curr_token_ = std::move(tokens_.back());
   tokens_.pop_back();
-  jwt_ = std::make_unique<::google::jwt_verify::Jwt>();
-  const Status status = jwt_->parseFromString(curr_token_->token());
-  if (status != Status::Ok) {
-    doneWithStatus(status);
-    return;
+  cached_ = token_cache_ != nullptr ? token_cache_->find(curr_token_->token()) : absl::nullopt;
+  if (cached_.has_value()) {
+    jwt_ = cached_->jwt_;
+  } else {
+    auto jwt = std::make_shared<::google::jwt_verify::Jwt>();
+    const Status status = jwt->parseFromString(curr_token_->token());
+    if (status != Status::Ok) {
+      doneWithStatus(status);
+      return;
+    }
+    jwt_ = std::move(jwt);
   }
 
   ENVOY_LOG(debug, "Verifying JWT token of issuer {}", jwt_->iss_);
@@ -209,10 +220,18 @@ void AuthenticatorImpl::onDestroy() {
 
 // Verify with a specific public key.
 void AuthenticatorImpl::verifyKey() {
-  const Status status = ::google::jwt_verify::verifyJwt(*jwt_, *jwks_data_->getJwksObj());
-  if (status != Status::Ok) {
-    doneWithStatus(status);
-    return;
+  if (cached_.has_value() && cached_->verifiedWith(*jwks_data_)) {
+    token_cache_->hit().inc();
+  } else {
+    const Status status = ::google::jwt_verify::verifyJwt(*jwt_, *jwks_data_->getJwksObj());
+    if (status != Status::Ok) {
+      doneWithStatus(status);
+      return;
+    }
+    if (token_cache_ != nullptr) {
+      token_cache_->miss().inc();
+      token_cache_->insert(curr_token_->token(), {jwt_, jwks_data_, jwks_data_->generation()});
+    }
   }
 
   // Forward the payload
@@ -252,11 +271,13 @@ void AuthenticatorImpl::doneWithStatus(const Status& status) {
 AuthenticatorPtr Authenticator::create(const CheckAudience* check_audience,
                                        const absl::optional<std::string>& provider,
                                        bool allow_failed, JwksCache& jwks_cache,
+                                       TokenCache* token_cache,
                                        Upstream::ClusterManager& cluster_manager,
                                        CreateJwksFetcherCb create_jwks_fetcher_cb,
                                        TimeSource& time_source) {
   return std::make_unique<AuthenticatorImpl>(check_audience, provider, allow_failed, jwks_cache,
-                                             cluster_manager, create_jwks_fetcher_cb, time_source);
+                                             token_cache, cluster_manager, create_jwks_fetcher_cb,
+                                             time_source);
 }
 
 } // namespace JwtAuthn
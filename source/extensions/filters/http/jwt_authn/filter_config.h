@@ -7,6 +7,7 @@
 #include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "extensions/filters/http/jwt_authn/jwks_async_fetcher.h"
 #include "extensions/filters/http/jwt_authn/matcher.h"
 #include "extensions/filters/http/jwt_authn/verifier.h"
 
@@ -17,43 +18,54 @@ namespace Extensions {
 namespace HttpFilters {
 namespace JwtAuthn {
 
+/**
+ * All stats for the Jwt Authn filter. @see stats_macros.h
+ */
+
+// clang-format off
+#define ALL_JWT_AUTHN_FILTER_STATS(COUNTER)                                                        \
+  COUNTER(allowed)                                                                                 \
+  COUNTER(denied)                                                                                  \
+  COUNTER(token_cache_hit)                                                                         \
+  COUNTER(token_cache_miss)
+// clang-format on
+
+/**
+ * Wrapper struct for jwt_authn filter stats. @see stats_macros.h
+ */
+struct JwtAuthnFilterStats {
+  ALL_JWT_AUTHN_FILTER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
 /**
  * Making cache as a thread local object, its read/write operations don't need to be protected.
- * Now it only has jwks_cache, but in the future, it will have token cache: to cache the tokens
- * with their verification results.
+ * It has the jwks_cache and, if enabled, the token cache of the tokens whose verification
+ * succeeded.
  */
 class ThreadLocalCache : public ThreadLocal::ThreadLocalObject {
 public:
   // Load the config from envoy config.
   ThreadLocalCache(
       const ::envoy::config::filter::http::jwt_authn::v2alpha::JwtAuthentication& config,
-      TimeSource& time_source, Api::Api& api) {
+      TimeSource& time_source, Api::Api& api, JwtAuthnFilterStats& stats) {
     jwks_cache_ = JwksCache::create(config, time_source, api);
+    if (config.token_cache_size() > 0) {
+      token_cache_ = std::make_unique<TokenCache>(config.token_cache_size(),
+                                                  stats.token_cache_hit_, stats.token_cache_miss_);
+    }
   }
 
   // Get the JwksCache object.
   JwksCache& getJwksCache() { return *jwks_cache_; }
 
+  // Get the TokenCache object, nullptr if it is not enabled.
+  TokenCache* getTokenCache() { return token_cache_.get(); }
+
 private:
   // The JwksCache object.
   JwksCachePtr jwks_cache_;
-};
-
-/**
- * All stats for the Jwt Authn filter. @see stats_macros.h
- */
-
-// clang-format off
-#define ALL_JWT_AUTHN_FILTER_STATS(COUNTER)                                                        \
-  COUNTER(allowed)                                                                                 \
-  COUNTER(denied)
-// clang-format on
-
-/**
- * Wrapper struct for jwt_authn filter stats. @see stats_macros.h
- */
-struct JwtAuthnFilterStats {
-  ALL_JWT_AUTHN_FILTER_STATS(GENERATE_COUNTER_STRUCT)
+  // The TokenCache object.
+  TokenCachePtr token_cache_;
 };
 
 /**
@@ -71,10 +83,20 @@ public:
         time_source_(context.dispatcher().timeSource()), api_(context.api()) {
     ENVOY_LOG(info, "Loaded JwtAuthConfig: {}", proto_config_.DebugString());
     tls_->set([this](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
-      return std::make_shared<ThreadLocalCache>(proto_config_, time_source_, api_);
+      return std::make_shared<ThreadLocalCache>(proto_config_, time_source_, api_, stats_);
     });
     extractor_ = Extractor::create(proto_config_);
 
+    for (const auto& it : proto_config_.providers()) {
+      const auto& provider = it.second;
+      if (provider.has_remote_jwks() && provider.remote_jwks().async_fetch()) {
+        const std::string& name = it.first;
+        async_fetchers_.push_back(std::make_unique<JwksAsyncFetcher>(
+            provider.remote_jwks(), context, Common::JwksFetcher::create,
+            [this, name](JwksConstSharedPtr jwks) { setAsyncJwks(name, std::move(jwks)); }));
+      }
+    }
+
     for (const auto& rule : proto_config_.rules()) {
       rule_pairs_.emplace_back(
           Matcher::create(rule),
@@ -127,10 +149,20 @@ public:
                           const absl::optional<std::string>& provider,
                           bool allow_failed) const override {
     return Authenticator::create(check_audience, provider, allow_failed, getCache().getJwksCache(),
-                                 cm(), Common::JwksFetcher::create, timeSource());
+                                 getCache().getTokenCache(), cm(), Common::JwksFetcher::create,
+                                 timeSource());
   }
 
 private:
+  // Hand the JWKS of a provider fetched on the main thread to all the workers.
+  void setAsyncJwks(const std::string& provider, JwksConstSharedPtr jwks) {
+    tls_->runOnAllThreads([this, provider, jwks]() {
+      JwksCache::JwksData* jwks_data = getCache().getJwksCache().findByProvider(provider);
+      ASSERT(jwks_data != nullptr);
+      jwks_data->setAsyncJwks(jwks);
+    });
+  }
+
   JwtAuthnFilterStats generateStats(const std::string& prefix, Stats::Scope& scope) {
     const std::string final_prefix = prefix + "jwt_authn.";
     return {ALL_JWT_AUTHN_FILTER_STATS(POOL_COUNTER_PREFIX(scope, final_prefix))};
@@ -161,6 +193,8 @@ private:
   absl::flat_hash_map<std::string, VerifierConstPtr> filter_state_verifiers_;
   TimeSource& time_source_;
   Api::Api& api_;
+  // The background fetchers of the remote JWKS with async_fetch set.
+  std::vector<JwksAsyncFetcherPtr> async_fetchers_;
 };
 using FilterConfigSharedPtr = std::shared_ptr<FilterConfig>;
 
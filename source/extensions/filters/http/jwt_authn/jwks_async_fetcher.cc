@@ -0,0 +1,71 @@
+#include "extensions/filters/http/jwt_authn/jwks_async_fetcher.h"
+
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+namespace {
+
+// The refresh interval when the remote JWKS have no cache duration, as their default expiration.
+constexpr std::chrono::milliseconds DefaultRefreshInterval{600 * 1000};
+
+} // namespace
+
+constexpr std::chrono::milliseconds JwksAsyncFetcher::RetryInterval;
+
+JwksAsyncFetcher::JwksAsyncFetcher(
+    const ::envoy::config::filter::http::jwt_authn::v2alpha::RemoteJwks& remote_jwks,
+    Server::Configuration::FactoryContext& context, CreateJwksFetcherCb create_fetcher_cb,
+    JwksDoneFn done_fn)
+    : remote_jwks_(remote_jwks), cm_(context.clusterManager()),
+      create_fetcher_cb_(std::move(create_fetcher_cb)), done_fn_(std::move(done_fn)),
+      refresh_interval_(remote_jwks.has_cache_duration()
+                            ? std::chrono::milliseconds(DurationUtil::durationToMilliseconds(
+                                  remote_jwks.cache_duration()))
+                            : DefaultRefreshInterval),
+      refresh_timer_(context.dispatcher().createTimer([this]() { fetch(); })),
+      init_target_(fmt::format("JwksAsyncFetcher {}", remote_jwks.http_uri().uri()),
+                   [this]() { fetch(); }) {
+  context.initManager().add(init_target_);
+}
+
+JwksAsyncFetcher::~JwksAsyncFetcher() {
+  if (fetcher_ != nullptr) {
+    fetcher_->cancel();
+  }
+  // If we get destroyed during initialization, make sure we signal that we "initialized".
+  init_target_.ready();
+}
+
+void JwksAsyncFetcher::fetch() {
+  if (fetcher_ == nullptr) {
+    fetcher_ = create_fetcher_cb_(cm_);
+  }
+  ENVOY_LOG(debug, "fetching remote jwks from {}", remote_jwks_.http_uri().uri());
+  fetcher_->fetch(remote_jwks_.http_uri(), *this);
+}
+
+void JwksAsyncFetcher::onJwksSuccess(google::jwt_verify::JwksPtr&& jwks) {
+  done_fn_(JwksConstSharedPtr(std::move(jwks)));
+  onFetchDone(refresh_interval_);
+}
+
+void JwksAsyncFetcher::onJwksError(Failure) {
+  ENVOY_LOG(warn, "failed to fetch remote jwks from {}, keeping the previous ones",
+            remote_jwks_.http_uri().uri());
+  onFetchDone(std::min(refresh_interval_, RetryInterval));
+}
+
+void JwksAsyncFetcher::onFetchDone(std::chrono::milliseconds next_fetch) {
+  // The listener does not wait for the JWKS beyond the first attempt: until a fetch succeeds,
+  // requests fall back to fetching them as they would without the background fetch.
+  init_target_.ready();
+  refresh_timer_->enableTimer(next_fetch);
+}
+
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+
+#include "envoy/config/filter/http/jwt_authn/v2alpha/config.pb.h"
+#include "envoy/event/timer.h"
+#include "envoy/server/filter_config.h"
+
+#include "common/common/logger.h"
+#include "common/init/target_impl.h"
+
+#include "extensions/filters/http/common/jwks_fetcher.h"
+#include "extensions/filters/http/jwt_authn/authenticator.h"
+#include "extensions/filters/http/jwt_authn/jwks_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+
+/**
+ * Fetches the remote JWKS of a provider on the main thread: first while the listener initializes,
+ * then again in the background each time the cache duration elapses, or shortly after a failed
+ * fetch. The workers keep serving the previous JWKS until they are handed the new ones, so that
+ * requests do not wait on a fetch.
+ */
+class JwksAsyncFetcher : public Common::JwksFetcher::JwksReceiver,
+                         public Logger::Loggable<Logger::Id::jwt> {
+public:
+  using JwksDoneFn = std::function<void(JwksConstSharedPtr jwks)>;
+
+  /**
+   * @param remote_jwks supplies the remote JWKS config, which must outlive the fetcher.
+   * @param context supplies the factory context of the filter.
+   * @param create_fetcher_cb supplies the callback creating the JWKS fetcher.
+   * @param done_fn supplies the function called on the main thread with each fetched JWKS.
+   */
+  JwksAsyncFetcher(
+      const ::envoy::config::filter::http::jwt_authn::v2alpha::RemoteJwks& remote_jwks,
+      Server::Configuration::FactoryContext& context, CreateJwksFetcherCb create_fetcher_cb,
+      JwksDoneFn done_fn);
+  ~JwksAsyncFetcher() override;
+
+  // Common::JwksFetcher::JwksReceiver
+  void onJwksSuccess(google::jwt_verify::JwksPtr&& jwks) override;
+  void onJwksError(Failure reason) override;
+
+  // The delay before a failed fetch is retried, unless the cache duration is shorter.
+  static constexpr std::chrono::milliseconds RetryInterval{5000};
+
+private:
+  void fetch();
+  void onFetchDone(std::chrono::milliseconds next_fetch);
+
+  const ::envoy::config::filter::http::jwt_authn::v2alpha::RemoteJwks& remote_jwks_;
+  Upstream::ClusterManager& cm_;
+  const CreateJwksFetcherCb create_fetcher_cb_;
+  const JwksDoneFn done_fn_;
+  const std::chrono::milliseconds refresh_interval_;
+  Common::JwksFetcherPtr fetcher_;
+  Event::TimerPtr refresh_timer_;
+  Init::TargetImpl init_target_;
+};
+
+using JwksAsyncFetcherPtr = std::unique_ptr<JwksAsyncFetcher>;
+
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
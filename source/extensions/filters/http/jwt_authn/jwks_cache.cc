@@ -43,7 +43,7 @@ public:
       if (ptr->getStatus() != Status::Ok) {
         ENVOY_LOG(warn, "Invalid inline jwks for issuer: {}, jwks: {}", jwt_provider_.issuer(),
                   inline_jwks);
-        jwks_obj_.reset(nullptr);
+        jwks_obj_.reset();
       }
     }
   }
@@ -62,6 +62,12 @@ public:
     return setKey(std::move(jwks), getRemoteJwksExpirationTime());
   }
 
+  void setAsyncJwks(JwksConstSharedPtr jwks) override {
+    setKey(std::move(jwks), std::chrono::steady_clock::time_point::max());
+  }
+
+  uint64_t generation() const override { return generation_; }
+
 private:
   // Get the expiration time for a remote Jwks
   std::chrono::steady_clock::time_point getRemoteJwksExpirationTime() const {
@@ -75,10 +81,10 @@ private:
     return expire;
   }
 
-  const ::google::jwt_verify::Jwks* setKey(::google::jwt_verify::JwksPtr&& jwks,
-                                           MonotonicTime expire) {
+  const ::google::jwt_verify::Jwks* setKey(JwksConstSharedPtr jwks, MonotonicTime expire) {
     jwks_obj_ = std::move(jwks);
     expiration_time_ = expire;
+    generation_++;
     return jwks_obj_.get();
   }
 
@@ -86,11 +92,13 @@ private:
   const JwtProvider& jwt_provider_;
   // Check audience object
   ::google::jwt_verify::CheckAudiencePtr audiences_;
-  // The generated jwks object.
-  ::google::jwt_verify::JwksPtr jwks_obj_;
+  // The generated jwks object, possibly shared with the other workers.
+  JwksConstSharedPtr jwks_obj_;
   TimeSource& time_source_;
   // The pubkey expiration time.
   MonotonicTime expiration_time_;
+  // The generation of jwks_obj_.
+  uint64_t generation_{};
 };
 
 class JwksCacheImpl : public JwksCache {
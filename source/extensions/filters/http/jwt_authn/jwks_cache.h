@@ -14,6 +14,7 @@ namespace JwtAuthn {
 
 class JwksCache;
 using JwksCachePtr = std::unique_ptr<JwksCache>;
+using JwksConstSharedPtr = std::shared_ptr<const ::google::jwt_verify::Jwks>;
 
 /**
  * Interface to access all configured Jwt rules and their cached Jwks objects.
@@ -58,6 +59,13 @@ public:
     // Set a remote Jwks.
     virtual const ::google::jwt_verify::Jwks*
     setRemoteJwks(::google::jwt_verify::JwksPtr&& jwks) PURE;
+
+    // Set a remote Jwks fetched in the background, shared with the other workers. It does not
+    // expire: it is served until the next one is set.
+    virtual void setAsyncJwks(JwksConstSharedPtr jwks) PURE;
+
+    // Get the generation of the Jwks object, which changes whenever it is set.
+    virtual uint64_t generation() const PURE;
   };
 
   // Lookup issuer cache map. The cache only stores Jwks specified in the config.
@@ -0,0 +1,39 @@
+#include "extensions/filters/http/jwt_authn/token_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+
+absl::optional<TokenCache::Entry> TokenCache::find(absl::string_view token) {
+  const auto it = map_.find(token);
+  if (it == map_.end()) {
+    return absl::nullopt;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->second;
+}
+
+void TokenCache::insert(const std::string& token, Entry&& entry) {
+  const auto it = map_.find(token);
+  if (it != map_.end()) {
+    it->second->second = std::move(entry);
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return;
+  }
+
+  if (max_size_ == 0) {
+    return;
+  }
+  if (lru_.size() >= max_size_) {
+    map_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+  lru_.emplace_front(token, std::move(entry));
+  map_.emplace(lru_.front().first, lru_.begin());
+}
+
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
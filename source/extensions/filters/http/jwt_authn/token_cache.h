@@ -0,0 +1,89 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/stats/stats.h"
+
+#include "extensions/filters/http/jwt_authn/jwks_cache.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "jwt_verify_lib/jwt.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+
+using JwtConstSharedPtr = std::shared_ptr<const ::google::jwt_verify::Jwt>;
+
+/**
+ * A bounded LRU cache of the JWTs whose signature has been verified, so that a token presented
+ * again is neither parsed nor verified again. Only the parsing and the signature verification are
+ * cached: the issuer, time and audience checks still run on every request. An entry is only valid
+ * for the JWKS it was verified with, so it is verified again once the JWKS are refreshed. Like the
+ * JwksCache it is per thread, and its operations are not protected.
+ */
+class TokenCache {
+public:
+  struct Entry {
+    // The parsed token.
+    JwtConstSharedPtr jwt_;
+    // The JWKS the token was verified with, and their generation at the time.
+    const JwksCache::JwksData* jwks_data_;
+    uint64_t jwks_generation_;
+
+    // @return whether the token was verified with the current keys of the given JWKS.
+    bool verifiedWith(const JwksCache::JwksData& jwks_data) const {
+      return jwks_data_ == &jwks_data && jwks_generation_ == jwks_data.generation();
+    }
+  };
+
+  /**
+   * @param max_size supplies the maximum number of cached tokens, beyond which the least recently
+   *        used one is evicted.
+   * @param hit supplies the counter of the verifications skipped thanks to the cache.
+   * @param miss supplies the counter of the verifications done, and cached.
+   */
+  TokenCache(uint32_t max_size, Stats::Counter& hit, Stats::Counter& miss)
+      : max_size_(max_size), hit_(hit), miss_(miss) {}
+
+  /**
+   * @return the entry of a token, if it is cached.
+   */
+  absl::optional<Entry> find(absl::string_view token);
+
+  /**
+   * Cache a token after its signature was verified, replacing a previous entry.
+   */
+  void insert(const std::string& token, Entry&& entry);
+
+  /**
+   * @return the number of cached tokens.
+   */
+  size_t size() const { return lru_.size(); }
+
+  Stats::Counter& hit() { return hit_; }
+  Stats::Counter& miss() { return miss_; }
+
+private:
+  using LruList = std::list<std::pair<std::string, Entry>>;
+
+  const uint32_t max_size_;
+  Stats::Counter& hit_;
+  Stats::Counter& miss_;
+  // Most recently used first.
+  LruList lru_;
+  // Keyed by views of the tokens held in lru_.
+  absl::flat_hash_map<absl::string_view, LruList::iterator> map_;
+};
+
+using TokenCachePtr = std::unique_ptr<TokenCache>;
+
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
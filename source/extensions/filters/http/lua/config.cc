@@ -17,6 +17,13 @@ Http::FilterFactoryCb LuaFilterConfig::createFilterFactoryFromProtoTyped(
     Server::Configuration::FactoryContext& context) {
   FilterConfigConstSharedPtr filter_config(new FilterConfig{
       proto_config.inline_code(), context.threadLocal(), context.clusterManager()});
+  if (proto_config.has_gc_pause()) {
+    filter_config->setRuntimeGCParameter(LUA_GCSETPAUSE, proto_config.gc_pause().value());
+  }
+  if (proto_config.has_gc_step_multiplier()) {
+    filter_config->setRuntimeGCParameter(LUA_GCSETSTEPMUL,
+                                         proto_config.gc_step_multiplier().value());
+  }
   return [filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<Filter>(filter_config));
   };
@@ -296,6 +296,9 @@ public:
   int responseFunctionRef() { return lua_state_.getGlobalRef(response_function_slot_); }
   uint64_t runtimeBytesUsed() { return lua_state_.runtimeBytesUsed(); }
   void runtimeGC() { return lua_state_.runtimeGC(); }
+  void setRuntimeGCParameter(int option, int value) {
+    lua_state_.setRuntimeGCParameter(option, value);
+  }
 
   Upstream::ClusterManager& cluster_manager_;
 
@@ -10,6 +10,7 @@
 #include "common/common/fmt.h"
 #include "common/http/codes.h"
 #include "common/http/header_utility.h"
+#include "common/protobuf/utility.h"
 #include "common/router/config_impl.h"
 
 namespace Envoy {
@@ -25,6 +26,37 @@ struct RcDetailsValues {
 };
 using RcDetails = ConstSingleton<RcDetailsValues>;
 
+namespace {
+
+struct ThreadLocalQuotaLeases : public ThreadLocal::ThreadLocalObject {
+  ThreadLocalQuotaLeases(uint32_t lease_size, std::chrono::milliseconds lease_duration,
+                         uint32_t max_leases, TimeSource& time_source)
+      : leases_(lease_size, lease_duration, max_leases, time_source) {}
+
+  Filters::Common::RateLimit::QuotaLeases leases_;
+};
+
+} // namespace
+
+void FilterConfig::initializeQuotaLeases(
+    const envoy::config::filter::http::rate_limit::v2::QuotaLease& config,
+    ThreadLocal::SlotAllocator& tls) {
+  const uint32_t lease_size = config.lease_size();
+  const std::chrono::milliseconds lease_duration(
+      DurationUtil::durationToMilliseconds(config.lease_duration()));
+  const uint32_t max_leases = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_leases, 1024);
+  tls_ = tls.allocateSlot();
+  tls_->set([lease_size, lease_duration,
+             max_leases](Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<ThreadLocalQuotaLeases>(lease_size, lease_duration, max_leases,
+                                                    dispatcher.timeSource());
+  });
+}
+
+Filters::Common::RateLimit::QuotaLeases* FilterConfig::quotaLeases() const {
+  return tls_ != nullptr ? &tls_->getTyped<ThreadLocalQuotaLeases>().leases_ : nullptr;
+}
+
 void Filter::initiateCall(const Http::HeaderMap& headers) {
   bool is_internal_request =
       headers.EnvoyInternalRequest() && (headers.EnvoyInternalRequest()->value() == "true");
@@ -57,12 +89,28 @@ void Filter::initiateCall(const Http::HeaderMap& headers) {
                                  route_entry, headers);
   }
 
-  if (!descriptors.empty()) {
-    state_ = State::Calling;
-    initiating_call_ = true;
+  if (descriptors.empty()) {
+    return;
+  }
+
+  Filters::Common::RateLimit::QuotaLeases* leases = config_->quotaLeases();
+  if (leases != nullptr) {
+    lease_key_ = Filters::Common::RateLimit::QuotaLeases::key(config_->domain(), descriptors);
+    if (leases->tryConsume(lease_key_)) {
+      cluster_->statsScope().counterFromStatName(config_->statNames().leased_ok_).inc();
+      return;
+    }
+  }
+
+  state_ = State::Calling;
+  initiating_call_ = true;
+  if (leases != nullptr) {
+    client_->lease(*this, config_->domain(), descriptors, callbacks_->activeSpan(),
+                   leases->leaseSize());
+  } else {
     client_->limit(*this, config_->domain(), descriptors, callbacks_->activeSpan());
-    initiating_call_ = false;
   }
+  initiating_call_ = false;
 }
 
 Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool) {
@@ -135,6 +183,9 @@ void Filter::complete(Filters::Common::RateLimit::LimitStatus status,
   switch (status) {
   case Filters::Common::RateLimit::LimitStatus::OK:
     cluster_->statsScope().counterFromStatName(stat_names.ok_).inc();
+    if (!lease_key_.empty()) {
+      config_->quotaLeases()->addLease(lease_key_);
+    }
     break;
   case Filters::Common::RateLimit::LimitStatus::Error:
     cluster_->statsScope().counterFromStatName(stat_names.error_).inc();
@@ -12,11 +12,13 @@
 #include "envoy/ratelimit/ratelimit.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
+#include "envoy/thread_local/thread_local.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/common/assert.h"
 #include "common/http/header_map_impl.h"
 
+#include "extensions/filters/common/ratelimit/quota_lease.h"
 #include "extensions/filters/common/ratelimit/ratelimit.h"
 #include "extensions/filters/common/ratelimit/stat_names.h"
 
@@ -37,7 +39,8 @@ class FilterConfig {
 public:
   FilterConfig(const envoy::config::filter::http::rate_limit::v2::RateLimit& config,
                const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
-               Runtime::Loader& runtime, Http::Context& http_context)
+               Runtime::Loader& runtime, Http::Context& http_context,
+               ThreadLocal::SlotAllocator& tls)
       : domain_(config.domain()), stage_(static_cast<uint64_t>(config.stage())),
         request_type_(config.request_type().empty() ? stringToType("both")
                                                     : stringToType(config.request_type())),
@@ -47,7 +50,11 @@ public:
             config.rate_limited_as_resource_exhausted()
                 ? absl::make_optional(Grpc::Status::GrpcStatus::ResourceExhausted)
                 : absl::nullopt),
-        http_context_(http_context), stat_names_(scope.symbolTable()) {}
+        http_context_(http_context), stat_names_(scope.symbolTable()) {
+    if (config.has_quota_lease()) {
+      initializeQuotaLeases(config.quota_lease(), tls);
+    }
+  }
   const std::string& domain() const { return domain_; }
   const LocalInfo::LocalInfo& localInfo() const { return local_info_; }
   uint64_t stage() const { return stage_; }
@@ -61,7 +68,15 @@ public:
   Http::Context& httpContext() { return http_context_; }
   Filters::Common::RateLimit::StatNames& statNames() { return stat_names_; }
 
+  /**
+   * @return the quota leases of the current worker, or nullptr if quotas are not leased.
+   */
+  Filters::Common::RateLimit::QuotaLeases* quotaLeases() const;
+
 private:
+  void initializeQuotaLeases(const envoy::config::filter::http::rate_limit::v2::QuotaLease& config,
+                             ThreadLocal::SlotAllocator& tls);
+
   static FilterRequestType stringToType(const std::string& request_type) {
     if (request_type == "internal") {
       return FilterRequestType::Internal;
@@ -83,6 +98,7 @@ private:
   const absl::optional<Grpc::Status::GrpcStatus> rate_limited_grpc_status_;
   Http::Context& http_context_;
   Filters::Common::RateLimit::StatNames stat_names_;
+  ThreadLocal::SlotPtr tls_;
 };
 
 using FilterConfigSharedPtr = std::shared_ptr<FilterConfig>;
@@ -135,6 +151,8 @@ private:
   Upstream::ClusterInfoConstSharedPtr cluster_;
   bool initiating_call_{};
   Http::HeaderMapPtr headers_to_add_;
+  // The key of the quota lease asked for by the call, if any.
+  std::string lease_key_;
 };
 
 } // namespace RateLimitFilter
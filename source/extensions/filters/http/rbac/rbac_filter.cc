@@ -3,6 +3,7 @@
 #include "envoy/stats/scope.h"
 
 #include "common/http/utility.h"
+#include "common/router/per_filter_config_ids.h"
 
 #include "extensions/filters/http/well_known_names.h"
 
@@ -24,7 +25,8 @@ RoleBasedAccessControlFilterConfig::RoleBasedAccessControlFilterConfig(
     const std::string& stats_prefix, Stats::Scope& scope)
     : stats_(Filters::Common::RBAC::generateStats(stats_prefix, scope)),
       engine_(Filters::Common::RBAC::createEngine(proto_config)),
-      shadow_engine_(Filters::Common::RBAC::createShadowEngine(proto_config)) {}
+      shadow_engine_(Filters::Common::RBAC::createShadowEngine(proto_config)),
+      per_filter_config_id_(Router::PerFilterConfigIds::id(HttpFilterNames::get().Rbac)) {}
 
 const Filters::Common::RBAC::RoleBasedAccessControlEngineImpl*
 RoleBasedAccessControlFilterConfig::engine(const Router::RouteConstSharedPtr route,
@@ -33,14 +35,9 @@ RoleBasedAccessControlFilterConfig::engine(const Router::RouteConstSharedPtr rou
     return engine(mode);
   }
 
-  const std::string& name = HttpFilterNames::get().Rbac;
-  const auto* entry = route->routeEntry();
-  const auto* tmp =
-      entry->perFilterConfigTyped<RoleBasedAccessControlRouteSpecificFilterConfig>(name);
   const auto* route_local =
-      tmp ? tmp
-          : entry->virtualHost()
-                .perFilterConfigTyped<RoleBasedAccessControlRouteSpecificFilterConfig>(name);
+      route->mostSpecificPerFilterConfigTyped<RoleBasedAccessControlRouteSpecificFilterConfig>(
+          per_filter_config_id_);
 
   if (route_local) {
     return route_local->engine(mode);
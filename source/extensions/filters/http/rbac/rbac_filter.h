@@ -59,6 +59,7 @@ private:
 
   std::unique_ptr<const Filters::Common::RBAC::RoleBasedAccessControlEngineImpl> engine_;
   std::unique_ptr<const Filters::Common::RBAC::RoleBasedAccessControlEngineImpl> shadow_engine_;
+  const uint32_t per_filter_config_id_;
 };
 
 using RoleBasedAccessControlFilterConfigSharedPtr =
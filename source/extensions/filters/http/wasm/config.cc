@@ -19,6 +19,9 @@ Http::FilterFactoryCb WasmFilterConfig::createFilterFactoryFromProtoTyped(
     Server::Configuration::FactoryContext& context) {
   auto filter_config = std::make_shared<FilterConfig>(proto_config, context);
   return [filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    if (filter_config->overloaded()) {
+      return; // Fail open.
+    }
     auto filter = filter_config->createFilter();
     callbacks.addStreamFilter(filter);
     callbacks.addAccessLogHandler(filter);
@@ -16,7 +16,8 @@ namespace Wasm {
 
 FilterConfig::FilterConfig(const envoy::config::filter::http::wasm::v2::Wasm& config,
                            Server::Configuration::FactoryContext& context)
-    : root_id_(config.root_id()), tls_slot_(context.threadLocal().allocateSlot()) {
+    : root_id_(config.root_id()), tls_slot_(context.threadLocal().allocateSlot()),
+      overload_manager_(context.overloadManager()) {
   auto vm_id = config.vm_id();
   auto root_id = config.root_id();
   auto configuration = std::make_shared<std::string>(config.configuration());
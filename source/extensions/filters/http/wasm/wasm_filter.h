@@ -5,6 +5,7 @@
 #include "envoy/config/filter/http/wasm/v2/wasm.pb.validate.h"
 #include "envoy/http/filter.h"
 #include "envoy/server/filter_config.h"
+#include "envoy/server/overload_manager.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "extensions/common/wasm/wasm.h"
@@ -28,13 +29,26 @@ public:
     if (!root_context_id_) {
       root_context_id_ = wasm.getRootContext(root_id_)->id();
     }
-    return std::make_shared<Context>(&tls_slot_->getTyped<Wasm>(), root_context_id_);
+    return wasm.createStreamContext(root_context_id_);
+  }
+
+  // Whether the filter must be bypassed for a new request because the overload manager shed
+  // Wasm plugin work. Must be called on the worker thread.
+  bool overloaded() {
+    if (overload_manager_.getThreadLocalOverloadState().getState(
+            Server::OverloadActionNames::get().DisableWasmPlugins) !=
+        Server::OverloadActionState::Active) {
+      return false;
+    }
+    tls_slot_->getTyped<Wasm>().stats().overload_bypassed_.inc();
+    return true;
   }
 
 private:
   std::string root_id_;
   uint32_t root_context_id_{0};
   ThreadLocal::SlotPtr tls_slot_;
+  Server::OverloadManager& overload_manager_;
 };
 
 typedef std::shared_ptr<FilterConfig> FilterConfigSharedPtr;
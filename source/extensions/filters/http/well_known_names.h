@@ -62,6 +62,8 @@ public:
   const std::string DynamicForwardProxy = "envoy.filters.http.dynamic_forward_proxy";
   // WebAssembly filter
   const std::string Wasm = "envoy.filters.http.wasm";
+  // HTTP cache filter
+  const std::string Cache = "envoy.filters.http.cache";
 
   // Converts names from v1 to v2
   const Config::V1Converter v1_converter_;
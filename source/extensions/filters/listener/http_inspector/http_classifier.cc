@@ -0,0 +1,127 @@
+#include "extensions/filters/listener/http_inspector/http_classifier.h"
+
+#include <algorithm>
+
+#include "extensions/filters/listener/http_inspector/http_protocol_header.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace HttpInspector {
+
+namespace {
+
+// The protocol of a request line up to the minor version.
+constexpr absl::string_view HTTP1_VERSION_PREFIX = "HTTP/1.";
+
+} // namespace
+
+const absl::string_view HttpClassifier::HTTP2_CONNECTION_PREFACE =
+    "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+HttpClassifier::Result HttpClassifier::classify(absl::string_view data) {
+  for (; pos_ < data.size(); pos_++) {
+    const uint8_t c = data[pos_];
+    if (maybe_http2_) {
+      if (c != uint8_t(HTTP2_CONNECTION_PREFACE[pos_])) {
+        maybe_http2_ = false;
+      } else if (pos_ + 1 == HTTP2_CONNECTION_PREFACE.size()) {
+        return Result::Http2;
+      }
+    }
+
+    const Result result = scanHttp1(c);
+    if (result != Result::NeedMoreData) {
+      return result;
+    }
+    if (!maybe_http2_ && state_ == State::Failed) {
+      return Result::NotHttp;
+    }
+  }
+  return Result::NeedMoreData;
+}
+
+HttpClassifier::Result HttpClassifier::scanHttp1(uint8_t c) {
+  // Method SP Request-URI SP HTTP-Version CRLF
+  switch (state_) {
+  case State::Method:
+    if (c == ' ') {
+      // The methods equal to the bytes scanned so far sort first.
+      const bool found = method_begin_ < method_end_ && methods()[method_begin_].size() == pos_;
+      state_ = found ? State::Uri : State::Failed;
+      uri_start_ = pos_ + 1;
+    } else {
+      narrowMethods(c);
+      if (method_begin_ == method_end_) {
+        state_ = State::Failed;
+      }
+    }
+    break;
+  case State::Uri:
+    if (c == ' ') {
+      state_ = pos_ > uri_start_ ? State::Version : State::Failed;
+      version_start_ = pos_ + 1;
+    } else if (c == '\r' || c == '\n') {
+      state_ = State::Failed;
+    }
+    break;
+  case State::Version: {
+    const size_t i = pos_ - version_start_;
+    if (i < HTTP1_VERSION_PREFIX.size()) {
+      if (c != HTTP1_VERSION_PREFIX[i]) {
+        state_ = State::Failed;
+      }
+    } else if (i == HTTP1_VERSION_PREFIX.size()) {
+      if (c == '0' || c == '1') {
+        http11_ = c == '1';
+      } else {
+        state_ = State::Failed;
+      }
+    } else if (c == '\r' || c == '\n') {
+      return http11_ ? Result::Http11 : Result::Http10;
+    } else {
+      state_ = State::Failed;
+    }
+    break;
+  }
+  case State::Failed:
+    break;
+  }
+  return Result::NeedMoreData;
+}
+
+void HttpClassifier::narrowMethods(uint8_t c) {
+  // The methods in [method_begin_, method_end_) start with the pos_ bytes scanned so far. As they
+  // are sorted, those also matching c are contiguous among them.
+  const std::vector<absl::string_view>& sorted = methods();
+  while (method_begin_ < method_end_ && (sorted[method_begin_].size() <= pos_ ||
+                                         uint8_t(sorted[method_begin_][pos_]) < c)) {
+    method_begin_++;
+  }
+  while (method_end_ > method_begin_ && uint8_t(sorted[method_end_ - 1][pos_]) > c) {
+    method_end_--;
+  }
+}
+
+const std::vector<absl::string_view>& HttpClassifier::methods() {
+  static const std::vector<absl::string_view>* methods = []() {
+    const auto& values = ExtendedHeader::get().MethodValues;
+    auto* methods = new std::vector<absl::string_view>{
+        values.Acl, values.Baseline_Control, values.Bind, values.Checkin, values.Checkout,
+        values.Connect, values.Copy, values.Delete, values.Get, values.Head, values.Label,
+        values.Link, values.Lock, values.Merge, values.Mkactivity, values.Mkcalendar, values.Mkcol,
+        values.Mkredirectref, values.Mkworkspace, values.Move, values.Options, values.Orderpatch,
+        values.Patch, values.Post, values.Proppatch, values.Purge, values.Put, values.Rebind,
+        values.Report, values.Search, values.Trace, values.Unbind, values.Uncheckout, values.Unlink,
+        values.Unlock, values.Update, values.Updateredirectref, values.Version_Control};
+    // string_view compares bytes as unsigned chars, as narrowMethods() does.
+    std::sort(methods->begin(), methods->end());
+    return methods;
+  }();
+  return *methods;
+}
+
+} // namespace HttpInspector
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace HttpInspector {
+
+/**
+ * A classifier of the start of a connection as an HTTP/1.x request line, an HTTP/2 connection
+ * preface, or neither, deciding from as few bytes as possible. It is fed the data peeked from the
+ * connection, which grows from one call to the next, and keeps its state across calls so that
+ * each byte is scanned once, without allocating.
+ */
+class HttpClassifier {
+public:
+  enum class Result {
+    // The data is a valid prefix of a request line or of the connection preface; more is needed.
+    NeedMoreData,
+    Http10,
+    Http11,
+    Http2,
+    NotHttp,
+  };
+
+  /**
+   * Classify the data received so far.
+   * @param data supplies the data received so far, starting with the data of the previous calls.
+   * @return the outcome of the classification. Once it is not NeedMoreData, the classifier must
+   *         not be called again.
+   */
+  Result classify(absl::string_view data);
+
+  static const absl::string_view HTTP2_CONNECTION_PREFACE;
+
+private:
+  enum class State { Method, Uri, Version, Failed };
+
+  Result scanHttp1(uint8_t c);
+  void narrowMethods(uint8_t c);
+
+  /**
+   * @return the HTTP/1.x methods, sorted.
+   */
+  static const std::vector<absl::string_view>& methods();
+
+  // The position of the next byte to scan.
+  size_t pos_{};
+  bool maybe_http2_{true};
+  State state_{State::Method};
+  // While in the method, the range of the methods starting with the bytes scanned so far.
+  size_t method_begin_{};
+  size_t method_end_{methods().size()};
+  size_t uri_start_{};
+  size_t version_start_{};
+  bool http11_{};
+};
+
+} // namespace HttpInspector
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
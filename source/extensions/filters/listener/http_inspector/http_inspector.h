@@ -8,7 +8,7 @@
 
 #include "common/common/logger.h"
 
-#include "absl/container/flat_hash_set.h"
+#include "extensions/filters/listener/http_inspector/http_classifier.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -60,19 +60,15 @@ public:
   Network::FilterStatus onAccept(Network::ListenerFilterCallbacks& cb) override;
 
 private:
-  static const absl::string_view HTTP2_CONNECTION_PREFACE;
-
   void onRead();
   void done(bool success);
-  void parseHttpHeader(absl::string_view data);
-
-  const absl::flat_hash_set<std::string>& httpProtocols() const;
-  const absl::flat_hash_set<std::string>& http1xMethods() const;
 
   ConfigSharedPtr config_;
   Network::ListenerFilterCallbacks* cb_{nullptr};
   Event::FileEventPtr file_event_;
-  absl::string_view protocol_;
+  // Keeps how far the peeked data was classified across read events.
+  HttpClassifier classifier_;
+  HttpClassifier::Result protocol_{HttpClassifier::Result::NeedMoreData};
 
   // Use static thread_local to avoid allocating buffer over and over again.
   static thread_local uint8_t buf_[Config::MAX_INSPECT_SIZE];
@@ -1,6 +1,5 @@
 #include "extensions/filters/listener/proxy_protocol/proxy_protocol.h"
 
-#include <sys/ioctl.h>
 #include <unistd.h>
 
 #include <algorithm>
@@ -18,10 +17,13 @@
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
+#include "common/common/hex.h"
 #include "common/common/utility.h"
 #include "common/network/address_impl.h"
 #include "common/network/utility.h"
 
+#include "extensions/filters/listener/well_known_names.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace ListenerFilters {
@@ -53,15 +55,52 @@ void Filter::onRead() {
   }
 }
 
+thread_local char Filter::buf_[MAX_PROXY_PROTO_LEN_V2];
+
 void Filter::onReadWorker() {
   Network::ConnectionSocket& socket = cb_->socket();
+  const int fd = socket.ioHandle().fd();
+  auto& os_syscalls = Api::OsSysCallsSingleton::get();
+
+  size_t header_len = 0;
+  while (true) {
+    const Api::SysCallSizeResult result = os_syscalls.recv(fd, buf_, peek_len_, MSG_PEEK);
+    if (result.rc_ < 0 && result.errno_ == EAGAIN) {
+      return;
+    }
+    if (result.rc_ < 1) {
+      throw EnvoyException("failed to read proxy protocol (no bytes read)");
+    }
+    const size_t nread = result.rc_;
 
-  if ((!proxy_protocol_header_.has_value() && !readProxyHeader(socket.ioHandle().fd())) ||
-      (proxy_protocol_header_.has_value() && !parseExtensions(socket.ioHandle().fd()))) {
-    // We return if a) we do not yet have the header, or b) we have the header but not yet all
-    // the extension data. In both cases we'll be called again when the socket is ready to read
-    // and pick up where we left off.
-    return;
+    header_len = headerLength(buf_, nread);
+    if (header_len == 0) {
+      // We'll be called again when the socket is ready to read, and peek at the header again.
+      return;
+    }
+    if (header_len <= nread) {
+      break;
+    }
+    // A V2 header larger than what was peeked. It is peeked whole right away only if it may all
+    // be there already.
+    const bool peek_again = nread == peek_len_;
+    peek_len_ = header_len;
+    if (!peek_again) {
+      return;
+    }
+  }
+
+  if (header_version_ == V1) {
+    parseV1Header(buf_, header_len);
+  } else {
+    parseV2Header(buf_);
+  }
+
+  // Consume exactly the header, leaving the data after it to the connection. It was peeked
+  // already, so this can neither block nor come up short.
+  const Api::SysCallSizeResult read_result = os_syscalls.recv(fd, buf_, header_len, 0);
+  if (read_result.rc_ != ssize_t(header_len)) {
+    throw EnvoyException("failed to read proxy protocol (remote closed)");
   }
 
   if (proxy_protocol_header_.has_value() && !proxy_protocol_header_.value().local_command_) {
@@ -87,6 +126,13 @@ void Filter::onReadWorker() {
       socket.restoreLocalAddress(proxy_protocol_header_.value().local_address_);
     }
     socket.setRemoteAddress(proxy_protocol_header_.value().remote_address_);
+
+    // The TLVs of local commands are ignored, as their addresses are.
+    const size_t extensions_len = proxy_protocol_header_.value().extensions_length_;
+    if (extensions_len > 0) {
+      parseTlvs(reinterpret_cast<const uint8_t*>(buf_) + header_len - extensions_len,
+                extensions_len);
+    }
   }
 
   // Release the file event so that we do not interfere with the connection read events.
@@ -94,7 +140,7 @@ void Filter::onReadWorker() {
   cb_->continueFilterChain(true);
 }
 
-size_t Filter::lenV2Address(char* buf) {
+size_t Filter::lenV2Address(const char* buf) {
   const uint8_t proto_family = buf[PROXY_PROTO_V2_SIGNATURE_LEN + 1];
   const int ver_cmd = buf[PROXY_PROTO_V2_SIGNATURE_LEN];
   size_t len;
@@ -117,7 +163,7 @@ size_t Filter::lenV2Address(char* buf) {
   return len;
 }
 
-void Filter::parseV2Header(char* buf) {
+void Filter::parseV2Header(const char* buf) {
   const int ver_cmd = buf[PROXY_PROTO_V2_SIGNATURE_LEN];
   uint8_t upper_byte = buf[PROXY_PROTO_V2_HEADER_LEN - 2];
   uint8_t lower_byte = buf[PROXY_PROTO_V2_HEADER_LEN - 1];
@@ -143,8 +189,8 @@ void Filter::parseV2Header(char* buf) {
           uint16_t src_port;
           uint16_t dst_port;
         });
-        pp_ipv4_addr* v4;
-        v4 = reinterpret_cast<pp_ipv4_addr*>(&buf[PROXY_PROTO_V2_HEADER_LEN]);
+        const pp_ipv4_addr* v4;
+        v4 = reinterpret_cast<const pp_ipv4_addr*>(&buf[PROXY_PROTO_V2_HEADER_LEN]);
         sockaddr_in ra4, la4;
         memset(&ra4, 0, sizeof(ra4));
         memset(&la4, 0, sizeof(la4));
@@ -167,8 +213,8 @@ void Filter::parseV2Header(char* buf) {
           uint16_t src_port;
           uint16_t dst_port;
         });
-        pp_ipv6_addr* v6;
-        v6 = reinterpret_cast<pp_ipv6_addr*>(&buf[PROXY_PROTO_V2_HEADER_LEN]);
+        const pp_ipv6_addr* v6;
+        v6 = reinterpret_cast<const pp_ipv6_addr*>(&buf[PROXY_PROTO_V2_HEADER_LEN]);
         sockaddr_in6 ra6, la6;
         memset(&ra6, 0, sizeof(ra6));
         memset(&la6, 0, sizeof(la6));
@@ -191,7 +237,7 @@ void Filter::parseV2Header(char* buf) {
   throw EnvoyException("Unsupported command or address family or transport");
 }
 
-void Filter::parseV1Header(char* buf, size_t len) {
+void Filter::parseV1Header(const char* buf, size_t len) {
   std::string proxy_line;
   proxy_line.assign(buf, len);
   const auto trimmed_proxy_line = StringUtil::rtrim(proxy_line);
@@ -234,144 +280,138 @@ void Filter::parseV1Header(char* buf, size_t len) {
   }
 }
 
-bool Filter::parseExtensions(int fd) {
-  // If we ever implement extensions elsewhere, be sure to
-  // continue to skip and ignore those for LOCAL.
-  while (proxy_protocol_header_.value().extensions_length_) {
-    // buf_ is no longer in use so we re-use it to read/discard
-    int bytes_avail;
-    auto& os_syscalls = Api::OsSysCallsSingleton::get();
-    if (os_syscalls.ioctl(fd, FIONREAD, &bytes_avail).rc_ < 0) {
-      throw EnvoyException("failed to read proxy protocol (no bytes avail)");
+void Filter::parseTlvs(const uint8_t* buf, size_t len) {
+  ProtobufWkt::Struct metadata;
+  auto& fields = *metadata.mutable_fields();
+  while (len >= PROXY_PROTO_V2_TLV_HEADER_LEN) {
+    const uint8_t type = buf[0];
+    const size_t value_len = (buf[1] << 8) + buf[2];
+    if (value_len > len - PROXY_PROTO_V2_TLV_HEADER_LEN) {
+      ENVOY_LOG(debug, "proxy_protocol: malformed TLV, skipping the remaining ones");
+      break;
     }
-    if (bytes_avail == 0) {
-      return false;
-    }
-    bytes_avail = std::min(size_t(bytes_avail), sizeof(buf_));
-    bytes_avail = std::min(size_t(bytes_avail), proxy_protocol_header_.value().extensions_length_);
-    const Api::SysCallSizeResult recv_result = os_syscalls.recv(fd, buf_, bytes_avail, 0);
-    if (recv_result.rc_ != bytes_avail) {
-      throw EnvoyException("failed to read proxy protocol extension");
+    const uint8_t* value = buf + PROXY_PROTO_V2_TLV_HEADER_LEN;
+    const std::string value_str(reinterpret_cast<const char*>(value), value_len);
+
+    switch (type) {
+    case PROXY_PROTO_V2_TLV_ALPN:
+      fields["alpn"].set_string_value(value_str);
+      break;
+    case PROXY_PROTO_V2_TLV_AUTHORITY:
+      fields["authority"].set_string_value(value_str);
+      break;
+    case PROXY_PROTO_V2_TLV_UNIQUE_ID:
+      // Opaque bytes.
+      fields["unique_id"].set_string_value(Hex::encode(value, value_len));
+      break;
+    case PROXY_PROTO_V2_TLV_SSL:
+      if (value_len >= PROXY_PROTO_V2_SSL_HEADER_LEN) {
+        parseSslTlv(value, value_len, *fields["ssl"].mutable_struct_value());
+      }
+      break;
+    case PROXY_PROTO_V2_TLV_NETNS:
+      fields["netns"].set_string_value(value_str);
+      break;
+    case PROXY_PROTO_V2_TLV_AWS:
+      if (value_len > 0 && value[0] == PROXY_PROTO_V2_TLV_AWS_VPCE_ID) {
+        fields["aws_vpce_id"].set_string_value(value_str.substr(1));
+      }
+      break;
+    default:
+      break;
     }
-    proxy_protocol_header_.value().extensions_length_ -= recv_result.rc_;
+
+    buf += PROXY_PROTO_V2_TLV_HEADER_LEN + value_len;
+    len -= PROXY_PROTO_V2_TLV_HEADER_LEN + value_len;
   }
-  return true;
-}
 
-bool Filter::readProxyHeader(int fd) {
-  while (buf_off_ < MAX_PROXY_PROTO_LEN_V2) {
-    int bytes_avail;
-    auto& os_syscalls = Api::OsSysCallsSingleton::get();
+  if (!fields.empty()) {
+    cb_->setDynamicMetadata(ListenerFilterNames::get().ProxyProtocol, metadata);
+  }
+}
 
-    if (os_syscalls.ioctl(fd, FIONREAD, &bytes_avail).rc_ < 0) {
-      throw EnvoyException("failed to read proxy protocol (no bytes avail)");
+void Filter::parseSslTlv(const uint8_t* buf, size_t len, ProtobufWkt::Struct& metadata) {
+  ASSERT(len >= PROXY_PROTO_V2_SSL_HEADER_LEN);
+  auto& fields = *metadata.mutable_fields();
+  fields["client_ssl"].set_bool_value(buf[0] & PROXY_PROTO_V2_CLIENT_SSL);
+  fields["client_cert_conn"].set_bool_value(buf[0] & PROXY_PROTO_V2_CLIENT_CERT_CONN);
+  fields["client_cert_sess"].set_bool_value(buf[0] & PROXY_PROTO_V2_CLIENT_CERT_SESS);
+  // The verify field is zero if the client presented a certificate which was verified.
+  fields["verified"].set_bool_value((buf[1] | buf[2] | buf[3] | buf[4]) == 0);
+
+  buf += PROXY_PROTO_V2_SSL_HEADER_LEN;
+  len -= PROXY_PROTO_V2_SSL_HEADER_LEN;
+  while (len >= PROXY_PROTO_V2_TLV_HEADER_LEN) {
+    const uint8_t type = buf[0];
+    const size_t value_len = (buf[1] << 8) + buf[2];
+    if (value_len > len - PROXY_PROTO_V2_TLV_HEADER_LEN) {
+      break;
     }
-
-    if (bytes_avail == 0) {
-      return false;
+    const std::string value(reinterpret_cast<const char*>(buf + PROXY_PROTO_V2_TLV_HEADER_LEN),
+                            value_len);
+
+    switch (type) {
+    case PROXY_PROTO_V2_TLV_SSL_VERSION:
+      fields["version"].set_string_value(value);
+      break;
+    case PROXY_PROTO_V2_TLV_SSL_CN:
+      fields["cn"].set_string_value(value);
+      break;
+    case PROXY_PROTO_V2_TLV_SSL_CIPHER:
+      fields["cipher"].set_string_value(value);
+      break;
+    case PROXY_PROTO_V2_TLV_SSL_SIG_ALG:
+      fields["sig_alg"].set_string_value(value);
+      break;
+    case PROXY_PROTO_V2_TLV_SSL_KEY_ALG:
+      fields["key_alg"].set_string_value(value);
+      break;
+    default:
+      break;
     }
 
-    bytes_avail = std::min(size_t(bytes_avail), MAX_PROXY_PROTO_LEN_V2 - buf_off_);
-
-    const Api::SysCallSizeResult result =
-        os_syscalls.recv(fd, buf_ + buf_off_, bytes_avail, MSG_PEEK);
-    ssize_t nread = result.rc_;
+    buf += PROXY_PROTO_V2_TLV_HEADER_LEN + value_len;
+    len -= PROXY_PROTO_V2_TLV_HEADER_LEN + value_len;
+  }
+}
 
-    if (nread < 1) {
-      throw EnvoyException("failed to read proxy protocol (no bytes read)");
+size_t Filter::headerLength(const char* buf, size_t len) {
+  if (!memcmp(buf, PROXY_PROTO_V2_SIGNATURE,
+              std::min<size_t>(len, PROXY_PROTO_V2_SIGNATURE_LEN))) {
+    if (len < PROXY_PROTO_V2_HEADER_LEN) {
+      return 0;
     }
-
-    if (buf_off_ + nread >= PROXY_PROTO_V2_HEADER_LEN) {
-      const char* sig = PROXY_PROTO_V2_SIGNATURE;
-      if (!memcmp(buf_, sig, PROXY_PROTO_V2_SIGNATURE_LEN)) {
-        header_version_ = V2;
-      } else if (memcmp(buf_, PROXY_PROTO_V1_SIGNATURE, PROXY_PROTO_V1_SIGNATURE_LEN)) {
-        // It is not v2, and can't be v1, so no sense hanging around: it is invalid
-        throw EnvoyException("failed to read proxy protocol (exceed max v1 header len)");
-      }
+    const int ver_cmd = buf[PROXY_PROTO_V2_SIGNATURE_LEN];
+    if (((ver_cmd & 0xf0) >> 4) != PROXY_PROTO_V2_VERSION) {
+      throw EnvoyException("Unsupported V2 proxy protocol version");
     }
+    const uint8_t upper_byte = buf[PROXY_PROTO_V2_HEADER_LEN - 2];
+    const uint8_t lower_byte = buf[PROXY_PROTO_V2_HEADER_LEN - 1];
+    const size_t hdr_addr_len = (upper_byte << 8) + lower_byte;
+    if (hdr_addr_len < lenV2Address(buf)) {
+      throw EnvoyException("failed to read proxy protocol (insufficient data)");
+    }
+    header_version_ = V2;
+    return PROXY_PROTO_V2_HEADER_LEN + hdr_addr_len;
+  }
 
-    if (header_version_ == V2) {
-      const int ver_cmd = buf_[PROXY_PROTO_V2_SIGNATURE_LEN];
-      if (((ver_cmd & 0xf0) >> 4) != PROXY_PROTO_V2_VERSION) {
-        throw EnvoyException("Unsupported V2 proxy protocol version");
-      }
-      if (buf_off_ < PROXY_PROTO_V2_HEADER_LEN) {
-        ssize_t exp = PROXY_PROTO_V2_HEADER_LEN - buf_off_;
-        const Api::SysCallSizeResult read_result = os_syscalls.recv(fd, buf_ + buf_off_, exp, 0);
-        if (read_result.rc_ != exp) {
-          throw EnvoyException("failed to read proxy protocol (remote closed)");
-        }
-        buf_off_ += read_result.rc_;
-        nread -= read_result.rc_;
-      }
-      ssize_t addr_len = lenV2Address(buf_);
-      uint8_t upper_byte = buf_[PROXY_PROTO_V2_HEADER_LEN - 2];
-      uint8_t lower_byte = buf_[PROXY_PROTO_V2_HEADER_LEN - 1];
-      ssize_t hdr_addr_len = (upper_byte << 8) + lower_byte;
-      if (hdr_addr_len < addr_len) {
-        throw EnvoyException("failed to read proxy protocol (insufficient data)");
-      }
-      if (ssize_t(buf_off_) + nread >= PROXY_PROTO_V2_HEADER_LEN + addr_len) {
-        ssize_t missing = (PROXY_PROTO_V2_HEADER_LEN + addr_len) - buf_off_;
-        const Api::SysCallSizeResult read_result =
-            os_syscalls.recv(fd, buf_ + buf_off_, missing, 0);
-        if (read_result.rc_ != missing) {
-          throw EnvoyException("failed to read proxy protocol (remote closed)");
-        }
-        buf_off_ += read_result.rc_;
-        parseV2Header(buf_);
-        // The TLV remain, they are read/discard in parseExtensions() which is called from the
-        // parent (if needed).
-        return true;
-      } else {
-        const Api::SysCallSizeResult result = os_syscalls.recv(fd, buf_ + buf_off_, nread, 0);
-        nread = result.rc_;
-        if (nread < 0) {
-          throw EnvoyException("failed to read proxy protocol (remote closed)");
-        }
-        buf_off_ += nread;
-      }
-    } else {
-      // continue searching buf_ from where we left off
-      for (; search_index_ < buf_off_ + nread; search_index_++) {
-        if (buf_[search_index_] == '\n' && buf_[search_index_ - 1] == '\r') {
-          if (search_index_ == 1) {
-            // This could be the binary protocol. It cannot be the ascii protocol
-            header_version_ = InProgress;
-          } else {
-            header_version_ = V1;
-            search_index_++;
-          }
-          break;
-        }
-      }
-
-      // If we bailed on the first char, we might be v2, but are for sure not v1. Thus we
-      // can read up to min(PROXY_PROTO_V2_HEADER_LEN, bytes_avail). If we bailed after first
-      // char, but before we hit \r\n, read up to search_index_. We're asking only for
-      // bytes we've already seen so there should be no block or fail
-      size_t ntoread;
-      if (header_version_ == InProgress) {
-        ntoread = bytes_avail;
-      } else {
-        ntoread = search_index_ - buf_off_;
-      }
-
-      const Api::SysCallSizeResult result = os_syscalls.recv(fd, buf_ + buf_off_, ntoread, 0);
-      nread = result.rc_;
-      ASSERT(size_t(nread) == ntoread);
-
-      buf_off_ += nread;
+  if (memcmp(buf, PROXY_PROTO_V1_SIGNATURE, std::min<size_t>(len, PROXY_PROTO_V1_SIGNATURE_LEN))) {
+    // It is not v2, and can't be v1, so no sense hanging around: it is invalid
+    throw EnvoyException("failed to read proxy protocol");
+  }
 
-      if (header_version_ == V1) {
-        parseV1Header(buf_, buf_off_);
-        return true;
-      }
+  // continue searching from where we left off
+  const size_t search_len = std::min(len, MAX_PROXY_PROTO_LEN_V1);
+  for (; search_index_ < search_len; search_index_++) {
+    if (buf[search_index_] == '\n' && buf[search_index_ - 1] == '\r') {
+      header_version_ = V1;
+      return search_index_ + 1;
     }
   }
-
-  throw EnvoyException("failed to read proxy protocol (exceed max v2 header len)");
+  if (len >= MAX_PROXY_PROTO_LEN_V1) {
+    throw EnvoyException("failed to read proxy protocol (exceed max v1 header len)");
+  }
+  return 0;
 }
 
 } // namespace ProxyProtocol
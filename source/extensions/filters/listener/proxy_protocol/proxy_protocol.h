@@ -6,6 +6,7 @@
 #include "envoy/stats/stats_macros.h"
 
 #include "common/common/logger.h"
+#include "common/protobuf/protobuf.h"
 
 #include "proxy_protocol_header.h"
 
@@ -41,7 +42,7 @@ public:
 
 using ConfigSharedPtr = std::shared_ptr<Config>;
 
-enum ProxyProtocolVersion { Unknown = -1, InProgress = -2, V1 = 1, V2 = 2 };
+enum ProxyProtocolVersion { Unknown = -1, V1 = 1, V2 = 2 };
 
 /**
  * Implementation the PROXY Protocol listener filter
@@ -51,7 +52,11 @@ enum ProxyProtocolVersion { Unknown = -1, InProgress = -2, V1 = 1, V2 = 2 };
  * and Proxy Protocol v2 (TCP/UDP, v4/v6).
  *
  * Non INET (AF_UNIX) address family in v2 is not supported, will throw an error.
- * Extensions (TLV) in v2 are skipped over.
+ * The well-known extensions (TLV) in v2 are set as the dynamic metadata of the connection, under
+ * the filter name, the others are skipped over.
+ *
+ * The header is peeked, and only consumed once it has fully arrived, so that a connection usually
+ * costs a single peek and a single read of exactly the header.
  */
 class Filter : public Network::ListenerFilter, Logger::Loggable<Logger::Id::filter> {
 public:
@@ -61,46 +66,51 @@ public:
   Network::FilterStatus onAccept(Network::ListenerFilterCallbacks& cb) override;
 
 private:
-  static const size_t MAX_PROXY_PROTO_LEN_V2 =
-      PROXY_PROTO_V2_HEADER_LEN + PROXY_PROTO_V2_ADDR_LEN_UNIX;
+  static const size_t MAX_PROXY_PROTO_LEN_V2 = PROXY_PROTO_V2_MAX_LEN;
   static const size_t MAX_PROXY_PROTO_LEN_V1 = 108;
+  // Enough for v1 headers, and v2 headers with a few TLVs. Larger v2 headers are peeked again
+  // with their full length.
+  static const size_t INITIAL_PEEK_LEN = 256;
 
   void onRead();
   void onReadWorker();
 
   /**
-   * Helper function that attempts to read the proxy header
-   * (delimited by \r\n if V1 format, or with length if V2)
-   * throws EnvoyException on any socket errors.
-   * @return bool true valid header, false if more data is needed.
+   * Determine the length of the header from the part of it peeked so far, with \r\n delimiting
+   * V1 headers and V2 headers carrying their length. Throws EnvoyException if the data can not be a
+   * valid header.
+   * @return size_t the length of the header, or 0 if more data is needed to tell.
    */
-  bool readProxyHeader(int fd);
+  size_t headerLength(const char* buf, size_t len);
 
   /**
-   * Parse (and discard unknown) header extensions (until hdr.extensions_length == 0)
+   * Given a char * & len, parse the header as per spec
    */
-  bool parseExtensions(int fd);
+  void parseV1Header(const char* buf, size_t len);
+  void parseV2Header(const char* buf);
+  size_t lenV2Address(const char* buf);
 
   /**
-   * Given a char * & len, parse the header as per spec
+   * Parse the TLVs of a V2 header into the dynamic metadata of the connection. Parsing stops at the
+   * first malformed TLV, as the TLVs used to be skipped over without being checked.
    */
-  void parseV1Header(char* buf, size_t len);
-  void parseV2Header(char* buf);
-  size_t lenV2Address(char* buf);
+  void parseTlvs(const uint8_t* buf, size_t len);
+  static void parseSslTlv(const uint8_t* buf, size_t len, ProtobufWkt::Struct& metadata);
 
   Network::ListenerFilterCallbacks* cb_{};
   Event::FileEventPtr file_event_;
 
-  // The offset in buf_ that has been fully read
-  size_t buf_off_{};
+  // How much to peek at, grown once a V2 header is known to be larger than INITIAL_PEEK_LEN.
+  size_t peek_len_{INITIAL_PEEK_LEN};
 
-  // The index in buf_ where the search for '\r\n' should continue from
+  // The index in the peeked data where the search for '\r\n' should continue from
   size_t search_index_{1};
 
   ProxyProtocolVersion header_version_{Unknown};
 
-  // Stores the portion of the first line that has been read so far.
-  char buf_[MAX_PROXY_PROTO_LEN_V2];
+  // The peeked data. Nothing is kept in it across read events, so it is shared by the filters of
+  // the thread.
+  static thread_local char buf_[MAX_PROXY_PROTO_LEN_V2];
 
   ConfigSharedPtr config_;
 
@@ -51,6 +51,33 @@ constexpr uint32_t PROXY_PROTO_V2_ADDR_LEN_UNIX = 216;
 constexpr uint8_t PROXY_PROTO_V2_TRANSPORT_STREAM = 0x1;
 constexpr uint8_t PROXY_PROTO_V2_TRANSPORT_DGRAM = 0x2;
 
+// The largest header: the address length field is 16 bits wide, and covers the TLVs.
+constexpr uint32_t PROXY_PROTO_V2_MAX_LEN = PROXY_PROTO_V2_HEADER_LEN + 65535;
+
+// TLVs (type-length-value vectors) following the addresses: a type, a 16 bit length, the value.
+constexpr uint32_t PROXY_PROTO_V2_TLV_HEADER_LEN = 3;
+constexpr uint8_t PROXY_PROTO_V2_TLV_ALPN = 0x01;
+constexpr uint8_t PROXY_PROTO_V2_TLV_AUTHORITY = 0x02;
+constexpr uint8_t PROXY_PROTO_V2_TLV_UNIQUE_ID = 0x05;
+constexpr uint8_t PROXY_PROTO_V2_TLV_SSL = 0x20;
+constexpr uint8_t PROXY_PROTO_V2_TLV_SSL_VERSION = 0x21;
+constexpr uint8_t PROXY_PROTO_V2_TLV_SSL_CN = 0x22;
+constexpr uint8_t PROXY_PROTO_V2_TLV_SSL_CIPHER = 0x23;
+constexpr uint8_t PROXY_PROTO_V2_TLV_SSL_SIG_ALG = 0x24;
+constexpr uint8_t PROXY_PROTO_V2_TLV_SSL_KEY_ALG = 0x25;
+constexpr uint8_t PROXY_PROTO_V2_TLV_NETNS = 0x30;
+// AWS specific TLV, see
+// https://docs.aws.amazon.com/elasticloadbalancing/latest/network/load-balancer-target-groups.html
+constexpr uint8_t PROXY_PROTO_V2_TLV_AWS = 0xEA;
+constexpr uint8_t PROXY_PROTO_V2_TLV_AWS_VPCE_ID = 0x01;
+
+// The SSL TLV value starts with a client bit field and a 32 bit verify result, followed by
+// sub-TLVs.
+constexpr uint32_t PROXY_PROTO_V2_SSL_HEADER_LEN = 5;
+constexpr uint8_t PROXY_PROTO_V2_CLIENT_SSL = 0x01;
+constexpr uint8_t PROXY_PROTO_V2_CLIENT_CERT_CONN = 0x02;
+constexpr uint8_t PROXY_PROTO_V2_CLIENT_CERT_SESS = 0x04;
+
 } // namespace ProxyProtocol
 } // namespace ListenerFilters
 } // namespace Extensions
@@ -0,0 +1,159 @@
+#include "extensions/filters/listener/tls_inspector/client_hello_parser.h"
+
+#include <array>
+
+#include "openssl/bytestring.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace TlsInspector {
+
+namespace {
+
+absl::string_view toStringView(const CBS& cbs) {
+  return {reinterpret_cast<const char*>(CBS_data(&cbs)), CBS_len(&cbs)};
+}
+
+// The same checks as BoringSSL, which only accepts a single host name.
+bool parseServerName(CBS extension, ClientHello& client_hello) {
+  CBS list, host_name;
+  uint8_t name_type;
+  if (!CBS_get_u16_length_prefixed(&extension, &list) || !CBS_get_u8(&list, &name_type) ||
+      !CBS_get_u16_length_prefixed(&list, &host_name) || CBS_len(&list) != 0 ||
+      CBS_len(&extension) != 0) {
+    return false;
+  }
+  if (name_type != TLSEXT_NAMETYPE_host_name || CBS_len(&host_name) == 0 ||
+      CBS_len(&host_name) > TLSEXT_MAXLEN_host_name || CBS_contains_zero_byte(&host_name)) {
+    return false;
+  }
+  client_hello.server_name_ = toStringView(host_name);
+  return true;
+}
+
+bool parseAlpn(const CBS& extension, ClientHello& client_hello) {
+  CBS wire = extension;
+  CBS list;
+  if (!CBS_get_u16_length_prefixed(&wire, &list) || CBS_len(&wire) != 0 || CBS_len(&list) == 0) {
+    return false;
+  }
+  while (CBS_len(&list) > 0) {
+    CBS name;
+    if (!CBS_get_u8_length_prefixed(&list, &name) || CBS_len(&name) == 0) {
+      return false;
+    }
+  }
+  client_hello.alpn_ = toStringView(extension);
+  return true;
+}
+
+bool parseExtensions(CBS extensions, ClientHello& client_hello) {
+  std::array<uint16_t, ClientHelloParser::MAX_EXTENSIONS> seen;
+  size_t num_seen = 0;
+  while (CBS_len(&extensions) > 0) {
+    uint16_t type;
+    CBS extension;
+    if (!CBS_get_u16(&extensions, &type) ||
+        !CBS_get_u16_length_prefixed(&extensions, &extension)) {
+      return false;
+    }
+    // BoringSSL rejects the ClientHellos with duplicate extensions, so must the parser.
+    if (num_seen == seen.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < num_seen; i++) {
+      if (seen[i] == type) {
+        return false;
+      }
+    }
+    seen[num_seen++] = type;
+
+    if (type == TLSEXT_TYPE_server_name) {
+      if (!parseServerName(extension, client_hello)) {
+        return false;
+      }
+    } else if (type == TLSEXT_TYPE_application_layer_protocol_negotiation) {
+      if (!parseAlpn(extension, client_hello)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool parseHandshake(CBS record, ClientHello& client_hello) {
+  uint8_t type;
+  CBS body;
+  // A ClientHello fragmented across records, or followed by other messages, is left to BoringSSL.
+  if (!CBS_get_u8(&record, &type) || type != SSL3_MT_CLIENT_HELLO ||
+      !CBS_get_u24_length_prefixed(&record, &body) || CBS_len(&record) != 0) {
+    return false;
+  }
+
+  uint16_t version;
+  CBS session_id, cipher_suites, compression_methods;
+  if (!CBS_get_u16(&body, &version) || version < TLS1_VERSION ||
+      !CBS_skip(&body, SSL3_RANDOM_SIZE) || !CBS_get_u8_length_prefixed(&body, &session_id) ||
+      CBS_len(&session_id) > SSL_MAX_SSL_SESSION_ID_LENGTH ||
+      !CBS_get_u16_length_prefixed(&body, &cipher_suites) || CBS_len(&cipher_suites) == 0 ||
+      CBS_len(&cipher_suites) % 2 != 0 ||
+      !CBS_get_u8_length_prefixed(&body, &compression_methods) ||
+      CBS_len(&compression_methods) == 0) {
+    return false;
+  }
+
+  client_hello = ClientHello{};
+  if (CBS_len(&body) == 0) {
+    // No extensions.
+    return true;
+  }
+  CBS extensions;
+  if (!CBS_get_u16_length_prefixed(&body, &extensions) || CBS_len(&body) != 0) {
+    return false;
+  }
+  return parseExtensions(extensions, client_hello);
+}
+
+} // namespace
+
+ClientHelloParser::Result ClientHelloParser::parse(const uint8_t* data, size_t len,
+                                                   ClientHello& client_hello) {
+  CBS input;
+  CBS_init(&input, data, len);
+
+  // Reject the data which can not be a TLS record as soon as possible, e.g. the SSLv2-compatible
+  // ClientHellos BoringSSL rejects anyway.
+  uint8_t content_type;
+  if (!CBS_get_u8(&input, &content_type)) {
+    return Result::Incomplete;
+  }
+  if (content_type != SSL3_RT_HANDSHAKE) {
+    return Result::Unsupported;
+  }
+  uint8_t major_version;
+  if (!CBS_get_u8(&input, &major_version)) {
+    return Result::Incomplete;
+  }
+  if (major_version != 3) {
+    return Result::Unsupported;
+  }
+  uint16_t record_len;
+  if (!CBS_skip(&input, 1) || !CBS_get_u16(&input, &record_len)) {
+    return Result::Incomplete;
+  }
+  if (record_len > SSL3_RT_MAX_PLAIN_LENGTH) {
+    return Result::Unsupported;
+  }
+  CBS record;
+  if (!CBS_get_bytes(&input, &record, record_len)) {
+    return Result::Incomplete;
+  }
+  return parseHandshake(record, client_hello) ? Result::Complete : Result::Unsupported;
+}
+
+} // namespace TlsInspector
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
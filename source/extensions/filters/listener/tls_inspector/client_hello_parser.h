@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace TlsInspector {
+
+/**
+ * The fields of a ClientHello the TLS inspector is interested in. They are views of the parsed
+ * data, which must outlive them.
+ */
+struct ClientHello {
+  // The host name of the Server Name Indication, empty if there is none.
+  absl::string_view server_name_;
+  // The wire-format data of the Application-Layer Protocol Negotiation extension, i.e. the
+  // 16-bit length-prefixed protocol name list, empty if there is none.
+  absl::string_view alpn_;
+};
+
+/**
+ * A parser of the ClientHellos sent in a single TLS record, extracting their SNI and ALPN in one
+ * pass without allocating. Anything it does not recognize or deems malformed is reported as
+ * unsupported, for the caller to fall back to BoringSSL, which handles the rarer forms such as
+ * ClientHellos spanning several records and reports the errors.
+ */
+class ClientHelloParser {
+public:
+  enum class Result {
+    // The ClientHello was parsed.
+    Complete,
+    // The data is a valid prefix of a ClientHello; more is needed.
+    Incomplete,
+    // The data is not a ClientHello the parser handles.
+    Unsupported,
+  };
+
+  /**
+   * Parse a ClientHello from the start of a TLS connection.
+   * @param data supplies the data received so far.
+   * @param len supplies the length of the data.
+   * @param client_hello receives the fields of the ClientHello, if it is complete.
+   * @return the outcome of the parsing.
+   */
+  static Result parse(const uint8_t* data, size_t len, ClientHello& client_hello);
+
+  // The most extensions of a ClientHello the parser checks for duplicates.
+  static constexpr size_t MAX_EXTENSIONS = 64;
+};
+
+} // namespace TlsInspector
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
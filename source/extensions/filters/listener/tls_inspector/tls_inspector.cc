@@ -14,6 +14,7 @@
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
 
+#include "extensions/filters/listener/tls_inspector/client_hello_parser.h"
 #include "extensions/transport_sockets/well_known_names.h"
 
 #include "openssl/ssl.h"
@@ -61,11 +62,8 @@ bssl::UniquePtr<SSL> Config::newSsl() { return bssl::UniquePtr<SSL>{SSL_new(ssl_
 
 thread_local uint8_t Filter::buf_[Config::TLS_MAX_CLIENT_HELLO];
 
-Filter::Filter(const ConfigSharedPtr config) : config_(config), ssl_(config_->newSsl()) {
+Filter::Filter(const ConfigSharedPtr config) : config_(config) {
   RELEASE_ASSERT(sizeof(buf_) >= config_->maxClientHelloSize(), "");
-
-  SSL_set_app_data(ssl_.get(), this);
-  SSL_set_accept_state(ssl_.get());
 }
 
 Network::FilterStatus Filter::onAccept(Network::ListenerFilterCallbacks& cb) {
@@ -150,12 +148,57 @@ void Filter::onRead() {
 
   // Because we're doing a MSG_PEEK, data we've seen before gets returned every time, so
   // skip over what we've already processed.
-  if (static_cast<uint64_t>(result.rc_) > read_) {
-    const uint8_t* data = buf_ + read_;
-    const size_t len = result.rc_ - read_;
-    read_ = result.rc_;
-    parseClientHello(data, len);
+  if (static_cast<uint64_t>(result.rc_) <= read_) {
+    return;
   }
+  const uint8_t* data = buf_ + read_;
+  size_t len = result.rc_ - read_;
+  read_ = result.rc_;
+
+  if (ssl_ == nullptr) {
+    // Most ClientHellos are parsed directly, rather than by starting a handshake.
+    ClientHello client_hello;
+    switch (ClientHelloParser::parse(buf_, read_, client_hello)) {
+    case ClientHelloParser::Result::Complete:
+      if (!client_hello.alpn_.empty()) {
+        onALPN(reinterpret_cast<const unsigned char*>(client_hello.alpn_.data()),
+               client_hello.alpn_.size());
+      }
+      onServername(client_hello.server_name_);
+      onClientHelloDone();
+      return;
+    case ClientHelloParser::Result::Incomplete:
+      if (read_ == config_->maxClientHelloSize()) {
+        config_->stats().client_hello_too_large_.inc();
+        done(false);
+      }
+      return;
+    case ClientHelloParser::Result::Unsupported:
+      // Let BoringSSL handle the ClientHello from the start.
+      ssl_ = config_->newSsl();
+      SSL_set_app_data(ssl_.get(), this);
+      SSL_set_accept_state(ssl_.get());
+      data = buf_;
+      len = read_;
+      break;
+    }
+  }
+  parseClientHello(data, len);
+}
+
+void Filter::onClientHelloDone() {
+  if (clienthello_success_) {
+    config_->stats().tls_found_.inc();
+    if (alpn_found_) {
+      config_->stats().alpn_found_.inc();
+    } else {
+      config_->stats().alpn_not_found_.inc();
+    }
+    cb_->socket().setDetectedTransportProtocol(TransportSockets::TransportSocketNames::get().Tls);
+  } else {
+    config_->stats().tls_not_found_.inc();
+  }
+  done(true);
 }
 
 void Filter::done(bool success) {
@@ -189,18 +232,7 @@ void Filter::parseClientHello(const void* data, size_t len) {
     }
     break;
   case SSL_ERROR_SSL:
-    if (clienthello_success_) {
-      config_->stats().tls_found_.inc();
-      if (alpn_found_) {
-        config_->stats().alpn_found_.inc();
-      } else {
-        config_->stats().alpn_not_found_.inc();
-      }
-      cb_->socket().setDetectedTransportProtocol(TransportSockets::TransportSocketNames::get().Tls);
-    } else {
-      config_->stats().tls_not_found_.inc();
-    }
-    done(true);
+    onClientHelloDone();
     break;
   default:
     done(false);
@@ -70,6 +70,7 @@ public:
 private:
   void parseClientHello(const void* data, size_t len);
   void onRead();
+  void onClientHelloDone();
   void done(bool success);
   void onALPN(const unsigned char* data, unsigned int len);
   void onServername(absl::string_view name);
@@ -78,6 +79,7 @@ private:
   Network::ListenerFilterCallbacks* cb_;
   Event::FileEventPtr file_event_;
 
+  // Only created once the ClientHello turns out to be one the ClientHelloParser does not handle.
   bssl::UniquePtr<SSL> ssl_;
   uint64_t read_{0};
   bool alpn_found_{false};
@@ -48,6 +48,16 @@ public:
   int64_t& asInteger();
   int64_t asInteger() const;
 
+  /**
+   * A bulk string may hold its content in a buffer rather than in a string. The buffer is then
+   * shared by the copies of the value and referenced by the buffers the value is encoded to,
+   * rather than copied. Calling asString() copies the content into a string and releases the
+   * buffer.
+   * @return the buffer holding the content of a bulk string, or nullptr if it is held in a string.
+   */
+  const std::shared_ptr<const Buffer::Instance>& bulkStringBuffer() const;
+  void bulkStringBuffer(std::shared_ptr<const Buffer::Instance> buffer);
+
   /**
    * Get/set the type of the RespValue. A RespValue can only be a single type at a time. Each time
    * type() is called the type is changed and then the type specific as* methods can be used.
@@ -58,11 +68,16 @@ public:
 private:
   union {
     std::vector<RespValue> array_;
-    std::string string_;
+    // Mutable so that the content of bulk_string_buffer_ can be moved to it on a const access.
+    mutable std::string string_;
     int64_t integer_;
   };
 
   void cleanup();
+  void moveBufferToString() const;
+
+  // Set only for bulk strings whose content is held in a buffer, string_ being empty.
+  mutable std::shared_ptr<const Buffer::Instance> bulk_string_buffer_;
 
   RespType type_{};
 };
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
 #include "common/common/stack_array.h"
@@ -54,15 +55,36 @@ const std::vector<RespValue>& RespValue::asArray() const {
 std::string& RespValue::asString() {
   ASSERT(type_ == RespType::BulkString || type_ == RespType::Error ||
          type_ == RespType::SimpleString);
+  moveBufferToString();
   return string_;
 }
 
 const std::string& RespValue::asString() const {
   ASSERT(type_ == RespType::BulkString || type_ == RespType::Error ||
          type_ == RespType::SimpleString);
+  moveBufferToString();
   return string_;
 }
 
+const std::shared_ptr<const Buffer::Instance>& RespValue::bulkStringBuffer() const {
+  ASSERT(type_ == RespType::BulkString);
+  return bulk_string_buffer_;
+}
+
+void RespValue::bulkStringBuffer(std::shared_ptr<const Buffer::Instance> buffer) {
+  ASSERT(type_ == RespType::BulkString);
+  string_.clear();
+  bulk_string_buffer_ = std::move(buffer);
+}
+
+void RespValue::moveBufferToString() const {
+  if (bulk_string_buffer_ != nullptr) {
+    // The buffer may still be referenced by other values or by encoded data, so it is copied.
+    string_ = bulk_string_buffer_->toString();
+    bulk_string_buffer_.reset();
+  }
+}
+
 int64_t& RespValue::asInteger() {
   ASSERT(type_ == RespType::Integer);
   return integer_;
@@ -84,6 +106,7 @@ void RespValue::cleanup() {
   case RespType::BulkString:
   case RespType::Error: {
     string_.~basic_string<char>();
+    bulk_string_buffer_.reset();
     break;
   }
   case RespType::Null:
@@ -126,7 +149,9 @@ RespValue::RespValue(const RespValue& other) : type_(RespType::Null) {
   case RespType::SimpleString:
   case RespType::BulkString:
   case RespType::Error: {
-    this->asString() = other.asString();
+    // A buffer is shared rather than copied.
+    string_ = other.string_;
+    bulk_string_buffer_ = other.bulk_string_buffer_;
     break;
   }
   case RespType::Integer: {
@@ -151,7 +176,8 @@ RespValue& RespValue::operator=(const RespValue& other) {
   case RespType::SimpleString:
   case RespType::BulkString:
   case RespType::Error: {
-    this->asString() = other.asString();
+    string_ = other.string_;
+    bulk_string_buffer_ = other.bulk_string_buffer_;
     break;
   }
   case RespType::Integer: {
@@ -194,17 +220,40 @@ bool RespValue::operator==(const RespValue& other) const {
 }
 
 void DecoderImpl::decode(Buffer::Instance& data) {
-  uint64_t num_slices = data.getRawSlices(nullptr, 0);
-  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
-  data.getRawSlices(slices.begin(), num_slices);
-  for (const Buffer::RawSlice& slice : slices) {
-    parseSlice(slice);
-  }
+  while (data.length() != 0) {
+    if (bulk_string_buffer_ != nullptr) {
+      // The slices entirely within the bulk string are moved rather than copied.
+      ASSERT(state_ == State::BulkStringBody);
+      const uint64_t length = std::min(pending_integer_.integer_, data.length());
+      bulk_string_buffer_->move(data, length);
+      pending_integer_.integer_ -= length;
+      if (pending_integer_.integer_ == 0) {
+        ENVOY_LOG(trace, "parse slice: BulkStringBody complete: {} bytes",
+                  bulk_string_buffer_->length());
+        pending_value_stack_.front().value_->bulkStringBuffer(std::move(bulk_string_buffer_));
+        state_ = State::CR;
+      }
+      continue;
+    }
 
-  data.drain(data.length());
+    uint64_t num_slices = data.getRawSlices(nullptr, 0);
+    STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+    data.getRawSlices(slices.begin(), num_slices);
+    uint64_t parsed = 0;
+    for (const Buffer::RawSlice& slice : slices) {
+      const uint64_t slice_parsed = parseSlice(slice);
+      parsed += slice_parsed;
+      if (slice_parsed != slice.len_) {
+        // A large bulk string starts, which is moved out of the data above.
+        ASSERT(bulk_string_buffer_ != nullptr);
+        break;
+      }
+    }
+    data.drain(parsed);
+  }
 }
 
-void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
+uint64_t DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
   const char* buffer = reinterpret_cast<const char*>(slice.mem_);
   uint64_t remaining = slice.len_;
 
@@ -325,7 +374,12 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
       } else {
         ASSERT(current_value.value_->type() == RespType::BulkString);
         if (!pending_integer_.negative_) {
-          // TODO(mattklein123): reserve and define max length since we don't stream currently.
+          // TODO(mattklein123): define max length since we don't stream currently.
+          if (pending_integer_.integer_ >= MIN_BUFFERED_BULK_STRING_LENGTH) {
+            bulk_string_buffer_ = std::make_unique<Buffer::OwnedImpl>();
+          } else {
+            current_value.value_->asString().reserve(pending_integer_.integer_);
+          }
           state_ = State::BulkStringBody;
         } else {
           // Null bulk string. Switch type to null and move to value complete.
@@ -339,6 +393,10 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
 
     case State::BulkStringBody: {
       ASSERT(!pending_integer_.negative_);
+      if (bulk_string_buffer_ != nullptr) {
+        // Let decode() move the bulk string out of the data.
+        return slice.len_ - remaining;
+      }
       uint64_t length_to_copy =
           std::min(static_cast<uint64_t>(pending_integer_.integer_), remaining);
       pending_value_stack_.front().value_->asString().append(buffer, length_to_copy);
@@ -414,6 +472,8 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
     }
     }
   }
+
+  return slice.len_;
 }
 
 void EncoderImpl::encode(const RespValue& value, Buffer::Instance& out) {
@@ -427,7 +487,11 @@ void EncoderImpl::encode(const RespValue& value, Buffer::Instance& out) {
     break;
   }
   case RespType::BulkString: {
-    encodeBulkString(value.asString(), out);
+    if (value.bulkStringBuffer() != nullptr) {
+      encodeBulkStringBuffer(value.bulkStringBuffer(), out);
+    } else {
+      encodeBulkString(value.asString(), out);
+    }
     break;
   }
   case RespType::Error: {
@@ -459,15 +523,38 @@ void EncoderImpl::encodeArray(const std::vector<RespValue>& array, Buffer::Insta
 }
 
 void EncoderImpl::encodeBulkString(const std::string& string, Buffer::Instance& out) {
+  encodeBulkStringLength(string.size(), out);
+  out.add(string);
+  out.add("\r\n", 2);
+}
+
+void EncoderImpl::encodeBulkStringBuffer(const std::shared_ptr<const Buffer::Instance>& buffer,
+                                         Buffer::Instance& out) {
+  encodeBulkStringLength(buffer->length(), out);
+  uint64_t num_slices = buffer->getRawSlices(nullptr, 0);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  buffer->getRawSlices(slices.begin(), num_slices);
+  for (const Buffer::RawSlice& slice : slices) {
+    // The slices are referenced rather than copied, the buffer being kept alive until out is done
+    // with them.
+    auto* fragment = new Buffer::BufferFragmentImpl(
+        slice.mem_, slice.len_,
+        [buffer](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+          delete fragment;
+        });
+    out.addBufferFragment(*fragment);
+  }
+  out.add("\r\n", 2);
+}
+
+void EncoderImpl::encodeBulkStringLength(uint64_t length, Buffer::Instance& out) {
   char buffer[32];
   char* current = buffer;
   *current++ = '$';
-  current += StringUtil::itoa(current, 31, string.size());
+  current += StringUtil::itoa(current, 31, length);
   *current++ = '\r';
   *current++ = '\n';
   out.add(buffer, current - buffer);
-  out.add(string);
-  out.add("\r\n", 2);
 }
 
 void EncoderImpl::encodeError(const std::string& string, Buffer::Instance& out) {
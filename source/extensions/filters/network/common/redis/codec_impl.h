@@ -19,6 +19,8 @@ namespace Redis {
  * Decoder implementation of https://redis.io/topics/protocol
  *
  * This implementation buffers when needed and will always consume all bytes passed for decoding.
+ * Bulk strings of at least MIN_BUFFERED_BULK_STRING_LENGTH bytes are moved to a buffer rather than
+ * copied to a string, see RespValue::bulkStringBuffer().
  */
 class DecoderImpl : public Decoder, Logger::Loggable<Logger::Id::redis> {
 public:
@@ -27,6 +29,9 @@ public:
   // RedisProxy::Decoder
   void decode(Buffer::Instance& data) override;
 
+  // Smaller bulk strings are copied, as referencing them would cost more than copying them.
+  static constexpr uint64_t MIN_BUFFERED_BULK_STRING_LENGTH = 1024;
+
 private:
   enum class State {
     ValueRootStart,
@@ -56,13 +61,20 @@ private:
     uint64_t current_array_element_;
   };
 
-  void parseSlice(const Buffer::RawSlice& slice);
+  /**
+   * Parse a slice of the data, up to its end or to the start of the body of a bulk string to be
+   * moved to bulk_string_buffer_.
+   * @return the number of bytes parsed.
+   */
+  uint64_t parseSlice(const Buffer::RawSlice& slice);
 
   DecoderCallbacks& callbacks_;
   State state_{State::ValueRootStart};
   PendingInteger pending_integer_;
   RespValuePtr pending_value_root_;
   std::forward_list<PendingValue> pending_value_stack_;
+  // The body of the bulk string being decoded, when it is moved rather than copied.
+  Buffer::InstancePtr bulk_string_buffer_;
 };
 
 /**
@@ -87,6 +99,9 @@ public:
 private:
   void encodeArray(const std::vector<RespValue>& array, Buffer::Instance& out);
   void encodeBulkString(const std::string& string, Buffer::Instance& out);
+  void encodeBulkStringBuffer(const std::shared_ptr<const Buffer::Instance>& buffer,
+                              Buffer::Instance& out);
+  void encodeBulkStringLength(uint64_t length, Buffer::Instance& out);
   void encodeError(const std::string& string, Buffer::Instance& out);
   void encodeInteger(int64_t integer, Buffer::Instance& out);
   void encodeSimpleString(const std::string& string, Buffer::Instance& out);
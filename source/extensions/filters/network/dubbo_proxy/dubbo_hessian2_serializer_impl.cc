@@ -18,10 +18,12 @@ namespace DubboProxy {
 std::pair<RpcInvocationSharedPtr, bool>
 DubboHessian2SerializerImpl::deserializeRpcInvocation(Buffer::Instance& buffer,
                                                       ContextSharedPtr context) {
+  // Only the fields preceding the method name are read. The parameter types, the arguments and the
+  // attachments which follow are left in the buffer, and forwarded as they are.
   size_t total_size = 0, size;
   // TODO(zyfjeff): Add format checker
-  std::string dubbo_version = HessianUtils::peekString(buffer, &size);
-  total_size += size;
+  // The dubbo version is not used, so it is skipped without being copied out.
+  total_size += HessianUtils::peekStringSize(buffer);
   std::string service_name = HessianUtils::peekString(buffer, &size, total_size);
   total_size += size;
   std::string service_version = HessianUtils::peekString(buffer, &size, total_size);
@@ -35,9 +37,9 @@ DubboHessian2SerializerImpl::deserializeRpcInvocation(Buffer::Instance& buffer,
   }
 
   auto invo = std::make_shared<RpcInvocationImpl>();
-  invo->setServiceName(service_name);
-  invo->setServiceVersion(service_version);
-  invo->setMethodName(method_name);
+  invo->setServiceName(std::move(service_name));
+  invo->setServiceVersion(std::move(service_version));
+  invo->setMethodName(std::move(method_name));
 
   return std::pair<RpcInvocationSharedPtr, bool>(invo, true);
 }
@@ -84,11 +84,22 @@ char* allocStringBuffer(std::string* str, size_t length) {
   return &((*str)[0]);
 }
 
-std::string HessianUtils::peekString(Buffer::Instance& buffer, size_t* size, uint64_t offset) {
+namespace {
+
+void appendOut(Buffer::Instance& buffer, uint64_t offset, size_t length, std::string* result) {
+  if (result != nullptr) {
+    const size_t size = result->size();
+    result->resize(size + length);
+    buffer.copyOut(offset, length, &(*result)[size]);
+  }
+}
+
+// Appends the string at the offset to the result, or only measures it if the result is nullptr.
+// Returns the encoded size of the string.
+size_t peekStringTo(Buffer::Instance& buffer, uint64_t offset, std::string* result) {
   ASSERT(buffer.length() > offset);
   uint8_t code = buffer.peekInt<uint8_t>(offset);
   size_t delta_length = 0;
-  std::string result;
   switch (code) {
   case 0x00:
   case 0x01:
@@ -126,9 +137,8 @@ std::string HessianUtils::peekString(Buffer::Instance& buffer, size_t* size, uin
     if (delta_length + 1 + offset > buffer.length()) {
       throw EnvoyException("buffer underflow");
     }
-    buffer.copyOut(offset + 1, delta_length, allocStringBuffer(&result, delta_length + 1));
-    *size = delta_length + 1;
-    return result;
+    appendOut(buffer, offset + 1, delta_length, result);
+    return delta_length + 1;
 
   case 0x30:
   case 0x31:
@@ -143,9 +153,8 @@ std::string HessianUtils::peekString(Buffer::Instance& buffer, size_t* size, uin
       throw EnvoyException("buffer underflow");
     }
 
-    buffer.copyOut(offset + 2, delta_length, allocStringBuffer(&result, delta_length + 1));
-    *size = delta_length + 2;
-    return result;
+    appendOut(buffer, offset + 2, delta_length, result);
+    return delta_length + 2;
 
   case 0x53:
     if (offset + 3 > buffer.length()) {
@@ -158,9 +167,8 @@ std::string HessianUtils::peekString(Buffer::Instance& buffer, size_t* size, uin
       throw EnvoyException("buffer underflow");
     }
 
-    buffer.copyOut(offset + 3, delta_length, allocStringBuffer(&result, delta_length + 1));
-    *size = delta_length + 3;
-    return result;
+    appendOut(buffer, offset + 3, delta_length, result);
+    return delta_length + 3;
 
   case 0x52:
     if (offset + 3 > buffer.length()) {
@@ -168,15 +176,29 @@ std::string HessianUtils::peekString(Buffer::Instance& buffer, size_t* size, uin
     }
 
     delta_length = buffer.peekBEInt<uint16_t>(offset + 1);
-    buffer.copyOut(offset + 3, delta_length, allocStringBuffer(&result, delta_length + 1));
-    size_t next_size = 0;
-    result.append(peekString(buffer, &next_size, delta_length + 3 + offset));
-    *size = next_size + delta_length + 3;
-    return result;
+    if (delta_length + 3 + offset >= buffer.length()) {
+      throw EnvoyException("buffer underflow");
+    }
+
+    appendOut(buffer, offset + 3, delta_length, result);
+    return delta_length + 3 + peekStringTo(buffer, delta_length + 3 + offset, result);
   }
   throw EnvoyException(fmt::format("hessian type is not string {}", code));
 }
 
+} // namespace
+
+std::string HessianUtils::peekString(Buffer::Instance& buffer, size_t* size, uint64_t offset) {
+  std::string result;
+  *size = peekStringTo(buffer, offset, &result);
+  return result;
+}
+
+size_t HessianUtils::peekStringSize(Buffer::Instance& buffer, uint64_t offset) {
+  return peekStringTo(buffer, offset, nullptr);
+}
+
+
 std::string HessianUtils::readString(Buffer::Instance& buffer) {
   size_t size;
   std::string result(peekString(buffer, &size));
@@ -18,6 +18,8 @@ namespace DubboProxy {
 class HessianUtils {
 public:
   static std::string peekString(Buffer::Instance& buffer, size_t* size, uint64_t offset = 0);
+  // Returns the encoded size of the string at the offset, without copying it out.
+  static size_t peekStringSize(Buffer::Instance& buffer, uint64_t offset = 0);
   static long peekLong(Buffer::Instance& buffer, size_t* size, uint64_t offset = 0);
   static bool peekBool(Buffer::Instance& buffer, size_t* size, uint64_t offset = 0);
   static int peekInt(Buffer::Instance& buffer, size_t* size, uint64_t offset = 0);
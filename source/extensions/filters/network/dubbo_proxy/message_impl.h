@@ -40,13 +40,13 @@ class RpcInvocationBase : public RpcInvocation {
 public:
   ~RpcInvocationBase() override = default;
 
-  void setServiceName(const std::string& name) { service_name_ = name; }
+  void setServiceName(std::string name) { service_name_ = std::move(name); }
   const std::string& service_name() const override { return service_name_; }
 
-  void setMethodName(const std::string& name) { method_name_ = name; }
+  void setMethodName(std::string name) { method_name_ = std::move(name); }
   const std::string& method_name() const override { return method_name_; }
 
-  void setServiceVersion(const std::string& version) { service_version_ = version; }
+  void setServiceVersion(std::string version) { service_version_ = std::move(version); }
   const absl::optional<std::string>& service_version() const override { return service_version_; }
 
   void setServiceGroup(const std::string& group) { group_ = group; }
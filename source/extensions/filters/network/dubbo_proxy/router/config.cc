@@ -11,10 +11,21 @@ namespace DubboProxy {
 namespace Router {
 
 DubboFilters::FilterFactoryCb RouterFilterConfig::createFilterFactoryFromProtoTyped(
-    const envoy::config::filter::dubbo::router::v2alpha1::Router&, const std::string&,
+    const envoy::config::filter::dubbo::router::v2alpha1::Router& proto_config, const std::string&,
     Server::Configuration::FactoryContext& context) {
-  return [&context](DubboFilters::FilterChainFactoryCallbacks& callbacks) -> void {
-    callbacks.addDecoderFilter(std::make_shared<Router>(context.clusterManager()));
+  if (!proto_config.multiplex_upstream_connections()) {
+    return [&context](DubboFilters::FilterChainFactoryCallbacks& callbacks) -> void {
+      callbacks.addDecoderFilter(std::make_shared<Router>(context.clusterManager()));
+    };
+  }
+
+  std::shared_ptr<ThreadLocal::Slot> slot = context.threadLocal().allocateSlot();
+  slot->set([](Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<MultiplexedConnectionRegistry>(dispatcher);
+  });
+  return [&context, slot](DubboFilters::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addDecoderFilter(std::make_shared<Router>(
+        context.clusterManager(), &slot->getTyped<MultiplexedConnectionRegistry>()));
   };
 }
 
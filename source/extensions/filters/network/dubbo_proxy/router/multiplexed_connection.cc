@@ -0,0 +1,297 @@
+#include "extensions/filters/network/dubbo_proxy/router/multiplexed_connection.h"
+
+#include "extensions/filters/network/dubbo_proxy/message.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace DubboProxy {
+namespace Router {
+namespace {
+
+// The fixed size header of Dubbo messages, see DubboProtocolImpl.
+constexpr uint16_t MagicNumber = 0xdabb;
+constexpr uint8_t MessageTypeMask = 0x80;
+constexpr uint8_t TwoWayMask = 0x40;
+constexpr uint8_t EventMask = 0x20;
+constexpr uint8_t SerializationTypeMask = 0x1f;
+constexpr uint64_t FlagOffset = 2;
+constexpr uint64_t RequestIdOffset = 4;
+constexpr uint64_t BodySizeOffset = 12;
+constexpr uint64_t HeaderSize = 16;
+
+/**
+ * Replaces the request id of the message at the front of a buffer.
+ * @return int64_t the previous request id.
+ */
+int64_t replaceRequestId(Buffer::Instance& data, int64_t request_id) {
+  const int64_t previous_request_id = data.peekBEInt<int64_t>(RequestIdOffset);
+
+  Buffer::OwnedImpl header;
+  header.move(data, RequestIdOffset);
+  header.writeBEInt<int64_t>(request_id);
+  data.drain(sizeof(int64_t));
+  data.prepend(header);
+
+  return previous_request_id;
+}
+
+} // namespace
+
+MultiplexedRequest::MultiplexedRequest(MultiplexedConnection& parent, int64_t upstream_request_id)
+    : parent_(&parent), upstream_request_id_(upstream_request_id) {}
+
+MultiplexedRequest::~MultiplexedRequest() {
+  if (parent_ != nullptr) {
+    parent_->onRequestDestroyed(*this);
+  }
+}
+
+void MultiplexedRequest::write(Buffer::Instance& data, bool two_way) {
+  ASSERT(data.length() >= HeaderSize);
+  if (parent_ == nullptr) {
+    // The connection was closed, and the callbacks were notified.
+    data.drain(data.length());
+    return;
+  }
+
+  downstream_request_id_ = replaceRequestId(data, upstream_request_id_);
+  awaiting_response_ = two_way;
+  parent_->onRequestWritten(data);
+}
+
+MultiplexedConnection::MultiplexedConnection(MultiplexedConnectionRegistry& parent,
+                                             Tcp::ConnectionPool::Instance& pool)
+    : parent_(parent), pool_(pool) {}
+
+MultiplexedConnection::~MultiplexedConnection() {
+  if (pool_handle_ != nullptr) {
+    pool_handle_->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+  }
+  detachRequests();
+}
+
+Tcp::ConnectionPool::Cancellable*
+MultiplexedConnection::newRequest(MultiplexedRequestCallbacks& callbacks) {
+  if (conn_data_ != nullptr) {
+    callbacks.onPoolReady(createRequest(), host_);
+    return nullptr;
+  }
+
+  PendingRequestPtr pending_request = std::make_unique<PendingRequest>(*this, callbacks);
+  PendingRequest* handle = pending_request.get();
+  pending_request->moveIntoList(std::move(pending_request), pending_requests_);
+
+  if (pool_handle_ == nullptr) {
+    ENVOY_LOG(debug, "dubbo multiplexed connection: connecting");
+    // The pool may invoke the callbacks, and so complete the pending request, before returning.
+    pool_handle_ = pool_.newConnection(*this);
+  }
+
+  for (const PendingRequestPtr& pending : pending_requests_) {
+    if (pending.get() == handle) {
+      return handle;
+    }
+  }
+  return nullptr;
+}
+
+void MultiplexedConnection::onPoolFailure(Tcp::ConnectionPool::PoolFailureReason reason,
+                                          Upstream::HostDescriptionConstSharedPtr host) {
+  ENVOY_LOG(debug, "dubbo multiplexed connection: connection failure");
+  pool_handle_ = nullptr;
+
+  std::list<PendingRequestPtr> pending_requests;
+  pending_requests.swap(pending_requests_);
+  parent_.remove(*this);
+
+  for (const PendingRequestPtr& pending_request : pending_requests) {
+    pending_request->callbacks_.onPoolFailure(reason, host);
+  }
+}
+
+void MultiplexedConnection::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
+                                        Upstream::HostDescriptionConstSharedPtr host) {
+  ENVOY_LOG(debug, "dubbo multiplexed connection: connected to {}", host->address()->asString());
+  pool_handle_ = nullptr;
+  conn_data_ = std::move(conn_data);
+  conn_data_->addUpstreamCallbacks(*this);
+  host_ = host;
+
+  while (!pending_requests_.empty() && conn_data_ != nullptr) {
+    PendingRequestPtr pending_request =
+        pending_requests_.front()->removeFromList(pending_requests_);
+    pending_request->callbacks_.onPoolReady(createRequest(), host_);
+  }
+
+  releaseIfIdle();
+}
+
+void MultiplexedConnection::onUpstreamData(Buffer::Instance& data, bool) {
+  response_buffer_.move(data);
+
+  // The connection is released once the last response is received, and may be closed on errors.
+  while (conn_data_ != nullptr && response_buffer_.length() >= HeaderSize) {
+    if (response_buffer_.peekBEInt<uint16_t>() != MagicNumber) {
+      ENVOY_LOG(debug, "dubbo multiplexed connection: invalid magic number, closing");
+      conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
+      return;
+    }
+
+    const uint64_t size = HeaderSize + response_buffer_.peekBEInt<uint32_t>(BodySizeOffset);
+    if (response_buffer_.length() < size) {
+      return;
+    }
+
+    Buffer::OwnedImpl message;
+    message.move(response_buffer_, size);
+    if ((message.peekInt<uint8_t>(FlagOffset) & MessageTypeMask) != 0) {
+      onHeartbeat(message);
+    } else {
+      onResponse(message);
+    }
+  }
+}
+
+void MultiplexedConnection::onEvent(Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::Connected) {
+    // Connected is consumed by the connection pool.
+    return;
+  }
+
+  ENVOY_LOG(debug, "dubbo multiplexed connection: closed with {} requests", requests_.size());
+  conn_data_.reset();
+
+  // Detach the requests before notifying them, so that they can be destroyed meanwhile.
+  std::vector<Tcp::ConnectionPool::UpstreamCallbacks*> callbacks;
+  for (const auto& request : requests_) {
+    if (request.second != nullptr && request.second->callbacks_ != nullptr) {
+      callbacks.push_back(request.second->callbacks_);
+    }
+  }
+  detachRequests();
+  parent_.remove(*this);
+
+  for (Tcp::ConnectionPool::UpstreamCallbacks* cb : callbacks) {
+    cb->onEvent(event);
+  }
+}
+
+MultiplexedRequestPtr MultiplexedConnection::createRequest() {
+  const int64_t request_id = next_request_id_++;
+  MultiplexedRequestPtr request = std::make_unique<MultiplexedRequest>(*this, request_id);
+  requests_[request_id] = request.get();
+  return request;
+}
+
+void MultiplexedConnection::onRequestWritten(Buffer::Instance& data) {
+  ASSERT(conn_data_ != nullptr);
+  conn_data_->connection().write(data, false);
+}
+
+void MultiplexedConnection::onRequestDestroyed(MultiplexedRequest& request) {
+  auto it = requests_.find(request.upstream_request_id_);
+  ASSERT(it != requests_.end() && it->second == &request);
+
+  if (request.awaiting_response_) {
+    // Keep the connection until the abandoned response is received, so that it cannot be mistaken
+    // for the response of another request once the connection is reused.
+    it->second = nullptr;
+  } else {
+    requests_.erase(it);
+  }
+
+  releaseIfIdle();
+}
+
+void MultiplexedConnection::onResponse(Buffer::Instance& message) {
+  const int64_t request_id = message.peekBEInt<int64_t>(RequestIdOffset);
+  auto it = requests_.find(request_id);
+  if (it == requests_.end()) {
+    ENVOY_LOG(debug, "dubbo multiplexed connection: unexpected response {}", request_id);
+    return;
+  }
+
+  MultiplexedRequest* request = it->second;
+  if (request == nullptr) {
+    ENVOY_LOG(debug, "dubbo multiplexed connection: dropping abandoned response {}", request_id);
+    requests_.erase(it);
+    releaseIfIdle();
+    return;
+  }
+
+  request->awaiting_response_ = false;
+  replaceRequestId(message, request->downstream_request_id_);
+  ASSERT(request->callbacks_ != nullptr);
+  request->callbacks_->onUpstreamData(message, false);
+}
+
+void MultiplexedConnection::onHeartbeat(Buffer::Instance& message) {
+  const uint8_t flag = message.peekInt<uint8_t>(FlagOffset);
+  if ((flag & EventMask) == 0 || (flag & TwoWayMask) == 0) {
+    ENVOY_LOG(debug, "dubbo multiplexed connection: dropping upstream request");
+    return;
+  }
+
+  // The connection is not idle as far as the upstream is concerned, so answer on its behalf.
+  Buffer::OwnedImpl response;
+  response.writeBEInt<uint16_t>(MagicNumber);
+  response.writeByte(static_cast<uint8_t>((flag & SerializationTypeMask) | EventMask));
+  response.writeByte(static_cast<uint8_t>(ResponseStatus::Ok));
+  response.writeBEInt<int64_t>(message.peekBEInt<int64_t>(RequestIdOffset));
+  response.writeBEInt<uint32_t>(0);
+  conn_data_->connection().write(response, false);
+}
+
+void MultiplexedConnection::releaseIfIdle() {
+  if (!requests_.empty() || !pending_requests_.empty()) {
+    return;
+  }
+
+  ENVOY_LOG(debug, "dubbo multiplexed connection: releasing idle connection");
+  if (pool_handle_ != nullptr) {
+    pool_handle_->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+    pool_handle_ = nullptr;
+  }
+  conn_data_.reset();
+  response_buffer_.drain(response_buffer_.length());
+  parent_.remove(*this);
+}
+
+void MultiplexedConnection::detachRequests() {
+  for (const auto& request : requests_) {
+    if (request.second != nullptr) {
+      request.second->parent_ = nullptr;
+    }
+  }
+  requests_.clear();
+}
+
+void MultiplexedConnection::PendingRequest::cancel(Tcp::ConnectionPool::CancelPolicy) {
+  PendingRequestPtr removed = removeFromList(parent_.pending_requests_);
+  parent_.releaseIfIdle();
+}
+
+MultiplexedConnection&
+MultiplexedConnectionRegistry::connection(Tcp::ConnectionPool::Instance& pool) {
+  MultiplexedConnectionPtr& connection = connections_[&pool];
+  if (connection == nullptr) {
+    connection = std::make_unique<MultiplexedConnection>(*this, pool);
+  }
+  return *connection;
+}
+
+void MultiplexedConnectionRegistry::remove(MultiplexedConnection& connection) {
+  // The connection may have been removed already, and replaced by a new one.
+  auto it = connections_.find(&connection.pool_);
+  if (it != connections_.end() && it->second.get() == &connection) {
+    dispatcher_.deferredDelete(std::move(it->second));
+    connections_.erase(it);
+  }
+}
+
+} // namespace Router
+} // namespace DubboProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -170,7 +170,10 @@ Router::UpstreamRequest::UpstreamRequest(Router& parent, Tcp::ConnectionPool::In
 Router::UpstreamRequest::~UpstreamRequest() = default;
 
 FilterStatus Router::UpstreamRequest::start() {
-  Tcp::ConnectionPool::Cancellable* handle = conn_pool_.newConnection(*this);
+  Tcp::ConnectionPool::Cancellable* handle =
+      parent_.multiplexed_connections_ != nullptr
+          ? parent_.multiplexed_connections_->connection(conn_pool_).newRequest(*this)
+          : conn_pool_.newConnection(*this);
   if (handle) {
     // Pause while we wait for a connection.
     conn_pool_handle_ = handle;
@@ -196,13 +199,23 @@ void Router::UpstreamRequest::resetStream() {
     conn_data_.reset();
     ENVOY_LOG(debug, "dubbo upstream request: reset connection data");
   }
+
+  if (multiplexed_request_) {
+    // Other requests share the connection, the response is dropped when it arrives.
+    multiplexed_request_.reset();
+    ENVOY_LOG(debug, "dubbo upstream request: reset multiplexed request");
+  }
 }
 
 void Router::UpstreamRequest::encodeData(Buffer::Instance& data) {
-  ASSERT(conn_data_);
+  ASSERT(conn_data_ || multiplexed_request_);
   ASSERT(!conn_pool_handle_);
 
   ENVOY_STREAM_LOG(trace, "proxying {} bytes", *parent_.callbacks_, data.length());
+  if (multiplexed_request_) {
+    multiplexed_request_->write(data, metadata_->message_type() != MessageType::Oneway);
+    return;
+  }
   conn_data_->connection().write(data, false);
 }
 
@@ -243,6 +256,22 @@ void Router::UpstreamRequest::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr
   encodeData(parent_.upstream_request_buffer_);
 }
 
+void Router::UpstreamRequest::onPoolReady(MultiplexedRequestPtr&& request,
+                                          Upstream::HostDescriptionConstSharedPtr host) {
+  ENVOY_LOG(debug, "dubbo upstream request: multiplexed connection has ready");
+
+  // Only invoke continueDecoding if we'd previously stopped the filter chain.
+  bool continue_decoding = conn_pool_handle_ != nullptr;
+
+  onUpstreamHostSelected(host);
+  multiplexed_request_ = std::move(request);
+  multiplexed_request_->addUpstreamCallbacks(parent_);
+  conn_pool_handle_ = nullptr;
+
+  onRequestStart(continue_decoding);
+  encodeData(parent_.upstream_request_buffer_);
+}
+
 void Router::UpstreamRequest::onRequestStart(bool continue_decoding) {
   ENVOY_LOG(debug, "dubbo upstream request: start sending data to the server {}",
             upstream_host_->address()->asString());
@@ -258,6 +287,7 @@ void Router::UpstreamRequest::onRequestComplete() { request_complete_ = true; }
 void Router::UpstreamRequest::onResponseComplete() {
   response_complete_ = true;
   conn_data_.reset();
+  multiplexed_request_.reset();
 }
 
 void Router::UpstreamRequest::onUpstreamHostSelected(Upstream::HostDescriptionConstSharedPtr host) {
@@ -10,6 +10,7 @@
 #include "common/upstream/load_balancer_impl.h"
 
 #include "extensions/filters/network/dubbo_proxy/filters/filter.h"
+#include "extensions/filters/network/dubbo_proxy/router/multiplexed_connection.h"
 #include "extensions/filters/network/dubbo_proxy/router/router.h"
 
 namespace Envoy {
@@ -23,7 +24,13 @@ class Router : public Tcp::ConnectionPool::UpstreamCallbacks,
                public DubboFilters::DecoderFilter,
                Logger::Loggable<Logger::Id::dubbo> {
 public:
-  Router(Upstream::ClusterManager& cluster_manager) : cluster_manager_(cluster_manager) {}
+  /**
+   * @param multiplexed_connections supplies the connections shared by the requests of the worker,
+   *        nullptr if each request has an upstream connection of its own.
+   */
+  Router(Upstream::ClusterManager& cluster_manager,
+         MultiplexedConnectionRegistry* multiplexed_connections = nullptr)
+      : cluster_manager_(cluster_manager), multiplexed_connections_(multiplexed_connections) {}
   ~Router() override = default;
 
   // DubboFilters::DecoderFilter
@@ -43,7 +50,8 @@ public:
   void onBelowWriteBufferLowWatermark() override {}
 
 private:
-  struct UpstreamRequest : public Tcp::ConnectionPool::Callbacks {
+  struct UpstreamRequest : public Tcp::ConnectionPool::Callbacks,
+                           public MultiplexedRequestCallbacks {
     UpstreamRequest(Router& parent, Tcp::ConnectionPool::Instance& pool,
                     MessageMetadataSharedPtr& metadata, SerializationType serialization_type,
                     ProtocolType protocol_type);
@@ -53,12 +61,16 @@ private:
     void resetStream();
     void encodeData(Buffer::Instance& data);
 
-    // Tcp::ConnectionPool::Callbacks
+    // Tcp::ConnectionPool::Callbacks and MultiplexedRequestCallbacks
     void onPoolFailure(Tcp::ConnectionPool::PoolFailureReason reason,
                        Upstream::HostDescriptionConstSharedPtr host) override;
     void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn,
                      Upstream::HostDescriptionConstSharedPtr host) override;
 
+    // MultiplexedRequestCallbacks
+    void onPoolReady(MultiplexedRequestPtr&& request,
+                     Upstream::HostDescriptionConstSharedPtr host) override;
+
     void onRequestStart(bool continue_decoding);
     void onRequestComplete();
     void onResponseComplete();
@@ -71,6 +83,7 @@ private:
 
     Tcp::ConnectionPool::Cancellable* conn_pool_handle_{};
     Tcp::ConnectionPool::ConnectionDataPtr conn_data_;
+    MultiplexedRequestPtr multiplexed_request_;
     Upstream::HostDescriptionConstSharedPtr upstream_host_;
     SerializerPtr serializer_;
     ProtocolPtr protocol_;
@@ -84,6 +97,7 @@ private:
   void cleanup();
 
   Upstream::ClusterManager& cluster_manager_;
+  MultiplexedConnectionRegistry* const multiplexed_connections_;
 
   DubboFilters::DecoderFilterCallbacks* callbacks_{};
   RouteConstSharedPtr route_{};
@@ -16,6 +16,7 @@
 #include "common/http/conn_manager_utility.h"
 #include "common/http/date_provider_impl.h"
 #include "common/http/default_server_string.h"
+#include "common/http/filter_latency.h"
 #include "common/http/http1/codec_impl.h"
 #include "common/http/http2/codec_impl.h"
 #include "common/http/utility.h"
@@ -30,7 +31,7 @@ namespace NetworkFilters {
 namespace HttpConnectionManager {
 namespace {
 
-using FilterFactoriesList = std::list<Http::FilterFactoryCb>;
+using FilterFactoriesList = std::vector<Http::FilterFactoryCb>;
 using FilterFactoryMap = std::map<std::string, HttpConnectionManagerConfig::FilterConfig>;
 
 HttpConnectionManagerConfig::UpgradeMap::const_iterator
@@ -149,6 +150,8 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
       http1_settings_(Http::Utility::parseHttp1Settings(config.http_protocol_options())),
       max_request_headers_kb_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           config, max_request_headers_kb, Http::DEFAULT_MAX_REQUEST_HEADERS_KB)),
+      overload_buffer_limit_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, overload_buffer_limit_bytes, 0)),
       idle_timeout_(PROTOBUF_GET_OPTIONAL_MS(config, idle_timeout)),
       stream_idle_timeout_(
           PROTOBUF_GET_MS_OR_DEFAULT(config, stream_idle_timeout, StreamIdleTimeoutMs)),
@@ -171,7 +174,8 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
                                                       0
 #endif
                                                       ))),
-      merge_slashes_(config.merge_slashes()) {
+      merge_slashes_(config.merge_slashes()),
+      record_filter_latency_(config.record_filter_latency()) {
   // If scoped RDS is enabled, avoid creating a route config provider. Route config providers will
   // be managed by the scoped routing logic instead.
   switch (config.route_specifier_case()) {
@@ -306,6 +310,7 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
   }
 
   const auto& filters = config.http_filters();
+  filter_factories_.reserve(filters.size());
   for (int32_t i = 0; i < filters.size(); i++) {
     bool is_terminal = false;
     processFilter(filters[i], i, "http", filter_factories_, is_terminal);
@@ -323,6 +328,7 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
     }
     if (!upgrade_config.filters().empty()) {
       std::unique_ptr<FilterFactoriesList> factories = std::make_unique<FilterFactoriesList>();
+      factories->reserve(upgrade_config.filters().size());
       for (int32_t j = 0; j < upgrade_config.filters().size(); j++) {
         bool is_terminal = false;
         processFilter(upgrade_config.filters(j), j, name, *factories, is_terminal);
@@ -342,7 +348,7 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
 
 void HttpConnectionManagerConfig::processFilter(
     const envoy::config::filter::network::http_connection_manager::v2::HttpFilter& proto_config,
-    int i, absl::string_view prefix, std::list<Http::FilterFactoryCb>& filter_factories,
+    int i, absl::string_view prefix, FilterFactoriesList& filter_factories,
     bool& is_terminal) {
   const std::string& string_name = proto_config.name();
 
@@ -366,8 +372,13 @@ void HttpConnectionManagerConfig::processFilter(
         proto_config, context_.messageValidationVisitor(), factory);
     callback = factory.createFilterFactoryFromProto(*message, stats_prefix_, context_);
   }
+  if (record_filter_latency_) {
+    callback = Http::FilterLatency::wrapFilterFactory(std::move(callback), string_name,
+                                                      stats_prefix_, context_.scope(),
+                                                      context_.timeSource());
+  }
   is_terminal = factory.isTerminalFilter();
-  filter_factories.push_back(callback);
+  filter_factories.push_back(std::move(callback));
 }
 
 Http::ServerConnectionPtr
@@ -124,6 +124,11 @@ public:
     return request_header_ == rhs.request_header_ && data_ == rhs.data_;
   };
 
+  /**
+   * Request-specific data.
+   */
+  const Data& data() const { return data_; }
+
 private:
   const Data data_;
 };
@@ -97,6 +97,11 @@ public:
     return metadata_ == rhs.metadata_ && data_ == rhs.data_;
   };
 
+  /**
+   * Response-specific data.
+   */
+  const Data& data() const { return data_; }
+
 private:
   const Data data_;
 };
@@ -0,0 +1,51 @@
+#include "extensions/filters/network/kafka/metadata_response_summary.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+
+ResponseParserSharedPtr
+MetadataResponseSummaryParserResolver::createParser(ResponseContextSharedPtr context) const {
+  if (METADATA_API_KEY == context->api_key_) {
+    switch (context->api_version_) {
+    case 0:
+      return std::make_shared<
+          ResponseDataParser<MetadataResponseSummary, MetadataResponseSummaryV0Deserializer>>(
+          context);
+    case 1:
+      return std::make_shared<
+          ResponseDataParser<MetadataResponseSummary, MetadataResponseSummaryV1Deserializer>>(
+          context);
+    case 2:
+      return std::make_shared<
+          ResponseDataParser<MetadataResponseSummary, MetadataResponseSummaryV2Deserializer>>(
+          context);
+    case 3:
+    case 4:
+      return std::make_shared<ResponseDataParser<
+          MetadataResponseSummary,
+          MetadataResponseSummaryV3Deserializer<PartitionLeaderSummaryV0Deserializer>>>(context);
+    case 5:
+    case 6:
+      return std::make_shared<ResponseDataParser<
+          MetadataResponseSummary,
+          MetadataResponseSummaryV3Deserializer<PartitionLeaderSummaryV5Deserializer>>>(context);
+    case 7:
+      return std::make_shared<ResponseDataParser<
+          MetadataResponseSummary,
+          MetadataResponseSummaryV3Deserializer<PartitionLeaderSummaryV7Deserializer>>>(context);
+    }
+  }
+  return ResponseParserResolver::createParser(context);
+}
+
+const MetadataResponseSummaryParserResolver&
+MetadataResponseSummaryParserResolver::getDefaultInstance() {
+  CONSTRUCT_ON_FIRST_USE(MetadataResponseSummaryParserResolver);
+}
+
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
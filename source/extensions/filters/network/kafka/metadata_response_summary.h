@@ -0,0 +1,227 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "extensions/filters/network/kafka/kafka_response.h"
+#include "extensions/filters/network/kafka/kafka_response_parser.h"
+#include "extensions/filters/network/kafka/serialization.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+
+/**
+ * Metadata request & response api key.
+ * @see http://kafka.apache.org/protocol.html#The_Messages_Metadata
+ */
+constexpr int16_t METADATA_API_KEY = 3;
+
+/**
+ * A broker of a metadata response, without its rack.
+ */
+struct BrokerSummary {
+  // Version 0.
+  BrokerSummary(int32_t node_id, std::string host, int32_t port)
+      : node_id_{node_id}, host_{std::move(host)}, port_{port} {};
+
+  // Version 1+.
+  BrokerSummary(int32_t node_id, std::string host, int32_t port, NullableString)
+      : BrokerSummary(node_id, std::move(host), port){};
+
+  const int32_t node_id_;
+  const std::string host_;
+  const int32_t port_;
+
+  bool operator==(const BrokerSummary& rhs) const {
+    return node_id_ == rhs.node_id_ && host_ == rhs.host_ && port_ == rhs.port_;
+  };
+};
+
+/**
+ * A partition of a metadata response, with its leader but without its replicas.
+ */
+struct PartitionLeaderSummary {
+  PartitionLeaderSummary(int16_t error_code, int32_t partition, int32_t leader)
+      : error_code_{error_code}, partition_{partition}, leader_{leader} {};
+
+  // Version 0-4.
+  PartitionLeaderSummary(int16_t error_code, int32_t partition, int32_t leader,
+                         std::vector<int32_t>, std::vector<int32_t>)
+      : PartitionLeaderSummary(error_code, partition, leader){};
+
+  // Version 5-6.
+  PartitionLeaderSummary(int16_t error_code, int32_t partition, int32_t leader,
+                         std::vector<int32_t>, std::vector<int32_t>, std::vector<int32_t>)
+      : PartitionLeaderSummary(error_code, partition, leader){};
+
+  // Version 7+.
+  PartitionLeaderSummary(int16_t error_code, int32_t partition, int32_t leader, int32_t,
+                         std::vector<int32_t>, std::vector<int32_t>, std::vector<int32_t>)
+      : PartitionLeaderSummary(error_code, partition, leader){};
+
+  const int16_t error_code_;
+  const int32_t partition_;
+  // The node id of the leader, -1 if there is none.
+  const int32_t leader_;
+
+  bool operator==(const PartitionLeaderSummary& rhs) const {
+    return error_code_ == rhs.error_code_ && partition_ == rhs.partition_ &&
+           leader_ == rhs.leader_;
+  };
+};
+
+/**
+ * A topic of a metadata response, with the leaders of its partitions.
+ */
+struct TopicLeadersSummary {
+  // Version 0.
+  TopicLeadersSummary(int16_t error_code, std::string name,
+                      std::vector<PartitionLeaderSummary> partitions)
+      : error_code_{error_code}, name_{std::move(name)}, partitions_{std::move(partitions)} {};
+
+  // Version 1+.
+  TopicLeadersSummary(int16_t error_code, std::string name, bool,
+                      std::vector<PartitionLeaderSummary> partitions)
+      : TopicLeadersSummary(error_code, std::move(name), std::move(partitions)){};
+
+  const int16_t error_code_;
+  const std::string name_;
+  const std::vector<PartitionLeaderSummary> partitions_;
+
+  bool operator==(const TopicLeadersSummary& rhs) const {
+    return error_code_ == rhs.error_code_ && name_ == rhs.name_ && partitions_ == rhs.partitions_;
+  };
+};
+
+/**
+ * The data of a metadata response reduced to what routing by partition leader needs: the brokers
+ * and the leaders of the partitions. As the rest is dropped, the summary can not be encoded.
+ * @see http://kafka.apache.org/protocol.html#The_Messages_Metadata
+ */
+struct MetadataResponseSummary {
+  // Version 0.
+  MetadataResponseSummary(std::vector<BrokerSummary> brokers,
+                          std::vector<TopicLeadersSummary> topics)
+      : brokers_{std::move(brokers)}, topics_{std::move(topics)} {};
+
+  // Version 1.
+  MetadataResponseSummary(std::vector<BrokerSummary> brokers, int32_t,
+                          std::vector<TopicLeadersSummary> topics)
+      : MetadataResponseSummary(std::move(brokers), std::move(topics)){};
+
+  // Version 2.
+  MetadataResponseSummary(std::vector<BrokerSummary> brokers, NullableString, int32_t,
+                          std::vector<TopicLeadersSummary> topics)
+      : MetadataResponseSummary(std::move(brokers), std::move(topics)){};
+
+  // Version 3+.
+  MetadataResponseSummary(int32_t, std::vector<BrokerSummary> brokers, NullableString, int32_t,
+                          std::vector<TopicLeadersSummary> topics)
+      : MetadataResponseSummary(std::move(brokers), std::move(topics)){};
+
+  const std::vector<BrokerSummary> brokers_;
+  const std::vector<TopicLeadersSummary> topics_;
+
+  uint32_t computeSize(const EncodingContext&) const {
+    throw EnvoyException("metadata response summaries can not be encoded");
+  }
+
+  uint32_t encode(Buffer::Instance&, EncodingContext&) const {
+    throw EnvoyException("metadata response summaries can not be encoded");
+  }
+
+  bool operator==(const MetadataResponseSummary& rhs) const {
+    return brokers_ == rhs.brokers_ && topics_ == rhs.topics_;
+  };
+};
+
+using Int32ArrayDeserializer = ArrayDeserializer<int32_t, Int32Deserializer>;
+
+class BrokerSummaryV0Deserializer
+    : public CompositeDeserializerWith3Delegates<BrokerSummary, Int32Deserializer,
+                                                 StringDeserializer, Int32Deserializer> {};
+
+class BrokerSummaryV1Deserializer
+    : public CompositeDeserializerWith4Delegates<BrokerSummary, Int32Deserializer,
+                                                 StringDeserializer, Int32Deserializer,
+                                                 NullableStringDeserializer> {};
+
+class PartitionLeaderSummaryV0Deserializer
+    : public CompositeDeserializerWith5Delegates<PartitionLeaderSummary, Int16Deserializer,
+                                                 Int32Deserializer, Int32Deserializer,
+                                                 Int32ArrayDeserializer, Int32ArrayDeserializer> {
+};
+
+class PartitionLeaderSummaryV5Deserializer
+    : public CompositeDeserializerWith6Delegates<PartitionLeaderSummary, Int16Deserializer,
+                                                 Int32Deserializer, Int32Deserializer,
+                                                 Int32ArrayDeserializer, Int32ArrayDeserializer,
+                                                 Int32ArrayDeserializer> {};
+
+class PartitionLeaderSummaryV7Deserializer
+    : public CompositeDeserializerWith7Delegates<
+          PartitionLeaderSummary, Int16Deserializer, Int32Deserializer, Int32Deserializer,
+          Int32Deserializer, Int32ArrayDeserializer, Int32ArrayDeserializer,
+          Int32ArrayDeserializer> {};
+
+class TopicLeadersSummaryV0Deserializer
+    : public CompositeDeserializerWith3Delegates<
+          TopicLeadersSummary, Int16Deserializer, StringDeserializer,
+          ArrayDeserializer<PartitionLeaderSummary, PartitionLeaderSummaryV0Deserializer>> {};
+
+template <typename PartitionDeserializer>
+class TopicLeadersSummaryV1Deserializer
+    : public CompositeDeserializerWith4Delegates<
+          TopicLeadersSummary, Int16Deserializer, StringDeserializer, BooleanDeserializer,
+          ArrayDeserializer<PartitionLeaderSummary, PartitionDeserializer>> {};
+
+class MetadataResponseSummaryV0Deserializer
+    : public CompositeDeserializerWith2Delegates<
+          MetadataResponseSummary, ArrayDeserializer<BrokerSummary, BrokerSummaryV0Deserializer>,
+          ArrayDeserializer<TopicLeadersSummary, TopicLeadersSummaryV0Deserializer>> {};
+
+class MetadataResponseSummaryV1Deserializer
+    : public CompositeDeserializerWith3Delegates<
+          MetadataResponseSummary, ArrayDeserializer<BrokerSummary, BrokerSummaryV1Deserializer>,
+          Int32Deserializer,
+          ArrayDeserializer<TopicLeadersSummary,
+                            TopicLeadersSummaryV1Deserializer<
+                                PartitionLeaderSummaryV0Deserializer>>> {};
+
+class MetadataResponseSummaryV2Deserializer
+    : public CompositeDeserializerWith4Delegates<
+          MetadataResponseSummary, ArrayDeserializer<BrokerSummary, BrokerSummaryV1Deserializer>,
+          NullableStringDeserializer, Int32Deserializer,
+          ArrayDeserializer<TopicLeadersSummary,
+                            TopicLeadersSummaryV1Deserializer<
+                                PartitionLeaderSummaryV0Deserializer>>> {};
+
+/**
+ * Versions 3 and later only differ in their partitions.
+ */
+template <typename PartitionDeserializer>
+class MetadataResponseSummaryV3Deserializer
+    : public CompositeDeserializerWith5Delegates<
+          MetadataResponseSummary, Int32Deserializer,
+          ArrayDeserializer<BrokerSummary, BrokerSummaryV1Deserializer>,
+          NullableStringDeserializer, Int32Deserializer,
+          ArrayDeserializer<TopicLeadersSummary,
+                            TopicLeadersSummaryV1Deserializer<PartitionDeserializer>>> {};
+
+/**
+ * Resolver that parses metadata responses into Response<MetadataResponseSummary>, and the other
+ * responses as the default resolver does.
+ */
+class MetadataResponseSummaryParserResolver : public ResponseParserResolver {
+public:
+  ResponseParserSharedPtr createParser(ResponseContextSharedPtr context) const override;
+
+  static const MetadataResponseSummaryParserResolver& getDefaultInstance();
+};
+
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
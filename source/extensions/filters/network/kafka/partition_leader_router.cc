@@ -0,0 +1,73 @@
+#include "extensions/filters/network/kafka/partition_leader_router.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+
+void PartitionLeaderRouter::onMessage(AbstractResponseSharedPtr response) {
+  if (METADATA_API_KEY != response->metadata_.api_key_) {
+    return;
+  }
+  const auto* metadata = dynamic_cast<const Response<MetadataResponseSummary>*>(response.get());
+  if (metadata != nullptr) {
+    update(metadata->data());
+  }
+}
+
+void PartitionLeaderRouter::update(const MetadataResponseSummary& metadata) {
+  // Every response lists all the live brokers.
+  brokers_.clear();
+  for (const BrokerSummary& broker : metadata.brokers_) {
+    brokers_.emplace(broker.node_id_, broker);
+  }
+
+  for (const TopicLeadersSummary& topic : metadata.topics_) {
+    if (0 != topic.error_code_) {
+      leaders_.erase(topic.name_);
+      continue;
+    }
+    absl::flat_hash_map<int32_t, int32_t>& partitions = leaders_[topic.name_];
+    partitions.clear();
+    for (const PartitionLeaderSummary& partition : topic.partitions_) {
+      // Partitions in the middle of a leader election have no leader.
+      if (0 == partition.error_code_ && partition.leader_ >= 0) {
+        partitions[partition.partition_] = partition.leader_;
+      }
+    }
+  }
+}
+
+const BrokerSummary* PartitionLeaderRouter::leader(const std::string& topic,
+                                                   const int32_t partition) const {
+  const auto topic_it = leaders_.find(topic);
+  if (topic_it == leaders_.end()) {
+    return nullptr;
+  }
+  const auto partition_it = topic_it->second.find(partition);
+  if (partition_it == topic_it->second.end()) {
+    return nullptr;
+  }
+  const auto broker_it = brokers_.find(partition_it->second);
+  return broker_it == brokers_.end() ? nullptr : &broker_it->second;
+}
+
+const BrokerSummary* PartitionLeaderRouter::leader(const ProduceRequestSummary& request) const {
+  const BrokerSummary* result = nullptr;
+  for (const TopicProduceSummary& topic : request.topics_) {
+    for (const PartitionProduceSummary& partition : topic.partitions_) {
+      const BrokerSummary* partition_leader = leader(topic.name_, partition.partition_);
+      if (partition_leader == nullptr ||
+          (result != nullptr && result->node_id_ != partition_leader->node_id_)) {
+        return nullptr;
+      }
+      result = partition_leader;
+    }
+  }
+  return result;
+}
+
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+
+#include "extensions/filters/network/kafka/metadata_response_summary.h"
+#include "extensions/filters/network/kafka/produce_request_summary.h"
+#include "extensions/filters/network/kafka/response_codec.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+
+/**
+ * Finds the brokers leading the partitions addressed by requests, from the metadata responses
+ * received so far. A metadata response replaces the brokers and the leaders of the topics it lists.
+ * It is not thread safe: each worker keeps its own, fed by the responses of its connections, so
+ * that the requests of all the clients of a worker can share its upstream broker connections.
+ * The responses need to be decoded with MetadataResponseSummaryParserResolver.
+ */
+class PartitionLeaderRouter : public ResponseCallback {
+public:
+  // ResponseCallback
+  void onMessage(AbstractResponseSharedPtr response) override;
+  void onFailedParse(ResponseMetadataSharedPtr) override {}
+
+  /**
+   * Updates the brokers and the partition leaders.
+   */
+  void update(const MetadataResponseSummary& metadata);
+
+  /**
+   * @return the leader of a partition, nullptr if it is unknown.
+   */
+  const BrokerSummary* leader(const std::string& topic, int32_t partition) const;
+
+  /**
+   * @return the leader of all the partitions of a produce request, nullptr if one of them is
+   *         unknown or if they have different leaders. Such a request can be sent to any
+   *         broker, which rejects the partitions it does not lead and makes the client refresh
+   *         its metadata.
+   */
+  const BrokerSummary* leader(const ProduceRequestSummary& request) const;
+
+private:
+  absl::flat_hash_map<int32_t, BrokerSummary> brokers_;
+  // Node ids of the leaders, by topic and partition.
+  absl::flat_hash_map<std::string, absl::flat_hash_map<int32_t, int32_t>> leaders_;
+};
+
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,84 @@
+#include "extensions/filters/network/kafka/produce_metrics.h"
+
+#include <chrono>
+
+#include "extensions/filters/network/kafka/produce_request_summary.h"
+
+#include "absl/strings/match.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+
+ProduceStats::ProduceStats(Stats::Scope& scope, const std::string& prefix)
+    : scope_(scope), stat_name_set_(scope.symbolTable()),
+      prefix_(stat_name_set_.add(absl::StripSuffix(prefix, "."))),
+      topic_(stat_name_set_.add("topic")), produce_bytes_(stat_name_set_.add("produce_bytes")),
+      produce_latency_ms_(stat_name_set_.add("produce_latency_ms")),
+      requests_in_flight_(scope.gauge(prefix + "produce_requests_in_flight",
+                                      Stats::Gauge::ImportMode::Accumulate)) {}
+
+Stats::SymbolTable::StoragePtr ProduceStats::join(Stats::StatName topic, Stats::StatName name) {
+  return scope_.symbolTable().join({prefix_, topic_, topic, name});
+}
+
+Stats::Counter& ProduceStats::produceBytes(Stats::StatName topic) {
+  const Stats::SymbolTable::StoragePtr stat_name_storage = join(topic, produce_bytes_);
+  return scope_.counterFromStatName(Stats::StatName(stat_name_storage.get()));
+}
+
+Stats::Histogram& ProduceStats::produceLatency(Stats::StatName topic) {
+  const Stats::SymbolTable::StoragePtr stat_name_storage = join(topic, produce_latency_ms_);
+  return scope_.histogramFromStatName(Stats::StatName(stat_name_storage.get()));
+}
+
+ProduceMetrics::~ProduceMetrics() { stats_->requests_in_flight_.sub(in_flight_.size()); }
+
+void ProduceMetrics::onMessage(AbstractRequestSharedPtr request) {
+  if (PRODUCE_REQUEST_API_KEY != request->request_header_.api_key_) {
+    return;
+  }
+  const auto* produce = dynamic_cast<const Request<ProduceRequestSummary>*>(request.get());
+  if (produce == nullptr) {
+    // Decoded in full, by another resolver.
+    return;
+  }
+
+  std::vector<Stats::StatName> topics;
+  topics.reserve(produce->data().topics_.size());
+  for (const TopicProduceSummary& topic : produce->data().topics_) {
+    topics.push_back(stats_->getStatName(topic.name_));
+    stats_->produceBytes(topics.back()).add(topic.recordSetBytes());
+  }
+
+  // The requests without acknowledgement have no response.
+  if (0 != produce->data().acks_) {
+    const int32_t correlation_id = request->request_header_.correlation_id_;
+    if (in_flight_.find(correlation_id) == in_flight_.end()) {
+      stats_->requests_in_flight_.inc();
+    }
+    in_flight_[correlation_id] = {time_source_.monotonicTime(), std::move(topics)};
+  }
+}
+
+void ProduceMetrics::onResponse(int32_t correlation_id) {
+  const auto it = in_flight_.find(correlation_id);
+  if (it == in_flight_.end()) {
+    return;
+  }
+
+  const uint64_t latency_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  time_source_.monotonicTime() - it->second.start_)
+                                  .count();
+  for (const Stats::StatName topic : it->second.topics_) {
+    stats_->produceLatency(topic).recordValue(latency_ms);
+  }
+  stats_->requests_in_flight_.dec();
+  in_flight_.erase(it);
+}
+
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/stats/scope.h"
+
+#include "common/stats/symbol_table_impl.h"
+
+#include "extensions/filters/network/kafka/request_codec.h"
+#include "extensions/filters/network/kafka/response_codec.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+
+/**
+ * The per topic produce stats, shared by the connections. Their names are joined from StatNames,
+ * so that charging them does not encode anything once the topics have been seen.
+ * As the topics are named by the clients, the number of stats grows with the topics they use.
+ */
+class ProduceStats {
+public:
+  ProduceStats(Stats::Scope& scope, const std::string& prefix);
+
+  /**
+   * @return the stats of a topic: the size of the record sets produced to it, and the time taken
+   *         to acknowledge them.
+   */
+  Stats::Counter& produceBytes(Stats::StatName topic);
+  Stats::Histogram& produceLatency(Stats::StatName topic);
+
+  /**
+   * Finds or creates a StatName for a topic, taking a lock if it has not been seen.
+   */
+  Stats::StatName getStatName(const std::string& topic) {
+    return stat_name_set_.getStatName(topic);
+  }
+
+private:
+  Stats::SymbolTable::StoragePtr join(Stats::StatName topic, Stats::StatName name);
+
+  Stats::Scope& scope_;
+  Stats::StatNameSet stat_name_set_;
+  const Stats::StatName prefix_;
+  const Stats::StatName topic_;
+  const Stats::StatName produce_bytes_;
+  const Stats::StatName produce_latency_ms_;
+
+public:
+  /**
+   * The produce requests sent and not yet acknowledged, across connections. As the clients
+   * pipeline their requests, it exceeds the number of connections when the brokers lag.
+   */
+  Stats::Gauge& requests_in_flight_;
+};
+
+using ProduceStatsSharedPtr = std::shared_ptr<ProduceStats>;
+
+/**
+ * Charges the produce stats from the requests and responses of a connection, matching them by
+ * correlation id. The requests need to be decoded with ProduceRequestSummaryParserResolver, so that
+ * their record sets are only measured.
+ */
+class ProduceMetrics : public RequestCallback, public ResponseCallback {
+public:
+  ProduceMetrics(ProduceStatsSharedPtr stats, TimeSource& time_source)
+      : stats_(std::move(stats)), time_source_(time_source) {}
+  ~ProduceMetrics() override;
+
+  // RequestCallback
+  void onMessage(AbstractRequestSharedPtr request) override;
+  void onFailedParse(RequestParseFailureSharedPtr) override {}
+
+  // ResponseCallback
+  void onMessage(AbstractResponseSharedPtr response) override {
+    onResponse(response->metadata_.correlation_id_);
+  }
+  void onFailedParse(ResponseMetadataSharedPtr metadata) override {
+    onResponse(metadata->correlation_id_);
+  }
+
+private:
+  struct InFlightRequest {
+    MonotonicTime start_;
+    std::vector<Stats::StatName> topics_;
+  };
+
+  void onResponse(int32_t correlation_id);
+
+  const ProduceStatsSharedPtr stats_;
+  TimeSource& time_source_;
+  absl::flat_hash_map<int32_t, InFlightRequest> in_flight_;
+};
+
+using ProduceMetricsSharedPtr = std::shared_ptr<ProduceMetrics>;
+
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,32 @@
+#include "extensions/filters/network/kafka/produce_request_summary.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+
+RequestParserSharedPtr
+ProduceRequestSummaryParserResolver::createParser(int16_t api_key, int16_t api_version,
+                                                  RequestContextSharedPtr context) const {
+  if (PRODUCE_REQUEST_API_KEY == api_key) {
+    if (api_version >= 0 && api_version < 3) {
+      return std::make_shared<
+          RequestDataParser<ProduceRequestSummary, ProduceRequestSummaryV0Deserializer>>(context);
+    }
+    if (api_version >= 3 && api_version < 8) {
+      return std::make_shared<
+          RequestDataParser<ProduceRequestSummary, ProduceRequestSummaryV3Deserializer>>(context);
+    }
+  }
+  return RequestParserResolver::createParser(api_key, api_version, context);
+}
+
+const ProduceRequestSummaryParserResolver&
+ProduceRequestSummaryParserResolver::getDefaultInstance() {
+  CONSTRUCT_ON_FIRST_USE(ProduceRequestSummaryParserResolver);
+}
+
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "extensions/filters/network/kafka/kafka_request.h"
+#include "extensions/filters/network/kafka/kafka_request_parser.h"
+#include "extensions/filters/network/kafka/serialization.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+
+/**
+ * Produce request api key.
+ * @see http://kafka.apache.org/protocol.html#The_Messages_Produce
+ */
+constexpr int16_t PRODUCE_REQUEST_API_KEY = 0;
+
+/**
+ * The partition of a produce request, with the size of its record set rather than the record set.
+ */
+struct PartitionProduceSummary {
+  const int32_t partition_;
+  // The size of the record set, -1 if it was null.
+  const int32_t record_set_size_;
+
+  uint32_t computeSize(const EncodingContext& encoder) const {
+    return encoder.computeSize(partition_) + sizeof(int32_t) + std::max(record_set_size_, 0);
+  }
+
+  bool operator==(const PartitionProduceSummary& rhs) const {
+    return partition_ == rhs.partition_ && record_set_size_ == rhs.record_set_size_;
+  };
+};
+
+/**
+ * The topic of a produce request, with the summaries of its partitions.
+ */
+struct TopicProduceSummary {
+  const std::string name_;
+  const std::vector<PartitionProduceSummary> partitions_;
+
+  /**
+   * @return the total size of the record sets produced to the topic.
+   */
+  uint64_t recordSetBytes() const {
+    uint64_t result = 0;
+    for (const PartitionProduceSummary& partition : partitions_) {
+      result += std::max(partition.record_set_size_, 0);
+    }
+    return result;
+  }
+
+  uint32_t computeSize(const EncodingContext& encoder) const {
+    return encoder.computeSize(name_) + encoder.computeSize(partitions_);
+  }
+
+  bool operator==(const TopicProduceSummary& rhs) const {
+    return name_ == rhs.name_ && partitions_ == rhs.partitions_;
+  };
+};
+
+/**
+ * The data of a produce request without its record sets, which are skipped while parsing rather
+ * than copied, as the requests themselves are passed through as received.
+ * As the record sets are not kept, the summary can not be encoded.
+ * @see http://kafka.apache.org/protocol.html#The_Messages_Produce
+ */
+struct ProduceRequestSummary {
+  // Version 0-2.
+  ProduceRequestSummary(int16_t acks, int32_t timeout, std::vector<TopicProduceSummary> topics)
+      : ProduceRequestSummary(absl::nullopt, acks, timeout, std::move(topics)){};
+
+  // Version 3+.
+  ProduceRequestSummary(NullableString transactional_id, int16_t acks, int32_t timeout,
+                        std::vector<TopicProduceSummary> topics)
+      : transactional_id_{transactional_id}, acks_{acks}, timeout_{timeout},
+        topics_{std::move(topics)} {};
+
+  const NullableString transactional_id_;
+  const int16_t acks_;
+  const int32_t timeout_;
+  const std::vector<TopicProduceSummary> topics_;
+
+  uint32_t computeSize(const EncodingContext& encoder) const {
+    uint32_t result = 0;
+    if (encoder.apiVersion() >= 3) {
+      result += encoder.computeSize(transactional_id_);
+    }
+    result += encoder.computeSize(acks_);
+    result += encoder.computeSize(timeout_);
+    result += encoder.computeSize(topics_);
+    return result;
+  }
+
+  uint32_t encode(Buffer::Instance&, EncodingContext&) const {
+    throw EnvoyException("produce request summaries can not be encoded");
+  }
+
+  bool operator==(const ProduceRequestSummary& rhs) const {
+    return transactional_id_ == rhs.transactional_id_ && acks_ == rhs.acks_ &&
+           timeout_ == rhs.timeout_ && topics_ == rhs.topics_;
+  };
+};
+
+class PartitionProduceSummaryDeserializer
+    : public CompositeDeserializerWith2Delegates<PartitionProduceSummary, Int32Deserializer,
+                                                 NullableBytesLengthDeserializer> {};
+
+class TopicProduceSummaryDeserializer
+    : public CompositeDeserializerWith2Delegates<
+          TopicProduceSummary, StringDeserializer,
+          ArrayDeserializer<PartitionProduceSummary, PartitionProduceSummaryDeserializer>> {};
+
+class ProduceRequestSummaryV0Deserializer
+    : public CompositeDeserializerWith3Delegates<
+          ProduceRequestSummary, Int16Deserializer, Int32Deserializer,
+          ArrayDeserializer<TopicProduceSummary, TopicProduceSummaryDeserializer>> {};
+
+class ProduceRequestSummaryV3Deserializer
+    : public CompositeDeserializerWith4Delegates<
+          ProduceRequestSummary, NullableStringDeserializer, Int16Deserializer, Int32Deserializer,
+          ArrayDeserializer<TopicProduceSummary, TopicProduceSummaryDeserializer>> {};
+
+/**
+ * Resolver that parses produce requests into Request<ProduceRequestSummary>, without copying their
+ * record sets, and the other requests as the default resolver does.
+ */
+class ProduceRequestSummaryParserResolver : public RequestParserResolver {
+public:
+  RequestParserSharedPtr createParser(int16_t api_key, int16_t api_version,
+                                      RequestContextSharedPtr context) const override;
+
+  static const ProduceRequestSummaryParserResolver& getDefaultInstance();
+};
+
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -104,6 +104,29 @@ uint32_t NullableBytesDeserializer::feed(absl::string_view& data) {
       data, length_buf_, length_consumed_, required_, data_buf_, ready_, NULL_BYTES_LENGTH, true);
 }
 
+uint32_t NullableBytesLengthDeserializer::feed(absl::string_view& data) {
+  const uint32_t length_consumed = length_buf_.feed(data);
+  if (!length_buf_.ready()) {
+    // Break early: we still need to fill in length buffer.
+    return length_consumed;
+  }
+
+  if (!length_consumed_) {
+    length_ = length_buf_.get();
+    if (length_ < NULL_BYTES_LENGTH) {
+      throw EnvoyException(fmt::format("invalid length: {}", length_));
+    }
+    required_ = length_ == NULL_BYTES_LENGTH ? 0 : length_;
+    length_consumed_ = true;
+  }
+
+  // The bytes are only skipped.
+  const uint32_t data_consumed = std::min<uint32_t>(required_, data.size());
+  data = {data.data() + data_consumed, data.size() - data_consumed};
+  required_ -= data_consumed;
+  return length_consumed + data_consumed;
+}
+
 } // namespace Kafka
 } // namespace NetworkFilters
 } // namespace Extensions
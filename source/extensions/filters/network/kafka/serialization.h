@@ -289,6 +289,29 @@ private:
   bool ready_{false};
 };
 
+/**
+ * Deserializer of nullable bytes value that skips the bytes rather than copying them, for the
+ * payloads that only need to be measured (e.g. the record sets of produce requests).
+ * Returns the length of the value, -1 meaning null.
+ */
+class NullableBytesLengthDeserializer : public Deserializer<int32_t> {
+public:
+  /**
+   * Can throw EnvoyException if given bytes length is not valid.
+   */
+  uint32_t feed(absl::string_view& data) override;
+
+  bool ready() const override { return length_consumed_ && 0 == required_; }
+
+  int32_t get() const override { return length_; }
+
+private:
+  Int32Deserializer length_buf_;
+  bool length_consumed_{false};
+  int32_t length_;
+  uint32_t required_{0};
+};
+
 /**
  * Deserializer for array of objects of the same type.
  *
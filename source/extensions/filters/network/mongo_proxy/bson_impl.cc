@@ -1,9 +1,11 @@
 #include "extensions/filters/network/mongo_proxy/bson_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <sstream>
 #include <string>
 
+#include "common/buffer/reader.h"
 #include "common/common/assert.h"
 #include "common/common/byte_order.h"
 #include "common/common/fmt.h"
@@ -21,10 +23,7 @@ int32_t BufferHelper::peekInt32(Buffer::Instance& data) {
     throw EnvoyException("invalid buffer size");
   }
 
-  int32_t val;
-  void* mem = data.linearize(sizeof(int32_t));
-  std::memcpy(reinterpret_cast<void*>(&val), mem, sizeof(int32_t));
-  return le32toh(val);
+  return data.peekLEInt<int32_t>();
 }
 
 uint8_t BufferHelper::removeByte(Buffer::Instance& data) {
@@ -32,10 +31,7 @@ uint8_t BufferHelper::removeByte(Buffer::Instance& data) {
     throw EnvoyException("invalid buffer size");
   }
 
-  void* mem = data.linearize(sizeof(uint8_t));
-  uint8_t ret = *reinterpret_cast<uint8_t*>(mem);
-  data.drain(sizeof(uint8_t));
-  return ret;
+  return data.drainLEInt<uint8_t>();
 }
 
 void BufferHelper::removeBytes(Buffer::Instance& data, uint8_t* out, size_t out_len) {
@@ -43,20 +39,18 @@ void BufferHelper::removeBytes(Buffer::Instance& data, uint8_t* out, size_t out_
     throw EnvoyException("invalid buffer size");
   }
 
-  void* mem = data.linearize(out_len);
-  std::memcpy(out, mem, out_len);
+  Buffer::Reader(data).read(out, out_len);
   data.drain(out_len);
 }
 
 std::string BufferHelper::removeCString(Buffer::Instance& data) {
-  char end = '\0';
-  ssize_t index = data.search(&end, sizeof(end), 0);
+  Buffer::Reader reader(data);
+  const ssize_t index = reader.find('\0');
   if (index == -1) {
     throw EnvoyException("invalid CString");
   }
 
-  char* start = reinterpret_cast<char*>(data.linearize(index + 1));
-  std::string ret(start);
+  std::string ret = reader.readString(index);
   data.drain(index + 1);
   return ret;
 }
@@ -87,11 +81,7 @@ int64_t BufferHelper::removeInt64(Buffer::Instance& data) {
     throw EnvoyException("invalid buffer size");
   }
 
-  int64_t val;
-  void* mem = data.linearize(sizeof(int64_t));
-  std::memcpy(reinterpret_cast<void*>(&val), mem, sizeof(int64_t));
-  data.drain(sizeof(int64_t));
-  return le64toh(val);
+  return data.drainLEInt<int64_t>();
 }
 
 std::string BufferHelper::removeString(Buffer::Instance& data) {
@@ -100,8 +90,10 @@ std::string BufferHelper::removeString(Buffer::Instance& data) {
     throw EnvoyException("invalid buffer size");
   }
 
-  char* start = reinterpret_cast<char*>(data.linearize(length));
-  std::string ret(start);
+  // The string ends at its first null byte, normally the last one of its length.
+  Buffer::Reader reader(data);
+  const ssize_t end = reader.find('\0');
+  std::string ret = reader.readString(end >= 0 && end < length ? end : length);
   data.drain(length);
   return ret;
 }
@@ -114,8 +106,7 @@ std::string BufferHelper::removeBinary(Buffer::Instance& data) {
     throw EnvoyException("invalid buffer size");
   }
 
-  char* start = reinterpret_cast<char*>(data.linearize(length));
-  std::string ret(start, length);
+  std::string ret = Buffer::Reader(data).readString(length);
   data.drain(length);
   return ret;
 }
@@ -153,6 +144,146 @@ void BufferHelper::writeBinary(Buffer::Instance& data, const std::string& value)
   data.add(value.c_str(), value.size());
 }
 
+namespace {
+
+// The size of an empty document: its length and its terminating byte.
+constexpr uint32_t MinDocumentSize = sizeof(int32_t) + 1;
+
+// The read*() functions consume the value at the start of the data, which is left in place, the
+// values referring to it rather than being copied.
+
+absl::string_view readBytes(absl::string_view& data, size_t length) {
+  if (data.size() < length) {
+    throw EnvoyException("invalid buffer size");
+  }
+
+  const absl::string_view ret = data.substr(0, length);
+  data.remove_prefix(length);
+  return ret;
+}
+
+uint8_t readByte(absl::string_view& data) { return readBytes(data, 1)[0]; }
+
+int32_t readInt32(absl::string_view& data) {
+  int32_t val;
+  std::memcpy(&val, readBytes(data, sizeof(int32_t)).data(), sizeof(int32_t));
+  return le32toh(val);
+}
+
+int64_t readInt64(absl::string_view& data) {
+  int64_t val;
+  std::memcpy(&val, readBytes(data, sizeof(int64_t)).data(), sizeof(int64_t));
+  return le64toh(val);
+}
+
+absl::string_view readCString(absl::string_view& data) {
+  const size_t index = data.find('\0');
+  if (index == absl::string_view::npos) {
+    throw EnvoyException("invalid CString");
+  }
+
+  const absl::string_view ret = data.substr(0, index);
+  data.remove_prefix(index + 1);
+  return ret;
+}
+
+absl::string_view readString(absl::string_view& data) {
+  const uint32_t length = readInt32(data);
+  const absl::string_view value = readBytes(data, length);
+  // The length includes the terminating null character.
+  return value.substr(0, value.find('\0'));
+}
+
+absl::string_view readBinary(absl::string_view& data) {
+  // Read out the subtype but do not store it for now.
+  const uint32_t length = readInt32(data);
+  readByte(data);
+  return readBytes(data, length);
+}
+
+absl::string_view readDocument(absl::string_view& data) {
+  absl::string_view header = data;
+  const uint32_t length = readInt32(header);
+  if (length < MinDocumentSize || length > data.size()) {
+    throw EnvoyException("invalid BSON message length");
+  }
+
+  return readBytes(data, length);
+}
+
+// The elements of an encoded document, between its length and its terminating byte.
+absl::string_view elements(absl::string_view document) {
+  return document.substr(sizeof(int32_t), document.size() - MinDocumentSize);
+}
+
+void skipValue(absl::string_view& data, Field::Type type) {
+  switch (type) {
+  case Field::Type::DOUBLE:
+  case Field::Type::DATETIME:
+  case Field::Type::TIMESTAMP:
+  case Field::Type::INT64:
+    readBytes(data, sizeof(int64_t));
+    return;
+
+  case Field::Type::STRING:
+  case Field::Type::SYMBOL:
+    readString(data);
+    return;
+
+  case Field::Type::DOCUMENT:
+  case Field::Type::ARRAY:
+    readDocument(data);
+    return;
+
+  case Field::Type::BINARY:
+    readBinary(data);
+    return;
+
+  case Field::Type::OBJECT_ID:
+    readBytes(data, sizeof(Field::ObjectId));
+    return;
+
+  case Field::Type::BOOLEAN:
+    readByte(data);
+    return;
+
+  case Field::Type::NULL_VALUE:
+    return;
+
+  case Field::Type::REGEX:
+    readCString(data);
+    readCString(data);
+    return;
+
+  case Field::Type::INT32:
+    readBytes(data, sizeof(int32_t));
+    return;
+  }
+
+  throw EnvoyException(
+      fmt::format("invalid BSON element type: {:#x}", static_cast<uint8_t>(type)));
+}
+
+// Checks the encoding of a document and of its sub-documents, without decoding their fields.
+void validate(absl::string_view document) {
+  if (document.back() != 0) {
+    throw EnvoyException("invalid document");
+  }
+
+  absl::string_view data = elements(document);
+  while (!data.empty()) {
+    const Field::Type type = static_cast<Field::Type>(readByte(data));
+    readCString(data);
+    if (type == Field::Type::DOCUMENT || type == Field::Type::ARRAY) {
+      validate(readDocument(data));
+    } else {
+      skipValue(data, type);
+    }
+  }
+}
+
+} // namespace
+
 int32_t FieldImpl::byteSize() const {
   // 1 byte type, cstring key, field.
   int32_t total = 1 + key_.size() + 1;
@@ -372,137 +503,106 @@ std::string FieldImpl::toString() const {
   NOT_REACHED_GCOVR_EXCL_LINE;
 }
 
-void DocumentImpl::fromBuffer(Buffer::Instance& data) {
-  uint64_t original_buffer_length = data.length();
-  int32_t message_length = BufferHelper::removeInt32(data);
-  if (static_cast<uint64_t>(message_length) > original_buffer_length) {
+DocumentSharedPtr DocumentImpl::create(Buffer::Instance& data) {
+  const uint32_t length = BufferHelper::peekInt32(data);
+  if (length < MinDocumentSize || length > data.length()) {
     throw EnvoyException("invalid BSON message length");
   }
 
-  ENVOY_LOG(trace, "BSON document length: {} data length: {}", message_length,
-            original_buffer_length);
-
-  while (true) {
-    uint64_t document_bytes_remaining = data.length() - (original_buffer_length - message_length);
-    ENVOY_LOG(trace, "BSON document bytes remaining: {}", document_bytes_remaining);
-    if (document_bytes_remaining == 1) {
-      uint8_t last_byte = BufferHelper::removeByte(data);
-      if (last_byte != 0) {
-        throw EnvoyException("invalid document");
-      }
-
-      return;
-    }
-
-    uint8_t element_type = BufferHelper::removeByte(data);
-    std::string key = BufferHelper::removeCString(data);
-    ENVOY_LOG(trace, "BSON element type: {:#x} key: {}", element_type, key);
-    switch (static_cast<Field::Type>(element_type)) {
-    case Field::Type::DOUBLE: {
-      double value = BufferHelper::removeDouble(data);
-      ENVOY_LOG(trace, "BSON double: {}", value);
-      addDouble(key, value);
-      break;
-    }
+  ENVOY_LOG(trace, "BSON document length: {} data length: {}", length, data.length());
+  auto storage = std::make_shared<std::string>(length, '\0');
+  data.copyOut(0, length, &(*storage)[0]);
+  data.drain(length);
+  validate(*storage);
 
-    case Field::Type::STRING: {
-      std::string value = BufferHelper::removeString(data);
-      ENVOY_LOG(trace, "BSON string: {}", value);
-      addString(key, std::move(value));
-      break;
-    }
+  const absl::string_view encoded = *storage;
+  return DocumentSharedPtr{new DocumentImpl(std::move(storage), encoded)};
+}
 
-    case Field::Type::SYMBOL: {
-      std::string value = BufferHelper::removeString(data);
-      ENVOY_LOG(trace, "BSON symbol: {}", value);
-      addSymbol(key, std::move(value));
-      break;
-    }
+FieldPtr DocumentImpl::decodeField(Field::Type type, absl::string_view key,
+                                   absl::string_view& data) const {
+  ENVOY_LOG(trace, "BSON element type: {:#x} key: {}", static_cast<uint8_t>(type), key);
+  const std::string field_key(key);
+  switch (type) {
+  case Field::Type::DOUBLE: {
+    const int64_t bits = readInt64(data);
+    double value;
+    static_assert(sizeof(bits) == sizeof(value), "invalid type size");
+    std::memcpy(&value, &bits, sizeof(value));
+    return std::make_unique<FieldImpl>(field_key, value);
+  }
 
-    case Field::Type::DOCUMENT: {
-      ENVOY_LOG(trace, "BSON document");
-      addDocument(key, DocumentImpl::create(data));
-      break;
-    }
+  case Field::Type::STRING:
+  case Field::Type::SYMBOL:
+    return std::make_unique<FieldImpl>(type, field_key, std::string(readString(data)));
 
-    case Field::Type::ARRAY: {
-      ENVOY_LOG(trace, "BSON array");
-      addArray(key, DocumentImpl::create(data));
-      break;
-    }
+  case Field::Type::DOCUMENT:
+  case Field::Type::ARRAY:
+    return std::make_unique<FieldImpl>(
+        type, field_key, DocumentSharedPtr{new DocumentImpl(storage_, readDocument(data))});
 
-    case Field::Type::BINARY: {
-      std::string value = BufferHelper::removeBinary(data);
-      ENVOY_LOG(trace, "BSON binary: {}", value);
-      addBinary(key, std::move(value));
-      break;
-    }
+  case Field::Type::BINARY:
+    return std::make_unique<FieldImpl>(type, field_key, std::string(readBinary(data)));
 
-    case Field::Type::OBJECT_ID: {
-      Field::ObjectId value;
-      BufferHelper::removeBytes(data, &value[0], value.size());
-      addObjectId(key, std::move(value));
-      break;
-    }
+  case Field::Type::OBJECT_ID: {
+    Field::ObjectId value;
+    const absl::string_view bytes = readBytes(data, value.size());
+    std::copy(bytes.begin(), bytes.end(), value.begin());
+    return std::make_unique<FieldImpl>(field_key, std::move(value));
+  }
 
-    case Field::Type::BOOLEAN: {
-      bool value = BufferHelper::removeByte(data) != 0;
-      ENVOY_LOG(trace, "BSON boolean: {}", value);
-      addBoolean(key, value);
-      break;
-    }
+  case Field::Type::BOOLEAN:
+    return std::make_unique<FieldImpl>(field_key, readByte(data) != 0);
 
-    case Field::Type::DATETIME: {
-      int64_t value = BufferHelper::removeInt64(data);
-      ENVOY_LOG(trace, "BSON datetime: {}", value);
-      addDatetime(key, value);
-      break;
-    }
+  case Field::Type::DATETIME:
+  case Field::Type::TIMESTAMP:
+  case Field::Type::INT64:
+    return std::make_unique<FieldImpl>(type, field_key, readInt64(data));
 
-    case Field::Type::NULL_VALUE: {
-      ENVOY_LOG(trace, "BSON null value");
-      addNull(key);
-      break;
-    }
+  case Field::Type::NULL_VALUE:
+    return std::make_unique<FieldImpl>(field_key);
 
-    case Field::Type::REGEX: {
-      Field::Regex value;
-      value.pattern_ = BufferHelper::removeCString(data);
-      value.options_ = BufferHelper::removeCString(data);
-      ENVOY_LOG(trace, "BSON regex pattern: {} options: {}", value.pattern_, value.options_);
-      addRegex(key, std::move(value));
-      break;
-    }
+  case Field::Type::REGEX: {
+    Field::Regex value;
+    value.pattern_ = std::string(readCString(data));
+    value.options_ = std::string(readCString(data));
+    return std::make_unique<FieldImpl>(field_key, std::move(value));
+  }
 
-    case Field::Type::INT32: {
-      int32_t value = BufferHelper::removeInt32(data);
-      ENVOY_LOG(trace, "BSON int32: {}", value);
-      addInt32(key, value);
-      break;
-    }
+  case Field::Type::INT32:
+    return std::make_unique<FieldImpl>(field_key, readInt32(data));
+  }
 
-    case Field::Type::TIMESTAMP: {
-      int64_t value = BufferHelper::removeInt64(data);
-      ENVOY_LOG(trace, "BSON timestamp: {}", value);
-      addTimestamp(key, value);
-      break;
-    }
+  // The element types were checked when the document was created.
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
 
-    case Field::Type::INT64: {
-      int64_t value = BufferHelper::removeInt64(data);
-      ENVOY_LOG(trace, "BSON int64: {}", value);
-      addInt64(key, value);
-      break;
-    }
+std::list<FieldPtr>& DocumentImpl::mutableFields() {
+  values();
+  storage_.reset();
+  encoded_ = {};
+  return fields_;
+}
 
-    default:
-      throw EnvoyException(
-          fmt::format("invalid BSON element type: {:#x} key: {}", element_type, key));
+const std::list<FieldPtr>& DocumentImpl::values() const {
+  if (encoded() && !decoded_) {
+    absl::string_view data = elements(encoded_);
+    while (!data.empty()) {
+      const Field::Type type = static_cast<Field::Type>(readByte(data));
+      const absl::string_view key = readCString(data);
+      fields_.push_back(decodeField(type, key, data));
     }
+    decoded_ = true;
   }
+
+  return fields_;
 }
 
 int32_t DocumentImpl::byteSize() const {
+  if (encoded()) {
+    return encoded_.size();
+  }
+
   // Minimum size is 5.
   int32_t total_size = sizeof(int32_t) + 1;
   for (const FieldPtr& field : fields_) {
@@ -513,6 +613,11 @@ int32_t DocumentImpl::byteSize() const {
 }
 
 void DocumentImpl::encode(Buffer::Instance& output) const {
+  if (encoded()) {
+    output.add(encoded_.data(), encoded_.size());
+    return;
+  }
+
   BufferHelper::writeInt32(output, byteSize());
   for (const FieldPtr& field : fields_) {
     field->encode(output);
@@ -543,7 +648,7 @@ std::string DocumentImpl::toString() const {
   out << "{";
 
   bool first = true;
-  for (const FieldPtr& field : fields_) {
+  for (const FieldPtr& field : values()) {
     if (!first) {
       out << ", ";
     }
@@ -556,21 +661,33 @@ std::string DocumentImpl::toString() const {
   return out.str();
 }
 
-const Field* DocumentImpl::find(const std::string& name) const {
-  for (const FieldPtr& field : fields_) {
-    if (field->key() == name) {
-      return field.get();
-    }
-  }
+const Field* DocumentImpl::find(const std::string& name) const { return find(name, nullptr); }
 
-  return nullptr;
+const Field* DocumentImpl::find(const std::string& name, Field::Type type) const {
+  return find(name, &type);
 }
 
-const Field* DocumentImpl::find(const std::string& name, Field::Type type) const {
-  for (const FieldPtr& field : fields_) {
-    if (field->key() == name && field->type() == type) {
-      return field.get();
+const Field* DocumentImpl::find(const std::string& name, const Field::Type* type) const {
+  if (!encoded() || decoded_) {
+    for (const FieldPtr& field : fields_) {
+      if (field->key() == name && (type == nullptr || field->type() == *type)) {
+        return field.get();
+      }
+    }
+
+    return nullptr;
+  }
+
+  // The fields are scanned in place, and only the one found is decoded.
+  absl::string_view data = elements(encoded_);
+  while (!data.empty()) {
+    const Field::Type element_type = static_cast<Field::Type>(readByte(data));
+    const absl::string_view key = readCString(data);
+    if (key == name && (type == nullptr || element_type == *type)) {
+      found_fields_.push_back(decodeField(element_type, key, data));
+      return found_fields_.back().get();
     }
+    skipValue(data, element_type);
   }
 
   return nullptr;
@@ -11,6 +11,8 @@
 
 #include "extensions/filters/network/mongo_proxy/bson.h"
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -182,80 +184,82 @@ class DocumentImpl : public Document,
                      public std::enable_shared_from_this<DocumentImpl> {
 public:
   static DocumentSharedPtr create() { return DocumentSharedPtr{new DocumentImpl()}; }
-  static DocumentSharedPtr create(Buffer::Instance& data) {
-    std::shared_ptr<DocumentImpl> new_doc{new DocumentImpl()};
-    new_doc->fromBuffer(data);
-    return new_doc;
-  }
+
+  /**
+   * Create a document from the one encoded at the start of the data, which is drained of it. The
+   * encoding is checked right away, but the fields are only decoded when they are accessed, and the
+   * document is encoded again as it was received until it is modified.
+   */
+  static DocumentSharedPtr create(Buffer::Instance& data);
 
   // Mongo::Document
   DocumentSharedPtr addDouble(const std::string& key, double value) override {
-    fields_.emplace_back(new FieldImpl(key, value));
+    mutableFields().emplace_back(new FieldImpl(key, value));
     return shared_from_this();
   }
 
   DocumentSharedPtr addString(const std::string& key, std::string&& value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::STRING, key, std::move(value)));
+    mutableFields().emplace_back(new FieldImpl(Field::Type::STRING, key, std::move(value)));
     return shared_from_this();
   }
 
   DocumentSharedPtr addSymbol(const std::string& key, std::string&& value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::SYMBOL, key, std::move(value)));
+    mutableFields().emplace_back(new FieldImpl(Field::Type::SYMBOL, key, std::move(value)));
     return shared_from_this();
   }
 
   DocumentSharedPtr addDocument(const std::string& key, DocumentSharedPtr value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::DOCUMENT, key, value));
+    mutableFields().emplace_back(new FieldImpl(Field::Type::DOCUMENT, key, value));
     return shared_from_this();
   }
 
   DocumentSharedPtr addArray(const std::string& key, DocumentSharedPtr value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::ARRAY, key, value));
+    mutableFields().emplace_back(new FieldImpl(Field::Type::ARRAY, key, value));
     return shared_from_this();
   }
 
   DocumentSharedPtr addBinary(const std::string& key, std::string&& value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::BINARY, key, std::move(value)));
+    mutableFields().emplace_back(new FieldImpl(Field::Type::BINARY, key, std::move(value)));
     return shared_from_this();
   }
 
   DocumentSharedPtr addObjectId(const std::string& key, Field::ObjectId&& value) override {
-    fields_.emplace_back(new FieldImpl(key, std::move(value)));
+    mutableFields().emplace_back(new FieldImpl(key, std::move(value)));
     return shared_from_this();
   }
 
   DocumentSharedPtr addBoolean(const std::string& key, bool value) override {
-    fields_.emplace_back(new FieldImpl(key, value));
+    mutableFields().emplace_back(new FieldImpl(key, value));
     return shared_from_this();
   }
 
   DocumentSharedPtr addDatetime(const std::string& key, int64_t value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::DATETIME, key, value));
+    mutableFields().emplace_back(new FieldImpl(Field::Type::DATETIME, key, value));
     return shared_from_this();
   }
 
   DocumentSharedPtr addNull(const std::string& key) override {
-    fields_.emplace_back(new FieldImpl(key));
+    mutableFields().emplace_back(new FieldImpl(key));
     return shared_from_this();
   }
 
   DocumentSharedPtr addRegex(const std::string& key, Field::Regex&& value) override {
-    fields_.emplace_back(new FieldImpl(key, std::move(value)));
+    mutableFields().emplace_back(new FieldImpl(key, std::move(value)));
     return shared_from_this();
   }
 
   DocumentSharedPtr addInt32(const std::string& key, int32_t value) override {
-    fields_.emplace_back(new FieldImpl(key, value));
+    mutableFields().emplace_back(new FieldImpl(key, value));
     return shared_from_this();
   }
 
   DocumentSharedPtr addTimestamp(const std::string& key, int64_t value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::TIMESTAMP, key, value));
+    mutableFields().emplace_back(new FieldImpl(Field::Type::TIMESTAMP, key, value));
     return shared_from_this();
   }
 
   DocumentSharedPtr addInt64(const std::string& key, int64_t value) override {
-    fields_.emplace_back(new FieldImpl(Field::Type::INT64, key, value));
+    mutableFields().emplace_back(new FieldImpl(Field::Type::INT64, key, value));
     return shared_from_this();
   }
 
@@ -265,14 +269,27 @@ public:
   const Field* find(const std::string& name) const override;
   const Field* find(const std::string& name, Field::Type type) const override;
   std::string toString() const override;
-  const std::list<FieldPtr>& values() const override { return fields_; }
+  const std::list<FieldPtr>& values() const override;
 
 private:
   DocumentImpl() = default;
-
-  void fromBuffer(Buffer::Instance& data);
-
-  std::list<FieldPtr> fields_;
+  DocumentImpl(std::shared_ptr<const std::string> storage, absl::string_view encoded)
+      : storage_(std::move(storage)), encoded_(encoded) {}
+
+  bool encoded() const { return storage_ != nullptr; }
+  const Field* find(const std::string& name, const Field::Type* type) const;
+  FieldPtr decodeField(Field::Type type, absl::string_view key, absl::string_view& data) const;
+  std::list<FieldPtr>& mutableFields();
+
+  // The encoding the document was received in, shared with its sub-documents. It is dropped once
+  // the document is modified.
+  std::shared_ptr<const std::string> storage_;
+  absl::string_view encoded_;
+  // Whether all the fields of the encoding were decoded into fields_.
+  mutable bool decoded_{};
+  mutable std::list<FieldPtr> fields_;
+  // The fields decoded on their own by find(), before all of them were.
+  mutable std::list<FieldPtr> found_fields_;
 };
 
 } // namespace Bson
@@ -0,0 +1,54 @@
+#include "extensions/filters/network/mongo_proxy/mongo_stats.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/scope.h"
+
+#include "common/stats/symbol_table_impl.h"
+
+#include "absl/strings/match.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace MongoProxy {
+
+MongoStats::MongoStats(Stats::Scope& scope, const std::string& prefix)
+    : scope_(scope), stat_name_set_(scope.symbolTable()),
+      prefix_(stat_name_set_.add(absl::StripSuffix(prefix, "."))),
+      callsite_(stat_name_set_.add("callsite")), cmd_(stat_name_set_.add("cmd")),
+      collection_(stat_name_set_.add("collection")), multi_get_(stat_name_set_.add("multi_get")),
+      query_(stat_name_set_.add("query")), reply_num_docs_(stat_name_set_.add("reply_num_docs")),
+      reply_size_(stat_name_set_.add("reply_size")),
+      reply_time_ms_(stat_name_set_.add("reply_time_ms")),
+      scatter_get_(stat_name_set_.add("scatter_get")), total_(stat_name_set_.add("total")) {
+  // The most common commands are looked up without taking a lock.
+  stat_name_set_.rememberBuiltins({"aggregate", "buildInfo", "count", "delete", "distinct",
+                                   "find", "findAndModify", "getLastError", "getMore", "insert",
+                                   "isMaster", "ismaster", "ping", "update"});
+}
+
+Stats::SymbolTable::StoragePtr MongoStats::addPrefix(const Stats::StatNameVec& names) {
+  Stats::StatNameVec names_with_prefix;
+  names_with_prefix.reserve(1 + names.size());
+  names_with_prefix.push_back(prefix_);
+  names_with_prefix.insert(names_with_prefix.end(), names.begin(), names.end());
+  return scope_.symbolTable().join(names_with_prefix);
+}
+
+Stats::Counter& MongoStats::counter(const Stats::StatNameVec& names) {
+  const Stats::SymbolTable::StoragePtr stat_name_storage = addPrefix(names);
+  return scope_.counterFromStatName(Stats::StatName(stat_name_storage.get()));
+}
+
+Stats::Histogram& MongoStats::histogram(const Stats::StatNameVec& names) {
+  const Stats::SymbolTable::StoragePtr stat_name_storage = addPrefix(names);
+  return scope_.histogramFromStatName(Stats::StatName(stat_name_storage.get()));
+}
+
+} // namespace MongoProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/scope.h"
+
+#include "common/stats/symbol_table_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace MongoProxy {
+
+/**
+ * The per command, collection and callsite stats of the mongo filters sharing a config. Their names
+ * are joined from StatNames, so that charging them does not encode anything once the commands,
+ * collections and callsites of the traffic have been seen.
+ */
+class MongoStats {
+public:
+  MongoStats(Stats::Scope& scope, const std::string& prefix);
+
+  Stats::Counter& counter(const Stats::StatNameVec& names);
+  Stats::Histogram& histogram(const Stats::StatNameVec& names);
+
+  /**
+   * Finds or creates a StatName by string, taking a global lock if needed.
+   */
+  Stats::StatName getStatName(const std::string& str) { return stat_name_set_.getStatName(str); }
+
+  /**
+   * @return uint64_t the number of command, collection and callsite names which had to be encoded.
+   */
+  uint64_t dynamicEncodings() const { return stat_name_set_.dynamicEncodings(); }
+
+private:
+  Stats::SymbolTable::StoragePtr addPrefix(const Stats::StatNameVec& names);
+
+  Stats::Scope& scope_;
+  Stats::StatNameSet stat_name_set_;
+  const Stats::StatName prefix_;
+
+public:
+  const Stats::StatName callsite_;
+  const Stats::StatName cmd_;
+  const Stats::StatName collection_;
+  const Stats::StatName multi_get_;
+  const Stats::StatName query_;
+  const Stats::StatName reply_num_docs_;
+  const Stats::StatName reply_size_;
+  const Stats::StatName reply_time_ms_;
+  const Stats::StatName scatter_get_;
+  const Stats::StatName total_;
+};
+using MongoStatsSharedPtr = std::shared_ptr<MongoStats>;
+
+} // namespace MongoProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
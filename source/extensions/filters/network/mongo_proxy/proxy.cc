@@ -58,11 +58,11 @@ ProxyFilter::ProxyFilter(const std::string& stat_prefix, Stats::Scope& scope,
                          Runtime::Loader& runtime, AccessLogSharedPtr access_log,
                          const Filters::Common::Fault::FaultDelayConfigSharedPtr& fault_config,
                          const Network::DrainDecision& drain_decision, TimeSource& time_source,
-                         bool emit_dynamic_metadata)
-    : stat_prefix_(stat_prefix), scope_(scope), stats_(generateStats(stat_prefix, scope)),
-      runtime_(runtime), drain_decision_(drain_decision), access_log_(access_log),
-      fault_config_(fault_config), time_source_(time_source),
-      emit_dynamic_metadata_(emit_dynamic_metadata) {
+                         bool emit_dynamic_metadata, const MongoStatsSharedPtr& mongo_stats)
+    : stats_(generateStats(stat_prefix, scope)), runtime_(runtime),
+      drain_decision_(drain_decision), access_log_(access_log), fault_config_(fault_config),
+      time_source_(time_source), emit_dynamic_metadata_(emit_dynamic_metadata),
+      mongo_stats_(mongo_stats) {
   if (!runtime_.snapshot().featureEnabled(MongoRuntimeConfig::get().ConnectionLoggingEnabled,
                                           100)) {
     // If we are not logging at the connection level, just release the shared pointer so that we
@@ -145,21 +145,25 @@ void ProxyFilter::decodeQuery(QueryMessagePtr&& message) {
   ActiveQueryPtr active_query(new ActiveQuery(*this, *message));
   if (!active_query->query_info_.command().empty()) {
     // First field key is the operation.
-    scope_.counter(fmt::format("{}cmd.{}.total", stat_prefix_, active_query->query_info_.command()))
+    mongo_stats_
+        ->counter({mongo_stats_->cmd_,
+                   mongo_stats_->getStatName(active_query->query_info_.command()),
+                   mongo_stats_->total_})
         .inc();
   } else {
     // Normal query, get stats on a per collection basis first.
-    std::string collection_stat_prefix =
-        fmt::format("{}collection.{}", stat_prefix_, active_query->query_info_.collection());
     QueryMessageInfo::QueryType query_type = active_query->query_info_.type();
-    chargeQueryStats(collection_stat_prefix, query_type);
+    Stats::StatNameVec names;
+    names.reserve(6);
+    names.push_back(mongo_stats_->collection_);
+    names.push_back(mongo_stats_->getStatName(active_query->query_info_.collection()));
+    chargeQueryStats(names, query_type);
 
     // Callsite stats if we have it.
     if (!active_query->query_info_.callsite().empty()) {
-      std::string callsite_stat_prefix =
-          fmt::format("{}collection.{}.callsite.{}", stat_prefix_,
-                      active_query->query_info_.collection(), active_query->query_info_.callsite());
-      chargeQueryStats(callsite_stat_prefix, query_type);
+      names.push_back(mongo_stats_->callsite_);
+      names.push_back(mongo_stats_->getStatName(active_query->query_info_.callsite()));
+      chargeQueryStats(names, query_type);
     }
 
     // Global stats.
@@ -176,14 +180,24 @@ void ProxyFilter::decodeQuery(QueryMessagePtr&& message) {
   active_query_list_.emplace_back(std::move(active_query));
 }
 
-void ProxyFilter::chargeQueryStats(const std::string& prefix,
+void ProxyFilter::chargeQueryStats(Stats::StatNameVec& names,
                                    QueryMessageInfo::QueryType query_type) {
-  scope_.counter(fmt::format("{}.query.total", prefix)).inc();
+  // The query suffixes are appended to the collection or callsite names, and removed again on
+  // return, so that the caller can reuse the names.
+  const size_t orig_size = names.size();
+  ASSERT(names.capacity() - orig_size >= 2);
+  names.push_back(mongo_stats_->query_);
+  names.push_back(mongo_stats_->total_);
+  mongo_stats_->counter(names).inc();
+
   if (query_type == QueryMessageInfo::QueryType::ScatterGet) {
-    scope_.counter(fmt::format("{}.query.scatter_get", prefix)).inc();
+    names.back() = mongo_stats_->scatter_get_;
+    mongo_stats_->counter(names).inc();
   } else if (query_type == QueryMessageInfo::QueryType::MultiGet) {
-    scope_.counter(fmt::format("{}.query.multi_get", prefix)).inc();
+    names.back() = mongo_stats_->multi_get_;
+    mongo_stats_->counter(names).inc();
   }
+  names.resize(orig_size);
 }
 
 void ProxyFilter::decodeReply(ReplyMessagePtr&& message) {
@@ -207,22 +221,28 @@ void ProxyFilter::decodeReply(ReplyMessagePtr&& message) {
       continue;
     }
 
+    Stats::StatNameVec names;
+    names.reserve(6);
     if (!active_query.query_info_.command().empty()) {
-      std::string stat_prefix =
-          fmt::format("{}cmd.{}", stat_prefix_, active_query.query_info_.command());
-      chargeReplyStats(active_query, stat_prefix, *message);
+      names.push_back(mongo_stats_->cmd_);
+      names.push_back(mongo_stats_->getStatName(active_query.query_info_.command()));
+      chargeReplyStats(active_query, names, *message);
     } else {
       // Collection stats first.
-      std::string stat_prefix =
-          fmt::format("{}collection.{}.query", stat_prefix_, active_query.query_info_.collection());
-      chargeReplyStats(active_query, stat_prefix, *message);
+      names.push_back(mongo_stats_->collection_);
+      names.push_back(mongo_stats_->getStatName(active_query.query_info_.collection()));
+      names.push_back(mongo_stats_->query_);
+      chargeReplyStats(active_query, names, *message);
 
       // Callsite stats if we have it.
       if (!active_query.query_info_.callsite().empty()) {
-        std::string callsite_stat_prefix =
-            fmt::format("{}collection.{}.callsite.{}.query", stat_prefix_,
-                        active_query.query_info_.collection(), active_query.query_info_.callsite());
-        chargeReplyStats(active_query, callsite_stat_prefix, *message);
+        // {"collection", collection, "query"} becomes
+        // {"collection", collection, "callsite", callsite, "query"}.
+        ASSERT(names.size() == 3);
+        names.back() = mongo_stats_->callsite_;
+        names.push_back(mongo_stats_->getStatName(active_query.query_info_.callsite()));
+        names.push_back(mongo_stats_->query_);
+        chargeReplyStats(active_query, names, *message);
       }
     }
 
@@ -270,20 +290,25 @@ void ProxyFilter::onDrainClose() {
   read_callbacks_->connection().close(Network::ConnectionCloseType::FlushWrite);
 }
 
-void ProxyFilter::chargeReplyStats(ActiveQuery& active_query, const std::string& prefix,
+void ProxyFilter::chargeReplyStats(ActiveQuery& active_query, Stats::StatNameVec& names,
                                    const ReplyMessage& message) {
   uint64_t reply_documents_byte_size = 0;
   for (const Bson::DocumentSharedPtr& document : message.documents()) {
     reply_documents_byte_size += document->byteSize();
   }
 
-  scope_.histogram(fmt::format("{}.reply_num_docs", prefix))
-      .recordValue(message.documents().size());
-  scope_.histogram(fmt::format("{}.reply_size", prefix)).recordValue(reply_documents_byte_size);
-  scope_.histogram(fmt::format("{}.reply_time_ms", prefix))
-      .recordValue(std::chrono::duration_cast<std::chrono::milliseconds>(
-                       time_source_.monotonicTime() - active_query.start_time_)
-                       .count());
+  // As in chargeQueryStats(), the suffixes are removed again on return.
+  const size_t orig_size = names.size();
+  names.push_back(mongo_stats_->reply_num_docs_);
+  mongo_stats_->histogram(names).recordValue(message.documents().size());
+  names[orig_size] = mongo_stats_->reply_size_;
+  mongo_stats_->histogram(names).recordValue(reply_documents_byte_size);
+  names[orig_size] = mongo_stats_->reply_time_ms_;
+  mongo_stats_->histogram(names).recordValue(
+      std::chrono::duration_cast<std::chrono::milliseconds>(time_source_.monotonicTime() -
+                                                            active_query.start_time_)
+          .count());
+  names.resize(orig_size);
 }
 
 void ProxyFilter::doDecode(Buffer::Instance& buffer) {
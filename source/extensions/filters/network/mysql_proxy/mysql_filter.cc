@@ -3,6 +3,7 @@
 #include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
 #include "common/common/logger.h"
+#include "common/protobuf/utility.h"
 
 #include "extensions/filters/network/well_known_names.h"
 
@@ -13,9 +14,48 @@ namespace Extensions {
 namespace NetworkFilters {
 namespace MySQLProxy {
 
+namespace {
+
+struct ThreadLocalQueryParseCache : public ThreadLocal::ThreadLocalObject {
+  ThreadLocalQueryParseCache(uint32_t max_entries) : cache_(max_entries) {}
+
+  QueryParseCache cache_;
+};
+
+} // namespace
+
 MySQLFilterConfig::MySQLFilterConfig(const std::string& stat_prefix, Stats::Scope& scope)
     : scope_(scope), stat_prefix_(stat_prefix), stats_(generateStats(stat_prefix, scope)) {}
 
+MySQLFilterConfig::MySQLFilterConfig(
+    const std::string& stat_prefix, Stats::Scope& scope,
+    const envoy::config::filter::network::mysql_proxy::v1alpha1::QueryParsing& query_parsing,
+    Runtime::RandomGenerator& random, ThreadLocal::SlotAllocator& tls)
+    : scope_(scope), stat_prefix_(stat_prefix), stats_(generateStats(stat_prefix, scope)),
+      tokenize_simple_queries_(query_parsing.tokenize_simple_queries()), random_(&random) {
+  if (query_parsing.has_full_parse_fraction()) {
+    full_parse_fraction_ = query_parsing.full_parse_fraction();
+  }
+
+  const uint32_t max_entries = query_parsing.cache_max_entries();
+  if (max_entries > 0) {
+    tls_ = tls.allocateSlot();
+    tls_->set([max_entries](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+      return std::make_shared<ThreadLocalQueryParseCache>(max_entries);
+    });
+  }
+}
+
+QueryParseCache* MySQLFilterConfig::parseCache() const {
+  return tls_ != nullptr ? &tls_->getTyped<ThreadLocalQueryParseCache>().cache_ : nullptr;
+}
+
+bool MySQLFilterConfig::shouldParse() const {
+  return !full_parse_fraction_.has_value() ||
+         ProtobufPercentHelper::evaluateFractionalPercent(full_parse_fraction_.value(),
+                                                          random_->random());
+}
+
 MySQLFilter::MySQLFilter(MySQLFilterConfigSharedPtr config) : config_(std::move(config)) {}
 
 void MySQLFilter::initializeReadFilterCallbacks(Network::ReadFilterCallbacks& callbacks) {
@@ -102,37 +142,83 @@ void MySQLFilter::onCommand(Command& command) {
     return;
   }
 
-  // Parse a given query
-  hsql::SQLParserResult result;
-  hsql::SQLParser::parse(command.getData(), &result);
-
   ENVOY_CONN_LOG(trace, "mysql_proxy: query processed {}", read_callbacks_->connection(),
                  command.getData());
 
-  if (!result.isValid()) {
-    config_->stats_.queries_parse_error_.inc();
+  TableAccessMap tables;
+  if (config_->tokenizeSimpleQueries() && QueryTables::extract(command.getData(), tables)) {
+    config_->stats_.queries_tokenized_.inc();
+  } else if (!parseQuery(command.getData(), tables)) {
     return;
   }
   config_->stats_.queries_parsed_.inc();
 
-  // Set dynamic metadata
-  envoy::api::v2::core::Metadata& dynamic_metadata =
-      read_callbacks_->connection().streamInfo().dynamicMetadata();
-  ProtobufWkt::Struct metadata(
-      (*dynamic_metadata.mutable_filter_metadata())[NetworkFilterNames::get().MySQLProxy]);
-  auto& fields = *metadata.mutable_fields();
+  setTablesMetadata(tables);
+}
 
-  for (auto i = 0u; i < result.size(); ++i) {
+bool MySQLFilter::parseQuery(const std::string& query, TableAccessMap& tables) {
+  QueryParseCache* cache = config_->parseCache();
+  std::string fingerprint;
+  if (cache != nullptr) {
+    // Queries without a fingerprint are parsed, but their results are not cached.
+    const QueryParseCache::Entry* entry = QueryTables::fingerprint(query, fingerprint)
+                                              ? cache->find(fingerprint)
+                                              : nullptr;
+    if (entry != nullptr) {
+      config_->stats_.queries_parse_cache_hit_.inc();
+      if (!entry->valid_) {
+        config_->stats_.queries_parse_error_.inc();
+        return false;
+      }
+      tables = entry->tables_;
+      return true;
+    }
+    config_->stats_.queries_parse_cache_miss_.inc();
+  }
+
+  if (!config_->shouldParse()) {
+    config_->stats_.queries_parse_skipped_.inc();
+    return false;
+  }
+
+  hsql::SQLParserResult result;
+  hsql::SQLParser::parse(query, &result);
+
+  QueryParseCache::Entry entry{result.isValid(), {}};
+  for (auto i = 0u; entry.valid_ && i < result.size(); ++i) {
     if (result.getStatement(i)->type() == hsql::StatementType::kStmtShow) {
       continue;
     }
     hsql::TableAccessMap table_access_map;
     result.getStatement(i)->tablesAccessed(table_access_map);
     for (auto& it : table_access_map) {
-      auto& operations = *fields[it.first].mutable_list_value();
-      for (const auto& ot : it.second) {
-        operations.add_values()->set_string_value(ot);
-      }
+      auto& operations = entry.tables_[it.first];
+      operations.insert(operations.end(), it.second.begin(), it.second.end());
+    }
+  }
+
+  if (!entry.valid_) {
+    config_->stats_.queries_parse_error_.inc();
+  }
+  const bool valid = entry.valid_;
+  tables = entry.tables_;
+  if (cache != nullptr && !fingerprint.empty()) {
+    cache->insert(fingerprint, std::move(entry));
+  }
+  return valid;
+}
+
+void MySQLFilter::setTablesMetadata(const TableAccessMap& tables) {
+  envoy::api::v2::core::Metadata& dynamic_metadata =
+      read_callbacks_->connection().streamInfo().dynamicMetadata();
+  ProtobufWkt::Struct metadata(
+      (*dynamic_metadata.mutable_filter_metadata())[NetworkFilterNames::get().MySQLProxy]);
+  auto& fields = *metadata.mutable_fields();
+
+  for (const auto& table : tables) {
+    auto& operations = *fields[table.first].mutable_list_value();
+    for (const std::string& operation : table.second) {
+      operations.add_values()->set_string_value(operation);
     }
   }
 
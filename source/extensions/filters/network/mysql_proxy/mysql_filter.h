@@ -1,11 +1,14 @@
 #pragma once
 
 #include "envoy/access_log/access_log.h"
+#include "envoy/config/filter/network/mysql_proxy/v1alpha1/mysql_proxy.pb.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/filter.h"
+#include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats.h"
 #include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/common/logger.h"
 
@@ -16,8 +19,12 @@
 #include "extensions/filters/network/mysql_proxy/mysql_codec_greeting.h"
 #include "extensions/filters/network/mysql_proxy/mysql_codec_switch_resp.h"
 #include "extensions/filters/network/mysql_proxy/mysql_decoder.h"
+#include "extensions/filters/network/mysql_proxy/mysql_query_cache.h"
+#include "extensions/filters/network/mysql_proxy/mysql_query_tables.h"
 #include "extensions/filters/network/mysql_proxy/mysql_session.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -37,6 +44,10 @@ namespace MySQLProxy {
   COUNTER(auth_switch_request)                                                   \
   COUNTER(queries_parsed)                                                        \
   COUNTER(queries_parse_error)                                                   \
+  COUNTER(queries_tokenized)                                                     \
+  COUNTER(queries_parse_cache_hit)                                               \
+  COUNTER(queries_parse_cache_miss)                                              \
+  COUNTER(queries_parse_skipped)                                                 \
 // clang-format on
 
 /**
@@ -52,9 +63,28 @@ struct MySQLProxyStats {
 class MySQLFilterConfig {
 public:
   MySQLFilterConfig(const std::string &stat_prefix, Stats::Scope& scope);
+  MySQLFilterConfig(
+      const std::string& stat_prefix, Stats::Scope& scope,
+      const envoy::config::filter::network::mysql_proxy::v1alpha1::QueryParsing& query_parsing,
+      Runtime::RandomGenerator& random, ThreadLocal::SlotAllocator& tls);
 
   const MySQLProxyStats& stats() { return stats_; }
 
+  /**
+   * @return true if the tables of simple queries are extracted without parsing them.
+   */
+  bool tokenizeSimpleQueries() const { return tokenize_simple_queries_; }
+
+  /**
+   * @return the parse results cache of the current worker, or nullptr if results are not cached.
+   */
+  QueryParseCache* parseCache() const;
+
+  /**
+   * @return true if a query which is neither tokenized nor cached should be parsed.
+   */
+  bool shouldParse() const;
+
   Stats::Scope& scope_;
   const std::string stat_prefix_;
   MySQLProxyStats stats_;
@@ -65,6 +95,11 @@ private:
     return MySQLProxyStats{
         ALL_MYSQL_PROXY_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
   }
+
+  const bool tokenize_simple_queries_{};
+  absl::optional<envoy::type::FractionalPercent> full_parse_fraction_;
+  Runtime::RandomGenerator* random_{};
+  ThreadLocal::SlotPtr tls_;
 };
 
 using MySQLFilterConfigSharedPtr = std::shared_ptr<MySQLFilterConfig>;
@@ -101,6 +136,9 @@ public:
   MySQLSession& getSession() { return decoder_->getSession(); }
 
 private:
+  bool parseQuery(const std::string& query, TableAccessMap& tables);
+  void setTablesMetadata(const TableAccessMap& tables);
+
   Network::ReadFilterCallbacks* read_callbacks_{};
   MySQLFilterConfigSharedPtr config_;
   Buffer::OwnedImpl read_buffer_;
@@ -0,0 +1,39 @@
+#include "extensions/filters/network/mysql_proxy/mysql_query_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace MySQLProxy {
+
+const QueryParseCache::Entry* QueryParseCache::find(absl::string_view fingerprint) {
+  const auto it = map_.find(fingerprint);
+  if (it == map_.end()) {
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return &it->second->second;
+}
+
+void QueryParseCache::insert(const std::string& fingerprint, Entry&& entry) {
+  const auto it = map_.find(fingerprint);
+  if (it != map_.end()) {
+    it->second->second = std::move(entry);
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return;
+  }
+
+  if (max_entries_ == 0) {
+    return;
+  }
+  if (lru_.size() >= max_entries_) {
+    map_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+  lru_.emplace_front(fingerprint, std::move(entry));
+  map_.emplace(lru_.front().first, lru_.begin());
+}
+
+} // namespace MySQLProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
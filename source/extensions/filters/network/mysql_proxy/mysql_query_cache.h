@@ -0,0 +1,67 @@
+#pragma once
+
+#include <list>
+#include <string>
+
+#include "extensions/filters/network/mysql_proxy/mysql_query_tables.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace MySQLProxy {
+
+/**
+ * A bounded LRU cache of the results of the full parses of queries, keyed by query fingerprint
+ * (@see QueryTables::fingerprint()). Like the filters using it, it is per thread and its
+ * operations are not protected.
+ */
+class QueryParseCache {
+public:
+  /**
+   * The result of parsing a query.
+   */
+  struct Entry {
+    // False if the query could not be parsed.
+    bool valid_;
+    TableAccessMap tables_;
+  };
+
+  /**
+   * @param max_entries supplies the maximum number of cached results, beyond which the least
+   *        recently used one is evicted.
+   */
+  QueryParseCache(uint32_t max_entries) : max_entries_(max_entries) {}
+
+  /**
+   * @return the result cached for a fingerprint, or nullptr if there is none. The result is only
+   *         valid until the cache is modified.
+   */
+  const Entry* find(absl::string_view fingerprint);
+
+  /**
+   * Cache the result of parsing a query, evicting the least recently used one if full.
+   */
+  void insert(const std::string& fingerprint, Entry&& entry);
+
+  /**
+   * @return the number of cached results.
+   */
+  size_t size() const { return lru_.size(); }
+
+private:
+  using LruList = std::list<std::pair<std::string, Entry>>;
+
+  const uint32_t max_entries_;
+  // Most recently used first.
+  LruList lru_;
+  // Keyed by views of the fingerprints held in lru_.
+  absl::flat_hash_map<absl::string_view, LruList::iterator> map_;
+};
+
+} // namespace MySQLProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
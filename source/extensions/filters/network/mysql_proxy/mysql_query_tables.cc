@@ -0,0 +1,279 @@
+#include "extensions/filters/network/mysql_proxy/mysql_query_tables.h"
+
+#include <algorithm>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace MySQLProxy {
+namespace {
+
+// Integers with more digits are kept in fingerprints, as they may not be valid where shorter ones
+// are.
+constexpr size_t MaxNormalizedIntegerLength = 18;
+
+// Words which cannot be the unquoted name of a table or of its alias in the simple queries.
+constexpr absl::string_view ReservedWords[] = {
+    "AS",      "CROSS",  "DELAYED",   "DUAL",          "FOR",    "FROM",          "GROUP",
+    "HAVING",  "IGNORE", "INNER",     "INTO",          "JOIN",   "HIGH_PRIORITY", "LEFT",
+    "LIMIT",   "LOCK",   "NATURAL",   "LOW_PRIORITY",  "ON",     "ORDER",         "OUTER",
+    "QUICK",   "RIGHT",  "PARTITION", "STRAIGHT_JOIN", "SELECT", "SET",           "UNION",
+    "USING",   "VALUE",  "VALUES",    "WHERE",         "WINDOW"};
+
+struct Token {
+  enum class Type { Word, QuotedIdentifier, String, Integer, Symbol };
+
+  Type type_;
+  // The text of the token in the query, quotes included.
+  absl::string_view text_;
+  bool space_before_;
+};
+
+bool isWordChar(char c) { return absl::ascii_isalnum(c) || c == '_' || c == '$'; }
+
+/**
+ * Split a query into tokens. Comments, escape sequences in quoted strings and any character not
+ * expected in simple queries fail the tokenization.
+ */
+bool tokenize(absl::string_view query, std::vector<Token>& tokens) {
+  bool space_before = false;
+  size_t i = 0;
+  while (i < query.size()) {
+    const char c = query[i];
+    const char next = i + 1 < query.size() ? query[i + 1] : '\0';
+    size_t end = i + 1;
+    Token::Type type;
+
+    if (absl::ascii_isspace(c)) {
+      space_before = true;
+      ++i;
+      continue;
+    } else if (isWordChar(c)) {
+      while (end < query.size() && isWordChar(query[end])) {
+        ++end;
+      }
+      const absl::string_view word = query.substr(i, end - i);
+      if (std::all_of(word.begin(), word.end(), absl::ascii_isdigit)) {
+        type = Token::Type::Integer;
+      } else if (absl::ascii_isdigit(c)) {
+        // Hexadecimal and exponent literals, or identifiers starting with digits.
+        return false;
+      } else {
+        type = Token::Type::Word;
+      }
+    } else if (c == '`' || c == '"' || c == '\'') {
+      end = query.find(c, i + 1);
+      if (end == absl::string_view::npos) {
+        return false;
+      }
+      ++end;
+      // Doubled quotes and backslashes escape characters in quoted text.
+      if ((end < query.size() && query[end] == c) ||
+          query.substr(i, end - i).find('\\') != absl::string_view::npos) {
+        return false;
+      }
+      type = c == '\'' ? Token::Type::String : Token::Type::QuotedIdentifier;
+    } else if (c == '#' || (c == '-' && next == '-') || (c == '/' && next == '*')) {
+      return false;
+    } else if (absl::string_view("(),;.<>=!|&+-*/%^~:@").find(c) != absl::string_view::npos) {
+      type = Token::Type::Symbol;
+    } else {
+      return false;
+    }
+
+    tokens.push_back(Token{type, query.substr(i, end - i), space_before});
+    space_before = false;
+    i = end;
+  }
+  return true;
+}
+
+bool isWord(const Token& token, absl::string_view word) {
+  return token.type_ == Token::Type::Word && absl::EqualsIgnoreCase(token.text_, word);
+}
+
+bool isSymbol(const Token& token, char symbol) {
+  return token.type_ == Token::Type::Symbol && token.text_[0] == symbol;
+}
+
+/**
+ * @return true if the token can name a table or an alias, in which case name receives it.
+ */
+bool tableName(const Token& token, std::string& name) {
+  if (token.type_ == Token::Type::QuotedIdentifier) {
+    name = std::string(token.text_.substr(1, token.text_.size() - 2));
+    return !name.empty();
+  }
+  if (token.type_ != Token::Type::Word) {
+    return false;
+  }
+  for (absl::string_view reserved : ReservedWords) {
+    if (absl::EqualsIgnoreCase(token.text_, reserved)) {
+      return false;
+    }
+  }
+  name = std::string(token.text_);
+  return true;
+}
+
+/**
+ * Skip the optional words from a list, in any order.
+ */
+size_t skipWords(const std::vector<Token>& tokens, size_t i,
+                 std::initializer_list<absl::string_view> words) {
+  while (i < tokens.size() && std::any_of(words.begin(), words.end(), [&](absl::string_view word) {
+           return isWord(tokens[i], word);
+         })) {
+    ++i;
+  }
+  return i;
+}
+
+/**
+ * Skip the optional alias of a table, with or without AS.
+ * @return false if AS is not followed by an alias.
+ */
+bool skipAlias(const std::vector<Token>& tokens, size_t& i) {
+  std::string alias;
+  if (i < tokens.size() && isWord(tokens[i], "AS")) {
+    i += 2;
+    return i <= tokens.size() && tableName(tokens[i - 1], alias);
+  }
+  if (i < tokens.size() && tableName(tokens[i], alias)) {
+    ++i;
+  }
+  return true;
+}
+
+/**
+ * @return true if the token at i ends the tables of a statement: either the end of the statement,
+ *         or one of the words starting the next clause.
+ */
+bool endOfTables(const std::vector<Token>& tokens, size_t i,
+                 std::initializer_list<absl::string_view> clauses) {
+  return i == tokens.size() ||
+         std::any_of(clauses.begin(), clauses.end(),
+                     [&](absl::string_view clause) { return isWord(tokens[i], clause); });
+}
+
+} // namespace
+
+bool QueryTables::extract(absl::string_view query, TableAccessMap& tables) {
+  std::vector<Token> tokens;
+  if (!tokenize(query, tokens)) {
+    return false;
+  }
+  if (!tokens.empty() && isSymbol(tokens.back(), ';')) {
+    tokens.pop_back();
+  }
+  if (tokens.empty()) {
+    return false;
+  }
+
+  // Multiple statements, qualified names and subqueries are left to the full parser, which reports
+  // the tables of column references too.
+  size_t selects = 0;
+  for (const Token& token : tokens) {
+    if (isSymbol(token, ';') || isSymbol(token, '.') || isWord(token, "JOIN") ||
+        isWord(token, "UNION") || (isWord(token, "INTO") && isWord(tokens[0], "SELECT"))) {
+      return false;
+    }
+    if (isWord(token, "SELECT")) {
+      ++selects;
+    }
+  }
+
+  std::string table;
+  std::string operation;
+  size_t i;
+  if (isWord(tokens[0], "SELECT")) {
+    // SELECT ... FROM table [[AS] alias] [WHERE|GROUP|HAVING|ORDER|LIMIT ...]
+    // The FROM keyword is the first one outside of parentheses, e.g. not that of EXTRACT().
+    int depth = 0;
+    for (i = 1; i < tokens.size() && !(depth == 0 && isWord(tokens[i], "FROM")); ++i) {
+      if (isSymbol(tokens[i], '(')) {
+        ++depth;
+      } else if (isSymbol(tokens[i], ')')) {
+        --depth;
+      }
+    }
+    if (selects != 1 || i + 1 >= tokens.size() || !tableName(tokens[i + 1], table)) {
+      return false;
+    }
+    i += 2;
+    if (!skipAlias(tokens, i) ||
+        !endOfTables(tokens, i, {"WHERE", "GROUP", "HAVING", "ORDER", "LIMIT"})) {
+      return false;
+    }
+    operation = "select";
+  } else if (isWord(tokens[0], "INSERT")) {
+    // INSERT [modifiers] [INTO] table (columns|VALUES ...)
+    i = skipWords(tokens, 1, {"LOW_PRIORITY", "DELAYED", "HIGH_PRIORITY", "IGNORE"});
+    i = skipWords(tokens, i, {"INTO"});
+    if (selects != 0 || i + 1 >= tokens.size() || !tableName(tokens[i], table) ||
+        !(isSymbol(tokens[i + 1], '(') || isWord(tokens[i + 1], "VALUES") ||
+          isWord(tokens[i + 1], "VALUE"))) {
+      return false;
+    }
+    operation = "insert";
+  } else if (isWord(tokens[0], "UPDATE")) {
+    // UPDATE [modifiers] table [[AS] alias] SET ...
+    i = skipWords(tokens, 1, {"LOW_PRIORITY", "IGNORE"});
+    if (selects != 0 || i >= tokens.size() || !tableName(tokens[i], table)) {
+      return false;
+    }
+    ++i;
+    if (!skipAlias(tokens, i) || i >= tokens.size() || !isWord(tokens[i], "SET")) {
+      return false;
+    }
+    operation = "update";
+  } else if (isWord(tokens[0], "DELETE")) {
+    // DELETE [modifiers] FROM table [WHERE|ORDER|LIMIT ...]
+    i = skipWords(tokens, 1, {"LOW_PRIORITY", "QUICK", "IGNORE"});
+    if (selects != 0 || i + 1 >= tokens.size() || !isWord(tokens[i], "FROM") ||
+        !tableName(tokens[i + 1], table) ||
+        !endOfTables(tokens, i + 2, {"WHERE", "ORDER", "LIMIT"})) {
+      return false;
+    }
+    operation = "delete";
+  } else {
+    return false;
+  }
+
+  tables[table].push_back(operation);
+  return true;
+}
+
+bool QueryTables::fingerprint(absl::string_view query, std::string& fingerprint) {
+  std::vector<Token> tokens;
+  if (!tokenize(query, tokens)) {
+    return false;
+  }
+
+  // The whitespace between tokens is kept, as it may separate tokens which would otherwise be one,
+  // e.g. "< =" and "<=". Placeholders cannot be mistaken for the query text, where "?" fails the
+  // tokenization.
+  fingerprint.clear();
+  fingerprint.reserve(query.size());
+  for (const Token& token : tokens) {
+    if (token.space_before_ && !fingerprint.empty()) {
+      fingerprint.push_back(' ');
+    }
+    if (token.type_ == Token::Type::String ||
+        (token.type_ == Token::Type::Integer &&
+         token.text_.size() <= MaxNormalizedIntegerLength)) {
+      fingerprint.push_back('?');
+    } else {
+      fingerprint.append(token.text_.data(), token.text_.size());
+    }
+  }
+  return true;
+}
+
+} // namespace MySQLProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
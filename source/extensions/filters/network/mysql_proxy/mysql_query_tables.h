@@ -0,0 +1,51 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace MySQLProxy {
+
+/**
+ * The tables accessed by a query, with the operations on each, e.g. "select" or "insert", as
+ * reported by hsql::SQLStatement::tablesAccessed().
+ */
+using TableAccessMap = std::map<std::string, std::vector<std::string>>;
+
+/**
+ * Lightweight helpers working on the tokens of a query, which avoid parsing it with the full SQL
+ * parser.
+ */
+class QueryTables {
+public:
+  /**
+   * Extract the tables accessed by a simple query: a single SELECT from one table, or a single
+   * INSERT, UPDATE or DELETE of one table, without subqueries nor qualified names. The query is
+   * not validated beyond that.
+   * @param query supplies the query.
+   * @param tables receives the tables, with the operations as reported by the full parser.
+   * @return true if the query is simple enough for its tables to be extracted.
+   */
+  static bool extract(absl::string_view query, TableAccessMap& tables);
+
+  /**
+   * Compute the fingerprint of a query: its text with the string and integer literals replaced by
+   * a placeholder and the whitespace collapsed. Queries with the same fingerprint access the same
+   * tables and are equally valid.
+   * @param query supplies the query.
+   * @param fingerprint receives the fingerprint.
+   * @return false if the query has comments or constructs that are not normalized, in which case
+   *         it has no fingerprint.
+   */
+  static bool fingerprint(absl::string_view query, std::string& fingerprint);
+};
+
+} // namespace MySQLProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
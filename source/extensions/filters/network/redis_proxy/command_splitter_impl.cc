@@ -1,7 +1,11 @@
 #include "extensions/filters/network/redis_proxy/command_splitter_impl.h"
 
+#include <utility>
+
 #include "extensions/filters/network/common/redis/supported_commands.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -178,6 +182,78 @@ SplitRequestPtr SimpleRequest::create(Router& router,
   return request_ptr;
 }
 
+SplitRequestPtr CachedGetRequest::create(Router& router, LocalCache& local_cache,
+                                         Common::Redis::RespValuePtr&& incoming_request,
+                                         SplitCallbacks& callbacks, CommandStats& command_stats,
+                                         TimeSource& time_source, bool latency_in_micros) {
+  std::unique_ptr<CachedGetRequest> request_ptr{
+      new CachedGetRequest(local_cache, callbacks, command_stats, time_source, latency_in_micros)};
+
+  request_ptr->key_ = incoming_request->asArray()[1].asString();
+  Common::Redis::RespValuePtr value = local_cache.lookup(request_ptr->key_, request_ptr->version_);
+  if (value) {
+    request_ptr->updateStats(true);
+    callbacks.onResponse(std::move(value));
+    return nullptr;
+  }
+
+  const auto route = router.upstreamPool(incoming_request->asArray()[1].asString());
+  if (route) {
+    request_ptr->conn_pool_ = route->upstream();
+    request_ptr->handle_ =
+        makeRequest(route, incoming_request->asArray()[0].asString(),
+                    incoming_request->asArray()[1].asString(), *incoming_request, *request_ptr);
+  }
+
+  if (!request_ptr->handle_) {
+    callbacks.onResponse(Utility::makeError(Response::get().NoUpstreamHost));
+    return nullptr;
+  }
+
+  request_ptr->incoming_request_ = std::move(incoming_request);
+  return request_ptr;
+}
+
+void CachedGetRequest::onResponse(Common::Redis::RespValuePtr&& response) {
+  if (response->type() == Common::Redis::RespType::BulkString) {
+    local_cache_.insert(key_, *response, version_);
+  }
+  SingleServerRequest::onResponse(std::move(response));
+}
+
+SplitRequestPtr WriteInvalidatingRequest::create(
+    CommandHandler& handler, LocalCache& local_cache, std::vector<std::string>&& keys,
+    Common::Redis::RespValuePtr&& incoming_request, SplitCallbacks& callbacks,
+    CommandStats& command_stats, TimeSource& time_source, bool latency_in_micros) {
+  std::unique_ptr<WriteInvalidatingRequest> request_ptr{
+      new WriteInvalidatingRequest(local_cache, std::move(keys), callbacks)};
+  request_ptr->invalidate();
+  request_ptr->request_ = handler.startRequest(std::move(incoming_request), *request_ptr,
+                                               command_stats, time_source, latency_in_micros);
+  if (!request_ptr->request_) {
+    // The request completed, or failed, without waiting for upstream.
+    return nullptr;
+  }
+  return request_ptr;
+}
+
+void WriteInvalidatingRequest::cancel() {
+  request_->cancel();
+  // The write may still be applied by upstream.
+  invalidate();
+}
+
+void WriteInvalidatingRequest::onResponse(Common::Redis::RespValuePtr&& value) {
+  invalidate();
+  callbacks_.onResponse(std::move(value));
+}
+
+void WriteInvalidatingRequest::invalidate() {
+  for (const std::string& key : keys_) {
+    local_cache_.invalidate(key);
+  }
+}
+
 SplitRequestPtr EvalRequest::create(Router& router, Common::Redis::RespValuePtr&& incoming_request,
                                     SplitCallbacks& callbacks, CommandStats& command_stats,
                                     TimeSource& time_source, bool latency_in_micros) {
@@ -231,48 +307,108 @@ void FragmentedRequest::onChildFailure(uint32_t index) {
   onChildResponse(Utility::makeError(Response::get().UpstreamFailure), index);
 }
 
-SplitRequestPtr MGETRequest::create(Router& router, Common::Redis::RespValuePtr&& incoming_request,
-                                    SplitCallbacks& callbacks, CommandStats& command_stats,
-                                    TimeSource& time_source, bool latency_in_micros) {
-  std::unique_ptr<MGETRequest> request_ptr{
-      new MGETRequest(callbacks, command_stats, time_source, latency_in_micros)};
-
-  request_ptr->num_pending_responses_ = incoming_request->asArray().size() - 1;
-  request_ptr->pending_requests_.reserve(request_ptr->num_pending_responses_);
+void FragmentedRequest::makeFragmentedRequests(Router& router) {
+  std::vector<Common::Redis::RespValue>& args = incoming_request_->asArray();
+  const uint32_t num_keys = (args.size() - 1) / args_per_key_;
+
+  // The keys sharing a connection pool and a hash key are sent to the same server. As routing may
+  // remove a prefix from a key, all the keys are routed before any request is made.
+  std::vector<RouteSharedPtr> routes;
+  std::vector<uint32_t> key_requests(num_keys);
+  absl::flat_hash_map<std::pair<const ConnPool::Instance*, absl::string_view>, uint32_t> requests;
+  requests.reserve(num_keys);
+  for (uint32_t key = 0; key < num_keys; key++) {
+    std::string& key_string = args[keyArgIndex(key)].asString();
+    RouteSharedPtr route = router.upstreamPool(key_string);
+    uint32_t index = pending_requests_.size();
+    if (route) {
+      const ConnPool::InstanceSharedPtr conn_pool = route->upstream();
+      const auto request_key = std::make_pair(conn_pool.get(), conn_pool->hashKey(key_string));
+      index = requests.emplace(request_key, index).first->second;
+    }
+    if (index == pending_requests_.size()) {
+      pending_requests_.emplace_back(*this, index);
+      routes.push_back(std::move(route));
+    }
+    pending_requests_[index].num_keys_++;
+    key_requests[key] = index;
+  }
 
-  request_ptr->pending_response_ = std::make_unique<Common::Redis::RespValue>();
-  request_ptr->pending_response_->type(Common::Redis::RespType::Array);
-  std::vector<Common::Redis::RespValue> responses(request_ptr->num_pending_responses_);
-  request_ptr->pending_response_->asArray().swap(responses);
+  // Lay the keys out by pending request, keeping their order within each.
+  uint32_t keys_begin = 0;
+  for (PendingRequest& pending_request : pending_requests_) {
+    pending_request.keys_begin_ = keys_begin;
+    keys_begin += pending_request.num_keys_;
+    pending_request.num_keys_ = 0;
+  }
+  fragment_keys_.resize(num_keys);
+  for (uint32_t key = 0; key < num_keys; key++) {
+    PendingRequest& pending_request = pending_requests_[key_requests[key]];
+    fragment_keys_[pending_request.keys_begin_ + pending_request.num_keys_++] = key;
+  }
 
-  std::vector<Common::Redis::RespValue> values(2);
-  values[0].type(Common::Redis::RespType::BulkString);
-  values[0].asString() = "get";
-  values[1].type(Common::Redis::RespType::BulkString);
-  Common::Redis::RespValue single_mget;
-  single_mget.type(Common::Redis::RespType::Array);
-  single_mget.asArray().swap(values);
-
-  for (uint64_t i = 1; i < incoming_request->asArray().size(); i++) {
-    request_ptr->pending_requests_.emplace_back(*request_ptr, i - 1);
-    PendingRequest& pending_request = request_ptr->pending_requests_.back();
-
-    single_mget.asArray()[1].asString() = incoming_request->asArray()[i].asString();
-    ENVOY_LOG(debug, "redis: parallel get: '{}'", single_mget.toString());
-    const auto route = router.upstreamPool(incoming_request->asArray()[i].asString());
+  num_pending_responses_ = pending_requests_.size();
+  Common::Redis::RespValue request;
+  for (PendingRequest& pending_request : pending_requests_) {
+    const RouteSharedPtr& route = routes[pending_request.index_];
     if (route) {
+      recreate(request, pending_request.index_);
+      const std::string& command = request.asArray()[0].asString();
+      ENVOY_LOG(debug, "redis: parallel {}: '{}'", command, request.toString());
       pending_request.conn_pool_ = route->upstream();
-      pending_request.handle_ = makeRequest(route, "get", incoming_request->asArray()[i].asString(),
-                                            single_mget, pending_request);
+      pending_request.handle_ =
+          makeRequest(route, command,
+                      args[keyArgIndex(fragment_keys_[pending_request.keys_begin_])].asString(),
+                      request, pending_request);
     }
 
     if (!pending_request.handle_) {
       pending_request.onResponse(Utility::makeError(Response::get().NoUpstreamHost));
     }
   }
+}
+
+void FragmentedRequest::fillRequest(Common::Redis::RespValue& request, const std::string& command,
+                                    uint32_t index) const {
+  const PendingRequest& pending_request = pending_requests_[index];
+  const std::vector<Common::Redis::RespValue>& args = incoming_request_->asArray();
+
+  // The values of a previously filled request are reused.
+  if (request.type() != Common::Redis::RespType::Array) {
+    request.type(Common::Redis::RespType::Array);
+  }
+  std::vector<Common::Redis::RespValue>& values = request.asArray();
+  values.resize(1 + pending_request.num_keys_ * args_per_key_);
+  if (values[0].type() != Common::Redis::RespType::BulkString) {
+    values[0].type(Common::Redis::RespType::BulkString);
+  }
+  values[0].asString() = command;
+
+  uint32_t value = 1;
+  for (uint32_t i = 0; i < pending_request.num_keys_; i++) {
+    const uint32_t arg = keyArgIndex(fragment_keys_[pending_request.keys_begin_ + i]);
+    for (uint32_t j = 0; j < args_per_key_; j++) {
+      // The values share the buffers of large bulk strings rather than copying them.
+      values[value++] = args[arg + j];
+    }
+  }
+}
+
+SplitRequestPtr MGETRequest::create(Router& router, Common::Redis::RespValuePtr&& incoming_request,
+                                    SplitCallbacks& callbacks, CommandStats& command_stats,
+                                    TimeSource& time_source, bool latency_in_micros) {
+  std::unique_ptr<MGETRequest> request_ptr{
+      new MGETRequest(callbacks, command_stats, time_source, latency_in_micros)};
+
+  request_ptr->pending_response_ = std::make_unique<Common::Redis::RespValue>();
+  request_ptr->pending_response_->type(Common::Redis::RespType::Array);
+  std::vector<Common::Redis::RespValue> responses(incoming_request->asArray().size() - 1);
+  request_ptr->pending_response_->asArray().swap(responses);
+
+  request_ptr->incoming_request_ = std::move(incoming_request);
+  request_ptr->makeFragmentedRequests(router);
 
   if (request_ptr->num_pending_responses_ > 0) {
-    request_ptr->incoming_request_ = std::move(incoming_request);
     return request_ptr;
   }
 
@@ -309,15 +445,42 @@ bool FragmentedRequest::onChildRedirection(const Common::Redis::RespValue& value
 }
 
 void MGETRequest::onChildResponse(Common::Redis::RespValuePtr&& value, uint32_t index) {
-  pending_requests_[index].handle_ = nullptr;
+  PendingRequest& pending_request = pending_requests_[index];
+  pending_request.handle_ = nullptr;
+
+  const uint32_t* keys = &fragment_keys_[pending_request.keys_begin_];
+  if (pending_request.num_keys_ == 1) {
+    onKeyResponse(*value, keys[0]);
+  } else if (value->type() == Common::Redis::RespType::Array &&
+             value->asArray().size() == pending_request.num_keys_) {
+    for (uint32_t i = 0; i < pending_request.num_keys_; i++) {
+      onKeyResponse(value->asArray()[i], keys[i]);
+    }
+  } else {
+    // An error or an invalid response applies to each of the keys.
+    for (uint32_t i = 0; i < pending_request.num_keys_; i++) {
+      Common::Redis::RespValue key_value(*value);
+      onKeyResponse(key_value, keys[i]);
+    }
+  }
 
-  pending_response_->asArray()[index].type(value->type());
-  switch (value->type()) {
+  ASSERT(num_pending_responses_ > 0);
+  if (--num_pending_responses_ == 0) {
+    updateStats(error_count_ == 0);
+    ENVOY_LOG(debug, "redis: response: '{}'", pending_response_->toString());
+    callbacks_.onResponse(std::move(pending_response_));
+  }
+}
+
+void MGETRequest::onKeyResponse(Common::Redis::RespValue& value, uint32_t key) {
+  Common::Redis::RespValue& response = pending_response_->asArray()[key];
+  response.type(value.type());
+  switch (value.type()) {
   case Common::Redis::RespType::Array:
   case Common::Redis::RespType::Integer:
   case Common::Redis::RespType::SimpleString: {
-    pending_response_->asArray()[index].type(Common::Redis::RespType::Error);
-    pending_response_->asArray()[index].asString() = Response::get().UpstreamProtocolError;
+    response.type(Common::Redis::RespType::Error);
+    response.asString() = Response::get().UpstreamProtocolError;
     error_count_++;
     break;
   }
@@ -326,34 +489,16 @@ void MGETRequest::onChildResponse(Common::Redis::RespValuePtr&& value, uint32_t
     FALLTHRU;
   }
   case Common::Redis::RespType::BulkString: {
-    pending_response_->asArray()[index].asString().swap(value->asString());
+    response.asString().swap(value.asString());
     break;
   }
   case Common::Redis::RespType::Null:
     break;
   }
-
-  ASSERT(num_pending_responses_ > 0);
-  if (--num_pending_responses_ == 0) {
-    updateStats(error_count_ == 0);
-    ENVOY_LOG(debug, "redis: response: '{}'", pending_response_->toString());
-    callbacks_.onResponse(std::move(pending_response_));
-  }
 }
 
 void MGETRequest::recreate(Common::Redis::RespValue& request, uint32_t index) {
-  static const uint32_t GET_COMMAND_SUBSTRINGS = 2;
-  uint32_t num_values = GET_COMMAND_SUBSTRINGS;
-  std::vector<Common::Redis::RespValue> values(num_values);
-
-  for (uint32_t i = 0; i < num_values; i++) {
-    values[i].type(Common::Redis::RespType::BulkString);
-  }
-  values[--num_values].asString() = incoming_request_->asArray()[index + 1].asString();
-  values[--num_values].asString() = "get";
-
-  request.type(Common::Redis::RespType::Array);
-  request.asArray().swap(values);
+  fillRequest(request, pending_requests_[index].num_keys_ == 1 ? "get" : "mget", index);
 }
 
 SplitRequestPtr MSETRequest::create(Router& router, Common::Redis::RespValuePtr&& incoming_request,
@@ -367,44 +512,13 @@ SplitRequestPtr MSETRequest::create(Router& router, Common::Redis::RespValuePtr&
   std::unique_ptr<MSETRequest> request_ptr{
       new MSETRequest(callbacks, command_stats, time_source, latency_in_micros)};
 
-  request_ptr->num_pending_responses_ = (incoming_request->asArray().size() - 1) / 2;
-  request_ptr->pending_requests_.reserve(request_ptr->num_pending_responses_);
-
   request_ptr->pending_response_ = std::make_unique<Common::Redis::RespValue>();
   request_ptr->pending_response_->type(Common::Redis::RespType::SimpleString);
 
-  std::vector<Common::Redis::RespValue> values(3);
-  values[0].type(Common::Redis::RespType::BulkString);
-  values[0].asString() = "set";
-  values[1].type(Common::Redis::RespType::BulkString);
-  values[2].type(Common::Redis::RespType::BulkString);
-  Common::Redis::RespValue single_mset;
-  single_mset.type(Common::Redis::RespType::Array);
-  single_mset.asArray().swap(values);
-
-  uint64_t fragment_index = 0;
-  for (uint64_t i = 1; i < incoming_request->asArray().size(); i += 2) {
-    request_ptr->pending_requests_.emplace_back(*request_ptr, fragment_index++);
-    PendingRequest& pending_request = request_ptr->pending_requests_.back();
-
-    single_mset.asArray()[1].asString() = incoming_request->asArray()[i].asString();
-    single_mset.asArray()[2].asString() = incoming_request->asArray()[i + 1].asString();
-
-    ENVOY_LOG(debug, "redis: parallel set: '{}'", single_mset.toString());
-    const auto route = router.upstreamPool(incoming_request->asArray()[i].asString());
-    if (route) {
-      pending_request.conn_pool_ = route->upstream();
-      pending_request.handle_ = makeRequest(route, "set", incoming_request->asArray()[i].asString(),
-                                            single_mset, pending_request);
-    }
-
-    if (!pending_request.handle_) {
-      pending_request.onResponse(Utility::makeError(Response::get().NoUpstreamHost));
-    }
-  }
+  request_ptr->incoming_request_ = std::move(incoming_request);
+  request_ptr->makeFragmentedRequests(router);
 
   if (request_ptr->num_pending_responses_ > 0) {
-    request_ptr->incoming_request_ = std::move(incoming_request);
     return request_ptr;
   }
 
@@ -422,7 +536,8 @@ void MSETRequest::onChildResponse(Common::Redis::RespValuePtr&& value, uint32_t
     FALLTHRU;
   }
   default: {
-    error_count_++;
+    // The error is counted for each of the keys set by the request.
+    error_count_ += pending_requests_[index].num_keys_;
     break;
   }
   }
@@ -441,19 +556,7 @@ void MSETRequest::onChildResponse(Common::Redis::RespValuePtr&& value, uint32_t
 }
 
 void MSETRequest::recreate(Common::Redis::RespValue& request, uint32_t index) {
-  static const uint32_t SET_COMMAND_SUBSTRINGS = 3;
-  uint32_t num_values = SET_COMMAND_SUBSTRINGS;
-  std::vector<Common::Redis::RespValue> values(num_values);
-
-  for (uint32_t i = 0; i < num_values; i++) {
-    values[i].type(Common::Redis::RespType::BulkString);
-  }
-  values[--num_values].asString() = incoming_request_->asArray()[(index * 2) + 2].asString();
-  values[--num_values].asString() = incoming_request_->asArray()[(index * 2) + 1].asString();
-  values[--num_values].asString() = "set";
-
-  request.type(Common::Redis::RespType::Array);
-  request.asArray().swap(values);
+  fillRequest(request, pending_requests_[index].num_keys_ == 1 ? "set" : "mset", index);
 }
 
 SplitRequestPtr SplitKeysSumResultRequest::create(Router& router,
@@ -464,42 +567,13 @@ SplitRequestPtr SplitKeysSumResultRequest::create(Router& router,
   std::unique_ptr<SplitKeysSumResultRequest> request_ptr{
       new SplitKeysSumResultRequest(callbacks, command_stats, time_source, latency_in_micros)};
 
-  request_ptr->num_pending_responses_ = incoming_request->asArray().size() - 1;
-  request_ptr->pending_requests_.reserve(request_ptr->num_pending_responses_);
-
   request_ptr->pending_response_ = std::make_unique<Common::Redis::RespValue>();
   request_ptr->pending_response_->type(Common::Redis::RespType::Integer);
 
-  std::vector<Common::Redis::RespValue> values(2);
-  values[0].type(Common::Redis::RespType::BulkString);
-  values[0].asString() = incoming_request->asArray()[0].asString();
-  values[1].type(Common::Redis::RespType::BulkString);
-  Common::Redis::RespValue single_fragment;
-  single_fragment.type(Common::Redis::RespType::Array);
-  single_fragment.asArray().swap(values);
-
-  for (uint64_t i = 1; i < incoming_request->asArray().size(); i++) {
-    request_ptr->pending_requests_.emplace_back(*request_ptr, i - 1);
-    PendingRequest& pending_request = request_ptr->pending_requests_.back();
-
-    single_fragment.asArray()[1].asString() = incoming_request->asArray()[i].asString();
-    ENVOY_LOG(debug, "redis: parallel {}: '{}'", incoming_request->asArray()[0].asString(),
-              single_fragment.toString());
-    const auto route = router.upstreamPool(incoming_request->asArray()[i].asString());
-    if (route) {
-      pending_request.conn_pool_ = route->upstream();
-      pending_request.handle_ =
-          makeRequest(route, single_fragment.asArray()[0].asString(),
-                      incoming_request->asArray()[i].asString(), single_fragment, pending_request);
-    }
-
-    if (!pending_request.handle_) {
-      pending_request.onResponse(Utility::makeError(Response::get().NoUpstreamHost));
-    }
-  }
+  request_ptr->incoming_request_ = std::move(incoming_request);
+  request_ptr->makeFragmentedRequests(router);
 
   if (request_ptr->num_pending_responses_ > 0) {
-    request_ptr->incoming_request_ = std::move(incoming_request);
     return request_ptr;
   }
 
@@ -516,7 +590,7 @@ void SplitKeysSumResultRequest::onChildResponse(Common::Redis::RespValuePtr&& va
     break;
   }
   default: {
-    error_count_++;
+    error_count_ += pending_requests_[index].num_keys_;
     break;
   }
   }
@@ -535,23 +609,14 @@ void SplitKeysSumResultRequest::onChildResponse(Common::Redis::RespValuePtr&& va
 }
 
 void SplitKeysSumResultRequest::recreate(Common::Redis::RespValue& request, uint32_t index) {
-  static const uint32_t BASE_COMMAND_SUBSTRINGS = 2;
-  uint32_t num_values = BASE_COMMAND_SUBSTRINGS;
-  std::vector<Common::Redis::RespValue> values(num_values);
-
-  for (uint32_t i = 0; i < num_values; i++) {
-    values[i].type(Common::Redis::RespType::BulkString);
-  }
-  values[--num_values].asString() = incoming_request_->asArray()[index + 1].asString();
-  values[--num_values].asString() = incoming_request_->asArray()[0].asString();
-
-  request.type(Common::Redis::RespType::Array);
-  request.asArray().swap(values);
+  fillRequest(request, incoming_request_->asArray()[0].asString(), index);
 }
 
 InstanceImpl::InstanceImpl(RouterPtr&& router, Stats::Scope& scope, const std::string& stat_prefix,
-                           TimeSource& time_source, bool latency_in_micros)
-    : router_(std::move(router)), simple_command_handler_(*router_),
+                           TimeSource& time_source, bool latency_in_micros,
+                           LocalCacheSharedPtr local_cache)
+    : router_(std::move(router)), local_cache_(std::move(local_cache)),
+      simple_command_handler_(*router_),
       eval_command_handler_(*router_), mget_handler_(*router_), mset_handler_(*router_),
       split_keys_sum_result_handler_(*router_),
       stats_{ALL_COMMAND_SPLITTER_STATS(POOL_COUNTER_PREFIX(scope, stat_prefix + "splitter."))},
@@ -628,6 +693,35 @@ SplitRequestPtr InstanceImpl::makeRequest(Common::Redis::RespValuePtr&& request,
   }
   ENVOY_LOG(debug, "redis: splitting '{}'", request->toString());
   handler->command_stats_.total_.inc();
+
+  if (local_cache_ != nullptr) {
+    // The large bulk strings kept in buffers are not cached keys, and are not copied into strings
+    // to be checked.
+    const std::vector<Common::Redis::RespValue>& arguments = request->asArray();
+    if (to_lower_string == Common::Redis::SupportedCommands::get() &&
+        arguments[1].bulkStringBuffer() == nullptr &&
+        local_cache_->cacheable(arguments[1].asString())) {
+      return CachedGetRequest::create(*router_, *local_cache_, std::move(request), callbacks,
+                                      handler->command_stats_, time_source_, latency_in_micros_);
+    }
+    if (!Common::Redis::SupportedCommands::isReadCommand(to_lower_string)) {
+      // Any argument of a write may be a key written.
+      std::vector<std::string> keys;
+      for (uint64_t i = 1; i < arguments.size(); i++) {
+        if (arguments[i].bulkStringBuffer() == nullptr &&
+            local_cache_->cacheable(arguments[i].asString())) {
+          keys.push_back(arguments[i].asString());
+        }
+      }
+      if (!keys.empty()) {
+        return WriteInvalidatingRequest::create(handler->handler_.get(), *local_cache_,
+                                                std::move(keys), std::move(request), callbacks,
+                                                handler->command_stats_, time_source_,
+                                                latency_in_micros_);
+      }
+    }
+  }
+
   SplitRequestPtr request_ptr = handler->handler_.get().startRequest(
       std::move(request), callbacks, handler->command_stats_, time_source_, latency_in_micros_);
   return request_ptr;
@@ -17,6 +17,7 @@
 #include "extensions/filters/network/common/redis/client_impl.h"
 #include "extensions/filters/network/redis_proxy/command_splitter.h"
 #include "extensions/filters/network/redis_proxy/conn_pool.h"
+#include "extensions/filters/network/redis_proxy/local_cache.h"
 #include "extensions/filters/network/redis_proxy/router.h"
 
 namespace Envoy {
@@ -136,6 +137,70 @@ private:
       : SingleServerRequest(callbacks, command_stats, time_source, latency_in_micros) {}
 };
 
+/**
+ * CachedGetRequest serves a GET of a cacheable key from the local cache, or else sends it upstream
+ * and offers the value read to the cache.
+ */
+class CachedGetRequest : public SingleServerRequest {
+public:
+  static SplitRequestPtr create(Router& router, LocalCache& local_cache,
+                                Common::Redis::RespValuePtr&& incoming_request,
+                                SplitCallbacks& callbacks, CommandStats& command_stats,
+                                TimeSource& time_source, bool latency_in_micros);
+
+  // Common::Redis::Client::PoolCallbacks
+  void onResponse(Common::Redis::RespValuePtr&& response) override;
+
+private:
+  CachedGetRequest(LocalCache& local_cache, SplitCallbacks& callbacks, CommandStats& command_stats,
+                   TimeSource& time_source, bool latency_in_micros)
+      : SingleServerRequest(callbacks, command_stats, time_source, latency_in_micros),
+        local_cache_(local_cache) {}
+
+  LocalCache& local_cache_;
+  // The key as received, before routing removes any prefix from it.
+  std::string key_;
+  uint32_t version_{};
+};
+
+/**
+ * WriteInvalidatingRequest wraps a request writing cacheable keys, which are invalidated when it is
+ * sent. The keys are invalidated again when its response is received, so that a GET which started
+ * in between but read the value before the write applied does not get that value cached.
+ */
+class WriteInvalidatingRequest : public SplitRequest, public SplitCallbacks {
+public:
+  WriteInvalidatingRequest(LocalCache& local_cache, std::vector<std::string>&& keys,
+                           SplitCallbacks& callbacks)
+      : local_cache_(local_cache), keys_(std::move(keys)), callbacks_(callbacks) {}
+
+  /**
+   * Start the wrapped request.
+   * @return SplitRequestPtr the request to cancel, or nullptr if it already completed.
+   */
+  static SplitRequestPtr create(CommandHandler& handler, LocalCache& local_cache,
+                                std::vector<std::string>&& keys,
+                                Common::Redis::RespValuePtr&& incoming_request,
+                                SplitCallbacks& callbacks, CommandStats& command_stats,
+                                TimeSource& time_source, bool latency_in_micros);
+
+  // RedisProxy::CommandSplitter::SplitRequest
+  void cancel() override;
+
+  // RedisProxy::CommandSplitter::SplitCallbacks
+  bool connectionAllowed() override { return callbacks_.connectionAllowed(); }
+  void onAuth(const std::string& password) override { callbacks_.onAuth(password); }
+  void onResponse(Common::Redis::RespValuePtr&& value) override;
+
+private:
+  void invalidate();
+
+  LocalCache& local_cache_;
+  const std::vector<std::string> keys_;
+  SplitCallbacks& callbacks_;
+  SplitRequestPtr request_;
+};
+
 /**
  * EvalRequest hashes the fourth argument as the key.
  */
@@ -152,11 +217,11 @@ private:
 };
 
 /**
- * FragmentedRequest is a base class for requests that contains multiple keys. An individual request
- * is sent to the appropriate server for each key. The responses from all servers are combined and
- * returned to the client.
+ * FragmentedRequest is a base class for requests that contains multiple keys. The keys are grouped
+ * by the server they are sent to, and an individual request is sent to the appropriate server for
+ * each group of keys. The responses from all servers are combined and returned to the client.
  */
-class FragmentedRequest : public SplitRequestBase {
+class FragmentedRequest : public SplitRequestBase, protected Logger::Loggable<Logger::Id::redis> {
 public:
   ~FragmentedRequest() override;
 
@@ -164,9 +229,14 @@ public:
   void cancel() override;
 
 protected:
+  /**
+   * @param args_per_key supplies the number of arguments of each key of the command, e.g. 2 for the
+   *        key and value pairs of MSET.
+   */
   FragmentedRequest(SplitCallbacks& callbacks, CommandStats& command_stats, TimeSource& time_source,
-                    bool latency_in_micros)
-      : SplitRequestBase(command_stats, time_source, latency_in_micros), callbacks_(callbacks) {}
+                    bool latency_in_micros, uint32_t args_per_key = 1)
+      : SplitRequestBase(command_stats, time_source, latency_in_micros), callbacks_(callbacks),
+        args_per_key_(args_per_key) {}
 
   struct PendingRequest : public Common::Redis::Client::PoolCallbacks {
     PendingRequest(FragmentedRequest& parent, uint32_t index) : parent_(parent), index_(index) {}
@@ -183,10 +253,34 @@ protected:
 
     FragmentedRequest& parent_;
     const uint32_t index_;
+    // The keys of the request are fragment_keys_[keys_begin_, keys_begin_ + num_keys_).
+    uint32_t keys_begin_{};
+    uint32_t num_keys_{};
     Common::Redis::Client::PoolRequest* handle_{};
     ConnPool::InstanceSharedPtr conn_pool_;
   };
 
+  /**
+   * Send the keys of incoming_request_ to their servers, in one request per group of keys sharing
+   * a connection pool and a hash key. The requests are made by recreate().
+   * @param router supplies the router of the keys.
+   */
+  void makeFragmentedRequests(Router& router);
+
+  /**
+   * Fill a request with a command followed by the arguments of the keys of a pending request.
+   * @param request supplies the request to fill, whose values are reused.
+   * @param command supplies the command.
+   * @param index supplies the index of the pending request.
+   */
+  void fillRequest(Common::Redis::RespValue& request, const std::string& command,
+                   uint32_t index) const;
+
+  /**
+   * @return the index in the command of the first argument of a key.
+   */
+  uint32_t keyArgIndex(uint32_t key) const { return 1 + key * args_per_key_; }
+
   virtual void onChildResponse(Common::Redis::RespValuePtr&& value, uint32_t index) PURE;
   void onChildFailure(uint32_t index);
   bool onChildRedirection(const Common::Redis::RespValue& value, uint32_t index,
@@ -194,19 +288,23 @@ protected:
   virtual void recreate(Common::Redis::RespValue& request, uint32_t index) PURE;
 
   SplitCallbacks& callbacks_;
+  const uint32_t args_per_key_;
 
   Common::Redis::RespValuePtr incoming_request_;
   Common::Redis::RespValuePtr pending_response_;
   std::vector<PendingRequest> pending_requests_;
+  // The indexes of the keys of the command, grouped by pending request.
+  std::vector<uint32_t> fragment_keys_;
   uint32_t num_pending_responses_;
   uint32_t error_count_{0};
 };
 
 /**
  * MGETRequest takes each key from the command and sends a GET for each to the appropriate Redis
- * server. The response contains the result from each command.
+ * server, or an MGET for the keys sent to the same server. The response contains the result from
+ * each command.
  */
-class MGETRequest : public FragmentedRequest, Logger::Loggable<Logger::Id::redis> {
+class MGETRequest : public FragmentedRequest {
 public:
   static SplitRequestPtr create(Router& router, Common::Redis::RespValuePtr&& incoming_request,
                                 SplitCallbacks& callbacks, CommandStats& command_stats,
@@ -220,15 +318,17 @@ private:
   // RedisProxy::CommandSplitter::FragmentedRequest
   void onChildResponse(Common::Redis::RespValuePtr&& value, uint32_t index) override;
   void recreate(Common::Redis::RespValue& request, uint32_t index) override;
+
+  void onKeyResponse(Common::Redis::RespValue& value, uint32_t key);
 };
 
 /**
  * SplitKeysSumResultRequest takes each key from the command and sends the same incoming command
- * with each key to the appropriate Redis server. The response from each Redis (which must be an
- * integer) is summed and returned to the user. If there is any error or failure in processing the
- * fragmented commands, an error will be returned.
+ * with the keys of each server to the appropriate Redis server. The response from each Redis (which
+ * must be an integer) is summed and returned to the user. If there is any error or failure in
+ * processing the fragmented commands, an error will be returned.
  */
-class SplitKeysSumResultRequest : public FragmentedRequest, Logger::Loggable<Logger::Id::redis> {
+class SplitKeysSumResultRequest : public FragmentedRequest {
 public:
   static SplitRequestPtr create(Router& router, Common::Redis::RespValuePtr&& incoming_request,
                                 SplitCallbacks& callbacks, CommandStats& command_stats,
@@ -248,10 +348,10 @@ private:
 
 /**
  * MSETRequest takes each key and value pair from the command and sends a SET for each to the
- * appropriate Redis server. The response is an OK if all commands succeeded or an ERR if any
- * failed.
+ * appropriate Redis server, or an MSET for the pairs sent to the same server. The response is an OK
+ * if all commands succeeded or an ERR if any failed.
  */
-class MSETRequest : public FragmentedRequest, Logger::Loggable<Logger::Id::redis> {
+class MSETRequest : public FragmentedRequest {
 public:
   static SplitRequestPtr create(Router& router, Common::Redis::RespValuePtr&& incoming_request,
                                 SplitCallbacks& callbacks, CommandStats& command_stats,
@@ -260,7 +360,7 @@ public:
 private:
   MSETRequest(SplitCallbacks& callbacks, CommandStats& command_stats, TimeSource& time_source,
               bool latency_in_micros)
-      : FragmentedRequest(callbacks, command_stats, time_source, latency_in_micros) {}
+      : FragmentedRequest(callbacks, command_stats, time_source, latency_in_micros, 2) {}
 
   // RedisProxy::CommandSplitter::FragmentedRequest
   void onChildResponse(Common::Redis::RespValuePtr&& value, uint32_t index) override;
@@ -302,7 +402,8 @@ struct InstanceStats {
 class InstanceImpl : public Instance, Logger::Loggable<Logger::Id::redis> {
 public:
   InstanceImpl(RouterPtr&& router, Stats::Scope& scope, const std::string& stat_prefix,
-               TimeSource& time_source, bool latency_in_micros);
+               TimeSource& time_source, bool latency_in_micros,
+               LocalCacheSharedPtr local_cache = nullptr);
 
   // RedisProxy::CommandSplitter::Instance
   SplitRequestPtr makeRequest(Common::Redis::RespValuePtr&& request,
@@ -321,6 +422,7 @@ private:
   void onInvalidRequest(SplitCallbacks& callbacks);
 
   RouterPtr router_;
+  const LocalCacheSharedPtr local_cache_;
   CommandHandlerFactory<SimpleRequest> simple_command_handler_;
   CommandHandlerFactory<EvalRequest> eval_command_handler_;
   CommandHandlerFactory<MGETRequest> mget_handler_;
@@ -4,6 +4,7 @@
 
 #include "extensions/filters/network/common/redis/client_impl.h"
 #include "extensions/filters/network/redis_proxy/command_splitter_impl.h"
+#include "extensions/filters/network/redis_proxy/local_cache_impl.h"
 #include "extensions/filters/network/redis_proxy/proxy_filter.h"
 #include "extensions/filters/network/redis_proxy/router_impl.h"
 
@@ -71,10 +72,17 @@ Network::FilterFactoryCb RedisProxyFilterConfigFactory::createFilterFactoryFromP
   auto router =
       std::make_unique<PrefixRoutes>(prefix_routes, std::move(upstreams), context.runtime());
 
+  LocalCacheSharedPtr local_cache;
+  if (proto_config.has_local_cache()) {
+    local_cache = std::make_shared<LocalCacheImpl>(
+        proto_config.local_cache(), context.threadLocal(), context.timeSource(), context.scope(),
+        filter_config->stat_prefix_ + "local_cache.");
+  }
+
   std::shared_ptr<CommandSplitter::Instance> splitter =
       std::make_shared<CommandSplitter::InstanceImpl>(
           std::move(router), context.scope(), filter_config->stat_prefix_, context.timeSource(),
-          proto_config.latency_in_micros());
+          proto_config.latency_in_micros(), std::move(local_cache));
   return [splitter, filter_config](Network::FilterManager& filter_manager) -> void {
     Common::Redis::DecoderFactoryImpl factory;
     filter_manager.addReadFilter(std::make_shared<ProxyFilter>(
@@ -9,6 +9,8 @@
 #include "extensions/filters/network/common/redis/client.h"
 #include "extensions/filters/network/common/redis/codec.h"
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -48,6 +50,13 @@ public:
   virtual Common::Redis::Client::PoolRequest*
   makeRequestToHost(const std::string& host_address, const Common::Redis::RespValue& request,
                     Common::Redis::Client::PoolCallbacks& callbacks) PURE;
+
+  /**
+   * @param key supplies the key of a request.
+   * @return the part of the key that the upstream host of the request is chosen by. The requests
+   *         of the keys sharing it are sent to the same host, and can be combined into one request.
+   */
+  virtual absl::string_view hashKey(absl::string_view key) const PURE;
 };
 
 using InstanceSharedPtr = std::shared_ptr<Instance>;
@@ -17,6 +17,25 @@ namespace RedisProxy {
 namespace ConnPool {
 namespace {
 Common::Redis::Client::DoNothingPoolCallbacks null_pool_callbacks;
+
+// The load balancer context of the hedge of a read, which goes to another host than the read.
+class HedgeLoadBalancerContext : public Clusters::Redis::RedisLoadBalancerContextImpl {
+public:
+  HedgeLoadBalancerContext(const std::string& key, bool enabled_hashtagging, bool use_crc16,
+                           const Common::Redis::RespValue& request,
+                           Common::Redis::Client::ReadPolicy read_policy,
+                           const Upstream::Host& read_host)
+      : RedisLoadBalancerContextImpl(key, enabled_hashtagging, use_crc16, request, read_policy),
+        read_host_(read_host) {}
+
+  // Upstream::LoadBalancerContext
+  bool shouldSelectAnotherHost(const Upstream::Host& host) override {
+    return &host == &read_host_;
+  }
+
+private:
+  const Upstream::Host& read_host_;
+};
 } // namespace
 
 InstanceImpl::InstanceImpl(
@@ -25,8 +44,9 @@ InstanceImpl::InstanceImpl(
     const envoy::config::filter::network::redis_proxy::v2::RedisProxy::ConnPoolSettings& config,
     Api::Api& api, Stats::ScopePtr&& stats_scope)
     : cm_(cm), client_factory_(client_factory), tls_(tls.allocateSlot()), config_(config),
-      api_(api), stats_scope_(std::move(stats_scope)), redis_cluster_stats_{REDIS_CLUSTER_STATS(
-                                                           POOL_COUNTER(*stats_scope_))} {
+      read_hedge_delay_(PROTOBUF_GET_MS_OR_DEFAULT(config, read_hedge_delay, 0)), api_(api),
+      stats_scope_(std::move(stats_scope)),
+      redis_cluster_stats_{REDIS_CLUSTER_STATS(POOL_COUNTER(*stats_scope_))} {
   tls_->set([this, cluster_name](
                 Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return std::make_shared<ThreadLocalPool>(*this, dispatcher, cluster_name);
@@ -46,6 +66,10 @@ InstanceImpl::makeRequestToHost(const std::string& host_address,
   return tls_->getTyped<ThreadLocalPool>().makeRequestToHost(host_address, request, callbacks);
 }
 
+absl::string_view InstanceImpl::hashKey(absl::string_view key) const {
+  return Clusters::Redis::RedisLoadBalancerContextImpl::hashtag(key, config_.enableHashtagging());
+}
+
 InstanceImpl::ThreadLocalPool::ThreadLocalPool(InstanceImpl& parent, Event::Dispatcher& dispatcher,
                                                std::string cluster_name)
     : parent_(parent), dispatcher_(dispatcher), cluster_name_(std::move(cluster_name)),
@@ -226,12 +250,19 @@ InstanceImpl::ThreadLocalPool::makeRequest(const std::string& key,
 
   const bool use_crc16 = is_redis_cluster_;
   Clusters::Redis::RedisLoadBalancerContextImpl lb_context(key, parent_.config_.enableHashtagging(),
-                                                           use_crc16, request);
+                                                           use_crc16, request,
+                                                           parent_.config_.readPolicy());
   Upstream::HostConstSharedPtr host = cluster_->loadBalancer().chooseHost(&lb_context);
   if (!host) {
     return nullptr;
   }
 
+  if (is_redis_cluster_ && parent_.read_hedge_delay_.count() > 0 &&
+      parent_.config_.readPolicy() != Common::Redis::Client::ReadPolicy::Master &&
+      lb_context.isReadCommand()) {
+    return makeHedgedRequest(std::move(host), key, request, callbacks);
+  }
+
   ThreadLocalActiveClientPtr& client = threadLocalActiveClient(host);
 
   return client->redis_client_->makeRequest(request, callbacks);
@@ -309,6 +340,115 @@ InstanceImpl::ThreadLocalPool::makeRequestToHost(const std::string& host_address
   return client->redis_client_->makeRequest(request, callbacks);
 }
 
+Common::Redis::Client::PoolRequest* InstanceImpl::ThreadLocalPool::makeHedgedRequest(
+    Upstream::HostConstSharedPtr host, const std::string& key,
+    const Common::Redis::RespValue& request, Common::Redis::Client::PoolCallbacks& callbacks) {
+  HedgedRequestPtr hedged_request =
+      std::make_unique<HedgedRequest>(*this, key, request, callbacks);
+  if (!hedged_request->first_.send(std::move(host))) {
+    return nullptr;
+  }
+  hedged_request->hedge_timer_->enableTimer(parent_.read_hedge_delay_);
+  hedged_request->moveIntoList(std::move(hedged_request), hedged_requests_);
+  return hedged_requests_.front().get();
+}
+
+bool InstanceImpl::HedgedAttempt::send(Upstream::HostConstSharedPtr host) {
+  host_ = std::move(host);
+  handle_ = parent_.parent_.threadLocalActiveClient(host_)->redis_client_->makeRequest(
+      parent_.request_, *this);
+  return handle_ != nullptr;
+}
+
+void InstanceImpl::HedgedAttempt::onResponse(Common::Redis::RespValuePtr&& value) {
+  parent_.onAttemptResponse(*this, std::move(value));
+}
+
+void InstanceImpl::HedgedAttempt::onFailure() { parent_.onAttemptFailure(*this); }
+
+bool InstanceImpl::HedgedAttempt::onRedirection(const Common::Redis::RespValue& value) {
+  return parent_.onAttemptRedirection(*this, value);
+}
+
+InstanceImpl::HedgedRequest::HedgedRequest(ThreadLocalPool& parent, const std::string& key,
+                                           const Common::Redis::RespValue& request,
+                                           Common::Redis::Client::PoolCallbacks& callbacks)
+    : parent_(parent), key_(key), request_(request), callbacks_(callbacks),
+      hedge_timer_(parent.dispatcher_.createTimer([this]() -> void { onHedgeTimeout(); })) {}
+
+void InstanceImpl::HedgedRequest::onHedgeTimeout() {
+  if (parent_.cluster_ == nullptr) {
+    return;
+  }
+
+  HedgeLoadBalancerContext lb_context(key_, parent_.parent_.config_.enableHashtagging(),
+                                      parent_.is_redis_cluster_, request_,
+                                      parent_.parent_.config_.readPolicy(), *first_.host_);
+  Upstream::HostConstSharedPtr host = parent_.cluster_->loadBalancer().chooseHost(&lb_context);
+  // The shard may have no other host to hedge the read to.
+  if (host == nullptr || host == first_.host_) {
+    return;
+  }
+  if (second_.send(std::move(host))) {
+    parent_.parent_.redis_cluster_stats_.upstream_rq_hedged_.inc();
+  }
+}
+
+void InstanceImpl::HedgedRequest::onAttemptResponse(HedgedAttempt& attempt,
+                                                    Common::Redis::RespValuePtr&& value) {
+  attempt.handle_ = nullptr;
+  if (&attempt == &second_) {
+    parent_.parent_.redis_cluster_stats_.upstream_rq_hedge_won_.inc();
+  }
+  cancelAttempts();
+  callbacks_.onResponse(std::move(value));
+  finish();
+}
+
+void InstanceImpl::HedgedRequest::onAttemptFailure(HedgedAttempt& attempt) {
+  attempt.handle_ = nullptr;
+  if (first_.handle_ != nullptr || second_.handle_ != nullptr) {
+    // The other attempt may still succeed.
+    return;
+  }
+  cancelAttempts();
+  callbacks_.onFailure();
+  finish();
+}
+
+bool InstanceImpl::HedgedRequest::onAttemptRedirection(HedgedAttempt& attempt,
+                                                       const Common::Redis::RespValue& value) {
+  attempt.handle_ = nullptr;
+  // The other attempt would be redirected as well.
+  cancelAttempts();
+  if (!callbacks_.onRedirection(value)) {
+    // The client passes the error on to onAttemptResponse().
+    return false;
+  }
+  // The caller made a new request in place of this one.
+  finish();
+  return true;
+}
+
+void InstanceImpl::HedgedRequest::cancelAttempts() {
+  hedge_timer_->disableTimer();
+  for (HedgedAttempt* attempt : {&first_, &second_}) {
+    if (attempt->handle_ != nullptr) {
+      attempt->handle_->cancel();
+      attempt->handle_ = nullptr;
+    }
+  }
+}
+
+void InstanceImpl::HedgedRequest::finish() {
+  parent_.dispatcher_.deferredDelete(removeFromList(parent_.hedged_requests_));
+}
+
+void InstanceImpl::HedgedRequest::cancel() {
+  cancelAttempts();
+  finish();
+}
+
 void InstanceImpl::ThreadLocalActiveClient::onEvent(Network::ConnectionEvent event) {
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
@@ -14,6 +14,7 @@
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/common/linked_object.h"
 #include "common/network/address_impl.h"
 #include "common/network/filter_impl.h"
 #include "common/protobuf/utility.h"
@@ -39,6 +40,8 @@ namespace ConnPool {
 
 #define REDIS_CLUSTER_STATS(COUNTER)                                                               \
   COUNTER(upstream_cx_drained)                                                                     \
+  COUNTER(upstream_rq_hedged)                                                                      \
+  COUNTER(upstream_rq_hedge_won)                                                                   \
   COUNTER(max_upstream_unknown_connections_reached)
 
 struct RedisClusterStats {
@@ -59,6 +62,7 @@ public:
   Common::Redis::Client::PoolRequest*
   makeRequestToHost(const std::string& host_address, const Common::Redis::RespValue& request,
                     Common::Redis::Client::PoolCallbacks& callbacks) override;
+  absl::string_view hashKey(absl::string_view key) const override;
 
   // Allow the unit test to have access to private members.
   friend class RedisConnPoolImplTest;
@@ -81,6 +85,64 @@ private:
 
   using ThreadLocalActiveClientPtr = std::unique_ptr<ThreadLocalActiveClient>;
 
+  struct HedgedRequest;
+
+  /**
+   * One of the two attempts of a hedged read.
+   */
+  struct HedgedAttempt : public Common::Redis::Client::PoolCallbacks {
+    HedgedAttempt(HedgedRequest& parent) : parent_(parent) {}
+
+    /**
+     * Send the read to a host.
+     * @return whether the read could be sent.
+     */
+    bool send(Upstream::HostConstSharedPtr host);
+
+    // Common::Redis::Client::PoolCallbacks
+    void onResponse(Common::Redis::RespValuePtr&& value) override;
+    void onFailure() override;
+    bool onRedirection(const Common::Redis::RespValue& value) override;
+
+    HedgedRequest& parent_;
+    Upstream::HostConstSharedPtr host_;
+    Common::Redis::Client::PoolRequest* handle_{};
+  };
+
+  /**
+   * A read sent to a host, and also to another host of its shard if it has not been answered
+   * after the read hedge delay. The first response is passed on, the other attempt is canceled.
+   */
+  struct HedgedRequest : public Common::Redis::Client::PoolRequest,
+                         public Event::DeferredDeletable,
+                         public LinkedObject<HedgedRequest> {
+    HedgedRequest(ThreadLocalPool& parent, const std::string& key,
+                  const Common::Redis::RespValue& request,
+                  Common::Redis::Client::PoolCallbacks& callbacks);
+
+    void onHedgeTimeout();
+    void onAttemptResponse(HedgedAttempt& attempt, Common::Redis::RespValuePtr&& value);
+    void onAttemptFailure(HedgedAttempt& attempt);
+    bool onAttemptRedirection(HedgedAttempt& attempt, const Common::Redis::RespValue& value);
+    void cancelAttempts();
+    void finish();
+
+    // Common::Redis::Client::PoolRequest
+    void cancel() override;
+
+    ThreadLocalPool& parent_;
+    const std::string key_;
+    // Copied, as the hedge may be sent once the caller is done with the request, e.g. if the
+    // caller is a mirror policy.
+    const Common::Redis::RespValue request_;
+    Common::Redis::Client::PoolCallbacks& callbacks_;
+    HedgedAttempt first_{*this};
+    HedgedAttempt second_{*this};
+    Event::TimerPtr hedge_timer_;
+  };
+
+  using HedgedRequestPtr = std::unique_ptr<HedgedRequest>;
+
   struct ThreadLocalPool : public ThreadLocal::ThreadLocalObject,
                            public Upstream::ClusterUpdateCallbacks {
     ThreadLocalPool(InstanceImpl& parent, Event::Dispatcher& dispatcher, std::string cluster_name);
@@ -92,6 +154,10 @@ private:
     Common::Redis::Client::PoolRequest*
     makeRequestToHost(const std::string& host_address, const Common::Redis::RespValue& request,
                       Common::Redis::Client::PoolCallbacks& callbacks);
+    Common::Redis::Client::PoolRequest*
+    makeHedgedRequest(Upstream::HostConstSharedPtr host, const std::string& key,
+                      const Common::Redis::RespValue& request,
+                      Common::Redis::Client::PoolCallbacks& callbacks);
     void onClusterAddOrUpdateNonVirtual(Upstream::ThreadLocalCluster& cluster);
     void onHostsAdded(const std::vector<Upstream::HostSharedPtr>& hosts_added);
     void onHostsRemoved(const std::vector<Upstream::HostSharedPtr>& hosts_removed);
@@ -114,6 +180,7 @@ private:
     std::string auth_password_;
     std::list<Upstream::HostSharedPtr> created_via_redirect_hosts_;
     std::list<ThreadLocalActiveClientPtr> clients_to_drain_;
+    std::list<HedgedRequestPtr> hedged_requests_;
 
     /* This timer is used to poll the active clients in clients_to_drain_ to determine whether they
      * have been drained (have no active requests) or not. It is only enabled after a client has
@@ -129,6 +196,8 @@ private:
   Common::Redis::Client::ClientFactory& client_factory_;
   ThreadLocal::SlotPtr tls_;
   Common::Redis::Client::ConfigImpl config_;
+  // Zero if reads are not hedged.
+  const std::chrono::milliseconds read_hedge_delay_;
   Api::Api& api_;
   Stats::ScopePtr stats_scope_;
   RedisClusterStats redis_cluster_stats_;
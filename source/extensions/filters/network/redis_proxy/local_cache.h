@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/common/pure.h"
+
+#include "extensions/filters/network/common/redis/codec.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+
+/**
+ * A cache of the values of hot keys read by GET, kept by each worker.
+ */
+class LocalCache {
+public:
+  virtual ~LocalCache() = default;
+
+  /**
+   * @param key supplies a key.
+   * @return whether the value of the key may be cached.
+   */
+  virtual bool cacheable(absl::string_view key) const PURE;
+
+  /**
+   * Look up the value of a cacheable key being read, counting the read towards the detection of
+   * hot keys.
+   * @param key supplies the key.
+   * @param version supplies the version of the key, to be passed to insert() along with the value
+   *        read from upstream on a miss.
+   * @return the cached value, or nullptr if the key is not cached.
+   */
+  virtual Common::Redis::RespValuePtr lookup(const std::string& key, uint32_t& version) PURE;
+
+  /**
+   * Cache the value of a cacheable key read from upstream if the key is hot, unless the key was
+   * written since it was looked up.
+   * @param key supplies the key.
+   * @param value supplies the value.
+   * @param version supplies the version of the key returned by lookup().
+   */
+  virtual void insert(const std::string& key, const Common::Redis::RespValue& value,
+                      uint32_t version) PURE;
+
+  /**
+   * Invalidate the value of a cacheable key being written, in the caches of all the workers.
+   * @param key supplies the key.
+   */
+  virtual void invalidate(absl::string_view key) PURE;
+};
+
+using LocalCacheSharedPtr = std::shared_ptr<LocalCache>;
+
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,165 @@
+#include "extensions/filters/network/redis_proxy/local_cache_impl.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "common/common/hash.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/strings/match.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+
+namespace {
+
+uint32_t roundUpToPowerOfTwo(uint32_t value) {
+  uint32_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+} // namespace
+
+CountMinSketch::CountMinSketch(uint32_t width)
+    : mask_(roundUpToPowerOfTwo(width) - 1), sample_size_(10 * (mask_ + 1)),
+      counters_(DEPTH * (mask_ + 1)) {}
+
+uint32_t CountMinSketch::increment(uint64_t hash) {
+  uint32_t estimate = std::numeric_limits<uint16_t>::max();
+  for (uint32_t row = 0; row < DEPTH; row++) {
+    uint16_t& counter = counters_[index(hash, row)];
+    if (counter < std::numeric_limits<uint16_t>::max()) {
+      counter++;
+    }
+    estimate = std::min<uint32_t>(estimate, counter);
+  }
+  if (++increments_ == sample_size_) {
+    halve();
+  }
+  return estimate;
+}
+
+uint32_t CountMinSketch::estimate(uint64_t hash) const {
+  uint32_t estimate = std::numeric_limits<uint16_t>::max();
+  for (uint32_t row = 0; row < DEPTH; row++) {
+    estimate = std::min<uint32_t>(estimate, counters_[index(hash, row)]);
+  }
+  return estimate;
+}
+
+size_t CountMinSketch::index(uint64_t hash, uint32_t row) const {
+  // The index in each row is derived from the two halves of the hash by double hashing.
+  const uint32_t low = hash;
+  const uint32_t high = (hash >> 32) | 1;
+  return row * (mask_ + 1) + ((low + row * high) & mask_);
+}
+
+void CountMinSketch::halve() {
+  for (uint16_t& counter : counters_) {
+    counter >>= 1;
+  }
+  increments_ /= 2;
+}
+
+LocalCacheImpl::LocalCacheImpl(
+    const envoy::config::filter::network::redis_proxy::v2::RedisProxy::LocalCache& config,
+    ThreadLocal::SlotAllocator& tls, TimeSource& time_source, Stats::Scope& scope,
+    const std::string& stat_prefix)
+    : prefixes_(config.prefixes().begin(), config.prefixes().end()),
+      ttl_(PROTOBUF_GET_MS_REQUIRED(config, ttl)),
+      max_entries_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entries, 10000)),
+      hot_key_threshold_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, hot_key_threshold, 3)),
+      time_source_(time_source),
+      stats_{ALL_REDIS_LOCAL_CACHE_STATS(POOL_COUNTER_PREFIX(scope, stat_prefix))},
+      versions_(NUM_VERSIONS), tls_(tls.allocateSlot()) {
+  // The sketch counts the reads of more keys than are cached, the hot keys being found among them.
+  const uint32_t sketch_width = 4 * max_entries_;
+  tls_->set([sketch_width](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<ThreadLocalCache>(sketch_width);
+  });
+}
+
+bool LocalCacheImpl::cacheable(absl::string_view key) const {
+  for (const std::string& prefix : prefixes_) {
+    if (absl::StartsWith(key, prefix)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Common::Redis::RespValuePtr LocalCacheImpl::lookup(const std::string& key, uint32_t& version) {
+  const uint64_t hash = HashUtil::xxHash64(key);
+  version = keyVersion(hash).load();
+
+  ThreadLocalCache& cache = tls_->getTyped<ThreadLocalCache>();
+  if (cache.sketch_.increment(hash) == hot_key_threshold_) {
+    stats_.hot_key_.inc();
+    ENVOY_LOG(debug, "redis: hot key '{}'", key);
+  }
+
+  const auto it = cache.index_.find(key);
+  if (it != cache.index_.end()) {
+    const Entry& entry = *it->second;
+    if (entry.version_ == version && entry.expiry_ > time_source_.monotonicTime()) {
+      cache.entries_.splice(cache.entries_.begin(), cache.entries_, it->second);
+      stats_.hit_.inc();
+      return std::make_unique<Common::Redis::RespValue>(entry.value_);
+    }
+    // The key was written or the value expired.
+    cache.erase(it);
+  }
+  stats_.miss_.inc();
+  return nullptr;
+}
+
+void LocalCacheImpl::insert(const std::string& key, const Common::Redis::RespValue& value,
+                            uint32_t version) {
+  const uint64_t hash = HashUtil::xxHash64(key);
+  ThreadLocalCache& cache = tls_->getTyped<ThreadLocalCache>();
+  if (version != keyVersion(hash).load() || cache.sketch_.estimate(hash) < hot_key_threshold_) {
+    return;
+  }
+
+  const MonotonicTime expiry = time_source_.monotonicTime() + ttl_;
+  const auto it = cache.index_.find(key);
+  if (it != cache.index_.end()) {
+    Entry& entry = *it->second;
+    entry.value_ = value;
+    entry.version_ = version;
+    entry.expiry_ = expiry;
+    cache.entries_.splice(cache.entries_.begin(), cache.entries_, it->second);
+    return;
+  }
+
+  if (cache.entries_.size() >= max_entries_) {
+    cache.erase(cache.index_.find(cache.entries_.back().key_));
+    stats_.evict_.inc();
+  }
+  cache.entries_.push_front(Entry{key, value, version, expiry});
+  cache.index_.emplace(cache.entries_.front().key_, cache.entries_.begin());
+  stats_.insert_.inc();
+}
+
+void LocalCacheImpl::invalidate(absl::string_view key) {
+  // The values cached by the workers are dropped as they are looked up.
+  keyVersion(HashUtil::xxHash64(key))++;
+  stats_.invalidate_.inc();
+}
+
+void LocalCacheImpl::ThreadLocalCache::erase(
+    absl::flat_hash_map<absl::string_view, EntryList::iterator>::iterator it) {
+  const EntryList::iterator entry = it->second;
+  index_.erase(it);
+  entries_.erase(entry);
+}
+
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
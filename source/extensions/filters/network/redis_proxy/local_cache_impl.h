@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/config/filter/network/redis_proxy/v2/redis_proxy.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/logger.h"
+
+#include "extensions/filters/network/redis_proxy/local_cache.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+
+/**
+ * All local cache stats. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_REDIS_LOCAL_CACHE_STATS(COUNTER)                                                       \
+  COUNTER(evict)                                                                                   \
+  COUNTER(hit)                                                                                     \
+  COUNTER(hot_key)                                                                                 \
+  COUNTER(insert)                                                                                  \
+  COUNTER(invalidate)                                                                              \
+  COUNTER(miss)
+// clang-format on
+
+/**
+ * Struct definition for all local cache stats. @see stats_macros.h
+ */
+struct LocalCacheStats {
+  ALL_REDIS_LOCAL_CACHE_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * A count-min sketch estimating how often hashes were counted recently. The counts are halved
+ * once as many hashes as 10 times the width of the sketch were counted, so that the keys which
+ * are no longer read cool down.
+ */
+class CountMinSketch {
+public:
+  /**
+   * @param width supplies the number of counters of each row, rounded up to a power of two.
+   */
+  explicit CountMinSketch(uint32_t width);
+
+  /**
+   * Count a hash.
+   * @return the estimated count of the hash, including this one.
+   */
+  uint32_t increment(uint64_t hash);
+
+  /**
+   * @return the estimated count of a hash, which may exceed but not fall short of its actual count
+   *         since the last halving.
+   */
+  uint32_t estimate(uint64_t hash) const;
+
+private:
+  static constexpr uint32_t DEPTH = 4;
+
+  size_t index(uint64_t hash, uint32_t row) const;
+  void halve();
+
+  const uint32_t mask_;
+  const uint32_t sample_size_;
+  uint32_t increments_{};
+  std::vector<uint16_t> counters_;
+};
+
+class LocalCacheImpl : public LocalCache, Logger::Loggable<Logger::Id::redis> {
+public:
+  LocalCacheImpl(const envoy::config::filter::network::redis_proxy::v2::RedisProxy::LocalCache&
+                     config,
+                 ThreadLocal::SlotAllocator& tls, TimeSource& time_source, Stats::Scope& scope,
+                 const std::string& stat_prefix);
+
+  // RedisProxy::LocalCache
+  bool cacheable(absl::string_view key) const override;
+  Common::Redis::RespValuePtr lookup(const std::string& key, uint32_t& version) override;
+  void insert(const std::string& key, const Common::Redis::RespValue& value,
+              uint32_t version) override;
+  void invalidate(absl::string_view key) override;
+
+  // The number of versions shared by the keys, a power of two.
+  static constexpr uint32_t NUM_VERSIONS = 1 << 16;
+
+private:
+  struct Entry {
+    std::string key_;
+    Common::Redis::RespValue value_;
+    uint32_t version_;
+    MonotonicTime expiry_;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  struct ThreadLocalCache : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalCache(uint32_t sketch_width) : sketch_(sketch_width) {}
+
+    void erase(absl::flat_hash_map<absl::string_view, EntryList::iterator>::iterator it);
+
+    // The entries, the most recently used first.
+    EntryList entries_;
+    absl::flat_hash_map<absl::string_view, EntryList::iterator> index_;
+    CountMinSketch sketch_;
+  };
+
+  std::atomic<uint32_t>& keyVersion(uint64_t hash) { return versions_[hash & (NUM_VERSIONS - 1)]; }
+
+  const std::vector<std::string> prefixes_;
+  const std::chrono::milliseconds ttl_;
+  const uint32_t max_entries_;
+  const uint32_t hot_key_threshold_;
+  TimeSource& time_source_;
+  LocalCacheStats stats_;
+  // The versions of the keys, shared by the workers. The version of a key changes when the key is
+  // written, invalidating its cached values along with those of the keys sharing its version.
+  std::vector<std::atomic<uint32_t>> versions_;
+  ThreadLocal::SlotPtr tls_;
+};
+
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -4,6 +4,7 @@
 
 #include "envoy/common/exception.h"
 
+#include "common/buffer/reader.h"
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
 #include "common/common/macros.h"
@@ -44,8 +45,7 @@ bool BinaryProtocolImpl::readMessageBegin(Buffer::Instance& buffer, MessageMetad
   buffer.drain(8);
 
   if (name_len > 0) {
-    metadata.setMethodName(
-        std::string(static_cast<const char*>(buffer.linearize(name_len)), name_len));
+    metadata.setMethodName(Buffer::Reader(buffer).readString(name_len));
     buffer.drain(name_len);
   } else {
     metadata.setMethodName("");
@@ -246,7 +246,7 @@ bool BinaryProtocolImpl::readString(Buffer::Instance& buffer, std::string& value
   }
 
   buffer.drain(4);
-  value.assign(static_cast<const char*>(buffer.linearize(str_len)), str_len);
+  value = Buffer::Reader(buffer).readString(str_len);
   buffer.drain(str_len);
   return true;
 }
@@ -379,8 +379,7 @@ bool LaxBinaryProtocolImpl::readMessageBegin(Buffer::Instance& buffer, MessageMe
 
   buffer.drain(4);
   if (name_len > 0) {
-    metadata.setMethodName(
-        std::string(static_cast<const char*>(buffer.linearize(name_len)), name_len));
+    metadata.setMethodName(Buffer::Reader(buffer).readString(name_len));
     buffer.drain(name_len);
   } else {
     metadata.setMethodName("");
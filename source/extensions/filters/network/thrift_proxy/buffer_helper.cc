@@ -1,5 +1,6 @@
 #include "extensions/filters/network/thrift_proxy/buffer_helper.h"
 
+#include "common/buffer/reader.h"
 #include "common/common/byte_order.h"
 
 namespace Envoy {
@@ -33,29 +34,19 @@ uint64_t BufferHelper::peekVarInt(Buffer::Instance& buffer, uint64_t offset, int
     throw EnvoyException("buffer underflow");
   }
 
-  // Need at most 10 bytes for a 64-bit var int.
-  const uint64_t last = std::min(buffer.length() - offset, static_cast<uint64_t>(10));
-
-  uint8_t shift = 0;
-  uint64_t result = 0;
-  for (uint64_t i = 0; i < last; i++) {
-    uint8_t b = buffer.peekInt<uint8_t>(offset + i);
-
-    // Note: the compact protocol spec says these variable-length ints are encoded as big-endian,
-    // but the Apache C++, Java, and Python implementations read and write them little-endian.
-    result |= static_cast<uint64_t>(b & 0x7f) << shift;
-    shift += 7;
-
-    if ((b & 0x80) == 0) {
-      // End of encoded int.
-      size = i + 1;
-      return result;
-    }
+  // Need at most 10 bytes for a 64-bit var int. The bytes are read across the slices of the
+  // buffer rather than each being copied out from the start of the buffer.
+  // Note: the compact protocol spec says these variable-length ints are encoded as big-endian,
+  // but the Apache C++, Java, and Python implementations read and write them little-endian.
+  Buffer::Reader reader(buffer, offset);
+  uint64_t result;
+  size = reader.readVarInt(result, 10);
+  if (size == 0) {
+    // Ran out of bytes (or it's invalid).
+    size = -std::min(reader.remaining(), static_cast<uint64_t>(10));
+    return 0;
   }
-
-  // Ran out of bytes (or it's invalid).
-  size = -last;
-  return 0;
+  return result;
 }
 
 int32_t BufferHelper::peekVarIntI32(Buffer::Instance& buffer, uint64_t offset, int& size) {
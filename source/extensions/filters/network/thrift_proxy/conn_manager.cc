@@ -170,6 +170,15 @@ DecoderEventHandler& ConnectionManager::newDecoderEventHandler() {
   return **rpcs_.begin();
 }
 
+bool ConnectionManager::passthroughEnabled() const {
+  if (!config_.payloadPassthrough()) {
+    return false;
+  }
+
+  // The decoder asks while decoding a message begin, for the rpc it just created.
+  return !rpcs_.empty() && (*rpcs_.begin())->passthroughSupported();
+}
+
 bool ConnectionManager::ResponseDecoder::onData(Buffer::Instance& data) {
   upstream_buffer_.move(data);
 
@@ -188,6 +197,20 @@ FilterStatus ConnectionManager::ResponseDecoder::messageBegin(MessageMetadataSha
   return ProtocolConverter::messageBegin(metadata);
 }
 
+FilterStatus ConnectionManager::ResponseDecoder::passthroughData(Buffer::Instance& data) {
+  passthrough_ = true;
+  return ProtocolConverter::passthroughData(data);
+}
+
+bool ConnectionManager::ResponseDecoder::passthroughEnabled() const {
+  const ConnectionManager& cm = parent_.parent_;
+
+  // The body is written downstream as received, so it must already be in the downstream protocol.
+  return cm.config_.payloadPassthrough() &&
+         decoder_->protocolType() == cm.decoder_->protocolType() &&
+         decoder_->protocolType() != ProtocolType::Twitter;
+}
+
 FilterStatus ConnectionManager::ResponseDecoder::fieldBegin(absl::string_view name,
                                                             FieldType& field_type,
                                                             int16_t& field_id) {
@@ -227,10 +250,17 @@ FilterStatus ConnectionManager::ResponseDecoder::transportEnd() {
   cm.read_callbacks_->connection().write(buffer, false);
 
   cm.stats_.response_.inc();
+  if (passthrough_) {
+    cm.stats_.response_passthrough_.inc();
+  }
 
   switch (metadata_->messageType()) {
   case MessageType::Reply:
     cm.stats_.response_reply_.inc();
+    if (passthrough_) {
+      // The reply struct was not decoded, so whether it holds a result or an exception is unknown.
+      break;
+    }
     if (success_.value_or(false)) {
       cm.stats_.response_success_.inc();
     } else {
@@ -345,6 +375,9 @@ void ConnectionManager::ActiveRpc::finalizeRequest() {
   pending_transport_end_ = false;
 
   parent_.stats_.request_.inc();
+  if (passthrough_) {
+    parent_.stats_.request_passthrough_.inc();
+  }
 
   bool destroy_rpc = false;
   switch (original_msg_type_) {
@@ -406,6 +439,18 @@ FilterStatus ConnectionManager::ActiveRpc::messageEnd() {
   return applyDecoderFilters(nullptr);
 }
 
+FilterStatus ConnectionManager::ActiveRpc::passthroughData(Buffer::Instance& data) {
+  passthrough_ = true;
+
+  filter_context_ = &data;
+  filter_action_ = [this](DecoderEventHandler* filter) -> FilterStatus {
+    Buffer::Instance* data = absl::any_cast<Buffer::Instance*>(filter_context_);
+    return filter->passthroughData(*data);
+  };
+
+  return applyDecoderFilters(nullptr);
+}
+
 FilterStatus ConnectionManager::ActiveRpc::structBegin(absl::string_view name) {
   filter_context_ = std::string(name);
   filter_action_ = [this](DecoderEventHandler* filter) -> FilterStatus {
@@ -572,6 +617,19 @@ FilterStatus ConnectionManager::ActiveRpc::setEnd() {
   return applyDecoderFilters(nullptr);
 }
 
+bool ConnectionManager::ActiveRpc::passthroughSupported() const {
+  if (upgrade_handler_ != nullptr) {
+    return false;
+  }
+
+  for (const auto& filter : decoder_filters_) {
+    if (!filter->handle_->passthroughSupported()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void ConnectionManager::ActiveRpc::createFilterChain() {
   parent_.config_.filterFactory().createFilterChain(*this);
 }
@@ -38,6 +38,11 @@ public:
   virtual TransportPtr createTransport() PURE;
   virtual ProtocolPtr createProtocol() PURE;
   virtual Router::Config& routerConfig() PURE;
+
+  /**
+   * @return bool true if the bodies of messages may be passed through without being decoded.
+   */
+  virtual bool payloadPassthrough() const PURE;
 };
 
 /**
@@ -75,6 +80,7 @@ public:
 
   // DecoderCallbacks
   DecoderEventHandler& newDecoderEventHandler() override;
+  bool passthroughEnabled() const override;
 
 private:
   struct ActiveRpc;
@@ -82,7 +88,7 @@ private:
   struct ResponseDecoder : public DecoderCallbacks, public ProtocolConverter {
     ResponseDecoder(ActiveRpc& parent, Transport& transport, Protocol& protocol)
         : parent_(parent), decoder_(std::make_unique<Decoder>(transport, protocol, *this)),
-          complete_(false), first_reply_field_(false) {
+          complete_(false), first_reply_field_(false), passthrough_(false) {
       initProtocolConverter(*parent_.parent_.protocol_, parent_.response_buffer_);
     }
 
@@ -90,6 +96,7 @@ private:
 
     // ProtocolConverter
     FilterStatus messageBegin(MessageMetadataSharedPtr metadata) override;
+    FilterStatus passthroughData(Buffer::Instance& data) override;
     FilterStatus fieldBegin(absl::string_view name, FieldType& field_type,
                             int16_t& field_id) override;
     FilterStatus transportBegin(MessageMetadataSharedPtr metadata) override {
@@ -100,6 +107,7 @@ private:
 
     // DecoderCallbacks
     DecoderEventHandler& newDecoderEventHandler() override { return *this; }
+    bool passthroughEnabled() const override;
 
     ActiveRpc& parent_;
     DecoderPtr decoder_;
@@ -108,6 +116,7 @@ private:
     absl::optional<bool> success_;
     bool complete_ : 1;
     bool first_reply_field_ : 1;
+    bool passthrough_ : 1;
   };
   using ResponseDecoderPtr = std::unique_ptr<ResponseDecoder>;
 
@@ -156,8 +165,8 @@ private:
         : parent_(parent), request_timer_(new Stats::Timespan(parent_.stats_.request_time_ms_,
                                                               parent_.time_source_)),
           stream_id_(parent_.random_generator_.random()),
-          stream_info_(parent_.time_source_), local_response_sent_{false}, pending_transport_end_{
-                                                                               false} {
+          stream_info_(parent_.time_source_), local_response_sent_{false},
+          pending_transport_end_{false}, passthrough_{false} {
       parent_.stats_.request_active_.inc();
 
       stream_info_.setDownstreamLocalAddress(parent_.read_callbacks_->connection().localAddress());
@@ -178,6 +187,7 @@ private:
     FilterStatus transportEnd() override;
     FilterStatus messageBegin(MessageMetadataSharedPtr metadata) override;
     FilterStatus messageEnd() override;
+    FilterStatus passthroughData(Buffer::Instance& data) override;
     FilterStatus structBegin(absl::string_view name) override;
     FilterStatus structEnd() override;
     FilterStatus fieldBegin(absl::string_view name, FieldType& field_type,
@@ -223,6 +233,7 @@ private:
 
     FilterStatus applyDecoderFilters(ActiveRpcDecoderFilter* filter);
     void finalizeRequest();
+    bool passthroughSupported() const;
 
     void createFilterChain();
     void onReset();
@@ -244,6 +255,7 @@ private:
     absl::any filter_context_;
     bool local_response_sent_ : 1;
     bool pending_transport_end_ : 1;
+    bool passthrough_ : 1;
   };
 
   using ActiveRpcPtr = std::unique_ptr<ActiveRpc>;
@@ -14,8 +14,10 @@ namespace Extensions {
 namespace NetworkFilters {
 namespace ThriftProxy {
 
-// MessageBegin -> StructBegin
+// MessageBegin -> StructBegin, or
+// MessageBegin -> PassthroughData
 DecoderStateMachine::DecoderStatus DecoderStateMachine::messageBegin(Buffer::Instance& buffer) {
+  const uint64_t length = buffer.length();
   if (!proto_.readMessageBegin(buffer, *metadata_)) {
     return {ProtocolState::WaitForData};
   }
@@ -23,7 +25,21 @@ DecoderStateMachine::DecoderStatus DecoderStateMachine::messageBegin(Buffer::Ins
   stack_.clear();
   stack_.emplace_back(Frame(ProtocolState::MessageEnd));
 
-  return {ProtocolState::StructBegin, handler_.messageBegin(metadata_)};
+  const FilterStatus status = handler_.messageBegin(metadata_);
+
+  // The handlers may only decide whether they support passthrough once they have seen the message
+  // begin (e.g. once the router has picked the upstream protocol).
+  if (metadata_->hasFrameSize() && callbacks_.passthroughEnabled()) {
+    const uint64_t message_begin_bytes = length - buffer.length();
+    if (message_begin_bytes > metadata_->frameSize()) {
+      throw EnvoyException(fmt::format("message begin of {} bytes exceeds frame size {}",
+                                       message_begin_bytes, metadata_->frameSize()));
+    }
+    body_bytes_ = metadata_->frameSize() - message_begin_bytes;
+    return {ProtocolState::PassthroughData, status};
+  }
+
+  return {ProtocolState::StructBegin, status};
 }
 
 // MessageEnd -> Done
@@ -35,6 +51,18 @@ DecoderStateMachine::DecoderStatus DecoderStateMachine::messageEnd(Buffer::Insta
   return {ProtocolState::Done, handler_.messageEnd()};
 }
 
+// PassthroughData -> MessageEnd
+DecoderStateMachine::DecoderStatus
+DecoderStateMachine::passthroughData(Buffer::Instance& buffer) {
+  if (buffer.length() < body_bytes_) {
+    return {ProtocolState::WaitForData};
+  }
+
+  stack_.pop_back();
+  body_.move(buffer, body_bytes_);
+  return {ProtocolState::MessageEnd, handler_.passthroughData(body_)};
+}
+
 // StructBegin -> FieldBegin
 DecoderStateMachine::DecoderStatus DecoderStateMachine::structBegin(Buffer::Instance& buffer) {
   std::string name;
@@ -320,6 +348,8 @@ DecoderStateMachine::DecoderStatus DecoderStateMachine::handleState(Buffer::Inst
     return setEnd(buffer);
   case ProtocolState::MessageEnd:
     return messageEnd(buffer);
+  case ProtocolState::PassthroughData:
+    return passthroughData(buffer);
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
@@ -409,7 +439,7 @@ FilterStatus Decoder::onData(Buffer::Instance& data, bool& buffer_underflow) {
     request_ = std::make_unique<ActiveRequest>(callbacks_.newDecoderEventHandler());
     frame_started_ = true;
     state_machine_ =
-        std::make_unique<DecoderStateMachine>(protocol_, metadata_, request_->handler_);
+        std::make_unique<DecoderStateMachine>(protocol_, metadata_, request_->handler_, callbacks_);
 
     if (request_->handler_.transportBegin(metadata_) == FilterStatus::StopIteration) {
       return FilterStatus::StopIteration;
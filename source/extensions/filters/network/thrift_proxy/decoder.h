@@ -2,6 +2,7 @@
 
 #include "envoy/buffer/buffer.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
 #include "common/common/logger.h"
 
@@ -14,11 +15,28 @@ namespace Extensions {
 namespace NetworkFilters {
 namespace ThriftProxy {
 
+class DecoderCallbacks {
+public:
+  virtual ~DecoderCallbacks() = default;
+
+  /**
+   * @return DecoderEventHandler& a new DecoderEventHandler for a message.
+   */
+  virtual DecoderEventHandler& newDecoderEventHandler() PURE;
+
+  /**
+   * @return bool true if the body of the current message may be passed through without being
+   *         decoded, after its message begin. Only used when the transport reports the frame size.
+   */
+  virtual bool passthroughEnabled() const PURE;
+};
+
 #define ALL_PROTOCOL_STATES(FUNCTION)                                                              \
   FUNCTION(StopIteration)                                                                          \
   FUNCTION(WaitForData)                                                                            \
   FUNCTION(MessageBegin)                                                                           \
   FUNCTION(MessageEnd)                                                                             \
+  FUNCTION(PassthroughData)                                                                        \
   FUNCTION(StructBegin)                                                                            \
   FUNCTION(StructEnd)                                                                              \
   FUNCTION(FieldBegin)                                                                             \
@@ -63,9 +81,9 @@ private:
 class DecoderStateMachine : public Logger::Loggable<Logger::Id::thrift> {
 public:
   DecoderStateMachine(Protocol& proto, MessageMetadataSharedPtr& metadata,
-                      DecoderEventHandler& handler)
-      : proto_(proto), metadata_(metadata), handler_(handler), state_(ProtocolState::MessageBegin) {
-  }
+                      DecoderEventHandler& handler, DecoderCallbacks& callbacks)
+      : proto_(proto), metadata_(metadata), handler_(handler), callbacks_(callbacks),
+        state_(ProtocolState::MessageBegin) {}
 
   /**
    * Consumes as much data from the configured Buffer as possible and executes the decoding state
@@ -131,6 +149,7 @@ private:
   // or ProtocolState::WaitForData if more data is required.
   DecoderStatus messageBegin(Buffer::Instance& buffer);
   DecoderStatus messageEnd(Buffer::Instance& buffer);
+  DecoderStatus passthroughData(Buffer::Instance& buffer);
   DecoderStatus structBegin(Buffer::Instance& buffer);
   DecoderStatus structEnd(Buffer::Instance& buffer);
   DecoderStatus fieldBegin(Buffer::Instance& buffer);
@@ -165,22 +184,16 @@ private:
   Protocol& proto_;
   MessageMetadataSharedPtr metadata_;
   DecoderEventHandler& handler_;
+  DecoderCallbacks& callbacks_;
   ProtocolState state_;
   std::vector<Frame> stack_;
+  // Size of the message body, after its message begin, when it is passed through.
+  uint32_t body_bytes_{0};
+  Buffer::OwnedImpl body_;
 };
 
 using DecoderStateMachinePtr = std::unique_ptr<DecoderStateMachine>;
 
-class DecoderCallbacks {
-public:
-  virtual ~DecoderCallbacks() = default;
-
-  /**
-   * @return DecoderEventHandler& a new DecoderEventHandler for a message.
-   */
-  virtual DecoderEventHandler& newDecoderEventHandler() PURE;
-};
-
 /**
  * Decoder encapsulates a configured Transport and Protocol and provides the ability to decode
  * Thrift messages.
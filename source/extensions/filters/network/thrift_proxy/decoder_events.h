@@ -1,5 +1,7 @@
 #pragma once
 
+#include "envoy/buffer/buffer.h"
+
 #include "extensions/filters/network/thrift_proxy/metadata.h"
 #include "extensions/filters/network/thrift_proxy/thrift.h"
 
@@ -48,6 +50,14 @@ public:
    */
   virtual FilterStatus messageEnd() PURE;
 
+  /**
+   * Indicates that the body of a Thrift protocol message was received without being decoded. When
+   * payload passthrough is enabled, it replaces the events between messageBegin and messageEnd.
+   * @param data the encoded body of the message, up to the end of the transport frame
+   * @return FilterStatus to indicate if filter chain iteration should continue
+   */
+  virtual FilterStatus passthroughData(Buffer::Instance& data) PURE;
+
   /**
    * Indicates that the start of a Thrift protocol struct was detected.
    * @param name the name of the struct, if available
@@ -77,6 +77,7 @@ public:
       ThriftProxy::ThriftFilters::DecoderFilterCallbacks& callbacks) override {
     callbacks_ = &callbacks;
   };
+  bool passthroughSupported() const override { return true; }
   ThriftProxy::FilterStatus
   transportBegin(NetworkFilters::ThriftProxy::MessageMetadataSharedPtr) override {
     return ThriftProxy::FilterStatus::Continue;
@@ -84,6 +85,9 @@ public:
   ThriftProxy::FilterStatus transportEnd() override { return ThriftProxy::FilterStatus::Continue; }
   ThriftProxy::FilterStatus messageBegin(ThriftProxy::MessageMetadataSharedPtr) override;
   ThriftProxy::FilterStatus messageEnd() override { return ThriftProxy::FilterStatus::Continue; }
+  ThriftProxy::FilterStatus passthroughData(Buffer::Instance&) override {
+    return ThriftProxy::FilterStatus::Continue;
+  }
   ThriftProxy::FilterStatus structBegin(absl::string_view) override {
     return ThriftProxy::FilterStatus::Continue;
   }
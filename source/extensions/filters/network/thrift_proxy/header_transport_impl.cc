@@ -5,6 +5,7 @@
 #include "envoy/common/exception.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/buffer/reader.h"
 
 #include "extensions/filters/network/thrift_proxy/buffer_helper.h"
 
@@ -285,7 +286,7 @@ std::string HeaderTransportImpl::drainVarString(Buffer::Instance& buffer, int32_
     throw EnvoyException(fmt::format("unable to read header transport {}: header too small", desc));
   }
 
-  std::string value(static_cast<char*>(buffer.linearize(str_len)), str_len);
+  std::string value = Buffer::Reader(buffer).readString(str_len);
   buffer.drain(str_len);
   header_size -= str_len;
   return value;
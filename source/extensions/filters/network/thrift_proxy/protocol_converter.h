@@ -35,6 +35,12 @@ public:
     return FilterStatus::Continue;
   }
 
+  FilterStatus passthroughData(Buffer::Instance& data) override {
+    // The body is only passed through when both ends use the same protocol.
+    buffer_->move(data);
+    return FilterStatus::Continue;
+  }
+
   FilterStatus structBegin(absl::string_view name) override {
     proto_->writeStructBegin(*buffer_, std::string(name));
     return FilterStatus::Continue;
@@ -13,11 +13,21 @@ namespace Router {
 ThriftFilters::FilterFactoryCb RouterFilterConfig::createFilterFactoryFromProtoTyped(
     const envoy::config::filter::thrift::router::v2alpha1::Router& proto_config,
     const std::string& stat_prefix, Server::Configuration::FactoryContext& context) {
-  UNREFERENCED_PARAMETER(proto_config);
   UNREFERENCED_PARAMETER(stat_prefix);
 
-  return [&context](ThriftFilters::FilterChainFactoryCallbacks& callbacks) -> void {
-    callbacks.addDecoderFilter(std::make_shared<Router>(context.clusterManager()));
+  if (!proto_config.multiplex_upstream_connections()) {
+    return [&context](ThriftFilters::FilterChainFactoryCallbacks& callbacks) -> void {
+      callbacks.addDecoderFilter(std::make_shared<Router>(context.clusterManager()));
+    };
+  }
+
+  std::shared_ptr<ThreadLocal::Slot> slot = context.threadLocal().allocateSlot();
+  slot->set([](Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<MultiplexedConnectionRegistry>(dispatcher);
+  });
+  return [&context, slot](ThriftFilters::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addDecoderFilter(std::make_shared<Router>(
+        context.clusterManager(), &slot->getTyped<MultiplexedConnectionRegistry>()));
   };
 }
 
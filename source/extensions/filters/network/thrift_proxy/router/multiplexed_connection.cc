@@ -0,0 +1,331 @@
+#include "extensions/filters/network/thrift_proxy/router/multiplexed_connection.h"
+
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+
+#include "extensions/filters/network/thrift_proxy/framed_transport_impl.h"
+#include "extensions/filters/network/thrift_proxy/header_transport_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace ThriftProxy {
+namespace Router {
+namespace {
+
+// Size of the frame size field shared by the framed and header transports.
+constexpr uint64_t FrameSizeLength = 4;
+
+// The sequence id of a response is read from a copy of the start of its frame, which holds the
+// transport headers and the message begin in all but unusual cases.
+constexpr uint64_t SequenceIdPeekSize = 512;
+
+} // namespace
+
+MultiplexedRequest::MultiplexedRequest(MultiplexedConnection& parent, int32_t sequence_id)
+    : parent_(&parent), sequence_id_(sequence_id) {}
+
+MultiplexedRequest::~MultiplexedRequest() {
+  if (parent_ != nullptr) {
+    parent_->onRequestDestroyed(*this);
+  }
+}
+
+void MultiplexedRequest::write(Buffer::Instance& data, bool two_way) {
+  if (parent_ == nullptr) {
+    // The connection was closed, and the callbacks were notified.
+    data.drain(data.length());
+    return;
+  }
+
+  awaiting_response_ = two_way;
+  parent_->onRequestWritten(data);
+}
+
+MultiplexedConnection::MultiplexedConnection(MultiplexedConnectionRegistry& parent,
+                                             Tcp::ConnectionPool::Instance& pool,
+                                             TransportType transport_type,
+                                             ProtocolType protocol_type)
+    : parent_(parent), pool_(pool), transport_type_(transport_type),
+      protocol_type_(protocol_type),
+      transport_(NamedTransportConfigFactory::getFactory(transport_type).createTransport()),
+      protocol_(NamedProtocolConfigFactory::getFactory(protocol_type).createProtocol()) {
+  ASSERT(MultiplexedConnectionRegistry::supported(transport_type, protocol_type));
+}
+
+MultiplexedConnection::~MultiplexedConnection() {
+  if (pool_handle_ != nullptr) {
+    pool_handle_->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+  }
+  detachRequests();
+}
+
+Tcp::ConnectionPool::Cancellable*
+MultiplexedConnection::newRequest(MultiplexedRequestCallbacks& callbacks) {
+  if (conn_data_ != nullptr) {
+    callbacks.onPoolReady(createRequest(), host_);
+    return nullptr;
+  }
+
+  PendingRequestPtr pending_request = std::make_unique<PendingRequest>(*this, callbacks);
+  PendingRequest* handle = pending_request.get();
+  pending_request->moveIntoList(std::move(pending_request), pending_requests_);
+
+  if (pool_handle_ == nullptr) {
+    ENVOY_LOG(debug, "thrift multiplexed connection: connecting");
+    // The pool may invoke the callbacks, and so complete the pending request, before returning.
+    pool_handle_ = pool_.newConnection(*this);
+  }
+
+  for (const PendingRequestPtr& pending : pending_requests_) {
+    if (pending.get() == handle) {
+      return handle;
+    }
+  }
+  return nullptr;
+}
+
+void MultiplexedConnection::onPoolFailure(Tcp::ConnectionPool::PoolFailureReason reason,
+                                          Upstream::HostDescriptionConstSharedPtr host) {
+  ENVOY_LOG(debug, "thrift multiplexed connection: connection failure");
+  pool_handle_ = nullptr;
+
+  std::list<PendingRequestPtr> pending_requests;
+  pending_requests.swap(pending_requests_);
+  parent_.remove(*this);
+
+  for (const PendingRequestPtr& pending_request : pending_requests) {
+    pending_request->callbacks_.onPoolFailure(reason, host);
+  }
+}
+
+void MultiplexedConnection::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
+                                        Upstream::HostDescriptionConstSharedPtr host) {
+  ENVOY_LOG(debug, "thrift multiplexed connection: connected to {}", host->address()->asString());
+  pool_handle_ = nullptr;
+  conn_data_ = std::move(conn_data);
+  conn_data_->addUpstreamCallbacks(*this);
+  host_ = host;
+
+  // Sequence ids continue from those of the previous users of the connection.
+  conn_state_ = conn_data_->connectionStateTyped<ThriftConnectionState>();
+  if (conn_state_ == nullptr) {
+    conn_data_->setConnectionState(std::make_unique<ThriftConnectionState>());
+    conn_state_ = conn_data_->connectionStateTyped<ThriftConnectionState>();
+  }
+
+  while (!pending_requests_.empty() && conn_data_ != nullptr) {
+    PendingRequestPtr pending_request =
+        pending_requests_.front()->removeFromList(pending_requests_);
+    pending_request->callbacks_.onPoolReady(createRequest(), host_);
+  }
+
+  releaseIfIdle();
+}
+
+void MultiplexedConnection::onUpstreamData(Buffer::Instance& data, bool) {
+  response_buffer_.move(data);
+
+  // The connection is released once the last response is received, and may be closed on errors.
+  while (conn_data_ != nullptr && response_buffer_.length() >= FrameSizeLength) {
+    const int32_t frame_size = response_buffer_.peekBEInt<int32_t>();
+    const bool valid_frame_size = transport_type_ == TransportType::Framed
+                                      ? frame_size <= FramedTransportImpl::MaxFrameSize
+                                      : frame_size <= HeaderTransportImpl::MaxFrameSize;
+    if (frame_size <= 0 || !valid_frame_size) {
+      ENVOY_LOG(debug, "thrift multiplexed connection: invalid frame size {}, closing", frame_size);
+      conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
+      return;
+    }
+
+    const uint64_t length = FrameSizeLength + frame_size;
+    if (response_buffer_.length() < length) {
+      return;
+    }
+
+    Buffer::OwnedImpl frame;
+    frame.move(response_buffer_, length);
+
+    int32_t sequence_id;
+    if (!sequenceId(frame, sequence_id)) {
+      ENVOY_LOG(debug, "thrift multiplexed connection: invalid response, closing");
+      conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
+      return;
+    }
+
+    onResponse(frame, sequence_id);
+  }
+}
+
+void MultiplexedConnection::onEvent(Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::Connected) {
+    // Connected is consumed by the connection pool.
+    return;
+  }
+
+  ENVOY_LOG(debug, "thrift multiplexed connection: closed with {} requests", requests_.size());
+  conn_state_ = nullptr;
+  conn_data_.reset();
+
+  // Detach the requests before notifying them, so that they can be destroyed meanwhile.
+  std::vector<Tcp::ConnectionPool::UpstreamCallbacks*> callbacks;
+  for (const auto& request : requests_) {
+    if (request.second != nullptr && request.second->callbacks_ != nullptr) {
+      callbacks.push_back(request.second->callbacks_);
+    }
+  }
+  detachRequests();
+  parent_.remove(*this);
+
+  for (Tcp::ConnectionPool::UpstreamCallbacks* cb : callbacks) {
+    cb->onEvent(event);
+  }
+}
+
+MultiplexedRequestPtr MultiplexedConnection::createRequest() {
+  const int32_t sequence_id = conn_state_->nextSequenceId();
+  MultiplexedRequestPtr request = std::make_unique<MultiplexedRequest>(*this, sequence_id);
+  requests_[sequence_id] = request.get();
+  return request;
+}
+
+void MultiplexedConnection::onRequestWritten(Buffer::Instance& data) {
+  ASSERT(conn_data_ != nullptr);
+  conn_data_->connection().write(data, false);
+}
+
+void MultiplexedConnection::onRequestDestroyed(MultiplexedRequest& request) {
+  auto it = requests_.find(request.sequence_id_);
+  ASSERT(it != requests_.end() && it->second == &request);
+
+  if (request.awaiting_response_) {
+    // Keep the connection until the abandoned response is received, so that it cannot be mistaken
+    // for the response of another request once the connection is reused.
+    it->second = nullptr;
+  } else {
+    requests_.erase(it);
+  }
+
+  releaseIfIdle();
+}
+
+bool MultiplexedConnection::sequenceId(Buffer::Instance& frame, int32_t& sequence_id) {
+  const auto peek = [this, &sequence_id](Buffer::Instance& data) -> bool {
+    MessageMetadata metadata;
+    if (!transport_->decodeFrameStart(data, metadata) ||
+        !protocol_->readMessageBegin(data, metadata) || !metadata.hasSequenceId()) {
+      return false;
+    }
+
+    sequence_id = metadata.sequenceId();
+    return true;
+  };
+
+  try {
+    uint8_t prefix_data[SequenceIdPeekSize];
+    const uint64_t prefix_size = std::min(frame.length(), SequenceIdPeekSize);
+    frame.copyOut(0, prefix_size, prefix_data);
+    Buffer::OwnedImpl prefix(prefix_data, prefix_size);
+    if (peek(prefix)) {
+      return true;
+    }
+
+    if (prefix_size < frame.length()) {
+      Buffer::OwnedImpl copy;
+      copy.add(frame);
+      return peek(copy);
+    }
+  } catch (const EnvoyException& ex) {
+    ENVOY_LOG(debug, "thrift multiplexed connection: {}", ex.what());
+  }
+
+  return false;
+}
+
+void MultiplexedConnection::onResponse(Buffer::Instance& frame, int32_t sequence_id) {
+  auto it = requests_.find(sequence_id);
+  if (it == requests_.end()) {
+    ENVOY_LOG(debug, "thrift multiplexed connection: unexpected response {}", sequence_id);
+    return;
+  }
+
+  MultiplexedRequest* request = it->second;
+  if (request == nullptr) {
+    ENVOY_LOG(debug, "thrift multiplexed connection: dropping abandoned response {}",
+              sequence_id);
+    requests_.erase(it);
+    releaseIfIdle();
+    return;
+  }
+
+  request->awaiting_response_ = false;
+  ASSERT(request->callbacks_ != nullptr);
+  request->callbacks_->onUpstreamData(frame, false);
+}
+
+void MultiplexedConnection::releaseIfIdle() {
+  if (!requests_.empty() || !pending_requests_.empty()) {
+    return;
+  }
+
+  ENVOY_LOG(debug, "thrift multiplexed connection: releasing idle connection");
+  if (pool_handle_ != nullptr) {
+    pool_handle_->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+    pool_handle_ = nullptr;
+  }
+  conn_state_ = nullptr;
+  conn_data_.reset();
+  response_buffer_.drain(response_buffer_.length());
+  parent_.remove(*this);
+}
+
+void MultiplexedConnection::detachRequests() {
+  for (const auto& request : requests_) {
+    if (request.second != nullptr) {
+      request.second->parent_ = nullptr;
+    }
+  }
+  requests_.clear();
+}
+
+void MultiplexedConnection::PendingRequest::cancel(Tcp::ConnectionPool::CancelPolicy) {
+  PendingRequestPtr removed = removeFromList(parent_.pending_requests_);
+  parent_.releaseIfIdle();
+}
+
+MultiplexedConnection&
+MultiplexedConnectionRegistry::connection(Tcp::ConnectionPool::Instance& pool,
+                                          TransportType transport_type,
+                                          ProtocolType protocol_type) {
+  MultiplexedConnectionPtr& connection = connections_[Key{&pool, transport_type, protocol_type}];
+  if (connection == nullptr) {
+    connection =
+        std::make_unique<MultiplexedConnection>(*this, pool, transport_type, protocol_type);
+  }
+  return *connection;
+}
+
+void MultiplexedConnectionRegistry::remove(MultiplexedConnection& connection) {
+  // The connection may have been removed already, and replaced by a new one.
+  auto it = connections_.find(
+      Key{&connection.pool_, connection.transport_type_, connection.protocol_type_});
+  if (it != connections_.end() && it->second.get() == &connection) {
+    dispatcher_.deferredDelete(std::move(it->second));
+    connections_.erase(it);
+  }
+}
+
+bool MultiplexedConnectionRegistry::supported(TransportType transport_type,
+                                              ProtocolType protocol_type) {
+  // Responses are split on their frame size. The twitter protocol upgrades each connection with a
+  // request of its own, whose response has no sequence id to match.
+  return (transport_type == TransportType::Framed || transport_type == TransportType::Header) &&
+         protocol_type != ProtocolType::Twitter && protocol_type != ProtocolType::Auto;
+}
+
+} // namespace Router
+} // namespace ThriftProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
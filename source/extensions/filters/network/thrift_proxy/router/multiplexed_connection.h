@@ -0,0 +1,211 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <tuple>
+
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/tcp/conn_pool.h"
+#include "envoy/thread_local/thread_local.h"
+#include "envoy/upstream/upstream.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/linked_object.h"
+#include "common/common/logger.h"
+
+#include "extensions/filters/network/thrift_proxy/conn_state.h"
+#include "extensions/filters/network/thrift_proxy/protocol.h"
+#include "extensions/filters/network/thrift_proxy/transport.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace ThriftProxy {
+namespace Router {
+
+class MultiplexedConnection;
+class MultiplexedConnectionRegistry;
+
+/**
+ * A request sent on a MultiplexedConnection, the counterpart of a Tcp::ConnectionPool
+ * ConnectionData. Destroying it before the response is received abandons the response, which is
+ * dropped when it arrives.
+ */
+class MultiplexedRequest {
+public:
+  MultiplexedRequest(MultiplexedConnection& parent, int32_t sequence_id);
+  ~MultiplexedRequest();
+
+  /**
+   * @return int32_t the sequence id the request must be encoded with, unique on the connection.
+   */
+  int32_t sequenceId() const { return sequence_id_; }
+
+  /**
+   * Sets the callbacks receiving the response and the events of the shared connection. The
+   * response is passed as a single, complete frame.
+   */
+  void addUpstreamCallbacks(Tcp::ConnectionPool::UpstreamCallbacks& callbacks) {
+    callbacks_ = &callbacks;
+  }
+
+  /**
+   * Writes an encoded request frame upstream.
+   * @param data supplies the frame, which is drained.
+   * @param two_way true if a response is expected.
+   */
+  void write(Buffer::Instance& data, bool two_way);
+
+private:
+  friend class MultiplexedConnection;
+
+  // Reset once the connection is closed.
+  MultiplexedConnection* parent_;
+  Tcp::ConnectionPool::UpstreamCallbacks* callbacks_{};
+  const int32_t sequence_id_;
+  bool awaiting_response_{};
+};
+
+using MultiplexedRequestPtr = std::unique_ptr<MultiplexedRequest>;
+
+/**
+ * Callbacks invoked in the context of MultiplexedConnection::newRequest(), either synchronously
+ * or asynchronously, like Tcp::ConnectionPool::Callbacks.
+ */
+class MultiplexedRequestCallbacks {
+public:
+  virtual ~MultiplexedRequestCallbacks() = default;
+
+  /**
+   * Called when the shared connection could not be established.
+   */
+  virtual void onPoolFailure(Tcp::ConnectionPool::PoolFailureReason reason,
+                             Upstream::HostDescriptionConstSharedPtr host) PURE;
+
+  /**
+   * Called when the request can be written.
+   */
+  virtual void onPoolReady(MultiplexedRequestPtr&& request,
+                           Upstream::HostDescriptionConstSharedPtr host) PURE;
+};
+
+/**
+ * An upstream connection taken from a Tcp::ConnectionPool and shared by all the requests of a
+ * worker to its host. Responses are matched to requests by sequence id, so any number of requests
+ * can be in flight on it. It is released back to the pool once it has no request left.
+ * Responses are split on their frame size, so only the framed and header transports are
+ * supported.
+ */
+class MultiplexedConnection : public Tcp::ConnectionPool::Callbacks,
+                              public Tcp::ConnectionPool::UpstreamCallbacks,
+                              public Event::DeferredDeletable,
+                              Logger::Loggable<Logger::Id::thrift> {
+public:
+  MultiplexedConnection(MultiplexedConnectionRegistry& parent, Tcp::ConnectionPool::Instance& pool,
+                        TransportType transport_type, ProtocolType protocol_type);
+  ~MultiplexedConnection() override;
+
+  /**
+   * Creates a request on the connection, connecting it first if needed.
+   * @return a handle to cancel the request while the connection is being established, nullptr if
+   *         the callbacks were already invoked.
+   */
+  Tcp::ConnectionPool::Cancellable* newRequest(MultiplexedRequestCallbacks& callbacks);
+
+  // Tcp::ConnectionPool::Callbacks
+  void onPoolFailure(Tcp::ConnectionPool::PoolFailureReason reason,
+                     Upstream::HostDescriptionConstSharedPtr host) override;
+  void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
+                   Upstream::HostDescriptionConstSharedPtr host) override;
+
+  // Tcp::ConnectionPool::UpstreamCallbacks
+  void onUpstreamData(Buffer::Instance& data, bool end_stream) override;
+  void onEvent(Network::ConnectionEvent event) override;
+  void onAboveWriteBufferHighWatermark() override {}
+  void onBelowWriteBufferLowWatermark() override {}
+
+private:
+  friend class MultiplexedRequest;
+  friend class MultiplexedConnectionRegistry;
+
+  struct PendingRequest : public Tcp::ConnectionPool::Cancellable,
+                          LinkedObject<PendingRequest> {
+    PendingRequest(MultiplexedConnection& parent, MultiplexedRequestCallbacks& callbacks)
+        : parent_(parent), callbacks_(callbacks) {}
+
+    // Tcp::ConnectionPool::Cancellable
+    void cancel(Tcp::ConnectionPool::CancelPolicy cancel_policy) override;
+
+    MultiplexedConnection& parent_;
+    MultiplexedRequestCallbacks& callbacks_;
+  };
+
+  using PendingRequestPtr = std::unique_ptr<PendingRequest>;
+
+  MultiplexedRequestPtr createRequest();
+  void onRequestWritten(Buffer::Instance& data);
+  void onRequestDestroyed(MultiplexedRequest& request);
+  bool sequenceId(Buffer::Instance& frame, int32_t& sequence_id);
+  void onResponse(Buffer::Instance& frame, int32_t sequence_id);
+  void releaseIfIdle();
+  void detachRequests();
+
+  MultiplexedConnectionRegistry& parent_;
+  Tcp::ConnectionPool::Instance& pool_;
+  const TransportType transport_type_;
+  const ProtocolType protocol_type_;
+  TransportPtr transport_;
+  ProtocolPtr protocol_;
+  Tcp::ConnectionPool::Cancellable* pool_handle_{};
+  Tcp::ConnectionPool::ConnectionDataPtr conn_data_;
+  ThriftConnectionState* conn_state_{};
+  Upstream::HostDescriptionConstSharedPtr host_;
+  std::list<PendingRequestPtr> pending_requests_;
+  // Requests by sequence id. Requests destroyed while their response is outstanding are kept as
+  // nullptr until the response arrives, so that the connection is not released meanwhile.
+  absl::flat_hash_map<int32_t, MultiplexedRequest*> requests_;
+  Buffer::OwnedImpl response_buffer_;
+};
+
+using MultiplexedConnectionPtr = std::unique_ptr<MultiplexedConnection>;
+
+/**
+ * The multiplexed connections of a worker, one per connection pool, transport and protocol.
+ */
+class MultiplexedConnectionRegistry : public ThreadLocal::ThreadLocalObject {
+public:
+  MultiplexedConnectionRegistry(Event::Dispatcher& dispatcher) : dispatcher_(dispatcher) {}
+
+  /**
+   * @return MultiplexedConnection& the connection shared by the requests using a pool, transport
+   *         and protocol.
+   */
+  MultiplexedConnection& connection(Tcp::ConnectionPool::Instance& pool,
+                                    TransportType transport_type, ProtocolType protocol_type);
+
+  /**
+   * Forgets a connection once it is released or closed, and deletes it once the current call stack
+   * unwinds.
+   */
+  void remove(MultiplexedConnection& connection);
+
+  /**
+   * @return true if requests using a transport and protocol can share connections.
+   */
+  static bool supported(TransportType transport_type, ProtocolType protocol_type);
+
+private:
+  using Key = std::tuple<Tcp::ConnectionPool::Instance*, TransportType, ProtocolType>;
+
+  Event::Dispatcher& dispatcher_;
+  absl::flat_hash_map<Key, MultiplexedConnectionPtr> connections_;
+};
+
+} // namespace Router
+} // namespace ThriftProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -243,10 +243,15 @@ FilterStatus Router::messageBegin(MessageMetadataSharedPtr metadata) {
                                       : callbacks_->downstreamTransportType();
   ASSERT(transport != TransportType::Auto);
 
-  const ProtocolType protocol = options ? options->protocol(callbacks_->downstreamProtocolType())
-                                        : callbacks_->downstreamProtocolType();
+  const ProtocolType downstream_protocol = callbacks_->downstreamProtocolType();
+  const ProtocolType protocol =
+      options ? options->protocol(downstream_protocol) : downstream_protocol;
   ASSERT(protocol != ProtocolType::Auto);
 
+  // The request body can only be copied as is if the upstream speaks the downstream protocol. The
+  // twitter protocol is excluded because the upstream connection may not be upgraded the same way.
+  passthrough_supported_ = protocol == downstream_protocol && protocol != ProtocolType::Twitter;
+
   Tcp::ConnectionPool::Instance* conn_pool = cluster_manager_.tcpConnPoolForCluster(
       route_entry_->clusterName(), Upstream::ResourcePriority::Default, this, nullptr);
   if (!conn_pool) {
@@ -273,7 +278,12 @@ FilterStatus Router::messageEnd() {
 
   upstream_request_->transport_->encodeFrame(transport_buffer, *upstream_request_->metadata_,
                                              upstream_request_buffer_);
-  upstream_request_->conn_data_->connection().write(transport_buffer, false);
+  if (upstream_request_->multiplexed_request_ != nullptr) {
+    upstream_request_->multiplexed_request_->write(
+        transport_buffer, upstream_request_->metadata_->messageType() != MessageType::Oneway);
+  } else {
+    upstream_request_->conn_data_->connection().write(transport_buffer, false);
+  }
   upstream_request_->onRequestComplete();
   return FilterStatus::Continue;
 }
@@ -371,7 +381,14 @@ Router::UpstreamRequest::UpstreamRequest(Router& parent, Tcp::ConnectionPool::In
 Router::UpstreamRequest::~UpstreamRequest() = default;
 
 FilterStatus Router::UpstreamRequest::start() {
-  Tcp::ConnectionPool::Cancellable* handle = conn_pool_.newConnection(*this);
+  const TransportType transport_type = transport_->type();
+  const ProtocolType protocol_type = protocol_->type();
+  Tcp::ConnectionPool::Cancellable* handle =
+      parent_.multiplexed_connections_ != nullptr &&
+              MultiplexedConnectionRegistry::supported(transport_type, protocol_type)
+          ? parent_.multiplexed_connections_->connection(conn_pool_, transport_type, protocol_type)
+                .newRequest(*this)
+          : conn_pool_.newConnection(*this);
   if (handle) {
     // Pause while we wait for a connection.
     conn_pool_handle_ = handle;
@@ -396,6 +413,9 @@ void Router::UpstreamRequest::resetStream() {
     conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
     conn_data_.reset();
   }
+
+  // Other requests share the connection, the response is dropped when it arrives.
+  multiplexed_request_.reset();
 }
 
 void Router::UpstreamRequest::onPoolFailure(Tcp::ConnectionPool::PoolFailureReason reason,
@@ -435,10 +455,24 @@ void Router::UpstreamRequest::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr
   onRequestStart(continue_decoding);
 }
 
+void Router::UpstreamRequest::onPoolReady(MultiplexedRequestPtr&& request,
+                                          Upstream::HostDescriptionConstSharedPtr host) {
+  // Only invoke continueDecoding if we'd previously stopped the filter chain.
+  bool continue_decoding = conn_pool_handle_ != nullptr;
+
+  onUpstreamHostSelected(host);
+  multiplexed_request_ = std::move(request);
+  multiplexed_request_->addUpstreamCallbacks(parent_);
+  conn_pool_handle_ = nullptr;
+
+  onRequestStart(continue_decoding);
+}
+
 void Router::UpstreamRequest::onRequestStart(bool continue_decoding) {
   parent_.initProtocolConverter(*protocol_, parent_.upstream_request_buffer_);
 
-  metadata_->setSequenceId(conn_state_->nextSequenceId());
+  metadata_->setSequenceId(multiplexed_request_ != nullptr ? multiplexed_request_->sequenceId()
+                                                           : conn_state_->nextSequenceId());
   parent_.convertMessageBegin(metadata_);
 
   if (continue_decoding) {
@@ -452,6 +486,7 @@ void Router::UpstreamRequest::onResponseComplete() {
   response_complete_ = true;
   conn_state_ = nullptr;
   conn_data_.reset();
+  multiplexed_request_.reset();
 }
 
 void Router::UpstreamRequest::onUpstreamHostSelected(Upstream::HostDescriptionConstSharedPtr host) {
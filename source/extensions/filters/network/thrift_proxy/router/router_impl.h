@@ -15,6 +15,7 @@
 
 #include "extensions/filters/network/thrift_proxy/conn_manager.h"
 #include "extensions/filters/network/thrift_proxy/filters/filter.h"
+#include "extensions/filters/network/thrift_proxy/router/multiplexed_connection.h"
 #include "extensions/filters/network/thrift_proxy/router/router.h"
 #include "extensions/filters/network/thrift_proxy/router/router_ratelimit_impl.h"
 #include "extensions/filters/network/thrift_proxy/thrift_object.h"
@@ -140,13 +141,20 @@ class Router : public Tcp::ConnectionPool::UpstreamCallbacks,
                public ThriftFilters::DecoderFilter,
                Logger::Loggable<Logger::Id::thrift> {
 public:
-  Router(Upstream::ClusterManager& cluster_manager) : cluster_manager_(cluster_manager) {}
+  /**
+   * @param multiplexed_connections supplies the connections shared by the requests of the worker,
+   *        nullptr if each request has an upstream connection of its own.
+   */
+  Router(Upstream::ClusterManager& cluster_manager,
+         MultiplexedConnectionRegistry* multiplexed_connections = nullptr)
+      : cluster_manager_(cluster_manager), multiplexed_connections_(multiplexed_connections) {}
 
   ~Router() override = default;
 
   // ThriftFilters::DecoderFilter
   void onDestroy() override;
   void setDecoderFilterCallbacks(ThriftFilters::DecoderFilterCallbacks& callbacks) override;
+  bool passthroughSupported() const override { return passthrough_supported_; }
 
   // ProtocolConverter
   FilterStatus transportBegin(MessageMetadataSharedPtr metadata) override;
@@ -170,7 +178,8 @@ public:
   void onBelowWriteBufferLowWatermark() override {}
 
 private:
-  struct UpstreamRequest : public Tcp::ConnectionPool::Callbacks {
+  struct UpstreamRequest : public Tcp::ConnectionPool::Callbacks,
+                           public MultiplexedRequestCallbacks {
     UpstreamRequest(Router& parent, Tcp::ConnectionPool::Instance& pool,
                     MessageMetadataSharedPtr& metadata, TransportType transport_type,
                     ProtocolType protocol_type);
@@ -179,12 +188,16 @@ private:
     FilterStatus start();
     void resetStream();
 
-    // Tcp::ConnectionPool::Callbacks
+    // Tcp::ConnectionPool::Callbacks and MultiplexedRequestCallbacks
     void onPoolFailure(Tcp::ConnectionPool::PoolFailureReason reason,
                        Upstream::HostDescriptionConstSharedPtr host) override;
     void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn,
                      Upstream::HostDescriptionConstSharedPtr host) override;
 
+    // MultiplexedRequestCallbacks
+    void onPoolReady(MultiplexedRequestPtr&& request,
+                     Upstream::HostDescriptionConstSharedPtr host) override;
+
     void onRequestStart(bool continue_decoding);
     void onRequestComplete();
     void onResponseComplete();
@@ -197,6 +210,7 @@ private:
 
     Tcp::ConnectionPool::Cancellable* conn_pool_handle_{};
     Tcp::ConnectionPool::ConnectionDataPtr conn_data_;
+    MultiplexedRequestPtr multiplexed_request_;
     Upstream::HostDescriptionConstSharedPtr upstream_host_;
     ThriftConnectionState* conn_state_{};
     TransportPtr transport_;
@@ -212,6 +226,7 @@ private:
   void cleanup();
 
   Upstream::ClusterManager& cluster_manager_;
+  MultiplexedConnectionRegistry* const multiplexed_connections_;
 
   ThriftFilters::DecoderFilterCallbacks* callbacks_{};
   RouteConstSharedPtr route_{};
@@ -220,6 +235,7 @@ private:
 
   std::unique_ptr<UpstreamRequest> upstream_request_;
   Buffer::OwnedImpl upstream_request_buffer_;
+  bool passthrough_supported_{false};
 };
 
 } // namespace Router
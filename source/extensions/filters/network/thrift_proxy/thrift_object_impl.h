@@ -25,6 +25,7 @@ public:
   FilterStatus transportEnd() override { return FilterStatus::Continue; }
   FilterStatus messageBegin(MessageMetadataSharedPtr) override { return FilterStatus::Continue; }
   FilterStatus messageEnd() override { return FilterStatus::Continue; }
+  FilterStatus passthroughData(Buffer::Instance&) override { return FilterStatus::Continue; }
   FilterStatus structBegin(absl::string_view name) override;
   FilterStatus structEnd() override;
   FilterStatus fieldBegin(absl::string_view name, FieldType& field_type,
@@ -242,6 +243,8 @@ public:
 
   // DecoderCallbacks
   DecoderEventHandler& newDecoderEventHandler() override { return *this; }
+  bool passthroughEnabled() const override { return false; }
+
   FilterStatus transportEnd() override {
     complete_ = true;
     return FilterStatus::Continue;
@@ -3,6 +3,7 @@
 #include "envoy/common/exception.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/buffer/reader.h"
 
 #include "extensions/filters/network/thrift_proxy/buffer_helper.h"
 #include "extensions/filters/network/thrift_proxy/thrift_object_impl.h"
@@ -1144,8 +1145,7 @@ bool TwitterProtocolImpl::isUpgradePrefix(Buffer::Instance& buffer) {
   ASSERT(buffer.length() >= available_len + 8);
 
   // Extract as much of the name as is available.
-  absl::string_view available_name(
-      static_cast<const char*>(buffer.linearize(available_len + 8)) + 8, available_len);
+  const std::string available_name = Buffer::Reader(buffer, 8).readString(available_len);
 
   absl::string_view full_name(upgradeMethodName());
 
@@ -42,6 +42,54 @@ const char* createFlagsToString(CreateFlags flags) {
   return "unknown";
 }
 
+constexpr uint32_t InflightRequests::Capacity;
+
+bool InflightRequests::insert(const int32_t xid, const OpCodes opcode,
+                              const MonotonicTime start_time) {
+  uint32_t index = slotIndex(xid);
+  for (uint32_t probes = 0; probes < Capacity; probes++, index = nextIndex(index)) {
+    Slot& slot = slots_[index];
+    if (!slot.used) {
+      slot = {{opcode, start_time}, xid, true};
+      size_++;
+      return true;
+    }
+    if (slot.xid == xid) {
+      slot.request = {opcode, start_time};
+      return true;
+    }
+  }
+  return false;
+}
+
+absl::optional<InflightRequests::Request> InflightRequests::remove(const int32_t xid) {
+  uint32_t hole = slotIndex(xid);
+  for (uint32_t probes = 0;; probes++, hole = nextIndex(hole)) {
+    if (probes == Capacity || !slots_[hole].used) {
+      return absl::nullopt;
+    }
+    if (slots_[hole].xid == xid) {
+      break;
+    }
+  }
+
+  const Request request = slots_[hole].request;
+  slots_[hole].used = false;
+  size_--;
+
+  // Shift back the requests following the hole in their probe sequence, so that lookups need no
+  // tombstones: a request moves to the hole if the hole lies between its home slot and its slot.
+  for (uint32_t index = nextIndex(hole); slots_[index].used; index = nextIndex(index)) {
+    const uint32_t home = slotIndex(slots_[index].xid);
+    if (((index - home) & (Capacity - 1)) >= ((index - hole) & (Capacity - 1))) {
+      slots_[hole] = slots_[index];
+      slots_[index].used = false;
+      hole = index;
+    }
+  }
+  return request;
+}
+
 void DecoderImpl::decodeOnData(Buffer::Instance& data, uint64_t& offset) {
   ENVOY_LOG(trace, "zookeeper_proxy: decoding request with {} bytes at offset {}", data.length(),
             offset);
@@ -51,7 +99,7 @@ void DecoderImpl::decodeOnData(Buffer::Instance& data, uint64_t& offset) {
   ensureMinLength(len, INT_LENGTH + XID_LENGTH);
   ensureMaxLength(len);
 
-  auto start_time = time_source_.monotonicTime();
+  const auto start_time = time_source_.monotonicTime();
 
   // Control requests, with XIDs <= 0.
   //
@@ -67,21 +115,21 @@ void DecoderImpl::decodeOnData(Buffer::Instance& data, uint64_t& offset) {
   switch (static_cast<XidCodes>(xid)) {
   case XidCodes::CONNECT_XID:
     parseConnect(data, offset, len);
-    requests_by_xid_[xid] = {OpCodes::CONNECT, std::move(start_time)};
+    trackRequest(xid, OpCodes::CONNECT, start_time);
     return;
   case XidCodes::PING_XID:
     offset += OPCODE_LENGTH;
     callbacks_.onPing();
-    requests_by_xid_[xid] = {OpCodes::PING, std::move(start_time)};
+    trackRequest(xid, OpCodes::PING, start_time);
     return;
   case XidCodes::AUTH_XID:
     parseAuthRequest(data, offset, len);
-    requests_by_xid_[xid] = {OpCodes::SETAUTH, std::move(start_time)};
+    trackRequest(xid, OpCodes::SETAUTH, start_time);
     return;
   case XidCodes::SET_WATCHES_XID:
     offset += OPCODE_LENGTH;
     parseSetWatchesRequest(data, offset, len);
-    requests_by_xid_[xid] = {OpCodes::SETWATCHES, std::move(start_time)};
+    trackRequest(xid, OpCodes::SETWATCHES, start_time);
     return;
   default:
     // WATCH_XID is generated by the server, so that and everything
@@ -161,7 +209,7 @@ void DecoderImpl::decodeOnData(Buffer::Instance& data, uint64_t& offset) {
     throw EnvoyException(fmt::format("Unknown opcode: {}", enumToSignedInt(opcode)));
   }
 
-  requests_by_xid_[xid] = {opcode, std::move(start_time)};
+  trackRequest(xid, opcode, start_time);
 }
 
 void DecoderImpl::decodeOnWrite(Buffer::Instance& data, uint64_t& offset) {
@@ -176,19 +224,23 @@ void DecoderImpl::decodeOnWrite(Buffer::Instance& data, uint64_t& offset) {
   const auto xid = helper_.peekInt32(data, offset);
   const auto xid_code = static_cast<XidCodes>(xid);
 
-  // Find the corresponding request for this XID.
-  const auto it = requests_by_xid_.find(xid);
-
-  std::chrono::milliseconds latency;
-  OpCodes opcode;
+  std::chrono::milliseconds latency{};
+  OpCodes opcode{};
 
   if (xid_code != XidCodes::WATCH_XID) {
-    // If this fails, it's a server-side bug.
-    ASSERT(it != requests_by_xid_.end());
+    // Find the corresponding request for this XID.
+    const absl::optional<InflightRequests::Request> request = inflight_requests_.remove(xid);
+    if (!request.has_value()) {
+      // The request was not tracked, as too many were in flight, and the response can't be told
+      // apart from its opcode. Skip it.
+      ENVOY_LOG(debug, "zookeeper_proxy: response for untracked xid {}", xid);
+      callbacks_.onUntrackedResponse(xid);
+      offset += (len - XID_LENGTH);
+      return;
+    }
     latency = std::chrono::duration_cast<std::chrono::milliseconds>(time_source_.monotonicTime() -
-                                                                    it->second.start_time);
-    opcode = it->second.opcode;
-    requests_by_xid_.erase(it);
+                                                                    request->start_time);
+    opcode = request->opcode;
   }
 
   // Connect responses are special, they have no full reply header
@@ -518,6 +570,13 @@ void DecoderImpl::parseWatchEvent(Buffer::Instance& data, uint64_t& offset, cons
   callbacks_.onWatchEvent(event_type, client_state, path, zxid, error);
 }
 
+void DecoderImpl::trackRequest(const int32_t xid, const OpCodes opcode,
+                               const MonotonicTime start_time) {
+  if (!inflight_requests_.insert(xid, opcode, start_time)) {
+    ENVOY_LOG(debug, "zookeeper_proxy: too many requests in flight to track xid {}", xid);
+  }
+}
+
 bool DecoderImpl::maybeReadBool(Buffer::Instance& data, uint64_t& offset) {
   if (data.length() >= offset + 1) {
     return helper_.peekBool(data, offset);
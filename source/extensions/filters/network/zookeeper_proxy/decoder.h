@@ -1,15 +1,19 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <string>
 
 #include "envoy/common/platform.h"
+#include "envoy/common/time.h"
 
 #include "common/buffer/buffer_impl.h"
 #include "common/common/logger.h"
 
 #include "extensions/filters/network/zookeeper_proxy/utils.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -100,6 +104,7 @@ public:
                                  const std::chrono::milliseconds& latency) PURE;
   virtual void onResponse(OpCodes opcode, int32_t xid, int64_t zxid, int32_t error,
                           const std::chrono::milliseconds& latency) PURE;
+  virtual void onUntrackedResponse(int32_t xid) PURE;
   virtual void onWatchEvent(int32_t event_type, int32_t client_state, const std::string& path,
                             int64_t zxid, int32_t error) PURE;
 };
@@ -117,6 +122,52 @@ public:
 
 using DecoderPtr = std::unique_ptr<Decoder>;
 
+/**
+ * The requests in flight on a connection, keyed by xid, which their responses are correlated with.
+ * It is an open addressing hash table of fixed capacity, so that tracking a request allocates
+ * nothing.
+ */
+class InflightRequests {
+public:
+  struct Request {
+    OpCodes opcode;
+    MonotonicTime start_time;
+  };
+
+  // The number of requests which can be in flight. Beyond it, requests are not tracked.
+  static constexpr uint32_t Capacity = 256;
+  static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+  /**
+   * Tracks a request, replacing the one tracked for the same xid if any.
+   * @return false if the table is full, the request then not being tracked.
+   */
+  bool insert(int32_t xid, OpCodes opcode, MonotonicTime start_time);
+
+  /**
+   * Stops tracking the request of an xid.
+   * @return the request tracked for the xid, if any.
+   */
+  absl::optional<Request> remove(int32_t xid);
+
+  uint32_t size() const { return size_; }
+
+private:
+  struct Slot {
+    Request request;
+    int32_t xid;
+    bool used;
+  };
+
+  // The xids of a session are sequential, which the low bits spread over the slots without
+  // colliding.
+  static uint32_t slotIndex(int32_t xid) { return static_cast<uint32_t>(xid) & (Capacity - 1); }
+  static uint32_t nextIndex(uint32_t index) { return (index + 1) & (Capacity - 1); }
+
+  std::array<Slot, Capacity> slots_{};
+  uint32_t size_{};
+};
+
 class DecoderImpl : public Decoder, Logger::Loggable<Logger::Id::filter> {
 public:
   explicit DecoderImpl(DecoderCallbacks& callbacks, uint32_t max_packet_bytes,
@@ -130,10 +181,6 @@ public:
 
 private:
   enum class DecodeType { READ, WRITE };
-  struct RequestBegin {
-    OpCodes opcode;
-    MonotonicTime start_time;
-  };
 
   void decode(Buffer::Instance& data, DecodeType dtype);
   void decodeOnData(Buffer::Instance& data, uint64_t& offset);
@@ -164,12 +211,13 @@ private:
   void parseWatchEvent(Buffer::Instance& data, uint64_t& offset, uint32_t len, int64_t zxid,
                        int32_t error);
   bool maybeReadBool(Buffer::Instance& data, uint64_t& offset);
+  void trackRequest(int32_t xid, OpCodes opcode, MonotonicTime start_time);
 
   DecoderCallbacks& callbacks_;
   const uint32_t max_packet_bytes_;
   BufferHelper helper_;
   TimeSource& time_source_;
-  std::unordered_map<int32_t, RequestBegin> requests_by_xid_;
+  InflightRequests inflight_requests_;
 };
 
 } // namespace ZooKeeperProxy
@@ -21,7 +21,7 @@ ZooKeeperFilterConfig::ZooKeeperFilterConfig(const std::string& stat_prefix,
     : scope_(scope), max_packet_bytes_(max_packet_bytes), stats_(generateStats(stat_prefix, scope)),
       stat_name_set_(scope.symbolTable()), stat_prefix_(stat_name_set_.add(stat_prefix)),
       auth_(stat_name_set_.add("auth")),
-      connect_latency_(stat_name_set_.add("connect_response_latency")) {
+      connect_latency_(stat_name_set_.add(absl::StrCat(stat_prefix, ".connect_response_latency"))) {
   // https://zookeeper.apache.org/doc/r3.5.4-beta/zookeeperProgrammers.html#sc_BuiltinACLSchemes
   // lists commons schemes: "world", "auth", "digest", "host", "x509", and
   // "ip". These are used in filter.cc by appending "_rq".
@@ -31,6 +31,44 @@ ZooKeeperFilterConfig::ZooKeeperFilterConfig(const std::string& stat_prefix,
   stat_name_set_.rememberBuiltin("ip_rq");
   stat_name_set_.rememberBuiltin("world_rq");
   stat_name_set_.rememberBuiltin("x509_rq");
+
+  initOpCode(OpCodes::PING, stats_.ping_resp_, "ping_response", stat_prefix);
+  initOpCode(OpCodes::SETAUTH, stats_.auth_resp_, "auth_response", stat_prefix);
+  initOpCode(OpCodes::GETDATA, stats_.getdata_resp_, "getdata_resp", stat_prefix);
+  initOpCode(OpCodes::CREATE, stats_.create_resp_, "create_resp", stat_prefix);
+  initOpCode(OpCodes::CREATE2, stats_.create2_resp_, "create2_resp", stat_prefix);
+  initOpCode(OpCodes::CREATECONTAINER, stats_.createcontainer_resp_, "createcontainer_resp",
+             stat_prefix);
+  initOpCode(OpCodes::CREATETTL, stats_.createttl_resp_, "createttl_resp", stat_prefix);
+  initOpCode(OpCodes::SETDATA, stats_.setdata_resp_, "setdata_resp", stat_prefix);
+  initOpCode(OpCodes::GETCHILDREN, stats_.getchildren_resp_, "getchildren_resp", stat_prefix);
+  initOpCode(OpCodes::GETCHILDREN2, stats_.getchildren2_resp_, "getchildren2_resp", stat_prefix);
+  initOpCode(OpCodes::DELETE, stats_.delete_resp_, "delete_resp", stat_prefix);
+  initOpCode(OpCodes::EXISTS, stats_.exists_resp_, "exists_resp", stat_prefix);
+  initOpCode(OpCodes::GETACL, stats_.getacl_resp_, "getacl_resp", stat_prefix);
+  initOpCode(OpCodes::SETACL, stats_.setacl_resp_, "setacl_resp", stat_prefix);
+  initOpCode(OpCodes::SYNC, stats_.sync_resp_, "sync_resp", stat_prefix);
+  initOpCode(OpCodes::CHECK, stats_.check_resp_, "check_resp", stat_prefix);
+  initOpCode(OpCodes::MULTI, stats_.multi_resp_, "multi_resp", stat_prefix);
+  initOpCode(OpCodes::RECONFIG, stats_.reconfig_resp_, "reconfig_resp", stat_prefix);
+  initOpCode(OpCodes::SETWATCHES, stats_.setwatches_resp_, "setwatches_resp", stat_prefix);
+  initOpCode(OpCodes::CHECKWATCHES, stats_.checkwatches_resp_, "checkwatches_resp", stat_prefix);
+  initOpCode(OpCodes::REMOVEWATCHES, stats_.removewatches_resp_, "removewatches_resp",
+             stat_prefix);
+  initOpCode(OpCodes::GETEPHEMERALS, stats_.getephemerals_resp_, "getephemerals_resp",
+             stat_prefix);
+  initOpCode(OpCodes::GETALLCHILDRENNUMBER, stats_.getallchildrennumber_resp_,
+             "getallchildrennumber_resp", stat_prefix);
+  initOpCode(OpCodes::CLOSE, stats_.close_resp_, "close_resp", stat_prefix);
+}
+
+void ZooKeeperFilterConfig::initOpCode(OpCodes opcode, Stats::Counter& counter,
+                                       const std::string& opname,
+                                       const std::string& stat_prefix) {
+  OpCodeInfo& info = op_code_map_[opcode];
+  info.counter_ = &counter;
+  info.opname_ = opname;
+  info.latency_name_ = stat_name_set_.add(absl::StrCat(stat_prefix, ".", opname, "_latency"));
 }
 
 ZooKeeperFilter::ZooKeeperFilter(ZooKeeperFilterConfigSharedPtr config, TimeSource& time_source)
@@ -254,10 +292,7 @@ void ZooKeeperFilter::onConnectResponse(const int32_t proto_version, const int32
                                         const std::chrono::milliseconds& latency) {
   config_->stats_.connect_resp_.inc();
 
-  Stats::SymbolTable::StoragePtr storage =
-      config_->scope_.symbolTable().join({config_->stat_prefix_, config_->connect_latency_});
-  config_->scope_.histogramFromStatName(Stats::StatName(storage.get()))
-      .recordValue(latency.count());
+  config_->scope_.histogramFromStatName(config_->connect_latency_).recordValue(latency.count());
 
   setDynamicMetadata({{"opname", "connect_response"},
                       {"protocol_version", std::to_string(proto_version)},
@@ -267,121 +302,25 @@ void ZooKeeperFilter::onConnectResponse(const int32_t proto_version, const int32
 
 void ZooKeeperFilter::onResponse(const OpCodes opcode, const int32_t xid, const int64_t zxid,
                                  const int32_t error, const std::chrono::milliseconds& latency) {
-  std::string opname = "";
+  const auto it = config_->op_code_map_.find(opcode);
+  // The decoder only reports the responses of the opcodes it decodes requests of.
+  ASSERT(it != config_->op_code_map_.end());
+  const ZooKeeperFilterConfig::OpCodeInfo& info = it->second;
 
-  switch (opcode) {
-  case OpCodes::PING:
-    config_->stats_.ping_resp_.inc();
-    opname = "ping_response";
-    break;
-  case OpCodes::SETAUTH:
-    config_->stats_.auth_resp_.inc();
-    opname = "auth_response";
-    break;
-  case OpCodes::GETDATA:
-    opname = "getdata_resp";
-    config_->stats_.getdata_resp_.inc();
-    break;
-  case OpCodes::CREATE:
-    opname = "create_resp";
-    config_->stats_.create_resp_.inc();
-    break;
-  case OpCodes::CREATE2:
-    opname = "create2_resp";
-    config_->stats_.create2_resp_.inc();
-    break;
-  case OpCodes::CREATECONTAINER:
-    opname = "createcontainer_resp";
-    config_->stats_.createcontainer_resp_.inc();
-    break;
-  case OpCodes::CREATETTL:
-    opname = "createttl_resp";
-    config_->stats_.createttl_resp_.inc();
-    break;
-  case OpCodes::SETDATA:
-    opname = "setdata_resp";
-    config_->stats_.setdata_resp_.inc();
-    break;
-  case OpCodes::GETCHILDREN:
-    opname = "getchildren_resp";
-    config_->stats_.getchildren_resp_.inc();
-    break;
-  case OpCodes::GETCHILDREN2:
-    opname = "getchildren2_resp";
-    config_->stats_.getchildren2_resp_.inc();
-    break;
-  case OpCodes::DELETE:
-    opname = "delete_resp";
-    config_->stats_.delete_resp_.inc();
-    break;
-  case OpCodes::EXISTS:
-    opname = "exists_resp";
-    config_->stats_.exists_resp_.inc();
-    break;
-  case OpCodes::GETACL:
-    config_->stats_.getacl_resp_.inc();
-    opname = "getacl_resp";
-    break;
-  case OpCodes::SETACL:
-    opname = "setacl_resp";
-    config_->stats_.setacl_resp_.inc();
-    break;
-  case OpCodes::SYNC:
-    opname = "sync_resp";
-    config_->stats_.sync_resp_.inc();
-    break;
-  case OpCodes::CHECK:
-    opname = "check_resp";
-    config_->stats_.check_resp_.inc();
-    break;
-  case OpCodes::MULTI:
-    opname = "multi_resp";
-    config_->stats_.multi_resp_.inc();
-    break;
-  case OpCodes::RECONFIG:
-    opname = "reconfig_resp";
-    config_->stats_.reconfig_resp_.inc();
-    break;
-  case OpCodes::SETWATCHES:
-    opname = "setwatches_resp";
-    config_->stats_.setwatches_resp_.inc();
-    break;
-  case OpCodes::CHECKWATCHES:
-    opname = "checkwatches_resp";
-    config_->stats_.checkwatches_resp_.inc();
-    break;
-  case OpCodes::REMOVEWATCHES:
-    opname = "removewatches_resp";
-    config_->stats_.removewatches_resp_.inc();
-    break;
-  case OpCodes::GETEPHEMERALS:
-    opname = "getephemerals_resp";
-    config_->stats_.getephemerals_resp_.inc();
-    break;
-  case OpCodes::GETALLCHILDRENNUMBER:
-    opname = "getallchildrennumber_resp";
-    config_->stats_.getallchildrennumber_resp_.inc();
-    break;
-  case OpCodes::CLOSE:
-    opname = "close_resp";
-    config_->stats_.close_resp_.inc();
-    break;
-  default:
-    break;
-  }
+  info.counter_->inc();
+  config_->scope_.histogramFromStatName(info.latency_name_).recordValue(latency.count());
 
-  Stats::SymbolTable::StoragePtr storage = config_->scope_.symbolTable().join(
-      {config_->stat_prefix_,
-       config_->stat_name_set_.getStatName(absl::StrCat(opname, "_latency"))});
-  config_->scope_.histogramFromStatName(Stats::StatName(storage.get()))
-      .recordValue(latency.count());
-
-  setDynamicMetadata({{"opname", opname},
+  setDynamicMetadata({{"opname", info.opname_},
                       {"xid", std::to_string(xid)},
                       {"zxid", std::to_string(zxid)},
                       {"error", std::to_string(error)}});
 }
 
+void ZooKeeperFilter::onUntrackedResponse(const int32_t xid) {
+  config_->stats_.untracked_resp_.inc();
+  setDynamicMetadata({{"opname", "untracked_resp"}, {"xid", std::to_string(xid)}});
+}
+
 void ZooKeeperFilter::onWatchEvent(const int32_t event_type, const int32_t client_state,
                                    const std::string& path, const int64_t zxid,
                                    const int32_t error) {
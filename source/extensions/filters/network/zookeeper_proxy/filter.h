@@ -16,6 +16,8 @@
 
 #include "extensions/filters/network/zookeeper_proxy/decoder.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -81,6 +83,7 @@ namespace ZooKeeperProxy {
   COUNTER(checkwatches_resp)                                            \
   COUNTER(removewatches_resp)                                           \
   COUNTER(check_resp)                                                   \
+  COUNTER(untracked_resp)                                               \
   COUNTER(watch_event)
 // clang-format on
 
@@ -99,6 +102,16 @@ public:
   ZooKeeperFilterConfig(const std::string& stat_prefix, uint32_t max_packet_bytes,
                         Stats::Scope& scope);
 
+  /**
+   * The stats of the responses to an opcode.
+   */
+  struct OpCodeInfo {
+    Stats::Counter* counter_;
+    std::string opname_;
+    // The full name of the latency histogram, built once rather than for each response.
+    Stats::StatName latency_name_;
+  };
+
   const ZooKeeperProxyStats& stats() { return stats_; }
   uint32_t maxPacketBytes() const { return max_packet_bytes_; }
 
@@ -109,8 +122,12 @@ public:
   const Stats::StatName stat_prefix_;
   const Stats::StatName auth_;
   const Stats::StatName connect_latency_;
+  absl::flat_hash_map<OpCodes, OpCodeInfo> op_code_map_;
 
 private:
+  void initOpCode(OpCodes opcode, Stats::Counter& counter, const std::string& opname,
+                  const std::string& stat_prefix);
+
   ZooKeeperProxyStats generateStats(const std::string& prefix, Stats::Scope& scope) {
     return ZooKeeperProxyStats{ALL_ZOOKEEPER_PROXY_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
   }
@@ -164,6 +181,7 @@ public:
                          const std::chrono::milliseconds& latency) override;
   void onResponse(OpCodes opcode, int32_t xid, int64_t zxid, int32_t error,
                   const std::chrono::milliseconds& latency) override;
+  void onUntrackedResponse(int32_t xid) override;
   void onWatchEvent(int32_t event_type, int32_t client_state, const std::string& path, int64_t zxid,
                     int32_t error) override;
 
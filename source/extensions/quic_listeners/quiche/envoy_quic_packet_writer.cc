@@ -11,8 +11,11 @@
 
 #pragma GCC diagnostic pop
 
+#include <cstring>
+
 #include "extensions/quic_listeners/quiche/envoy_quic_utils.h"
 #include "common/buffer/buffer_impl.h"
+#include "common/common/stack_array.h"
 
 namespace Envoy {
 namespace Quic {
@@ -47,5 +50,105 @@ quic::WriteResult EnvoyQuicPacketWriter::WritePacket(const char* buffer, size_t
   return {status, static_cast<int>(result.err_->getErrorCode())};
 }
 
+EnvoyQuicBatchPacketWriter::EnvoyQuicBatchPacketWriter(Network::UdpListener& listener)
+    : listener_(listener),
+      buffer_(new char[MaxBatchPackets * quic::kMaxOutgoingPacketSize]) {}
+
+bool EnvoyQuicBatchPacketWriter::canBatch(const quic::QuicIpAddress& self_address,
+                                          const quic::QuicSocketAddress& peer_address) const {
+  return num_packets_ == 0 ||
+         (num_packets_ < MaxBatchPackets && self_address == batch_self_address_ &&
+          peer_address == batch_peer_address_);
+}
+
+char* EnvoyQuicBatchPacketWriter::GetNextWriteLocation(
+    const quic::QuicIpAddress& self_address, const quic::QuicSocketAddress& peer_address) {
+  // A packet which can not join the batch is serialized by QUICHE into its own buffer, and
+  // WritePacket() flushes the batch before buffering it.
+  return canBatch(self_address, peer_address) ? packetLocation(num_packets_) : nullptr;
+}
+
+quic::WriteResult EnvoyQuicBatchPacketWriter::WritePacket(
+    const char* buffer, size_t buf_len, const quic::QuicIpAddress& self_ip,
+    const quic::QuicSocketAddress& peer_address, quic::PerPacketOptions* options) {
+  ASSERT(options == nullptr, "Per packet option is not supported yet.");
+  ASSERT(!write_blocked_, "Cannot write while IO handle is blocked.");
+  ASSERT(buf_len <= quic::kMaxOutgoingPacketSize);
+
+  if (!canBatch(self_ip, peer_address)) {
+    const quic::WriteResult flush_result = Flush();
+    if (flush_result.status != quic::WRITE_STATUS_OK) {
+      // The packet is not buffered, the caller retries it once the writer is writable.
+      return flush_result;
+    }
+  }
+
+  if (num_packets_ == 0) {
+    batch_self_address_ = self_ip;
+    batch_peer_address_ = peer_address;
+    batch_local_addr_ = quicAddressToEnvoyAddressInstance(quic::QuicSocketAddress(self_ip, 0));
+    batch_remote_addr_ = quicAddressToEnvoyAddressInstance(peer_address);
+  }
+  char* location = packetLocation(num_packets_);
+  // The packet was serialized in place if QUICHE got its location from GetNextWriteLocation().
+  if (buffer != location) {
+    memcpy(location, buffer, buf_len);
+  }
+  packet_lengths_[num_packets_++] = buf_len;
+  if (num_packets_ < MaxBatchPackets) {
+    return {quic::WRITE_STATUS_OK, 0};
+  }
+
+  quic::WriteResult result = Flush();
+  if (result.status == quic::WRITE_STATUS_BLOCKED) {
+    // The packet is kept in the batch, which is sent again once the writer is writable.
+    result.status = quic::WRITE_STATUS_BLOCKED_DATA_BUFFERED;
+  }
+  return result;
+}
+
+quic::WriteResult EnvoyQuicBatchPacketWriter::Flush() {
+  if (num_packets_ == 0) {
+    return {quic::WRITE_STATUS_OK, 0};
+  }
+
+  STACK_ARRAY(packets, Buffer::RawSlice, num_packets_);
+  for (size_t i = 0; i < num_packets_; i++) {
+    packets[i] = {packetLocation(i), packet_lengths_[i]};
+  }
+  Network::UdpSendBatchData send_data{
+      batch_local_addr_ == nullptr ? nullptr : batch_local_addr_->ip(), *batch_remote_addr_,
+      packets.begin(), num_packets_};
+  const Api::IoCallUint64Result result = listener_.sendBatch(send_data);
+
+  const size_t packets_sent = result.rc_;
+  ASSERT(packets_sent <= num_packets_);
+  int bytes_sent = 0;
+  for (size_t i = 0; i < packets_sent; i++) {
+    bytes_sent += packet_lengths_[i];
+  }
+  if (result.ok()) {
+    num_packets_ = 0;
+    return {quic::WRITE_STATUS_OK, bytes_sent};
+  }
+
+  quic::WriteStatus status = result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again
+                                 ? quic::WRITE_STATUS_BLOCKED
+                                 : quic::WRITE_STATUS_ERROR;
+  if (quic::IsWriteBlockedStatus(status)) {
+    write_blocked_ = true;
+    // The packets which were not sent move to the front of the batch, to be sent first.
+    for (size_t i = packets_sent; i < num_packets_; i++) {
+      memmove(packetLocation(i - packets_sent), packetLocation(i), packet_lengths_[i]);
+      packet_lengths_[i - packets_sent] = packet_lengths_[i];
+    }
+    num_packets_ -= packets_sent;
+  } else {
+    // Like the unbatched writer, the packets are lost on errors other than a full send buffer.
+    num_packets_ = 0;
+  }
+  return {status, static_cast<int>(result.err_->getErrorCode())};
+}
+
 } // namespace Quic
 } // namespace Envoy
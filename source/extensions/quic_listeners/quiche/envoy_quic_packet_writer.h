@@ -10,6 +10,9 @@
 
 #pragma GCC diagnostic pop
 
+#include <array>
+#include <memory>
+
 #include "envoy/network/listener.h"
 
 namespace Envoy {
@@ -47,5 +50,60 @@ private:
   Network::UdpListener& listener_;
 };
 
+/**
+ * A packet writer which batches the packets written to the same peer from the same address, and
+ * sends each batch with a single UdpListener::sendBatch() call, i.e. a single sendmmsg() where
+ * supported. QUICHE serializes the packets directly into the batch through
+ * GetNextWriteLocation(), and flushes the batch once it is done writing.
+ */
+class EnvoyQuicBatchPacketWriter : public quic::QuicPacketWriter {
+public:
+  // The maximum number of packets in a batch.
+  static constexpr size_t MaxBatchPackets = 16;
+
+  EnvoyQuicBatchPacketWriter(Network::UdpListener& listener);
+
+  quic::WriteResult WritePacket(const char* buffer, size_t buf_len,
+                                const quic::QuicIpAddress& self_address,
+                                const quic::QuicSocketAddress& peer_address,
+                                quic::PerPacketOptions* options) override;
+
+  // quic::QuicPacketWriter
+  bool IsWriteBlocked() const override { return write_blocked_; }
+  void SetWritable() override { write_blocked_ = false; }
+  quic::QuicByteCount
+  GetMaxPacketSize(const quic::QuicSocketAddress& /*peer_address*/) const override {
+    return quic::kMaxOutgoingPacketSize;
+  }
+  // Currently this writer doesn't support pacing offload.
+  bool SupportsReleaseTime() const override { return false; }
+  bool IsBatchMode() const override { return true; }
+  char* GetNextWriteLocation(const quic::QuicIpAddress& self_address,
+                             const quic::QuicSocketAddress& peer_address) override;
+  quic::WriteResult Flush() override;
+
+  size_t numBufferedPackets() const { return num_packets_; }
+
+private:
+  bool canBatch(const quic::QuicIpAddress& self_address,
+                const quic::QuicSocketAddress& peer_address) const;
+  char* packetLocation(size_t index) const {
+    return buffer_.get() + index * quic::kMaxOutgoingPacketSize;
+  }
+
+  // Modified by WritePacket() and Flush() to indicate underlying IoHandle status.
+  bool write_blocked_{false};
+  Network::UdpListener& listener_;
+  // Room for MaxBatchPackets packets of kMaxOutgoingPacketSize bytes.
+  const std::unique_ptr<char[]> buffer_;
+  std::array<size_t, MaxBatchPackets> packet_lengths_;
+  size_t num_packets_{0};
+  // The addresses of the buffered packets, converted once per batch.
+  quic::QuicIpAddress batch_self_address_;
+  quic::QuicSocketAddress batch_peer_address_;
+  Network::Address::InstanceConstSharedPtr batch_local_addr_;
+  Network::Address::InstanceConstSharedPtr batch_remote_addr_;
+};
+
 } // namespace Quic
 } // namespace Envoy
@@ -0,0 +1,29 @@
+#include "extensions/resource_monitors/active_requests/active_requests_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace ActiveRequestsMonitor {
+
+ActiveRequestsMonitor::ActiveRequestsMonitor(
+    const envoy::config::resource_monitor::active_requests::v2alpha::ActiveRequestsConfig& config,
+    ThreadLocal::SlotAllocator& slot_allocator, TimeSource& time_source,
+    Server::OverloadManager& overload_manager)
+    : max_active_requests_(config.max_active_requests()),
+      probe_(slot_allocator, time_source, [&overload_manager](MonotonicTime) -> uint64_t {
+        // The HTTP connection managers of the thread count their requests in its overload state.
+        return overload_manager.getThreadLocalOverloadState().activeRequests();
+      }) {}
+
+void ActiveRequestsMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  probe_.update();
+
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ = probe_.sampleSum() / static_cast<double>(max_active_requests_);
+  callbacks.onSuccess(usage);
+}
+
+} // namespace ActiveRequestsMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
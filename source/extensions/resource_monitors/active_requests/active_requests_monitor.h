@@ -0,0 +1,38 @@
+#pragma once
+
+#include "envoy/common/time.h"
+#include "envoy/config/resource_monitor/active_requests/v2alpha/active_requests.pb.validate.h"
+#include "envoy/server/overload_manager.h"
+#include "envoy/server/resource_monitor.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "extensions/resource_monitors/common/thread_probe.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace ActiveRequestsMonitor {
+
+/**
+ * Monitor of the HTTP requests active on all the workers with a statically configured maximum.
+ */
+class ActiveRequestsMonitor : public Server::ResourceMonitor {
+public:
+  ActiveRequestsMonitor(
+      const envoy::config::resource_monitor::active_requests::v2alpha::ActiveRequestsConfig&
+          config,
+      ThreadLocal::SlotAllocator& slot_allocator, TimeSource& time_source,
+      Server::OverloadManager& overload_manager);
+
+  // Server::ResourceMonitor
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  const uint64_t max_active_requests_;
+  Common::ThreadProbe probe_;
+};
+
+} // namespace ActiveRequestsMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,28 @@
+#include "extensions/resource_monitors/active_requests/config.h"
+
+#include "envoy/registry/registry.h"
+
+#include "extensions/resource_monitors/active_requests/active_requests_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace ActiveRequestsMonitor {
+
+Server::ResourceMonitorPtr ActiveRequestsMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::config::resource_monitor::active_requests::v2alpha::ActiveRequestsConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& context) {
+  return std::make_unique<ActiveRequestsMonitor>(config, context.threadLocal(),
+                                                 context.api().timeSource(),
+                                                 context.overloadManager());
+}
+
+/**
+ * Static registration for the active requests resource monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(ActiveRequestsMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace ActiveRequestsMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "envoy/config/resource_monitor/active_requests/v2alpha/active_requests.pb.validate.h"
+#include "envoy/server/resource_monitor_config.h"
+
+#include "extensions/resource_monitors/common/factory_base.h"
+#include "extensions/resource_monitors/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace ActiveRequestsMonitor {
+
+class ActiveRequestsMonitorFactory
+    : public Common::FactoryBase<
+          envoy::config::resource_monitor::active_requests::v2alpha::ActiveRequestsConfig> {
+public:
+  ActiveRequestsMonitorFactory() : FactoryBase(ResourceMonitorNames::get().ActiveRequests) {}
+
+private:
+  Server::ResourceMonitorPtr createResourceMonitorFromProtoTyped(
+      const envoy::config::resource_monitor::active_requests::v2alpha::ActiveRequestsConfig& config,
+      Server::Configuration::ResourceMonitorFactoryContext& context) override;
+};
+
+} // namespace ActiveRequestsMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,39 @@
+#include "extensions/resource_monitors/buffer_memory/buffer_memory_monitor.h"
+
+#include <algorithm>
+
+#include "common/buffer/watermark_buffer.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace BufferMemoryMonitor {
+
+BufferMemoryMonitor::BufferMemoryMonitor(
+    const envoy::config::resource_monitor::buffer_memory::v2alpha::BufferMemoryConfig& config,
+    ThreadLocal::SlotAllocator& slot_allocator, TimeSource& time_source)
+    : max_buffered_bytes_(config.max_buffered_bytes()),
+      max_worker_buffered_bytes_(config.max_worker_buffered_bytes()),
+      probe_(slot_allocator, time_source, [](MonotonicTime) -> uint64_t {
+        // Unlike Buffer::WatermarkBuffer::totalBufferedBytes(), the bytes of each thread are not
+        // batched, so the budget of a worker can be smaller than the batches of all the threads.
+        return Buffer::WatermarkBuffer::threadBufferedBytes();
+      }) {}
+
+void BufferMemoryMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  probe_.update();
+
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ = probe_.sampleSum() / static_cast<double>(max_buffered_bytes_);
+  if (max_worker_buffered_bytes_ > 0) {
+    usage.resource_pressure_ =
+        std::max(usage.resource_pressure_,
+                 probe_.maxSample() / static_cast<double>(max_worker_buffered_bytes_));
+  }
+  callbacks.onSuccess(usage);
+}
+
+} // namespace BufferMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "envoy/common/time.h"
+#include "envoy/config/resource_monitor/buffer_memory/v2alpha/buffer_memory.pb.validate.h"
+#include "envoy/server/resource_monitor.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "extensions/resource_monitors/common/thread_probe.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace BufferMemoryMonitor {
+
+/**
+ * Monitor of the bytes held by the watermark buffers of all the threads with a statically
+ * configured budget for the process and optionally for each worker.
+ */
+class BufferMemoryMonitor : public Server::ResourceMonitor {
+public:
+  BufferMemoryMonitor(
+      const envoy::config::resource_monitor::buffer_memory::v2alpha::BufferMemoryConfig& config,
+      ThreadLocal::SlotAllocator& slot_allocator, TimeSource& time_source);
+
+  // Server::ResourceMonitor
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  const uint64_t max_buffered_bytes_;
+  const uint64_t max_worker_buffered_bytes_;
+  Common::ThreadProbe probe_;
+};
+
+} // namespace BufferMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
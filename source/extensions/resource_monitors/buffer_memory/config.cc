@@ -0,0 +1,27 @@
+#include "extensions/resource_monitors/buffer_memory/config.h"
+
+#include "envoy/registry/registry.h"
+
+#include "extensions/resource_monitors/buffer_memory/buffer_memory_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace BufferMemoryMonitor {
+
+Server::ResourceMonitorPtr BufferMemoryMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::config::resource_monitor::buffer_memory::v2alpha::BufferMemoryConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& context) {
+  return std::make_unique<BufferMemoryMonitor>(config, context.threadLocal(),
+                                               context.api().timeSource());
+}
+
+/**
+ * Static registration for the buffer memory resource monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(BufferMemoryMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace BufferMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
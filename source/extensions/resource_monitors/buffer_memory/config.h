@@ -0,0 +1,29 @@
+#pragma once
+
+#include "envoy/config/resource_monitor/buffer_memory/v2alpha/buffer_memory.pb.validate.h"
+#include "envoy/server/resource_monitor_config.h"
+
+#include "extensions/resource_monitors/common/factory_base.h"
+#include "extensions/resource_monitors/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace BufferMemoryMonitor {
+
+class BufferMemoryMonitorFactory
+    : public Common::FactoryBase<
+          envoy::config::resource_monitor::buffer_memory::v2alpha::BufferMemoryConfig> {
+public:
+  BufferMemoryMonitorFactory() : FactoryBase(ResourceMonitorNames::get().BufferMemory) {}
+
+private:
+  Server::ResourceMonitorPtr createResourceMonitorFromProtoTyped(
+      const envoy::config::resource_monitor::buffer_memory::v2alpha::BufferMemoryConfig& config,
+      Server::Configuration::ResourceMonitorFactoryContext& context) override;
+};
+
+} // namespace BufferMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,90 @@
+#include "extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+
+#include "envoy/common/exception.h"
+
+#include "common/common/fmt.h"
+#include "common/common/utility.h"
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+CgroupMemoryMonitor::CgroupMemoryMonitor(
+    const envoy::config::resource_monitor::cgroup_memory::v2alpha::CgroupMemoryConfig& config,
+    Filesystem::Instance& file_system)
+    : file_system_(file_system), max_memory_(config.max_memory_bytes()) {
+  const std::string root = config.cgroup_path().empty() ? "/sys/fs/cgroup" : config.cgroup_path();
+  if (file_system_.fileExists(root + "/memory.current")) {
+    usage_path_ = root + "/memory.current";
+    limit_path_ = root + "/memory.max";
+    stat_path_ = root + "/memory.stat";
+    inactive_file_key_ = "inactive_file";
+  } else {
+    usage_path_ = root + "/memory/memory.usage_in_bytes";
+    limit_path_ = root + "/memory/memory.limit_in_bytes";
+    stat_path_ = root + "/memory/memory.stat";
+    inactive_file_key_ = "total_inactive_file";
+  }
+}
+
+void CgroupMemoryMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  try {
+    const uint64_t limit = readLimitBytes();
+    const uint64_t usage = readBytes(usage_path_);
+    const uint64_t inactive_file = readInactiveFileBytes();
+    const uint64_t working_set = usage > inactive_file ? usage - inactive_file : 0;
+
+    Server::ResourceUsage resource_usage;
+    resource_usage.resource_pressure_ = working_set / static_cast<double>(limit);
+    callbacks.onSuccess(resource_usage);
+  } catch (const EnvoyException& error) {
+    callbacks.onFailure(error);
+  }
+}
+
+uint64_t CgroupMemoryMonitor::readBytes(const std::string& path) const {
+  uint64_t bytes;
+  if (!absl::SimpleAtoi(StringUtil::trim(file_system_.fileReadToEnd(path)), &bytes)) {
+    throw EnvoyException(fmt::format("failed to parse the memory in bytes of {}", path));
+  }
+  return bytes;
+}
+
+uint64_t CgroupMemoryMonitor::readLimitBytes() const {
+  uint64_t limit = max_memory_;
+  // Without a limit, cgroup v2 has "max" and cgroup v1 the largest page aligned value.
+  const std::string contents = file_system_.fileReadToEnd(limit_path_);
+  uint64_t cgroup_limit;
+  if (absl::SimpleAtoi(StringUtil::trim(contents), &cgroup_limit) &&
+      (limit == 0 || cgroup_limit < limit)) {
+    limit = cgroup_limit;
+  }
+  if (limit == 0) {
+    throw EnvoyException(
+        fmt::format("the cgroup has no memory limit in {} and no max_memory_bytes is configured",
+                    limit_path_));
+  }
+  return limit;
+}
+
+uint64_t CgroupMemoryMonitor::readInactiveFileBytes() const {
+  const std::string contents = file_system_.fileReadToEnd(stat_path_);
+  for (absl::string_view line : absl::StrSplit(contents, '\n', absl::SkipEmpty())) {
+    const std::pair<absl::string_view, absl::string_view> entry =
+        absl::StrSplit(line, absl::MaxSplits(' ', 1));
+    uint64_t bytes;
+    if (entry.first == inactive_file_key_ && absl::SimpleAtoi(entry.second, &bytes)) {
+      return bytes;
+    }
+  }
+  return 0;
+}
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+
+#include "envoy/config/resource_monitor/cgroup_memory/v2alpha/cgroup_memory.pb.validate.h"
+#include "envoy/filesystem/filesystem.h"
+#include "envoy/server/resource_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+/**
+ * Memory monitor of the cgroup of the process, which reads the usage and limit of the cgroup from
+ * the files of its memory controller. The cgroup v2 unified hierarchy is used when it is mounted,
+ * the cgroup v1 memory controller otherwise.
+ */
+class CgroupMemoryMonitor : public Server::ResourceMonitor {
+public:
+  CgroupMemoryMonitor(
+      const envoy::config::resource_monitor::cgroup_memory::v2alpha::CgroupMemoryConfig& config,
+      Filesystem::Instance& file_system);
+
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  uint64_t readBytes(const std::string& path) const;
+  uint64_t readLimitBytes() const;
+  uint64_t readInactiveFileBytes() const;
+
+  Filesystem::Instance& file_system_;
+  const uint64_t max_memory_;
+  std::string usage_path_;
+  std::string limit_path_;
+  std::string stat_path_;
+  // The key of the inactive file pages in the memory.stat file, which differs between versions.
+  std::string inactive_file_key_;
+};
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
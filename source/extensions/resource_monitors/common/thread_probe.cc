@@ -0,0 +1,49 @@
+#include "extensions/resource_monitors/common/thread_probe.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace Common {
+
+ThreadProbe::ThreadProbe(ThreadLocal::SlotAllocator& slot_allocator, TimeSource& time_source,
+                         SampleCb sample)
+    : slot_(slot_allocator.allocateSlot()), time_source_(time_source),
+      sample_(std::make_shared<const SampleCb>(std::move(sample))) {}
+
+void ThreadProbe::update() {
+  if (running_ != nullptr) {
+    if (!running_->complete_) {
+      return;
+    }
+    max_sample_ = running_->max_;
+    sample_sum_ = running_->sum_;
+  }
+
+  running_ = std::make_shared<Samples>(time_source_.monotonicTime());
+  SamplesSharedPtr samples = running_;
+  // The posts share the sample callback, as the workers may run them after the monitor was
+  // destroyed during shutdown.
+  std::shared_ptr<const SampleCb> sample = sample_;
+  slot_->runOnAllThreads(
+      [samples, sample]() -> void {
+        const uint64_t value = (*sample)(samples->posted_);
+        samples->sum_ += value;
+        uint64_t max = samples->max_;
+        while (value > max && !samples->max_.compare_exchange_weak(max, value)) {
+        }
+      },
+      [samples]() -> void { samples->complete_ = true; });
+}
+
+std::chrono::milliseconds ThreadProbe::runningTime() const {
+  if (running_ == nullptr || running_->complete_) {
+    return std::chrono::milliseconds(0);
+  }
+  return std::chrono::duration_cast<std::chrono::milliseconds>(time_source_.monotonicTime() -
+                                                               running_->posted_);
+}
+
+} // namespace Common
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
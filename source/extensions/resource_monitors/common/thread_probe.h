@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "envoy/common/time.h"
+#include "envoy/thread_local/thread_local.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace Common {
+
+/**
+ * Samples a value on the main thread and on each worker by posting to their event loops, for the
+ * monitors of the load of the workers. A thread is sampled when its event loop runs the post, so
+ * a saturated loop delays the completion of the probe rather than blocking the main thread. The
+ * monitors report the samples of the last completed probe, and at most one probe runs at a time.
+ */
+class ThreadProbe {
+public:
+  // Returns the sample of the thread it runs on, given the time the probe was posted.
+  using SampleCb = std::function<uint64_t(MonotonicTime posted)>;
+
+  ThreadProbe(ThreadLocal::SlotAllocator& slot_allocator, TimeSource& time_source,
+              SampleCb sample);
+
+  /**
+   * Collect the samples of the running probe if it completed, and post a new probe unless one is
+   * still running.
+   */
+  void update();
+
+  /**
+   * @return the largest sample of a thread in the last completed probe.
+   */
+  uint64_t maxSample() const { return max_sample_; }
+
+  /**
+   * @return the sum of the samples of the threads in the last completed probe.
+   */
+  uint64_t sampleSum() const { return sample_sum_; }
+
+  /**
+   * @return the time since the running probe was posted, or zero if none is running.
+   */
+  std::chrono::milliseconds runningTime() const;
+
+private:
+  // Shared with the posts, which may outlive the probe.
+  struct Samples {
+    explicit Samples(MonotonicTime posted) : posted_(posted) {}
+
+    const MonotonicTime posted_;
+    std::atomic<uint64_t> max_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<bool> complete_{false};
+  };
+  using SamplesSharedPtr = std::shared_ptr<Samples>;
+
+  ThreadLocal::SlotPtr slot_;
+  TimeSource& time_source_;
+  const std::shared_ptr<const SampleCb> sample_;
+  SamplesSharedPtr running_;
+  uint64_t max_sample_{};
+  uint64_t sample_sum_{};
+};
+
+} // namespace Common
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "envoy/config/resource_monitor/event_loop_lag/v2alpha/event_loop_lag.pb.validate.h"
+#include "envoy/server/resource_monitor_config.h"
+
+#include "extensions/resource_monitors/common/factory_base.h"
+#include "extensions/resource_monitors/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopLagMonitor {
+
+class EventLoopLagMonitorFactory
+    : public Common::FactoryBase<
+          envoy::config::resource_monitor::event_loop_lag::v2alpha::EventLoopLagConfig> {
+public:
+  EventLoopLagMonitorFactory() : FactoryBase(ResourceMonitorNames::get().EventLoopLag) {}
+
+private:
+  Server::ResourceMonitorPtr createResourceMonitorFromProtoTyped(
+      const envoy::config::resource_monitor::event_loop_lag::v2alpha::EventLoopLagConfig& config,
+      Server::Configuration::ResourceMonitorFactoryContext& context) override;
+};
+
+} // namespace EventLoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
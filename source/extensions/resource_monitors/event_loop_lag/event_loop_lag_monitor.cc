@@ -0,0 +1,35 @@
+#include "extensions/resource_monitors/event_loop_lag/event_loop_lag_monitor.h"
+
+#include <algorithm>
+
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopLagMonitor {
+
+EventLoopLagMonitor::EventLoopLagMonitor(
+    const envoy::config::resource_monitor::event_loop_lag::v2alpha::EventLoopLagConfig& config,
+    ThreadLocal::SlotAllocator& slot_allocator, TimeSource& time_source)
+    : max_lag_(std::max<int64_t>(PROTOBUF_GET_MS_REQUIRED(config, max_lag), 1)),
+      probe_(slot_allocator, time_source, [&time_source](MonotonicTime posted) -> uint64_t {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(time_source.monotonicTime() -
+                                                                     posted)
+            .count();
+      }) {}
+
+void EventLoopLagMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  probe_.update();
+
+  // A probe still running after the last one completed is lagging at least since it was posted.
+  const uint64_t lag = std::max<uint64_t>(probe_.maxSample(), probe_.runningTime().count());
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ = lag / static_cast<double>(max_lag_.count());
+  callbacks.onSuccess(usage);
+}
+
+} // namespace EventLoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
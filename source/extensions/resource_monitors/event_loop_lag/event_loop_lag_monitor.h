@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+
+#include "envoy/common/time.h"
+#include "envoy/config/resource_monitor/event_loop_lag/v2alpha/event_loop_lag.pb.validate.h"
+#include "envoy/server/resource_monitor.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "extensions/resource_monitors/common/thread_probe.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopLagMonitor {
+
+/**
+ * Monitor of the lag of the event loops of the workers with a statically configured maximum.
+ */
+class EventLoopLagMonitor : public Server::ResourceMonitor {
+public:
+  EventLoopLagMonitor(
+      const envoy::config::resource_monitor::event_loop_lag::v2alpha::EventLoopLagConfig& config,
+      ThreadLocal::SlotAllocator& slot_allocator, TimeSource& time_source);
+
+  // Server::ResourceMonitor
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  const std::chrono::milliseconds max_lag_;
+  Common::ThreadProbe probe_;
+};
+
+} // namespace EventLoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,26 @@
+#include "extensions/resource_monitors/wasm/config.h"
+
+#include "envoy/registry/registry.h"
+
+#include "extensions/resource_monitors/wasm/wasm_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace WasmMonitor {
+
+Server::ResourceMonitorPtr WasmMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::config::resource_monitor::wasm::v2alpha::WasmConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& context) {
+  return std::make_unique<WasmMonitor>(config, context.api().timeSource());
+}
+
+/**
+ * Static registration for the Wasm resource monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(WasmMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace WasmMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "envoy/config/resource_monitor/wasm/v2alpha/wasm.pb.validate.h"
+#include "envoy/server/resource_monitor_config.h"
+
+#include "extensions/resource_monitors/common/factory_base.h"
+#include "extensions/resource_monitors/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace WasmMonitor {
+
+class WasmMonitorFactory
+    : public Common::FactoryBase<envoy::config::resource_monitor::wasm::v2alpha::WasmConfig> {
+public:
+  WasmMonitorFactory() : FactoryBase(ResourceMonitorNames::get().Wasm) {}
+
+private:
+  Server::ResourceMonitorPtr createResourceMonitorFromProtoTyped(
+      const envoy::config::resource_monitor::wasm::v2alpha::WasmConfig& config,
+      Server::Configuration::ResourceMonitorFactoryContext& context) override;
+};
+
+} // namespace WasmMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,54 @@
+#include "extensions/resource_monitors/wasm/wasm_monitor.h"
+
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+
+#include "extensions/common/wasm/wasm.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace WasmMonitor {
+
+uint64_t WasmUsageReader::memoryBytes() { return Common::Wasm::getTotalMemoryBytes(); }
+
+std::chrono::microseconds WasmUsageReader::guestCallTime() {
+  return Common::Wasm::getTotalGuestCallTime();
+}
+
+WasmMonitor::WasmMonitor(const envoy::config::resource_monitor::wasm::v2alpha::WasmConfig& config,
+                         TimeSource& time_source, std::unique_ptr<WasmUsageReader> usage)
+    : max_memory_bytes_(config.max_memory_bytes()), max_cpu_ratio_(config.max_cpu_ratio()),
+      time_source_(time_source), usage_(std::move(usage)),
+      last_update_(time_source_.monotonicTime()), last_guest_call_time_(usage_->guestCallTime()) {
+  if (max_memory_bytes_ == 0 && max_cpu_ratio_ == 0) {
+    throw EnvoyException("Wasm resource monitor requires max_memory_bytes or max_cpu_ratio");
+  }
+}
+
+void WasmMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  const MonotonicTime now = time_source_.monotonicTime();
+  const std::chrono::microseconds guest_call_time = usage_->guestCallTime();
+
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ = 0;
+  if (max_memory_bytes_ > 0) {
+    usage.resource_pressure_ = usage_->memoryBytes() / static_cast<double>(max_memory_bytes_);
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - last_update_);
+  if (max_cpu_ratio_ > 0 && elapsed.count() > 0) {
+    const double cpu_ratio =
+        (guest_call_time - last_guest_call_time_).count() / static_cast<double>(elapsed.count());
+    usage.resource_pressure_ = std::max(usage.resource_pressure_, cpu_ratio / max_cpu_ratio_);
+  }
+  last_update_ = now;
+  last_guest_call_time_ = guest_call_time;
+
+  callbacks.onSuccess(usage);
+}
+
+} // namespace WasmMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
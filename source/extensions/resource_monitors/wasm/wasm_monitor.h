@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+
+#include "envoy/common/time.h"
+#include "envoy/config/resource_monitor/wasm/v2alpha/wasm.pb.validate.h"
+#include "envoy/server/resource_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace WasmMonitor {
+
+/**
+ * Helper class for getting the resource usage of all Wasm VMs.
+ */
+class WasmUsageReader {
+public:
+  WasmUsageReader() = default;
+  virtual ~WasmUsageReader() = default;
+
+  // Linear memory of all VMs.
+  virtual uint64_t memoryBytes();
+  // Time spent in calls into all VMs since the start of the process.
+  virtual std::chrono::microseconds guestCallTime();
+};
+
+/**
+ * Wasm VM memory and CPU monitor with statically configured budgets.
+ */
+class WasmMonitor : public Server::ResourceMonitor {
+public:
+  WasmMonitor(const envoy::config::resource_monitor::wasm::v2alpha::WasmConfig& config,
+              TimeSource& time_source,
+              std::unique_ptr<WasmUsageReader> usage = std::make_unique<WasmUsageReader>());
+
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  const uint64_t max_memory_bytes_;
+  const double max_cpu_ratio_;
+  TimeSource& time_source_;
+  std::unique_ptr<WasmUsageReader> usage_;
+  MonotonicTime last_update_;
+  std::chrono::microseconds last_guest_call_time_;
+};
+
+} // namespace WasmMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -18,6 +18,21 @@ public:
 
   // File-based injected resource monitor.
   const std::string InjectedResource = "envoy.resource_monitors.injected_resource";
+
+  // Resource usage of all Wasm VMs.
+  const std::string Wasm = "envoy.resource_monitors.wasm";
+
+  // Lag of the event loop of the most lagging worker.
+  const std::string EventLoopLag = "envoy.resource_monitors.event_loop_lag";
+
+  // HTTP requests active on all the workers.
+  const std::string ActiveRequests = "envoy.resource_monitors.active_requests";
+
+  // Memory monitor of the cgroup of the process.
+  const std::string CgroupMemory = "envoy.resource_monitors.cgroup_memory";
+
+  // Bytes held by the connection and stream buffers of all the threads.
+  const std::string BufferMemory = "envoy.resource_monitors.buffer_memory";
 };
 
 using ResourceMonitorNames = ConstSingleton<ResourceMonitorNameValues>;
@@ -1,5 +1,9 @@
 #include "extensions/stat_sinks/common/statsd/statsd.h"
 
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <string>
@@ -38,31 +42,95 @@ void Writer::write(const std::string& message) {
   ::send(io_handle_->fd(), message.c_str(), message.size(), MSG_DONTWAIT);
 }
 
+void Writer::writeDatagrams(const std::vector<absl::string_view>& datagrams) {
+#if defined(__linux__)
+  // The datagrams are sent in batches, with one sendmmsg() call per batch.
+  static constexpr size_t MaxDatagramsPerCall = 64;
+  std::array<iovec, MaxDatagramsPerCall> iovecs;
+  std::array<mmsghdr, MaxDatagramsPerCall> headers;
+  for (size_t start = 0; start < datagrams.size(); start += MaxDatagramsPerCall) {
+    const size_t count = std::min(MaxDatagramsPerCall, datagrams.size() - start);
+    for (size_t i = 0; i < count; i++) {
+      const absl::string_view datagram = datagrams[start + i];
+      iovecs[i].iov_base = const_cast<char*>(datagram.data());
+      iovecs[i].iov_len = datagram.size();
+      headers[i] = {};
+      headers[i].msg_hdr.msg_iov = &iovecs[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+    }
+    // As with write(), datagrams which cannot be sent right away are dropped.
+    ::sendmmsg(io_handle_->fd(), headers.data(), count, MSG_DONTWAIT);
+  }
+#else
+  for (const absl::string_view datagram : datagrams) {
+    ::send(io_handle_->fd(), datagram.data(), datagram.size(), MSG_DONTWAIT);
+  }
+#endif
+}
+
 UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
                              Network::Address::InstanceConstSharedPtr address, const bool use_tag,
-                             const std::string& prefix)
+                             const std::string& prefix, const bool report_changed_only,
+                             const uint64_t max_bytes_per_datagram)
     : tls_(tls.allocateSlot()), server_address_(std::move(address)), use_tag_(use_tag),
-      prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix) {
+      prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix),
+      report_changed_only_(report_changed_only), max_bytes_per_datagram_(max_bytes_per_datagram) {
   tls_->set([this](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return std::make_shared<Writer>(this->server_address_);
   });
 }
 
 void UdpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
-  Writer& writer = tls_->getTyped<Writer>();
-  for (const auto& counter : snapshot.counters()) {
+  flush_buffer_.clear();
+  datagram_ends_.clear();
+  for (const auto& counter :
+       report_changed_only_ ? snapshot.changedCounters() : snapshot.counters()) {
     if (counter.counter_.get().used()) {
-      writer.write(fmt::format("{}.{}:{}|c{}", prefix_, getName(counter.counter_.get()),
-                               counter.delta_, buildTagStr(counter.counter_.get().tags())));
+      addFlushLine(counter.counter_.get(), counter.delta_, 'c');
     }
   }
 
-  for (const auto& gauge : snapshot.gauges()) {
+  for (const auto& gauge : report_changed_only_ ? snapshot.changedGauges() : snapshot.gauges()) {
     if (gauge.get().used()) {
-      writer.write(fmt::format("{}.{}:{}|g{}", prefix_, getName(gauge.get()), gauge.get().value(),
-                               buildTagStr(gauge.get().tags())));
+      addFlushLine(gauge.get(), gauge.get().value(), 'g');
+    }
+  }
+
+  if (flush_buffer_.size() == 0) {
+    return;
+  }
+  datagram_ends_.push_back(flush_buffer_.size());
+  std::vector<absl::string_view> datagrams;
+  datagrams.reserve(datagram_ends_.size());
+  size_t start = 0;
+  for (const size_t end : datagram_ends_) {
+    datagrams.emplace_back(flush_buffer_.data() + start, end - start);
+    start = end;
+  }
+  tls_->getTyped<Writer>().writeDatagrams(datagrams);
+}
+
+void UdpStatsdSink::addFlushLine(const Stats::Metric& metric, uint64_t value, char type) {
+  line_buffer_.clear();
+  fmt::format_to(line_buffer_, "{}.{}:{}|{}", prefix_, getName(metric), value, type);
+  if (use_tag_) {
+    const std::vector<Stats::Tag> tags = metric.tags();
+    for (size_t i = 0; i < tags.size(); i++) {
+      fmt::format_to(line_buffer_, "{}{}:{}", i == 0 ? "|#" : ",", tags[i].name_, tags[i].value_);
+    }
+  }
+
+  const size_t datagram_start = datagram_ends_.empty() ? 0 : datagram_ends_.back();
+  const size_t datagram_size = flush_buffer_.size() - datagram_start;
+  if (datagram_size > 0) {
+    if (datagram_size + 1 + line_buffer_.size() > max_bytes_per_datagram_) {
+      // A line larger than the limit still gets a datagram of its own.
+      datagram_ends_.push_back(flush_buffer_.size());
+    } else {
+      flush_buffer_.push_back('\n');
     }
   }
+  flush_buffer_.append(line_buffer_.data(), line_buffer_.data() + line_buffer_.size());
 }
 
 void UdpStatsdSink::onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) {
@@ -97,8 +165,9 @@ const std::string UdpStatsdSink::buildTagStr(const std::vector<Stats::Tag>& tags
 TcpStatsdSink::TcpStatsdSink(const LocalInfo::LocalInfo& local_info,
                              const std::string& cluster_name, ThreadLocal::SlotAllocator& tls,
                              Upstream::ClusterManager& cluster_manager, Stats::Scope& scope,
-                             const std::string& prefix)
-    : prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix), tls_(tls.allocateSlot()),
+                             const std::string& prefix, const bool report_changed_only)
+    : prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix),
+      report_changed_only_(report_changed_only), tls_(tls.allocateSlot()),
       cluster_manager_(cluster_manager), cx_overflow_stat_(scope.counter("statsd.cx_overflow")) {
 
   Config::Utility::checkClusterAndLocalInfo("tcp statsd", cluster_name, cluster_manager,
@@ -112,13 +181,14 @@ TcpStatsdSink::TcpStatsdSink(const LocalInfo::LocalInfo& local_info,
 void TcpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
   TlsSink& tls_sink = tls_->getTyped<TlsSink>();
   tls_sink.beginFlush(true);
-  for (const auto& counter : snapshot.counters()) {
+  for (const auto& counter :
+       report_changed_only_ ? snapshot.changedCounters() : snapshot.counters()) {
     if (counter.counter_.get().used()) {
       tls_sink.flushCounter(counter.counter_.get().name(), counter.delta_);
     }
   }
 
-  for (const auto& gauge : snapshot.gauges()) {
+  for (const auto& gauge : report_changed_only_ ? snapshot.changedGauges() : snapshot.gauges()) {
     if (gauge.get().used()) {
       tls_sink.flushGauge(gauge.get().name(), gauge.get().value());
     }
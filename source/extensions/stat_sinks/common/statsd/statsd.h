@@ -11,9 +11,12 @@
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/common/fmt.h"
 #include "common/common/macros.h"
 #include "common/network/io_socket_handle_impl.h"
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace StatSinks {
@@ -33,6 +36,11 @@ public:
   ~Writer() override;
 
   virtual void write(const std::string& message);
+  /**
+   * Sends each of the datagrams, batching the system calls where the platform allows it.
+   * @param datagrams supplies the datagrams, each holding one or more newline separated messages.
+   */
+  virtual void writeDatagrams(const std::vector<absl::string_view>& datagrams);
   // Called in unit test to validate address.
   int getFdForTests() const { return io_handle_->fd(); }
 
@@ -46,18 +54,24 @@ private:
 class UdpStatsdSink : public Stats::Sink {
 public:
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, Network::Address::InstanceConstSharedPtr address,
-                const bool use_tag, const std::string& prefix = getDefaultPrefix());
+                const bool use_tag, const std::string& prefix = getDefaultPrefix(),
+                const bool report_changed_only = false, const uint64_t max_bytes_per_datagram = 0);
   // For testing.
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, const std::shared_ptr<Writer>& writer,
-                const bool use_tag, const std::string& prefix = getDefaultPrefix())
+                const bool use_tag, const std::string& prefix = getDefaultPrefix(),
+                const bool report_changed_only = false, const uint64_t max_bytes_per_datagram = 0)
       : tls_(tls.allocateSlot()), use_tag_(use_tag),
-        prefix_(prefix.empty() ? getDefaultPrefix() : prefix) {
+        prefix_(prefix.empty() ? getDefaultPrefix() : prefix),
+        report_changed_only_(report_changed_only),
+        max_bytes_per_datagram_(max_bytes_per_datagram) {
     tls_->set(
         [writer](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr { return writer; });
   }
 
   // Stats::Sink
   void flush(Stats::MetricSnapshot& snapshot) override;
+  // The datagrams are written with the writer of the flushing thread.
+  bool flushesOnAnyThread() const override { return true; }
   void onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) override;
 
   // Called in unit test to validate writer construction and address.
@@ -68,12 +82,26 @@ public:
 private:
   const std::string getName(const Stats::Metric& metric);
   const std::string buildTagStr(const std::vector<Stats::Tag>& tags);
+  /**
+   * Formats the line of a counter or gauge, adding it to the current datagram of the flush if it
+   * fits, or else starting the next one with it.
+   */
+  void addFlushLine(const Stats::Metric& metric, uint64_t value, char type);
 
   ThreadLocal::SlotPtr tls_;
   Network::Address::InstanceConstSharedPtr server_address_;
   const bool use_tag_;
   // Prefix for all flushed stats.
   const std::string prefix_;
+  // Whether only the counters and gauges which changed since the previous flush are flushed.
+  const bool report_changed_only_;
+  // The lines of a flush are packed in datagrams of up to this size. 0 sends one line per datagram.
+  const uint64_t max_bytes_per_datagram_;
+  // Reused across flushes, which all happen on the main thread, so that formatting the lines does
+  // not allocate: the lines of the flush, and the end offset of each datagram in flush_buffer_.
+  fmt::memory_buffer line_buffer_;
+  fmt::memory_buffer flush_buffer_;
+  std::vector<size_t> datagram_ends_;
 };
 
 /**
@@ -83,10 +111,13 @@ class TcpStatsdSink : public Stats::Sink {
 public:
   TcpStatsdSink(const LocalInfo::LocalInfo& local_info, const std::string& cluster_name,
                 ThreadLocal::SlotAllocator& tls, Upstream::ClusterManager& cluster_manager,
-                Stats::Scope& scope, const std::string& prefix = getDefaultPrefix());
+                Stats::Scope& scope, const std::string& prefix = getDefaultPrefix(),
+                const bool report_changed_only = false);
 
   // Stats::Sink
   void flush(Stats::MetricSnapshot& snapshot) override;
+  // The stats are written to the connection of the flushing thread.
+  bool flushesOnAnyThread() const override { return true; }
   void onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) override {
     // For statsd histograms are all timers.
     tls_->getTyped<TlsSink>().onTimespanComplete(histogram.name(),
@@ -131,6 +162,8 @@ private:
 
   // Prefix for all flushed stats.
   const std::string prefix_;
+  // Whether only the counters and gauges which changed since the previous flush are flushed.
+  const bool report_changed_only_;
 
   Upstream::ClusterInfoConstSharedPtr cluster_info_;
   ThreadLocal::SlotPtr tls_;
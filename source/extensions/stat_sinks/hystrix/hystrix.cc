@@ -23,8 +23,32 @@ namespace StatSinks {
 namespace Hystrix {
 
 const uint64_t HystrixSink::DEFAULT_NUM_BUCKETS;
-ClusterStatsCache::ClusterStatsCache(const std::string& cluster_name)
-    : cluster_name_(cluster_name) {}
+
+ClusterStatNames::ClusterStatNames(Stats::StatNamePool& pool)
+    : membership_total_(pool.add("membership_total")),
+      retry_upstream_rq_4xx_(pool.add("retry.upstream_rq_4xx")),
+      retry_upstream_rq_5xx_(pool.add("retry.upstream_rq_5xx")),
+      upstream_rq_2xx_(pool.add("upstream_rq_2xx")), upstream_rq_4xx_(pool.add("upstream_rq_4xx")),
+      upstream_rq_5xx_(pool.add("upstream_rq_5xx")) {}
+
+ClusterStatsCache::ClusterStatsCache(Upstream::ClusterInfoConstSharedPtr cluster_info,
+                                     const ClusterStatNames& stat_names)
+    : cluster_name_(cluster_info->name()) {
+  setClusterInfo(std::move(cluster_info), stat_names);
+}
+
+void ClusterStatsCache::setClusterInfo(Upstream::ClusterInfoConstSharedPtr cluster_info,
+                                       const ClusterStatNames& stat_names) {
+  Stats::Scope& scope = cluster_info->statsScope();
+  membership_total_ =
+      &scope.gaugeFromStatName(stat_names.membership_total_, Stats::Gauge::ImportMode::Accumulate);
+  retry_upstream_rq_4xx_ = &scope.counterFromStatName(stat_names.retry_upstream_rq_4xx_);
+  retry_upstream_rq_5xx_ = &scope.counterFromStatName(stat_names.retry_upstream_rq_5xx_);
+  upstream_rq_2xx_ = &scope.counterFromStatName(stat_names.upstream_rq_2xx_);
+  upstream_rq_4xx_ = &scope.counterFromStatName(stat_names.upstream_rq_4xx_);
+  upstream_rq_5xx_ = &scope.counterFromStatName(stat_names.upstream_rq_5xx_);
+  cluster_info_ = std::move(cluster_info);
+}
 
 void ClusterStatsCache::printToStream(std::stringstream& out_str) {
   const std::string cluster_name_prefix = absl::StrCat(cluster_name_, ".");
@@ -36,26 +60,26 @@ void ClusterStatsCache::printToStream(std::stringstream& out_str) {
   printRollingWindow(absl::StrCat(cluster_name_prefix, "total"), total_, out_str);
 }
 
-void ClusterStatsCache::printRollingWindow(absl::string_view name, RollingWindow rolling_window,
+void ClusterStatsCache::printRollingWindow(absl::string_view name,
+                                           const RollingWindow& rolling_window,
                                            std::stringstream& out_str) {
   out_str << name << " | ";
-  for (uint64_t& specific_stat_vec_itr : rolling_window) {
+  for (const uint64_t specific_stat_vec_itr : rolling_window) {
     out_str << specific_stat_vec_itr << " | ";
   }
   out_str << std::endl;
 }
 
 void HystrixSink::addHistogramToStream(const QuantileLatencyMap& latency_map, absl::string_view key,
-                                       std::stringstream& ss) {
-  // TODO: Consider if we better use join here
-  ss << ", \"" << key << "\": {";
+                                       std::string& out) {
+  absl::StrAppend(&out, ", \"", key, "\": {");
   bool is_first = true;
   for (const std::pair<double, double>& element : latency_map) {
     const std::string quantile = fmt::sprintf("%g", element.first * 100);
-    HystrixSink::addDoubleToStream(quantile, element.second, ss, is_first);
+    HystrixSink::addDoubleToStream(quantile, element.second, out, is_first);
     is_first = false;
   }
-  ss << "}";
+  out.push_back('}');
 }
 
 // Add new value to rolling window, in place of oldest one.
@@ -67,7 +91,7 @@ void HystrixSink::pushNewValue(RollingWindow& rolling_window, uint64_t value) {
   }
 }
 
-uint64_t HystrixSink::getRollingValue(RollingWindow rolling_window) {
+uint64_t HystrixSink::getRollingValue(const RollingWindow& rolling_window) {
 
   if (rolling_window.empty()) {
     return 0;
@@ -81,10 +105,8 @@ uint64_t HystrixSink::getRollingValue(RollingWindow rolling_window) {
   }
 }
 
-void HystrixSink::updateRollingWindowMap(const Upstream::ClusterInfo& cluster_info,
-                                         ClusterStatsCache& cluster_stats_cache) {
-  Upstream::ClusterStats& cluster_stats = cluster_info.stats();
-  Stats::Scope& cluster_stats_scope = cluster_info.statsScope();
+void HystrixSink::updateRollingWindowMap(ClusterStatsCache& cluster_stats_cache) {
+  Upstream::ClusterStats& cluster_stats = cluster_stats_cache.cluster_info_->stats();
 
   // Combining timeouts+retries - retries are counted  as separate requests
   // (alternative: each request including the retries counted as 1).
@@ -97,15 +119,15 @@ void HystrixSink::updateRollingWindowMap(const Upstream::ClusterInfo& cluster_in
   // (alternative: each request including the retries counted as 1)
   // since timeouts are 504 (or 408), deduce them from here ("-" sign).
   // Timeout retries were not counted here anyway.
-  uint64_t errors = cluster_stats_scope.counterFromStatName(upstream_rq_5xx_).value() +
-                    cluster_stats_scope.counterFromStatName(retry_upstream_rq_5xx_).value() +
-                    cluster_stats_scope.counterFromStatName(upstream_rq_4xx_).value() +
-                    cluster_stats_scope.counterFromStatName(retry_upstream_rq_4xx_).value() -
+  uint64_t errors = cluster_stats_cache.upstream_rq_5xx_->value() +
+                    cluster_stats_cache.retry_upstream_rq_5xx_->value() +
+                    cluster_stats_cache.upstream_rq_4xx_->value() +
+                    cluster_stats_cache.retry_upstream_rq_4xx_->value() -
                     cluster_stats.upstream_rq_timeout_.value();
 
   pushNewValue(cluster_stats_cache.errors_, errors);
 
-  uint64_t success = cluster_stats_scope.counterFromStatName(upstream_rq_2xx_).value();
+  uint64_t success = cluster_stats_cache.upstream_rq_2xx_->value();
   pushNewValue(cluster_stats_cache.success_, success);
 
   uint64_t rejected = cluster_stats.upstream_rq_pending_overflow_.value();
@@ -115,50 +137,41 @@ void HystrixSink::updateRollingWindowMap(const Upstream::ClusterInfo& cluster_in
   // leading to wrong results such as error percentage higher than 100%
   uint64_t total = errors + timeouts + success + rejected;
   pushNewValue(cluster_stats_cache.total_, total);
-
-  ENVOY_LOG(trace, "{}", printRollingWindows());
 }
 
 void HystrixSink::resetRollingWindow() { cluster_stats_cache_map_.clear(); }
 
 void HystrixSink::addStringToStream(absl::string_view key, absl::string_view value,
-                                    std::stringstream& info, bool is_first) {
-  std::string quoted_value = absl::StrCat("\"", value, "\"");
-  addInfoToStream(key, quoted_value, info, is_first);
+                                    std::string& out, bool is_first) {
+  absl::StrAppend(&out, is_first ? "" : ", ", "\"", key, "\": \"", value, "\"");
 }
 
-void HystrixSink::addIntToStream(absl::string_view key, uint64_t value, std::stringstream& info,
+void HystrixSink::addIntToStream(absl::string_view key, uint64_t value, std::string& out,
                                  bool is_first) {
-  addInfoToStream(key, std::to_string(value), info, is_first);
+  absl::StrAppend(&out, is_first ? "" : ", ", "\"", key, "\": ", value);
 }
 
-void HystrixSink::addDoubleToStream(absl::string_view key, double value, std::stringstream& info,
+void HystrixSink::addDoubleToStream(absl::string_view key, double value, std::string& out,
                                     bool is_first) {
-  addInfoToStream(key, std::to_string(value), info, is_first);
+  addInfoToStream(key, std::to_string(value), out, is_first);
 }
 
 void HystrixSink::addInfoToStream(absl::string_view key, absl::string_view value,
-                                  std::stringstream& info, bool is_first) {
-  if (!is_first) {
-    info << ", ";
-  }
-  std::string added_info = absl::StrCat("\"", key, "\": ", value);
-  info << added_info;
+                                  std::string& out, bool is_first) {
+  absl::StrAppend(&out, is_first ? "" : ", ", "\"", key, "\": ", value);
 }
 
 void HystrixSink::addHystrixCommand(ClusterStatsCache& cluster_stats_cache,
                                     absl::string_view cluster_name,
                                     uint64_t max_concurrent_requests, uint64_t reporting_hosts,
                                     std::chrono::milliseconds rolling_window_ms,
-                                    const QuantileLatencyMap& histogram, std::stringstream& ss) {
-
-  std::time_t currentTime = std::chrono::system_clock::to_time_t(server_.timeSource().systemTime());
-
-  ss << "data: {";
+                                    const QuantileLatencyMap& histogram, uint64_t current_time,
+                                    std::string& ss) {
+  ss.append("data: {");
   addStringToStream("type", "HystrixCommand", ss, true);
   addStringToStream("name", cluster_name, ss);
   addStringToStream("group", "NA", ss);
-  addIntToStream("currentTime", static_cast<uint64_t>(currentTime), ss);
+  addIntToStream("currentTime", current_time, ss);
   addInfoToStream("isCircuitBreakerOpen", "false", ss);
 
   uint64_t errors = getRollingValue(cluster_stats_cache.errors_);
@@ -211,15 +224,15 @@ void HystrixSink::addHystrixCommand(ClusterStatsCache& cluster_stats_cache,
   addIntToStream("propertyValue_metricsRollingStatisticalWindowInMilliseconds",
                  rolling_window_ms.count(), ss);
 
-  ss << "}" << std::endl << std::endl;
+  ss.append("}\n\n");
 }
 
 void HystrixSink::addHystrixThreadPool(absl::string_view cluster_name, uint64_t queue_size,
                                        uint64_t reporting_hosts,
                                        std::chrono::milliseconds rolling_window_ms,
-                                       std::stringstream& ss) {
+                                       std::string& ss) {
 
-  ss << "data: {";
+  ss.append("data: {");
   addIntToStream("currentPoolSize", 0, ss, true);
   addIntToStream("rollingMaxActiveThreads", 0, ss);
   addIntToStream("currentActiveCount", 0, ss);
@@ -237,7 +250,7 @@ void HystrixSink::addHystrixThreadPool(absl::string_view cluster_name, uint64_t
   addIntToStream("rollingCountThreadsExecuted", 0, ss);
   addIntToStream("currentMaximumPoolSize", 0, ss);
 
-  ss << "}" << std::endl << std::endl;
+  ss.append("}\n\n");
 }
 
 void HystrixSink::addClusterStatsToStream(ClusterStatsCache& cluster_stats_cache,
@@ -246,12 +259,12 @@ void HystrixSink::addClusterStatsToStream(ClusterStatsCache& cluster_stats_cache
                                           uint64_t reporting_hosts,
                                           std::chrono::milliseconds rolling_window_ms,
                                           const QuantileLatencyMap& histogram,
-                                          std::stringstream& ss) {
+                                          uint64_t current_time, std::string& out) {
 
   addHystrixCommand(cluster_stats_cache, cluster_name, max_concurrent_requests, reporting_hosts,
-                    rolling_window_ms, histogram, ss);
+                    rolling_window_ms, histogram, current_time, out);
   addHystrixThreadPool(cluster_name, max_concurrent_requests, reporting_hosts, rolling_window_ms,
-                       ss);
+                       out);
 }
 
 const std::string HystrixSink::printRollingWindows() {
@@ -269,12 +282,7 @@ HystrixSink::HystrixSink(Server::Instance& server, const uint64_t num_buckets)
       window_size_(current_index_ + 1), stat_name_pool_(server.stats().symbolTable()),
       cluster_name_(stat_name_pool_.add(Config::TagNames::get().CLUSTER_NAME)),
       cluster_upstream_rq_time_(stat_name_pool_.add("cluster.upstream_rq_time")),
-      membership_total_(stat_name_pool_.add("membership_total")),
-      retry_upstream_rq_4xx_(stat_name_pool_.add("retry.upstream_rq_4xx")),
-      retry_upstream_rq_5xx_(stat_name_pool_.add("retry.upstream_rq_5xx")),
-      upstream_rq_2xx_(stat_name_pool_.add("upstream_rq_2xx")),
-      upstream_rq_4xx_(stat_name_pool_.add("upstream_rq_4xx")),
-      upstream_rq_5xx_(stat_name_pool_.add("upstream_rq_5xx")) {
+      cluster_stat_names_(stat_name_pool_) {
   Server::Admin& admin = server_.admin();
   ENVOY_LOG(debug,
             "adding hystrix_event_stream endpoint to enable connection to hystrix dashboard");
@@ -328,7 +336,6 @@ void HystrixSink::flush(Stats::MetricSnapshot& snapshot) {
     return;
   }
   incCounter();
-  std::stringstream ss;
   Upstream::ClusterManager::ClusterInfoMap clusters = server_.clusterManager().clusters();
 
   // Save a map of the relevant histograms per cluster in a convenient format.
@@ -360,31 +367,39 @@ void HystrixSink::flush(Stats::MetricSnapshot& snapshot) {
     }
   }
 
+  const uint64_t current_time =
+      std::chrono::system_clock::to_time_t(server_.timeSource().systemTime());
+  const QuantileLatencyMap no_histogram;
+  event_stream_.clear();
   for (auto& cluster : clusters) {
     Upstream::ClusterInfoConstSharedPtr cluster_info = cluster.second.get().info();
 
     std::unique_ptr<ClusterStatsCache>& cluster_stats_cache_ptr =
         cluster_stats_cache_map_[cluster_info->name()];
     if (cluster_stats_cache_ptr == nullptr) {
-      cluster_stats_cache_ptr = std::make_unique<ClusterStatsCache>(cluster_info->name());
+      cluster_stats_cache_ptr =
+          std::make_unique<ClusterStatsCache>(cluster_info, cluster_stat_names_);
+    } else if (cluster_stats_cache_ptr->cluster_info_ != cluster_info) {
+      cluster_stats_cache_ptr->setClusterInfo(cluster_info, cluster_stat_names_);
     }
 
     // update rolling window with cluster stats
-    updateRollingWindowMap(*cluster_info, *cluster_stats_cache_ptr);
+    updateRollingWindowMap(*cluster_stats_cache_ptr);
 
     // append it to stream to be sent
+    const auto histogram = time_histograms.find(cluster_info->name());
     addClusterStatsToStream(
         *cluster_stats_cache_ptr, cluster_info->name(),
         cluster_info->resourceManager(Upstream::ResourcePriority::Default).pendingRequests().max(),
-        cluster_info->statsScope()
-            .gaugeFromStatName(membership_total_, Stats::Gauge::ImportMode::Accumulate)
-            .value(),
-        server_.statsFlushInterval(), time_histograms[cluster_info->name()], ss);
+        cluster_stats_cache_ptr->membership_total_->value(), server_.statsFlushInterval(),
+        histogram != time_histograms.end() ? histogram->second : no_histogram, current_time,
+        event_stream_);
   }
+  ENVOY_LOG(trace, "{}", printRollingWindows());
 
   Buffer::OwnedImpl data;
   for (auto callbacks : callbacks_list_) {
-    data.add(ss.str());
+    data.add(event_stream_);
     callbacks->encodeData(data, false);
   }
 
@@ -8,6 +8,7 @@
 #include "envoy/server/instance.h"
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/sink.h"
+#include "envoy/upstream/upstream.h"
 
 #include "common/stats/symbol_table_impl.h"
 
@@ -27,13 +28,43 @@ struct {
   const std::string AllowHeadersHystrix{"Accept, Cache-Control, X-Requested-With, Last-Event-ID"};
 } AccessControlAllowHeadersValue;
 
+/**
+ * The names of the cluster stats read on each flush, relative to the scope of the cluster.
+ */
+struct ClusterStatNames {
+  explicit ClusterStatNames(Stats::StatNamePool& pool);
+
+  const Stats::StatName membership_total_;
+  const Stats::StatName retry_upstream_rq_4xx_;
+  const Stats::StatName retry_upstream_rq_5xx_;
+  const Stats::StatName upstream_rq_2xx_;
+  const Stats::StatName upstream_rq_4xx_;
+  const Stats::StatName upstream_rq_5xx_;
+};
+
 struct ClusterStatsCache {
-  ClusterStatsCache(const std::string& cluster_name);
+  ClusterStatsCache(Upstream::ClusterInfoConstSharedPtr cluster_info,
+                    const ClusterStatNames& stat_names);
+
+  /**
+   * Looks up the stats of a cluster, so that the flushes read them without looking them up. The
+   * rolling windows are kept, as a cluster updated by CDS keeps its stats.
+   */
+  void setClusterInfo(Upstream::ClusterInfoConstSharedPtr cluster_info,
+                      const ClusterStatNames& stat_names);
 
   void printToStream(std::stringstream& out_str);
-  void printRollingWindow(absl::string_view name, RollingWindow rolling_window,
+  void printRollingWindow(absl::string_view name, const RollingWindow& rolling_window,
                           std::stringstream& out_str);
   std::string cluster_name_;
+  // Held so that the stats it scopes outlive the pointers below.
+  Upstream::ClusterInfoConstSharedPtr cluster_info_;
+  Stats::Gauge* membership_total_{};
+  Stats::Counter* retry_upstream_rq_4xx_{};
+  Stats::Counter* retry_upstream_rq_5xx_{};
+  Stats::Counter* upstream_rq_2xx_{};
+  Stats::Counter* upstream_rq_4xx_{};
+  Stats::Counter* upstream_rq_5xx_{};
 
   // Rolling windows
   RollingWindow errors_;
@@ -51,6 +82,8 @@ public:
   Http::Code handlerHystrixEventStream(absl::string_view, Http::HeaderMap& response_headers,
                                        Buffer::Instance&, Server::AdminStream& admin_stream);
   void flush(Stats::MetricSnapshot& snapshot) override;
+  // The admin streams belong to the main thread.
+  bool flushesOnAnyThread() const override { return false; }
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override{};
 
   /**
@@ -80,13 +113,13 @@ public:
                                absl::string_view cluster_name, uint64_t max_concurrent_requests,
                                uint64_t reporting_hosts,
                                std::chrono::milliseconds rolling_window_ms,
-                               const QuantileLatencyMap& histogram, std::stringstream& ss);
+                               const QuantileLatencyMap& histogram, uint64_t current_time,
+                               std::string& out);
 
   /**
    * Calculate values needed to create the stream and write into the map.
    */
-  void updateRollingWindowMap(const Upstream::ClusterInfo& cluster_info,
-                              ClusterStatsCache& cluster_stats_cache);
+  void updateRollingWindowMap(ClusterStatsCache& cluster_stats_cache);
   /**
    * Clear map.
    */
@@ -100,37 +133,37 @@ public:
   /**
    * Get the statistic's value change over the rolling window time frame.
    */
-  uint64_t getRollingValue(RollingWindow rolling_window);
+  uint64_t getRollingValue(const RollingWindow& rolling_window);
 
   /**
-   * Format the given key and value to "key"=value, and adding to the stringstream.
+   * Format the given key and value to "key"=value, and append it to the output.
    */
-  static void addInfoToStream(absl::string_view key, absl::string_view value,
-                              std::stringstream& info, bool is_first = false);
+  static void addInfoToStream(absl::string_view key, absl::string_view value, std::string& out,
+                              bool is_first = false);
 
   /**
-   * Format the given key and double value to "key"=<string of uint64_t>, and adding to the
-   * stringstream.
+   * Format the given key and double value to "key"=<string of double>, and append it to the
+   * output.
    */
-  static void addDoubleToStream(absl::string_view key, double value, std::stringstream& info,
+  static void addDoubleToStream(absl::string_view key, double value, std::string& out,
                                 bool is_first);
 
   /**
-   * Format the given key and absl::string_view value to "key"="value", and adding to the
-   * stringstream.
+   * Format the given key and absl::string_view value to "key"="value", and append it to the
+   * output.
    */
-  static void addStringToStream(absl::string_view key, absl::string_view value,
-                                std::stringstream& info, bool is_first = false);
+  static void addStringToStream(absl::string_view key, absl::string_view value, std::string& out,
+                                bool is_first = false);
 
   /**
-   * Format the given key and uint64_t value to "key"=<string of uint64_t>, and adding to the
-   * stringstream.
+   * Format the given key and uint64_t value to "key"=<string of uint64_t>, and append it to the
+   * output.
    */
-  static void addIntToStream(absl::string_view key, uint64_t value, std::stringstream& info,
+  static void addIntToStream(absl::string_view key, uint64_t value, std::string& out,
                              bool is_first = false);
 
   static void addHistogramToStream(const QuantileLatencyMap& latency_map, absl::string_view key,
-                                   std::stringstream& ss);
+                                   std::string& out);
 
 private:
   /**
@@ -139,14 +172,15 @@ private:
   void addHystrixCommand(ClusterStatsCache& cluster_stats_cache, absl::string_view cluster_name,
                          uint64_t max_concurrent_requests, uint64_t reporting_hosts,
                          std::chrono::milliseconds rolling_window_ms,
-                         const QuantileLatencyMap& histogram, std::stringstream& ss);
+                         const QuantileLatencyMap& histogram, uint64_t current_time,
+                         std::string& out);
 
   /**
    * Generate HystrixThreadPool event stream.
    */
   void addHystrixThreadPool(absl::string_view cluster_name, uint64_t queue_size,
                             uint64_t reporting_hosts, std::chrono::milliseconds rolling_window_ms,
-                            std::stringstream& ss);
+                            std::string& out);
 
   std::vector<Http::StreamDecoderFilterCallbacks*> callbacks_list_;
   Server::Instance& server_;
@@ -161,12 +195,10 @@ private:
   Stats::StatNamePool stat_name_pool_;
   const Stats::StatName cluster_name_;
   const Stats::StatName cluster_upstream_rq_time_;
-  const Stats::StatName membership_total_;
-  const Stats::StatName retry_upstream_rq_4xx_;
-  const Stats::StatName retry_upstream_rq_5xx_;
-  const Stats::StatName upstream_rq_2xx_;
-  const Stats::StatName upstream_rq_4xx_;
-  const Stats::StatName upstream_rq_5xx_;
+  const ClusterStatNames cluster_stat_names_;
+
+  // The event stream of the last flush, kept so that its capacity is reused by the next one.
+  std::string event_stream_;
 };
 
 using HystrixSinkPtr = std::unique_ptr<HystrixSink>;
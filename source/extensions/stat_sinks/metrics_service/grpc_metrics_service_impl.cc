@@ -33,8 +33,9 @@ void GrpcMetricsStreamerImpl::send(envoy::service::metrics::v2::StreamMetricsMes
 }
 
 MetricsServiceSink::MetricsServiceSink(const GrpcMetricsStreamerSharedPtr& grpc_metrics_streamer,
-                                       TimeSource& time_source)
-    : grpc_metrics_streamer_(grpc_metrics_streamer), time_source_(time_source) {}
+                                       TimeSource& time_source, bool report_changed_only)
+    : grpc_metrics_streamer_(grpc_metrics_streamer), time_source_(time_source),
+      report_changed_only_(report_changed_only) {}
 
 void MetricsServiceSink::flushCounter(const Stats::Counter& counter) {
   io::prometheus::client::MetricFamily* metrics_family = message_.add_envoy_metrics();
@@ -80,18 +81,21 @@ void MetricsServiceSink::flushHistogram(const Stats::ParentHistogram& histogram)
 void MetricsServiceSink::flush(Stats::MetricSnapshot& snapshot) {
   message_.clear_envoy_metrics();
 
+  const auto& counters = report_changed_only_ ? snapshot.changedCounters() : snapshot.counters();
+  const auto& gauges = report_changed_only_ ? snapshot.changedGauges() : snapshot.gauges();
+
   // TODO(mrice32): there's probably some more sophisticated preallocation we can do here where we
   // actually preallocate the submessages and then pass ownership to the proto (rather than just
   // preallocating the pointer array).
-  message_.mutable_envoy_metrics()->Reserve(snapshot.counters().size() + snapshot.gauges().size() +
+  message_.mutable_envoy_metrics()->Reserve(counters.size() + gauges.size() +
                                             snapshot.histograms().size());
-  for (const auto& counter : snapshot.counters()) {
+  for (const auto& counter : counters) {
     if (counter.counter_.get().used()) {
       flushCounter(counter.counter_.get());
     }
   }
 
-  for (const auto& gauge : snapshot.gauges()) {
+  for (const auto& gauge : gauges) {
     if (gauge.get().used()) {
       flushGauge(gauge.get());
     }
@@ -74,8 +74,10 @@ class MetricsServiceSink : public Stats::Sink {
 public:
   // MetricsService::Sink
   MetricsServiceSink(const GrpcMetricsStreamerSharedPtr& grpc_metrics_streamer,
-                     TimeSource& time_system);
+                     TimeSource& time_system, bool report_changed_only = false);
   void flush(Stats::MetricSnapshot& snapshot) override;
+  // The gRPC stream belongs to the main thread.
+  bool flushesOnAnyThread() const override { return false; }
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
 
   void flushCounter(const Stats::Counter& counter);
@@ -86,6 +88,8 @@ private:
   GrpcMetricsStreamerSharedPtr grpc_metrics_streamer_;
   envoy::service::metrics::v2::StreamMetricsMessage message_;
   TimeSource& time_source_;
+  // Whether only the counters and gauges which changed since the previous flush are flushed.
+  const bool report_changed_only_;
 };
 
 } // namespace MetricsService
@@ -85,8 +85,8 @@ private:
 } // namespace
 
 OpenTracingSpan::OpenTracingSpan(OpenTracingDriver& driver,
-                                 std::unique_ptr<opentracing::Span>&& span)
-    : driver_{driver}, span_(std::move(span)) {}
+                                 std::unique_ptr<opentracing::Span>&& span, bool sampled)
+    : driver_{driver}, span_(std::move(span)), sampled_(sampled) {}
 
 void OpenTracingSpan::finishSpan() { span_->FinishWithOptions(finish_options_); }
 
@@ -133,6 +133,7 @@ void OpenTracingSpan::injectContext(Http::HeaderMap& request_headers) {
 
 void OpenTracingSpan::setSampled(bool sampled) {
   span_->SetTag(opentracing::ext::sampling_priority, sampled ? 1 : 0);
+  sampled_ = sampled;
 }
 
 Tracing::SpanPtr OpenTracingSpan::spawnChild(const Tracing::Config&, const std::string& name,
@@ -140,7 +141,7 @@ Tracing::SpanPtr OpenTracingSpan::spawnChild(const Tracing::Config&, const std::
   std::unique_ptr<opentracing::Span> ot_span = span_->tracer().StartSpan(
       name, {opentracing::ChildOf(&span_->context()), opentracing::StartTimestamp(start_time)});
   RELEASE_ASSERT(ot_span != nullptr, "");
-  return Tracing::SpanPtr{new OpenTracingSpan{driver_, std::move(ot_span)}};
+  return Tracing::SpanPtr{new OpenTracingSpan{driver_, std::move(ot_span), sampled_}};
 }
 
 OpenTracingDriver::OpenTracingDriver(Stats::Store& stats)
@@ -200,7 +201,8 @@ Tracing::SpanPtr OpenTracingDriver::startSpan(const Tracing::Config& config,
                       config.operationName() == Tracing::OperationName::Egress
                           ? opentracing::ext::span_kind_rpc_client
                           : opentracing::ext::span_kind_rpc_server);
-  return Tracing::SpanPtr{new OpenTracingSpan{*this, std::move(active_span)}};
+  return Tracing::SpanPtr{
+      new OpenTracingSpan{*this, std::move(active_span), tracing_decision.traced}};
 }
 
 } // namespace Ot
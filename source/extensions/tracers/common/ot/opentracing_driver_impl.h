@@ -29,7 +29,8 @@ class OpenTracingDriver;
 
 class OpenTracingSpan : public Tracing::Span, Logger::Loggable<Logger::Id::tracing> {
 public:
-  OpenTracingSpan(OpenTracingDriver& driver, std::unique_ptr<opentracing::Span>&& span);
+  OpenTracingSpan(OpenTracingDriver& driver, std::unique_ptr<opentracing::Span>&& span,
+                  bool sampled);
 
   // Tracing::Span
   void finishSpan() override;
@@ -40,11 +41,14 @@ public:
   Tracing::SpanPtr spawnChild(const Tracing::Config& config, const std::string& name,
                               SystemTime start_time) override;
   void setSampled(bool) override;
+  bool sampled() const override { return sampled_; }
 
 private:
   OpenTracingDriver& driver_;
   opentracing::FinishSpanOptions finish_options_;
   std::unique_ptr<opentracing::Span> span_;
+  // The sampling priority last set on the span, which the tracer reports the span by.
+  bool sampled_;
 };
 
 /**
@@ -62,6 +62,7 @@ public:
   Tracing::SpanPtr spawnChild(const Tracing::Config& config, const std::string& name,
                               SystemTime start_time) override;
   void setSampled(bool sampled) override;
+  bool sampled() const override { return span_.context().trace_options().IsSampled(); }
 
 private:
   ::opencensus::trace::Span span_;
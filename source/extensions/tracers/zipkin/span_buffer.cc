@@ -7,7 +7,7 @@ namespace Zipkin {
 
 // TODO(fabolive): Need to avoid the copy to improve performance.
 bool SpanBuffer::addSpan(const Span& span) {
-  if (span_buffer_.size() == span_buffer_.capacity()) {
+  if (span_buffer_.size() >= max_size_) {
     // Buffer full
     return false;
   }
@@ -17,19 +17,16 @@ bool SpanBuffer::addSpan(const Span& span) {
 }
 
 std::string SpanBuffer::toStringifiedJsonArray() {
-  std::string stringified_json_array = "[";
-
-  if (pendingSpans()) {
-    stringified_json_array += span_buffer_[0].toJson();
-    const uint64_t size = span_buffer_.size();
-    for (uint64_t i = 1; i < size; i++) {
-      stringified_json_array += ",";
-      stringified_json_array += span_buffer_[i].toJson();
-    }
+  // The spans are streamed into a single buffer, rather than serialized one by one and merged.
+  rapidjson::StringBuffer s;
+  JsonWriter writer(s);
+  writer.StartArray();
+  for (const Span& span : span_buffer_) {
+    span.writeJson(writer);
   }
-  stringified_json_array += "]";
+  writer.EndArray();
 
-  return stringified_json_array;
+  return std::string(s.GetString(), s.GetSize());
 }
 
 } // namespace Zipkin
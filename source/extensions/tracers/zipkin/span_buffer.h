@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+
 #include "extensions/tracers/zipkin/zipkin_core_types.h"
 
 namespace Envoy {
@@ -31,7 +33,19 @@ public:
    *
    * @param size The desired buffer size.
    */
-  void allocateBuffer(uint64_t size) { span_buffer_.reserve(size); }
+  void allocateBuffer(uint64_t size) { allocateBuffer(size, size); }
+
+  /**
+   * Allocates space for an empty buffer or resizes a previously-allocated one, letting it grow
+   * past the allocated size, e.g. while the previous flush is still in flight.
+   *
+   * @param size The desired buffer size.
+   * @param max_size The number of spans past which the buffer is full.
+   */
+  void allocateBuffer(uint64_t size, uint64_t max_size) {
+    span_buffer_.reserve(size);
+    max_size_ = std::max(size, max_size);
+  }
 
   /**
    * Adds the given Zipkin span to the buffer.
@@ -62,6 +76,7 @@ public:
 private:
   // We use a pre-allocated vector to improve performance
   std::vector<Span> span_buffer_;
+  uint64_t max_size_{};
 };
 
 } // namespace Zipkin
@@ -7,9 +7,6 @@
 #include "extensions/tracers/zipkin/zipkin_core_constants.h"
 #include "extensions/tracers/zipkin/zipkin_json_field_names.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 namespace Envoy {
 namespace Extensions {
 namespace Tracers {
@@ -28,7 +25,12 @@ Endpoint& Endpoint::operator=(const Endpoint& ep) {
 
 const std::string Endpoint::toJson() {
   rapidjson::StringBuffer s;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+  JsonWriter writer(s);
+  writeJson(writer);
+  return s.GetString();
+}
+
+void Endpoint::writeJson(JsonWriter& writer) const {
   writer.StartObject();
   if (!address_) {
     writer.Key(ZipkinJsonFieldNames::get().ENDPOINT_IPV4.c_str());
@@ -50,9 +52,6 @@ const std::string Endpoint::toJson() {
   writer.Key(ZipkinJsonFieldNames::get().ENDPOINT_SERVICE_NAME.c_str());
   writer.String(service_name_.c_str());
   writer.EndObject();
-  std::string json_string = s.GetString();
-
-  return json_string;
 }
 
 Annotation::Annotation(const Annotation& ann) {
@@ -81,22 +80,22 @@ void Annotation::changeEndpointServiceName(const std::string& service_name) {
 
 const std::string Annotation::toJson() {
   rapidjson::StringBuffer s;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+  JsonWriter writer(s);
+  writeJson(writer);
+  return s.GetString();
+}
+
+void Annotation::writeJson(JsonWriter& writer) const {
   writer.StartObject();
   writer.Key(ZipkinJsonFieldNames::get().ANNOTATION_TIMESTAMP.c_str());
   writer.Uint64(timestamp_);
   writer.Key(ZipkinJsonFieldNames::get().ANNOTATION_VALUE.c_str());
   writer.String(value_.c_str());
-  writer.EndObject();
-
-  std::string json_string = s.GetString();
-
   if (endpoint_) {
-    Util::mergeJsons(json_string, static_cast<Endpoint>(endpoint_.value()).toJson(),
-                     ZipkinJsonFieldNames::get().ANNOTATION_ENDPOINT);
+    writer.Key(ZipkinJsonFieldNames::get().ANNOTATION_ENDPOINT.c_str());
+    endpoint_.value().writeJson(writer);
   }
-
-  return json_string;
+  writer.EndObject();
 }
 
 BinaryAnnotation::BinaryAnnotation(const BinaryAnnotation& ann) {
@@ -121,22 +120,22 @@ BinaryAnnotation& BinaryAnnotation::operator=(const BinaryAnnotation& ann) {
 
 const std::string BinaryAnnotation::toJson() {
   rapidjson::StringBuffer s;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+  JsonWriter writer(s);
+  writeJson(writer);
+  return s.GetString();
+}
+
+void BinaryAnnotation::writeJson(JsonWriter& writer) const {
   writer.StartObject();
   writer.Key(ZipkinJsonFieldNames::get().BINARY_ANNOTATION_KEY.c_str());
   writer.String(key_.c_str());
   writer.Key(ZipkinJsonFieldNames::get().BINARY_ANNOTATION_VALUE.c_str());
   writer.String(value_.c_str());
-  writer.EndObject();
-
-  std::string json_string = s.GetString();
-
   if (endpoint_) {
-    Util::mergeJsons(json_string, static_cast<Endpoint>(endpoint_.value()).toJson(),
-                     ZipkinJsonFieldNames::get().BINARY_ANNOTATION_ENDPOINT);
+    writer.Key(ZipkinJsonFieldNames::get().BINARY_ANNOTATION_ENDPOINT.c_str());
+    endpoint_.value().writeJson(writer);
   }
-
-  return json_string;
+  writer.EndObject();
 }
 
 const std::string Span::EMPTY_HEX_STRING_ = "0000000000000000";
@@ -173,7 +172,12 @@ void Span::setServiceName(const std::string& service_name) {
 
 const std::string Span::toJson() {
   rapidjson::StringBuffer s;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+  JsonWriter writer(s);
+  writeJson(writer);
+  return s.GetString();
+}
+
+void Span::writeJson(JsonWriter& writer) const {
   writer.StartObject();
   writer.Key(ZipkinJsonFieldNames::get().SPAN_TRACE_ID.c_str());
   writer.String(traceIdAsHexString().c_str());
@@ -197,26 +201,21 @@ const std::string Span::toJson() {
     writer.Int64(duration_.value());
   }
 
-  writer.EndObject();
-
-  std::string json_string = s.GetString();
-
-  std::vector<std::string> annotation_json_vector;
-
-  for (auto& annotation : annotations_) {
-    annotation_json_vector.push_back(annotation.toJson());
+  writer.Key(ZipkinJsonFieldNames::get().SPAN_ANNOTATIONS.c_str());
+  writer.StartArray();
+  for (const Annotation& annotation : annotations_) {
+    annotation.writeJson(writer);
   }
-  Util::addArrayToJson(json_string, annotation_json_vector,
-                       ZipkinJsonFieldNames::get().SPAN_ANNOTATIONS);
+  writer.EndArray();
 
-  std::vector<std::string> binary_annotation_json_vector;
-  for (auto& binary_annotation : binary_annotations_) {
-    binary_annotation_json_vector.push_back(binary_annotation.toJson());
+  writer.Key(ZipkinJsonFieldNames::get().SPAN_BINARY_ANNOTATIONS.c_str());
+  writer.StartArray();
+  for (const BinaryAnnotation& binary_annotation : binary_annotations_) {
+    binary_annotation.writeJson(writer);
   }
-  Util::addArrayToJson(json_string, binary_annotation_json_vector,
-                       ZipkinJsonFieldNames::get().SPAN_BINARY_ANNOTATIONS);
+  writer.EndArray();
 
-  return json_string;
+  writer.EndObject();
 }
 
 void Span::finish() {
@@ -13,12 +13,19 @@
 
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
 
 namespace Envoy {
 namespace Extensions {
 namespace Tracers {
 namespace Zipkin {
 
+/**
+ * Writer streaming the JSON representation of spans into a single buffer.
+ */
+using JsonWriter = rapidjson::Writer<rapidjson::StringBuffer>;
+
 /**
  * Base class to be inherited by all classes that represent Zipkin-related concepts, namely:
  * endpoint, annotation, binary annotation, and span.
@@ -94,6 +101,11 @@ public:
    */
   const std::string toJson() override;
 
+  /**
+   * Serializes the endpoint as a Zipkin-compliant JSON representation into the given writer.
+   */
+  void writeJson(JsonWriter& writer) const;
+
 private:
   std::string service_name_;
   Network::Address::InstanceConstSharedPtr address_;
@@ -186,6 +198,11 @@ public:
    */
   const std::string toJson() override;
 
+  /**
+   * Serializes the annotation as a Zipkin-compliant JSON representation into the given writer.
+   */
+  void writeJson(JsonWriter& writer) const;
+
 private:
   uint64_t timestamp_{0};
   std::string value_;
@@ -284,6 +301,12 @@ public:
    */
   const std::string toJson() override;
 
+  /**
+   * Serializes the binary annotation as a Zipkin-compliant JSON representation into the given
+   * writer.
+   */
+  void writeJson(JsonWriter& writer) const;
+
 private:
   std::string key_;
   std::string value_;
@@ -518,6 +541,11 @@ public:
    */
   const std::string toJson() override;
 
+  /**
+   * Serializes the span as a Zipkin-compliant JSON representation into the given writer.
+   */
+  void writeJson(JsonWriter& writer) const;
+
   /**
    * Associates a Tracer object with the span. The tracer's reportSpan() method is invoked
    * by the span's finish() method so that the tracer can decide what to do with the span
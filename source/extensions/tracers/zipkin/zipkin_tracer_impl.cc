@@ -135,11 +135,19 @@ ReporterImpl::ReporterImpl(Driver& driver, Event::Dispatcher& dispatcher,
 
   const uint64_t min_flush_spans =
       driver_.runtime().snapshot().getInteger("tracing.zipkin.min_flush_spans", 5U);
-  span_buffer_.allocateBuffer(min_flush_spans);
+  const uint64_t max_buffered_spans =
+      driver_.runtime().snapshot().getInteger("tracing.zipkin.max_buffered_spans", 1000U);
+  span_buffer_.allocateBuffer(min_flush_spans, max_buffered_spans);
 
   enableTimer();
 }
 
+ReporterImpl::~ReporterImpl() {
+  if (active_request_ != nullptr) {
+    active_request_->cancel();
+  }
+}
+
 ReporterPtr ReporterImpl::NewInstance(Driver& driver, Event::Dispatcher& dispatcher,
                                       const std::string& collector_endpoint) {
   return ReporterPtr(new ReporterImpl(driver, dispatcher, collector_endpoint));
@@ -147,12 +155,14 @@ ReporterPtr ReporterImpl::NewInstance(Driver& driver, Event::Dispatcher& dispatc
 
 // TODO(fabolive): Need to avoid the copy to improve performance.
 void ReporterImpl::reportSpan(const Span& span) {
-  span_buffer_.addSpan(span);
+  if (!span_buffer_.addSpan(span)) {
+    driver_.tracerStats().spans_dropped_.inc();
+  }
 
   const uint64_t min_flush_spans =
       driver_.runtime().snapshot().getInteger("tracing.zipkin.min_flush_spans", 5U);
 
-  if (span_buffer_.pendingSpans() == min_flush_spans) {
+  if (span_buffer_.pendingSpans() >= min_flush_spans) {
     flushSpans();
   }
 }
@@ -164,10 +174,12 @@ void ReporterImpl::enableTimer() {
 }
 
 void ReporterImpl::flushSpans() {
-  if (span_buffer_.pendingSpans()) {
+  if (span_buffer_.pendingSpans() && active_request_ == nullptr) {
     driver_.tracerStats().spans_sent_.add(span_buffer_.pendingSpans());
 
     const std::string request_body = span_buffer_.toStringifiedJsonArray();
+    // Cleared before sending, as a request failing inline completes within send().
+    span_buffer_.clear();
     Http::MessagePtr message(new Http::RequestMessageImpl());
     message->headers().insertMethod().value().setReference(Http::Headers::get().MethodValues.Post);
     message->headers().insertPath().value(collector_endpoint_);
@@ -181,17 +193,26 @@ void ReporterImpl::flushSpans() {
 
     const uint64_t timeout =
         driver_.runtime().snapshot().getInteger("tracing.zipkin.request_timeout", 5000U);
-    driver_.clusterManager()
-        .httpAsyncClientForCluster(driver_.cluster()->name())
-        .send(std::move(message), *this,
-              Http::AsyncClient::RequestOptions().setTimeout(std::chrono::milliseconds(timeout)));
+    active_request_ = driver_.clusterManager()
+                          .httpAsyncClientForCluster(driver_.cluster()->name())
+                          .send(std::move(message), *this,
+                                Http::AsyncClient::RequestOptions().setTimeout(
+                                    std::chrono::milliseconds(timeout)));
+  }
+}
 
-    span_buffer_.clear();
+void ReporterImpl::onReportComplete() {
+  active_request_ = nullptr;
+  if (span_buffer_.pendingSpans() &&
+      span_buffer_.pendingSpans() >=
+          driver_.runtime().snapshot().getInteger("tracing.zipkin.min_flush_spans", 5U)) {
+    flushSpans();
   }
 }
 
 void ReporterImpl::onFailure(Http::AsyncClient::FailureReason) {
   driver_.tracerStats().reports_failed_.inc();
+  onReportComplete();
 }
 
 void ReporterImpl::onSuccess(Http::MessagePtr&& http_response) {
@@ -201,6 +222,7 @@ void ReporterImpl::onSuccess(Http::MessagePtr&& http_response) {
   } else {
     driver_.tracerStats().reports_sent_.inc();
   }
+  onReportComplete();
 }
 
 } // namespace Zipkin
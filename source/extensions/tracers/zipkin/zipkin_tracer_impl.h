@@ -22,7 +22,8 @@ namespace Zipkin {
   COUNTER(timer_flushed)                                                                           \
   COUNTER(reports_sent)                                                                            \
   COUNTER(reports_dropped)                                                                         \
-  COUNTER(reports_failed)
+  COUNTER(reports_failed)                                                                          \
+  COUNTER(spans_dropped)
 
 struct ZipkinTracerStats {
   ZIPKIN_TRACER_STATS(GENERATE_COUNTER_STRUCT)
@@ -70,6 +71,8 @@ public:
 
   void setSampled(bool sampled) override;
 
+  bool sampled() const override { return span_.sampled(); }
+
   /**
    * @return a reference to the Zipkin::Span object.
    */
@@ -164,6 +167,7 @@ public:
    */
   ReporterImpl(Driver& driver, Event::Dispatcher& dispatcher,
                const std::string& collector_endpoint);
+  ~ReporterImpl() override;
 
   /**
    * Implementation of Zipkin::Reporter::reportSpan().
@@ -201,13 +205,21 @@ private:
 
   /**
    * Removes all spans from the span buffer and sends them to Zipkin using Http::AsyncClient.
+   * Only one report is in flight at a time: while one is, the spans stay buffered, up to the
+   * tracing.zipkin.max_buffered_spans runtime limit, and are flushed once it completes.
    */
   void flushSpans();
 
+  /**
+   * Called as a report completes, flushes the spans buffered meanwhile if there are enough.
+   */
+  void onReportComplete();
+
   Driver& driver_;
   Event::TimerPtr flush_timer_;
   SpanBuffer span_buffer_;
   const std::string collector_endpoint_;
+  Http::AsyncClient::Request* active_request_{};
 };
 } // namespace Zipkin
 } // namespace Tracers
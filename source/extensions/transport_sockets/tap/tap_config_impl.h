@@ -50,7 +50,8 @@ class SocketTapConfigImpl : public Extensions::Common::Tap::TapConfigBaseImpl,
 public:
   SocketTapConfigImpl(envoy::service::tap::v2alpha::TapConfig&& proto_config,
                       Extensions::Common::Tap::Sink* admin_streamer, TimeSource& time_system)
-      : Extensions::Common::Tap::TapConfigBaseImpl(std::move(proto_config), admin_streamer),
+      : Extensions::Common::Tap::TapConfigBaseImpl(std::move(proto_config), admin_streamer,
+                                                   time_system),
         time_source_(time_system) {}
 
   // SocketTapConfig
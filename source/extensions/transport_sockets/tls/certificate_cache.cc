@@ -0,0 +1,127 @@
+#include "extensions/transport_sockets/tls/certificate_cache.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+namespace {
+
+template <class Map> void removeExpiredEntries(Map& map) {
+  for (auto it = map.begin(); it != map.end();) {
+    if (it->second.expired()) {
+      map.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bssl::UniquePtr<BIO> memBio(const std::string& data) {
+  bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(const_cast<char*>(data.data()), data.size()));
+  RELEASE_ASSERT(bio != nullptr, "");
+  return bio;
+}
+
+} // namespace
+
+CertificateCache::CertificateChainConstSharedPtr
+CertificateCache::certificateChain(const std::string& pem) {
+  absl::MutexLock l(&lock_);
+  return getOrParse(certificate_chains_, pem, [&pem]() -> CertificateChainConstSharedPtr {
+    bssl::UniquePtr<BIO> bio = memBio(pem);
+    auto chain = std::make_shared<CertificateChain>();
+    chain->leaf_.reset(PEM_read_bio_X509_AUX(bio.get(), nullptr, nullptr, nullptr));
+    if (chain->leaf_ == nullptr) {
+      return nullptr;
+    }
+    while (true) {
+      bssl::UniquePtr<X509> cert(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr));
+      if (cert == nullptr) {
+        break;
+      }
+      chain->intermediates_.push_back(std::move(cert));
+    }
+    // Check for EOF.
+    const uint32_t err = ERR_peek_last_error();
+    if (ERR_GET_LIB(err) != ERR_LIB_PEM || ERR_GET_REASON(err) != PEM_R_NO_START_LINE) {
+      return nullptr;
+    }
+    ERR_clear_error();
+    return chain;
+  });
+}
+
+CertificateCache::PrivateKeyConstSharedPtr
+CertificateCache::privateKey(const std::string& pem, const std::string& password) {
+  absl::MutexLock l(&lock_);
+  return getOrParse(private_keys_, std::make_pair(pem, password),
+                    [&pem, &password]() -> PrivateKeyConstSharedPtr {
+                      bssl::UniquePtr<BIO> bio = memBio(pem);
+                      auto key = std::make_shared<PrivateKey>();
+                      key->pkey_.reset(PEM_read_bio_PrivateKey(
+                          bio.get(), nullptr, nullptr,
+                          !password.empty() ? const_cast<char*>(password.c_str()) : nullptr));
+                      return key->pkey_ != nullptr ? key : nullptr;
+                    });
+}
+
+CertificateCache::CertificateListConstSharedPtr
+CertificateCache::certificateList(const std::string& pem) {
+  absl::MutexLock l(&lock_);
+  return getOrParse(certificate_lists_, pem, [&pem]() -> CertificateListConstSharedPtr {
+    bssl::UniquePtr<BIO> bio = memBio(pem);
+    auto list = std::make_shared<CertificateList>();
+    // Based on BoringSSL's X509_load_cert_crl_file().
+    list->items_.reset(PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
+    return list->items_ != nullptr ? list : nullptr;
+  });
+}
+
+size_t CertificateCache::size() {
+  absl::MutexLock l(&lock_);
+  return sizeLocked();
+}
+
+size_t CertificateCache::sizeLocked() {
+  return certificate_chains_.size() + private_keys_.size() + certificate_lists_.size();
+}
+
+template <class Key, class Value, class ParseFunction>
+std::shared_ptr<const Value> CertificateCache::getOrParse(Map<Key, Value>& map, const Key& key,
+                                                          ParseFunction parse) {
+  const auto it = map.find(key);
+  if (it != map.end()) {
+    std::shared_ptr<const Value> value = it->second.lock();
+    if (value != nullptr) {
+      return value;
+    }
+  }
+
+  // The failures are not cached, so that the callers get the errors of the parsing.
+  std::shared_ptr<const Value> value = parse();
+  if (value == nullptr) {
+    return nullptr;
+  }
+  map[key] = value;
+  // The entries of the contexts which were destroyed are removed once the cache doubled in size,
+  // keeping the cost of the removal constant per insertion.
+  if (sizeLocked() >= 2 * size_after_removal_) {
+    removeExpired();
+  }
+  return value;
+}
+
+void CertificateCache::removeExpired() {
+  removeExpiredEntries(certificate_chains_);
+  removeExpiredEntries(private_keys_);
+  removeExpiredEntries(certificate_lists_);
+  size_after_removal_ = sizeLocked();
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/common/thread_annotations.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * The certificates and private keys parsed from the PEM data of the contexts, shared by the
+ * contexts configured with identical data rather than parsed and held by each of them. The entries
+ * live as long as a context uses them. The parsed objects are not modified once cached, and the
+ * cache may be used from any thread.
+ */
+class CertificateCache {
+public:
+  struct CertificateChain {
+    bssl::UniquePtr<X509> leaf_;
+    std::vector<bssl::UniquePtr<X509>> intermediates_;
+  };
+  using CertificateChainConstSharedPtr = std::shared_ptr<const CertificateChain>;
+
+  struct PrivateKey {
+    bssl::UniquePtr<EVP_PKEY> pkey_;
+  };
+  using PrivateKeyConstSharedPtr = std::shared_ptr<const PrivateKey>;
+
+  // The certificates and CRLs of a bundle, e.g. of trusted CAs.
+  struct CertificateList {
+    bssl::UniquePtr<STACK_OF(X509_INFO)> items_;
+  };
+  using CertificateListConstSharedPtr = std::shared_ptr<const CertificateList>;
+
+  /**
+   * @param pem supplies a certificate followed by its intermediates.
+   * @return the parsed chain, or nullptr if it is malformed, with the errors left queued.
+   */
+  CertificateChainConstSharedPtr certificateChain(const std::string& pem);
+
+  /**
+   * @param pem supplies a private key.
+   * @param password supplies the password the key is encrypted with, if not empty.
+   * @return the parsed key, or nullptr if it is malformed or the password is wrong.
+   */
+  PrivateKeyConstSharedPtr privateKey(const std::string& pem, const std::string& password);
+
+  /**
+   * @param pem supplies a bundle of certificates and CRLs.
+   * @return the parsed bundle, or nullptr if it is malformed.
+   */
+  CertificateListConstSharedPtr certificateList(const std::string& pem);
+
+  /**
+   * @return the number of entries, including those no longer used.
+   */
+  size_t size();
+
+private:
+  template <class Key, class Value>
+  using Map = absl::flat_hash_map<Key, std::weak_ptr<const Value>>;
+
+  template <class Key, class Value, class ParseFunction>
+  std::shared_ptr<const Value> getOrParse(Map<Key, Value>& map, const Key& key,
+                                          ParseFunction parse) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void removeExpired() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  size_t sizeLocked() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  absl::Mutex lock_;
+  Map<std::string, CertificateChain> certificate_chains_ GUARDED_BY(lock_);
+  // Keyed by the PEM data and the password.
+  Map<std::pair<std::string, std::string>, PrivateKey> private_keys_ GUARDED_BY(lock_);
+  Map<std::string, CertificateList> certificate_lists_ GUARDED_BY(lock_);
+  // The number of entries when the expired ones were last removed.
+  size_t size_after_removal_ GUARDED_BY(lock_){};
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
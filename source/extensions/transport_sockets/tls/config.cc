@@ -33,11 +33,19 @@ REGISTER_FACTORY(UpstreamSslSocketFactory,
 Network::TransportSocketFactoryPtr DownstreamSslSocketFactory::createTransportSocketFactory(
     const Protobuf::Message& message, Server::Configuration::TransportSocketFactoryContext& context,
     const std::vector<std::string>& server_names) {
-  auto server_config = std::make_unique<ServerContextConfigImpl>(
-      MessageUtil::downcastAndValidate<const envoy::api::v2::auth::DownstreamTlsContext&>(message),
-      context);
-  return std::make_unique<ServerSslSocketFactory>(
+  const auto& config =
+      MessageUtil::downcastAndValidate<const envoy::api::v2::auth::DownstreamTlsContext&>(message);
+  auto server_config = std::make_unique<ServerContextConfigImpl>(config, context);
+  auto factory = std::make_unique<ServerSslSocketFactory>(
       std::move(server_config), context.sslContextManager(), context.statsScope(), server_names);
+  if (config.handshake_limits().has_max_concurrent_handshakes() ||
+      config.handshake_limits().has_overload_max_concurrent_handshakes()) {
+    factory->limitHandshakes(
+        std::make_shared<HandshakeLimitsConfig>(config.handshake_limits(),
+                                                context.overloadManager(), context.statsScope()),
+        context.threadLocal());
+  }
+  return factory;
 }
 
 ProtobufTypes::MessagePtr DownstreamSslSocketFactory::createEmptyConfigProto() {
@@ -10,6 +10,8 @@
 #include "common/secret/sds_api.h"
 #include "common/ssl/certificate_validation_context_config_impl.h"
 
+#include "extensions/transport_sockets/tls/private_key_offload.h"
+
 #include "openssl/ssl.h"
 
 namespace Envoy {
@@ -103,6 +105,18 @@ getCertificateValidationContextConfigProvider(
   }
 }
 
+absl::optional<Envoy::Ssl::DynamicRecordSizing>
+dynamicRecordSizingFromProto(const envoy::api::v2::auth::CommonTlsContext& config) {
+  if (!config.has_dynamic_record_sizing()) {
+    return absl::nullopt;
+  }
+  const auto& sizing = config.dynamic_record_sizing();
+  return Envoy::Ssl::DynamicRecordSizing{
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(sizing, initial_record_size, 1400),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(sizing, ramp_up_bytes, 1024 * 1024),
+      std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(sizing, idle_timeout, 1000))};
+}
+
 } // namespace
 
 ContextConfigImpl::ContextConfigImpl(
@@ -122,7 +136,9 @@ ContextConfigImpl::ContextConfigImpl(
       min_protocol_version_(tlsVersionFromProto(config.tls_params().tls_minimum_protocol_version(),
                                                 default_min_protocol_version)),
       max_protocol_version_(tlsVersionFromProto(config.tls_params().tls_maximum_protocol_version(),
-                                                default_max_protocol_version)) {
+                                                default_max_protocol_version)),
+      kernel_tls_offload_(config.kernel_tls_offload()),
+      dynamic_record_sizing_(dynamicRecordSizingFromProto(config)) {
   if (default_cvc_ && certificate_validation_context_provider_ != nullptr) {
     // We need to validate combined certificate validation context.
     // The default certificate validation context and dynamic certificate validation
@@ -274,12 +290,15 @@ ClientContextConfigImpl::ClientContextConfigImpl(
                         DEFAULT_CIPHER_SUITES, DEFAULT_CURVES, factory_context),
       server_name_indication_(config.sni()), allow_renegotiation_(config.allow_renegotiation()),
       max_session_keys_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_session_keys, 1)),
-      sigalgs_(sigalgs) {
+      shared_session_cache_(config.shared_session_cache()), sigalgs_(sigalgs) {
   // BoringSSL treats this as a C string, so embedded NULL characters will not
   // be handled correctly.
   if (server_name_indication_.find('\0') != std::string::npos) {
     throw EnvoyException("SNI names containing NULL-byte are not allowed");
   }
+  if (shared_session_cache_ && max_session_keys_ == 0) {
+    throw EnvoyException("The shared session cache requires session resumption to be enabled");
+  }
   // TODO(PiotrSikora): Support multiple TLS certificates.
   if ((config.common_tls_context().tls_certificates().size() +
        config.common_tls_context().tls_certificate_sds_secret_configs().size()) > 1) {
@@ -347,7 +366,13 @@ ServerContextConfigImpl::ServerContextConfigImpl(
         }
 
         return ret;
-      }()) {
+      }()),
+      private_key_offload_pool_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, private_key_offload_threads, 0) > 0
+              ? std::make_shared<PrivateKeyOffloadPoolImpl>(
+                    api_.threadFactory(), config.private_key_offload_threads().value())
+              : nullptr),
+      shared_session_cache_(config.shared_session_cache()) {
   if ((config.common_tls_context().tls_certificates().size() +
        config.common_tls_context().tls_certificate_sds_secret_configs().size()) == 0) {
     throw EnvoyException("No TLS certificates found for server context");
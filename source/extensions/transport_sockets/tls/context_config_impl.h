@@ -13,6 +13,8 @@
 #include "common/json/json_loader.h"
 #include "common/ssl/tls_certificate_config_impl.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
@@ -43,6 +45,10 @@ public:
   }
   unsigned minProtocolVersion() const override { return min_protocol_version_; };
   unsigned maxProtocolVersion() const override { return max_protocol_version_; };
+  bool kernelTlsOffload() const override { return kernel_tls_offload_; }
+  const Envoy::Ssl::DynamicRecordSizing* dynamicRecordSizing() const override {
+    return dynamic_record_sizing_.has_value() ? &dynamic_record_sizing_.value() : nullptr;
+  }
 
   bool isReady() const override {
     const bool tls_is_ready =
@@ -92,6 +98,8 @@ private:
   Common::CallbackHandle* cvc_validation_callback_handle_{};
   const unsigned min_protocol_version_;
   const unsigned max_protocol_version_;
+  const bool kernel_tls_offload_;
+  const absl::optional<Envoy::Ssl::DynamicRecordSizing> dynamic_record_sizing_;
 };
 
 class ClientContextConfigImpl : public ContextConfigImpl, public Envoy::Ssl::ClientContextConfig {
@@ -108,6 +116,7 @@ public:
   const std::string& serverNameIndication() const override { return server_name_indication_; }
   bool allowRenegotiation() const override { return allow_renegotiation_; }
   size_t maxSessionKeys() const override { return max_session_keys_; }
+  bool sharedSessionCache() const override { return shared_session_cache_; }
   const std::string& signingAlgorithmsForTest() const override { return sigalgs_; }
 
 private:
@@ -119,6 +128,7 @@ private:
   const std::string server_name_indication_;
   const bool allow_renegotiation_;
   const size_t max_session_keys_;
+  const bool shared_session_cache_;
   const std::string sigalgs_;
 };
 
@@ -133,6 +143,10 @@ public:
   const std::vector<SessionTicketKey>& sessionTicketKeys() const override {
     return session_ticket_keys_;
   }
+  Envoy::Ssl::PrivateKeyOffloadPoolSharedPtr privateKeyOffloadPool() const override {
+    return private_key_offload_pool_;
+  }
+  bool sharedSessionCache() const override { return shared_session_cache_; }
 
 private:
   static const unsigned DEFAULT_MIN_VERSION;
@@ -142,6 +156,8 @@ private:
 
   const bool require_client_certificate_;
   const std::vector<SessionTicketKey> session_ticket_keys_;
+  const Envoy::Ssl::PrivateKeyOffloadPoolSharedPtr private_key_offload_pool_;
+  const bool shared_session_cache_;
 
   static void validateAndAppendKey(std::vector<ServerContextConfig::SessionTicketKey>& keys,
                                    const std::string& key_data);
@@ -12,14 +12,18 @@
 
 #include "common/common/assert.h"
 #include "common/common/base64.h"
+#include "common/common/empty_string.h"
 #include "common/common/fmt.h"
 #include "common/common/hex.h"
 #include "common/common/utility.h"
 #include "common/network/address_impl.h"
 #include "common/protobuf/utility.h"
 
+#include "extensions/transport_sockets/tls/handshake_limiter.h"
+#include "extensions/transport_sockets/tls/private_key_offload.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "openssl/evp.h"
 #include "openssl/hmac.h"
 #include "openssl/rand.h"
@@ -46,12 +50,27 @@ bool cbsContainsU16(CBS& cbs, uint16_t n) {
   return false;
 }
 
+std::vector<uint8_t> serializeSession(const SSL_SESSION* session) {
+  uint8_t* data;
+  size_t len;
+  if (!SSL_SESSION_to_bytes(session, &data, &len)) {
+    return {};
+  }
+  std::vector<uint8_t> serialized(data, data + len);
+  OPENSSL_free(data);
+  return serialized;
+}
+
 } // namespace
 
 ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& config,
-                         TimeSource& time_source)
+                         TimeSource& time_source, CertificateCache& certificate_cache)
     : scope_(scope), stats_(generateStats(scope)), time_source_(time_source),
-      tls_max_version_(config.maxProtocolVersion()) {
+      tls_max_version_(config.maxProtocolVersion()),
+      kernel_tls_offload_(config.kernelTlsOffload()) {
+  if (config.dynamicRecordSizing() != nullptr) {
+    dynamic_record_sizing_ = *config.dynamicRecordSizing();
+  }
   const auto tls_certificates = config.tlsCertificates();
   tls_contexts_.resize(std::max(static_cast<size_t>(1), tls_certificates.size()));
 
@@ -91,14 +110,8 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
   if (config.certificateValidationContext() != nullptr &&
       !config.certificateValidationContext()->caCert().empty()) {
     ca_file_path_ = config.certificateValidationContext()->caCertPath();
-    bssl::UniquePtr<BIO> bio(
-        BIO_new_mem_buf(const_cast<char*>(config.certificateValidationContext()->caCert().data()),
-                        config.certificateValidationContext()->caCert().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-    // Based on BoringSSL's X509_load_cert_crl_file().
-    bssl::UniquePtr<STACK_OF(X509_INFO)> list(
-        PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
-    if (list == nullptr) {
+    ca_certs_ = certificate_cache.certificateList(config.certificateValidationContext()->caCert());
+    if (ca_certs_ == nullptr) {
       throw EnvoyException(fmt::format("Failed to load trusted CA certificates from {}",
                                        config.certificateValidationContext()->caCertPath()));
     }
@@ -106,7 +119,7 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
     for (auto& ctx : tls_contexts_) {
       X509_STORE* store = SSL_CTX_get_cert_store(ctx.ssl_ctx_.get());
       bool has_crl = false;
-      for (const X509_INFO* item : list.get()) {
+      for (const X509_INFO* item : ca_certs_->items_.get()) {
         if (item->x509) {
           X509_STORE_add_cert(store, item->x509);
           if (ca_cert_ == nullptr) {
@@ -141,16 +154,9 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
 
   if (config.certificateValidationContext() != nullptr &&
       !config.certificateValidationContext()->certificateRevocationList().empty()) {
-    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(
-        const_cast<char*>(
-            config.certificateValidationContext()->certificateRevocationList().data()),
-        config.certificateValidationContext()->certificateRevocationList().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-
-    // Based on BoringSSL's X509_load_cert_crl_file().
-    bssl::UniquePtr<STACK_OF(X509_INFO)> list(
-        PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
-    if (list == nullptr) {
+    crls_ = certificate_cache.certificateList(
+        config.certificateValidationContext()->certificateRevocationList());
+    if (crls_ == nullptr) {
       throw EnvoyException(
           fmt::format("Failed to load CRL from {}",
                       config.certificateValidationContext()->certificateRevocationListPath()));
@@ -158,7 +164,7 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
 
     for (auto& ctx : tls_contexts_) {
       X509_STORE* store = SSL_CTX_get_cert_store(ctx.ssl_ctx_.get());
-      for (const X509_INFO* item : list.get()) {
+      for (const X509_INFO* item : crls_->items_.get()) {
         if (item->crl) {
           X509_STORE_add_crl(store, item->crl);
         }
@@ -217,11 +223,12 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
     // Load certificate chain.
     const auto& tls_certificate = tls_certificates[i].get();
     ctx.cert_chain_file_path_ = tls_certificate.certificateChainPath();
-    bssl::UniquePtr<BIO> bio(
-        BIO_new_mem_buf(const_cast<char*>(tls_certificate.certificateChain().data()),
-                        tls_certificate.certificateChain().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-    ctx.cert_chain_.reset(PEM_read_bio_X509_AUX(bio.get(), nullptr, nullptr, nullptr));
+    // The certificates and keys are parsed once for all the contexts configured with them.
+    ctx.certificate_chain_ = certificate_cache.certificateChain(tls_certificate.certificateChain());
+    if (ctx.certificate_chain_ != nullptr) {
+      X509_up_ref(ctx.certificate_chain_->leaf_.get());
+      ctx.cert_chain_.reset(ctx.certificate_chain_->leaf_.get());
+    }
     if (ctx.cert_chain_ == nullptr ||
         !SSL_CTX_use_certificate(ctx.ssl_ctx_.get(), ctx.cert_chain_.get())) {
       while (uint64_t err = ERR_get_error()) {
@@ -232,12 +239,10 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
       throw EnvoyException(
           fmt::format("Failed to load certificate chain from {}", ctx.cert_chain_file_path_));
     }
-    // Read rest of the certificate chain.
-    while (true) {
-      bssl::UniquePtr<X509> cert(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr));
-      if (cert == nullptr) {
-        break;
-      }
+    // Add the rest of the certificate chain.
+    for (const auto& intermediate : ctx.certificate_chain_->intermediates_) {
+      X509_up_ref(intermediate.get());
+      bssl::UniquePtr<X509> cert(intermediate.get());
       if (!SSL_CTX_add_extra_chain_cert(ctx.ssl_ctx_.get(), cert.get())) {
         throw EnvoyException(
             fmt::format("Failed to load certificate chain from {}", ctx.cert_chain_file_path_));
@@ -245,14 +250,6 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
       // SSL_CTX_add_extra_chain_cert() takes ownership.
       cert.release();
     }
-    // Check for EOF.
-    uint32_t err = ERR_peek_last_error();
-    if (ERR_GET_LIB(err) == ERR_LIB_PEM && ERR_GET_REASON(err) == PEM_R_NO_START_LINE) {
-      ERR_clear_error();
-    } else {
-      throw EnvoyException(
-          fmt::format("Failed to load certificate chain from {}", ctx.cert_chain_file_path_));
-    }
 
     bssl::UniquePtr<EVP_PKEY> public_key(X509_get_pubkey(ctx.cert_chain_.get()));
     const int pkey_id = EVP_PKEY_id(public_key.get());
@@ -306,14 +303,10 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
     }
 
     // Load private key.
-    bio.reset(BIO_new_mem_buf(const_cast<char*>(tls_certificate.privateKey().data()),
-                              tls_certificate.privateKey().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-    bssl::UniquePtr<EVP_PKEY> pkey(PEM_read_bio_PrivateKey(
-        bio.get(), nullptr, nullptr,
-        !tls_certificate.password().empty() ? const_cast<char*>(tls_certificate.password().c_str())
-                                            : nullptr));
-    if (pkey == nullptr || !SSL_CTX_use_PrivateKey(ctx.ssl_ctx_.get(), pkey.get())) {
+    ctx.private_key_ =
+        certificate_cache.privateKey(tls_certificate.privateKey(), tls_certificate.password());
+    EVP_PKEY* pkey = ctx.private_key_ != nullptr ? ctx.private_key_->pkey_.get() : nullptr;
+    if (pkey == nullptr || !SSL_CTX_use_PrivateKey(ctx.ssl_ctx_.get(), pkey)) {
       throw EnvoyException(
           fmt::format("Failed to load private key from {}", tls_certificate.privateKeyPath()));
     }
@@ -322,7 +315,7 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
     // Verify that private keys are passing FIPS pairwise consistency tests.
     switch (pkey_id) {
     case EVP_PKEY_EC: {
-      const EC_KEY* ecdsa_private_key = EVP_PKEY_get0_EC_KEY(pkey.get());
+      const EC_KEY* ecdsa_private_key = EVP_PKEY_get0_EC_KEY(pkey);
       if (!EC_KEY_check_fips(ecdsa_private_key)) {
         throw EnvoyException(fmt::format("Failed to load private key from {}, ECDSA key failed "
                                          "pairwise consistency test required in FIPS mode",
@@ -330,7 +323,7 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
       }
     } break;
     case EVP_PKEY_RSA: {
-      RSA* rsa_private_key = EVP_PKEY_get0_RSA(pkey.get());
+      RSA* rsa_private_key = EVP_PKEY_get0_RSA(pkey);
       if (!RSA_check_fips(rsa_private_key)) {
         throw EnvoyException(fmt::format("Failed to load private key from {}, RSA key failed "
                                          "pairwise consistency test required in FIPS mode",
@@ -666,11 +659,16 @@ Envoy::Ssl::CertificateDetailsPtr ContextImpl::certificateDetails(X509* cert,
 
 ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
                                      const Envoy::Ssl::ClientContextConfig& config,
-                                     TimeSource& time_source)
-    : ContextImpl(scope, config, time_source),
+                                     TimeSource& time_source,
+                                     Envoy::Ssl::SessionCacheSharedPtr session_cache,
+                                     CertificateCache& certificate_cache)
+    : ContextImpl(scope, config, time_source, certificate_cache),
       server_name_indication_(config.serverNameIndication()),
       allow_renegotiation_(config.allowRenegotiation()),
-      max_session_keys_(config.maxSessionKeys()) {
+      max_session_keys_(config.maxSessionKeys()),
+      session_cache_(config.sharedSessionCache() ? session_cache : nullptr),
+      session_cache_key_prefix_(config.sharedSessionCache() ? sharedSessionKeyPrefix(config)
+                                                            : EMPTY_STRING) {
   // This should be guaranteed during configuration ingestion for client contexts.
   ASSERT(tls_contexts_.size() == 1);
   if (!parsed_alpn_protocols_.empty()) {
@@ -699,7 +697,7 @@ ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
               static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
           ClientContextImpl* client_context_impl = dynamic_cast<ClientContextImpl*>(context_impl);
           RELEASE_ASSERT(client_context_impl != nullptr, ""); // for Coverity
-          return client_context_impl->newSessionKey(session);
+          return client_context_impl->newSessionKey(ssl, session);
         });
   }
 }
@@ -725,7 +723,27 @@ bssl::UniquePtr<SSL> ClientContextImpl::newSsl(const Network::TransportSocketOpt
     SSL_set_renegotiate_mode(ssl_con.get(), ssl_renegotiate_freely);
   }
 
-  if (max_session_keys_ > 0) {
+  if (session_cache_ != nullptr) {
+    // The sessions of the connections verifying other subject alt names than the context are not
+    // shared, as resuming them skips the verification.
+    if (SSL_get_app_data(ssl_con.get()) == nullptr) {
+      const std::string key = absl::StrCat(session_cache_key_prefix_, server_name_indication);
+      const std::vector<uint8_t> serialized = session_cache_->lookup(key);
+      bssl::UniquePtr<SSL_SESSION> session(
+          serialized.empty() ? nullptr
+                             : SSL_SESSION_from_bytes(serialized.data(), serialized.size(),
+                                                      SSL_get_SSL_CTX(ssl_con.get())));
+      if (session != nullptr) {
+        stats_.session_cache_hit_.inc();
+        SSL_set_session(ssl_con.get(), session.get());
+        if (SSL_SESSION_should_be_single_use(session.get())) {
+          session_cache_->remove(key);
+        }
+      } else {
+        stats_.session_cache_miss_.inc();
+      }
+    }
+  } else if (max_session_keys_ > 0) {
     if (session_keys_single_use_) {
       // Stored single-use session keys, use write/write locks.
       absl::WriterMutexLock l(&session_keys_mu_);
@@ -754,7 +772,17 @@ bssl::UniquePtr<SSL> ClientContextImpl::newSsl(const Network::TransportSocketOpt
   return ssl_con;
 }
 
-int ClientContextImpl::newSessionKey(SSL_SESSION* session) {
+int ClientContextImpl::newSessionKey(SSL* ssl, SSL_SESSION* session) {
+  if (session_cache_ != nullptr) {
+    if (SSL_get_app_data(ssl) == nullptr) {
+      const char* server_name = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+      session_cache_->store(absl::StrCat(session_cache_key_prefix_,
+                                         server_name != nullptr ? server_name : ""),
+                            serializeSession(session));
+    }
+    return 0; // The session was copied, BoringSSL keeps ownership.
+  }
+
   // In case we ever store single-use session key (TLS 1.3),
   // we need to switch to using write/write locks.
   if (SSL_SESSION_should_be_single_use(session)) {
@@ -770,6 +798,48 @@ int ClientContextImpl::newSessionKey(SSL_SESSION* session) {
   return 1; // Tell BoringSSL that we took ownership of the session.
 }
 
+std::string
+ClientContextImpl::sharedSessionKeyPrefix(const Envoy::Ssl::ClientContextConfig& config) {
+  EVP_MD_CTX md;
+  int rc = EVP_DigestInit(&md, EVP_sha256());
+  RELEASE_ASSERT(rc == 1, "");
+  // Each setting is prefixed with its length so that they can not run into each other.
+  const auto update = [&md](absl::string_view value) {
+    const uint64_t len = value.size();
+    int rc = EVP_DigestUpdate(&md, &len, sizeof(len));
+    RELEASE_ASSERT(rc == 1, "");
+    rc = EVP_DigestUpdate(&md, value.data(), value.size());
+    RELEASE_ASSERT(rc == 1, "");
+  };
+
+  update(config.alpnProtocols());
+  for (const auto& tls_certificate : config.tlsCertificates()) {
+    update(tls_certificate.get().certificateChain());
+  }
+  const Envoy::Ssl::CertificateValidationContextConfig* validation_context =
+      config.certificateValidationContext();
+  if (validation_context != nullptr) {
+    update(validation_context->caCert());
+    update(validation_context->certificateRevocationList());
+    for (const auto* list :
+         {&validation_context->verifySubjectAltNameList(),
+          &validation_context->verifyCertificateHashList(),
+          &validation_context->verifyCertificateSpkiList()}) {
+      update(absl::StrCat(list->size()));
+      for (const std::string& value : *list) {
+        update(value);
+      }
+    }
+    update(validation_context->allowExpiredCertificate() ? "1" : "0");
+  }
+
+  uint8_t hash[EVP_MAX_MD_SIZE];
+  unsigned hash_len = 0;
+  rc = EVP_DigestFinal(&md, hash, &hash_len);
+  RELEASE_ASSERT(rc == 1, "");
+  return absl::StrCat("client:", Hex::encode(hash, hash_len), ":");
+}
+
 uint16_t ClientContextImpl::parseSigningAlgorithmsForTest(const std::string& sigalgs) {
   // This is used only when testing RSA/ECDSA certificate selection, so only the signing algorithms
   // used in tests are supported here.
@@ -784,8 +854,12 @@ uint16_t ClientContextImpl::parseSigningAlgorithmsForTest(const std::string& sig
 ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
                                      const Envoy::Ssl::ServerContextConfig& config,
                                      const std::vector<std::string>& server_names,
-                                     TimeSource& time_source)
-    : ContextImpl(scope, config, time_source), session_ticket_keys_(config.sessionTicketKeys()) {
+                                     TimeSource& time_source,
+                                     Envoy::Ssl::SessionCacheSharedPtr session_cache,
+                                     CertificateCache& certificate_cache)
+    : ContextImpl(scope, config, time_source, certificate_cache),
+      session_ticket_keys_(config.sessionTicketKeys()),
+      session_cache_(config.sharedSessionCache() ? session_cache : nullptr) {
   if (config.tlsCertificates().empty()) {
     throw EnvoyException("Server TlsCertificates must have a certificate specified");
   }
@@ -795,6 +869,14 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   SSL_CTX_set_select_certificate_cb(
       tls_contexts_[0].ssl_ctx_.get(),
       [](const SSL_CLIENT_HELLO* client_hello) -> ssl_select_cert_result_t {
+        // The handshake may have to wait for others to complete before selecting a certificate.
+        LimitedHandshake* limited_handshake = LimitedHandshake::get(client_hello->ssl);
+        if (limited_handshake != nullptr) {
+          const ssl_select_cert_result_t result = limited_handshake->onClientHello(client_hello);
+          if (result != ssl_select_cert_success) {
+            return result;
+          }
+        }
         return static_cast<ServerContextImpl*>(
                    SSL_CTX_get_app_data(SSL_get_SSL_CTX(client_hello->ssl)))
             ->selectTlsContext(client_hello);
@@ -836,10 +918,73 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
           });
     }
 
+    if (session_cache_ != nullptr) {
+      // Only the callbacks of the context the connections are created with are used, but the
+      // contexts are kept identical.
+      SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(),
+                                     SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+      SSL_CTX_sess_set_new_cb(ctx.ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
+        static_cast<ServerContextImpl*>(
+            static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl))))
+            ->storeSession(session);
+        return 0; // The session was copied, BoringSSL keeps ownership.
+      });
+      SSL_CTX_sess_set_get_cb(
+          ctx.ssl_ctx_.get(),
+          [](SSL* ssl, const uint8_t* id, int id_len, int* out_copy) -> SSL_SESSION* {
+            // The returned session is owned by BoringSSL.
+            *out_copy = 0;
+            return static_cast<ServerContextImpl*>(
+                       static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl))))
+                ->lookupSession(ssl, id, id_len);
+          });
+      SSL_CTX_sess_set_remove_cb(ctx.ssl_ctx_.get(), [](SSL_CTX* ssl_ctx, SSL_SESSION* session) {
+        static_cast<ServerContextImpl*>(static_cast<ContextImpl*>(SSL_CTX_get_app_data(ssl_ctx)))
+            ->removeSession(session);
+      });
+    }
+
+    if (config.privateKeyOffloadPool() != nullptr) {
+      // The key stays loaded in the context, the pool signing with it on behalf of the method.
+      SSL_CTX_set_private_key_method(ctx.ssl_ctx_.get(), PrivateKeyConnection::method());
+    }
+
     int rc = SSL_CTX_set_session_id_context(ctx.ssl_ctx_.get(), session_context_buf,
                                             session_context_len);
     RELEASE_ASSERT(rc == 1, "");
   }
+  private_key_offload_pool_ = config.privateKeyOffloadPool();
+}
+
+std::string ServerContextImpl::sessionKey(const uint8_t* id, size_t id_len) {
+  return absl::StrCat("server:", Hex::encode(id, id_len));
+}
+
+void ServerContextImpl::storeSession(SSL_SESSION* session) {
+  unsigned id_len;
+  const uint8_t* id = SSL_SESSION_get_id(session, &id_len);
+  session_cache_->store(sessionKey(id, id_len), serializeSession(session));
+}
+
+SSL_SESSION* ServerContextImpl::lookupSession(SSL* ssl, const uint8_t* id, int id_len) {
+  const std::vector<uint8_t> serialized = session_cache_->lookup(sessionKey(id, id_len));
+  // Sessions of other session ID contexts are rejected by BoringSSL once returned.
+  SSL_SESSION* session =
+      serialized.empty()
+          ? nullptr
+          : SSL_SESSION_from_bytes(serialized.data(), serialized.size(), SSL_get_SSL_CTX(ssl));
+  if (session != nullptr) {
+    stats_.session_cache_hit_.inc();
+  } else {
+    stats_.session_cache_miss_.inc();
+  }
+  return session;
+}
+
+void ServerContextImpl::removeSession(SSL_SESSION* session) {
+  unsigned id_len;
+  const uint8_t* id = SSL_SESSION_get_id(session, &id_len);
+  session_cache_->remove(sessionKey(id, id_len));
 }
 
 void ServerContextImpl::generateHashForSessionContexId(const std::vector<std::string>& server_names,
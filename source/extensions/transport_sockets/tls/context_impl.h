@@ -8,9 +8,11 @@
 #include "envoy/network/transport_socket.h"
 #include "envoy/ssl/context.h"
 #include "envoy/ssl/context_config.h"
+#include "envoy/ssl/session_cache.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
 
+#include "extensions/transport_sockets/tls/certificate_cache.h"
 #include "extensions/transport_sockets/tls/context_manager_impl.h"
 
 #include "absl/synchronization/mutex.h"
@@ -35,7 +37,14 @@ namespace Tls {
   COUNTER(fail_verify_no_cert)                                                                     \
   COUNTER(fail_verify_error)                                                                       \
   COUNTER(fail_verify_san)                                                                         \
-  COUNTER(fail_verify_cert_hash)
+  COUNTER(fail_verify_cert_hash)                                                                   \
+  COUNTER(ktls_tx_enabled)                                                                         \
+  COUNTER(ktls_tx_unsupported)                                                                     \
+  COUNTER(session_cache_hit)                                                                       \
+  COUNTER(session_cache_miss)                                                                      \
+  COUNTER(write_record_small)                                                                      \
+  COUNTER(write_record_full)                                                                       \
+  COUNTER(write_flush)
 // clang-format on
 
 /**
@@ -74,6 +83,25 @@ public:
 
   SslStats& stats() { return stats_; }
 
+  /**
+   * @return whether sockets should try to offload record encryption to the kernel.
+   */
+  bool kernelTlsOffload() const { return kernel_tls_offload_; }
+
+  /**
+   * @return the sizing of the records written by the sockets, or nullptr if they are full-size.
+   */
+  const Envoy::Ssl::DynamicRecordSizing* dynamicRecordSizing() const {
+    return dynamic_record_sizing_.has_value() ? &dynamic_record_sizing_.value() : nullptr;
+  }
+
+  /**
+   * @return the pool the private key operations of the handshakes are offloaded to, or nullptr.
+   */
+  Envoy::Ssl::PrivateKeyOffloadPool* privateKeyOffloadPool() const {
+    return private_key_offload_pool_.get();
+  }
+
   // Ssl::Context
   size_t daysUntilFirstCertExpires() const override;
   Envoy::Ssl::CertificateDetailsPtr getCaCertInformation() const override;
@@ -81,7 +109,7 @@ public:
 
 protected:
   ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& config,
-              TimeSource& time_source);
+              TimeSource& time_source, CertificateCache& certificate_cache);
 
   /**
    * The global SSL-library index used for storing a pointer to the context
@@ -133,6 +161,9 @@ protected:
     // SSL_CTX_set_select_certificate_cb() callback following ClientHello.
     bssl::UniquePtr<SSL_CTX> ssl_ctx_;
     bssl::UniquePtr<X509> cert_chain_;
+    // The parsed certificate chain and private key, shared with the other contexts using them.
+    CertificateCache::CertificateChainConstSharedPtr certificate_chain_;
+    CertificateCache::PrivateKeyConstSharedPtr private_key_;
     std::string cert_chain_file_path_;
     bool is_ecdsa_{};
 
@@ -155,11 +186,16 @@ protected:
   SslStats stats_;
   std::vector<uint8_t> parsed_alpn_protocols_;
   bssl::UniquePtr<X509> ca_cert_;
+  CertificateCache::CertificateListConstSharedPtr ca_certs_;
+  CertificateCache::CertificateListConstSharedPtr crls_;
   bssl::UniquePtr<X509> cert_chain_;
   std::string ca_file_path_;
   std::string cert_chain_file_path_;
   TimeSource& time_source_;
   const unsigned tls_max_version_;
+  const bool kernel_tls_offload_;
+  absl::optional<Envoy::Ssl::DynamicRecordSizing> dynamic_record_sizing_;
+  Envoy::Ssl::PrivateKeyOffloadPoolSharedPtr private_key_offload_pool_;
 };
 
 using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
@@ -167,12 +203,16 @@ using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
 class ClientContextImpl : public ContextImpl, public Envoy::Ssl::ClientContext {
 public:
   ClientContextImpl(Stats::Scope& scope, const Envoy::Ssl::ClientContextConfig& config,
-                    TimeSource& time_source);
+                    TimeSource& time_source, Envoy::Ssl::SessionCacheSharedPtr session_cache,
+                    CertificateCache& certificate_cache);
 
   bssl::UniquePtr<SSL> newSsl(const Network::TransportSocketOptions* options) override;
 
 private:
-  int newSessionKey(SSL_SESSION* session);
+  int newSessionKey(SSL* ssl, SSL_SESSION* session);
+  // Returns the prefix of the keys of the sessions in the shared cache, which is specific to the
+  // settings the servers are authenticated with and the client authenticates with.
+  static std::string sharedSessionKeyPrefix(const Envoy::Ssl::ClientContextConfig& config);
   uint16_t parseSigningAlgorithmsForTest(const std::string& sigalgs);
 
   const std::string server_name_indication_;
@@ -181,12 +221,17 @@ private:
   absl::Mutex session_keys_mu_;
   std::deque<bssl::UniquePtr<SSL_SESSION>> session_keys_ GUARDED_BY(session_keys_mu_);
   bool session_keys_single_use_{false};
+  // Set if the sessions are stored in the shared cache, under this prefix followed by the SNI.
+  const Envoy::Ssl::SessionCacheSharedPtr session_cache_;
+  const std::string session_cache_key_prefix_;
 };
 
 class ServerContextImpl : public ContextImpl, public Envoy::Ssl::ServerContext {
 public:
   ServerContextImpl(Stats::Scope& scope, const Envoy::Ssl::ServerContextConfig& config,
-                    const std::vector<std::string>& server_names, TimeSource& time_source);
+                    const std::vector<std::string>& server_names, TimeSource& time_source,
+                    Envoy::Ssl::SessionCacheSharedPtr session_cache,
+                    CertificateCache& certificate_cache);
 
 private:
   int alpnSelectCallback(const unsigned char** out, unsigned char* outlen, const unsigned char* in,
@@ -199,8 +244,14 @@ private:
   enum ssl_select_cert_result_t selectTlsContext(const SSL_CLIENT_HELLO* ssl_client_hello);
   void generateHashForSessionContexId(const std::vector<std::string>& server_names,
                                       uint8_t* session_context_buf, unsigned& session_context_len);
+  void storeSession(SSL_SESSION* session);
+  SSL_SESSION* lookupSession(SSL* ssl, const uint8_t* id, int id_len);
+  void removeSession(SSL_SESSION* session);
+  static std::string sessionKey(const uint8_t* id, size_t id_len);
 
   const std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey> session_ticket_keys_;
+  // Set if the sessions resumed by session ID are stored in the shared cache.
+  const Envoy::Ssl::SessionCacheSharedPtr session_cache_;
 };
 
 } // namespace Tls
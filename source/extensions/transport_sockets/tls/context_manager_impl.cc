@@ -1,18 +1,44 @@
 #include "extensions/transport_sockets/tls/context_manager_impl.h"
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
 
+#include "envoy/common/exception.h"
 #include "envoy/stats/scope.h"
+#include "envoy/thread/thread.h"
 
 #include "common/common/assert.h"
+#include "common/config/datasource.h"
 
 #include "extensions/transport_sockets/tls/context_impl.h"
+#include "extensions/transport_sockets/tls/session_cache_impl.h"
+
+#include "openssl/err.h"
 
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
 namespace Tls {
 
+namespace {
+
+class CertificatePreloadImpl : public Envoy::Ssl::CertificatePreload {
+public:
+  explicit CertificatePreloadImpl(size_t size) : entries_(size) {}
+
+  // The entries of the certificate cache, which it only keeps while they are used.
+  std::vector<std::shared_ptr<const void>> entries_;
+};
+
+} // namespace
+
+constexpr size_t ContextManagerImpl::MinPreloadItemsPerThread;
+
+ContextManagerImpl::ContextManagerImpl(TimeSource& time_source)
+    : ContextManagerImpl(time_source,
+                         std::make_shared<SessionCacheImpl>(SessionCacheImpl::DefaultMaxEntries)) {}
+
 ContextManagerImpl::~ContextManagerImpl() {
   removeEmptyContexts();
   ASSERT(contexts_.empty());
@@ -29,8 +55,8 @@ ContextManagerImpl::createSslClientContext(Stats::Scope& scope,
     return nullptr;
   }
 
-  Envoy::Ssl::ClientContextSharedPtr context =
-      std::make_shared<ClientContextImpl>(scope, config, time_source_);
+  Envoy::Ssl::ClientContextSharedPtr context = std::make_shared<ClientContextImpl>(
+      scope, config, time_source_, session_cache_, certificate_cache_);
   removeEmptyContexts();
   contexts_.emplace_back(context);
   return context;
@@ -44,8 +70,8 @@ ContextManagerImpl::createSslServerContext(Stats::Scope& scope,
     return nullptr;
   }
 
-  Envoy::Ssl::ServerContextSharedPtr context =
-      std::make_shared<ServerContextImpl>(scope, config, server_names, time_source_);
+  Envoy::Ssl::ServerContextSharedPtr context = std::make_shared<ServerContextImpl>(
+      scope, config, server_names, time_source_, session_cache_, certificate_cache_);
   removeEmptyContexts();
   contexts_.emplace_back(context);
   return context;
@@ -62,6 +88,69 @@ size_t ContextManagerImpl::daysUntilFirstCertExpires() const {
   return ret;
 }
 
+Envoy::Ssl::CertificatePreloadPtr ContextManagerImpl::preloadCertificates(
+    const std::vector<const envoy::api::v2::auth::TlsCertificate*>& tls_certificates,
+    const std::vector<const envoy::api::v2::auth::CertificateValidationContext*>&
+        validation_contexts,
+    Api::Api& api, uint32_t max_threads) {
+  // Each item reads and parses one certificate chain, private key, CA bundle or CRL. The data is
+  // read as the contexts read it, so that they find it in the cache.
+  std::vector<std::function<std::shared_ptr<const void>()>> items;
+  for (const envoy::api::v2::auth::TlsCertificate* tls_certificate : tls_certificates) {
+    items.emplace_back([this, tls_certificate, &api]() -> std::shared_ptr<const void> {
+      const std::string pem =
+          Config::DataSource::read(tls_certificate->certificate_chain(), true, api);
+      return pem.empty() ? nullptr : certificate_cache_.certificateChain(pem);
+    });
+    items.emplace_back([this, tls_certificate, &api]() -> std::shared_ptr<const void> {
+      const std::string pem = Config::DataSource::read(tls_certificate->private_key(), true, api);
+      if (pem.empty()) {
+        return nullptr;
+      }
+      return certificate_cache_.privateKey(
+          pem, Config::DataSource::read(tls_certificate->password(), true, api));
+    });
+  }
+  for (const envoy::api::v2::auth::CertificateValidationContext* validation_context :
+       validation_contexts) {
+    for (const envoy::api::v2::core::DataSource* source :
+         {&validation_context->trusted_ca(), &validation_context->crl()}) {
+      items.emplace_back([this, source, &api]() -> std::shared_ptr<const void> {
+        const std::string pem = Config::DataSource::read(*source, true, api);
+        return pem.empty() ? nullptr : certificate_cache_.certificateList(pem);
+      });
+    }
+  }
+  if (items.empty()) {
+    return nullptr;
+  }
+
+  auto preload = std::make_unique<CertificatePreloadImpl>(items.size());
+  std::atomic<size_t> next_item{0};
+  const auto parse = [&items, &preload, &next_item]() -> void {
+    for (size_t i = next_item++; i < items.size(); i = next_item++) {
+      try {
+        preload->entries_[i] = items[i]();
+      } catch (const EnvoyException&) {
+      }
+      // The errors of malformed data are reported when the contexts are created.
+      ERR_clear_error();
+    }
+  };
+
+  const size_t threads =
+      std::min<size_t>(std::max(max_threads, 1U), items.size() / MinPreloadItemsPerThread);
+  std::vector<Thread::ThreadPtr> parsing_threads;
+  for (size_t i = 1; i < threads; i++) {
+    parsing_threads.emplace_back(api.threadFactory().createThread(parse));
+  }
+  parse();
+  for (Thread::ThreadPtr& thread : parsing_threads) {
+    thread->join();
+  }
+  return preload;
+}
+
 void ContextManagerImpl::iterateContexts(std::function<void(const Envoy::Ssl::Context&)> callback) {
   for (const auto& ctx_weak_ptr : contexts_) {
     Envoy::Ssl::ContextSharedPtr context = ctx_weak_ptr.lock();
@@ -5,8 +5,11 @@
 
 #include "envoy/common/time.h"
 #include "envoy/ssl/context_manager.h"
+#include "envoy/ssl/session_cache.h"
 #include "envoy/stats/scope.h"
 
+#include "extensions/transport_sockets/tls/certificate_cache.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
@@ -21,7 +24,9 @@ namespace Tls {
  */
 class ContextManagerImpl final : public Envoy::Ssl::ContextManager {
 public:
-  ContextManagerImpl(TimeSource& time_source) : time_source_(time_source) {}
+  ContextManagerImpl(TimeSource& time_source);
+  ContextManagerImpl(TimeSource& time_source, Envoy::Ssl::SessionCacheSharedPtr session_cache)
+      : time_source_(time_source), session_cache_(std::move(session_cache)) {}
   ~ContextManagerImpl() override;
 
   // Ssl::ContextManager
@@ -33,10 +38,26 @@ public:
                          const std::vector<std::string>& server_names) override;
   size_t daysUntilFirstCertExpires() const override;
   void iterateContexts(std::function<void(const Envoy::Ssl::Context&)> callback) override;
+  Envoy::Ssl::SessionCacheSharedPtr sessionCache() override { return session_cache_; }
+  Envoy::Ssl::CertificatePreloadPtr preloadCertificates(
+      const std::vector<const envoy::api::v2::auth::TlsCertificate*>& tls_certificates,
+      const std::vector<const envoy::api::v2::auth::CertificateValidationContext*>&
+          validation_contexts,
+      Api::Api& api, uint32_t max_threads) override;
+
+  // Below this many items (certificate chains, keys, ...) per thread, the cost of a thread
+  // outweighs the parsing it saves.
+  static constexpr size_t MinPreloadItemsPerThread = 16;
+
+  CertificateCache& certificateCache() { return certificate_cache_; }
 
 private:
   void removeEmptyContexts();
   TimeSource& time_source_;
+  // Shared by the contexts configured to store their sessions in it.
+  const Envoy::Ssl::SessionCacheSharedPtr session_cache_;
+  // Shares the certificates and keys parsed by the contexts.
+  CertificateCache certificate_cache_;
   std::list<std::weak_ptr<Envoy::Ssl::Context>> contexts_;
 };
 
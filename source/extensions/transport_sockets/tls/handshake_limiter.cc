@@ -0,0 +1,168 @@
+#include "extensions/transport_sockets/tls/handshake_limiter.h"
+
+#include <limits>
+
+#include "common/common/assert.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+HandshakeLimitsConfig::HandshakeLimitsConfig(const envoy::api::v2::auth::HandshakeLimits& config,
+                                             Server::OverloadManager* overload_manager,
+                                             Stats::Scope& scope)
+    : max_concurrent_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_concurrent_handshakes, 0)),
+      overload_max_concurrent_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, overload_max_concurrent_handshakes, 0)),
+      max_queued_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_queued_handshakes,
+                                                  std::numeric_limits<uint32_t>::max())),
+      overload_manager_(overload_max_concurrent_ > 0 ? overload_manager : nullptr),
+      stats_({ALL_HANDSHAKE_LIMITER_STATS(POOL_COUNTER_PREFIX(scope, "ssl."),
+                                          POOL_GAUGE_PREFIX(scope, "ssl."))}) {}
+
+HandshakeLimiter::Admission HandshakeLimiter::admit(Waiter& waiter, bool resumption) {
+  // The limit may have been raised as the overload action went inactive.
+  admitQueued();
+  if (queued() == 0 && active_ < limit()) {
+    active_++;
+    config_->stats_.handshake_active_.inc();
+    return Admission::Admitted;
+  }
+  if (queued() >= config_->max_queued_) {
+    config_->stats_.handshake_rejected_.inc();
+    return Admission::Rejected;
+  }
+  (resumption ? resumptions_ : full_handshakes_).push_back(&waiter);
+  config_->stats_.handshake_delayed_.inc();
+  config_->stats_.handshake_queued_.inc();
+  return Admission::Queued;
+}
+
+void HandshakeLimiter::release() {
+  ASSERT(active_ > 0);
+  active_--;
+  config_->stats_.handshake_active_.dec();
+  admitQueued();
+}
+
+void HandshakeLimiter::admitQueued() {
+  while (queued() > 0 && active_ < limit()) {
+    std::list<Waiter*>& queue = resumptions_.empty() ? full_handshakes_ : resumptions_;
+    Waiter* waiter = queue.front();
+    queue.pop_front();
+    config_->stats_.handshake_queued_.dec();
+    active_++;
+    config_->stats_.handshake_active_.inc();
+    waiter->onHandshakeAdmitted();
+  }
+}
+
+void HandshakeLimiter::cancel(Waiter& waiter) {
+  const size_t before = queued();
+  resumptions_.remove(&waiter);
+  full_handshakes_.remove(&waiter);
+  config_->stats_.handshake_queued_.sub(before - queued());
+}
+
+uint32_t HandshakeLimiter::limit() const {
+  uint32_t limit = config_->max_concurrent_ > 0 ? config_->max_concurrent_
+                                                 : std::numeric_limits<uint32_t>::max();
+  if (config_->overload_manager_ != nullptr &&
+      config_->overload_manager_->getThreadLocalOverloadState().getState(
+          Server::OverloadActionNames::get().LimitTlsHandshakes) ==
+          Server::OverloadActionState::Active) {
+    limit = std::min(limit, config_->overload_max_concurrent_);
+  }
+  return limit;
+}
+
+LimitedHandshake::LimitedHandshake(SSL* ssl, HandshakeLimiterSharedPtr limiter,
+                                   std::function<void()> on_admitted)
+    : limiter_(std::move(limiter)), on_admitted_(std::move(on_admitted)) {
+  SSL_set_ex_data(ssl, sslIndex(), this);
+}
+
+LimitedHandshake::~LimitedHandshake() {
+  if (state_ == State::Queued) {
+    limiter_->cancel(*this);
+  } else if (state_ == State::Admitted) {
+    limiter_->release();
+  }
+}
+
+LimitedHandshake* LimitedHandshake::get(SSL* ssl) {
+  return static_cast<LimitedHandshake*>(SSL_get_ex_data(ssl, sslIndex()));
+}
+
+ssl_select_cert_result_t LimitedHandshake::onClientHello(const SSL_CLIENT_HELLO* client_hello) {
+  switch (state_) {
+  case State::WaitingForHello:
+    break;
+  case State::Queued:
+    // The handshake was driven by more data, it keeps waiting.
+    return ssl_select_cert_retry;
+  case State::Admitted:
+  case State::Done:
+    return ssl_select_cert_success;
+  }
+
+  switch (limiter_->admit(*this, offersResumption(client_hello))) {
+  case HandshakeLimiter::Admission::Admitted:
+    state_ = State::Admitted;
+    return ssl_select_cert_success;
+  case HandshakeLimiter::Admission::Queued:
+    state_ = State::Queued;
+    return ssl_select_cert_retry;
+  case HandshakeLimiter::Admission::Rejected:
+    state_ = State::Done;
+    return ssl_select_cert_error;
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void LimitedHandshake::onHandshakeComplete() {
+  if (state_ == State::Admitted) {
+    limiter_->release();
+  }
+  state_ = State::Done;
+}
+
+void LimitedHandshake::onHandshakeAdmitted() {
+  ASSERT(state_ == State::Queued);
+  state_ = State::Admitted;
+  on_admitted_();
+}
+
+int LimitedHandshake::sslIndex() {
+  static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  RELEASE_ASSERT(index >= 0, "");
+  return index;
+}
+
+bool LimitedHandshake::offersResumption(const SSL_CLIENT_HELLO* client_hello) {
+  const uint8_t* data;
+  size_t len;
+  // A pre-shared key for TLS 1.3.
+  if (SSL_early_callback_ctx_extension_get(client_hello, TLSEXT_TYPE_pre_shared_key, &data,
+                                           &len)) {
+    return true;
+  }
+  // A session ticket for TLS 1.2.
+  if (SSL_early_callback_ctx_extension_get(client_hello, TLSEXT_TYPE_session_ticket, &data,
+                                           &len) &&
+      len > 0) {
+    return true;
+  }
+  // A session ID for TLS 1.2. Clients offering TLS 1.3 send a session ID whether they resume or
+  // not, for compatibility with middleboxes.
+  return client_hello->session_id_len > 0 &&
+         !SSL_early_callback_ctx_extension_get(client_hello, TLSEXT_TYPE_supported_versions,
+                                               &data, &len);
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
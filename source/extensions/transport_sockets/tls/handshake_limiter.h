@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+
+#include "envoy/api/v2/auth/cert.pb.h"
+#include "envoy/common/pure.h"
+#include "envoy/server/overload_manager.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+// clang-format off
+#define ALL_HANDSHAKE_LIMITER_STATS(COUNTER, GAUGE)                                                \
+  COUNTER(handshake_delayed)                                                                       \
+  COUNTER(handshake_rejected)                                                                      \
+  GAUGE(handshake_active, Accumulate)                                                              \
+  GAUGE(handshake_queued, Accumulate)
+// clang-format on
+
+/**
+ * Wrapper struct for handshake limiter stats. @see stats_macros.h
+ */
+struct HandshakeLimiterStats {
+  ALL_HANDSHAKE_LIMITER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * The handshake limits of the connections of a listener, shared by its workers.
+ */
+struct HandshakeLimitsConfig {
+  HandshakeLimitsConfig(const envoy::api::v2::auth::HandshakeLimits& config,
+                        Server::OverloadManager* overload_manager, Stats::Scope& scope);
+
+  // Zero when not limited.
+  const uint32_t max_concurrent_;
+  const uint32_t overload_max_concurrent_;
+  const uint32_t max_queued_;
+  // nullptr if the handshakes are not limited while overloaded.
+  Server::OverloadManager* const overload_manager_;
+  HandshakeLimiterStats stats_;
+};
+
+using HandshakeLimitsConfigSharedPtr = std::shared_ptr<HandshakeLimitsConfig>;
+
+/**
+ * Limits the handshakes in progress on a worker. The handshakes beyond the limit are queued until
+ * others complete, those resuming sessions first. It is per worker, and its operations are not
+ * protected.
+ */
+class HandshakeLimiter : public ThreadLocal::ThreadLocalObject {
+public:
+  /**
+   * A handshake waiting to start.
+   */
+  class Waiter {
+  public:
+    virtual ~Waiter() = default;
+
+    /**
+     * Called once the handshake may go on.
+     */
+    virtual void onHandshakeAdmitted() PURE;
+  };
+
+  enum class Admission { Admitted, Queued, Rejected };
+
+  explicit HandshakeLimiter(HandshakeLimitsConfigSharedPtr config) : config_(std::move(config)) {}
+
+  /**
+   * Start a handshake if the limit allows, or queue it.
+   * @param waiter supplies the waiter called back once a queued handshake is admitted.
+   * @param resumption supplies whether the handshake offers to resume a session.
+   * @return whether the handshake was admitted, in which case release() must be called when it
+   *         completes, queued, in which case the waiter must be cancelled if it is destroyed first,
+   *         or rejected as the queue is full.
+   */
+  Admission admit(Waiter& waiter, bool resumption);
+
+  /**
+   * Complete an admitted handshake, admitting the queued ones the limit allows.
+   */
+  void release();
+
+  /**
+   * Remove a queued handshake.
+   */
+  void cancel(Waiter& waiter);
+
+private:
+  void admitQueued();
+  uint32_t limit() const;
+  size_t queued() const { return resumptions_.size() + full_handshakes_.size(); }
+
+  const HandshakeLimitsConfigSharedPtr config_;
+  uint32_t active_{};
+  std::list<Waiter*> resumptions_;
+  std::list<Waiter*> full_handshakes_;
+};
+
+using HandshakeLimiterSharedPtr = std::shared_ptr<HandshakeLimiter>;
+
+/**
+ * The handshake of a connection whose start is limited by a HandshakeLimiter. It is attached to
+ * the SSL of the connection, and waits for admission when the ClientHello is received, through
+ * onClientHello() called by the certificate selection of the context.
+ */
+class LimitedHandshake : public HandshakeLimiter::Waiter {
+public:
+  /**
+   * @param on_admitted supplies the callback resuming the handshake once a queued one is admitted.
+   */
+  LimitedHandshake(SSL* ssl, HandshakeLimiterSharedPtr limiter, std::function<void()> on_admitted);
+  ~LimitedHandshake() override;
+
+  /**
+   * @return the limited handshake attached to an SSL, or nullptr.
+   */
+  static LimitedHandshake* get(SSL* ssl);
+
+  /**
+   * @return ssl_select_cert_success once the handshake is admitted, ssl_select_cert_retry while it
+   *         is queued, or ssl_select_cert_error if it was rejected.
+   */
+  ssl_select_cert_result_t onClientHello(const SSL_CLIENT_HELLO* client_hello);
+
+  /**
+   * Release the admission of the handshake, once it completed.
+   */
+  void onHandshakeComplete();
+
+  // HandshakeLimiter::Waiter
+  void onHandshakeAdmitted() override;
+
+private:
+  enum class State { WaitingForHello, Queued, Admitted, Done };
+
+  static int sslIndex();
+  static bool offersResumption(const SSL_CLIENT_HELLO* client_hello);
+
+  const HandshakeLimiterSharedPtr limiter_;
+  const std::function<void()> on_admitted_;
+  State state_{State::WaitingForHello};
+};
+
+using LimitedHandshakePtr = std::unique_ptr<LimitedHandshake>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
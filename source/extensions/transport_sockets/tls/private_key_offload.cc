@@ -0,0 +1,202 @@
+#include "extensions/transport_sockets/tls/private_key_offload.h"
+
+#include <cstring>
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+PrivateKeyOffloadPoolImpl::PrivateKeyOffloadPoolImpl(Thread::ThreadFactory& thread_factory,
+                                                     uint32_t threads) {
+  for (uint32_t i = 0; i < threads; i++) {
+    threads_.emplace_back(thread_factory.createThread([this]() { threadRoutine(); }));
+  }
+}
+
+PrivateKeyOffloadPoolImpl::~PrivateKeyOffloadPoolImpl() {
+  {
+    Thread::LockGuard lock(lock_);
+    shutdown_ = true;
+    cond_.notifyAll();
+  }
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+void PrivateKeyOffloadPoolImpl::post(std::function<void()> operation) {
+  Thread::LockGuard lock(lock_);
+  operations_.push_back(std::move(operation));
+  cond_.notifyOne();
+}
+
+void PrivateKeyOffloadPoolImpl::threadRoutine() {
+  while (true) {
+    std::function<void()> operation;
+    {
+      Thread::LockGuard lock(lock_);
+      while (operations_.empty() && !shutdown_) {
+        cond_.wait(lock_);
+      }
+      if (shutdown_) {
+        return;
+      }
+      operation = std::move(operations_.front());
+      operations_.pop_front();
+    }
+    operation();
+  }
+}
+
+PrivateKeyConnection::PrivateKeyConnection(SSL* ssl, Envoy::Ssl::PrivateKeyOffloadPool& pool,
+                                           Event::Dispatcher& dispatcher,
+                                           std::function<void()> on_complete)
+    : pool_(pool), dispatcher_(dispatcher), on_complete_(std::move(on_complete)) {
+  SSL_set_ex_data(ssl, sslIndex(), this);
+}
+
+PrivateKeyConnection::~PrivateKeyConnection() {
+  if (operation_ != nullptr) {
+    Thread::LockGuard lock(operation_->lock_);
+    operation_->cancelled_ = true;
+  }
+}
+
+const SSL_PRIVATE_KEY_METHOD* PrivateKeyConnection::method() {
+  static const SSL_PRIVATE_KEY_METHOD method = {sign, decrypt, complete};
+  return &method;
+}
+
+int PrivateKeyConnection::sslIndex() {
+  static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  RELEASE_ASSERT(index >= 0, "");
+  return index;
+}
+
+PrivateKeyConnection* PrivateKeyConnection::get(SSL* ssl) {
+  return static_cast<PrivateKeyConnection*>(SSL_get_ex_data(ssl, sslIndex()));
+}
+
+ssl_private_key_result_t PrivateKeyConnection::sign(SSL* ssl, uint8_t*, size_t*, size_t,
+                                                    uint16_t signature_algorithm,
+                                                    const uint8_t* in, size_t in_len) {
+  PrivateKeyConnection* connection = get(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  std::vector<uint8_t> input(in, in + in_len);
+  return connection->start(
+      ssl, [signature_algorithm, input](EVP_PKEY* key, std::vector<uint8_t>& output) -> bool {
+        if (EVP_PKEY_id(key) != SSL_get_signature_algorithm_key_type(signature_algorithm)) {
+          return false;
+        }
+        bssl::ScopedEVP_MD_CTX ctx;
+        EVP_PKEY_CTX* pkey_ctx;
+        if (!EVP_DigestSignInit(ctx.get(), &pkey_ctx,
+                                SSL_get_signature_algorithm_digest(signature_algorithm), nullptr,
+                                key)) {
+          return false;
+        }
+        if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm) &&
+            (!EVP_PKEY_CTX_set_rsa_padding(pkey_ctx, RSA_PKCS1_PSS_PADDING) ||
+             !EVP_PKEY_CTX_set_rsa_pss_saltlen(pkey_ctx, -1))) {
+          return false;
+        }
+        size_t len = EVP_PKEY_size(key);
+        output.resize(len);
+        if (!EVP_DigestSign(ctx.get(), output.data(), &len, input.data(), input.size())) {
+          return false;
+        }
+        output.resize(len);
+        return true;
+      });
+}
+
+ssl_private_key_result_t PrivateKeyConnection::decrypt(SSL* ssl, uint8_t*, size_t*, size_t,
+                                                       const uint8_t* in, size_t in_len) {
+  PrivateKeyConnection* connection = get(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  std::vector<uint8_t> input(in, in + in_len);
+  return connection->start(ssl, [input](EVP_PKEY* key, std::vector<uint8_t>& output) -> bool {
+    RSA* rsa = EVP_PKEY_get0_RSA(key);
+    if (rsa == nullptr) {
+      return false;
+    }
+    size_t len = RSA_size(rsa);
+    output.resize(len);
+    if (!RSA_decrypt(rsa, &len, output.data(), output.size(), input.data(), input.size(),
+                     RSA_NO_PADDING)) {
+      return false;
+    }
+    output.resize(len);
+    return true;
+  });
+}
+
+ssl_private_key_result_t PrivateKeyConnection::complete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                                        size_t max_out) {
+  PrivateKeyConnection* connection = get(ssl);
+  if (connection == nullptr || connection->operation_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+  OperationSharedPtr operation = connection->operation_;
+  Thread::LockGuard lock(operation->lock_);
+  if (!operation->done_) {
+    return ssl_private_key_retry;
+  }
+  connection->operation_.reset();
+  if (operation->failed_ || operation->output_.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+  memcpy(out, operation->output_.data(), operation->output_.size());
+  *out_len = operation->output_.size();
+  return ssl_private_key_success;
+}
+
+ssl_private_key_result_t
+PrivateKeyConnection::start(SSL* ssl,
+                            std::function<bool(EVP_PKEY*, std::vector<uint8_t>&)> compute) {
+  // The key is held by the operation, as the context may be released while it is pending.
+  EVP_PKEY* raw_key = SSL_get_privatekey(ssl);
+  if (raw_key == nullptr || operation_ != nullptr) {
+    return ssl_private_key_failure;
+  }
+  EVP_PKEY_up_ref(raw_key);
+  std::shared_ptr<EVP_PKEY> key(raw_key, EVP_PKEY_free);
+
+  OperationSharedPtr operation = std::make_shared<Operation>();
+  operation_ = operation;
+  pool_.post([this, operation, key, compute]() {
+    std::vector<uint8_t> output;
+    const bool succeeded = compute(key.get(), output);
+
+    Thread::LockGuard lock(operation->lock_);
+    operation->done_ = true;
+    operation->failed_ = !succeeded;
+    operation->output_ = std::move(output);
+    // The connection, and so its dispatcher, is alive as long as the operation is not cancelled.
+    if (!operation->cancelled_) {
+      dispatcher_.post([this, operation]() {
+        {
+          Thread::LockGuard lock(operation->lock_);
+          if (operation->cancelled_) {
+            return;
+          }
+        }
+        on_complete_();
+      });
+    }
+  });
+  return ssl_private_key_retry;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
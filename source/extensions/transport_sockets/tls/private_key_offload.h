@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/ssl/private_key_offload.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A fixed pool of threads running the operations posted to it in order.
+ */
+class PrivateKeyOffloadPoolImpl : public Envoy::Ssl::PrivateKeyOffloadPool {
+public:
+  PrivateKeyOffloadPoolImpl(Thread::ThreadFactory& thread_factory, uint32_t threads);
+  ~PrivateKeyOffloadPoolImpl() override;
+
+  // Ssl::PrivateKeyOffloadPool
+  void post(std::function<void()> operation) override;
+
+private:
+  void threadRoutine();
+
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar cond_;
+  std::list<std::function<void()>> operations_ GUARDED_BY(lock_);
+  bool shutdown_ GUARDED_BY(lock_){};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+/**
+ * The private key operations of the handshake of a connection, run by a pool of threads. Once
+ * installed on an SSL whose context uses method(), the operations return ssl_private_key_retry
+ * while pending on the pool, and on_complete is called on the dispatcher of the connection when
+ * the handshake may be resumed. Destroying it abandons the pending operation.
+ */
+class PrivateKeyConnection {
+public:
+  PrivateKeyConnection(SSL* ssl, Envoy::Ssl::PrivateKeyOffloadPool& pool,
+                       Event::Dispatcher& dispatcher, std::function<void()> on_complete);
+  ~PrivateKeyConnection();
+
+  /**
+   * @return the private key method to set on the SSL contexts offloading their operations.
+   */
+  static const SSL_PRIVATE_KEY_METHOD* method();
+
+private:
+  struct Operation {
+    Thread::MutexBasicLockable lock_;
+    bool cancelled_ GUARDED_BY(lock_){};
+    bool done_ GUARDED_BY(lock_){};
+    bool failed_ GUARDED_BY(lock_){};
+    std::vector<uint8_t> output_ GUARDED_BY(lock_);
+  };
+  using OperationSharedPtr = std::shared_ptr<Operation>;
+
+  static int sslIndex();
+  static PrivateKeyConnection* get(SSL* ssl);
+
+  static ssl_private_key_result_t sign(SSL* ssl, uint8_t* out, size_t* out_len, size_t max_out,
+                                       uint16_t signature_algorithm, const uint8_t* in,
+                                       size_t in_len);
+  static ssl_private_key_result_t decrypt(SSL* ssl, uint8_t* out, size_t* out_len, size_t max_out,
+                                          const uint8_t* in, size_t in_len);
+  static ssl_private_key_result_t complete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                           size_t max_out);
+
+  // Runs compute on the pool with the private key of the SSL, and delivers its output.
+  ssl_private_key_result_t start(SSL* ssl,
+                                 std::function<bool(EVP_PKEY*, std::vector<uint8_t>&)> compute);
+
+  Envoy::Ssl::PrivateKeyOffloadPool& pool_;
+  Event::Dispatcher& dispatcher_;
+  const std::function<void()> on_complete_;
+  OperationSharedPtr operation_;
+};
+
+using PrivateKeyConnectionPtr = std::unique_ptr<PrivateKeyConnection>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,64 @@
+#include "extensions/transport_sockets/tls/session_cache_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+void SessionCacheImpl::store(const std::string& key, std::vector<uint8_t>&& session) {
+  absl::MutexLock l(&lock_);
+  const auto it = map_.find(key);
+  if (it != map_.end()) {
+    it->second->second = std::move(session);
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return;
+  }
+
+  if (max_entries_ == 0) {
+    return;
+  }
+  if (lru_.size() >= max_entries_) {
+    map_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+  lru_.emplace_front(key, std::move(session));
+  map_.emplace(lru_.front().first, lru_.begin());
+}
+
+std::vector<uint8_t> SessionCacheImpl::lookup(const std::string& key) {
+  absl::MutexLock l(&lock_);
+  const auto it = map_.find(key);
+  if (it == map_.end()) {
+    return {};
+  }
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->second;
+}
+
+void SessionCacheImpl::remove(const std::string& key) {
+  absl::MutexLock l(&lock_);
+  const auto it = map_.find(key);
+  if (it == map_.end()) {
+    return;
+  }
+  const LruList::iterator entry = it->second;
+  map_.erase(it);
+  lru_.erase(entry);
+}
+
+void SessionCacheImpl::iterate(const IterateCb& cb) {
+  absl::MutexLock l(&lock_);
+  for (auto it = lru_.rbegin(); it != lru_.rend(); ++it) {
+    cb(it->first, it->second);
+  }
+}
+
+size_t SessionCacheImpl::size() {
+  absl::MutexLock l(&lock_);
+  return lru_.size();
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
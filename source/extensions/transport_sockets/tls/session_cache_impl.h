@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "envoy/ssl/session_cache.h"
+
+#include "common/common/thread_annotations.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A bounded LRU session cache in the memory of the process.
+ */
+class SessionCacheImpl : public Envoy::Ssl::SessionCache {
+public:
+  // The default size of the session cache of BoringSSL.
+  static constexpr uint32_t DefaultMaxEntries = 20480;
+
+  /**
+   * @param max_entries supplies the maximum number of stored sessions, beyond which the least
+   *        recently used one is evicted.
+   */
+  explicit SessionCacheImpl(uint32_t max_entries) : max_entries_(max_entries) {}
+
+  // Ssl::SessionCache
+  void store(const std::string& key, std::vector<uint8_t>&& session) override;
+  std::vector<uint8_t> lookup(const std::string& key) override;
+  void remove(const std::string& key) override;
+  void iterate(const IterateCb& cb) override;
+
+  /**
+   * @return the number of stored sessions.
+   */
+  size_t size();
+
+private:
+  using LruList = std::list<std::pair<std::string, std::vector<uint8_t>>>;
+
+  const uint32_t max_entries_;
+  absl::Mutex lock_;
+  // Most recently used first.
+  LruList lru_ GUARDED_BY(lock_);
+  // Keyed by views of the keys held in lru_.
+  absl::flat_hash_map<absl::string_view, LruList::iterator> map_ GUARDED_BY(lock_);
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
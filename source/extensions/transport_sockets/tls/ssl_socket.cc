@@ -13,6 +13,18 @@
 #include "openssl/err.h"
 #include "openssl/x509v3.h"
 
+#if defined(__linux__) && __has_include(<linux/tls.h>)
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+
+#define ENVOY_KERNEL_TLS 1
+#endif
+
 using Envoy::Network::PostIoAction;
 
 namespace Envoy {
@@ -40,13 +52,36 @@ public:
   void onConnected() override {}
   const Ssl::ConnectionInfo* ssl() const override { return nullptr; }
 };
+
+#ifdef ENVOY_KERNEL_TLS
+// Fills in the kernel's AES-GCM crypto info, whose layout only differs in the key size, and sets
+// it as the transmit state of the socket.
+template <class CryptoInfo>
+int setKernelTlsTx(int fd, uint16_t cipher_type, const uint8_t* key, const uint8_t* salt,
+                   const uint8_t* sequence) {
+  CryptoInfo info;
+  memset(&info, 0, sizeof(info));
+  info.info.version = TLS_1_2_VERSION;
+  info.info.cipher_type = cipher_type;
+  memcpy(info.key, key, sizeof(info.key));
+  memcpy(info.salt, salt, sizeof(info.salt));
+  // The TLS 1.2 explicit nonce is the record sequence number, as chosen by BoringSSL.
+  memcpy(info.iv, sequence, sizeof(info.iv));
+  memcpy(info.rec_seq, sequence, sizeof(info.rec_seq));
+  const int rc = setsockopt(fd, SOL_TLS, TLS_TX, &info, sizeof(info));
+  OPENSSL_cleanse(&info, sizeof(info));
+  return rc;
+}
+#endif
 } // namespace
 
 SslSocket::SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
-                     const Network::TransportSocketOptionsSharedPtr& transport_socket_options)
+                     const Network::TransportSocketOptionsSharedPtr& transport_socket_options,
+                     HandshakeLimiterSharedPtr handshake_limiter)
     : transport_socket_options_(transport_socket_options),
       ctx_(std::dynamic_pointer_cast<ContextImpl>(ctx)),
-      ssl_(ctx_->newSsl(transport_socket_options_.get())) {
+      ssl_(ctx_->newSsl(transport_socket_options_.get())),
+      handshake_limiter_(std::move(handshake_limiter)) {
   if (state == InitialState::Client) {
     SSL_set_connect_state(ssl_.get());
   } else {
@@ -61,6 +96,20 @@ void SslSocket::setTransportSocketCallbacks(Network::TransportSocketCallbacks& c
 
   BIO* bio = BIO_new_socket(callbacks_->ioHandle().fd(), 0);
   SSL_set_bio(ssl_.get(), bio, bio);
+
+  if (ctx_->privateKeyOffloadPool() != nullptr) {
+    // Once the operation completes, the handshake is resumed as if the socket was readable.
+    private_key_connection_ = std::make_unique<PrivateKeyConnection>(
+        ssl_.get(), *ctx_->privateKeyOffloadPool(), callbacks_->connection().dispatcher(),
+        [this]() { callbacks_->setReadBufferReady(); });
+  }
+
+  if (handshake_limiter_ != nullptr) {
+    // Once admitted, a queued handshake is resumed as if the socket was readable.
+    limited_handshake_ =
+        std::make_unique<LimitedHandshake>(ssl_.get(), std::move(handshake_limiter_),
+                                           [this]() { callbacks_->setReadBufferReady(); });
+  }
 }
 
 SslSocket::ReadResult SslSocket::sslReadIntoSlice(Buffer::RawSlice& slice) {
@@ -155,7 +204,19 @@ PostIoAction SslSocket::doHandshake() {
   if (rc == 1) {
     ENVOY_CONN_LOG(debug, "handshake complete", callbacks_->connection());
     handshake_complete_ = true;
+    if (limited_handshake_ != nullptr) {
+      limited_handshake_->onHandshakeComplete();
+    }
     ctx_->logHandshake(ssl_.get());
+    if (ctx_->kernelTlsOffload()) {
+      ktls_tx_ = enableKernelTlsTx();
+      if (ktls_tx_) {
+        ENVOY_CONN_LOG(debug, "TLS transmit offloaded to the kernel", callbacks_->connection());
+        ctx_->stats().ktls_tx_enabled_.inc();
+      } else {
+        ctx_->stats().ktls_tx_unsupported_.inc();
+      }
+    }
     callbacks_->raiseEvent(Network::ConnectionEvent::Connected);
 
     // It's possible that we closed during the handshake callback.
@@ -168,6 +229,8 @@ PostIoAction SslSocket::doHandshake() {
     switch (err) {
     case SSL_ERROR_WANT_READ:
     case SSL_ERROR_WANT_WRITE:
+    case SSL_ERROR_WANT_PRIVATE_KEY_OPERATION:
+    case SSL_ERROR_PENDING_CERTIFICATE:
       return PostIoAction::KeepOpen;
     default:
       drainErrorQueue();
@@ -212,12 +275,26 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (ktls_tx_) {
+    return doKernelTlsWrite(write_buffer, end_stream);
+  }
+
+  const Envoy::Ssl::DynamicRecordSizing* sizing = ctx_->dynamicRecordSizing();
+  MonotonicTime now;
+  if (sizing != nullptr) {
+    now = callbacks_->connection().dispatcher().approximateMonotonicTime();
+    if (now - last_write_time_ >= sizing->idle_timeout_) {
+      // The congestion window may have shrunk while idle, so start over with small records.
+      bytes_since_idle_ = 0;
+    }
+  }
+
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
     bytes_to_retry_ = 0;
   } else {
-    bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+    bytes_to_write = std::min(write_buffer.length(), recordSize(sizing));
   }
 
   uint64_t total_bytes_written = 0;
@@ -233,9 +310,15 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     ENVOY_CONN_LOG(trace, "ssl write returns: {}", callbacks_->connection(), rc);
     if (rc > 0) {
       ASSERT(rc == static_cast<int>(bytes_to_write));
+      if (recordSize(sizing) < SSL3_RT_MAX_PLAIN_LENGTH) {
+        ctx_->stats().write_record_small_.inc();
+      } else {
+        ctx_->stats().write_record_full_.inc();
+      }
+      bytes_since_idle_ += rc;
       total_bytes_written += rc;
       write_buffer.drain(rc);
-      bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+      bytes_to_write = std::min(write_buffer.length(), recordSize(sizing));
     } else {
       int err = SSL_get_error(ssl_.get(), rc);
       switch (err) {
@@ -253,6 +336,13 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (total_bytes_written > 0) {
+    ctx_->stats().write_flush_.inc();
+    if (sizing != nullptr) {
+      last_write_time_ = now;
+    }
+  }
+
   if (write_buffer.length() == 0 && end_stream) {
     shutdownSsl();
   }
@@ -260,14 +350,137 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+uint64_t SslSocket::recordSize(const Envoy::Ssl::DynamicRecordSizing* sizing) const {
+  if (sizing != nullptr && bytes_since_idle_ < sizing->ramp_up_bytes_) {
+    return sizing->initial_record_size_;
+  }
+  return SSL3_RT_MAX_PLAIN_LENGTH;
+}
+
+Network::IoResult SslSocket::doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream) {
+  // The kernel frames and encrypts whatever is written, so this is the raw socket write loop.
+  uint64_t bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    Api::IoCallUint64Result result = write_buffer.write(callbacks_->ioHandle());
+    if (!result.ok()) {
+      ENVOY_CONN_LOG(trace, "ktls write error: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails());
+      if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+        break;
+      }
+      return {PostIoAction::Close, bytes_written, false};
+    }
+    ENVOY_CONN_LOG(trace, "ktls write returns: {}", callbacks_->connection(), result.rc_);
+    bytes_written += result.rc_;
+  }
+
+  if (write_buffer.length() == 0 && end_stream) {
+    shutdownSsl();
+  }
+
+  return {PostIoAction::KeepOpen, bytes_written, false};
+}
+
+bool SslSocket::enableKernelTlsTx() {
+#ifdef ENVOY_KERNEL_TLS
+  SSL* ssl = ssl_.get();
+  if (SSL_version(ssl) != TLS1_2_VERSION) {
+    return false;
+  }
+  const int cipher_nid = SSL_CIPHER_get_cipher_nid(SSL_get_current_cipher(ssl));
+  uint16_t cipher_type;
+  size_t key_len;
+  if (cipher_nid == NID_aes_128_gcm) {
+    cipher_type = TLS_CIPHER_AES_GCM_128;
+    key_len = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+  } else if (cipher_nid == NID_aes_256_gcm) {
+    cipher_type = TLS_CIPHER_AES_GCM_256;
+    key_len = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+  } else {
+    return false;
+  }
+
+  // For AEAD ciphers the TLS 1.2 key block holds the client and server write keys followed by the
+  // client and server implicit nonce salts (RFC 5288).
+  constexpr size_t salt_len = TLS_CIPHER_AES_GCM_128_SALT_SIZE;
+  uint8_t key_block[2 * TLS_CIPHER_AES_GCM_256_KEY_SIZE + 2 * salt_len];
+  const size_t key_block_len = 2 * key_len + 2 * salt_len;
+  if (SSL_get_key_block_len(ssl) != key_block_len ||
+      !SSL_generate_key_block(ssl, key_block, key_block_len)) {
+    drainErrorQueue();
+    return false;
+  }
+  const bool is_server = SSL_is_server(ssl);
+  const uint8_t* key = key_block + (is_server ? key_len : 0);
+  const uint8_t* salt = key_block + 2 * key_len + (is_server ? salt_len : 0);
+
+  uint8_t sequence[TLS_CIPHER_AES_GCM_128_REC_SEQ_SIZE];
+  uint64_t write_sequence = SSL_get_write_sequence(ssl);
+  for (int i = sizeof(sequence) - 1; i >= 0; i--) {
+    sequence[i] = write_sequence & 0xff;
+    write_sequence >>= 8;
+  }
+
+  const int fd = callbacks_->ioHandle().fd();
+  int rc = setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls"));
+  if (rc == 0) {
+    // If this fails the upper layer protocol stays attached but passes writes through, so the
+    // socket keeps working with records encrypted by BoringSSL.
+    rc = cipher_type == TLS_CIPHER_AES_GCM_128
+             ? setKernelTlsTx<tls12_crypto_info_aes_gcm_128>(fd, cipher_type, key, salt, sequence)
+             : setKernelTlsTx<tls12_crypto_info_aes_gcm_256>(fd, cipher_type, key, salt, sequence);
+  }
+  const int error = errno;
+  OPENSSL_cleanse(key_block, sizeof(key_block));
+  if (rc != 0) {
+    ENVOY_CONN_LOG(debug, "unable to offload TLS transmit to the kernel: {}",
+                   callbacks_->connection(), strerror(error));
+    return false;
+  }
+
+  // BoringSSL's write state is now stale. Anything it still tries to send, such as an alert on a
+  // failed read, is discarded rather than corrupting the record stream.
+  SSL_set0_wbio(ssl, BIO_new(BIO_s_mem()));
+  return true;
+#else
+  return false;
+#endif
+}
+
+void SslSocket::sendKernelTlsCloseNotify() {
+#ifdef ENVOY_KERNEL_TLS
+  // A warning level close_notify alert, sent as a record of type alert.
+  uint8_t alert[2] = {SSL3_AL_WARNING, SSL_AD_CLOSE_NOTIFY};
+  iovec iov = {alert, sizeof(alert)};
+  char control[CMSG_SPACE(sizeof(uint8_t))];
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+  *CMSG_DATA(cmsg) = SSL3_RT_ALERT;
+  const ssize_t rc = sendmsg(callbacks_->ioHandle().fd(), &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+  ENVOY_CONN_LOG(debug, "ktls close_notify: rc={}", callbacks_->connection(), rc);
+#endif
+}
+
 void SslSocket::onConnected() { ASSERT(!handshake_complete_); }
 
 void SslSocket::shutdownSsl() {
   ASSERT(handshake_complete_);
   if (!shutdown_sent_ && callbacks_->connection().state() != Network::Connection::State::Closed) {
-    int rc = SSL_shutdown(ssl_.get());
-    ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
-    drainErrorQueue();
+    if (ktls_tx_) {
+      sendKernelTlsCloseNotify();
+    } else {
+      int rc = SSL_shutdown(ssl_.get());
+      ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
+      drainErrorQueue();
+    }
     shutdown_sent_ = true;
   }
 }
@@ -508,7 +721,7 @@ Network::TransportSocketPtr ClientSslSocketFactory::createTransportSocket(
   }
   if (ssl_ctx) {
     return std::make_unique<SslSocket>(std::move(ssl_ctx), InitialState::Client,
-                                       transport_socket_options);
+                                       transport_socket_options, nullptr);
   } else {
     ENVOY_LOG(debug, "Create NotReadySslSocket");
     stats_.upstream_context_secrets_not_ready_.inc();
@@ -548,7 +761,11 @@ ServerSslSocketFactory::createTransportSocket(Network::TransportSocketOptionsSha
     ssl_ctx = ssl_ctx_;
   }
   if (ssl_ctx) {
-    return std::make_unique<SslSocket>(std::move(ssl_ctx), InitialState::Server, nullptr);
+    return std::make_unique<SslSocket>(
+        std::move(ssl_ctx), InitialState::Server, nullptr,
+        handshake_limiter_slot_ != nullptr
+            ? std::dynamic_pointer_cast<HandshakeLimiter>(handshake_limiter_slot_->get())
+            : nullptr);
   } else {
     ENVOY_LOG(debug, "Create NotReadySslSocket");
     stats_.downstream_context_secrets_not_ready_.inc();
@@ -558,6 +775,15 @@ ServerSslSocketFactory::createTransportSocket(Network::TransportSocketOptionsSha
 
 bool ServerSslSocketFactory::implementsSecureTransport() const { return true; }
 
+void ServerSslSocketFactory::limitHandshakes(HandshakeLimitsConfigSharedPtr config,
+                                             ThreadLocal::SlotAllocator& tls) {
+  handshake_limiter_slot_ = tls.allocateSlot();
+  handshake_limiter_slot_->set(
+      [config](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+        return std::make_shared<HandshakeLimiter>(config);
+      });
+}
+
 void ServerSslSocketFactory::onAddOrUpdateSecret() {
   ENVOY_LOG(debug, "Secret is updated.");
   {
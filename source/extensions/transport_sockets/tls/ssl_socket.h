@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <string>
 
+#include "envoy/common/time.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/secret/secret_callbacks.h"
@@ -12,6 +13,8 @@
 #include "common/common/logger.h"
 
 #include "extensions/transport_sockets/tls/context_impl.h"
+#include "extensions/transport_sockets/tls/handshake_limiter.h"
+#include "extensions/transport_sockets/tls/private_key_offload.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
 #include "absl/synchronization/mutex.h"
@@ -44,7 +47,8 @@ class SslSocket : public Network::TransportSocket,
                   protected Logger::Loggable<Logger::Id::connection> {
 public:
   SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
-            const Network::TransportSocketOptionsSharedPtr& transport_socket_options);
+            const Network::TransportSocketOptionsSharedPtr& transport_socket_options,
+            HandshakeLimiterSharedPtr handshake_limiter);
 
   // Ssl::ConnectionInfo
   bool peerCertificatePresented() const override;
@@ -89,14 +93,33 @@ private:
   Network::PostIoAction doHandshake();
   void drainErrorQueue();
   void shutdownSsl();
+  // Installs the negotiated transmit keys in the kernel. Returns false, leaving the socket
+  // encrypting in user space, if the protocol version, cipher or kernel does not support it.
+  bool enableKernelTlsTx();
+  Network::IoResult doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream);
+  // Returns the plaintext size of the next record written, which is full-size unless the records
+  // are dynamically sized and the connection is still ramping up.
+  uint64_t recordSize(const Envoy::Ssl::DynamicRecordSizing* sizing) const;
+  void sendKernelTlsCloseNotify();
 
   const Network::TransportSocketOptionsSharedPtr transport_socket_options_;
   Network::TransportSocketCallbacks* callbacks_{};
   ContextImplSharedPtr ctx_;
   bssl::UniquePtr<SSL> ssl_;
+  // Set if the private key operations of the handshake are offloaded to a pool of threads.
+  PrivateKeyConnectionPtr private_key_connection_;
+  // Set if the start of the handshake is limited by the handshakes in progress on the worker.
+  HandshakeLimiterSharedPtr handshake_limiter_;
+  LimitedHandshakePtr limited_handshake_;
   bool handshake_complete_{};
   bool shutdown_sent_{};
+  // Set once records are encrypted by the kernel. Writes then bypass BoringSSL.
+  bool ktls_tx_{};
   uint64_t bytes_to_retry_{};
+  // The bytes written since the connection was last idle, and when it last wrote. Only tracked
+  // if the records are dynamically sized.
+  uint64_t bytes_since_idle_{};
+  MonotonicTime last_write_time_{};
   std::string failure_reason_;
   mutable std::string cached_sha_256_peer_certificate_digest_;
   mutable std::string cached_url_encoded_pem_encoded_peer_certificate_;
@@ -141,12 +164,20 @@ public:
   // Secret::SecretCallbacks
   void onAddOrUpdateSecret() override;
 
+  /**
+   * Limit the handshakes in progress on each worker. Must be called on the main thread, before
+   * creating transport sockets.
+   */
+  void limitHandshakes(HandshakeLimitsConfigSharedPtr config, ThreadLocal::SlotAllocator& tls);
+
 private:
   Ssl::ContextManager& manager_;
   Stats::Scope& stats_scope_;
   SslSocketFactoryStats stats_;
   Envoy::Ssl::ServerContextConfigPtr config_;
   const std::vector<std::string> server_names_;
+  // Holds the HandshakeLimiter of each worker, if the handshakes are limited.
+  ThreadLocal::SlotPtr handshake_limiter_slot_;
   mutable absl::Mutex ssl_ctx_mu_;
   Envoy::Ssl::ServerContextSharedPtr ssl_ctx_ GUARDED_BY(ssl_ctx_mu_);
 };
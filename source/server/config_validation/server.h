@@ -99,6 +99,7 @@ public:
   const LocalInfo::LocalInfo& localInfo() override { return *local_info_; }
   TimeSource& timeSource() override { return api_->timeSource(); }
   Envoy::MutexTracer* mutexTracer() override { return mutex_tracer_; }
+  GuardDog* guardDog() override { return nullptr; }
 
   std::chrono::milliseconds statsFlushInterval() const override {
     return config_.statsFlushInterval();
@@ -112,7 +113,8 @@ public:
   LdsApiPtr createLdsApi(const envoy::api::v2::core::ConfigSource& lds_config) override {
     return std::make_unique<LdsApiImpl>(lds_config, clusterManager(), initManager(), stats(),
                                         listenerManager(),
-                                        messageValidationContext().dynamicValidationVisitor());
+                                        messageValidationContext().dynamicValidationVisitor(),
+                                        api());
   }
   std::vector<Network::FilterFactoryCb> createNetworkFilterFactoryList(
       const Protobuf::RepeatedPtrField<envoy::api::v2::listener::Filter>& filters,
@@ -137,13 +139,19 @@ public:
     // validation mock.
     return nullptr;
   }
+  Network::SocketSharedPtr createReusePortListenSocket(Network::Address::InstanceConstSharedPtr,
+                                                       Network::Address::SocketType,
+                                                       const Network::Socket::OptionsSharedPtr&,
+                                                       uint32_t) override {
+    return nullptr;
+  }
   DrainManagerPtr createDrainManager(envoy::api::v2::Listener::DrainType) override {
     return nullptr;
   }
   uint64_t nextListenerTag() override { return 0; }
 
   // Server::WorkerFactory
-  WorkerPtr createWorker(OverloadManager&) override {
+  WorkerPtr createWorker(OverloadManager&, uint32_t) override {
     // Returned workers are not currently used so we can return nothing here safely vs. a
     // validation mock.
     return nullptr;
@@ -12,16 +12,20 @@
 #include "envoy/server/instance.h"
 #include "envoy/server/tracer_config.h"
 #include "envoy/ssl/context_manager.h"
+#include "envoy/stats/timespan.h"
 
 #include "common/common/assert.h"
 #include "common/common/utility.h"
 #include "common/config/runtime_utility.h"
 #include "common/config/utility.h"
 #include "common/network/socket_option_factory.h"
+#include "common/protobuf/message_validator_impl.h"
 #include "common/protobuf/utility.h"
 #include "common/runtime/runtime_impl.h"
 #include "common/tracing/http_tracer_impl.h"
 
+#include "extensions/transport_sockets/well_known_names.h"
+
 namespace Envoy {
 namespace Server {
 namespace Configuration {
@@ -55,9 +59,77 @@ bool FilterChainUtility::buildUdpFilterChain(
   return true;
 }
 
+namespace {
+
+/**
+ * Collects the certificates and validation contexts of the TLS contexts of a bootstrap.
+ */
+class TlsCertificateCollector {
+public:
+  void addCommonTlsContext(const envoy::api::v2::auth::CommonTlsContext& common_tls_context) {
+    for (const auto& tls_certificate : common_tls_context.tls_certificates()) {
+      tls_certificates_.push_back(&tls_certificate);
+    }
+    if (common_tls_context.has_validation_context()) {
+      validation_contexts_.push_back(&common_tls_context.validation_context());
+    } else if (common_tls_context.has_combined_validation_context()) {
+      validation_contexts_.push_back(
+          &common_tls_context.combined_validation_context().default_validation_context());
+    }
+  }
+
+  template <class TlsContext>
+  void addTransportSocket(const envoy::api::v2::core::TransportSocket& transport_socket) {
+    if (transport_socket.name() != Extensions::TransportSockets::TransportSocketNames::get().Tls) {
+      return;
+    }
+    auto tls_context = std::make_unique<TlsContext>();
+    try {
+      Config::Utility::translateOpaqueConfig(transport_socket.typed_config(),
+                                             transport_socket.config(),
+                                             ProtobufMessage::getNullValidationVisitor(),
+                                             *tls_context);
+    } catch (const EnvoyException&) {
+      // The error is reported when the transport socket is created.
+      return;
+    }
+    addCommonTlsContext(tls_context->common_tls_context());
+    translated_.push_back(std::move(tls_context));
+  }
+
+  void addSecret(const envoy::api::v2::auth::Secret& secret) {
+    if (secret.has_tls_certificate()) {
+      tls_certificates_.push_back(&secret.tls_certificate());
+    } else if (secret.has_validation_context()) {
+      validation_contexts_.push_back(&secret.validation_context());
+    }
+  }
+
+  std::vector<const envoy::api::v2::auth::TlsCertificate*> tls_certificates_;
+  std::vector<const envoy::api::v2::auth::CertificateValidationContext*> validation_contexts_;
+
+private:
+  std::vector<std::unique_ptr<Protobuf::Message>> translated_;
+};
+
+} // namespace
+
+InitializationStats MainImpl::generateInitializationStats(Stats::Scope& scope) {
+  const std::string prefix = "server.initialization.";
+  return {ALL_INITIALIZATION_STATS(POOL_HISTOGRAM_PREFIX(scope, prefix))};
+}
+
 void MainImpl::initialize(const envoy::config::bootstrap::v2::Bootstrap& bootstrap,
                           Instance& server,
                           Upstream::ClusterManagerFactory& cluster_manager_factory) {
+  InitializationStats stats = generateInitializationStats(server.stats());
+
+  // The contexts find the parsed certificates in the cache of the context manager while the
+  // handle is alive.
+  Stats::Timespan preload_timespan(stats.certificate_preload_ms_, server.timeSource());
+  const Ssl::CertificatePreloadPtr certificate_preload = preloadCertificates(bootstrap, server);
+  preload_timespan.complete();
+
   const auto& secrets = bootstrap.static_resources().secrets();
   ENVOY_LOG(info, "loading {} static secret(s)", secrets.size());
   for (ssize_t i = 0; i < secrets.size(); i++) {
@@ -66,14 +138,18 @@ void MainImpl::initialize(const envoy::config::bootstrap::v2::Bootstrap& bootstr
   }
 
   ENVOY_LOG(info, "loading {} cluster(s)", bootstrap.static_resources().clusters().size());
+  Stats::Timespan clusters_timespan(stats.clusters_ms_, server.timeSource());
   cluster_manager_ = cluster_manager_factory.clusterManagerFromProto(bootstrap);
+  clusters_timespan.complete();
 
   const auto& listeners = bootstrap.static_resources().listeners();
   ENVOY_LOG(info, "loading {} listener(s)", listeners.size());
+  Stats::Timespan listeners_timespan(stats.listeners_ms_, server.timeSource());
   for (ssize_t i = 0; i < listeners.size(); i++) {
     ENVOY_LOG(debug, "listener #{}:", i);
     server.listenerManager().addOrUpdateListener(listeners[i], "", false);
   }
+  listeners_timespan.complete();
 
   stats_flush_interval_ =
       std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(bootstrap, stats_flush_interval, 5000));
@@ -92,6 +168,42 @@ void MainImpl::initialize(const envoy::config::bootstrap::v2::Bootstrap& bootstr
   initializeStatsSinks(bootstrap, server);
 }
 
+Ssl::CertificatePreloadPtr
+MainImpl::preloadCertificates(const envoy::config::bootstrap::v2::Bootstrap& bootstrap,
+                              Instance& server) {
+  TlsCertificateCollector collector;
+  for (const auto& secret : bootstrap.static_resources().secrets()) {
+    collector.addSecret(secret);
+  }
+  for (const auto& cluster : bootstrap.static_resources().clusters()) {
+    if (cluster.has_transport_socket()) {
+      collector.addTransportSocket<envoy::api::v2::auth::UpstreamTlsContext>(
+          cluster.transport_socket());
+    } else if (cluster.has_tls_context()) {
+      collector.addCommonTlsContext(cluster.tls_context().common_tls_context());
+    }
+  }
+  for (const auto& listener : bootstrap.static_resources().listeners()) {
+    for (const auto& filter_chain : listener.filter_chains()) {
+      if (filter_chain.has_transport_socket()) {
+        collector.addTransportSocket<envoy::api::v2::auth::DownstreamTlsContext>(
+            filter_chain.transport_socket());
+      } else if (filter_chain.has_tls_context()) {
+        collector.addCommonTlsContext(filter_chain.tls_context().common_tls_context());
+      }
+    }
+  }
+  if (collector.tls_certificates_.empty() && collector.validation_contexts_.empty()) {
+    return nullptr;
+  }
+
+  ENVOY_LOG(info, "preloading {} certificate(s) and {} validation context(s)",
+            collector.tls_certificates_.size(), collector.validation_contexts_.size());
+  return server.sslContextManager().preloadCertificates(
+      collector.tls_certificates_, collector.validation_contexts_, server.api(),
+      server.options().concurrency());
+}
+
 void MainImpl::initializeTracers(const envoy::config::trace::v2::Tracing& configuration,
                                  Instance& server) {
   ENVOY_LOG(info, "loading tracing configuration");
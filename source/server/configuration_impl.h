@@ -16,6 +16,9 @@
 #include "envoy/server/configuration.h"
 #include "envoy/server/filter_config.h"
 #include "envoy/server/instance.h"
+#include "envoy/ssl/context_manager.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "common/common/logger.h"
 #include "common/json/json_loader.h"
@@ -88,6 +91,22 @@ public:
                       const std::vector<Network::UdpListenerFilterFactoryCb>& factories);
 };
 
+/**
+ * All the phases of the initialization of the server which are timed. @see stats_macros.h
+ */
+#define ALL_INITIALIZATION_STATS(HISTOGRAM)                                                        \
+  HISTOGRAM(certificate_preload_ms)                                                                \
+  HISTOGRAM(clusters_ms)                                                                           \
+  HISTOGRAM(listeners_ms)                                                                          \
+  HISTOGRAM(wasm_services_ms)
+
+/**
+ * Struct definition for the timing of the initialization phases. @see stats_macros.h
+ */
+struct InitializationStats {
+  ALL_INITIALIZATION_STATS(GENERATE_HISTOGRAM_STRUCT)
+};
+
 /**
  * Implementation of Server::Configuration::Main that reads a configuration from
  * a JSON file.
@@ -107,6 +126,12 @@ public:
   void initialize(const envoy::config::bootstrap::v2::Bootstrap& bootstrap, Instance& server,
                   Upstream::ClusterManagerFactory& cluster_manager_factory);
 
+  /**
+   * @param scope supplies the scope of the server stats.
+   * @return InitializationStats the stats timing the initialization phases.
+   */
+  static InitializationStats generateInitializationStats(Stats::Scope& scope);
+
   // Server::Configuration::Main
   Upstream::ClusterManager* clusterManager() override { return cluster_manager_.get(); }
   Tracing::HttpTracer& httpTracer() override { return *http_tracer_; }
@@ -122,6 +147,14 @@ public:
   }
 
 private:
+  /**
+   * Read and parse the certificates of the static listeners, clusters and secrets in parallel,
+   * ahead of the creation of their TLS contexts.
+   * @return the handle keeping the parsed certificates cached, or nullptr.
+   */
+  Ssl::CertificatePreloadPtr
+  preloadCertificates(const envoy::config::bootstrap::v2::Bootstrap& bootstrap, Instance& server);
+
   /**
    * Initialize tracers and corresponding sinks.
    */
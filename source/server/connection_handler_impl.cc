@@ -1,5 +1,7 @@
 #include "server/connection_handler_impl.h"
 
+#include <queue>
+
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
 #include "envoy/network/filter.h"
@@ -14,8 +16,10 @@
 namespace Envoy {
 namespace Server {
 
-ConnectionHandlerImpl::ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher)
-    : logger_(logger), dispatcher_(dispatcher), disable_listeners_(false) {}
+ConnectionHandlerImpl::ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher,
+                                             uint32_t worker_index)
+    : logger_(logger), dispatcher_(dispatcher), worker_index_(worker_index),
+      disable_listeners_(false) {}
 
 void ConnectionHandlerImpl::addListener(Network::ListenerConfig& config) {
   ActiveListenerBasePtr listener;
@@ -75,6 +79,66 @@ void ConnectionHandlerImpl::enableListeners() {
   }
 }
 
+void ConnectionHandlerImpl::forEachTcpListener(std::function<void(ActiveTcpListener&)> cb) {
+  for (auto& listener : listeners_) {
+    // TODO(sumukhs): Try to avoid dynamic_cast by coming up with a better interface design
+    ActiveTcpListener* tcp_listener = dynamic_cast<ActiveTcpListener*>(listener.second.get());
+    if (tcp_listener != nullptr) {
+      cb(*tcp_listener);
+    }
+  }
+}
+
+void ConnectionHandlerImpl::disableConnectionReads() {
+  disable_connection_reads_ = true;
+  forEachTcpListener([](ActiveTcpListener& listener) {
+    for (auto& connection : listener.connections_) {
+      connection->setReadsDisabled(true);
+    }
+  });
+}
+
+void ConnectionHandlerImpl::enableConnectionReads() {
+  disable_connection_reads_ = false;
+  forEachTcpListener([](ActiveTcpListener& listener) {
+    for (auto& connection : listener.connections_) {
+      connection->setReadsDisabled(false);
+    }
+  });
+}
+
+std::vector<Network::BufferedConnection>
+ConnectionHandlerImpl::topBufferedConnections(uint32_t limit) {
+  // Keep the largest connections seen so far in a min heap, so the scan is O(n log(limit)).
+  using Entry = std::pair<uint64_t, const ActiveConnection*>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> top;
+  if (limit > 0) {
+    forEachTcpListener([limit, &top](ActiveTcpListener& listener) {
+      for (const auto& connection : listener.connections_) {
+        const uint64_t buffered_bytes = connection->connection_->bufferedBytes();
+        if (buffered_bytes == 0) {
+          continue;
+        }
+        if (top.size() < limit) {
+          top.emplace(buffered_bytes, connection.get());
+        } else if (buffered_bytes > top.top().first) {
+          top.pop();
+          top.emplace(buffered_bytes, connection.get());
+        }
+      }
+    });
+  }
+
+  std::vector<Network::BufferedConnection> connections(top.size());
+  for (auto it = connections.rbegin(); it != connections.rend(); ++it) {
+    const ActiveConnection& connection = *top.top().second;
+    *it = {connection.connection_->id(), connection.listener_.config_.name(),
+           connection.connection_->remoteAddress()->asString(), top.top().first};
+    top.pop();
+  }
+  return connections;
+}
+
 void ConnectionHandlerImpl::ActiveTcpListener::removeConnection(ActiveConnection& connection) {
   ENVOY_CONN_LOG_TO_LOGGER(parent_.logger_, debug, "adding to cleanup list",
                            *connection.connection_);
@@ -82,6 +146,8 @@ void ConnectionHandlerImpl::ActiveTcpListener::removeConnection(ActiveConnection
   parent_.dispatcher_.deferredDelete(std::move(removed));
   ASSERT(parent_.num_connections_ > 0);
   parent_.num_connections_--;
+  ASSERT(num_listener_connections_ > 0);
+  num_listener_connections_--;
 }
 
 ConnectionHandlerImpl::ActiveListenerBase::ActiveListenerBase(ConnectionHandlerImpl& parent,
@@ -97,16 +163,22 @@ ConnectionHandlerImpl::ActiveTcpListener::ActiveTcpListener(ConnectionHandlerImp
                                                             Network::ListenerConfig& config)
     : ActiveTcpListener(
           parent,
-          parent.dispatcher_.createListener(config.socket(), *this, config.bindToPort(),
+          parent.dispatcher_.createListener(config.workerSocket(parent.worker_index_), *this,
+                                            config.bindToPort(),
                                             config.handOffRestoredDestinationConnections()),
           config) {}
 
 ConnectionHandlerImpl::ActiveTcpListener::ActiveTcpListener(ConnectionHandlerImpl& parent,
                                                             Network::ListenerPtr&& listener,
                                                             Network::ListenerConfig& config)
-    : ConnectionHandlerImpl::ActiveListenerBase(parent, std::move(listener), config) {}
+    : ConnectionHandlerImpl::ActiveListenerBase(parent, std::move(listener), config),
+      per_worker_stats_(generatePerHandlerStats(config.listenerScope(), parent.worker_index_)) {
+  config.connectionBalancer().registerHandler(*this);
+}
 
 ConnectionHandlerImpl::ActiveTcpListener::~ActiveTcpListener() {
+  config_.connectionBalancer().unregisterHandler(*this);
+
   // Purge sockets that have not progressed to connections. This should only happen when
   // a listener filter stops iteration and never resumes.
   while (!sockets_.empty()) {
@@ -223,8 +295,9 @@ void ConnectionHandlerImpl::ActiveSocket::newConnection() {
     // Hands off connections redirected by iptables to the listener associated with the
     // original destination address. Pass 'hand_off_restored_destination_connections' as false to
     // prevent further redirection.
-    tcp_listener->onAccept(std::move(socket_),
-                           false /* hand_off_restored_destination_connections */);
+    tcp_listener->onAcceptWorker(std::move(socket_),
+                                 false /* hand_off_restored_destination_connections */,
+                                 true /* rebalanced */, std::move(dynamic_metadata_));
   } else {
     // Set default transport protocol if none of the listener filters did it.
     if (socket_->detectedTransportProtocol().empty()) {
@@ -232,14 +305,31 @@ void ConnectionHandlerImpl::ActiveSocket::newConnection() {
           Extensions::TransportSockets::TransportSocketNames::get().RawBuffer);
     }
     // Create a new connection on this listener.
-    listener_.newConnection(std::move(socket_));
+    listener_.newConnection(std::move(socket_), dynamic_metadata_);
   }
 }
 
 void ConnectionHandlerImpl::ActiveTcpListener::onAccept(
     Network::ConnectionSocketPtr&& socket, bool hand_off_restored_destination_connections) {
-  auto active_socket = std::make_unique<ActiveSocket>(*this, std::move(socket),
-                                                      hand_off_restored_destination_connections);
+  onAcceptWorker(std::move(socket), hand_off_restored_destination_connections, false, {});
+}
+
+void ConnectionHandlerImpl::ActiveTcpListener::onAcceptWorker(
+    Network::ConnectionSocketPtr&& socket, bool hand_off_restored_destination_connections,
+    bool rebalanced, envoy::api::v2::core::Metadata&& dynamic_metadata) {
+  if (!rebalanced) {
+    Network::BalancedConnectionHandler& target_handler =
+        config_.connectionBalancer().pickTargetHandler(*this);
+    if (&target_handler != this) {
+      target_handler.post(std::move(socket));
+      return;
+    }
+  }
+
+  auto active_socket =
+      std::make_unique<ActiveSocket>(*this, std::move(socket),
+                                     hand_off_restored_destination_connections,
+                                     std::move(dynamic_metadata));
 
   // Create and run the filters
   config_.filterChainFactory().createListenerFilterChain(*active_socket);
@@ -254,7 +344,7 @@ void ConnectionHandlerImpl::ActiveTcpListener::onAccept(
 }
 
 void ConnectionHandlerImpl::ActiveTcpListener::newConnection(
-    Network::ConnectionSocketPtr&& socket) {
+    Network::ConnectionSocketPtr&& socket, const envoy::api::v2::core::Metadata& dynamic_metadata) {
   // Find matching filter chain.
   const auto filter_chain = config_.filterChainManager().findFilterChain(*socket);
   if (filter_chain == nullptr) {
@@ -268,7 +358,16 @@ void ConnectionHandlerImpl::ActiveTcpListener::newConnection(
   auto transport_socket = filter_chain->transportSocketFactory().createTransportSocket(nullptr);
   Network::ConnectionPtr new_connection =
       parent_.dispatcher_.createServerConnection(std::move(socket), std::move(transport_socket));
+  if (dynamic_metadata.filter_metadata_size() > 0) {
+    new_connection->streamInfo().dynamicMetadata().MergeFrom(dynamic_metadata);
+  }
   new_connection->setBufferLimits(config_.perConnectionBufferLimitBytes());
+  if (config_.perConnectionReadBudgetBytes() > 0) {
+    new_connection->setReadBudget(config_.perConnectionReadBudgetBytes(),
+                                  {stats_.downstream_cx_read_budget_yield_,
+                                   stats_.downstream_cx_read_size_grow_,
+                                   stats_.downstream_cx_read_size_shrink_});
+  }
 
   const bool empty_filter_chain = !config_.filterChainFactory().createNetworkFilterChain(
       *new_connection, filter_chain->networkFilterFactories());
@@ -282,6 +381,28 @@ void ConnectionHandlerImpl::ActiveTcpListener::newConnection(
   onNewConnection(std::move(new_connection));
 }
 
+void ConnectionHandlerImpl::ActiveTcpListener::post(Network::ConnectionSocketPtr&& socket) {
+  // The posted callback must be copyable, so the socket is moved into a shared_ptr.
+  auto socket_to_post = std::make_shared<Network::ConnectionSocketPtr>(std::move(socket));
+  parent_.dispatcher_.post([socket_to_post, tag = config_.listenerTag(), &parent = parent_]() {
+    // The listener may have been removed while the socket was in flight, in which case the
+    // socket is closed when the last reference to it goes away.
+    for (const auto& listener : parent.listeners_) {
+      if (listener.second->listener_tag_ == tag) {
+        // Only TCP listeners are balanced.
+        ActiveTcpListener* tcp_listener = dynamic_cast<ActiveTcpListener*>(listener.second.get());
+        ASSERT(tcp_listener != nullptr);
+        ASSERT(tcp_listener->num_listener_connections_ > 0);
+        tcp_listener->num_listener_connections_--;
+        tcp_listener->onAcceptWorker(std::move(*socket_to_post),
+                                     tcp_listener->config_.handOffRestoredDestinationConnections(),
+                                     true, {});
+        return;
+      }
+    }
+  });
+}
+
 void ConnectionHandlerImpl::ActiveTcpListener::onNewConnection(
     Network::ConnectionPtr&& new_connection) {
   ENVOY_CONN_LOG_TO_LOGGER(parent_.logger_, debug, "new connection", *new_connection);
@@ -290,8 +411,12 @@ void ConnectionHandlerImpl::ActiveTcpListener::onNewConnection(
   if (new_connection->state() != Network::Connection::State::Closed) {
     ActiveConnectionPtr active_connection(
         new ActiveConnection(*this, std::move(new_connection), parent_.dispatcher_.timeSource()));
+    if (parent_.disable_connection_reads_) {
+      active_connection->setReadsDisabled(true);
+    }
     active_connection->moveIntoList(std::move(active_connection), connections_);
     parent_.num_connections_++;
+    num_listener_connections_++;
   }
 }
 
@@ -306,21 +431,42 @@ ConnectionHandlerImpl::ActiveConnection::ActiveConnection(ActiveTcpListener& lis
   connection_->addConnectionCallbacks(*this);
   listener_.stats_.downstream_cx_total_.inc();
   listener_.stats_.downstream_cx_active_.inc();
+  listener_.per_worker_stats_.downstream_cx_total_.inc();
+  listener_.per_worker_stats_.downstream_cx_active_.inc();
 }
 
 ConnectionHandlerImpl::ActiveConnection::~ActiveConnection() {
   listener_.stats_.downstream_cx_active_.dec();
+  listener_.per_worker_stats_.downstream_cx_active_.dec();
   listener_.stats_.downstream_cx_destroy_.inc();
   conn_length_->complete();
 }
 
+void ConnectionHandlerImpl::ActiveConnection::setReadsDisabled(bool disabled) {
+  // A connection which is closing can no longer change its read state.
+  if (reads_disabled_ == disabled || connection_->state() != Network::Connection::State::Open) {
+    return;
+  }
+  reads_disabled_ = disabled;
+  connection_->readDisable(disabled);
+}
+
 ListenerStats ConnectionHandlerImpl::generateStats(Stats::Scope& scope) {
   return {ALL_LISTENER_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope), POOL_HISTOGRAM(scope))};
 }
 
+PerHandlerListenerStats ConnectionHandlerImpl::generatePerHandlerStats(Stats::Scope& scope,
+                                                                       uint32_t worker_index) {
+  const std::string prefix = fmt::format("worker_{}.", worker_index);
+  return {ALL_PER_HANDLER_LISTENER_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                         POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
 ConnectionHandlerImpl::ActiveUdpListener::ActiveUdpListener(ConnectionHandlerImpl& parent,
                                                             Network::ListenerConfig& config)
-    : ActiveUdpListener(parent, parent.dispatcher_.createUdpListener(config.socket(), *this),
+    : ActiveUdpListener(parent,
+                        parent.dispatcher_.createUdpListener(
+                            config.workerSocket(parent.worker_index_), *this),
                         config) {}
 
 ConnectionHandlerImpl::ActiveUdpListener::ActiveUdpListener(ConnectionHandlerImpl& parent,
@@ -2,12 +2,16 @@
 
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <list>
 #include <memory>
+#include <vector>
 
+#include "envoy/api/v2/core/base.pb.h"
 #include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
 #include "envoy/network/connection.h"
+#include "envoy/network/connection_balancer.h"
 #include "envoy/network/connection_handler.h"
 #include "envoy/network/filter.h"
 #include "envoy/network/listen_socket.h"
@@ -26,6 +30,9 @@ namespace Server {
 
 #define ALL_LISTENER_STATS(COUNTER, GAUGE, HISTOGRAM)                                              \
   COUNTER(downstream_cx_destroy)                                                                   \
+  COUNTER(downstream_cx_read_budget_yield)                                                         \
+  COUNTER(downstream_cx_read_size_grow)                                                            \
+  COUNTER(downstream_cx_read_size_shrink)                                                          \
   COUNTER(downstream_cx_total)                                                                     \
   COUNTER(downstream_pre_cx_timeout)                                                               \
   COUNTER(no_filter_chain_match)                                                                   \
@@ -40,13 +47,33 @@ struct ListenerStats {
   ALL_LISTENER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
+#define ALL_PER_HANDLER_LISTENER_STATS(COUNTER, GAUGE)                                             \
+  COUNTER(downstream_cx_total)                                                                     \
+  GAUGE(downstream_cx_active, Accumulate)
+
+/**
+ * Wrapper struct for the listener stats of each connection handler, which show how the
+ * listener's connections are spread across the workers. @see stats_macros.h
+ */
+struct PerHandlerListenerStats {
+  ALL_PER_HANDLER_LISTENER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
 /**
  * Server side connection handler. This is used both by workers as well as the
  * main thread for non-threaded listeners.
  */
 class ConnectionHandlerImpl : public Network::ConnectionHandler, NonCopyable {
 public:
-  ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher);
+  ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher)
+      : ConnectionHandlerImpl(logger, dispatcher, 0) {}
+  /**
+   * @param worker_index supplies the index of the worker that owns the handler. It selects the
+   *        listen socket of listeners with a socket per worker. @see
+   *        Network::ListenerConfig::workerSocket().
+   */
+  ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher,
+                        uint32_t worker_index);
 
   // Network::ConnectionHandler
   uint64_t numConnections() override { return num_connections_; }
@@ -56,6 +83,9 @@ public:
   void stopListeners() override;
   void disableListeners() override;
   void enableListeners() override;
+  void disableConnectionReads() override;
+  void enableConnectionReads() override;
+  std::vector<Network::BufferedConnection> topBufferedConnections(uint32_t limit) override;
 
   Network::Listener* findListenerByAddress(const Network::Address::Instance& address) override;
 
@@ -71,6 +101,11 @@ private:
 
   ActiveListenerBase* findActiveListenerByAddress(const Network::Address::Instance& address);
 
+  /**
+   * Run a callback on each TCP listener owned by the handler.
+   */
+  void forEachTcpListener(std::function<void(ActiveTcpListener&)> cb);
+
   struct ActiveConnection;
   using ActiveConnectionPtr = std::unique_ptr<ActiveConnection>;
   struct ActiveSocket;
@@ -125,7 +160,9 @@ private:
   /**
    * Wrapper for an active tcp listener owned by this handler.
    */
-  struct ActiveTcpListener : public Network::ListenerCallbacks, public ActiveListenerBase {
+  struct ActiveTcpListener : public Network::ListenerCallbacks,
+                             public ActiveListenerBase,
+                             public Network::BalancedConnectionHandler {
     ActiveTcpListener(ConnectionHandlerImpl& parent, Network::ListenerConfig& config);
 
     ActiveTcpListener(ConnectionHandlerImpl& parent, Network::ListenerPtr&& listener,
@@ -138,6 +175,22 @@ private:
                   bool hand_off_restored_destination_connections) override;
     void onNewConnection(Network::ConnectionPtr&& new_connection) override;
 
+    // Network::BalancedConnectionHandler
+    uint64_t numConnections() const override { return num_listener_connections_; }
+    void incNumConnections() override { ++num_listener_connections_; }
+    void post(Network::ConnectionSocketPtr&& socket) override;
+
+    /**
+     * Run the listener filters on an accepted socket, and create a connection if they succeed.
+     * @param rebalanced supplies whether the socket has already been balanced to this worker, or
+     *        handed off to this listener by another listener on the same worker.
+     * @param dynamic_metadata supplies the metadata set by the listener filters of the listener
+     *        handing the socket off, if any.
+     */
+    void onAcceptWorker(Network::ConnectionSocketPtr&& socket,
+                        bool hand_off_restored_destination_connections, bool rebalanced,
+                        envoy::api::v2::core::Metadata&& dynamic_metadata);
+
     /**
      * Remove and destroy an active connection.
      * @param connection supplies the connection to remove.
@@ -146,11 +199,17 @@ private:
 
     /**
      * Create a new connection from a socket accepted by the listener.
+     * @param dynamic_metadata supplies the metadata set by the listener filters.
      */
-    void newConnection(Network::ConnectionSocketPtr&& socket);
+    void newConnection(Network::ConnectionSocketPtr&& socket,
+                       const envoy::api::v2::core::Metadata& dynamic_metadata);
 
     std::list<ActiveSocketPtr> sockets_;
     std::list<ActiveConnectionPtr> connections_;
+    PerHandlerListenerStats per_worker_stats_;
+    // The listener's connections on this worker plus the sockets posted to it by other workers
+    // that have not arrived yet. Read by the balancer from other workers.
+    std::atomic<uint64_t> num_listener_connections_{};
   };
 
   /**
@@ -174,9 +233,16 @@ private:
     void onAboveWriteBufferHighWatermark() override {}
     void onBelowWriteBufferLowWatermark() override {}
 
+    /**
+     * Disable or enable reading on the connection on behalf of the handler. Calls which do not
+     * change the state are ignored, as Network::Connection::readDisable() calls are counted.
+     */
+    void setReadsDisabled(bool disabled);
+
     ActiveTcpListener& listener_;
     Network::ConnectionPtr connection_;
     Stats::TimespanPtr conn_length_;
+    bool reads_disabled_{};
   };
 
   /**
@@ -187,10 +253,11 @@ private:
                         LinkedObject<ActiveSocket>,
                         public Event::DeferredDeletable {
     ActiveSocket(ActiveTcpListener& listener, Network::ConnectionSocketPtr&& socket,
-                 bool hand_off_restored_destination_connections)
+                 bool hand_off_restored_destination_connections,
+                 envoy::api::v2::core::Metadata&& dynamic_metadata)
         : listener_(listener), socket_(std::move(socket)),
           hand_off_restored_destination_connections_(hand_off_restored_destination_connections),
-          iter_(accept_filters_.end()) {
+          iter_(accept_filters_.end()), dynamic_metadata_(std::move(dynamic_metadata)) {
       listener_.stats_.downstream_pre_cx_active_.inc();
     }
     ~ActiveSocket() override {
@@ -212,6 +279,12 @@ private:
     Network::ConnectionSocket& socket() override { return *socket_.get(); }
     Event::Dispatcher& dispatcher() override { return listener_.parent_.dispatcher_; }
     void continueFilterChain(bool success) override;
+    void setDynamicMetadata(const std::string& name, const ProtobufWkt::Struct& value) override {
+      (*dynamic_metadata_.mutable_filter_metadata())[name].MergeFrom(value);
+    }
+    const envoy::api::v2::core::Metadata& dynamicMetadata() const override {
+      return dynamic_metadata_;
+    }
 
     ActiveTcpListener& listener_;
     Network::ConnectionSocketPtr socket_;
@@ -219,15 +292,20 @@ private:
     std::list<Network::ListenerFilterPtr> accept_filters_;
     std::list<Network::ListenerFilterPtr>::iterator iter_;
     Event::TimerPtr timer_;
+    envoy::api::v2::core::Metadata dynamic_metadata_;
   };
 
   static ListenerStats generateStats(Stats::Scope& scope);
+  static PerHandlerListenerStats generatePerHandlerStats(Stats::Scope& scope,
+                                                         uint32_t worker_index);
 
   spdlog::logger& logger_;
   Event::Dispatcher& dispatcher_;
+  const uint32_t worker_index_;
   std::list<std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerBasePtr>> listeners_;
   std::atomic<uint64_t> num_connections_{};
   bool disable_listeners_;
+  bool disable_connection_reads_{};
 };
 
 } // namespace Server
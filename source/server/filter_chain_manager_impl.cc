@@ -1,5 +1,8 @@
 #include "server/filter_chain_manager_impl.h"
 
+#include <algorithm>
+#include <functional>
+
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
 #include "common/config/utility.h"
@@ -7,6 +10,7 @@
 
 #include "server/configuration_impl.h"
 
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 
@@ -82,6 +86,7 @@ void FilterChainManagerImpl::addFilterChain(
             filter_chain_factory_builder.buildFilterChain(*filter_chain)));
   }
   convertIPsToTries();
+  std::sort(wildcard_dot_counts_.begin(), wildcard_dot_counts_.end(), std::greater<size_t>());
 }
 
 void FilterChainManagerImpl::addFilterChainForDestinationPorts(
@@ -143,6 +148,11 @@ void FilterChainManagerImpl::addFilterChainForServerNames(
   } else {
     for (const auto& server_name_ptr : server_names) {
       if (isWildcardServerName(*server_name_ptr)) {
+        const size_t dot_count = std::count(server_name_ptr->begin(), server_name_ptr->end(), '.');
+        if (std::find(wildcard_dot_counts_.begin(), wildcard_dot_counts_.end(), dot_count) ==
+            wildcard_dot_counts_.end()) {
+          wildcard_dot_counts_.push_back(dot_count);
+        }
         // Add mapping for the wildcard domain, i.e. ".example.com" for "*.example.com".
         addFilterChainForApplicationProtocols(
             server_names_map[server_name_ptr->substr(1)][transport_protocol], application_protocols,
@@ -286,7 +296,7 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForDestinatio
 
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName(
     const ServerNamesMap& server_names_map, const Network::ConnectionSocket& socket) const {
-  const std::string server_name(socket.requestedServerName());
+  const absl::string_view server_name = socket.requestedServerName();
 
   // Match on exact server name, i.e. "www.example.com" for "www.example.com".
   const auto server_name_exact_match = server_names_map.find(server_name);
@@ -294,15 +304,31 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName
     return findFilterChainForTransportProtocol(server_name_exact_match->second, socket);
   }
 
-  // Match on all wildcard domains, i.e. ".example.com" and ".com" for "www.example.com".
-  size_t pos = server_name.find('.', 1);
-  while (pos < server_name.size() - 1 && pos != std::string::npos) {
-    const std::string wildcard = server_name.substr(pos);
-    const auto server_name_wildcard_match = server_names_map.find(wildcard);
-    if (server_name_wildcard_match != server_names_map.end()) {
-      return findFilterChainForTransportProtocol(server_name_wildcard_match->second, socket);
+  // Match on the wildcard domains, longest first, i.e. ".example.com" and ".com" for
+  // "www.example.com". Only the suffixes with as many labels as a configured wildcard domain are
+  // looked up, so that the lookups do not depend on the depth of the server name.
+  if (!wildcard_dot_counts_.empty() && !server_name.empty()) {
+    // The positions of the dots of the server name, from the last one.
+    absl::InlinedVector<size_t, 8> dots;
+    for (size_t pos = server_name.rfind('.');
+         pos != absl::string_view::npos && pos > 0 && dots.size() < wildcard_dot_counts_.front();
+         pos = server_name.rfind('.', pos - 1)) {
+      dots.push_back(pos);
+    }
+    for (const size_t dot_count : wildcard_dot_counts_) {
+      if (dot_count > dots.size()) {
+        continue;
+      }
+      // The suffix must leave a label to the wildcard, and not be the trailing dot alone.
+      const size_t pos = dots[dot_count - 1];
+      if (pos == server_name.size() - 1) {
+        continue;
+      }
+      const auto server_name_wildcard_match = server_names_map.find(server_name.substr(pos));
+      if (server_name_wildcard_match != server_names_map.end()) {
+        return findFilterChainForTransportProtocol(server_name_wildcard_match->second, socket);
+      }
     }
-    pos = server_name.find('.', pos + 1);
   }
 
   // Match on a filter chain without server name requirements.
@@ -317,7 +343,7 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForTransportProtocol(
     const TransportProtocolsMap& transport_protocols_map,
     const Network::ConnectionSocket& socket) const {
-  const std::string transport_protocol(socket.detectedTransportProtocol());
+  const absl::string_view transport_protocol = socket.detectedTransportProtocol();
 
   // Match on exact transport protocol, e.g. "tls".
   const auto transport_protocol_match = transport_protocols_map.find(transport_protocol);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "envoy/api/v2/listener/listener.pb.h"
 #include "envoy/server/transport_socket_config.h"
@@ -131,14 +132,16 @@ private:
   // Mapping of FilterChain's configured destination ports, IPs, server names, transport protocols
   // and application protocols, using structures defined above.
   DestinationPortsMap destination_ports_map_;
+  // The distinct numbers of dots of the wildcard domains, i.e. 2 for ".example.com", largest first.
+  std::vector<size_t> wildcard_dot_counts_;
   const Network::Address::InstanceConstSharedPtr address_;
 };
 
 class FilterChainImpl : public Network::FilterChain {
 public:
-  FilterChainImpl(Network::TransportSocketFactoryPtr&& transport_socket_factory,
+  FilterChainImpl(const Network::TransportSocketFactorySharedPtr& transport_socket_factory,
                   std::vector<Network::FilterFactoryCb>&& filters_factory)
-      : transport_socket_factory_(std::move(transport_socket_factory)),
+      : transport_socket_factory_(transport_socket_factory),
         filters_factory_(std::move(filters_factory)) {}
 
   // Network::FilterChain
@@ -151,7 +154,9 @@ public:
   }
 
 private:
-  const Network::TransportSocketFactoryPtr transport_socket_factory_;
+  // Shared with the other filter chains of the listener and of its updates with the same transport
+  // socket configuration.
+  const Network::TransportSocketFactorySharedPtr transport_socket_factory_;
   const std::vector<Network::FilterFactoryCb> filters_factory_;
 };
 
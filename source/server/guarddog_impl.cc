@@ -1,6 +1,9 @@
 #include "server/guarddog_impl.h"
 
+#include <cxxabi.h>
+
 #include <chrono>
+#include <cstdlib>
 #include <memory>
 
 #include "envoy/stats/scope.h"
@@ -11,11 +14,29 @@
 
 #include "server/watchdog_impl.h"
 
+#include "absl/debugging/symbolize.h"
 #include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Server {
 
+namespace {
+
+std::string demangle(const char* name) {
+  int status;
+  char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+  if (status != 0) {
+    return name;
+  }
+  std::string result(demangled);
+  ::free(demangled);
+  return result;
+}
+
+} // namespace
+
+constexpr size_t GuardDogImpl::MaxRecentStalls;
+
 GuardDogImpl::GuardDogImpl(Stats::Scope& stats_scope, const Server::Configuration::Main& config,
                            Api::Api& api, std::unique_ptr<TestInterlockHook>&& test_interlock)
     : test_interlock_hook_(std::move(test_interlock)), time_source_(api.timeSource()),
@@ -34,6 +55,7 @@ GuardDogImpl::GuardDogImpl(Stats::Scope& stats_scope, const Server::Configuratio
       watchdog_megamiss_counter_(stats_scope.counter("server.watchdog_mega_miss")),
       dispatcher_(api.allocateDispatcher()),
       loop_timer_(dispatcher_->createTimer([this]() { step(); })), run_thread_(true) {
+  WatchDogImpl::installStackSampleHandler();
   start(api);
 }
 
@@ -57,6 +79,9 @@ void GuardDogImpl::step() {
     bool seen_one_multi_timeout(false);
     Thread::LockGuard guard(wd_lock_);
     for (auto& watched_dog : watched_dogs_) {
+      if (watched_dog.pending_stall_.has_value()) {
+        collectStackSample(watched_dog);
+      }
       const auto ltt = watched_dog.dog_->lastTouchTime();
       const auto delta = now - ltt;
       if (watched_dog.last_alert_time_ && watched_dog.last_alert_time_.value() < ltt) {
@@ -68,6 +93,13 @@ void GuardDogImpl::step() {
           watchdog_miss_counter_.inc();
           watched_dog.last_alert_time_ = ltt;
           watched_dog.miss_alerted_ = true;
+          if (watched_dog.dog_->requestStackSample()) {
+            StallReport stall;
+            stall.thread_id_ = watched_dog.dog_->threadId().debugString();
+            stall.time_ = time_source_.systemTime();
+            stall.stalled_for_ = std::chrono::duration_cast<std::chrono::milliseconds>(delta);
+            watched_dog.pending_stall_ = std::move(stall);
+          }
         }
       }
       if (delta > megamiss_timeout_) {
@@ -109,7 +141,7 @@ WatchDogSharedPtr GuardDogImpl::createWatchDog(Thread::ThreadId thread_id) {
   // accessed out of the locked section below is const (time_source_ has no
   // state).
   auto wd_interval = loop_interval_ / 2;
-  WatchDogSharedPtr new_watchdog =
+  std::shared_ptr<WatchDogImpl> new_watchdog =
       std::make_shared<WatchDogImpl>(std::move(thread_id), time_source_, wd_interval);
   WatchedDog watched_dog;
   watched_dog.dog_ = new_watchdog;
@@ -132,6 +164,37 @@ void GuardDogImpl::stopWatching(WatchDogSharedPtr wd) {
   }
 }
 
+std::vector<StallReport> GuardDogImpl::recentStalls() const {
+  Thread::LockGuard guard(stalls_lock_);
+  return {recent_stalls_.begin(), recent_stalls_.end()};
+}
+
+void GuardDogImpl::collectStackSample(WatchedDog& watched_dog) {
+  StallReport stall = std::move(watched_dog.pending_stall_.value());
+  watched_dog.pending_stall_.reset();
+  // The thread handles the signal as soon as it runs, so the sample is only missing if the thread
+  // did not run since the last step, or if another WatchDog was started on it since.
+  const absl::optional<WatchDogImpl::StackSample> sample = watched_dog.dog_->takeStackSample();
+  if (!sample.has_value()) {
+    return;
+  }
+  if (sample->tracked_object_type_ != nullptr) {
+    stall.tracked_object_ = demangle(sample->tracked_object_type_->name());
+  }
+  for (void* frame : sample->frames_) {
+    char symbol[1024];
+    stall.frames_.push_back(absl::Symbolize(frame, symbol, sizeof(symbol))
+                                ? fmt::format("{} [{}]", symbol, frame)
+                                : fmt::format("[{}]", frame));
+  }
+
+  Thread::LockGuard guard(stalls_lock_);
+  if (recent_stalls_.size() == MaxRecentStalls) {
+    recent_stalls_.pop_front();
+  }
+  recent_stalls_.push_back(std::move(stall));
+}
+
 void GuardDogImpl::start(Api::Api& api) {
   Thread::LockGuard guard(mutex_);
   thread_ = api.threadFactory().createThread(
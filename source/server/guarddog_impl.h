@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <deque>
 #include <vector>
 
 #include "envoy/api/api.h"
@@ -16,6 +17,8 @@
 #include "common/common/thread.h"
 #include "common/event/libevent.h"
 
+#include "server/watchdog_impl.h"
+
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -28,6 +31,10 @@ namespace Server {
  * intervals. If it finds starved threads or suspected deadlocks it will take
  * the appropriate action depending on the config parameters described below.
  *
+ * When a thread misses, its stack and the type of the object tracked by its
+ * dispatcher are sampled by interrupting it with a signal, and kept as one of
+ * the recentStalls().
+ *
  * Thread lifetime is tied to GuardDog object lifetime (RAII style).
  */
 class GuardDogImpl : public GuardDog {
@@ -89,6 +96,10 @@ public:
   // Server::GuardDog
   WatchDogSharedPtr createWatchDog(Thread::ThreadId thread_id) override;
   void stopWatching(WatchDogSharedPtr wd) override;
+  std::vector<StallReport> recentStalls() const override;
+
+  // The number of stalls kept by recentStalls().
+  static constexpr size_t MaxRecentStalls = 16;
 
 private:
   void start(Api::Api& api);
@@ -100,12 +111,17 @@ private:
   bool multikillEnabled() const { return multi_kill_timeout_ > std::chrono::milliseconds(0); }
 
   struct WatchedDog {
-    WatchDogSharedPtr dog_;
+    std::shared_ptr<WatchDogImpl> dog_;
     absl::optional<MonotonicTime> last_alert_time_;
     bool miss_alerted_{};
     bool megamiss_alerted_{};
+    // Set when the stack of the thread was requested on a miss, until the next step collects it.
+    absl::optional<StallReport> pending_stall_;
   };
 
+  // Adds the stack sampled on the last miss of a dog to the recent stalls, if it was taken.
+  void collectStackSample(WatchedDog& watched_dog);
+
   std::unique_ptr<TestInterlockHook> test_interlock_hook_;
   TimeSource& time_source_;
   const std::chrono::milliseconds miss_timeout_;
@@ -117,6 +133,8 @@ private:
   Stats::Counter& watchdog_megamiss_counter_;
   std::vector<WatchedDog> watched_dogs_ GUARDED_BY(wd_lock_);
   Thread::MutexBasicLockable wd_lock_;
+  std::deque<StallReport> recent_stalls_ GUARDED_BY(stalls_lock_);
+  mutable Thread::MutexBasicLockable stalls_lock_;
   Thread::ThreadPtr thread_;
   Event::DispatcherPtr dispatcher_;
   Event::TimerPtr loop_timer_;
@@ -108,8 +108,9 @@ void HotRestartImpl::drainParentListeners() {
   shmem_->flags_ &= ~SHMEM_FLAGS_INITIALIZING;
 }
 
-int HotRestartImpl::duplicateParentListenSocket(const std::string& address) {
-  return as_child_.duplicateParentListenSocket(address);
+int HotRestartImpl::duplicateParentListenSocket(const std::string& address,
+                                                uint32_t worker_index) {
+  return as_child_.duplicateParentListenSocket(address, worker_index);
 }
 
 void HotRestartImpl::initialize(Event::Dispatcher& dispatcher, Server::Instance& server) {
@@ -131,10 +132,18 @@ HotRestartImpl::mergeParentStatsIfAny(Stats::StoreRoot& stats_store) {
     as_child_.mergeParentStats(stats_store, wrapper_msg->reply().stats());
     response.parent_memory_allocated_ = wrapper_msg->reply().stats().memory_allocated();
     response.parent_connections_ = wrapper_msg->reply().stats().num_connections();
+    response.stats_merged_ = true;
   }
   return response;
 }
 
+void HotRestartImpl::importParentTlsSessions(Ssl::SessionCache& session_cache) {
+  std::unique_ptr<envoy::HotRestartMessage> wrapper_msg = as_child_.getParentTlsSessions();
+  if (wrapper_msg) {
+    as_child_.importParentTlsSessions(session_cache, wrapper_msg->reply().tls_sessions());
+  }
+}
+
 void HotRestartImpl::shutdown() { as_parent_.shutdown(); }
 
 std::string HotRestartImpl::version() { return hotRestartVersion(); }
@@ -0,0 +1,151 @@
+#include "server/hot_restart_stats_snapshot.h"
+
+#include "absl/strings/str_split.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+void appendVarint(uint64_t value, std::string& out) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+bool readVarint(absl::string_view& in, uint64_t& value) {
+  value = 0;
+  for (uint32_t shift = 0; shift < 64 && !in.empty(); shift += 7) {
+    const uint8_t byte = in[0];
+    in.remove_prefix(1);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+void StatsSnapshotEncoder::addCounter(Stats::StatName name, uint64_t value) {
+  addStat(name, value, counters_);
+  ++num_counters_;
+}
+
+void StatsSnapshotEncoder::addGauge(Stats::StatName name, uint64_t value) {
+  addStat(name, value, gauges_);
+  ++num_gauges_;
+}
+
+std::string StatsSnapshotEncoder::finish() const {
+  std::string out;
+  out.reserve(symbols_.size() + counters_.size() + gauges_.size() + 30);
+  appendVarint(symbol_indices_.size(), out);
+  out.append(symbols_);
+  appendVarint(num_counters_, out);
+  out.append(counters_);
+  appendVarint(num_gauges_, out);
+  out.append(gauges_);
+  return out;
+}
+
+void StatsSnapshotEncoder::addStat(Stats::StatName name, uint64_t value, std::string& out) {
+  symbol_table_.callWithStringView(name, [this, &out](absl::string_view str) {
+    const std::vector<absl::string_view> tokens = absl::StrSplit(str, '.', absl::SkipEmpty());
+    appendVarint(tokens.size(), out);
+    for (absl::string_view token : tokens) {
+      appendVarint(symbolIndex(token), out);
+    }
+  });
+  appendVarint(value, out);
+}
+
+uint64_t StatsSnapshotEncoder::symbolIndex(absl::string_view token) {
+  auto it = symbol_indices_.find(token);
+  if (it != symbol_indices_.end()) {
+    return it->second;
+  }
+  const uint64_t index = symbol_indices_.size();
+  symbol_indices_.emplace(std::string(token), index);
+  appendVarint(token.size(), symbols_);
+  symbols_.append(token.data(), token.size());
+  return index;
+}
+
+StatsSnapshot::~StatsSnapshot() { clear(); }
+
+bool StatsSnapshot::decode(absl::string_view snapshot) {
+  clear();
+
+  // Each token is encoded in the symbol table once, rather than once per stat.
+  uint64_t num_symbols;
+  if (!readVarint(snapshot, num_symbols) || num_symbols > snapshot.size()) {
+    return false;
+  }
+  std::vector<Stats::StatName> symbols;
+  symbols.reserve(num_symbols);
+  for (uint64_t i = 0; i < num_symbols; ++i) {
+    uint64_t length;
+    if (!readVarint(snapshot, length) || length > snapshot.size()) {
+      return false;
+    }
+    symbols.push_back(symbols_.add(snapshot.substr(0, length)));
+    snapshot.remove_prefix(length);
+  }
+
+  uint64_t num_counters;
+  uint64_t num_gauges;
+  if (!readVarint(snapshot, num_counters) ||
+      !decodeStats(snapshot, symbols, num_counters, counter_deltas_) ||
+      !readVarint(snapshot, num_gauges) || !decodeStats(snapshot, symbols, num_gauges, gauges_) ||
+      !snapshot.empty()) {
+    clear();
+    return false;
+  }
+  return true;
+}
+
+bool StatsSnapshot::decodeStats(absl::string_view& snapshot,
+                                const std::vector<Stats::StatName>& symbols, uint64_t num_stats,
+                                Stats::StatMerger::StatNameValues& stats) {
+  // Every stat takes at least two bytes.
+  if (num_stats > snapshot.size() / 2) {
+    return false;
+  }
+  stats.reserve(num_stats);
+  std::vector<Stats::StatName> tokens;
+  for (uint64_t i = 0; i < num_stats; ++i) {
+    uint64_t num_tokens;
+    if (!readVarint(snapshot, num_tokens) || num_tokens > snapshot.size()) {
+      return false;
+    }
+    tokens.clear();
+    for (uint64_t j = 0; j < num_tokens; ++j) {
+      uint64_t index;
+      if (!readVarint(snapshot, index) || index >= symbols.size()) {
+        return false;
+      }
+      tokens.push_back(symbols[index]);
+    }
+    uint64_t value;
+    if (!readVarint(snapshot, value)) {
+      return false;
+    }
+    names_.push_back(symbol_table_.join(tokens));
+    stats.emplace_back(Stats::StatName(names_.back().get()), value);
+  }
+  return true;
+}
+
+void StatsSnapshot::clear() {
+  counter_deltas_.clear();
+  gauges_.clear();
+  // The joined names hold no references to the symbols, those of the tokens do.
+  names_.clear();
+  symbols_.clear();
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/symbol_table.h"
+
+#include "common/stats/stat_merger.h"
+#include "common/stats/symbol_table_impl.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Encodes the counters and gauges of a hot restart parent into a snapshot which the child merges
+ * in bulk. The snapshot has its own symbol table: each distinct token of the stat names is written
+ * once, and each stat as the indices of its tokens followed by its value, all as varints. The
+ * snapshot is only read by a process of the same hot restart version on the same host.
+ */
+class StatsSnapshotEncoder {
+public:
+  explicit StatsSnapshotEncoder(const Stats::SymbolTable& symbol_table)
+      : symbol_table_(symbol_table) {}
+
+  void addCounter(Stats::StatName name, uint64_t value);
+  void addGauge(Stats::StatName name, uint64_t value);
+
+  /**
+   * @return the encoded snapshot of the stats added so far.
+   */
+  std::string finish() const;
+
+private:
+  void addStat(Stats::StatName name, uint64_t value, std::string& out);
+  uint64_t symbolIndex(absl::string_view token);
+
+  const Stats::SymbolTable& symbol_table_;
+  absl::flat_hash_map<std::string, uint64_t> symbol_indices_;
+  std::string symbols_;
+  std::string counters_;
+  std::string gauges_;
+  uint64_t num_counters_{};
+  uint64_t num_gauges_{};
+};
+
+/**
+ * A snapshot decoded into the StatNames of the symbol table of the child. Each token of the
+ * snapshot is encoded once, and the names of the stats are joined from the encoded tokens.
+ */
+class StatsSnapshot {
+public:
+  explicit StatsSnapshot(Stats::SymbolTable& symbol_table)
+      : symbol_table_(symbol_table), symbols_(symbol_table) {}
+  ~StatsSnapshot();
+
+  /**
+   * Decode a snapshot written by StatsSnapshotEncoder.
+   * @param snapshot supplies the encoded snapshot.
+   * @return false if the snapshot is malformed, in which case it has no stats.
+   */
+  bool decode(absl::string_view snapshot);
+
+  const Stats::StatMerger::StatNameValues& counterDeltas() const { return counter_deltas_; }
+  const Stats::StatMerger::StatNameValues& gauges() const { return gauges_; }
+
+private:
+  bool decodeStats(absl::string_view& snapshot, const std::vector<Stats::StatName>& symbols,
+                   uint64_t num_stats, Stats::StatMerger::StatNameValues& stats);
+  void clear();
+
+  Stats::SymbolTable& symbol_table_;
+  Stats::StatNamePool symbols_;
+  std::vector<Stats::SymbolTable::StoragePtr> names_;
+  Stats::StatMerger::StatNameValues counter_deltas_;
+  Stats::StatMerger::StatNameValues gauges_;
+};
+
+} // namespace Server
+} // namespace Envoy
@@ -56,6 +56,9 @@ protected:
   bool replyIsExpectedType(const envoy::HotRestartMessage* proto,
                            envoy::HotRestartMessage::Reply::ReplyCase oneof_type) const;
 
+  // The fd passed with a PassListenSocket reply, or with a Stats reply carrying a snapshot, or -1.
+  int passedFd(const envoy::HotRestartMessage& proto) const;
+
 private:
   void getPassedFdIfPresent(envoy::HotRestartMessage* out, msghdr* message);
   std::unique_ptr<envoy::HotRestartMessage> parseProtoAndResetState();
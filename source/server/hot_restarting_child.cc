@@ -1,7 +1,10 @@
 #include "server/hot_restarting_child.h"
 
+#include "common/api/os_sys_calls_impl.h"
 #include "common/common/utility.h"
 
+#include "server/hot_restart_stats_snapshot.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -16,13 +19,15 @@ HotRestartingChild::HotRestartingChild(int base_id, int restart_epoch)
   bindDomainSocket(restart_epoch_, "child");
 }
 
-int HotRestartingChild::duplicateParentListenSocket(const std::string& address) {
+int HotRestartingChild::duplicateParentListenSocket(const std::string& address,
+                                                    uint32_t worker_index) {
   if (restart_epoch_ == 0 || parent_terminated_) {
     return -1;
   }
 
   HotRestartMessage wrapped_request;
   wrapped_request.mutable_request()->mutable_pass_listen_socket()->set_address(address);
+  wrapped_request.mutable_request()->mutable_pass_listen_socket()->set_worker_index(worker_index);
   sendHotRestartMessage(parent_address_, wrapped_request);
 
   std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
@@ -38,7 +43,7 @@ std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
   }
 
   HotRestartMessage wrapped_request;
-  wrapped_request.mutable_request()->mutable_stats();
+  wrapped_request.mutable_request()->mutable_stats()->set_snapshot(true);
   sendHotRestartMessage(parent_address_, wrapped_request);
 
   std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
@@ -94,7 +99,56 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
   if (!stat_merger_) {
     stat_merger_ = std::make_unique<Stats::StatMerger>(stats_store);
   }
-  stat_merger_->mergeStats(stats_proto.counter_deltas(), stats_proto.gauges());
+  if (!stats_proto.has_snapshot()) {
+    // A parent of an earlier version sends the stats in the maps of the reply.
+    stat_merger_->mergeStats(stats_proto.counter_deltas(), stats_proto.gauges());
+    return;
+  }
+
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const int fd = stats_proto.snapshot().fd();
+  const uint64_t size = stats_proto.snapshot().size();
+  const Api::SysCallPtrResult mmap_result =
+      os_sys_calls.mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  os_sys_calls.close(fd);
+  RELEASE_ASSERT(mmap_result.rc_ != MAP_FAILED, "failed to map the stats snapshot of the parent");
+
+  StatsSnapshot snapshot(stats_store.symbolTable());
+  const bool decoded =
+      snapshot.decode(absl::string_view(static_cast<const char*>(mmap_result.rc_), size));
+  munmap(mmap_result.rc_, size);
+  if (!decoded) {
+    ENVOY_LOG(warn, "ignoring a malformed stats snapshot from the parent");
+    return;
+  }
+  stat_merger_->mergeStats(snapshot.counterDeltas(), snapshot.gauges());
+}
+
+std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentTlsSessions() {
+  if (restart_epoch_ == 0 || parent_terminated_) {
+    return nullptr;
+  }
+
+  HotRestartMessage wrapped_request;
+  wrapped_request.mutable_request()->mutable_tls_sessions();
+  sendHotRestartMessage(parent_address_, wrapped_request);
+
+  std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
+  // A parent of an earlier version may not know about TLS sessions, in which case they start cold.
+  if (!replyIsExpectedType(wrapped_reply.get(), HotRestartMessage::Reply::kTlsSessions)) {
+    return nullptr;
+  }
+  return wrapped_reply;
+}
+
+void HotRestartingChild::importParentTlsSessions(
+    Ssl::SessionCache& session_cache,
+    const HotRestartMessage::Reply::TlsSessions& sessions_proto) {
+  for (const auto& session : sessions_proto.sessions()) {
+    session_cache.store(session.key(),
+                        std::vector<uint8_t>(session.session().begin(), session.session().end()));
+  }
+  ENVOY_LOG(info, "imported {} TLS sessions from the parent", sessions_proto.sessions_size());
 }
 
 } // namespace Server
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "envoy/ssl/session_cache.h"
+
 #include "common/stats/stat_merger.h"
 
 #include "server/hot_restarting_base.h"
@@ -14,13 +16,16 @@ class HotRestartingChild : HotRestartingBase, Logger::Loggable<Logger::Id::main>
 public:
   HotRestartingChild(int base_id, int restart_epoch);
 
-  int duplicateParentListenSocket(const std::string& address);
+  int duplicateParentListenSocket(const std::string& address, uint32_t worker_index);
   std::unique_ptr<envoy::HotRestartMessage> getParentStats();
   void drainParentListeners();
   void sendParentAdminShutdownRequest(time_t& original_start_time);
   void sendParentTerminateRequest();
   void mergeParentStats(Stats::Store& stats_store,
                         const envoy::HotRestartMessage::Reply::Stats& stats_proto);
+  std::unique_ptr<envoy::HotRestartMessage> getParentTlsSessions();
+  void importParentTlsSessions(Ssl::SessionCache& session_cache,
+                               const envoy::HotRestartMessage::Reply::TlsSessions& sessions_proto);
 
 private:
   const int restart_epoch_;
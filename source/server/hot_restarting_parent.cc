@@ -2,9 +2,13 @@
 
 #include "envoy/server/instance.h"
 
+#include "common/api/os_sys_calls_impl.h"
+#include "common/api/os_sys_calls_impl_hot_restart.h"
 #include "common/memory/stats.h"
 #include "common/network/utility.h"
 
+#include "server/hot_restart_stats_snapshot.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -51,7 +55,21 @@ void HotRestartingParent::onSocketEvent() {
 
     case HotRestartMessage::Request::kStats: {
       HotRestartMessage wrapped_reply;
-      internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats());
+      HotRestartMessage::Reply::Stats* stats = wrapped_reply.mutable_reply()->mutable_stats();
+      if (!wrapped_request->request().stats().snapshot() ||
+          !internal_->exportStatsSnapshotToChild(stats)) {
+        internal_->exportStatsToChild(stats);
+      }
+      sendHotRestartMessage(child_address_, wrapped_reply);
+      if (stats->has_snapshot()) {
+        Api::OsSysCallsSingleton::get().close(stats->snapshot().fd());
+      }
+      break;
+    }
+
+    case HotRestartMessage::Request::kTlsSessions: {
+      HotRestartMessage wrapped_reply;
+      internal_->exportTlsSessionsToChild(wrapped_reply.mutable_reply()->mutable_tls_sessions());
       sendHotRestartMessage(child_address_, wrapped_reply);
       break;
     }
@@ -94,10 +112,16 @@ HotRestartingParent::Internal::getListenSocketsForChild(const HotRestartMessage:
   wrapped_reply.mutable_reply()->mutable_pass_listen_socket()->set_fd(-1);
   Network::Address::InstanceConstSharedPtr addr =
       Network::Utility::resolveUrl(request.pass_listen_socket().address());
+  const uint32_t worker_index = request.pass_listen_socket().worker_index();
   for (const auto& listener : server_->listenerManager().listeners()) {
     if (*listener.get().socket().localAddress() == *addr) {
-      wrapped_reply.mutable_reply()->mutable_pass_listen_socket()->set_fd(
-          listener.get().socket().ioHandle().fd());
+      // Only pass a socket for a worker after the first if it is that worker's own socket, so
+      // that the child does not share one socket among workers that expect one each.
+      const Network::Socket& socket = listener.get().workerSocket(worker_index);
+      if (worker_index == 0 || &socket != &listener.get().socket()) {
+        wrapped_reply.mutable_reply()->mutable_pass_listen_socket()->set_fd(
+            socket.ioHandle().fd());
+      }
       break;
     }
   }
@@ -124,6 +148,66 @@ void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply:
   stats->set_num_connections(server_->listenerManager().numConnections());
 }
 
+bool HotRestartingParent::Internal::exportStatsSnapshotToChild(
+    HotRestartMessage::Reply::Stats* stats) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Api::HotRestartOsSysCalls& hot_restart_os_sys_calls = Api::HotRestartOsSysCallsSingleton::get();
+
+  // The shared memory is unlinked right away, as is any left by an earlier process with the same
+  // pid: the child maps it through the fd passed with the reply, and it is freed once both
+  // processes closed it.
+  const std::string shmem_name = fmt::format("/envoy_stats_snapshot_{}", getpid());
+  hot_restart_os_sys_calls.shmUnlink(shmem_name.c_str());
+  const Api::SysCallIntResult result = hot_restart_os_sys_calls.shmOpen(
+      shmem_name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  if (result.rc_ == -1) {
+    ENVOY_LOG(warn, "cannot open shared memory region {} for the stats snapshot: {}", shmem_name,
+              strerror(result.errno_));
+    return false;
+  }
+  hot_restart_os_sys_calls.shmUnlink(shmem_name.c_str());
+
+  // The names are split into tokens as they are, without building the full string of each.
+  StatsSnapshotEncoder encoder(server_->stats().symbolTable());
+  for (const auto& gauge : server_->stats().gauges()) {
+    encoder.addGauge(gauge->statName(), gauge->value());
+  }
+  for (const auto& counter : server_->stats().counters()) {
+    const uint64_t latched_value = counter->latch();
+    if (latched_value > 0) {
+      encoder.addCounter(counter->statName(), latched_value);
+    }
+  }
+  const std::string snapshot = encoder.finish();
+
+  RELEASE_ASSERT(os_sys_calls.ftruncate(result.rc_, snapshot.size()).rc_ != -1,
+                 "failed to size the stats snapshot");
+  const Api::SysCallPtrResult mmap_result =
+      os_sys_calls.mmap(nullptr, snapshot.size(), PROT_WRITE, MAP_SHARED, result.rc_, 0);
+  RELEASE_ASSERT(mmap_result.rc_ != MAP_FAILED, "failed to map the stats snapshot");
+  memcpy(mmap_result.rc_, snapshot.data(), snapshot.size());
+  munmap(mmap_result.rc_, snapshot.size());
+
+  stats->mutable_snapshot()->set_fd(result.rc_);
+  stats->mutable_snapshot()->set_size(snapshot.size());
+  stats->set_memory_allocated(Memory::Stats::totalCurrentlyAllocated());
+  stats->set_num_connections(server_->listenerManager().numConnections());
+  return true;
+}
+
+void HotRestartingParent::Internal::exportTlsSessionsToChild(
+    HotRestartMessage::Reply::TlsSessions* sessions) {
+  const Ssl::SessionCacheSharedPtr session_cache = server_->sslContextManager().sessionCache();
+  if (session_cache == nullptr) {
+    return;
+  }
+  session_cache->iterate([sessions](const std::string& key, const std::vector<uint8_t>& session) {
+    auto* session_proto = sessions->add_sessions();
+    session_proto->set_key(key);
+    session_proto->set_session(session.data(), session.size());
+  });
+}
+
 void HotRestartingParent::Internal::drainListeners() { server_->drainListeners(); }
 
 } // namespace Server
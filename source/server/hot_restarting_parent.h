@@ -30,6 +30,13 @@ public:
     getListenSocketsForChild(const envoy::HotRestartMessage::Request& request);
     // 'stats' is a field in the reply protobuf to be sent to the child, which we should populate.
     void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats);
+    // Same as above, except that the counters and gauges are encoded in shared memory, whose fd
+    // the caller must close once the reply is sent. Returns false, without exporting anything, if
+    // the shared memory cannot be created.
+    bool exportStatsSnapshotToChild(envoy::HotRestartMessage::Reply::Stats* stats);
+    // 'sessions' is a field in the reply protobuf to be sent to the child, which we should
+    // populate.
+    void exportTlsSessionsToChild(envoy::HotRestartMessage::Reply::TlsSessions* sessions);
     void drainListeners();
 
   private:
@@ -12,11 +12,11 @@
 
 #include "envoy/admin/v2alpha/certs.pb.h"
 #include "envoy/admin/v2alpha/clusters.pb.h"
-#include "envoy/admin/v2alpha/config_dump.pb.h"
 #include "envoy/admin/v2alpha/listeners.pb.h"
 #include "envoy/admin/v2alpha/memory.pb.h"
 #include "envoy/admin/v2alpha/mutex_stats.pb.h"
 #include "envoy/admin/v2alpha/server_info.pb.h"
+#include "envoy/admin/v2alpha/stalls.pb.h"
 #include "envoy/filesystem/filesystem.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/server/hot_restart.h"
@@ -30,6 +30,7 @@
 #include "common/access_log/access_log_formatter.h"
 #include "common/access_log/access_log_impl.h"
 #include "common/buffer/buffer_impl.h"
+#include "common/buffer/watermark_buffer.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/enum_to_int.h"
@@ -43,16 +44,23 @@
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 #include "common/json/json_loader.h"
+#include "common/memory/allocation_tracker.h"
 #include "common/memory/stats.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/network/utility.h"
 #include "common/profiler/profiler.h"
 #include "common/router/config_impl.h"
 #include "common/stats/histogram_impl.h"
+#include "common/stats/symbol_table_impl.h"
 #include "common/upstream/host_utility.h"
+#include "common/upstream/upstream_impl.h"
+
+#include "server/http/config_dump_response.h"
 
 #include "extensions/access_loggers/file/file_access_log_impl.h"
 
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
@@ -140,6 +148,9 @@ const char AdminHtmlEnd[] = R"(
 
 const std::regex PromRegex("[^a-zA-Z0-9_]");
 
+// The number of connections listed by /memory/connections unless its limit parameter is set.
+constexpr uint32_t DefaultBufferedConnectionsLimit = 10;
+
 void populateFallbackResponseHeaders(Http::Code code, Http::HeaderMap& header_map) {
   header_map.insertStatus().value(std::to_string(enumToInt(code)));
   const auto& headers = Http::Headers::get();
@@ -163,6 +174,16 @@ absl::optional<std::regex> filterParam(Http::Utility::QueryParams params) {
              : absl::nullopt;
 }
 
+// Helper method to get the prefix parameter, only showing the stats whose names start with it.
+std::string prefixParam(const Http::Utility::QueryParams& params) {
+  const auto prefix = params.find("prefix");
+  return prefix != params.end() ? prefix->second : EMPTY_STRING;
+}
+
+bool hasPrefix(const Stats::Metric& metric, const std::string& prefix) {
+  return prefix.empty() || absl::StartsWith(metric.name(), prefix);
+}
+
 // Helper method to get the format parameter
 absl::optional<std::string> formatParam(Http::Utility::QueryParams params) {
   return (params.find("format") != params.end()) ? absl::optional<std::string>{params.at("format")}
@@ -206,6 +227,37 @@ void setHealthFlag(Upstream::Host::HealthFlag flag, const Upstream::Host& host,
     break;
   }
 }
+
+// Adds up the memory held by the names of the given stats, which are all of the same type.
+template <class StatTypeSharedPtr>
+void addStatTypeMemory(const std::vector<StatTypeSharedPtr>& stats,
+                       envoy::admin::v2alpha::StatTypeMemory& memory) {
+  Stats::StatNameHashSet tag_extracted_names;
+  uint64_t name_bytes = 0;
+  uint64_t tag_extracted_name_bytes = 0;
+  uint64_t tag_bytes = 0;
+  for (const StatTypeSharedPtr& stat : stats) {
+    const Stats::StatName name = stat->statName();
+    const Stats::StatName tag_extracted_name = stat->tagExtractedStatName();
+    name_bytes += name.size();
+    // A tag-extracted name equal to the name shares its storage.
+    if (tag_extracted_name.data() != name.data()) {
+      tag_extracted_name_bytes += tag_extracted_name.size();
+    }
+    tag_extracted_names.insert(tag_extracted_name);
+    stat->iterateTagStatNames(
+        [&tag_bytes](Stats::StatName tag_name, Stats::StatName tag_value) -> bool {
+          tag_bytes += tag_name.size() + tag_value.size();
+          return true;
+        });
+  }
+  memory.set_stats(stats.size());
+  memory.set_name_bytes(name_bytes);
+  memory.set_tag_extracted_name_bytes(tag_extracted_name_bytes);
+  memory.set_tag_bytes(tag_bytes);
+  memory.set_unique_tag_extracted_names(tag_extracted_names.size());
+}
+
 } // namespace
 
 AdminFilter::AdminFilter(AdminImpl& parent) : parent_(parent) {}
@@ -239,6 +291,7 @@ Http::FilterTrailersStatus AdminFilter::decodeTrailers(Http::HeaderMap&) {
 }
 
 void AdminFilter::onDestroy() {
+  stopStreaming();
   for (const auto& callback : on_destroy_callbacks_) {
     callback();
   }
@@ -260,6 +313,51 @@ const Http::HeaderMap& AdminFilter::getRequestHeaders() const {
   return *request_headers_;
 }
 
+void AdminFilter::streamResponse(Buffer::Instance& response, ChunkCallback next_chunk) {
+  if (!can_stream_response_) {
+    while (next_chunk(response)) {
+    }
+    return;
+  }
+  next_chunk_ = std::move(next_chunk);
+}
+
+void AdminFilter::onBelowWriteBufferLowWatermark() {
+  ASSERT(high_watermark_count_ > 0);
+  if (--high_watermark_count_ == 0 && next_chunk_ != nullptr) {
+    next_chunk_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
+void AdminFilter::streamNextChunk() {
+  // Resumed by onBelowWriteBufferLowWatermark() once the downstream drains.
+  if (high_watermark_count_ > 0) {
+    return;
+  }
+
+  Buffer::OwnedImpl chunk;
+  const bool more = next_chunk_(chunk);
+  if (!more) {
+    stopStreaming();
+  }
+  callbacks_->encodeData(chunk, !more);
+  if (more && high_watermark_count_ == 0) {
+    // The next chunk is written in a later event loop iteration, so that other events are not
+    // held up by a large response.
+    next_chunk_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
+void AdminFilter::stopStreaming() {
+  if (next_chunk_ == nullptr) {
+    return;
+  }
+  // The timer may be running its callback, so it is only disabled here.
+  callbacks_->removeDownstreamWatermarkCallbacks(*this);
+  next_chunk_timer_->disableTimer();
+  next_chunk_ = nullptr;
+}
+
 bool AdminImpl::changeLogLevel(const Http::Utility::QueryParams& params) {
   if (params.size() != 1) {
     return false;
@@ -535,20 +633,39 @@ Http::Code AdminImpl::handlerClusters(absl::string_view url, Http::HeaderMap& re
   return Http::Code::OK;
 }
 
-// TODO(jsedgwick) Use query params to list available dumps, selectively dump, etc
-Http::Code AdminImpl::handlerConfigDump(absl::string_view, Http::HeaderMap& response_headers,
-                                        Buffer::Instance& response, AdminStream&) const {
-  envoy::admin::v2alpha::ConfigDump dump;
-  for (const auto& key_callback_pair : config_tracker_.getCallbacksMap()) {
-    ProtobufTypes::MessagePtr message = key_callback_pair.second();
-    RELEASE_ASSERT(message, "");
-    auto& any_message = *(dump.add_configs());
-    any_message.PackFrom(*message);
+Http::Code AdminImpl::handlerConfigDump(absl::string_view url, Http::HeaderMap& response_headers,
+                                        Buffer::Instance& response,
+                                        AdminStream& admin_stream) const {
+  const Http::Utility::QueryParams params = Http::Utility::parseQueryString(url);
+  const auto resource = params.find("resource");
+  const auto name_regex_param = params.find("name_regex");
+  absl::optional<std::regex> name_regex;
+  if (name_regex_param != params.end()) {
+    try {
+      name_regex = std::regex(name_regex_param->second);
+    } catch (const std::regex_error&) {
+      response.add("Invalid name_regex\n");
+      return Http::Code::BadRequest;
+    }
   }
 
-  response_headers.insertContentType().value().setReference(
-      Http::Headers::get().ContentTypeValues.Json);
-  response.add(MessageUtil::getJsonStringFromMessage(dump, true)); // pretty-print
+  ConfigDumpResponse::Format format = ConfigDumpResponse::Format::Json;
+  const absl::optional<std::string> format_value = formatParam(params);
+  if (format_value.has_value() && format_value.value() == "proto") {
+    format = ConfigDumpResponse::Format::Proto;
+    response_headers.insertContentType().value().setReference(
+        Http::Headers::get().ContentTypeValues.Protobuf);
+  } else {
+    response_headers.insertContentType().value().setReference(
+        Http::Headers::get().ContentTypeValues.Json);
+  }
+
+  auto config_dump_response = std::make_shared<ConfigDumpResponse>(
+      config_tracker_, format, resource != params.end() ? resource->second : EMPTY_STRING,
+      name_regex);
+  admin_stream.streamResponse(response, [config_dump_response](Buffer::Instance& chunk) -> bool {
+    return config_dump_response->nextChunk(chunk);
+  });
   return Http::Code::OK;
 }
 
@@ -564,6 +681,15 @@ Http::Code AdminImpl::handlerContention(absl::string_view, Http::HeaderMap& resp
     mutex_stats.set_num_contentions(server_.mutexTracer()->numContentions());
     mutex_stats.set_current_wait_cycles(server_.mutexTracer()->currentWaitCycles());
     mutex_stats.set_lifetime_wait_cycles(server_.mutexTracer()->lifetimeWaitCycles());
+    for (const auto& contention : server_.mutexTracer()->namedContentions()) {
+      auto* named_mutex = mutex_stats.add_named_mutexes();
+      named_mutex->set_name(contention.name_);
+      named_mutex->set_num_contentions(contention.num_contentions_);
+      named_mutex->set_lifetime_wait_cycles(contention.lifetime_wait_cycles_);
+      for (const int64_t count : contention.wait_cycles_histogram_) {
+        named_mutex->add_wait_cycles_histogram(count);
+      }
+    }
     response.add(MessageUtil::getJsonStringFromMessage(mutex_stats, true, true));
   } else {
     response.add("Mutex contention tracing is not enabled. To enable, run Envoy with flag "
@@ -575,15 +701,21 @@ Http::Code AdminImpl::handlerContention(absl::string_view, Http::HeaderMap& resp
 Http::Code AdminImpl::handlerCpuProfiler(absl::string_view url, Http::HeaderMap&,
                                          Buffer::Instance& response, AdminStream&) {
   Http::Utility::QueryParams query_params = Http::Utility::parseQueryString(url);
-  if (query_params.size() != 1 || query_params.begin()->first != "enable" ||
-      (query_params.begin()->second != "y" && query_params.begin()->second != "n")) {
-    response.add("?enable=<y|n>\n");
+  const auto enable_it = query_params.find("enable");
+  const auto threads_it = query_params.find("threads");
+  if (enable_it == query_params.end() || (enable_it->second != "y" && enable_it->second != "n") ||
+      query_params.size() != (threads_it == query_params.end() ? 1 : 2) ||
+      (threads_it != query_params.end() && threads_it->second != "all" &&
+       threads_it->second != "workers")) {
+    response.add("?enable=<y|n>[&threads=<all|workers>]\n");
     return Http::Code::BadRequest;
   }
 
-  bool enable = query_params.begin()->second == "y";
+  bool enable = enable_it->second == "y";
+  bool workers_only = threads_it != query_params.end() && threads_it->second == "workers";
   if (enable && !Profiler::Cpu::profilerEnabled()) {
-    if (!Profiler::Cpu::startProfiler(profile_path_)) {
+    if (!(workers_only ? Profiler::Cpu::startWorkerProfiler(profile_path_)
+                       : Profiler::Cpu::startProfiler(profile_path_))) {
       response.add("failure to start the profiler");
       return Http::Code::InternalServerError;
     }
@@ -643,6 +775,25 @@ Http::Code AdminImpl::handlerHeapProfiler(absl::string_view url, Http::HeaderMap
   return res;
 }
 
+Http::Code AdminImpl::handlerAllocationTracker(absl::string_view url, Http::HeaderMap&,
+                                               Buffer::Instance& response, AdminStream&) {
+  Http::Utility::QueryParams query_params = Http::Utility::parseQueryString(url);
+  if (query_params.size() != 1 || query_params.begin()->first != "enable" ||
+      (query_params.begin()->second != "y" && query_params.begin()->second != "n")) {
+    response.add("?enable=<y|n>\n");
+    return Http::Code::BadRequest;
+  }
+
+  const bool enable = query_params.begin()->second == "y";
+  if (!Memory::AllocationTracker::setEnabled(enable)) {
+    response.add("The current build does not support tracking the allocations\n");
+    return Http::Code::NotImplemented;
+  }
+  response.add(enable ? "Tracking the allocations of new requests\n"
+                      : "Stopped tracking the allocations\n");
+  return Http::Code::OK;
+}
+
 Http::Code AdminImpl::handlerHealthcheckFail(absl::string_view, Http::HeaderMap&,
                                              Buffer::Instance& response, AdminStream&) {
   server_.failHealthcheck(true);
@@ -704,6 +855,111 @@ Http::Code AdminImpl::handlerMemory(absl::string_view, Http::HeaderMap& response
   return Http::Code::OK;
 }
 
+Http::Code AdminImpl::handlerHostMemory(absl::string_view, Http::HeaderMap& response_headers,
+                                        Buffer::Instance& response, AdminStream&) {
+  response_headers.insertContentType().value().setReference(
+      Http::Headers::get().ContentTypeValues.Json);
+  const Upstream::HostMemoryStats stats = Upstream::HostDescriptionImpl::memoryStats();
+  envoy::admin::v2alpha::HostMemory memory;
+  memory.set_hosts(stats.hosts_);
+  memory.set_hosts_with_stats(stats.hosts_with_stats_);
+  memory.set_host_bytes(sizeof(Upstream::HostImpl));
+  memory.set_stats_bytes(sizeof(Upstream::HostStatsBlock));
+  memory.set_unique_addresses(stats.unique_addresses_);
+  memory.set_unique_localities(stats.unique_localities_);
+  memory.set_unique_metadata(stats.unique_metadata_);
+  memory.set_unique_metadata_bytes(stats.unique_metadata_bytes_);
+  if (stats.hosts_ > 0) {
+    memory.set_bytes_per_host(sizeof(Upstream::HostImpl) +
+                              (stats.hosts_with_stats_ * sizeof(Upstream::HostStatsBlock) +
+                               stats.unique_metadata_bytes_) /
+                                  stats.hosts_);
+  }
+  response.add(MessageUtil::getJsonStringFromMessage(memory, true, true)); // pretty-print
+  return Http::Code::OK;
+}
+
+Http::Code AdminImpl::handlerConnectionsMemory(absl::string_view url,
+                                               Http::HeaderMap& response_headers,
+                                               Buffer::Instance& response, AdminStream&) {
+  const Http::Utility::QueryParams params = Http::Utility::parseQueryString(url);
+  uint32_t limit = DefaultBufferedConnectionsLimit;
+  const auto limit_it = params.find("limit");
+  if (limit_it != params.end() && !absl::SimpleAtoi(limit_it->second, &limit)) {
+    response.add("usage: /memory/connections?limit=<connections>\n");
+    return Http::Code::BadRequest;
+  }
+
+  response_headers.insertContentType().value().setReference(
+      Http::Headers::get().ContentTypeValues.Json);
+  envoy::admin::v2alpha::ConnectionsMemory memory;
+  memory.set_total_buffered_bytes(Buffer::WatermarkBuffer::totalBufferedBytes());
+  for (const Network::BufferedConnection& connection :
+       server_.listenerManager().topBufferedConnections(limit)) {
+    envoy::admin::v2alpha::BufferedConnection& buffered_connection = *memory.add_connections();
+    buffered_connection.set_id(connection.id_);
+    buffered_connection.set_listener(connection.listener_name_);
+    buffered_connection.set_remote_address(connection.remote_address_);
+    buffered_connection.set_buffered_bytes(connection.buffered_bytes_);
+  }
+  response.add(MessageUtil::getJsonStringFromMessage(memory, true, true)); // pretty-print
+  return Http::Code::OK;
+}
+
+Http::Code AdminImpl::handlerAllocationsMemory(absl::string_view,
+                                               Http::HeaderMap& response_headers,
+                                               Buffer::Instance& response, AdminStream&) {
+  response_headers.insertContentType().value().setReference(
+      Http::Headers::get().ContentTypeValues.Json);
+  envoy::admin::v2alpha::AllocationsMemory memory;
+  memory.set_enabled(Memory::AllocationTracker::enabled());
+  for (const Memory::SubsystemAllocations& subsystem : Memory::AllocationTracker::subsystems()) {
+    envoy::admin::v2alpha::SubsystemAllocations& allocations = *memory.add_subsystems();
+    allocations.set_name(subsystem.name_);
+    allocations.set_requests(subsystem.requests_);
+    allocations.set_allocations(subsystem.counts_.allocations_);
+    allocations.set_allocated_bytes(subsystem.counts_.bytes_);
+  }
+  response.add(MessageUtil::getJsonStringFromMessage(memory, true, true)); // pretty-print
+  return Http::Code::OK;
+}
+
+Http::Code AdminImpl::handlerStalls(absl::string_view, Http::HeaderMap& response_headers,
+                                    Buffer::Instance& response, AdminStream&) {
+  response_headers.insertContentType().value().setReference(
+      Http::Headers::get().ContentTypeValues.Json);
+  envoy::admin::v2alpha::Stalls stalls;
+  if (server_.guardDog() != nullptr) {
+    for (const Server::StallReport& report : server_.guardDog()->recentStalls()) {
+      envoy::admin::v2alpha::Stall& stall = *stalls.add_stalls();
+      stall.set_thread_id(report.thread_id_);
+      TimestampUtil::systemClockToTimestamp(report.time_, *stall.mutable_time());
+      *stall.mutable_stalled_for() =
+          Protobuf::util::TimeUtil::MillisecondsToDuration(report.stalled_for_.count());
+      stall.set_tracked_object(report.tracked_object_);
+      for (const std::string& frame : report.frames_) {
+        stall.add_frames(frame);
+      }
+    }
+  }
+  response.add(MessageUtil::getJsonStringFromMessage(stalls, true, true)); // pretty-print
+  return Http::Code::OK;
+}
+
+Http::Code AdminImpl::handlerStatsMemory(absl::string_view, Http::HeaderMap& response_headers,
+                                         Buffer::Instance& response, AdminStream&) {
+  response_headers.insertContentType().value().setReference(
+      Http::Headers::get().ContentTypeValues.Json);
+  Stats::Store& store = server_.stats();
+  envoy::admin::v2alpha::StatsMemory memory;
+  addStatTypeMemory(store.counters(), *memory.mutable_counters());
+  addStatTypeMemory(store.gauges(), *memory.mutable_gauges());
+  addStatTypeMemory(store.histograms(), *memory.mutable_histograms());
+  memory.set_symbols(store.symbolTable().numSymbols());
+  response.add(MessageUtil::getJsonStringFromMessage(memory, true, true)); // pretty-print
+  return Http::Code::OK;
+}
+
 Http::Code AdminImpl::handlerResetCounters(absl::string_view, Http::HeaderMap&,
                                            Buffer::Instance& response, AdminStream&) {
   for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
@@ -748,70 +1004,74 @@ Http::Code AdminImpl::handlerReady(absl::string_view, Http::HeaderMap&, Buffer::
 
 Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& response_headers,
                                    Buffer::Instance& response, AdminStream& admin_stream) {
-  Http::Code rc = Http::Code::OK;
   const Http::Utility::QueryParams params = Http::Utility::parseQueryString(url);
 
   const bool used_only = params.find("usedonly") != params.end();
   const absl::optional<std::regex> regex = filterParam(params);
-
-  std::map<std::string, uint64_t> all_stats;
-  for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
-    if (shouldShowMetric(*counter, used_only, regex)) {
-      all_stats.emplace(counter->name(), counter->value());
-    }
-  }
-
-  for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
-    if (shouldShowMetric(*gauge, used_only, regex)) {
-      ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
-      all_stats.emplace(gauge->name(), gauge->value());
-    }
-  }
+  const std::string prefix = prefixParam(params);
 
   if (const auto format_value = formatParam(params)) {
     if (format_value.value() == "json") {
+      std::map<std::string, uint64_t> all_stats;
+      for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
+        if (hasPrefix(*counter, prefix) && shouldShowMetric(*counter, used_only, regex)) {
+          all_stats.emplace(counter->name(), counter->value());
+        }
+      }
+
+      for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
+        if (hasPrefix(*gauge, prefix) && shouldShowMetric(*gauge, used_only, regex)) {
+          ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
+          all_stats.emplace(gauge->name(), gauge->value());
+        }
+      }
+
+      std::vector<Stats::ParentHistogramSharedPtr> histograms;
+      for (const Stats::ParentHistogramSharedPtr& histogram : server_.stats().histograms()) {
+        if (hasPrefix(*histogram, prefix)) {
+          histograms.push_back(histogram);
+        }
+      }
+
       response_headers.insertContentType().value().setReference(
           Http::Headers::get().ContentTypeValues.Json);
-      response.add(
-          AdminImpl::statsAsJson(all_stats, server_.stats().histograms(), used_only, regex));
+      response.add(AdminImpl::statsAsJson(all_stats, histograms, used_only, regex));
+      return Http::Code::OK;
     } else if (format_value.value() == "prometheus") {
       return handlerPrometheusStats(url, response_headers, response, admin_stream);
     } else {
       response.add("usage: /stats?format=json  or /stats?format=prometheus \n");
       response.add("\n");
-      rc = Http::Code::NotFound;
-    }
-  } else { // Display plain stats if format query param is not there.
-    for (const auto& stat : all_stats) {
-      response.add(fmt::format("{}: {}\n", stat.first, stat.second));
-    }
-    // TODO(ramaraochavali): See the comment in ThreadLocalStoreImpl::histograms() for why we use a
-    // multimap here. This makes sure that duplicate histograms get output. When shared storage is
-    // implemented this can be switched back to a normal map.
-    std::multimap<std::string, std::string> all_histograms;
-    for (const Stats::ParentHistogramSharedPtr& histogram : server_.stats().histograms()) {
-      if (shouldShowMetric(*histogram, used_only, regex)) {
-        all_histograms.emplace(histogram->name(), histogram->quantileSummary());
-      }
-    }
-    for (const auto& histogram : all_histograms) {
-      response.add(fmt::format("{}: {}\n", histogram.first, histogram.second));
+      return Http::Code::NotFound;
     }
   }
-  return rc;
+
+  // Display plain stats if format query param is not there.
+  streamStats(StatsResponse::Format::Text, used_only, regex, prefix, response, admin_stream);
+  return Http::Code::OK;
 }
 
 Http::Code AdminImpl::handlerPrometheusStats(absl::string_view path_and_query, Http::HeaderMap&,
-                                             Buffer::Instance& response, AdminStream&) {
+                                             Buffer::Instance& response,
+                                             AdminStream& admin_stream) {
   const Http::Utility::QueryParams params = Http::Utility::parseQueryString(path_and_query);
   const bool used_only = params.find("usedonly") != params.end();
   const absl::optional<std::regex> regex = filterParam(params);
-  PrometheusStatsFormatter::statsAsPrometheus(server_.stats().counters(), server_.stats().gauges(),
-                                              server_.stats().histograms(), response, used_only,
-                                              regex);
+  streamStats(StatsResponse::Format::Prometheus, used_only, regex, prefixParam(params), response,
+              admin_stream);
   return Http::Code::OK;
 }
 
+void AdminImpl::streamStats(StatsResponse::Format format, bool used_only,
+                            const absl::optional<std::regex>& regex, const std::string& prefix,
+                            Buffer::Instance& response, AdminStream& admin_stream) {
+  auto stats_response =
+      std::make_shared<StatsResponse>(server_.stats(), format, used_only, regex, prefix);
+  admin_stream.streamResponse(response, [stats_response](Buffer::Instance& chunk) -> bool {
+    return stats_response->nextChunk(chunk);
+  });
+}
+
 std::string PrometheusStatsFormatter::sanitizeName(const std::string& name) {
   // The name must match the regex [a-zA-Z_][a-zA-Z0-9_]* as required by
   // prometheus. Refer to https://prometheus.io/docs/concepts/data_model/.
@@ -845,6 +1105,63 @@ std::string PrometheusStatsFormatter::metricName(const std::string& extractedNam
   return sanitizeName(fmt::format("envoy_{0}", extractedName));
 }
 
+void PrometheusStatsFormatter::formatCounter(const Stats::Counter& counter,
+                                             std::unordered_set<std::string>& metric_type_tracker,
+                                             Buffer::Instance& response) {
+  const std::string tags = formattedTags(counter.tags());
+  const std::string metric_name = metricName(counter.tagExtractedName());
+  if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
+    metric_type_tracker.insert(metric_name);
+    response.add(fmt::format("# TYPE {0} counter\n", metric_name));
+  }
+  response.add(fmt::format("{0}{{{1}}} {2}\n", metric_name, tags, counter.value()));
+}
+
+void PrometheusStatsFormatter::formatGauge(const Stats::Gauge& gauge,
+                                           std::unordered_set<std::string>& metric_type_tracker,
+                                           Buffer::Instance& response) {
+  const std::string tags = formattedTags(gauge.tags());
+  const std::string metric_name = metricName(gauge.tagExtractedName());
+  if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
+    metric_type_tracker.insert(metric_name);
+    response.add(fmt::format("# TYPE {0} gauge\n", metric_name));
+  }
+  response.add(fmt::format("{0}{{{1}}} {2}\n", metric_name, tags, gauge.value()));
+}
+
+void PrometheusStatsFormatter::formatHistogram(
+    const Stats::ParentHistogram& histogram, std::unordered_set<std::string>& metric_type_tracker,
+    Buffer::Instance& response) {
+  const std::string tags = formattedTags(histogram.tags());
+  const std::string hist_tags = histogram.tags().empty() ? EMPTY_STRING : (tags + ",");
+
+  const std::string metric_name = metricName(histogram.tagExtractedName());
+  if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
+    metric_type_tracker.insert(metric_name);
+    response.add(fmt::format("# TYPE {0} histogram\n", metric_name));
+  }
+
+  const Stats::HistogramStatistics& stats = histogram.cumulativeStatistics();
+  const std::vector<double>& supported_buckets = stats.supportedBuckets();
+  const std::vector<uint64_t>& computed_buckets = stats.computedBuckets();
+  for (size_t i = 0; i < supported_buckets.size(); ++i) {
+    double bucket = supported_buckets[i];
+    uint64_t value = computed_buckets[i];
+    // We want to print the bucket in a fixed point (non-scientific) format. The fmt library
+    // doesn't have a specific modifier to format as a fixed-point value only so we use the
+    // 'g' operator which prints the number in general fixed point format or scientific format
+    // with precision 50 to round the number up to 32 significant digits in fixed point format
+    // which should cover pretty much all cases
+    response.add(fmt::format("{0}_bucket{{{1}le=\"{2:.32g}\"}} {3}\n", metric_name, hist_tags,
+                             bucket, value));
+  }
+
+  response.add(fmt::format("{0}_bucket{{{1}le=\"+Inf\"}} {2}\n", metric_name, hist_tags,
+                           stats.sampleCount()));
+  response.add(fmt::format("{0}_sum{{{1}}} {2:.32g}\n", metric_name, tags, stats.sampleSum()));
+  response.add(fmt::format("{0}_count{{{1}}} {2}\n", metric_name, tags, stats.sampleCount()));
+}
+
 uint64_t PrometheusStatsFormatter::statsAsPrometheus(
     const std::vector<Stats::CounterSharedPtr>& counters,
     const std::vector<Stats::GaugeSharedPtr>& gauges,
@@ -852,69 +1169,130 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
     const bool used_only, const absl::optional<std::regex>& regex) {
   std::unordered_set<std::string> metric_type_tracker;
   for (const auto& counter : counters) {
-    if (!shouldShowMetric(*counter, used_only, regex)) {
-      continue;
-    }
-
-    const std::string tags = formattedTags(counter->tags());
-    const std::string metric_name = metricName(counter->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} counter\n", metric_name));
+    if (shouldShowMetric(*counter, used_only, regex)) {
+      formatCounter(*counter, metric_type_tracker, response);
     }
-    response.add(fmt::format("{0}{{{1}}} {2}\n", metric_name, tags, counter->value()));
   }
 
   for (const auto& gauge : gauges) {
-    if (!shouldShowMetric(*gauge, used_only, regex)) {
-      continue;
-    }
-
-    const std::string tags = formattedTags(gauge->tags());
-    const std::string metric_name = metricName(gauge->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} gauge\n", metric_name));
+    if (shouldShowMetric(*gauge, used_only, regex)) {
+      formatGauge(*gauge, metric_type_tracker, response);
     }
-    response.add(fmt::format("{0}{{{1}}} {2}\n", metric_name, tags, gauge->value()));
   }
 
   for (const auto& histogram : histograms) {
-    if (!shouldShowMetric(*histogram, used_only, regex)) {
-      continue;
+    if (shouldShowMetric(*histogram, used_only, regex)) {
+      formatHistogram(*histogram, metric_type_tracker, response);
     }
+  }
+
+  return metric_type_tracker.size();
+}
+
+constexpr uint64_t StatsResponse::ChunkSize;
 
-    const std::string tags = formattedTags(histogram->tags());
-    const std::string hist_tags = histogram->tags().empty() ? EMPTY_STRING : (tags + ",");
+StatsResponse::StatsResponse(Stats::Store& store, Format format, bool used_only,
+                             const absl::optional<std::regex>& regex, const std::string& prefix)
+    : format_(format), used_only_(used_only), regex_(regex), prefix_(prefix) {
+  if (format_ == Format::Prometheus) {
+    counters_ = store.counters();
+    gauges_ = store.gauges();
+    histograms_ = store.histograms();
+    return;
+  }
 
-    const std::string metric_name = metricName(histogram->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} histogram\n", metric_name));
+  // The text format is sorted by name, so the names and values of the stats shown are gathered
+  // up front. They are formatted chunk by chunk.
+  for (const Stats::CounterSharedPtr& counter : store.counters()) {
+    if (shouldShow(*counter)) {
+      text_stats_.emplace_back(counter->name(), counter->value());
+    }
+  }
+  for (const Stats::GaugeSharedPtr& gauge : store.gauges()) {
+    if (shouldShow(*gauge)) {
+      ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
+      text_stats_.emplace_back(gauge->name(), gauge->value());
+    }
+  }
+  std::sort(text_stats_.begin(), text_stats_.end());
+
+  // TODO(ramaraochavali): See the comment in ThreadLocalStoreImpl::histograms() for why
+  // duplicate histograms are kept here. When shared storage is implemented this can be switched
+  // back to unique names.
+  for (const Stats::ParentHistogramSharedPtr& histogram : store.histograms()) {
+    if (shouldShow(*histogram)) {
+      text_histograms_.emplace_back(histogram->name(), histogram);
     }
+  }
+  std::stable_sort(
+      text_histograms_.begin(), text_histograms_.end(),
+      [](const std::pair<std::string, Stats::ParentHistogramSharedPtr>& lhs,
+         const std::pair<std::string, Stats::ParentHistogramSharedPtr>& rhs) -> bool {
+        return lhs.first < rhs.first;
+      });
+}
 
-    const Stats::HistogramStatistics& stats = histogram->cumulativeStatistics();
-    const std::vector<double>& supported_buckets = stats.supportedBuckets();
-    const std::vector<uint64_t>& computed_buckets = stats.computedBuckets();
-    for (size_t i = 0; i < supported_buckets.size(); ++i) {
-      double bucket = supported_buckets[i];
-      uint64_t value = computed_buckets[i];
-      // We want to print the bucket in a fixed point (non-scientific) format. The fmt library
-      // doesn't have a specific modifier to format as a fixed-point value only so we use the
-      // 'g' operator which prints the number in general fixed point format or scientific format
-      // with precision 50 to round the number up to 32 significant digits in fixed point format
-      // which should cover pretty much all cases
-      response.add(fmt::format("{0}_bucket{{{1}le=\"{2:.32g}\"}} {3}\n", metric_name, hist_tags,
-                               bucket, value));
+bool StatsResponse::nextChunk(Buffer::Instance& response) {
+  const uint64_t start = response.length();
+  while (response.length() - start < ChunkSize) {
+    const bool added = format_ == Format::Prometheus ? addNextPrometheusStat(response)
+                                                      : addNextTextStat(response);
+    if (!added) {
+      return false;
     }
+  }
+  return true;
+}
 
-    response.add(fmt::format("{0}_bucket{{{1}le=\"+Inf\"}} {2}\n", metric_name, hist_tags,
-                             stats.sampleCount()));
-    response.add(fmt::format("{0}_sum{{{1}}} {2:.32g}\n", metric_name, tags, stats.sampleSum()));
-    response.add(fmt::format("{0}_count{{{1}}} {2}\n", metric_name, tags, stats.sampleCount()));
+bool StatsResponse::shouldShow(const Stats::Metric& metric) const {
+  if (used_only_ && !metric.used()) {
+    return false;
+  }
+  if (prefix_.empty() && !regex_.has_value()) {
+    return true;
   }
+  const std::string name = metric.name();
+  return absl::StartsWith(name, prefix_) &&
+         (!regex_.has_value() || std::regex_search(name, regex_.value()));
+}
 
-  return metric_type_tracker.size();
+bool StatsResponse::addNextTextStat(Buffer::Instance& response) {
+  if (next_text_stat_ < text_stats_.size()) {
+    const auto& stat = text_stats_[next_text_stat_++];
+    response.add(fmt::format("{}: {}\n", stat.first, stat.second));
+    return true;
+  }
+  if (next_text_histogram_ < text_histograms_.size()) {
+    const auto& histogram = text_histograms_[next_text_histogram_++];
+    response.add(fmt::format("{}: {}\n", histogram.first, histogram.second->quantileSummary()));
+    return true;
+  }
+  return false;
+}
+
+bool StatsResponse::addNextPrometheusStat(Buffer::Instance& response) {
+  while (next_counter_ < counters_.size()) {
+    const Stats::Counter& counter = *counters_[next_counter_++];
+    if (shouldShow(counter)) {
+      PrometheusStatsFormatter::formatCounter(counter, metric_type_tracker_, response);
+      return true;
+    }
+  }
+  while (next_gauge_ < gauges_.size()) {
+    const Stats::Gauge& gauge = *gauges_[next_gauge_++];
+    if (shouldShow(gauge)) {
+      PrometheusStatsFormatter::formatGauge(gauge, metric_type_tracker_, response);
+      return true;
+    }
+  }
+  while (next_histogram_ < histograms_.size()) {
+    const Stats::ParentHistogram& histogram = *histograms_[next_histogram_++];
+    if (shouldShow(histogram)) {
+      PrometheusStatsFormatter::formatHistogram(histogram, metric_type_tracker_, response);
+      return true;
+    }
+  }
+  return false;
 }
 
 std::string
@@ -1157,13 +1535,21 @@ void AdminFilter::onComplete() {
   Buffer::OwnedImpl response;
   Http::HeaderMapPtr header_map{new Http::HeaderMapImpl};
   RELEASE_ASSERT(request_headers_, "");
+  can_stream_response_ = true;
   Http::Code code = parent_.runCallback(path, *header_map, response, *this);
   populateFallbackResponseHeaders(code, *header_map);
-  callbacks_->encodeHeaders(std::move(header_map),
-                            end_stream_on_complete_ && response.length() == 0);
+  const bool end_stream = end_stream_on_complete_ && next_chunk_ == nullptr;
+  callbacks_->encodeHeaders(std::move(header_map), end_stream && response.length() == 0);
 
   if (response.length() > 0) {
-    callbacks_->encodeData(response, end_stream_on_complete_);
+    callbacks_->encodeData(response, end_stream);
+  }
+
+  if (next_chunk_ != nullptr) {
+    callbacks_->addDownstreamWatermarkCallbacks(*this);
+    next_chunk_timer_ =
+        callbacks_->dispatcher().createTimer([this]() -> void { streamNextChunk(); });
+    streamNextChunk();
   }
 }
 
@@ -1203,6 +1589,8 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
       // TODO(jsedgwick) add /runtime_reset endpoint that removes all admin-set values
       handlers_{
           {"/", "Admin home page", MAKE_ADMIN_HANDLER(handlerAdminHome), false, false},
+          {"/allocationtracker", "enable/disable tracking the allocations of the requests",
+           MAKE_ADMIN_HANDLER(handlerAllocationTracker), false, true},
           {"/certs", "print certs on machine", MAKE_ADMIN_HANDLER(handlerCerts), false, false},
           {"/clusters", "upstream cluster status", MAKE_ADMIN_HANDLER(handlerClusters), false,
            false},
@@ -1226,12 +1614,22 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
            true},
           {"/memory", "print current allocation/heap usage", MAKE_ADMIN_HANDLER(handlerMemory),
            false, false},
+          {"/memory/allocations", "print the allocations of the requests by subsystem",
+           MAKE_ADMIN_HANDLER(handlerAllocationsMemory), false, false},
+          {"/memory/connections", "print the connections buffering the most data",
+           MAKE_ADMIN_HANDLER(handlerConnectionsMemory), false, false},
+          {"/memory/hosts", "print the memory held by upstream hosts",
+           MAKE_ADMIN_HANDLER(handlerHostMemory), false, false},
+          {"/memory/stats", "print the memory held by the names of the stats",
+           MAKE_ADMIN_HANDLER(handlerStatsMemory), false, false},
           {"/quitquitquit", "exit the server", MAKE_ADMIN_HANDLER(handlerQuitQuitQuit), false,
            true},
           {"/reset_counters", "reset all counters to zero",
            MAKE_ADMIN_HANDLER(handlerResetCounters), false, true},
           {"/server_info", "print server version/status information",
            MAKE_ADMIN_HANDLER(handlerServerInfo), false, false},
+          {"/stalls", "print the stacks of the threads which recently missed the watchdog",
+           MAKE_ADMIN_HANDLER(handlerStalls), false, false},
           {"/ready", "print server state, return 200 if LIVE, otherwise return 503",
            MAKE_ADMIN_HANDLER(handlerReady), false, false},
           {"/stats", "print server stats", MAKE_ADMIN_HANDLER(handlerStats), false, false},
@@ -2,8 +2,10 @@
 
 #include <chrono>
 #include <list>
+#include <regex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -17,6 +19,7 @@
 #include "envoy/server/instance.h"
 #include "envoy/server/listener_manager.h"
 #include "envoy/stats/scope.h"
+#include "envoy/stats/store.h"
 #include "envoy/upstream/outlier_detection.h"
 #include "envoy/upstream/resource_manager.h"
 
@@ -27,6 +30,7 @@
 #include "common/http/date_provider_impl.h"
 #include "common/http/default_server_string.h"
 #include "common/http/utility.h"
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/raw_buffer_socket.h"
 #include "common/router/scoped_config_impl.h"
 #include "common/stats/isolated_store_impl.h"
@@ -47,6 +51,59 @@ class AdminInternalAddressConfig : public Http::InternalAddressConfig {
   bool isInternalAddress(const Network::Address::Instance&) const override { return false; }
 };
 
+/**
+ * The body of a /stats or /stats/prometheus response, formatted chunk by chunk so that it can be
+ * streamed, @see AdminStream::streamResponse(). The stats are snapshotted when the response is
+ * created, as references to the metrics rather than copies of them, except for the names and
+ * values of the text format, which is sorted by name.
+ */
+class StatsResponse {
+public:
+  enum class Format { Text, Prometheus };
+
+  // A chunk is complete once it holds at least this many bytes.
+  static constexpr uint64_t ChunkSize = 64 * 1024;
+
+  /**
+   * @param store supplies the stats.
+   * @param format supplies the format of the response.
+   * @param used_only supplies whether only the stats which have been updated are shown.
+   * @param regex supplies the regex the names of the stats shown must match, if any.
+   * @param prefix supplies the prefix the names of the stats shown must start with, if any.
+   */
+  StatsResponse(Stats::Store& store, Format format, bool used_only,
+                const absl::optional<std::regex>& regex, const std::string& prefix);
+
+  /**
+   * Adds the next chunk of the response.
+   * @param response supplies the buffer to add the chunk to.
+   * @return whether more chunks follow.
+   */
+  bool nextChunk(Buffer::Instance& response);
+
+private:
+  bool shouldShow(const Stats::Metric& metric) const;
+  // Each adds the next stat shown, returning false once there are none left.
+  bool addNextTextStat(Buffer::Instance& response);
+  bool addNextPrometheusStat(Buffer::Instance& response);
+
+  const Format format_;
+  const bool used_only_;
+  const absl::optional<std::regex> regex_;
+  const std::string prefix_;
+  std::vector<std::pair<std::string, uint64_t>> text_stats_;
+  std::vector<std::pair<std::string, Stats::ParentHistogramSharedPtr>> text_histograms_;
+  size_t next_text_stat_{};
+  size_t next_text_histogram_{};
+  std::vector<Stats::CounterSharedPtr> counters_;
+  std::vector<Stats::GaugeSharedPtr> gauges_;
+  std::vector<Stats::ParentHistogramSharedPtr> histograms_;
+  size_t next_counter_{};
+  size_t next_gauge_{};
+  size_t next_histogram_{};
+  std::unordered_set<std::string> metric_type_tracker_;
+};
+
 /**
  * Implementation of Server::Admin.
  */
@@ -113,6 +170,7 @@ public:
   bool preserveExternalRequestId() const override { return false; }
   absl::optional<std::chrono::milliseconds> idleTimeout() const override { return idle_timeout_; }
   uint32_t maxRequestHeadersKb() const override { return max_request_headers_kb_; }
+  uint32_t overloadBufferLimit() const override { return 0; }
   std::chrono::milliseconds streamIdleTimeout() const override { return {}; }
   std::chrono::milliseconds requestTimeout() const override { return {}; }
   std::chrono::milliseconds delayedCloseTimeout() const override { return {}; }
@@ -244,12 +302,15 @@ private:
    */
   Http::Code handlerAdminHome(absl::string_view path_and_query, Http::HeaderMap& response_headers,
                               Buffer::Instance& response, AdminStream&);
+  Http::Code handlerAllocationTracker(absl::string_view path_and_query,
+                                     Http::HeaderMap& response_headers,
+                                     Buffer::Instance& response, AdminStream&);
   Http::Code handlerCerts(absl::string_view path_and_query, Http::HeaderMap& response_headers,
                           Buffer::Instance& response, AdminStream&);
   Http::Code handlerClusters(absl::string_view path_and_query, Http::HeaderMap& response_headers,
                              Buffer::Instance& response, AdminStream&);
   Http::Code handlerConfigDump(absl::string_view path_and_query, Http::HeaderMap& response_headers,
-                               Buffer::Instance& response, AdminStream&) const;
+                               Buffer::Instance& response, AdminStream& admin_stream) const;
   Http::Code handlerContention(absl::string_view path_and_query, Http::HeaderMap& response_headers,
                                Buffer::Instance& response, AdminStream&);
   Http::Code handlerCpuProfiler(absl::string_view path_and_query, Http::HeaderMap& response_headers,
@@ -275,6 +336,20 @@ private:
                             Buffer::Instance& response, AdminStream&);
   Http::Code handlerMemory(absl::string_view path_and_query, Http::HeaderMap& response_headers,
                            Buffer::Instance& response, AdminStream&);
+  Http::Code handlerHostMemory(absl::string_view path_and_query,
+                               Http::HeaderMap& response_headers, Buffer::Instance& response,
+                               AdminStream&);
+  Http::Code handlerConnectionsMemory(absl::string_view path_and_query,
+                                      Http::HeaderMap& response_headers,
+                                      Buffer::Instance& response, AdminStream&);
+  Http::Code handlerAllocationsMemory(absl::string_view path_and_query,
+                                      Http::HeaderMap& response_headers,
+                                      Buffer::Instance& response, AdminStream&);
+  Http::Code handlerStatsMemory(absl::string_view path_and_query,
+                                Http::HeaderMap& response_headers, Buffer::Instance& response,
+                                AdminStream&);
+  Http::Code handlerStalls(absl::string_view path_and_query, Http::HeaderMap& response_headers,
+                           Buffer::Instance& response, AdminStream&);
   Http::Code handlerMain(const std::string& path, Buffer::Instance& response, AdminStream&);
   Http::Code handlerQuitQuitQuit(absl::string_view path_and_query,
                                  Http::HeaderMap& response_headers, Buffer::Instance& response,
@@ -291,6 +366,9 @@ private:
   Http::Code handlerPrometheusStats(absl::string_view path_and_query,
                                     Http::HeaderMap& response_headers, Buffer::Instance& response,
                                     AdminStream&);
+  void streamStats(StatsResponse::Format format, bool used_only,
+                   const absl::optional<std::regex>& regex, const std::string& prefix,
+                   Buffer::Instance& response, AdminStream& admin_stream);
   Http::Code handlerRuntime(absl::string_view path_and_query, Http::HeaderMap& response_headers,
                             Buffer::Instance& response, AdminStream&);
   Http::Code handlerRuntimeModify(absl::string_view path_and_query,
@@ -309,14 +387,17 @@ private:
     Network::FilterChainFactory& filterChainFactory() override { return parent_; }
     Network::Socket& socket() override { return parent_.mutable_socket(); }
     const Network::Socket& socket() const override { return parent_.mutable_socket(); }
+    Network::Socket& workerSocket(uint32_t) override { return parent_.mutable_socket(); }
     bool bindToPort() override { return true; }
     bool handOffRestoredDestinationConnections() const override { return false; }
     uint32_t perConnectionBufferLimitBytes() const override { return 0; }
+    uint32_t perConnectionReadBudgetBytes() const override { return 0; }
     std::chrono::milliseconds listenerFiltersTimeout() const override {
       return std::chrono::milliseconds();
     }
     bool continueOnListenerFiltersTimeout() const override { return false; }
     Stats::Scope& listenerScope() override { return *scope_; }
+    Network::ConnectionBalancer& connectionBalancer() override { return connection_balancer_; }
     uint64_t listenerTag() const override { return 0; }
     const std::string& name() const override { return name_; }
 
@@ -324,6 +405,7 @@ private:
     const std::string name_;
     Stats::ScopePtr scope_;
     Http::ConnectionManagerListenerStats stats_;
+    Network::NopConnectionBalancerImpl connection_balancer_;
   };
   using AdminListenerPtr = std::unique_ptr<AdminListener>;
 
@@ -376,6 +458,7 @@ private:
  */
 class AdminFilter : public Http::StreamDecoderFilter,
                     public AdminStream,
+                    public Http::DownstreamWatermarkCallbacks,
                     Logger::Loggable<Logger::Id::admin> {
 public:
   AdminFilter(AdminImpl& parent);
@@ -397,6 +480,11 @@ public:
   Http::StreamDecoderFilterCallbacks& getDecoderFilterCallbacks() const override;
   const Buffer::Instance* getRequestBody() const override;
   const Http::HeaderMap& getRequestHeaders() const override;
+  void streamResponse(Buffer::Instance& response, ChunkCallback next_chunk) override;
+
+  // Http::DownstreamWatermarkCallbacks
+  void onAboveWriteBufferHighWatermark() override { high_watermark_count_++; }
+  void onBelowWriteBufferLowWatermark() override;
 
 private:
   /**
@@ -404,6 +492,13 @@ private:
    */
   void onComplete();
 
+  /**
+   * Writes the next chunk of a streamed response, unless the downstream is above its high
+   * watermark, and schedules the following one.
+   */
+  void streamNextChunk();
+  void stopStreaming();
+
   AdminImpl& parent_;
   // Handlers relying on the reference should use addOnDestroyCallback()
   // to add a callback that will notify them when the reference is no
@@ -412,6 +507,11 @@ private:
   Http::HeaderMap* request_headers_{};
   std::list<std::function<void()>> on_destroy_callbacks_;
   bool end_stream_on_complete_ = true;
+  // Whether the response may be streamed, i.e. the request is served over a connection.
+  bool can_stream_response_{};
+  ChunkCallback next_chunk_;
+  Event::TimerPtr next_chunk_timer_;
+  uint32_t high_watermark_count_{};
 };
 
 /**
@@ -431,6 +531,20 @@ public:
                                     const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
                                     Buffer::Instance& response, const bool used_only,
                                     const absl::optional<std::regex>& regex);
+  /**
+   * Format a single counter, gauge or histogram, adding the type of its metric the first time
+   * the metric is seen.
+   * @param metric_type_tracker supplies the metrics whose type has been added to the response.
+   */
+  static void formatCounter(const Stats::Counter& counter,
+                            std::unordered_set<std::string>& metric_type_tracker,
+                            Buffer::Instance& response);
+  static void formatGauge(const Stats::Gauge& gauge,
+                          std::unordered_set<std::string>& metric_type_tracker,
+                          Buffer::Instance& response);
+  static void formatHistogram(const Stats::ParentHistogram& histogram,
+                              std::unordered_set<std::string>& metric_type_tracker,
+                              Buffer::Instance& response);
   /**
    * Format the given tags, returning a string as a comma-separated list
    * of <tag_name>="<tag_value>" pairs.
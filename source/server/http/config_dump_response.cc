@@ -0,0 +1,288 @@
+#include "server/http/config_dump_response.h"
+
+#include "common/common/assert.h"
+#include "common/common/empty_string.h"
+#include "common/common/fmt.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+
+namespace Envoy {
+namespace Server {
+
+namespace {
+
+// The field number of the configs of a ConfigDump.
+constexpr uint32_t ConfigsFieldNumber = 1;
+
+void appendVarint(std::string& output, uint64_t value) {
+  while (value >= 0x80) {
+    output.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  output.push_back(static_cast<char>(value));
+}
+
+uint32_t lengthDelimitedTag(uint32_t field_number) { return (field_number << 3) | 2; }
+
+// Adds a length delimited field to a serialized proto.
+void addProtoField(Buffer::Instance& response, uint32_t field_number, const std::string& value) {
+  std::string header;
+  appendVarint(header, lengthDelimitedTag(field_number));
+  appendVarint(header, value.size());
+  response.add(header);
+  response.add(value);
+}
+
+// Indents each line of pretty printed JSON, dropping its trailing new line.
+std::string indentJson(const std::string& json, uint32_t indent) {
+  const std::string prefix(indent, ' ');
+  return prefix + absl::StrJoin(absl::StrSplit(json, '\n', absl::SkipEmpty()), "\n" + prefix);
+}
+
+// Returns the value of the name field of a message, if it has one.
+absl::optional<std::string> nameField(const Protobuf::Message& message) {
+  const Protobuf::FieldDescriptor* field = message.GetDescriptor()->FindFieldByName("name");
+  if (field == nullptr || field->is_repeated() ||
+      field->cpp_type() != Protobuf::FieldDescriptor::CPPTYPE_STRING) {
+    return absl::nullopt;
+  }
+  return message.GetReflection()->GetString(message, field);
+}
+
+std::string resourceName(const Protobuf::Message& resource) {
+  const absl::optional<std::string> name = nameField(resource);
+  if (name.has_value()) {
+    return name.value();
+  }
+  const Protobuf::Reflection* reflection = resource.GetReflection();
+  std::vector<const Protobuf::FieldDescriptor*> fields;
+  reflection->ListFields(resource, &fields);
+  for (const Protobuf::FieldDescriptor* field : fields) {
+    if (!field->is_repeated() && field->cpp_type() == Protobuf::FieldDescriptor::CPPTYPE_MESSAGE) {
+      const absl::optional<std::string> name = nameField(reflection->GetMessage(resource, field));
+      if (name.has_value()) {
+        return name.value();
+      }
+    }
+  }
+  return EMPTY_STRING;
+}
+
+} // namespace
+
+constexpr uint64_t ConfigDumpResponse::ChunkSize;
+
+ConfigDumpResponse::ConfigDumpResponse(const ConfigTracker& config_tracker, Format format,
+                                       const std::string& resource,
+                                       const absl::optional<std::regex>& name_regex)
+    : config_tracker_(config_tracker), format_(format), resource_(resource),
+      name_regex_(name_regex) {
+  for (const auto& key_callback_pair : config_tracker_.getCallbacksMap()) {
+    keys_.push_back(key_callback_pair.first);
+  }
+}
+
+bool ConfigDumpResponse::nextChunk(Buffer::Instance& response) {
+  const uint64_t start = response.length();
+  while (response.length() - start < ChunkSize) {
+    if (config_ == nullptr && !startNextConfig()) {
+      if (format_ == Format::Json) {
+        response.add(configs_added_ == 0 ? "{}\n" : "\n ]\n}\n");
+      }
+      return false;
+    }
+    if (!addNextPiece(response)) {
+      config_.reset();
+      resources_.reset();
+      fields_.clear();
+    }
+  }
+  return true;
+}
+
+bool ConfigDumpResponse::startNextConfig() {
+  while (next_key_ < keys_.size()) {
+    const ConfigTracker::CbsMap& callbacks = config_tracker_.getCallbacksMap();
+    const auto it = callbacks.find(keys_[next_key_++]);
+    if (it == callbacks.end()) {
+      continue;
+    }
+    config_ = it->second();
+    RELEASE_ASSERT(config_, "");
+
+    // The well-known types have a JSON representation of their own, so they are dumped whole.
+    const Protobuf::Descriptor* descriptor = config_->GetDescriptor();
+    std::vector<const Protobuf::FieldDescriptor*> resource_fields;
+    if (descriptor->file()->package() != "google.protobuf") {
+      for (int i = 0; i < descriptor->field_count(); i++) {
+        const Protobuf::FieldDescriptor* field = descriptor->field(i);
+        if (field->is_repeated() && !field->is_map() &&
+            field->cpp_type() == Protobuf::FieldDescriptor::CPPTYPE_MESSAGE &&
+            (resource_.empty() || field->name() == resource_)) {
+          resource_fields.push_back(field);
+        }
+      }
+    }
+    if (!resource_.empty() && resource_fields.empty()) {
+      config_.reset();
+      continue;
+    }
+
+    resources_.reset(config_->New());
+    const Protobuf::Reflection* reflection = config_->GetReflection();
+    reflection->SwapFields(config_.get(), resources_.get(), resource_fields);
+    for (const Protobuf::FieldDescriptor* field : resource_fields) {
+      std::vector<int> shown;
+      for (int i = 0; i < reflection->FieldSize(*resources_, field); i++) {
+        if (shouldShow(reflection->GetRepeatedMessage(*resources_, field, i))) {
+          shown.push_back(i);
+        }
+      }
+      if (!shown.empty()) {
+        fields_.emplace_back(field, std::move(shown));
+      }
+    }
+    header_added_ = false;
+    next_field_ = 0;
+    next_resource_ = 0;
+    return true;
+  }
+  return false;
+}
+
+bool ConfigDumpResponse::addNextPiece(Buffer::Instance& response) {
+  if (resource_.empty() && !header_added_) {
+    header_added_ = true;
+    if (fields_.empty()) {
+      addWholeConfig(response, *config_);
+      return false;
+    }
+    startConfig(response);
+    if (format_ == Format::Json) {
+      addJsonRemainder(response);
+    } else {
+      addProtoHeader(response);
+    }
+    return true;
+  }
+
+  if (next_field_ == fields_.size()) {
+    if (resource_.empty() && format_ == Format::Json) {
+      response.add("\n  }");
+    }
+    return false;
+  }
+
+  const auto& field = fields_[next_field_];
+  const Protobuf::Message& resource = config_->GetReflection()->GetRepeatedMessage(
+      *resources_, field.first, field.second[next_resource_]);
+  const bool last = next_resource_ + 1 == field.second.size();
+  if (!resource_.empty()) {
+    // Each resource is a config of its own.
+    addWholeConfig(response, resource);
+  } else if (format_ == Format::Json) {
+    response.add(next_resource_ == 0 ? fmt::format(",\n   \"{}\": [\n", field.first->name())
+                                     : ",\n");
+    addJsonResource(response, resource);
+    if (last) {
+      response.add("\n   ]");
+    }
+  } else {
+    addProtoResource(response, resource);
+  }
+
+  if (last) {
+    next_field_++;
+    next_resource_ = 0;
+  } else {
+    next_resource_++;
+  }
+  return true;
+}
+
+bool ConfigDumpResponse::shouldShow(const Protobuf::Message& resource) const {
+  if (!name_regex_.has_value()) {
+    return true;
+  }
+  const std::string name = resourceName(resource);
+  return name.empty() || std::regex_search(name, name_regex_.value());
+}
+
+void ConfigDumpResponse::startConfig(Buffer::Instance& response) {
+  if (format_ == Format::Json) {
+    response.add(configs_added_ == 0 ? "{\n \"configs\": [\n" : ",\n");
+  }
+  configs_added_++;
+}
+
+void ConfigDumpResponse::addWholeConfig(Buffer::Instance& response,
+                                        const Protobuf::Message& config) {
+  ProtobufWkt::Any any;
+  any.PackFrom(config);
+  startConfig(response);
+  if (format_ == Format::Json) {
+    response.add(indentJson(MessageUtil::getJsonStringFromMessage(any, true), 2));
+  } else {
+    addProtoField(response, ConfigsFieldNumber, any.SerializeAsString());
+  }
+}
+
+void ConfigDumpResponse::addJsonRemainder(Buffer::Instance& response) {
+  response.add(fmt::format("  {{\n   \"@type\": \"type.googleapis.com/{}\"",
+                           config_->GetDescriptor()->full_name()));
+  // The fields left once the resources are swapped out, less the braces around them.
+  const std::string json = MessageUtil::getJsonStringFromMessage(*config_, true);
+  const size_t begin = json.find('\n');
+  const size_t end = json.rfind('}');
+  if (begin != std::string::npos && end > begin + 1) {
+    response.add(",\n");
+    response.add(indentJson(json.substr(begin + 1, end - begin - 1), 2));
+  }
+}
+
+void ConfigDumpResponse::addJsonResource(Buffer::Instance& response,
+                                         const Protobuf::Message& resource) {
+  response.add(indentJson(MessageUtil::getJsonStringFromMessage(resource, true), 4));
+}
+
+void ConfigDumpResponse::addProtoHeader(Buffer::Instance& response) {
+  // The Any is written field by field, so its value is sized up front: the config less its
+  // resources, followed by each resource as an element of its repeated field.
+  const std::string type_url = "type.googleapis.com/" + config_->GetDescriptor()->full_name();
+  const Protobuf::Reflection* reflection = config_->GetReflection();
+  uint64_t value_size = config_->ByteSizeLong();
+  for (const auto& field : fields_) {
+    const uint32_t tag_size =
+        Protobuf::io::CodedOutputStream::VarintSize32(lengthDelimitedTag(field.first->number()));
+    for (const int index : field.second) {
+      const uint64_t size =
+          reflection->GetRepeatedMessage(*resources_, field.first, index).ByteSizeLong();
+      value_size += tag_size + Protobuf::io::CodedOutputStream::VarintSize64(size) + size;
+    }
+  }
+  const uint64_t any_size = 1 + Protobuf::io::CodedOutputStream::VarintSize64(type_url.size()) +
+                            type_url.size() + 1 +
+                            Protobuf::io::CodedOutputStream::VarintSize64(value_size) + value_size;
+
+  std::string header;
+  appendVarint(header, lengthDelimitedTag(ConfigsFieldNumber));
+  appendVarint(header, any_size);
+  // The type_url and value fields of the Any.
+  appendVarint(header, lengthDelimitedTag(1));
+  appendVarint(header, type_url.size());
+  header.append(type_url);
+  appendVarint(header, lengthDelimitedTag(2));
+  appendVarint(header, value_size);
+  response.add(header);
+  response.add(config_->SerializeAsString());
+}
+
+void ConfigDumpResponse::addProtoResource(Buffer::Instance& response,
+                                          const Protobuf::Message& resource) {
+  addProtoField(response, fields_[next_field_].first->number(), resource.SerializeAsString());
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/server/config_tracker.h"
+
+#include "common/protobuf/protobuf.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * The body of a /config_dump response, a ConfigDump message formatted chunk by chunk so that it
+ * can be streamed, @see AdminStream::streamResponse(). Each config is produced by its ConfigTracker
+ * callback once the response reaches it, and its resources, the elements of its repeated message
+ * fields such as the dynamic_active_clusters of a ClustersConfigDump, are serialized one at a time,
+ * so that neither the whole dump nor its serialization is held in memory.
+ */
+class ConfigDumpResponse {
+public:
+  enum class Format { Json, Proto };
+
+  // A chunk is complete once it holds at least this many bytes.
+  static constexpr uint64_t ChunkSize = 64 * 1024;
+
+  /**
+   * @param config_tracker supplies the callbacks of the configs, which must outlive the response.
+   * @param format supplies the format of the response, pretty printed JSON or a binary proto.
+   * @param resource supplies the name of a repeated field, such as dynamic_active_clusters, to dump
+   *        each of its resources as a config of their own, or empty to dump the whole configs.
+   * @param name_regex supplies the regex the names of the resources dumped must match, if any. The
+   *        name of a resource is its name field, or that of its first message field having one,
+   *        such as the cluster of a DynamicCluster. The resources without a name are dumped.
+   */
+  ConfigDumpResponse(const ConfigTracker& config_tracker, Format format,
+                     const std::string& resource, const absl::optional<std::regex>& name_regex);
+
+  /**
+   * Adds the next chunk of the response.
+   * @param response supplies the buffer to add the chunk to.
+   * @return whether more chunks follow.
+   */
+  bool nextChunk(Buffer::Instance& response);
+
+private:
+  // Produces the next config and starts dumping it, returning false once there are none left.
+  bool startNextConfig();
+  // Adds the next piece of the current config, returning false once it is complete.
+  bool addNextPiece(Buffer::Instance& response);
+  bool shouldShow(const Protobuf::Message& resource) const;
+  // Adds the separator and the header of a config, or of the whole response before the first one.
+  void startConfig(Buffer::Instance& response);
+  void addWholeConfig(Buffer::Instance& response, const Protobuf::Message& config);
+  void addJsonRemainder(Buffer::Instance& response);
+  void addJsonResource(Buffer::Instance& response, const Protobuf::Message& resource);
+  void addProtoHeader(Buffer::Instance& response);
+  void addProtoResource(Buffer::Instance& response, const Protobuf::Message& resource);
+
+  const ConfigTracker& config_tracker_;
+  const Format format_;
+  const std::string resource_;
+  const absl::optional<std::regex> name_regex_;
+  // The keys of the configs, snapshotted when the response is created. A config removed before the
+  // response reaches it is skipped.
+  std::vector<std::string> keys_;
+  size_t next_key_{};
+  uint64_t configs_added_{};
+
+  // The current config, without the resource fields, which are swapped into resources_.
+  ProtobufTypes::MessagePtr config_;
+  ProtobufTypes::MessagePtr resources_;
+  // The resource fields of the current config, and the indexes of the resources shown of each.
+  std::vector<std::pair<const Protobuf::FieldDescriptor*, std::vector<int>>> fields_;
+  bool header_added_{};
+  size_t next_field_{};
+  size_t next_resource_{};
+};
+
+} // namespace Server
+} // namespace Envoy
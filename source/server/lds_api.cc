@@ -17,10 +17,10 @@ namespace Server {
 LdsApiImpl::LdsApiImpl(const envoy::api::v2::core::ConfigSource& lds_config,
                        Upstream::ClusterManager& cm, Init::Manager& init_manager,
                        Stats::Scope& scope, ListenerManager& lm,
-                       ProtobufMessage::ValidationVisitor& validation_visitor)
+                       ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api)
     : listener_manager_(lm), scope_(scope.createScope("listener_manager.lds.")), cm_(cm),
       init_target_("LDS", [this]() { subscription_->start({}); }),
-      validation_visitor_(validation_visitor) {
+      validation_visitor_(validation_visitor), decoder_(api, scope, "control_plane.lds.") {
   subscription_ = cm.subscriptionFactory().subscriptionFromConfigSource(
       lds_config, Grpc::Common::typeUrl(envoy::api::v2::Listener().GetDescriptor()->full_name()),
       *scope_, *this);
@@ -31,6 +31,55 @@ void LdsApiImpl::onConfigUpdate(
     const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>& added_resources,
     const Protobuf::RepeatedPtrField<std::string>& removed_resources,
     const std::string& system_version_info) {
+  applyConfigUpdate(
+      decoder_.decode<envoy::api::v2::Listener>(
+          added_resources.size(),
+          [&added_resources](size_t i) -> const ProtobufWkt::Any& {
+            return added_resources[i].resource();
+          },
+          validation_visitor_),
+      [&added_resources](size_t i) -> const std::string& { return added_resources[i].version(); },
+      removed_resources, system_version_info);
+}
+
+void LdsApiImpl::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
+                                const std::string& version_info) {
+  const std::vector<Config::DecodedResource<envoy::api::v2::Listener>> listeners =
+      decoder_.decode<envoy::api::v2::Listener>(
+          resources.size(),
+          [&resources](size_t i) -> const ProtobufWkt::Any& { return resources[i]; },
+          validation_visitor_);
+
+  // We need to keep track of which listeners need to remove.
+  // Specifically, it's [listeners we currently have] - [listeners found in the response].
+  std::unordered_set<std::string> listeners_to_remove;
+  for (const auto& listener : listener_manager_.listeners()) {
+    listeners_to_remove.insert(listener.get().name());
+  }
+  for (const auto& listener : listeners) {
+    // Without its name, the listeners to remove are unknown, so the whole update is rejected.
+    if (!listener.unpacked_) {
+      std::rethrow_exception(listener.error_);
+    }
+    listeners_to_remove.erase(listener.resource_.name());
+  }
+
+  // Copy our delta removed pile into the desired format.
+  Protobuf::RepeatedPtrField<std::string> to_remove_repeated;
+  for (const auto& listener : listeners_to_remove) {
+    *to_remove_repeated.Add() = listener;
+  }
+  applyConfigUpdate(
+      listeners, [&version_info](size_t) -> const std::string& { return version_info; },
+      to_remove_repeated, version_info);
+}
+
+void LdsApiImpl::applyConfigUpdate(
+    const std::vector<Config::DecodedResource<envoy::api::v2::Listener>>& listeners,
+    const std::function<const std::string&(size_t)>& version,
+    const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+    const std::string& system_version_info) {
+  const MonotonicTime start = decoder_.timeSource().monotonicTime();
   cm_.adsMux().pause(Config::TypeUrl::get().RouteConfiguration);
   Cleanup rds_resume([this] { cm_.adsMux().resume(Config::TypeUrl::get().RouteConfiguration); });
 
@@ -46,17 +95,17 @@ void LdsApiImpl::onConfigUpdate(
 
   std::vector<std::string> exception_msgs;
   std::unordered_set<std::string> listener_names;
-  for (const auto& resource : added_resources) {
-    envoy::api::v2::Listener listener;
+  for (size_t i = 0; i < listeners.size(); i++) {
+    const envoy::api::v2::Listener& listener = listeners[i].resource_;
     try {
-      listener = MessageUtil::anyConvert<envoy::api::v2::Listener>(resource.resource(),
-                                                                   validation_visitor_);
-      MessageUtil::validate(listener);
+      if (listeners[i].error_ != nullptr) {
+        std::rethrow_exception(listeners[i].error_);
+      }
       if (!listener_names.insert(listener.name()).second) {
         // NOTE: at this point, the first of these duplicates has already been successfully applied.
         throw EnvoyException(fmt::format("duplicate listener {} found", listener.name()));
       }
-      if (listener_manager_.addOrUpdateListener(listener, resource.version(), true)) {
+      if (listener_manager_.addOrUpdateListener(listener, version(i), true)) {
         ENVOY_LOG(info, "lds: add/update listener '{}'", listener.name());
         any_applied = true;
       } else {
@@ -70,6 +119,7 @@ void LdsApiImpl::onConfigUpdate(
   if (any_applied) {
     system_version_info_ = system_version_info;
   }
+  decoder_.recordApplyDuration(start);
   init_target_.ready();
   if (!exception_msgs.empty()) {
     throw EnvoyException(fmt::format("Error adding/updating listener(s) {}",
@@ -77,37 +127,6 @@ void LdsApiImpl::onConfigUpdate(
   }
 }
 
-void LdsApiImpl::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
-                                const std::string& version_info) {
-  // We need to keep track of which listeners need to remove.
-  // Specifically, it's [listeners we currently have] - [listeners found in the response].
-  std::unordered_set<std::string> listeners_to_remove;
-  for (const auto& listener : listener_manager_.listeners()) {
-    listeners_to_remove.insert(listener.get().name());
-  }
-
-  Protobuf::RepeatedPtrField<envoy::api::v2::Resource> to_add_repeated;
-  for (const auto& listener_blob : resources) {
-    // Add this resource to our delta added/updated pile...
-    envoy::api::v2::Resource* to_add = to_add_repeated.Add();
-    const std::string listener_name =
-        MessageUtil::anyConvert<envoy::api::v2::Listener>(listener_blob, validation_visitor_)
-            .name();
-    to_add->set_name(listener_name);
-    to_add->set_version(version_info);
-    to_add->mutable_resource()->MergeFrom(listener_blob);
-    // ...and remove its name from our delta removed pile.
-    listeners_to_remove.erase(listener_name);
-  }
-
-  // Copy our delta removed pile into the desired format.
-  Protobuf::RepeatedPtrField<std::string> to_remove_repeated;
-  for (const auto& listener : listeners_to_remove) {
-    *to_remove_repeated.Add() = listener;
-  }
-  onConfigUpdate(to_add_repeated, to_remove_repeated, version_info);
-}
-
 void LdsApiImpl::onConfigUpdateFailed(Envoy::Config::ConfigUpdateFailureReason,
                                       const EnvoyException*) {
   // We need to allow server startup to continue, even if we have a bad
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <functional>
+#include <string>
+#include <vector>
 
+#include "envoy/api/api.h"
 #include "envoy/api/v2/lds.pb.h"
 #include "envoy/config/subscription.h"
 #include "envoy/config/subscription_factory.h"
@@ -10,6 +13,7 @@
 #include "envoy/stats/scope.h"
 
 #include "common/common/logger.h"
+#include "common/config/resource_decoder.h"
 #include "common/init/target_impl.h"
 
 namespace Envoy {
@@ -24,7 +28,7 @@ class LdsApiImpl : public LdsApi,
 public:
   LdsApiImpl(const envoy::api::v2::core::ConfigSource& lds_config, Upstream::ClusterManager& cm,
              Init::Manager& init_manager, Stats::Scope& scope, ListenerManager& lm,
-             ProtobufMessage::ValidationVisitor& validation_visitor);
+             ProtobufMessage::ValidationVisitor& validation_visitor, Api::Api& api);
 
   // Server::LdsApi
   std::string versionInfo() const override { return system_version_info_; }
@@ -42,6 +46,14 @@ private:
     return MessageUtil::anyConvert<envoy::api::v2::Listener>(resource, validation_visitor_).name();
   }
 
+  // Removes removed_resources, then applies the decoded listeners in order. version supplies the
+  // version of the listener at an index.
+  void applyConfigUpdate(
+      const std::vector<Config::DecodedResource<envoy::api::v2::Listener>>& listeners,
+      const std::function<const std::string&(size_t)>& version,
+      const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+      const std::string& system_version_info);
+
   std::unique_ptr<Config::Subscription> subscription_;
   std::string system_version_info_;
   ListenerManager& listener_manager_;
@@ -49,6 +61,7 @@ private:
   Upstream::ClusterManager& cm_;
   Init::TargetImpl init_target_;
   ProtobufMessage::ValidationVisitor& validation_visitor_;
+  Config::ResourceDecoder decoder_;
 };
 
 } // namespace Server
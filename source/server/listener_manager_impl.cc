@@ -11,7 +11,11 @@
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
+#include "common/common/hash.h"
+#include "common/common/lock_guard.h"
+#include "common/common/thread.h"
 #include "common/config/utility.h"
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/io_socket_handle_impl.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/network/resolver_impl.h"
@@ -29,6 +33,7 @@
 
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 
 namespace Envoy {
 namespace Server {
@@ -135,6 +140,19 @@ ProdListenerComponentFactory::createUdpListenerFilterFactoryList_(
 Network::SocketSharedPtr ProdListenerComponentFactory::createListenSocket(
     Network::Address::InstanceConstSharedPtr address, Network::Address::SocketType socket_type,
     const Network::Socket::OptionsSharedPtr& options, bool bind_to_port) {
+  return createListenSocketForWorker(address, socket_type, options, bind_to_port, 0);
+}
+
+Network::SocketSharedPtr ProdListenerComponentFactory::createReusePortListenSocket(
+    Network::Address::InstanceConstSharedPtr address, Network::Address::SocketType socket_type,
+    const Network::Socket::OptionsSharedPtr& options, uint32_t worker_index) {
+  ASSERT(address->type() == Network::Address::Type::Ip);
+  return createListenSocketForWorker(address, socket_type, options, true, worker_index);
+}
+
+Network::SocketSharedPtr ProdListenerComponentFactory::createListenSocketForWorker(
+    Network::Address::InstanceConstSharedPtr address, Network::Address::SocketType socket_type,
+    const Network::Socket::OptionsSharedPtr& options, bool bind_to_port, uint32_t worker_index) {
   ASSERT(address->type() == Network::Address::Type::Ip ||
          address->type() == Network::Address::Type::Pipe);
   ASSERT(socket_type == Network::Address::SocketType::Stream ||
@@ -151,7 +169,7 @@ Network::SocketSharedPtr ProdListenerComponentFactory::createListenSocket(
           fmt::format("socket type {} not supported for pipes", toString(socket_type)));
     }
     const std::string addr = fmt::format("unix://{}", address->asString());
-    const int fd = server_.hotRestart().duplicateParentListenSocket(addr);
+    const int fd = server_.hotRestart().duplicateParentListenSocket(addr, worker_index);
     Network::IoHandlePtr io_handle = std::make_unique<Network::IoSocketHandleImpl>(fd);
     if (io_handle->isOpen()) {
       ENVOY_LOG(debug, "obtained socket for address {} from parent", addr);
@@ -164,7 +182,7 @@ Network::SocketSharedPtr ProdListenerComponentFactory::createListenSocket(
                                  ? Network::Utility::TCP_SCHEME
                                  : Network::Utility::UDP_SCHEME;
   const std::string addr = absl::StrCat(scheme, address->asString());
-  const int fd = server_.hotRestart().duplicateParentListenSocket(addr);
+  const int fd = server_.hotRestart().duplicateParentListenSocket(addr, worker_index);
   if (fd != -1) {
     ENVOY_LOG(debug, "obtained socket for address {} from parent", addr);
     Network::IoHandlePtr io_handle = std::make_unique<Network::IoSocketHandleImpl>(fd);
@@ -189,18 +207,26 @@ ProdListenerComponentFactory::createDrainManager(envoy::api::v2::Listener::Drain
 ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::string& version_info,
                            ListenerManagerImpl& parent, const std::string& name, bool added_via_api,
                            bool workers_started, uint64_t hash,
-                           ProtobufMessage::ValidationVisitor& validation_visitor)
+                           ProtobufMessage::ValidationVisitor& validation_visitor,
+                           const ListenerImpl* previous)
     : parent_(parent), address_(Network::Address::resolveProtoAddress(config.address())),
       filter_chain_manager_(address_),
       socket_type_(Network::Utility::protobufAddressSocketType(config.address())),
       global_scope_(parent_.server_.stats().createScope("")),
-      listener_scope_(
-          parent_.server_.stats().createScope(fmt::format("listener.{}.", address_->asString()))),
+      listener_scope_(previous != nullptr && *previous->address_ == *address_
+                          ? previous->listener_scope_
+                          : Stats::ScopeSharedPtr(parent_.server_.stats().createScope(
+                                fmt::format("listener.{}.", address_->asString())))),
       bind_to_port_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.deprecated_v1(), bind_to_port, true)),
       hand_off_restored_destination_connections_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, use_original_dst, false)),
       per_connection_buffer_limit_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, per_connection_buffer_limit_bytes, 1024 * 1024)),
+      per_connection_read_budget_bytes_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, per_connection_read_budget_bytes, 0)),
+      reuse_port_(config.has_reuse_port()),
+      reuse_port_cpu_steering_(config.reuse_port().steering() ==
+                               envoy::api::v2::Listener::ReusePort::CPU),
       listener_tag_(parent_.factory_.nextListenerTag()), name_(name), added_via_api_(added_via_api),
       workers_started_(workers_started), hash_(hash), validation_visitor_(validation_visitor),
       dynamic_init_manager_(fmt::format("Listener {}", name)),
@@ -211,6 +237,13 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
       listener_filters_timeout_(
           PROTOBUF_GET_MS_OR_DEFAULT(config, listener_filters_timeout, 15000)),
       continue_on_listener_filters_timeout_(config.continue_on_listener_filters_timeout()) {
+  if (config.has_connection_balance_config()) {
+    // Exact balance is the only supported type today.
+    ASSERT(config.connection_balance_config().has_exact_balance());
+    connection_balancer_ = std::make_unique<Network::ExactConnectionBalancerImpl>();
+  } else {
+    connection_balancer_ = std::make_unique<Network::NopConnectionBalancerImpl>();
+  }
   if (config.has_transparent()) {
     addListenSocketOptions(Network::SocketOptionFactory::buildIpTransparentOptions());
   }
@@ -221,6 +254,14 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
     addListenSocketOptions(
         Network::SocketOptionFactory::buildLiteralOptions(config.socket_options()));
   }
+  if (reuse_port_) {
+    if (!bind_to_port_ || address_->type() != Network::Address::Type::Ip) {
+      throw EnvoyException(
+          fmt::format("error adding listener '{}': reuse_port requires a bound IP address",
+                      address_->asString()));
+    }
+    addListenSocketOptions(Network::SocketOptionFactory::buildReusePortOptions());
+  }
   if (socket_type_ == Network::Address::SocketType::Datagram) {
     // Needed for recvmsg to return destination address in IP header.
     addListenSocketOptions(Network::SocketOptionFactory::buildIpPacketInfoOptions());
@@ -287,7 +328,11 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
       parent_.server_.random(), parent_.server_.stats(), parent_.server_.singletonManager(),
       parent_.server_.threadLocal(), validation_visitor, parent_.server_.api());
   factory_context.setInitManager(initManager());
-  ListenerFilterChainFactoryBuilder builder(*this, factory_context);
+  factory_context.setOverloadManager(parent_.server_.overloadManager());
+  // Updates with another address fail, so there is nothing to reuse.
+  ListenerFilterChainFactoryBuilder builder(
+      *this, factory_context,
+      previous != nullptr && *previous->address_ == *address_ ? previous : nullptr);
   filter_chain_manager_.addFilterChain(config.filter_chains(), builder);
   const bool need_tls_inspector =
       std::any_of(
@@ -404,9 +449,40 @@ void ListenerImpl::setSocket(const Network::SocketSharedPtr& socket) {
   ASSERT(!socket_);
   socket_ = socket;
   // Server config validation sets nullptr sockets.
-  if (socket_ && listen_socket_options_) {
+  if (socket_) {
+    applyListenSocketOptions(*socket_);
+  }
+}
+
+void ListenerImpl::setWorkerSockets(const std::vector<Network::SocketSharedPtr>& sockets) {
+  ASSERT(reuse_port_ && !sockets.empty() && worker_sockets_.empty());
+  setSocket(sockets[0]);
+  // Server config validation sets nullptr sockets.
+  if (!socket_) {
+    return;
+  }
+  for (size_t i = 1; i < sockets.size(); i++) {
+    applyListenSocketOptions(*sockets[i]);
+  }
+  worker_sockets_ = sockets;
+  if (reuse_port_cpu_steering_) {
+    Network::Utility::steerReusePortByCpu(worker_sockets_);
+  }
+}
+
+void ListenerImpl::shareSockets(const ListenerImpl& listener) {
+  ASSERT(reuse_port_ == listener.reuse_port_);
+  if (listener.worker_sockets_.empty()) {
+    setSocket(listener.socket_);
+  } else {
+    setWorkerSockets(listener.worker_sockets_);
+  }
+}
+
+void ListenerImpl::applyListenSocketOptions(Network::Socket& socket) {
+  if (listen_socket_options_) {
     // 'pre_bind = false' as bind() is never done after this.
-    bool ok = Network::Socket::applyOptions(listen_socket_options_, *socket_,
+    bool ok = Network::Socket::applyOptions(listen_socket_options_, socket,
                                             envoy::api::v2::core::SocketOption::STATE_BOUND);
     const std::string message =
         fmt::format("{}: Setting socket options {}", name_, ok ? "succeeded" : "failed");
@@ -417,9 +493,9 @@ void ListenerImpl::setSocket(const Network::SocketSharedPtr& socket) {
       ENVOY_LOG(debug, "{}", message);
     }
 
-    // Add the options to the socket_ so that STATE_LISTENING options can be
+    // Add the options to the socket so that STATE_LISTENING options can be
     // set in the worker after listen()/evconnlistener_new() is called.
-    socket_->addOptions(listen_socket_options_);
+    socket.addOptions(listen_socket_options_);
   }
 }
 
@@ -433,7 +509,7 @@ ListenerManagerImpl::ListenerManagerImpl(Instance& server,
           "listeners", [this] { return dumpListenerConfigs(); })),
       enable_dispatcher_stats_(enable_dispatcher_stats) {
   for (uint32_t i = 0; i < server.options().concurrency(); i++) {
-    workers_.emplace_back(worker_factory.createWorker(server.overloadManager()));
+    workers_.emplace_back(worker_factory.createWorker(server.overloadManager(), i));
   }
 }
 
@@ -511,10 +587,14 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
     return false;
   }
 
+  // Only the transport socket factories of the active listener are reused, as those of a warming
+  // listener may still be waiting for their secrets.
   ListenerImplPtr new_listener(new ListenerImpl(
       config, version_info, *this, name, added_via_api, workers_started_, hash,
       added_via_api ? server_.messageValidationContext().dynamicValidationVisitor()
-                    : server_.messageValidationContext().staticValidationVisitor()));
+                    : server_.messageValidationContext().staticValidationVisitor(),
+      existing_active_listener != active_listeners_.end() ? existing_active_listener->get()
+                                                          : nullptr));
   ListenerImpl& new_listener_ref = *new_listener;
 
   // We mandate that a listener with the same name must have the same configured address. This
@@ -532,17 +612,28 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
     throw EnvoyException(message);
   }
 
+  // The sockets are shared with the existing listener, so they must be of the same kind.
+  if ((existing_warming_listener != warming_listeners_.end() &&
+       !(*existing_warming_listener)->sameReusePort(*new_listener)) ||
+      (existing_active_listener != active_listeners_.end() &&
+       !(*existing_active_listener)->sameReusePort(*new_listener))) {
+    const std::string message = fmt::format(
+        "error updating listener: '{}' has a different reuse_port from existing listener", name);
+    ENVOY_LOG(warn, "{}", message);
+    throw EnvoyException(message);
+  }
+
   bool added = false;
   if (existing_warming_listener != warming_listeners_.end()) {
     // In this case we can just replace inline.
     ASSERT(workers_started_);
     new_listener->debugLog("update warming listener");
-    new_listener->setSocket((*existing_warming_listener)->getSocket());
+    new_listener->shareSockets(**existing_warming_listener);
     *existing_warming_listener = std::move(new_listener);
   } else if (existing_active_listener != active_listeners_.end()) {
     // In this case we have no warming listener, so what we do depends on whether workers
     // have been started or not. Either way we get the socket from the existing listener.
-    new_listener->setSocket((*existing_active_listener)->getSocket());
+    new_listener->shareSockets(**existing_active_listener);
     if (workers_started_) {
       new_listener->debugLog("add warming listener");
       warming_listeners_.emplace_back(std::move(new_listener));
@@ -571,22 +662,27 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
     // to see if there is a listener that has a socket bound to the address we are configured for.
     // This is an edge case, but may happen if a listener is removed and then added back with a same
     // or different name and intended to listen on the same address. This should work and not fail.
-    Network::SocketSharedPtr draining_listener_socket;
     auto existing_draining_listener = std::find_if(
         draining_listeners_.cbegin(), draining_listeners_.cend(),
         [&new_listener](const DrainingListener& listener) {
           return *new_listener->address() == *listener.listener_->socket().localAddress();
         });
     if (existing_draining_listener != draining_listeners_.cend()) {
-      draining_listener_socket = existing_draining_listener->listener_->getSocket();
+      if (!existing_draining_listener->listener_->sameReusePort(*new_listener)) {
+        const std::string message = fmt::format(
+            "error adding listener: '{}' has a different reuse_port from draining listener '{}'",
+            name, existing_draining_listener->listener_->name());
+        ENVOY_LOG(warn, "{}", message);
+        throw EnvoyException(message);
+      }
+      new_listener->shareSockets(*existing_draining_listener->listener_);
+    } else if (new_listener->reusePort()) {
+      createWorkerSockets(*new_listener);
+    } else {
+      new_listener->setSocket(factory_.createListenSocket(
+          new_listener->address(), new_listener->socketType(), new_listener->listenSocketOptions(),
+          new_listener->bindToPort()));
     }
-
-    new_listener->setSocket(draining_listener_socket
-                                ? draining_listener_socket
-                                : factory_.createListenSocket(new_listener->address(),
-                                                              new_listener->socketType(),
-                                                              new_listener->listenSocketOptions(),
-                                                              new_listener->bindToPort()));
     if (workers_started_) {
       new_listener->debugLog("add warming listener");
       warming_listeners_.emplace_back(std::move(new_listener));
@@ -604,6 +700,7 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
   } else {
     stats_.listener_modified_.inc();
   }
+  stats_.transport_socket_factory_reused_.add(new_listener_ref.reusedTransportSocketFactories());
 
   new_listener_ref.initialize();
   return true;
@@ -708,6 +805,20 @@ void ListenerManagerImpl::addListenerToWorker(Worker& worker, ListenerImpl& list
   });
 }
 
+void ListenerManagerImpl::createWorkerSockets(ListenerImpl& listener) {
+  std::vector<Network::SocketSharedPtr> sockets;
+  // The first socket resolves a port of 0, and the other workers bind to the port it got.
+  Network::Address::InstanceConstSharedPtr address = listener.address();
+  for (uint32_t i = 0; i < workers_.size(); i++) {
+    sockets.push_back(factory_.createReusePortListenSocket(address, listener.socketType(),
+                                                           listener.listenSocketOptions(), i));
+    if (i == 0 && sockets[0] != nullptr) {
+      address = sockets[0]->localAddress();
+    }
+  }
+  listener.setWorkerSockets(sockets);
+}
+
 void ListenerManagerImpl::onListenerWarmed(ListenerImpl& listener) {
   // The warmed listener should be added first so that the worker will accept new connections
   // when it stops listening on the old listener.
@@ -738,6 +849,63 @@ uint64_t ListenerManagerImpl::numConnections() {
   return num_connections;
 }
 
+std::vector<Network::BufferedConnection>
+ListenerManagerImpl::topBufferedConnections(uint32_t limit) {
+  if (!workers_started_ || limit == 0) {
+    return {};
+  }
+
+  // The state is shared with the completions, as a worker which does not answer in time may still
+  // call its completion after this returns.
+  struct State {
+    Thread::MutexBasicLockable mutex_;
+    Thread::CondVar done_;
+    std::vector<Network::BufferedConnection> connections_ GUARDED_BY(mutex_);
+    size_t workers_pending_ GUARDED_BY(mutex_);
+  };
+  auto state = std::make_shared<State>();
+  {
+    Thread::LockGuard lock(state->mutex_);
+    state->workers_pending_ = workers_.size();
+  }
+  for (const auto& worker : workers_) {
+    worker->topBufferedConnections(
+        limit, [state](std::vector<Network::BufferedConnection>&& connections) -> void {
+          Thread::LockGuard lock(state->mutex_);
+          std::move(connections.begin(), connections.end(),
+                    std::back_inserter(state->connections_));
+          if (--state->workers_pending_ == 0) {
+            state->done_.notifyAll();
+          }
+        });
+  }
+
+  std::vector<Network::BufferedConnection> connections;
+  {
+    Thread::LockGuard lock(state->mutex_);
+    const auto deadline = std::chrono::steady_clock::now() + TopBufferedConnectionsTimeout;
+    while (state->workers_pending_ > 0) {
+      const auto now = std::chrono::steady_clock::now();
+      if (now >= deadline) {
+        ENVOY_LOG(warn, "{} workers did not report their buffered connections in time",
+                  state->workers_pending_);
+        break;
+      }
+      state->done_.waitFor(state->mutex_, deadline - now);
+    }
+    connections = state->connections_;
+  }
+
+  std::sort(connections.begin(), connections.end(),
+            [](const Network::BufferedConnection& lhs, const Network::BufferedConnection& rhs) {
+              return lhs.buffered_bytes_ > rhs.buffered_bytes_;
+            });
+  if (connections.size() > limit) {
+    connections.resize(limit);
+  }
+  return connections;
+}
+
 bool ListenerManagerImpl::removeListener(const std::string& name) {
   ENVOY_LOG(debug, "begin remove listener: name={}", name);
 
@@ -807,8 +975,9 @@ void ListenerManagerImpl::stopWorkers() {
 
 ListenerFilterChainFactoryBuilder::ListenerFilterChainFactoryBuilder(
     ListenerImpl& listener,
-    Server::Configuration::TransportSocketFactoryContextImpl& factory_context)
-    : parent_(listener), factory_context_(factory_context) {}
+    Server::Configuration::TransportSocketFactoryContextImpl& factory_context,
+    const ListenerImpl* previous)
+    : parent_(listener), factory_context_(factory_context), previous_(previous) {}
 
 std::unique_ptr<Network::FilterChain> ListenerFilterChainFactoryBuilder::buildFilterChain(
     const ::envoy::api::v2::listener::FilterChain& filter_chain) const {
@@ -826,17 +995,33 @@ std::unique_ptr<Network::FilterChain> ListenerFilterChainFactoryBuilder::buildFi
     }
   }
 
-  auto& config_factory = Config::Utility::getAndCheckFactory<
-      Server::Configuration::DownstreamTransportSocketConfigFactory>(transport_socket.name());
-  ProtobufTypes::MessagePtr message = Config::Utility::translateToFactoryConfig(
-      transport_socket, parent_.messageValidationVisitor(), config_factory);
-
   std::vector<std::string> server_names(filter_chain.filter_chain_match().server_names().begin(),
                                         filter_chain.filter_chain_match().server_names().end());
 
+  // Building a transport socket factory can be expensive, e.g. for TLS contexts, so the filter
+  // chains of the listener and of its updates share the factories with the same configuration.
+  const uint64_t key =
+      HashUtil::xxHash64(absl::StrJoin(server_names, ","), MessageUtil::hash(transport_socket));
+  Network::TransportSocketFactorySharedPtr& transport_socket_factory =
+      parent_.transport_socket_factories_[key];
+  if (transport_socket_factory == nullptr && previous_ != nullptr) {
+    const auto previous_factory = previous_->transport_socket_factories_.find(key);
+    if (previous_factory != previous_->transport_socket_factories_.end()) {
+      transport_socket_factory = previous_factory->second;
+      parent_.reused_transport_socket_factories_++;
+    }
+  }
+  if (transport_socket_factory == nullptr) {
+    auto& config_factory = Config::Utility::getAndCheckFactory<
+        Server::Configuration::DownstreamTransportSocketConfigFactory>(transport_socket.name());
+    ProtobufTypes::MessagePtr message = Config::Utility::translateToFactoryConfig(
+        transport_socket, parent_.messageValidationVisitor(), config_factory);
+    transport_socket_factory = config_factory.createTransportSocketFactory(
+        *message, factory_context_, std::move(server_names));
+  }
+
   return std::make_unique<FilterChainImpl>(
-      config_factory.createTransportSocketFactory(*message, factory_context_,
-                                                  std::move(server_names)),
+      transport_socket_factory,
       parent_.parent_.factory_.createNetworkFilterFactoryList(filter_chain.filters(), parent_));
 }
 
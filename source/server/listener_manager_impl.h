@@ -19,6 +19,8 @@
 #include "server/filter_chain_manager_impl.h"
 #include "server/lds_api.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -62,7 +64,8 @@ public:
   LdsApiPtr createLdsApi(const envoy::api::v2::core::ConfigSource& lds_config) override {
     return std::make_unique<LdsApiImpl>(
         lds_config, server_.clusterManager(), server_.initManager(), server_.stats(),
-        server_.listenerManager(), server_.messageValidationContext().dynamicValidationVisitor());
+        server_.listenerManager(), server_.messageValidationContext().dynamicValidationVisitor(),
+        server_.api());
   }
   std::vector<Network::FilterFactoryCb> createNetworkFilterFactoryList(
       const Protobuf::RepeatedPtrField<envoy::api::v2::listener::Filter>& filters,
@@ -83,10 +86,21 @@ public:
                                               Network::Address::SocketType socket_type,
                                               const Network::Socket::OptionsSharedPtr& options,
                                               bool bind_to_port) override;
+  Network::SocketSharedPtr
+  createReusePortListenSocket(Network::Address::InstanceConstSharedPtr address,
+                              Network::Address::SocketType socket_type,
+                              const Network::Socket::OptionsSharedPtr& options,
+                              uint32_t worker_index) override;
   DrainManagerPtr createDrainManager(envoy::api::v2::Listener::DrainType drain_type) override;
   uint64_t nextListenerTag() override { return next_listener_tag_++; }
 
 private:
+  Network::SocketSharedPtr
+  createListenSocketForWorker(Network::Address::InstanceConstSharedPtr address,
+                              Network::Address::SocketType socket_type,
+                              const Network::Socket::OptionsSharedPtr& options, bool bind_to_port,
+                              uint32_t worker_index);
+
   Instance& server_;
   uint64_t next_listener_tag_{1};
 };
@@ -103,6 +117,7 @@ using ListenerImplPtr = std::unique_ptr<ListenerImpl>;
   COUNTER(listener_create_success)                                                                 \
   COUNTER(listener_modified)                                                                       \
   COUNTER(listener_removed)                                                                        \
+  COUNTER(transport_socket_factory_reused)                                                         \
   GAUGE(total_listeners_active, NeverImport)                                                       \
   GAUGE(total_listeners_draining, NeverImport)                                                     \
   GAUGE(total_listeners_warming, NeverImport)
@@ -133,6 +148,7 @@ public:
   }
   std::vector<std::reference_wrapper<Network::ListenerConfig>> listeners() override;
   uint64_t numConnections() override;
+  std::vector<Network::BufferedConnection> topBufferedConnections(uint32_t limit) override;
   bool removeListener(const std::string& listener_name) override;
   void startWorkers(GuardDog& guard_dog) override;
   void stopListeners() override;
@@ -145,6 +161,9 @@ public:
 private:
   using ListenerList = std::list<ListenerImplPtr>;
 
+  // How long topBufferedConnections() waits for the workers to report their connections.
+  static constexpr std::chrono::seconds TopBufferedConnectionsTimeout{1};
+
   struct DrainingListener {
     DrainingListener(ListenerImplPtr&& listener, uint64_t workers_pending_removal)
         : listener_(std::move(listener)), workers_pending_removal_(workers_pending_removal) {}
@@ -154,6 +173,7 @@ private:
   };
 
   void addListenerToWorker(Worker& worker, ListenerImpl& listener);
+  void createWorkerSockets(ListenerImpl& listener);
   ProtobufTypes::MessagePtr dumpListenerConfigs();
   static ListenerManagerStats generateStats(Stats::Scope& scope);
   static bool hasListenerWithAddress(const ListenerList& list,
@@ -223,11 +243,14 @@ public:
    *        have been started. This controls various behavior related to init management.
    * @param hash supplies the hash to use for duplicate checking.
    * @param validation_visitor message validation visitor instance.
+   * @param previous supplies the active listener this one updates, if any, whose transport socket
+   *        factories are reused by the filter chains with the same transport socket configuration.
    */
   ListenerImpl(const envoy::api::v2::Listener& config, const std::string& version_info,
                ListenerManagerImpl& parent, const std::string& name, bool added_via_api,
                bool workers_started, uint64_t hash,
-               ProtobufMessage::ValidationVisitor& validation_visitor);
+               ProtobufMessage::ValidationVisitor& validation_visitor,
+               const ListenerImpl* previous);
   ~ListenerImpl() override;
 
   /**
@@ -255,13 +278,38 @@ public:
   DrainManager& localDrainManager() const { return *local_drain_manager_; }
   void setSocket(const Network::SocketSharedPtr& socket);
   void setSocketAndOptions(const Network::SocketSharedPtr& socket);
+  /**
+   * Sets the SO_REUSEPORT sockets of a reuse port listener, one per worker in worker order.
+   */
+  void setWorkerSockets(const std::vector<Network::SocketSharedPtr>& sockets);
+  const std::vector<Network::SocketSharedPtr>& getWorkerSockets() const { return worker_sockets_; }
+  /**
+   * Uses the sockets of another listener on the same address. @see sameReusePort().
+   */
+  void shareSockets(const ListenerImpl& listener);
+  bool reusePort() const { return reuse_port_; }
+  bool sameReusePort(const ListenerImpl& listener) const {
+    return reuse_port_ == listener.reuse_port_ &&
+           reuse_port_cpu_steering_ == listener.reuse_port_cpu_steering_;
+  }
   const Network::Socket::OptionsSharedPtr& listenSocketOptions() { return listen_socket_options_; }
   const std::string& versionInfo() { return version_info_; }
+  /**
+   * @return the number of transport socket factories reused from the previous listener.
+   */
+  uint64_t reusedTransportSocketFactories() const { return reused_transport_socket_factories_; }
 
   // Network::ListenerConfig
   Network::FilterChainManager& filterChainManager() override { return filter_chain_manager_; }
   Network::FilterChainFactory& filterChainFactory() override { return *this; }
   Network::Socket& socket() override { return *socket_; }
+  Network::Socket& workerSocket(uint32_t worker_index) override {
+    if (worker_sockets_.empty()) {
+      return *socket_;
+    }
+    ASSERT(worker_index < worker_sockets_.size());
+    return *worker_sockets_[worker_index];
+  }
   const Network::Socket& socket() const override { return *socket_; }
   bool bindToPort() override { return bind_to_port_; }
   bool handOffRestoredDestinationConnections() const override {
@@ -270,6 +318,9 @@ public:
   uint32_t perConnectionBufferLimitBytes() const override {
     return per_connection_buffer_limit_bytes_;
   }
+  uint32_t perConnectionReadBudgetBytes() const override {
+    return per_connection_read_budget_bytes_;
+  }
   std::chrono::milliseconds listenerFiltersTimeout() const override {
     return listener_filters_timeout_;
   }
@@ -277,6 +328,7 @@ public:
     return continue_on_listener_filters_timeout_;
   }
   Stats::Scope& listenerScope() override { return *listener_scope_; }
+  Network::ConnectionBalancer& connectionBalancer() override { return *connection_balancer_; }
   uint64_t listenerTag() const override { return listener_tag_; }
   const std::string& name() const override { return name_; }
 
@@ -336,6 +388,7 @@ public:
   SystemTime last_updated_;
 
 private:
+  void applyListenSocketOptions(Network::Socket& socket);
   void addListenSocketOption(const Network::Socket::OptionConstSharedPtr& option) {
     ensureSocketOptions();
     listen_socket_options_->emplace_back(std::move(option));
@@ -351,11 +404,18 @@ private:
 
   Network::Address::SocketType socket_type_;
   Network::SocketSharedPtr socket_;
+  // For reuse port listeners, the socket of each worker. The first is also socket_.
+  std::vector<Network::SocketSharedPtr> worker_sockets_;
   Stats::ScopePtr global_scope_;   // Stats with global named scope, but needed for LDS cleanup.
-  Stats::ScopePtr listener_scope_; // Stats with listener named scope.
+  // Stats with listener named scope. Shared with the updates of the listener, as the transport
+  // socket factories they reuse hold on to it.
+  Stats::ScopeSharedPtr listener_scope_;
   const bool bind_to_port_;
   const bool hand_off_restored_destination_connections_;
   const uint32_t per_connection_buffer_limit_bytes_;
+  const uint32_t per_connection_read_budget_bytes_;
+  const bool reuse_port_;
+  const bool reuse_port_cpu_steering_;
   const uint64_t listener_tag_;
   const std::string name_;
   const bool added_via_api_;
@@ -379,20 +439,28 @@ private:
   Network::Socket::OptionsSharedPtr listen_socket_options_;
   const std::chrono::milliseconds listener_filters_timeout_;
   const bool continue_on_listener_filters_timeout_;
+  Network::ConnectionBalancerPtr connection_balancer_;
   // to access ListenerManagerImpl::factory_.
+  // The transport socket factories of the filter chains, by their transport socket configuration
+  // and server names. @see ListenerFilterChainFactoryBuilder::buildFilterChain().
+  absl::flat_hash_map<uint64_t, Network::TransportSocketFactorySharedPtr>
+      transport_socket_factories_;
+  uint64_t reused_transport_socket_factories_{};
   friend class ListenerFilterChainFactoryBuilder;
 };
 
 class ListenerFilterChainFactoryBuilder : public FilterChainFactoryBuilder {
 public:
   ListenerFilterChainFactoryBuilder(
-      ListenerImpl& listener, Configuration::TransportSocketFactoryContextImpl& factory_context);
+      ListenerImpl& listener, Configuration::TransportSocketFactoryContextImpl& factory_context,
+      const ListenerImpl* previous);
   std::unique_ptr<Network::FilterChain>
   buildFilterChain(const ::envoy::api::v2::listener::FilterChain& filter_chain) const override;
 
 private:
   ListenerImpl& parent_;
   Configuration::TransportSocketFactoryContextImpl& factory_context_;
+  const ListenerImpl* previous_;
 };
 
 } // namespace Server
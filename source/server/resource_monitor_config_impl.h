@@ -8,16 +8,25 @@ namespace Configuration {
 
 class ResourceMonitorFactoryContextImpl : public ResourceMonitorFactoryContext {
 public:
-  ResourceMonitorFactoryContextImpl(Event::Dispatcher& dispatcher, Api::Api& api)
-      : dispatcher_(dispatcher), api_(api) {}
+  ResourceMonitorFactoryContextImpl(Event::Dispatcher& dispatcher, Api::Api& api,
+                                    ThreadLocal::SlotAllocator& slot_allocator,
+                                    OverloadManager& overload_manager)
+      : dispatcher_(dispatcher), api_(api), slot_allocator_(slot_allocator),
+        overload_manager_(overload_manager) {}
 
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
 
   Api::Api& api() override { return api_; }
 
+  ThreadLocal::SlotAllocator& threadLocal() override { return slot_allocator_; }
+
+  OverloadManager& overloadManager() override { return overload_manager_; }
+
 private:
   Event::Dispatcher& dispatcher_;
   Api::Api& api_;
+  ThreadLocal::SlotAllocator& slot_allocator_;
+  OverloadManager& overload_manager_;
 };
 
 } // namespace Configuration
@@ -22,6 +22,8 @@
 #include "common/api/api_impl.h"
 #include "common/api/os_sys_calls_impl.h"
 #include "common/buffer/buffer_impl.h"
+#include "common/buffer/slice_pool.h"
+#include "common/buffer/watermark_buffer.h"
 #include "common/common/enum_to_int.h"
 #include "common/common/mutex_tracer_impl.h"
 #include "common/common/utility.h"
@@ -70,8 +72,8 @@ InstanceImpl::InstanceImpl(const Options& options, Event::TimeSystem& time_syste
       random_generator_(std::move(random_generator)), listener_component_factory_(*this),
       worker_factory_(thread_local_, *api_, hooks),
       dns_resolver_(dispatcher_->createDnsResolver({})),
-      access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
-                          store),
+      access_log_manager_(options.fileFlushIntervalMsec(), options.fileMaxBufferedBytes(), *api_,
+                          *dispatcher_, access_log_lock, store),
       terminated_(false),
       mutex_tracer_(options.mutexTracingEnabled() ? &Envoy::MutexTracerImpl::getOrCreateTracer()
                                                   : nullptr),
@@ -141,6 +143,9 @@ MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store) {
   counters_.reserve(snapped_counters_.size());
   for (const auto& counter : snapped_counters_) {
     counters_.push_back({counter->latch(), *counter});
+    if (counters_.back().delta_ != 0) {
+      changed_counters_.push_back(counters_.back());
+    }
   }
 
   snapped_gauges_ = store.gauges();
@@ -148,6 +153,11 @@ MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store) {
   for (const auto& gauge : snapped_gauges_) {
     ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
     gauges_.push_back(*gauge);
+    // Latched on every flush, even without a sink using it, so that each flush only reports the
+    // changes since the previous one.
+    if (gauge->latchChanged()) {
+      changed_gauges_.push_back(*gauge);
+    }
   }
 
   snapped_histograms_ = store.histograms();
@@ -170,6 +180,15 @@ void InstanceUtil::flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks,
 }
 
 void InstanceImpl::flushStats() {
+  if (stats_flush_thread_ != nullptr && !terminated_ && stats_flush_thread_->busy()) {
+    // The sinks on the flush thread still read the histogram statistics of the previous snapshot,
+    // so the histograms are not merged, and the counters are left to the next flush to latch.
+    ENVOY_LOG(debug, "skipping stats flush, the previous flush is still running");
+    server_stats_->stats_flush_skipped_.inc();
+    stat_flush_timer_->enableTimer(config_.statsFlushInterval());
+    return;
+  }
+
   ENVOY_LOG(debug, "flushing stats");
   // If Envoy is not fully initialized, workers will not be started and mergeHistograms
   // completion callback is not called immediately. As a result of this server stats will
@@ -187,12 +206,26 @@ void InstanceImpl::flushStats() {
 
 void InstanceImpl::flushStatsInternal() {
   // mergeParentStatsIfAny() does nothing and returns a struct of 0s if there is no parent.
+  Stats::Timespan merge_timespan(server_stats_->hot_restart_stats_merge_time_ms_, timeSource());
   HotRestart::ServerStatsFromParent parent_stats = restarter_.mergeParentStatsIfAny(stats_store_);
+  if (parent_stats.stats_merged_) {
+    merge_timespan.complete();
+  }
 
   server_stats_->uptime_.set(time(nullptr) - original_start_time_);
   server_stats_->memory_allocated_.set(Memory::Stats::totalCurrentlyAllocated() +
                                        parent_stats.parent_memory_allocated_);
   server_stats_->memory_heap_size_.set(Memory::Stats::totalCurrentlyReserved());
+  // The pool counts are process-wide totals while the counters may also hold values merged from a
+  // hot restart parent, so only the growth since the last flush is added.
+  const uint64_t slice_pool_hits = Buffer::SlicePool::hits();
+  const uint64_t slice_pool_misses = Buffer::SlicePool::misses();
+  server_stats_->buffer_slice_pool_hits_.add(slice_pool_hits - last_slice_pool_hits_);
+  server_stats_->buffer_slice_pool_misses_.add(slice_pool_misses - last_slice_pool_misses_);
+  last_slice_pool_hits_ = slice_pool_hits;
+  last_slice_pool_misses_ = slice_pool_misses;
+  server_stats_->buffer_slice_pool_resident_bytes_.set(Buffer::SlicePool::residentBytes());
+  server_stats_->watermark_buffer_bytes_.set(Buffer::WatermarkBuffer::totalBufferedBytes());
   server_stats_->parent_connections_.set(parent_stats.parent_connections_);
   server_stats_->total_connections_.set(listener_manager_->numConnections() +
                                         parent_stats.parent_connections_);
@@ -200,13 +233,37 @@ void InstanceImpl::flushStatsInternal() {
       sslContextManager().daysUntilFirstCertExpires());
   server_stats_->state_.set(
       enumToInt(Utility::serverState(initManager().state(), healthCheckFailed())));
-  InstanceUtil::flushMetricsToSinks(config_.statsSinks(), stats_store_);
+  if (stats_flush_thread_ != nullptr && !terminated_) {
+    flushMetricsOnThread();
+  } else {
+    InstanceUtil::flushMetricsToSinks(config_.statsSinks(), stats_store_);
+  }
   // TODO(ramaraochavali): consider adding different flush interval for histograms.
   if (stat_flush_timer_ != nullptr) {
     stat_flush_timer_->enableTimer(config_.statsFlushInterval());
   }
 }
 
+void InstanceImpl::flushMetricsOnThread() {
+  // The sinks flushing on the thread and those flushing here share the snapshot, which only the
+  // main thread creates, as it latches the counters.
+  auto snapshot = std::make_shared<MetricSnapshotImpl>(stats_store_);
+  std::vector<std::reference_wrapper<Stats::Sink>> thread_sinks;
+  for (const auto& sink : config_.statsSinks()) {
+    if (sink->flushesOnAnyThread()) {
+      thread_sinks.push_back(*sink);
+    }
+  }
+  if (!thread_sinks.empty()) {
+    stats_flush_thread_->flush(snapshot, std::move(thread_sinks));
+  }
+  for (const auto& sink : config_.statsSinks()) {
+    if (!sink->flushesOnAnyThread()) {
+      sink->flush(*snapshot);
+    }
+  }
+}
+
 bool InstanceImpl::healthCheckFailed() { return server_stats_->live_.value() == 0; }
 
 InstanceUtil::BootstrapVersion InstanceUtil::loadBootstrapConfig(
@@ -290,6 +347,8 @@ void InstanceImpl::initialize(const Options& options,
   // stats.
   stats_store_.setTagProducer(Config::Utility::createTagProducer(bootstrap_));
   stats_store_.setStatsMatcher(Config::Utility::createStatsMatcher(bootstrap_));
+  stats_store_.setShardedCounterMatcher(Config::Utility::createShardedCounterMatcher(bootstrap_));
+  stats_store_.setHistogramSettings(Config::Utility::createHistogramSettings(bootstrap_));
 
   const std::string server_stats_prefix = "server.";
   server_stats_ = std::make_unique<ServerStats>(
@@ -362,6 +421,12 @@ void InstanceImpl::initialize(const Options& options,
   listener_manager_ = std::make_unique<ListenerManagerImpl>(
       *this, listener_component_factory_, worker_factory_, bootstrap_.enable_dispatcher_stats());
 
+  // Like the workers, the stats flush thread registers for thread local updates before any slot is
+  // set.
+  if (bootstrap_.stats_flush_on_dedicated_thread()) {
+    stats_flush_thread_ = std::make_unique<StatsFlushThread>(*api_, thread_local_);
+  }
+
   // The main thread is also registered for thread local updates so that code that does not care
   // whether it runs on the main thread or on workers can still use TLS.
   thread_local_.registerThread(*dispatcher_, true);
@@ -383,6 +448,13 @@ void InstanceImpl::initialize(const Options& options,
   // Once we have runtime we can initialize the SSL context manager.
   ssl_context_manager_ = createContextManager(Ssl::ContextManagerFactory::name(), time_source_);
 
+  // Resume the TLS sessions of our parent, if any, so that the connections made after a hot
+  // restart do not all need full handshakes.
+  const Ssl::SessionCacheSharedPtr session_cache = ssl_context_manager_->sessionCache();
+  if (session_cache != nullptr) {
+    restarter_.importParentTlsSessions(*session_cache);
+  }
+
   cluster_manager_factory_ = std::make_unique<Upstream::ProdClusterManagerFactory>(
       *admin_, Runtime::LoaderSingleton::get(), stats_store_, thread_local_, *random_generator_,
       dns_resolver_, *ssl_context_manager_, *dispatcher_, *local_info_, *secret_manager_,
@@ -391,6 +463,9 @@ void InstanceImpl::initialize(const Options& options,
   // Optional Wasm services. These must be initialied afer threading but before the main
   // configuration which many reference wasm vms.
   if (bootstrap_.wasm_service_size() > 0) {
+    Stats::Timespan wasm_services_timespan(
+        Configuration::MainImpl::generateInitializationStats(stats_store_).wasm_services_ms_,
+        timeSource());
     auto factory = Registry::FactoryRegistry<Configuration::WasmFactory>::getFactory("envoy.wasm");
     if (factory) {
       for (auto& config : bootstrap_.wasm_service()) {
@@ -410,6 +485,7 @@ void InstanceImpl::initialize(const Options& options,
     } else {
       ENVOY_LOG(warn, "No wasm factory available, so no wasm service started.");
     }
+    wasm_services_timespan.complete();
   }
 
   // Now the configuration gets parsed. The configuration may start setting
@@ -432,7 +508,9 @@ void InstanceImpl::initialize(const Options& options,
   if (bootstrap_.has_hds_config()) {
     const auto& hds_config = bootstrap_.hds_config();
     async_client_manager_ = std::make_unique<Grpc::AsyncClientManagerImpl>(
-        *config_.clusterManager(), thread_local_, time_source_, *api_);
+        *config_.clusterManager(), thread_local_, time_source_, *api_,
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(bootstrap_.cluster_manager(),
+                                        google_grpc_completion_threads, 1));
     hds_delegate_ = std::make_unique<Upstream::HdsDelegate>(
         stats_store_,
         Config::Utility::factoryForGrpcApiConfigSource(*async_client_manager_, hds_config,
@@ -588,6 +666,11 @@ void InstanceImpl::terminate() {
     listener_manager_->stopWorkers();
   }
 
+  // The final flush below runs all the sinks on the main thread.
+  if (stats_flush_thread_ != nullptr) {
+    stats_flush_thread_->stop();
+  }
+
   // Only flush if we have not been hot restarted.
   if (stat_flush_timer_) {
     flushStats();
@@ -38,6 +38,7 @@
 #include "server/listener_hooks.h"
 #include "server/listener_manager_impl.h"
 #include "server/overload_manager_impl.h"
+#include "server/stats_flush_thread.h"
 #include "server/worker_impl.h"
 
 #include "absl/container/node_hash_map.h"
@@ -50,9 +51,13 @@ namespace Server {
  * All server wide stats. @see stats_macros.h
  */
 #define ALL_SERVER_STATS(COUNTER, GAUGE, HISTOGRAM)                                                \
+  COUNTER(buffer_slice_pool_hits)                                                                  \
+  COUNTER(buffer_slice_pool_misses)                                                                \
   COUNTER(static_unknown_fields)                                                                   \
   COUNTER(dynamic_unknown_fields)                                                                  \
   COUNTER(debug_assertion_failures)                                                                \
+  COUNTER(stats_flush_skipped)                                                                     \
+  GAUGE(buffer_slice_pool_resident_bytes, NeverImport)                                             \
   GAUGE(concurrency, NeverImport)                                                                  \
   GAUGE(days_until_first_cert_expiring, Accumulate)                                                \
   GAUGE(hot_restart_epoch, NeverImport)                                                            \
@@ -64,6 +69,8 @@ namespace Server {
   GAUGE(total_connections, Accumulate)                                                             \
   GAUGE(uptime, Accumulate)                                                                        \
   GAUGE(version, NeverImport)                                                                      \
+  GAUGE(watermark_buffer_bytes, NeverImport)                                                       \
+  HISTOGRAM(hot_restart_stats_merge_time_ms)                                                       \
   HISTOGRAM(initialization_time_ms)
 
 struct ServerStats {
@@ -181,6 +188,7 @@ public:
   ListenerManager& listenerManager() override { return *listener_manager_; }
   Secret::SecretManager& secretManager() override { return *secret_manager_; }
   Envoy::MutexTracer* mutexTracer() override { return mutex_tracer_; }
+  GuardDog* guardDog() override { return guard_dog_.get(); }
   OverloadManager& overloadManager() override { return *overload_manager_; }
   Runtime::RandomGenerator& random() override { return *random_generator_; }
   Runtime::Loader& runtime() override;
@@ -217,6 +225,7 @@ private:
   ProtobufTypes::MessagePtr dumpBootstrapConfig();
   void flushStats();
   void flushStatsInternal();
+  void flushMetricsOnThread();
   void initialize(const Options& options, Network::Address::InstanceConstSharedPtr local_address,
                   ComponentFactory& component_factory, ListenerHooks& hooks);
   void loadServerFlags(const absl::optional<std::string>& flags_path);
@@ -245,6 +254,9 @@ private:
   time_t original_start_time_;
   Stats::StoreRoot& stats_store_;
   std::unique_ptr<ServerStats> server_stats_;
+  // The buffer slice pool counts at the last stats flush.
+  uint64_t last_slice_pool_hits_{};
+  uint64_t last_slice_pool_misses_{};
   Assert::ActionRegistrationPtr assert_action_registration_;
   ThreadLocal::Instance& thread_local_;
   Api::ApiPtr api_;
@@ -261,6 +273,8 @@ private:
   Configuration::MainImpl config_;
   Network::DnsResolverSharedPtr dns_resolver_;
   Event::TimerPtr stat_flush_timer_;
+  // Runs the flushes of the sinks supporting it when stats_flush_on_dedicated_thread is set.
+  StatsFlushThreadPtr stats_flush_thread_;
   LocalInfo::LocalInfoPtr local_info_;
   DrainManagerPtr drain_manager_;
   AccessLog::AccessLogManagerImpl access_log_manager_;
@@ -319,6 +333,10 @@ public:
   const std::vector<std::reference_wrapper<const Stats::ParentHistogram>>& histograms() override {
     return histograms_;
   }
+  const std::vector<CounterSnapshot>& changedCounters() override { return changed_counters_; }
+  const std::vector<std::reference_wrapper<const Stats::Gauge>>& changedGauges() override {
+    return changed_gauges_;
+  }
 
 private:
   std::vector<Stats::CounterSharedPtr> snapped_counters_;
@@ -327,6 +345,8 @@ private:
   std::vector<std::reference_wrapper<const Stats::Gauge>> gauges_;
   std::vector<Stats::ParentHistogramSharedPtr> snapped_histograms_;
   std::vector<std::reference_wrapper<const Stats::ParentHistogram>> histograms_;
+  std::vector<CounterSnapshot> changed_counters_;
+  std::vector<std::reference_wrapper<const Stats::Gauge>> changed_gauges_;
 };
 
 } // namespace Server
@@ -29,6 +29,16 @@ class SslContextManagerNoTlsStub final : public Envoy::Ssl::ContextManager {
 
   void iterateContexts(std::function<void(const Envoy::Ssl::Context&)> /* callback */) override{};
 
+  Ssl::SessionCacheSharedPtr sessionCache() override { return nullptr; }
+
+  Ssl::CertificatePreloadPtr preloadCertificates(
+      const std::vector<const envoy::api::v2::auth::TlsCertificate*>& /* tls_certificates */,
+      const std::vector<const envoy::api::v2::auth::CertificateValidationContext*>&
+      /* validation_contexts */,
+      Api::Api& /* api */, uint32_t /* max_threads */) override {
+    return nullptr;
+  }
+
 private:
   [[noreturn]] void throwException() {
     throw EnvoyException("SSL is not supported in this configuration");
@@ -0,0 +1,43 @@
+#include "server/stats_flush_thread.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Server {
+
+StatsFlushThread::StatsFlushThread(Api::Api& api, ThreadLocal::Instance& tls)
+    : tls_(tls), dispatcher_(api.allocateDispatcher()) {
+  tls_.registerThread(*dispatcher_, false);
+  thread_ = api.threadFactory().createThread([this]() -> void { threadRoutine(); });
+}
+
+void StatsFlushThread::stop() {
+  dispatcher_->exit();
+  thread_->join();
+}
+
+void StatsFlushThread::flush(std::shared_ptr<Stats::MetricSnapshot> snapshot,
+                             std::vector<std::reference_wrapper<Stats::Sink>>&& sinks) {
+  ASSERT(!busy_);
+  busy_ = true;
+  dispatcher_->post([this, snapshot, sinks = std::move(sinks)]() mutable -> void {
+    for (Stats::Sink& sink : sinks) {
+      sink.flush(*snapshot);
+    }
+    // The snapshot is released before the next flush can start, as it holds the flushed stats.
+    snapshot.reset();
+    busy_ = false;
+  });
+}
+
+void StatsFlushThread::threadRoutine() {
+  ENVOY_LOG(debug, "stats flush thread entering dispatch loop");
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  ENVOY_LOG(debug, "stats flush thread exited dispatch loop");
+  // As on the workers, the thread local state of the sinks is destroyed on the thread.
+  dispatcher_->clearDeferredDeleteList();
+  tls_.shutdownThread();
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/stats/sink.h"
+#include "envoy/thread/thread.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * A thread running the periodic flushes of the stats sinks which support it, so that their
+ * formatting and I/O do not delay the main thread. Like a worker, the thread is registered for
+ * thread local updates, so that the sinks can use their thread local state on it. Only used on the
+ * main thread.
+ */
+class StatsFlushThread : Logger::Loggable<Logger::Id::main> {
+public:
+  StatsFlushThread(Api::Api& api, ThreadLocal::Instance& tls);
+
+  /**
+   * Exits the thread, dropping a flush which has not started yet, and blocks until it joins. Must
+   * be called after the global shutdown of thread local updates. The dispatcher of the thread stays
+   * registered for thread local updates, so the object must outlive them, as a worker.
+   */
+  void stop();
+
+  /**
+   * @return whether the previous flush is still running on the thread.
+   */
+  bool busy() const { return busy_; }
+
+  /**
+   * Flushes a snapshot to sinks on the thread. Must not be called while busy(), as the histogram
+   * statistics of the snapshot are not changed until the flush completes.
+   * @param snapshot the snapshot, which may also be flushed to other sinks on the main thread.
+   * @param sinks the sinks, which must outlive the thread.
+   */
+  void flush(std::shared_ptr<Stats::MetricSnapshot> snapshot,
+             std::vector<std::reference_wrapper<Stats::Sink>>&& sinks);
+
+private:
+  void threadRoutine();
+
+  ThreadLocal::Instance& tls_;
+  Event::DispatcherPtr dispatcher_;
+  Thread::ThreadPtr thread_;
+  std::atomic<bool> busy_{};
+};
+
+using StatsFlushThreadPtr = std::unique_ptr<StatsFlushThread>;
+
+} // namespace Server
+} // namespace Envoy
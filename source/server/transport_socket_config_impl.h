@@ -43,6 +43,11 @@ public:
     return validation_visitor_;
   }
   Api::Api& api() override { return api_; }
+  OverloadManager* overloadManager() override { return overload_manager_; }
+
+  void setOverloadManager(OverloadManager& overload_manager) {
+    overload_manager_ = &overload_manager;
+  }
 
 private:
   Server::Admin& admin_;
@@ -58,6 +63,7 @@ private:
   Init::Manager* init_manager_{};
   ProtobufMessage::ValidationVisitor& validation_visitor_;
   Api::Api& api_;
+  OverloadManager* overload_manager_{};
 };
 
 } // namespace Configuration
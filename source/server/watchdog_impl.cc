@@ -1,13 +1,37 @@
 #include "server/watchdog_impl.h"
 
+#include <cerrno>
+#include <cstring>
+
 #include "envoy/event/dispatcher.h"
 
 #include "common/common/assert.h"
 
+#include "absl/debugging/stacktrace.h"
+
 namespace Envoy {
 namespace Server {
 
+namespace {
+
+// The WatchDog started on the current thread, which the stack sample signal handler samples.
+thread_local WatchDogImpl* current_watchdog = nullptr;
+
+} // namespace
+
+constexpr int WatchDogImpl::StackSampleSignal;
+
+WatchDogImpl::~WatchDogImpl() {
+  if (current_watchdog == this) {
+    current_watchdog = nullptr;
+  }
+}
+
 void WatchDogImpl::startWatchdog(Event::Dispatcher& dispatcher) {
+  thread_ = pthread_self();
+  current_watchdog = this;
+  dispatcher_.store(&dispatcher);
+
   timer_ = dispatcher.createTimer([this]() -> void {
     this->touch();
     timer_->enableTimer(timer_interval_);
@@ -15,5 +39,54 @@ void WatchDogImpl::startWatchdog(Event::Dispatcher& dispatcher) {
   timer_->enableTimer(timer_interval_);
 }
 
+void WatchDogImpl::installStackSampleHandler() {
+  static const bool installed = []() -> bool {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = onStackSampleSignal;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    return sigaction(StackSampleSignal, &action, nullptr) == 0;
+  }();
+  ASSERT(installed);
+}
+
+bool WatchDogImpl::requestStackSample() {
+  if (dispatcher_.load() == nullptr) {
+    return false;
+  }
+  sample_requested_++;
+  return pthread_kill(thread_, StackSampleSignal) == 0;
+}
+
+absl::optional<WatchDogImpl::StackSample> WatchDogImpl::takeStackSample() {
+  const uint64_t requested = sample_requested_.load();
+  if (requested == 0 || sample_taken_.load() != requested) {
+    return absl::nullopt;
+  }
+  StackSample sample;
+  sample.frames_.assign(sample_frames_, sample_frames_ + sample_depth_);
+  sample.tracked_object_type_ = sample_tracked_object_type_;
+  sample_taken_.store(0);
+  return sample;
+}
+
+// Runs on the watched thread, interrupted wherever it is stalled, so it must be async-signal-safe:
+// it only walks the stack and reads the pointer to the tracked object of the dispatcher.
+void WatchDogImpl::onStackSampleSignal(int, siginfo_t*, void* context) {
+  WatchDogImpl* watchdog = current_watchdog;
+  if (watchdog == nullptr) {
+    return;
+  }
+  const int saved_errno = errno;
+  watchdog->sample_depth_ = absl::GetStackTraceWithContext(
+      watchdog->sample_frames_, MaxStackDepth, /* skip_count = */ 1, context,
+      /* min_dropped_frames = */ nullptr);
+  const ScopeTrackedObject* object = watchdog->dispatcher_.load()->trackedObject();
+  watchdog->sample_tracked_object_type_ = object != nullptr ? &typeid(*object) : nullptr;
+  watchdog->sample_taken_.store(watchdog->sample_requested_.load());
+  errno = saved_errno;
+}
+
 } // namespace Server
 } // namespace Envoy
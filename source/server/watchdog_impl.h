@@ -1,12 +1,19 @@
 #pragma once
 
+#include <pthread.h>
+
 #include <atomic>
 #include <chrono>
+#include <csignal>
+#include <typeinfo>
+#include <vector>
 
 #include "envoy/common/time.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/server/watchdog.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -16,6 +23,18 @@ namespace Server {
  */
 class WatchDogImpl : public WatchDog {
 public:
+  /**
+   * The stack of a watched thread and the type of the object it tracked when it was sampled.
+   */
+  struct StackSample {
+    std::vector<void*> frames_;
+    const std::type_info* tracked_object_type_{};
+  };
+
+  // The signal interrupting a watched thread to sample its stack. It is ignored by default, and
+  // only raised for sockets with an owner, which Envoy does not set.
+  static constexpr int StackSampleSignal = SIGURG;
+
   /**
    * @param interval WatchDog timer interval (used after startWatchdog())
    */
@@ -23,6 +42,7 @@ public:
       : thread_id_(thread_id), time_source_(tsource),
         latest_touch_time_since_epoch_(tsource.monotonicTime().time_since_epoch()),
         timer_interval_(interval) {}
+  ~WatchDogImpl() override;
 
   Thread::ThreadId threadId() const override { return thread_id_; }
   MonotonicTime lastTouchTime() const override {
@@ -35,12 +55,45 @@ public:
     latest_touch_time_since_epoch_.store(time_source_.monotonicTime().time_since_epoch());
   }
 
+  /**
+   * Installs the handler of StackSampleSignal, once per process.
+   */
+  static void installStackSampleHandler();
+
+  /**
+   * Interrupts the watched thread for it to sample its stack, which takeStackSample() then returns.
+   * @return false if the thread can not be sampled, as its WatchDog was not started on it or it
+   *         could not be signaled.
+   */
+  bool requestStackSample();
+
+  /**
+   * @return the sample taken for the last requestStackSample(), or absl::nullopt if the thread
+   *         did not take it yet.
+   */
+  absl::optional<StackSample> takeStackSample();
+
 private:
+  static constexpr int MaxStackDepth = 64;
+
+  static void onStackSampleSignal(int sig, siginfo_t* info, void* context);
+
   const Thread::ThreadId thread_id_;
   TimeSource& time_source_;
   std::atomic<std::chrono::steady_clock::duration> latest_touch_time_since_epoch_;
   Event::TimerPtr timer_;
   const std::chrono::milliseconds timer_interval_;
+
+  // Set on the watched thread by startWatchdog(), the thread before the dispatcher.
+  pthread_t thread_{};
+  std::atomic<Event::Dispatcher*> dispatcher_{};
+  // Written by the signal handler on the watched thread, then published by storing the request it
+  // answers into sample_taken_.
+  void* sample_frames_[MaxStackDepth];
+  int sample_depth_{};
+  const std::type_info* sample_tracked_object_type_{};
+  std::atomic<uint64_t> sample_requested_{};
+  std::atomic<uint64_t> sample_taken_{};
 };
 
 } // namespace Server
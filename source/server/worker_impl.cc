@@ -8,16 +8,18 @@
 #include "envoy/server/configuration.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/profiler/profiler.h"
+
 #include "server/connection_handler_impl.h"
 
 namespace Envoy {
 namespace Server {
 
-WorkerPtr ProdWorkerFactory::createWorker(OverloadManager& overload_manager) {
+WorkerPtr ProdWorkerFactory::createWorker(OverloadManager& overload_manager, uint32_t index) {
   Event::DispatcherPtr dispatcher(api_.allocateDispatcher());
   return WorkerPtr{new WorkerImpl(
       tls_, hooks_, std::move(dispatcher),
-      Network::ConnectionHandlerPtr{new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher)},
+      Network::ConnectionHandlerPtr{new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher, index)},
       overload_manager, api_)};
 }
 
@@ -30,6 +32,9 @@ WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
   overload_manager.registerForAction(
       OverloadActionNames::get().StopAcceptingConnections, *dispatcher_,
       [this](OverloadActionState state) { stopAcceptingConnectionsCb(state); });
+  overload_manager.registerForAction(
+      OverloadActionNames::get().StopReadingConnections, *dispatcher_,
+      [this](OverloadActionState state) { stopReadingConnectionsCb(state); });
 }
 
 void WorkerImpl::addListener(Network::ListenerConfig& listener, AddListenerCompletion completion) {
@@ -97,8 +102,16 @@ void WorkerImpl::stopListeners() {
   dispatcher_->post([this]() -> void { handler_->stopListeners(); });
 }
 
+void WorkerImpl::topBufferedConnections(uint32_t limit,
+                                        BufferedConnectionsCompletion completion) {
+  dispatcher_->post([this, limit, completion]() -> void {
+    completion(handler_->topBufferedConnections(limit));
+  });
+}
+
 void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
   ENVOY_LOG(debug, "worker entering dispatch loop");
+  Profiler::Cpu::registerWorkerThread();
   auto watchdog = guard_dog.createWatchDog(api_.threadFactory().currentThreadId());
   watchdog->startWatchdog(*dispatcher_);
   dispatcher_->run(Event::Dispatcher::RunType::Block);
@@ -124,5 +137,16 @@ void WorkerImpl::stopAcceptingConnectionsCb(OverloadActionState state) {
   }
 }
 
+void WorkerImpl::stopReadingConnectionsCb(OverloadActionState state) {
+  switch (state) {
+  case OverloadActionState::Active:
+    handler_->disableConnectionReads();
+    break;
+  case OverloadActionState::Inactive:
+    handler_->enableConnectionReads();
+    break;
+  }
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -23,7 +23,7 @@ public:
       : tls_(tls), api_(api), hooks_(hooks) {}
 
   // Server::WorkerFactory
-  WorkerPtr createWorker(OverloadManager& overload_manager) override;
+  WorkerPtr createWorker(OverloadManager& overload_manager, uint32_t index) override;
 
 private:
   ThreadLocal::Instance& tls_;
@@ -49,10 +49,12 @@ public:
   void stop() override;
   void stopListener(Network::ListenerConfig& listener) override;
   void stopListeners() override;
+  void topBufferedConnections(uint32_t limit, BufferedConnectionsCompletion completion) override;
 
 private:
   void threadRoutine(GuardDog& guard_dog);
   void stopAcceptingConnectionsCb(OverloadActionState state);
+  void stopReadingConnectionsCb(OverloadActionState state);
 
   ThreadLocal::Instance& tls_;
   ListenerHooks& hooks_;
@@ -1030,6 +1030,42 @@ TEST(AccessLogFormatterTest, CompositeFormatterSuccess) {
   }
 }
 
+// formatInto() appends the same line as format(), including for the fields that are appended to
+// the output directly.
+TEST(AccessLogFormatterTest, CompositeFormatterFormatInto) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestHeaderMapImpl request_header{{":method", "GET"}, {":path", "/"}};
+  Http::TestHeaderMapImpl response_header{{"test", "test"}};
+  Http::TestHeaderMapImpl response_trailer;
+  const std::string format =
+      "%REQ(:METHOD)% %REQ(:PATH):1% %PROTOCOL% %RESPONSE_CODE% %BYTES_RECEIVED% %BYTES_SENT% "
+      "%DURATION% %REQUEST_DURATION% %RESPONSE_DURATION% %RESP(TEST)% %UPSTREAM_HOST% "
+      "%UPSTREAM_CLUSTER%";
+  FormatterImpl formatter(format);
+
+  {
+    std::string output = "prefix ";
+    formatter.formatInto(request_header, response_header, response_trailer, stream_info, output);
+    EXPECT_EQ("prefix GET / - 0 0 0 - - - test 10.0.0.1:443 fake_cluster", output);
+  }
+
+  stream_info.protocol_ = Http::Protocol::Http2;
+  stream_info.response_code_ = 200;
+  stream_info.bytes_received_ = 10;
+  stream_info.bytes_sent_ = 20;
+  stream_info.end_time_ = std::chrono::milliseconds(30);
+  stream_info.last_downstream_rx_byte_received_ = std::chrono::milliseconds(5);
+  stream_info.first_upstream_rx_byte_received_ = std::chrono::milliseconds(25);
+  stream_info.host_.reset();
+
+  const std::string expected = "GET / HTTP/2 200 10 20 30 5 25 test - -";
+  EXPECT_EQ(expected,
+            formatter.format(request_header, response_header, response_trailer, stream_info));
+  std::string output;
+  formatter.formatInto(request_header, response_header, response_trailer, stream_info, output);
+  EXPECT_EQ(expected, output);
+}
+
 TEST(AccessLogFormatterTest, ParserFailures) {
   AccessLogFormatParser parser;
 
@@ -18,6 +18,7 @@
 #include "test/mocks/access_log/mocks.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/filesystem/mocks.h"
+#include "test/mocks/router/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/mocks/upstream/mocks.h"
@@ -1134,6 +1135,73 @@ config:
   log->log(&request_headers_, &response_headers_, &response_trailers_, stream_info_);
 }
 
+TEST_F(AccessLogImplTest, AggregateFilter) {
+  const std::string yaml = R"EOF(
+name: envoy.file_access_log
+filter:
+  aggregate_filter:
+    stat_prefix: agg
+    filter:
+      status_code_filter:
+        comparison:
+          op: GE
+          value:
+            default_value: 500
+            runtime_key: key
+config:
+  path: /dev/null
+  )EOF";
+
+  const InstanceSharedPtr log =
+      AccessLogFactory::fromProto(parseAccessLogFromV2Yaml(yaml), context_);
+  EXPECT_CALL(runtime_.snapshot_, getInteger("key", 500)).WillRepeatedly(Return(500));
+
+  // Successes are only aggregated.
+  stream_info_.response_code_ = 200;
+  EXPECT_CALL(*file_, write(_)).Times(0);
+  log->log(&request_headers_, &response_headers_, &response_trailers_, stream_info_);
+  EXPECT_EQ(1, context_.scope_.counter("access_log.agg.rq_2xx").value());
+
+  // Errors are aggregated and logged.
+  stream_info_.response_code_ = 503;
+  EXPECT_CALL(*file_, write(_));
+  log->log(&request_headers_, &response_headers_, &response_trailers_, stream_info_);
+  EXPECT_EQ(1, context_.scope_.counter("access_log.agg.rq_5xx").value());
+
+  stream_info_.response_code_.reset();
+  EXPECT_CALL(*file_, write(_)).Times(0);
+  log->log(&request_headers_, &response_headers_, &response_trailers_, stream_info_);
+  EXPECT_EQ(1, context_.scope_.counter("access_log.agg.rq_no_response").value());
+  EXPECT_EQ(1, context_.scope_.counter("access_log.agg.rq_2xx").value());
+}
+
+TEST_F(AccessLogImplTest, AggregateFilterPerRoute) {
+  const std::string yaml = R"EOF(
+name: envoy.file_access_log
+filter:
+  aggregate_filter:
+    stat_prefix: agg
+    per_route: true
+config:
+  path: /dev/null
+  )EOF";
+
+  const InstanceSharedPtr log =
+      AccessLogFactory::fromProto(parseAccessLogFromV2Yaml(yaml), context_);
+  NiceMock<Router::MockRouteEntry> route_entry;
+  EXPECT_CALL(*file_, write(_)).Times(0);
+
+  stream_info_.response_code_ = 404;
+  stream_info_.route_entry_ = &route_entry;
+  log->log(&request_headers_, &response_headers_, &response_trailers_, stream_info_);
+  EXPECT_EQ(1, context_.scope_.counter("access_log.agg.route.fake_route_name.rq_4xx").value());
+
+  // Requests without a route are aggregated under the prefix.
+  stream_info_.route_entry_ = nullptr;
+  log->log(&request_headers_, &response_headers_, &response_trailers_, stream_info_);
+  EXPECT_EQ(1, context_.scope_.counter("access_log.agg.rq_4xx").value());
+}
+
 class TestHeaderFilterFactory : public ExtensionFilterFactory {
 public:
   ~TestHeaderFilterFactory() override = default;
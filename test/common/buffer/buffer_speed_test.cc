@@ -88,6 +88,21 @@ static void BufferAddBuffer(benchmark::State& state) {
 }
 BENCHMARK(BufferAddBuffer)->Arg(1)->Arg(4096)->Arg(16384)->Arg(65536);
 
+// Test sharing the same content with several buffers, as when a request body is mirrored.
+static void BufferAddSharedFanOut(benchmark::State& state) {
+  constexpr size_t NumBuffers = 8;
+  const std::string data(state.range(0), 'a');
+  Buffer::OwnedImpl to_add(data);
+  for (auto _ : state) {
+    Buffer::OwnedImpl buffers[NumBuffers];
+    for (Buffer::OwnedImpl& buffer : buffers) {
+      buffer.addShared(to_add);
+    }
+    benchmark::DoNotOptimize(buffers[NumBuffers - 1].length());
+  }
+}
+BENCHMARK(BufferAddSharedFanOut)->Arg(1)->Arg(4096)->Arg(16384)->Arg(65536);
+
 // Test the prepending of varying amounts of content from a string to an OwnedImpl.
 static void BufferPrependString(benchmark::State& state) {
   const std::string data(state.range(0), 'a');
@@ -224,6 +224,37 @@ TEST(UnownedSliceTest, CreateDeleteOwnedBufferFragment) {
   EXPECT_TRUE(release_callback_called);
 }
 
+TEST(SharedSliceTest, CreateDelete) {
+  constexpr char input[] = "hello world";
+  bool release_callback_called = false;
+  BufferFragmentImpl fragment(
+      input, sizeof(input) - 1,
+      [&release_callback_called](const void*, size_t, const BufferFragmentImpl*) {
+        release_callback_called = true;
+      });
+  auto storage = std::make_shared<UnownedSlice>(fragment);
+  auto slice = std::make_unique<SharedSlice>(storage, storage->data(), storage->dataSize());
+  storage.reset();
+  SlicePtr other_slice = slice->share();
+  EXPECT_EQ(11, slice->dataSize());
+  EXPECT_EQ(0, slice->reservableSize());
+  EXPECT_EQ(0, memcmp(slice->data(), input, slice->dataSize()));
+  EXPECT_EQ(slice->data(), other_slice->data());
+
+  // Nothing can be added to a shared slice, while draining it does not affect the other ones.
+  EXPECT_EQ(0, slice->append("!", 1));
+  EXPECT_EQ(nullptr, slice->reserve(1).mem_);
+  slice->drain(6);
+  EXPECT_EQ(0, slice->prepend("a", 1));
+  EXPECT_EQ(5, slice->dataSize());
+  EXPECT_EQ(11, other_slice->dataSize());
+
+  slice.reset(nullptr);
+  EXPECT_FALSE(release_callback_called);
+  other_slice.reset(nullptr);
+  EXPECT_TRUE(release_callback_called);
+}
+
 TEST(SliceDequeTest, CreateDelete) {
   bool slice1_deleted = false;
   bool slice2_deleted = false;
@@ -571,6 +571,101 @@ TEST_P(OwnedImplTest, ReserveZeroCommit) {
   EXPECT_EQ("bbbbb", buf.toString().substr(0, 5));
 }
 
+TEST_P(OwnedImplTest, AddSharedLargeSlices) {
+  const std::string large(2 * OwnedImpl::MinSharedSliceSize, 'a');
+  Buffer::OwnedImpl source(large);
+  verifyImplementation(source);
+  Buffer::OwnedImpl copy;
+  copy.addShared(source);
+  EXPECT_EQ(large, copy.toString());
+
+  RawSlice source_slice;
+  RawSlice copy_slice;
+  ASSERT_EQ(1, source.getRawSlices(&source_slice, 1));
+  ASSERT_EQ(1, copy.getRawSlices(&copy_slice, 1));
+  if (GetParam() == BufferImplementation::New) {
+    EXPECT_EQ(source_slice.mem_, copy_slice.mem_);
+  } else {
+    EXPECT_NE(source_slice.mem_, copy_slice.mem_);
+  }
+
+  // Changing one buffer leaves the other unchanged.
+  source.prepend("b");
+  source.add("c");
+  copy.drain(1);
+  EXPECT_EQ("b" + large + "c", source.toString());
+  EXPECT_EQ(large.substr(1), copy.toString());
+  source.drain(source.length());
+  EXPECT_EQ(large.substr(1), copy.toString());
+}
+
+TEST_P(OwnedImplTest, AddSharedCopiesSmallSlices) {
+  Buffer::OwnedImpl source("hello");
+  verifyImplementation(source);
+  Buffer::OwnedImpl copy;
+  copy.addShared(source);
+
+  RawSlice source_slice;
+  RawSlice copy_slice;
+  ASSERT_EQ(1, source.getRawSlices(&source_slice, 1));
+  ASSERT_EQ(1, copy.getRawSlices(&copy_slice, 1));
+  EXPECT_NE(source_slice.mem_, copy_slice.mem_);
+
+  source.add(" world");
+  EXPECT_EQ("hello world", source.toString());
+  EXPECT_EQ("hello", copy.toString());
+}
+
+// Adding a buffer copies it, leaving its slices, and their room for more data, unchanged.
+TEST_P(OwnedImplTest, AddCopiesLargeSlices) {
+  const std::string large(2 * OwnedImpl::MinSharedSliceSize, 'a');
+  Buffer::OwnedImpl source(large);
+  verifyImplementation(source);
+  RawSlice source_slice;
+  ASSERT_EQ(1, source.getRawSlices(&source_slice, 1));
+  Buffer::OwnedImpl copy;
+  copy.add(static_cast<const Instance&>(source));
+  EXPECT_EQ(large, copy.toString());
+
+  RawSlice copy_slice;
+  ASSERT_EQ(1, copy.getRawSlices(&copy_slice, 1));
+  EXPECT_NE(source_slice.mem_, copy_slice.mem_);
+
+  source.add("b");
+  if (GetParam() == BufferImplementation::New) {
+    // The source still appends into its last slice.
+    RawSlice appended_slice;
+    ASSERT_EQ(1, source.getRawSlices(&appended_slice, 1));
+    EXPECT_EQ(source_slice.mem_, appended_slice.mem_);
+  }
+  EXPECT_EQ(large + "b", source.toString());
+  EXPECT_EQ(large, copy.toString());
+}
+
+TEST_P(OwnedImplTest, AddSharedFragment) {
+  const std::string input(OwnedImpl::MinSharedSliceSize, 'a');
+  BufferFragmentImpl frag(input.data(), input.size(),
+                          [this](const void*, size_t, const BufferFragmentImpl*) {
+                            release_callback_called_ = true;
+                          });
+  Buffer::OwnedImpl source;
+  verifyImplementation(source);
+  source.addBufferFragment(frag);
+  Buffer::OwnedImpl copy1;
+  Buffer::OwnedImpl copy2;
+  copy1.addShared(source);
+  copy2.addShared(copy1);
+
+  source.drain(source.length());
+  EXPECT_EQ(input, copy1.toString());
+  copy1.drain(copy1.length());
+  EXPECT_EQ(input, copy2.toString());
+  // The new implementation references the fragment until the last buffer sharing it is drained.
+  EXPECT_EQ(GetParam() == BufferImplementation::Old, release_callback_called_);
+  copy2.drain(copy2.length());
+  EXPECT_TRUE(release_callback_called_);
+}
+
 TEST(OverflowDetectingUInt64, Arithmetic) {
   Logger::StderrSinkDelegate stderr_sink(Logger::Registry::getSink()); // For coverage build.
   OverflowDetectingUInt64 length;
@@ -0,0 +1,120 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/buffer/reader.h"
+
+#include "test/common/buffer/utility.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+class ReaderTest : public BufferImplementationParamTest {
+protected:
+  // Fill buffer_ with slices of the given strings.
+  void addSlices(std::initializer_list<absl::string_view> slices) {
+    verifyImplementation(buffer_);
+    for (absl::string_view slice : slices) {
+      buffer_.appendSliceForTest(slice);
+    }
+  }
+
+  OwnedImpl buffer_;
+};
+
+INSTANTIATE_TEST_SUITE_P(ReaderTest, ReaderTest,
+                         testing::ValuesIn({BufferImplementation::Old, BufferImplementation::New}));
+
+TEST_P(ReaderTest, Empty) {
+  Reader reader(buffer_);
+  EXPECT_EQ(0, reader.position());
+  EXPECT_EQ(0, reader.remaining());
+  EXPECT_EQ(-1, reader.find('a'));
+  uint64_t value;
+  EXPECT_EQ(0, reader.readVarInt(value));
+  EXPECT_THROW_WITH_MESSAGE(reader.readByte(), EnvoyException, "buffer underflow");
+  EXPECT_THROW_WITH_MESSAGE(Reader(buffer_, 1), EnvoyException, "buffer underflow");
+}
+
+TEST_P(ReaderTest, ReadAcrossSlices) {
+  addSlices({"ab", "", "cdef", "g"});
+  Reader reader(buffer_, 1);
+  EXPECT_EQ(1, reader.position());
+  EXPECT_EQ(6, reader.remaining());
+  EXPECT_EQ('b', reader.readByte());
+  EXPECT_EQ("cde", reader.readString(3));
+  char out[2];
+  reader.read(out, 2);
+  EXPECT_EQ("fg", absl::string_view(out, 2));
+  EXPECT_EQ(7, reader.position());
+  EXPECT_EQ(0, reader.remaining());
+  EXPECT_THROW_WITH_MESSAGE(reader.readString(1), EnvoyException, "buffer underflow");
+  EXPECT_EQ("abcdefg", buffer_.toString());
+}
+
+TEST_P(ReaderTest, Skip) {
+  addSlices({"ab", "cd"});
+  Reader reader(buffer_);
+  reader.skip(2);
+  EXPECT_EQ('c', reader.readByte());
+  EXPECT_THROW_WITH_MESSAGE(reader.skip(2), EnvoyException, "buffer underflow");
+  reader.skip(1);
+  EXPECT_EQ(0, reader.remaining());
+}
+
+TEST_P(ReaderTest, ReadInt) {
+  addSlices({std::string("\x01\x02", 2), std::string("\x03\x04\xff", 3), std::string("\xfe", 1)});
+  Reader reader(buffer_);
+  EXPECT_EQ(0x01020304, reader.readBEInt<uint32_t>());
+  EXPECT_EQ(-257, (reader.readLEInt<int32_t, 2>()));
+  EXPECT_EQ(6, reader.position());
+
+  Reader other_reader(buffer_, 2);
+  EXPECT_EQ(0x0403, other_reader.readLEInt<uint16_t>());
+  EXPECT_EQ(buffer_.peekBEInt<int16_t>(4), other_reader.readBEInt<int16_t>());
+  EXPECT_THROW_WITH_MESSAGE(other_reader.readInt<uint8_t>(), EnvoyException, "buffer underflow");
+}
+
+TEST_P(ReaderTest, ReadVarInt) {
+  // 300 is encoded as 0xac 0x02, followed by 1 and an incomplete varint.
+  addSlices({"\xac", "\x02\x01", "\x80"});
+  Reader reader(buffer_);
+  uint64_t value = 0;
+  EXPECT_EQ(2, reader.readVarInt(value));
+  EXPECT_EQ(300, value);
+  EXPECT_EQ(1, reader.readVarInt(value));
+  EXPECT_EQ(1, value);
+  EXPECT_EQ(0, reader.readVarInt(value));
+  EXPECT_EQ(1, value);
+  EXPECT_EQ(3, reader.position());
+
+  // A varint longer than max_size is not read.
+  Reader other_reader(buffer_);
+  EXPECT_EQ(0, other_reader.readVarInt(value, 1));
+  EXPECT_EQ(0, other_reader.position());
+  EXPECT_EQ(0xac, other_reader.readByte());
+}
+
+TEST_P(ReaderTest, ReadVarIntMax) {
+  addSlices({std::string(9, '\xff'), "\x01"});
+  Reader reader(buffer_);
+  uint64_t value = 0;
+  EXPECT_EQ(10, reader.readVarInt(value));
+  EXPECT_EQ(UINT64_MAX, value);
+}
+
+TEST_P(ReaderTest, Find) {
+  addSlices({"ab", "c", "", "dc"});
+  Reader reader(buffer_);
+  EXPECT_EQ(2, reader.find('c'));
+  EXPECT_EQ(-1, reader.find('e'));
+  reader.skip(3);
+  EXPECT_EQ(1, reader.find('c'));
+  EXPECT_EQ(0, reader.find('d'));
+  EXPECT_EQ(3, reader.position());
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
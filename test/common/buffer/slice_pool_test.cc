@@ -0,0 +1,93 @@
+#include <functional>
+#include <thread>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/buffer/slice_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+// The totals are published by each thread periodically and at thread exit, so each test does its
+// work on a thread of its own and checks the totals after joining it.
+void runOnThread(std::function<void()> fn) {
+  std::thread thread(fn);
+  thread.join();
+}
+
+TEST(SlicePoolTest, ReusesReleasedBlocks) {
+  const uint64_t hits = SlicePool::hits();
+  const uint64_t misses = SlicePool::misses();
+  const uint64_t resident_bytes = SlicePool::residentBytes();
+  runOnThread([] {
+    void* block = SlicePool::allocate(SlicePool::PageSize);
+    SlicePool::release(block, SlicePool::PageSize);
+    EXPECT_EQ(block, SlicePool::allocate(SlicePool::PageSize));
+    // A different size class does not reuse the block.
+    void* other_block = SlicePool::allocate(2 * SlicePool::PageSize);
+    EXPECT_NE(block, other_block);
+    SlicePool::release(block, SlicePool::PageSize);
+    SlicePool::release(other_block, 2 * SlicePool::PageSize);
+  });
+  EXPECT_EQ(hits + 1, SlicePool::hits());
+  EXPECT_EQ(misses + 2, SlicePool::misses());
+  // Cached blocks are freed at thread exit.
+  EXPECT_EQ(resident_bytes, SlicePool::residentBytes());
+}
+
+TEST(SlicePoolTest, LargeBlocksAreNotPooled) {
+  const uint64_t hits = SlicePool::hits();
+  const uint64_t misses = SlicePool::misses();
+  runOnThread([] {
+    const uint64_t size = (SlicePool::MaxPooledPages + 1) * SlicePool::PageSize;
+    for (int i = 0; i < 2; i++) {
+      SlicePool::release(SlicePool::allocate(size), size);
+    }
+  });
+  EXPECT_EQ(hits, SlicePool::hits());
+  EXPECT_EQ(misses, SlicePool::misses());
+}
+
+TEST(SlicePoolTest, ResidentBytesLimit) {
+  const uint64_t hits = SlicePool::hits();
+  SlicePool::setMaxResidentBytesPerThread(SlicePool::PageSize);
+  runOnThread([] {
+    void* block1 = SlicePool::allocate(SlicePool::PageSize);
+    void* block2 = SlicePool::allocate(SlicePool::PageSize);
+    SlicePool::release(block1, SlicePool::PageSize);
+    // Over the limit, so this goes back to the heap.
+    SlicePool::release(block2, SlicePool::PageSize);
+    EXPECT_EQ(block1, SlicePool::allocate(SlicePool::PageSize));
+    void* block3 = SlicePool::allocate(SlicePool::PageSize);
+    SlicePool::release(block1, SlicePool::PageSize);
+    SlicePool::release(block3, SlicePool::PageSize);
+  });
+  SlicePool::setMaxResidentBytesPerThread(SlicePool::DefaultMaxResidentBytesPerThread);
+  EXPECT_EQ(hits + 1, SlicePool::hits());
+}
+
+TEST(SlicePoolTest, OwnedSliceStorageIsPooled) {
+  const uint64_t hits = SlicePool::hits();
+  runOnThread([] {
+    RawSlice slice;
+    const void* data;
+    {
+      OwnedImpl buffer;
+      buffer.add(std::string(100, 'a'));
+      ASSERT_EQ(1, buffer.getRawSlices(&slice, 1));
+      data = slice.mem_;
+    }
+    OwnedImpl buffer;
+    buffer.add(std::string(100, 'b'));
+    ASSERT_EQ(1, buffer.getRawSlices(&slice, 1));
+    EXPECT_EQ(data, slice.mem_);
+    EXPECT_EQ(std::string(100, 'b'), buffer.toString());
+  });
+  EXPECT_LE(hits + 1, SlicePool::hits());
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
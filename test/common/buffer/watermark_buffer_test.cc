@@ -1,4 +1,5 @@
 #include <array>
+#include <thread>
 
 #include "common/buffer/buffer_impl.h"
 #include "common/buffer/watermark_buffer.h"
@@ -281,6 +282,46 @@ TEST_P(WatermarkBufferTest, MoveBackWithWatermarks) {
   EXPECT_EQ(1, low_watermark_buffer1);
 }
 
+TEST_P(WatermarkBufferTest, TotalBufferedBytes) {
+  // The pending changes of this thread, before and after, each are less than a 64KiB batch.
+  const uint64_t tolerance = 128 * 1024;
+  const uint64_t initial = WatermarkBuffer::totalBufferedBytes();
+  {
+    WatermarkBuffer buffer([]() -> void {}, []() -> void {});
+    verifyImplementation(buffer);
+    buffer.add(std::string(1024 * 1024, 'a'));
+    EXPECT_GE(WatermarkBuffer::totalBufferedBytes() + tolerance, initial + 1024 * 1024);
+    EXPECT_LE(WatermarkBuffer::totalBufferedBytes(), initial + 1024 * 1024 + tolerance);
+
+    buffer.drain(512 * 1024);
+    EXPECT_GE(WatermarkBuffer::totalBufferedBytes() + tolerance, initial + 512 * 1024);
+    EXPECT_LE(WatermarkBuffer::totalBufferedBytes(), initial + 512 * 1024 + tolerance);
+  }
+  EXPECT_LE(WatermarkBuffer::totalBufferedBytes(), initial + tolerance);
+}
+
+TEST_P(WatermarkBufferTest, ThreadBufferedBytes) {
+  const uint64_t initial = WatermarkBuffer::threadBufferedBytes();
+  {
+    WatermarkBuffer buffer([]() -> void {}, []() -> void {});
+    verifyImplementation(buffer);
+    buffer.add("abcdef");
+    EXPECT_EQ(initial + 6, WatermarkBuffer::threadBufferedBytes());
+    buffer.drain(2);
+    EXPECT_EQ(initial + 4, WatermarkBuffer::threadBufferedBytes());
+
+    // The bytes added on another thread are accounted to that thread.
+    std::thread thread([]() -> void {
+      WatermarkBuffer other_buffer([]() -> void {}, []() -> void {});
+      other_buffer.add("abc");
+      EXPECT_EQ(3, WatermarkBuffer::threadBufferedBytes());
+    });
+    thread.join();
+    EXPECT_EQ(initial + 4, WatermarkBuffer::threadBufferedBytes());
+  }
+  EXPECT_EQ(initial, WatermarkBuffer::threadBufferedBytes());
+}
+
 } // namespace
 } // namespace Buffer
 } // namespace Envoy
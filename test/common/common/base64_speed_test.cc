@@ -0,0 +1,85 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <random>
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/base64.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+
+// NOLINT(namespace-envoy)
+
+// Adds random bytes, split into slices of 16 KiB as a body read from a connection would be.
+static void addRandomBytes(Buffer::Instance& buffer, uint64_t length) {
+  static std::mt19937 prng(1); // PRNG with a fixed seed, for repeatability
+  std::string bytes(length, '\0');
+  for (char& c : bytes) {
+    c = static_cast<char>(prng());
+  }
+  for (uint64_t offset = 0; offset < length; offset += 16384) {
+    Buffer::OwnedImpl slice(absl::string_view(bytes).substr(offset, 16384));
+    buffer.move(slice);
+  }
+}
+
+static void BM_Base64EncodeString(benchmark::State& state) {
+  Buffer::OwnedImpl buffer;
+  addRandomBytes(buffer, state.range(0));
+  const std::string input = buffer.toString();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Base64::encode(input.data(), input.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Base64EncodeString)->Arg(64)->Arg(4096)->Arg(1 << 20);
+
+static void BM_Base64EncodeBuffer(benchmark::State& state) {
+  Buffer::OwnedImpl input;
+  addRandomBytes(input, state.range(0));
+  for (auto _ : state) {
+    Buffer::OwnedImpl output;
+    Base64::encode(input, input.length(), output);
+    benchmark::DoNotOptimize(output.length());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Base64EncodeBuffer)->Arg(64)->Arg(4096)->Arg(1 << 20);
+
+static void BM_Base64DecodeString(benchmark::State& state) {
+  Buffer::OwnedImpl buffer;
+  addRandomBytes(buffer, state.range(0));
+  const std::string input = Base64::encode(buffer, buffer.length());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Base64::decode(input));
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_Base64DecodeString)->Arg(64)->Arg(4096)->Arg(1 << 20);
+
+static void BM_Base64DecodeBuffer(benchmark::State& state) {
+  Buffer::OwnedImpl buffer;
+  addRandomBytes(buffer, state.range(0));
+  Buffer::OwnedImpl input;
+  Base64::encode(buffer, buffer.length(), input);
+  for (auto _ : state) {
+    Buffer::OwnedImpl output;
+    benchmark::DoNotOptimize(Base64::decode(input, output));
+  }
+  state.SetBytesProcessed(state.iterations() * input.length());
+}
+BENCHMARK(BM_Base64DecodeBuffer)->Arg(64)->Arg(4096)->Arg(1 << 20);
+
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -132,6 +132,61 @@ TEST(Base64Test, BinaryBufferEncode) {
   EXPECT_EQ("AAECAwgKCQCqvN4=", Base64::encode(buffer, 30));
 }
 
+TEST(Base64Test, BufferToBufferEncode) {
+  Buffer::OwnedImpl input;
+  input.add("\0\1\2\3", 4);
+  input.add("\b\n\t", 4);
+  input.add("\xaa\xbc\xde", 3);
+  Buffer::OwnedImpl output("prefix");
+  Base64::encode(input, 0, output);
+  EXPECT_EQ("prefix", output.toString());
+  Base64::encode(input, 7, output);
+  EXPECT_EQ("prefixAAECAwgKCQ==", output.toString());
+  Base64::encode(input, 30, output);
+  EXPECT_EQ("prefixAAECAwgKCQ==AAECAwgKCQCqvN4=", output.toString());
+  // The input is left unchanged.
+  EXPECT_EQ(11, input.length());
+}
+
+TEST(Base64Test, BufferToBufferDecode) {
+  {
+    Buffer::OwnedImpl input;
+    Buffer::OwnedImpl output;
+    EXPECT_TRUE(Base64::decode(input, output));
+    EXPECT_EQ(0, output.length());
+  }
+
+  {
+    // Blocks spanning several slices, followed by a padded one.
+    Buffer::OwnedImpl input;
+    input.add("AAE", 3);
+    input.add("CAw", 3);
+    input.add("gKC", 3);
+    input.add("Q==", 3);
+    Buffer::OwnedImpl output("prefix");
+    EXPECT_TRUE(Base64::decode(input, output));
+    EXPECT_EQ(std::string("prefix\0\1\2\3\b\n\t", 13), output.toString());
+  }
+
+  {
+    const std::string test_string(1000, 'a');
+    Buffer::OwnedImpl input(Base64::encode(test_string.data(), test_string.size()));
+    Buffer::OwnedImpl output;
+    EXPECT_TRUE(Base64::decode(input, output));
+    EXPECT_EQ(test_string, output.toString());
+  }
+}
+
+TEST(Base64Test, BufferToBufferDecodeFailure) {
+  for (const std::string& input_string :
+       {"==Zg", "Zm=8", "Zg=A", "Zh==", "Zm9=", "Zg..", "A===", "====", "123", "Zg==Zg=="}) {
+    Buffer::OwnedImpl input(input_string);
+    Buffer::OwnedImpl output("prefix");
+    EXPECT_FALSE(Base64::decode(input, output)) << input_string;
+    EXPECT_EQ("prefix", output.toString());
+  }
+}
+
 TEST(Base64UrlTest, EncodeString) {
   EXPECT_EQ("", Base64Url::encode("", 0));
   EXPECT_EQ("AAA", Base64Url::encode("\0\0", 2));
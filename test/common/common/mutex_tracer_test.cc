@@ -1,5 +1,7 @@
 #include <chrono>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "common/common/lock_guard.h"
 #include "common/common/mutex_tracer_impl.h"
@@ -17,14 +19,63 @@ protected:
   void SetUp() override { tracer_.reset(); }
 
   // Since MutexTracerImpl::contentionHook is a private method, MutexTracerTest is a friend class.
-  void sendWaitCyclesToContentionHook(int64_t wait_cycles) {
-    tracer_.contentionHook(nullptr, nullptr, wait_cycles);
+  void sendWaitCyclesToContentionHook(int64_t wait_cycles, const void* mutex = nullptr) {
+    tracer_.contentionHook(nullptr, mutex, wait_cycles);
+  }
+
+  const MutexTracer::NamedContention* findNamedContention(const std::string& name) {
+    named_contentions_ = tracer_.namedContentions();
+    for (const auto& contention : named_contentions_) {
+      if (contention.name_ == name) {
+        return &contention;
+      }
+    }
+    return nullptr;
   }
 
   Thread::MutexBasicLockable mu_;
   MutexTracerImpl& tracer_{MutexTracerImpl::getOrCreateTracer()};
+  std::vector<MutexTracer::NamedContention> named_contentions_;
 };
 
+// Contentions of named mutexes are also counted by name.
+TEST_F(MutexTracerTest, NamedMutexes) {
+  Thread::MutexBasicLockable mu2;
+  Thread::MutexBasicLockable mu3;
+  {
+    MutexContentionName name1(mu_.contentionId(), "test.one");
+    MutexContentionName name2(mu2.contentionId(), "test.two");
+    MutexContentionName name3(mu3.contentionId(), "test.two");
+
+    sendWaitCyclesToContentionHook(100, mu_.contentionId());
+    sendWaitCyclesToContentionHook(3000, mu2.contentionId());
+    sendWaitCyclesToContentionHook(1 << 30, mu3.contentionId());
+    sendWaitCyclesToContentionHook(5);
+  }
+  // Mutexes are no longer counted once their name is gone.
+  sendWaitCyclesToContentionHook(7, mu_.contentionId());
+
+  EXPECT_EQ(5, tracer_.numContentions());
+
+  const MutexTracer::NamedContention* one = findNamedContention("test.one");
+  ASSERT_NE(nullptr, one);
+  EXPECT_EQ(1, one->num_contentions_);
+  EXPECT_EQ(100, one->lifetime_wait_cycles_);
+  ASSERT_EQ(16, one->wait_cycles_histogram_.size());
+  EXPECT_EQ(1, one->wait_cycles_histogram_[0]);
+
+  const MutexTracer::NamedContention* two = findNamedContention("test.two");
+  ASSERT_NE(nullptr, two);
+  EXPECT_EQ(2, two->num_contentions_);
+  EXPECT_EQ(3000 + (1 << 30), two->lifetime_wait_cycles_);
+  // 3000 cycles is under 2^12, and 2^30 cycles is beyond the last bound.
+  EXPECT_EQ(1, two->wait_cycles_histogram_[2]);
+  EXPECT_EQ(1, two->wait_cycles_histogram_[15]);
+
+  tracer_.reset();
+  EXPECT_EQ(0, findNamedContention("test.two")->num_contentions_);
+}
+
 // Call the contention hook manually.
 TEST_F(MutexTracerTest, AddN) {
   EXPECT_EQ(tracer_.numContentions(), 0);
@@ -0,0 +1,108 @@
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/regex.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Regex {
+namespace {
+
+TEST(Re2UtilityTest, Compatible) {
+  EXPECT_TRUE(Re2Utility::compatible("/foo/[a-z]+/\\d{2,4}"));
+  EXPECT_TRUE(Re2Utility::compatible("\\w\\W\\s\\S\\d\\D\\b\\B\\f\\n\\r\\t\\v\\x41"));
+  EXPECT_TRUE(Re2Utility::compatible("\\/\\.\\-\\\\"));
+  // Literal letters for std::regex, but assertions or character classes for RE2.
+  EXPECT_FALSE(Re2Utility::compatible("\\A"));
+  EXPECT_FALSE(Re2Utility::compatible("\\z"));
+  EXPECT_FALSE(Re2Utility::compatible("\\Qa\\E"));
+  EXPECT_FALSE(Re2Utility::compatible("\\pN"));
+  // A back reference for std::regex, but an octal escape for RE2.
+  EXPECT_FALSE(Re2Utility::compatible("(a)\\1"));
+  EXPECT_FALSE(Re2Utility::compatible("a\\"));
+}
+
+TEST(Re2UtilityTest, CanMatch) {
+  EXPECT_TRUE(Re2Utility::canMatch("foo bar"));
+  EXPECT_FALSE(Re2Utility::canMatch("foo\vbar"));
+}
+
+TEST(PrefilteredRegexTest, InvalidRegex) {
+  EXPECT_THROW_WITH_REGEX(PrefilteredRegex("*"), EnvoyException, "Invalid regex '\\*'");
+}
+
+// The result is that of std::regex for patterns RE2 supports, patterns it does not and patterns
+// it interprets differently.
+TEST(PrefilteredRegexTest, MatchesAsStdRegex) {
+  const std::vector<std::string> patterns{
+      "/foo/[a-z]+/\\d{2,4}", "a.c",     "a\\sb",        "a[\\s]b", "(a|ab)(c|bcd)",
+      "\\Qa",                 "(a)\\1",  "(?=a)[a-z]+", "",        "a*",
+      "[^a]b",                "\\x41+$", "^(foo|bar)$"};
+  const std::vector<std::string> values{"",
+                                        "a",
+                                        "/foo/bar/123",
+                                        "/foo/bar/1",
+                                        "abc",
+                                        "a\nc",
+                                        "a\rc",
+                                        "a b",
+                                        "a\vb",
+                                        "abcd",
+                                        "Qa",
+                                        "aa",
+                                        "ai",
+                                        "AAA",
+                                        std::string("\xff") + "b",
+                                        "foo",
+                                        "foobar"};
+  for (const std::string& pattern : patterns) {
+    const PrefilteredRegex regex(pattern);
+    const std::regex expected(pattern);
+    for (const std::string& value : values) {
+      EXPECT_EQ(std::regex_match(value, expected), regex.matches(value))
+          << "pattern '" << pattern << "' value '" << value << "'";
+    }
+  }
+}
+
+TEST(PrefilterSetTest, Empty) {
+  PrefilterSet set;
+  set.compile();
+  std::vector<int> indices{1};
+  EXPECT_TRUE(set.match("/foo", indices));
+  EXPECT_TRUE(indices.empty());
+}
+
+TEST(PrefilterSetTest, Match) {
+  PrefilterSet set;
+  EXPECT_TRUE(set.add("/foo/.*"));
+  EXPECT_FALSE(set.add("(?=/)/bar"));
+  EXPECT_FALSE(set.add("\\A/bar"));
+  EXPECT_TRUE(set.add("/[a-z]+/bar"));
+  EXPECT_TRUE(set.add("/foo/bar"));
+  EXPECT_EQ(3, set.size());
+  set.compile();
+
+  std::vector<int> indices;
+  EXPECT_TRUE(set.match("/foo/bar", indices));
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), indices);
+  EXPECT_TRUE(set.match("/baz/bar", indices));
+  EXPECT_EQ((std::vector<int>{1}), indices);
+  EXPECT_TRUE(set.match("/foo/bar?x", indices));
+  EXPECT_EQ((std::vector<int>{0}), indices);
+  EXPECT_TRUE(set.match("/bar", indices));
+  EXPECT_TRUE(indices.empty());
+  // Values RE2 may match differently from std::regex are not matched against the set.
+  EXPECT_FALSE(set.match("/foo/\v", indices));
+  EXPECT_TRUE(indices.empty());
+}
+
+} // namespace
+} // namespace Regex
+} // namespace Envoy
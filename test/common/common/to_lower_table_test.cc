@@ -26,5 +26,27 @@ TEST(ToLowerTableTest, All) {
     table.toLowerCase(input);
     EXPECT_EQ(input, "\x90hello\x90");
   }
+  {
+    // Longer strings are converted a word at a time, then byte by byte.
+    std::string input("X-Forwarded-For@[`{\xc1\xdaZ");
+    table.toLowerCase(input);
+    EXPECT_EQ(input, "x-forwarded-for@[`{\xc1\xdaz");
+  }
+}
+
+TEST(ToLowerTableTest, AllBytes) {
+  ToLowerTable table;
+  std::string input;
+  std::string expected;
+  for (int c = 0; c < 256; c++) {
+    input.push_back(static_cast<char>(c));
+    expected.push_back(static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c));
+  }
+  // Convert at each rotation, so every byte is converted at each position within a word.
+  for (size_t offset = 0; offset < 8; offset++) {
+    std::string rotated = input.substr(offset) + input.substr(0, offset);
+    table.toLowerCase(rotated);
+    EXPECT_EQ(expected.substr(offset) + expected.substr(0, offset), rotated);
+  }
 }
 } // namespace Envoy
@@ -0,0 +1,70 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/compressor/zlib_compressor_pool.h"
+#include "common/decompressor/zlib_decompressor_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Compressor {
+namespace {
+
+class ZlibCompressorPoolTest : public testing::Test {
+protected:
+  // Compresses random data with a compressor of the pool, and checks that it decompresses back.
+  void compressAndVerify(ZlibCompressorImpl& compressor) {
+    Buffer::OwnedImpl buffer;
+    TestUtility::feedBufferWithRandomCharacters(buffer, 4096);
+    const std::string expected = buffer.toString();
+    compressor.compress(buffer, State::Finish);
+
+    Decompressor::ZlibDecompressorImpl decompressor;
+    decompressor.init(31);
+    Buffer::OwnedImpl decompressed;
+    decompressor.decompress(buffer, decompressed);
+    EXPECT_EQ(expected, decompressed.toString());
+  }
+
+  ZlibCompressorPool pool_{ZlibCompressorImpl::CompressionLevel::Standard,
+                           ZlibCompressorImpl::CompressionStrategy::Standard, 31, 8, 1};
+};
+
+// A released compressor is reset and handed out again.
+TEST_F(ZlibCompressorPoolTest, Reuse) {
+  ZlibCompressorImplPtr compressor = pool_.acquire();
+  ZlibCompressorImpl* first = compressor.get();
+  compressAndVerify(*compressor);
+  pool_.release(std::move(compressor));
+  EXPECT_EQ(1, pool_.size());
+
+  compressor = pool_.acquire();
+  EXPECT_EQ(first, compressor.get());
+  EXPECT_EQ(0, pool_.size());
+  compressAndVerify(*compressor);
+}
+
+// A compressor released in the middle of a stream starts a new one once reused.
+TEST_F(ZlibCompressorPoolTest, ReleaseUnfinished) {
+  ZlibCompressorImplPtr compressor = pool_.acquire();
+  Buffer::OwnedImpl buffer;
+  TestUtility::feedBufferWithRandomCharacters(buffer, 1024);
+  compressor->compress(buffer, State::Flush);
+  pool_.release(std::move(compressor));
+
+  compressAndVerify(*pool_.acquire());
+}
+
+// Compressors beyond the maximum size of the pool are freed.
+TEST_F(ZlibCompressorPoolTest, MaxSize) {
+  ZlibCompressorImplPtr first = pool_.acquire();
+  ZlibCompressorImplPtr second = pool_.acquire();
+  EXPECT_NE(first.get(), second.get());
+  pool_.release(std::move(first));
+  pool_.release(std::move(second));
+  EXPECT_EQ(1, pool_.size());
+}
+
+} // namespace
+} // namespace Compressor
+} // namespace Envoy
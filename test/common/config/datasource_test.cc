@@ -7,6 +7,7 @@
 
 #include "test/mocks/server/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/environment.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -374,6 +375,40 @@ TEST_F(AsyncDataSourceTest, loadRemoteDataSourceExpectInvalidData) {
   EXPECT_CALL(init_watcher_, ready());
 }
 
+TEST(ReadSharedTest, SmallFileAndInline) {
+  Api::ApiPtr api = Api::createApiForTest();
+  envoy::api::v2::core::DataSource source;
+  source.set_inline_string("inline");
+  EXPECT_EQ("inline", DataSource::readShared(source, false, *api)->data());
+
+  source.set_filename(TestEnvironment::writeStringToFileForTest("small", "small"));
+  EXPECT_EQ("small", DataSource::readShared(source, false, *api)->data());
+
+  source.set_filename("/nonexistent");
+  EXPECT_THROW_WITH_MESSAGE(DataSource::readShared(source, false, *api), EnvoyException,
+                            "unable to read file: /nonexistent");
+}
+
+// A large file is mapped once and shared by its readers until it is replaced.
+TEST(ReadSharedTest, LargeFileMappedAndShared) {
+  Api::ApiPtr api = Api::createApiForTest();
+  const std::string first(DataSource::MinMappedFileSize, 'a');
+  envoy::api::v2::core::DataSource source;
+  source.set_filename(TestEnvironment::writeStringToFileForTest("large", first));
+
+  DataSource::ContentsConstSharedPtr contents = DataSource::readShared(source, false, *api);
+  EXPECT_EQ(first, contents->data());
+  DataSource::ContentsConstSharedPtr shared = DataSource::readShared(source, false, *api);
+  EXPECT_EQ(contents->data().data(), shared->data().data());
+
+  // The readers of the replaced file keep its contents.
+  const std::string second(DataSource::MinMappedFileSize + 1, 'b');
+  TestEnvironment::writeStringToFileForTest("large", second);
+  DataSource::ContentsConstSharedPtr replaced = DataSource::readShared(source, false, *api);
+  EXPECT_EQ(second, replaced->data());
+  EXPECT_EQ(first, contents->data());
+}
+
 } // namespace
 } // namespace Config
 } // namespace Envoy
\ No newline at end of file
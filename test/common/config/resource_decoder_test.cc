@@ -0,0 +1,104 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/api/v2/cds.pb.h"
+#include "envoy/api/v2/cds.pb.validate.h"
+
+#include "common/api/api_impl.h"
+#include "common/config/resource_decoder.h"
+#include "common/protobuf/utility.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+// Counts the unknown fields without synchronization of its own.
+class CountingValidationVisitor : public ProtobufMessage::ValidationVisitor {
+public:
+  void onUnknownField(absl::string_view) override { unknown_fields_++; }
+
+  uint64_t unknown_fields_{};
+};
+
+class ResourceDecoderTest : public testing::Test {
+protected:
+  ResourceDecoderTest() : api_(Api::createApiForTest(store_)) {}
+
+  static ProtobufWkt::Any validCluster(size_t index) {
+    envoy::api::v2::Cluster cluster;
+    cluster.set_name(absl::StrCat("cluster_", index));
+    cluster.mutable_connect_timeout()->set_seconds(1);
+    ProtobufWkt::Any any;
+    any.PackFrom(cluster);
+    return any;
+  }
+
+  std::vector<DecodedResource<envoy::api::v2::Cluster>>
+  decode(ResourceDecoder& decoder, const std::vector<ProtobufWkt::Any>& resources) {
+    return decoder.decode<envoy::api::v2::Cluster>(
+        resources.size(),
+        [&resources](size_t i) -> const ProtobufWkt::Any& { return resources[i]; },
+        validation_visitor_);
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  Api::ApiPtr api_;
+  CountingValidationVisitor validation_visitor_;
+};
+
+// Resources which cannot be unpacked, or are invalid, are reported on their own.
+TEST_F(ResourceDecoderTest, Errors) {
+  ResourceDecoder decoder(*api_, store_, "control_plane.cds.");
+
+  std::vector<ProtobufWkt::Any> resources;
+  resources.push_back(validCluster(0));
+  envoy::api::v2::Cluster invalid_cluster;
+  invalid_cluster.set_name("invalid");
+  resources.emplace_back();
+  resources.back().PackFrom(invalid_cluster);
+  resources.push_back(validCluster(2));
+  resources.back().set_value("garbage");
+
+  const auto decoded = decode(decoder, resources);
+  ASSERT_EQ(3, decoded.size());
+  EXPECT_TRUE(decoded[0].unpacked_);
+  EXPECT_EQ(nullptr, decoded[0].error_);
+  EXPECT_EQ("cluster_0", decoded[0].resource_.name());
+  EXPECT_TRUE(decoded[1].unpacked_);
+  EXPECT_EQ("invalid", decoded[1].resource_.name());
+  EXPECT_THROW(std::rethrow_exception(decoded[1].error_), ProtoValidationException);
+  EXPECT_FALSE(decoded[2].unpacked_);
+  EXPECT_THROW_WITH_REGEX(std::rethrow_exception(decoded[2].error_), EnvoyException,
+                          "Unable to unpack");
+}
+
+// Large updates are decoded on several threads, in order, sharing the validation visitor.
+TEST_F(ResourceDecoderTest, Parallel) {
+  ResourceDecoder decoder(*api_, store_, "control_plane.cds.", 4);
+
+  std::vector<ProtobufWkt::Any> resources;
+  const size_t count = 4 * ResourceDecoder::MinResourcesPerThread + 3;
+  for (size_t i = 0; i < count; i++) {
+    resources.push_back(validCluster(i));
+    // An unknown varint field, number 1000.
+    resources.back().mutable_value()->append("\xc0\x3e\x01");
+  }
+
+  const auto decoded = decode(decoder, resources);
+  ASSERT_EQ(count, decoded.size());
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_EQ(nullptr, decoded[i].error_);
+    EXPECT_EQ(absl::StrCat("cluster_", i), decoded[i].resource_.name());
+  }
+  EXPECT_EQ(count, validation_visitor_.unknown_fields_);
+}
+
+} // namespace
+} // namespace Config
+} // namespace Envoy
@@ -1,4 +1,6 @@
 #include <functional>
+#include <numeric>
+#include <vector>
 
 #include "envoy/thread/thread.h"
 
@@ -10,6 +12,7 @@
 
 #include "test/mocks/common.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -17,6 +20,7 @@
 
 using testing::_;
 using testing::InSequence;
+using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 using testing::StartsWith;
@@ -98,11 +102,141 @@ protected:
 // TODO(mergeconflict): We also need integration testing to validate that the expected histograms
 // are written when `enable_dispatcher_stats` is true. See issue #6582.
 TEST_F(DispatcherImplTest, InitializeStats) {
+  EXPECT_CALL(scope_, histogram("test.dispatcher.admin_post_delay_us"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.admin_post_duration_us"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.background_post_delay_us"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.background_post_duration_us"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.callbacks_per_loop"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.control_plane_post_delay_us"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.control_plane_post_duration_us"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.health_check_post_delay_us"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.health_check_post_duration_us"));
   EXPECT_CALL(scope_, histogram("test.dispatcher.loop_duration_us"));
   EXPECT_CALL(scope_, histogram("test.dispatcher.poll_delay_us"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.timer_delay_us"));
   dispatcher_->initializeStats(scope_, "test.");
 }
 
+// A timer that fires records how late it ran, and each loop iteration records the callbacks it
+// ran.
+TEST(DispatcherStatsTest, TimerDelayAndCallbacksPerLoop) {
+  NiceMock<Stats::MockStore> store;
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher());
+  dispatcher->initializeStats(store, "test.");
+  // Run the posted stats initialization.
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+
+  std::vector<uint64_t> callbacks_per_loop;
+  uint32_t timer_delays = 0;
+  EXPECT_CALL(store, deliverHistogramToSinks(_, _))
+      .WillRepeatedly(Invoke([&](const Stats::Histogram& histogram, uint64_t value) {
+        if (histogram.name() == "test.dispatcher.callbacks_per_loop") {
+          callbacks_per_loop.push_back(value);
+        } else if (histogram.name() == "test.dispatcher.timer_delay_us") {
+          timer_delays++;
+        }
+      }));
+
+  // The timer fires in two loop iterations, and the second one exits after it.
+  uint32_t fired = 0;
+  TimerPtr timer;
+  timer = dispatcher->createTimer([&]() {
+    if (++fired == 1) {
+      timer->enableTimer(std::chrono::milliseconds(1));
+    } else {
+      dispatcher->exit();
+    }
+  });
+  timer->enableTimer(std::chrono::milliseconds(1));
+  dispatcher->run(Dispatcher::RunType::Block);
+
+  EXPECT_EQ(2, fired);
+  EXPECT_EQ(2, timer_delays);
+  // The iterations are recorded when the next one starts, so the last one is not, and any
+  // iteration that woke up early ran no callbacks.
+  EXPECT_EQ(1, std::accumulate(callbacks_per_loop.begin(), callbacks_per_loop.end(), 0));
+}
+
+// Each posted callback records how long it waited and ran under its priority.
+TEST(DispatcherStatsTest, PostDelayAndDuration) {
+  NiceMock<Stats::MockStore> store;
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher());
+  dispatcher->initializeStats(store, "test.");
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+
+  std::vector<std::string> recorded;
+  EXPECT_CALL(store, deliverHistogramToSinks(_, _))
+      .WillRepeatedly(Invoke([&](const Stats::Histogram& histogram, uint64_t) {
+        if (histogram.name().find("_post_") != std::string::npos) {
+          recorded.push_back(histogram.name());
+        }
+      }));
+
+  dispatcher->post([]() {}, PostPriority::HealthCheck);
+  dispatcher->post([]() {});
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+  EXPECT_EQ((std::vector<std::string>{"test.dispatcher.control_plane_post_delay_us",
+                                      "test.dispatcher.control_plane_post_duration_us",
+                                      "test.dispatcher.health_check_post_delay_us",
+                                      "test.dispatcher.health_check_post_duration_us"}),
+            recorded);
+}
+
+// Pending callbacks run by priority, and in the order they were posted within a priority,
+// including the callbacks posted while running the others.
+TEST(DispatcherPostPriorityTest, RunByPriority) {
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher());
+
+  std::vector<std::string> ran;
+  dispatcher->post([&]() { ran.push_back("background"); }, PostPriority::Background);
+  dispatcher->post([&]() { ran.push_back("admin 1"); }, PostPriority::Admin);
+  dispatcher->post(
+      [&]() {
+        ran.push_back("health check");
+        dispatcher->post([&]() { ran.push_back("control plane 2"); });
+      },
+      PostPriority::HealthCheck);
+  dispatcher->post([&]() { ran.push_back("admin 2"); }, PostPriority::Admin);
+  dispatcher->post([&]() { ran.push_back("control plane 1"); });
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+
+  EXPECT_EQ((std::vector<std::string>{"control plane 1", "health check", "control plane 2",
+                                      "admin 1", "admin 2", "background"}),
+            ran);
+}
+
+// The approximate time does not change while callbacks run, and is updated when the event loop
+// returns from polling.
+TEST(DispatcherApproximateTimeTest, UpdatedAfterPolling) {
+  Event::TestRealTimeSystem real_time;
+  Api::ApiPtr api = Api::createApiForTest(real_time);
+  DispatcherPtr dispatcher(api->allocateDispatcher());
+  const MonotonicTime created = dispatcher->approximateMonotonicTime();
+
+  MonotonicTime first_fired;
+  uint32_t fired = 0;
+  TimerPtr timer;
+  timer = dispatcher->createTimer([&]() {
+    if (++fired == 1) {
+      first_fired = dispatcher->approximateMonotonicTime();
+      EXPECT_LE(created, first_fired);
+      EXPECT_LE(first_fired, api->timeSource().monotonicTime());
+      real_time.sleep(std::chrono::milliseconds(1));
+      EXPECT_EQ(first_fired, dispatcher->approximateMonotonicTime());
+      timer->enableTimer(std::chrono::milliseconds(0));
+    } else {
+      EXPECT_LE(first_fired + std::chrono::milliseconds(1), dispatcher->approximateMonotonicTime());
+      dispatcher->exit();
+    }
+  });
+  timer->enableTimer(std::chrono::milliseconds(1));
+  dispatcher->run(Dispatcher::RunType::Block);
+  EXPECT_EQ(2, fired);
+}
+
 TEST_F(DispatcherImplTest, Post) {
   dispatcher_->post([this]() {
     {
@@ -0,0 +1,200 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/event/libevent_scheduler.h"
+#include "common/event/timer_wheel.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+// Counts how often the wheel arms its tick timer.
+class CountingScheduler : public Scheduler {
+public:
+  explicit CountingScheduler(Scheduler& scheduler) : scheduler_(scheduler) {}
+
+  // Scheduler
+  TimerPtr createTimer(const TimerCb& cb) override {
+    return std::make_unique<CountingTimer>(scheduler_.createTimer(cb), enables_);
+  }
+
+  uint64_t enables() const { return enables_; }
+
+private:
+  class CountingTimer : public Timer {
+  public:
+    CountingTimer(TimerPtr timer, uint64_t& enables)
+        : timer_(std::move(timer)), enables_(enables) {}
+
+    // Timer
+    void disableTimer() override { timer_->disableTimer(); }
+    void enableTimer(const std::chrono::milliseconds& d) override {
+      enables_++;
+      timer_->enableTimer(d);
+    }
+    bool enabled() override { return timer_->enabled(); }
+
+  private:
+    TimerPtr timer_;
+    uint64_t& enables_;
+  };
+
+  Scheduler& scheduler_;
+  uint64_t enables_{};
+};
+
+class TimerWheelTest : public testing::Test {
+protected:
+  TimerWheelTest()
+      : scheduler_(time_system_.createScheduler(base_scheduler_)), counting_scheduler_(*scheduler_),
+        wheel_(counting_scheduler_, time_system_, std::chrono::milliseconds(4)) {}
+
+  TimerPtr addTimer(std::chrono::milliseconds timeout, char marker) {
+    TimerPtr timer = wheel_.createTimer([this, marker]() { output_.append(1, marker); });
+    timer->enableTimer(timeout);
+    return timer;
+  }
+
+  template <class Duration> void sleepAndLoop(Duration duration) {
+    time_system_.sleep(duration);
+    base_scheduler_.run(Dispatcher::RunType::NonBlock);
+  }
+
+  LibeventScheduler base_scheduler_;
+  SimulatedTimeSystem time_system_;
+  SchedulerPtr scheduler_;
+  CountingScheduler counting_scheduler_;
+  TimerWheel wheel_;
+  std::string output_;
+};
+
+TEST_F(TimerWheelTest, FiresWithinOneResolution) {
+  TimerPtr timer = addTimer(std::chrono::milliseconds(10), 'a');
+  EXPECT_TRUE(timer->enabled());
+  EXPECT_EQ(1, wheel_.armedTimers());
+
+  // Never early.
+  sleepAndLoop(std::chrono::milliseconds(9));
+  EXPECT_EQ("", output_);
+  // At most one resolution late.
+  sleepAndLoop(std::chrono::milliseconds(5));
+  EXPECT_EQ("a", output_);
+  EXPECT_FALSE(timer->enabled());
+  EXPECT_EQ(0, wheel_.armedTimers());
+}
+
+TEST_F(TimerWheelTest, ZeroTimeoutFiresOnNextTick) {
+  TimerPtr timer = addTimer(std::chrono::milliseconds(0), 'a');
+  base_scheduler_.run(Dispatcher::RunType::NonBlock);
+  EXPECT_EQ("", output_);
+  sleepAndLoop(std::chrono::milliseconds(4));
+  EXPECT_EQ("a", output_);
+}
+
+TEST_F(TimerWheelTest, DisableAndReset) {
+  TimerPtr first = addTimer(std::chrono::milliseconds(20), 'a');
+  TimerPtr second = addTimer(std::chrono::milliseconds(20), 'b');
+  first->disableTimer();
+  EXPECT_FALSE(first->enabled());
+  EXPECT_EQ(1, wheel_.armedTimers());
+  // Disabling twice is harmless.
+  first->disableTimer();
+  EXPECT_EQ(1, wheel_.armedTimers());
+
+  // Resetting pushes the timeout back.
+  sleepAndLoop(std::chrono::milliseconds(12));
+  second->enableTimer(std::chrono::milliseconds(20));
+  EXPECT_EQ(1, wheel_.armedTimers());
+  sleepAndLoop(std::chrono::milliseconds(12));
+  EXPECT_EQ("", output_);
+  sleepAndLoop(std::chrono::milliseconds(12));
+  EXPECT_EQ("b", output_);
+
+  // Freeing an armed timer disarms it.
+  TimerPtr third = addTimer(std::chrono::milliseconds(4), 'c');
+  third.reset();
+  EXPECT_EQ(0, wheel_.armedTimers());
+  sleepAndLoop(std::chrono::milliseconds(8));
+  EXPECT_EQ("b", output_);
+}
+
+// Timeouts in each level of the wheel and beyond its range fire in order, never early and at most
+// one resolution late.
+TEST_F(TimerWheelTest, CascadesAcrossLevels) {
+  const std::vector<std::chrono::milliseconds> timeouts = {
+      std::chrono::milliseconds(100), std::chrono::seconds(5), std::chrono::minutes(10),
+      std::chrono::hours(10), std::chrono::hours(40)};
+  std::vector<TimerPtr> timers;
+  for (size_t i = 0; i < timeouts.size(); i++) {
+    timers.push_back(addTimer(timeouts[i], static_cast<char>('a' + i)));
+  }
+
+  std::chrono::milliseconds now(0);
+  std::string expected;
+  for (size_t i = 0; i < timeouts.size(); i++) {
+    sleepAndLoop(timeouts[i] - std::chrono::milliseconds(1) - now);
+    EXPECT_EQ(expected, output_);
+    sleepAndLoop(std::chrono::milliseconds(5));
+    now = timeouts[i] + std::chrono::milliseconds(4);
+    expected.append(1, static_cast<char>('a' + i));
+    EXPECT_EQ(expected, output_);
+  }
+  EXPECT_EQ(0, wheel_.armedTimers());
+}
+
+// The tick timer is armed for the next occupied slot, not for every tick, so a distant timeout
+// only wakes the wheel when its slot is cascaded or expires.
+TEST_F(TimerWheelTest, TickNotRearmedWhileSlotsAreFar) {
+  TimerPtr timer = addTimer(std::chrono::minutes(10), 'a');
+  EXPECT_EQ(1U, counting_scheduler_.enables());
+
+  for (int i = 0; i < 1000; i++) {
+    sleepAndLoop(std::chrono::milliseconds(4));
+  }
+  EXPECT_EQ(1U, counting_scheduler_.enables());
+
+  // The timer is cascaded from level two to level one on the way.
+  sleepAndLoop(std::chrono::minutes(10) - std::chrono::seconds(4) - std::chrono::milliseconds(1));
+  EXPECT_EQ("", output_);
+  EXPECT_EQ(2U, counting_scheduler_.enables());
+  sleepAndLoop(std::chrono::milliseconds(1));
+  EXPECT_EQ("a", output_);
+  EXPECT_EQ(2U, counting_scheduler_.enables());
+  EXPECT_EQ(0U, wheel_.armedTimers());
+}
+
+// Callbacks may re-arm themselves and disarm or free timers which expire on the same tick.
+TEST_F(TimerWheelTest, CallbacksModifyTimers) {
+  TimerPtr first;
+  TimerPtr second;
+  TimerPtr third;
+  first = wheel_.createTimer([&]() {
+    output_.append("a");
+    first->enableTimer(std::chrono::milliseconds(0));
+    second.reset();
+    third->disableTimer();
+  });
+  first->enableTimer(std::chrono::milliseconds(8));
+  second = addTimer(std::chrono::milliseconds(8), 'b');
+  third = addTimer(std::chrono::milliseconds(8), 'c');
+
+  sleepAndLoop(std::chrono::milliseconds(8));
+  EXPECT_EQ("a", output_);
+  EXPECT_TRUE(first->enabled());
+  EXPECT_FALSE(third->enabled());
+  EXPECT_EQ(1, wheel_.armedTimers());
+
+  sleepAndLoop(std::chrono::milliseconds(4));
+  EXPECT_EQ("aa", output_);
+  first->disableTimer();
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
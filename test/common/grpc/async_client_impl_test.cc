@@ -1,3 +1,4 @@
+#include "common/decompressor/zlib_decompressor_impl.h"
 #include "common/grpc/async_client_impl.h"
 
 #include "test/mocks/http/mocks.h"
@@ -5,6 +6,7 @@
 #include "test/mocks/upstream/mocks.h"
 #include "test/proto/helloworld.pb.h"
 #include "test/test_common/test_time.h"
+#include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -149,6 +151,93 @@ TEST_F(EnvoyAsyncClientImplTest, StreamHttpClientException) {
   EXPECT_TRUE(grpc_stream == nullptr);
 }
 
+// Validate that the messages of at least the minimum size are compressed, and that the messages
+// are sent uncompressed once the service does not accept gzip.
+TEST_F(EnvoyAsyncClientImplTest, StreamCompression) {
+  envoy::api::v2::core::GrpcService config;
+  config.mutable_envoy_grpc()->set_cluster_name("test_cluster");
+  config.mutable_envoy_grpc()->mutable_compression()->mutable_min_message_bytes()->set_value(100);
+  AsyncClient<helloworld::HelloRequest, helloworld::HelloReply> grpc_client(
+      std::make_unique<AsyncClientImpl>(cm_, config, test_time_.timeSystem()));
+
+  MockAsyncStreamCallbacks<helloworld::HelloReply> grpc_callbacks;
+  Http::AsyncClient::StreamCallbacks* http_callbacks;
+  Http::MockAsyncClientStream http_stream;
+  EXPECT_CALL(http_client_, start(_, _))
+      .WillOnce(
+          Invoke([&http_callbacks, &http_stream](Http::AsyncClient::StreamCallbacks& callbacks,
+                                                 const Http::AsyncClient::StreamOptions&) {
+            http_callbacks = &callbacks;
+            return &http_stream;
+          }));
+  EXPECT_CALL(grpc_callbacks, onCreateInitialMetadata(_));
+  EXPECT_CALL(http_stream, sendHeaders(_, false))
+      .WillOnce(Invoke([](Http::HeaderMap& headers, bool) {
+        EXPECT_EQ("gzip", headers.get(Http::Headers::get().GrpcEncoding)->value().getStringView());
+      }));
+  auto grpc_stream = grpc_client->start(*method_descriptor_, grpc_callbacks);
+  ASSERT_NE(grpc_stream, nullptr);
+
+  std::vector<Frame> frames;
+  Decoder decoder;
+  auto decode_frame = [&frames, &decoder](Buffer::Instance& data, bool) {
+    frames.clear();
+    EXPECT_TRUE(decoder.decode(data, frames));
+    EXPECT_EQ(1, frames.size());
+  };
+
+  helloworld::HelloRequest request_msg;
+  request_msg.set_name(std::string(1000, 'a'));
+  EXPECT_CALL(http_stream, sendData(_, false)).WillOnce(Invoke(decode_frame));
+  grpc_stream->sendMessage(request_msg, false);
+  EXPECT_EQ(GRPC_FH_COMPRESSED, frames[0].flags_);
+  EXPECT_LT(frames[0].length_, request_msg.ByteSizeLong());
+  Decompressor::ZlibDecompressorImpl decompressor;
+  decompressor.init(31);
+  Buffer::OwnedImpl decompressed;
+  decompressor.decompress(*frames[0].data_, decompressed);
+  EXPECT_EQ(request_msg.SerializeAsString(), decompressed.toString());
+
+  Stats::Store& stats = cm_.thread_local_cluster_.cluster_.info_->stats_store_;
+  EXPECT_EQ(1, stats.counter("grpc.compression.messages_compressed").value());
+  EXPECT_EQ(request_msg.ByteSizeLong(),
+            stats.counter("grpc.compression.bytes_before_compression").value());
+  EXPECT_EQ(frames[0].length_, stats.counter("grpc.compression.bytes_after_compression").value());
+
+  // Smaller messages are sent uncompressed.
+  request_msg.set_name("a");
+  EXPECT_CALL(http_stream, sendData(_, false)).WillOnce(Invoke(decode_frame));
+  grpc_stream->sendMessage(request_msg, false);
+  EXPECT_EQ(GRPC_FH_DEFAULT, frames[0].flags_);
+  EXPECT_EQ(1, stats.counter("grpc.compression.messages_uncompressed").value());
+
+  // The service does not accept gzip.
+  Http::HeaderMapPtr headers{new Http::TestHeaderMapImpl{
+      {":status", "200"}, {"grpc-accept-encoding", "identity, deflate"}}};
+  EXPECT_CALL(grpc_callbacks, onReceiveInitialMetadata_(_));
+  http_callbacks->onHeaders(std::move(headers), false);
+  request_msg.set_name(std::string(1000, 'a'));
+  EXPECT_CALL(http_stream, sendData(_, false)).WillOnce(Invoke(decode_frame));
+  grpc_stream->sendMessage(request_msg, false);
+  EXPECT_EQ(GRPC_FH_DEFAULT, frames[0].flags_);
+  EXPECT_EQ(1, stats.counter("grpc.compression.messages_compressed").value());
+
+  EXPECT_CALL(http_stream, reset());
+  grpc_stream->resetStream();
+
+  // Later streams are not compressed either.
+  EXPECT_CALL(http_client_, start(_, _)).WillOnce(Return(&http_stream));
+  EXPECT_CALL(grpc_callbacks, onCreateInitialMetadata(_));
+  EXPECT_CALL(http_stream, sendHeaders(_, false))
+      .WillOnce(Invoke([](Http::HeaderMap& headers, bool) {
+        EXPECT_EQ(nullptr, headers.get(Http::Headers::get().GrpcEncoding));
+      }));
+  grpc_stream = grpc_client->start(*method_descriptor_, grpc_callbacks);
+  ASSERT_NE(grpc_stream, nullptr);
+  EXPECT_CALL(http_stream, reset());
+  grpc_stream->resetStream();
+}
+
 } // namespace
 } // namespace Grpc
 } // namespace Envoy
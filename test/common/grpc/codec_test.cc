@@ -169,6 +169,52 @@ TEST(GrpcCodecTest, decodeMultipleFrame) {
   }
 }
 
+// The data of a frame spanning whole slices of the input is moved rather than copied.
+TEST(GrpcCodecTest, decodeMovesSlices) {
+  const std::string data(4096, 'a');
+  std::array<uint8_t, 5> header;
+  Encoder encoder;
+  encoder.newFrame(GRPC_FH_DEFAULT, 2 * data.size(), header);
+
+  Buffer::OwnedImpl buffer;
+  buffer.add(header.data(), 5);
+  for (int i = 0; i < 2; i++) {
+    Buffer::OwnedImpl slice(data);
+    buffer.move(slice);
+  }
+  Buffer::RawSlice input_slices[3];
+  ASSERT_EQ(3, buffer.getRawSlices(input_slices, 3));
+
+  std::vector<Frame> frames;
+  Decoder decoder;
+  EXPECT_TRUE(decoder.decode(buffer, frames));
+  EXPECT_EQ(0, buffer.length());
+  ASSERT_EQ(1, frames.size());
+  Buffer::RawSlice frame_slices[2];
+  ASSERT_EQ(2, frames[0].data_->getRawSlices(frame_slices, 2));
+  EXPECT_EQ(input_slices[1].mem_, frame_slices[0].mem_);
+  EXPECT_EQ(input_slices[2].mem_, frame_slices[1].mem_);
+  EXPECT_EQ(data + data, frames[0].data_->toString());
+}
+
+// The frames decoded before an invalid frame are drained from the input.
+TEST(GrpcCodecTest, decodeInvalidFrameAfterValidFrame) {
+  std::array<uint8_t, 5> header;
+  Encoder encoder;
+  encoder.newFrame(GRPC_FH_DEFAULT, 1, header);
+  Buffer::OwnedImpl buffer;
+  buffer.add(header.data(), 5);
+  buffer.add("a");
+  buffer.add("\x02\x00\x00\x00\x01" "b", 6);
+
+  std::vector<Frame> frames;
+  Decoder decoder;
+  EXPECT_FALSE(decoder.decode(buffer, frames));
+  ASSERT_EQ(1, frames.size());
+  EXPECT_EQ("a", frames[0].data_->toString());
+  EXPECT_EQ(6, buffer.length());
+}
+
 } // namespace
 } // namespace Grpc
 } // namespace Envoy
@@ -55,7 +55,7 @@ public:
     auto* google_grpc = config.mutable_google_grpc();
     google_grpc->set_target_uri("fake_address");
     google_grpc->set_stat_prefix("test_cluster");
-    tls_ = std::make_unique<GoogleAsyncClientThreadLocal>(*api_);
+    tls_ = std::make_unique<GoogleAsyncClientThreadLocal>(*api_, *dispatcher_, 1);
     grpc_client_ = std::make_unique<GoogleAsyncClientImpl>(*dispatcher_, *tls_, stub_factory_,
                                                            scope_, config, *api_);
   }
@@ -109,6 +109,13 @@ TEST_F(EnvoyGoogleAsyncClientImplTest, RequestHttpStartFail) {
   EXPECT_TRUE(grpc_request == nullptr);
 }
 
+// Validate that a completion queue polled by several threads shuts down cleanly.
+TEST_F(EnvoyGoogleAsyncClientImplTest, MultipleCompletionThreads) {
+  auto tls = std::make_unique<GoogleAsyncClientThreadLocal>(*api_, *dispatcher_, 4);
+  tls.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
 } // namespace
 } // namespace Grpc
 } // namespace Envoy
@@ -308,7 +308,7 @@ public:
 
   RawAsyncClientPtr createGoogleAsyncClientImpl() {
 #ifdef ENVOY_GOOGLE_GRPC
-    google_tls_ = std::make_unique<GoogleAsyncClientThreadLocal>(*api_);
+    google_tls_ = std::make_unique<GoogleAsyncClientThreadLocal>(*api_, *dispatcher_, 1);
     GoogleGenericStubFactory stub_factory;
     return std::make_unique<GoogleAsyncClientImpl>(*dispatcher_, *google_tls_, stub_factory,
                                                    stats_scope_, createGoogleGrpcConfig(), *api_);
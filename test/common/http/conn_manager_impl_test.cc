@@ -20,6 +20,7 @@
 #include "common/http/exception.h"
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
+#include "common/memory/allocation_tracker.h"
 #include "common/network/address_impl.h"
 #include "common/network/utility.h"
 #include "common/upstream/upstream_impl.h"
@@ -43,6 +44,7 @@
 #include "test/test_common/printers.h"
 #include "test/test_common/test_time.h"
 
+#include "absl/strings/match.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -93,6 +95,9 @@ public:
 
   ~HttpConnectionManagerImplTest() override {
     filter_callbacks_.connection_.dispatcher_.clearDeferredDeleteList();
+    // The connection manager and its streams refer to the thread local state of the overload
+    // manager, which is destroyed first.
+    conn_manager_.reset();
   }
 
   void setup(bool ssl, const std::string& server_name, bool tracing = true) {
@@ -252,6 +257,7 @@ public:
   bool generateRequestId() override { return true; }
   bool preserveExternalRequestId() const override { return false; }
   uint32_t maxRequestHeadersKb() const override { return max_request_headers_kb_; }
+  uint32_t overloadBufferLimit() const override { return overload_buffer_limit_; }
   absl::optional<std::chrono::milliseconds> idleTimeout() const override { return idle_timeout_; }
   std::chrono::milliseconds streamIdleTimeout() const override { return stream_idle_timeout_; }
   std::chrono::milliseconds requestTimeout() const override { return request_timeout_; }
@@ -308,6 +314,7 @@ public:
   std::vector<Http::ClientCertDetailsType> set_current_client_cert_details_;
   absl::optional<std::string> user_agent_;
   uint32_t max_request_headers_kb_{Http::DEFAULT_MAX_REQUEST_HEADERS_KB};
+  uint32_t overload_buffer_limit_{0};
   absl::optional<std::chrono::milliseconds> idle_timeout_;
   std::chrono::milliseconds stream_idle_timeout_{};
   std::chrono::milliseconds request_timeout_{};
@@ -405,6 +412,57 @@ TEST_F(HttpConnectionManagerImplTest, HeaderOnlyRequestAndResponse) {
   EXPECT_EQ(1U, listener_stats_.downstream_rq_completed_.value());
 }
 
+#ifdef TCMALLOC
+TEST_F(HttpConnectionManagerImplTest, TrackAllocations) {
+  setup(false, "envoy-custom-server", false);
+  ASSERT_TRUE(Memory::AllocationTracker::setEnabled(true));
+
+  std::shared_ptr<MockStreamDecoderFilter> filter(new NiceMock<MockStreamDecoderFilter>());
+  std::unique_ptr<std::string> filter_allocation;
+  EXPECT_CALL(*filter, decodeHeaders(_, true))
+      .WillOnce(Invoke([&](HeaderMap&, bool) -> FilterHeadersStatus {
+        filter_allocation = std::make_unique<std::string>(1000, 'a');
+        return FilterHeadersStatus::StopIteration;
+      }));
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamDecoderFilter(filter);
+      }));
+
+  NiceMock<MockStreamEncoder> encoder;
+  EXPECT_CALL(*codec_, dispatch(_)).WillOnce(Invoke([&](Buffer::Instance& data) -> void {
+    StreamDecoder* decoder = &conn_manager_->newStream(encoder);
+    HeaderMapPtr headers{
+        new TestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+    decoder->decodeHeaders(std::move(headers), true);
+    HeaderMapPtr response_headers{new TestHeaderMapImpl{{":status", "200"}}};
+    filter->callbacks_->encodeHeaders(std::move(response_headers), true);
+    data.drain(4);
+  }));
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+  // The allocations are recorded as the stream is destroyed.
+  filter_callbacks_.connection_.dispatcher_.to_delete_.clear();
+  ASSERT_TRUE(Memory::AllocationTracker::setEnabled(false));
+
+  bool found_filter = false;
+  bool found_connection_manager = false;
+  for (const Memory::SubsystemAllocations& subsystem : Memory::AllocationTracker::subsystems()) {
+    if (absl::StrContains(subsystem.name_, "MockStreamDecoderFilter")) {
+      found_filter = true;
+      EXPECT_EQ(1, subsystem.requests_);
+      EXPECT_LE(1000, subsystem.counts_.bytes_);
+    } else if (subsystem.name_ == "http_connection_manager") {
+      found_connection_manager = true;
+      EXPECT_EQ(1, subsystem.requests_);
+    }
+  }
+  EXPECT_TRUE(found_filter);
+  EXPECT_TRUE(found_connection_manager);
+}
+#endif
+
 TEST_F(HttpConnectionManagerImplTest, 100ContinueResponse) {
   proxy_100_continue_ = true;
   setup(false, "envoy-custom-server", false);
@@ -813,6 +871,57 @@ TEST_F(HttpConnectionManagerImplTest, StartAndFinishSpanNormalFlowIngressDecorat
   conn_manager_->onData(fake_input, false);
 }
 
+// A span which is not reported is neither decorated nor tagged, while the decorator operation is
+// still propagated.
+TEST_F(HttpConnectionManagerImplTest, NotSampledSpanIngressDecorator) {
+  setup(false, "");
+
+  auto* span = new NiceMock<Tracing::MockSpan>();
+  EXPECT_CALL(tracer_, startSpan_(_, _, _, _)).WillOnce(Return(span));
+  ON_CALL(*span, sampled()).WillByDefault(Return(false));
+  route_config_provider_.route_config_->route_->decorator_.operation_ = "testOp";
+  EXPECT_CALL(route_config_provider_.route_config_->route_->decorator_, apply(_)).Times(0);
+  EXPECT_CALL(*span, finishSpan());
+  EXPECT_CALL(*span, setTag(_, _)).Times(0);
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("tracing.global_enabled",
+                                                 An<const envoy::type::FractionalPercent&>(), _))
+      .WillOnce(Return(true));
+
+  std::shared_ptr<MockStreamDecoderFilter> filter(new NiceMock<MockStreamDecoderFilter>());
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillRepeatedly(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamDecoderFilter(filter);
+      }));
+
+  // Treat request as internal, otherwise x-request-id header will be overwritten.
+  use_remote_address_ = false;
+
+  StreamDecoder* decoder = nullptr;
+  NiceMock<MockStreamEncoder> encoder;
+  EXPECT_CALL(*codec_, dispatch(_)).WillRepeatedly(Invoke([&](Buffer::Instance& data) -> void {
+    decoder = &conn_manager_->newStream(encoder);
+
+    HeaderMapPtr headers{
+        new TestHeaderMapImpl{{":method", "GET"},
+                              {":authority", "host"},
+                              {":path", "/"},
+                              {"x-request-id", "125a4afb-6f55-a4ba-ad80-413f09f48a28"}}};
+    decoder->decodeHeaders(std::move(headers), true);
+
+    HeaderMapPtr response_headers{new TestHeaderMapImpl{{":status", "200"}}};
+    filter->callbacks_->encodeHeaders(std::move(response_headers), true);
+    data.drain(4);
+  }));
+
+  EXPECT_CALL(encoder, encodeHeaders(_, true))
+      .WillOnce(Invoke([](const HeaderMap& headers, bool) -> void {
+        EXPECT_EQ("testOp", headers.EnvoyDecoratorOperation()->value().getStringView());
+      }));
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+}
+
 TEST_F(HttpConnectionManagerImplTest, StartAndFinishSpanNormalFlowIngressDecoratorOverrideOp) {
   setup(false, "");
 
@@ -4189,6 +4298,68 @@ TEST_F(HttpConnectionManagerImplTest, DisableKeepAliveWhenOverloaded) {
   EXPECT_EQ(1U, stats_.named_.downstream_cx_overload_disable_keepalive_.value());
 }
 
+TEST_F(HttpConnectionManagerImplTest, ReduceHttp2MaxConcurrentStreamsWhenOverloaded) {
+  setup(false, "");
+
+  EXPECT_CALL(*codec_, dispatch(_)).WillRepeatedly(Invoke([&](Buffer::Instance& data) -> void {
+    conn_manager_->newStream(response_encoder_);
+    data.drain(4);
+  }));
+
+  EXPECT_CALL(*codec_, reduceMaxConcurrentStreams(false));
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+
+  overload_manager_.overload_state_.setState(
+      Server::OverloadActionNames::get().ReduceHttp2MaxConcurrentStreams,
+      Server::OverloadActionState::Active);
+  EXPECT_CALL(*codec_, reduceMaxConcurrentStreams(true));
+  Buffer::OwnedImpl fake_input2("1234");
+  conn_manager_->onData(fake_input2, false);
+
+  EXPECT_EQ(2U, overload_manager_.overload_state_.activeRequests());
+  conn_manager_->onEvent(Network::ConnectionEvent::RemoteClose);
+  filter_callbacks_.connection_.dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(0U, overload_manager_.overload_state_.activeRequests());
+}
+
+TEST_F(HttpConnectionManagerImplTest, ResetLargestStreamsWhenBufferLimitsReduced) {
+  initial_buffer_limit_ = 100;
+  overload_buffer_limit_ = 4;
+  streaming_filter_ = false;
+  setup(false, "");
+  setUpEncoderAndDecoder(false, false);
+  sendRequestHeadersAndData();
+
+  // The stream buffers the 5 bytes added by the first filter, more than the overload limit.
+  EXPECT_CALL(filter_callbacks_.connection_, setBufferLimits(4));
+  EXPECT_CALL(stream_, resetStream(StreamResetReason::LocalReset))
+      .WillOnce(Invoke([&](StreamResetReason reason) -> void {
+        stream_callbacks_->onResetStream(reason, absl::string_view());
+      }));
+  expectOnDestroy();
+  overload_manager_.overload_state_.setState(
+      Server::OverloadActionNames::get().ReduceBufferLimits, Server::OverloadActionState::Active);
+  EXPECT_EQ(1U, stats_.named_.downstream_rq_overload_reset_.value());
+
+  EXPECT_CALL(filter_callbacks_.connection_, setBufferLimits(0));
+  overload_manager_.overload_state_.setState(Server::OverloadActionNames::get().ReduceBufferLimits,
+                                             Server::OverloadActionState::Inactive);
+}
+
+TEST_F(HttpConnectionManagerImplTest, NewStreamsGetReducedBufferLimit) {
+  initial_buffer_limit_ = 100;
+  overload_buffer_limit_ = 10;
+  setup(false, "");
+  EXPECT_CALL(filter_callbacks_.connection_, setBufferLimits(10));
+  overload_manager_.overload_state_.setState(
+      Server::OverloadActionNames::get().ReduceBufferLimits, Server::OverloadActionState::Active);
+
+  setUpEncoderAndDecoder(false, false);
+  sendRequestHeadersAndData();
+  EXPECT_EQ(10U, decoder_filters_[0]->callbacks_->decoderBufferLimit());
+}
+
 TEST_F(HttpConnectionManagerImplTest, OverlyLongHeadersRejected) {
   setup(false, "");
 
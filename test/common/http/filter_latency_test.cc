@@ -0,0 +1,146 @@
+#include <chrono>
+#include <memory>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/filter_latency.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/printers.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Property;
+using testing::ReturnRef;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class FilterLatencyTest : public testing::Test {
+public:
+  FilterLatencyTest() {
+    ON_CALL(encoder_callbacks_, streamInfo())
+        .WillByDefault(ReturnRef(decoder_callbacks_.stream_info_));
+  }
+
+  FilterFactoryCb wrap(FilterFactoryCb factory, const std::string& name) {
+    return FilterLatency::wrapFilterFactory(factory, name, "http.test.", store_, time_system_);
+  }
+
+  void expectHistogram(const std::string& name, uint64_t value) {
+    EXPECT_CALL(store_, deliverHistogramToSinks(Property(&Stats::Metric::name, name), value));
+  }
+
+  const StreamInfo::FilterState& filterState() {
+    return decoder_callbacks_.stream_info_.filterState();
+  }
+
+  std::string latencies() {
+    return filterState().getDataReadOnly<FilterLatencyState>(FilterLatencyState::key()).toString();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<Stats::MockIsolatedStatsStore> store_;
+  NiceMock<MockFilterChainFactoryCallbacks> chain_callbacks_;
+  NiceMock<MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  NiceMock<MockStreamEncoderFilterCallbacks> encoder_callbacks_;
+  TestHeaderMapImpl headers_{{":path", "/"}};
+  Buffer::OwnedImpl data_;
+};
+
+TEST_F(FilterLatencyTest, StreamFilter) {
+  auto filter = std::make_shared<NiceMock<MockStreamFilter>>();
+  StreamFilterSharedPtr wrapped;
+  EXPECT_CALL(chain_callbacks_, addStreamFilter(_)).WillOnce(SaveArg<0>(&wrapped));
+  wrap([filter](FilterChainFactoryCallbacks& callbacks) { callbacks.addStreamFilter(filter); },
+       "envoy.test")(chain_callbacks_);
+  ASSERT_NE(nullptr, wrapped);
+  EXPECT_NE(filter, wrapped);
+
+  EXPECT_CALL(*filter, setDecoderFilterCallbacks(_));
+  EXPECT_CALL(*filter, setEncoderFilterCallbacks(_));
+  wrapped->setDecoderFilterCallbacks(decoder_callbacks_);
+  wrapped->setEncoderFilterCallbacks(encoder_callbacks_);
+
+  EXPECT_CALL(*filter, decodeHeaders(_, false)).WillOnce(Invoke([this](HeaderMap&, bool) {
+    time_system_.sleep(std::chrono::microseconds(20));
+    return FilterHeadersStatus::StopIteration;
+  }));
+  EXPECT_EQ(FilterHeadersStatus::StopIteration, wrapped->decodeHeaders(headers_, false));
+  EXPECT_CALL(*filter, decodeData(_, true)).WillOnce(Invoke([this](Buffer::Instance&, bool) {
+    time_system_.sleep(std::chrono::microseconds(10));
+    return FilterDataStatus::Continue;
+  }));
+  EXPECT_EQ(FilterDataStatus::Continue, wrapped->decodeData(data_, true));
+  EXPECT_CALL(*filter, encodeHeaders(_, true)).WillOnce(Invoke([this](HeaderMap&, bool) {
+    time_system_.sleep(std::chrono::microseconds(5));
+    return FilterHeadersStatus::Continue;
+  }));
+  EXPECT_EQ(FilterHeadersStatus::Continue, wrapped->encodeHeaders(headers_, true));
+  // Time spent outside of the filter is not counted.
+  time_system_.sleep(std::chrono::milliseconds(1));
+
+  EXPECT_FALSE(filterState().hasData<FilterLatencyState>(FilterLatencyState::key()));
+  expectHistogram("http.test.filter.envoy.test.decode_time_us", 30);
+  expectHistogram("http.test.filter.envoy.test.encode_time_us", 5);
+  // A dual filter is only destroyed once.
+  EXPECT_CALL(*filter, onDestroy());
+  wrapped->onDestroy();
+
+  EXPECT_EQ("envoy.test=35", latencies());
+}
+
+TEST_F(FilterLatencyTest, DecoderAndEncoderFilters) {
+  auto decoder = std::make_shared<NiceMock<MockStreamDecoderFilter>>();
+  auto encoder = std::make_shared<NiceMock<MockStreamEncoderFilter>>();
+  StreamDecoderFilterSharedPtr wrapped_decoder;
+  StreamEncoderFilterSharedPtr wrapped_encoder;
+  EXPECT_CALL(chain_callbacks_, addStreamDecoderFilter(_)).WillOnce(SaveArg<0>(&wrapped_decoder));
+  EXPECT_CALL(chain_callbacks_, addStreamEncoderFilter(_)).WillOnce(SaveArg<0>(&wrapped_encoder));
+  wrap(
+      [decoder](FilterChainFactoryCallbacks& callbacks) {
+        callbacks.addStreamDecoderFilter(decoder);
+      },
+      "envoy.decoder")(chain_callbacks_);
+  wrap(
+      [encoder](FilterChainFactoryCallbacks& callbacks) {
+        callbacks.addStreamEncoderFilter(encoder);
+      },
+      "envoy.encoder")(chain_callbacks_);
+
+  wrapped_decoder->setDecoderFilterCallbacks(decoder_callbacks_);
+  wrapped_encoder->setEncoderFilterCallbacks(encoder_callbacks_);
+
+  EXPECT_CALL(*decoder, decodeHeaders(_, true)).WillOnce(Invoke([this](HeaderMap&, bool) {
+    time_system_.sleep(std::chrono::microseconds(7));
+    return FilterHeadersStatus::Continue;
+  }));
+  EXPECT_EQ(FilterHeadersStatus::Continue, wrapped_decoder->decodeHeaders(headers_, true));
+  EXPECT_CALL(*encoder, encodeHeaders(_, true)).WillOnce(Invoke([this](HeaderMap&, bool) {
+    time_system_.sleep(std::chrono::microseconds(3));
+    return FilterHeadersStatus::Continue;
+  }));
+  EXPECT_EQ(FilterHeadersStatus::Continue, wrapped_encoder->encodeHeaders(headers_, true));
+
+  // A decoder filter has no encode histogram, and an encoder filter no decode histogram.
+  expectHistogram("http.test.filter.envoy.decoder.decode_time_us", 7);
+  expectHistogram("http.test.filter.envoy.encoder.encode_time_us", 3);
+  EXPECT_CALL(*decoder, onDestroy());
+  EXPECT_CALL(*encoder, onDestroy());
+  wrapped_decoder->onDestroy();
+  wrapped_encoder->onDestroy();
+
+  EXPECT_EQ("envoy.decoder=7,envoy.encoder=3", latencies());
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
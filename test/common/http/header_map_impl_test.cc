@@ -1,5 +1,6 @@
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/http/header_map_impl.h"
 #include "common/http/header_utility.h"
@@ -7,6 +8,7 @@
 #include "test/test_common/printers.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "gtest/gtest.h"
 
 using ::testing::InSequence;
@@ -1047,6 +1049,78 @@ TEST(HeaderMapImplTest, PseudoHeaderOrder) {
 // Validate that TestHeaderMapImpl copy construction and assignment works. This is a
 // regression for where we were missing a valid copy constructor and had the
 // default (dangerous) move semantics takeover.
+// Entries come from blocks that grow with the map, and removed entries are reused.
+TEST(HeaderMapImplTest, ManyHeaders) {
+  HeaderMapImpl headers;
+  for (int i = 0; i < 100; i++) {
+    headers.addCopy(LowerCaseString(absl::StrCat("x-header-", i)), i);
+  }
+  for (int i = 0; i < 100; i += 2) {
+    headers.remove(LowerCaseString(absl::StrCat("x-header-", i)));
+  }
+  for (int i = 100; i < 150; i++) {
+    headers.addCopy(LowerCaseString(absl::StrCat("x-header-", i)), i);
+  }
+  headers.insertPath().value(std::string("/"));
+  EXPECT_EQ(101, headers.size());
+
+  std::vector<std::string> expected{":path /"};
+  for (int i = 1; i < 100; i += 2) {
+    expected.push_back(absl::StrCat("x-header-", i, " ", i));
+  }
+  for (int i = 100; i < 150; i++) {
+    expected.push_back(absl::StrCat("x-header-", i, " ", i));
+  }
+  std::vector<std::string> actual;
+  headers.iterate(
+      [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+        static_cast<std::vector<std::string>*>(context)->push_back(
+            absl::StrCat(header.key().getStringView(), " ", header.value().getStringView()));
+        return HeaderMap::Iterate::Continue;
+      },
+      &actual);
+  EXPECT_EQ(expected, actual);
+}
+
+// Lookups on maps large enough to be indexed return the first header with a key, including after
+// that header is removed.
+TEST(HeaderMapImplTest, IndexedLookups) {
+  HeaderMapImpl headers;
+  for (int i = 0; i < 40; i++) {
+    headers.addCopy(LowerCaseString(absl::StrCat("x-header-", i % 20)), i);
+  }
+  headers.addCopy(LowerCaseString(":x-pseudo"), "pseudo");
+  for (int i = 0; i < 20; i++) {
+    const HeaderEntry* entry = headers.get(LowerCaseString(absl::StrCat("x-header-", i)));
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(absl::StrCat(i), entry->value().getStringView());
+  }
+  EXPECT_EQ("pseudo", headers.get(LowerCaseString(":x-pseudo"))->value().getStringView());
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("x-header-20")));
+
+  // Removing the first header of each key leaves the second one visible.
+  for (int i = 0; i < 20; i++) {
+    headers.remove(LowerCaseString(absl::StrCat("x-header-", i)));
+    headers.addCopy(LowerCaseString(absl::StrCat("x-header-", i)), i + 20);
+  }
+  for (int i = 0; i < 20; i++) {
+    EXPECT_EQ(absl::StrCat(i + 20),
+              headers.get(LowerCaseString(absl::StrCat("x-header-", i)))->value().getStringView());
+  }
+
+  headers.removePrefix(LowerCaseString("x-header-1"));
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("x-header-1")));
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("x-header-15")));
+  EXPECT_EQ("22", headers.get(LowerCaseString("x-header-2"))->value().getStringView());
+  EXPECT_EQ("pseudo", headers.get(LowerCaseString(":x-pseudo"))->value().getStringView());
+
+  // Shrinking below the indexing threshold falls back to a scan.
+  headers.removePrefix(LowerCaseString("x-header-"));
+  EXPECT_EQ(1, headers.size());
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("x-header-2")));
+  EXPECT_EQ("pseudo", headers.get(LowerCaseString(":x-pseudo"))->value().getStringView());
+}
+
 TEST(HeaderMapImplTest, TestHeaderMapImplyCopy) {
   TestHeaderMapImpl foo;
   foo.addCopy(LowerCaseString("foo"), "bar");
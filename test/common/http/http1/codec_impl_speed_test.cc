@@ -0,0 +1,67 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/http1/codec_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Measure the speed of parsing a request on a server connection. The numeric Arg passed by the
+ * BENCHMARK(...) macro call below is the number of headers in the request, after the usual few,
+ * which helps identify costs that grow with the number of headers.
+ */
+static void Http1ServerParseRequest(benchmark::State& state) {
+  NiceMock<Network::MockConnection> connection;
+  NiceMock<MockServerConnectionCallbacks> callbacks;
+  NiceMock<MockStreamDecoder> decoder;
+  Stats::IsolatedStoreImpl store;
+  StreamEncoder* response_encoder = nullptr;
+  ON_CALL(callbacks, newStream(_, _))
+      .WillByDefault(Invoke([&](StreamEncoder& encoder, bool) -> StreamDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+  ServerConnectionImpl codec(connection, store, callbacks, Http1Settings(),
+                             DEFAULT_MAX_REQUEST_HEADERS_KB);
+
+  std::string request = "GET /some/path?with=query HTTP/1.1\r\nhost: www.example.com\r\n"
+                        "user-agent: benchmark\r\naccept: */*\r\n";
+  for (int64_t i = 0; i < state.range(0); i++) {
+    request += "x-dummy-header-" + std::to_string(i) + ": abcdefghijklmnopqrstuvwxyz0123456789\r\n";
+  }
+  request += "\r\n";
+
+  const TestHeaderMapImpl response_headers{{":status", "200"}};
+  for (auto _ : state) {
+    Buffer::OwnedImpl buffer(request);
+    codec.dispatch(buffer);
+    response_encoder->encodeHeaders(response_headers, true);
+  }
+}
+BENCHMARK(Http1ServerParseRequest)->Arg(0)->Arg(10)->Arg(50)->Arg(200);
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -1,5 +1,6 @@
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/buffer/buffer.h"
 #include "envoy/event/dispatcher.h"
@@ -549,6 +550,48 @@ TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseWith204) {
   EXPECT_EQ("HTTP/1.1 204 No Content\r\n\r\n", output);
 }
 
+// Status lines come from a table for codes 100 to 599 and are built for any other code.
+TEST_F(Http1ServerConnectionImplTest, StatusLines) {
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> decoder;
+  Http::StreamEncoder* response_encoder = nullptr;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillRepeatedly(Invoke([&](Http::StreamEncoder& encoder, bool) -> Http::StreamDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+
+  std::string output;
+  ON_CALL(connection_, write(_, _)).WillByDefault(AddBufferToString(&output));
+
+  const std::vector<std::pair<std::string, std::string>> statuses = {
+      {"100", "HTTP/1.1 100 Continue\r\n\r\n"},
+      {"429", "HTTP/1.1 429 Too Many Requests\r\ncontent-length: 0\r\n\r\n"},
+      {"599", "HTTP/1.1 599 Unknown\r\ncontent-length: 0\r\n\r\n"},
+      {"600", "HTTP/1.1 600 Unknown\r\ncontent-length: 0\r\n\r\n"},
+      {"99", "HTTP/1.1 99 Unknown\r\n\r\n"}};
+  for (const auto& status : statuses) {
+    Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\n\r\n");
+    codec_->dispatch(buffer);
+    EXPECT_EQ(0U, buffer.length());
+
+    output.clear();
+    TestHeaderMapImpl headers{{":status", status.first}};
+    if (status.first == "100") {
+      response_encoder->encode100ContinueHeaders(headers);
+      EXPECT_EQ(status.second, output);
+      output.clear();
+      TestHeaderMapImpl final_headers{{":status", "200"}};
+      response_encoder->encodeHeaders(final_headers, true);
+      EXPECT_EQ("HTTP/1.1 200 OK\r\ncontent-length: 0\r\n\r\n", output);
+    } else {
+      response_encoder->encodeHeaders(headers, true);
+      EXPECT_EQ(status.second, output);
+    }
+  }
+}
+
 TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseWith100Then200) {
   initialize();
 
@@ -1263,6 +1306,36 @@ TEST_F(Http1ServerConnectionImplTest, TestLargeRequestHeadersSplitRejected) {
   EXPECT_THROW_WITH_MESSAGE(codec_->dispatch(buffer), EnvoyException, "headers size exceeds limit");
 }
 
+// The header size limit applies to each request on a connection, not to all of them together.
+TEST_F(Http1ServerConnectionImplTest, TestLargeRequestHeadersPerRequest) {
+  // Default limit of 60 KiB
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> decoder;
+  Http::StreamEncoder* response_encoder = nullptr;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](Http::StreamEncoder& encoder, bool) -> Http::StreamDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+  EXPECT_CALL(decoder, decodeHeaders_(_, true)).Times(2);
+
+  std::string long_string = std::string(1024, 'q');
+  for (int request = 0; request < 2; request++) {
+    Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\n");
+    for (int i = 0; i < 40; i++) {
+      buffer.add(fmt::format("big: {}\r\n", long_string));
+    }
+    buffer.add("\r\n");
+    codec_->dispatch(buffer);
+    EXPECT_EQ(0U, buffer.length());
+
+    TestHeaderMapImpl headers{{":status", "200"}};
+    response_encoder->encodeHeaders(headers, true);
+  }
+}
+
 TEST_F(Http1ServerConnectionImplTest, TestLargeRequestHeadersAccepted) {
   max_request_headers_kb_ = 65;
   initialize();
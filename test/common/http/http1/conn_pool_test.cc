@@ -755,6 +755,55 @@ TEST_F(Http1ConnPoolImplTest, ConcurrentConnections) {
   EXPECT_EQ(2U, cluster_->stats_.upstream_cx_destroy_remote_.value());
 }
 
+/**
+ * Test that connections are opened ahead of requests with a preconnect ratio.
+ */
+TEST_F(Http1ConnPoolImplTest, Preconnect) {
+  InSequence s;
+  cluster_->resetResourceManager(3, 1024, 1024, 1, 1);
+  cluster_->per_upstream_preconnect_ratio_ = 1.5;
+
+  // The first request opens a connection for itself and another for the next request.
+  NiceMock<Http::MockStreamDecoder> outer_decoder1;
+  ConnPoolCallbacks callbacks1;
+  conn_pool_.expectClientCreate();
+  conn_pool_.expectClientCreate();
+  EXPECT_NE(nullptr, conn_pool_.newStream(outer_decoder1, callbacks1));
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_total_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_.value());
+
+  NiceMock<Http::MockStreamEncoder> request_encoder;
+  Http::StreamDecoder* inner_decoder1;
+  EXPECT_CALL(*conn_pool_.test_clients_[0].codec_, newStream(_))
+      .WillOnce(DoAll(SaveArgAddress(&inner_decoder1), ReturnRef(request_encoder)));
+  EXPECT_CALL(callbacks1.pool_ready_, ready());
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // The second request is bound to the preconnected connection right away, and opens another.
+  NiceMock<Http::MockStreamDecoder> outer_decoder2;
+  ConnPoolCallbacks callbacks2;
+  Http::StreamDecoder* inner_decoder2;
+  EXPECT_CALL(*conn_pool_.test_clients_[1].codec_, newStream(_))
+      .WillOnce(DoAll(SaveArgAddress(&inner_decoder2), ReturnRef(request_encoder)));
+  EXPECT_CALL(callbacks2.pool_ready_, ready());
+  conn_pool_.expectClientCreate();
+  EXPECT_EQ(nullptr, conn_pool_.newStream(outer_decoder2, callbacks2));
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_total_.value());
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_preconnect_.value());
+
+  callbacks1.outer_encoder_->encodeHeaders(TestHeaderMapImpl{}, true);
+  inner_decoder1->decodeHeaders(HeaderMapPtr{new TestHeaderMapImpl{{":status", "200"}}}, true);
+  callbacks2.outer_encoder_->encodeHeaders(TestHeaderMapImpl{}, true);
+  inner_decoder2->decodeHeaders(HeaderMapPtr{new TestHeaderMapImpl{{":status", "200"}}}, true);
+
+  EXPECT_CALL(conn_pool_, onClientDestroy()).Times(3);
+  conn_pool_.test_clients_[2].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+}
+
 TEST_F(Http1ConnPoolImplTest, DrainCallback) {
   InSequence s;
   ReadyWatcher drained;
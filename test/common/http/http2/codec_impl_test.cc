@@ -131,6 +131,19 @@ public:
     reinterpret_cast<uint8_t*>(data.linearize(data.length()))[index % data.length()] = new_value;
   }
 
+  // Returns the number of frames in a sequence of whole frames written by a codec.
+  static uint32_t countFrames(const Buffer::Instance& data) {
+    const std::string frames = data.toString();
+    uint32_t count = 0;
+    for (size_t offset = 0; offset + Http2Frame::HeaderSize <= frames.size(); ++count) {
+      const uint32_t payload_length = (static_cast<uint8_t>(frames[offset]) << 16) |
+                                      (static_cast<uint8_t>(frames[offset + 1]) << 8) |
+                                      static_cast<uint8_t>(frames[offset + 2]);
+      offset += Http2Frame::HeaderSize + payload_length;
+    }
+    return count;
+  }
+
   const Http2SettingsTuple client_settings_;
   const Http2SettingsTuple server_settings_;
   bool allow_metadata_ = false;
@@ -271,6 +284,64 @@ TEST_P(Http2CodecImplTest, ShutdownNotice) {
   response_encoder_->encodeHeaders(response_headers, true);
 }
 
+// The overload limit of the concurrent streams is only advertised when the overload state changes.
+TEST_P(Http2CodecImplTest, ReduceMaxConcurrentStreams) {
+  server_http2settings_.overload_max_concurrent_streams_ = 1;
+  initialize();
+
+  TestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  request_encoder_->encodeHeaders(request_headers, true);
+
+  EXPECT_CALL(server_connection_, write(_, _));
+  server_->reduceMaxConcurrentStreams(true);
+  server_->reduceMaxConcurrentStreams(true);
+  testing::Mock::VerifyAndClearExpectations(&server_connection_);
+
+  EXPECT_CALL(server_connection_, write(_, _));
+  server_->reduceMaxConcurrentStreams(false);
+  server_->reduceMaxConcurrentStreams(false);
+  testing::Mock::VerifyAndClearExpectations(&server_connection_);
+
+  TestHeaderMapImpl response_headers{{":status", "200"}};
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, true));
+  response_encoder_->encodeHeaders(response_headers, true);
+}
+
+// Without an overload limit, the settings are never changed.
+TEST_P(Http2CodecImplTest, ReduceMaxConcurrentStreamsWithoutOverloadLimit) {
+  initialize();
+
+  EXPECT_CALL(server_connection_, write(_, _)).Times(0);
+  server_->reduceMaxConcurrentStreams(true);
+}
+
+// Repeated headers are encoded as references to the HPACK dynamic table, which shows in the ratio
+// of the header block to the header field stats.
+TEST_P(Http2CodecImplTest, HeaderCompressionStats) {
+  initialize();
+
+  TestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  request_headers.addCopy("x-custom-header", std::string(100, 'a'));
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  request_encoder_->encodeHeaders(request_headers, true);
+
+  const uint64_t field_bytes = stats_store_.counter("http2.tx_header_field_bytes").value();
+  const uint64_t block_bytes = stats_store_.counter("http2.tx_header_block_bytes").value();
+  EXPECT_EQ(request_headers.byteSize(), field_bytes);
+  EXPECT_LT(block_bytes, field_bytes);
+
+  StreamEncoder* request_encoder2 = &client_->newStream(response_decoder_);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  request_encoder2->encodeHeaders(request_headers, true);
+
+  EXPECT_EQ(2 * field_bytes, stats_store_.counter("http2.tx_header_field_bytes").value());
+  EXPECT_LT(stats_store_.counter("http2.tx_header_block_bytes").value() - block_bytes,
+            block_bytes / 4);
+}
+
 TEST_P(Http2CodecImplTest, ContinueHeaders) {
   initialize();
 
@@ -1241,7 +1312,7 @@ TEST_P(Http2CodecImplTest, PingFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &ack_count](Buffer::Instance& frame, bool) {
-        ++ack_count;
+        ack_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -1267,9 +1338,14 @@ TEST_P(Http2CodecImplTest, PingFloodMitigationDisabled) {
     EXPECT_EQ(0, nghttp2_submit_ping(client_->session(), NGHTTP2_FLAG_NONE, nullptr));
   }
 
-  EXPECT_CALL(server_connection_, write(_, _))
-      .Times(Http2Settings::DEFAULT_MAX_OUTBOUND_CONTROL_FRAMES + 1);
+  uint32_t ack_count = 0;
+  ON_CALL(server_connection_, write(_, _))
+      .WillByDefault(Invoke([&](Buffer::Instance& frame, bool) {
+        ack_count += countFrames(frame);
+        client_wrapper_.dispatch(frame, *client_);
+      }));
   EXPECT_NO_THROW(client_->sendPendingFrames());
+  EXPECT_EQ(Http2Settings::DEFAULT_MAX_OUTBOUND_CONTROL_FRAMES + 1, ack_count);
 }
 
 // Verify that outbound control frame counter decreases when send buffer is drained
@@ -1291,7 +1367,7 @@ TEST_P(Http2CodecImplTest, PingFloodCounterReset) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &ack_count](Buffer::Instance& frame, bool) {
-        ++ack_count;
+        ack_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -1327,7 +1403,7 @@ TEST_P(Http2CodecImplTest, ResponseHeadersFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -1357,7 +1433,7 @@ TEST_P(Http2CodecImplTest, ResponseDataFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -1388,9 +1464,12 @@ TEST_P(Http2CodecImplTest, ResponseDataFloodMitigationDisabled) {
   EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
   request_encoder_->encodeHeaders(request_headers, false);
 
-  // +2 is to account for HEADERS and PING ACK, that is used to trigger mitigation
-  EXPECT_CALL(server_connection_, write(_, _))
-      .Times(Http2Settings::DEFAULT_MAX_OUTBOUND_FRAMES + 2);
+  uint32_t frame_count = 0;
+  ON_CALL(server_connection_, write(_, _))
+      .WillByDefault(Invoke([&](Buffer::Instance& frame, bool) {
+        frame_count += countFrames(frame);
+        client_wrapper_.dispatch(frame, *client_);
+      }));
   EXPECT_CALL(response_decoder_, decodeHeaders_(_, false)).Times(1);
   EXPECT_CALL(response_decoder_, decodeData(_, false))
       .Times(Http2Settings::DEFAULT_MAX_OUTBOUND_FRAMES);
@@ -1405,6 +1484,8 @@ TEST_P(Http2CodecImplTest, ResponseDataFloodMitigationDisabled) {
   // So we need to send stream from downstream client to trigger mitigation
   EXPECT_EQ(0, nghttp2_submit_ping(client_->session(), NGHTTP2_FLAG_NONE, nullptr));
   EXPECT_NO_THROW(client_->sendPendingFrames());
+  // +2 is to account for HEADERS and PING ACK, that is used to trigger mitigation
+  EXPECT_EQ(Http2Settings::DEFAULT_MAX_OUTBOUND_FRAMES + 2, frame_count);
 }
 
 // Verify that outbound frame counter decreases when send buffer is drained
@@ -1422,7 +1503,7 @@ TEST_P(Http2CodecImplTest, ResponseDataFloodCounterReset) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -1462,7 +1543,7 @@ TEST_P(Http2CodecImplTest, PingStacksWithDataFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
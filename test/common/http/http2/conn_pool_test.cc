@@ -225,12 +225,17 @@ TEST_F(Http2ConnPoolImplTest, DrainConnections) {
   EXPECT_CALL(r2.inner_encoder_, encodeHeaders(_, true));
   r2.callbacks_.outer_encoder_->encodeHeaders(HeaderMapImpl{}, true);
 
-  // This will move primary to draining and destroy draining.
+  // This will move the second client to draining, alongside the first.
   pool_.drainConnections();
+  EXPECT_TRUE(pool_.hasActiveConnections());
+
+  // This will destroy the first client, as its stream is complete.
+  EXPECT_CALL(r1.decoder_, decodeHeaders_(_, true));
+  r1.inner_decoder_->decodeHeaders(HeaderMapPtr{new HeaderMapImpl{}}, true);
   EXPECT_CALL(*this, onClientDestroy());
   dispatcher_.clearDeferredDeleteList();
 
-  // This will destroy draining.
+  // This will destroy the second client.
   test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
   EXPECT_CALL(*this, onClientDestroy());
   dispatcher_.clearDeferredDeleteList();
@@ -389,6 +394,9 @@ TEST_F(Http2ConnPoolImplTest, VerifyConnectionTimingStats) {
   ActiveTestRequest r1(*this, 0, false);
   EXPECT_CALL(cluster_->stats_store_,
               deliverHistogramToSinks(Property(&Stats::Metric::name, "upstream_cx_connect_ms"), _));
+  EXPECT_CALL(cluster_->stats_store_,
+              deliverHistogramToSinks(
+                  Property(&Stats::Metric::name, "upstream_cx_http2_concurrent_streams"), 1));
   expectClientConnect(0, r1);
   EXPECT_CALL(r1.inner_encoder_, encodeHeaders(_, true));
   r1.callbacks_.outer_encoder_->encodeHeaders(HeaderMapImpl{}, true);
@@ -702,6 +710,97 @@ TEST_F(Http2ConnPoolImplTest, GoAway) {
   EXPECT_EQ(1U, cluster_->stats_.upstream_cx_close_notify_.value());
 }
 
+// Verifies that with multiple connections allowed, another connection is opened once every
+// connection carries streams, and that streams are assigned to the least loaded connection.
+TEST_F(Http2ConnPoolImplTest, MultipleConnectionsLeastLoaded) {
+  InSequence s;
+  cluster_->max_http2_connections_per_host_ = 2;
+
+  expectClientCreate();
+  ActiveTestRequest r1(*this, 0, false);
+  expectClientConnect(0, r1);
+
+  // The first connection carries a stream, so a second connection is created. The stream is
+  // served by the first connection until the second is ready.
+  expectClientCreate();
+  ActiveTestRequest r2(*this, 0, true);
+
+  // The second connection takes no streams until it is ready.
+  ActiveTestRequest r3(*this, 0, true);
+
+  EXPECT_CALL(*test_clients_[1].connect_timer_, disableTimer());
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // The second connection is the least loaded until it carries as many streams as the first, and
+  // no more connections are created past the limit.
+  ActiveTestRequest r4(*this, 1, true);
+  ActiveTestRequest r5(*this, 1, true);
+  ActiveTestRequest r6(*this, 1, true);
+  ActiveTestRequest r7(*this, 0, true);
+
+  completeRequest(r4);
+  ActiveTestRequest r8(*this, 1, true);
+
+  EXPECT_TRUE(pool_.hasActiveConnections());
+  for (ActiveTestRequest* r : {&r1, &r2, &r3, &r5, &r6, &r7, &r8}) {
+    completeRequest(*r);
+  }
+  EXPECT_FALSE(pool_.hasActiveConnections());
+
+  closeClient(0);
+  closeClient(1);
+
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_total_.value());
+  EXPECT_EQ(8U, cluster_->stats_.upstream_rq_total_.value());
+}
+
+// Verifies that all connections are drained, and that a connection which is draining does not
+// count towards the limit.
+TEST_F(Http2ConnPoolImplTest, MultipleConnectionsDrain) {
+  InSequence s;
+  cluster_->max_http2_connections_per_host_ = 2;
+
+  expectClientCreate();
+  ActiveTestRequest r1(*this, 0, false);
+  expectClientConnect(0, r1);
+  expectClientCreate();
+  ActiveTestRequest r2(*this, 0, true);
+  EXPECT_CALL(*test_clients_[1].connect_timer_, disableTimer());
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  ActiveTestRequest r3(*this, 1, true);
+
+  // A GOAWAY on the first connection leaves one connection accepting streams, so another is
+  // created once it carries streams.
+  test_clients_[0].codec_client_->raiseGoAway();
+  expectClientCreate();
+  ActiveTestRequest r4(*this, 1, true);
+
+  ReadyWatcher drained;
+  pool_.addDrainedCallback([&]() -> void { drained.ready(); });
+
+  // The connecting client has no streams, so it is closed right away.
+  EXPECT_CALL(*this, onClientDestroy());
+  dispatcher_.clearDeferredDeleteList();
+
+  pool_.drainConnections();
+  completeRequest(r3);
+  completeRequest(r1);
+  completeRequest(r2);
+  EXPECT_CALL(*this, onClientDestroy());
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_CALL(r4.inner_encoder_, encodeHeaders(_, true));
+  r4.callbacks_.outer_encoder_->encodeHeaders(HeaderMapImpl{}, true);
+  EXPECT_CALL(drained, ready());
+  EXPECT_CALL(r4.decoder_, decodeHeaders_(_, true));
+  r4.inner_decoder_->decodeHeaders(HeaderMapPtr{new HeaderMapImpl{}}, true);
+  EXPECT_CALL(*this, onClientDestroy());
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_destroy_.value());
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_destroy_local_.value());
+}
+
 TEST_F(Http2ConnPoolImplTest, NoActiveConnectionsByDefault) {
   EXPECT_FALSE(pool_.hasActiveConnections());
 }
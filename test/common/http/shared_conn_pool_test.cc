@@ -0,0 +1,268 @@
+#include <list>
+#include <memory>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/shared_conn_pool.h"
+
+#include "test/common/http/common.h"
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/common.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/upstream/host.h"
+#include "test/test_common/printers.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class SharedConnPoolTest : public testing::Test {
+public:
+  SharedConnPoolTest()
+      : shared_(std::make_shared<SharedConnPool>(
+            owner_dispatcher_, Protocol::Http2, host_,
+            [this]() -> ConnectionPool::InstancePtr {
+              pool_created_.ready();
+              return std::move(inner_pool_);
+            },
+            [this]() -> void { destroyed_.ready(); })),
+        client_(shared_->createClient(client_dispatcher_)) {
+    // Events posted to the owner are run when the test says so, as they would be run after
+    // the client's thread has moved on.
+    ON_CALL(owner_dispatcher_, post(_)).WillByDefault(Invoke([this](Event::PostCb cb) -> void {
+      owner_posts_.push_back(cb);
+    }));
+  }
+
+  ~SharedConnPoolTest() override {
+    client_.reset();
+    shared_.reset();
+    runOwner();
+  }
+
+  void runOwner() {
+    while (!owner_posts_.empty()) {
+      Event::PostCb cb = owner_posts_.front();
+      owner_posts_.pop_front();
+      cb();
+    }
+  }
+
+  // Makes a stream which the inner pool makes ready immediately.
+  ConnectionPool::Cancellable* newReadyStream() {
+    EXPECT_CALL(*inner_, newStream(_, _))
+        .WillOnce(Invoke([this](StreamDecoder& decoder, ConnectionPool::Callbacks& callbacks)
+                             -> ConnectionPool::Cancellable* {
+          inner_decoder_ = &decoder;
+          callbacks.onPoolReady(inner_encoder_, host_);
+          return nullptr;
+        }));
+    ConnectionPool::Cancellable* handle = client_->newStream(response_decoder_, callbacks_);
+    EXPECT_CALL(callbacks_.pool_ready_, ready());
+    runOwner();
+    return handle;
+  }
+
+  NiceMock<Event::MockDispatcher> owner_dispatcher_;
+  NiceMock<Event::MockDispatcher> client_dispatcher_;
+  std::unique_ptr<NiceMock<ConnectionPool::MockInstance>> inner_pool_{
+      new NiceMock<ConnectionPool::MockInstance>()};
+  NiceMock<ConnectionPool::MockInstance>* inner_{inner_pool_.get()};
+  std::shared_ptr<NiceMock<Upstream::MockHostDescription>> host_{
+      new NiceMock<Upstream::MockHostDescription>()};
+  NiceMock<MockStreamEncoder> inner_encoder_;
+  StreamDecoder* inner_decoder_{};
+  NiceMock<MockStreamDecoder> response_decoder_;
+  ConnPoolCallbacks callbacks_;
+  NiceMock<ReadyWatcher> pool_created_;
+  NiceMock<ReadyWatcher> destroyed_;
+  std::list<Event::PostCb> owner_posts_;
+  SharedConnPoolSharedPtr shared_;
+  ConnectionPool::InstancePtr client_;
+};
+
+// The inner pool is created for the first stream, and the events of the stream are handed between
+// the client and the inner pool.
+TEST_F(SharedConnPoolTest, ForwardsStream) {
+  EXPECT_EQ(Protocol::Http2, client_->protocol());
+  EXPECT_EQ(host_, client_->host());
+  EXPECT_CALL(pool_created_, ready());
+  ON_CALL(inner_encoder_.stream_, bufferLimit()).WillByDefault(Return(1024));
+  EXPECT_NE(nullptr, newReadyStream());
+  EXPECT_TRUE(client_->hasActiveConnections());
+  EXPECT_EQ(host_, callbacks_.host_);
+  EXPECT_EQ(1024, callbacks_.outer_encoder_->getStream().bufferLimit());
+
+  TestHeaderMapImpl request_headers{{":method", "POST"}, {":path", "/"}};
+  EXPECT_CALL(inner_encoder_, encodeHeaders(HeaderMapEqualRef(&request_headers), false));
+  callbacks_.outer_encoder_->encodeHeaders(request_headers, false);
+  Buffer::OwnedImpl request_body("request");
+  EXPECT_CALL(inner_encoder_, encodeData(BufferStringEqual("request"), true));
+  callbacks_.outer_encoder_->encodeData(request_body, true);
+  EXPECT_EQ(0, request_body.length());
+  runOwner();
+
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, false));
+  inner_decoder_->decodeHeaders(HeaderMapPtr{new TestHeaderMapImpl{{":status", "200"}}}, false);
+  EXPECT_CALL(response_decoder_, decodeData(BufferStringEqual("response"), false));
+  Buffer::OwnedImpl response_body("response");
+  inner_decoder_->decodeData(response_body, false);
+  EXPECT_CALL(response_decoder_, decodeTrailers_(_));
+  inner_decoder_->decodeTrailers(HeaderMapPtr{new TestHeaderMapImpl{{"grpc-status", "0"}}});
+  EXPECT_FALSE(client_->hasActiveConnections());
+  // The completed inner stream no longer calls back into the shared pool.
+  EXPECT_TRUE(inner_encoder_.stream_.callbacks_.empty());
+
+  ReadyWatcher drained;
+  EXPECT_CALL(drained, ready());
+  client_->addDrainedCallback([&drained]() -> void { drained.ready(); });
+
+  EXPECT_CALL(*inner_, drainConnections());
+  client_->drainConnections();
+  runOwner();
+}
+
+// Flow control is handed between the client and the inner pool.
+TEST_F(SharedConnPoolTest, FlowControl) {
+  newReadyStream();
+  MockStreamCallbacks stream_callbacks;
+  callbacks_.outer_encoder_->getStream().addCallbacks(stream_callbacks);
+
+  EXPECT_CALL(stream_callbacks, onAboveWriteBufferHighWatermark());
+  inner_encoder_.stream_.runHighWatermarkCallbacks();
+  EXPECT_CALL(stream_callbacks, onBelowWriteBufferLowWatermark());
+  inner_encoder_.stream_.runLowWatermarkCallbacks();
+
+  EXPECT_CALL(inner_encoder_.stream_, readDisable(true));
+  callbacks_.outer_encoder_->getStream().readDisable(true);
+  runOwner();
+}
+
+// Cancelling a pending stream cancels it on the inner pool.
+TEST_F(SharedConnPoolTest, CancelPending) {
+  ConnectionPool::MockCancellable cancellable;
+  EXPECT_CALL(*inner_, newStream(_, _)).WillOnce(Return(&cancellable));
+  ConnectionPool::Cancellable* handle = client_->newStream(response_decoder_, callbacks_);
+  runOwner();
+
+  handle->cancel();
+  EXPECT_FALSE(client_->hasActiveConnections());
+  EXPECT_CALL(cancellable, cancel());
+  runOwner();
+}
+
+// A stream cancelled before the owner has made it is reset once it is made, so that it does not
+// hold on to the connection.
+TEST_F(SharedConnPoolTest, CancelBeforeStart) {
+  ConnectionPool::Cancellable* handle = client_->newStream(response_decoder_, callbacks_);
+  handle->cancel();
+
+  EXPECT_CALL(*inner_, newStream(_, _))
+      .WillOnce(Invoke([this](StreamDecoder&, ConnectionPool::Callbacks& callbacks)
+                           -> ConnectionPool::Cancellable* {
+        callbacks.onPoolReady(inner_encoder_, host_);
+        return nullptr;
+      }));
+  EXPECT_CALL(callbacks_.pool_ready_, ready()).Times(0);
+  EXPECT_CALL(inner_encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  runOwner();
+}
+
+TEST_F(SharedConnPoolTest, PoolFailure) {
+  EXPECT_CALL(*inner_, newStream(_, _))
+      .WillOnce(Invoke([this](StreamDecoder&, ConnectionPool::Callbacks& callbacks)
+                           -> ConnectionPool::Cancellable* {
+        callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::ConnectionFailure, "", host_);
+        return nullptr;
+      }));
+  client_->newStream(response_decoder_, callbacks_);
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  runOwner();
+  EXPECT_EQ(host_, callbacks_.host_);
+  EXPECT_FALSE(client_->hasActiveConnections());
+}
+
+// A reset by the upstream is handed to the client.
+TEST_F(SharedConnPoolTest, RemoteReset) {
+  newReadyStream();
+  MockStreamCallbacks stream_callbacks;
+  callbacks_.outer_encoder_->getStream().addCallbacks(stream_callbacks);
+
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::RemoteReset, _));
+  inner_encoder_.stream_.resetStream(StreamResetReason::RemoteReset);
+  EXPECT_FALSE(client_->hasActiveConnections());
+}
+
+// A reset by the client runs its reset callbacks immediately and resets the inner stream.
+TEST_F(SharedConnPoolTest, LocalReset) {
+  newReadyStream();
+  MockStreamCallbacks stream_callbacks;
+  callbacks_.outer_encoder_->getStream().addCallbacks(stream_callbacks);
+
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::LocalReset, _));
+  callbacks_.outer_encoder_->getStream().resetStream(StreamResetReason::LocalReset);
+  EXPECT_FALSE(client_->hasActiveConnections());
+
+  EXPECT_CALL(inner_encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  runOwner();
+  // The inner stream's events are no longer handed to the client.
+  inner_encoder_.stream_.runHighWatermarkCallbacks();
+}
+
+// Pending streams and streams made after the shared pool is shut down fail.
+TEST_F(SharedConnPoolTest, Shutdown) {
+  ConnectionPool::MockCancellable cancellable;
+  EXPECT_CALL(*inner_, newStream(_, _)).WillOnce(Return(&cancellable));
+  client_->newStream(response_decoder_, callbacks_);
+  runOwner();
+
+  EXPECT_CALL(cancellable, cancel());
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  shared_->shutdown();
+  EXPECT_FALSE(client_->hasActiveConnections());
+  testing::Mock::VerifyAndClearExpectations(&callbacks_.pool_failure_);
+
+  EXPECT_CALL(pool_created_, ready()).Times(0);
+  client_->newStream(response_decoder_, callbacks_);
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  runOwner();
+
+  // Preconnecting and draining do nothing.
+  client_->preconnect(1);
+  client_->drainConnections();
+  runOwner();
+}
+
+// The shared pool is destroyed on the owner's thread once its last client is, and the client's
+// pending streams are cancelled.
+TEST_F(SharedConnPoolTest, DestroyClient) {
+  ConnectionPool::MockCancellable cancellable;
+  EXPECT_CALL(*inner_, newStream(_, _)).WillOnce(Return(&cancellable));
+  client_->newStream(response_decoder_, callbacks_);
+  runOwner();
+
+  ConnectionPool::InstancePtr other_client = shared_->createClient(client_dispatcher_);
+  shared_.reset();
+  client_.reset();
+  EXPECT_CALL(cancellable, cancel());
+  EXPECT_CALL(destroyed_, ready()).Times(0);
+  runOwner();
+  testing::Mock::VerifyAndClearExpectations(&destroyed_);
+
+  other_client.reset();
+  EXPECT_CALL(destroyed_, ready());
+  runOwner();
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
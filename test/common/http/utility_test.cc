@@ -39,6 +39,21 @@ TEST(HttpUtility, parseQueryString) {
             Utility::parseQueryString("/logging?name=admin&level=trace"));
 }
 
+TEST(HttpUtility, QueryParamsView) {
+  EXPECT_EQ(absl::nullopt, Utility::QueryParamsView("/hello").find("hello"));
+  EXPECT_EQ(absl::nullopt, Utility::QueryParamsView("/hello?").find("hello"));
+  EXPECT_EQ("", Utility::QueryParamsView("/hello?hello").find("hello"));
+  EXPECT_EQ("", Utility::QueryParamsView("/hello?hello=&").find("hello"));
+
+  const Utility::QueryParamsView params("/hello?hello=&hello2=world2&hello2=world3&a=b=c");
+  EXPECT_EQ("", params.find("hello"));
+  // As with parseQueryString(), the first occurrence of a parameter wins.
+  EXPECT_EQ("world2", params.find("hello2"));
+  EXPECT_EQ("b=c", params.find("a"));
+  EXPECT_EQ(absl::nullopt, params.find("hello3"));
+  EXPECT_EQ(absl::nullopt, params.find("world2"));
+}
+
 TEST(HttpUtility, getResponseStatus) {
   EXPECT_THROW(Utility::getResponseStatus(TestHeaderMapImpl{}), CodecClientException);
   EXPECT_EQ(200U, Utility::getResponseStatus(TestHeaderMapImpl{{":status", "200"}}));
@@ -274,6 +289,7 @@ TEST(HttpUtility, parseHttp2Settings) {
               http2_settings.max_inbound_priority_frames_per_stream_);
     EXPECT_EQ(Http2Settings::DEFAULT_MAX_INBOUND_WINDOW_UPDATE_FRAMES_PER_DATA_FRAME_SENT,
               http2_settings.max_inbound_window_update_frames_per_data_frame_sent_);
+    EXPECT_EQ(0U, http2_settings.overload_max_concurrent_streams_);
   }
 
   {
@@ -282,10 +298,12 @@ hpack_table_size: 1
 max_concurrent_streams: 2
 initial_stream_window_size: 65535
 initial_connection_window_size: 65535
+overload_max_concurrent_streams: 1
     )EOF";
     auto http2_settings = parseHttp2SettingsFromV2Yaml(yaml);
     EXPECT_EQ(1U, http2_settings.hpack_table_size_);
     EXPECT_EQ(2U, http2_settings.max_concurrent_streams_);
+    EXPECT_EQ(1U, http2_settings.overload_max_concurrent_streams_);
     EXPECT_EQ(65535U, http2_settings.initial_stream_window_size_);
     EXPECT_EQ(65535U, http2_settings.initial_connection_window_size_);
   }
@@ -0,0 +1,89 @@
+#include <memory>
+
+#include "common/memory/allocation_tracker.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Memory {
+namespace {
+
+struct TrackedSubsystem {};
+
+const SubsystemAllocations* findSubsystem(const std::vector<SubsystemAllocations>& subsystems,
+                                          const std::string& name) {
+  for (const SubsystemAllocations& subsystem : subsystems) {
+    if (subsystem.name_ == name) {
+      return &subsystem;
+    }
+  }
+  return nullptr;
+}
+
+TEST(AllocationScopeTest, Nesting) {
+  EXPECT_EQ(nullptr, AllocationScope::current());
+  AllocationCounts outer_counts;
+  AllocationCounts inner_counts;
+  {
+    AllocationScope outer(&outer_counts);
+    EXPECT_EQ(&outer_counts, AllocationScope::current());
+    {
+      AllocationScope inner(&inner_counts);
+      EXPECT_EQ(&inner_counts, AllocationScope::current());
+      {
+        AllocationScope untracked(nullptr);
+        EXPECT_EQ(nullptr, AllocationScope::current());
+      }
+      EXPECT_EQ(&inner_counts, AllocationScope::current());
+    }
+    EXPECT_EQ(&outer_counts, AllocationScope::current());
+  }
+  EXPECT_EQ(nullptr, AllocationScope::current());
+}
+
+#ifdef TCMALLOC
+TEST(AllocationScopeTest, CountsAllocations) {
+  ASSERT_TRUE(AllocationTracker::setEnabled(true));
+  AllocationCounts counts;
+  {
+    AllocationScope scope(&counts);
+    auto allocated = std::make_unique<char[]>(1000);
+    EXPECT_NE(nullptr, allocated);
+  }
+  EXPECT_TRUE(AllocationTracker::setEnabled(false));
+  EXPECT_EQ(1, counts.allocations_);
+  EXPECT_LE(1000, counts.bytes_);
+}
+#else
+TEST(AllocationTrackerTest, NotSupported) {
+  EXPECT_FALSE(AllocationTracker::setEnabled(true));
+  EXPECT_FALSE(AllocationTracker::enabled());
+  EXPECT_TRUE(AllocationTracker::setEnabled(false));
+}
+#endif
+
+TEST(AllocationTrackerTest, Record) {
+  AllocationCounts counts;
+  counts.allocations_ = 2;
+  counts.bytes_ = 64;
+  AllocationTracker::record("test_subsystem", counts);
+  AllocationTracker::record("test_subsystem", counts);
+  AllocationTracker::record(typeid(TrackedSubsystem), counts);
+
+  const std::vector<SubsystemAllocations> subsystems = AllocationTracker::subsystems();
+  const SubsystemAllocations* subsystem = findSubsystem(subsystems, "test_subsystem");
+  ASSERT_NE(nullptr, subsystem);
+  EXPECT_EQ(2, subsystem->requests_);
+  EXPECT_EQ(4, subsystem->counts_.allocations_);
+  EXPECT_EQ(128, subsystem->counts_.bytes_);
+
+  // The names of the types are demangled.
+  subsystem =
+      findSubsystem(subsystems, "Envoy::Memory::(anonymous namespace)::TrackedSubsystem");
+  ASSERT_NE(nullptr, subsystem);
+  EXPECT_EQ(1, subsystem->requests_);
+}
+
+} // namespace
+} // namespace Memory
+} // namespace Envoy
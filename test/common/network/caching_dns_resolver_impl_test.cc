@@ -0,0 +1,265 @@
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "common/network/caching_dns_resolver_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::DoAll;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class CachingDnsResolverImplTest : public testing::Test, public Event::TestUsingSimulatedTime {
+public:
+  void initialize() {
+    cache_ = std::make_unique<CachingDnsResolverImpl>(resolver_, dispatcher_, config_, store_);
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(store_, "dns_resolver_cache." + name)->value();
+  }
+
+  uint64_t entries() {
+    return TestUtility::findGauge(store_, "dns_resolver_cache.entries")->value();
+  }
+
+  // Resolves a name through the cache, expecting a query to the resolver.
+  Event::MockTimer* resolveMiss(const std::string& name, DnsResolver::ResolveCb& resolve_cb,
+                                std::list<DnsResponse>& response) {
+    Event::MockTimer* timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+    EXPECT_CALL(*resolver_, resolve(name, DnsLookupFamily::V4Only, _))
+        .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+    EXPECT_NE(nullptr, cache_->resolve(name, DnsLookupFamily::V4Only,
+                                       [&response](std::list<DnsResponse>&& results) -> void {
+                                         response = std::move(results);
+                                       }));
+    return timer;
+  }
+
+  // Resolves a name through the cache, expecting the callback to be invoked inline.
+  std::list<DnsResponse> resolveHit(const std::string& name) {
+    std::list<DnsResponse> response;
+    bool called = false;
+    EXPECT_EQ(nullptr, cache_->resolve(name, DnsLookupFamily::V4Only,
+                                       [&](std::list<DnsResponse>&& results) -> void {
+                                         response = std::move(results);
+                                         called = true;
+                                       }));
+    EXPECT_TRUE(called);
+    return response;
+  }
+
+  envoy::config::bootstrap::v2::ClusterManager::DnsCache config_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  std::shared_ptr<MockDnsResolver> resolver_{std::make_shared<NiceMock<MockDnsResolver>>()};
+  Stats::IsolatedStoreImpl store_;
+  std::unique_ptr<CachingDnsResolverImpl> cache_;
+};
+
+// Validate that responses are cached for their TTL, with the remaining TTL.
+TEST_F(CachingDnsResolverImplTest, Hit) {
+  initialize();
+
+  DnsResolver::ResolveCb resolve_cb;
+  std::list<DnsResponse> response;
+  Event::MockTimer* timer = resolveMiss("foo.com", resolve_cb, response);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(54000)));
+  resolve_cb(TestUtility::makeDnsResponse({"10.0.0.1", "10.0.0.2"}, std::chrono::seconds(60)));
+  ASSERT_EQ(2UL, response.size());
+  EXPECT_EQ("10.0.0.1:0", response.front().address_->asString());
+  EXPECT_EQ(1UL, counter("miss"));
+  EXPECT_EQ(1UL, entries());
+
+  simTime().sleep(std::chrono::seconds(10));
+  response = resolveHit("foo.com");
+  ASSERT_EQ(2UL, response.size());
+  EXPECT_EQ("10.0.0.2:0", response.back().address_->asString());
+  EXPECT_EQ(std::chrono::seconds(50), response.back().ttl_);
+  EXPECT_EQ(1UL, counter("hit"));
+
+  // The lookup family is part of the key.
+  EXPECT_CALL(*resolver_, resolve("foo.com", DnsLookupFamily::V6Only, _));
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  cache_->resolve("foo.com", DnsLookupFamily::V6Only, [](std::list<DnsResponse>&&) -> void {});
+  EXPECT_EQ(2UL, counter("miss"));
+
+  EXPECT_CALL(resolver_->active_query_, cancel());
+  cache_.reset();
+}
+
+// Validate that concurrent resolutions of a name share a query.
+TEST_F(CachingDnsResolverImplTest, Coalesced) {
+  initialize();
+
+  DnsResolver::ResolveCb resolve_cb;
+  std::list<DnsResponse> response1;
+  resolveMiss("foo.com", resolve_cb, response1);
+
+  std::list<DnsResponse> response2;
+  ActiveDnsQuery* query2 = cache_->resolve(
+      "foo.com", DnsLookupFamily::V4Only,
+      [&response2](std::list<DnsResponse>&& results) -> void { response2 = std::move(results); });
+  ASSERT_NE(nullptr, query2);
+  bool called3 = false;
+  ActiveDnsQuery* query3 =
+      cache_->resolve("foo.com", DnsLookupFamily::V4Only,
+                      [&called3](std::list<DnsResponse>&&) -> void { called3 = true; });
+  EXPECT_EQ(2UL, counter("coalesced"));
+
+  // Cancelling a query keeps the query to the resolver.
+  EXPECT_CALL(resolver_->active_query_, cancel()).Times(0);
+  query3->cancel();
+
+  resolve_cb(TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(60)));
+  EXPECT_EQ(1UL, response1.size());
+  EXPECT_EQ(1UL, response2.size());
+  EXPECT_FALSE(called3);
+  EXPECT_EQ(1UL, counter("miss"));
+}
+
+// Validate that failed resolutions are cached for the negative TTL, and then expire.
+TEST_F(CachingDnsResolverImplTest, NegativeCaching) {
+  config_.mutable_negative_ttl()->set_seconds(2);
+  initialize();
+
+  DnsResolver::ResolveCb resolve_cb;
+  std::list<DnsResponse> response;
+  Event::MockTimer* timer = resolveMiss("foo.com", resolve_cb, response);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(2000)));
+  resolve_cb({});
+
+  EXPECT_TRUE(resolveHit("foo.com").empty());
+  EXPECT_EQ(1UL, counter("negative_hit"));
+
+  simTime().sleep(std::chrono::seconds(2));
+  timer->invokeCallback();
+  EXPECT_EQ(1UL, counter("expired"));
+  EXPECT_EQ(0UL, entries());
+
+  resolveMiss("foo.com", resolve_cb, response);
+  EXPECT_EQ(2UL, counter("miss"));
+}
+
+// Validate that the entries used since they were resolved are resolved again before they expire,
+// and that the others expire.
+TEST_F(CachingDnsResolverImplTest, Prefetch) {
+  initialize();
+
+  DnsResolver::ResolveCb resolve_cb;
+  std::list<DnsResponse> response;
+  Event::MockTimer* timer = resolveMiss("foo.com", resolve_cb, response);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(9000)));
+  resolve_cb(TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(10)));
+  resolveHit("foo.com");
+
+  simTime().sleep(std::chrono::seconds(9));
+  EXPECT_CALL(*resolver_, resolve("foo.com", DnsLookupFamily::V4Only, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  timer->invokeCallback();
+  EXPECT_EQ(1UL, counter("prefetch"));
+
+  // The cached response is used while the prefetch is in flight.
+  EXPECT_EQ("10.0.0.1:0", resolveHit("foo.com").front().address_->asString());
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(9000)));
+  resolve_cb(TestUtility::makeDnsResponse({"10.0.0.2"}, std::chrono::seconds(10)));
+  EXPECT_EQ("10.0.0.2:0", resolveHit("foo.com").front().address_->asString());
+  EXPECT_EQ(1UL, counter("miss"));
+
+  // Entries which are not used expire.
+  simTime().sleep(std::chrono::seconds(9));
+  EXPECT_CALL(*resolver_, resolve(_, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  timer->invokeCallback();
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(9000)));
+  resolve_cb(TestUtility::makeDnsResponse({"10.0.0.2"}, std::chrono::seconds(10)));
+
+  simTime().sleep(std::chrono::seconds(9));
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(1000)));
+  timer->invokeCallback();
+  simTime().sleep(std::chrono::seconds(1));
+  timer->invokeCallback();
+  EXPECT_EQ(1UL, counter("expired"));
+  EXPECT_EQ(0UL, entries());
+}
+
+// Validate that the TTLs are bounded by the configuration.
+TEST_F(CachingDnsResolverImplTest, TtlBounds) {
+  config_.mutable_min_ttl()->set_seconds(30);
+  config_.mutable_max_ttl()->set_seconds(100);
+  config_.mutable_prefetch_percent()->set_value(50);
+  initialize();
+
+  DnsResolver::ResolveCb resolve_cb;
+  std::list<DnsResponse> response;
+  Event::MockTimer* timer = resolveMiss("foo.com", resolve_cb, response);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(15000)));
+  resolve_cb(TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(1)));
+
+  timer = resolveMiss("bar.com", resolve_cb, response);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(50000)));
+  resolve_cb(TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(1000)));
+}
+
+// Validate that the least recently used entries are evicted once the cache is full.
+TEST_F(CachingDnsResolverImplTest, Eviction) {
+  config_.mutable_max_entries()->set_value(2);
+  initialize();
+
+  DnsResolver::ResolveCb resolve_cb;
+  std::list<DnsResponse> response;
+  resolveMiss("foo.com", resolve_cb, response);
+  resolve_cb(TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(60)));
+  resolveMiss("bar.com", resolve_cb, response);
+  resolve_cb(TestUtility::makeDnsResponse({"10.0.0.2"}, std::chrono::seconds(60)));
+  resolveHit("foo.com");
+
+  resolveMiss("baz.com", resolve_cb, response);
+  EXPECT_EQ(1UL, counter("evicted"));
+  EXPECT_EQ(2UL, entries());
+  resolveHit("foo.com");
+
+  // Entries with pending queries are not evicted.
+  DnsResolver::ResolveCb other_resolve_cb;
+  resolveMiss("qux.com", other_resolve_cb, response);
+  EXPECT_EQ(2UL, counter("evicted"));
+  EXPECT_EQ(2UL, entries());
+  resolve_cb(TestUtility::makeDnsResponse({"10.0.0.3"}, std::chrono::seconds(60)));
+  EXPECT_EQ("10.0.0.3:0", response.front().address_->asString());
+}
+
+// Validate that resolutions completed inline by the resolver are returned inline.
+TEST_F(CachingDnsResolverImplTest, InlineResolution) {
+  initialize();
+
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*resolver_, resolve("127.0.0.1", DnsLookupFamily::V4Only, _))
+      .WillOnce(Invoke([](const std::string&, DnsLookupFamily,
+                          DnsResolver::ResolveCb callback) -> ActiveDnsQuery* {
+        callback(TestUtility::makeDnsResponse({"127.0.0.1"}, std::chrono::seconds(60)));
+        return nullptr;
+      }));
+  EXPECT_EQ("127.0.0.1:0", resolveHit("127.0.0.1").front().address_->asString());
+  EXPECT_EQ(1UL, counter("miss"));
+  EXPECT_EQ("127.0.0.1:0", resolveHit("127.0.0.1").front().address_->asString());
+  EXPECT_EQ(1UL, counter("hit"));
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,60 @@
+#include "common/network/connection_balancer_impl.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class MockBalancedConnectionHandler : public BalancedConnectionHandler {
+public:
+  MOCK_CONST_METHOD0(numConnections, uint64_t());
+  MOCK_METHOD0(incNumConnections, void());
+  MOCK_METHOD1(post, void(ConnectionSocketPtr& socket));
+
+  void post(ConnectionSocketPtr&& socket) override { post(socket); }
+};
+
+TEST(ExactConnectionBalancerImplTest, PickFewestConnections) {
+  ExactConnectionBalancerImpl balancer;
+  MockBalancedConnectionHandler handler1;
+  MockBalancedConnectionHandler handler2;
+  balancer.registerHandler(handler1);
+  balancer.registerHandler(handler2);
+
+  // The handler with the fewest connections is picked and counts the socket.
+  EXPECT_CALL(handler1, numConnections()).WillRepeatedly(Return(2));
+  EXPECT_CALL(handler2, numConnections()).WillRepeatedly(Return(1));
+  EXPECT_CALL(handler2, incNumConnections());
+  EXPECT_EQ(&handler2, &balancer.pickTargetHandler(handler1));
+
+  // The current handler wins a tie and is not counted, as it does not post the socket.
+  EXPECT_CALL(handler1, numConnections()).WillRepeatedly(Return(1));
+  EXPECT_CALL(handler1, incNumConnections()).Times(0);
+  EXPECT_EQ(&handler1, &balancer.pickTargetHandler(handler1));
+
+  // An unregistered handler is no longer picked.
+  balancer.unregisterHandler(handler2);
+  EXPECT_CALL(handler1, numConnections()).WillRepeatedly(Return(5));
+  EXPECT_EQ(&handler1, &balancer.pickTargetHandler(handler1));
+  balancer.unregisterHandler(handler1);
+}
+
+TEST(NopConnectionBalancerImplTest, PickCurrentHandler) {
+  NopConnectionBalancerImpl balancer;
+  MockBalancedConnectionHandler handler1;
+  MockBalancedConnectionHandler handler2;
+  balancer.registerHandler(handler1);
+  balancer.registerHandler(handler2);
+  EXPECT_CALL(handler1, incNumConnections()).Times(0);
+  EXPECT_EQ(&handler1, &balancer.pickTargetHandler(handler1));
+  balancer.unregisterHandler(handler1);
+  balancer.unregisterHandler(handler2);
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -1692,6 +1692,53 @@ TEST_F(MockTransportConnectionImplTest, WriteReadyOnConnected) {
       .WillOnce(Return(IoResult{PostIoAction::KeepOpen, 0, true}));
 }
 
+// Test that the read budget ends a read event once it is used up and that the read size adapts to
+// the amount of data read per event.
+TEST_F(MockTransportConnectionImplTest, ReadBudget) {
+  connection_->addReadFilter(std::make_shared<NiceMock<MockReadFilter>>());
+  StrictMock<Stats::MockCounter> yield;
+  StrictMock<Stats::MockCounter> grow;
+  StrictMock<Stats::MockCounter> shrink;
+  connection_->setReadBudget(32768, {yield, grow, shrink});
+  EXPECT_EQ(16384, transport_socket_callbacks_->readSizeHint());
+
+  // Two full reads use up the budget, so the transport socket is told to yield. Needing more than
+  // one read grows the read size.
+  EXPECT_CALL(*transport_socket_, doRead(_)).WillOnce(Invoke([this](Buffer::Instance& buffer) {
+    buffer.add(std::string(transport_socket_callbacks_->readSizeHint(), 'a'));
+    EXPECT_FALSE(transport_socket_callbacks_->shouldDrainReadBuffer());
+    buffer.add(std::string(transport_socket_callbacks_->readSizeHint(), 'a'));
+    EXPECT_TRUE(transport_socket_callbacks_->shouldDrainReadBuffer());
+    return IoResult{PostIoAction::KeepOpen, 32768, false};
+  }));
+  EXPECT_CALL(yield, inc());
+  EXPECT_CALL(grow, inc());
+  file_ready_cb_(Event::FileReadyType::Read);
+  // The read size is capped by the budget.
+  EXPECT_EQ(32768, transport_socket_callbacks_->readSizeHint());
+
+  // The budget applies per event, so the data still buffered from the previous event does not
+  // count against it. A short read shrinks the read size.
+  EXPECT_CALL(*transport_socket_, doRead(_)).WillOnce(Invoke([this](Buffer::Instance& buffer) {
+    buffer.add("hello");
+    EXPECT_FALSE(transport_socket_callbacks_->shouldDrainReadBuffer());
+    return IoResult{PostIoAction::KeepOpen, 5, false};
+  }));
+  EXPECT_CALL(shrink, inc());
+  file_ready_cb_(Event::FileReadyType::Read);
+  EXPECT_EQ(16384, transport_socket_callbacks_->readSizeHint());
+
+  // Without a budget the read size is fixed.
+  connection_->setReadBudget(0, {yield, grow, shrink});
+  EXPECT_CALL(*transport_socket_, doRead(_)).WillOnce(Invoke([this](Buffer::Instance& buffer) {
+    buffer.add(std::string(65536, 'a'));
+    EXPECT_FALSE(transport_socket_callbacks_->shouldDrainReadBuffer());
+    return IoResult{PostIoAction::KeepOpen, 65536, false};
+  }));
+  file_ready_cb_(Event::FileReadyType::Read);
+  EXPECT_EQ(16384, transport_socket_callbacks_->readSizeHint());
+}
+
 // Fixture for validating behavior after a connection is closed.
 class PostCloseConnectionImplTest : public MockTransportConnectionImplTest {
 protected:
@@ -717,6 +717,19 @@ TEST_P(DnsImplTest, MultiARecordLookupWithV6) {
   EXPECT_TRUE(hasAddress(address_list, "1::2"));
   EXPECT_TRUE(hasAddress(address_list, "1::2:3"));
   EXPECT_TRUE(hasAddress(address_list, "1::2:3:4"));
+
+  EXPECT_NE(nullptr, resolver_->resolve("some.good.domain", DnsLookupFamily::All,
+                                        [&](std::list<DnsResponse>&& results) -> void {
+                                          address_list = getAddressList(results);
+                                          dispatcher_->exit();
+                                        }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(6UL, address_list.size());
+  EXPECT_TRUE(hasAddress(address_list, "201.134.56.7"));
+  EXPECT_TRUE(hasAddress(address_list, "6.5.4.3"));
+  EXPECT_TRUE(hasAddress(address_list, "1::2"));
+  EXPECT_TRUE(hasAddress(address_list, "1::2:3:4"));
 }
 
 // Validate working of cancellation provided by ActiveDnsQuery return.
@@ -0,0 +1,166 @@
+#include <memory>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/happy_eyeballs_connection_impl.h"
+#include "common/network/utility.h"
+
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::InSequence;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class HappyEyeballsConnectionImplTest : public testing::Test {
+protected:
+  HappyEyeballsConnectionImplTest()
+      : timer_(new NiceMock<Event::MockTimer>(&dispatcher_)),
+        address_list_({Utility::resolveUrl("tcp://127.0.0.1:80"),
+                       Utility::resolveUrl("tcp://[::1]:80"),
+                       Utility::resolveUrl("tcp://127.0.0.2:80")}) {
+    connection_ = std::make_unique<HappyEyeballsConnectionImpl>(
+        dispatcher_, address_list_, [this](const Address::InstanceConstSharedPtr& address) {
+          auto connection = std::make_unique<NiceMock<MockClientConnection>>();
+          connection->remote_address_ = address;
+          attempts_.push_back(connection.get());
+          return connection;
+        });
+    connection_->addConnectionCallbacks(callbacks_);
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Event::MockTimer* timer_;
+  const std::vector<Address::InstanceConstSharedPtr> address_list_;
+  std::vector<MockClientConnection*> attempts_;
+  std::unique_ptr<HappyEyeballsConnectionImpl> connection_;
+  MockConnectionCallbacks callbacks_;
+};
+
+TEST_F(HappyEyeballsConnectionImplTest, SortAddresses) {
+  const auto sorted = HappyEyeballsConnectionImpl::sortAddresses(
+      {Utility::resolveUrl("tcp://127.0.0.1:80"), Utility::resolveUrl("tcp://127.0.0.2:80"),
+       Utility::resolveUrl("tcp://[::1]:80"), Utility::resolveUrl("tcp://127.0.0.3:80"),
+       Utility::resolveUrl("tcp://[::2]:80")});
+  std::vector<std::string> addresses;
+  for (const auto& address : sorted) {
+    addresses.push_back(address->asString());
+  }
+  EXPECT_EQ(std::vector<std::string>({"[::1]:80", "127.0.0.1:80", "[::2]:80", "127.0.0.2:80",
+                                      "127.0.0.3:80"}),
+            addresses);
+}
+
+// The first attempt connects before the attempt delay, and the state set before then is replayed on
+// it.
+TEST_F(HappyEyeballsConnectionImplTest, FirstAttemptConnects) {
+  ASSERT_EQ(1UL, attempts_.size());
+  EXPECT_EQ("[::1]:80", connection_->remoteAddress()->asString());
+  EXPECT_EQ(attempts_[0]->id(), connection_->id());
+
+  EXPECT_CALL(*attempts_[0], connect());
+  EXPECT_CALL(*timer_, enableTimer(HappyEyeballsConnectionImpl::ConnectionAttemptDelay));
+  connection_->connect();
+
+  auto filter = std::make_shared<NiceMock<MockReadFilter>>();
+  connection_->addReadFilter(filter);
+  EXPECT_TRUE(connection_->initializeReadFilters());
+  connection_->noDelay(true);
+  connection_->setBufferLimits(1024);
+  EXPECT_EQ(1024U, connection_->bufferLimit());
+  connection_->readDisable(true);
+  EXPECT_FALSE(connection_->readEnabled());
+  Buffer::OwnedImpl data("hello");
+  connection_->write(data, false);
+  EXPECT_EQ(5UL, connection_->bufferedBytes());
+  EXPECT_EQ(Connection::State::Open, connection_->state());
+
+  {
+    InSequence s;
+    EXPECT_CALL(*timer_, disableTimer());
+    EXPECT_CALL(*attempts_[0], addReadFilter(_));
+    EXPECT_CALL(*attempts_[0], initializeReadFilters());
+    EXPECT_CALL(*attempts_[0], noDelay(true));
+    EXPECT_CALL(*attempts_[0], setBufferLimits(1024));
+    EXPECT_CALL(*attempts_[0], readDisable(true));
+    EXPECT_CALL(*attempts_[0], write(BufferStringEqual("hello"), false));
+    EXPECT_CALL(callbacks_, onEvent(ConnectionEvent::Connected));
+  }
+  attempts_[0]->raiseEvent(ConnectionEvent::Connected);
+  EXPECT_EQ(1UL, attempts_.size());
+
+  // Once connected, the calls go to the connection kept.
+  EXPECT_CALL(*attempts_[0], readDisable(false));
+  connection_->readDisable(false);
+  EXPECT_CALL(callbacks_, onAboveWriteBufferHighWatermark());
+  attempts_[0]->runHighWatermarkCallbacks();
+
+  EXPECT_CALL(callbacks_, onEvent(ConnectionEvent::LocalClose));
+  connection_->close(ConnectionCloseType::NoFlush);
+}
+
+// An attempt which is slow to connect is raced by the next one, and closed once the next one
+// connects.
+TEST_F(HappyEyeballsConnectionImplTest, NextAttemptAfterDelay) {
+  connection_->connect();
+
+  EXPECT_CALL(*timer_, enableTimer(HappyEyeballsConnectionImpl::ConnectionAttemptDelay));
+  timer_->invokeCallback();
+  ASSERT_EQ(2UL, attempts_.size());
+  EXPECT_EQ("127.0.0.1:80", attempts_[1]->remoteAddress()->asString());
+
+  EXPECT_CALL(*attempts_[0], close(ConnectionCloseType::NoFlush));
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  EXPECT_CALL(callbacks_, onEvent(ConnectionEvent::Connected));
+  attempts_[1]->raiseEvent(ConnectionEvent::Connected);
+  EXPECT_EQ("127.0.0.1:80", connection_->remoteAddress()->asString());
+  // The id does not change with the attempt kept.
+  EXPECT_EQ(attempts_[0]->id(), connection_->id());
+
+  EXPECT_CALL(callbacks_, onEvent(ConnectionEvent::RemoteClose));
+  attempts_[1]->raiseEvent(ConnectionEvent::RemoteClose);
+}
+
+// A failed attempt starts the next one at once, and the failure of the last attempt is that of the
+// connection.
+TEST_F(HappyEyeballsConnectionImplTest, AttemptsFail) {
+  connection_->connect();
+
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  EXPECT_CALL(*timer_, enableTimer(HappyEyeballsConnectionImpl::ConnectionAttemptDelay));
+  attempts_[0]->raiseEvent(ConnectionEvent::RemoteClose);
+  ASSERT_EQ(2UL, attempts_.size());
+
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  attempts_[1]->raiseEvent(ConnectionEvent::RemoteClose);
+  ASSERT_EQ(3UL, attempts_.size());
+  EXPECT_EQ("127.0.0.2:80", attempts_[2]->remoteAddress()->asString());
+
+  EXPECT_CALL(callbacks_, onEvent(ConnectionEvent::RemoteClose));
+  attempts_[2]->raiseEvent(ConnectionEvent::RemoteClose);
+}
+
+// Closing the connection before an attempt connected closes all of them, raising one close event.
+TEST_F(HappyEyeballsConnectionImplTest, CloseBeforeConnected) {
+  connection_->connect();
+  timer_->invokeCallback();
+  ASSERT_EQ(2UL, attempts_.size());
+
+  EXPECT_CALL(*attempts_[1], close(ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*attempts_[0], close(ConnectionCloseType::FlushWrite));
+  EXPECT_CALL(callbacks_, onEvent(ConnectionEvent::LocalClose));
+  connection_->close(ConnectionCloseType::FlushWrite);
+  EXPECT_EQ(Connection::State::Closed, connection_->state());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -21,6 +21,17 @@ std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> lc_trie_nested_pref
 
 std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> lc_trie_minimal;
 
+std::vector<Envoy::Network::Address::InstanceConstSharedPtr> large_addresses;
+
+std::vector<std::pair<std::string, std::vector<Envoy::Network::Address::CidrRange>>>
+    tag_data_large;
+
+std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> lc_trie_large;
+
+std::vector<Envoy::Network::Address::InstanceConstSharedPtr> ipv6_addresses;
+
+std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> lc_trie_ipv6;
+
 } // namespace
 
 namespace Envoy {
@@ -95,6 +106,44 @@ static void BM_LcTrieLookupMinimal(benchmark::State& state) {
 
 BENCHMARK(BM_LcTrieLookupMinimal);
 
+static void BM_LcTrieConstructLarge(benchmark::State& state) {
+  std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> trie;
+  for (auto _ : state) {
+    trie = std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data_large);
+  }
+  benchmark::DoNotOptimize(trie);
+}
+
+BENCHMARK(BM_LcTrieConstructLarge);
+
+// Looks up a batch of addresses in a trie with 100,000 prefixes per iteration, so the cost of
+// walking the nodes out of cache dominates.
+static void BM_LcTrieBulkLookupLarge(benchmark::State& state) {
+  size_t output_tags = 0;
+  for (auto _ : state) {
+    for (const auto& address : large_addresses) {
+      output_tags += lc_trie_large->getData(address).size();
+    }
+  }
+  benchmark::DoNotOptimize(output_tags);
+  state.SetItemsProcessed(state.iterations() * large_addresses.size());
+}
+
+BENCHMARK(BM_LcTrieBulkLookupLarge);
+
+static void BM_LcTrieBulkLookupIpv6(benchmark::State& state) {
+  size_t output_tags = 0;
+  for (auto _ : state) {
+    for (const auto& address : ipv6_addresses) {
+      output_tags += lc_trie_ipv6->getData(address).size();
+    }
+  }
+  benchmark::DoNotOptimize(output_tags);
+  state.SetItemsProcessed(state.iterations() * ipv6_addresses.size());
+}
+
+BENCHMARK(BM_LcTrieBulkLookupIpv6);
+
 } // namespace Envoy
 
 // Boilerplate main(), which discovers benchmarks in the same file and runs them.
@@ -132,6 +181,42 @@ int main(int argc, char** argv) {
       std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data_nested_prefixes);
   lc_trie_minimal = std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data_minimal);
 
+  // A large set of 100,000 /24 prefixes from 10.0.0.0/24, tagged with 64 tags, and 1,024 addresses
+  // spread over them, a quarter of which match no prefix.
+  static const size_t num_large_prefixes = 100000;
+  for (size_t i = 0; i < 64; i++) {
+    tag_data_large.emplace_back(
+        std::pair<std::string, std::vector<Envoy::Network::Address::CidrRange>>(
+            {fmt::format("tag_{}", i), {}}));
+  }
+  for (size_t i = 0; i < num_large_prefixes; i++) {
+    tag_data_large[i % 64].second.push_back(Envoy::Network::Address::CidrRange::create(
+        fmt::format("{}.{}.{}.0/24", 10 + i / 65536, i / 256 % 256, i % 256)));
+  }
+  lc_trie_large = std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data_large);
+  for (size_t i = 0; i < 1024; i++) {
+    const size_t prefix = (i * 7919) % (num_large_prefixes * 4 / 3);
+    large_addresses.push_back(Envoy::Network::Utility::parseInternetAddress(fmt::format(
+        "{}.{}.{}.{}", 10 + prefix / 65536, prefix / 256 % 256, prefix % 256, i % 256)));
+  }
+
+  // IPv6 /48 and /64 prefixes, exercising branches in both halves of the addresses.
+  std::vector<std::pair<std::string, std::vector<Envoy::Network::Address::CidrRange>>>
+      tag_data_ipv6{{"tag_0", {Envoy::Network::Address::CidrRange::create("::/0")}},
+                    {"tag_1", {}},
+                    {"tag_2", {}}};
+  for (size_t i = 0; i < 4096; i++) {
+    tag_data_ipv6[1].second.push_back(
+        Envoy::Network::Address::CidrRange::create(fmt::format("2001:db8:{:x}::/48", i)));
+    tag_data_ipv6[2].second.push_back(Envoy::Network::Address::CidrRange::create(
+        fmt::format("2001:db8:{:x}:{:x}::/64", i, i * 31 % 65536)));
+  }
+  lc_trie_ipv6 = std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data_ipv6);
+  for (size_t i = 0; i < 1024; i++) {
+    ipv6_addresses.push_back(Envoy::Network::Utility::parseInternetAddress(
+        fmt::format("2001:db8:{:x}:{:x}::{:x}", i * 4, i % 2 == 0 ? i * 124 % 65536 : i, i)));
+  }
+
   benchmark::Initialize(&argc, argv);
   if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
     return 1;
@@ -325,6 +325,57 @@ TEST_F(LcTrieTest, ExclusiveNestedPrefixesWithCatchAll) {
   expectIPAndTags(test_case);
 }
 
+// Branches which straddle the two 64-bit halves of the IPv6 addresses.
+TEST_F(LcTrieTest, Ipv6BranchesAcrossHalves) {
+  std::vector<std::vector<std::string>> cidr_range_strings = {
+      {"2001:db8::/62"},              // tag_0
+      {"2001:db8:0:4::/63"},          // tag_1
+      {"2001:db8:0:6::/64"},          // tag_2
+      {"2001:db8:0:7::/65"},          // tag_3
+      {"2001:db8:0:7:8000::/66"},     // tag_4
+      {"2001:db8:0:7:c000::/67"},     // tag_5
+      {"2001:db8:0:7:e000::1/128"},   // tag_6
+      {"2001:db8:0:7:ffff::/80"},     // tag_7
+      {"2001:db8:0:7:ffff:ffff::/96"} // tag_8
+  };
+  std::vector<std::pair<std::string, std::vector<std::string>>> test_case = {
+      {"2001:db8::1", {"tag_0"}},
+      {"2001:db8:0:3:ffff::", {"tag_0"}},
+      {"2001:db8:0:5::", {"tag_1"}},
+      {"2001:db8:0:6:ffff::", {"tag_2"}},
+      {"2001:db8:0:7:7fff::", {"tag_3"}},
+      {"2001:db8:0:7:bfff::", {"tag_4"}},
+      {"2001:db8:0:7:c000::1", {"tag_5"}},
+      {"2001:db8:0:7:e000::1", {"tag_6"}},
+      {"2001:db8:0:7:e000::2", {}},
+      {"2001:db8:0:7:ffff::1", {"tag_7"}},
+      {"2001:db8:0:7:ffff:ffff::1", {"tag_7", "tag_8"}},
+      {"2001:db8:0:8::", {}}};
+  setup(cidr_range_strings);
+  expectIPAndTags(test_case);
+  setup(cidr_range_strings, false, 0.25, 16);
+  expectIPAndTags(test_case);
+}
+
+// The leaves with the same data share it, and lookups return references to it.
+TEST_F(LcTrieTest, SharedData) {
+  std::vector<std::vector<std::string>> cidr_range_strings = {
+      {"0.0.0.0/0"},        // tag_0
+      {"10.0.0.0/8"},       // tag_1
+      {"10.1.0.0/16"},      // tag_2
+      {"10.255.255.0/24"}}; // tag_3
+  setup(cidr_range_strings, true);
+
+  const std::vector<std::string>& low = trie_->getData(Utility::parseInternetAddress("10.0.0.1"));
+  const std::vector<std::string>& high =
+      trie_->getData(Utility::parseInternetAddress("10.200.0.1"));
+  EXPECT_EQ(std::vector<std::string>{"tag_1"}, low);
+  EXPECT_EQ(&low, &high);
+
+  const std::vector<std::string>& missing = trie_->getData(Utility::parseInternetAddress("::1"));
+  EXPECT_TRUE(missing.empty());
+}
+
 // Ensure the trie will reject inputs that would cause it to exceed the maximum 2^20 nodes
 // when using the default fill factor.
 TEST_F(LcTrieTest, MaximumEntriesExceptionDefault) {
@@ -17,10 +17,12 @@
 #include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::AtMost;
 using testing::Invoke;
 using testing::Return;
 
@@ -342,11 +344,81 @@ TEST_P(UdpListenerImplTest, UdpListenerRecvMsgError) {
   // Inject mocked OsSysCalls implementation to mock a read failure.
   Api::MockOsSysCalls os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  // Platforms without recvmmsg fall back to recvmsg.
+  EXPECT_CALL(os_sys_calls, recvmmsg(_, _, _, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, ENOSYS}));
   EXPECT_CALL(os_sys_calls, recvmsg(_, _, _)).WillOnce(Return(Api::SysCallSizeResult{-1, ENOTSUP}));
 
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+/**
+ * Tests UDP listener's error callback when receiving a batch of packets fails.
+ */
+TEST_P(UdpListenerImplTest, UdpListenerRecvMmsgError) {
+  client_socket_ = createClientSocket(false);
+
+  const std::string first("first");
+  const void* void_pointer = static_cast<const void*>(first.c_str());
+  Buffer::RawSlice first_slice{const_cast<void*>(void_pointer), first.length()};
+
+  auto send_rc = client_socket_->ioHandle().sendto(first_slice, 0, *send_to_addr_);
+  ASSERT_EQ(send_rc.rc_, first.length());
+
+  EXPECT_CALL(listener_callbacks_, onData_(_)).Times(0);
+
+  EXPECT_CALL(listener_callbacks_, onWriteReady_(_)).Times(AtMost(1));
+
+  EXPECT_CALL(listener_callbacks_, onReceiveError_(_, _))
+      .WillOnce(Invoke([&](const UdpListenerCallbacks::ErrorCode& err_code,
+                           Api::IoError::IoErrorCode err) -> void {
+        ASSERT_EQ(UdpListenerCallbacks::ErrorCode::SyscallError, err_code);
+        ASSERT_EQ(Api::IoError::IoErrorCode::Permission, err);
+
+        dispatcher_->exit();
+      }));
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, recvmmsg(_, _, _, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EPERM}));
+  EXPECT_CALL(os_sys_calls, recvmsg(_, _, _)).Times(0);
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
+/**
+ * Tests that more packets than are read by a single system call are all delivered, in order.
+ */
+TEST_P(UdpListenerImplTest, UdpBatchedRead) {
+  client_socket_ = createClientSocket(false);
+
+  const int num_packets = 40;
+  for (int i = 0; i < num_packets; i++) {
+    const std::string payload = absl::StrCat("packet ", i);
+    Buffer::RawSlice slice{const_cast<char*>(payload.data()), payload.length()};
+    auto send_rc = client_socket_->ioHandle().sendto(slice, 0, *send_to_addr_);
+    ASSERT_EQ(send_rc.rc_, payload.length());
+  }
+
+  int received = 0;
+  EXPECT_CALL(listener_callbacks_, onData_(_))
+      .Times(num_packets)
+      .WillRepeatedly(Invoke([&](const UdpRecvData& data) -> void {
+        validateRecvCallbackParams(data);
+        EXPECT_EQ(absl::StrCat("packet ", received), data.buffer_->toString());
+        if (++received == num_packets) {
+          dispatcher_->exit();
+        }
+      }));
+
+  EXPECT_CALL(listener_callbacks_, onWriteReady_(_))
+      .WillRepeatedly(Invoke([&](const Socket& socket) {
+        EXPECT_EQ(socket.ioHandle().fd(), server_socket_->ioHandle().fd());
+      }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
 /**
  * Tests UDP listener for sending datagrams to destination.
  *  1. Setup a udp listener and client socket
@@ -455,6 +527,63 @@ TEST_P(UdpListenerImplTest, SendDataError) {
   EXPECT_DEATH(listener_->send(send_data), "Invalid argument passed in");
 }
 
+/**
+ * Tests that a batch of packets is sent to the destination, in order.
+ */
+TEST_P(UdpListenerImplTest, SendBatch) {
+  client_socket_ = createClientSocket(true);
+  ASSERT_NE(client_socket_, nullptr);
+
+  const std::vector<std::string> payloads{"first", "second", "third"};
+  std::vector<Buffer::RawSlice> packets;
+  for (const std::string& payload : payloads) {
+    packets.push_back({const_cast<char*>(payload.data()), payload.length()});
+  }
+  UdpSendBatchData send_data{nullptr, *client_socket_->localAddress(), packets.data(),
+                             packets.size()};
+  auto send_result = listener_->sendBatch(send_data);
+  EXPECT_TRUE(send_result.ok()) << "sendBatch() failed : " << send_result.err_->getErrorDetails();
+  EXPECT_EQ(payloads.size(), send_result.rc_);
+
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  for (const std::string& payload : payloads) {
+    char recv_buf[16];
+    Api::SysCallSizeResult result{-1, EAGAIN};
+    for (int retry = 0; retry < 10 && result.rc_ < 0 && result.errno_ == EAGAIN; retry++) {
+      result =
+          os_sys_calls.recv(client_socket_->ioHandle().fd(), recv_buf, sizeof(recv_buf), 0);
+      if (result.rc_ < 0) {
+        ::usleep(10000);
+      }
+    }
+    ASSERT_EQ(payload.length(), result.rc_);
+    EXPECT_EQ(payload, std::string(recv_buf, result.rc_));
+  }
+}
+
+/**
+ * Tests that platforms without sendmmsg send batches one packet at a time, and that a failure
+ * reports the packets sent before it.
+ */
+TEST_P(UdpListenerImplTest, SendBatchFallback) {
+  const std::string payload("hello world");
+  std::vector<Buffer::RawSlice> packets(3, {const_cast<char*>(payload.data()), payload.length()});
+  UdpSendBatchData send_data{nullptr, *server_socket_->localAddress(), packets.data(),
+                             packets.size()};
+
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, sendmmsg(_, _, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, ENOSYS}));
+  EXPECT_CALL(os_sys_calls, sendmsg(_, _, _))
+      .WillOnce(Return(Api::SysCallSizeResult{static_cast<ssize_t>(payload.length()), 0}))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, EAGAIN}));
+  auto send_result = listener_->sendBatch(send_data);
+  EXPECT_FALSE(send_result.ok());
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, send_result.err_->getErrorCode());
+  EXPECT_EQ(1, send_result.rc_);
+}
+
 } // namespace
 } // namespace Network
 } // namespace Envoy
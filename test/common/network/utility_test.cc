@@ -6,6 +6,8 @@
 
 #include "common/common/thread.h"
 #include "common/network/address_impl.h"
+#include "common/network/listen_socket_impl.h"
+#include "common/network/socket_option_factory.h"
 #include "common/network/utility.h"
 
 #include "test/mocks/network/mocks.h"
@@ -295,6 +297,40 @@ TEST(NetworkUtility, AnyAddress) {
   }
 }
 
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+// With CPU steering a connection from this thread is accepted by the socket at the index of the
+// CPU it runs on, modulo the number of sockets.
+TEST(NetworkUtility, SteerReusePortByCpu) {
+  const int cpu = sched_getcpu();
+  ASSERT_GE(cpu, 0);
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  ASSERT_EQ(0, sched_setaffinity(0, sizeof(cpu_set), &cpu_set));
+
+  std::vector<SocketSharedPtr> sockets;
+  Address::InstanceConstSharedPtr address = Utility::parseInternetAddressAndPort("127.0.0.1:0");
+  for (int i = 0; i < 2; i++) {
+    sockets.push_back(std::make_shared<TcpListenSocket>(
+        address, SocketOptionFactory::buildReusePortOptions(), true));
+    address = sockets[0]->localAddress();
+  }
+  Utility::steerReusePortByCpu(sockets);
+
+  const int client = ::socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_GE(client, 0);
+  ASSERT_EQ(0, address->connect(client).rc_);
+  const int expected = cpu % 2;
+  const int accepted = ::accept4(sockets[expected]->ioHandle().fd(), nullptr, nullptr,
+                                 SOCK_NONBLOCK);
+  EXPECT_GE(accepted, 0);
+  EXPECT_EQ(-1, ::accept4(sockets[1 - expected]->ioHandle().fd(), nullptr, nullptr,
+                          SOCK_NONBLOCK));
+  ::close(accepted);
+  ::close(client);
+}
+#endif
+
 TEST(NetworkUtility, ParseProtobufAddress) {
   {
     envoy::api::v2::core::Address proto_address;
@@ -0,0 +1,133 @@
+// Benchmarks for matching requests to the virtual hosts and routes of large route configurations.
+
+#include "envoy/api/v2/rds.pb.h"
+
+#include "common/router/config_impl.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+enum class RouteKind { Prefix, Path, PrefixAndRegex };
+
+/**
+ * Generates a virtual host with a number of routes for distinct services followed by a catch-all.
+ * With RouteKind::PrefixAndRegex every tenth route matches on a regex rather than a prefix.
+ */
+envoy::api::v2::RouteConfiguration generateRouteConfig(int64_t routes, RouteKind kind) {
+  envoy::api::v2::RouteConfiguration route_config;
+  auto* virtual_host = route_config.add_virtual_hosts();
+  virtual_host->set_name("service");
+  virtual_host->add_domains("*");
+  for (int64_t i = 0; i < routes; i++) {
+    auto* route = virtual_host->add_routes();
+    const std::string path = absl::StrCat("/service_", i, "/method");
+    if (kind == RouteKind::Path) {
+      route->mutable_match()->set_path(path);
+    } else if (kind == RouteKind::PrefixAndRegex && i % 10 == 0) {
+      route->mutable_match()->set_regex(absl::StrCat(path, "/[0-9]+"));
+    } else {
+      route->mutable_match()->set_prefix(path);
+    }
+    route->mutable_route()->set_cluster(absl::StrCat("cluster_", i));
+  }
+  auto* route = virtual_host->add_routes();
+  route->mutable_match()->set_prefix("/");
+  route->mutable_route()->set_cluster("default");
+  return route_config;
+}
+
+/**
+ * Measure the time to match a request to the last of the service routes, which is the route
+ * evaluated last when the routes are evaluated in order. The numeric Arg passed by the
+ * BENCHMARK(...) macro call below is the number of service routes.
+ */
+static void RouteMatch(benchmark::State& state, RouteKind kind) {
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  const ConfigImpl config(generateRouteConfig(state.range(0), kind), factory_context, false);
+  Http::TestHeaderMapImpl headers{
+      {":authority", "www.lyft.com"},
+      {":path", absl::StrCat("/service_", state.range(0) - 1, "/method")},
+      {":method", "GET"},
+      {"x-forwarded-proto", "http"}};
+  for (auto _ : state) {
+    RouteConstSharedPtr route = config.route(headers, 0);
+    benchmark::DoNotOptimize(route.get());
+  }
+}
+BENCHMARK_CAPTURE(RouteMatch, prefix, RouteKind::Prefix)->Arg(1)->Arg(10)->Arg(100)->Arg(2000);
+BENCHMARK_CAPTURE(RouteMatch, path, RouteKind::Path)->Arg(1)->Arg(10)->Arg(100)->Arg(2000);
+BENCHMARK_CAPTURE(RouteMatch, prefix_and_regex, RouteKind::PrefixAndRegex)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(2000);
+
+/**
+ * Measure the time to match a request which only matches the catch-all route. The numeric Arg
+ * passed by the BENCHMARK(...) macro call below is the number of service routes.
+ */
+static void RouteMatchCatchAll(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  const ConfigImpl config(generateRouteConfig(state.range(0), RouteKind::Prefix), factory_context,
+                          false);
+  Http::TestHeaderMapImpl headers{{":authority", "www.lyft.com"},
+                                  {":path", "/unknown/method"},
+                                  {":method", "GET"},
+                                  {"x-forwarded-proto", "http"}};
+  for (auto _ : state) {
+    RouteConstSharedPtr route = config.route(headers, 0);
+    benchmark::DoNotOptimize(route.get());
+  }
+}
+BENCHMARK(RouteMatchCatchAll)->Arg(1)->Arg(10)->Arg(100)->Arg(2000);
+
+/**
+ * Measure the time to select the virtual host for a request to one of many tenants, each with
+ * their own wildcard domain. The numeric Arg passed by the BENCHMARK(...) macro call below is the
+ * number of tenants.
+ */
+static void WildcardVirtualHostMatch(benchmark::State& state) {
+  envoy::api::v2::RouteConfiguration route_config;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    auto* virtual_host = route_config.add_virtual_hosts();
+    virtual_host->set_name(absl::StrCat("tenant_", i));
+    virtual_host->add_domains(absl::StrCat("*.tenant-", i, ".example.com"));
+    auto* route = virtual_host->add_routes();
+    route->mutable_match()->set_prefix("/");
+    route->mutable_route()->set_cluster(absl::StrCat("cluster_", i));
+  }
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  const ConfigImpl config(route_config, factory_context, false);
+  Http::TestHeaderMapImpl headers{
+      {":authority", absl::StrCat("www.tenant-", state.range(0) / 2, ".example.com")},
+      {":path", "/"},
+      {":method", "GET"},
+      {"x-forwarded-proto", "http"}};
+  for (auto _ : state) {
+    RouteConstSharedPtr route = config.route(headers, 0);
+    benchmark::DoNotOptimize(route.get());
+  }
+}
+BENCHMARK(WildcardVirtualHostMatch)->Arg(10)->Arg(100)->Arg(10000);
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
+
+BENCHMARK_MAIN();
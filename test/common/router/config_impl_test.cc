@@ -15,6 +15,7 @@
 #include "common/http/headers.h"
 #include "common/network/address_impl.h"
 #include "common/router/config_impl.h"
+#include "common/router/per_filter_config_ids.h"
 
 #include "extensions/filters/http/common/empty_http_filter_config.h"
 
@@ -610,6 +611,46 @@ virtual_hosts:
             config.route(genHeaders("example.com", "/", "GET"), 0)->routeEntry()->clusterName());
 }
 
+// Routes are matched in order whatever their kind, including header constrained, regex and case
+// insensitive routes which overlap with later ones.
+TEST_F(RouteMatcherTest, FirstMatchAcrossRouteKinds) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: local_service
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/api", headers: [{ name: "x-canary", exact_match: "true" }] }
+        route: { cluster: "canary" }
+      - match: { path: "/api/v1/users" }
+        route: { cluster: "users" }
+      - match: { regex: "/api/v1/.*/admin" }
+        route: { cluster: "admin" }
+      - match: { prefix: "/API/V1", case_sensitive: false }
+        route: { cluster: "v1" }
+      - match: { prefix: "/api/v1/users" }
+        route: { cluster: "users_prefix" }
+      - match: { prefix: "/" }
+        route: { cluster: "default" }
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
+  const auto cluster = [&config](const std::string& path) {
+    return config.route(genHeaders("www.lyft.com", path, "GET"), 0)->routeEntry()->clusterName();
+  };
+
+  EXPECT_EQ("users", cluster("/api/v1/users"));
+  EXPECT_EQ("users", cluster("/api/v1/users?active=true"));
+  EXPECT_EQ("admin", cluster("/api/v1/users/admin"));
+  EXPECT_EQ("v1", cluster("/api/v1/users/1"));
+  EXPECT_EQ("v1", cluster("/Api/V1/users"));
+  EXPECT_EQ("default", cluster("/api/v2/users"));
+  EXPECT_EQ("default", cluster("/other"));
+
+  Http::TestHeaderMapImpl canary_headers = genHeaders("www.lyft.com", "/api/v1/users", "GET");
+  canary_headers.addCopy("x-canary", "true");
+  EXPECT_EQ("canary", config.route(canary_headers, 0)->routeEntry()->clusterName());
+}
+
 TEST_F(RouteMatcherTest, TestRoutesWithInvalidRegex) {
   std::string invalid_route = R"EOF(
 virtual_hosts:
@@ -2114,6 +2155,31 @@ virtual_hosts:
   TestConfigImpl(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
 }
 
+// A referenced cluster which was added lazily is instantiated, and passes the validation although
+// it is still warming.
+TEST_F(RouteMatcherTest, LazyClusterInitialized) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- name: www2
+  domains:
+  - www.lyft.com
+  routes:
+  - match:
+      prefix: "/foo"
+    route:
+      cluster: www2
+  )EOF";
+
+  EXPECT_CALL(factory_context_.cluster_manager_, initializeLazyCluster("www2"))
+      .WillOnce(Return(true));
+  EXPECT_CALL(factory_context_.cluster_manager_, get(Eq("www2"))).Times(0);
+  TestConfigImpl(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
+
+  EXPECT_CALL(factory_context_.cluster_manager_, initializeLazyCluster("www2"))
+      .WillOnce(Return(true));
+  TestConfigImpl(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, false);
+}
+
 TEST_F(RouteMatcherTest, AttemptCountHeader) {
   const std::string yaml = R"EOF(
 virtual_hosts:
@@ -2214,6 +2280,7 @@ virtual_hosts:
       request_mirror_policy:
         cluster: some_cluster2
         runtime_key: foo
+        stream_body: true
       cluster: www2
   - match:
       prefix: "/baz"
@@ -2231,6 +2298,10 @@ virtual_hosts:
                     ->routeEntry()
                     ->shadowPolicy()
                     .runtimeKey());
+  EXPECT_FALSE(config.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)
+                   ->routeEntry()
+                   ->shadowPolicy()
+                   .streamBody());
 
   EXPECT_EQ("some_cluster2", config.route(genHeaders("www.lyft.com", "/bar", "GET"), 0)
                                  ->routeEntry()
@@ -2240,6 +2311,10 @@ virtual_hosts:
                        ->routeEntry()
                        ->shadowPolicy()
                        .runtimeKey());
+  EXPECT_TRUE(config.route(genHeaders("www.lyft.com", "/bar", "GET"), 0)
+                  ->routeEntry()
+                  ->shadowPolicy()
+                  .streamBody());
 
   EXPECT_EQ("", config.route(genHeaders("www.lyft.com", "/baz", "GET"), 0)
                     ->routeEntry()
@@ -2768,6 +2843,45 @@ virtual_hosts:
   EXPECT_EQ(0, percent.numerator());
 }
 
+TEST_F(RouteMatcherTest, HedgeOnLatency) {
+  const std::string yaml = R"EOF(
+name: HedgeOnLatency
+virtual_hosts:
+- domains: [www.lyft.com]
+  name: www
+  routes:
+  - match: {prefix: /foo}
+    route:
+      cluster: www
+      hedge_policy:
+        hedge_on_latency_percentile: {value: 95}
+        hedge_budget: {value: 2.5}
+  - match: {prefix: /bar}
+    route:
+      cluster: www
+      hedge_policy: {hedge_on_latency_percentile: {value: 99}}
+  - match: {prefix: /}
+    route: {cluster: www}
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
+
+  const HedgePolicy& foo_policy =
+      config.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)->routeEntry()->hedgePolicy();
+  EXPECT_EQ(95, foo_policy.hedgeOnLatencyPercentile().value());
+  EXPECT_EQ(2.5, foo_policy.hedgeBudgetPercent());
+
+  const HedgePolicy& bar_policy =
+      config.route(genHeaders("www.lyft.com", "/bar", "GET"), 0)->routeEntry()->hedgePolicy();
+  EXPECT_EQ(99, bar_policy.hedgeOnLatencyPercentile().value());
+  EXPECT_EQ(10, bar_policy.hedgeBudgetPercent());
+
+  const HedgePolicy& default_policy =
+      config.route(genHeaders("www.lyft.com", "/", "GET"), 0)->routeEntry()->hedgePolicy();
+  EXPECT_FALSE(default_policy.hedgeOnLatencyPercentile().has_value());
+  EXPECT_EQ(10, default_policy.hedgeBudgetPercent());
+}
+
 TEST_F(RouteMatcherTest, TestBadDefaultConfig) {
   const std::string yaml = R"EOF(
 virtual_hosts:
@@ -4319,6 +4433,45 @@ virtual_hosts:
   EXPECT_EQ(cors_policy->allowCredentials(), true);
 }
 
+TEST_F(RoutePropertyTest, TestCorsOriginMatching) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: "default"
+    domains: ["*"]
+    cors:
+      allow_origin: ["https://a.example.com", "https://b.example.com"]
+      allow_origin_regex: ["https://.*\\.envoyproxy\\.io", "https://(?!www).*\\.lyft\\.com"]
+    routes:
+      - match:
+          prefix: "/api"
+        route:
+          cluster: "ats"
+          cors:
+            allow_origin: ["*"]
+)EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, false);
+  const RouteEntry* route_entry =
+      config.route(genHeaders("api.lyft.com", "/api", "GET"), 0)->routeEntry();
+  const Router::CorsPolicy* cors_policy = route_entry->virtualHost().corsPolicy();
+
+  EXPECT_TRUE(cors_policy->allowOriginsContain("https://a.example.com"));
+  EXPECT_TRUE(cors_policy->allowOriginsContain("https://b.example.com"));
+  EXPECT_FALSE(cors_policy->allowOriginsContain("https://c.example.com"));
+  EXPECT_FALSE(cors_policy->allowOriginsContain("https://a.example.com.evil"));
+
+  // The first regex is matched through the RE2 set, the second, a lookahead RE2 does not support,
+  // with std::regex alone.
+  EXPECT_TRUE(cors_policy->allowOriginRegexesMatch("https://www.envoyproxy.io"));
+  EXPECT_FALSE(cors_policy->allowOriginRegexesMatch("https://www.envoyproxy.io.evil"));
+  EXPECT_TRUE(cors_policy->allowOriginRegexesMatch("https://api.lyft.com"));
+  EXPECT_FALSE(cors_policy->allowOriginRegexesMatch("https://www.lyft.com"));
+  EXPECT_FALSE(cors_policy->allowOriginRegexesMatch("https://a.example.com"));
+
+  EXPECT_TRUE(route_entry->corsPolicy()->allowOriginsContain("https://any.example.com"));
+  EXPECT_FALSE(route_entry->corsPolicy()->allowOriginRegexesMatch("https://www.envoyproxy.io"));
+}
+
 TEST_F(RoutePropertyTest, TestVHostCorsLegacyConfig) {
   const std::string yaml = R"EOF(
 virtual_hosts:
@@ -5499,6 +5652,74 @@ virtual_hosts:
   EXPECT_NE(predicates1, predicates2);
 }
 
+// Virtual hosts whose configuration has not changed are shared with the previous configuration.
+TEST_F(RouteConfigurationV2, ReusesUnchangedVirtualHosts) {
+  const std::string yaml = R"EOF(
+name: foo
+virtual_hosts:
+  - name: foo
+    domains: [foo.lyft.com]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: foo }
+  - name: bar
+    domains: ["*.bar.lyft.com"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: bar }
+  )EOF";
+  const auto virtual_host = [](const Config& config, const std::string& host) {
+    return &config.route(genHeaders(host, "/", "GET"), 0)->routeEntry()->virtual_host();
+  };
+
+  auto route_config = parseRouteConfigurationFromV2Yaml(yaml);
+  const ConfigImpl first(route_config, factory_context_, false);
+
+  route_config.mutable_virtual_hosts(1)->mutable_routes(0)->mutable_route()->set_cluster("baz");
+  const ConfigImpl second(route_config, factory_context_, false, &first);
+  EXPECT_EQ(virtual_host(first, "foo.lyft.com"), virtual_host(second, "foo.lyft.com"));
+  EXPECT_NE(virtual_host(first, "www.bar.lyft.com"), virtual_host(second, "www.bar.lyft.com"));
+  EXPECT_EQ("baz", second.route(genHeaders("www.bar.lyft.com", "/", "GET"), 0)
+                       ->routeEntry()
+                       ->clusterName());
+  EXPECT_EQ("foo", virtual_host(second, "foo.lyft.com")->routeConfig().name());
+
+  // Virtual hosts refer to the rest of the route configuration, so they are rebuilt when it
+  // changes.
+  route_config.add_internal_only_headers("x-internal");
+  const ConfigImpl third(route_config, factory_context_, false, &second);
+  EXPECT_NE(virtual_host(second, "foo.lyft.com"), virtual_host(third, "foo.lyft.com"));
+  EXPECT_EQ(1, virtual_host(third, "foo.lyft.com")->routeConfig().internalOnlyHeaders().size());
+
+  // Clusters are validated while building virtual hosts.
+  const ConfigImpl fourth(route_config, factory_context_, true, &third);
+  EXPECT_NE(virtual_host(third, "foo.lyft.com"), virtual_host(fourth, "foo.lyft.com"));
+}
+
+// Every field of the route configuration but the virtual hosts and validate_clusters affects the
+// part of it virtual hosts refer to, so a field added to it has to be handled there too.
+TEST_F(RouteConfigurationV2, CommonConfigFields) {
+  const Protobuf::Descriptor* descriptor = envoy::api::v2::RouteConfiguration::descriptor();
+  EXPECT_EQ(9, descriptor->field_count());
+
+  const std::string yaml = R"EOF(
+name: foo
+virtual_hosts:
+  - name: foo
+    domains: [foo.lyft.com]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: foo }
+  )EOF";
+  auto route_config = parseRouteConfigurationFromV2Yaml(yaml);
+  const uint64_t hash = CommonConfigImpl(route_config).hash();
+  route_config.mutable_virtual_hosts(0)->set_name("bar");
+  route_config.mutable_validate_clusters()->set_value(true);
+  EXPECT_EQ(hash, CommonConfigImpl(route_config).hash());
+  route_config.add_request_headers_to_remove("x-foo");
+  EXPECT_NE(hash, CommonConfigImpl(route_config).hash());
+}
+
 class PerFilterConfigsTest : public testing::Test, public ConfigImplTestBase {
 public:
   PerFilterConfigsTest()
@@ -5553,6 +5774,9 @@ public:
           "route");
     check(vhost.perFilterConfigTyped<DerivedFilterConfig>(factory_.name()), expected_vhost,
           "virtual host");
+    check(route->mostSpecificPerFilterConfigTyped<DerivedFilterConfig>(
+              PerFilterConfigIds::id(factory_.name())),
+          expected_entry, "most specific");
   }
 
   void check(const DerivedFilterConfig* cfg, uint32_t expected_seconds, std::string source) {
@@ -5572,6 +5796,8 @@ public:
               route_entry->perFilterConfigTyped<DerivedFilterConfig>(default_factory_.name()));
     EXPECT_EQ(nullptr, route->perFilterConfigTyped<DerivedFilterConfig>(default_factory_.name()));
     EXPECT_EQ(nullptr, vhost.perFilterConfigTyped<DerivedFilterConfig>(default_factory_.name()));
+    EXPECT_EQ(nullptr, route->mostSpecificPerFilterConfigTyped<DerivedFilterConfig>(
+                           PerFilterConfigIds::id(default_factory_.name())));
   }
 
   TestFilterConfig factory_;
@@ -5779,6 +6005,49 @@ virtual_hosts:
   checkEach(yaml, 1213, 1213, 1415);
 }
 
+TEST_F(PerFilterConfigsTest, VirtualHostFallthroughConfig) {
+  const std::string yaml = R"EOF(
+name: foo
+virtual_hosts:
+  - name: bar
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/" }
+        route:
+          weighted_clusters:
+            clusters:
+              - name: baz
+                weight: 100
+    per_filter_config: { test.filter: { seconds: 1617 } }
+)EOF";
+
+  const TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
+  const auto route = config.route(genHeaders("www.foo.com", "/", "GET"), 0);
+  EXPECT_EQ(nullptr, route->perFilterConfigTyped<DerivedFilterConfig>(factory_.name()));
+  check(route->mostSpecificPerFilterConfigTyped<DerivedFilterConfig>(
+            PerFilterConfigIds::id(factory_.name())),
+        1617, "most specific");
+}
+
+// A filter not configured on any route gets an id past the end of the merged configs.
+TEST_F(PerFilterConfigsTest, UnconfiguredFilterId) {
+  const std::string yaml = R"EOF(
+name: foo
+virtual_hosts:
+  - name: bar
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: baz }
+        per_filter_config: { test.filter: { seconds: 123 } }
+)EOF";
+
+  const TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
+  const auto route = config.route(genHeaders("www.foo.com", "/", "GET"), 0);
+  EXPECT_EQ(nullptr, route->mostSpecificPerFilterConfig(
+                         PerFilterConfigIds::id("test.filter.configured.nowhere")));
+}
+
 } // namespace
 } // namespace Router
 } // namespace Envoy
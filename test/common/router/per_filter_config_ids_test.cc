@@ -0,0 +1,21 @@
+#include "common/router/per_filter_config_ids.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+TEST(PerFilterConfigIdsTest, IdsAreStable) {
+  const uint32_t foo = PerFilterConfigIds::id("per_filter_config_ids_test.foo");
+  const uint32_t bar = PerFilterConfigIds::id("per_filter_config_ids_test.bar");
+  EXPECT_NE(foo, bar);
+  EXPECT_EQ(foo, PerFilterConfigIds::id("per_filter_config_ids_test.foo"));
+  EXPECT_EQ(bar, PerFilterConfigIds::id("per_filter_config_ids_test.bar"));
+  EXPECT_EQ("per_filter_config_ids_test.foo", PerFilterConfigIds::name(foo));
+  EXPECT_EQ("per_filter_config_ids_test.bar", PerFilterConfigIds::name(bar));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,118 @@
+#include <cstdint>
+#include <vector>
+
+#include "common/router/route_path_index.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+std::vector<uint32_t> candidates(const RoutePathIndex& index, absl::string_view path) {
+  std::vector<uint32_t> positions;
+  index.forEachCandidate(path, [&positions](uint32_t position) {
+    positions.push_back(position);
+    return true;
+  });
+  return positions;
+}
+
+TEST(RoutePathIndexTest, Empty) {
+  RoutePathIndex index;
+  index.compile();
+  EXPECT_EQ(std::vector<uint32_t>{}, candidates(index, "/"));
+  EXPECT_EQ(std::vector<uint32_t>{}, candidates(index, ""));
+}
+
+TEST(RoutePathIndexTest, Prefixes) {
+  RoutePathIndex index;
+  index.addPrefix("/foo/bar", 0);
+  index.addPrefix("/foo", 1);
+  index.addPrefix("/", 2);
+  index.addPrefix("/fob", 3);
+  index.addPrefix("", 4);
+  index.addPrefix("/foo", 5);
+  index.compile();
+
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 2, 4, 5}), candidates(index, "/foo/bar/baz"));
+  EXPECT_EQ((std::vector<uint32_t>{1, 2, 4, 5}), candidates(index, "/foo/ba"));
+  EXPECT_EQ((std::vector<uint32_t>{2, 3, 4}), candidates(index, "/fob"));
+  EXPECT_EQ((std::vector<uint32_t>{2, 4}), candidates(index, "/fo"));
+  EXPECT_EQ((std::vector<uint32_t>{4}), candidates(index, "foo"));
+  // Prefixes are matched against the query string too.
+  EXPECT_EQ((std::vector<uint32_t>{2, 4}), candidates(index, "/?/foo"));
+}
+
+TEST(RoutePathIndexTest, Paths) {
+  RoutePathIndex index;
+  index.addPath("/foo", 0);
+  index.addPath("/foo/bar", 1);
+  index.addPath("/fo", 2);
+  index.addPath("/foo", 3);
+  index.compile();
+
+  EXPECT_EQ((std::vector<uint32_t>{0, 3}), candidates(index, "/foo"));
+  EXPECT_EQ((std::vector<uint32_t>{0, 3}), candidates(index, "/foo?bar=baz"));
+  EXPECT_EQ((std::vector<uint32_t>{1}), candidates(index, "/foo/bar"));
+  EXPECT_EQ((std::vector<uint32_t>{2}), candidates(index, "/fo?"));
+  EXPECT_EQ(std::vector<uint32_t>{}, candidates(index, "/foo/"));
+  EXPECT_EQ(std::vector<uint32_t>{}, candidates(index, "/f"));
+}
+
+// Candidates of all kinds are visited in the order they were added, with unindexed routes
+// candidates for every path.
+TEST(RoutePathIndexTest, MixedOrder) {
+  RoutePathIndex index;
+  index.addUnindexed(0);
+  index.addPath("/foo/bar", 1);
+  index.addPrefix("/foo", 2);
+  index.addUnindexed(3);
+  index.addPath("/foo", 4);
+  index.addPrefix("/foo/bar", 5);
+  index.addPrefix("/", 6);
+  index.compile();
+
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 2, 3, 5, 6}), candidates(index, "/foo/bar"));
+  EXPECT_EQ((std::vector<uint32_t>{0, 2, 3, 4, 6}), candidates(index, "/foo"));
+  EXPECT_EQ((std::vector<uint32_t>{0, 3}), candidates(index, "bar"));
+}
+
+// Regular expressions RE2 supports are only candidates for the paths they may match, while others
+// are candidates for every path.
+TEST(RoutePathIndexTest, Regexes) {
+  RoutePathIndex index;
+  index.addRegex("/foo/[0-9]+", 0);
+  index.addPrefix("/foo", 1);
+  index.addRegex("(?!/bar)/.*", 2);
+  index.addRegex("/(foo|bar)/.*", 3);
+  index.addRegex("/foo", 4);
+  index.compile();
+
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 2, 3}), candidates(index, "/foo/123"));
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 2, 3}), candidates(index, "/foo/123?a=b"));
+  EXPECT_EQ((std::vector<uint32_t>{1, 2, 4}), candidates(index, "/foo?/123"));
+  EXPECT_EQ((std::vector<uint32_t>{2, 3}), candidates(index, "/bar/123"));
+  EXPECT_EQ((std::vector<uint32_t>{2}), candidates(index, "/baz"));
+  // Paths RE2 may match differently from std::regex are candidates for every regex.
+  EXPECT_EQ((std::vector<uint32_t>{0, 2, 3, 4}), candidates(index, "/\v"));
+}
+
+TEST(RoutePathIndexTest, StopsWhenCallbackReturnsFalse) {
+  RoutePathIndex index;
+  index.addPrefix("/foo", 0);
+  index.addPrefix("/", 1);
+  index.addUnindexed(2);
+  index.compile();
+
+  std::vector<uint32_t> positions;
+  index.forEachCandidate("/foo", [&positions](uint32_t position) {
+    positions.push_back(position);
+    return position < 1;
+  });
+  EXPECT_EQ((std::vector<uint32_t>{0, 1}), positions);
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -1595,8 +1595,12 @@ TEST_F(RouterTest, HedgedPerTryTimeoutFirstRequestSucceeds) {
       }));
   response_decoder1->decodeHeaders(std::move(response_headers), true);
   EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
-
-  // TODO: Verify hedge stats here once they are implemented.
+  EXPECT_EQ(1U, cm_.thread_local_cluster_.cluster_.info_->stats_store_
+                    .counter("upstream_rq_hedge_abandoned")
+                    .value());
+  EXPECT_EQ(0U, cm_.thread_local_cluster_.cluster_.info_->stats_store_
+                    .counter("upstream_rq_hedge_won")
+                    .value());
 }
 
 // Tests that an upstream request is reset even if it can't be retried as long as there is
@@ -2003,6 +2007,124 @@ TEST_F(RouterTest, HedgedPerTryTimeoutGlobalTimeout) {
   // TODO: Verify hedge stats here once they are implemented.
 }
 
+// The first request is hedged once it waits longer than the percentile of the response times of
+// the cluster, the hedge responds first and the first request is reset.
+TEST_F(RouterTest, HedgedOnLatencyHedgeWins) {
+  callbacks_.route_->route_entry_.hedge_policy_.hedge_on_latency_percentile_ = 90;
+  Upstream::MockHedgeTracker& hedge_tracker = *cm_.thread_local_cluster_.hedge_tracker_;
+
+  NiceMock<Http::MockStreamEncoder> encoder1;
+  Http::StreamDecoder* response_decoder1 = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder1 = &decoder;
+        EXPECT_CALL(*router_.retry_state_, onHostAttempted(_));
+        callbacks.onPoolReady(encoder1, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  EXPECT_CALL(cm_.conn_pool_.host_->outlier_detector_,
+              putResult(Upstream::Outlier::Result::LOCAL_ORIGIN_CONNECT_SUCCESS,
+                        absl::optional<uint64_t>(absl::nullopt)))
+      .Times(2);
+  EXPECT_CALL(hedge_tracker, responseTimePercentile(90))
+      .WillOnce(Return(std::chrono::microseconds(2500)));
+  Event::MockTimer* hedge_timeout = new Event::MockTimer(&callbacks_.dispatcher_);
+  // The delay is rounded up to the resolution of the timers.
+  EXPECT_CALL(*hedge_timeout, enableTimer(std::chrono::milliseconds(3)));
+  EXPECT_CALL(*hedge_timeout, disableTimer());
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  EXPECT_CALL(hedge_tracker, hedgeBudgetAvailable(10)).WillOnce(Return(true));
+  EXPECT_CALL(hedge_tracker, onHedge());
+  EXPECT_CALL(encoder1.stream_, resetStream(_)).Times(0);
+  router_.retry_state_->expectHedgedPerTryTimeoutRetry();
+  test_time_.sleep(std::chrono::milliseconds(3));
+  hedge_timeout->invokeCallback();
+
+  NiceMock<Http::MockStreamEncoder> encoder2;
+  Http::StreamDecoder* response_decoder2 = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder2 = &decoder;
+        EXPECT_CALL(*router_.retry_state_, onHostAttempted(_));
+        callbacks.onPoolReady(encoder2, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  // Only the first request is hedged.
+  EXPECT_CALL(hedge_tracker, responseTimePercentile(_)).Times(0);
+  router_.retry_state_->callback_();
+  EXPECT_EQ(1U, cm_.thread_local_cluster_.cluster_.info_->stats_store_
+                    .counter("upstream_rq_hedged")
+                    .value());
+
+  // The response time of the hedge is recorded, and the first request is reset.
+  test_time_.sleep(std::chrono::milliseconds(1));
+  EXPECT_CALL(hedge_tracker, recordResponseTime(std::chrono::microseconds(1000)));
+  EXPECT_CALL(cm_.conn_pool_.host_->outlier_detector_, putHttpResponseCode(200));
+  EXPECT_CALL(encoder1.stream_, resetStream(_));
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, true));
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "200"}});
+  response_decoder2->decodeHeaders(std::move(response_headers), true);
+  EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
+  EXPECT_EQ(1U, cm_.thread_local_cluster_.cluster_.info_->stats_store_
+                    .counter("upstream_rq_hedge_won")
+                    .value());
+  EXPECT_EQ(1U, cm_.thread_local_cluster_.cluster_.info_->stats_store_
+                    .counter("upstream_rq_hedge_abandoned")
+                    .value());
+}
+
+// A request is not hedged on latency once the hedge budget is exhausted.
+TEST_F(RouterTest, HedgedOnLatencyBudgetExceeded) {
+  callbacks_.route_->route_entry_.hedge_policy_.hedge_on_latency_percentile_ = 50;
+  callbacks_.route_->route_entry_.hedge_policy_.hedge_budget_percent_ = 5;
+  Upstream::MockHedgeTracker& hedge_tracker = *cm_.thread_local_cluster_.hedge_tracker_;
+
+  NiceMock<Http::MockStreamEncoder> encoder1;
+  Http::StreamDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder = &decoder;
+        EXPECT_CALL(*router_.retry_state_, onHostAttempted(_));
+        callbacks.onPoolReady(encoder1, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  EXPECT_CALL(hedge_tracker, responseTimePercentile(50))
+      .WillOnce(Return(std::chrono::microseconds(1000)));
+  Event::MockTimer* hedge_timeout = new Event::MockTimer(&callbacks_.dispatcher_);
+  EXPECT_CALL(*hedge_timeout, enableTimer(std::chrono::milliseconds(1)));
+  EXPECT_CALL(*hedge_timeout, disableTimer());
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  EXPECT_CALL(hedge_tracker, hedgeBudgetAvailable(5)).WillOnce(Return(false));
+  EXPECT_CALL(hedge_tracker, onHedge()).Times(0);
+  EXPECT_CALL(*router_.retry_state_, shouldHedgeRetryPerTryTimeout(_)).Times(0);
+  hedge_timeout->invokeCallback();
+  EXPECT_EQ(1U, cm_.thread_local_cluster_.cluster_.info_->stats_store_
+                    .counter("upstream_rq_hedge_budget_exceeded")
+                    .value());
+
+  EXPECT_CALL(hedge_tracker, recordResponseTime(_));
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, true));
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+  EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
+  EXPECT_EQ(0U, cm_.thread_local_cluster_.cluster_.info_->stats_store_
+                    .counter("upstream_rq_hedged")
+                    .value());
+}
+
 // Sequence: 1) per try timeout w/ hedge retry, 2) second request gets a 5xx
 // response, no retries remaining 3) first request gets a 5xx response.
 TEST_F(RouterTest, HedgingRetriesExhaustedBadResponse) {
@@ -3110,6 +3232,98 @@ TEST_F(RouterTest, Shadow) {
   EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
 }
 
+TEST_F(RouterTest, StreamingShadow) {
+  callbacks_.route_->route_entry_.shadow_policy_.cluster_ = "foo";
+  callbacks_.route_->route_entry_.shadow_policy_.stream_body_ = true;
+
+  NiceMock<Http::MockStreamEncoder> encoder;
+  Http::StreamDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder = &decoder;
+        callbacks.onPoolReady(encoder, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  expectResponseTimerCreate();
+
+  MockShadowStream* shadow_stream = new MockShadowStream();
+  EXPECT_CALL(*shadow_writer_, streamingShadow_("foo", _, std::chrono::milliseconds(10), 0, false))
+      .WillOnce(Return(shadow_stream));
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, false);
+
+  // The body is neither buffered nor copied, the shadow and the upstream sharing its slices.
+  Buffer::OwnedImpl body_data("hello");
+  const void* body_slice = body_data.linearize(5);
+  EXPECT_CALL(callbacks_, addDecodedData(_, _)).Times(0);
+  EXPECT_CALL(*shadow_stream, sendData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ("hello", data.toString());
+        EXPECT_EQ(body_slice, data.linearize(5));
+      }));
+  EXPECT_CALL(encoder, encodeData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ(body_slice, data.linearize(5));
+      }));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, router_.decodeData(body_data, false));
+
+  Http::TestHeaderMapImpl trailers{{"some", "trailer"}};
+  EXPECT_CALL(*shadow_stream, sendTrailers(HeaderMapEqualRef(&trailers)));
+  EXPECT_CALL(*shadow_writer_, shadow_(_, _, _)).Times(0);
+  router_.decodeTrailers(trailers);
+
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+  EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
+  router_.onDestroy();
+}
+
+// A shadow which falls behind the request is abandoned.
+TEST_F(RouterTest, StreamingShadowAboveBufferLimit) {
+  callbacks_.route_->route_entry_.shadow_policy_.cluster_ = "foo";
+  callbacks_.route_->route_entry_.shadow_policy_.stream_body_ = true;
+
+  NiceMock<Http::MockStreamEncoder> encoder;
+  Http::StreamDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder = &decoder;
+        callbacks.onPoolReady(encoder, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+
+  MockShadowStream* shadow_stream = new MockShadowStream();
+  EXPECT_CALL(*shadow_writer_, streamingShadow_("foo", _, _, _, false))
+      .WillOnce(Return(shadow_stream));
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, false);
+
+  Buffer::OwnedImpl data1("hello");
+  EXPECT_CALL(*shadow_stream, aboveBufferLimit()).WillOnce(Return(false));
+  EXPECT_CALL(*shadow_stream, sendData(_, false));
+  router_.decodeData(data1, false);
+
+  Buffer::OwnedImpl data2("world");
+  EXPECT_CALL(*shadow_stream, aboveBufferLimit()).WillOnce(Return(true));
+  EXPECT_CALL(*shadow_stream, sendData(_, _)).Times(0);
+  EXPECT_CALL(encoder, encodeData(_, true))
+      .WillOnce(Invoke(
+          [](Buffer::Instance& data, bool) -> void { EXPECT_EQ("world", data.toString()); }));
+  expectResponseTimerCreate();
+  router_.decodeData(data2, true);
+  EXPECT_EQ(1U, cm_.thread_local_cluster_.cluster_.info_->stats_store_
+                    .counter("retry_or_shadow_abandoned")
+                    .value());
+
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+  router_.onDestroy();
+}
+
 TEST_F(RouterTest, AltStatName) {
   // Also test no upstream timeout here.
   EXPECT_CALL(callbacks_.route_->route_entry_, timeout())
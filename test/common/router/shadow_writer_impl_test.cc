@@ -1,10 +1,14 @@
 #include <chrono>
 #include <string>
 
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 #include "common/http/message_impl.h"
 #include "common/router/shadow_writer_impl.h"
 
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/http/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 
 #include "gmock/gmock.h"
@@ -42,9 +46,33 @@ public:
     writer_.shadow("foo", std::move(message), std::chrono::milliseconds(5));
   }
 
+  ShadowStreamPtr expectStreamingShadow(bool end_stream) {
+    Http::HeaderMapPtr headers{new Http::HeaderMapImpl()};
+    headers->insertHost().value(std::string("cluster1"));
+    EXPECT_CALL(cm_, get(Eq("foo")));
+    EXPECT_CALL(cm_, httpAsyncClientForCluster("foo")).WillOnce(ReturnRef(cm_.async_client_));
+    EXPECT_CALL(cm_.async_client_, start(_, Http::AsyncClient::StreamOptions()
+                                                .setTimeout(std::chrono::milliseconds(5))
+                                                .setBufferLimit(1024)))
+        .WillOnce(Invoke(
+            [&](Http::AsyncClient::StreamCallbacks& callbacks,
+                const Http::AsyncClient::StreamOptions&) -> Http::AsyncClient::Stream* {
+              stream_callbacks_ = &callbacks;
+              return &stream_;
+            }));
+    EXPECT_CALL(stream_, sendHeaders(_, end_stream))
+        .WillOnce(Invoke([](Http::HeaderMap& headers, bool) -> void {
+          EXPECT_EQ("cluster1-shadow", headers.Host()->value().getStringView());
+        }));
+    return writer_.streamingShadow("foo", std::move(headers), std::chrono::milliseconds(5), 1024,
+                                   end_stream);
+  }
+
   Upstream::MockClusterManager cm_;
   ShadowWriterImpl writer_{cm_};
   Http::AsyncClient::Callbacks* callback_{};
+  Http::MockAsyncClientStream stream_;
+  Http::AsyncClient::StreamCallbacks* stream_callbacks_{};
 };
 
 TEST_F(ShadowWriterImplTest, Success) {
@@ -71,6 +99,64 @@ TEST_F(ShadowWriterImplTest, NoCluster) {
   writer_.shadow("foo", std::move(message), std::chrono::milliseconds(5));
 }
 
+TEST_F(ShadowWriterImplTest, StreamingNoCluster) {
+  EXPECT_CALL(cm_, get(Eq("foo"))).WillOnce(Return(nullptr));
+  EXPECT_CALL(cm_, httpAsyncClientForCluster("foo")).Times(0);
+  EXPECT_EQ(nullptr, writer_.streamingShadow("foo", Http::HeaderMapPtr{new Http::HeaderMapImpl()},
+                                             std::chrono::milliseconds(5), 1024, false));
+}
+
+// The shadow outlives the stream once the whole request has been sent.
+TEST_F(ShadowWriterImplTest, StreamingComplete) {
+  ShadowStreamPtr shadow = expectStreamingShadow(false);
+
+  Buffer::OwnedImpl data("hello");
+  EXPECT_CALL(stream_, sendData(BufferStringEqual("hello"), false));
+  shadow->sendData(data, false);
+
+  EXPECT_CALL(stream_, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  EXPECT_TRUE(shadow->aboveBufferLimit());
+
+  Http::HeaderMapImpl trailers;
+  trailers.addCopy(Http::LowerCaseString("some"), "trailer");
+  EXPECT_CALL(stream_, sendTrailers(HeaderMapEqualRef(&trailers)));
+  shadow->sendTrailers(trailers);
+
+  EXPECT_CALL(stream_, reset()).Times(0);
+  shadow.reset();
+  stream_callbacks_->onComplete();
+}
+
+// A shadow which is missing the end of the request is reset.
+TEST_F(ShadowWriterImplTest, StreamingIncomplete) {
+  ShadowStreamPtr shadow = expectStreamingShadow(false);
+
+  EXPECT_CALL(stream_, reset()).WillOnce(Invoke([&]() -> void { stream_callbacks_->onReset(); }));
+  shadow.reset();
+}
+
+TEST_F(ShadowWriterImplTest, StreamingHeadersOnly) {
+  ShadowStreamPtr shadow = expectStreamingShadow(true);
+
+  EXPECT_CALL(stream_, reset()).Times(0);
+  shadow.reset();
+  stream_callbacks_->onComplete();
+}
+
+// Nothing more is sent once the shadow has completed.
+TEST_F(ShadowWriterImplTest, StreamingShadowCompletesFirst) {
+  ShadowStreamPtr shadow = expectStreamingShadow(false);
+  stream_callbacks_->onReset();
+
+  Buffer::OwnedImpl data("hello");
+  EXPECT_CALL(stream_, sendData(_, _)).Times(0);
+  EXPECT_CALL(stream_, isAboveWriteBufferHighWatermark()).Times(0);
+  EXPECT_CALL(stream_, reset()).Times(0);
+  shadow->sendData(data, false);
+  EXPECT_FALSE(shadow->aboveBufferLimit());
+  shadow.reset();
+}
+
 } // namespace
 } // namespace Router
 } // namespace Envoy
@@ -0,0 +1,60 @@
+#include "common/router/wildcard_domain_trie.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using Trie = WildcardDomainTrie<int>;
+
+int find(const Trie& trie, absl::string_view host) {
+  const int* value = trie.find(host);
+  return value == nullptr ? -1 : *value;
+}
+
+TEST(WildcardDomainTrieTest, Empty) {
+  const Trie trie(Trie::Wildcard::Suffix);
+  EXPECT_TRUE(trie.empty());
+  EXPECT_EQ(-1, find(trie, "foo.com"));
+  EXPECT_EQ(-1, find(trie, ""));
+}
+
+TEST(WildcardDomainTrieTest, Suffixes) {
+  Trie trie(Trie::Wildcard::Suffix);
+  EXPECT_TRUE(trie.add(".foo.com", 0));
+  EXPECT_TRUE(trie.add("-bar.foo.com", 1));
+  EXPECT_TRUE(trie.add(".bar.foo.com", 2));
+  EXPECT_TRUE(trie.add("o.com", 3));
+  EXPECT_FALSE(trie.add(".foo.com", 4));
+  EXPECT_FALSE(trie.empty());
+
+  EXPECT_EQ(0, find(trie, "www.foo.com"));
+  EXPECT_EQ(1, find(trie, "baz-bar.foo.com"));
+  EXPECT_EQ(2, find(trie, "www.bar.foo.com"));
+  EXPECT_EQ(0, find(trie, "bar.foo.com"));
+  EXPECT_EQ(3, find(trie, "zoo.com"));
+  EXPECT_EQ(3, find(trie, ".foo.com"));
+  // The wildcard must match at least one character.
+  EXPECT_EQ(-1, find(trie, "o.com"));
+  EXPECT_EQ(-1, find(trie, "foo.org"));
+}
+
+TEST(WildcardDomainTrieTest, Prefixes) {
+  Trie trie(Trie::Wildcard::Prefix);
+  EXPECT_TRUE(trie.add("foo.", 0));
+  EXPECT_TRUE(trie.add("foo-bar.", 1));
+  EXPECT_TRUE(trie.add("foo", 2));
+  EXPECT_FALSE(trie.add("foo-bar.", 3));
+
+  EXPECT_EQ(0, find(trie, "foo.com"));
+  EXPECT_EQ(1, find(trie, "foo-bar.com"));
+  EXPECT_EQ(2, find(trie, "foo-bar"));
+  EXPECT_EQ(2, find(trie, "foo."));
+  EXPECT_EQ(-1, find(trie, "foo"));
+  EXPECT_EQ(-1, find(trie, "bar.foo.com"));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
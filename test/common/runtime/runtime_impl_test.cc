@@ -1,5 +1,7 @@
+#include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/config/runtime_utility.h"
 #include "common/runtime/runtime_impl.h"
@@ -15,6 +17,7 @@
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/environment.h"
 
+#include "absl/strings/str_cat.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -610,6 +613,44 @@ TEST_F(StaticLoaderImplTest, ProtoParsing) {
   EXPECT_EQ(2, store_.gauge("runtime.num_layers", Stats::Gauge::ImportMode::NeverImport).value());
 }
 
+// Validate that registered keys look up the same values as their names.
+TEST_F(StaticLoaderImplTest, RegisteredKeys) {
+  const Key integer_key("keys_test.integer");
+  const Key percent_key("keys_test.percent");
+  EXPECT_EQ(integer_key.index(), Key("keys_test.integer").index());
+  EXPECT_NE(integer_key.index(), percent_key.index());
+
+  base_ = TestUtility::parseYaml<ProtobufWkt::Struct>(R"EOF(
+    keys_test.integer: 3
+    keys_test.percent:
+      numerator: 5
+      denominator: TEN_THOUSAND
+  )EOF");
+  setup();
+
+  envoy::type::FractionalPercent fractional_percent;
+  EXPECT_EQ(3UL, loader_->snapshot().getInteger(integer_key, 1));
+  EXPECT_TRUE(loader_->snapshot().featureEnabled(integer_key, 0, 2));
+  EXPECT_FALSE(loader_->snapshot().featureEnabled(integer_key, 0, 3));
+  EXPECT_TRUE(loader_->snapshot().featureEnabled(percent_key, fractional_percent, 4));
+  EXPECT_FALSE(loader_->snapshot().featureEnabled(percent_key, fractional_percent, 5));
+  EXPECT_CALL(generator_, random()).WillOnce(Return(4));
+  EXPECT_TRUE(loader_->snapshot().featureEnabled(percent_key, fractional_percent));
+
+  // Keys registered after the snapshot was created are looked up by name.
+  const Key late_key("keys_test.late");
+  loader_->mergeValues({{"keys_test.late", "7"}});
+  const Key later_key("keys_test.later");
+  EXPECT_EQ(7UL, loader_->snapshot().getInteger(late_key, 1));
+  EXPECT_EQ(1UL, loader_->snapshot().getInteger(later_key, 1));
+  loader_->mergeValues({{"keys_test.later", "8"}});
+  EXPECT_EQ(8UL, loader_->snapshot().getInteger(later_key, 1));
+
+  // Values overridden in the admin layer are indexed too.
+  loader_->mergeValues({{"keys_test.integer", "0"}});
+  EXPECT_FALSE(loader_->snapshot().featureEnabled(integer_key, 100));
+}
+
 TEST_F(StaticLoaderImplTest, RuntimeFromNonWorkerThreads) {
   // Force the thread to be considered a non-worker thread.
   tls_.registered_ = false;
@@ -667,6 +708,37 @@ TEST_F(StaticLoaderImplTest, RuntimeFromNonWorkerThreads) {
   EXPECT_EQ(original_thread_snapshot_pointer, original_snapshot_pointer);
 }
 
+// Validate that non-worker threads always read a complete snapshot while new ones are loaded.
+TEST_F(StaticLoaderImplTest, ConcurrentThreadsafeSnapshots) {
+  tls_.registered_ = false;
+  setup();
+  loader_->mergeValues({{"foo", "0"}, {"bar", "0"}});
+
+  std::atomic<bool> done{false};
+  std::vector<Thread::ThreadPtr> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&]() {
+      uint64_t last = 0;
+      while (!done) {
+        std::shared_ptr<const Snapshot> snapshot = loader_->threadsafeSnapshot();
+        const uint64_t foo = snapshot->getInteger("foo", 0);
+        EXPECT_EQ(foo, snapshot->getInteger("bar", 0));
+        EXPECT_LE(last, foo);
+        last = foo;
+      }
+    }));
+  }
+
+  for (uint64_t i = 1; i <= 100; ++i) {
+    loader_->mergeValues({{"foo", absl::StrCat(i)}, {"bar", absl::StrCat(i)}});
+  }
+  done = true;
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  EXPECT_EQ(100UL, loader_->threadsafeSnapshot()->getInteger("foo", 0));
+}
+
 class DiskLayerTest : public testing::Test {
 protected:
   DiskLayerTest() : api_(Api::createApiForTest()) {}
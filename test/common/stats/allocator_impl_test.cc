@@ -1,4 +1,6 @@
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "common/stats/allocator_impl.h"
 #include "common/stats/fake_symbol_table_impl.h"
@@ -73,6 +75,62 @@ TEST_F(AllocatorImplTest, GaugesWithSameName) {
   EXPECT_EQ(0, g2->value());
 }
 
+TEST_F(AllocatorImplTest, GaugeLatchChanged) {
+  GaugeSharedPtr gauge = alloc_.makeGauge(makeStat("gauge.name"), "", std::vector<Tag>(),
+                                          Gauge::ImportMode::Accumulate);
+  EXPECT_FALSE(gauge->latchChanged());
+
+  gauge->set(5);
+  EXPECT_TRUE(gauge->latchChanged());
+  EXPECT_FALSE(gauge->latchChanged());
+
+  // Setting the same value, or adding 0, is not a change.
+  gauge->set(5);
+  gauge->add(0);
+  EXPECT_FALSE(gauge->latchChanged());
+  EXPECT_TRUE(gauge->used());
+
+  gauge->inc();
+  gauge->dec();
+  EXPECT_TRUE(gauge->latchChanged());
+  gauge->sub(5);
+  EXPECT_TRUE(gauge->latchChanged());
+  EXPECT_FALSE(gauge->latchChanged());
+}
+
+TEST_F(AllocatorImplTest, ShardedCounter) {
+  StatName counter_name = makeStat("counter.name");
+  CounterSharedPtr counter = alloc_.makeShardedCounter(counter_name, "", std::vector<Tag>());
+  EXPECT_FALSE(counter->used());
+
+  // Increment from more threads than there are shards, so that some shards are shared.
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < 2 * AllocatorImpl::NumCounterShards; i++) {
+    threads.emplace_back([&counter]() {
+      for (uint32_t j = 0; j < 1000; j++) {
+        counter->inc();
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  const uint64_t expected = 2 * AllocatorImpl::NumCounterShards * 1000;
+  EXPECT_TRUE(counter->used());
+  EXPECT_EQ(expected, counter->value());
+  EXPECT_EQ(expected, counter->latch());
+  EXPECT_EQ(0, counter->latch());
+
+  counter->add(5);
+  EXPECT_EQ(expected + 5, counter->value());
+  EXPECT_EQ(5, counter->latch());
+  counter->reset();
+  EXPECT_EQ(0, counter->value());
+
+  // Looking up the name again returns the same counter, whichever way it was made.
+  EXPECT_EQ(counter.get(), alloc_.makeCounter(counter_name, "", std::vector<Tag>()).get());
+}
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
@@ -35,6 +35,18 @@ TEST_F(MetricImplTest, NoTags) {
   EXPECT_EQ(0, counter->tags().size());
 }
 
+// A tag-extracted name equal to the name shares its storage.
+TEST_F(MetricImplTest, TagExtractedNameIsName) {
+  CounterSharedPtr counter = alloc_.makeCounter(makeStat("counter.name"), "counter.name", {});
+  EXPECT_EQ("counter.name", counter->tagExtractedName());
+  EXPECT_EQ(counter->statName().data(), counter->tagExtractedStatName().data());
+  EXPECT_EQ(0, counter->tags().size());
+
+  CounterSharedPtr other = alloc_.makeCounter(makeStat("other.name"), "other", {});
+  EXPECT_EQ("other", other->tagExtractedName());
+  EXPECT_EQ(0, other->tags().size());
+}
+
 TEST_F(MetricImplTest, OneTag) {
   CounterSharedPtr counter =
       alloc_.makeCounter(makeStat("counter.name.value"), "counter", {{"name", "value"}});
@@ -68,6 +68,25 @@ TEST_F(StatMergerTest, counterMerge) {
   EXPECT_EQ(4, store_.counter("draculaer").latch());
 }
 
+TEST_F(StatMergerTest, statNameMerge) {
+  StatNamePool pool(store_.symbolTable());
+  store_.counter("draculaer").inc();
+  EXPECT_EQ(1, store_.counter("draculaer").latch());
+
+  StatMerger::StatNameValues counter_deltas{{pool.add("draculaer"), 2}};
+  StatMerger::StatNameValues gauges{{pool.add("whywassixafraidofseven"), 111},
+                                    {pool.add("newgauge"), 5}};
+  stat_merger_.mergeStats(counter_deltas, gauges);
+  EXPECT_EQ(3, store_.counter("draculaer").value());
+  EXPECT_EQ(789, whywassixafraidofseven_.value());
+  EXPECT_EQ(5, store_.gauge("newgauge", Gauge::ImportMode::Accumulate).value());
+
+  // Gauges take the difference with the previous value of the parent.
+  gauges = {{pool.add("whywassixafraidofseven"), 100}};
+  stat_merger_.mergeStats(StatMerger::StatNameValues{}, gauges);
+  EXPECT_EQ(778, whywassixafraidofseven_.value());
+}
+
 TEST_F(StatMergerTest, basicDefaultAccumulationImport) {
   Protobuf::Map<std::string, uint64_t> gauges;
   gauges["whywassixafraidofseven"] = 111;
@@ -54,6 +54,51 @@ static void BM_CreateRace(benchmark::State& state) {
 }
 BENCHMARK(BM_CreateRace);
 
+// The symbol table shared by the threads of the benchmarks below, which is
+// created and destroyed by their first thread.
+static Envoy::Stats::SymbolTableImpl* shared_table = nullptr;
+static Envoy::Stats::StatNameStorage* shared_stat_name = nullptr;
+
+static void setUpSharedTable(benchmark::State& state) {
+  if (state.thread_index == 0) {
+    shared_table = new Envoy::Stats::SymbolTableImpl;
+    shared_stat_name = new Envoy::Stats::StatNameStorage("cluster.service.upstream_rq_2xx",
+                                                         *shared_table);
+  }
+}
+
+static void tearDownSharedTable(benchmark::State& state) {
+  if (state.thread_index == 0) {
+    shared_stat_name->free(*shared_table);
+    delete shared_stat_name;
+    delete shared_table;
+  }
+}
+
+// Encodes a name whose symbols are all established, as dynamic stat names do
+// at request time, from several threads. Only the reference counts of the
+// symbols are updated, with the table lock held shared.
+static void BM_EncodeEstablishedRace(benchmark::State& state) {
+  setUpSharedTable(state);
+  for (auto _ : state) {
+    Envoy::Stats::StatNameStorage storage("cluster.service.upstream_rq_2xx", *shared_table);
+    storage.free(*shared_table);
+  }
+  tearDownSharedTable(state);
+}
+BENCHMARK(BM_EncodeEstablishedRace)->ThreadRange(1, 16)->UseRealTime();
+
+// Decodes a name from several threads, as the admin handlers and the stats
+// sinks do while the workers encode.
+static void BM_DecodeRace(benchmark::State& state) {
+  setUpSharedTable(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(shared_table->toString(shared_stat_name->statName()));
+  }
+  tearDownSharedTable(state);
+}
+BENCHMARK(BM_DecodeRace)->ThreadRange(1, 16)->UseRealTime();
+
 int main(int argc, char** argv) {
   Envoy::Thread::MutexBasicLockable lock;
   Envoy::Logger::Context logger_context(spdlog::level::warn,
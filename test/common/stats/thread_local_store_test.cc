@@ -655,6 +655,33 @@ TEST_F(StatsMatcherTLSTest, TestExclusionRegex) {
   store_->shutdownThreading();
 }
 
+TEST_F(StatsMatcherTLSTest, ShardedCounters) {
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  auto* matcher = new MockStatsMatcher;
+  store_->setShardedCounterMatcher(StatsMatcherPtr(matcher));
+
+  // The matcher is only consulted when a counter is created, and never for the other stats.
+  EXPECT_CALL(*matcher, rejects("hot_counter")).WillOnce(Return(false));
+  EXPECT_CALL(*matcher, rejects("cold_counter")).WillOnce(Return(true));
+  for (int i = 0; i < 5; ++i) {
+    store_->counter("hot_counter").inc();
+    store_->counter("cold_counter").add(2);
+  }
+  store_->gauge("hot_gauge", Gauge::ImportMode::Accumulate).inc();
+
+  Counter& hot_counter = store_->counter("hot_counter");
+  EXPECT_EQ("hot_counter", hot_counter.name());
+  EXPECT_TRUE(hot_counter.used());
+  EXPECT_EQ(5, hot_counter.value());
+  EXPECT_EQ(5, hot_counter.latch());
+  EXPECT_EQ(10, store_->counter("cold_counter").value());
+  EXPECT_EQ(&hot_counter, TestUtility::findCounter(*store_, "hot_counter").get());
+
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+}
+
 // Tests the logic for caching the stats-matcher results, and in particular the
 // private impl method checkAndRememberRejection(). That method behaves
 // differently depending on whether TLS is enabled or not, so we parameterize
@@ -1079,6 +1106,62 @@ TEST_F(HistogramTest, BasicHistogramMergeSummary) {
             name_histogram_map["h1"]->cumulativeStatistics().bucketSummary());
 }
 
+// Merges without new samples reset the interval statistics once, and keep the cumulative ones.
+TEST_F(HistogramTest, MergeWithoutNewSamples) {
+  Histogram& h1 = store_->histogram("h1");
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), _)).Times(2);
+  h1.recordValue(10);
+  h1.recordValue(20);
+  store_->mergeHistograms([]() -> void {});
+
+  const ParentHistogramSharedPtr histogram = store_->histograms()[0];
+  EXPECT_EQ(2, histogram->intervalStatistics().sampleCount());
+  EXPECT_EQ(2, histogram->cumulativeStatistics().sampleCount());
+  const std::vector<uint64_t> cumulative_buckets =
+      histogram->cumulativeStatistics().computedBuckets();
+
+  for (int i = 0; i < 2; i++) {
+    bool merge_called = false;
+    store_->mergeHistograms([&merge_called]() -> void { merge_called = true; });
+    EXPECT_TRUE(merge_called);
+    EXPECT_EQ(0, histogram->intervalStatistics().sampleCount());
+    EXPECT_EQ(0, histogram->intervalStatistics().computedBuckets().back());
+    EXPECT_EQ(2, histogram->cumulativeStatistics().sampleCount());
+    EXPECT_EQ(cumulative_buckets, histogram->cumulativeStatistics().computedBuckets());
+    EXPECT_TRUE(histogram->used());
+  }
+}
+
+// The histograms matched by the histogram settings have their buckets, sorted and deduplicated.
+TEST_F(HistogramTest, CustomBuckets) {
+  envoy::config::metrics::v2::StatsConfig config;
+  envoy::config::metrics::v2::HistogramBucketSettings* settings =
+      config.add_histogram_bucket_settings();
+  settings->mutable_match()->set_exact("h1");
+  settings->add_buckets(10);
+  settings->add_buckets(1);
+  settings->add_buckets(10);
+  store_->setHistogramSettings(std::make_unique<HistogramSettingsImpl>(config));
+
+  Histogram& h1 = store_->histogram("h1");
+  Histogram& h2 = store_->histogram("h2");
+  for (size_t i = 0; i < 100; ++i) {
+    expectCallAndAccumulate(h1, i);
+  }
+  expectCallAndAccumulate(h2, 1);
+  store_->mergeHistograms([]() -> void {});
+
+  NameHistogramMap name_histogram_map = makeHistogramMap(store_->histograms());
+  const HistogramStatistics& h1_statistics = name_histogram_map["h1"]->cumulativeStatistics();
+  EXPECT_EQ(std::vector<double>({1, 10}), h1_statistics.supportedBuckets());
+  EXPECT_EQ("B1: 1, B10: 10", h1_statistics.bucketSummary());
+  EXPECT_EQ("B1(1,1) B10(10,10)", name_histogram_map["h1"]->bucketSummary());
+  EXPECT_EQ(HistogramSettingsImpl::defaultBuckets(),
+            name_histogram_map["h2"]->cumulativeStatistics().supportedBuckets());
+  EXPECT_EQ(HistogramSettingsImpl::defaultBuckets().size(),
+            name_histogram_map["h2"]->intervalStatistics().computedBuckets().size());
+}
+
 TEST_F(HistogramTest, BasicHistogramUsed) {
   ScopePtr scope1 = store_->createScope("scope1.");
 
@@ -792,6 +792,41 @@ TEST_F(TcpConnPoolImplTest, ConcurrentConnections) {
   dispatcher_.clearDeferredDeleteList();
 }
 
+/**
+ * Test that connections are opened ahead of requests with a preconnect ratio.
+ */
+TEST_F(TcpConnPoolImplTest, Preconnect) {
+  cluster_->resetResourceManager(3, 1024, 1024, 1, 1);
+  cluster_->per_upstream_preconnect_ratio_ = 1.5;
+
+  // The first request opens a connection for itself and another for the next request.
+  std::unique_ptr<ActiveTestConn> c1;
+  {
+    InSequence s;
+    conn_pool_.expectConnCreate();
+    c1 = std::make_unique<ActiveTestConn>(*this, 0, ActiveTestConn::Type::CreateConnection);
+  }
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_total_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_.value());
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // The second request is assigned the preconnected connection right away, and opens another.
+  conn_pool_.expectConnCreate();
+  ActiveTestConn c2(*this, 1, ActiveTestConn::Type::Immediate);
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_total_.value());
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_preconnect_.value());
+
+  EXPECT_CALL(conn_pool_, onConnReleasedForTest()).Times(2);
+  c1->releaseConn();
+  c2.releaseConn();
+
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest()).Times(3);
+  conn_pool_.test_conns_[2].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+}
+
 /**
  * Tests ConnectionState lifecycle with multiple concurrent connections.
  */
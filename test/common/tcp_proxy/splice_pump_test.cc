@@ -0,0 +1,171 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "common/event/dispatcher_impl.h"
+#include "common/tcp_proxy/splice_pump.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace TcpProxy {
+namespace {
+
+class TestSplicePumpCallbacks : public SplicePumpCallbacks {
+public:
+  void onDownstreamBytesSpliced(uint64_t bytes) override { downstream_bytes_ += bytes; }
+  void onUpstreamBytesSpliced(uint64_t bytes) override { upstream_bytes_ += bytes; }
+  void onSpliceComplete(bool error) override {
+    complete_ = true;
+    error_ = error;
+  }
+
+  uint64_t downstream_bytes_{};
+  uint64_t upstream_bytes_{};
+  bool complete_{};
+  bool error_{};
+};
+
+// The pump sits between the proxy ends of two socket pairs, which stand in for the downstream and
+// upstream connections. The test reads and writes the peer ends.
+class SplicePumpTest : public testing::Test {
+protected:
+  SplicePumpTest() : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher()) {}
+
+  void SetUp() override {
+    if (!SplicePump::isSupported()) {
+      GTEST_SKIP() << "splice is not supported on this platform";
+    }
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, downstream_));
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, upstream_));
+  }
+
+  void TearDown() override {
+    pump_.reset();
+    for (int fd : {downstream_[0], downstream_[1], upstream_[0], upstream_[1]}) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  void createPump(uint32_t pipe_size = 0) {
+    pump_ = std::make_unique<SplicePump>(*dispatcher_, downstream_[1], upstream_[1], pipe_size,
+                                         callbacks_);
+  }
+
+  void run() { dispatcher_->run(Event::Dispatcher::RunType::NonBlock); }
+
+  std::string readAll(int fd) {
+    std::string data;
+    char buf[4096];
+    ssize_t rc;
+    while ((rc = read(fd, buf, sizeof(buf))) > 0) {
+      data.append(buf, rc);
+    }
+    return data;
+  }
+
+  void writeAll(int fd, const std::string& data) {
+    ASSERT_EQ(static_cast<ssize_t>(data.size()), write(fd, data.data(), data.size()));
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  TestSplicePumpCallbacks callbacks_;
+  std::unique_ptr<SplicePump> pump_;
+  // Index 0 is the client or server end, index 1 is the end owned by the proxy.
+  int downstream_[2]{-1, -1};
+  int upstream_[2]{-1, -1};
+};
+
+TEST_F(SplicePumpTest, BothDirections) {
+  createPump();
+  writeAll(downstream_[0], "hello");
+  run();
+  EXPECT_EQ("hello", readAll(upstream_[0]));
+  EXPECT_EQ(5, callbacks_.downstream_bytes_);
+
+  writeAll(upstream_[0], "world!");
+  run();
+  EXPECT_EQ("world!", readAll(downstream_[0]));
+  EXPECT_EQ(6, callbacks_.upstream_bytes_);
+  EXPECT_FALSE(callbacks_.complete_);
+}
+
+// Data written before the pump was created is still forwarded.
+TEST_F(SplicePumpTest, DataQueuedBeforeCreation) {
+  writeAll(downstream_[0], "early");
+  createPump();
+  run();
+  EXPECT_EQ("early", readAll(upstream_[0]));
+}
+
+TEST_F(SplicePumpTest, HalfCloseThenComplete) {
+  createPump();
+  writeAll(downstream_[0], "request");
+  shutdown(downstream_[0], SHUT_WR);
+  run();
+  EXPECT_EQ("request", readAll(upstream_[0]));
+  // The downstream end of stream was propagated to upstream.
+  char c;
+  EXPECT_EQ(0, read(upstream_[0], &c, 1));
+  EXPECT_FALSE(callbacks_.complete_);
+
+  writeAll(upstream_[0], "response");
+  shutdown(upstream_[0], SHUT_WR);
+  run();
+  EXPECT_EQ("response", readAll(downstream_[0]));
+  EXPECT_TRUE(callbacks_.complete_);
+  EXPECT_FALSE(callbacks_.error_);
+}
+
+// When the destination does not read, the pump stops once the socket buffers and the pipe are
+// full and resumes when the destination drains.
+TEST_F(SplicePumpTest, Backpressure) {
+  createPump(4096);
+  const std::string chunk(4096, 'a');
+  uint64_t written = 0;
+  // Fill everything between the downstream client and the upstream server.
+  for (int i = 0; i < 1024; i++) {
+    const ssize_t rc = write(downstream_[0], chunk.data(), chunk.size());
+    if (rc <= 0) {
+      run();
+      if (write(downstream_[0], chunk.data(), chunk.size()) <= 0) {
+        break;
+      }
+      written += chunk.size();
+    } else {
+      written += rc;
+    }
+  }
+  run();
+  EXPECT_LT(callbacks_.downstream_bytes_, written);
+
+  uint64_t received = 0;
+  while (received < written) {
+    const std::string data = readAll(upstream_[0]);
+    received += data.size();
+    run();
+  }
+  EXPECT_EQ(written, received);
+  EXPECT_EQ(written, callbacks_.downstream_bytes_);
+}
+
+TEST_F(SplicePumpTest, ErrorCompletes) {
+  createPump();
+  // Writing to a peer that has gone away fails rather than reaching end of stream.
+  close(upstream_[0]);
+  upstream_[0] = -1;
+  writeAll(downstream_[0], "lost");
+  run();
+  EXPECT_TRUE(callbacks_.complete_);
+  EXPECT_TRUE(callbacks_.error_);
+}
+
+} // namespace
+} // namespace TcpProxy
+} // namespace Envoy
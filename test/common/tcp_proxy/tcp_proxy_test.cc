@@ -528,6 +528,23 @@ TEST_F(TcpProxyTest, HalfCloseProxy) {
   upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
 }
 
+// Test that splicing is skipped when either connection uses TLS, so the payload is proxied through
+// the filter as usual.
+TEST_F(TcpProxyTest, SpliceFallsBackForTls) {
+  envoy::config::filter::network::tcp_proxy::v2::TcpProxy config = defaultConfig();
+  config.set_splice(true);
+  Ssl::MockConnectionInfo ssl_info;
+  EXPECT_CALL(filter_callbacks_.connection_, ssl()).WillRepeatedly(Return(&ssl_info));
+  setup(1, config);
+
+  raiseEventUpstreamConnected(0);
+  EXPECT_EQ(0U, config_->stats().downstream_cx_splice_total_.value());
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferEqual(&buffer), false));
+  filter_->onData(buffer, false);
+}
+
 // Test that downstream is closed after an upstream LocalClose.
 TEST_F(TcpProxyTest, UpstreamLocalDisconnect) {
   setup(1);
@@ -9,7 +9,9 @@
 
 using testing::_;
 using testing::InSequence;
+using testing::Invoke;
 using testing::Ref;
+using testing::Return;
 using testing::ReturnPointee;
 
 namespace Envoy {
@@ -23,6 +25,12 @@ public:
   MOCK_METHOD0(onDestroy, void());
 };
 
+struct CountObject : public ThreadLocalObject {
+  CountObject(uint64_t count) : count_(count) {}
+
+  const uint64_t count_;
+};
+
 class ThreadLocalInstanceImplTest : public testing::Test {
 public:
   ThreadLocalInstanceImplTest() {
@@ -113,6 +121,64 @@ TEST_F(ThreadLocalInstanceImplTest, RunOnAllThreads) {
   tls_.shutdownThread();
 }
 
+// Validate that the updates of a slot are posted to the workers in batches, which skip the updates
+// replaced before the batch runs.
+TEST_F(ThreadLocalInstanceImplTest, BatchedSets) {
+  SlotPtr slot1 = tls_.allocateSlot();
+  SlotPtr slot2 = tls_.allocateSlot();
+  std::vector<Event::PostCb> posted;
+  EXPECT_CALL(thread_dispatcher_, post(_))
+      .Times(2)
+      .WillRepeatedly(Invoke([&posted](Event::PostCb cb) -> void { posted.push_back(cb); }));
+
+  uint64_t worker_calls = 0;
+  auto set = [this, &worker_calls](Slot& slot, uint64_t count) -> void {
+    slot.set([this, &worker_calls, count](Event::Dispatcher& dispatcher) {
+      if (&dispatcher == &thread_dispatcher_) {
+        worker_calls++;
+      }
+      return std::make_shared<CountObject>(count);
+    });
+  };
+
+  set(*slot1, 1);
+  set(*slot2, 2);
+  set(*slot1, 3);
+  ASSERT_EQ(1UL, posted.size());
+  EXPECT_EQ(3UL, slot1->getTyped<CountObject>().count_);
+
+  // Only the latest update of each slot runs on the worker.
+  posted[0]();
+  EXPECT_EQ(2UL, worker_calls);
+  EXPECT_EQ(3UL, slot1->getTyped<CountObject>().count_);
+  EXPECT_EQ(2UL, slot2->getTyped<CountObject>().count_);
+
+  // A started batch is not added to.
+  set(*slot1, 4);
+  ASSERT_EQ(2UL, posted.size());
+  posted[1]();
+  EXPECT_EQ(3UL, worker_calls);
+
+  tls_.shutdownGlobalThreading();
+  tls_.shutdownThread();
+}
+
+// Validate that the updates are not batched across other posts to the workers.
+TEST_F(ThreadLocalInstanceImplTest, SetBatchClosedByRunOnAllThreads) {
+  SlotPtr slot = tls_.allocateSlot();
+  EXPECT_CALL(thread_dispatcher_, post(_)).Times(3).WillRepeatedly(Return());
+
+  auto set = [&slot]() -> void {
+    slot->set([](Event::Dispatcher&) { return std::make_shared<CountObject>(0); });
+  };
+  set();
+  slot->runOnAllThreads([]() -> void {});
+  set();
+
+  tls_.shutdownGlobalThreading();
+  tls_.shutdownThread();
+}
+
 // Validate ThreadLocal::InstanceImpl's dispatcher() behavior.
 TEST(ThreadLocalInstanceImplDispatcherTest, Dispatcher) {
   InstanceImpl tls;
@@ -187,6 +187,20 @@ TEST(HttpConnManFinalizerImpl, NullRequestHeaders) {
   HttpTracerUtility::finalizeSpan(span, nullptr, stream_info, config);
 }
 
+// The tags of a span which is not reported are not built.
+TEST(HttpConnManFinalizerImpl, NotSampled) {
+  NiceMock<MockSpan> span;
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestHeaderMapImpl request_headers{{":path", "/test"}, {":method", "GET"}};
+
+  EXPECT_CALL(span, sampled()).WillOnce(Return(false));
+  EXPECT_CALL(span, setTag(_, _)).Times(0);
+  EXPECT_CALL(span, finishSpan());
+
+  NiceMock<MockConfig> config;
+  HttpTracerUtility::finalizeSpan(span, &request_headers, stream_info, config);
+}
+
 TEST(HttpConnManFinalizerImpl, StreamInfoLogs) {
   NiceMock<MockSpan> span;
   NiceMock<StreamInfo::MockStreamInfo> stream_info;
@@ -353,15 +367,17 @@ TEST(HttpNullTracerTest, BasicFunctionality) {
   StreamInfo::MockStreamInfo stream_info;
   Http::TestHeaderMapImpl request_headers;
 
-  SpanPtr span_ptr =
-      null_tracer.startSpan(config, request_headers, stream_info, {Reason::Sampling, true});
-  EXPECT_TRUE(dynamic_cast<NullSpan*>(span_ptr.get()) != nullptr);
+  // No span is allocated, the caller using the NullSpan instance.
+  EXPECT_EQ(nullptr,
+            null_tracer.startSpan(config, request_headers, stream_info, {Reason::Sampling, true}));
 
-  span_ptr->setOperation("foo");
-  span_ptr->setTag("foo", "bar");
-  span_ptr->injectContext(request_headers);
+  Span& span = NullSpan::instance();
+  span.setOperation("foo");
+  span.setTag("foo", "bar");
+  span.injectContext(request_headers);
+  EXPECT_FALSE(span.sampled());
 
-  EXPECT_NE(nullptr, span_ptr->spawnChild(config, "foo", SystemTime()));
+  EXPECT_NE(nullptr, span.spawnChild(config, "foo", SystemTime()));
 }
 
 class HttpTracerImplTest : public testing::Test {
@@ -405,6 +421,22 @@ TEST_F(HttpTracerImplTest, BasicFunctionalityNodeSet) {
   tracer_->startSpan(config_, request_headers_, stream_info_, {Reason::Sampling, true});
 }
 
+// A span which is not reported is returned without tags.
+TEST_F(HttpTracerImplTest, NotSampledSpan) {
+  EXPECT_CALL(stream_info_, startTime());
+  EXPECT_CALL(config_, operationName()).Times(2);
+
+  NiceMock<MockSpan>* span = new NiceMock<MockSpan>();
+  EXPECT_CALL(*driver_, startSpan_(_, _, "ingress", stream_info_.start_time_, _))
+      .WillOnce(Return(span));
+  EXPECT_CALL(*span, sampled()).WillOnce(Return(false));
+  EXPECT_CALL(*span, setTag(_, _)).Times(0);
+
+  SpanPtr active_span = tracer_->startSpan(config_, request_headers_, stream_info_,
+                                           {Reason::NotTraceableRequestId, false});
+  EXPECT_EQ(span, active_span.get());
+}
+
 } // namespace
 } // namespace Tracing
 } // namespace Envoy
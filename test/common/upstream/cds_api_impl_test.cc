@@ -5,6 +5,7 @@
 
 #include "envoy/api/v2/core/config_source.pb.validate.h"
 
+#include "common/api/api_impl.h"
 #include "common/config/utility.h"
 #include "common/protobuf/utility.h"
 #include "common/upstream/cds_api_impl.h"
@@ -37,7 +38,7 @@ class CdsApiImplTest : public testing::Test {
 protected:
   void setup() {
     envoy::api::v2::core::ConfigSource cds_config;
-    cds_ = CdsApiImpl::create(cds_config, cm_, store_, validation_visitor_);
+    cds_ = CdsApiImpl::create(cds_config, cm_, store_, validation_visitor_, *api_);
     cds_->setInitializedCb([this]() -> void { initialized_.ready(); });
 
     EXPECT_CALL(*cm_.subscription_factory_.subscription_, start(_));
@@ -66,6 +67,7 @@ protected:
   Upstream::ClusterManager::ClusterInfoMap cluster_map_;
   Upstream::MockClusterMockPrioritySet mock_cluster_;
   Stats::IsolatedStoreImpl store_;
+  Api::ApiPtr api_{Api::createApiForTest(store_)};
   CdsApiPtr cds_;
   Config::SubscriptionCallbacks* cds_callbacks_{};
   ReadyWatcher initialized_;
@@ -180,6 +182,28 @@ TEST_F(CdsApiImplTest, ConfigUpdateWith2ValidClusters) {
   cds_callbacks_->onConfigUpdate(clusters, "");
 }
 
+// Clusters which have not been instantiated yet are removed when missing from an update.
+TEST_F(CdsApiImplTest, ConfigUpdateRemovesLazyClusters) {
+  {
+    InSequence s;
+    setup();
+  }
+
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(ClusterManager::ClusterInfoMap{}));
+  EXPECT_CALL(cm_, lazyClusters())
+      .WillOnce(Return(std::vector<std::string>{"cluster_1", "cluster_2"}));
+  EXPECT_CALL(initialized_, ready());
+
+  Protobuf::RepeatedPtrField<ProtobufWkt::Any> clusters;
+  envoy::api::v2::Cluster cluster_1;
+  cluster_1.set_name("cluster_1");
+  clusters.Add()->PackFrom(cluster_1);
+  expectAdd("cluster_1");
+  EXPECT_CALL(cm_, removeCluster("cluster_2")).WillOnce(Return(true));
+
+  cds_callbacks_->onConfigUpdate(clusters, "");
+}
+
 TEST_F(CdsApiImplTest, DeltaConfigUpdate) {
   {
     InSequence s;
@@ -20,6 +20,7 @@
 
 #include "extensions/transport_sockets/tls/context_manager_impl.h"
 
+#include "test/common/http/common.h"
 #include "test/common/upstream/utility.h"
 #include "test/mocks/access_log/mocks.h"
 #include "test/mocks/api/mocks.h"
@@ -51,6 +52,7 @@ using testing::Return;
 using testing::ReturnNew;
 using testing::ReturnRef;
 using testing::SaveArg;
+using testing::UnorderedElementsAre;
 
 namespace Envoy {
 namespace Upstream {
@@ -107,6 +109,7 @@ public:
   }
 
   Secret::SecretManager& secretManager() override { return secret_manager_; }
+  Network::DnsResolverSharedPtr dnsResolver() override { return dns_resolver_; }
 
   MOCK_METHOD1(clusterManagerFromProto_,
                ClusterManager*(const envoy::config::bootstrap::v2::Bootstrap& bootstrap));
@@ -1255,6 +1258,62 @@ TEST_F(ClusterManagerImplTest, ShutdownWithWarming) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
 }
 
+// Only max_concurrent_warming_clusters warm at once, the others wait in order for a slot.
+TEST_F(ClusterManagerImplTest, MaxConcurrentWarmingClusters) {
+  const std::string yaml = R"EOF(
+static_resources:
+  clusters: []
+cluster_manager:
+  max_concurrent_warming_clusters: 1
+  )EOF";
+  create(parseBootstrapFromV2Yaml(yaml));
+
+  ReadyWatcher initialized;
+  EXPECT_CALL(initialized, ready());
+  cluster_manager_->setInitializedCb([&]() -> void { initialized.ready(); });
+
+  std::vector<std::shared_ptr<MockClusterMockPrioritySet>> clusters;
+  for (uint32_t i = 0; i < 3; i++) {
+    clusters.emplace_back(new NiceMock<MockClusterMockPrioritySet>());
+  }
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(clusters[0], nullptr)))
+      .WillOnce(Return(std::make_pair(clusters[1], nullptr)))
+      .WillOnce(Return(std::make_pair(clusters[2], nullptr)));
+  EXPECT_CALL(*clusters[0], initialize(_));
+  EXPECT_CALL(*clusters[1], initialize(_)).Times(0);
+  EXPECT_CALL(*clusters[2], initialize(_)).Times(0);
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster_0"), ""));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster_1"), ""));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster_2"), ""));
+  checkStats(3 /*added*/, 0 /*modified*/, 0 /*removed*/, 0 /*active*/, 3 /*warming*/);
+  EXPECT_EQ(2, factory_.stats_
+                   .gauge("cluster_manager.queued_warming_clusters",
+                          Stats::Gauge::ImportMode::NeverImport)
+                   .value());
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(clusters[1].get()));
+
+  // Removing a queued cluster does not start another one.
+  EXPECT_TRUE(cluster_manager_->removeCluster("cluster_2"));
+  checkStats(3 /*added*/, 0 /*modified*/, 1 /*removed*/, 0 /*active*/, 2 /*warming*/);
+
+  // The next queued cluster starts warming once the warming one completes.
+  EXPECT_CALL(*clusters[1], initialize(_));
+  clusters[0]->initialize_callback_();
+  checkStats(3 /*added*/, 0 /*modified*/, 1 /*removed*/, 1 /*active*/, 1 /*warming*/);
+  EXPECT_EQ(0, factory_.stats_
+                   .gauge("cluster_manager.queued_warming_clusters",
+                          Stats::Gauge::ImportMode::NeverImport)
+                   .value());
+
+  clusters[1]->initialize_callback_();
+  checkStats(3 /*added*/, 0 /*modified*/, 1 /*removed*/, 2 /*active*/, 0 /*warming*/);
+
+  for (auto& cluster : clusters) {
+    EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster.get()));
+  }
+}
+
 TEST_F(ClusterManagerImplTest, DynamicAddRemove) {
   create(defaultConfig());
 
@@ -1355,6 +1414,54 @@ TEST_F(ClusterManagerImplTest, DynamicAddRemove) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(callbacks.get()));
 }
 
+// With lazy cluster initialization, the clusters added via API are only instantiated on first use.
+TEST_F(ClusterManagerImplTest, LazyClusterInitialization) {
+  const std::string yaml = R"EOF(
+static_resources:
+  clusters: []
+cluster_manager:
+  lazy_cluster_initialization: true
+  )EOF";
+  create(parseBootstrapFromV2Yaml(yaml));
+
+  // Adding a cluster only keeps its configuration.
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _)).Times(0);
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster_1"), ""));
+  EXPECT_FALSE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster_1"), ""));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster_2"), ""));
+  checkStats(2 /*added*/, 0 /*modified*/, 0 /*removed*/, 0 /*active*/, 0 /*warming*/);
+  EXPECT_EQ(2, factory_.stats_
+                   .gauge("cluster_manager.lazy_clusters", Stats::Gauge::ImportMode::NeverImport)
+                   .value());
+  EXPECT_THAT(cluster_manager_->lazyClusters(), UnorderedElementsAre("cluster_1", "cluster_2"));
+  EXPECT_TRUE(cluster_manager_->clusters().empty());
+
+  // A removed cluster is never instantiated.
+  EXPECT_TRUE(cluster_manager_->removeCluster("cluster_2"));
+  EXPECT_FALSE(cluster_manager_->initializeLazyCluster("cluster_2"));
+
+  // Looking the cluster up instantiates it, and it is found once warm.
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)));
+  EXPECT_CALL(*cluster1, initialize(_));
+  EXPECT_EQ(nullptr, cluster_manager_->get("cluster_1"));
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.lazy_cluster_initialized").value());
+  EXPECT_TRUE(cluster_manager_->lazyClusters().empty());
+  EXPECT_FALSE(cluster_manager_->initializeLazyCluster("cluster_1"));
+  cluster1->initialize_callback_();
+
+  EXPECT_EQ(cluster1->info_, cluster_manager_->get("cluster_1")->info());
+  checkStats(2 /*added*/, 0 /*modified*/, 1 /*removed*/, 1 /*active*/, 0 /*warming*/);
+  EXPECT_EQ(0, factory_.stats_
+                   .gauge("cluster_manager.lazy_clusters", Stats::Gauge::ImportMode::NeverImport)
+                   .value());
+
+  // Unknown clusters are not instantiated.
+  EXPECT_EQ(nullptr, cluster_manager_->get("unknown"));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
+}
+
 TEST_F(ClusterManagerImplTest, addOrUpdateClusterStaticExists) {
   const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
                                         clustersJson({defaultStaticClusterJson("fake_cluster")}));
@@ -1494,6 +1601,102 @@ TEST_F(ClusterManagerImplTest, CloseHttpConnectionsOnHealthFailure) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
 }
 
+// Test that we preconnect to a host which passes active health checking again, when the cluster
+// has a preconnect ratio.
+TEST_F(ClusterManagerImplTest, PreconnectOnHealthRecovery) {
+  const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
+                                        clustersJson({defaultStaticClusterJson("some_cluster")}));
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  cluster1->info_->name_ = "some_cluster";
+  cluster1->info_->per_upstream_preconnect_ratio_ = 2;
+  HostSharedPtr test_host = makeTestHost(cluster1->info_, "tcp://127.0.0.1:80");
+  cluster1->prioritySet().getMockHostSet(0)->hosts_ = {test_host};
+  ON_CALL(*cluster1, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+
+  MockHealthChecker health_checker;
+  ON_CALL(*cluster1, healthChecker()).WillByDefault(Return(&health_checker));
+
+  Http::ConnectionPool::MockInstance* cp1 = new NiceMock<Http::ConnectionPool::MockInstance>();
+
+  InSequence s;
+
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)));
+  EXPECT_CALL(health_checker, addHostCheckCompleteCb(_));
+  EXPECT_CALL(*cluster1, initialize(_))
+      .WillOnce(Invoke([cluster1](std::function<void()> initialize_callback) {
+        // Test inline init.
+        initialize_callback();
+      }));
+  create(parseBootstrapFromV2Json(json));
+
+  EXPECT_CALL(factory_, allocateConnPool_(_, _)).WillOnce(Return(cp1));
+  cluster_manager_->httpConnPoolForCluster("some_cluster", ResourcePriority::Default,
+                                           Http::Protocol::Http11, nullptr);
+
+  EXPECT_CALL(*cp1, drainConnections());
+  test_host->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  health_checker.runCallbacks(test_host, HealthTransition::Changed);
+
+  // The pool already used for the host is warmed up.
+  EXPECT_CALL(*cp1, preconnect(1));
+  test_host->healthFlagClear(Host::HealthFlag::FAILED_ACTIVE_HC);
+  health_checker.runCallbacks(test_host, HealthTransition::Changed);
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
+}
+
+// Test that with shared HTTP/2 connections, the pool used for HTTP/2 streams is created on the main
+// thread for the first stream, while pools for other protocols are still created per worker.
+TEST_F(ClusterManagerImplTest, ShareHttp2ConnectionsAcrossWorkers) {
+  const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
+                                        clustersJson({defaultStaticClusterJson("some_cluster")}));
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  cluster1->info_->name_ = "some_cluster";
+  ON_CALL(*cluster1->info_, features())
+      .WillByDefault(Return(ClusterInfo::Features::HTTP2 |
+                            ClusterInfo::Features::SHARE_HTTP2_CONNECTIONS_ACROSS_WORKERS));
+  cluster1->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster1->info_, "tcp://127.0.0.1:80")};
+  ON_CALL(*cluster1, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)));
+  EXPECT_CALL(*cluster1, initialize(_))
+      .WillOnce(Invoke([cluster1](std::function<void()> initialize_callback) {
+        // Test inline init.
+        initialize_callback();
+      }));
+  create(parseBootstrapFromV2Json(json));
+
+  EXPECT_CALL(factory_, allocateConnPool_(_, _)).Times(0);
+  Http::ConnectionPool::Instance* pool = cluster_manager_->httpConnPoolForCluster(
+      "some_cluster", ResourcePriority::Default, Http::Protocol::Http2, nullptr);
+  ASSERT_NE(nullptr, pool);
+  EXPECT_EQ(Http::Protocol::Http2, pool->protocol());
+  EXPECT_EQ(pool, cluster_manager_->httpConnPoolForCluster(
+                      "some_cluster", ResourcePriority::Default, Http::Protocol::Http2, nullptr));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(&factory_));
+
+  Http::ConnectionPool::MockInstance* cp1 = new NiceMock<Http::ConnectionPool::MockInstance>();
+  Http::ConnectionPool::MockCancellable cancellable;
+  EXPECT_CALL(factory_, allocateConnPool_(_, _)).WillOnce(Return(cp1));
+  EXPECT_CALL(*cp1, newStream(_, _)).WillOnce(Return(&cancellable));
+  NiceMock<Http::MockStreamDecoder> decoder;
+  ConnPoolCallbacks callbacks;
+  EXPECT_NE(nullptr, pool->newStream(decoder, callbacks));
+
+  Http::ConnectionPool::MockInstance* cp2 = new NiceMock<Http::ConnectionPool::MockInstance>();
+  EXPECT_CALL(factory_, allocateConnPool_(_, _)).WillOnce(Return(cp2));
+  EXPECT_EQ(cp2, cluster_manager_->httpConnPoolForCluster("some_cluster", ResourcePriority::Default,
+                                                          Http::Protocol::Http11, nullptr));
+
+  // Shutting down closes the shared connections, failing the pending stream.
+  EXPECT_CALL(cancellable, cancel());
+  EXPECT_CALL(callbacks.pool_failure_, ready());
+  cluster_manager_->shutdown();
+}
+
 // Test that we close all TCP connection pool connections when there is a host health failure.
 TEST_F(ClusterManagerImplTest, CloseTcpConnectionPoolsOnHealthFailure) {
   const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
@@ -2624,6 +2827,73 @@ TEST_F(ClusterManagerImplTest, MergedUpdatesDestroyedOnUpdate) {
                    .value());
 }
 
+// Tests that the cluster updates made in one dispatcher iteration are posted to the workers as a
+// single batch, with the updates of the same cluster and priority coalesced unless a host would be
+// both added and removed.
+TEST_F(ClusterManagerImplTest, BatchedAndCoalescedUpdates) {
+  const std::string yaml = R"EOF(
+  static_resources:
+    clusters:
+    - name: cluster_1
+      connect_timeout: 0.250s
+      type: STATIC
+      lb_policy: ROUND_ROBIN
+      hosts:
+      - socket_address:
+          address: "127.0.0.1"
+          port_value: 11001
+      - socket_address:
+          address: "127.0.0.1"
+          port_value: 11002
+      common_lb_config:
+        update_merge_window: 0s
+  )EOF";
+
+  create(parseBootstrapFromV2Yaml(yaml));
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.update_batch_posted").value());
+
+  ThreadLocalCluster* tls_cluster = cluster_manager_->get("cluster_1");
+  EXPECT_EQ(2, tls_cluster->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  std::vector<std::pair<size_t, size_t>> tls_updates;
+  tls_cluster->prioritySet().addMemberUpdateCb(
+      [&tls_updates](const HostVector& hosts_added, const HostVector& hosts_removed) -> void {
+        tls_updates.emplace_back(hosts_added.size(), hosts_removed.size());
+      });
+
+  Event::PostCb post_cb;
+  EXPECT_CALL(factory_.dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+
+  Cluster& cluster = cluster_manager_->activeClusters().begin()->second;
+  const HostVector initial_hosts = cluster.prioritySet().hostSetsPerPriority()[0]->hosts();
+  HostsPerLocalitySharedPtr hosts_per_locality = std::make_shared<HostsPerLocalityImpl>();
+  const auto update = [&](const HostVector& hosts, const HostVector& hosts_added,
+                          const HostVector& hosts_removed) {
+    auto hosts_ptr = std::make_shared<HostVector>(hosts);
+    cluster.prioritySet().updateHosts(
+        0,
+        updateHostsParams(hosts_ptr, hosts_per_locality,
+                          std::make_shared<const HealthyHostVector>(hosts), hosts_per_locality),
+        {}, hosts_added, hosts_removed, absl::nullopt);
+  };
+
+  // The two removals are coalesced, adding back a removed host is not.
+  update({initial_hosts[1]}, {}, {initial_hosts[0]});
+  update({}, {}, {initial_hosts[1]});
+  update({initial_hosts[0]}, {initial_hosts[0]}, {});
+  EXPECT_EQ(3, factory_.stats_.counter("cluster_manager.cluster_updated").value());
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.update_coalesced").value());
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.update_batch_posted").value());
+  EXPECT_TRUE(tls_updates.empty());
+
+  post_cb();
+  EXPECT_EQ(2, factory_.stats_.counter("cluster_manager.update_batch_posted").value());
+  EXPECT_EQ((std::vector<std::pair<size_t, size_t>>{{0, 2}, {1, 0}}), tls_updates);
+  ASSERT_EQ(1, tls_cluster->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(initial_hosts[0], tls_cluster->prioritySet().hostSetsPerPriority()[0]->hosts()[0]);
+
+  factory_.tls_.shutdownThread();
+}
+
 TEST_F(ClusterManagerImplTest, UpstreamSocketOptionsPassedToConnPool) {
   createWithLocalClusterUpdate();
   NiceMock<MockLoadBalancerContext> context;
@@ -1,3 +1,5 @@
+#include <vector>
+
 #include "common/upstream/edf_scheduler.h"
 
 #include "gtest/gtest.h"
@@ -71,6 +73,27 @@ TEST(EdfSchedulerTest, Expired) {
   EXPECT_EQ(nullptr, sched.pick());
 }
 
+// Validate that adding entries all at once gives the same schedule as adding them one by one.
+TEST(EdfSchedulerTest, AddAll) {
+  EdfScheduler<uint32_t> sched;
+  EdfScheduler<uint32_t> all_sched;
+  constexpr uint32_t num_entries = 128;
+  std::vector<std::shared_ptr<uint32_t>> entries;
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries.push_back(std::make_shared<uint32_t>(i));
+    sched.add(i % 4 + 1, entries.back());
+  }
+  all_sched.addAll(entries, [](uint32_t entry) -> double { return entry % 4 + 1; });
+
+  for (uint32_t i = 0; i < num_entries * 4; ++i) {
+    auto p = sched.pick();
+    EXPECT_EQ(p, all_sched.pick());
+    sched.add(*p % 4 + 1, p);
+    all_sched.add(*p % 4 + 1, p);
+  }
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
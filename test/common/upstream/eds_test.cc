@@ -288,6 +288,86 @@ TEST_F(EdsTest, DeltaOnConfigUpdateSuccess) {
   EXPECT_EQ(1UL, stats_.counter("cluster.name.update_no_rebuild").value());
 }
 
+// Validate that a delta-style onConfigUpdate() removing the assignment empties the cluster.
+TEST_F(EdsTest, DeltaOnConfigUpdateRemoved) {
+  envoy::api::v2::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name("fare");
+  auto* socket_address = cluster_load_assignment.add_endpoints()
+                             ->add_lb_endpoints()
+                             ->mutable_endpoint()
+                             ->mutable_address()
+                             ->mutable_socket_address();
+  socket_address->set_address("1.2.3.4");
+  socket_address->set_port_value(80);
+  initialize();
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(1UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+
+  Protobuf::RepeatedPtrField<std::string> removed_resources;
+  removed_resources.Add()->assign("fare");
+  VERBOSE_EXPECT_NO_THROW(eds_callbacks_->onConfigUpdate({}, removed_resources, "v2"));
+  EXPECT_EQ(0UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+}
+
+// Validate that an update only rebuilds the hosts of the localities which changed, keeping the
+// hosts of the others as is.
+TEST_F(EdsTest, UnchangedLocalitiesReused) {
+  envoy::api::v2::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name("fare");
+  auto add_endpoint = [](envoy::api::v2::endpoint::LocalityLbEndpoints& endpoints, uint32_t port) {
+    auto* socket_address = endpoints.add_lb_endpoints()
+                               ->mutable_endpoint()
+                               ->mutable_address()
+                               ->mutable_socket_address();
+    socket_address->set_address("1.2.3.4");
+    socket_address->set_port_value(port);
+  };
+  auto* changed_locality = cluster_load_assignment.add_endpoints();
+  changed_locality->mutable_locality()->set_zone("us-east-1a");
+  add_endpoint(*changed_locality, 80);
+  add_endpoint(*changed_locality, 81);
+  auto* unchanged_locality = cluster_load_assignment.add_endpoints();
+  unchanged_locality->mutable_locality()->set_zone("us-east-1b");
+  add_endpoint(*unchanged_locality, 90);
+  add_endpoint(*unchanged_locality, 91);
+
+  initialize();
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(0UL, stats_.counter("cluster.name.update_delta").value());
+  EXPECT_EQ(4UL, stats_.counter("cluster.name.update_hosts_built").value());
+  const HostVector initial_hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+  ASSERT_EQ(4UL, initial_hosts.size());
+
+  // Only the hosts of the changed locality are built and diffed.
+  add_endpoint(*changed_locality, 82);
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(1UL, stats_.counter("cluster.name.update_delta").value());
+  EXPECT_EQ(1UL, stats_.counter("cluster.name.update_localities_reused").value());
+  EXPECT_EQ(7UL, stats_.counter("cluster.name.update_hosts_built").value());
+  const HostVector& hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+  ASSERT_EQ(5UL, hosts.size());
+  EXPECT_EQ(initial_hosts[0], hosts[0]);
+  EXPECT_EQ(initial_hosts[1], hosts[1]);
+  EXPECT_EQ("1.2.3.4:82", hosts[2]->address()->asString());
+  EXPECT_EQ(initial_hosts[2], hosts[3]);
+  EXPECT_EQ(initial_hosts[3], hosts[4]);
+
+  // An identical assignment builds no host and rebuilds nothing.
+  const uint64_t no_rebuild = stats_.counter("cluster.name.update_no_rebuild").value();
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(2UL, stats_.counter("cluster.name.update_delta").value());
+  EXPECT_EQ(3UL, stats_.counter("cluster.name.update_localities_reused").value());
+  EXPECT_EQ(7UL, stats_.counter("cluster.name.update_hosts_built").value());
+  EXPECT_EQ(no_rebuild + 1, stats_.counter("cluster.name.update_no_rebuild").value());
+
+  // Removing the changed locality removes its hosts only.
+  cluster_load_assignment.mutable_endpoints()->DeleteSubrange(0, 1);
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(3UL, stats_.counter("cluster.name.update_delta").value());
+  EXPECT_EQ((HostVector{initial_hosts[2], initial_hosts[3]}),
+            cluster_->prioritySet().hostSetsPerPriority()[0]->hosts());
+}
+
 // Validate that onConfigUpdate() with no service name accepts config.
 TEST_F(EdsTest, NoServiceNameOnSuccessConfigUpdate) {
   resetCluster(R"EOF(
@@ -12,6 +12,7 @@
 #include "common/json/json_loader.h"
 #include "common/network/utility.h"
 #include "common/protobuf/utility.h"
+#include "common/singleton/manager_impl.h"
 #include "common/upstream/health_checker_impl.h"
 #include "common/upstream/upstream_impl.h"
 
@@ -64,10 +65,12 @@ TEST(HealthCheckerFactoryTest, GrpcHealthCheckHTTP2NotConfiguredException) {
   Event::MockDispatcher dispatcher;
   AccessLog::MockAccessLogManager log_manager;
   NiceMock<ProtobufMessage::MockValidationVisitor> validation_visitor;
+  Singleton::ManagerImpl singleton_manager{Thread::threadFactoryForTest()};
 
   EXPECT_THROW_WITH_MESSAGE(
       HealthCheckerFactory::create(createGrpcHealthCheckConfig(), cluster, runtime, random,
-                                   dispatcher, log_manager, validation_visitor),
+                                   dispatcher, log_manager, validation_visitor, singleton_manager,
+                                   nullptr),
       EnvoyException, "fake_cluster cluster must support HTTP/2 for gRPC healthchecking");
 }
 
@@ -82,12 +85,13 @@ TEST(HealthCheckerFactoryTest, CreateGrpc) {
   Event::MockDispatcher dispatcher;
   AccessLog::MockAccessLogManager log_manager;
   NiceMock<ProtobufMessage::MockValidationVisitor> validation_visitor;
+  Singleton::ManagerImpl singleton_manager{Thread::threadFactoryForTest()};
 
-  EXPECT_NE(nullptr,
-            dynamic_cast<GrpcHealthCheckerImpl*>(
-                HealthCheckerFactory::create(createGrpcHealthCheckConfig(), cluster, runtime,
-                                             random, dispatcher, log_manager, validation_visitor)
-                    .get()));
+  EXPECT_NE(nullptr, dynamic_cast<GrpcHealthCheckerImpl*>(
+                         HealthCheckerFactory::create(createGrpcHealthCheckConfig(), cluster,
+                                                      runtime, random, dispatcher, log_manager,
+                                                      validation_visitor, singleton_manager, nullptr)
+                             .get()));
 }
 
 class TestHttpHealthCheckerImpl : public HttpHealthCheckerImpl {
@@ -2852,6 +2856,155 @@ TEST_F(TcpHealthCheckerImplTest, ConnectionLocalFailure) {
   EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.passive_failure").value());
 }
 
+// Tests that the first checks of the hosts are spread evenly over the interval when configured.
+TEST_F(TcpHealthCheckerImplTest, SpreadInitialChecks) {
+  InSequence s;
+
+  const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 1s
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    spread_initial_checks: true
+    tcp_health_check: {}
+    )EOF";
+  health_checker_.reset(new TcpHealthCheckerImpl(*cluster_, parseHealthCheckFromV2Yaml(yaml),
+                                                 dispatcher_, runtime_, random_,
+                                                 HealthCheckEventLoggerPtr(event_logger_)));
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80"),
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:81")};
+
+  // The first host is checked right away, the second one half an interval later.
+  expectSessionCreate();
+  expectClientCreate();
+  EXPECT_CALL(*timeout_timer_, enableTimer(_));
+  expectSessionCreate();
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(500)));
+  health_checker_->start();
+
+  expectClientCreate();
+  EXPECT_CALL(*timeout_timer_, enableTimer(_));
+  interval_timer_->invokeCallback();
+
+  EXPECT_EQ(2UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+}
+
+// Tests that the checks of a host shared across clusters are only sent by the first cluster, that
+// the other clusters take on its results, and that the next cluster takes over once the first one
+// removes the host.
+TEST_F(TcpHealthCheckerImplTest, SharedAcrossClusters) {
+  InSequence s;
+
+  const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 1s
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    share_across_clusters: true
+    tcp_health_check:
+      send:
+        text: "01"
+      receive:
+      - text: "02"
+    )EOF";
+  auto shared_sessions = std::make_shared<HealthCheckerImplBase::SharedSessions>();
+  health_checker_.reset(new TcpHealthCheckerImpl(*cluster_, parseHealthCheckFromV2Yaml(yaml),
+                                                 dispatcher_, runtime_, random_,
+                                                 HealthCheckEventLoggerPtr(event_logger_)));
+  health_checker_->shareChecks(shared_sessions);
+  auto other_cluster = std::make_shared<NiceMock<MockClusterMockPrioritySet>>();
+  auto other_health_checker = std::make_shared<TcpHealthCheckerImpl>(
+      *other_cluster, parseHealthCheckFromV2Yaml(yaml), dispatcher_, runtime_, random_, nullptr);
+  other_health_checker->shareChecks(shared_sessions);
+
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80")};
+  other_cluster->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(other_cluster->info_, "tcp://127.0.0.1:80")};
+
+  expectSessionCreate();
+  expectClientCreate();
+  EXPECT_CALL(*connection_, write(_, _));
+  EXPECT_CALL(*timeout_timer_, enableTimer(_));
+  health_checker_->start();
+  Event::MockTimer* first_interval_timer = interval_timer_;
+  Event::MockTimer* first_timeout_timer = timeout_timer_;
+
+  // The other cluster neither connects nor sends checks.
+  expectSessionCreate();
+  EXPECT_CALL(dispatcher_, createClientConnection_(_, _, _, _)).Times(0);
+  other_health_checker->start();
+
+  connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_CALL(*first_timeout_timer, disableTimer());
+  EXPECT_CALL(*first_interval_timer, enableTimer(_));
+  EXPECT_CALL(*timeout_timer_, disableTimer());
+  Buffer::OwnedImpl response;
+  add_uint8(response, 2);
+  read_filter_->onData(response, false);
+
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.success").value());
+  EXPECT_EQ(0UL, other_cluster->info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_EQ(1UL, other_cluster->info_->stats_store_.counter("health_check.success").value());
+
+  // Once the first cluster removes the host, the other cluster sends the checks.
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(0)));
+  HostVector old_hosts = std::move(cluster_->prioritySet().getMockHostSet(0)->hosts_);
+  cluster_->prioritySet().getMockHostSet(0)->runCallbacks({}, old_hosts);
+
+  expectClientCreate();
+  EXPECT_CALL(*connection_, write(_, _));
+  EXPECT_CALL(*timeout_timer_, enableTimer(_));
+  interval_timer_->invokeCallback();
+
+  EXPECT_EQ(1UL, other_cluster->info_->stats_store_.counter("health_check.attempt").value());
+}
+
+// Tests that offloaded checks run on the dispatcher the health checker was created with, and that
+// the completed checks are handed to the main thread.
+TEST_F(TcpHealthCheckerImplTest, Offloaded) {
+  InSequence s;
+
+  setupData();
+  NiceMock<Event::MockDispatcher> main_thread_dispatcher;
+  health_checker_->offloadFrom(main_thread_dispatcher);
+  uint32_t completed_checks = 0;
+  health_checker_->addHostCheckCompleteCb(
+      [&completed_checks](HostSharedPtr, HealthTransition) -> void { completed_checks++; });
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80")};
+
+  // The sessions are added on the health checker's dispatcher.
+  Event::PostCb post_cb;
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  health_checker_->start();
+
+  expectSessionCreate();
+  expectClientCreate();
+  EXPECT_CALL(*connection_, write(_, _));
+  EXPECT_CALL(*timeout_timer_, enableTimer(_));
+  post_cb();
+
+  connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  EXPECT_CALL(*timeout_timer_, disableTimer());
+  EXPECT_CALL(*interval_timer_, enableTimer(_));
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  Buffer::OwnedImpl response;
+  add_uint8(response, 2);
+  read_filter_->onData(response, false);
+
+  // The completed check is handed to the main thread, where the callbacks run.
+  Event::PostCb main_thread_post_cb;
+  EXPECT_CALL(main_thread_dispatcher, post(_)).WillOnce(SaveArg<0>(&main_thread_post_cb));
+  post_cb();
+  EXPECT_EQ(0, completed_checks);
+  main_thread_post_cb();
+  EXPECT_EQ(1, completed_checks);
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.success").value());
+}
+
 class TestGrpcHealthCheckerImpl : public GrpcHealthCheckerImpl {
 public:
   using GrpcHealthCheckerImpl::GrpcHealthCheckerImpl;
@@ -0,0 +1,87 @@
+#include <chrono>
+
+#include "common/upstream/hedge_tracker_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+TEST(HedgeTrackerImplTest, Buckets) {
+  for (uint64_t value = 0; value < 4; ++value) {
+    EXPECT_EQ(value, HedgeTrackerImpl::bucket(value));
+    EXPECT_EQ(value, HedgeTrackerImpl::bucketUpperBound(value));
+  }
+  EXPECT_EQ(4, HedgeTrackerImpl::bucket(4));
+  EXPECT_EQ(7, HedgeTrackerImpl::bucket(7));
+  EXPECT_EQ(8, HedgeTrackerImpl::bucket(8));
+  EXPECT_EQ(8, HedgeTrackerImpl::bucket(9));
+  EXPECT_EQ(9, HedgeTrackerImpl::bucket(10));
+  EXPECT_EQ(9, HedgeTrackerImpl::bucketUpperBound(8));
+  EXPECT_EQ(HedgeTrackerImpl::NumBuckets - 1, HedgeTrackerImpl::bucket(1ULL << 40));
+
+  // The buckets are contiguous, and each value is at most the upper bound of its bucket.
+  uint64_t value = 0;
+  for (uint32_t bucket = 0; bucket < HedgeTrackerImpl::NumBuckets; ++bucket) {
+    EXPECT_EQ(bucket, HedgeTrackerImpl::bucket(value));
+    value = HedgeTrackerImpl::bucketUpperBound(bucket);
+    EXPECT_EQ(bucket, HedgeTrackerImpl::bucket(value));
+    ++value;
+  }
+  EXPECT_EQ(1ULL << 32, value);
+}
+
+TEST(HedgeTrackerImplTest, Percentile) {
+  HedgeTrackerImpl tracker;
+  for (uint64_t i = 1; i < HedgeTrackerImpl::MinResponses; ++i) {
+    tracker.recordResponseTime(std::chrono::microseconds(i * 1000));
+  }
+  EXPECT_FALSE(tracker.responseTimePercentile(50).has_value());
+
+  tracker.recordResponseTime(std::chrono::microseconds(100 * 1000));
+  // 50ms is in the bucket [49152, 57343].
+  EXPECT_EQ(std::chrono::microseconds(57343), tracker.responseTimePercentile(50).value());
+  // 90ms is in the bucket [81920, 98303].
+  EXPECT_EQ(std::chrono::microseconds(98303), tracker.responseTimePercentile(90).value());
+  EXPECT_EQ(std::chrono::microseconds(1023), tracker.responseTimePercentile(0).value());
+  EXPECT_EQ(std::chrono::microseconds(114687), tracker.responseTimePercentile(100).value());
+}
+
+TEST(HedgeTrackerImplTest, Decay) {
+  HedgeTrackerImpl tracker;
+  for (uint64_t i = 0; i < HedgeTrackerImpl::DecayInterval; ++i) {
+    tracker.recordResponseTime(std::chrono::microseconds(1000));
+  }
+  EXPECT_EQ(std::chrono::microseconds(1023), tracker.responseTimePercentile(50).value());
+
+  // After a few decays, the percentile follows the new response times.
+  for (uint64_t i = 0; i < HedgeTrackerImpl::DecayInterval; ++i) {
+    tracker.recordResponseTime(std::chrono::microseconds(8000));
+  }
+  EXPECT_EQ(std::chrono::microseconds(8191), tracker.responseTimePercentile(50).value());
+  EXPECT_EQ(std::chrono::microseconds(1023), tracker.responseTimePercentile(10).value());
+  for (uint64_t i = 0; i < 2 * HedgeTrackerImpl::DecayInterval; ++i) {
+    tracker.recordResponseTime(std::chrono::microseconds(8000));
+  }
+  EXPECT_EQ(std::chrono::microseconds(8191), tracker.responseTimePercentile(10).value());
+}
+
+TEST(HedgeTrackerImplTest, Budget) {
+  HedgeTrackerImpl tracker;
+  EXPECT_FALSE(tracker.hedgeBudgetAvailable(10));
+  for (uint64_t i = 0; i < 100; ++i) {
+    tracker.recordResponseTime(std::chrono::microseconds(1000));
+  }
+  for (uint64_t i = 0; i < 10; ++i) {
+    EXPECT_TRUE(tracker.hedgeBudgetAvailable(10));
+    tracker.onHedge();
+  }
+  EXPECT_FALSE(tracker.hedgeBudgetAvailable(10));
+  EXPECT_TRUE(tracker.hedgeBudgetAvailable(11));
+  EXPECT_FALSE(tracker.hedgeBudgetAvailable(0));
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,84 @@
+#include <memory>
+
+#include "common/stats/fake_symbol_table_impl.h"
+#include "common/upstream/host_stats_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class HostStatsBlockTest : public testing::Test {
+protected:
+  HostStatsBlockTest()
+      : names_(std::make_shared<const HostStatNames>(symbol_table_)),
+        block_(new HostStatsBlock(names_)) {}
+
+  Stats::FakeSymbolTableImpl symbol_table_;
+  HostStatNamesConstSharedPtr names_;
+  HostStatsBlockSharedPtr block_;
+};
+
+TEST_F(HostStatsBlockTest, Names) {
+  const std::vector<Stats::CounterSharedPtr> counters = block_->counters();
+  ASSERT_EQ(7, counters.size());
+  EXPECT_EQ("cx_connect_fail", counters[0]->name());
+  EXPECT_EQ("rq_total", counters[6]->name());
+  EXPECT_EQ("rq_total", symbol_table_.toString(counters[6]->statName()));
+  EXPECT_EQ("rq_total", counters[6]->tagExtractedName());
+  EXPECT_TRUE(counters[6]->tags().empty());
+
+  const std::vector<Stats::GaugeSharedPtr> gauges = block_->gauges();
+  ASSERT_EQ(3, gauges.size());
+  EXPECT_EQ("cx_active", gauges[0]->name());
+  EXPECT_EQ("cx_rtt_us", gauges[1]->name());
+  EXPECT_EQ("rq_active", gauges[2]->name());
+  EXPECT_EQ(Stats::Gauge::ImportMode::Accumulate, gauges[2]->importMode());
+}
+
+TEST_F(HostStatsBlockTest, Values) {
+  const HostStats& stats = block_->stats();
+  EXPECT_FALSE(stats.rq_total_.used());
+  stats.rq_total_.inc();
+  stats.rq_total_.add(2);
+  EXPECT_TRUE(stats.rq_total_.used());
+  EXPECT_FALSE(stats.rq_error_.used());
+  EXPECT_EQ(3, stats.rq_total_.value());
+  EXPECT_EQ(3, stats.rq_total_.latch());
+  EXPECT_EQ(0, stats.rq_total_.latch());
+  EXPECT_EQ(3, block_->counters()[6]->value());
+  stats.rq_total_.reset();
+  EXPECT_EQ(0, stats.rq_total_.value());
+
+  EXPECT_FALSE(stats.rq_active_.used());
+  stats.rq_active_.inc();
+  stats.rq_active_.inc();
+  stats.cx_active_.set(5);
+  stats.rq_active_.dec();
+  EXPECT_TRUE(stats.rq_active_.used());
+  EXPECT_EQ(1, stats.rq_active_.value());
+  EXPECT_EQ(5, block_->gauges()[0]->value());
+
+  EXPECT_TRUE(stats.cx_active_.latchChanged());
+  EXPECT_TRUE(stats.rq_active_.latchChanged());
+  EXPECT_FALSE(stats.rq_active_.latchChanged());
+  stats.cx_active_.set(5);
+  EXPECT_FALSE(stats.cx_active_.latchChanged());
+}
+
+// The counters and gauges handed out keep the block alive.
+TEST_F(HostStatsBlockTest, Refcount) {
+  EXPECT_EQ(1, block_->use_count());
+  Stats::CounterSharedPtr counter = block_->counters()[2];
+  EXPECT_EQ(2, block_->use_count());
+  block_->stats().cx_total_.inc();
+  block_.reset();
+  EXPECT_EQ("cx_total", counter->name());
+  EXPECT_EQ(1, counter->value());
+  EXPECT_EQ(1, counter->use_count());
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
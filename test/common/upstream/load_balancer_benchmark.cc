@@ -4,6 +4,7 @@
 
 #include "common/memory/stats.h"
 #include "common/runtime/runtime_impl.h"
+#include "common/upstream/load_balancer_impl.h"
 #include "common/upstream/maglev_lb.h"
 #include "common/upstream/ring_hash_lb.h"
 #include "common/upstream/upstream_impl.h"
@@ -100,6 +101,48 @@ BENCHMARK(BM_RoundRobinLoadBalancerBuild)
     ->Args({50000, 100, 50})
     ->Unit(benchmark::kMillisecond);
 
+class LeastRequestTester : public BaseTester {
+public:
+  LeastRequestTester(uint64_t num_hosts, uint32_t weighted_subset_percent, uint32_t weight,
+                     bool weighted_choices)
+      : BaseTester(num_hosts, weighted_subset_percent, weight) {
+    // Spread some load over the hosts so that the choices differ.
+    const HostVector& hosts = priority_set_.hostSetsPerPriority()[0]->hosts();
+    for (uint64_t i = 0; i < hosts.size(); i++) {
+      hosts[i]->stats().rq_active_.set(i % 8);
+    }
+    envoy::api::v2::Cluster::LeastRequestLbConfig least_request_config;
+    least_request_config.set_weighted_choices(weighted_choices);
+    lb_ = std::make_unique<LeastRequestLoadBalancer>(priority_set_, &local_priority_set_, stats_,
+                                                     runtime_, random_, common_config_,
+                                                     least_request_config);
+  }
+
+  std::unique_ptr<LeastRequestLoadBalancer> lb_;
+};
+
+void BM_LeastRequestLoadBalancerChooseHost(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t weighted_subset_percent = state.range(1);
+  const uint64_t weight = state.range(2);
+  const bool weighted_choices = state.range(3) != 0;
+  LeastRequestTester tester(num_hosts, weighted_subset_percent, weight, weighted_choices);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tester.lb_->chooseHost(nullptr));
+  }
+}
+BENCHMARK(BM_LeastRequestLoadBalancerChooseHost)
+    ->Args({100, 0, 1, 0})
+    ->Args({10000, 0, 1, 0})
+    ->Args({50000, 0, 1, 0})
+    ->Args({100, 50, 4, 0})
+    ->Args({10000, 50, 4, 0})
+    ->Args({50000, 50, 4, 0})
+    ->Args({100, 50, 4, 1})
+    ->Args({10000, 50, 4, 1})
+    ->Args({50000, 50, 4, 1});
+
 class RingHashTester : public BaseTester {
 public:
   RingHashTester(uint64_t num_hosts, uint64_t min_ring_size) : BaseTester(num_hosts) {
@@ -165,6 +208,27 @@ BENCHMARK(BM_MaglevLoadBalancerBuildTable)
     ->Arg(100)
     ->Arg(200)
     ->Arg(500)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_MaglevLoadBalancerBuildWeightedTable(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    const uint64_t num_hosts = state.range(0);
+    const uint64_t weighted_subset_percent = state.range(1);
+    const uint64_t weight = state.range(2);
+    MaglevTester tester(num_hosts, weighted_subset_percent, weight);
+    state.ResumeTiming();
+
+    // We are only interested in timing the initial table build.
+    tester.maglev_lb_->initialize();
+  }
+}
+BENCHMARK(BM_MaglevLoadBalancerBuildWeightedTable)
+    ->Args({500, 5, 10})
+    ->Args({500, 50, 10})
+    ->Args({10000, 5, 10})
+    ->Args({10000, 50, 10})
     ->Unit(benchmark::kMillisecond);
 
 class TestLoadBalancerContext : public LoadBalancerContextBase {
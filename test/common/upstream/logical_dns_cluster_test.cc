@@ -419,6 +419,62 @@ TEST_F(LogicalDnsClusterTest, Basic) {
   testBasicSetup(basic_yaml_load_assignment, "foo.bar.com", 443, 8000);
 }
 
+// With both families resolved, connections race across all the addresses, starting with IPv6.
+TEST_F(LogicalDnsClusterTest, AllFamilies) {
+  const std::string yaml = R"EOF(
+  name: name
+  type: LOGICAL_DNS
+  dns_refresh_rate: 4s
+  connect_timeout: 0.25s
+  lb_policy: ROUND_ROBIN
+  dns_lookup_family: ALL
+  hosts:
+  - socket_address:
+      address: foo.bar.com
+      port_value: 443
+  )EOF";
+
+  expectResolve(Network::DnsLookupFamily::All, "foo.bar.com");
+  setupFromV2Yaml(yaml);
+
+  EXPECT_CALL(membership_updated_, ready());
+  EXPECT_CALL(initialized_, ready());
+  EXPECT_CALL(*resolve_timer_, enableTimer(std::chrono::milliseconds(4000)));
+  dns_callback_(TestUtility::makeDnsResponse({"127.0.0.1", "::1"}));
+
+  HostSharedPtr logical_host = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[0];
+  EXPECT_EQ("127.0.0.1:443", logical_host->address()->asString());
+
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(dispatcher_,
+              createClientConnection_(
+                  PointeesEq(Network::Utility::resolveUrl("tcp://[::1]:443")), _, _, _))
+      .WillOnce(Return(new NiceMock<Network::MockClientConnection>()));
+  Host::CreateConnectionData data = logical_host->createConnection(dispatcher_, nullptr, nullptr);
+  EXPECT_EQ("127.0.0.1:443", data.host_description_->address()->asString());
+  data.connection_->close(Network::ConnectionCloseType::NoFlush);
+
+  // A change of any of the addresses is an address change.
+  expectResolve(Network::DnsLookupFamily::All, "foo.bar.com");
+  resolve_timer_->invokeCallback();
+  EXPECT_CALL(*resolve_timer_, enableTimer(_));
+  dns_callback_(TestUtility::makeDnsResponse({"127.0.0.1", "::2"}));
+
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(dispatcher_,
+              createClientConnection_(
+                  PointeesEq(Network::Utility::resolveUrl("tcp://[::2]:443")), _, _, _))
+      .WillOnce(Return(new NiceMock<Network::MockClientConnection>()));
+  data = logical_host->createConnection(dispatcher_, nullptr, nullptr);
+  data.connection_->close(Network::ConnectionCloseType::NoFlush);
+
+  EXPECT_CALL(active_dns_query_, cancel());
+  expectResolve(Network::DnsLookupFamily::All, "foo.bar.com");
+  resolve_timer_->invokeCallback();
+
+  tls_.shutdownThread();
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -79,6 +79,33 @@ TEST_F(MaglevLoadBalancerTest, Basic) {
   }
 }
 
+// With bounded loads, a request whose host is loaded beyond its bound moves on to the next entry of
+// the table.
+TEST_F(MaglevLoadBalancerTest, BoundedLoads) {
+  host_set_.hosts_ = {
+      makeTestHost(info_, "tcp://127.0.0.1:90"), makeTestHost(info_, "tcp://127.0.0.1:91"),
+      makeTestHost(info_, "tcp://127.0.0.1:92"), makeTestHost(info_, "tcp://127.0.0.1:93"),
+      makeTestHost(info_, "tcp://127.0.0.1:94"), makeTestHost(info_, "tcp://127.0.0.1:95")};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  common_config_.mutable_consistent_hashing_lb_config()->mutable_hash_balance_factor()->set_value(
+      150);
+  init(7);
+
+  // With 5 active requests, each host may take ceil((5 + 1) * 1.5 / 6) = 2 of them.
+  LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(0);
+  stats_.upstream_rq_active_.set(5);
+  host_set_.hosts_[2]->stats().rq_active_.set(1);
+  EXPECT_EQ(host_set_.hosts_[2], lb->chooseHost(&context));
+  host_set_.hosts_[2]->stats().rq_active_.set(2);
+  EXPECT_EQ(host_set_.hosts_[4], lb->chooseHost(&context));
+  host_set_.hosts_[4]->stats().rq_active_.set(2);
+  EXPECT_EQ(host_set_.hosts_[0], lb->chooseHost(&context));
+  host_set_.hosts_[4]->stats().rq_active_.set(0);
+  EXPECT_EQ(host_set_.hosts_[4], lb->chooseHost(&context));
+}
+
 // Weighted sanity test.
 TEST_F(MaglevLoadBalancerTest, Weighted) {
   host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", 1),
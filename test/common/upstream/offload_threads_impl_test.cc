@@ -0,0 +1,75 @@
+#include <list>
+#include <memory>
+
+#include "common/api/api_impl.h"
+#include "common/upstream/offload_threads_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class OffloadThreadsImplTest : public testing::Test {
+protected:
+  OffloadThreadsImplTest()
+      : api_(Api::createApiForTest()), main_thread_dispatcher_(api_->allocateDispatcher()),
+        offload_threads_(2, *api_, *main_thread_dispatcher_) {}
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr main_thread_dispatcher_;
+  OffloadThreadsImpl offload_threads_;
+};
+
+TEST_F(OffloadThreadsImplTest, NextDispatcherRoundRobin) {
+  Event::Dispatcher& first = offload_threads_.nextDispatcher();
+  Event::Dispatcher& second = offload_threads_.nextDispatcher();
+  EXPECT_NE(&first, &second);
+  EXPECT_EQ(&first, &offload_threads_.nextDispatcher());
+  EXPECT_EQ(&first, &offload_threads_.firstDispatcher());
+}
+
+// Posting to an offload thread runs the callback off the main thread.
+TEST_F(OffloadThreadsImplTest, Post) {
+  const Thread::ThreadId main_thread_id = api_->threadFactory().currentThreadId();
+  Thread::ThreadId offload_thread_id;
+  offload_threads_.nextDispatcher().post([&]() -> void {
+    offload_thread_id = api_->threadFactory().currentThreadId();
+    main_thread_dispatcher_->post([&]() -> void { main_thread_dispatcher_->exit(); });
+  });
+  main_thread_dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_FALSE(offload_thread_id.isEmpty());
+  EXPECT_NE(main_thread_id, offload_thread_id);
+}
+
+// Queries are resolved on the offload threads and their responses are handed to the main thread,
+// unless they were cancelled.
+TEST_F(OffloadThreadsImplTest, DnsResolver) {
+  Network::DnsResolverSharedPtr dns_resolver = offload_threads_.dnsResolver();
+  bool cancelled_query_completed = false;
+  Network::ActiveDnsQuery* cancelled_query = dns_resolver->resolve(
+      "127.0.0.1", Network::DnsLookupFamily::V4Only,
+      [&](std::list<Network::DnsResponse>&&) -> void { cancelled_query_completed = true; });
+  ASSERT_NE(nullptr, cancelled_query);
+  cancelled_query->cancel();
+
+  const Thread::ThreadId main_thread_id = api_->threadFactory().currentThreadId();
+  std::list<Network::DnsResponse> response;
+  dns_resolver->resolve("127.0.0.1", Network::DnsLookupFamily::V4Only,
+                        [&](std::list<Network::DnsResponse>&& results) -> void {
+                          EXPECT_EQ(main_thread_id, api_->threadFactory().currentThreadId());
+                          response = std::move(results);
+                          main_thread_dispatcher_->exit();
+                        });
+  main_thread_dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  ASSERT_EQ(1, response.size());
+  EXPECT_EQ("127.0.0.1:0", response.front().address_->asString());
+  EXPECT_FALSE(cancelled_query_completed);
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
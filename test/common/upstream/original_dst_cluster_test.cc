@@ -503,6 +503,61 @@ TEST_F(OriginalDstClusterTest, MultipleClusters) {
   EXPECT_EQ(host, second.hostSetsPerPriority()[0]->hosts()[0]);
 }
 
+// The hosts created before the main thread adds them to the host set are added together, and are
+// found by the other load balancers meanwhile.
+TEST_F(OriginalDstClusterTest, PendingHosts) {
+  std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 1.250s
+    type: ORIGINAL_DST
+    lb_policy: ORIGINAL_DST_LB
+  )EOF";
+
+  EXPECT_CALL(initialized_, ready());
+  EXPECT_CALL(*cleanup_timer_, enableTimer(_));
+  setupFromYaml(yaml);
+
+  NiceMock<Network::MockConnection> connection1;
+  TestLoadBalancerContext lb_context1(&connection1);
+  connection1.local_address_ = std::make_shared<Network::Address::Ipv4Instance>("10.10.11.11");
+  EXPECT_CALL(connection1, localAddressRestored()).WillRepeatedly(Return(true));
+
+  NiceMock<Network::MockConnection> connection2;
+  TestLoadBalancerContext lb_context2(&connection2);
+  connection2.local_address_ = std::make_shared<Network::Address::Ipv4Instance>("10.10.11.12");
+  EXPECT_CALL(connection2, localAddressRestored()).WillRepeatedly(Return(true));
+
+  OriginalDstCluster::LoadBalancer lb1(cluster_);
+  OriginalDstCluster::LoadBalancer lb2(cluster_);
+  Event::PostCb post_cb;
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  HostConstSharedPtr host1 = lb1.chooseHost(&lb_context1);
+  HostConstSharedPtr host2 = lb2.chooseHost(&lb_context2);
+  ASSERT_NE(host1, nullptr);
+  ASSERT_NE(host2, nullptr);
+  EXPECT_EQ(host1, lb2.chooseHost(&lb_context1));
+  EXPECT_EQ(0UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+
+  EXPECT_CALL(membership_updated_, ready());
+  post_cb();
+  EXPECT_EQ(2UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(2UL, cluster_->prioritySet().hostSetsPerPriority()[0]->healthyHosts().size());
+  EXPECT_EQ(
+      2, TestUtility::findCounter(stats_store_, "cluster.name.original_dst_host_added")->value());
+
+  // Only the host used since the first cleanup is kept on the second one.
+  EXPECT_CALL(*cleanup_timer_, enableTimer(_));
+  cleanup_timer_->invokeCallback();
+  EXPECT_EQ(host2, lb1.chooseHost(&lb_context2));
+  EXPECT_CALL(*cleanup_timer_, enableTimer(_));
+  EXPECT_CALL(membership_updated_, ready());
+  cleanup_timer_->invokeCallback();
+  ASSERT_EQ(1UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(host2, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[0]);
+  EXPECT_EQ(
+      1, TestUtility::findCounter(stats_store_, "cluster.name.original_dst_host_removed")->value());
+}
+
 TEST_F(OriginalDstClusterTest, UseHttpHeaderEnabled) {
   std::string yaml = R"EOF(
     name: name
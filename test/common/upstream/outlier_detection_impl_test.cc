@@ -104,6 +104,12 @@ public:
     }
   }
 
+  void loadRq(HostSharedPtr host, int num_rq, std::chrono::milliseconds response_time) {
+    for (int i = 0; i < num_rq; i++) {
+      host->outlierDetector().putResponseTime(response_time);
+    }
+  }
+
   NiceMock<MockClusterMockPrioritySet> cluster_;
   HostVector& hosts_ = cluster_.prioritySet().getMockHostSet(0)->hosts_;
   HostVector& failover_hosts_ = cluster_.prioritySet().getMockHostSet(1)->hosts_;
@@ -129,6 +135,10 @@ enforcing_success_rate: 20
 success_rate_minimum_hosts: 50
 success_rate_request_volume: 200
 success_rate_stdev_factor: 3000
+enforcing_latency: 30
+latency_minimum_hosts: 10
+latency_request_volume: 50
+latency_factor: 2000
   )EOF";
 
   envoy::api::v2::cluster::OutlierDetection outlier_detection;
@@ -148,6 +158,10 @@ success_rate_stdev_factor: 3000
   EXPECT_EQ(50UL, detector->config().successRateMinimumHosts());
   EXPECT_EQ(200UL, detector->config().successRateRequestVolume());
   EXPECT_EQ(3000UL, detector->config().successRateStdevFactor());
+  EXPECT_EQ(30UL, detector->config().enforcingLatency());
+  EXPECT_EQ(10UL, detector->config().latencyMinimumHosts());
+  EXPECT_EQ(50UL, detector->config().latencyRequestVolume());
+  EXPECT_EQ(2000UL, detector->config().latencyFactor());
 }
 
 TEST_F(OutlierDetectorImplTest, DestroyWithActive) {
@@ -1056,6 +1070,64 @@ TEST_F(OutlierDetectorImplTest, EmptySuccessRate) {
   interval_timer_->invokeCallback();
 }
 
+TEST_F(OutlierDetectorImplTest, BasicFlowLatency) {
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({
+      "tcp://127.0.0.1:80",
+      "tcp://127.0.0.1:81",
+      "tcp://127.0.0.1:82",
+      "tcp://127.0.0.1:83",
+      "tcp://127.0.0.1:84",
+  });
+
+  envoy::api::v2::cluster::OutlierDetection outlier_detection;
+  outlier_detection.mutable_enforcing_latency()->set_value(100);
+  ON_CALL(runtime_.snapshot_, featureEnabled("outlier_detection.enforcing_latency", 100))
+      .WillByDefault(Return(true));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(
+      cluster_, outlier_detection, dispatcher_, runtime_, time_system_, event_logger_));
+  detector->addChangedStateCb([&](HostSharedPtr host) -> void { checker_.check(host); });
+
+  // Make one host respond five times slower than the others.
+  loadRq(hosts_, 100, std::chrono::milliseconds(10));
+  loadRq(hosts_[4], 100, std::chrono::milliseconds(90));
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(10000));
+  EXPECT_CALL(checker_, check(hosts_[4]));
+  EXPECT_CALL(*event_logger_,
+              logEject(std::static_pointer_cast<const HostDescription>(hosts_[4]), _,
+                       envoy::data::cluster::v2alpha::OutlierEjectionType::LATENCY, true));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  interval_timer_->invokeCallback();
+  EXPECT_EQ(10, hosts_[0]->outlierDetector().latency());
+  EXPECT_EQ(50, hosts_[4]->outlierDetector().latency());
+  EXPECT_EQ(10, detector->latencyMedian());
+  EXPECT_EQ(30, detector->latencyEjectionThreshold());
+  EXPECT_TRUE(hosts_[4]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  EXPECT_EQ(1UL, outlier_detection_ejections_active_.value());
+  Stats::Store& stats_store = cluster_.info_->stats_store_;
+  EXPECT_EQ(1UL, stats_store.counter("outlier_detection.ejections_detected_latency").value());
+  EXPECT_EQ(1UL, stats_store.counter("outlier_detection.ejections_enforced_latency").value());
+
+  // The latency of the hosts is averaged with their latency in the previous interval. The ejected
+  // host gets no traffic, so there are not enough hosts left to look for outliers among.
+  loadRq(hosts_[0], 100, std::chrono::milliseconds(20));
+  loadRq(hosts_[1], 100, std::chrono::milliseconds(20));
+  loadRq(hosts_[2], 100, std::chrono::milliseconds(20));
+  loadRq(hosts_[3], 99, std::chrono::milliseconds(20));
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(20000));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  interval_timer_->invokeCallback();
+  EXPECT_EQ(15, hosts_[0]->outlierDetector().latency());
+  EXPECT_EQ(-1, hosts_[3]->outlierDetector().latency());
+  EXPECT_EQ(-1, hosts_[4]->outlierDetector().latency());
+  EXPECT_EQ(-1, detector->latencyMedian());
+  EXPECT_EQ(-1, detector->latencyEjectionThreshold());
+  EXPECT_EQ(1UL, outlier_detection_ejections_active_.value());
+}
+
 TEST_F(OutlierDetectorImplTest, RemoveWhileEjected) {
   EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
   addHosts({"tcp://127.0.0.1:80"});
@@ -1261,6 +1333,7 @@ TEST(DetectorHostMonitorNullImplTest, All) {
   DetectorHostMonitorNullImpl null_sink;
 
   EXPECT_EQ(0UL, null_sink.numEjections());
+  EXPECT_EQ(-1, null_sink.latency());
   EXPECT_FALSE(null_sink.lastEjectionTime());
   EXPECT_FALSE(null_sink.lastUnejectionTime());
 }
@@ -1345,6 +1418,24 @@ TEST(OutlierDetectionEventLoggerImplTest, All) {
       .WillOnce(SaveArg<0>(&log4));
   event_logger.logUneject(host);
   Json::Factory::loadFromString(log4);
+
+  StringViewSaver log5;
+  EXPECT_CALL(host->outlier_detector_, lastUnejectionTime()).WillOnce(ReturnRef(monotonic_time));
+  EXPECT_CALL(host->outlier_detector_, latency()).WillOnce(Return(50));
+  EXPECT_CALL(detector, latencyMedian()).WillOnce(Return(10));
+  EXPECT_CALL(detector, latencyEjectionThreshold()).WillOnce(Return(30));
+  EXPECT_CALL(*file,
+              write(absl::string_view(
+                  "{\"type\":\"LATENCY\",\"cluster_name\":\"fake_cluster\","
+                  "\"upstream_url\":\"10.0.0.1:443\",\"action\":\"EJECT\","
+                  "\"num_ejections\":0,\"enforced\":true,\"eject_latency_event\":{"
+                  "\"host_latency_ms\":\"50\",\"cluster_median_latency_ms\":\"10\","
+                  "\"cluster_latency_ejection_threshold_ms\":\"30\"},"
+                  "\"timestamp\":\"2018-12-18T09:00:00Z\",\"secs_since_last_action\":\"30\"}\n")))
+      .WillOnce(SaveArg<0>(&log5));
+  event_logger.logEject(host, detector, envoy::data::cluster::v2alpha::OutlierEjectionType::LATENCY,
+                        true);
+  Json::Factory::loadFromString(log5);
 }
 
 TEST(OutlierUtility, SRThreshold) {
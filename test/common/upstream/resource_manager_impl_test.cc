@@ -26,8 +26,8 @@ TEST(ResourceManagerImplTest, RuntimeResourceManager) {
 
   ResourceManagerImpl resource_manager(
       runtime, "circuit_breakers.runtime_resource_manager_test.default.", 0, 0, 0, 1, 0,
-      ClusterCircuitBreakersStats{
-          ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(POOL_GAUGE(store), POOL_GAUGE(store))});
+      ClusterCircuitBreakersStats{ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(
+          POOL_COUNTER(store), POOL_GAUGE(store), POOL_GAUGE(store))});
 
   EXPECT_CALL(
       runtime.snapshot_,
@@ -71,8 +71,8 @@ TEST(ResourceManagerImplTest, RemainingResourceGauges) {
   NiceMock<Runtime::MockLoader> runtime;
   Stats::IsolatedStoreImpl store;
 
-  auto stats = ClusterCircuitBreakersStats{
-      ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(POOL_GAUGE(store), POOL_GAUGE(store))};
+  auto stats = ClusterCircuitBreakersStats{ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(
+      POOL_COUNTER(store), POOL_GAUGE(store), POOL_GAUGE(store))};
   ResourceManagerImpl resource_manager(
       runtime, "circuit_breakers.runtime_resource_manager_test.default.", 1, 2, 1, 0, 3, stats);
 
@@ -120,6 +120,46 @@ TEST(ResourceManagerImplTest, RemainingResourceGauges) {
   resource_manager.connectionPools().dec();
   EXPECT_EQ(3U, stats.remaining_cx_pools_.value());
 }
+
+TEST(ResourceManagerImplTest, RetryBudget) {
+  NiceMock<Runtime::MockLoader> runtime;
+  Stats::IsolatedStoreImpl store;
+
+  auto stats = ClusterCircuitBreakersStats{ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(
+      POOL_COUNTER(store), POOL_GAUGE(store), POOL_GAUGE(store))};
+  // max_retries is ignored.
+  ResourceManagerImpl resource_manager(
+      runtime, "circuit_breakers.runtime_resource_manager_test.default.", 10, 10, 10, 5, 10, stats,
+      50, 1);
+
+  EXPECT_CALL(runtime.snapshot_,
+              getInteger("circuit_breakers.runtime_resource_manager_test.default.retry_budget."
+                         "min_retry_concurrency",
+                         1U))
+      .WillRepeatedly(Return(1U));
+  EXPECT_EQ(1U, resource_manager.retries().max());
+  EXPECT_TRUE(resource_manager.retries().canCreate());
+  resource_manager.retries().inc();
+  EXPECT_EQ(1U, stats.rq_retry_open_.value());
+  EXPECT_FALSE(resource_manager.retries().canCreate());
+  EXPECT_EQ(1U, stats.rq_retry_budget_exhausted_.value());
+
+  // The budget is half of the active and pending requests.
+  resource_manager.requests().inc();
+  resource_manager.requests().inc();
+  resource_manager.pendingRequests().inc();
+  resource_manager.pendingRequests().inc();
+  EXPECT_EQ(2U, resource_manager.retries().max());
+  EXPECT_TRUE(resource_manager.retries().canCreate());
+  resource_manager.retries().inc();
+  EXPECT_EQ(0U, stats.remaining_retries_.value());
+  EXPECT_FALSE(resource_manager.retries().canCreate());
+  EXPECT_EQ(2U, stats.rq_retry_budget_exhausted_.value());
+
+  resource_manager.retries().decBy(2);
+  resource_manager.requests().decBy(2);
+  resource_manager.pendingRequests().decBy(2);
+}
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
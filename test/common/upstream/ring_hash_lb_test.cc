@@ -102,6 +102,9 @@ TEST_P(RingHashLoadBalancerTest, Basic) {
   EXPECT_EQ(12, lb_->stats().size_.value());
   EXPECT_EQ(2, lb_->stats().min_hashes_per_host_.value());
   EXPECT_EQ(2, lb_->stats().max_hashes_per_host_.value());
+  EXPECT_EQ("ring_hash_lb.memory_bytes", lb_->stats().memory_bytes_.name());
+  EXPECT_EQ(6 * sizeof(HostConstSharedPtr) + 12 * (sizeof(uint64_t) + sizeof(uint32_t)),
+            lb_->stats().memory_bytes_.value());
 
   // hash ring:
   // port | position
@@ -158,6 +161,38 @@ TEST_P(RingHashLoadBalancerTest, Basic) {
   EXPECT_EQ(1UL, stats_.lb_healthy_panic_.value());
 }
 
+// With bounded loads, a request whose host is loaded beyond its bound walks on around the ring.
+TEST_P(RingHashLoadBalancerTest, BoundedLoads) {
+  hostSet().hosts_ = {
+      makeTestHost(info_, "tcp://127.0.0.1:90"), makeTestHost(info_, "tcp://127.0.0.1:91"),
+      makeTestHost(info_, "tcp://127.0.0.1:92"), makeTestHost(info_, "tcp://127.0.0.1:93"),
+      makeTestHost(info_, "tcp://127.0.0.1:94"), makeTestHost(info_, "tcp://127.0.0.1:95")};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_ = envoy::api::v2::Cluster::RingHashLbConfig();
+  config_.value().mutable_minimum_ring_size()->set_value(12);
+  common_config_.mutable_consistent_hashing_lb_config()->mutable_hash_balance_factor()->set_value(
+      150);
+  init();
+
+  // The ring is as in the Basic test, where the hash below picks :95 followed by :93 and :91.
+  // With 5 active requests, each host may take ceil((5 + 1) * 1.5 / 6) = 2 of them.
+  LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(3551244743356806947);
+  stats_.upstream_rq_active_.set(5);
+  hostSet().hosts_[5]->stats().rq_active_.set(1);
+  EXPECT_EQ(hostSet().hosts_[5], lb->chooseHost(&context));
+  hostSet().hosts_[5]->stats().rq_active_.set(2);
+  EXPECT_EQ(hostSet().hosts_[3], lb->chooseHost(&context));
+  hostSet().hosts_[3]->stats().rq_active_.set(3);
+  EXPECT_EQ(hostSet().hosts_[1], lb->chooseHost(&context));
+
+  // Once the host has room again, the request goes back to it.
+  hostSet().hosts_[5]->stats().rq_active_.set(0);
+  EXPECT_EQ(hostSet().hosts_[5], lb->chooseHost(&context));
+}
+
 // Ensure if all the hosts with priority 0 unhealthy, the next priority hosts are used.
 TEST_P(RingHashFailoverTest, BasicFailover) {
   host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80")};
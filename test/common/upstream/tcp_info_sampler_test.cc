@@ -0,0 +1,137 @@
+#include <netinet/tcp.h>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/upstream/tcp_info_sampler.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/upstream/host.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Property;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class TcpInfoOsSysCalls : public Api::OsSysCallsImpl {
+public:
+  MOCK_METHOD5(getsockopt, Api::SysCallIntResult(int sockfd, int level, int optname, void* optval,
+                                                 socklen_t* optlen));
+};
+
+class TcpInfoSamplerTest : public testing::Test {
+protected:
+  TcpInfoSamplerTest()
+      : host_(std::make_shared<NiceMock<MockHost>>()),
+        sample_timer_(new NiceMock<Event::MockTimer>(&dispatcher_)),
+        sampler_(std::make_shared<TcpInfoSampler>(dispatcher_, host_, Interval)) {
+    ON_CALL(read_callbacks_.connection_, ioHandle()).WillByDefault(ReturnRef(io_handle_));
+  }
+
+  // Returns a TCP_INFO sample with the given round trip time and retransmits.
+  void expectSample(uint32_t rtt_us, uint32_t total_retransmits) {
+    EXPECT_CALL(os_sys_calls_, getsockopt(_, IPPROTO_TCP, TCP_INFO, _, _))
+        .WillOnce(Invoke([rtt_us, total_retransmits](int, int, int, void* optval,
+                                                     socklen_t* optlen) -> Api::SysCallIntResult {
+          EXPECT_EQ(sizeof(struct tcp_info), *optlen);
+          struct tcp_info info {};
+          info.tcpi_rtt = rtt_us;
+          info.tcpi_total_retrans = total_retransmits;
+          memcpy(optval, &info, sizeof(info));
+          return {0, 0};
+        }));
+  }
+
+  static constexpr std::chrono::milliseconds Interval{100};
+
+  NiceMock<TcpInfoOsSysCalls> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  std::shared_ptr<NiceMock<MockHost>> host_;
+  Event::MockTimer* sample_timer_;
+  std::shared_ptr<TcpInfoSampler> sampler_;
+  NiceMock<Network::MockReadFilterCallbacks> read_callbacks_;
+  Network::IoSocketHandleImpl io_handle_;
+};
+
+constexpr std::chrono::milliseconds TcpInfoSamplerTest::Interval;
+
+TEST_F(TcpInfoSamplerTest, SmoothRtt) {
+  EXPECT_EQ(800UL, TcpInfoSampler::smoothRtt(0, 800));
+  EXPECT_EQ(900UL, TcpInfoSampler::smoothRtt(800, 1600));
+  EXPECT_EQ(800UL, TcpInfoSampler::smoothRtt(800, 800));
+}
+
+TEST_F(TcpInfoSamplerTest, AddToConnection) {
+  NiceMock<Network::MockConnection> connection;
+  EXPECT_CALL(connection, addReadFilter(_)).Times(0);
+  TcpInfoSampler::addToConnection(connection, host_);
+
+  EXPECT_CALL(host_->cluster_, tcpInfoSampleInterval())
+      .WillOnce(Return(absl::optional<std::chrono::milliseconds>(Interval)));
+  new NiceMock<Event::MockTimer>(&connection.dispatcher_);
+  EXPECT_CALL(connection, addReadFilter(_));
+  TcpInfoSampler::addToConnection(connection, host_);
+}
+
+// The samples are recorded into the stats of the cluster and the host, the retransmits being
+// counted from the previous sample.
+TEST_F(TcpInfoSamplerTest, Sample) {
+  EXPECT_CALL(*sample_timer_, enableTimer(Interval));
+  sampler_->initializeReadFilterCallbacks(read_callbacks_);
+  EXPECT_EQ(1UL, read_callbacks_.connection_.callbacks_.size());
+
+  // No round trip time is measured while connecting.
+  expectSample(0, 0);
+  EXPECT_CALL(*sample_timer_, enableTimer(Interval));
+  sample_timer_->invokeCallback();
+  EXPECT_EQ(0UL, host_->stats_.cx_rtt_us_.value());
+
+  expectSample(800, 2);
+  EXPECT_CALL(host_->cluster_.stats_store_,
+              deliverHistogramToSinks(Property(&Stats::Metric::name, "upstream_cx_rtt_us"), 800));
+  EXPECT_CALL(*sample_timer_, enableTimer(Interval));
+  sample_timer_->invokeCallback();
+  EXPECT_EQ(800UL, host_->stats_.cx_rtt_us_.value());
+  EXPECT_EQ(2UL, host_->stats_.cx_retransmits_.value());
+  EXPECT_EQ(2UL, host_->cluster_.stats_.upstream_cx_retransmits_.value());
+
+  expectSample(1600, 3);
+  EXPECT_CALL(*sample_timer_, enableTimer(Interval));
+  sample_timer_->invokeCallback();
+  EXPECT_EQ(900UL, host_->stats_.cx_rtt_us_.value());
+  EXPECT_EQ(3UL, host_->stats_.cx_retransmits_.value());
+  EXPECT_EQ(3UL, host_->cluster_.stats_.upstream_cx_retransmits_.value());
+
+  EXPECT_CALL(*sample_timer_, disableTimer());
+  read_callbacks_.connection_.raiseEvent(Network::ConnectionEvent::RemoteClose);
+}
+
+// Sampling stops when the socket can not be sampled.
+TEST_F(TcpInfoSamplerTest, SampleFailure) {
+  sampler_->initializeReadFilterCallbacks(read_callbacks_);
+
+  EXPECT_CALL(os_sys_calls_, getsockopt(_, IPPROTO_TCP, TCP_INFO, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, ENOPROTOOPT}));
+  EXPECT_CALL(*sample_timer_, enableTimer(_)).Times(0);
+  sample_timer_->invokeCallback();
+  EXPECT_FALSE(host_->stats_.cx_rtt_us_.used());
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -251,6 +251,9 @@ TEST_F(StrictDnsClusterImplTest, Basic) {
         max_requests: 3
         max_retries: 4
     max_requests_per_connection: 3
+    max_http2_connections_per_host: 4
+    preconnect_policy:
+      per_upstream_preconnect_ratio: 1.5
     http2_protocol_options:
       hpack_table_size: 0
     hosts:
@@ -286,6 +289,8 @@ TEST_F(StrictDnsClusterImplTest, Basic) {
   EXPECT_CALL(runtime_.snapshot_, getInteger("circuit_breakers.name.high.max_retries", 4));
   EXPECT_EQ(4U, cluster.info()->resourceManager(ResourcePriority::High).retries().max());
   EXPECT_EQ(3U, cluster.info()->maxRequestsPerConnection());
+  EXPECT_EQ(4U, cluster.info()->maxHttp2ConnectionsPerHost());
+  EXPECT_EQ(1.5, cluster.info()->perUpstreamPreconnectRatio());
   EXPECT_EQ(0U, cluster.info()->http2Settings().hpack_table_size_);
 
   cluster.info()->stats().upstream_rq_total_.inc();
@@ -1048,6 +1053,74 @@ TEST(HostImplTest, HealthPipeAddress) {
       EnvoyException, "Invalid host configuration: non-zero port for non-IP address");
 }
 
+// Hosts with equal addresses, localities and metadata share them.
+TEST(HostImplTest, SharedDescription) {
+  std::shared_ptr<MockClusterInfo> info{new NiceMock<MockClusterInfo>()};
+  envoy::api::v2::core::Metadata metadata;
+  Config::Metadata::mutableMetadataValue(metadata, Config::MetadataFilters::get().ENVOY_LB,
+                                         "version")
+      .set_string_value("1.0");
+  envoy::api::v2::core::Locality locality;
+  locality.set_zone("zone");
+  envoy::api::v2::endpoint::Endpoint::HealthCheckConfig config;
+  config.set_port_value(8000);
+  const auto make_host = [&](const std::string& url) -> HostSharedPtr {
+    return std::make_shared<HostImpl>(info, "", Network::Utility::resolveUrl(url), metadata, 1,
+                                      locality, config, 0,
+                                      envoy::api::v2::core::HealthStatus::UNKNOWN);
+  };
+
+  HostSharedPtr host1 = make_host("tcp://10.0.0.1:1234");
+  HostSharedPtr host2 = make_host("tcp://10.0.0.1:1234");
+  HostSharedPtr host3 = make_host("tcp://10.0.0.2:1234");
+  EXPECT_EQ(host1->address(), host2->address());
+  EXPECT_EQ(host1->healthCheckAddress(), host2->healthCheckAddress());
+  EXPECT_NE(host1->address(), host3->address());
+  EXPECT_EQ("10.0.0.2:8000", host3->healthCheckAddress()->asString());
+  EXPECT_EQ(host1->metadata(), host3->metadata());
+  EXPECT_EQ(&host1->locality(), &host3->locality());
+  EXPECT_EQ("zone", host3->locality().zone());
+
+  // Updating the metadata of a host leaves the other hosts alone.
+  envoy::api::v2::core::Metadata new_metadata;
+  host3->metadata(new_metadata);
+  EXPECT_TRUE(TestUtility::protoEqual(new_metadata, *host3->metadata()));
+  EXPECT_EQ("1.0", Config::Metadata::metadataValue(*host1->metadata(),
+                                                   Config::MetadataFilters::get().ENVOY_LB,
+                                                   "version")
+                       .string_value());
+}
+
+// The stats of a host are only allocated once used.
+TEST(HostImplTest, LazyStats) {
+  std::shared_ptr<MockClusterInfo> info{new NiceMock<MockClusterInfo>()};
+  const HostMemoryStats initial = HostDescriptionImpl::memoryStats();
+  HostSharedPtr host = makeTestHost(info, "tcp://10.0.0.1:1234");
+  HostMemoryStats current = HostDescriptionImpl::memoryStats();
+  EXPECT_EQ(initial.hosts_ + 1, current.hosts_);
+  EXPECT_EQ(initial.hosts_with_stats_, current.hosts_with_stats_);
+
+  // The counters and gauges of a host whose stats are not allocated are all zero.
+  EXPECT_EQ(6, host->counters().size());
+  EXPECT_EQ(2, host->gauges().size());
+  for (const Stats::CounterSharedPtr& counter : host->counters()) {
+    EXPECT_EQ(0, counter->value());
+  }
+  EXPECT_EQ(initial.hosts_with_stats_, HostDescriptionImpl::memoryStats().hosts_with_stats_);
+
+  host->stats().rq_total_.inc();
+  current = HostDescriptionImpl::memoryStats();
+  EXPECT_EQ(initial.hosts_with_stats_ + 1, current.hosts_with_stats_);
+  for (const Stats::CounterSharedPtr& counter : host->counters()) {
+    EXPECT_EQ(counter->name() == "rq_total" ? 1 : 0, counter->value());
+  }
+
+  host.reset();
+  current = HostDescriptionImpl::memoryStats();
+  EXPECT_EQ(initial.hosts_, current.hosts_);
+  EXPECT_EQ(initial.hosts_with_stats_, current.hosts_with_stats_);
+}
+
 class StaticClusterImplTest : public testing::Test, public UpstreamImplTestBase {};
 
 TEST_F(StaticClusterImplTest, InitialHosts) {
@@ -1512,6 +1585,8 @@ TEST_F(StaticClusterImplTest, UrlConfig) {
   EXPECT_EQ(1024U, cluster.info()->resourceManager(ResourcePriority::High).requests().max());
   EXPECT_EQ(3U, cluster.info()->resourceManager(ResourcePriority::High).retries().max());
   EXPECT_EQ(0U, cluster.info()->maxRequestsPerConnection());
+  EXPECT_EQ(1U, cluster.info()->maxHttp2ConnectionsPerHost());
+  EXPECT_EQ(1.0, cluster.info()->perUpstreamPreconnectRatio());
   EXPECT_EQ(Http::Http2Settings::DEFAULT_HPACK_TABLE_SIZE,
             cluster.info()->http2Settings().hpack_table_size_);
   EXPECT_EQ(LoadBalancerType::Random, cluster.info()->lbType());
@@ -1708,6 +1783,35 @@ TEST_F(ClusterImplTest, CloseConnectionsOnHostHealthFailure) {
               ClusterInfo::Features::CLOSE_CONNECTIONS_ON_HOST_HEALTH_FAILURE);
 }
 
+// Test that the correct feature() is set when share_http2_connections_across_workers is
+// configured.
+TEST_F(ClusterImplTest, ShareHttp2ConnectionsAcrossWorkers) {
+  auto dns_resolver = std::make_shared<Network::MockDnsResolver>();
+
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+    http2_protocol_options: {}
+    share_http2_connections_across_workers: true
+    hosts: [{ socket_address: { address: foo.bar.com, port_value: 443 }}]
+  )EOF";
+  envoy::api::v2::Cluster cluster_config = parseClusterFromV2Yaml(yaml);
+  Envoy::Stats::ScopePtr scope = stats_.createScope(fmt::format(
+      "cluster.{}.", cluster_config.alt_stat_name().empty() ? cluster_config.name()
+                                                            : cluster_config.alt_stat_name()));
+  Envoy::Server::Configuration::TransportSocketFactoryContextImpl factory_context(
+      admin_, ssl_context_manager_, *scope, cm_, local_info_, dispatcher_, random_, stats_,
+      singleton_manager_, tls_, validation_visitor_, *api_);
+
+  StrictDnsClusterImpl cluster(cluster_config, runtime_, dns_resolver, factory_context,
+                               std::move(scope), false);
+  EXPECT_EQ(ClusterInfo::Features::HTTP2 |
+                ClusterInfo::Features::SHARE_HTTP2_CONNECTIONS_ACROSS_WORKERS,
+            cluster.info()->features());
+}
+
 class TestBatchUpdateCb : public PrioritySet::BatchUpdateCb {
 public:
   TestBatchUpdateCb(HostVectorSharedPtr hosts, HostsPerLocalitySharedPtr hosts_per_locality)
@@ -1904,6 +2008,76 @@ TEST_F(ClusterInfoImplTest, Metadata) {
   EXPECT_EQ(LoadBalancerType::Maglev, cluster->info()->lbType());
 }
 
+// The retry budget replaces max_retries, and scales with the active and pending requests.
+TEST_F(ClusterInfoImplTest, RetryBudget) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+    circuit_breakers:
+      thresholds:
+      - priority: DEFAULT
+        max_retries: 10
+        retry_budget:
+          budget_percent: {value: 25}
+          min_retry_concurrency: 2
+      - priority: HIGH
+        retry_budget: {}
+    hosts: [{ socket_address: { address: foo.bar.com, port_value: 443 }}]
+  )EOF";
+
+  auto cluster = makeCluster(yaml);
+  ResourceManager& default_manager = cluster->info()->resourceManager(ResourcePriority::Default);
+  EXPECT_EQ(2U, default_manager.retries().max());
+  for (uint32_t i = 0; i < 8; ++i) {
+    default_manager.requests().inc();
+  }
+  for (uint32_t i = 0; i < 4; ++i) {
+    default_manager.pendingRequests().inc();
+  }
+  EXPECT_EQ(3U, default_manager.retries().max());
+  default_manager.retries().inc();
+  default_manager.retries().inc();
+  EXPECT_TRUE(default_manager.retries().canCreate());
+  default_manager.retries().inc();
+  EXPECT_FALSE(default_manager.retries().canCreate());
+  EXPECT_EQ(1UL,
+            stats_.counter("cluster.name.circuit_breakers.default.rq_retry_budget_exhausted")
+                .value());
+  default_manager.retries().decBy(3);
+  default_manager.requests().decBy(8);
+  default_manager.pendingRequests().decBy(4);
+
+  // The defaults are a budget of 20% and a minimum concurrency of 3.
+  ResourceManager& high_manager = cluster->info()->resourceManager(ResourcePriority::High);
+  EXPECT_EQ(3U, high_manager.retries().max());
+  for (uint32_t i = 0; i < 20; ++i) {
+    high_manager.requests().inc();
+  }
+  EXPECT_EQ(4U, high_manager.retries().max());
+  high_manager.requests().decBy(20);
+}
+
+// The TCP state of the upstream connections is only sampled if an interval is set.
+TEST_F(ClusterInfoImplTest, TcpInfoSampleInterval) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+    hosts: [{ socket_address: { address: foo.bar.com, port_value: 443 }}]
+  )EOF";
+  EXPECT_FALSE(makeCluster(yaml)->info()->tcpInfoSampleInterval().has_value());
+
+  const std::string sampled_yaml = yaml + R"EOF(
+    upstream_connection_options:
+      tcp_info_sample_interval: 0.5s
+  )EOF";
+  EXPECT_EQ(std::chrono::milliseconds(500),
+            makeCluster(sampled_yaml)->info()->tcpInfoSampleInterval().value());
+}
+
 // Eds service_name is populated.
 TEST_F(ClusterInfoImplTest, EdsServiceNamePopulation) {
   const std::string yaml = R"EOF(
@@ -2,6 +2,7 @@
 
 #include "common/buffer/zero_copy_input_stream_impl.h"
 #include "common/network/address_impl.h"
+#include "common/stats/isolated_store_impl.h"
 
 #include "extensions/access_loggers/grpc/http_grpc_access_log_impl.h"
 
@@ -37,7 +38,8 @@ public:
     EXPECT_CALL(*timer_, enableTimer(buffer_flush_interval_msec));
     logger_ = std::make_unique<GrpcAccessLoggerImpl>(Grpc::RawAsyncClientPtr{async_client_},
                                                      log_name_, buffer_flush_interval_msec,
-                                                     buffer_size_bytes, dispatcher_, local_info_);
+                                                     buffer_size_bytes, dispatcher_, local_info_,
+                                                     stats_store_);
   }
 
   void expectStreamStart(MockAccessLogStream& stream, AccessLogCallbacks** callbacks_to_set) {
@@ -52,6 +54,7 @@ public:
   void expectStreamMessage(MockAccessLogStream& stream, const std::string& expected_message_yaml) {
     envoy::service::accesslog::v2::StreamAccessLogsMessage expected_message;
     TestUtility::loadFromYaml(expected_message_yaml, expected_message);
+    EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
     EXPECT_CALL(stream, sendMessageRaw_(_, false))
         .WillOnce(Invoke([expected_message](Buffer::InstancePtr& request, bool) {
           envoy::service::accesslog::v2::StreamAccessLogsMessage message;
@@ -61,6 +64,11 @@ public:
         }));
   }
 
+  uint64_t counterValue(const std::string& name) {
+    return stats_store_.counter("access_logs.grpc_access_log." + name).value();
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
   std::string log_name_ = "test_log_name";
   LocalInfo::MockLocalInfo local_info_;
   Event::MockTimer* timer_ = nullptr;
@@ -235,6 +243,61 @@ TEST_F(GrpcAccessLoggerImplTest, Flushing) {
   timer_->invokeCallback();
 }
 
+// Test that a full batch is held back while the stream is above its high watermark, and that the
+// entries logged meanwhile are dropped.
+TEST_F(GrpcAccessLoggerImplTest, WatermarkBackpressure) {
+  InSequence s;
+  initLogger(FlushInterval, 30);
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  const std::string path1(30, '1');
+  envoy::data::accesslog::v2::HTTPAccessLogEntry entry;
+  entry.mutable_request()->set_path(path1);
+  logger_->log(envoy::data::accesslog::v2::HTTPAccessLogEntry(entry));
+
+  // The batch is still full and the stream still backed up, so the entry is dropped.
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  entry.mutable_request()->set_path("/test/path2");
+  logger_->log(envoy::data::accesslog::v2::HTTPAccessLogEntry(entry));
+  EXPECT_EQ(1, counterValue("logs_written"));
+  EXPECT_EQ(1, counterValue("logs_dropped"));
+
+  // Once the stream drains, the held back batch is sent by the next flush.
+  expectStreamMessage(stream, fmt::format(R"EOF(
+identifier:
+  node:
+    id: node_name
+    cluster: cluster_name
+    locality:
+      zone: zone_name
+  log_name: test_log_name
+http_logs:
+  log_entry:
+    request:
+      path: "{}"
+)EOF",
+                                          path1));
+  EXPECT_CALL(*timer_, enableTimer(FlushInterval));
+  timer_->invokeCallback();
+
+  const std::string path3(30, '3');
+  expectStreamMessage(stream, fmt::format(R"EOF(
+http_logs:
+  log_entry:
+    request:
+      path: "{}"
+)EOF",
+                                          path3));
+  entry.mutable_request()->set_path(path3);
+  logger_->log(envoy::data::accesslog::v2::HTTPAccessLogEntry(entry));
+  EXPECT_EQ(2, counterValue("logs_written"));
+  EXPECT_EQ(1, counterValue("logs_dropped"));
+}
+
 class GrpcAccessLoggerCacheImplTest : public testing::Test {
 public:
   GrpcAccessLoggerCacheImplTest() {
@@ -0,0 +1,108 @@
+#include <string>
+#include <vector>
+
+#include "envoy/config/accesslog/v2/protobuf_file.pb.h"
+#include "envoy/registry/registry.h"
+
+#include "common/access_log/access_log_impl.h"
+#include "common/protobuf/protobuf.h"
+
+#include "extensions/access_loggers/protobuf_file/config.h"
+#include "extensions/access_loggers/protobuf_file/protobuf_file_access_log_impl.h"
+#include "extensions/access_loggers/well_known_names.h"
+
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/server/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace ProtobufFile {
+namespace {
+
+// Reads the length-delimited entries of a record written to the file.
+std::vector<envoy::data::accesslog::v2::HTTPAccessLogEntry> parseDelimited(absl::string_view data) {
+  std::vector<envoy::data::accesslog::v2::HTTPAccessLogEntry> entries;
+  Protobuf::io::CodedInputStream stream(reinterpret_cast<const uint8_t*>(data.data()),
+                                        data.size());
+  uint32_t size;
+  while (stream.ReadVarint32(&size)) {
+    const auto limit = stream.PushLimit(size);
+    entries.emplace_back();
+    EXPECT_TRUE(entries.back().ParseFromCodedStream(&stream));
+    stream.PopLimit(limit);
+  }
+  return entries;
+}
+
+TEST(HttpProtobufFileAccessLogConfigTest, ValidateFail) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+
+  EXPECT_THROW(HttpProtobufFileAccessLogFactory().createAccessLogInstance(
+                   envoy::config::accesslog::v2::HttpProtobufFileAccessLogConfig(), nullptr,
+                   context),
+               ProtoValidationException);
+}
+
+TEST(HttpProtobufFileAccessLogConfigTest, ConfigureFromProto) {
+  envoy::config::filter::accesslog::v2::AccessLog config;
+  config.set_name(AccessLogNames::get().HttpProtobufFile);
+
+  envoy::config::accesslog::v2::HttpProtobufFileAccessLogConfig proto_config;
+  proto_config.set_path("/dev/null");
+  TestUtility::jsonConvert(proto_config, *config.mutable_config());
+
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  EXPECT_CALL(context.access_log_manager_, createAccessLog("/dev/null"));
+  AccessLog::InstanceSharedPtr log = AccessLog::AccessLogFactory::fromProto(config, context);
+
+  EXPECT_NE(nullptr, dynamic_cast<HttpProtobufFileAccessLog*>(log.get()));
+}
+
+TEST(HttpProtobufFileAccessLogTest, WritesDelimitedEntries) {
+  envoy::config::accesslog::v2::HttpProtobufFileAccessLogConfig config;
+  config.set_path("/dev/null");
+  config.add_additional_request_headers_to_log("x-custom");
+
+  NiceMock<AccessLog::MockAccessLogManager> log_manager;
+  HttpProtobufFileAccessLog log(nullptr, config, log_manager);
+
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  stream_info.response_code_ = 200;
+  Http::TestHeaderMapImpl request_headers{
+      {":method", "GET"}, {":path", "/foo"}, {"x-custom", "bar"}};
+  Http::TestHeaderMapImpl response_headers;
+  Http::TestHeaderMapImpl response_trailers;
+
+  std::string written;
+  EXPECT_CALL(*log_manager.file_, write(_))
+      .Times(2)
+      .WillRepeatedly(Invoke(
+          [&written](absl::string_view data) { written.append(data.data(), data.size()); }));
+  log.log(&request_headers, &response_headers, &response_trailers, stream_info);
+  stream_info.response_code_ = 503;
+  log.log(&request_headers, &response_headers, &response_trailers, stream_info);
+
+  const auto entries = parseDelimited(written);
+  ASSERT_EQ(2, entries.size());
+  EXPECT_EQ("/foo", entries[0].request().path());
+  EXPECT_EQ(envoy::api::v2::core::RequestMethod::GET, entries[0].request().request_method());
+  EXPECT_EQ("bar", entries[0].request().request_headers().at("x-custom"));
+  EXPECT_EQ(200, entries[0].response().response_code().value());
+  EXPECT_EQ(503, entries[1].response().response_code().value());
+}
+
+} // namespace
+} // namespace ProtobufFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
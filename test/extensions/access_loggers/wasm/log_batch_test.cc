@@ -0,0 +1,115 @@
+#include <cstring>
+
+#include "common/http/header_map_impl.h"
+
+#include "extensions/access_loggers/wasm/log_batch.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Wasm {
+namespace {
+
+// Reads the list serialized by a batch, as WasmData::list() does in the plugin.
+std::vector<std::string> parseList(absl::string_view data) {
+  uint32_t n;
+  memcpy(&n, data.data(), sizeof(n));
+  const char* sizes = data.data() + sizeof(n);
+  const char* item = sizes + n * sizeof(uint32_t);
+  std::vector<std::string> items;
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t size;
+    memcpy(&size, sizes + i * sizeof(uint32_t), sizeof(size));
+    items.emplace_back(item, size);
+    EXPECT_EQ('\0', item[size]);
+    item += size + 1;
+  }
+  EXPECT_EQ(data.data() + data.size(), item);
+  return items;
+}
+
+TEST(LogRecordFormatterTest, Format) {
+  Protobuf::Map<std::string, std::string> fields;
+  fields["path"] = "%REQ(:PATH)%";
+  fields["code"] = "%RESPONSE_CODE%";
+  LogRecordFormatter formatter(fields);
+
+  Http::TestHeaderMapImpl request_headers{{":path", "/foo"}};
+  Http::TestHeaderMapImpl response_headers;
+  Http::TestHeaderMapImpl response_trailers;
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  stream_info.response_code_ = 200;
+
+  const std::string record =
+      formatter.format(request_headers, response_headers, response_trailers, stream_info);
+  // The fields are sorted by name.
+  const uint32_t header[] = {2, 4, 3, 4, 4};
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(header), sizeof(header)) +
+                std::string("code\0200\0path\0/foo\0", 19),
+            record);
+}
+
+class LogBatchTest : public testing::Test {
+protected:
+  LogBatchTest() : timer_(new NiceMock<Event::MockTimer>(&dispatcher_)) {}
+
+  void createBatch(uint32_t max_records) {
+    batch_ = std::make_unique<LogBatch>(dispatcher_, max_records, std::chrono::milliseconds(1000),
+                                        [this](absl::string_view records) {
+                                          batches_.push_back(parseList(records));
+                                        });
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Event::MockTimer>* timer_;
+  LogBatchPtr batch_;
+  std::vector<std::vector<std::string>> batches_;
+};
+
+TEST_F(LogBatchTest, FlushWhenFull) {
+  createBatch(2);
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(1000)));
+  batch_->add("a");
+  EXPECT_TRUE(batches_.empty());
+
+  EXPECT_CALL(*timer_, disableTimer());
+  batch_->add(std::string("b\0c", 3));
+  ASSERT_EQ(1, batches_.size());
+  EXPECT_EQ((std::vector<std::string>{"a", std::string("b\0c", 3)}), batches_[0]);
+
+  // The next record starts a new batch and arms the timer again.
+  EXPECT_CALL(*timer_, enableTimer(_));
+  batch_->add("d");
+  EXPECT_EQ(1, batches_.size());
+}
+
+TEST_F(LogBatchTest, FlushOnTimer) {
+  createBatch(100);
+  EXPECT_CALL(*timer_, enableTimer(_)).Times(1);
+  batch_->add("a");
+  batch_->add("b");
+
+  timer_->invokeCallback();
+  ASSERT_EQ(1, batches_.size());
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), batches_[0]);
+
+  // An empty batch is not delivered.
+  batch_->flush();
+  EXPECT_EQ(1, batches_.size());
+}
+
+} // namespace
+} // namespace Wasm
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -41,8 +41,8 @@ public:
     // actually correct. It's possible this will have to change in the future.
     EXPECT_CALL(*dns_cache_manager_->dns_cache_, addUpdateCallbacks_(_))
         .WillOnce(DoAll(SaveArgAddress(&update_callbacks_), Return(nullptr)));
-    cluster_ = std::make_shared<Cluster>(cluster_config, config, runtime_, *this, local_info_,
-                                         factory_context, std::move(scope), false);
+    cluster_ = std::make_shared<Cluster>(cluster_config, config, runtime_, *this, factory_context,
+                                         std::move(scope), false);
     thread_aware_lb_ = std::make_unique<Cluster::ThreadAwareLoadBalancer>(*cluster_);
     lb_factory_ = thread_aware_lb_->factory();
     refreshLb();
@@ -67,6 +67,7 @@ public:
 
     // Allow touch() to still be strict.
     EXPECT_CALL(*host_map_[host], address()).Times(AtLeast(0));
+    EXPECT_CALL(*host_map_[host], addressList()).Times(AtLeast(0));
     EXPECT_CALL(*host_map_[host], isIpAddress()).Times(AtLeast(0));
     EXPECT_CALL(*host_map_[host], resolvedHost()).Times(AtLeast(0));
   }
@@ -164,6 +165,34 @@ TEST_F(ClusterTest, BasicFlow) {
   EXPECT_EQ(nullptr, lb_->chooseHost(setHostAndReturnContext("host1")));
 }
 
+// Hosts added and removed among others, which are kept in place.
+TEST_F(ClusterTest, MultipleHosts) {
+  initialize(default_yaml_config_, false);
+  makeTestHost("host1", "1.2.3.4");
+  makeTestHost("host2", "2.3.4.5");
+  makeTestHost("host3", "3.4.5.6");
+
+  EXPECT_CALL(*this, onMemberUpdateCb(SizeIs(1), SizeIs(0))).Times(3);
+  update_callbacks_->onDnsHostAddOrUpdate("host1", host_map_["host1"]);
+  update_callbacks_->onDnsHostAddOrUpdate("host2", host_map_["host2"]);
+  update_callbacks_->onDnsHostAddOrUpdate("host3", host_map_["host3"]);
+  EXPECT_EQ(3UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+
+  EXPECT_CALL(*this, onMemberUpdateCb(SizeIs(0), SizeIs(1)));
+  update_callbacks_->onDnsHostRemove("host2");
+  const auto& hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+  ASSERT_EQ(2UL, hosts.size());
+  EXPECT_EQ("1.2.3.4:0", hosts[0]->address()->asString());
+  EXPECT_EQ("3.4.5.6:0", hosts[1]->address()->asString());
+
+  refreshLb();
+  EXPECT_CALL(*host_map_["host1"], touch());
+  EXPECT_EQ("1.2.3.4:0", lb_->chooseHost(setHostAndReturnContext("host1"))->address()->asString());
+  EXPECT_EQ(nullptr, lb_->chooseHost(setHostAndReturnContext("host2")));
+  EXPECT_CALL(*host_map_["host3"], touch());
+  EXPECT_EQ("3.4.5.6:0", lb_->chooseHost(setHostAndReturnContext("host3"))->address()->asString());
+}
+
 // Various invalid LB context permutations in case the cluster is used outside of HTTP.
 TEST_F(ClusterTest, InvalidLbContext) {
   initialize(default_yaml_config_, false);
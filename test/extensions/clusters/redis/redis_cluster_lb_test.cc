@@ -26,6 +26,10 @@ public:
   // Upstream::LoadBalancerContext
   absl::optional<uint64_t> computeHashKey() override { return hash_key_; }
 
+  bool shouldSelectAnotherHost(const Upstream::Host& host) override {
+    return &host == excluded_host_.get();
+  }
+
   bool isReadCommand() const override { return is_read_; };
   NetworkFilters::Common::Redis::Client::ReadPolicy readPolicy() const override {
     return read_policy_;
@@ -34,6 +38,7 @@ public:
   absl::optional<uint64_t> hash_key_;
   bool is_read_;
   NetworkFilters::Common::Redis::Client::ReadPolicy read_policy_;
+  Upstream::HostConstSharedPtr excluded_host_;
 };
 
 class RedisClusterLoadBalancerTest : public testing::Test {
@@ -268,6 +273,45 @@ TEST_F(RedisClusterLoadBalancerTest, ReadStrategiesUnhealthyReplica) {
                      NetworkFilters::Common::Redis::Client::ReadPolicy::Any);
 }
 
+// The replica with the fewest active requests is chosen, the hosts rejected by the context being
+// skipped.
+TEST_F(RedisClusterLoadBalancerTest, ReadStrategiesLeastRequest) {
+  Upstream::HostVector hosts{
+      Upstream::makeTestHost(info_, "tcp://127.0.0.1:90"),
+      Upstream::makeTestHost(info_, "tcp://127.0.0.2:90"),
+      Upstream::makeTestHost(info_, "tcp://127.0.0.3:90"),
+  };
+
+  ClusterSlotsPtr slots = std::make_unique<std::vector<ClusterSlot>>(std::vector<ClusterSlot>{
+      ClusterSlot(0, 16383, hosts[0]->address()),
+  });
+  slots->at(0).addReplica(hosts[1]->address());
+  slots->at(0).addReplica(hosts[2]->address());
+  Upstream::HostMap all_hosts;
+  std::transform(hosts.begin(), hosts.end(), std::inserter(all_hosts, all_hosts.end()), makePair);
+  init();
+  factory_->onClusterSlotUpdate(std::move(slots), all_hosts);
+  hosts[1]->stats().rq_active_.set(5);
+
+  Upstream::LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(1100, true,
+                                  NetworkFilters::Common::Redis::Client::ReadPolicy::Replica);
+  // Both replicas are candidates, whatever their order.
+  EXPECT_CALL(random_, random())
+      .WillOnce(Return(0))
+      .WillOnce(Return(1))
+      .WillRepeatedly(Return(0));
+  EXPECT_EQ(hosts[2], lb->chooseHost(&context));
+
+  context.excluded_host_ = hosts[2];
+  EXPECT_EQ(hosts[1], lb->chooseHost(&context));
+
+  context.read_policy_ = NetworkFilters::Common::Redis::Client::ReadPolicy::PreferMaster;
+  EXPECT_EQ(hosts[0], lb->chooseHost(&context));
+  context.excluded_host_ = hosts[0];
+  EXPECT_NE(hosts[0], lb->chooseHost(&context));
+}
+
 TEST_F(RedisClusterLoadBalancerTest, ReadStrategiesNoReplica) {
   Upstream::HostVector hosts{Upstream::makeTestHost(info_, "tcp://127.0.0.1:90"),
                              Upstream::makeTestHost(info_, "tcp://127.0.0.1:91")};
@@ -19,12 +19,12 @@ namespace {
 
 class DnsCacheImplTest : public testing::Test, public Event::TestUsingSimulatedTime {
 public:
-  void initialize() {
+  void
+  initialize(envoy::api::v2::Cluster::DnsLookupFamily family = envoy::api::v2::Cluster::V4_ONLY) {
     config_.set_name("foo");
-    config_.set_dns_lookup_family(envoy::api::v2::Cluster::V4_ONLY);
+    config_.set_dns_lookup_family(family);
 
-    EXPECT_CALL(dispatcher_, createDnsResolver(_)).WillOnce(Return(resolver_));
-    dns_cache_ = std::make_unique<DnsCacheImpl>(dispatcher_, tls_, store_, config_);
+    dns_cache_ = std::make_unique<DnsCacheImpl>(dispatcher_, resolver_, tls_, store_, config_);
     update_callbacks_handle_ = dns_cache_->addUpdateCallbacks(update_callbacks_);
   }
 
@@ -137,6 +137,47 @@ TEST_F(DnsCacheImplTest, ResolveSuccess) {
              1 /* added */, 0 /* removed */, 1 /* num hosts */);
 }
 
+// With both families resolved, the host keeps all the addresses, and a change of any of them is an
+// address change.
+TEST_F(DnsCacheImplTest, ResolveAllFamilies) {
+  initialize(envoy::api::v2::Cluster::ALL);
+  InSequence s;
+
+  MockLoadDnsCacheEntryCallbacks callbacks;
+  Network::DnsResolver::ResolveCb resolve_cb;
+  Event::MockTimer* resolve_timer = new Event::MockTimer(&dispatcher_);
+  EXPECT_CALL(*resolver_, resolve("foo.com", Network::DnsLookupFamily::All, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  auto result = dns_cache_->loadDnsCacheEntry("foo.com", 80, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result.status_);
+
+  DnsHostInfoSharedPtr host_info;
+  EXPECT_CALL(update_callbacks_,
+              onDnsHostAddOrUpdate("foo.com", DnsHostInfoEquals("[::1]:80", "foo.com", false)))
+      .WillOnce(SaveArg<1>(&host_info));
+  EXPECT_CALL(callbacks, onLoadDnsCacheComplete());
+  EXPECT_CALL(*resolve_timer, enableTimer(std::chrono::milliseconds(60000)));
+  resolve_cb(TestUtility::makeDnsResponse({"::1", "10.0.0.1"}));
+
+  ASSERT_EQ(2UL, host_info->addressList().size());
+  EXPECT_EQ("[::1]:80", host_info->addressList()[0]->asString());
+  EXPECT_EQ("10.0.0.1:80", host_info->addressList()[1]->asString());
+
+  EXPECT_CALL(*resolver_, resolve("foo.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  resolve_timer->invokeCallback();
+
+  // Only the second address changes.
+  EXPECT_CALL(update_callbacks_,
+              onDnsHostAddOrUpdate("foo.com", DnsHostInfoEquals("[::1]:80", "foo.com", false)));
+  EXPECT_CALL(*resolve_timer, enableTimer(std::chrono::milliseconds(60000)));
+  resolve_cb(TestUtility::makeDnsResponse({"::1", "10.0.0.2"}));
+
+  EXPECT_EQ("10.0.0.2:80", host_info->addressList()[1]->asString());
+  checkStats(2 /* attempt */, 2 /* success */, 0 /* failure */, 2 /* address changed */,
+             1 /* added */, 0 /* removed */, 1 /* num hosts */);
+}
+
 // Ipv4 address.
 TEST_F(DnsCacheImplTest, Ipv4Address) {
   initialize();
@@ -518,12 +559,60 @@ TEST_F(DnsCacheImplTest, MaxHostOverflow) {
   EXPECT_EQ(1, TestUtility::findCounter(store_, "dns_cache.foo.host_overflow")->value());
 }
 
+// Least recently used hosts are evicted rather than overflowing.
+TEST_F(DnsCacheImplTest, MaxHostEviction) {
+  config_.mutable_max_hosts()->set_value(2);
+  config_.set_evict_least_recently_used_hosts(true);
+  initialize();
+  InSequence s;
+
+  MockLoadDnsCacheEntryCallbacks callbacks;
+  Network::DnsResolver::ResolveCb resolve_cb;
+  DnsHostInfoSharedPtr foo_host_info;
+  EXPECT_CALL(*resolver_, resolve("foo.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  auto result = dns_cache_->loadDnsCacheEntry("foo.com", 80, callbacks);
+  EXPECT_CALL(update_callbacks_, onDnsHostAddOrUpdate("foo.com", _))
+      .WillOnce(SaveArg<1>(&foo_host_info));
+  EXPECT_CALL(callbacks, onLoadDnsCacheComplete());
+  resolve_cb(TestUtility::makeDnsResponse({"10.0.0.1"}));
+
+  simTime().sleep(std::chrono::milliseconds(1));
+  EXPECT_CALL(*resolver_, resolve("bar.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  result = dns_cache_->loadDnsCacheEntry("bar.com", 80, callbacks);
+  EXPECT_CALL(update_callbacks_, onDnsHostAddOrUpdate("bar.com", _));
+  EXPECT_CALL(callbacks, onLoadDnsCacheComplete());
+  resolve_cb(TestUtility::makeDnsResponse({"10.0.0.2"}));
+
+  // foo.com is used after bar.com, which is evicted to make room for baz.com.
+  simTime().sleep(std::chrono::milliseconds(1));
+  foo_host_info->touch();
+  EXPECT_CALL(update_callbacks_, onDnsHostRemove("bar.com"));
+  EXPECT_CALL(*resolver_, resolve("baz.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  result = dns_cache_->loadDnsCacheEntry("baz.com", 80, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result.status_);
+  EXPECT_NE(result.handle_, nullptr);
+
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::InCache,
+            dns_cache_->loadDnsCacheEntry("foo.com", 80, callbacks).status_);
+  EXPECT_EQ(1, TestUtility::findCounter(store_, "dns_cache.foo.host_evicted")->value());
+  EXPECT_EQ(0, TestUtility::findCounter(store_, "dns_cache.foo.host_overflow")->value());
+  checkStats(3 /* attempt */, 2 /* success */, 0 /* failure */, 2 /* address changed */,
+             3 /* added */, 1 /* removed */, 2 /* num hosts */);
+
+  // The pending resolution of baz.com is cancelled with the cache.
+  EXPECT_CALL(resolver_->active_query_, cancel());
+  dns_cache_.reset();
+}
+
 // DNS cache manager config tests.
 TEST(DnsCacheManagerImplTest, LoadViaConfig) {
   NiceMock<Event::MockDispatcher> dispatcher;
   NiceMock<ThreadLocal::MockInstance> tls;
   Stats::IsolatedStoreImpl store;
-  DnsCacheManagerImpl cache_manager(dispatcher, tls, store);
+  DnsCacheManagerImpl cache_manager(dispatcher, nullptr, tls, store);
 
   envoy::config::common::dynamic_forward_proxy::v2alpha::DnsCacheConfig config1;
   config1.set_name("foo");
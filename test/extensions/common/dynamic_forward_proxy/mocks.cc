@@ -1,6 +1,7 @@
 #include "test/extensions/common/dynamic_forward_proxy/mocks.h"
 
 using testing::_;
+using testing::Invoke;
 using testing::Return;
 using testing::ReturnPointee;
 using testing::ReturnRef;
@@ -23,6 +24,9 @@ MockDnsCacheManager::~MockDnsCacheManager() = default;
 
 MockDnsHostInfo::MockDnsHostInfo() {
   ON_CALL(*this, address()).WillByDefault(ReturnPointee(&address_));
+  ON_CALL(*this, addressList()).WillByDefault(Invoke([this]() {
+    return std::vector<Network::Address::InstanceConstSharedPtr>{address_};
+  }));
   ON_CALL(*this, resolvedHost()).WillByDefault(ReturnRef(resolved_host_));
 }
 MockDnsHostInfo::~MockDnsHostInfo() = default;
@@ -62,6 +62,7 @@ public:
   ~MockDnsHostInfo() override;
 
   MOCK_METHOD0(address, Network::Address::InstanceConstSharedPtr());
+  MOCK_METHOD0(addressList, std::vector<Network::Address::InstanceConstSharedPtr>());
   MOCK_METHOD0(resolvedHost, const std::string&());
   MOCK_METHOD0(isIpAddress, bool());
   MOCK_METHOD0(touch, void());
@@ -2,6 +2,9 @@
 
 #include "extensions/common/tap/tap_config_base.h"
 
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -157,6 +160,72 @@ TEST(TrimSlice, All) {
   }
 }
 
+std::vector<envoy::data::tap::v2alpha::TraceWrapper> readDelimitedTraces(const std::string& path) {
+  const std::string data = TestEnvironment::readFileToStringForTest(path);
+  Protobuf::io::ArrayInputStream stream(data.data(), data.size());
+  Protobuf::io::CodedInputStream coded_stream(&stream);
+  std::vector<envoy::data::tap::v2alpha::TraceWrapper> traces;
+  uint32_t size;
+  while (coded_stream.ReadVarint32(&size)) {
+    const auto limit = coded_stream.PushLimit(size);
+    traces.emplace_back();
+    EXPECT_TRUE(traces.back().ParseFromCodedStream(&coded_stream));
+    coded_stream.PopLimit(limit);
+  }
+  return traces;
+}
+
+TraceWrapperPtr makeTrace(uint64_t trace_id, const std::string& body) {
+  TraceWrapperPtr trace = makeTraceWrapper();
+  trace->mutable_http_streamed_trace_segment()->set_trace_id(trace_id);
+  trace->mutable_http_streamed_trace_segment()->mutable_request_body_chunk()->set_as_bytes(body);
+  return trace;
+}
+
+TEST(StreamingFileSink, BatchesTraces) {
+  const std::string path = TestEnvironment::temporaryPath("streaming_tap_batches");
+  envoy::service::tap::v2alpha::StreamingFileSink config;
+  config.set_path(path);
+  config.mutable_max_batch_bytes()->set_value(64);
+  StreamingFileSink sink(config);
+
+  PerTapSinkHandlePtr handle1 = sink.createPerTapSinkHandle(1);
+  PerTapSinkHandlePtr handle2 = sink.createPerTapSinkHandle(2);
+  const auto format = envoy::service::tap::v2alpha::OutputSink::PROTO_BINARY_LENGTH_DELIMITED;
+  handle1->submitTrace(makeTrace(1, std::string(20, 'a')), format);
+  handle2->submitTrace(makeTrace(2, std::string(20, 'b')), format);
+  EXPECT_TRUE(readDelimitedTraces(path).empty());
+
+  // The second trace of the first tap does not fit in its batch, which is written.
+  handle1->submitTrace(makeTrace(1, std::string(40, 'c')), format);
+  std::vector<envoy::data::tap::v2alpha::TraceWrapper> traces = readDelimitedTraces(path);
+  ASSERT_EQ(1, traces.size());
+  EXPECT_EQ(std::string(20, 'a'),
+            traces[0].http_streamed_trace_segment().request_body_chunk().as_bytes());
+
+  // A trace larger than the batch is written on its own.
+  handle2->submitTrace(makeTrace(2, std::string(100, 'd')), format);
+  EXPECT_EQ(3, readDelimitedTraces(path).size());
+
+  // The remaining batches are written when the taps end.
+  handle1.reset();
+  handle2.reset();
+  traces = readDelimitedTraces(path);
+  ASSERT_EQ(4, traces.size());
+  EXPECT_EQ(2, traces[1].http_streamed_trace_segment().trace_id());
+  EXPECT_EQ(std::string(100, 'd'),
+            traces[2].http_streamed_trace_segment().request_body_chunk().as_bytes());
+  EXPECT_EQ(std::string(40, 'c'),
+            traces[3].http_streamed_trace_segment().request_body_chunk().as_bytes());
+}
+
+TEST(StreamingFileSink, BadPath) {
+  envoy::service::tap::v2alpha::StreamingFileSink config;
+  config.set_path("/nonexistent/directory/tap");
+  EXPECT_THROW_WITH_REGEX(StreamingFileSink sink(config), EnvoyException,
+                          "unable to open streaming tap file");
+}
+
 } // namespace
 } // namespace Tap
 } // namespace Common
@@ -2,6 +2,7 @@
 
 #include "extensions/common/tap/tap_matcher.h"
 
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -18,6 +19,7 @@ public:
   Matcher::MatchStatusVector statuses_;
   envoy::service::tap::v2alpha::MatchPredicate config_;
   Http::TestHeaderMapImpl headers_;
+  Event::SimulatedTimeSystem time_system_;
 };
 
 TEST_F(TapMatcherTest, Any) {
@@ -27,7 +29,7 @@ any_match: true
 )EOF";
 
   TestUtility::loadFromYaml(matcher_yaml, config_);
-  buildMatcher(config_, matchers_);
+  buildMatcher(config_, matchers_, time_system_);
   EXPECT_EQ(1, matchers_.size());
   statuses_.resize(matchers_.size());
   matchers_[0]->onNewStream(statuses_);
@@ -50,7 +52,7 @@ not_match:
 )EOF";
 
   TestUtility::loadFromYaml(matcher_yaml, config_);
-  buildMatcher(config_, matchers_);
+  buildMatcher(config_, matchers_, time_system_);
   EXPECT_EQ(2, matchers_.size());
   statuses_.resize(matchers_.size());
   matchers_[0]->onNewStream(statuses_);
@@ -77,7 +79,7 @@ and_match:
 )EOF";
 
   TestUtility::loadFromYaml(matcher_yaml, config_);
-  buildMatcher(config_, matchers_);
+  buildMatcher(config_, matchers_, time_system_);
   EXPECT_EQ(2, matchers_.size());
   statuses_.resize(matchers_.size());
   matchers_[0]->onNewStream(statuses_);
@@ -92,6 +94,75 @@ and_match:
   EXPECT_EQ((Matcher::MatchStatus{false, false}), matchers_[0]->matchStatus(statuses_));
 }
 
+TEST_F(TapMatcherTest, SampleSpreadsStreams) {
+  const std::string matcher_yaml =
+      R"EOF(
+sample_match:
+  percentage:
+    numerator: 25
+)EOF";
+
+  TestUtility::loadFromYaml(matcher_yaml, config_);
+  buildMatcher(config_, matchers_, time_system_);
+  EXPECT_EQ(1, matchers_.size());
+  std::vector<bool> sampled;
+  for (int i = 0; i < 8; ++i) {
+    statuses_.assign(matchers_.size(), Matcher::MatchStatus());
+    matchers_[0]->onNewStream(statuses_);
+    EXPECT_FALSE(matchers_[0]->matchStatus(statuses_).might_change_status_);
+    sampled.push_back(matchers_[0]->matchStatus(statuses_).matches_);
+  }
+  EXPECT_EQ((std::vector<bool>{false, false, false, true, false, false, false, true}), sampled);
+}
+
+TEST_F(TapMatcherTest, SampleRateLimited) {
+  const std::string matcher_yaml =
+      R"EOF(
+sample_match:
+  percentage:
+    numerator: 100
+  max_streams_per_second: 2
+)EOF";
+
+  TestUtility::loadFromYaml(matcher_yaml, config_);
+  buildMatcher(config_, matchers_, time_system_);
+  auto sample = [this]() {
+    statuses_.assign(matchers_.size(), Matcher::MatchStatus());
+    matchers_[0]->onNewStream(statuses_);
+    return matchers_[0]->matchStatus(statuses_).matches_;
+  };
+  EXPECT_TRUE(sample());
+  EXPECT_TRUE(sample());
+  EXPECT_FALSE(sample());
+  time_system_.sleep(std::chrono::seconds(1));
+  EXPECT_TRUE(sample());
+}
+
+TEST_F(TapMatcherTest, AndSampleHeaders) {
+  const std::string matcher_yaml =
+      R"EOF(
+and_match:
+  rules:
+    - sample_match:
+        percentage:
+          numerator: 0
+    - http_request_headers_match:
+        headers:
+          - name: bar
+            exact_match: baz
+)EOF";
+
+  TestUtility::loadFromYaml(matcher_yaml, config_);
+  buildMatcher(config_, matchers_, time_system_);
+  EXPECT_EQ(3, matchers_.size());
+  statuses_.resize(matchers_.size());
+  matchers_[0]->onNewStream(statuses_);
+  EXPECT_EQ((Matcher::MatchStatus{false, true}), matchers_[0]->matchStatus(statuses_));
+  headers_.addCopy("bar", "baz");
+  matchers_[0]->onHttpRequestHeaders(headers_, statuses_);
+  EXPECT_EQ((Matcher::MatchStatus{false, false}), matchers_[0]->matchStatus(statuses_));
+}
+
 } // namespace
 } // namespace Tap
 } // namespace Common
@@ -32,6 +32,21 @@ TEST(Context, EmptyHeadersAttributes) {
   EXPECT_TRUE(headers.empty());
 }
 
+TEST(Context, HeadersLookupsAreMemoized) {
+  Http::TestHeaderMapImpl header_map{{"foo", "bar"}};
+  HeadersWrapper headers(&header_map);
+  auto header = headers[CelValue::CreateString("foo")];
+  ASSERT_TRUE(header.has_value());
+  EXPECT_EQ("bar", header.value().StringOrDie().value());
+  EXPECT_FALSE(headers[CelValue::CreateString("baz")].has_value());
+
+  // The headers of an activation do not change while it is in use, so a second lookup of the
+  // same header is served from the first one.
+  header_map.addCopy(Http::LowerCaseString("baz"), "qux");
+  EXPECT_FALSE(headers[CelValue::CreateString("baz")].has_value());
+  EXPECT_EQ("bar", headers[CelValue::CreateString("foo")].value().StringOrDie().value());
+}
+
 TEST(Context, RequestAttributes) {
   NiceMock<StreamInfo::MockStreamInfo> info;
   Http::TestHeaderMapImpl header_map{
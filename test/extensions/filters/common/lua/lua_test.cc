@@ -11,6 +11,7 @@
 using testing::_;
 using testing::InSequence;
 using testing::NiceMock;
+using testing::Return;
 
 namespace Envoy {
 namespace Extensions {
@@ -157,6 +158,65 @@ TEST_F(LuaTest, MarkDead) {
   lua_gc(cr1->luaState(), LUA_GCCOLLECT, 0);
 }
 
+// The threads of coroutines which returned are reused, the others are not.
+TEST_F(LuaTest, CoroutinePool) {
+  const std::string SCRIPT{R"EOF(
+    function callMe(object)
+      object:testCall()
+      return 1, 2
+    end
+
+    function yieldMe()
+      coroutine.yield()
+    end
+
+    function failMe()
+      error("failed")
+    end
+  )EOF"};
+
+  setup(SCRIPT);
+  const int call_me = state_->getGlobalRef(state_->registerGlobal("callMe"));
+  const int yield_me = state_->getGlobalRef(state_->registerGlobal("yieldMe"));
+  const int fail_me = state_->getGlobalRef(state_->registerGlobal("failMe"));
+
+  CoroutinePtr cr(state_->createCoroutine());
+  lua_State* thread = cr->luaState();
+  TestObject* object = TestObject::create(thread).first;
+  EXPECT_CALL(*object, doTestCall(_)).WillOnce(Return(0));
+  EXPECT_CALL(*object, onDestroy());
+  cr->start(call_me, 1, yield_callback_);
+  EXPECT_EQ(2, lua_gettop(thread));
+  cr.reset();
+  EXPECT_EQ(1, state_->pooledCoroutines());
+
+  // The pooled thread starts from an empty stack.
+  cr = state_->createCoroutine();
+  EXPECT_EQ(thread, cr->luaState());
+  EXPECT_EQ(0, lua_gettop(thread));
+  EXPECT_EQ(0, state_->pooledCoroutines());
+  object = TestObject::create(thread).first;
+  EXPECT_CALL(*object, doTestCall(_)).WillOnce(Return(0));
+  EXPECT_CALL(*object, onDestroy());
+  cr->start(call_me, 1, yield_callback_);
+  EXPECT_EQ(cr->state(), Coroutine::State::Finished);
+
+  CoroutinePtr yielded(state_->createCoroutine());
+  EXPECT_CALL(on_yield_, ready());
+  yielded->start(yield_me, 0, yield_callback_);
+  yielded.reset();
+  EXPECT_EQ(0, state_->pooledCoroutines());
+
+  CoroutinePtr failed(state_->createCoroutine());
+  EXPECT_THROW(failed->start(fail_me, 0, yield_callback_), LuaException);
+  failed.reset();
+  EXPECT_EQ(0, state_->pooledCoroutines());
+
+  cr.reset();
+  EXPECT_EQ(1, state_->pooledCoroutines());
+  lua_gc(thread, LUA_GCCOLLECT, 0);
+}
+
 } // namespace
 } // namespace Lua
 } // namespace Common
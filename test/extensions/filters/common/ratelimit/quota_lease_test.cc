@@ -0,0 +1,75 @@
+#include <chrono>
+
+#include "extensions/filters/common/ratelimit/quota_lease.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RateLimit {
+namespace {
+
+class QuotaLeasesTest : public testing::Test {
+protected:
+  Event::SimulatedTimeSystem time_system_;
+  QuotaLeases leases_{3, std::chrono::seconds(1), 2, time_system_};
+};
+
+// Descriptors are part of the key, and do not run into each other.
+TEST_F(QuotaLeasesTest, Key) {
+  EXPECT_EQ(QuotaLeases::key("foo", {{{{"a", "b"}}}}), QuotaLeases::key("foo", {{{{"a", "b"}}}}));
+  EXPECT_NE(QuotaLeases::key("foo", {{{{"a", "b"}}}}), QuotaLeases::key("bar", {{{{"a", "b"}}}}));
+  EXPECT_NE(QuotaLeases::key("foo", {{{{"a", "b"}, {"c", "d"}}}}),
+            QuotaLeases::key("foo", {{{{"a", "b"}}}, {{{"c", "d"}}}}));
+  EXPECT_NE(QuotaLeases::key("foo", {{{{"ab", ""}}}}), QuotaLeases::key("foo", {{{{"a", "b"}}}}));
+}
+
+// The hits of a lease, but the one used by the request that asked for it, are consumed.
+TEST_F(QuotaLeasesTest, Consume) {
+  EXPECT_FALSE(leases_.tryConsume("a"));
+  leases_.addLease("a");
+  EXPECT_TRUE(leases_.tryConsume("a"));
+  EXPECT_TRUE(leases_.tryConsume("a"));
+  EXPECT_FALSE(leases_.tryConsume("a"));
+  EXPECT_EQ(0, leases_.size());
+}
+
+// A lease can not be used once expired, and a new lease replaces the hits left.
+TEST_F(QuotaLeasesTest, Expiry) {
+  leases_.addLease("a");
+  time_system_.sleep(std::chrono::seconds(1));
+  EXPECT_FALSE(leases_.tryConsume("a"));
+
+  leases_.addLease("a");
+  EXPECT_TRUE(leases_.tryConsume("a"));
+  leases_.addLease("a");
+  EXPECT_TRUE(leases_.tryConsume("a"));
+  EXPECT_TRUE(leases_.tryConsume("a"));
+  EXPECT_FALSE(leases_.tryConsume("a"));
+}
+
+// Beyond the maximum number of leases, expired ones are removed, and otherwise the lease is not
+// recorded.
+TEST_F(QuotaLeasesTest, MaxLeases) {
+  leases_.addLease("a");
+  leases_.addLease("b");
+  leases_.addLease("c");
+  EXPECT_EQ(2, leases_.size());
+  EXPECT_FALSE(leases_.tryConsume("c"));
+
+  time_system_.sleep(std::chrono::seconds(1));
+  leases_.addLease("c");
+  EXPECT_EQ(1, leases_.size());
+  EXPECT_TRUE(leases_.tryConsume("c"));
+}
+
+} // namespace
+} // namespace RateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -124,6 +124,23 @@ TEST_F(RateLimitGrpcClientTest, Basic) {
   }
 }
 
+// A lease asks for its hits with the hits_addend of the request.
+TEST_F(RateLimitGrpcClientTest, Lease) {
+  envoy::service::ratelimit::v2::RateLimitRequest request;
+  GrpcClientImpl::createRequest(request, "foo", {{{{"foo", "bar"}}}});
+  request.set_hits_addend(10);
+  EXPECT_CALL(*async_client_, sendRaw(_, _, Grpc::ProtoBufferEq(request), _, _, _))
+      .WillOnce(Return(&async_request_));
+
+  client_.lease(request_callbacks_, "foo", {{{{"foo", "bar"}}}}, Tracing::NullSpan::instance(), 10);
+
+  auto response = std::make_unique<envoy::service::ratelimit::v2::RateLimitResponse>();
+  response->set_overall_code(envoy::service::ratelimit::v2::RateLimitResponse_Code_OK);
+  EXPECT_CALL(span_, setTag(Eq("ratelimit_status"), Eq("ok")));
+  EXPECT_CALL(request_callbacks_, complete_(LimitStatus::OK, _));
+  client_.onSuccess(std::move(response), span_);
+}
+
 TEST_F(RateLimitGrpcClientTest, Cancel) {
   std::unique_ptr<envoy::service::ratelimit::v2::RateLimitResponse> response;
 
@@ -199,6 +199,53 @@ TEST(RoleBasedAccessControlEngineImpl, HeaderCondition) {
   checkEngine(engine, true, Envoy::Network::MockConnection(), headers);
 }
 
+// The conditions of several policies are evaluated against the activation of the first one.
+TEST(RoleBasedAccessControlEngineImpl, HeaderConditionsOfSeveralPolicies) {
+  envoy::config::rbac::v2::RBAC rbac;
+  rbac.set_action(envoy::config::rbac::v2::RBAC_Action::RBAC_Action_ALLOW);
+  for (const std::string value : {"bar", "baz"}) {
+    envoy::config::rbac::v2::Policy policy;
+    policy.add_permissions()->set_any(true);
+    policy.add_principals()->set_any(true);
+    const std::string condition = fmt::format(R"EOF(
+      call_expr:
+        function: _==_
+        args:
+        - call_expr:
+            function: _[_]
+            args:
+            - select_expr:
+                operand:
+                  ident_expr:
+                    name: request
+                field: headers
+            - const_expr:
+                string_value: foo
+        - const_expr:
+            string_value: {}
+    )EOF",
+                                              value);
+    policy.mutable_condition()->MergeFrom(
+        TestUtility::parseYaml<google::api::expr::v1alpha1::Expr>(condition));
+    (*rbac.mutable_policies())["policy_" + value] = policy;
+  }
+  RBAC::RoleBasedAccessControlEngineImpl engine(rbac);
+
+  Envoy::Http::HeaderMapImpl headers;
+  Envoy::Http::LowerCaseString key("foo");
+  std::string value = "baz";
+  headers.setReference(key, value);
+
+  std::string policy_id;
+  checkEngine(engine, true, Envoy::Network::MockConnection(), headers,
+              envoy::api::v2::core::Metadata(), &policy_id);
+  EXPECT_EQ("policy_baz", policy_id);
+
+  value = "qux";
+  headers.setReference(key, value);
+  checkEngine(engine, false, Envoy::Network::MockConnection(), headers);
+}
+
 TEST(RoleBasedAccessControlEngineImpl, MetadataCondition) {
   envoy::config::rbac::v2::Policy policy;
   policy.add_permissions()->set_any(true);
@@ -1,3 +1,4 @@
+#include "common/network/address_impl.h"
 #include "common/network/utility.h"
 
 #include "extensions/filters/common/rbac/matchers.h"
@@ -118,6 +119,52 @@ TEST(OrMatcher, Principal_Set) {
   checkMatcher(RBAC::OrMatcher(set), true, conn);
 }
 
+TEST(OrMatcher, Permission_SetMergedIPsAndPorts) {
+  envoy::config::rbac::v2::Permission_Set set;
+  for (const std::string prefix : {"10.0.0.0", "192.168.1.0", "2001:abcd::"}) {
+    auto* cidr = set.add_rules()->mutable_destination_ip();
+    cidr->set_address_prefix(prefix);
+    cidr->mutable_prefix_len()->set_value(24);
+  }
+  set.add_rules()->set_destination_port(80);
+  set.add_rules()->set_destination_port(443);
+
+  Envoy::Network::MockConnection conn;
+  Envoy::Network::Address::InstanceConstSharedPtr addr;
+  EXPECT_CALL(conn, localAddress()).WillRepeatedly(ReturnRef(addr));
+  RBAC::OrMatcher matcher(set);
+
+  addr = Envoy::Network::Utility::parseInternetAddress("192.168.1.7", 8080, false);
+  checkMatcher(matcher, true, conn);
+  addr = Envoy::Network::Utility::parseInternetAddress("2001:abcd::1", 8080, false);
+  checkMatcher(matcher, true, conn);
+  addr = Envoy::Network::Utility::parseInternetAddress("192.168.2.7", 443, false);
+  checkMatcher(matcher, true, conn);
+  addr = Envoy::Network::Utility::parseInternetAddress("192.168.2.7", 8080, false);
+  checkMatcher(matcher, false, conn);
+  addr = std::make_shared<const Envoy::Network::Address::PipeInstance>("test");
+  checkMatcher(matcher, false, conn);
+}
+
+TEST(OrMatcher, Principal_SetMergedIPs) {
+  envoy::config::rbac::v2::Principal_Set set;
+  for (const std::string prefix : {"1.2.3.0", "4.5.6.0"}) {
+    auto* cidr = set.add_ids()->mutable_source_ip();
+    cidr->set_address_prefix(prefix);
+    cidr->mutable_prefix_len()->set_value(24);
+  }
+
+  Envoy::Network::MockConnection conn;
+  Envoy::Network::Address::InstanceConstSharedPtr addr;
+  EXPECT_CALL(conn, remoteAddress()).WillRepeatedly(ReturnRef(addr));
+  RBAC::OrMatcher matcher(set);
+
+  addr = Envoy::Network::Utility::parseInternetAddress("4.5.6.7", 456, false);
+  checkMatcher(matcher, true, conn);
+  addr = Envoy::Network::Utility::parseInternetAddress("4.5.7.7", 456, false);
+  checkMatcher(matcher, false, conn);
+}
+
 TEST(NotMatcher, Permission) {
   envoy::config::rbac::v2::Permission perm;
   perm.set_any(true);
@@ -25,6 +25,7 @@ class MockConcurrencyController : public ConcurrencyController::ConcurrencyContr
 public:
   MOCK_METHOD0(forwardingDecision, RequestForwardingAction());
   MOCK_METHOD1(recordLatencySample, void(const std::chrono::nanoseconds&));
+  MOCK_METHOD0(cancelLatencySample, void());
 };
 
 class AdaptiveConcurrencyFilterTest : public testing::Test {
@@ -89,6 +90,30 @@ TEST_F(AdaptiveConcurrencyFilterTest, EncodeHeadersValidTest) {
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers, false));
   EXPECT_CALL(*controller_, recordLatencySample(advance_time));
   filter_->encodeComplete();
+  filter_->onDestroy();
+}
+
+TEST_F(AdaptiveConcurrencyFilterTest, BlockedRequestNotSampled) {
+  Http::TestHeaderMapImpl request_headers;
+  EXPECT_CALL(*controller_, forwardingDecision()).WillOnce(Return(RequestForwardingAction::Block));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers, true));
+
+  EXPECT_CALL(*controller_, recordLatencySample(_)).Times(0);
+  EXPECT_CALL(*controller_, cancelLatencySample()).Times(0);
+  filter_->encodeComplete();
+  filter_->onDestroy();
+}
+
+TEST_F(AdaptiveConcurrencyFilterTest, ResetRequestCancelsSample) {
+  Http::TestHeaderMapImpl request_headers;
+  EXPECT_CALL(*controller_, forwardingDecision())
+      .WillOnce(Return(RequestForwardingAction::Forward));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+
+  EXPECT_CALL(*controller_, recordLatencySample(_)).Times(0);
+  EXPECT_CALL(*controller_, cancelLatencySample());
+  filter_->onDestroy();
 }
 
 } // namespace
@@ -0,0 +1,279 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "envoy/config/filter/http/adaptive_concurrency/v2alpha/adaptive_concurrency.pb.h"
+
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/adaptive_concurrency/concurrency_controller/gradient_controller.h"
+
+#include "test/mocks/runtime/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace AdaptiveConcurrency {
+namespace ConcurrencyController {
+namespace {
+
+GradientControllerConfigSharedPtr makeConfig(const std::string& yaml) {
+  envoy::config::filter::http::adaptive_concurrency::v2alpha::GradientControllerConfig proto;
+  TestUtility::loadFromYaml(yaml, proto);
+  return std::make_shared<const GradientControllerConfig>(proto);
+}
+
+class GradientControllerTest : public testing::Test {
+public:
+  GradientControllerSharedPtr makeController(const std::string& yaml) {
+    return std::make_shared<GradientController>(makeConfig(yaml), time_system_, random_,
+                                                "test_prefix.", stats_);
+  }
+
+  // Forward a request and sample its latency.
+  void sampleRequest(GradientController& controller, std::chrono::milliseconds latency) {
+    ASSERT_EQ(RequestForwardingAction::Forward, controller.forwardingDecision());
+    controller.recordLatencySample(latency);
+  }
+
+  void advanceTime(std::chrono::milliseconds duration) {
+    time_system_.setMonotonicTime(time_system_.monotonicTime() + duration);
+  }
+
+  uint64_t gauge(const std::string& name) {
+    return stats_.gauge("test_prefix.gradient_controller." + name,
+                        Stats::Gauge::ImportMode::NeverImport)
+        .value();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<Runtime::MockRandomGenerator> random_;
+  Stats::IsolatedStoreImpl stats_;
+};
+
+const std::string DefaultYaml = R"EOF(
+concurrency_limit_params:
+  concurrency_update_interval: 0.1s
+min_rtt_calc_params:
+  interval: 30s
+  request_count: 5
+  jitter:
+    value: 0
+)EOF";
+
+TEST(GradientControllerConfigTest, Defaults) {
+  const auto config = makeConfig(R"EOF(
+concurrency_limit_params:
+  concurrency_update_interval: 0.1s
+min_rtt_calc_params:
+  interval: 30s
+)EOF");
+  EXPECT_EQ(std::chrono::milliseconds(30000), config->minRTTCalcInterval());
+  EXPECT_EQ(std::chrono::milliseconds(100), config->sampleRTTCalcInterval());
+  EXPECT_EQ(1000, config->maxConcurrencyLimit());
+  EXPECT_EQ(50, config->minRTTAggregateRequestCount());
+  EXPECT_EQ(3, config->minConcurrency());
+  EXPECT_EQ(2.0, config->maxGradient());
+  EXPECT_DOUBLE_EQ(0.15, config->jitter());
+  EXPECT_DOUBLE_EQ(0.5, config->sampleAggregatePercentile());
+}
+
+TEST(GradientControllerConfigTest, Values) {
+  const auto config = makeConfig(R"EOF(
+sample_aggregate_percentile:
+  value: 90
+concurrency_limit_params:
+  max_gradient: 3.5
+  max_concurrency_limit: 20
+  concurrency_update_interval: 0.5s
+min_rtt_calc_params:
+  interval: 10s
+  request_count: 7
+  jitter:
+    value: 25
+  min_concurrency: 2
+)EOF");
+  EXPECT_EQ(std::chrono::milliseconds(10000), config->minRTTCalcInterval());
+  EXPECT_EQ(std::chrono::milliseconds(500), config->sampleRTTCalcInterval());
+  EXPECT_EQ(20, config->maxConcurrencyLimit());
+  EXPECT_EQ(7, config->minRTTAggregateRequestCount());
+  EXPECT_EQ(2, config->minConcurrency());
+  EXPECT_EQ(3.5, config->maxGradient());
+  EXPECT_DOUBLE_EQ(0.25, config->jitter());
+  EXPECT_DOUBLE_EQ(0.9, config->sampleAggregatePercentile());
+}
+
+TEST(LatencyHistogramTest, Buckets) {
+  for (uint64_t latency_us : {0, 1, 3, 4, 5, 7, 8, 100, 10000, 1000000}) {
+    const uint32_t bucket = LatencyHistogram::bucket(latency_us);
+    EXPECT_LE(latency_us, LatencyHistogram::bucketUpperBound(bucket)) << latency_us;
+    // The upper bound is within 25% of the latency.
+    EXPECT_LE(LatencyHistogram::bucketUpperBound(bucket), latency_us * 5 / 4 + 1) << latency_us;
+  }
+  EXPECT_EQ(LatencyHistogram::NumBuckets - 1, LatencyHistogram::bucket(1ULL << 40));
+}
+
+TEST(LatencyHistogramTest, Percentile) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(std::chrono::microseconds(0), histogram.percentile(0.5));
+
+  for (int i = 1; i <= 100; ++i) {
+    histogram.record(std::chrono::milliseconds(i));
+  }
+  EXPECT_EQ(100, histogram.count());
+  const std::chrono::microseconds p50 = histogram.percentile(0.5);
+  EXPECT_LE(std::chrono::milliseconds(50), p50);
+  EXPECT_GE(std::chrono::microseconds(50 * 1250), p50);
+  EXPECT_LE(std::chrono::milliseconds(100), histogram.percentile(1));
+  EXPECT_GE(std::chrono::milliseconds(1), histogram.percentile(0));
+
+  histogram.clear();
+  EXPECT_EQ(0, histogram.count());
+  EXPECT_EQ(std::chrono::microseconds(0), histogram.percentile(0.5));
+}
+
+// The limit is pinned to the minimum concurrency until the minimum round-trip time is measured.
+TEST_F(GradientControllerTest, MinRTTMeasuredFirst) {
+  const auto controller = makeController(DefaultYaml);
+  EXPECT_EQ(3, controller->concurrencyLimit());
+  EXPECT_EQ(1, gauge("min_rtt_calculation_active"));
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(RequestForwardingAction::Forward, controller->forwardingDecision());
+  }
+  EXPECT_EQ(RequestForwardingAction::Block, controller->forwardingDecision());
+  EXPECT_EQ(1, stats_.counter("test_prefix.gradient_controller.rq_blocked").value());
+  for (int i = 0; i < 3; ++i) {
+    controller->recordLatencySample(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(0, controller->numRequestsOutstanding());
+
+  // The measurement ends as soon as enough requests are sampled.
+  sampleRequest(*controller, std::chrono::milliseconds(10));
+  sampleRequest(*controller, std::chrono::milliseconds(10));
+  EXPECT_EQ(RequestForwardingAction::Forward, controller->forwardingDecision());
+  controller->cancelLatencySample();
+  EXPECT_EQ(0, gauge("min_rtt_calculation_active"));
+  EXPECT_EQ(10, gauge("min_rtt_msecs"));
+  EXPECT_EQ(3, controller->concurrencyLimit());
+}
+
+TEST_F(GradientControllerTest, LimitFollowsGradient) {
+  const auto controller = makeController(DefaultYaml);
+  for (int i = 0; i < 5; ++i) {
+    sampleRequest(*controller, std::chrono::milliseconds(10));
+  }
+
+  // While the latency stays at the minimum, the limit grows by its square root at each update.
+  uint32_t limit = controller->concurrencyLimit();
+  for (int i = 0; i < 5; ++i) {
+    sampleRequest(*controller, std::chrono::milliseconds(10));
+    advanceTime(std::chrono::milliseconds(100));
+    sampleRequest(*controller, std::chrono::milliseconds(10));
+    EXPECT_EQ(static_cast<uint32_t>(limit + std::sqrt(limit)), controller->concurrencyLimit());
+    limit = controller->concurrencyLimit();
+  }
+  EXPECT_EQ(10, gauge("sample_rtt_msecs"));
+
+  // Once the latency grows, requests are queuing upstream, and the limit shrinks by up to half.
+  for (int i = 0; i < 3; ++i) {
+    sampleRequest(*controller, std::chrono::milliseconds(40));
+  }
+  advanceTime(std::chrono::milliseconds(100));
+  EXPECT_EQ(RequestForwardingAction::Forward, controller->forwardingDecision());
+  controller->cancelLatencySample();
+  EXPECT_EQ(static_cast<uint32_t>(limit * 0.5 + std::sqrt(limit * 0.5)),
+            controller->concurrencyLimit());
+  EXPECT_EQ(40, gauge("sample_rtt_msecs"));
+
+  // No update without samples.
+  limit = controller->concurrencyLimit();
+  advanceTime(std::chrono::milliseconds(100));
+  EXPECT_EQ(RequestForwardingAction::Forward, controller->forwardingDecision());
+  controller->cancelLatencySample();
+  EXPECT_EQ(limit, controller->concurrencyLimit());
+}
+
+TEST_F(GradientControllerTest, LimitBounds) {
+  const auto controller = makeController(R"EOF(
+concurrency_limit_params:
+  max_concurrency_limit: 5
+  concurrency_update_interval: 0.1s
+min_rtt_calc_params:
+  interval: 30s
+  request_count: 1
+  min_concurrency: 2
+)EOF");
+  sampleRequest(*controller, std::chrono::milliseconds(10));
+
+  for (int i = 0; i < 10; ++i) {
+    sampleRequest(*controller, std::chrono::milliseconds(1));
+    advanceTime(std::chrono::milliseconds(100));
+    sampleRequest(*controller, std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(5, controller->concurrencyLimit());
+
+  for (int i = 0; i < 10; ++i) {
+    sampleRequest(*controller, std::chrono::milliseconds(1000));
+    advanceTime(std::chrono::milliseconds(100));
+    sampleRequest(*controller, std::chrono::milliseconds(1000));
+  }
+  EXPECT_EQ(2, controller->concurrencyLimit());
+}
+
+// The minimum round-trip time is measured again after the jittered interval, with the limit pinned
+// meanwhile and restored afterwards.
+TEST_F(GradientControllerTest, MinRTTRecalculatedAfterJitteredInterval) {
+  ON_CALL(random_, random()).WillByDefault(Return(2500));
+  const auto controller = makeController(R"EOF(
+concurrency_limit_params:
+  concurrency_update_interval: 0.1s
+min_rtt_calc_params:
+  interval: 10s
+  request_count: 5
+  jitter:
+    value: 50
+)EOF");
+  for (int i = 0; i < 5; ++i) {
+    sampleRequest(*controller, std::chrono::milliseconds(10));
+  }
+  for (int i = 0; i < 5; ++i) {
+    sampleRequest(*controller, std::chrono::milliseconds(10));
+    advanceTime(std::chrono::milliseconds(100));
+  }
+
+  // The measurement is due 10s plus a jitter of 2500ms % 5001ms after the end of the last one,
+  // 12.5s from the start.
+  advanceTime(std::chrono::milliseconds(11900));
+  sampleRequest(*controller, std::chrono::milliseconds(10));
+  EXPECT_EQ(0, gauge("min_rtt_calculation_active"));
+  const uint32_t limit = controller->concurrencyLimit();
+  EXPECT_LT(3, limit);
+  advanceTime(std::chrono::milliseconds(100));
+  EXPECT_EQ(RequestForwardingAction::Forward, controller->forwardingDecision());
+  EXPECT_EQ(1, gauge("min_rtt_calculation_active"));
+  EXPECT_EQ(3, controller->concurrencyLimit());
+  controller->recordLatencySample(std::chrono::milliseconds(20));
+
+  for (int i = 0; i < 5; ++i) {
+    sampleRequest(*controller, std::chrono::milliseconds(20));
+  }
+  EXPECT_EQ(0, gauge("min_rtt_calculation_active"));
+  EXPECT_EQ(20, gauge("min_rtt_msecs"));
+  EXPECT_EQ(limit, controller->concurrencyLimit());
+}
+
+} // namespace
+} // namespace ConcurrencyController
+} // namespace AdaptiveConcurrency
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,55 @@
+#include "envoy/config/filter/http/adaptive_concurrency/v2alpha/adaptive_concurrency.pb.h"
+
+#include "extensions/filters/http/adaptive_concurrency/config.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace AdaptiveConcurrency {
+namespace {
+
+TEST(AdaptiveConcurrencyFilterFactoryTest, GradientControllerConfig) {
+  const std::string yaml = R"EOF(
+gradient_controller_config:
+  sample_aggregate_percentile:
+    value: 50
+  concurrency_limit_params:
+    concurrency_update_interval: 0.1s
+  min_rtt_calc_params:
+    interval: 30s
+    request_count: 50
+)EOF";
+
+  envoy::config::filter::http::adaptive_concurrency::v2alpha::AdaptiveConcurrency proto_config;
+  TestUtility::loadFromYamlAndValidate(yaml, proto_config);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  AdaptiveConcurrencyFilterFactory factory;
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(proto_config, "stats.", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+}
+
+TEST(AdaptiveConcurrencyFilterFactoryTest, ControllerRequired) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  envoy::config::filter::http::adaptive_concurrency::v2alpha::AdaptiveConcurrency proto_config;
+  EXPECT_THROW(
+      AdaptiveConcurrencyFilterFactory().createFilterFactoryFromProto(proto_config, "stats.",
+                                                                      context),
+      ProtoValidationException);
+}
+
+} // namespace
+} // namespace AdaptiveConcurrency
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
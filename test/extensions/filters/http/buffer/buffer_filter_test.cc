@@ -17,6 +17,7 @@
 #include "test/mocks/protobuf/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/environment.h"
 #include "test/test_common/printers.h"
 
 #include "gmock/gmock.h"
@@ -25,6 +26,7 @@
 using testing::_;
 using testing::DoAll;
 using testing::InSequence;
+using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 using testing::SaveArg;
@@ -39,7 +41,7 @@ public:
   BufferFilterConfigSharedPtr setupConfig() {
     envoy::config::filter::http::buffer::v2::Buffer proto_config;
     proto_config.mutable_max_request_bytes()->set_value(1024 * 1024);
-    return std::make_shared<BufferFilterConfig>(proto_config);
+    return std::make_shared<BufferFilterConfig>(proto_config, "test.", filter_stats_);
   }
 
   BufferFilterTest() : config_(setupConfig()), filter_(config_), api_(Api::createApiForTest()) {
@@ -64,6 +66,7 @@ public:
   }
 
   NiceMock<Http::MockStreamDecoderFilterCallbacks> callbacks_;
+  Stats::IsolatedStoreImpl filter_stats_;
   BufferFilterConfigSharedPtr config_;
   BufferFilter filter_;
   Event::MockDispatcher dispatcher_;
@@ -202,6 +205,148 @@ TEST_F(BufferFilterTest, RouteDisabledConfigOverride) {
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(data1, true));
 }
 
+class BufferFilterSpillTest : public BufferFilterTest {
+public:
+  // Replaces the filter with one spilling the bodies beyond the given number of bytes.
+  void setupSpill(const std::string& directory, uint32_t memory_threshold_bytes,
+                  uint64_t max_spill_bytes) {
+    envoy::config::filter::http::buffer::v2::Buffer proto_config;
+    proto_config.mutable_max_request_bytes()->set_value(64);
+    auto* spill = proto_config.mutable_spill();
+    spill->set_directory(directory);
+    spill->mutable_memory_threshold_bytes()->set_value(memory_threshold_bytes);
+    spill->mutable_max_spill_bytes()->set_value(max_spill_bytes);
+    config_ = std::make_shared<BufferFilterConfig>(proto_config, "test.", filter_stats_);
+    spill_filter_ = std::make_unique<BufferFilter>(config_);
+    spill_filter_->setDecoderFilterCallbacks(callbacks_);
+  }
+
+  uint64_t counter(const std::string& name) {
+    return filter_stats_.counter("test.buffer." + name).value();
+  }
+
+  std::unique_ptr<BufferFilter> spill_filter_;
+};
+
+// The body beyond the memory threshold is spilled, and comes back whole with the last frame.
+TEST_F(BufferFilterSpillTest, SpillRequestBody) {
+  setupSpill(TestEnvironment::temporaryDirectory(), 8, 1024);
+
+  EXPECT_CALL(callbacks_, setDecoderBufferLimit(_)).Times(0);
+  Http::TestHeaderMapImpl headers;
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            spill_filter_->decodeHeaders(headers, false));
+
+  Buffer::OwnedImpl data1("hello ");
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, spill_filter_->decodeData(data1, false));
+  EXPECT_EQ(0, data1.length());
+  EXPECT_EQ(0, counter("rq_spilled"));
+
+  Buffer::OwnedImpl data2("spilled world");
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, spill_filter_->decodeData(data2, false));
+  EXPECT_EQ(0, data2.length());
+  EXPECT_EQ(1, counter("rq_spilled"));
+  EXPECT_EQ(11, counter("spilled_bytes"));
+  EXPECT_EQ(11, config_->spillBudget()->usedBytes());
+
+  Buffer::OwnedImpl data3("!");
+  EXPECT_EQ(Http::FilterDataStatus::Continue, spill_filter_->decodeData(data3, true));
+  EXPECT_EQ("hello spilled world!", data3.toString());
+  EXPECT_EQ(12, counter("spilled_bytes"));
+  ASSERT_NE(headers.ContentLength(), nullptr);
+  EXPECT_EQ(headers.ContentLength()->value().getStringView(), "20");
+
+  // The spilled bytes are held until the mapped file is released.
+  EXPECT_EQ(12, config_->spillBudget()->usedBytes());
+  data3.drain(data3.length());
+  EXPECT_EQ(0, config_->spillBudget()->usedBytes());
+}
+
+TEST_F(BufferFilterSpillTest, SmallRequestBody) {
+  setupSpill(TestEnvironment::temporaryDirectory(), 8, 1024);
+
+  Http::TestHeaderMapImpl headers;
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            spill_filter_->decodeHeaders(headers, false));
+  Buffer::OwnedImpl data1("foo");
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, spill_filter_->decodeData(data1, false));
+  Buffer::OwnedImpl data2("bar");
+  EXPECT_EQ(Http::FilterDataStatus::Continue, spill_filter_->decodeData(data2, true));
+  EXPECT_EQ("foobar", data2.toString());
+  EXPECT_EQ(0, counter("rq_spilled"));
+}
+
+TEST_F(BufferFilterSpillTest, SpillWithTrailers) {
+  setupSpill(TestEnvironment::temporaryDirectory(), 4, 1024);
+
+  Http::TestHeaderMapImpl headers;
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            spill_filter_->decodeHeaders(headers, false));
+  Buffer::OwnedImpl data("hello world");
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, spill_filter_->decodeData(data, false));
+
+  std::string body;
+  EXPECT_CALL(callbacks_, addDecodedData(_, false))
+      .WillOnce(Invoke([&body](Buffer::Instance& data, bool) { body = data.toString(); }));
+  Http::TestHeaderMapImpl trailers;
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, spill_filter_->decodeTrailers(trailers));
+  EXPECT_EQ("hello world", body);
+}
+
+// With spilling, the filter enforces the maximum request size itself.
+TEST_F(BufferFilterSpillTest, RequestTooLarge) {
+  setupSpill(TestEnvironment::temporaryDirectory(), 8, 1024);
+
+  Http::TestHeaderMapImpl headers;
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            spill_filter_->decodeHeaders(headers, false));
+  Buffer::OwnedImpl data1(std::string(60, 'a'));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, spill_filter_->decodeData(data1, false));
+
+  EXPECT_CALL(callbacks_, sendLocalReply(Http::Code::PayloadTooLarge, _, _, _,
+                                         "request_payload_too_large"));
+  Buffer::OwnedImpl data2(std::string(5, 'a'));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, spill_filter_->decodeData(data2, false));
+  EXPECT_EQ(1, counter("rq_too_large"));
+  EXPECT_EQ(0, config_->spillBudget()->usedBytes());
+
+  // The rest of the request is dropped.
+  Buffer::OwnedImpl data3("a");
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, spill_filter_->decodeData(data3, true));
+  EXPECT_EQ(0, data3.length());
+}
+
+TEST_F(BufferFilterSpillTest, SpillBudgetExceeded) {
+  setupSpill(TestEnvironment::temporaryDirectory(), 4, 8);
+
+  Http::TestHeaderMapImpl headers;
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            spill_filter_->decodeHeaders(headers, false));
+  Buffer::OwnedImpl data1("12345678");
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, spill_filter_->decodeData(data1, false));
+
+  EXPECT_CALL(callbacks_, sendLocalReply(Http::Code::InsufficientStorage, _, _, _,
+                                         "buffer_spill_budget_exceeded"));
+  Buffer::OwnedImpl data2("12345678");
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, spill_filter_->decodeData(data2, true));
+  EXPECT_EQ(1, counter("rq_spill_budget_exceeded"));
+  EXPECT_EQ(0, config_->spillBudget()->usedBytes());
+}
+
+TEST_F(BufferFilterSpillTest, SpillFailed) {
+  setupSpill(TestEnvironment::temporaryPath("does_not_exist"), 4, 1024);
+
+  Http::TestHeaderMapImpl headers;
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            spill_filter_->decodeHeaders(headers, false));
+
+  EXPECT_CALL(callbacks_,
+              sendLocalReply(Http::Code::InternalServerError, _, _, _, "buffer_spill_failed"));
+  Buffer::OwnedImpl data("hello world");
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, spill_filter_->decodeData(data, true));
+  EXPECT_EQ(1, counter("rq_spill_failed"));
+}
+
 } // namespace BufferFilter
 } // namespace HttpFilters
 } // namespace Extensions
@@ -0,0 +1,81 @@
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/http/buffer/spill_file.h"
+
+#include "test/test_common/environment.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace BufferFilter {
+namespace {
+
+TEST(SpillBudgetTest, ReserveAndRelease) {
+  SpillBudget budget(10);
+  EXPECT_TRUE(budget.tryReserve(6));
+  EXPECT_FALSE(budget.tryReserve(5));
+  EXPECT_TRUE(budget.tryReserve(4));
+  EXPECT_EQ(10, budget.usedBytes());
+  budget.release(10);
+  EXPECT_EQ(0, budget.usedBytes());
+}
+
+// The bytes written are reserved until the mapping of the file is released.
+TEST(SpillFileTest, WriteAndMove) {
+  auto budget = std::make_shared<SpillBudget>(100);
+  SpillFilePtr file = SpillFile::create(TestEnvironment::temporaryDirectory(), budget);
+  ASSERT_NE(nullptr, file);
+
+  Buffer::OwnedImpl data1("hello ");
+  Buffer::OwnedImpl data2(std::string(50, 'a'));
+  EXPECT_EQ(SpillFile::WriteResult::Written, file->write(data1));
+  EXPECT_EQ(SpillFile::WriteResult::Written, file->write(data2));
+  EXPECT_EQ(0, data1.length());
+  EXPECT_EQ(0, data2.length());
+  EXPECT_EQ(56, budget->usedBytes());
+
+  Buffer::OwnedImpl data3(std::string(50, 'b'));
+  EXPECT_EQ(SpillFile::WriteResult::OverBudget, file->write(data3));
+  EXPECT_EQ(50, data3.length());
+
+  Buffer::OwnedImpl output("memory ");
+  EXPECT_TRUE(file->moveTo(output));
+  file.reset();
+  EXPECT_EQ("memory hello " + std::string(50, 'a'), output.toString());
+  EXPECT_EQ(56, budget->usedBytes());
+  output.drain(output.length());
+  EXPECT_EQ(0, budget->usedBytes());
+}
+
+TEST(SpillFileTest, CloseWithoutMoving) {
+  auto budget = std::make_shared<SpillBudget>(100);
+  SpillFilePtr file = SpillFile::create(TestEnvironment::temporaryDirectory(), budget);
+  ASSERT_NE(nullptr, file);
+  Buffer::OwnedImpl data("hello");
+  EXPECT_EQ(SpillFile::WriteResult::Written, file->write(data));
+  EXPECT_EQ(5, budget->usedBytes());
+  file.reset();
+  EXPECT_EQ(0, budget->usedBytes());
+}
+
+TEST(SpillFileTest, MoveEmptyFile) {
+  auto budget = std::make_shared<SpillBudget>(100);
+  SpillFilePtr file = SpillFile::create(TestEnvironment::temporaryDirectory(), budget);
+  ASSERT_NE(nullptr, file);
+  Buffer::OwnedImpl output;
+  EXPECT_TRUE(file->moveTo(output));
+  EXPECT_EQ(0, output.length());
+}
+
+TEST(SpillFileTest, CreateFailure) {
+  EXPECT_EQ(nullptr, SpillFile::create(TestEnvironment::temporaryPath("does_not_exist"),
+                                       std::make_shared<SpillBudget>(100)));
+}
+
+} // namespace
+} // namespace BufferFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
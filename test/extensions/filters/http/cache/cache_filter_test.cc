@@ -0,0 +1,298 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "envoy/config/filter/http/cache/v2alpha/cache.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/http/cache/cache_filter.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+// A stream through a cache filter.
+struct TestStream {
+  TestStream(const CacheFilterConfigSharedPtr& config) : filter_(config) {
+    filter_.setDecoderFilterCallbacks(decoder_callbacks_);
+    filter_.setEncoderFilterCallbacks(encoder_callbacks_);
+  }
+
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks_;
+  CacheFilter filter_;
+};
+
+class CacheFilterTest : public testing::Test {
+protected:
+  CacheFilterTest() { initialize(""); }
+
+  void initialize(const std::string& yaml) {
+    envoy::config::filter::http::cache::v2alpha::CacheConfig proto_config;
+    if (!yaml.empty()) {
+      TestUtility::loadFromYaml(yaml, proto_config);
+    }
+    config_ = std::make_shared<CacheFilterConfig>(proto_config, "test.", stats_, tls_);
+  }
+
+  // Passes a response through a stream, which went upstream.
+  void respond(TestStream& stream, Http::TestHeaderMapImpl&& headers, const std::string& body) {
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+              stream.filter_.encodeHeaders(headers, body.empty()));
+    if (!body.empty()) {
+      Buffer::OwnedImpl data(body);
+      EXPECT_EQ(Http::FilterDataStatus::Continue, stream.filter_.encodeData(data, true));
+    }
+  }
+
+  // Sends a request which goes upstream, and a response to it.
+  void fill(Http::TestHeaderMapImpl&& request_headers, Http::TestHeaderMapImpl&& response_headers,
+            const std::string& body) {
+    TestStream stream(config_);
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+              stream.filter_.decodeHeaders(request_headers, true));
+    respond(stream, std::move(response_headers), body);
+    stream.filter_.onDestroy();
+  }
+
+  // Expects a stream to be served a response from the cache.
+  void expectServed(TestStream& stream, const std::string& body, const std::string& age) {
+    EXPECT_CALL(stream.decoder_callbacks_, encodeHeaders_(_, false))
+        .WillOnce(Invoke([age](Http::HeaderMap& headers, bool) {
+          EXPECT_EQ("200", headers.Status()->value().getStringView());
+          EXPECT_EQ(age, headers.get(Http::LowerCaseString("age"))->value().getStringView());
+        }));
+    EXPECT_CALL(stream.decoder_callbacks_, encodeData(_, true))
+        .WillOnce(Invoke(
+            [body](Buffer::Instance& data, bool) { EXPECT_EQ(body, data.toString()); }));
+  }
+
+  Http::TestHeaderMapImpl request() {
+    return Http::TestHeaderMapImpl{{":method", "GET"}, {":authority", "host"}, {":path", "/path"}};
+  }
+
+  Http::TestHeaderMapImpl cacheableResponse() {
+    return Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", "public, max-age=10"}};
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl stats_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  CacheFilterConfigSharedPtr config_;
+};
+
+TEST(CacheFilterFreshnessTest, FreshnessLifetime) {
+  const auto lifetime = [](const std::string& cache_control) {
+    return CacheFilter::freshnessLifetime(
+        Http::TestHeaderMapImpl{{":status", "200"}, {"cache-control", cache_control}});
+  };
+  EXPECT_EQ(std::chrono::seconds(10), lifetime("max-age=10").value());
+  EXPECT_EQ(std::chrono::seconds(10), lifetime("public, max-age=\"10\"").value());
+  EXPECT_EQ(std::chrono::seconds(20), lifetime("max-age=10, s-maxage=20").value());
+  EXPECT_FALSE(lifetime("max-age=0"));
+  EXPECT_FALSE(lifetime("max-age=10, no-store"));
+  EXPECT_FALSE(lifetime("private, max-age=10"));
+  EXPECT_FALSE(lifetime("No-Cache, max-age=10"));
+  EXPECT_FALSE(lifetime("max-age=ten"));
+  EXPECT_FALSE(lifetime("public"));
+  EXPECT_FALSE(CacheFilter::freshnessLifetime(Http::TestHeaderMapImpl{{":status", "200"}}));
+}
+
+// A stored response is served until it is no longer fresh.
+TEST_F(CacheFilterTest, HitUntilExpiry) {
+  fill(request(), cacheableResponse(), "body");
+  EXPECT_EQ(1, stats_.counter("test.cache.miss").value());
+  EXPECT_EQ(1, stats_.counter("test.cache.insert").value());
+
+  time_system_.sleep(std::chrono::seconds(5));
+  {
+    TestStream stream(config_);
+    expectServed(stream, "body", "5");
+    Http::TestHeaderMapImpl headers = request();
+    EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+              stream.filter_.decodeHeaders(headers, true));
+    // The response served goes through the encoding path of the filter untouched.
+    Http::TestHeaderMapImpl response_headers = cacheableResponse();
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+              stream.filter_.encodeHeaders(response_headers, false));
+    stream.filter_.onDestroy();
+  }
+  EXPECT_EQ(1, stats_.counter("test.cache.hit").value());
+  EXPECT_EQ(1, stats_.counter("test.cache.insert").value());
+
+  time_system_.sleep(std::chrono::seconds(5));
+  TestStream stream(config_);
+  Http::TestHeaderMapImpl headers = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, stream.filter_.decodeHeaders(headers, true));
+  EXPECT_EQ(2, stats_.counter("test.cache.miss").value());
+}
+
+// The Age of the stored response counts towards its freshness.
+TEST_F(CacheFilterTest, Age) {
+  fill(request(), {{":status", "200"}, {"cache-control", "max-age=10"}, {"age", "4"}}, "body");
+  time_system_.sleep(std::chrono::seconds(1));
+  {
+    TestStream stream(config_);
+    expectServed(stream, "body", "5");
+    Http::TestHeaderMapImpl headers = request();
+    EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+              stream.filter_.decodeHeaders(headers, true));
+  }
+
+  time_system_.sleep(std::chrono::seconds(5));
+  TestStream stream(config_);
+  Http::TestHeaderMapImpl headers = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, stream.filter_.decodeHeaders(headers, true));
+}
+
+// Responses which may not be stored, and requests which may not use the cache, bypass it.
+TEST_F(CacheFilterTest, NotCacheable) {
+  fill(request(), {{":status", "200"}, {"cache-control", "no-store"}}, "body");
+  fill(request(), {{":status", "404"}, {"cache-control", "max-age=10"}}, "body");
+  fill(request(), {{":status", "200"}, {"cache-control", "max-age=10"}, {"vary", "*"}}, "body");
+  fill({{":method", "POST"}, {":authority", "host"}, {":path", "/path"}}, cacheableResponse(),
+       "body");
+  fill({{":method", "GET"}, {":authority", "host"}, {":path", "/path"}, {"authorization", "x"}},
+       cacheableResponse(), "body");
+  {
+    // Responses with trailers are not stored.
+    TestStream stream(config_);
+    Http::TestHeaderMapImpl headers = request();
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, stream.filter_.decodeHeaders(headers, true));
+    Http::TestHeaderMapImpl response_headers = cacheableResponse();
+    stream.filter_.encodeHeaders(response_headers, false);
+    Buffer::OwnedImpl data("body");
+    stream.filter_.encodeData(data, false);
+    Http::TestHeaderMapImpl trailers;
+    stream.filter_.encodeTrailers(trailers);
+  }
+  EXPECT_EQ(0, stats_.counter("test.cache.insert").value());
+
+  fill(request(), cacheableResponse(), "body");
+  EXPECT_EQ(1, stats_.counter("test.cache.insert").value());
+  TestStream stream(config_);
+  Http::TestHeaderMapImpl headers{{":method", "GET"},
+                                  {":authority", "host"},
+                                  {":path", "/path"},
+                                  {"cache-control", "no-cache"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, stream.filter_.decodeHeaders(headers, true));
+  EXPECT_EQ(0, stats_.counter("test.cache.hit").value());
+}
+
+// Responses with bodies larger than the maximum are not stored.
+TEST_F(CacheFilterTest, MaxBodyBytes) {
+  initialize("max_body_bytes: 4");
+  fill(request(), cacheableResponse(), "12345");
+  EXPECT_EQ(0, stats_.counter("test.cache.insert").value());
+  fill(request(), cacheableResponse(), "1234");
+  EXPECT_EQ(1, stats_.counter("test.cache.insert").value());
+}
+
+// A stored response is only served to the requests with the same values of the headers it varies
+// on.
+TEST_F(CacheFilterTest, Vary) {
+  fill({{":method", "GET"}, {":authority", "host"}, {":path", "/path"}, {"accept", "text/html"}},
+       {{":status", "200"}, {"cache-control", "max-age=10"}, {"vary", "Accept"}}, "body");
+  {
+    TestStream stream(config_);
+    expectServed(stream, "body", "0");
+    Http::TestHeaderMapImpl headers{
+        {":method", "GET"}, {":authority", "host"}, {":path", "/path"}, {"accept", "text/html"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+              stream.filter_.decodeHeaders(headers, true));
+  }
+  TestStream stream(config_);
+  EXPECT_CALL(stream.decoder_callbacks_, encodeHeaders_(_, _)).Times(0);
+  Http::TestHeaderMapImpl headers = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, stream.filter_.decodeHeaders(headers, true));
+}
+
+// A request whose If-None-Match matches the entity tag of the stored response gets a 304.
+TEST_F(CacheFilterTest, NotModified) {
+  fill(request(), {{":status", "200"}, {"cache-control", "max-age=10"}, {"etag", "\"v1\""}},
+       "body");
+  TestStream stream(config_);
+  EXPECT_CALL(stream.decoder_callbacks_, encodeHeaders_(_, true))
+      .WillOnce(Invoke([](Http::HeaderMap& headers, bool) {
+        EXPECT_EQ("304", headers.Status()->value().getStringView());
+      }));
+  EXPECT_CALL(stream.decoder_callbacks_, encodeData(_, _)).Times(0);
+  Http::TestHeaderMapImpl headers{{":method", "GET"},
+                                  {":authority", "host"},
+                                  {":path", "/path"},
+                                  {"if-none-match", "\"v0\", W/\"v1\""}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            stream.filter_.decodeHeaders(headers, true));
+  EXPECT_EQ(1, stats_.counter("test.cache.not_modified").value());
+}
+
+// Concurrent misses for the same key wait for the response of the first one.
+TEST_F(CacheFilterTest, Coalescing) {
+  TestStream first(config_);
+  Http::TestHeaderMapImpl first_headers = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, first.filter_.decodeHeaders(first_headers, true));
+
+  TestStream second(config_);
+  Http::TestHeaderMapImpl second_headers = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            second.filter_.decodeHeaders(second_headers, true));
+  TestStream third(config_);
+  Http::TestHeaderMapImpl third_headers = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            third.filter_.decodeHeaders(third_headers, true));
+  EXPECT_EQ(2, stats_.counter("test.cache.coalesced").value());
+
+  // The third request goes away before the response.
+  third.filter_.onDestroy();
+  EXPECT_CALL(third.decoder_callbacks_, encodeHeaders_(_, _)).Times(0);
+  EXPECT_CALL(second.decoder_callbacks_, continueDecoding()).Times(0);
+  expectServed(second, "body", "0");
+  respond(first, cacheableResponse(), "body");
+}
+
+// The waiters go upstream when the response of the first request is not stored.
+TEST_F(CacheFilterTest, CoalescingNotCacheable) {
+  TestStream first(config_);
+  Http::TestHeaderMapImpl first_headers = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, first.filter_.decodeHeaders(first_headers, true));
+  TestStream second(config_);
+  Http::TestHeaderMapImpl second_headers = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            second.filter_.decodeHeaders(second_headers, true));
+
+  EXPECT_CALL(second.decoder_callbacks_, continueDecoding());
+  respond(first, {{":status", "200"}, {"cache-control", "no-store"}}, "body");
+
+  // A reset of the first request also lets the waiters go.
+  TestStream third(config_);
+  Http::TestHeaderMapImpl third_headers = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, third.filter_.decodeHeaders(third_headers, true));
+  TestStream fourth(config_);
+  Http::TestHeaderMapImpl fourth_headers = request();
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            fourth.filter_.decodeHeaders(fourth_headers, true));
+  EXPECT_CALL(fourth.decoder_callbacks_, continueDecoding());
+  third.filter_.onDestroy();
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
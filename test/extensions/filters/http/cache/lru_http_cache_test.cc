@@ -0,0 +1,87 @@
+#include <chrono>
+
+#include "common/http/header_map_impl.h"
+
+#include "extensions/filters/http/cache/lru_http_cache.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+class LruHttpCacheTest : public testing::Test {
+protected:
+  CachedResponseConstSharedPtr response(const std::string& body, std::chrono::seconds lifetime) {
+    auto response = std::make_shared<CachedResponse>();
+    response->headers_ = std::make_unique<Http::HeaderMapImpl>();
+    response->body_ = body;
+    response->response_time_ = time_system_.monotonicTime();
+    response->initial_age_ = std::chrono::seconds(0);
+    response->expiry_ = response->response_time_ + lifetime;
+    return response;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  LruHttpCache cache_{2, 10, time_system_};
+};
+
+// Responses are found until they are no longer fresh.
+TEST_F(LruHttpCacheTest, Expiry) {
+  cache_.insert("a", response("body", std::chrono::seconds(10)));
+  ASSERT_NE(nullptr, cache_.lookup("a"));
+  EXPECT_EQ("body", cache_.lookup("a")->body_);
+
+  time_system_.sleep(std::chrono::seconds(9));
+  EXPECT_NE(nullptr, cache_.lookup("a"));
+  time_system_.sleep(std::chrono::seconds(1));
+  EXPECT_EQ(nullptr, cache_.lookup("a"));
+  EXPECT_EQ(0, cache_.size());
+  EXPECT_EQ(0, cache_.totalBodyBytes());
+}
+
+// The least recently used response is evicted beyond the maximum number of responses.
+TEST_F(LruHttpCacheTest, MaxEntries) {
+  cache_.insert("a", response("", std::chrono::seconds(10)));
+  cache_.insert("b", response("", std::chrono::seconds(10)));
+  EXPECT_NE(nullptr, cache_.lookup("a"));
+
+  cache_.insert("c", response("", std::chrono::seconds(10)));
+  EXPECT_EQ(2, cache_.size());
+  EXPECT_NE(nullptr, cache_.lookup("a"));
+  EXPECT_EQ(nullptr, cache_.lookup("b"));
+  EXPECT_NE(nullptr, cache_.lookup("c"));
+}
+
+// The least recently used responses are evicted beyond the maximum total size of the bodies, and
+// bodies larger than it are not stored.
+TEST_F(LruHttpCacheTest, MaxTotalBodyBytes) {
+  cache_.insert("a", response("123456", std::chrono::seconds(10)));
+  cache_.insert("b", response("123456", std::chrono::seconds(10)));
+  EXPECT_EQ(nullptr, cache_.lookup("a"));
+  EXPECT_NE(nullptr, cache_.lookup("b"));
+  EXPECT_EQ(6, cache_.totalBodyBytes());
+
+  cache_.insert("c", response("12345678901", std::chrono::seconds(10)));
+  EXPECT_EQ(nullptr, cache_.lookup("c"));
+  EXPECT_EQ(1, cache_.size());
+}
+
+// Inserting a response for a stored key replaces it.
+TEST_F(LruHttpCacheTest, Replace) {
+  cache_.insert("a", response("123", std::chrono::seconds(10)));
+  cache_.insert("a", response("12345", std::chrono::seconds(10)));
+  EXPECT_EQ(1, cache_.size());
+  EXPECT_EQ(5, cache_.totalBodyBytes());
+  EXPECT_EQ("12345", cache_.lookup("a")->body_);
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
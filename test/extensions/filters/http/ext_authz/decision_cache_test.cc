@@ -0,0 +1,146 @@
+#include <chrono>
+
+#include "extensions/filters/http/ext_authz/decision_cache.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::InSequence;
+using testing::Invoke;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+namespace {
+
+using Filters::Common::ExtAuthz::CheckStatus;
+using Filters::Common::ExtAuthz::Response;
+
+class MockWaiter : public DecisionCache::Waiter {
+public:
+  MOCK_METHOD1(onDecision, void(const Response& response));
+  MOCK_METHOD0(onCheckCancelled, void());
+};
+
+class DecisionCacheTest : public testing::Test {
+protected:
+  static Response response(CheckStatus status) {
+    Response response{};
+    response.status = status;
+    return response;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  DecisionCache cache_{2, time_system_};
+};
+
+// Decisions are found until their TTL expires.
+TEST_F(DecisionCacheTest, Ttl) {
+  MockWaiter waiter;
+  EXPECT_FALSE(cache_.joinCheck("a", waiter));
+  cache_.completeCheck("a", response(CheckStatus::Denied), std::chrono::seconds(10));
+  ASSERT_NE(nullptr, cache_.find("a"));
+  EXPECT_EQ(CheckStatus::Denied, cache_.find("a")->status);
+
+  time_system_.sleep(std::chrono::seconds(9));
+  EXPECT_NE(nullptr, cache_.find("a"));
+  time_system_.sleep(std::chrono::seconds(1));
+  EXPECT_EQ(nullptr, cache_.find("a"));
+  EXPECT_EQ(0, cache_.size());
+}
+
+// Decisions without a TTL are not cached.
+TEST_F(DecisionCacheTest, NoTtl) {
+  MockWaiter waiter;
+  EXPECT_FALSE(cache_.joinCheck("a", waiter));
+  cache_.completeCheck("a", response(CheckStatus::OK), absl::nullopt);
+  EXPECT_EQ(nullptr, cache_.find("a"));
+  EXPECT_EQ(0, cache_.size());
+}
+
+// The least recently used decision is evicted.
+TEST_F(DecisionCacheTest, Lru) {
+  MockWaiter waiter;
+  for (const std::string key : {"a", "b"}) {
+    EXPECT_FALSE(cache_.joinCheck(key, waiter));
+    cache_.completeCheck(key, response(CheckStatus::OK), std::chrono::seconds(10));
+  }
+  EXPECT_NE(nullptr, cache_.find("a"));
+
+  EXPECT_FALSE(cache_.joinCheck("c", waiter));
+  cache_.completeCheck("c", response(CheckStatus::OK), std::chrono::seconds(10));
+  EXPECT_EQ(2, cache_.size());
+  EXPECT_NE(nullptr, cache_.find("a"));
+  EXPECT_EQ(nullptr, cache_.find("b"));
+  EXPECT_NE(nullptr, cache_.find("c"));
+}
+
+// The waiters of a check get its decision, except those which left.
+TEST_F(DecisionCacheTest, JoinCheck) {
+  MockWaiter first;
+  MockWaiter second;
+  MockWaiter third;
+  EXPECT_FALSE(cache_.joinCheck("a", first));
+  EXPECT_TRUE(cache_.joinCheck("a", second));
+  EXPECT_TRUE(cache_.joinCheck("a", third));
+  cache_.leaveCheck("a", third);
+
+  EXPECT_CALL(second, onDecision(_)).WillOnce(Invoke([](const Response& response) {
+    EXPECT_EQ(CheckStatus::Denied, response.status);
+  }));
+  EXPECT_CALL(third, onDecision(_)).Times(0);
+  cache_.completeCheck("a", response(CheckStatus::Denied), absl::nullopt);
+
+  // The check is over.
+  EXPECT_FALSE(cache_.joinCheck("a", first));
+}
+
+// A waiter destroyed while the decision is passed on is not called.
+TEST_F(DecisionCacheTest, LeaveCheckDuringDecision) {
+  MockWaiter first;
+  MockWaiter second;
+  MockWaiter third;
+  EXPECT_FALSE(cache_.joinCheck("a", first));
+  EXPECT_TRUE(cache_.joinCheck("a", second));
+  EXPECT_TRUE(cache_.joinCheck("a", third));
+
+  EXPECT_CALL(second, onDecision(_)).WillOnce(Invoke([&](const Response&) {
+    cache_.leaveCheck("a", third);
+  }));
+  EXPECT_CALL(third, onDecision(_)).Times(0);
+  cache_.completeCheck("a", response(CheckStatus::OK), absl::nullopt);
+}
+
+// When a check is cancelled, its first waiter checks in turn.
+TEST_F(DecisionCacheTest, CancelCheck) {
+  InSequence s;
+
+  MockWaiter first;
+  MockWaiter second;
+  MockWaiter third;
+  EXPECT_FALSE(cache_.joinCheck("a", first));
+  EXPECT_TRUE(cache_.joinCheck("a", second));
+  EXPECT_TRUE(cache_.joinCheck("a", third));
+
+  EXPECT_CALL(second, onCheckCancelled());
+  cache_.cancelCheck("a");
+
+  EXPECT_CALL(third, onDecision(_));
+  cache_.completeCheck("a", response(CheckStatus::OK), std::chrono::seconds(1));
+  EXPECT_NE(nullptr, cache_.find("a"));
+
+  // Without waiters, cancelling just ends the check.
+  EXPECT_FALSE(cache_.joinCheck("b", first));
+  cache_.cancelCheck("b");
+  EXPECT_FALSE(cache_.joinCheck("b", first));
+}
+
+} // namespace
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -23,6 +23,7 @@
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/router/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/printers.h"
@@ -55,8 +56,8 @@ public:
     if (!yaml.empty()) {
       TestUtility::loadFromYaml(yaml, proto_config);
     }
-    config_.reset(
-        new FilterConfig(proto_config, local_info_, stats_store_, runtime_, http_context_));
+    config_.reset(new FilterConfig(proto_config, local_info_, stats_store_, runtime_, http_context_,
+                                   tls_));
     client_ = new Filters::Common::ExtAuthz::MockClient();
     filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_});
     filter_->setDecoderFilterCallbacks(filter_callbacks_);
@@ -74,6 +75,7 @@ public:
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Upstream::MockClusterManager> cm_;
   NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
   Network::Address::InstanceConstSharedPtr addr_;
   NiceMock<Envoy::Network::MockConnection> connection_;
   Http::ContextImpl http_context_;
@@ -768,6 +770,133 @@ TEST_F(HttpFilterTest, NoClearCacheRouteDeniedResponse) {
   EXPECT_EQ("ext_authz_denied", filter_callbacks_.details_);
 }
 
+// Verifies that with a decision cache, a request waits for the call of an identical request in
+// flight, and later identical requests use the cached decision.
+TEST_F(HttpFilterTest, DecisionCache) {
+  initialize(R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_authz_server"
+  decision_cache:
+    key_headers: ["authorization"]
+    max_entries: 10
+    ttl_header: "x-auth-ttl"
+  )EOF");
+
+  ON_CALL(filter_callbacks_, connection()).WillByDefault(Return(&connection_));
+  ON_CALL(connection_, remoteAddress()).WillByDefault(ReturnRef(addr_));
+  ON_CALL(connection_, localAddress()).WillByDefault(ReturnRef(addr_));
+  request_headers_.addCopy("authorization", "Bearer a");
+
+  EXPECT_CALL(*client_, check(_, _, _))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks) -> void {
+            request_callbacks_ = &callbacks;
+          })));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(request_headers_, false));
+
+  // An identical request waits for the decision.
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> waiting_callbacks;
+  auto* waiting_client = new Filters::Common::ExtAuthz::MockClient();
+  Filter waiting_filter(config_, Filters::Common::ExtAuthz::ClientPtr{waiting_client});
+  waiting_filter.setDecoderFilterCallbacks(waiting_callbacks);
+  Http::TestHeaderMapImpl waiting_headers{{"authorization", "Bearer a"}};
+  EXPECT_CALL(*waiting_client, check(_, _, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            waiting_filter.decodeHeaders(waiting_headers, false));
+  EXPECT_EQ(1U, waiting_callbacks.clusterInfo()
+                    ->statsScope()
+                    .counter("ext_authz.decision_cache_coalesced")
+                    .value());
+
+  Filters::Common::ExtAuthz::Response response{};
+  response.status = Filters::Common::ExtAuthz::CheckStatus::OK;
+  response.headers_to_add = Http::HeaderVector{{Http::LowerCaseString{"x-auth-ttl"}, "10"},
+                                               {Http::LowerCaseString{"foo"}, "bar"}};
+  EXPECT_CALL(waiting_callbacks, continueDecoding());
+  EXPECT_CALL(filter_callbacks_, continueDecoding());
+  request_callbacks_->onComplete(std::make_unique<Filters::Common::ExtAuthz::Response>(response));
+  EXPECT_EQ("bar", request_headers_.get_("foo"));
+  EXPECT_EQ("bar", waiting_headers.get_("foo"));
+  EXPECT_FALSE(request_headers_.has("x-auth-ttl"));
+  EXPECT_FALSE(waiting_headers.has("x-auth-ttl"));
+
+  // A later identical request uses the cached decision.
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> cached_callbacks;
+  auto* cached_client = new Filters::Common::ExtAuthz::MockClient();
+  Filter cached_filter(config_, Filters::Common::ExtAuthz::ClientPtr{cached_client});
+  cached_filter.setDecoderFilterCallbacks(cached_callbacks);
+  Http::TestHeaderMapImpl cached_headers{{"authorization", "Bearer a"}};
+  EXPECT_CALL(*cached_client, check(_, _, _)).Times(0);
+  EXPECT_CALL(cached_callbacks, continueDecoding()).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            cached_filter.decodeHeaders(cached_headers, false));
+  EXPECT_EQ("bar", cached_headers.get_("foo"));
+  EXPECT_EQ(
+      1U,
+      cached_callbacks.clusterInfo()->statsScope().counter("ext_authz.decision_cache_hit").value());
+
+  // A request with another key calls the service.
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> other_callbacks;
+  auto* other_client = new Filters::Common::ExtAuthz::MockClient();
+  Filter other_filter(config_, Filters::Common::ExtAuthz::ClientPtr{other_client});
+  other_filter.setDecoderFilterCallbacks(other_callbacks);
+  ON_CALL(other_callbacks, connection()).WillByDefault(Return(&connection_));
+  Http::TestHeaderMapImpl other_headers{{"authorization", "Bearer b"}};
+  EXPECT_CALL(*other_client, check(_, _, _));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            other_filter.decodeHeaders(other_headers, false));
+  EXPECT_EQ(
+      1U,
+      other_callbacks.clusterInfo()->statsScope().counter("ext_authz.decision_cache_miss").value());
+}
+
+// Verifies that when the request whose call is awaited is destroyed, the waiting request calls
+// the service in turn.
+TEST_F(HttpFilterTest, DecisionCacheCancelledCall) {
+  initialize(R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_authz_server"
+  decision_cache:
+    key_headers: [":path"]
+    max_entries: 10
+    default_ttl: 10s
+  )EOF");
+
+  ON_CALL(filter_callbacks_, connection()).WillByDefault(Return(&connection_));
+  ON_CALL(connection_, remoteAddress()).WillByDefault(ReturnRef(addr_));
+  ON_CALL(connection_, localAddress()).WillByDefault(ReturnRef(addr_));
+  request_headers_.addCopy(":path", "/");
+
+  EXPECT_CALL(*client_, check(_, _, _));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(request_headers_, false));
+
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> waiting_callbacks;
+  ON_CALL(waiting_callbacks, connection()).WillByDefault(Return(&connection_));
+  auto* waiting_client = new Filters::Common::ExtAuthz::MockClient();
+  Filter waiting_filter(config_, Filters::Common::ExtAuthz::ClientPtr{waiting_client});
+  waiting_filter.setDecoderFilterCallbacks(waiting_callbacks);
+  Http::TestHeaderMapImpl waiting_headers{{":path", "/"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            waiting_filter.decodeHeaders(waiting_headers, false));
+
+  // The waiting request calls once the first one is destroyed, and its decision is cached.
+  Filters::Common::ExtAuthz::Response response{};
+  response.status = Filters::Common::ExtAuthz::CheckStatus::OK;
+  EXPECT_CALL(*client_, cancel());
+  EXPECT_CALL(*waiting_client, check(_, _, _))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks) -> void {
+            callbacks.onComplete(std::make_unique<Filters::Common::ExtAuthz::Response>(response));
+          })));
+  EXPECT_CALL(waiting_callbacks, continueDecoding());
+  filter_->onDestroy();
+  EXPECT_EQ(1U, config_->decisionCache()->size());
+}
+
 // -------------------
 // Parameterized Tests
 // -------------------
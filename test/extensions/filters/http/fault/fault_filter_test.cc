@@ -985,6 +985,53 @@ TEST_F(FaultFilterTest, RouteFaultOverridesListenerFault) {
   }
 }
 
+TEST_F(FaultFilterTest, NoFaultsConfigured) {
+  SetUpTest(v2_empty_fault_config_json);
+
+  // Without a configured fault or abort runtime key, no runtime lookup is done.
+  ON_CALL(runtime_.snapshot_, get("fault.http.abort.abort_percent"))
+      .WillByDefault(ReturnRef(EMPTY_STRING));
+  EXPECT_CALL(runtime_.snapshot_, getInteger(_, _)).Times(0);
+  EXPECT_CALL(runtime_.snapshot_,
+              featureEnabled(_, Matcher<const envoy::type::FractionalPercent&>(_)))
+      .Times(0);
+
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(data_, false));
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers_));
+  filter_->onDestroy();
+
+  EXPECT_EQ(0UL, config_->stats().aborts_injected_.value());
+  EXPECT_EQ(0UL, config_->stats().active_faults_.value());
+}
+
+TEST_F(FaultFilterTest, RuntimeAbortWithoutFaultsConfigured) {
+  SetUpTest(v2_empty_fault_config_json);
+
+  // The abort runtime keys apply even without an abort configuration.
+  const std::string abort_percent = "100";
+  ON_CALL(runtime_.snapshot_, get("fault.http.abort.abort_percent"))
+      .WillByDefault(ReturnRef(abort_percent));
+  EXPECT_CALL(runtime_.snapshot_,
+              getInteger("fault.http.max_active_faults", std::numeric_limits<uint64_t>::max()))
+      .WillOnce(Return(std::numeric_limits<uint64_t>::max()));
+  EXPECT_CALL(runtime_.snapshot_,
+              featureEnabled("fault.http.abort.abort_percent",
+                             Matcher<const envoy::type::FractionalPercent&>(Percent(0))))
+      .WillOnce(Return(true));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("fault.http.abort.http_status", _))
+      .WillOnce(Return(503));
+  EXPECT_CALL(decoder_filter_callbacks_.stream_info_,
+              setResponseFlag(StreamInfo::ResponseFlag::FaultInjected));
+
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+  filter_->onDestroy();
+
+  EXPECT_EQ(1UL, config_->stats().aborts_injected_.value());
+  EXPECT_EQ(0UL, config_->stats().active_faults_.value());
+}
+
 class FaultFilterRateLimitTest : public FaultFilterTest {
 public:
   void setupRateLimitTest(bool enable_runtime) {
@@ -1120,12 +1167,13 @@ TEST_F(FaultFilterSettingsTest, CheckDefaultRuntimeKeys) {
 
   Fault::FaultSettings settings(fault);
 
-  EXPECT_EQ("fault.http.delay.fixed_delay_percent", settings.delayPercentRuntime());
-  EXPECT_EQ("fault.http.abort.abort_percent", settings.abortPercentRuntime());
-  EXPECT_EQ("fault.http.delay.fixed_duration_ms", settings.delayDurationRuntime());
-  EXPECT_EQ("fault.http.abort.http_status", settings.abortHttpStatusRuntime());
-  EXPECT_EQ("fault.http.max_active_faults", settings.maxActiveFaultsRuntime());
-  EXPECT_EQ("fault.http.rate_limit.response_percent", settings.responseRateLimitPercentRuntime());
+  EXPECT_EQ("fault.http.delay.fixed_delay_percent", settings.delayPercentRuntime().name());
+  EXPECT_EQ("fault.http.abort.abort_percent", settings.abortPercentRuntime().name());
+  EXPECT_EQ("fault.http.delay.fixed_duration_ms", settings.delayDurationRuntime().name());
+  EXPECT_EQ("fault.http.abort.http_status", settings.abortHttpStatusRuntime().name());
+  EXPECT_EQ("fault.http.max_active_faults", settings.maxActiveFaultsRuntime().name());
+  EXPECT_EQ("fault.http.rate_limit.response_percent",
+            settings.responseRateLimitPercentRuntime().name());
 }
 
 TEST_F(FaultFilterSettingsTest, CheckOverrideRuntimeKeys) {
@@ -1140,13 +1188,13 @@ TEST_F(FaultFilterSettingsTest, CheckOverrideRuntimeKeys) {
 
   Fault::FaultSettings settings(fault);
 
-  EXPECT_EQ("fault.delay_percent_runtime", settings.delayPercentRuntime());
-  EXPECT_EQ("fault.abort_percent_runtime", settings.abortPercentRuntime());
-  EXPECT_EQ("fault.delay_duration_runtime", settings.delayDurationRuntime());
-  EXPECT_EQ("fault.abort_http_status_runtime", settings.abortHttpStatusRuntime());
-  EXPECT_EQ("fault.max_active_faults_runtime", settings.maxActiveFaultsRuntime());
+  EXPECT_EQ("fault.delay_percent_runtime", settings.delayPercentRuntime().name());
+  EXPECT_EQ("fault.abort_percent_runtime", settings.abortPercentRuntime().name());
+  EXPECT_EQ("fault.delay_duration_runtime", settings.delayDurationRuntime().name());
+  EXPECT_EQ("fault.abort_http_status_runtime", settings.abortHttpStatusRuntime().name());
+  EXPECT_EQ("fault.max_active_faults_runtime", settings.maxActiveFaultsRuntime().name());
   EXPECT_EQ("fault.response_rate_limit_percent_runtime",
-            settings.responseRateLimitPercentRuntime());
+            settings.responseRateLimitPercentRuntime().name());
 }
 
 } // namespace
@@ -46,6 +46,32 @@ TEST_F(TranscoderInputStreamTest, BackUp) {
   EXPECT_EQ(3, stream_.BytesAvailable());
 }
 
+class TestTranscoderInputStream : public TranscoderInputStreamImpl {
+public:
+  uint64_t bufferLength() const { return buffer_->length(); }
+};
+
+TEST(TranscoderInputStreamDrainTest, DrainConsumed) {
+  TestTranscoderInputStream stream;
+  Buffer::OwnedImpl buffer{"abcd"};
+  stream.move(buffer);
+
+  const void* data;
+  int size;
+  EXPECT_TRUE(stream.Next(&data, &size));
+  stream.BackUp(1);
+  EXPECT_EQ(4, stream.bufferLength());
+
+  // The bytes read are released without waiting for the next read.
+  stream.drainConsumed();
+  EXPECT_EQ(1, stream.bufferLength());
+  EXPECT_EQ(1, stream.BytesAvailable());
+  EXPECT_EQ(3, stream.ByteCount());
+
+  EXPECT_TRUE(stream.Next(&data, &size));
+  EXPECT_EQ("d", std::string(static_cast<const char*>(data), size));
+}
+
 } // namespace
 } // namespace GrpcJsonTranscoder
 } // namespace HttpFilters
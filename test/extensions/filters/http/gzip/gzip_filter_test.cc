@@ -11,6 +11,7 @@
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -66,7 +67,7 @@ protected:
     Json::ObjectSharedPtr config = Json::Factory::loadFromString(json);
     envoy::config::filter::http::gzip::v2::Gzip gzip;
     TestUtility::loadFromJson(json, gzip);
-    config_.reset(new GzipFilterConfig(gzip, "test.", stats_, runtime_));
+    config_.reset(new GzipFilterConfig(gzip, "test.", stats_, runtime_, tls_));
     filter_ = std::make_unique<GzipFilter>(config_);
     filter_->setEncoderFilterCallbacks(encoder_callbacks_);
   }
@@ -183,9 +184,35 @@ protected:
   std::string expected_str_;
   Stats::IsolatedStoreImpl stats_;
   NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
   NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks_;
 };
 
+// The compressor of a finished response is reused by the next one, which still gets a valid
+// stream of its own.
+TEST_F(GzipFilterTest, CompressorReuse) {
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip"}}, false);
+  doResponseCompression({{":method", "get"}, {"content-length", "256"}}, false);
+  filter_->onDestroy();
+
+  filter_ = std::make_unique<GzipFilter>(config_);
+  filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip"}}, false);
+  Http::TestHeaderMapImpl headers{{":method", "get"}, {"content-length", "512"}};
+  TestUtility::feedBufferWithRandomCharacters(data_, 512);
+  const std::string expected = data_.toString();
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data_, true));
+  expectValidFinishedBuffer(512);
+
+  Decompressor::ZlibDecompressorImpl decompressor;
+  decompressor.init(31);
+  Buffer::OwnedImpl decompressed;
+  decompressor.decompress(data_, decompressed);
+  EXPECT_EQ(expected, decompressed.toString());
+  EXPECT_EQ(2U, stats_.counter("test.gzip.compressed").value());
+}
+
 // Test if Runtime Feature is Disabled
 TEST_F(GzipFilterTest, RuntimeDisabled) {
   EXPECT_CALL(runtime_.snapshot_, featureEnabled("gzip.filter_enabled", 100))
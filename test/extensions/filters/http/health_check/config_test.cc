@@ -94,6 +94,25 @@ TEST(HealthCheckFilterConfig, NotFailingWhenNotPassThroughAndTimeoutNotSetProto)
   healthCheckFilterConfig.createFilterFactoryFromProto(config, "dummy_stats_prefix", context);
 }
 
+TEST(HealthCheckFilterConfig, ClusterHealthCacheTime) {
+  HealthCheckFilterConfig healthCheckFilterConfig;
+  envoy::config::filter::http::health_check::v2::HealthCheck config{};
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+
+  config.mutable_pass_through_mode()->set_value(false);
+  (*config.mutable_cluster_min_healthy_percentages())["www1"].set_value(50.0);
+  config.mutable_cluster_health_cache_time()->set_seconds(1);
+
+  // The health of the clusters is evaluated on a timer of the main thread.
+  Event::MockTimer* evaluate_timer = new Event::MockTimer(&context.dispatcher_);
+  EXPECT_CALL(*evaluate_timer, enableTimer(std::chrono::milliseconds(1000)));
+  Http::FilterFactoryCb cb =
+      healthCheckFilterConfig.createFilterFactoryFromProto(config, "dummy_stats_prefix", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+}
+
 TEST(HealthCheckFilterConfig, HealthCheckFilterWithEmptyProto) {
   HealthCheckFilterConfig healthCheckFilterConfig;
   NiceMock<Server::Configuration::MockFactoryContext> context;
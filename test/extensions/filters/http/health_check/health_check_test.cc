@@ -46,14 +46,16 @@ public:
 
   void prepareFilter(
       bool pass_through,
-      ClusterMinHealthyPercentagesConstSharedPtr cluster_min_healthy_percentages = nullptr) {
+      ClusterMinHealthyPercentagesConstSharedPtr cluster_min_healthy_percentages = nullptr,
+      ClusterHealthCacheSharedPtr cluster_health_cache = nullptr) {
     header_data_ = std::make_shared<std::vector<Http::HeaderUtility::HeaderData>>();
     envoy::api::v2::route::HeaderMatcher matcher;
     matcher.set_name(":path");
     matcher.set_exact_match("/healthcheck");
     header_data_->emplace_back(matcher);
     filter_ = std::make_unique<HealthCheckFilter>(context_, pass_through, cache_manager_,
-                                                  header_data_, cluster_min_healthy_percentages);
+                                                  header_data_, cluster_min_healthy_percentages,
+                                                  cluster_health_cache);
     filter_->setDecoderFilterCallbacks(callbacks_);
   }
 
@@ -217,6 +219,46 @@ TEST_F(HealthCheckFilterNoPassThroughTest, ComputedHealth) {
   }
 }
 
+TEST_F(HealthCheckFilterNoPassThroughTest, CachedClusterHealth) {
+  auto cluster_min_healthy_percentages = std::make_shared<const ClusterMinHealthyPercentages>(
+      ClusterMinHealthyPercentages{{"www1", 50.0}});
+  MockHealthCheckCluster cluster_www1(100, 50);
+  EXPECT_CALL(context_.cluster_manager_, get(Eq("www1"))).WillRepeatedly(Return(&cluster_www1));
+
+  // The health of the clusters is evaluated when the cache is created and on each timer.
+  Event::MockTimer* evaluate_timer = new Event::MockTimer(&dispatcher_);
+  EXPECT_CALL(*evaluate_timer, enableTimer(std::chrono::milliseconds(1000))).Times(2);
+  auto cluster_health_cache = std::make_shared<ClusterHealthCache>(
+      dispatcher_, context_.cluster_manager_, cluster_min_healthy_percentages,
+      std::chrono::milliseconds(1000));
+  EXPECT_EQ(ClusterHealth::Healthy, cluster_health_cache->clusterHealth());
+  prepareFilter(false, cluster_min_healthy_percentages, cluster_health_cache);
+
+  // The requests are answered with the cached health, without looking the clusters up.
+  cluster_www1.info()->stats().membership_healthy_.set(49);
+  {
+    Http::TestHeaderMapImpl health_check_response{{":status", "200"}};
+    EXPECT_CALL(context_, healthCheckFailed()).WillOnce(Return(false));
+    EXPECT_CALL(context_, clusterManager()).Times(0);
+    EXPECT_CALL(callbacks_, encodeHeaders_(HeaderMapEqualRef(&health_check_response), true));
+    EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+              filter_->decodeHeaders(request_headers_, true));
+    EXPECT_EQ("health_check_ok_cluster_healthy", callbacks_.details_);
+  }
+
+  evaluate_timer->invokeCallback();
+  EXPECT_EQ(ClusterHealth::Unhealthy, cluster_health_cache->clusterHealth());
+  prepareFilter(false, cluster_min_healthy_percentages, cluster_health_cache);
+  {
+    Http::TestHeaderMapImpl health_check_response{{":status", "503"}};
+    EXPECT_CALL(context_, healthCheckFailed()).WillOnce(Return(false));
+    EXPECT_CALL(callbacks_, encodeHeaders_(HeaderMapEqualRef(&health_check_response), true));
+    EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+              filter_->decodeHeaders(request_headers_, true));
+    EXPECT_EQ("health_check_failed_cluster_unhealthy", callbacks_.details_);
+  }
+}
+
 TEST_F(HealthCheckFilterNoPassThroughTest, HealthCheckFailedCallbackCalled) {
   EXPECT_CALL(context_, healthCheckFailed()).WillOnce(Return(true));
   EXPECT_CALL(callbacks_.stream_info_, healthCheck(true));
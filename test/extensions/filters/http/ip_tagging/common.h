@@ -0,0 +1,68 @@
+#pragma once
+
+#include <arpa/inet.h>
+
+#include <string>
+#include <vector>
+
+#include "common/network/cidr_range.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace IpTagging {
+
+/**
+ * Builds the contents of an IP tags file.
+ */
+class IpTagsFileBuilder {
+public:
+  IpTagsFileBuilder(const std::vector<std::string>& tags) {
+    contents_.append("IPTG");
+    appendUint32(1);
+    appendUint32(tags.size());
+    for (const std::string& tag : tags) {
+      appendUint16(tag.size());
+      contents_.append(tag);
+    }
+  }
+
+  /**
+   * Adds a CIDR range, e.g. "10.0.0.0/8", to the tag at tag_index.
+   */
+  IpTagsFileBuilder& add(uint16_t tag_index, const std::string& cidr) {
+    const Network::Address::CidrRange range = Network::Address::CidrRange::create(cidr);
+    appendUint16(tag_index);
+    if (range.ip()->version() == Network::Address::IpVersion::v4) {
+      contents_.push_back(4);
+      contents_.push_back(range.length());
+      const uint32_t address = range.ip()->ipv4()->address();
+      contents_.append(reinterpret_cast<const char*>(&address), sizeof(address));
+    } else {
+      contents_.push_back(6);
+      contents_.push_back(range.length());
+      const absl::uint128 address = range.ip()->ipv6()->address();
+      contents_.append(reinterpret_cast<const char*>(&address), sizeof(address));
+    }
+    return *this;
+  }
+
+  const std::string& contents() const { return contents_; }
+
+private:
+  void appendUint16(uint16_t value) {
+    value = htons(value);
+    contents_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+  void appendUint32(uint32_t value) {
+    value = htonl(value);
+    contents_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  std::string contents_;
+};
+
+} // namespace IpTagging
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <memory>
 
 #include "common/buffer/buffer_impl.h"
@@ -8,15 +9,23 @@
 
 #include "extensions/filters/http/ip_tagging/ip_tagging_filter.h"
 
+#include "test/extensions/filters/http/ip_tagging/common.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/filesystem/mocks.h"
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/environment.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::Invoke;
 using testing::Return;
 using testing::ReturnRef;
 
@@ -45,12 +54,17 @@ ip_tags:
   void initializeFilter(const std::string& yaml) {
     envoy::config::filter::http::ip_tagging::v2::IPTagging config;
     TestUtility::loadFromYaml(yaml, config);
-    config_.reset(new IpTaggingFilterConfig(config, "prefix.", stats_, runtime_));
+    config_.reset(
+        new IpTaggingFilterConfig(config, "prefix.", stats_, runtime_, dispatcher_, tls_));
     filter_ = std::make_unique<IpTaggingFilter>(config_);
     filter_->setDecoderFilterCallbacks(filter_callbacks_);
   }
 
-  ~IpTaggingFilterTest() override { filter_->onDestroy(); }
+  ~IpTaggingFilterTest() override {
+    if (filter_ != nullptr) {
+      filter_->onDestroy();
+    }
+  }
 
   IpTaggingFilterConfigSharedPtr config_;
   std::unique_ptr<IpTaggingFilter> filter_;
@@ -58,6 +72,8 @@ ip_tags:
   Buffer::OwnedImpl data_;
   NiceMock<Stats::MockStore> stats_;
   NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
 };
 
 TEST_F(IpTaggingFilterTest, InternalRequest) {
@@ -281,6 +297,86 @@ TEST_F(IpTaggingFilterTest, ClearRouteCache) {
   EXPECT_FALSE(request_headers.has(Http::Headers::get().EnvoyIpTags));
 }
 
+TEST_F(IpTaggingFilterTest, NoTags) {
+  EXPECT_THROW_WITH_MESSAGE(
+      initializeFilter("request_type: both"), EnvoyException,
+      "HTTP IP Tagging Filter requires exactly one of ip_tags and ip_tags_path to be specified.");
+  EXPECT_THROW_WITH_MESSAGE(
+      initializeFilter(fmt::format("{}ip_tags_path: /ip_tags", internal_request_yaml)),
+      EnvoyException,
+      "HTTP IP Tagging Filter requires exactly one of ip_tags and ip_tags_path to be specified.");
+}
+
+class IpTaggingFilterFileTest : public IpTaggingFilterTest {
+public:
+  void initializeFileFilter(const std::string& contents) {
+    path_ = TestEnvironment::writeStringToFileForTest("ip_tags", contents);
+    EXPECT_CALL(dispatcher_, createFilesystemWatcher_()).WillOnce(Invoke([this] {
+      auto* watcher = new Filesystem::MockWatcher();
+      EXPECT_CALL(*watcher, addWatch(path_, Filesystem::Watcher::Events::MovedTo, _))
+          .WillOnce(Invoke([this](const std::string&, uint32_t,
+                                  Filesystem::Watcher::OnChangedCb cb) { on_changed_cb_ = cb; }));
+      return watcher;
+    }));
+    initializeFilter(fmt::format("ip_tags_path: {}", path_));
+  }
+
+  void expectTags(const std::string& address, const std::string& tags) {
+    Network::Address::InstanceConstSharedPtr remote_address =
+        Network::Utility::parseInternetAddress(address);
+    EXPECT_CALL(filter_callbacks_.stream_info_, downstreamRemoteAddress())
+        .WillOnce(ReturnRef(remote_address));
+    Http::TestHeaderMapImpl request_headers;
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
+    // There is no guarantee for the order tags are returned by the LC-Trie.
+    std::vector<absl::string_view> actual_tags =
+        absl::StrSplit(request_headers.get_(Http::Headers::get().EnvoyIpTags), ',',
+                       absl::SkipEmpty());
+    std::sort(actual_tags.begin(), actual_tags.end());
+    EXPECT_EQ(tags, absl::StrJoin(actual_tags, ","));
+  }
+
+  std::string path_;
+  Filesystem::Watcher::OnChangedCb on_changed_cb_;
+};
+
+TEST_F(IpTaggingFilterFileTest, IpTagsFile) {
+  initializeFileFilter(IpTagsFileBuilder({"tag_a", "tag_b"})
+                           .add(0, "1.2.3.0/24")
+                           .add(1, "1.2.3.4/32")
+                           .add(1, "2001:abcd::/32")
+                           .contents());
+  expectTags("1.2.3.4", "tag_a,tag_b");
+  expectTags("1.2.3.5", "tag_a");
+  expectTags("2001:abcd::1", "tag_b");
+  expectTags("1.2.4.1", "");
+}
+
+TEST_F(IpTaggingFilterFileTest, Reload) {
+  initializeFileFilter(IpTagsFileBuilder({"tag_a"}).add(0, "1.2.3.0/24").contents());
+  expectTags("1.2.3.4", "tag_a");
+
+  // A new file replaces the tags of all the requests that follow.
+  TestEnvironment::writeStringToFileForTest(
+      "ip_tags", IpTagsFileBuilder({"tag_b"}).add(0, "1.2.4.0/24").contents());
+  EXPECT_CALL(stats_, counter("prefix.ip_tagging.file_reload"));
+  on_changed_cb_(Filesystem::Watcher::Events::MovedTo);
+  expectTags("1.2.3.4", "");
+  expectTags("1.2.4.4", "tag_b");
+
+  // A malformed file keeps the previous tags.
+  TestEnvironment::writeStringToFileForTest("ip_tags", "malformed");
+  EXPECT_CALL(stats_, counter("prefix.ip_tagging.file_reload_failed"));
+  on_changed_cb_(Filesystem::Watcher::Events::MovedTo);
+  expectTags("1.2.4.4", "tag_b");
+}
+
+TEST_F(IpTaggingFilterFileTest, MissingFile) {
+  EXPECT_THROW_WITH_REGEX(initializeFilter(fmt::format(
+                              "ip_tags_path: {}", TestEnvironment::temporaryPath("missing"))),
+                          EnvoyException, "unable to open the IP tags file");
+}
+
 } // namespace
 } // namespace IpTagging
 } // namespace HttpFilters
@@ -0,0 +1,84 @@
+#include <string>
+
+#include "extensions/filters/http/ip_tagging/ip_tags_file.h"
+
+#include "test/extensions/filters/http/ip_tagging/common.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace IpTagging {
+namespace {
+
+std::string writeIpTagsFile(const std::string& contents) {
+  return TestEnvironment::writeStringToFileForTest("ip_tags", contents);
+}
+
+TEST(IpTagsFileTest, Read) {
+  const std::string path = writeIpTagsFile(IpTagsFileBuilder({"tag_a", "tag_b"})
+                                               .add(0, "10.0.0.0/8")
+                                               .add(1, "2001:db8::/32")
+                                               .add(0, "192.0.2.1/32")
+                                               .contents());
+  const IpTagData tag_data = readIpTagsFile(path);
+  ASSERT_EQ(2, tag_data.size());
+  EXPECT_EQ("tag_a", tag_data[0].first);
+  ASSERT_EQ(2, tag_data[0].second.size());
+  EXPECT_EQ("10.0.0.0/8", tag_data[0].second[0].asString());
+  EXPECT_EQ("192.0.2.1/32", tag_data[0].second[1].asString());
+  EXPECT_EQ("tag_b", tag_data[1].first);
+  ASSERT_EQ(1, tag_data[1].second.size());
+  EXPECT_EQ("2001:db8::/32", tag_data[1].second[0].asString());
+}
+
+TEST(IpTagsFileTest, NoRanges) {
+  const IpTagData tag_data = readIpTagsFile(writeIpTagsFile(IpTagsFileBuilder({"tag"}).contents()));
+  ASSERT_EQ(1, tag_data.size());
+  EXPECT_TRUE(tag_data[0].second.empty());
+}
+
+TEST(IpTagsFileTest, Missing) {
+  EXPECT_THROW_WITH_REGEX(readIpTagsFile(TestEnvironment::temporaryPath("missing_ip_tags")),
+                          EnvoyException, "unable to open the IP tags file");
+}
+
+TEST(IpTagsFileTest, Malformed) {
+  EXPECT_THROW_WITH_REGEX(readIpTagsFile(writeIpTagsFile("")), EnvoyException,
+                          "is not an IP tags file");
+  EXPECT_THROW_WITH_REGEX(readIpTagsFile(writeIpTagsFile("10.0.0.0/8 tag\n")), EnvoyException,
+                          "is not an IP tags file");
+
+  std::string contents = IpTagsFileBuilder({"tag"}).contents();
+  contents[7] = 2;
+  EXPECT_THROW_WITH_REGEX(readIpTagsFile(writeIpTagsFile(contents)), EnvoyException,
+                          "unsupported version 2 of the IP tags file");
+
+  contents = IpTagsFileBuilder({"tag"}).add(0, "10.0.0.0/8").contents();
+  contents.pop_back();
+  EXPECT_THROW_WITH_REGEX(readIpTagsFile(writeIpTagsFile(contents)), EnvoyException,
+                          "truncated IP tags file");
+
+  EXPECT_THROW_WITH_REGEX(
+      readIpTagsFile(writeIpTagsFile(IpTagsFileBuilder({"tag"}).add(1, "10.0.0.0/8").contents())),
+      EnvoyException, "invalid tag index 1 in the IP tags file");
+
+  contents = IpTagsFileBuilder({"tag"}).add(0, "10.0.0.0/8").contents();
+  contents[contents.size() - 6] = 5;
+  EXPECT_THROW_WITH_REGEX(readIpTagsFile(writeIpTagsFile(contents)), EnvoyException,
+                          "invalid IP version 5 in the IP tags file");
+
+  contents[contents.size() - 6] = 4;
+  contents[contents.size() - 5] = 33;
+  EXPECT_THROW_WITH_REGEX(readIpTagsFile(writeIpTagsFile(contents)), EnvoyException,
+                          "invalid prefix length 33 in the IP tags file");
+}
+
+} // namespace
+} // namespace IpTagging
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -44,7 +44,8 @@ public:
     fetcher_.reset(raw_fetcher_);
     auth_ = Authenticator::create(
         check_audience, provider, !provider, filter_config_->getCache().getJwksCache(),
-        filter_config_->cm(), [this](Upstream::ClusterManager&) { return std::move(fetcher_); },
+        filter_config_->getCache().getTokenCache(), filter_config_->cm(),
+        [this](Upstream::ClusterManager&) { return std::move(fetcher_); },
         filter_config_->timeSource());
     jwks_ = Jwks::createFrom(PublicKey, Jwks::JWKS);
     EXPECT_TRUE(jwks_->getStatus() == Status::Ok);
@@ -94,6 +95,32 @@ TEST_F(AuthenticatorTest, TestOkJWTandCache) {
   }
 }
 
+// This test verifies a verified token is cached, and only its claims are checked again.
+TEST_F(AuthenticatorTest, TestTokenCache) {
+  proto_config_.set_token_cache_size(10);
+  CreateAuthenticator();
+  EXPECT_CALL(*raw_fetcher_, fetch(_, _))
+      .WillOnce(Invoke(
+          [this](const ::envoy::api::v2::core::HttpUri&, JwksFetcher::JwksReceiver& receiver) {
+            receiver.onJwksSuccess(std::move(jwks_));
+          }));
+
+  for (int i = 0; i < 3; i++) {
+    auto headers = Http::TestHeaderMapImpl{{"Authorization", "Bearer " + std::string(GoodToken)}};
+    expectVerifyStatus(Status::Ok, headers);
+    EXPECT_EQ(headers.get_("sec-istio-auth-userinfo"), ExpectedPayloadValue);
+  }
+  EXPECT_EQ(1U, mock_factory_ctx_.scope_.counter("jwt_authn.token_cache_miss").value());
+  EXPECT_EQ(2U, mock_factory_ctx_.scope_.counter("jwt_authn.token_cache_hit").value());
+  EXPECT_EQ(1U, filter_config_->getCache().getTokenCache()->size());
+
+  // A failed verification is not cached.
+  auto headers =
+      Http::TestHeaderMapImpl{{"Authorization", "Bearer " + std::string(NonExistKidToken)}};
+  expectVerifyStatus(Status::JwtVerificationFail, headers);
+  EXPECT_EQ(1U, filter_config_->getCache().getTokenCache()->size());
+}
+
 // This test verifies the Jwt is forwarded if "forward" flag is set.
 TEST_F(AuthenticatorTest, TestForwardJwt) {
   // Confit forward_jwt flag
@@ -0,0 +1,110 @@
+#include "common/protobuf/utility.h"
+
+#include "extensions/filters/http/jwt_authn/jwks_async_fetcher.h"
+
+#include "test/extensions/filters/http/common/mock.h"
+#include "test/extensions/filters/http/jwt_authn/test_common.h"
+#include "test/mocks/init/mocks.h"
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+using ::envoy::config::filter::http::jwt_authn::v2alpha::JwtAuthentication;
+using ::envoy::config::filter::http::jwt_authn::v2alpha::RemoteJwks;
+using Envoy::Extensions::HttpFilters::Common::JwksFetcher;
+using Envoy::Extensions::HttpFilters::Common::MockJwksFetcher;
+using ::google::jwt_verify::Jwks;
+using ::google::jwt_verify::Status;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+namespace {
+
+class JwksAsyncFetcherTest : public testing::Test {
+public:
+  JwksAsyncFetcherTest() {
+    JwtAuthentication config;
+    TestUtility::loadFromYaml(ExampleConfig, config);
+    remote_jwks_ = config.providers().at(ProviderName).remote_jwks();
+
+    ON_CALL(context_.init_manager_, add(_))
+        .WillByDefault(Invoke([this](const Init::Target& target) {
+          init_target_handle_ = target.createHandle("test");
+        }));
+    timer_ = new NiceMock<Event::MockTimer>(&context_.dispatcher_);
+    fetcher_ = std::make_unique<JwksAsyncFetcher>(
+        remote_jwks_, context_,
+        [this](Upstream::ClusterManager&) {
+          auto fetcher = std::make_unique<MockJwksFetcher>();
+          raw_fetcher_ = fetcher.get();
+          EXPECT_CALL(*raw_fetcher_, fetch(_, _))
+              .WillRepeatedly(Invoke([this](const ::envoy::api::v2::core::HttpUri&,
+                                            JwksFetcher::JwksReceiver& receiver) {
+                receiver_ = &receiver;
+              }));
+          return fetcher;
+        },
+        [this](JwksConstSharedPtr jwks) { fetched_.push_back(jwks); });
+  }
+
+  RemoteJwks remote_jwks_;
+  NiceMock<Server::Configuration::MockFactoryContext> context_;
+  Init::TargetHandlePtr init_target_handle_;
+  Init::ExpectableWatcherImpl init_watcher_;
+  Event::MockTimer* timer_;
+  MockJwksFetcher* raw_fetcher_{};
+  JwksFetcher::JwksReceiver* receiver_{};
+  std::vector<JwksConstSharedPtr> fetched_;
+  JwksAsyncFetcherPtr fetcher_;
+};
+
+// The JWKS are fetched when the listener initializes, then refreshed every cache duration.
+TEST_F(JwksAsyncFetcherTest, FetchAndRefresh) {
+  ASSERT_NE(nullptr, init_target_handle_);
+  EXPECT_EQ(nullptr, receiver_);
+  init_target_handle_->initialize(init_watcher_);
+  ASSERT_NE(nullptr, receiver_);
+
+  init_watcher_.expectReady();
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(600 * 1000)));
+  receiver_->onJwksSuccess(Jwks::createFrom(PublicKey, Jwks::JWKS));
+  ASSERT_EQ(1, fetched_.size());
+  EXPECT_EQ(Status::Ok, fetched_[0]->getStatus());
+
+  // A failed refresh is retried sooner, and does not hand out anything.
+  receiver_ = nullptr;
+  timer_->invokeCallback();
+  ASSERT_NE(nullptr, receiver_);
+  EXPECT_CALL(*timer_, enableTimer(JwksAsyncFetcher::RetryInterval));
+  receiver_->onJwksError(JwksFetcher::JwksReceiver::Failure::Network);
+  EXPECT_EQ(1, fetched_.size());
+
+  timer_->invokeCallback();
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(600 * 1000)));
+  receiver_->onJwksSuccess(Jwks::createFrom(PublicKey, Jwks::JWKS));
+  EXPECT_EQ(2, fetched_.size());
+
+  EXPECT_CALL(*raw_fetcher_, cancel());
+  fetcher_.reset();
+}
+
+// The listener does not wait beyond the first failed fetch.
+TEST_F(JwksAsyncFetcherTest, FirstFetchFails) {
+  init_target_handle_->initialize(init_watcher_);
+  init_watcher_.expectReady();
+  EXPECT_CALL(*timer_, enableTimer(JwksAsyncFetcher::RetryInterval));
+  receiver_->onJwksError(JwksFetcher::JwksReceiver::Failure::InvalidJwks);
+  EXPECT_TRUE(fetched_.empty());
+}
+
+} // namespace
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
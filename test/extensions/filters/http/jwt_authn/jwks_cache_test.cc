@@ -75,6 +75,19 @@ TEST_F(JwksCacheTest, TestSetRemoteJwksWithDefaultCacheDuration) {
   EXPECT_FALSE(jwks->isExpired());
 }
 
+// Test setAsyncJwks: the shared jwks do not expire.
+TEST_F(JwksCacheTest, TestSetAsyncJwks) {
+  auto jwks = cache_->findByIssuer("https://example.com");
+  const uint64_t generation = jwks->generation();
+  JwksConstSharedPtr shared_jwks(std::move(jwks_));
+  jwks->setAsyncJwks(shared_jwks);
+  EXPECT_EQ(shared_jwks.get(), jwks->getJwksObj());
+  EXPECT_NE(generation, jwks->generation());
+
+  time_system_.sleep(std::chrono::seconds(3600));
+  EXPECT_FALSE(jwks->isExpired());
+}
+
 // Test a good local jwks
 TEST_F(JwksCacheTest, TestGoodInlineJwks) {
   auto& provider0 = (*config_.mutable_providers())[std::string(ProviderName)];
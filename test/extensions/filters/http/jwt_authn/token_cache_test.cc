@@ -0,0 +1,74 @@
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/jwt_authn/token_cache.h"
+
+#include "test/extensions/filters/http/jwt_authn/test_common.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+using ::envoy::config::filter::http::jwt_authn::v2alpha::JwtAuthentication;
+using ::google::jwt_verify::Jwks;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+namespace {
+
+class TokenCacheTest : public testing::Test {
+protected:
+  TokenCacheTest() : api_(Api::createApiForTest()) {
+    TestUtility::loadFromYaml(ExampleConfig, config_);
+    jwks_cache_ = JwksCache::create(config_, time_system_, *api_);
+    jwks_data_ = jwks_cache_->findByIssuer("https://example.com");
+  }
+
+  TokenCache::Entry entry() {
+    return {std::make_shared<::google::jwt_verify::Jwt>(), jwks_data_, jwks_data_->generation()};
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Api::ApiPtr api_;
+  Stats::IsolatedStoreImpl stats_;
+  JwtAuthentication config_;
+  JwksCachePtr jwks_cache_;
+  JwksCache::JwksData* jwks_data_;
+};
+
+// The least recently used token is evicted.
+TEST_F(TokenCacheTest, Lru) {
+  TokenCache cache(2, stats_.counter("hit"), stats_.counter("miss"));
+  EXPECT_FALSE(cache.find("a").has_value());
+
+  cache.insert("a", entry());
+  cache.insert("b", entry());
+  EXPECT_EQ(2, cache.size());
+  EXPECT_TRUE(cache.find("a").has_value());
+
+  cache.insert("c", entry());
+  EXPECT_EQ(2, cache.size());
+  EXPECT_TRUE(cache.find("a").has_value());
+  EXPECT_FALSE(cache.find("b").has_value());
+  EXPECT_TRUE(cache.find("c").has_value());
+
+  // Replacing an entry does not evict another one.
+  cache.insert("a", entry());
+  EXPECT_EQ(2, cache.size());
+  EXPECT_TRUE(cache.find("c").has_value());
+}
+
+// An entry is only valid for the JWKS it was verified with.
+TEST_F(TokenCacheTest, JwksGeneration) {
+  TokenCache cache(2, stats_.counter("hit"), stats_.counter("miss"));
+  cache.insert("a", entry());
+  EXPECT_TRUE(cache.find("a")->verifiedWith(*jwks_data_));
+
+  jwks_data_->setRemoteJwks(Jwks::createFrom(PublicKey, Jwks::JWKS));
+  EXPECT_FALSE(cache.find("a")->verifiedWith(*jwks_data_));
+}
+
+} // namespace
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
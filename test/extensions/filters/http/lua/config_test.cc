@@ -38,6 +38,23 @@ TEST(LuaFilterConfigTest, LuaFilterInJson) {
   cb(filter_callback);
 }
 
+TEST(LuaFilterConfigTest, GCParameters) {
+  envoy::config::filter::http::lua::v2::Lua proto_config;
+  proto_config.set_inline_code("print(5)");
+  proto_config.mutable_gc_pause()->set_value(150);
+  proto_config.mutable_gc_step_multiplier()->set_value(400);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  LuaFilterConfig factory;
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(proto_config, "stats", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+
+  proto_config.mutable_gc_step_multiplier()->set_value(50);
+  EXPECT_THROW(factory.createFilterFactoryFromProto(proto_config, "stats", context),
+               ProtoValidationException);
+}
+
 } // namespace
 } // namespace Lua
 } // namespace HttpFilters
@@ -14,6 +14,7 @@
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/ratelimit/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/printers.h"
@@ -52,8 +53,8 @@ public:
     envoy::config::filter::http::rate_limit::v2::RateLimit proto_config{};
     TestUtility::loadFromYaml(yaml, proto_config);
 
-    config_.reset(
-        new FilterConfig(proto_config, local_info_, stats_store_, runtime_, http_context_));
+    config_.reset(new FilterConfig(proto_config, local_info_, stats_store_, runtime_, http_context_,
+                                   tls_));
 
     client_ = new Filters::Common::RateLimit::MockClient();
     filter_ = std::make_unique<Filter>(config_, Filters::Common::RateLimit::ClientPtr{client_});
@@ -91,6 +92,7 @@ public:
   NiceMock<Router::MockRateLimitPolicyEntry> vh_rate_limit_;
   std::vector<RateLimit::Descriptor> descriptor_{{{{"descriptor_key", "descriptor_value"}}}};
   NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
   Http::ContextImpl http_context_;
 };
 
@@ -217,6 +219,53 @@ TEST_F(HttpRateLimitFilterTest, OkResponse) {
   EXPECT_EQ(1U, filter_callbacks_.clusterInfo()->statsScope().counter("ratelimit.ok").value());
 }
 
+// With quota leases, the hits of a lease admit the following requests without calling the service.
+TEST_F(HttpRateLimitFilterTest, QuotaLease) {
+  SetUpTest(R"EOF(
+  domain: foo
+  quota_lease:
+    lease_size: 3
+    lease_duration: 1s
+  )EOF");
+
+  ON_CALL(route_rate_limit_, populateDescriptors(_, _, _, _, _))
+      .WillByDefault(SetArgReferee<1>(descriptor_));
+  EXPECT_CALL(*client_, lease(_, "foo",
+                              testing::ContainerEq(std::vector<RateLimit::Descriptor>{
+                                  {{{"descriptor_key", "descriptor_value"}}}}),
+                              _, 3))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
+            request_callbacks_ = &callbacks;
+          })));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+  EXPECT_CALL(filter_callbacks_, continueDecoding());
+  request_callbacks_->complete(Filters::Common::RateLimit::LimitStatus::OK, nullptr);
+
+  // The two hits left admit two requests, then a new lease is asked for.
+  for (int i = 0; i < 3; i++) {
+    auto* client = new Filters::Common::RateLimit::MockClient();
+    Filter filter(config_, Filters::Common::RateLimit::ClientPtr{client});
+    filter.setDecoderFilterCallbacks(filter_callbacks_);
+    if (i < 2) {
+      EXPECT_CALL(*client, lease(_, _, _, _, _)).Times(0);
+      EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+                filter.decodeHeaders(request_headers_, false));
+    } else {
+      EXPECT_CALL(*client, lease(_, _, _, _, 3));
+      EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+                filter.decodeHeaders(request_headers_, false));
+      EXPECT_CALL(*client, cancel());
+      filter.onDestroy();
+    }
+  }
+
+  EXPECT_EQ(1U, filter_callbacks_.clusterInfo()->statsScope().counter("ratelimit.ok").value());
+  EXPECT_EQ(2U,
+            filter_callbacks_.clusterInfo()->statsScope().counter("ratelimit.leased_ok").value());
+}
+
 TEST_F(HttpRateLimitFilterTest, OkResponseWithHeaders) {
   SetUpTest(filter_config_);
   InSequence s;
@@ -0,0 +1,52 @@
+#include <string>
+
+#include "extensions/common/wasm/null/null_plugin.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Wasm {
+namespace Null {
+namespace Plugin {
+namespace RecyclePlugin {
+NULL_PLUGIN_ROOT_REGISTRY;
+NullPluginRootRegistry* context_registry_{};
+
+// A stream context which supports recycling. It copies the response headers and body it can see
+// into the request headers, and traps on the response as a guest with a bug would.
+class PluginContext : public Context {
+public:
+  explicit PluginContext(uint32_t id, RootContext* root) : Context(id, root) {}
+
+  FilterHeadersStatus onRequestHeaders() override {
+    addRequestHeader("response-status", getResponseHeader(":status")->view());
+    addRequestHeader("response-body", getResponseBodyBufferBytes(0, 8)->view());
+    return FilterHeadersStatus::Continue;
+  }
+  FilterHeadersStatus onResponseHeaders() override {
+    throw Envoy::Extensions::Common::Wasm::WasmException("trap in onResponseHeaders");
+  }
+  FilterDataStatus onResponseBody(size_t, bool) override {
+    throw Envoy::Extensions::Common::Wasm::WasmException("trap in onResponseBody");
+  }
+  bool onReset() override { return true; }
+};
+static RegisterContextFactory register_PluginContext(CONTEXT_FACTORY(PluginContext));
+} // namespace RecyclePlugin
+
+class PluginFactory : public NullPluginFactory {
+public:
+  const std::string name() const override { return "recycle_null_plugin"; }
+  std::unique_ptr<NullVmPlugin> create() const override {
+    return std::make_unique<NullPlugin>(RecyclePlugin::context_registry_);
+  }
+};
+
+static Registry::RegisterFactory<PluginFactory, NullPluginFactory> register_;
+
+} // namespace Plugin
+} // namespace Null
+} // namespace Wasm
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
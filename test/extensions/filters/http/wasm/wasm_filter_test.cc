@@ -403,6 +403,39 @@ TEST_F(WasmHttpFilterTest, NullVmResolver) {
   filter_->log(&request_headers, nullptr, nullptr, log_stream_info);
 }
 
+// A recycled stream context does not see the headers and body of the previous stream, even when a
+// guest call failed while they were set.
+TEST_F(WasmHttpFilterTest, NullPluginRecycledContext) {
+  setupNullConfig("recycle_null_plugin");
+  const uint32_t root_context_id = wasm_->getRootContext("")->id();
+
+  auto context = wasm_->createStreamContext(root_context_id);
+  Common::Wasm::Context* first_context = context.get();
+  context->setDecoderFilterCallbacks(decoder_callbacks_);
+  context->setEncoderFilterCallbacks(encoder_callbacks_);
+  {
+    Http::TestHeaderMapImpl request_headers{{":path", "/"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, context->decodeHeaders(request_headers, true));
+    Http::TestHeaderMapImpl response_headers{{":status", "200"}};
+    EXPECT_THROW(context->encodeHeaders(response_headers, false), Common::Wasm::WasmException);
+    Buffer::OwnedImpl response_body("response");
+    EXPECT_THROW(context->encodeData(response_body, true), Common::Wasm::WasmException);
+  }
+  context->onDestroy();
+  context.reset();
+
+  context = wasm_->createStreamContext(root_context_id);
+  EXPECT_EQ(first_context, context.get());
+  EXPECT_EQ(1U, stats_store_.counter("wasm.wasm.recycled_contexts").value());
+  context->setDecoderFilterCallbacks(decoder_callbacks_);
+  context->setEncoderFilterCallbacks(encoder_callbacks_);
+  Http::TestHeaderMapImpl request_headers{{":path", "/"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, context->decodeHeaders(request_headers, true));
+  EXPECT_EQ("", request_headers.get_("response-status"));
+  EXPECT_EQ("", request_headers.get_("response-body"));
+  context->onDestroy();
+}
+
 TEST_P(WasmHttpFilterTest, SharedData) {
   setupConfig(TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
       "{{ test_rundir }}/test/extensions/filters/http/wasm/test_data/shared_cpp.wasm")));
@@ -417,6 +450,9 @@ TEST_P(WasmHttpFilterTest, SharedData) {
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
   StreamInfo::MockStreamInfo log_stream_info;
   filter_->log(&request_headers, nullptr, nullptr, log_stream_info);
+  // A single thread never contends on the shared data locks.
+  EXPECT_EQ(0U, stats_store_.counter("wasm.wasm.shared_data_read_contended").value());
+  EXPECT_EQ(0U, stats_store_.counter("wasm.wasm.shared_data_write_contended").value());
 }
 
 TEST_P(WasmHttpFilterTest, SharedQueue) {
@@ -0,0 +1,104 @@
+#include <string>
+
+#include "extensions/filters/listener/http_inspector/http_classifier.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace HttpInspector {
+namespace {
+
+using Result = HttpClassifier::Result;
+
+// Feeds the data one more byte at a time, as successive peeks would return it.
+Result classifyByteByByte(absl::string_view data, size_t& bytes_needed) {
+  HttpClassifier classifier;
+  for (size_t i = 1; i <= data.size(); i++) {
+    const Result result = classifier.classify(data.substr(0, i));
+    if (result != Result::NeedMoreData) {
+      bytes_needed = i;
+      return result;
+    }
+  }
+  bytes_needed = data.size();
+  return Result::NeedMoreData;
+}
+
+Result classify(absl::string_view data) {
+  HttpClassifier classifier;
+  return classifier.classify(data);
+}
+
+TEST(HttpClassifierTest, Http1) {
+  EXPECT_EQ(Result::Http11, classify("GET /index HTTP/1.1\r\nHost: a\r\n\r\n"));
+  EXPECT_EQ(Result::Http10, classify("POST / HTTP/1.0\r\n"));
+  EXPECT_EQ(Result::Http11, classify("BASELINE-CONTROL / HTTP/1.1\n"));
+  EXPECT_EQ(Result::Http11, classify("VERSION-CONTROL * HTTP/1.1\r"));
+  EXPECT_EQ(Result::Http11, classify("Merge / HTTP/1.1\r\n"));
+}
+
+TEST(HttpClassifierTest, Http2) {
+  EXPECT_EQ(Result::Http2, classify(HttpClassifier::HTTP2_CONNECTION_PREFACE));
+  // The start of the preface is neither a valid request line nor the full preface.
+  EXPECT_EQ(Result::NeedMoreData, classify("PRI * HTTP/2.0\r\n"));
+}
+
+TEST(HttpClassifierTest, NeedMoreData) {
+  EXPECT_EQ(Result::NeedMoreData, classify(""));
+  EXPECT_EQ(Result::NeedMoreData, classify("GE"));
+  EXPECT_EQ(Result::NeedMoreData, classify("GET /index"));
+  EXPECT_EQ(Result::NeedMoreData, classify("GET /index HTTP/1.1"));
+}
+
+TEST(HttpClassifierTest, NotHttp) {
+  EXPECT_EQ(Result::NotHttp, classify("BAD /index HTTP/1.1\r\n"));
+  EXPECT_EQ(Result::NotHttp, classify("GETS /index HTTP/1.1\r\n"));
+  EXPECT_EQ(Result::NotHttp, classify("get /index HTTP/1.1\r\n"));
+  EXPECT_EQ(Result::NotHttp, classify("GET  HTTP/1.1\r\n"));
+  EXPECT_EQ(Result::NotHttp, classify("GET /index\r\n"));
+  EXPECT_EQ(Result::NotHttp, classify("GET /index HTTP/0.9\r\n"));
+  EXPECT_EQ(Result::NotHttp, classify("GET /index HTTP/1.12\r\n"));
+  EXPECT_EQ(Result::NotHttp, classify("GET /index HTTP/1.1 extra\r\n"));
+  EXPECT_EQ(Result::NotHttp, classify("PRI * HTTP/2.0\r\n\r\nXX"));
+}
+
+// The classification is decided as soon as the data can not be HTTP.
+TEST(HttpClassifierTest, MinimumBytes) {
+  size_t bytes_needed;
+  // A TLS ClientHello.
+  EXPECT_EQ(Result::NotHttp, classifyByteByByte("\x16\x03\x01\x02\x00", bytes_needed));
+  EXPECT_EQ(1, bytes_needed);
+  EXPECT_EQ(Result::NotHttp, classifyByteByByte("GEX / HTTP/1.1\r\n", bytes_needed));
+  EXPECT_EQ(3, bytes_needed);
+  EXPECT_EQ(Result::NotHttp, classifyByteByByte("GET / HTTP/2.0\r\n", bytes_needed));
+  EXPECT_EQ(12, bytes_needed);
+  // The preface is only ruled out at its first differing byte.
+  EXPECT_EQ(Result::NotHttp, classifyByteByByte("PRI * HTTP/2.0\r\n\r\nXX", bytes_needed));
+  EXPECT_EQ(19, bytes_needed);
+
+  const std::string request = "GET /index HTTP/1.1\r\nHost: a\r\n\r\n";
+  EXPECT_EQ(Result::Http11, classifyByteByByte(request, bytes_needed));
+  EXPECT_EQ(request.find('\r') + 1, bytes_needed);
+  EXPECT_EQ(Result::Http2,
+            classifyByteByByte(HttpClassifier::HTTP2_CONNECTION_PREFACE, bytes_needed));
+  EXPECT_EQ(HttpClassifier::HTTP2_CONNECTION_PREFACE.size(), bytes_needed);
+}
+
+// The data scanned by previous calls is not scanned again.
+TEST(HttpClassifierTest, Resume) {
+  HttpClassifier classifier;
+  const std::string request = "GET /index HTTP/1.1\r\n";
+  EXPECT_EQ(Result::NeedMoreData, classifier.classify(request.substr(0, 8)));
+  // A byte of the previously scanned data is changed, which goes unnoticed.
+  std::string changed = request;
+  changed[0] = 'X';
+  EXPECT_EQ(Result::Http11, classifier.classify(changed));
+}
+
+} // namespace
+} // namespace HttpInspector
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -135,8 +135,26 @@ TEST_F(HttpInspectorTest, InvalidHttpMethod) {
 
 TEST_F(HttpInspectorTest, InvalidHttpRequestLine) {
   init();
+  // The method is invalid, so the end of the request line is not waited for.
   const absl::string_view header = "BAD /anything HTTP/1.1";
 
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(Invoke([&header](int, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+        ASSERT(length >= header.size());
+        memcpy(buffer, header.data(), header.size());
+        return Api::SysCallSizeResult{ssize_t(header.size()), 0};
+      }));
+
+  EXPECT_CALL(socket_, setRequestedApplicationProtocols(_)).Times(0);
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().http_not_found_.value());
+}
+
+TEST_F(HttpInspectorTest, IncompleteHttpRequestLine) {
+  init();
+  const absl::string_view header = "GET /anything HTTP/1.1";
+
   EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
       .WillOnce(Invoke([&header](int, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
         ASSERT(length >= header.size());
@@ -149,6 +167,23 @@ TEST_F(HttpInspectorTest, InvalidHttpRequestLine) {
   file_event_callback_(Event::FileReadyType::Read);
 }
 
+TEST_F(HttpInspectorTest, RequestLineTooLong) {
+  init();
+  // A full peek buffer without the end of the request line.
+  const std::string header = "GET /" + std::string(Config::MAX_INSPECT_SIZE, 'a');
+
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(Invoke([&header](int, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+        memcpy(buffer, header.data(), length);
+        return Api::SysCallSizeResult{ssize_t(length), 0};
+      }));
+
+  EXPECT_CALL(socket_, setRequestedApplicationProtocols(_)).Times(0);
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().http_not_found_.value());
+}
+
 TEST_F(HttpInspectorTest, UnsupportedHttpProtocol) {
   init();
   const absl::string_view header = "GET /anything HTTP/0.9\r\n";
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/listen_socket_impl.h"
+#include "common/network/utility.h"
+
+#include "extensions/filters/listener/proxy_protocol/proxy_protocol.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "benchmark/benchmark.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace ProxyProtocol {
+
+class FastMockListenerFilterCallbacks : public Network::MockListenerFilterCallbacks {
+public:
+  FastMockListenerFilterCallbacks(Network::ConnectionSocket& socket, Event::Dispatcher& dispatcher)
+      : socket_(socket), dispatcher_(dispatcher) {}
+  Network::ConnectionSocket& socket() override { return socket_; }
+  Event::Dispatcher& dispatcher() override { return dispatcher_; }
+  void continueFilterChain(bool success) override { RELEASE_ASSERT(success, ""); }
+  void setDynamicMetadata(const std::string& name, const ProtobufWkt::Struct& value) override {
+    (*metadata_.mutable_filter_metadata())[name].MergeFrom(value);
+  }
+  const envoy::api::v2::core::Metadata& dynamicMetadata() const override { return metadata_; }
+
+  Network::ConnectionSocket& socket_;
+  Event::Dispatcher& dispatcher_;
+};
+
+// Don't inherit from the mock implementation at all, because this is instantiated
+// in the hot loop.
+class FastMockFileEvent : public Event::FileEvent {
+  void activate(uint32_t) override {}
+  void setEnabled(uint32_t) override {}
+};
+
+class FastMockDispatcher : public Event::MockDispatcher {
+public:
+  Event::FileEventPtr createFileEvent(int, Event::FileReadyCb cb, Event::FileTriggerType,
+                                      uint32_t) override {
+    file_event_callback_ = cb;
+    return std::make_unique<FastMockFileEvent>();
+  }
+
+  Event::FileReadyCb file_event_callback_;
+};
+
+// Returns the header followed by some data when peeked at, and consumes the header.
+class FastMockOsSysCalls : public Api::MockOsSysCalls {
+public:
+  FastMockOsSysCalls(const std::string& header) : data_(header + "GET / HTTP/1.1\r\n") {}
+
+  Api::SysCallSizeResult recv(int, void* buffer, size_t length, int) override {
+    length = std::min(length, data_.size());
+    memcpy(buffer, data_.data(), length);
+    return Api::SysCallSizeResult{ssize_t(length), 0};
+  }
+
+  const std::string data_;
+};
+
+static std::string tlv(uint8_t type, const std::string& value) {
+  const std::string header{char(type), char(value.size() >> 8), char(value.size() & 0xff)};
+  return header + value;
+}
+
+static std::string v2Header(const std::string& tlvs) {
+  std::string header("\x0d\x0a\x0d\x0a\x00\x0d\x0a\x51\x55\x49\x54\x0a\x21\x11", 14);
+  const size_t len = PROXY_PROTO_V2_ADDR_LEN_INET + tlvs.size();
+  header.push_back(len >> 8);
+  header.push_back(len & 0xff);
+  header.append("\x01\x02\x03\x04\x00\x01\x01\x02\x03\x05\x00\x02", 12);
+  return header + tlvs;
+}
+
+static void runProxyProtocol(benchmark::State& state, const std::string& header) {
+  NiceMock<FastMockOsSysCalls> os_sys_calls(header);
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls{&os_sys_calls};
+  NiceMock<Stats::MockStore> store;
+  ConfigSharedPtr cfg(std::make_shared<Config>(store));
+  Network::IoHandlePtr io_handle = std::make_unique<Network::IoSocketHandleImpl>();
+  Network::ConnectionSocketImpl socket(
+      std::move(io_handle), Network::Utility::parseInternetAddressAndPort("127.0.0.1:80"),
+      Network::Utility::parseInternetAddressAndPort("127.0.0.1:1234"));
+  NiceMock<FastMockDispatcher> dispatcher;
+  FastMockListenerFilterCallbacks cb(socket, dispatcher);
+
+  for (auto _ : state) {
+    Filter filter(cfg);
+    filter.onAccept(cb);
+    dispatcher.file_event_callback_(Event::FileReadyType::Read);
+  }
+}
+
+static void BM_ProxyProtocolV1(benchmark::State& state) {
+  runProxyProtocol(state, "PROXY TCP4 1.2.3.4 253.253.253.253 65535 1234\r\n");
+}
+BENCHMARK(BM_ProxyProtocolV1)->Unit(benchmark::kMicrosecond);
+
+static void BM_ProxyProtocolV2(benchmark::State& state) {
+  runProxyProtocol(state, v2Header(""));
+}
+BENCHMARK(BM_ProxyProtocolV2)->Unit(benchmark::kMicrosecond);
+
+// The header of an AWS PrivateLink connection, along with TLS details.
+static void BM_ProxyProtocolV2Tlvs(benchmark::State& state) {
+  runProxyProtocol(
+      state, v2Header(tlv(PROXY_PROTO_V2_TLV_AWS, "\x01vpce-08d2bf15fac5001c9") +
+                      tlv(PROXY_PROTO_V2_TLV_SSL,
+                          std::string("\x01\x00\x00\x00\x00", 5) +
+                              tlv(PROXY_PROTO_V2_TLV_SSL_VERSION, "TLSv1.2") +
+                              tlv(PROXY_PROTO_V2_TLV_SSL_CIPHER, "ECDHE-RSA-AES128-GCM-SHA256"))));
+}
+BENCHMARK(BM_ProxyProtocolV2Tlvs)->Unit(benchmark::kMicrosecond);
+
+} // namespace ProxyProtocol
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -6,6 +6,7 @@
 
 #include "common/buffer/buffer_impl.h"
 #include "common/event/dispatcher_impl.h"
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/network/listener_impl.h"
 #include "common/network/raw_buffer_socket.h"
@@ -67,14 +68,17 @@ public:
   Network::FilterChainFactory& filterChainFactory() override { return factory_; }
   Network::Socket& socket() override { return socket_; }
   const Network::Socket& socket() const override { return socket_; }
+  Network::Socket& workerSocket(uint32_t) override { return socket_; }
   bool bindToPort() override { return true; }
   bool handOffRestoredDestinationConnections() const override { return false; }
   uint32_t perConnectionBufferLimitBytes() const override { return 0; }
+  uint32_t perConnectionReadBudgetBytes() const override { return 0; }
   std::chrono::milliseconds listenerFiltersTimeout() const override {
     return std::chrono::milliseconds();
   }
   bool continueOnListenerFiltersTimeout() const override { return false; }
   Stats::Scope& listenerScope() override { return stats_store_; }
+  Network::ConnectionBalancer& connectionBalancer() override { return connection_balancer_; }
   uint64_t listenerTag() const override { return 1; }
   const std::string& name() const override { return name_; }
 
@@ -117,6 +121,26 @@ public:
     conn_->write(buf, false);
   }
 
+  // A well-formed ipv4/tcp v2 header from 1.2.3.4, followed by the given TLVs.
+  static std::string v2Header(const std::string& tlvs) {
+    std::string header("\x0d\x0a\x0d\x0a\x00\x0d\x0a\x51\x55\x49\x54\x0a\x21\x11", 14);
+    const size_t len = PROXY_PROTO_V2_ADDR_LEN_INET + tlvs.size();
+    header.push_back(len >> 8);
+    header.push_back(len & 0xff);
+    header.append("\x01\x02\x03\x04\x00\x01\x01\x02\x03\x05\x00\x02", 12);
+    return header + tlvs;
+  }
+
+  static std::string tlv(uint8_t type, const std::string& value) {
+    const std::string header{char(type), char(value.size() >> 8), char(value.size() & 0xff)};
+    return header + value;
+  }
+
+  const ProtobufWkt::Struct& proxyProtocolMetadata() {
+    return server_connection_->streamInfo().dynamicMetadata().filter_metadata().at(
+        "envoy.listener.proxy_protocol");
+  }
+
   void expectData(std::string expected) {
     EXPECT_CALL(*read_filter_, onNewConnection());
     EXPECT_CALL(*read_filter_, onData(_, _))
@@ -161,6 +185,7 @@ public:
   Network::MockConnectionCallbacks server_callbacks_;
   std::shared_ptr<Network::MockReadFilter> read_filter_;
   std::string name_;
+  Network::NopConnectionBalancerImpl connection_balancer_;
   const Network::FilterChainSharedPtr filter_chain_;
 };
 
@@ -268,12 +293,6 @@ TEST_P(ProxyProtocolTest, errorRecv_2) {
   EXPECT_CALL(os_sys_calls, recv(_, _, _, _))
       .Times(AnyNumber())
       .WillOnce(Return(Api::SysCallSizeResult{-1, 0}));
-  EXPECT_CALL(os_sys_calls, ioctl(_, _, _))
-      .Times(AnyNumber())
-      .WillRepeatedly(Invoke([](int fd, unsigned long int request, void* argp) {
-        const int rc = ::ioctl(fd, request, argp);
-        return Api::SysCallIntResult{rc, errno};
-      }));
   EXPECT_CALL(os_sys_calls, writev(_, _, _))
       .Times(AnyNumber())
       .WillRepeatedly(Invoke([](int fd, const struct iovec* iov, int iovcnt) {
@@ -294,15 +313,22 @@ TEST_P(ProxyProtocolTest, errorRecv_2) {
   expectProxyProtoError();
 }
 
-TEST_P(ProxyProtocolTest, errorFIONREAD_1) {
-  // A well formed v4/tcp message, no extensions, but introduce an error on ioctl(...FIONREAD...)
+TEST_P(ProxyProtocolTest, errorConsume_1) {
+  // A well formed v4/tcp message, no extensions, but introduce an error on the recv() consuming
+  // the peeked header
   constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
                                 0x54, 0x0a, 0x21, 0x11, 0x00, 0x0c, 0x01, 0x02, 0x03, 0x04,
                                 0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x00, 0x02, 'm',  'o',
                                 'r',  'e',  ' ',  'd',  'a',  't',  'a'};
   Api::MockOsSysCalls os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
-  EXPECT_CALL(os_sys_calls, ioctl(_, FIONREAD, _)).WillOnce(Return(Api::SysCallIntResult{-1, 0}));
+  EXPECT_CALL(os_sys_calls, recv(_, _, _, MSG_PEEK))
+      .Times(AnyNumber())
+      .WillRepeatedly(Invoke([](int fd, void* buf, size_t len, int flags) {
+        const ssize_t rc = ::recv(fd, buf, len, flags);
+        return Api::SysCallSizeResult{rc, errno};
+      }));
+  EXPECT_CALL(os_sys_calls, recv(_, _, 28, 0)).WillOnce(Return(Api::SysCallSizeResult{-1, 0}));
   EXPECT_CALL(os_sys_calls, writev(_, _, _))
       .Times(AnyNumber())
       .WillRepeatedly(Invoke([](int fd, const struct iovec* iov, int iovcnt) {
@@ -486,8 +512,9 @@ TEST_P(ProxyProtocolTest, v2ParseExtensions) {
   disconnect();
 }
 
-TEST_P(ProxyProtocolTest, v2ParseExtensionsIoctlError) {
-  // A well-formed ipv4/tcp with a TLV extension. An error is created in the ioctl(...FIONREAD...)
+TEST_P(ProxyProtocolTest, v2ParseExtensionsPeekError) {
+  // A well-formed ipv4/tcp with a TLV extension. An error is created in the recv() peeking at the
+  // header once the extension arrives
   constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
                                 0x54, 0x0a, 0x21, 0x11, 0x00, 0x10, 0x01, 0x02, 0x03, 0x04,
                                 0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x00, 0x02};
@@ -496,23 +523,16 @@ TEST_P(ProxyProtocolTest, v2ParseExtensionsIoctlError) {
   Api::MockOsSysCalls os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
 
-  EXPECT_CALL(os_sys_calls, ioctl(_, FIONREAD, _))
-      .Times(AnyNumber())
-      .WillRepeatedly(Invoke([](int fd, unsigned long int request, void* argp) {
-        int x = ::ioctl(fd, request, argp);
-        if (x == 0 && *static_cast<int*>(argp) == sizeof(tlv)) {
-          return Api::SysCallIntResult{-1, errno};
-        } else {
-          return Api::SysCallIntResult{x, errno};
-        }
-      }));
-
-  EXPECT_CALL(os_sys_calls, recv(_, _, _, _))
+  EXPECT_CALL(os_sys_calls, recv(_, _, _, MSG_PEEK))
       .Times(AnyNumber())
       .WillRepeatedly(Invoke([](int fd, void* buf, size_t len, int flags) {
         const ssize_t rc = ::recv(fd, buf, len, flags);
+        if (rc == sizeof(buffer) + sizeof(tlv)) {
+          return Api::SysCallSizeResult{-1, 0};
+        }
         return Api::SysCallSizeResult{rc, errno};
       }));
+  EXPECT_CALL(os_sys_calls, recv(_, _, _, 0)).Times(0);
 
   EXPECT_CALL(os_sys_calls, writev(_, _, _))
       .Times(AnyNumber())
@@ -535,6 +555,82 @@ TEST_P(ProxyProtocolTest, v2ParseExtensionsIoctlError) {
   expectProxyProtoError();
 }
 
+TEST_P(ProxyProtocolTest, v2ParseTlvs) {
+  // The well-known TLVs are set as dynamic metadata, the others are skipped over
+  const std::string ssl_tlv = tlv(PROXY_PROTO_V2_TLV_SSL,
+                                  std::string("\x07\x00\x00\x00\x00", 5) +
+                                      tlv(PROXY_PROTO_V2_TLV_SSL_VERSION, "TLSv1.3") +
+                                      tlv(PROXY_PROTO_V2_TLV_SSL_CN, "client") + tlv(0x2f, "x"));
+  connect();
+  write(v2Header(tlv(PROXY_PROTO_V2_TLV_ALPN, "h2") + tlv(0x00, "\xff") +
+                 tlv(PROXY_PROTO_V2_TLV_AUTHORITY, "example.com") +
+                 tlv(PROXY_PROTO_V2_TLV_UNIQUE_ID, "\xab\xcd") +
+                 tlv(PROXY_PROTO_V2_TLV_AWS, "\x01vpce-08d2bf15fac5001c9") + ssl_tlv) +
+        "DATA");
+  expectData("DATA");
+
+  EXPECT_EQ(server_connection_->remoteAddress()->ip()->addressAsString(), "1.2.3.4");
+  const auto& fields = proxyProtocolMetadata().fields();
+  EXPECT_EQ(5, fields.size());
+  EXPECT_EQ("h2", fields.at("alpn").string_value());
+  EXPECT_EQ("example.com", fields.at("authority").string_value());
+  EXPECT_EQ("abcd", fields.at("unique_id").string_value());
+  EXPECT_EQ("vpce-08d2bf15fac5001c9", fields.at("aws_vpce_id").string_value());
+  const auto& ssl_fields = fields.at("ssl").struct_value().fields();
+  EXPECT_TRUE(ssl_fields.at("client_ssl").bool_value());
+  EXPECT_TRUE(ssl_fields.at("client_cert_conn").bool_value());
+  EXPECT_TRUE(ssl_fields.at("client_cert_sess").bool_value());
+  EXPECT_TRUE(ssl_fields.at("verified").bool_value());
+  EXPECT_EQ("TLSv1.3", ssl_fields.at("version").string_value());
+  EXPECT_EQ("client", ssl_fields.at("cn").string_value());
+  EXPECT_EQ(0, ssl_fields.count("cipher"));
+  disconnect();
+}
+
+TEST_P(ProxyProtocolTest, v2ParseLargeTlvs) {
+  // A header larger than the initial peek is peeked again whole
+  const std::string authority(1000, 'a');
+  connect();
+  write(v2Header(tlv(PROXY_PROTO_V2_TLV_AUTHORITY, authority)) + "DATA");
+  expectData("DATA");
+
+  EXPECT_EQ(server_connection_->remoteAddress()->ip()->addressAsString(), "1.2.3.4");
+  EXPECT_EQ(authority, proxyProtocolMetadata().fields().at("authority").string_value());
+  disconnect();
+}
+
+TEST_P(ProxyProtocolTest, v2ParseTlvsFrag) {
+  // A header with TLVs larger than the initial peek, delivered in fragments
+  const std::string header = v2Header(tlv(PROXY_PROTO_V2_TLV_AUTHORITY, std::string(300, 'a')) +
+                                      tlv(PROXY_PROTO_V2_TLV_ALPN, "h2"));
+  connect();
+  write(header.substr(0, 200));
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  write(header.substr(200, 120));
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  write(header.substr(320) + "DATA");
+  expectData("DATA");
+
+  EXPECT_EQ(300, proxyProtocolMetadata().fields().at("authority").string_value().size());
+  EXPECT_EQ("h2", proxyProtocolMetadata().fields().at("alpn").string_value());
+  disconnect();
+}
+
+TEST_P(ProxyProtocolTest, v2MalformedTlv) {
+  // A TLV overrunning the header stops the parsing of the TLVs, but not the connection
+  std::string overrun = tlv(PROXY_PROTO_V2_TLV_AUTHORITY, "example.com");
+  overrun[2]++;
+  connect();
+  write(v2Header(tlv(PROXY_PROTO_V2_TLV_ALPN, "h2") + overrun) + "DATA");
+  expectData("DATA");
+
+  EXPECT_EQ(server_connection_->remoteAddress()->ip()->addressAsString(), "1.2.3.4");
+  const auto& fields = proxyProtocolMetadata().fields();
+  EXPECT_EQ(1, fields.size());
+  EXPECT_EQ("h2", fields.at("alpn").string_value());
+  disconnect();
+}
+
 TEST_P(ProxyProtocolTest, v2ParseExtensionsFrag) {
   // A well-formed ipv4/tcp header with 2 TLV/extensions, these are fragmented on delivery
   constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
@@ -618,7 +714,7 @@ TEST_P(ProxyProtocolTest, v2Fragmented2) {
 
 TEST_P(ProxyProtocolTest, v2Fragmented3Error) {
   // A well-formed ipv4/tcp header, delivering all of the signature +1, w/ an error
-  // simulated in recv() on the +1
+  // simulated in the recv() peeking at the rest
   constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
                                 0x54, 0x0a, 0x21, 0x11, 0x00, 0x0c, 0x01, 0x02, 0x03, 0x04,
                                 0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x00, 0x02, 'm',  'o',
@@ -627,22 +723,14 @@ TEST_P(ProxyProtocolTest, v2Fragmented3Error) {
   Api::MockOsSysCalls os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
 
-  EXPECT_CALL(os_sys_calls, recv(_, _, _, _))
-      .Times(AnyNumber())
-      .WillRepeatedly(Invoke([](int fd, void* buf, size_t len, int flags) {
+  EXPECT_CALL(os_sys_calls, recv(_, _, _, MSG_PEEK))
+      .WillOnce(Invoke([](int fd, void* buf, size_t len, int flags) {
         const ssize_t rc = ::recv(fd, buf, len, flags);
         return Api::SysCallSizeResult{rc, errno};
-      }));
-  EXPECT_CALL(os_sys_calls, recv(_, _, 1, _))
-      .Times(AnyNumber())
+      }))
       .WillOnce(Return(Api::SysCallSizeResult{-1, 0}));
+  EXPECT_CALL(os_sys_calls, recv(_, _, _, 0)).Times(0);
 
-  EXPECT_CALL(os_sys_calls, ioctl(_, _, _))
-      .Times(AnyNumber())
-      .WillRepeatedly(Invoke([](int fd, unsigned long int request, void* argp) {
-        const int rc = ::ioctl(fd, request, argp);
-        return Api::SysCallIntResult{rc, errno};
-      }));
   EXPECT_CALL(os_sys_calls, writev(_, _, _))
       .Times(AnyNumber())
       .WillRepeatedly(Invoke([](int fd, const struct iovec* iov, int iovcnt) {
@@ -658,13 +746,15 @@ TEST_P(ProxyProtocolTest, v2Fragmented3Error) {
 
   connect(false);
   write(buffer, 17);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  write(buffer + 17, 20);
 
   expectProxyProtoError();
 }
 
 TEST_P(ProxyProtocolTest, v2Fragmented4Error) {
   // A well-formed ipv4/tcp header, part of the signature with an error introduced
-  // in recv() on the remainder
+  // in the recv() consuming the header, as it comes up short
   constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
                                 0x54, 0x0a, 0x21, 0x11, 0x00, 0x0c, 0x01, 0x02, 0x03, 0x04,
                                 0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x00, 0x02, 'm',  'o',
@@ -673,22 +763,17 @@ TEST_P(ProxyProtocolTest, v2Fragmented4Error) {
   Api::MockOsSysCalls os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
 
-  EXPECT_CALL(os_sys_calls, recv(_, _, _, _))
+  EXPECT_CALL(os_sys_calls, recv(_, _, _, MSG_PEEK))
       .Times(AnyNumber())
       .WillRepeatedly(Invoke([](int fd, void* buf, size_t len, int flags) {
         const ssize_t rc = ::recv(fd, buf, len, flags);
         return Api::SysCallSizeResult{rc, errno};
       }));
-  EXPECT_CALL(os_sys_calls, recv(_, _, 4, _))
-      .Times(AnyNumber())
-      .WillOnce(Return(Api::SysCallSizeResult{-1, 0}));
+  EXPECT_CALL(os_sys_calls, recv(_, _, 28, 0)).WillOnce(Invoke([](int fd, void* buf, size_t, int) {
+    const ssize_t rc = ::recv(fd, buf, 4, 0);
+    return Api::SysCallSizeResult{rc, errno};
+  }));
 
-  EXPECT_CALL(os_sys_calls, ioctl(_, _, _))
-      .Times(AnyNumber())
-      .WillRepeatedly(Invoke([](int fd, unsigned long int request, void* argp) {
-        const int rc = ::ioctl(fd, request, argp);
-        return Api::SysCallIntResult{rc, errno};
-      }));
   EXPECT_CALL(os_sys_calls, writev(_, _, _))
       .Times(AnyNumber())
       .WillRepeatedly(Invoke([](int fd, const struct iovec* iov, int iovcnt) {
@@ -705,7 +790,7 @@ TEST_P(ProxyProtocolTest, v2Fragmented4Error) {
   connect(false);
   write(buffer, 10);
   dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
-  write(buffer + 10, 10);
+  write(buffer + 10, 27);
 
   expectProxyProtoError();
 }
@@ -896,14 +981,17 @@ public:
   Network::FilterChainFactory& filterChainFactory() override { return factory_; }
   Network::Socket& socket() override { return socket_; }
   const Network::Socket& socket() const override { return socket_; }
+  Network::Socket& workerSocket(uint32_t) override { return socket_; }
   bool bindToPort() override { return true; }
   bool handOffRestoredDestinationConnections() const override { return false; }
   uint32_t perConnectionBufferLimitBytes() const override { return 0; }
+  uint32_t perConnectionReadBudgetBytes() const override { return 0; }
   std::chrono::milliseconds listenerFiltersTimeout() const override {
     return std::chrono::milliseconds();
   }
   bool continueOnListenerFiltersTimeout() const override { return false; }
   Stats::Scope& listenerScope() override { return stats_store_; }
+  Network::ConnectionBalancer& connectionBalancer() override { return connection_balancer_; }
   uint64_t listenerTag() const override { return 1; }
   const std::string& name() const override { return name_; }
 
@@ -968,6 +1056,7 @@ public:
   Network::MockConnectionCallbacks server_callbacks_;
   std::shared_ptr<Network::MockReadFilter> read_filter_;
   std::string name_;
+  Network::NopConnectionBalancerImpl connection_balancer_;
   const Network::FilterChainSharedPtr filter_chain_;
 };
 
@@ -0,0 +1,116 @@
+#include <string>
+#include <vector>
+
+#include "extensions/filters/listener/tls_inspector/client_hello_parser.h"
+
+#include "test/extensions/filters/listener/tls_inspector/tls_utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace TlsInspector {
+namespace {
+
+using Result = ClientHelloParser::Result;
+
+std::string u16(size_t value) { return {static_cast<char>(value >> 8), static_cast<char>(value)}; }
+
+// A minimal ClientHello record with the given wire-format extensions.
+std::vector<uint8_t> clientHelloWithExtensions(const std::string& extensions) {
+  const std::string body = "\x03\x03" + std::string(32, 'r') + std::string("\x00", 1) + u16(2) +
+                           std::string("\x13\x01", 2) + std::string("\x01\x00", 2) +
+                           u16(extensions.size()) + extensions;
+  const std::string handshake = "\x01" + std::string("\x00", 1) + u16(body.size()) + body;
+  const std::string record = "\x16\x03\x01" + u16(handshake.size()) + handshake;
+  return {record.begin(), record.end()};
+}
+
+std::string serverNameExtension(const std::string& name) {
+  return u16(0) + u16(name.size() + 5) + u16(name.size() + 3) + std::string("\x00", 1) +
+         u16(name.size()) + name;
+}
+
+Result parse(const std::vector<uint8_t>& data, ClientHello& client_hello) {
+  return ClientHelloParser::parse(data.data(), data.size(), client_hello);
+}
+
+// The SNI and ALPN of a ClientHello are parsed.
+TEST(ClientHelloParserTest, SniAndAlpn) {
+  const std::vector<uint8_t> data = Tls::Test::generateClientHello("example.com", "\x02h2");
+  ClientHello client_hello;
+  ASSERT_EQ(Result::Complete, parse(data, client_hello));
+  EXPECT_EQ("example.com", client_hello.server_name_);
+  EXPECT_EQ(std::string("\x00\x03\x02h2", 5), client_hello.alpn_);
+}
+
+// A ClientHello without SNI nor ALPN is parsed.
+TEST(ClientHelloParserTest, NoSniNorAlpn) {
+  const std::vector<uint8_t> data = Tls::Test::generateClientHello("", "");
+  ClientHello client_hello;
+  ASSERT_EQ(Result::Complete, parse(data, client_hello));
+  EXPECT_TRUE(client_hello.server_name_.empty());
+  EXPECT_TRUE(client_hello.alpn_.empty());
+}
+
+// Every prefix of a ClientHello needs more data.
+TEST(ClientHelloParserTest, Incomplete) {
+  const std::vector<uint8_t> data = Tls::Test::generateClientHello("example.com", "\x02h2");
+  ClientHello client_hello;
+  for (size_t len = 0; len < data.size(); len++) {
+    EXPECT_EQ(Result::Incomplete, ClientHelloParser::parse(data.data(), len, client_hello)) << len;
+  }
+}
+
+// ClientHellos spanning several records are left to BoringSSL, once the first record is received.
+TEST(ClientHelloParserTest, Fragmented) {
+  const std::vector<uint8_t> data =
+      Tls::Test::fragmentClientHello(Tls::Test::generateClientHello("example.com", ""), 20);
+  ClientHello client_hello;
+  EXPECT_EQ(Result::Incomplete, ClientHelloParser::parse(data.data(), 24, client_hello));
+  EXPECT_EQ(Result::Unsupported, ClientHelloParser::parse(data.data(), 25, client_hello));
+}
+
+// Data which is not a TLS handshake is left to BoringSSL as soon as possible.
+TEST(ClientHelloParserTest, NotTls) {
+  const std::string request = "GET / HTTP/1.1\r\n";
+  ClientHello client_hello;
+  EXPECT_EQ(Result::Unsupported,
+            ClientHelloParser::parse(reinterpret_cast<const uint8_t*>(request.data()), 1,
+                                     client_hello));
+  const std::vector<uint8_t> zeros(100);
+  EXPECT_EQ(Result::Unsupported, parse(zeros, client_hello));
+}
+
+// The extensions BoringSSL rejects are left to it.
+TEST(ClientHelloParserTest, MalformedExtensions) {
+  ClientHello client_hello;
+  EXPECT_EQ(Result::Complete,
+            parse(clientHelloWithExtensions(serverNameExtension("example.com")), client_hello));
+  EXPECT_EQ("example.com", client_hello.server_name_);
+
+  // A name with a NUL.
+  EXPECT_EQ(Result::Unsupported,
+            parse(clientHelloWithExtensions(serverNameExtension(std::string("a\0b", 3))),
+                  client_hello));
+  // An empty name.
+  EXPECT_EQ(Result::Unsupported,
+            parse(clientHelloWithExtensions(serverNameExtension("")), client_hello));
+  // Duplicate extensions.
+  EXPECT_EQ(Result::Unsupported,
+            parse(clientHelloWithExtensions(serverNameExtension("a") + serverNameExtension("b")),
+                  client_hello));
+  // An empty protocol name.
+  EXPECT_EQ(Result::Unsupported,
+            parse(clientHelloWithExtensions(u16(16) + u16(3) + u16(1) + std::string("\x00", 1)),
+                  client_hello));
+  // A truncated extension.
+  EXPECT_EQ(Result::Unsupported, parse(clientHelloWithExtensions(u16(16) + u16(3)), client_hello));
+}
+
+} // namespace
+} // namespace TlsInspector
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
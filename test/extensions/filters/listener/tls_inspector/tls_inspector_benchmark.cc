@@ -72,9 +72,8 @@ public:
   const std::vector<uint8_t> client_hello_;
 };
 
-static void BM_TlsInspector(benchmark::State& state) {
-  NiceMock<FastMockOsSysCalls> os_sys_calls(
-      Tls::Test::generateClientHello("example.com", "\x02h2\x08http/1.1"));
+static void runTlsInspector(benchmark::State& state, const std::vector<uint8_t>& client_hello) {
+  NiceMock<FastMockOsSysCalls> os_sys_calls(client_hello);
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls{&os_sys_calls};
   NiceMock<Stats::MockStore> store;
   ConfigSharedPtr cfg(std::make_shared<Config>(store));
@@ -98,8 +97,20 @@ static void BM_TlsInspector(benchmark::State& state) {
   }
 }
 
+// The ClientHello is parsed by the ClientHelloParser.
+static void BM_TlsInspector(benchmark::State& state) {
+  runTlsInspector(state, Tls::Test::generateClientHello("example.com", "\x02h2\x08http/1.1"));
+}
 BENCHMARK(BM_TlsInspector)->Unit(benchmark::kMicrosecond);
 
+// The ClientHello spans two records, so is parsed by BoringSSL.
+static void BM_TlsInspectorFallback(benchmark::State& state) {
+  const std::vector<uint8_t> client_hello =
+      Tls::Test::generateClientHello("example.com", "\x02h2\x08http/1.1");
+  runTlsInspector(state, Tls::Test::fragmentClientHello(client_hello, 20));
+}
+BENCHMARK(BM_TlsInspectorFallback)->Unit(benchmark::kMicrosecond);
+
 } // namespace TlsInspector
 } // namespace ListenerFilters
 } // namespace Extensions
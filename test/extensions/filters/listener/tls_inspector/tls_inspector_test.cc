@@ -171,6 +171,41 @@ TEST_F(TlsInspectorTest, MultipleReads) {
   EXPECT_EQ(1, cfg_->stats().alpn_found_.value());
 }
 
+// Test that a ClientHello spanning several records is parsed by BoringSSL.
+TEST_F(TlsInspectorTest, FragmentedClientHello) {
+  init();
+  const std::vector<absl::string_view> alpn_protos = {absl::string_view("h2")};
+  const std::string servername("example.com");
+  std::vector<uint8_t> client_hello =
+      Tls::Test::fragmentClientHello(Tls::Test::generateClientHello(servername, "\x02h2"), 20);
+  {
+    InSequence s;
+    // The first record, after which the ClientHello is known to be fragmented.
+    EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+        .WillOnce(
+            Invoke([&client_hello](int, void* buffer, size_t, int) -> Api::SysCallSizeResult {
+              memcpy(buffer, client_hello.data(), 25);
+              return Api::SysCallSizeResult{ssize_t(25), 0};
+            }));
+    EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+        .WillOnce(Invoke(
+            [&client_hello](int, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+              ASSERT(length >= client_hello.size());
+              memcpy(buffer, client_hello.data(), client_hello.size());
+              return Api::SysCallSizeResult{ssize_t(client_hello.size()), 0};
+            }));
+  }
+  EXPECT_CALL(socket_, setRequestedServerName(Eq(servername)));
+  EXPECT_CALL(socket_, setRequestedApplicationProtocols(alpn_protos));
+  EXPECT_CALL(socket_, setDetectedTransportProtocol(absl::string_view("tls")));
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().tls_found_.value());
+  EXPECT_EQ(1, cfg_->stats().sni_found_.value());
+  EXPECT_EQ(1, cfg_->stats().alpn_found_.value());
+}
+
 // Test that the filter correctly handles a ClientHello with no extensions present.
 TEST_F(TlsInspectorTest, NoExtensions) {
   init();
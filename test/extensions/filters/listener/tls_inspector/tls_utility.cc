@@ -39,6 +39,24 @@ std::vector<uint8_t> generateClientHello(const std::string& sni_name, const std:
   return buf;
 }
 
+std::vector<uint8_t> fragmentClientHello(const std::vector<uint8_t>& client_hello,
+                                         size_t first_fragment_len) {
+  const size_t header_len = SSL3_RT_HEADER_LENGTH;
+  ASSERT(client_hello.size() > header_len + first_fragment_len);
+  std::vector<uint8_t> buf;
+  const auto append_record = [&](size_t offset, size_t len) {
+    // The content type and version of the original record.
+    buf.insert(buf.end(), client_hello.begin(), client_hello.begin() + 3);
+    buf.push_back(len >> 8);
+    buf.push_back(len & 0xff);
+    buf.insert(buf.end(), client_hello.begin() + offset, client_hello.begin() + offset + len);
+  };
+  append_record(header_len, first_fragment_len);
+  append_record(header_len + first_fragment_len,
+                client_hello.size() - header_len - first_fragment_len);
+  return buf;
+}
+
 } // namespace Test
 } // namespace Tls
 } // namespace Envoy
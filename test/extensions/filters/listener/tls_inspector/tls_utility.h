@@ -16,6 +16,14 @@ namespace Test {
  */
 std::vector<uint8_t> generateClientHello(const std::string& sni_name, const std::string& alpn);
 
+/**
+ * Split a ClientHello generated by generateClientHello() across two TLS records.
+ * @param client_hello The ClientHello, in a single record.
+ * @param first_fragment_len The length of the part of the handshake message in the first record.
+ */
+std::vector<uint8_t> fragmentClientHello(const std::vector<uint8_t>& client_hello,
+                                         size_t first_fragment_len);
+
 } // namespace Test
 } // namespace Tls
 } // namespace Envoy
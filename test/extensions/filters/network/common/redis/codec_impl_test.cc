@@ -9,6 +9,7 @@
 #include "test/test_common/printers.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "gtest/gtest.h"
 
 using testing::InSequence;
@@ -178,6 +179,57 @@ TEST_F(RedisEncoderDecoderImplTest, BulkString) {
   EXPECT_EQ(0UL, buffer_.length());
 }
 
+TEST_F(RedisEncoderDecoderImplTest, LargeBulkString) {
+  const std::string body(DecoderImpl::MIN_BUFFERED_BULK_STRING_LENGTH * 3, 'a');
+  const std::string encoded =
+      absl::StrCat("*2\r\n$", body.size(), "\r\n", body, "\r\n$3\r\nfoo\r\n");
+  // The body spans several slices, the middle one being moved rather than copied.
+  const uint64_t slice_length = DecoderImpl::MIN_BUFFERED_BULK_STRING_LENGTH + 16;
+  for (uint64_t i = 0; i < encoded.size(); i += slice_length) {
+    Buffer::OwnedImpl slice(encoded.substr(i, slice_length));
+    buffer_.move(slice);
+  }
+  decoder_.decode(buffer_);
+  EXPECT_EQ(0UL, buffer_.length());
+  ASSERT_EQ(1UL, decoded_values_.size());
+  const RespValue& value = *decoded_values_[0];
+  ASSERT_EQ(RespType::Array, value.type());
+  ASSERT_NE(nullptr, value.asArray()[0].bulkStringBuffer());
+  EXPECT_EQ(body.size(), value.asArray()[0].bulkStringBuffer()->length());
+  EXPECT_EQ(nullptr, value.asArray()[1].bulkStringBuffer());
+  EXPECT_EQ("foo", value.asArray()[1].asString());
+
+  // Copies share the buffer.
+  RespValue copy = value;
+  EXPECT_EQ(value.asArray()[0].bulkStringBuffer(), copy.asArray()[0].bulkStringBuffer());
+
+  // The encoded data references the buffer, which outlives the values.
+  Buffer::OwnedImpl out;
+  encoder_.encode(value, out);
+  decoded_values_.clear();
+  EXPECT_EQ(encoded, out.toString());
+
+  // Accessing the string copies the content to it.
+  EXPECT_EQ(body, copy.asArray()[0].asString());
+  EXPECT_EQ(nullptr, copy.asArray()[0].bulkStringBuffer());
+  Buffer::OwnedImpl copy_out;
+  encoder_.encode(copy, copy_out);
+  EXPECT_EQ(encoded, copy_out.toString());
+}
+
+TEST_F(RedisEncoderDecoderImplTest, LargeBulkStringFragmented) {
+  const std::string body(DecoderImpl::MIN_BUFFERED_BULK_STRING_LENGTH, 'a');
+  const std::string encoded = absl::StrCat("$", body.size(), "\r\n", body, "\r\n");
+  for (char c : encoded) {
+    buffer_.add(&c, 1);
+    decoder_.decode(buffer_);
+    EXPECT_EQ(0UL, buffer_.length());
+  }
+  ASSERT_EQ(1UL, decoded_values_.size());
+  ASSERT_NE(nullptr, decoded_values_[0]->bulkStringBuffer());
+  EXPECT_EQ(body, decoded_values_[0]->asString());
+}
+
 TEST_F(RedisEncoderDecoderImplTest, Integer) {
   RespValue value;
   value.type(RespType::Integer);
@@ -301,6 +353,12 @@ TEST_F(RedisEncoderDecoderImplTest, InvalidBulkStringExpectLF) {
   EXPECT_THROW(decoder_.decode(buffer_), ProtocolError);
 }
 
+TEST_F(RedisEncoderDecoderImplTest, InvalidLargeBulkStringExpectCR) {
+  buffer_.add(absl::StrCat("$", DecoderImpl::MIN_BUFFERED_BULK_STRING_LENGTH, "\r\n",
+                           std::string(DecoderImpl::MIN_BUFFERED_BULK_STRING_LENGTH + 1, 'a')));
+  EXPECT_THROW(decoder_.decode(buffer_), ProtocolError);
+}
+
 } // namespace Redis
 } // namespace Common
 } // namespace NetworkFilters
@@ -0,0 +1,89 @@
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/network/dubbo_proxy/dubbo_protocol_impl.h"
+#include "extensions/filters/network/dubbo_proxy/hessian_utils.h"
+
+#include "test/extensions/filters/network/dubbo_proxy/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace DubboProxy {
+namespace {
+
+/**
+ * Builds a two way hessian2 request, whose string argument and attachment values are of the given
+ * size.
+ */
+std::string buildRequest(size_t argument_size) {
+  Buffer::OwnedImpl body;
+  HessianUtils::writeString(body, "2.0.2");
+  HessianUtils::writeString(body, "org.apache.dubbo.demo.DemoService");
+  HessianUtils::writeString(body, "0.0.0");
+  HessianUtils::writeString(body, "sayHello");
+  HessianUtils::writeString(body, "Ljava/lang/String;");
+  HessianUtils::writeString(body, std::string(argument_size, 'a'));
+  // The attachments, an untyped map.
+  body.add("H");
+  for (const std::string key : {"path", "interface", "version", "timeout"}) {
+    HessianUtils::writeString(body, key);
+    HessianUtils::writeString(body, std::string(argument_size, 'v'));
+  }
+  body.add("Z");
+
+  Buffer::OwnedImpl message;
+  message.add(std::string({'\xda', '\xbb', '\xc2', 0x00}));
+  addInt64(message, 1);
+  addInt32(message, body.length());
+  message.move(body);
+  return message.toString();
+}
+
+/**
+ * Measures the decoding of a request by the dubbo protocol and the hessian2 serializer, which only
+ * deserialize the fields preceding the method name whatever the size of the rest of the body.
+ */
+static void DubboDecodeRequest(benchmark::State& state) {
+  const std::string request = buildRequest(state.range(0));
+  DubboProtocolImpl protocol;
+  protocol.initSerializer(SerializationType::Hessian2);
+  for (auto _ : state) {
+    Buffer::OwnedImpl buffer(request);
+    auto metadata = std::make_shared<MessageMetadata>();
+    auto result = protocol.decodeHeader(buffer, metadata);
+    buffer.drain(result.first->header_size());
+    protocol.decodeData(buffer, result.first, metadata);
+    benchmark::DoNotOptimize(metadata->invocation_info().method_name());
+  }
+}
+BENCHMARK(DubboDecodeRequest)->Arg(16)->Arg(1024)->Arg(65536);
+
+/**
+ * Measures the encoding of a response carrying a string value.
+ */
+static void DubboEncodeResponse(benchmark::State& state) {
+  const std::string content(state.range(0), 'a');
+  MessageMetadata metadata;
+  metadata.setMessageType(MessageType::Response);
+  metadata.setResponseStatus(ResponseStatus::Ok);
+  metadata.setSerializationType(SerializationType::Hessian2);
+  metadata.setRequestId(1);
+  DubboProtocolImpl protocol;
+  protocol.initSerializer(SerializationType::Hessian2);
+  for (auto _ : state) {
+    Buffer::OwnedImpl buffer;
+    protocol.encode(buffer, metadata, content, RpcResponseType::ResponseWithValue);
+    benchmark::DoNotOptimize(buffer.length());
+  }
+}
+BENCHMARK(DubboEncodeResponse)->Arg(16)->Arg(1024)->Arg(65536);
+
+} // namespace
+} // namespace DubboProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
+
+BENCHMARK_MAIN();
@@ -130,6 +130,36 @@ TEST(HessianUtilsTest, peekString) {
   }
 }
 
+TEST(HessianUtilsTest, peekStringSize) {
+  {
+    Buffer::OwnedImpl buffer;
+    buffer.add(std::string({0x05, 'h', 'e', 'l', 'l', 'o', 0x01, 't'}));
+    EXPECT_EQ(6, HessianUtils::peekStringSize(buffer));
+    EXPECT_EQ(2, HessianUtils::peekStringSize(buffer, 6));
+  }
+
+  {
+    Buffer::OwnedImpl buffer;
+    buffer.add(std::string(
+        {0x52, 0x00, 0x07, 'h', 'e', 'l', 'l', 'o', ',', ' ', 0x05, 'w', 'o', 'r', 'l', 'd'}));
+    EXPECT_EQ(16, HessianUtils::peekStringSize(buffer));
+  }
+
+  {
+    Buffer::OwnedImpl buffer;
+    buffer.add(std::string({0x52, 0x00, 0x07, 'h', 'e', 'l', 'l', 'o', ',', ' '}));
+    EXPECT_THROW_WITH_MESSAGE(HessianUtils::peekStringSize(buffer), EnvoyException,
+                              "buffer underflow");
+  }
+
+  {
+    Buffer::OwnedImpl buffer;
+    buffer.add(std::string({0x20, 't'}));
+    EXPECT_THROW_WITH_MESSAGE(HessianUtils::peekStringSize(buffer), EnvoyException,
+                              "hessian type is not string 32");
+  }
+}
+
 TEST(HessianUtilsTest, peekLong) {
   // Insufficient data
   {
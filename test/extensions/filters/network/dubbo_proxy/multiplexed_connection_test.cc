@@ -0,0 +1,269 @@
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/network/dubbo_proxy/router/multiplexed_connection.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/tcp/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::InSequence;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace DubboProxy {
+namespace Router {
+namespace {
+
+class MockMultiplexedRequestCallbacks : public MultiplexedRequestCallbacks {
+public:
+  MOCK_METHOD2(onPoolFailure, void(Tcp::ConnectionPool::PoolFailureReason reason,
+                                   Upstream::HostDescriptionConstSharedPtr host));
+  void onPoolReady(MultiplexedRequestPtr&& request,
+                   Upstream::HostDescriptionConstSharedPtr) override {
+    request_ = std::move(request);
+    request_->addUpstreamCallbacks(upstream_callbacks_);
+  }
+
+  MultiplexedRequestPtr request_;
+  NiceMock<Tcp::ConnectionPool::MockUpstreamCallbacks> upstream_callbacks_;
+};
+
+// Encodes a message with a hessian2 serialized body.
+void writeMessage(Buffer::Instance& buffer, uint8_t flag, int64_t request_id,
+                  const std::string& body) {
+  buffer.writeBEInt<uint16_t>(0xdabb);
+  buffer.writeByte(static_cast<uint8_t>(flag | 0x02));
+  buffer.writeByte(20);
+  buffer.writeBEInt<int64_t>(request_id);
+  buffer.writeBEInt<uint32_t>(body.size());
+  buffer.add(body);
+}
+
+void writeRequest(Buffer::Instance& buffer, int64_t request_id) {
+  writeMessage(buffer, 0xc0, request_id, "request");
+}
+
+void writeResponse(Buffer::Instance& buffer, int64_t request_id) {
+  writeMessage(buffer, 0x00, request_id, "response");
+}
+
+int64_t requestId(Buffer::Instance& buffer) { return buffer.peekBEInt<int64_t>(4); }
+
+class DubboMultiplexedConnectionTest : public testing::Test {
+public:
+  DubboMultiplexedConnectionTest() {
+    ON_CALL(*pool_.connection_data_, addUpstreamCallbacks(_))
+        .WillByDefault(Invoke([this](Tcp::ConnectionPool::UpstreamCallbacks& callbacks) -> void {
+          upstream_callbacks_ = &callbacks;
+        }));
+    ON_CALL(connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) -> void {
+          written_.push_back(data.toString());
+          data.drain(data.length());
+        }));
+  }
+
+  void startRequests(std::vector<MockMultiplexedRequestCallbacks>& callbacks) {
+    EXPECT_CALL(pool_, newConnection(_));
+    for (auto& cb : callbacks) {
+      EXPECT_NE(nullptr, registry_.connection(pool_).newRequest(cb));
+    }
+    pool_.poolReady(connection_);
+    for (auto& cb : callbacks) {
+      ASSERT_NE(nullptr, cb.request_);
+    }
+  }
+
+  void onUpstreamData(Buffer::Instance& data) {
+    ASSERT_NE(nullptr, upstream_callbacks_);
+    upstream_callbacks_->onUpstreamData(data, false);
+  }
+
+  NiceMock<Tcp::ConnectionPool::MockInstance> pool_;
+  NiceMock<Network::MockClientConnection> connection_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  MultiplexedConnectionRegistry registry_{dispatcher_};
+  Tcp::ConnectionPool::UpstreamCallbacks* upstream_callbacks_{};
+  std::vector<std::string> written_;
+};
+
+TEST_F(DubboMultiplexedConnectionTest, SharesConnectionAndMatchesResponses) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(2);
+  startRequests(callbacks);
+
+  // Both downstream requests use the same id.
+  Buffer::OwnedImpl request;
+  writeRequest(request, 100);
+  callbacks[0].request_->write(request, true);
+  writeRequest(request, 100);
+  callbacks[1].request_->write(request, true);
+
+  ASSERT_EQ(2, written_.size());
+  Buffer::OwnedImpl written(written_[0]);
+  EXPECT_EQ(0, requestId(written));
+  written.drain(written.length());
+  written.add(written_[1]);
+  EXPECT_EQ(1, requestId(written));
+
+  // A request started once connected does not wait for the pool.
+  MockMultiplexedRequestCallbacks third;
+  EXPECT_EQ(nullptr, registry_.connection(pool_).newRequest(third));
+  ASSERT_NE(nullptr, third.request_);
+
+  // Responses are received out of order, with a partial message first.
+  Buffer::OwnedImpl response;
+  writeResponse(response, 1);
+  writeResponse(response, 0);
+  Buffer::OwnedImpl partial;
+  partial.move(response, 20);
+
+  EXPECT_CALL(callbacks[0].upstream_callbacks_, onUpstreamData(_, _)).Times(0);
+  EXPECT_CALL(callbacks[1].upstream_callbacks_, onUpstreamData(_, _)).Times(0);
+  onUpstreamData(partial);
+
+  InSequence s;
+  EXPECT_CALL(callbacks[1].upstream_callbacks_, onUpstreamData(_, false))
+      .WillOnce(Invoke([](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ(100, requestId(data));
+        EXPECT_EQ(24, data.length());
+      }));
+  EXPECT_CALL(callbacks[0].upstream_callbacks_, onUpstreamData(_, false))
+      .WillOnce(Invoke([](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ(100, requestId(data));
+      }));
+  partial.move(response);
+  onUpstreamData(partial);
+
+  // The connection is released with the last request.
+  EXPECT_CALL(pool_, released(_)).Times(0);
+  callbacks[0].request_.reset();
+  callbacks[1].request_.reset();
+  EXPECT_CALL(pool_, released(_));
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  third.request_.reset();
+}
+
+TEST_F(DubboMultiplexedConnectionTest, KeepsConnectionUntilAbandonedResponse) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(1);
+  startRequests(callbacks);
+
+  Buffer::OwnedImpl request;
+  writeRequest(request, 100);
+  callbacks[0].request_->write(request, true);
+
+  EXPECT_CALL(pool_, released(_)).Times(0);
+  callbacks[0].request_.reset();
+
+  // Responses of unknown requests are dropped.
+  Buffer::OwnedImpl response;
+  writeResponse(response, 7);
+  onUpstreamData(response);
+
+  EXPECT_CALL(pool_, released(_));
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  writeResponse(response, 0);
+  onUpstreamData(response);
+}
+
+TEST_F(DubboMultiplexedConnectionTest, ReleasesConnectionAfterOnewayRequest) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(1);
+  startRequests(callbacks);
+
+  Buffer::OwnedImpl request;
+  writeMessage(request, 0x80, 100, "request");
+  callbacks[0].request_->write(request, false);
+
+  EXPECT_CALL(pool_, released(_));
+  callbacks[0].request_.reset();
+}
+
+TEST_F(DubboMultiplexedConnectionTest, AnswersHeartbeats) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(1);
+  startRequests(callbacks);
+
+  Buffer::OwnedImpl heartbeat;
+  writeMessage(heartbeat, 0xe0, 42, "");
+  EXPECT_CALL(callbacks[0].upstream_callbacks_, onUpstreamData(_, _)).Times(0);
+  onUpstreamData(heartbeat);
+
+  ASSERT_EQ(1, written_.size());
+  Buffer::OwnedImpl written(written_[0]);
+  EXPECT_EQ(16, written.length());
+  EXPECT_EQ(0x22, written.peekInt<uint8_t>(2));
+  EXPECT_EQ(42, requestId(written));
+}
+
+TEST_F(DubboMultiplexedConnectionTest, ClosesConnectionOnInvalidMagicNumber) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(1);
+  startRequests(callbacks);
+
+  Buffer::OwnedImpl response;
+  response.add(std::string(16, 'x'));
+  EXPECT_CALL(connection_, close(Network::ConnectionCloseType::NoFlush));
+  onUpstreamData(response);
+}
+
+TEST_F(DubboMultiplexedConnectionTest, NotifiesRequestsOnClose) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(2);
+  startRequests(callbacks);
+
+  EXPECT_CALL(callbacks[0].upstream_callbacks_, onEvent(Network::ConnectionEvent::RemoteClose))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { callbacks[0].request_.reset(); }));
+  EXPECT_CALL(callbacks[1].upstream_callbacks_, onEvent(Network::ConnectionEvent::RemoteClose));
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
+
+  // Writing on a closed connection is a no-op.
+  Buffer::OwnedImpl request;
+  writeRequest(request, 100);
+  callbacks[1].request_->write(request, true);
+  EXPECT_EQ(0, request.length());
+  EXPECT_TRUE(written_.empty());
+  callbacks[1].request_.reset();
+
+  // The next request opens a new connection.
+  MockMultiplexedRequestCallbacks next;
+  EXPECT_CALL(pool_, newConnection(_));
+  EXPECT_NE(nullptr, registry_.connection(pool_).newRequest(next));
+}
+
+TEST_F(DubboMultiplexedConnectionTest, NotifiesPendingRequestsOnPoolFailure) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(2);
+  EXPECT_CALL(pool_, newConnection(_));
+  EXPECT_NE(nullptr, registry_.connection(pool_).newRequest(callbacks[0]));
+  EXPECT_NE(nullptr, registry_.connection(pool_).newRequest(callbacks[1]));
+
+  for (auto& cb : callbacks) {
+    EXPECT_CALL(cb, onPoolFailure(Tcp::ConnectionPool::PoolFailureReason::Timeout, _));
+  }
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  pool_.poolFailure(Tcp::ConnectionPool::PoolFailureReason::Timeout);
+}
+
+TEST_F(DubboMultiplexedConnectionTest, CancelsConnectionWithLastPendingRequest) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(2);
+  EXPECT_CALL(pool_, newConnection(_));
+  Tcp::ConnectionPool::Cancellable* first = registry_.connection(pool_).newRequest(callbacks[0]);
+  Tcp::ConnectionPool::Cancellable* second = registry_.connection(pool_).newRequest(callbacks[1]);
+
+  EXPECT_CALL(pool_.handles_.front(), cancel(_)).Times(0);
+  first->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+
+  EXPECT_CALL(pool_.handles_.front(), cancel(Tcp::ConnectionPool::CancelPolicy::Default));
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  second->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+}
+
+} // namespace
+} // namespace Router
+} // namespace DubboProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -38,6 +38,19 @@ TEST(DubboProxyRouterFilterConfigTest, RouterFilterWithEmptyProtoConfig) {
   cb(filter_callback);
 }
 
+TEST(DubboProxyRouterFilterConfigTest, RouterWithMultiplexedUpstreamConnections) {
+  envoy::config::filter::dubbo::router::v2alpha1::Router router_config;
+  router_config.set_multiplex_upstream_connections(true);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  RouterFilterConfig factory;
+  EXPECT_CALL(context.thread_local_, allocateSlot());
+  DubboFilters::FilterFactoryCb cb =
+      factory.createFilterFactoryFromProto(router_config, "stats", context);
+  DubboFilters::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addDecoderFilter(_));
+  cb(filter_callback);
+}
+
 TEST(DubboProxyRouterFilterConfigTest, DoubleRegistrationTest) {
   EXPECT_THROW_WITH_MESSAGE(
       (Registry::RegisterFactory<RouterFilterConfig,
@@ -6,6 +6,7 @@
 #include "extensions/filters/network/dubbo_proxy/serializer_impl.h"
 
 #include "test/extensions/filters/network/dubbo_proxy/mocks.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/test_common/printers.h"
@@ -81,11 +82,11 @@ public:
         }),
         serializer_register_(serializer_factory_), protocol_register_(protocol_factory_) {}
 
-  void initializeRouter() {
+  void initializeRouter(MultiplexedConnectionRegistry* multiplexed_connections = nullptr) {
     route_ = new NiceMock<MockRoute>();
     route_ptr_.reset(route_);
 
-    router_ = std::make_unique<Router>(context_.clusterManager());
+    router_ = std::make_unique<Router>(context_.clusterManager(), multiplexed_connections);
 
     EXPECT_EQ(nullptr, router_->downstreamConnection());
 
@@ -436,6 +437,56 @@ TEST_F(DubboRouterTest, Call) {
   destroyRouter();
 }
 
+TEST_F(DubboRouterTest, CallWithMultiplexedConnection) {
+  NiceMock<Event::MockDispatcher> dispatcher;
+  MultiplexedConnectionRegistry registry(dispatcher);
+  initializeRouter(&registry);
+  initializeMetadata(MessageType::Request);
+
+  Buffer::Instance& request = message_context_->message_origin_data();
+  request.writeBEInt<uint16_t>(0xdabb);
+  request.writeByte(0xc2);
+  request.writeByte(0);
+  request.writeBEInt<int64_t>(42);
+  request.writeBEInt<uint32_t>(0);
+  std::static_pointer_cast<ContextImpl>(message_context_)->set_header_size(16);
+
+  EXPECT_CALL(callbacks_, route()).WillOnce(Return(route_ptr_));
+  EXPECT_CALL(*route_, routeEntry()).WillOnce(Return(&route_entry_));
+  EXPECT_CALL(route_entry_, clusterName()).WillRepeatedly(ReturnRef(cluster_name_));
+  EXPECT_CALL(callbacks_, serializationType()).WillOnce(Return(SerializationType::Hessian2));
+  EXPECT_CALL(callbacks_, protocolType()).WillOnce(Return(ProtocolType::Dubbo));
+  EXPECT_EQ(FilterStatus::StopIteration, router_->onMessageDecoded(metadata_, message_context_));
+
+  // The request id is unique on the upstream connection.
+  EXPECT_CALL(upstream_connection_, write(_, false))
+      .WillOnce(Invoke([](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ(16, data.length());
+        EXPECT_EQ(0, data.peekBEInt<int64_t>(4));
+        data.drain(data.length());
+      }));
+  connectUpstream();
+
+  Buffer::OwnedImpl response;
+  response.writeBEInt<uint16_t>(0xdabb);
+  response.writeByte(0x02);
+  response.writeByte(20);
+  response.writeBEInt<int64_t>(0);
+  response.writeBEInt<uint32_t>(0);
+
+  EXPECT_CALL(callbacks_, startUpstreamResponse());
+  EXPECT_CALL(callbacks_, upstreamData(_))
+      .WillOnce(Invoke([](Buffer::Instance& data) -> DubboFilters::UpstreamResponseStatus {
+        EXPECT_EQ(42, data.peekBEInt<int64_t>(4));
+        return DubboFilters::UpstreamResponseStatus::Complete;
+      }));
+  EXPECT_CALL(context_.cluster_manager_.tcp_conn_pool_, released(Ref(upstream_connection_)));
+  EXPECT_CALL(dispatcher, deferredDelete_(_));
+  upstream_callbacks_->onUpstreamData(response, false);
+
+  destroyRouter();
+}
+
 TEST_F(DubboRouterTest, DecoderFilterCallbacks) {
   initializeRouter();
   initializeMetadata(MessageType::Request);
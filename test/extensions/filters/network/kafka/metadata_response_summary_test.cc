@@ -0,0 +1,145 @@
+#include "extensions/filters/network/kafka/metadata_response_summary.h"
+#include "extensions/filters/network/kafka/response_codec.h"
+
+#include "test/extensions/filters/network/kafka/buffer_based_test.h"
+#include "test/extensions/filters/network/kafka/serialization_utilities.h"
+#include "test/mocks/server/mocks.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace MetadataResponseSummaryTest {
+
+using ResponseCapturingCallback =
+    CapturingCallback<ResponseCallback, AbstractResponseSharedPtr, ResponseMetadataSharedPtr>;
+
+class MetadataResponseSummaryTest : public testing::TestWithParam<int16_t>,
+                                    public BufferBasedTest {
+protected:
+  /**
+   * Puts a metadata response into the buffer, with two brokers and two topics: "a" with a led
+   * partition and a partition without leader, and "b" that does not exist.
+   */
+  void putMetadataResponse(const int16_t api_version, const int32_t correlation_id) {
+    Buffer::OwnedImpl response;
+    EncodingContext encoder{api_version};
+    encoder.encode(correlation_id, response);
+    if (api_version >= 3) {
+      encoder.encode(int32_t{0}, response); // throttle_time_ms
+    }
+    encoder.encode(int32_t{2}, response); // brokers
+    putBroker(encoder, 1, "broker1", 9092, response);
+    putBroker(encoder, 2, "broker2", 9093, response);
+    if (api_version >= 2) {
+      encoder.encode(NullableString{"cluster-id"}, response);
+    }
+    if (api_version >= 1) {
+      encoder.encode(int32_t{1}, response); // controller_id
+    }
+    encoder.encode(int32_t{2}, response); // topics
+    putTopicHeader(encoder, 0, "a", response);
+    encoder.encode(int32_t{2}, response); // partitions
+    putPartition(encoder, 0, 0, 2, response);
+    putPartition(encoder, 5, 1, -1, response); // LEADER_NOT_AVAILABLE
+    putTopicHeader(encoder, 3, "b", response); // UNKNOWN_TOPIC_OR_PARTITION
+    encoder.encode(int32_t{0}, response);      // partitions
+
+    putIntoBuffer(static_cast<int32_t>(response.length()));
+    buffer_.move(response);
+  }
+
+  void putBroker(EncodingContext& encoder, const int32_t node_id, const std::string& host,
+                 const int32_t port, Buffer::Instance& response) {
+    encoder.encode(node_id, response);
+    encoder.encode(host, response);
+    encoder.encode(port, response);
+    if (encoder.apiVersion() >= 1) {
+      encoder.encode(NullableString{absl::nullopt}, response); // rack
+    }
+  }
+
+  void putTopicHeader(EncodingContext& encoder, const int16_t error_code, const std::string& name,
+                      Buffer::Instance& response) {
+    encoder.encode(error_code, response);
+    encoder.encode(name, response);
+    if (encoder.apiVersion() >= 1) {
+      encoder.encode(false, response); // is_internal
+    }
+  }
+
+  void putPartition(EncodingContext& encoder, const int16_t error_code, const int32_t partition,
+                    const int32_t leader, Buffer::Instance& response) {
+    encoder.encode(error_code, response);
+    encoder.encode(partition, response);
+    encoder.encode(leader, response);
+    if (encoder.apiVersion() >= 7) {
+      encoder.encode(int32_t{0}, response); // leader_epoch
+    }
+    encoder.encode(std::vector<int32_t>{1, 2}, response); // replica_nodes
+    encoder.encode(std::vector<int32_t>{2}, response);    // isr_nodes
+    if (encoder.apiVersion() >= 5) {
+      encoder.encode(std::vector<int32_t>{1}, response); // offline_replicas
+    }
+  }
+
+  const std::shared_ptr<ResponseCapturingCallback> callback_{
+      std::make_shared<ResponseCapturingCallback>()};
+  ResponseDecoder testee_{std::make_shared<ResponseInitialParserFactory>(),
+                          MetadataResponseSummaryParserResolver::getDefaultInstance(),
+                          {callback_}};
+};
+
+TEST_P(MetadataResponseSummaryTest, shouldParseBrokersAndLeaders) {
+  // given
+  const int16_t api_version = GetParam();
+  putMetadataResponse(api_version, 42);
+  testee_.expectResponse(METADATA_API_KEY, api_version);
+
+  // when
+  testee_.onData(buffer_);
+
+  // then
+  ASSERT_EQ(callback_->getParseFailures().size(), 0);
+  const std::vector<AbstractResponseSharedPtr>& responses = callback_->getCapturedMessages();
+  ASSERT_EQ(responses.size(), 1);
+  const auto* response = dynamic_cast<const Response<MetadataResponseSummary>*>(responses[0].get());
+  ASSERT_NE(response, nullptr);
+  ASSERT_EQ(response->metadata_.correlation_id_, 42);
+
+  const MetadataResponseSummary expected = {
+      {{1, "broker1", 9092}, {2, "broker2", 9093}},
+      {{0, "a", {{0, 0, 2}, {5, 1, -1}}}, {3, "b", std::vector<PartitionLeaderSummary>{}}}};
+  ASSERT_EQ(response->data(), expected);
+
+  // The dropped fields can not be encoded back.
+  Buffer::OwnedImpl output;
+  EXPECT_THROW(response->encode(output), EnvoyException);
+}
+
+INSTANTIATE_TEST_SUITE_P(MetadataVersions, MetadataResponseSummaryTest,
+                         testing::Values(0, 1, 2, 3, 4, 5, 6, 7));
+
+TEST_F(MetadataResponseSummaryTest, shouldDelegateOtherResponses) {
+  // given
+  const ResponseMetadata metadata = {100, 0, 0};
+  const std::vector<unsigned char> data = std::vector<unsigned char>(1024);
+  ResponseEncoder{buffer_}.encode(Response<std::vector<unsigned char>>{metadata, data});
+  testee_.expectResponse(100, 0);
+
+  // when
+  testee_.onData(buffer_);
+
+  // then
+  ASSERT_EQ(callback_->getCapturedMessages().size(), 0);
+  ASSERT_EQ(callback_->getParseFailures().size(), 1);
+  ASSERT_EQ(*(callback_->getParseFailures()[0]), metadata);
+}
+
+} // namespace MetadataResponseSummaryTest
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,90 @@
+#include "extensions/filters/network/kafka/partition_leader_router.h"
+
+#include "test/mocks/server/mocks.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace PartitionLeaderRouterTest {
+
+class PartitionLeaderRouterTest : public testing::Test {
+protected:
+  AbstractResponseSharedPtr makeMetadataResponse(std::vector<BrokerSummary> brokers,
+                                                 std::vector<TopicLeadersSummary> topics) {
+    const ResponseMetadata metadata = {METADATA_API_KEY, 7, 0};
+    return std::make_shared<Response<MetadataResponseSummary>>(
+        metadata, MetadataResponseSummary{std::move(brokers), std::move(topics)});
+  }
+
+  const std::vector<BrokerSummary> brokers_{{1, "broker1", 9092}, {2, "broker2", 9093}};
+  PartitionLeaderRouter testee_;
+};
+
+TEST_F(PartitionLeaderRouterTest, shouldFindLeadersOfPartitions) {
+  // given
+  testee_.onMessage(makeMetadataResponse(brokers_, {{0, "a", {{0, 0, 1}, {0, 1, 2}, {5, 2, -1}}}}));
+
+  // when, then
+  ASSERT_NE(testee_.leader("a", 0), nullptr);
+  EXPECT_EQ(*testee_.leader("a", 0), brokers_[0]);
+  ASSERT_NE(testee_.leader("a", 1), nullptr);
+  EXPECT_EQ(*testee_.leader("a", 1), brokers_[1]);
+  // Leader election in progress.
+  EXPECT_EQ(testee_.leader("a", 2), nullptr);
+  EXPECT_EQ(testee_.leader("a", 3), nullptr);
+  EXPECT_EQ(testee_.leader("b", 0), nullptr);
+}
+
+TEST_F(PartitionLeaderRouterTest, shouldReplaceLeadersOfListedTopics) {
+  // given
+  testee_.onMessage(makeMetadataResponse(
+      brokers_, {{0, "a", {{0, 0, 1}}}, {0, "b", {{0, 0, 1}}}, {0, "c", {{0, 0, 1}}}}));
+
+  // when
+  testee_.update({{brokers_[1]}, {{0, "a", {{0, 0, 2}}}, {3, "b", {}}}});
+
+  // then
+  ASSERT_NE(testee_.leader("a", 0), nullptr);
+  EXPECT_EQ(testee_.leader("a", 0)->node_id_, 2);
+  // Deleted.
+  EXPECT_EQ(testee_.leader("b", 0), nullptr);
+  // Not listed, but led by a broker that is gone.
+  EXPECT_EQ(testee_.leader("c", 0), nullptr);
+}
+
+TEST_F(PartitionLeaderRouterTest, shouldRouteProduceRequestsToSingleLeader) {
+  // given
+  testee_.update({brokers_, {{0, "a", {{0, 0, 1}, {0, 1, 2}}}, {0, "b", {{0, 0, 1}}}}});
+
+  // when, then
+  const BrokerSummary* leader =
+      testee_.leader(ProduceRequestSummary{1, 1000, {{"a", {{0, 10}}}, {"b", {{0, 10}}}}});
+  ASSERT_NE(leader, nullptr);
+  EXPECT_EQ(*leader, brokers_[0]);
+
+  // Partitions led by different brokers.
+  EXPECT_EQ(testee_.leader(ProduceRequestSummary{1, 1000, {{"a", {{0, 10}, {1, 10}}}}}), nullptr);
+  // Unknown partition.
+  EXPECT_EQ(testee_.leader(ProduceRequestSummary{1, 1000, {{"a", {{0, 10}, {7, 10}}}}}), nullptr);
+}
+
+TEST_F(PartitionLeaderRouterTest, shouldIgnoreOtherResponses) {
+  // given
+  const ResponseMetadata metadata = {METADATA_API_KEY, 7, 0};
+
+  // when
+  testee_.onMessage(std::make_shared<Response<int32_t>>(metadata, 0));
+  testee_.onFailedParse(std::make_shared<ResponseMetadata>(metadata));
+
+  // then
+  EXPECT_EQ(testee_.leader("a", 0), nullptr);
+}
+
+} // namespace PartitionLeaderRouterTest
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
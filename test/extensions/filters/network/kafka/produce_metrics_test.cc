@@ -0,0 +1,114 @@
+#include "extensions/filters/network/kafka/produce_metrics.h"
+#include "extensions/filters/network/kafka/produce_request_summary.h"
+
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Property;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace ProduceMetricsTest {
+
+class ProduceMetricsTest : public testing::Test {
+protected:
+  AbstractRequestSharedPtr makeRequest(const int32_t correlation_id, const int16_t acks) {
+    const RequestHeader header = {PRODUCE_REQUEST_API_KEY, 3, correlation_id, "client-id"};
+    const ProduceRequestSummary data = {
+        acks, 1000, {{"a", {{0, 1000}, {1, 24}}}, {"b", {{0, 10}, {1, -1}}}}};
+    return std::make_shared<Request<ProduceRequestSummary>>(header, data);
+  }
+
+  AbstractResponseSharedPtr makeResponse(const int32_t correlation_id) {
+    return std::make_shared<Response<int32_t>>(ResponseMetadata{0, 0, correlation_id}, 0);
+  }
+
+  uint64_t gaugeValue() {
+    return store_.gauge("kafka.produce_requests_in_flight", Stats::Gauge::ImportMode::Accumulate)
+        .value();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  testing::NiceMock<Stats::MockIsolatedStatsStore> store_;
+  ProduceStatsSharedPtr stats_{std::make_shared<ProduceStats>(store_, "kafka.")};
+  std::unique_ptr<ProduceMetrics> testee_{std::make_unique<ProduceMetrics>(stats_, time_system_)};
+};
+
+TEST_F(ProduceMetricsTest, shouldChargeProducedBytesPerTopic) {
+  // given
+  const AbstractRequestSharedPtr request = makeRequest(1, 1);
+
+  // when
+  testee_->onMessage(request);
+  testee_->onMessage(makeRequest(2, 0));
+
+  // then
+  EXPECT_EQ(store_.counter("kafka.topic.a.produce_bytes").value(), 2048);
+  EXPECT_EQ(store_.counter("kafka.topic.b.produce_bytes").value(), 20);
+  // The request without acknowledgement is not waited for.
+  EXPECT_EQ(gaugeValue(), 1);
+}
+
+TEST_F(ProduceMetricsTest, shouldRecordLatencyOfPipelinedRequests) {
+  // given
+  testee_->onMessage(makeRequest(1, 1));
+  time_system_.sleep(std::chrono::milliseconds(5));
+  testee_->onMessage(makeRequest(2, -1));
+  EXPECT_EQ(gaugeValue(), 2);
+  time_system_.sleep(std::chrono::milliseconds(10));
+
+  // when, then
+  EXPECT_CALL(store_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name, "kafka.topic.a.produce_latency_ms"), 15));
+  EXPECT_CALL(store_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name, "kafka.topic.b.produce_latency_ms"), 15));
+  testee_->onMessage(makeResponse(1));
+  EXPECT_EQ(gaugeValue(), 1);
+
+  EXPECT_CALL(store_, deliverHistogramToSinks(_, 10)).Times(2);
+  testee_->onFailedParse(std::make_shared<ResponseMetadata>(0, 0, 2));
+  EXPECT_EQ(gaugeValue(), 0);
+
+  // A response to nothing charges nothing.
+  EXPECT_CALL(store_, deliverHistogramToSinks(_, _)).Times(0);
+  testee_->onMessage(makeResponse(3));
+  EXPECT_EQ(gaugeValue(), 0);
+}
+
+TEST_F(ProduceMetricsTest, shouldIgnoreOtherRequests) {
+  // given
+  const RequestHeader header = {PRODUCE_REQUEST_API_KEY, 3, 1, "client-id"};
+  // Decoded in full, as the default resolver does.
+  const AbstractRequestSharedPtr request = std::make_shared<Request<int32_t>>(header, 0);
+
+  // when
+  testee_->onMessage(request);
+
+  // then
+  EXPECT_EQ(gaugeValue(), 0);
+}
+
+TEST_F(ProduceMetricsTest, shouldReleaseRequestsInFlightWhenDestroyed) {
+  // given
+  testee_->onMessage(makeRequest(1, 1));
+  testee_->onMessage(makeRequest(2, 1));
+  EXPECT_EQ(gaugeValue(), 2);
+
+  // when
+  testee_.reset();
+
+  // then
+  EXPECT_EQ(gaugeValue(), 0);
+}
+
+} // namespace ProduceMetricsTest
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,135 @@
+#include "extensions/filters/network/kafka/produce_request_summary.h"
+#include "extensions/filters/network/kafka/request_codec.h"
+
+#include "test/extensions/filters/network/kafka/buffer_based_test.h"
+#include "test/extensions/filters/network/kafka/serialization_utilities.h"
+#include "test/mocks/server/mocks.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace ProduceRequestSummaryTest {
+
+using RequestCapturingCallback =
+    CapturingCallback<RequestCallback, AbstractRequestSharedPtr, RequestParseFailureSharedPtr>;
+
+class ProduceRequestSummaryTest : public testing::Test, public BufferBasedTest {
+protected:
+  /**
+   * Puts a produce request into the buffer, with a record set of 1000 bytes and a null one for
+   * topic "a" and a record set of 10 bytes for topic "b".
+   * @return the size of the request, without its length.
+   */
+  uint32_t putProduceRequest(const int16_t api_version, const int32_t correlation_id) {
+    Buffer::OwnedImpl request;
+    EncodingContext encoder{api_version};
+    encoder.encode(PRODUCE_REQUEST_API_KEY, request);
+    encoder.encode(api_version, request);
+    encoder.encode(correlation_id, request);
+    encoder.encode(NullableString{"client-id"}, request);
+    if (api_version >= 3) {
+      encoder.encode(NullableString{"transactional-id"}, request);
+    }
+    encoder.encode(int16_t{1}, request);   // acks
+    encoder.encode(int32_t{1000}, request); // timeout
+    encoder.encode(int32_t{2}, request);    // topics
+    encoder.encode(std::string{"a"}, request);
+    encoder.encode(int32_t{2}, request); // partitions
+    encoder.encode(int32_t{0}, request);
+    encoder.encode(NullableBytes{Bytes(1000)}, request);
+    encoder.encode(int32_t{1}, request);
+    encoder.encode(NullableBytes{absl::nullopt}, request);
+    encoder.encode(std::string{"b"}, request);
+    encoder.encode(int32_t{1}, request); // partitions
+    encoder.encode(int32_t{0}, request);
+    encoder.encode(NullableBytes{Bytes(10)}, request);
+
+    const uint32_t size = request.length();
+    putIntoBuffer(static_cast<int32_t>(size));
+    buffer_.move(request);
+    return size;
+  }
+
+  const std::vector<TopicProduceSummary> expected_topics_{{"a", {{0, 1000}, {1, -1}}},
+                                                          {"b", {{0, 10}}}};
+  const std::shared_ptr<RequestCapturingCallback> callback_{
+      std::make_shared<RequestCapturingCallback>()};
+  RequestDecoder testee_{InitialParserFactory::getDefaultInstance(),
+                         ProduceRequestSummaryParserResolver::getDefaultInstance(),
+                         {callback_}};
+};
+
+TEST_F(ProduceRequestSummaryTest, shouldParseProduceRequestsWithoutRecordSets) {
+  // given
+  const uint32_t size_v2 = putProduceRequest(2, 1);
+  const uint32_t size_v3 = putProduceRequest(3, 2);
+
+  // when
+  testee_.onData(buffer_);
+
+  // then
+  ASSERT_EQ(callback_->getParseFailures().size(), 0);
+  const std::vector<AbstractRequestSharedPtr>& requests = callback_->getCapturedMessages();
+  ASSERT_EQ(requests.size(), 2);
+
+  const auto* request_v2 = dynamic_cast<const Request<ProduceRequestSummary>*>(requests[0].get());
+  ASSERT_NE(request_v2, nullptr);
+  ASSERT_EQ(request_v2->request_header_.correlation_id_, 1);
+  ASSERT_EQ(request_v2->data(), ProduceRequestSummary(1, 1000, expected_topics_));
+  ASSERT_EQ(request_v2->computeSize(), size_v2);
+
+  const auto* request_v3 = dynamic_cast<const Request<ProduceRequestSummary>*>(requests[1].get());
+  ASSERT_NE(request_v3, nullptr);
+  ASSERT_EQ(request_v3->data(),
+            ProduceRequestSummary({"transactional-id"}, 1, 1000, expected_topics_));
+  ASSERT_EQ(request_v3->computeSize(), size_v3);
+  ASSERT_EQ(request_v3->data().topics_[0].recordSetBytes(), 1000);
+
+  // The record sets are not kept.
+  Buffer::OwnedImpl output;
+  EXPECT_THROW(request_v3->encode(output), EnvoyException);
+}
+
+TEST_F(ProduceRequestSummaryTest, shouldParseProduceRequestFedByteByByte) {
+  // given
+  putProduceRequest(7, 1);
+
+  // when
+  while (buffer_.length() > 0) {
+    Buffer::OwnedImpl chunk;
+    chunk.move(buffer_, 1);
+    testee_.onData(chunk);
+  }
+
+  // then
+  const std::vector<AbstractRequestSharedPtr>& requests = callback_->getCapturedMessages();
+  ASSERT_EQ(requests.size(), 1);
+  const auto* request = dynamic_cast<const Request<ProduceRequestSummary>*>(requests[0].get());
+  ASSERT_NE(request, nullptr);
+  ASSERT_EQ(request->data().topics_, expected_topics_);
+}
+
+TEST_F(ProduceRequestSummaryTest, shouldDelegateOtherRequests) {
+  // given
+  // Unknown to the default resolver.
+  const RequestHeader header = {100, 0, 0, "client-id"};
+  const std::vector<unsigned char> data = std::vector<unsigned char>(1024);
+  RequestEncoder{buffer_}.encode(Request<std::vector<unsigned char>>{header, data});
+
+  // when
+  testee_.onData(buffer_);
+
+  // then
+  ASSERT_EQ(callback_->getCapturedMessages().size(), 0);
+  ASSERT_EQ(callback_->getParseFailures().size(), 1);
+  ASSERT_EQ(callback_->getParseFailures()[0]->request_header_, header);
+}
+
+} // namespace ProduceRequestSummaryTest
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
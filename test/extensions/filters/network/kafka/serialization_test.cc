@@ -29,6 +29,7 @@ TEST_EmptyDeserializerShouldNotBeReady(StringDeserializer);
 TEST_EmptyDeserializerShouldNotBeReady(NullableStringDeserializer);
 TEST_EmptyDeserializerShouldNotBeReady(BytesDeserializer);
 TEST_EmptyDeserializerShouldNotBeReady(NullableBytesDeserializer);
+TEST_EmptyDeserializerShouldNotBeReady(NullableBytesLengthDeserializer);
 
 TEST(ArrayDeserializer, EmptyBufferShouldNotBeReady) {
   // given
@@ -159,6 +160,53 @@ TEST(NullableBytesDeserializer, ShouldDeserializeNullBytes) {
   serializeThenDeserializeAndCheckEquality<NullableBytesDeserializer>(value);
 }
 
+TEST(NullableBytesLengthDeserializer, ShouldSkipBytes) {
+  // given
+  Buffer::OwnedImpl buffer;
+  const uint32_t written = encoder.encode(NullableBytes{{'a', 'b', 'c', 'd'}}, buffer);
+  encoder.encode(NullableBytes(absl::nullopt), buffer);
+  const absl::string_view orig_data = {getRawData(buffer), buffer.length()};
+
+  // when
+  NullableBytesLengthDeserializer testee;
+  absl::string_view data = orig_data;
+  uint32_t consumed = 0;
+  for (uint32_t i = 0; i < written; ++i) {
+    data = {data.data(), 1}; // Consume data byte-by-byte.
+    consumed += testee.feed(data);
+  }
+
+  // then
+  ASSERT_EQ(consumed, written);
+  ASSERT_EQ(testee.ready(), true);
+  ASSERT_EQ(testee.get(), 4);
+
+  // when - 2
+  NullableBytesLengthDeserializer testee2;
+  data = {orig_data.data() + written, orig_data.size() - written};
+  const uint32_t consumed2 = testee2.feed(data);
+
+  // then - 2
+  ASSERT_EQ(consumed2, sizeof(int32_t));
+  ASSERT_EQ(testee2.ready(), true);
+  ASSERT_EQ(testee2.get(), -1);
+}
+
+TEST(NullableBytesLengthDeserializer, ShouldThrowOnInvalidLength) {
+  // given
+  NullableBytesLengthDeserializer testee;
+  Buffer::OwnedImpl buffer;
+
+  const int32_t bytes_length = -2; // -1 is OK for NULLABLE_BYTES.
+  encoder.encode(bytes_length, buffer);
+
+  absl::string_view data = {getRawData(buffer), 1024};
+
+  // when
+  // then
+  EXPECT_THROW(testee.feed(data), EnvoyException);
+}
+
 TEST(NullableBytesDeserializer, ShouldThrowOnInvalidLength) {
   // given
   NullableBytesDeserializer testee;
@@ -52,6 +52,80 @@ TEST(BsonImplTest, InvalodDocumentTermination) {
   EXPECT_THROW(DocumentImpl::create(buffer), EnvoyException);
 }
 
+TEST(BsonImplTest, Decode) {
+  DocumentSharedPtr doc = DocumentImpl::create()
+                              ->addString("string", "hello")
+                              ->addInt32("int32", 1)
+                              ->addDocument("document", DocumentImpl::create()->addInt64("a", 2))
+                              ->addArray("array", DocumentImpl::create()->addBoolean("0", true))
+                              ->addNull("null")
+                              ->addRegex("regex", {"^a", "i"})
+                              ->addDouble("double", 3.5)
+                              ->addBinary("binary", std::string("\0\1", 2));
+  Buffer::OwnedImpl buffer;
+  doc->encode(buffer);
+  buffer.add("rest");
+
+  DocumentSharedPtr decoded = DocumentImpl::create(buffer);
+  EXPECT_EQ("rest", buffer.toString());
+  EXPECT_EQ(doc->byteSize(), decoded->byteSize());
+  EXPECT_EQ(1, decoded->find("int32")->asInt32());
+  EXPECT_EQ(nullptr, decoded->find("int32", Field::Type::INT64));
+  EXPECT_EQ(nullptr, decoded->find("missing"));
+  EXPECT_EQ(2, decoded->find("document", Field::Type::DOCUMENT)->asDocument().find("a")->asInt64());
+  EXPECT_EQ(std::string("\0\1", 2), decoded->find("binary")->asBinary());
+  EXPECT_TRUE(*doc == *decoded);
+  EXPECT_EQ(doc->toString(), decoded->toString());
+  EXPECT_EQ("hello", decoded->find("string")->asString());
+}
+
+// A decoded document is encoded again as it was received, until it is modified.
+TEST(BsonImplTest, EncodeDecoded) {
+  Buffer::OwnedImpl buffer;
+  DocumentImpl::create()->addBinary("binary", "a")->addString("hello", "world")->encode(buffer);
+  std::string encoded = buffer.toString();
+  // A binary subtype other than zero, which is not kept by the decoded fields.
+  encoded[sizeof(int32_t) + 1 + sizeof("binary") + sizeof(int32_t)] = 0x4;
+
+  Buffer::OwnedImpl input(encoded);
+  DocumentSharedPtr decoded = DocumentImpl::create(input);
+  Buffer::OwnedImpl output;
+  decoded->encode(output);
+  EXPECT_EQ(encoded, output.toString());
+
+  decoded->addInt32("added", 1);
+  output.drain(output.length());
+  decoded->encode(output);
+  EXPECT_EQ(decoded->byteSize(), output.length());
+  DocumentSharedPtr decoded_again = DocumentImpl::create(output);
+  EXPECT_TRUE(*decoded == *decoded_again);
+  EXPECT_EQ(1, decoded_again->find("added")->asInt32());
+}
+
+TEST(BsonImplTest, InvalidSubDocument) {
+  Buffer::OwnedImpl buffer;
+  DocumentImpl::create()->addDocument("doc", DocumentImpl::create())->encode(buffer);
+  std::string encoded = buffer.toString();
+  // The length of the sub-document is made to run past the end of the document.
+  encoded[sizeof(int32_t) + 1 + sizeof("doc")] = 0x10;
+  Buffer::OwnedImpl input(encoded);
+  EXPECT_THROW(DocumentImpl::create(input), EnvoyException);
+}
+
+TEST(BufferHelperTest, RemoveAcrossSlices) {
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest("hel");
+  buffer.appendSliceForTest(absl::string_view("lo\0wo", 5));
+  buffer.appendSliceForTest(absl::string_view("rld\0", 4));
+  BufferHelper::writeInt32(buffer, 3);
+  buffer.appendSliceForTest(absl::string_view("ab", 2));
+  buffer.appendSliceForTest(absl::string_view("\0", 1));
+  EXPECT_EQ("hello", BufferHelper::removeCString(buffer));
+  EXPECT_EQ("world", BufferHelper::removeCString(buffer));
+  EXPECT_EQ("ab", BufferHelper::removeString(buffer));
+  EXPECT_EQ(0, buffer.length());
+}
+
 TEST(BufferHelperTest, InvalidSize) {
   {
     Buffer::OwnedImpl buffer;
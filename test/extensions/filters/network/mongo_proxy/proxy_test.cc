@@ -82,9 +82,9 @@ public:
   }
 
   void initializeFilter(bool emit_dynamic_metadata = false) {
-    filter_ = std::make_unique<TestProxyFilter>("test.", store_, runtime_, access_log_,
-                                                fault_config_, drain_decision_,
-                                                dispatcher_.timeSource(), emit_dynamic_metadata);
+    filter_ = std::make_unique<TestProxyFilter>(
+        "test.", store_, runtime_, access_log_, fault_config_, drain_decision_,
+        dispatcher_.timeSource(), emit_dynamic_metadata, mongo_stats_);
     filter_->initializeReadFilterCallbacks(read_filter_callbacks_);
     filter_->onNewConnection();
 
@@ -114,6 +114,7 @@ public:
 
   Buffer::OwnedImpl fake_data_;
   NiceMock<TestStatStore> store_;
+  MongoStatsSharedPtr mongo_stats_{std::make_shared<MongoStats>(store_, "test.")};
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Event::MockDispatcher> dispatcher_;
   std::shared_ptr<Envoy::AccessLog::MockAccessLogFile> file_{
@@ -280,6 +281,38 @@ TEST_F(MongoProxyFilterTest, DynamicMetadataDisabled) {
                    NetworkFilterNames::get().MongoProxy));
 }
 
+// Once a collection and callsite have been seen, charging their stats does not encode any name.
+TEST_F(MongoProxyFilterTest, StatNamesEncodedOnce) {
+  initializeFilter();
+
+  auto query_and_reply = [this]() {
+    EXPECT_CALL(*filter_->decoder_, onData(_)).WillOnce(Invoke([&](Buffer::Instance&) -> void {
+      QueryMessagePtr message(new QueryMessageImpl(0, 0));
+      message->fullCollectionName("db.test");
+      message->query(Bson::DocumentImpl::create()->addString(
+          "$comment", R"EOF({"callingFunction":"getByMongoId"})EOF"));
+      filter_->callbacks_->decodeQuery(std::move(message));
+    }));
+    filter_->onData(fake_data_, false);
+
+    EXPECT_CALL(*filter_->decoder_, onData(_)).WillOnce(Invoke([&](Buffer::Instance&) -> void {
+      ReplyMessagePtr message(new ReplyMessageImpl(0, 0));
+      filter_->callbacks_->decodeReply(std::move(message));
+    }));
+    filter_->onWrite(fake_data_, false);
+  };
+
+  query_and_reply();
+  const uint64_t dynamic_encodings = mongo_stats_->dynamicEncodings();
+  EXPECT_EQ(2U, dynamic_encodings);
+  query_and_reply();
+  query_and_reply();
+  EXPECT_EQ(dynamic_encodings, mongo_stats_->dynamicEncodings());
+
+  EXPECT_EQ(3U, store_.counter("test.collection.test.query.total").value());
+  EXPECT_EQ(3U, store_.counter("test.collection.test.callsite.getByMongoId.query.total").value());
+}
+
 TEST_F(MongoProxyFilterTest, Stats) {
   initializeFilter();
 
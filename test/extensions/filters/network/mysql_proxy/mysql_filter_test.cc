@@ -1,14 +1,20 @@
 #include "extensions/filters/network/mysql_proxy/mysql_codec.h"
 #include "extensions/filters/network/mysql_proxy/mysql_filter.h"
 #include "extensions/filters/network/mysql_proxy/mysql_utils.h"
+#include "extensions/filters/network/well_known_names.h"
 
 #include "test/mocks/network/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "mysql_test_utils.h"
 
+using testing::_;
+using testing::Invoke;
 using testing::NiceMock;
+using testing::Return;
 
 namespace Envoy {
 namespace Extensions {
@@ -27,11 +33,54 @@ public:
     filter_->initializeReadFilterCallbacks(filter_callbacks_);
   }
 
+  void initialize(
+      const envoy::config::filter::network::mysql_proxy::v1alpha1::QueryParsing& query_parsing) {
+    config_ =
+        std::make_shared<MySQLFilterConfig>(stat_prefix_, scope_, query_parsing, random_, tls_);
+    filter_ = std::make_unique<MySQLFilter>(config_);
+    filter_->initializeReadFilterCallbacks(filter_callbacks_);
+  }
+
+  void login() {
+    Buffer::OwnedImpl greet_data(encodeServerGreeting(MYSQL_PROTOCOL_10));
+    EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(greet_data, false));
+    Buffer::OwnedImpl client_login_data(
+        encodeClientLogin(MYSQL_CLIENT_CAPAB_41VS320, "user1", CHALLENGE_SEQ_NUM));
+    EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(client_login_data, false));
+    Buffer::OwnedImpl server_resp_data(encodeClientLoginResp(MYSQL_RESP_OK));
+    EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(server_resp_data, false));
+    EXPECT_EQ(MySQLSession::State::MYSQL_REQ, filter_->getSession().getState());
+  }
+
+  void query(std::string query) {
+    Command mysql_cmd_encode{};
+    mysql_cmd_encode.setCmd(Command::Cmd::COM_QUERY);
+    mysql_cmd_encode.setData(query);
+    Buffer::OwnedImpl query_data(BufferHelper::encodeHdr(mysql_cmd_encode.encode(), 0));
+    EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(query_data, false));
+    Buffer::OwnedImpl resp_data(encodeClientLoginResp(MYSQL_RESP_OK, 0, 1));
+    EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(resp_data, false));
+    EXPECT_EQ(MySQLSession::State::MYSQL_REQ, filter_->getSession().getState());
+  }
+
+  // Expect the table metadata to be set once, and return it.
+  ProtobufWkt::Struct& expectTablesMetadata() {
+    EXPECT_CALL(filter_callbacks_.connection_.stream_info_,
+                setDynamicMetadata(NetworkFilterNames::get().MySQLProxy, _))
+        .WillOnce(Invoke([this](const std::string&, const ProtobufWkt::Struct& metadata) -> void {
+          metadata_ = metadata;
+        }));
+    return metadata_;
+  }
+
   MySQLFilterConfigSharedPtr config_;
   std::unique_ptr<MySQLFilter> filter_;
   Stats::IsolatedStoreImpl scope_;
   std::string stat_prefix_{"test"};
   NiceMock<Network::MockReadFilterCallbacks> filter_callbacks_;
+  NiceMock<Runtime::MockRandomGenerator> random_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  ProtobufWkt::Struct metadata_;
 };
 
 // Test New Session counter increment
@@ -937,6 +986,91 @@ TEST_F(MySQLFilterTest, MySqlLoginAndQueryTest) {
   EXPECT_EQ(MySQLSession::State::MYSQL_REQ, filter_->getSession().getState());
 }
 
+/*
+ * Test the tables of simple queries being extracted without parsing them, and other queries being
+ * parsed.
+ */
+TEST_F(MySQLFilterTest, MySqlTokenizedQueryTest) {
+  envoy::config::filter::network::mysql_proxy::v1alpha1::QueryParsing query_parsing;
+  query_parsing.set_tokenize_simple_queries(true);
+  initialize(query_parsing);
+  login();
+
+  ProtobufWkt::Struct& metadata = expectTablesMetadata();
+  query("SELECT * FROM table1 WHERE Count = 1");
+  EXPECT_EQ(1UL, config_->stats().queries_tokenized_.value());
+  EXPECT_EQ(1UL, config_->stats().queries_parsed_.value());
+  const auto& operations = metadata.fields().at("table1").list_value();
+  ASSERT_EQ(1, operations.values_size());
+  EXPECT_EQ("select", operations.values(0).string_value());
+
+  expectTablesMetadata();
+  query("CREATE TABLE students (name TEXT, student_number INTEGER, city TEXT)");
+  EXPECT_EQ(1UL, config_->stats().queries_tokenized_.value());
+  EXPECT_EQ(2UL, config_->stats().queries_parsed_.value());
+  EXPECT_EQ(1, metadata.fields().count("students"));
+}
+
+/*
+ * Test the parse results being cached by query fingerprint, including the errors.
+ */
+TEST_F(MySQLFilterTest, MySqlQueryParseCacheTest) {
+  envoy::config::filter::network::mysql_proxy::v1alpha1::QueryParsing query_parsing;
+  query_parsing.set_cache_max_entries(10);
+  initialize(query_parsing);
+  login();
+
+  ProtobufWkt::Struct& metadata = expectTablesMetadata();
+  query("CREATE TABLE students (name TEXT DEFAULT 'a')");
+  EXPECT_EQ(0UL, config_->stats().queries_parse_cache_hit_.value());
+  EXPECT_EQ(1UL, config_->stats().queries_parse_cache_miss_.value());
+  EXPECT_EQ(1UL, config_->stats().queries_parsed_.value());
+
+  metadata.Clear();
+  expectTablesMetadata();
+  query("CREATE TABLE  students (name TEXT DEFAULT 'b')");
+  EXPECT_EQ(1UL, config_->stats().queries_parse_cache_hit_.value());
+  EXPECT_EQ(1UL, config_->stats().queries_parse_cache_miss_.value());
+  EXPECT_EQ(2UL, config_->stats().queries_parsed_.value());
+  EXPECT_EQ(1, metadata.fields().count("students"));
+
+  EXPECT_CALL(filter_callbacks_.connection_.stream_info_, setDynamicMetadata(_, _)).Times(0);
+  query("SELECT FROM WHERE 1");
+  query("SELECT FROM WHERE 2");
+  EXPECT_EQ(2UL, config_->stats().queries_parse_cache_hit_.value());
+  EXPECT_EQ(2UL, config_->stats().queries_parse_cache_miss_.value());
+  EXPECT_EQ(2UL, config_->stats().queries_parse_error_.value());
+  EXPECT_EQ(2UL, config_->stats().queries_parsed_.value());
+}
+
+/*
+ * Test the queries which are not tokenized being parsed by a fraction of the time.
+ */
+TEST_F(MySQLFilterTest, MySqlFullParseSamplingTest) {
+  envoy::config::filter::network::mysql_proxy::v1alpha1::QueryParsing query_parsing;
+  query_parsing.set_tokenize_simple_queries(true);
+  query_parsing.mutable_full_parse_fraction()->set_numerator(50);
+  initialize(query_parsing);
+  login();
+
+  // Tokenized queries are not sampled.
+  expectTablesMetadata();
+  query("DELETE FROM table1 WHERE id = 1");
+  EXPECT_EQ(1UL, config_->stats().queries_tokenized_.value());
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(99));
+  EXPECT_CALL(filter_callbacks_.connection_.stream_info_, setDynamicMetadata(_, _)).Times(0);
+  query("CREATE TABLE students (name TEXT)");
+  EXPECT_EQ(1UL, config_->stats().queries_parse_skipped_.value());
+  EXPECT_EQ(1UL, config_->stats().queries_parsed_.value());
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(49));
+  expectTablesMetadata();
+  query("CREATE TABLE students (name TEXT)");
+  EXPECT_EQ(1UL, config_->stats().queries_parse_skipped_.value());
+  EXPECT_EQ(2UL, config_->stats().queries_parsed_.value());
+}
+
 } // namespace MySQLProxy
 } // namespace NetworkFilters
 } // namespace Extensions
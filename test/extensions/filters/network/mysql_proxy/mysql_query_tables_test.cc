@@ -0,0 +1,140 @@
+#include "extensions/filters/network/mysql_proxy/mysql_query_cache.h"
+#include "extensions/filters/network/mysql_proxy/mysql_query_tables.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace MySQLProxy {
+namespace {
+
+void expectTables(const std::string& query, const TableAccessMap& expected) {
+  TableAccessMap tables;
+  EXPECT_TRUE(QueryTables::extract(query, tables)) << query;
+  EXPECT_EQ(expected, tables) << query;
+}
+
+void expectNotExtracted(const std::string& query) {
+  TableAccessMap tables;
+  EXPECT_FALSE(QueryTables::extract(query, tables)) << query;
+  EXPECT_TRUE(tables.empty()) << query;
+}
+
+std::string fingerprint(const std::string& query) {
+  std::string fingerprint;
+  EXPECT_TRUE(QueryTables::fingerprint(query, fingerprint)) << query;
+  return fingerprint;
+}
+
+TEST(MySQLQueryTablesTest, ExtractSelect) {
+  expectTables("SELECT * FROM table1", {{"table1", {"select"}}});
+  expectTables("select DISTINCT Usr FROM table1;", {{"table1", {"select"}}});
+  expectTables("SELECT Usr,Count FROM table1 ORDER BY Count DESC", {{"table1", {"select"}}});
+  expectTables("SELECT 12 AS a, a FROM table1 GROUP BY a;", {{"table1", {"select"}}});
+  expectTables("SELECT * FROM `table 1` WHERE name = 'a FROM b'", {{"table 1", {"select"}}});
+  expectTables("SELECT * FROM \"table1\" AS t WHERE Count = 1", {{"table1", {"select"}}});
+  expectTables("SELECT EXTRACT(YEAR FROM d) FROM table1 t LIMIT 10", {{"table1", {"select"}}});
+}
+
+TEST(MySQLQueryTablesTest, ExtractInsertUpdateDelete) {
+  expectTables("INSERT INTO table1 (a, b) VALUES (1, 'x')", {{"table1", {"insert"}}});
+  expectTables("INSERT LOW_PRIORITY IGNORE table1 VALUES (1)", {{"table1", {"insert"}}});
+  expectTables("UPDATE table1 SET col1 = col1 + 1", {{"table1", {"update"}}});
+  expectTables("UPDATE LOW_PRIORITY IGNORE table1 AS t SET a = 1 WHERE b = 2",
+               {{"table1", {"update"}}});
+  expectTables("DELETE FROM table1 WHERE a > 100", {{"table1", {"delete"}}});
+  expectTables("DELETE QUICK IGNORE FROM `table1`", {{"table1", {"delete"}}});
+}
+
+TEST(MySQLQueryTablesTest, LeavesOtherQueriesToTheParser) {
+  // Statements other than SELECT, INSERT, UPDATE and DELETE.
+  expectNotExtracted("");
+  expectNotExtracted(";");
+  expectNotExtracted("show databases");
+  expectNotExtracted("CREATE TABLE students (name TEXT)");
+  // Several tables, subqueries or qualified names.
+  expectNotExtracted("SELECT * FROM table1, table2");
+  expectNotExtracted("SELECT * FROM table1 JOIN table2 ON a = b");
+  expectNotExtracted("SELECT Product.category FROM table1");
+  expectNotExtracted("SELECT * FROM db.table1");
+  expectNotExtracted("SELECT * FROM table1 WHERE a IN (SELECT a FROM table2)");
+  expectNotExtracted("SELECT * FROM (SELECT a FROM table1) t");
+  expectNotExtracted("SELECT a FROM table1 UNION SELECT a FROM table2");
+  expectNotExtracted("INSERT INTO table1 SELECT * FROM table2");
+  expectNotExtracted("UPDATE table1 SET a = (SELECT b FROM table2)");
+  expectNotExtracted("DELETE table1 FROM table1 JOIN table2");
+  expectNotExtracted("SELECT * FROM table1; DELETE FROM table1");
+  // Incomplete statements.
+  expectNotExtracted("SELECT Usr, Count");
+  expectNotExtracted("SELECT * FROM");
+  expectNotExtracted("SELECT * FROM WHERE");
+  expectNotExtracted("SELECT * FROM table1 AS");
+  expectNotExtracted("INSERT INTO table1");
+  expectNotExtracted("UPDATE table1 WHERE a = 1");
+  // Comments, escapes and unexpected characters.
+  expectNotExtracted("SELECT * FROM table1 -- comment");
+  expectNotExtracted("SELECT * FROM table1 # comment");
+  expectNotExtracted("SELECT /*!40001 SQL_NO_CACHE */ * FROM table1");
+  expectNotExtracted("SELECT * FROM table1 WHERE a = 'it''s'");
+  expectNotExtracted("SELECT * FROM table1 WHERE a = 'it\\'s'");
+  expectNotExtracted("SELECT * FROM table1 WHERE a = 'unterminated");
+  expectNotExtracted("SELECT * FROM table1 WHERE a = ?");
+  expectNotExtracted("SELECT * FROM table1 WHERE a = 0x1F");
+}
+
+TEST(MySQLQueryTablesTest, Fingerprint) {
+  EXPECT_EQ("SELECT * FROM t WHERE a = ? AND b = ?",
+            fingerprint("SELECT  *\n FROM t WHERE a = 42 AND b = 'x y'"));
+  EXPECT_EQ(fingerprint("SELECT * FROM t WHERE a = 1"),
+            fingerprint("SELECT * FROM t WHERE a = 123456"));
+  EXPECT_NE(fingerprint("SELECT * FROM t1 WHERE a = 1"),
+            fingerprint("SELECT * FROM t2 WHERE a = 1"));
+
+  // Token boundaries, identifiers and decimals are kept.
+  EXPECT_EQ("SELECT a<=b", fingerprint("SELECT a<=b"));
+  EXPECT_EQ("SELECT a < = b", fingerprint("SELECT a < = b"));
+  EXPECT_EQ("SELECT `a`, \"b\" FROM t LIMIT ?.?",
+            fingerprint("SELECT `a`, \"b\" FROM t LIMIT 1.5"));
+  EXPECT_EQ("LIMIT 1234567890123456789", fingerprint("LIMIT 1234567890123456789"));
+
+  std::string result;
+  EXPECT_FALSE(QueryTables::fingerprint("SELECT 1 -- comment", result));
+  EXPECT_FALSE(QueryTables::fingerprint("SELECT 'a\\'b'", result));
+}
+
+TEST(MySQLQueryParseCacheTest, EvictsLeastRecentlyUsed) {
+  QueryParseCache cache(2);
+  cache.insert("a", {true, {{"table1", {"select"}}}});
+  cache.insert("b", {false, {}});
+  EXPECT_EQ(2, cache.size());
+
+  const QueryParseCache::Entry* entry = cache.find("a");
+  ASSERT_NE(nullptr, entry);
+  EXPECT_TRUE(entry->valid_);
+  EXPECT_EQ((TableAccessMap{{"table1", {"select"}}}), entry->tables_);
+
+  cache.insert("c", {true, {}});
+  EXPECT_EQ(2, cache.size());
+  EXPECT_EQ(nullptr, cache.find("b"));
+  EXPECT_NE(nullptr, cache.find("a"));
+  EXPECT_NE(nullptr, cache.find("c"));
+
+  // Inserting an existing fingerprint replaces its result.
+  cache.insert("c", {false, {}});
+  EXPECT_EQ(2, cache.size());
+  EXPECT_FALSE(cache.find("c")->valid_);
+}
+
+TEST(MySQLQueryParseCacheTest, ZeroEntries) {
+  QueryParseCache cache(0);
+  cache.insert("a", {true, {}});
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(nullptr, cache.find("a"));
+}
+
+} // namespace
+} // namespace MySQLProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
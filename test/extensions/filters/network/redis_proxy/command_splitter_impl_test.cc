@@ -8,12 +8,17 @@
 
 #include "extensions/filters/network/common/redis/supported_commands.h"
 #include "extensions/filters/network/redis_proxy/command_splitter_impl.h"
+#include "extensions/filters/network/redis_proxy/local_cache_impl.h"
 
 #include "test/extensions/filters/network/common/redis/mocks.h"
 #include "test/extensions/filters/network/redis_proxy/mocks.h"
 #include "test/mocks/common.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/match.h"
 
 using testing::_;
 using testing::ByRef;
@@ -26,6 +31,7 @@ using testing::Property;
 using testing::Ref;
 using testing::Return;
 using testing::SaveArg;
+using testing::SetArgReferee;
 using testing::WithArg;
 
 namespace Envoy {
@@ -1482,6 +1488,395 @@ INSTANTIATE_TEST_SUITE_P(
     RedisSplitKeysSumResultHandlerTest, RedisSplitKeysSumResultHandlerTest,
     testing::ValuesIn(Common::Redis::SupportedCommands::hashMultipleSumResultCommands()));
 
+// The keys sharing a hash key are sent in one request, and their responses are put back in order.
+class RedisBatchedFragmentsTest : public RedisCommandSplitterImplTest {
+public:
+  void SetUp() override {
+    // The hash key of a key is its first character.
+    ON_CALL(*conn_pool_, hashKey(_)).WillByDefault(Invoke([](absl::string_view key) {
+      return key.substr(0, 1);
+    }));
+    EXPECT_CALL(callbacks_, connectionAllowed()).WillRepeatedly(Return(true));
+  }
+
+  void expectRequest(const std::vector<std::string>& request, uint32_t index) {
+    Common::Redis::RespValue expected_request;
+    makeBulkStringArray(expected_request, request);
+    EXPECT_CALL(*conn_pool_, makeRequest(request[1], Eq(expected_request), _))
+        .WillOnce(DoAll(WithArg<2>(SaveArgAddress(&pool_callbacks_[index])),
+                        Return(&pool_requests_[index])));
+  }
+
+  void makeRequest(const std::vector<std::string>& request) {
+    Common::Redis::RespValuePtr request_value{new Common::Redis::RespValue()};
+    makeBulkStringArray(*request_value, request);
+    handle_ = splitter_.makeRequest(std::move(request_value), callbacks_);
+    EXPECT_NE(nullptr, handle_);
+  }
+
+  Common::Redis::RespValuePtr makeResponse(Common::Redis::RespType type,
+                                           const std::string& value = "") {
+    Common::Redis::RespValuePtr response{new Common::Redis::RespValue()};
+    response->type(type);
+    if (type == Common::Redis::RespType::Integer) {
+      response->asInteger() = std::stoi(value);
+    } else if (type != Common::Redis::RespType::Null) {
+      response->asString() = value;
+    }
+    return response;
+  }
+
+  Common::Redis::Client::PoolCallbacks* pool_callbacks_[2]{};
+  Common::Redis::Client::MockPoolRequest pool_requests_[2];
+};
+
+TEST_F(RedisBatchedFragmentsTest, MGET) {
+  InSequence s;
+
+  expectRequest({"mget", "a1", "a2"}, 0);
+  expectRequest({"get", "b1"}, 1);
+  makeRequest({"mget", "a1", "b1", "a2"});
+
+  pool_callbacks_[1]->onResponse(makeResponse(Common::Redis::RespType::BulkString, "vb1"));
+
+  Common::Redis::RespValuePtr response = makeResponse(Common::Redis::RespType::Array);
+  response->asArray().push_back(*makeResponse(Common::Redis::RespType::BulkString, "va1"));
+  response->asArray().push_back(*makeResponse(Common::Redis::RespType::Null));
+
+  Common::Redis::RespValue expected_response;
+  expected_response.type(Common::Redis::RespType::Array);
+  expected_response.asArray().push_back(*makeResponse(Common::Redis::RespType::BulkString, "va1"));
+  expected_response.asArray().push_back(*makeResponse(Common::Redis::RespType::BulkString, "vb1"));
+  expected_response.asArray().push_back(*makeResponse(Common::Redis::RespType::Null));
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
+  pool_callbacks_[0]->onResponse(std::move(response));
+
+  EXPECT_EQ(1UL, store_.counter("redis.foo.command.mget.success").value());
+}
+
+TEST_F(RedisBatchedFragmentsTest, MGETError) {
+  InSequence s;
+
+  expectRequest({"mget", "a1", "a2"}, 0);
+  expectRequest({"get", "b1"}, 1);
+  makeRequest({"mget", "a1", "b1", "a2"});
+
+  pool_callbacks_[1]->onResponse(makeResponse(Common::Redis::RespType::BulkString, "vb1"));
+
+  // The error of the batch is the response of each of its keys.
+  Common::Redis::RespValue expected_response;
+  expected_response.type(Common::Redis::RespType::Array);
+  expected_response.asArray().push_back(*makeResponse(Common::Redis::RespType::Error, "ERR x"));
+  expected_response.asArray().push_back(*makeResponse(Common::Redis::RespType::BulkString, "vb1"));
+  expected_response.asArray().push_back(*makeResponse(Common::Redis::RespType::Error, "ERR x"));
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
+  pool_callbacks_[0]->onResponse(makeResponse(Common::Redis::RespType::Error, "ERR x"));
+
+  EXPECT_EQ(1UL, store_.counter("redis.foo.command.mget.error").value());
+}
+
+TEST_F(RedisBatchedFragmentsTest, MGETWrongNumberOfResponses) {
+  InSequence s;
+
+  expectRequest({"mget", "a1", "a2"}, 0);
+  makeRequest({"mget", "a1", "a2"});
+
+  Common::Redis::RespValuePtr response = makeResponse(Common::Redis::RespType::Array);
+  response->asArray().push_back(*makeResponse(Common::Redis::RespType::BulkString, "va1"));
+
+  Common::Redis::RespValue expected_response;
+  expected_response.type(Common::Redis::RespType::Array);
+  for (uint32_t i = 0; i < 2; i++) {
+    expected_response.asArray().push_back(
+        *makeResponse(Common::Redis::RespType::Error, Response::get().UpstreamProtocolError));
+  }
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
+  pool_callbacks_[0]->onResponse(std::move(response));
+}
+
+TEST_F(RedisBatchedFragmentsTest, MGETMovedRedirection) {
+  InSequence s;
+
+  expectRequest({"mget", "a1", "a2"}, 0);
+  makeRequest({"mget", "a1", "a2"});
+
+  Common::Redis::RespValue moved_response;
+  moved_response.type(Common::Redis::RespType::Error);
+  moved_response.asString() = "MOVED 1234 192.168.0.1:5000";
+  Common::Redis::RespValue expected_request;
+  makeBulkStringArray(expected_request, {"mget", "a1", "a2"});
+  EXPECT_CALL(*conn_pool_, makeRequestToHost("192.168.0.1:5000", Eq(expected_request),
+                                             Ref(*pool_callbacks_[0])))
+      .WillOnce(Return(&pool_requests_[0]));
+  EXPECT_TRUE(pool_callbacks_[0]->onRedirection(moved_response));
+
+  EXPECT_CALL(pool_requests_[0], cancel());
+  handle_->cancel();
+}
+
+TEST_F(RedisBatchedFragmentsTest, MSET) {
+  InSequence s;
+
+  expectRequest({"mset", "a1", "x", "a2", "z"}, 0);
+  expectRequest({"set", "b1", "y"}, 1);
+  makeRequest({"mset", "a1", "x", "b1", "y", "a2", "z"});
+
+  pool_callbacks_[0]->onResponse(makeResponse(Common::Redis::RespType::SimpleString, "OK"));
+
+  Common::Redis::RespValue expected_response;
+  expected_response.type(Common::Redis::RespType::SimpleString);
+  expected_response.asString() = Response::get().OK;
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
+  pool_callbacks_[1]->onResponse(makeResponse(Common::Redis::RespType::SimpleString, "OK"));
+
+  EXPECT_EQ(1UL, store_.counter("redis.foo.command.mset.success").value());
+}
+
+TEST_F(RedisBatchedFragmentsTest, MSETError) {
+  InSequence s;
+
+  expectRequest({"mset", "a1", "x", "a2", "z"}, 0);
+  expectRequest({"set", "b1", "y"}, 1);
+  makeRequest({"mset", "a1", "x", "b1", "y", "a2", "z"});
+
+  pool_callbacks_[1]->onResponse(makeResponse(Common::Redis::RespType::SimpleString, "OK"));
+
+  // The error is counted for each of the keys of the batch.
+  Common::Redis::RespValue expected_response;
+  expected_response.type(Common::Redis::RespType::Error);
+  expected_response.asString() = "finished with 2 error(s)";
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
+  pool_callbacks_[0]->onFailure();
+
+  EXPECT_EQ(1UL, store_.counter("redis.foo.command.mset.error").value());
+}
+
+TEST_F(RedisBatchedFragmentsTest, SplitKeysSumResult) {
+  InSequence s;
+
+  expectRequest({"del", "a1", "a2"}, 0);
+  expectRequest({"del", "b1"}, 1);
+  makeRequest({"del", "a1", "b1", "a2"});
+
+  pool_callbacks_[0]->onResponse(makeResponse(Common::Redis::RespType::Integer, "2"));
+
+  Common::Redis::RespValue expected_response;
+  expected_response.type(Common::Redis::RespType::Integer);
+  expected_response.asInteger() = 3;
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
+  pool_callbacks_[1]->onResponse(makeResponse(Common::Redis::RespType::Integer, "1"));
+
+  EXPECT_EQ(1UL, store_.counter("redis.foo.command.del.success").value());
+}
+
+class RedisCachedGetTest : public testing::Test {
+public:
+  void SetUp() override {
+    ON_CALL(*local_cache_, cacheable(_)).WillByDefault(Invoke([](absl::string_view key) {
+      return absl::StartsWith(key, "hot:");
+    }));
+    EXPECT_CALL(callbacks_, connectionAllowed()).WillRepeatedly(Return(true));
+  }
+
+  Common::Redis::RespValuePtr makeRequest(const std::vector<std::string>& strings) {
+    Common::Redis::RespValuePtr request{new Common::Redis::RespValue()};
+    std::vector<Common::Redis::RespValue> values(strings.size());
+    for (uint64_t i = 0; i < strings.size(); i++) {
+      values[i].type(Common::Redis::RespType::BulkString);
+      values[i].asString() = strings[i];
+    }
+    request->type(Common::Redis::RespType::Array);
+    request->asArray().swap(values);
+    return request;
+  }
+
+  Common::Redis::RespValuePtr makeBulkString(const std::string& value) {
+    Common::Redis::RespValuePtr response{new Common::Redis::RespValue()};
+    response->type(Common::Redis::RespType::BulkString);
+    response->asString() = value;
+    return response;
+  }
+
+  void expectUpstreamRequest(const std::string& hash_key) {
+    EXPECT_CALL(*conn_pool_, makeRequest(hash_key, _, _))
+        .WillOnce(DoAll(WithArg<2>(SaveArgAddress(&pool_callbacks_)), Return(&pool_request_)));
+  }
+
+  ConnPool::MockInstance* conn_pool_{new ConnPool::MockInstance()};
+  MockLocalCache* local_cache_{new NiceMock<MockLocalCache>()};
+  NiceMock<Stats::MockIsolatedStatsStore> store_;
+  Event::SimulatedTimeSystem time_system_;
+  InstanceImpl splitter_{std::make_unique<PassthruRouter>(ConnPool::InstanceSharedPtr{conn_pool_}),
+                         store_, "redis.foo.", time_system_, false,
+                         LocalCacheSharedPtr{local_cache_}};
+  MockSplitCallbacks callbacks_;
+  Common::Redis::Client::PoolCallbacks* pool_callbacks_{};
+  Common::Redis::Client::MockPoolRequest pool_request_;
+};
+
+TEST_F(RedisCachedGetTest, Hit) {
+  EXPECT_CALL(*local_cache_, lookup_("hot:a", _)).WillOnce(Return(makeBulkString("1").release()));
+  EXPECT_CALL(*conn_pool_, makeRequest(_, _, _)).Times(0);
+  Common::Redis::RespValuePtr expected_response = makeBulkString("1");
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(expected_response.get())));
+  EXPECT_EQ(nullptr, splitter_.makeRequest(makeRequest({"GET", "hot:a"}), callbacks_));
+
+  EXPECT_EQ(1UL, store_.counter("redis.foo.command.get.total").value());
+  EXPECT_EQ(1UL, store_.counter("redis.foo.command.get.success").value());
+}
+
+TEST_F(RedisCachedGetTest, Miss) {
+  InSequence s;
+
+  EXPECT_CALL(*local_cache_, lookup_("hot:a", _))
+      .WillOnce(DoAll(SetArgReferee<1>(7), Return(nullptr)));
+  expectUpstreamRequest("hot:a");
+  SplitRequestPtr handle = splitter_.makeRequest(makeRequest({"get", "hot:a"}), callbacks_);
+  EXPECT_NE(nullptr, handle);
+
+  Common::Redis::RespValuePtr expected_response = makeBulkString("1");
+  EXPECT_CALL(*local_cache_, insert("hot:a", Eq(ByRef(*expected_response)), 7));
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(expected_response.get())));
+  pool_callbacks_->onResponse(makeBulkString("1"));
+}
+
+// Only the values of existing keys are cached.
+TEST_F(RedisCachedGetTest, MissNull) {
+  InSequence s;
+
+  EXPECT_CALL(*local_cache_, lookup_("hot:a", _)).WillOnce(Return(nullptr));
+  expectUpstreamRequest("hot:a");
+  SplitRequestPtr handle = splitter_.makeRequest(makeRequest({"get", "hot:a"}), callbacks_);
+
+  EXPECT_CALL(*local_cache_, insert(_, _, _)).Times(0);
+  EXPECT_CALL(callbacks_, onResponse_(_));
+  pool_callbacks_->onResponse(std::make_unique<Common::Redis::RespValue>());
+}
+
+TEST_F(RedisCachedGetTest, NotCacheable) {
+  EXPECT_CALL(*local_cache_, lookup_(_, _)).Times(0);
+  expectUpstreamRequest("cold:a");
+  SplitRequestPtr handle = splitter_.makeRequest(makeRequest({"get", "cold:a"}), callbacks_);
+  EXPECT_NE(nullptr, handle);
+
+  EXPECT_CALL(pool_request_, cancel());
+  handle->cancel();
+}
+
+// The keys written are invalidated when the write is sent, and again once it completed.
+TEST_F(RedisCachedGetTest, WriteInvalidates) {
+  EXPECT_CALL(*local_cache_, invalidate(Eq("hot:a")));
+  expectUpstreamRequest("hot:a");
+  SplitRequestPtr handle = splitter_.makeRequest(makeRequest({"set", "hot:a", "1"}), callbacks_);
+  EXPECT_NE(nullptr, handle);
+  EXPECT_CALL(*local_cache_, invalidate(Eq("hot:a")));
+  EXPECT_CALL(callbacks_, onResponse_(_));
+  pool_callbacks_->onResponse(makeBulkString("OK"));
+
+  // The arguments are not told apart from the keys, which only costs a miss. A write cancelled
+  // may still be applied.
+  EXPECT_CALL(*local_cache_, invalidate(Eq("hot:b")));
+  expectUpstreamRequest("cold:c");
+  handle = splitter_.makeRequest(makeRequest({"set", "cold:c", "hot:b"}), callbacks_);
+  EXPECT_CALL(pool_request_, cancel());
+  EXPECT_CALL(*local_cache_, invalidate(Eq("hot:b")));
+  handle->cancel();
+
+  // The arguments of reads are not invalidated.
+  EXPECT_CALL(*local_cache_, invalidate(_)).Times(0);
+  expectUpstreamRequest("hot:a");
+  handle = splitter_.makeRequest(makeRequest({"strlen", "hot:a"}), callbacks_);
+  EXPECT_CALL(callbacks_, onResponse_(_));
+  pool_callbacks_->onResponse(makeBulkString("1"));
+}
+
+// The splitter with a local cache in which a key is hot from its first read.
+class RedisLocalCacheSplitterTest : public testing::Test {
+public:
+  RedisLocalCacheSplitterTest() {
+    envoy::config::filter::network::redis_proxy::v2::RedisProxy::LocalCache config;
+    TestUtility::loadFromYaml(R"EOF(
+prefixes: ["hot:"]
+ttl: 10s
+hot_key_threshold: 1
+)EOF",
+                              config);
+    splitter_ = std::make_unique<InstanceImpl>(
+        std::make_unique<PassthruRouter>(ConnPool::InstanceSharedPtr{conn_pool_}), store_,
+        "redis.foo.", time_system_, false,
+        std::make_shared<LocalCacheImpl>(config, tls_, time_system_, store_,
+                                         "redis.foo.local_cache."));
+    EXPECT_CALL(callbacks_, connectionAllowed()).WillRepeatedly(Return(true));
+    EXPECT_CALL(callbacks_, onResponse_(_))
+        .WillRepeatedly(Invoke([this](Common::Redis::RespValuePtr& value) {
+          responses_.push_back(value->asString());
+        }));
+    ON_CALL(*conn_pool_, makeRequest(_, _, _))
+        .WillByDefault(Invoke([this](const std::string&, const Common::Redis::RespValue&,
+                                     Common::Redis::Client::PoolCallbacks& callbacks)
+                                  -> Common::Redis::Client::PoolRequest* {
+          pool_callbacks_.push_back(&callbacks);
+          return &pool_request_;
+        }));
+  }
+
+  SplitRequestPtr makeRequest(const std::vector<std::string>& strings) {
+    Common::Redis::RespValuePtr request{new Common::Redis::RespValue()};
+    std::vector<Common::Redis::RespValue> values(strings.size());
+    for (uint64_t i = 0; i < strings.size(); i++) {
+      values[i].type(Common::Redis::RespType::BulkString);
+      values[i].asString() = strings[i];
+    }
+    request->type(Common::Redis::RespType::Array);
+    request->asArray().swap(values);
+    return splitter_->makeRequest(std::move(request), callbacks_);
+  }
+
+  // Responds to the upstream request of the given index.
+  void respond(size_t index, const std::string& value) {
+    Common::Redis::RespValuePtr response{new Common::Redis::RespValue()};
+    response->type(Common::Redis::RespType::BulkString);
+    response->asString() = value;
+    pool_callbacks_[index]->onResponse(std::move(response));
+  }
+
+  NiceMock<ConnPool::MockInstance>* conn_pool_{new NiceMock<ConnPool::MockInstance>()};
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Stats::IsolatedStoreImpl store_;
+  Event::SimulatedTimeSystem time_system_;
+  std::unique_ptr<InstanceImpl> splitter_;
+  MockSplitCallbacks callbacks_;
+  std::vector<Common::Redis::Client::PoolCallbacks*> pool_callbacks_;
+  Common::Redis::Client::MockPoolRequest pool_request_;
+  std::vector<std::string> responses_;
+};
+
+// A GET which starts while a SET of its key is in flight, and reads the previous value because it
+// reaches upstream first, does not leave that value cached once the SET completed.
+TEST_F(RedisLocalCacheSplitterTest, GetDuringSet) {
+  SplitRequestPtr get = makeRequest({"get", "hot:a"});
+  respond(0, "1");
+  EXPECT_EQ(nullptr, makeRequest({"get", "hot:a"}));
+  EXPECT_EQ(1U, pool_callbacks_.size());
+
+  SplitRequestPtr set = makeRequest({"set", "hot:a", "2"});
+  ASSERT_EQ(2U, pool_callbacks_.size());
+  get = makeRequest({"get", "hot:a"});
+  ASSERT_EQ(3U, pool_callbacks_.size());
+  respond(2, "1");
+  respond(1, "OK");
+
+  // The value read during the SET is not served from the cache.
+  get = makeRequest({"get", "hot:a"});
+  ASSERT_EQ(4U, pool_callbacks_.size());
+  respond(3, "2");
+  EXPECT_EQ(nullptr, makeRequest({"get", "hot:a"}));
+  EXPECT_EQ(4U, pool_callbacks_.size());
+
+  EXPECT_EQ(std::vector<std::string>({"1", "1", "1", "OK", "2", "2"}), responses_);
+  EXPECT_EQ(2U, store_.counter("redis.foo.local_cache.hit").value());
+}
+
 class RedisSingleServerRequestWithLatencyMicrosTest : public RedisSingleServerRequestTest {
 public:
   void makeRequest(const std::string& hash_key, Common::Redis::RespValuePtr&& request) {
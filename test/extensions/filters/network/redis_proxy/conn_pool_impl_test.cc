@@ -66,11 +66,19 @@ public:
       max_upstream_unknown_connections_reached_.value_++;
     }));
 
-    std::unique_ptr<InstanceImpl> conn_pool_impl =
-        std::make_unique<InstanceImpl>(cluster_name_, cm_, *this, tls_,
-                                       Common::Redis::Client::createConnPoolSettings(
-                                           20, hashtagging, true, max_unknown_conns, read_policy_),
-                                       api_, std::move(store));
+    ON_CALL(*store, counter(Eq("upstream_rq_hedged")))
+        .WillByDefault(ReturnRef(upstream_rq_hedged_));
+    ON_CALL(*store, counter(Eq("upstream_rq_hedge_won")))
+        .WillByDefault(ReturnRef(upstream_rq_hedge_won_));
+
+    auto settings = Common::Redis::Client::createConnPoolSettings(20, hashtagging, true,
+                                                                  max_unknown_conns, read_policy_);
+    if (read_hedge_delay_.count() > 0) {
+      settings.mutable_read_hedge_delay()->CopyFrom(
+          Protobuf::util::TimeUtil::MillisecondsToDuration(read_hedge_delay_.count()));
+    }
+    std::unique_ptr<InstanceImpl> conn_pool_impl = std::make_unique<InstanceImpl>(
+        cluster_name_, cm_, *this, tls_, settings, api_, std::move(store));
     // Set the authentication password for this connection pool.
     conn_pool_impl->tls_->getTyped<InstanceImpl::ThreadLocalPool>().auth_password_ = auth_password_;
     conn_pool_ = std::move(conn_pool_impl);
@@ -196,6 +204,83 @@ public:
     tls_.shutdownThread();
   }
 
+  // Sets up a Redis Cluster pool reading from the replicas, with hedged reads.
+  void setupHedging() {
+    redis_cluster_type_.emplace();
+    redis_cluster_type_->set_name("envoy.clusters.redis");
+    EXPECT_CALL(*cm_.thread_local_cluster_.cluster_.info_, clusterType())
+        .WillOnce(ReturnRef(redis_cluster_type_));
+    EXPECT_CALL(*cm_.thread_local_cluster_.cluster_.info_, lbType())
+        .WillOnce(Return(Upstream::LoadBalancerType::ClusterProvided));
+    read_policy_ = envoy::config::filter::network::redis_proxy::v2::
+        RedisProxy_ConnPoolSettings_ReadPolicy_REPLICA;
+    read_hedge_delay_ = std::chrono::milliseconds(5);
+    setup();
+  }
+
+  static Common::Redis::RespValue makeCommand(const std::string& command, const std::string& key) {
+    std::vector<Common::Redis::RespValue> values(2);
+    values[0].type(Common::Redis::RespType::BulkString);
+    values[0].asString() = command;
+    values[1].type(Common::Redis::RespType::BulkString);
+    values[1].asString() = key;
+    Common::Redis::RespValue request;
+    request.type(Common::Redis::RespType::Array);
+    request.asArray().swap(values);
+    return request;
+  }
+
+  // Expects the request to be sent to the host over a new client, returning the callbacks of the
+  // request through callbacks.
+  Common::Redis::Client::MockClient*
+  expectHedgedAttempt(Upstream::HostConstSharedPtr host, const Common::Redis::RespValue& value,
+                      Common::Redis::Client::MockPoolRequest& request,
+                      Common::Redis::Client::PoolCallbacks*& callbacks) {
+    Common::Redis::Client::MockClient* client = new NiceMock<Common::Redis::Client::MockClient>();
+    EXPECT_CALL(*this, create_(Eq(host))).WillOnce(Return(client));
+    EXPECT_CALL(
+        *client,
+        makeRequest(Eq(NetworkFilters::Common::Redis::Utility::ReadOnlyRequest::instance()), _))
+        .WillOnce(Return(nullptr));
+    Common::Redis::Client::MockPoolRequest* request_ptr = &request;
+    Common::Redis::Client::PoolCallbacks** callbacks_ptr = &callbacks;
+    EXPECT_CALL(*client, makeRequest(Eq(value), _))
+        .WillOnce(Invoke([request_ptr, callbacks_ptr](
+                             const Common::Redis::RespValue&,
+                             Common::Redis::Client::PoolCallbacks& request_callbacks)
+                             -> Common::Redis::Client::PoolRequest* {
+          *callbacks_ptr = &request_callbacks;
+          return request_ptr;
+        }));
+    return client;
+  }
+
+  // Makes a hedged read, then sends the hedge to the replica.
+  Common::Redis::Client::PoolRequest* makeHedgedRead() {
+    Upstream::HostConstSharedPtr master = cm_.thread_local_cluster_.lb_.host_;
+    EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_)).WillOnce(Return(master));
+    first_client_ = expectHedgedAttempt(master, read_, first_request_, first_callbacks_);
+    hedge_timer_ = new Event::MockTimer(&tls_.dispatcher_);
+    EXPECT_CALL(*hedge_timer_, enableTimer(read_hedge_delay_));
+    Common::Redis::Client::PoolRequest* request =
+        conn_pool_->makeRequest("foo", read_, callbacks_);
+    EXPECT_NE(nullptr, request);
+    EXPECT_NE(&first_request_, request);
+
+    EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_))
+        .WillOnce(
+            Invoke([&](Upstream::LoadBalancerContext* context) -> Upstream::HostConstSharedPtr {
+              EXPECT_EQ(context->computeHashKey().value(), 44950);
+              EXPECT_TRUE(context->shouldSelectAnotherHost(*master));
+              EXPECT_FALSE(context->shouldSelectAnotherHost(*replica_));
+              return replica_;
+            }));
+    second_client_ = expectHedgedAttempt(replica_, read_, second_request_, second_callbacks_);
+    EXPECT_CALL(upstream_rq_hedged_, inc());
+    hedge_timer_->invokeCallback();
+    return request;
+  }
+
   MOCK_METHOD1(create_, Common::Redis::Client::Client*(Upstream::HostConstSharedPtr host));
 
   const std::string cluster_name_{"fake_cluster"};
@@ -212,6 +297,22 @@ public:
           RedisProxy_ConnPoolSettings_ReadPolicy_MASTER;
   NiceMock<Stats::MockCounter> upstream_cx_drained_;
   NiceMock<Stats::MockCounter> max_upstream_unknown_connections_reached_;
+  NiceMock<Stats::MockCounter> upstream_rq_hedged_;
+  NiceMock<Stats::MockCounter> upstream_rq_hedge_won_;
+  std::chrono::milliseconds read_hedge_delay_{};
+  absl::optional<envoy::api::v2::Cluster::CustomClusterType> redis_cluster_type_;
+
+  // The state of the read made by makeHedgedRead().
+  const Common::Redis::RespValue read_{makeCommand("get", "foo")};
+  Common::Redis::Client::MockPoolCallbacks callbacks_;
+  std::shared_ptr<Upstream::MockHost> replica_{new NiceMock<Upstream::MockHost>()};
+  Event::MockTimer* hedge_timer_{};
+  Common::Redis::Client::MockClient* first_client_{};
+  Common::Redis::Client::MockClient* second_client_{};
+  Common::Redis::Client::MockPoolRequest first_request_;
+  Common::Redis::Client::MockPoolRequest second_request_;
+  Common::Redis::Client::PoolCallbacks* first_callbacks_{};
+  Common::Redis::Client::PoolCallbacks* second_callbacks_{};
 };
 
 TEST_F(RedisConnPoolImplTest, Basic) {
@@ -316,6 +417,9 @@ TEST_F(RedisConnPoolImplTest, Hashtagging) {
   EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_)).WillOnce(Invoke(expectHashKey("bar")));
   conn_pool_->makeRequest("foo{bar}{zap}", value, callbacks);
 
+  EXPECT_EQ("bar", conn_pool_->hashKey("foo{bar}{zap}"));
+  EXPECT_EQ("foo{}{bar}", conn_pool_->hashKey("foo{}{bar}"));
+
   tls_.shutdownThread();
 };
 
@@ -350,6 +454,8 @@ TEST_F(RedisConnPoolImplTest, HashtaggingNotEnabled) {
       .WillOnce(Invoke(expectHashKey("foo{bar}{zap}")));
   conn_pool_->makeRequest("foo{bar}{zap}", value, callbacks);
 
+  EXPECT_EQ("foo{bar}{zap}", conn_pool_->hashKey("foo{bar}{zap}"));
+
   tls_.shutdownThread();
 };
 
@@ -923,6 +1029,135 @@ TEST_F(RedisConnPoolImplTest, MakeRequestToRedisCluster) {
   tls_.shutdownThread();
 };
 
+// The read is answered first by the replica it is hedged to.
+TEST_F(RedisConnPoolImplTest, HedgedReadWonByHedge) {
+  setupHedging();
+  makeHedgedRead();
+
+  EXPECT_CALL(*hedge_timer_, disableTimer());
+  EXPECT_CALL(first_request_, cancel());
+  EXPECT_CALL(upstream_rq_hedge_won_, inc());
+  EXPECT_CALL(callbacks_, onResponse_(_));
+  EXPECT_CALL(tls_.dispatcher_, deferredDelete_(_));
+  second_callbacks_->onResponse(std::make_unique<Common::Redis::RespValue>());
+
+  EXPECT_CALL(*first_client_, close());
+  EXPECT_CALL(*second_client_, close());
+  tls_.shutdownThread();
+}
+
+// The read is answered before the hedge delay, no hedge is sent.
+TEST_F(RedisConnPoolImplTest, HedgedReadAnsweredBeforeDelay) {
+  setupHedging();
+
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_));
+  first_client_ = expectHedgedAttempt(cm_.thread_local_cluster_.lb_.host_, read_, first_request_,
+                                      first_callbacks_);
+  hedge_timer_ = new Event::MockTimer(&tls_.dispatcher_);
+  EXPECT_CALL(*hedge_timer_, enableTimer(read_hedge_delay_));
+  EXPECT_NE(nullptr, conn_pool_->makeRequest("foo", read_, callbacks_));
+
+  EXPECT_CALL(*hedge_timer_, disableTimer());
+  EXPECT_CALL(first_request_, cancel()).Times(0);
+  EXPECT_CALL(upstream_rq_hedge_won_, inc()).Times(0);
+  EXPECT_CALL(callbacks_, onResponse_(_));
+  EXPECT_CALL(tls_.dispatcher_, deferredDelete_(_));
+  first_callbacks_->onResponse(std::make_unique<Common::Redis::RespValue>());
+
+  EXPECT_CALL(*first_client_, close());
+  tls_.shutdownThread();
+}
+
+// A failure is only passed on once both attempts failed.
+TEST_F(RedisConnPoolImplTest, HedgedReadFailure) {
+  setupHedging();
+  makeHedgedRead();
+
+  EXPECT_CALL(callbacks_, onFailure()).Times(0);
+  first_callbacks_->onFailure();
+
+  EXPECT_CALL(callbacks_, onFailure());
+  EXPECT_CALL(tls_.dispatcher_, deferredDelete_(_));
+  second_callbacks_->onFailure();
+
+  EXPECT_CALL(*first_client_, close());
+  EXPECT_CALL(*second_client_, close());
+  tls_.shutdownThread();
+}
+
+TEST_F(RedisConnPoolImplTest, HedgedReadCancel) {
+  setupHedging();
+  Common::Redis::Client::PoolRequest* request = makeHedgedRead();
+
+  EXPECT_CALL(*hedge_timer_, disableTimer());
+  EXPECT_CALL(first_request_, cancel());
+  EXPECT_CALL(second_request_, cancel());
+  EXPECT_CALL(tls_.dispatcher_, deferredDelete_(_));
+  request->cancel();
+
+  EXPECT_CALL(*first_client_, close());
+  EXPECT_CALL(*second_client_, close());
+  tls_.shutdownThread();
+}
+
+// A redirection is passed on, the hedge being canceled.
+TEST_F(RedisConnPoolImplTest, HedgedReadRedirection) {
+  setupHedging();
+  makeHedgedRead();
+
+  Common::Redis::RespValue moved;
+  moved.type(Common::Redis::RespType::Error);
+  moved.asString() = "MOVED 1111 10.1.2.3:4000";
+  EXPECT_CALL(second_request_, cancel());
+  EXPECT_CALL(callbacks_, onRedirection(Ref(moved))).WillOnce(Return(true));
+  EXPECT_CALL(tls_.dispatcher_, deferredDelete_(_));
+  EXPECT_TRUE(first_callbacks_->onRedirection(moved));
+
+  EXPECT_CALL(*first_client_, close());
+  EXPECT_CALL(*second_client_, close());
+  tls_.shutdownThread();
+}
+
+// The shard has no other host to hedge the read to.
+TEST_F(RedisConnPoolImplTest, HedgedReadNoOtherHost) {
+  setupHedging();
+
+  Upstream::HostConstSharedPtr master = cm_.thread_local_cluster_.lb_.host_;
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_)).WillOnce(Return(master));
+  first_client_ = expectHedgedAttempt(master, read_, first_request_, first_callbacks_);
+  hedge_timer_ = new Event::MockTimer(&tls_.dispatcher_);
+  EXPECT_NE(nullptr, conn_pool_->makeRequest("foo", read_, callbacks_));
+
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_)).WillOnce(Return(nullptr));
+  EXPECT_CALL(upstream_rq_hedged_, inc()).Times(0);
+  hedge_timer_->invokeCallback();
+
+  EXPECT_CALL(callbacks_, onResponse_(_));
+  first_callbacks_->onResponse(std::make_unique<Common::Redis::RespValue>());
+
+  EXPECT_CALL(*first_client_, close());
+  tls_.shutdownThread();
+}
+
+// Writes are not hedged.
+TEST_F(RedisConnPoolImplTest, HedgingSkipsWrites) {
+  setupHedging();
+
+  const Common::Redis::RespValue write = makeCommand("set", "foo");
+  Common::Redis::Client::MockPoolRequest active_request;
+  Common::Redis::Client::MockClient* client = new NiceMock<Common::Redis::Client::MockClient>();
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_));
+  EXPECT_CALL(*this, create_(_)).WillOnce(Return(client));
+  EXPECT_CALL(
+      *client,
+      makeRequest(Eq(NetworkFilters::Common::Redis::Utility::ReadOnlyRequest::instance()), _));
+  EXPECT_CALL(*client, makeRequest(Ref(write), Ref(callbacks_))).WillOnce(Return(&active_request));
+  EXPECT_EQ(&active_request, conn_pool_->makeRequest("foo", write, callbacks_));
+
+  EXPECT_CALL(*client, close());
+  tls_.shutdownThread();
+}
+
 TEST_F(RedisConnPoolImplTest, MakeRequestToRedisClusterHashtag) {
 
   absl::optional<envoy::api::v2::Cluster::CustomClusterType> cluster_type;
@@ -0,0 +1,160 @@
+#include <chrono>
+#include <string>
+
+#include "common/common/fmt.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/network/redis_proxy/local_cache_impl.h"
+
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+
+class RedisLocalCacheImplTest : public testing::Test {
+public:
+  void setup(uint32_t max_entries = 2, uint32_t hot_key_threshold = 2) {
+    envoy::config::filter::network::redis_proxy::v2::RedisProxy::LocalCache config;
+    const std::string yaml = fmt::format(R"EOF(
+prefixes: ["hot:", "warm:"]
+ttl: 10s
+max_entries: {}
+hot_key_threshold: {}
+)EOF",
+                                         max_entries, hot_key_threshold);
+    TestUtility::loadFromYaml(yaml, config);
+    cache_ = std::make_unique<LocalCacheImpl>(config, tls_, time_system_, store_,
+                                              "redis.foo.local_cache.");
+  }
+
+  Common::Redis::RespValue makeValue(const std::string& value) {
+    Common::Redis::RespValue resp_value;
+    resp_value.type(Common::Redis::RespType::BulkString);
+    resp_value.asString() = value;
+    return resp_value;
+  }
+
+  // Reads a key, and inserts the value read from upstream on a miss.
+  std::string read(const std::string& key, const std::string& upstream_value) {
+    uint32_t version;
+    Common::Redis::RespValuePtr value = cache_->lookup(key, version);
+    if (value) {
+      return value->asString();
+    }
+    cache_->insert(key, makeValue(upstream_value), version);
+    return upstream_value;
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counter("redis.foo.local_cache." + name).value();
+  }
+
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  std::unique_ptr<LocalCacheImpl> cache_;
+};
+
+TEST_F(RedisLocalCacheImplTest, Cacheable) {
+  setup();
+  EXPECT_TRUE(cache_->cacheable("hot:a"));
+  EXPECT_TRUE(cache_->cacheable("warm:"));
+  EXPECT_FALSE(cache_->cacheable("cold:a"));
+  EXPECT_FALSE(cache_->cacheable("hot"));
+}
+
+TEST_F(RedisLocalCacheImplTest, HotKeyCached) {
+  setup();
+
+  // The key is not hot on its first read.
+  EXPECT_EQ("1", read("hot:a", "1"));
+  EXPECT_EQ(0UL, counter("insert"));
+  EXPECT_EQ("2", read("hot:a", "2"));
+  EXPECT_EQ(1UL, counter("hot_key"));
+  EXPECT_EQ(1UL, counter("insert"));
+
+  EXPECT_EQ("2", read("hot:a", "3"));
+  EXPECT_EQ(1UL, counter("hit"));
+  EXPECT_EQ(2UL, counter("miss"));
+}
+
+TEST_F(RedisLocalCacheImplTest, Expired) {
+  setup();
+  read("hot:a", "1");
+  read("hot:a", "2");
+
+  time_system_.sleep(std::chrono::seconds(9));
+  EXPECT_EQ("2", read("hot:a", "3"));
+  time_system_.sleep(std::chrono::seconds(1));
+  EXPECT_EQ("4", read("hot:a", "4"));
+  EXPECT_EQ("4", read("hot:a", "5"));
+}
+
+TEST_F(RedisLocalCacheImplTest, Invalidated) {
+  setup();
+  read("hot:a", "1");
+  read("hot:a", "2");
+
+  cache_->invalidate("hot:a");
+  EXPECT_EQ(1UL, counter("invalidate"));
+  EXPECT_EQ("3", read("hot:a", "3"));
+  EXPECT_EQ("3", read("hot:a", "4"));
+}
+
+// A value read before a write of its key is not cached.
+TEST_F(RedisLocalCacheImplTest, WrittenWhileRead) {
+  setup(2, 1);
+
+  uint32_t version;
+  EXPECT_EQ(nullptr, cache_->lookup("hot:a", version));
+  cache_->invalidate("hot:a");
+  cache_->insert("hot:a", makeValue("1"), version);
+  EXPECT_EQ(0UL, counter("insert"));
+
+  EXPECT_EQ("2", read("hot:a", "2"));
+  EXPECT_EQ("2", read("hot:a", "3"));
+}
+
+TEST_F(RedisLocalCacheImplTest, LeastRecentlyUsedEvicted) {
+  setup(2, 1);
+  read("hot:a", "a");
+  read("hot:b", "b");
+  // Reading a makes b the least recently used.
+  EXPECT_EQ("a", read("hot:a", "a2"));
+  read("hot:c", "c");
+  EXPECT_EQ(1UL, counter("evict"));
+
+  EXPECT_EQ("a", read("hot:a", "a3"));
+  EXPECT_EQ("c", read("hot:c", "c2"));
+  EXPECT_EQ("b2", read("hot:b", "b2"));
+}
+
+TEST(RedisCountMinSketchTest, Halved) {
+  CountMinSketch sketch(4);
+  EXPECT_EQ(0U, sketch.estimate(1));
+  for (uint32_t i = 1; i <= 10; i++) {
+    EXPECT_EQ(i, sketch.increment(1));
+  }
+  EXPECT_EQ(10U, sketch.estimate(1));
+
+  // The counts are halved once 10 times the width of the sketch were counted. The two hashes do
+  // not share counters.
+  for (uint32_t i = 0; i < 30; i++) {
+    sketch.increment(2);
+  }
+  EXPECT_EQ(5U, sketch.estimate(1));
+  EXPECT_EQ(15U, sketch.estimate(2));
+}
+
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -3,6 +3,7 @@
 using testing::_;
 using testing::Invoke;
 using testing::Return;
+using testing::ReturnArg;
 using testing::ReturnRef;
 
 namespace Envoy {
@@ -13,6 +14,9 @@ namespace RedisProxy {
 MockRouter::MockRouter() = default;
 MockRouter::~MockRouter() = default;
 
+MockLocalCache::MockLocalCache() = default;
+MockLocalCache::~MockLocalCache() = default;
+
 MockRoute::MockRoute(ConnPool::InstanceSharedPtr conn_pool) : conn_pool_(std::move(conn_pool)) {
   ON_CALL(*this, upstream()).WillByDefault(Return(conn_pool_));
   ON_CALL(*this, mirrorPolicies()).WillByDefault(ReturnRef(policies_));
@@ -21,7 +25,10 @@ MockRoute::~MockRoute() = default;
 
 namespace ConnPool {
 
-MockInstance::MockInstance() = default;
+MockInstance::MockInstance() {
+  // Each key is sent to its own host, unless a test groups keys.
+  ON_CALL(*this, hashKey(_)).WillByDefault(ReturnArg<0>());
+}
 MockInstance::~MockInstance() = default;
 
 } // namespace ConnPool
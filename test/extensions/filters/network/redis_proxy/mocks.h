@@ -8,6 +8,7 @@
 #include "extensions/filters/network/common/redis/codec_impl.h"
 #include "extensions/filters/network/redis_proxy/command_splitter.h"
 #include "extensions/filters/network/redis_proxy/conn_pool.h"
+#include "extensions/filters/network/redis_proxy/local_cache.h"
 #include "extensions/filters/network/redis_proxy/router.h"
 
 #include "test/test_common/printers.h"
@@ -27,6 +28,22 @@ public:
   MOCK_METHOD1(upstreamPool, RouteSharedPtr(std::string& key));
 };
 
+class MockLocalCache : public LocalCache {
+public:
+  MockLocalCache();
+  ~MockLocalCache() override;
+
+  Common::Redis::RespValuePtr lookup(const std::string& key, uint32_t& version) override {
+    return Common::Redis::RespValuePtr{lookup_(key, version)};
+  }
+
+  MOCK_CONST_METHOD1(cacheable, bool(absl::string_view key));
+  MOCK_METHOD2(lookup_, Common::Redis::RespValue*(const std::string& key, uint32_t& version));
+  MOCK_METHOD3(insert, void(const std::string& key, const Common::Redis::RespValue& value,
+                            uint32_t version));
+  MOCK_METHOD1(invalidate, void(absl::string_view key));
+};
+
 class MockRoute : public Route {
 public:
   MockRoute(ConnPool::InstanceSharedPtr);
@@ -55,6 +72,7 @@ public:
                Common::Redis::Client::PoolRequest*(
                    const std::string& host_address, const Common::Redis::RespValue& request,
                    Common::Redis::Client::PoolCallbacks& callbacks));
+  MOCK_CONST_METHOD1(hashKey, absl::string_view(absl::string_view key));
 };
 
 } // namespace ConnPool
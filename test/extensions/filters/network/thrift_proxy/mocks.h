@@ -35,6 +35,7 @@ public:
   MOCK_METHOD0(stats, ThriftFilterStats&());
   MOCK_METHOD1(createDecoder, DecoderPtr(DecoderCallbacks&));
   MOCK_METHOD0(routerConfig, Router::Config&());
+  MOCK_CONST_METHOD0(payloadPassthrough, bool());
 };
 
 class MockTransport : public Transport {
@@ -125,6 +126,7 @@ public:
 
   // ThriftProxy::DecoderCallbacks
   MOCK_METHOD0(newDecoderEventHandler, DecoderEventHandler&());
+  MOCK_CONST_METHOD0(passthroughEnabled, bool());
 };
 
 class MockDecoderEventHandler : public DecoderEventHandler {
@@ -137,6 +139,7 @@ public:
   MOCK_METHOD0(transportEnd, FilterStatus());
   MOCK_METHOD1(messageBegin, FilterStatus(MessageMetadataSharedPtr metadata));
   MOCK_METHOD0(messageEnd, FilterStatus());
+  MOCK_METHOD1(passthroughData, FilterStatus(Buffer::Instance& data));
   MOCK_METHOD1(structBegin, FilterStatus(const absl::string_view name));
   MOCK_METHOD0(structEnd, FilterStatus());
   MOCK_METHOD3(fieldBegin,
@@ -199,12 +202,14 @@ public:
   MOCK_METHOD0(onDestroy, void());
   MOCK_METHOD1(setDecoderFilterCallbacks, void(DecoderFilterCallbacks& callbacks));
   MOCK_METHOD0(resetUpstreamConnection, void());
+  MOCK_CONST_METHOD0(passthroughSupported, bool());
 
   // ThriftProxy::DecoderEventHandler
   MOCK_METHOD1(transportBegin, FilterStatus(MessageMetadataSharedPtr metadata));
   MOCK_METHOD0(transportEnd, FilterStatus());
   MOCK_METHOD1(messageBegin, FilterStatus(MessageMetadataSharedPtr metadata));
   MOCK_METHOD0(messageEnd, FilterStatus());
+  MOCK_METHOD1(passthroughData, FilterStatus(Buffer::Instance& data));
   MOCK_METHOD1(structBegin, FilterStatus(absl::string_view name));
   MOCK_METHOD0(structEnd, FilterStatus());
   MOCK_METHOD3(fieldBegin,
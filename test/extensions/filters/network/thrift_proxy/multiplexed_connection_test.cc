@@ -0,0 +1,275 @@
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/network/thrift_proxy/binary_protocol_impl.h"
+#include "extensions/filters/network/thrift_proxy/framed_transport_impl.h"
+#include "extensions/filters/network/thrift_proxy/router/multiplexed_connection.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/tcp/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::InSequence;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace ThriftProxy {
+namespace Router {
+
+class MockMultiplexedRequestCallbacks : public MultiplexedRequestCallbacks {
+public:
+  MOCK_METHOD2(onPoolFailure, void(Tcp::ConnectionPool::PoolFailureReason reason,
+                                   Upstream::HostDescriptionConstSharedPtr host));
+  void onPoolReady(MultiplexedRequestPtr&& request,
+                   Upstream::HostDescriptionConstSharedPtr) override {
+    request_ = std::move(request);
+    request_->addUpstreamCallbacks(upstream_callbacks_);
+  }
+
+  MultiplexedRequestPtr request_;
+  NiceMock<Tcp::ConnectionPool::MockUpstreamCallbacks> upstream_callbacks_;
+};
+
+class ThriftMultiplexedConnectionTest : public testing::Test {
+public:
+  ThriftMultiplexedConnectionTest() {
+    ON_CALL(*pool_.connection_data_, addUpstreamCallbacks(_))
+        .WillByDefault(Invoke([this](Tcp::ConnectionPool::UpstreamCallbacks& callbacks) -> void {
+          upstream_callbacks_ = &callbacks;
+        }));
+    ON_CALL(*pool_.connection_data_, connectionState())
+        .WillByDefault(Invoke(
+            [this]() -> Tcp::ConnectionPool::ConnectionState* { return conn_state_.get(); }));
+    ON_CALL(*pool_.connection_data_, setConnectionState_(_))
+        .WillByDefault(Invoke(
+            [this](Tcp::ConnectionPool::ConnectionStatePtr& cs) -> void { conn_state_.swap(cs); }));
+  }
+
+  MultiplexedConnection& connection() {
+    return registry_.connection(pool_, TransportType::Framed, ProtocolType::Binary);
+  }
+
+  void startRequests(std::vector<MockMultiplexedRequestCallbacks>& callbacks) {
+    EXPECT_CALL(pool_, newConnection(_));
+    for (auto& cb : callbacks) {
+      EXPECT_NE(nullptr, connection().newRequest(cb));
+    }
+    pool_.poolReady(connection_);
+    for (auto& cb : callbacks) {
+      ASSERT_NE(nullptr, cb.request_);
+    }
+  }
+
+  // Encodes a framed, binary response with an empty result.
+  void writeResponse(Buffer::Instance& buffer, int32_t sequence_id) {
+    MessageMetadata metadata;
+    metadata.setMethodName("method");
+    metadata.setMessageType(MessageType::Reply);
+    metadata.setSequenceId(sequence_id);
+
+    Buffer::OwnedImpl message;
+    protocol_.writeMessageBegin(message, metadata);
+    protocol_.writeStructBegin(message, "");
+    protocol_.writeFieldBegin(message, "", FieldType::Stop, 0);
+    protocol_.writeStructEnd(message);
+    protocol_.writeMessageEnd(message);
+    transport_.encodeFrame(buffer, metadata, message);
+  }
+
+  void onUpstreamData(Buffer::Instance& data) {
+    ASSERT_NE(nullptr, upstream_callbacks_);
+    upstream_callbacks_->onUpstreamData(data, false);
+  }
+
+  FramedTransportImpl transport_;
+  BinaryProtocolImpl protocol_;
+  NiceMock<Tcp::ConnectionPool::MockInstance> pool_;
+  NiceMock<Network::MockClientConnection> connection_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  MultiplexedConnectionRegistry registry_{dispatcher_};
+  Tcp::ConnectionPool::ConnectionStatePtr conn_state_;
+  Tcp::ConnectionPool::UpstreamCallbacks* upstream_callbacks_{};
+};
+
+TEST_F(ThriftMultiplexedConnectionTest, Supported) {
+  EXPECT_TRUE(
+      MultiplexedConnectionRegistry::supported(TransportType::Framed, ProtocolType::Binary));
+  EXPECT_TRUE(
+      MultiplexedConnectionRegistry::supported(TransportType::Header, ProtocolType::Compact));
+  EXPECT_FALSE(
+      MultiplexedConnectionRegistry::supported(TransportType::Unframed, ProtocolType::Binary));
+  EXPECT_FALSE(
+      MultiplexedConnectionRegistry::supported(TransportType::Framed, ProtocolType::Twitter));
+}
+
+TEST_F(ThriftMultiplexedConnectionTest, SharesConnectionAndMatchesResponses) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(2);
+  startRequests(callbacks);
+  EXPECT_EQ(0, callbacks[0].request_->sequenceId());
+  EXPECT_EQ(1, callbacks[1].request_->sequenceId());
+
+  EXPECT_CALL(connection_, write(_, false)).Times(2);
+  Buffer::OwnedImpl request("request");
+  callbacks[0].request_->write(request, true);
+  request.add("request");
+  callbacks[1].request_->write(request, true);
+
+  // A request started once connected does not wait for the pool.
+  MockMultiplexedRequestCallbacks third;
+  EXPECT_EQ(nullptr, connection().newRequest(third));
+  ASSERT_NE(nullptr, third.request_);
+  EXPECT_EQ(2, third.request_->sequenceId());
+
+  // Responses are received out of order, with a partial frame first.
+  Buffer::OwnedImpl response;
+  writeResponse(response, 1);
+  const uint64_t frame_length = response.length();
+  writeResponse(response, 0);
+  Buffer::OwnedImpl partial;
+  partial.move(response, frame_length - 1);
+
+  EXPECT_CALL(callbacks[0].upstream_callbacks_, onUpstreamData(_, _)).Times(0);
+  EXPECT_CALL(callbacks[1].upstream_callbacks_, onUpstreamData(_, _)).Times(0);
+  onUpstreamData(partial);
+
+  InSequence s;
+  EXPECT_CALL(callbacks[1].upstream_callbacks_, onUpstreamData(_, false))
+      .WillOnce(Invoke([frame_length](Buffer::Instance& data, bool) -> void {
+        EXPECT_EQ(frame_length, data.length());
+      }));
+  EXPECT_CALL(callbacks[0].upstream_callbacks_, onUpstreamData(_, false));
+  partial.move(response);
+  onUpstreamData(partial);
+
+  // The connection is released with the last request.
+  EXPECT_CALL(pool_, released(_)).Times(0);
+  callbacks[0].request_.reset();
+  callbacks[1].request_.reset();
+  EXPECT_CALL(pool_, released(_));
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  third.request_.reset();
+}
+
+TEST_F(ThriftMultiplexedConnectionTest, ContinuesSequenceIdsOfConnection) {
+  conn_state_ = std::make_unique<ThriftConnectionState>(10);
+
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(1);
+  startRequests(callbacks);
+  EXPECT_EQ(10, callbacks[0].request_->sequenceId());
+}
+
+TEST_F(ThriftMultiplexedConnectionTest, KeepsConnectionUntilAbandonedResponse) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(1);
+  startRequests(callbacks);
+
+  Buffer::OwnedImpl request("request");
+  callbacks[0].request_->write(request, true);
+
+  EXPECT_CALL(pool_, released(_)).Times(0);
+  callbacks[0].request_.reset();
+
+  // Responses of unknown requests are dropped.
+  Buffer::OwnedImpl response;
+  writeResponse(response, 7);
+  onUpstreamData(response);
+
+  EXPECT_CALL(pool_, released(_));
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  writeResponse(response, 0);
+  onUpstreamData(response);
+}
+
+TEST_F(ThriftMultiplexedConnectionTest, ReleasesConnectionAfterOnewayRequest) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(1);
+  startRequests(callbacks);
+
+  Buffer::OwnedImpl request("request");
+  callbacks[0].request_->write(request, false);
+
+  EXPECT_CALL(pool_, released(_));
+  callbacks[0].request_.reset();
+}
+
+TEST_F(ThriftMultiplexedConnectionTest, ClosesConnectionOnInvalidFrameSize) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(1);
+  startRequests(callbacks);
+
+  Buffer::OwnedImpl response;
+  response.writeBEInt<int32_t>(-1);
+  EXPECT_CALL(connection_, close(Network::ConnectionCloseType::NoFlush));
+  onUpstreamData(response);
+}
+
+TEST_F(ThriftMultiplexedConnectionTest, ClosesConnectionOnInvalidResponse) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(1);
+  startRequests(callbacks);
+
+  Buffer::OwnedImpl response;
+  response.writeBEInt<int32_t>(4);
+  response.writeBEInt<int32_t>(0);
+  EXPECT_CALL(callbacks[0].upstream_callbacks_, onUpstreamData(_, _)).Times(0);
+  EXPECT_CALL(connection_, close(Network::ConnectionCloseType::NoFlush));
+  onUpstreamData(response);
+}
+
+TEST_F(ThriftMultiplexedConnectionTest, NotifiesRequestsOnClose) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(2);
+  startRequests(callbacks);
+
+  EXPECT_CALL(callbacks[0].upstream_callbacks_, onEvent(Network::ConnectionEvent::RemoteClose))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { callbacks[0].request_.reset(); }));
+  EXPECT_CALL(callbacks[1].upstream_callbacks_, onEvent(Network::ConnectionEvent::RemoteClose));
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
+
+  // Writing on a closed connection is a no-op.
+  EXPECT_CALL(connection_, write(_, _)).Times(0);
+  Buffer::OwnedImpl request("request");
+  callbacks[1].request_->write(request, true);
+  EXPECT_EQ(0, request.length());
+  callbacks[1].request_.reset();
+
+  // The next request opens a new connection.
+  MockMultiplexedRequestCallbacks next;
+  EXPECT_CALL(pool_, newConnection(_));
+  EXPECT_NE(nullptr, connection().newRequest(next));
+}
+
+TEST_F(ThriftMultiplexedConnectionTest, NotifiesPendingRequestsOnPoolFailure) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(2);
+  EXPECT_CALL(pool_, newConnection(_));
+  EXPECT_NE(nullptr, connection().newRequest(callbacks[0]));
+  EXPECT_NE(nullptr, connection().newRequest(callbacks[1]));
+
+  for (auto& cb : callbacks) {
+    EXPECT_CALL(cb, onPoolFailure(Tcp::ConnectionPool::PoolFailureReason::Timeout, _));
+  }
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  pool_.poolFailure(Tcp::ConnectionPool::PoolFailureReason::Timeout);
+}
+
+TEST_F(ThriftMultiplexedConnectionTest, CancelsConnectionWithLastPendingRequest) {
+  std::vector<MockMultiplexedRequestCallbacks> callbacks(2);
+  EXPECT_CALL(pool_, newConnection(_));
+  Tcp::ConnectionPool::Cancellable* first = connection().newRequest(callbacks[0]);
+  Tcp::ConnectionPool::Cancellable* second = connection().newRequest(callbacks[1]);
+
+  EXPECT_CALL(pool_.handles_.front(), cancel(_)).Times(0);
+  first->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+
+  EXPECT_CALL(pool_.handles_.front(), cancel(Tcp::ConnectionPool::CancelPolicy::Default));
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  second->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+}
+
+} // namespace Router
+} // namespace ThriftProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -953,6 +953,107 @@ TEST_F(ZooKeeperFilterTest, WatchEvent) {
   EXPECT_EQ(0UL, config_->stats().decoder_error_.value());
 }
 
+// The latency histograms of the responses are named from stat names built with the config.
+TEST_F(ZooKeeperFilterTest, ResponseLatencyStatNames) {
+  initialize();
+
+  Buffer::OwnedImpl data = encodePathWatch("/foo", true);
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(data, false));
+  time_system_.sleep(std::chrono::milliseconds(5));
+  data = encodeResponseHeader(1000, 2000, 0);
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onWrite(data, false));
+
+  EXPECT_EQ(1UL, config_->stats().getdata_resp_.value());
+  EXPECT_NE(absl::nullopt, findHistogram("test.zookeeper.getdata_resp_latency"));
+  EXPECT_EQ(0UL, config_->stat_name_set_.dynamicEncodings());
+}
+
+// A response whose request was not seen is counted, and skipped.
+TEST_F(ZooKeeperFilterTest, UntrackedResponse) {
+  initialize();
+
+  Buffer::OwnedImpl data = encodeResponseHeader(1000, 2000, 0);
+  expectSetDynamicMetadata({{{"opname", "untracked_resp"}, {"xid", "1000"}}, {{"bytes", "20"}}});
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onWrite(data, false));
+  EXPECT_EQ(1UL, config_->stats().untracked_resp_.value());
+  EXPECT_EQ(20UL, config_->stats().response_bytes_.value());
+  EXPECT_EQ(0UL, config_->stats().decoder_error_.value());
+}
+
+// The requests beyond the capacity of the in flight table are not tracked.
+TEST_F(ZooKeeperFilterTest, TooManyRequestsInFlight) {
+  initialize();
+
+  for (uint32_t xid = 1; xid <= InflightRequests::Capacity + 1; xid++) {
+    Buffer::OwnedImpl data = encodeSetWatchesRequest({}, {}, {}, xid);
+    EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onData(data, false));
+  }
+  EXPECT_EQ(InflightRequests::Capacity + 1, config_->stats().setwatches_rq_.value());
+
+  Buffer::OwnedImpl data = encodeResponseHeader(InflightRequests::Capacity + 1, 2000, 0);
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onWrite(data, false));
+  EXPECT_EQ(1UL, config_->stats().untracked_resp_.value());
+
+  data = encodeResponseHeader(1, 2000, 0);
+  EXPECT_EQ(Envoy::Network::FilterStatus::Continue, filter_->onWrite(data, false));
+  EXPECT_EQ(1UL, config_->stats().setwatches_resp_.value());
+  EXPECT_EQ(0UL, config_->stats().decoder_error_.value());
+}
+
+TEST(InflightRequestsTest, InsertRemove) {
+  InflightRequests requests;
+  const MonotonicTime start_time{};
+
+  EXPECT_TRUE(requests.insert(1, OpCodes::GETDATA, start_time));
+  EXPECT_TRUE(requests.insert(enumToSignedInt(XidCodes::PING_XID), OpCodes::PING, start_time));
+  // A request for the same xid replaces the previous one.
+  EXPECT_TRUE(requests.insert(1, OpCodes::SETDATA, start_time));
+  EXPECT_EQ(2U, requests.size());
+
+  EXPECT_FALSE(requests.remove(2).has_value());
+  const auto request = requests.remove(1);
+  ASSERT_TRUE(request.has_value());
+  EXPECT_EQ(OpCodes::SETDATA, request->opcode);
+  EXPECT_FALSE(requests.remove(1).has_value());
+  EXPECT_EQ(OpCodes::PING, requests.remove(enumToSignedInt(XidCodes::PING_XID))->opcode);
+  EXPECT_EQ(0U, requests.size());
+}
+
+// The requests colliding on a slot are found once the requests before them are removed.
+TEST(InflightRequestsTest, Collisions) {
+  InflightRequests requests;
+  const MonotonicTime start_time{};
+  const int32_t capacity = InflightRequests::Capacity;
+
+  EXPECT_TRUE(requests.insert(1, OpCodes::GETDATA, start_time));
+  EXPECT_TRUE(requests.insert(1 + capacity, OpCodes::SETDATA, start_time));
+  EXPECT_TRUE(requests.insert(2, OpCodes::EXISTS, start_time));
+  EXPECT_TRUE(requests.insert(1 + 2 * capacity, OpCodes::DELETE, start_time));
+
+  EXPECT_EQ(OpCodes::GETDATA, requests.remove(1)->opcode);
+  EXPECT_EQ(OpCodes::DELETE, requests.remove(1 + 2 * capacity)->opcode);
+  EXPECT_EQ(OpCodes::EXISTS, requests.remove(2)->opcode);
+  EXPECT_EQ(OpCodes::SETDATA, requests.remove(1 + capacity)->opcode);
+  EXPECT_EQ(0U, requests.size());
+}
+
+TEST(InflightRequestsTest, Full) {
+  InflightRequests requests;
+  const MonotonicTime start_time{};
+
+  for (uint32_t xid = 0; xid < InflightRequests::Capacity; xid++) {
+    EXPECT_TRUE(requests.insert(xid, OpCodes::GETDATA, start_time));
+  }
+  EXPECT_FALSE(requests.insert(InflightRequests::Capacity, OpCodes::GETDATA, start_time));
+  EXPECT_FALSE(requests.remove(InflightRequests::Capacity).has_value());
+  // A request already tracked is still replaced.
+  EXPECT_TRUE(requests.insert(0, OpCodes::SETDATA, start_time));
+
+  EXPECT_EQ(OpCodes::SETDATA, requests.remove(0)->opcode);
+  EXPECT_TRUE(requests.insert(InflightRequests::Capacity, OpCodes::EXISTS, start_time));
+  EXPECT_EQ(OpCodes::EXISTS, requests.remove(InflightRequests::Capacity)->opcode);
+}
+
 } // namespace ZooKeeperProxy
 } // namespace NetworkFilters
 } // namespace Extensions
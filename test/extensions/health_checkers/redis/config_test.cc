@@ -1,3 +1,4 @@
+#include "common/singleton/manager_impl.h"
 #include "common/upstream/health_checker_impl.h"
 
 #include "extensions/health_checkers/redis/config.h"
@@ -7,6 +8,7 @@
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/utility.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -106,11 +108,13 @@ TEST(HealthCheckerFactoryTest, CreateRedisViaUpstreamHealthCheckerFactory) {
   Runtime::MockRandomGenerator random;
   Event::MockDispatcher dispatcher;
   AccessLog::MockAccessLogManager log_manager;
+  Singleton::ManagerImpl singleton_manager{Thread::threadFactoryForTest()};
 
   EXPECT_NE(nullptr, dynamic_cast<CustomRedisHealthChecker*>(
                          Upstream::HealthCheckerFactory::create(
                              Upstream::parseHealthCheckFromV2Yaml(yaml), cluster, runtime, random,
-                             dispatcher, log_manager, ProtobufMessage::getStrictValidationVisitor())
+                             dispatcher, log_manager, ProtobufMessage::getStrictValidationVisitor(),
+                             singleton_manager, nullptr)
                              .get()));
 }
 } // namespace
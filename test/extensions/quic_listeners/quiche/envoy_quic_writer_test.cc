@@ -1,5 +1,6 @@
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/network/io_socket_error_impl.h"
 
@@ -7,6 +8,8 @@
 
 #include "test/mocks/network/mocks.h"
 
+#include "absl/strings/str_cat.h"
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -130,5 +133,132 @@ TEST_F(EnvoyQuicWriterTest, SendFailureMessageTooBig) {
   EXPECT_FALSE(envoy_quic_writer_.IsWriteBlocked());
 }
 
+class EnvoyQuicBatchWriterTest : public ::testing::Test {
+public:
+  EnvoyQuicBatchWriterTest() : envoy_quic_writer_(udp_listener_) {
+    self_address_.FromString("0.0.0.0");
+    quic::QuicIpAddress peer_ip;
+    peer_ip.FromString("127.0.0.1");
+    peer_address_ = quic::QuicSocketAddress(peer_ip, /*port=*/123);
+    other_peer_address_ = quic::QuicSocketAddress(peer_ip, /*port=*/456);
+    EXPECT_CALL(udp_listener_, onDestroy());
+  }
+
+  std::vector<std::string> packets(const Network::UdpSendBatchData& send_data) {
+    std::vector<std::string> packets;
+    for (uint64_t i = 0; i < send_data.num_packets_; i++) {
+      packets.emplace_back(static_cast<const char*>(send_data.packets_[i].mem_),
+                           send_data.packets_[i].len_);
+    }
+    return packets;
+  }
+
+  quic::WriteResult writePacket(const std::string& str, const quic::QuicSocketAddress& peer) {
+    return envoy_quic_writer_.WritePacket(str.data(), str.length(), self_address_, peer, nullptr);
+  }
+
+protected:
+  testing::NiceMock<Network::MockUdpListener> udp_listener_;
+  quic::QuicIpAddress self_address_;
+  quic::QuicSocketAddress peer_address_;
+  quic::QuicSocketAddress other_peer_address_;
+  EnvoyQuicBatchPacketWriter envoy_quic_writer_;
+};
+
+TEST_F(EnvoyQuicBatchWriterTest, BatchedUntilFlush) {
+  EXPECT_TRUE(envoy_quic_writer_.IsBatchMode());
+  EXPECT_CALL(udp_listener_, sendBatch(_)).Times(0);
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writePacket("first", peer_address_).status);
+
+  // A packet serialized in place is not copied.
+  char* location = envoy_quic_writer_.GetNextWriteLocation(self_address_, peer_address_);
+  ASSERT_NE(nullptr, location);
+  memcpy(location, "second", 6);
+  quic::WriteResult result =
+      envoy_quic_writer_.WritePacket(location, 6, self_address_, peer_address_, nullptr);
+  EXPECT_EQ(quic::WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(0, result.bytes_written);
+  EXPECT_EQ(2, envoy_quic_writer_.numBufferedPackets());
+
+  EXPECT_CALL(udp_listener_, sendBatch(_))
+      .WillOnce(testing::Invoke([this](const Network::UdpSendBatchData& send_data) {
+        EXPECT_EQ(peer_address_.ToString(), send_data.peer_address_.asString());
+        EXPECT_EQ(self_address_.ToString(), send_data.local_ip_->addressAsString());
+        EXPECT_EQ((std::vector<std::string>{"first", "second"}), packets(send_data));
+        return Api::IoCallUint64Result(
+            2u, Api::IoErrorPtr(nullptr, Network::IoSocketError::deleteIoError));
+      }));
+  result = envoy_quic_writer_.Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(11, result.bytes_written);
+  EXPECT_EQ(0, envoy_quic_writer_.numBufferedPackets());
+}
+
+TEST_F(EnvoyQuicBatchWriterTest, OtherPeerFlushesBatch) {
+  writePacket("first", peer_address_);
+  EXPECT_EQ(nullptr, envoy_quic_writer_.GetNextWriteLocation(self_address_, other_peer_address_));
+
+  EXPECT_CALL(udp_listener_, sendBatch(_))
+      .WillOnce(testing::Invoke([this](const Network::UdpSendBatchData& send_data) {
+        EXPECT_EQ(peer_address_.ToString(), send_data.peer_address_.asString());
+        EXPECT_EQ((std::vector<std::string>{"first"}), packets(send_data));
+        return Api::IoCallUint64Result(
+            1u, Api::IoErrorPtr(nullptr, Network::IoSocketError::deleteIoError));
+      }));
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writePacket("second", other_peer_address_).status);
+  EXPECT_EQ(1, envoy_quic_writer_.numBufferedPackets());
+}
+
+TEST_F(EnvoyQuicBatchWriterTest, FullBatchBlocked) {
+  for (size_t i = 0; i < EnvoyQuicBatchPacketWriter::MaxBatchPackets - 1; i++) {
+    EXPECT_EQ(quic::WRITE_STATUS_OK, writePacket(absl::StrCat("packet ", i), peer_address_).status);
+  }
+
+  // The full batch is sent, and the packets after the first 10 are blocked.
+  EXPECT_CALL(udp_listener_, sendBatch(_))
+      .WillOnce(testing::Invoke([](const Network::UdpSendBatchData& send_data) {
+        EXPECT_EQ(EnvoyQuicBatchPacketWriter::MaxBatchPackets, send_data.num_packets_);
+        return Api::IoCallUint64Result(
+            10u, Api::IoErrorPtr(Network::IoSocketError::getIoSocketEagainInstance(),
+                                 Network::IoSocketError::deleteIoError));
+      }));
+  quic::WriteResult result = writePacket("last", peer_address_);
+  EXPECT_EQ(quic::WRITE_STATUS_BLOCKED_DATA_BUFFERED, result.status);
+  EXPECT_TRUE(envoy_quic_writer_.IsWriteBlocked());
+  EXPECT_EQ(EnvoyQuicBatchPacketWriter::MaxBatchPackets - 10,
+            envoy_quic_writer_.numBufferedPackets());
+
+  envoy_quic_writer_.SetWritable();
+  EXPECT_CALL(udp_listener_, sendBatch(_))
+      .WillOnce(testing::Invoke([this](const Network::UdpSendBatchData& send_data) {
+        std::vector<std::string> expected;
+        for (size_t i = 10; i < EnvoyQuicBatchPacketWriter::MaxBatchPackets - 1; i++) {
+          expected.push_back(absl::StrCat("packet ", i));
+        }
+        expected.push_back("last");
+        EXPECT_EQ(expected, packets(send_data));
+        return Api::IoCallUint64Result(
+            send_data.num_packets_,
+            Api::IoErrorPtr(nullptr, Network::IoSocketError::deleteIoError));
+      }));
+  EXPECT_EQ(quic::WRITE_STATUS_OK, envoy_quic_writer_.Flush().status);
+  EXPECT_EQ(0, envoy_quic_writer_.numBufferedPackets());
+}
+
+TEST_F(EnvoyQuicBatchWriterTest, FlushFailureDropsBatch) {
+  writePacket("first", peer_address_);
+  EXPECT_CALL(udp_listener_, sendBatch(_))
+      .WillOnce(testing::Invoke([](const Network::UdpSendBatchData&) {
+        return Api::IoCallUint64Result(0u,
+                                       Api::IoErrorPtr(new Network::IoSocketError(ENOTSUP),
+                                                       Network::IoSocketError::deleteIoError));
+      }));
+  quic::WriteResult result = envoy_quic_writer_.Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_ERROR, result.status);
+  EXPECT_EQ(static_cast<int>(Api::IoError::IoErrorCode::NoSupport), result.error_code);
+  EXPECT_FALSE(envoy_quic_writer_.IsWriteBlocked());
+  EXPECT_EQ(0, envoy_quic_writer_.numBufferedPackets());
+}
+
 } // namespace Quic
 } // namespace Envoy
@@ -0,0 +1,51 @@
+#include "extensions/resource_monitors/active_requests/active_requests_monitor.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace ActiveRequestsMonitor {
+namespace {
+
+class MockedCallbacks : public Server::ResourceMonitor::Callbacks {
+public:
+  MOCK_METHOD1(onSuccess, void(const Server::ResourceUsage&));
+  MOCK_METHOD1(onFailure, void(const EnvoyException&));
+};
+
+MATCHER_P(ResourcePressure, pressure, "") { return arg.resource_pressure_ == pressure; }
+
+TEST(ActiveRequestsMonitorTest, ReportsRequestsOfLastProbe) {
+  envoy::config::resource_monitor::active_requests::v2alpha::ActiveRequestsConfig config;
+  config.set_max_active_requests(100);
+  Event::SimulatedTimeSystem time_system;
+  NiceMock<ThreadLocal::MockInstance> tls;
+  NiceMock<Server::MockOverloadManager> overload_manager;
+  ActiveRequestsMonitor monitor(config, tls, time_system, overload_manager);
+  MockedCallbacks callbacks;
+
+  // The mock runs the probe on a single thread as it is posted, and the monitor reports the count
+  // at the next update.
+  overload_manager.overload_state_.activeRequests() = 30;
+  EXPECT_CALL(callbacks, onSuccess(ResourcePressure(0.0)));
+  monitor.updateResourceUsage(callbacks);
+  overload_manager.overload_state_.activeRequests() = 120;
+  EXPECT_CALL(callbacks, onSuccess(ResourcePressure(0.3)));
+  monitor.updateResourceUsage(callbacks);
+  EXPECT_CALL(callbacks, onSuccess(ResourcePressure(1.2)));
+  monitor.updateResourceUsage(callbacks);
+}
+
+} // namespace
+} // namespace ActiveRequestsMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
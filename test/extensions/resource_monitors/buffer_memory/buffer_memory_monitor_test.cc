@@ -0,0 +1,71 @@
+#include "common/buffer/watermark_buffer.h"
+
+#include "extensions/resource_monitors/buffer_memory/buffer_memory_monitor.h"
+
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace BufferMemoryMonitor {
+namespace {
+
+class MockedCallbacks : public Server::ResourceMonitor::Callbacks {
+public:
+  MOCK_METHOD1(onSuccess, void(const Server::ResourceUsage&));
+  MOCK_METHOD1(onFailure, void(const EnvoyException&));
+};
+
+MATCHER_P(ResourcePressure, pressure, "") { return arg.resource_pressure_ == pressure; }
+
+class BufferMemoryMonitorTest : public testing::Test {
+protected:
+  BufferMemoryMonitorTest() : buffer_([]() {}, []() {}) {}
+
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  MockedCallbacks callbacks_;
+  Buffer::WatermarkBuffer buffer_;
+};
+
+TEST_F(BufferMemoryMonitorTest, ReportsBytesOfLastProbe) {
+  envoy::config::resource_monitor::buffer_memory::v2alpha::BufferMemoryConfig config;
+  config.set_max_buffered_bytes(1000);
+  BufferMemoryMonitor monitor(config, tls_, time_system_);
+
+  // The mock runs the probe on a single thread as it is posted, and the monitor reports the bytes
+  // at the next update.
+  buffer_.add(std::string(300, 'a'));
+  EXPECT_CALL(callbacks_, onSuccess(ResourcePressure(0.0)));
+  monitor.updateResourceUsage(callbacks_);
+  buffer_.drain(200);
+  EXPECT_CALL(callbacks_, onSuccess(ResourcePressure(0.3)));
+  monitor.updateResourceUsage(callbacks_);
+  EXPECT_CALL(callbacks_, onSuccess(ResourcePressure(0.1)));
+  monitor.updateResourceUsage(callbacks_);
+}
+
+TEST_F(BufferMemoryMonitorTest, ReportsLargerOfProcessAndWorkerPressure) {
+  envoy::config::resource_monitor::buffer_memory::v2alpha::BufferMemoryConfig config;
+  config.set_max_buffered_bytes(1000);
+  config.set_max_worker_buffered_bytes(200);
+  BufferMemoryMonitor monitor(config, tls_, time_system_);
+
+  buffer_.add(std::string(100, 'a'));
+  EXPECT_CALL(callbacks_, onSuccess(ResourcePressure(0.0)));
+  monitor.updateResourceUsage(callbacks_);
+  EXPECT_CALL(callbacks_, onSuccess(ResourcePressure(0.5)));
+  monitor.updateResourceUsage(callbacks_);
+}
+
+} // namespace
+} // namespace BufferMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
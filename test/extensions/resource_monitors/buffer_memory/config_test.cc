@@ -0,0 +1,44 @@
+#include "envoy/config/resource_monitor/buffer_memory/v2alpha/buffer_memory.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "server/resource_monitor_config_impl.h"
+
+#include "extensions/resource_monitors/buffer_memory/config.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace BufferMemoryMonitor {
+namespace {
+
+TEST(BufferMemoryMonitorFactoryTest, CreateMonitor) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.buffer_memory");
+  EXPECT_NE(factory, nullptr);
+
+  envoy::config::resource_monitor::buffer_memory::v2alpha::BufferMemoryConfig config;
+  config.set_max_buffered_bytes(1 << 20);
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<ThreadLocal::MockInstance> tls;
+  NiceMock<Server::MockOverloadManager> overload_manager;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(dispatcher, *api, tls,
+                                                                   overload_manager);
+  auto monitor = factory->createResourceMonitor(config, context);
+  EXPECT_NE(monitor, nullptr);
+}
+
+} // namespace
+} // namespace BufferMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,119 @@
+#include "extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/types/optional.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+namespace {
+
+class ResourcePressure : public Server::ResourceMonitor::Callbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+  }
+
+  void onFailure(const EnvoyException& error) override { error_ = error; }
+
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+class CgroupMemoryMonitorTest : public testing::Test {
+protected:
+  CgroupMemoryMonitorTest() : api_(Api::createApiForTest()) {}
+
+  // Writes the files of a cgroup under a new temporary directory, in the subdirectory of the
+  // memory controller if given.
+  std::string writeCgroup(const std::string& name, const std::string& subdirectory,
+                          const std::vector<std::pair<std::string, std::string>>& files) {
+    const std::string root = TestEnvironment::temporaryPath(name);
+    const std::string directory = subdirectory.empty() ? root : root + "/" + subdirectory;
+    TestEnvironment::createPath(directory);
+    for (const auto& file : files) {
+      TestEnvironment::writeStringToFileForTest(directory + "/" + file.first, file.second, true);
+    }
+    return root;
+  }
+
+  ResourcePressure update(const std::string& cgroup_path, uint64_t max_memory_bytes = 0) {
+    envoy::config::resource_monitor::cgroup_memory::v2alpha::CgroupMemoryConfig config;
+    config.set_cgroup_path(cgroup_path);
+    config.set_max_memory_bytes(max_memory_bytes);
+    CgroupMemoryMonitor monitor(config, api_->fileSystem());
+    ResourcePressure pressure;
+    monitor.updateResourceUsage(pressure);
+    return pressure;
+  }
+
+  Api::ApiPtr api_;
+};
+
+TEST_F(CgroupMemoryMonitorTest, CgroupV2) {
+  const std::string root = writeCgroup("cgroup_v2", "",
+                                       {{"memory.current", "800\n"},
+                                        {"memory.max", "1000\n"},
+                                        {"memory.stat", "anon 500\ninactive_file 200\n"}});
+  ResourcePressure pressure = update(root);
+  ASSERT_TRUE(pressure.pressure_.has_value());
+  EXPECT_DOUBLE_EQ(0.6, *pressure.pressure_);
+
+  // A lower configured maximum takes precedence over the limit of the cgroup.
+  pressure = update(root, 800);
+  ASSERT_TRUE(pressure.pressure_.has_value());
+  EXPECT_DOUBLE_EQ(0.75, *pressure.pressure_);
+  pressure = update(root, 2000);
+  ASSERT_TRUE(pressure.pressure_.has_value());
+  EXPECT_DOUBLE_EQ(0.6, *pressure.pressure_);
+}
+
+TEST_F(CgroupMemoryMonitorTest, CgroupV2WithoutLimit) {
+  const std::string root = writeCgroup("cgroup_v2_unlimited", "",
+                                       {{"memory.current", "800\n"},
+                                        {"memory.max", "max\n"},
+                                        {"memory.stat", "anon 800\n"}});
+  ResourcePressure pressure = update(root);
+  EXPECT_FALSE(pressure.pressure_.has_value());
+  ASSERT_TRUE(pressure.error_.has_value());
+
+  pressure = update(root, 1600);
+  ASSERT_TRUE(pressure.pressure_.has_value());
+  EXPECT_DOUBLE_EQ(0.5, *pressure.pressure_);
+}
+
+TEST_F(CgroupMemoryMonitorTest, CgroupV1) {
+  const std::string root =
+      writeCgroup("cgroup_v1", "memory",
+                  {{"memory.usage_in_bytes", "900\n"},
+                   {"memory.limit_in_bytes", "1000\n"},
+                   {"memory.stat", "cache 400\ninactive_file 1\ntotal_inactive_file 300\n"}});
+  ResourcePressure pressure = update(root);
+  ASSERT_TRUE(pressure.pressure_.has_value());
+  EXPECT_DOUBLE_EQ(0.6, *pressure.pressure_);
+}
+
+TEST_F(CgroupMemoryMonitorTest, Malformed) {
+  const std::string root = writeCgroup("cgroup_malformed", "",
+                                       {{"memory.current", "lots\n"},
+                                        {"memory.max", "1000\n"},
+                                        {"memory.stat", ""}});
+  ResourcePressure pressure = update(root);
+  EXPECT_FALSE(pressure.pressure_.has_value());
+  ASSERT_TRUE(pressure.error_.has_value());
+
+  // Neither version of the cgroup hierarchy.
+  pressure = update(TestEnvironment::temporaryPath("cgroup_missing"), 1000);
+  EXPECT_FALSE(pressure.pressure_.has_value());
+  EXPECT_TRUE(pressure.error_.has_value());
+}
+
+} // namespace
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
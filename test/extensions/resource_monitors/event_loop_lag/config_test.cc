@@ -0,0 +1,44 @@
+#include "envoy/config/resource_monitor/event_loop_lag/v2alpha/event_loop_lag.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "server/resource_monitor_config_impl.h"
+
+#include "extensions/resource_monitors/event_loop_lag/config.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopLagMonitor {
+namespace {
+
+TEST(EventLoopLagMonitorFactoryTest, CreateMonitor) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.event_loop_lag");
+  EXPECT_NE(factory, nullptr);
+
+  envoy::config::resource_monitor::event_loop_lag::v2alpha::EventLoopLagConfig config;
+  config.mutable_max_lag()->set_seconds(1);
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<ThreadLocal::MockInstance> tls;
+  NiceMock<Server::MockOverloadManager> overload_manager;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(dispatcher, *api, tls,
+                                                                   overload_manager);
+  auto monitor = factory->createResourceMonitor(config, context);
+  EXPECT_NE(monitor, nullptr);
+}
+
+} // namespace
+} // namespace EventLoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,112 @@
+#include <vector>
+
+#include "extensions/resource_monitors/event_loop_lag/event_loop_lag_monitor.h"
+
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopLagMonitor {
+namespace {
+
+class MockedCallbacks : public Server::ResourceMonitor::Callbacks {
+public:
+  MOCK_METHOD1(onSuccess, void(const Server::ResourceUsage&));
+  MOCK_METHOD1(onFailure, void(const EnvoyException&));
+};
+
+MATCHER_P(ResourcePressure, pressure, "") { return arg.resource_pressure_ == pressure; }
+
+class EventLoopLagMonitorTest : public testing::Test {
+protected:
+  EventLoopLagMonitorTest() {
+    config_.mutable_max_lag()->set_nanos(100000000);
+    // The probes run on the threads when the test says so.
+    ON_CALL(thread_local_, runOnAllThreads(_, _))
+        .WillByDefault(Invoke([this](Event::PostCb cb, Event::PostCb complete_cb) {
+          posts_.push_back(cb);
+          completions_.push_back(complete_cb);
+        }));
+  }
+
+  // Run a probe on two threads.
+  void runProbe(size_t i) {
+    posts_[i]();
+    posts_[i]();
+    completions_[i]();
+  }
+
+  envoy::config::resource_monitor::event_loop_lag::v2alpha::EventLoopLagConfig config_;
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<ThreadLocal::MockInstance> thread_local_;
+  std::vector<Event::PostCb> posts_;
+  std::vector<Event::PostCb> completions_;
+  MockedCallbacks callbacks_;
+};
+
+TEST_F(EventLoopLagMonitorTest, ReportsLagOfLastProbe) {
+  EventLoopLagMonitor monitor(config_, thread_local_, time_system_);
+
+  EXPECT_CALL(callbacks_, onSuccess(ResourcePressure(0.0)));
+  monitor.updateResourceUsage(callbacks_);
+  ASSERT_EQ(1U, posts_.size());
+
+  // The threads run the probe 30ms after it was posted.
+  time_system_.sleep(std::chrono::milliseconds(30));
+  runProbe(0);
+  EXPECT_CALL(callbacks_, onSuccess(ResourcePressure(0.3)));
+  monitor.updateResourceUsage(callbacks_);
+  ASSERT_EQ(2U, posts_.size());
+
+  runProbe(1);
+  EXPECT_CALL(callbacks_, onSuccess(ResourcePressure(0.0)));
+  monitor.updateResourceUsage(callbacks_);
+  EXPECT_EQ(3U, posts_.size());
+}
+
+TEST_F(EventLoopLagMonitorTest, ReportsStalledProbe) {
+  EventLoopLagMonitor monitor(config_, thread_local_, time_system_);
+
+  EXPECT_CALL(callbacks_, onSuccess(ResourcePressure(0.0)));
+  monitor.updateResourceUsage(callbacks_);
+
+  // A thread which does not run the probe raises the pressure until it does, and no other probe
+  // is posted meanwhile.
+  time_system_.sleep(std::chrono::milliseconds(50));
+  EXPECT_CALL(callbacks_, onSuccess(ResourcePressure(0.5)));
+  monitor.updateResourceUsage(callbacks_);
+  time_system_.sleep(std::chrono::milliseconds(100));
+  EXPECT_CALL(callbacks_, onSuccess(ResourcePressure(1.5)));
+  monitor.updateResourceUsage(callbacks_);
+  EXPECT_EQ(1U, posts_.size());
+
+  runProbe(0);
+  EXPECT_CALL(callbacks_, onSuccess(ResourcePressure(1.5)));
+  monitor.updateResourceUsage(callbacks_);
+  EXPECT_EQ(2U, posts_.size());
+}
+
+// The probes posted to the workers outlive the monitor.
+TEST_F(EventLoopLagMonitorTest, ProbeOutlivesMonitor) {
+  auto monitor = std::make_unique<EventLoopLagMonitor>(config_, thread_local_, time_system_);
+  EXPECT_CALL(callbacks_, onSuccess(_));
+  monitor->updateResourceUsage(callbacks_);
+  monitor.reset();
+  runProbe(0);
+}
+
+} // namespace
+} // namespace EventLoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -7,6 +7,8 @@
 
 #include "extensions/resource_monitors/injected_resource/config.h"
 
+#include "test/mocks/server/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/utility.h"
 
@@ -28,7 +30,10 @@ TEST(InjectedResourceMonitorFactoryTest, CreateMonitor) {
   config.set_filename(TestEnvironment::temporaryPath("injected_resource"));
   Api::ApiPtr api = Api::createApiForTest();
   Event::DispatcherPtr dispatcher(api->allocateDispatcher());
-  Server::Configuration::ResourceMonitorFactoryContextImpl context(*dispatcher, *api);
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
+  testing::NiceMock<Server::MockOverloadManager> overload_manager;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(*dispatcher, *api, tls,
+                                                                   overload_manager);
   Server::ResourceMonitorPtr monitor = factory->createResourceMonitor(config, context);
   EXPECT_NE(monitor, nullptr);
 }
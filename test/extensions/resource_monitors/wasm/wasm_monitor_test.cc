@@ -0,0 +1,114 @@
+#include "extensions/resource_monitors/wasm/wasm_monitor.h"
+
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "absl/types/optional.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace WasmMonitor {
+namespace {
+
+class MockWasmUsageReader : public WasmUsageReader {
+public:
+  MockWasmUsageReader() = default;
+
+  MOCK_METHOD0(memoryBytes, uint64_t());
+  MOCK_METHOD0(guestCallTime, std::chrono::microseconds());
+};
+
+class ResourcePressure : public Server::ResourceMonitor::Callbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+  }
+
+  void onFailure(const EnvoyException& error) override { error_ = error; }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+
+  double pressure() const { return *pressure_; }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+class WasmMonitorTest : public testing::Test {
+protected:
+  Event::SimulatedTimeSystem time_system_;
+};
+
+TEST_F(WasmMonitorTest, ComputesMemoryUsage) {
+  envoy::config::resource_monitor::wasm::v2alpha::WasmConfig config;
+  config.set_max_memory_bytes(1000);
+  auto usage = std::make_unique<MockWasmUsageReader>();
+  EXPECT_CALL(*usage, guestCallTime())
+      .WillRepeatedly(testing::Return(std::chrono::microseconds(0)));
+  EXPECT_CALL(*usage, memoryBytes()).WillOnce(testing::Return(700));
+  WasmMonitor monitor(config, time_system_, std::move(usage));
+
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  EXPECT_TRUE(resource.hasPressure());
+  EXPECT_FALSE(resource.hasError());
+  EXPECT_EQ(resource.pressure(), 0.7);
+}
+
+TEST_F(WasmMonitorTest, ComputesCpuUsageSinceLastUpdate) {
+  envoy::config::resource_monitor::wasm::v2alpha::WasmConfig config;
+  config.set_max_cpu_ratio(0.5);
+  auto usage = std::make_unique<MockWasmUsageReader>();
+  EXPECT_CALL(*usage, memoryBytes()).Times(0);
+  EXPECT_CALL(*usage, guestCallTime())
+      .WillOnce(testing::Return(std::chrono::microseconds(1000)))
+      .WillOnce(testing::Return(std::chrono::microseconds(251000)))
+      .WillOnce(testing::Return(std::chrono::microseconds(251000)));
+  WasmMonitor monitor(config, time_system_, std::move(usage));
+
+  // 250ms of guest calls in one second is half of the budget.
+  time_system_.sleep(std::chrono::seconds(1));
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  EXPECT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0.5);
+
+  time_system_.sleep(std::chrono::seconds(1));
+  monitor.updateResourceUsage(resource);
+  EXPECT_EQ(resource.pressure(), 0);
+}
+
+TEST_F(WasmMonitorTest, ReportsLargerPressure) {
+  envoy::config::resource_monitor::wasm::v2alpha::WasmConfig config;
+  config.set_max_memory_bytes(1000);
+  config.set_max_cpu_ratio(1);
+  auto usage = std::make_unique<MockWasmUsageReader>();
+  EXPECT_CALL(*usage, memoryBytes()).WillOnce(testing::Return(100));
+  EXPECT_CALL(*usage, guestCallTime())
+      .WillOnce(testing::Return(std::chrono::microseconds(0)))
+      .WillOnce(testing::Return(std::chrono::microseconds(900000)));
+  WasmMonitor monitor(config, time_system_, std::move(usage));
+
+  time_system_.sleep(std::chrono::seconds(1));
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0.9);
+}
+
+TEST_F(WasmMonitorTest, RequiresBudget) {
+  envoy::config::resource_monitor::wasm::v2alpha::WasmConfig config;
+  EXPECT_THROW_WITH_MESSAGE(
+      WasmMonitor(config, time_system_, std::make_unique<MockWasmUsageReader>()), EnvoyException,
+      "Wasm resource monitor requires max_memory_bytes or max_cpu_ratio");
+}
+
+} // namespace
+} // namespace WasmMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
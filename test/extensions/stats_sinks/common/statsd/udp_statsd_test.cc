@@ -15,7 +15,11 @@
 #include "gtest/gtest.h"
 #include "spdlog/spdlog.h"
 
+using testing::_;
+using testing::InSequence;
+using testing::Invoke;
 using testing::NiceMock;
+using testing::SizeIs;
 
 namespace Envoy {
 namespace Extensions {
@@ -26,7 +30,18 @@ namespace {
 
 class MockWriter : public Writer {
 public:
+  MockWriter() {
+    // Each datagram is checked as a write().
+    ON_CALL(*this, writeDatagrams(_))
+        .WillByDefault(Invoke([this](const std::vector<absl::string_view>& datagrams) {
+          for (const absl::string_view datagram : datagrams) {
+            write(std::string(datagram));
+          }
+        }));
+  }
+
   MOCK_METHOD1(write, void(const std::string& message));
+  MOCK_METHOD1(writeDatagrams, void(const std::vector<absl::string_view>& datagrams));
 };
 
 class UdpStatsdSinkTest : public testing::TestWithParam<Network::Address::IpVersion> {};
@@ -158,6 +173,79 @@ TEST(UdpStatsdSinkTest, CheckActualStats) {
   tls_.shutdownThread();
 }
 
+TEST(UdpStatsdSinkTest, ReportChangedOnly) {
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, false, "", true);
+
+  auto counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+  counter->name_ = "test_counter";
+  counter->used_ = true;
+  snapshot.counters_.push_back({0, *counter});
+  auto changed_counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+  changed_counter->name_ = "changed_counter";
+  changed_counter->used_ = true;
+  snapshot.counters_.push_back({1, *changed_counter});
+  snapshot.changed_counters_.push_back({1, *changed_counter});
+
+  auto gauge = std::make_shared<NiceMock<Stats::MockGauge>>();
+  gauge->name_ = "test_gauge";
+  gauge->used_ = true;
+  snapshot.gauges_.push_back(*gauge);
+  auto changed_gauge = std::make_shared<NiceMock<Stats::MockGauge>>();
+  changed_gauge->name_ = "changed_gauge";
+  changed_gauge->value_ = 2;
+  changed_gauge->used_ = true;
+  snapshot.gauges_.push_back(*changed_gauge);
+  snapshot.changed_gauges_.push_back(*changed_gauge);
+
+  InSequence s;
+  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr),
+              write("envoy.changed_counter:1|c"));
+  EXPECT_CALL(*std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr),
+              write("envoy.changed_gauge:2|g"));
+  sink.flush(snapshot);
+
+  tls_.shutdownThread();
+}
+
+TEST(UdpStatsdSinkTest, PackDatagrams) {
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  // Fits the first two lines and their separator, e.g. "envoy.counter_1:1|c\nenvoy.counter_2:2|c".
+  UdpStatsdSink sink(tls_, writer_ptr, false, "", false, 39);
+
+  std::vector<std::shared_ptr<NiceMock<Stats::MockCounter>>> counters;
+  for (uint64_t i = 1; i <= 3; i++) {
+    counters.push_back(std::make_shared<NiceMock<Stats::MockCounter>>());
+    counters.back()->name_ = fmt::format("counter_{}", i);
+    counters.back()->used_ = true;
+    snapshot.counters_.push_back({i, *counters.back()});
+  }
+  auto gauge = std::make_shared<NiceMock<Stats::MockGauge>>();
+  gauge->name_ = "a_gauge_whose_line_exceeds_the_datagram_size";
+  gauge->value_ = 4;
+  gauge->used_ = true;
+  snapshot.gauges_.push_back(*gauge);
+
+  InSequence s;
+  EXPECT_CALL(*writer_ptr, writeDatagrams(SizeIs(3)));
+  EXPECT_CALL(*writer_ptr, write("envoy.counter_1:1|c\nenvoy.counter_2:2|c"));
+  EXPECT_CALL(*writer_ptr, write("envoy.counter_3:3|c"));
+  EXPECT_CALL(*writer_ptr, write("envoy.a_gauge_whose_line_exceeds_the_datagram_size:4|g"));
+  sink.flush(snapshot);
+
+  // Nothing is sent when no stat is flushed.
+  snapshot.counters_.clear();
+  snapshot.gauges_.clear();
+  EXPECT_CALL(*writer_ptr, writeDatagrams(_)).Times(0);
+  sink.flush(snapshot);
+
+  tls_.shutdownThread();
+}
+
 TEST(UdpStatsdSinkTest, CheckActualStatsWithCustomPrefix) {
   NiceMock<Stats::MockMetricSnapshot> snapshot;
   auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
@@ -455,6 +455,29 @@ TEST_F(HystrixSinkTest, AddAndRemoveClusters) {
   validateResults(cluster_message_map[cluster2_name_], 0, 0, 0, 0, 0, window_size_);
 }
 
+// The stats of a cluster are looked up when the sink first sees it, not on each flush.
+TEST_F(HystrixSinkTest, StatsLookedUpOnce) {
+  Buffer::OwnedImpl buffer = createClusterAndCallbacks();
+  sink_->registerConnection(&callbacks_);
+  EXPECT_CALL(cluster1_.cluster_stats_scope_, counter(_)).Times(testing::AnyNumber());
+  EXPECT_CALL(cluster1_.cluster_stats_scope_, counter("upstream_rq_2xx"));
+  EXPECT_CALL(cluster1_.cluster_stats_scope_,
+              gauge("membership_total", Stats::Gauge::ImportMode::Accumulate));
+
+  for (uint64_t i = 0; i < (window_size_ + 1); i++) {
+    buffer.drain(buffer.length());
+    ON_CALL(cluster1_.success_counter_, value()).WillByDefault(Return(i + 1));
+    sink_->flush(snapshot_);
+  }
+
+  std::unordered_map<std::string, std::string> cluster_message_map =
+      buildClusterMap(buffer.toString());
+  Json::ObjectSharedPtr json_buffer =
+      Json::Factory::loadFromString(cluster_message_map[cluster1_name_]);
+  EXPECT_EQ(json_buffer->getInteger("rollingCountSuccess"), window_size_);
+  EXPECT_EQ(json_buffer->getInteger("reportingHosts"), 5);
+}
+
 TEST_F(HystrixSinkTest, HistogramTest) {
   InSequence s;
 
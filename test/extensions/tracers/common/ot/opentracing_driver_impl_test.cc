@@ -104,6 +104,7 @@ TEST_F(OpenTracingDriverTest, TagSamplingFalseByDecision) {
 
   Tracing::SpanPtr first_span = driver_->startSpan(config_, request_headers_, operation_name_,
                                                    start_time_, {Tracing::Reason::Sampling, false});
+  EXPECT_FALSE(first_span->sampled());
   first_span->finishSpan();
 
   const std::map<std::string, opentracing::Value> expected_tags = {
@@ -119,7 +120,9 @@ TEST_F(OpenTracingDriverTest, TagSamplingFalseByFlag) {
 
   Tracing::SpanPtr first_span = driver_->startSpan(config_, request_headers_, operation_name_,
                                                    start_time_, {Tracing::Reason::Sampling, true});
+  EXPECT_TRUE(first_span->sampled());
   first_span->setSampled(false);
+  EXPECT_FALSE(first_span->sampled());
   first_span->finishSpan();
 
   const std::map<std::string, opentracing::Value> expected_tags = {
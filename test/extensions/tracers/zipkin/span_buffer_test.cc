@@ -110,6 +110,21 @@ TEST(ZipkinSpanBufferTest, sizeConstructorEndtoEnd) {
   EXPECT_EQ("[]", buffer.toStringifiedJsonArray());
 }
 
+TEST(ZipkinSpanBufferTest, growsUpToMaxSize) {
+  DangerousDeprecatedTestTime test_time;
+  SpanBuffer buffer;
+
+  buffer.allocateBuffer(1, 3);
+  EXPECT_TRUE(buffer.addSpan(Span(test_time.timeSystem())));
+  EXPECT_TRUE(buffer.addSpan(Span(test_time.timeSystem())));
+  EXPECT_TRUE(buffer.addSpan(Span(test_time.timeSystem())));
+  EXPECT_FALSE(buffer.addSpan(Span(test_time.timeSystem())));
+  EXPECT_EQ(3ULL, buffer.pendingSpans());
+
+  buffer.clear();
+  EXPECT_TRUE(buffer.addSpan(Span(test_time.timeSystem())));
+}
+
 } // namespace
 } // namespace Zipkin
 } // namespace Tracers
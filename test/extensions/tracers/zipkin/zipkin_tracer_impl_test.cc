@@ -225,6 +225,44 @@ TEST_F(ZipkinDriverTest, FlushOneSpanReportFailure) {
   EXPECT_EQ(0U, stats_.counter("tracing.zipkin.reports_failed").value());
 }
 
+TEST_F(ZipkinDriverTest, FlushSpansWhileReportInFlight) {
+  setupValidDriver();
+
+  Http::MockAsyncClientRequest request(&cm_.async_client_);
+  Http::AsyncClient::Callbacks* callback;
+  EXPECT_CALL(cm_.async_client_, send_(_, _, _))
+      .WillOnce(Invoke([&](Http::MessagePtr&, Http::AsyncClient::Callbacks& callbacks,
+                           const Http::AsyncClient::RequestOptions&)
+                           -> Http::AsyncClient::Request* {
+        callback = &callbacks;
+        return &request;
+      }));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.min_flush_spans", 5))
+      .WillRepeatedly(Return(1));
+
+  Tracing::SpanPtr first_span = driver_->startSpan(config_, request_headers_, operation_name_,
+                                                   start_time_, {Tracing::Reason::Sampling, true});
+  first_span->finishSpan();
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.spans_sent").value());
+
+  // The first report is still in flight, so the next spans stay buffered.
+  Tracing::SpanPtr second_span = driver_->startSpan(config_, request_headers_, operation_name_,
+                                                    start_time_, {Tracing::Reason::Sampling, true});
+  second_span->finishSpan();
+  Tracing::SpanPtr third_span = driver_->startSpan(config_, request_headers_, operation_name_,
+                                                   start_time_, {Tracing::Reason::Sampling, true});
+  third_span->finishSpan();
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.spans_sent").value());
+
+  // They are flushed together once it completes.
+  EXPECT_CALL(cm_.async_client_, send_(_, _, _));
+  callback->onSuccess(std::make_unique<Http::ResponseMessageImpl>(
+      Http::HeaderMapPtr{new Http::TestHeaderMapImpl{{":status", "202"}}}));
+  EXPECT_EQ(3U, stats_.counter("tracing.zipkin.spans_sent").value());
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.reports_sent").value());
+  EXPECT_EQ(0U, stats_.counter("tracing.zipkin.spans_dropped").value());
+}
+
 TEST_F(ZipkinDriverTest, FlushSpansTimer) {
   setupValidDriver();
 
@@ -25,6 +25,7 @@ public:
   Network::Connection& connection() override { return connection_; }
   bool shouldDrainReadBuffer() override { return false; }
   void setReadBufferReady() override { set_read_buffer_ready_ = true; }
+  uint64_t readSizeHint() override { return 4096; }
   void raiseEvent(Network::ConnectionEvent) override { event_raised_ = true; }
 
   bool event_raised() const { return event_raised_; }
@@ -51,6 +52,7 @@ TEST_F(NoOpTransportSocketCallbacksTest, TestAllCallbacks) {
   EXPECT_EQ(&wrapper_callbacks_.ioHandle(), &wrapped_callbacks_.ioHandle());
   EXPECT_EQ(&connection_, &wrapped_callbacks_.connection());
   EXPECT_FALSE(wrapped_callbacks_.shouldDrainReadBuffer());
+  EXPECT_EQ(4096, wrapped_callbacks_.readSizeHint());
 
   wrapped_callbacks_.setReadBufferReady();
   EXPECT_FALSE(wrapper_callbacks_.set_read_buffer_ready());
@@ -0,0 +1,80 @@
+#include <memory>
+#include <string>
+
+#include "extensions/transport_sockets/tls/certificate_cache.h"
+
+#include "test/test_common/environment.h"
+
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+std::string readTestData(const std::string& name) {
+  return TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + name));
+}
+
+// Identical PEM data is parsed once, for as long as it is used.
+TEST(CertificateCacheTest, Shared) {
+  CertificateCache cache;
+  const std::string pem = readTestData("san_dns3_chain.pem");
+  CertificateCache::CertificateChainConstSharedPtr chain = cache.certificateChain(pem);
+  ASSERT_NE(nullptr, chain);
+  EXPECT_NE(nullptr, chain->leaf_);
+  EXPECT_EQ(1, chain->intermediates_.size());
+  EXPECT_EQ(chain, cache.certificateChain(pem));
+  EXPECT_NE(chain, cache.certificateChain(readTestData("san_dns_cert.pem")));
+
+  // The cache does not keep the parsed data alive.
+  std::weak_ptr<const CertificateCache::CertificateChain> weak_chain = chain;
+  chain.reset();
+  EXPECT_TRUE(weak_chain.expired());
+  EXPECT_NE(nullptr, cache.certificateChain(pem));
+}
+
+// Keys are shared by data and password.
+TEST(CertificateCacheTest, PrivateKey) {
+  CertificateCache cache;
+  const std::string pem = readTestData("password_protected_key.pem");
+  EXPECT_EQ(nullptr, cache.privateKey(pem, "wrong"));
+  CertificateCache::PrivateKeyConstSharedPtr key = cache.privateKey(pem, "p4ssw0rd");
+  ASSERT_NE(nullptr, key);
+  EXPECT_NE(nullptr, key->pkey_);
+  EXPECT_EQ(key, cache.privateKey(pem, "p4ssw0rd"));
+  EXPECT_EQ(nullptr, cache.privateKey(pem, ""));
+}
+
+// Malformed data is not cached.
+TEST(CertificateCacheTest, Malformed) {
+  CertificateCache cache;
+  EXPECT_EQ(nullptr, cache.certificateChain("not a certificate"));
+  EXPECT_EQ(nullptr, cache.privateKey("not a key", ""));
+  EXPECT_EQ(0, cache.size());
+  ERR_clear_error();
+
+  CertificateCache::CertificateListConstSharedPtr list =
+      cache.certificateList(readTestData("ca_certificates.pem"));
+  ASSERT_NE(nullptr, list);
+  EXPECT_EQ(2, sk_X509_INFO_num(list->items_.get()));
+}
+
+// The entries no longer used are removed as the cache grows.
+TEST(CertificateCacheTest, RemoveExpired) {
+  CertificateCache cache;
+  for (const std::string name : {"san_dns_cert.pem", "san_dns2_cert.pem", "san_dns3_cert.pem",
+                                 "no_san_cert.pem", "san_uri_cert.pem"}) {
+    EXPECT_NE(nullptr, cache.certificateChain(readTestData(name)));
+  }
+  EXPECT_GT(5, cache.size());
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
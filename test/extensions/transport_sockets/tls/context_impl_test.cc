@@ -22,6 +22,7 @@
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
+#include "openssl/err.h"
 #include "openssl/x509v3.h"
 
 using Envoy::Protobuf::util::MessageDifferencer;
@@ -337,6 +338,66 @@ TEST_F(SslContextImplTest, AtMostOneEcdsaCert) {
                           "at most one certificate of a given type may be specified");
 }
 
+// The contexts created after a preload use the certificates it parsed.
+TEST_F(SslContextImplTest, PreloadCertificates) {
+  envoy::api::v2::auth::DownstreamTlsContext tls_context;
+  const std::string tls_context_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_key.pem"
+    validation_context:
+      trusted_ca:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"
+      crl:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.crl"
+  )EOF";
+  TestUtility::loadFromYaml(TestEnvironment::substitute(tls_context_yaml), tls_context);
+
+  Envoy::Ssl::CertificatePreloadPtr preload = manager_.preloadCertificates(
+      {&tls_context.common_tls_context().tls_certificates(0)},
+      {&tls_context.common_tls_context().validation_context()}, *api_, 4);
+  EXPECT_NE(nullptr, preload);
+  EXPECT_EQ(4U, manager_.certificateCache().size());
+
+  ServerContextConfigImpl server_context_config(tls_context, factory_context_);
+  Envoy::Ssl::ServerContextSharedPtr context =
+      manager_.createSslServerContext(store_, server_context_config, {});
+  EXPECT_EQ(4U, manager_.certificateCache().size());
+}
+
+// The certificates are parsed once when they are shared by many contexts.
+TEST_F(SslContextImplTest, PreloadSharedCertificatesInParallel) {
+  envoy::api::v2::auth::TlsCertificate tls_certificate;
+  const std::string tls_certificate_yaml = R"EOF(
+  certificate_chain:
+    filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem"
+  private_key:
+    filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_key.pem"
+  )EOF";
+  TestUtility::loadFromYaml(TestEnvironment::substitute(tls_certificate_yaml), tls_certificate);
+
+  std::vector<const envoy::api::v2::auth::TlsCertificate*> tls_certificates(
+      2 * ContextManagerImpl::MinPreloadItemsPerThread, &tls_certificate);
+  Envoy::Ssl::CertificatePreloadPtr preload =
+      manager_.preloadCertificates(tls_certificates, {}, *api_, 4);
+  EXPECT_NE(nullptr, preload);
+  EXPECT_EQ(2U, manager_.certificateCache().size());
+}
+
+// Nothing to parse, or data which fails to parse, is left to the creation of the contexts.
+TEST_F(SslContextImplTest, PreloadNothingOrMalformedCertificates) {
+  envoy::api::v2::auth::TlsCertificate tls_certificate;
+  EXPECT_EQ(nullptr, manager_.preloadCertificates({&tls_certificate}, {}, *api_, 4));
+
+  tls_certificate.mutable_certificate_chain()->set_inline_string("not a certificate");
+  tls_certificate.mutable_private_key()->set_filename("/does/not/exist");
+  EXPECT_NE(nullptr, manager_.preloadCertificates({&tls_certificate}, {}, *api_, 4));
+  EXPECT_EQ(0U, ERR_peek_error());
+}
+
 class SslServerContextImplTicketTest : public SslContextImplTest {
 public:
   void loadConfig(ServerContextConfigImpl& cfg) {
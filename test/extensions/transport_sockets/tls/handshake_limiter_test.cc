@@ -0,0 +1,184 @@
+#include "envoy/api/v2/auth/cert.pb.h"
+
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/transport_sockets/tls/handshake_limiter.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+using testing::InSequence;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class MockWaiter : public HandshakeLimiter::Waiter {
+public:
+  MOCK_METHOD0(onHandshakeAdmitted, void());
+};
+
+class HandshakeLimiterTest : public testing::Test {
+protected:
+  void initialize(const std::string& yaml) {
+    envoy::api::v2::auth::HandshakeLimits limits;
+    TestUtility::loadFromYaml(yaml, limits);
+    limiter_ = std::make_shared<HandshakeLimiter>(
+        std::make_shared<HandshakeLimitsConfig>(limits, &overload_manager_, store_));
+  }
+
+  uint64_t gauge(const std::string& name) {
+    return store_.gauge(name, Stats::Gauge::ImportMode::Accumulate).value();
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  NiceMock<Server::MockOverloadManager> overload_manager_;
+  HandshakeLimiterSharedPtr limiter_;
+};
+
+// Handshakes beyond the limit are queued, and the resumptions are admitted first.
+TEST_F(HandshakeLimiterTest, QueueResumptionsFirst) {
+  initialize("max_concurrent_handshakes: 1");
+  InSequence s;
+
+  MockWaiter first;
+  MockWaiter full;
+  MockWaiter resumption;
+  EXPECT_EQ(HandshakeLimiter::Admission::Admitted, limiter_->admit(first, false));
+  EXPECT_EQ(HandshakeLimiter::Admission::Queued, limiter_->admit(full, false));
+  EXPECT_EQ(HandshakeLimiter::Admission::Queued, limiter_->admit(resumption, true));
+  EXPECT_EQ(1, gauge("ssl.handshake_active"));
+  EXPECT_EQ(2, gauge("ssl.handshake_queued"));
+  EXPECT_EQ(2, store_.counter("ssl.handshake_delayed").value());
+
+  EXPECT_CALL(resumption, onHandshakeAdmitted());
+  limiter_->release();
+  EXPECT_CALL(full, onHandshakeAdmitted());
+  limiter_->release();
+  EXPECT_EQ(1, gauge("ssl.handshake_active"));
+  EXPECT_EQ(0, gauge("ssl.handshake_queued"));
+
+  limiter_->release();
+  EXPECT_EQ(0, gauge("ssl.handshake_active"));
+}
+
+// Cancelled handshakes leave the queue.
+TEST_F(HandshakeLimiterTest, Cancel) {
+  initialize("max_concurrent_handshakes: 1");
+
+  MockWaiter first;
+  MockWaiter second;
+  EXPECT_EQ(HandshakeLimiter::Admission::Admitted, limiter_->admit(first, false));
+  EXPECT_EQ(HandshakeLimiter::Admission::Queued, limiter_->admit(second, false));
+  limiter_->cancel(second);
+  EXPECT_EQ(0, gauge("ssl.handshake_queued"));
+
+  EXPECT_CALL(second, onHandshakeAdmitted()).Times(0);
+  limiter_->release();
+}
+
+// Handshakes beyond the queue limit are rejected.
+TEST_F(HandshakeLimiterTest, QueueFull) {
+  initialize(R"EOF(
+max_concurrent_handshakes: 1
+max_queued_handshakes: 1
+)EOF");
+
+  MockWaiter waiters[3];
+  EXPECT_EQ(HandshakeLimiter::Admission::Admitted, limiter_->admit(waiters[0], false));
+  EXPECT_EQ(HandshakeLimiter::Admission::Queued, limiter_->admit(waiters[1], false));
+  EXPECT_EQ(HandshakeLimiter::Admission::Rejected, limiter_->admit(waiters[2], true));
+  EXPECT_EQ(1, store_.counter("ssl.handshake_rejected").value());
+  limiter_->cancel(waiters[1]);
+  limiter_->release();
+}
+
+// The overload limit only applies while the overload action is active.
+TEST_F(HandshakeLimiterTest, Overload) {
+  initialize("overload_max_concurrent_handshakes: 1");
+  const std::string& action = Server::OverloadActionNames::get().LimitTlsHandshakes;
+
+  MockWaiter waiters[3];
+  EXPECT_EQ(HandshakeLimiter::Admission::Admitted, limiter_->admit(waiters[0], false));
+  EXPECT_EQ(HandshakeLimiter::Admission::Admitted, limiter_->admit(waiters[1], false));
+
+  overload_manager_.overload_state_.setState(action, Server::OverloadActionState::Active);
+  limiter_->release();
+  EXPECT_EQ(HandshakeLimiter::Admission::Queued, limiter_->admit(waiters[2], false));
+
+  // Once the action goes inactive, the queued handshakes are admitted with the next one.
+  overload_manager_.overload_state_.setState(action, Server::OverloadActionState::Inactive);
+  MockWaiter next;
+  EXPECT_CALL(waiters[2], onHandshakeAdmitted());
+  EXPECT_EQ(HandshakeLimiter::Admission::Admitted, limiter_->admit(next, false));
+  EXPECT_EQ(3, gauge("ssl.handshake_active"));
+  for (int i = 0; i < 3; i++) {
+    limiter_->release();
+  }
+}
+
+// The handshake of a connection waits for admission once its ClientHello is received.
+TEST_F(HandshakeLimiterTest, LimitedHandshake) {
+  initialize("max_concurrent_handshakes: 1");
+  MockWaiter first;
+  EXPECT_EQ(HandshakeLimiter::Admission::Admitted, limiter_->admit(first, false));
+
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+  bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
+  const std::string path = TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_");
+  EXPECT_EQ(1, SSL_CTX_use_certificate_chain_file(server_ctx.get(), (path + "cert.pem").c_str()));
+  EXPECT_EQ(1, SSL_CTX_use_PrivateKey_file(server_ctx.get(), (path + "key.pem").c_str(),
+                                           SSL_FILETYPE_PEM));
+  SSL_CTX_set_select_certificate_cb(
+      server_ctx.get(), [](const SSL_CLIENT_HELLO* client_hello) -> ssl_select_cert_result_t {
+        return LimitedHandshake::get(client_hello->ssl)->onClientHello(client_hello);
+      });
+
+  bssl::UniquePtr<SSL> client(SSL_new(client_ctx.get()));
+  bssl::UniquePtr<SSL> server(SSL_new(server_ctx.get()));
+  BIO* client_bio;
+  BIO* server_bio;
+  EXPECT_EQ(1, BIO_new_bio_pair(&client_bio, 0, &server_bio, 0));
+  SSL_set_bio(client.get(), client_bio, client_bio);
+  SSL_set_bio(server.get(), server_bio, server_bio);
+  SSL_set_connect_state(client.get());
+  SSL_set_accept_state(server.get());
+
+  uint32_t admissions = 0;
+  LimitedHandshake handshake(server.get(), limiter_, [&admissions]() { admissions++; });
+  int client_rc = 0;
+  int server_rc = 0;
+  const auto drive = [&]() {
+    for (int i = 0; i < 10; i++) {
+      client_rc = SSL_do_handshake(client.get());
+      server_rc = SSL_do_handshake(server.get());
+    }
+  };
+
+  drive();
+  EXPECT_EQ(SSL_ERROR_PENDING_CERTIFICATE, SSL_get_error(server.get(), server_rc));
+  EXPECT_EQ(1, gauge("ssl.handshake_queued"));
+
+  limiter_->release();
+  EXPECT_EQ(1, admissions);
+  drive();
+  EXPECT_EQ(1, client_rc);
+  EXPECT_EQ(1, server_rc);
+  handshake.onHandshakeComplete();
+  EXPECT_EQ(0, gauge("ssl.handshake_active"));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,153 @@
+#include <functional>
+#include <vector>
+
+#include "common/common/lock_guard.h"
+#include "common/common/thread.h"
+
+#include "extensions/transport_sockets/tls/private_key_offload.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+// Runs the operations when asked to by the test.
+class ManualOffloadPool : public Envoy::Ssl::PrivateKeyOffloadPool {
+public:
+  void post(std::function<void()> operation) override { operations_.push_back(operation); }
+
+  void runAll() {
+    for (const auto& operation : operations_) {
+      operation();
+    }
+    operations_.clear();
+  }
+
+  std::vector<std::function<void()>> operations_;
+};
+
+// The operations are run by the threads of the pool.
+TEST(PrivateKeyOffloadPoolTest, RunsOperations) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Thread::MutexBasicLockable lock;
+  Thread::CondVar cond;
+  uint32_t done = 0;
+  {
+    PrivateKeyOffloadPoolImpl pool(api->threadFactory(), 2);
+    for (int i = 0; i < 10; i++) {
+      pool.post([&]() {
+        Thread::LockGuard guard(lock);
+        done++;
+        cond.notifyOne();
+      });
+    }
+    Thread::LockGuard guard(lock);
+    while (done < 10) {
+      cond.wait(lock);
+    }
+  }
+  EXPECT_EQ(10, done);
+}
+
+class PrivateKeyConnectionTest : public testing::TestWithParam<std::string> {
+protected:
+  PrivateKeyConnectionTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher()),
+        client_ctx_(SSL_CTX_new(TLS_method())), server_ctx_(SSL_CTX_new(TLS_method())) {
+    const std::string path =
+        TestEnvironment::substitute("{{ test_rundir }}/test/extensions/transport_sockets/tls/"
+                                    "test_data/" +
+                                    GetParam());
+    EXPECT_EQ(1, SSL_CTX_use_certificate_chain_file(server_ctx_.get(),
+                                                    (path + "_cert.pem").c_str()));
+    EXPECT_EQ(1, SSL_CTX_use_PrivateKey_file(server_ctx_.get(), (path + "_key.pem").c_str(),
+                                             SSL_FILETYPE_PEM));
+    SSL_CTX_set_private_key_method(server_ctx_.get(), PrivateKeyConnection::method());
+
+    client_.reset(SSL_new(client_ctx_.get()));
+    server_.reset(SSL_new(server_ctx_.get()));
+    BIO* client_bio;
+    BIO* server_bio;
+    EXPECT_EQ(1, BIO_new_bio_pair(&client_bio, 0, &server_bio, 0));
+    SSL_set_bio(client_.get(), client_bio, client_bio);
+    SSL_set_bio(server_.get(), server_bio, server_bio);
+    SSL_set_connect_state(client_.get());
+    SSL_set_accept_state(server_.get());
+  }
+
+  // Drives both ends of the handshake until neither makes progress.
+  void driveHandshake() {
+    for (int i = 0; i < 10; i++) {
+      client_rc_ = SSL_do_handshake(client_.get());
+      server_rc_ = SSL_do_handshake(server_.get());
+    }
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  bssl::UniquePtr<SSL> client_;
+  bssl::UniquePtr<SSL> server_;
+  int client_rc_{};
+  int server_rc_{};
+  ManualOffloadPool pool_;
+};
+
+INSTANTIATE_TEST_SUITE_P(Keys, PrivateKeyConnectionTest,
+                         testing::Values("san_dns", "selfsigned_ecdsa_p256"));
+
+// The handshake waits for the signature computed on the pool, then completes, the client having
+// verified the signature.
+TEST_P(PrivateKeyConnectionTest, Handshake) {
+  uint32_t completions = 0;
+  PrivateKeyConnection connection(server_.get(), pool_, *dispatcher_,
+                                  [&completions]() { completions++; });
+
+  driveHandshake();
+  EXPECT_EQ(SSL_ERROR_WANT_PRIVATE_KEY_OPERATION, SSL_get_error(server_.get(), server_rc_));
+  EXPECT_EQ(1, pool_.operations_.size());
+
+  pool_.runAll();
+  EXPECT_EQ(0, completions);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(1, completions);
+
+  driveHandshake();
+  EXPECT_EQ(1, client_rc_);
+  EXPECT_EQ(1, server_rc_);
+}
+
+// An operation completing after its connection was destroyed is dropped.
+TEST_P(PrivateKeyConnectionTest, Cancelled) {
+  uint32_t completions = 0;
+  auto connection = std::make_unique<PrivateKeyConnection>(server_.get(), pool_, *dispatcher_,
+                                                           [&completions]() { completions++; });
+  driveHandshake();
+  EXPECT_EQ(SSL_ERROR_WANT_PRIVATE_KEY_OPERATION, SSL_get_error(server_.get(), server_rc_));
+
+  connection.reset();
+  pool_.runAll();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(0, completions);
+}
+
+// Without a connection, the operations fail and so does the handshake.
+TEST_P(PrivateKeyConnectionTest, NoConnection) {
+  driveHandshake();
+  EXPECT_EQ(SSL_ERROR_SSL, SSL_get_error(server_.get(), server_rc_));
+  EXPECT_TRUE(pool_.operations_.empty());
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
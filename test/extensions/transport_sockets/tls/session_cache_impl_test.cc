@@ -0,0 +1,75 @@
+#include "extensions/transport_sockets/tls/session_cache_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+TEST(SessionCacheImplTest, StoreLookupRemove) {
+  SessionCacheImpl cache(2);
+  EXPECT_TRUE(cache.lookup("a").empty());
+
+  cache.store("a", {1, 2});
+  EXPECT_EQ(std::vector<uint8_t>({1, 2}), cache.lookup("a"));
+  cache.store("a", {3});
+  EXPECT_EQ(std::vector<uint8_t>({3}), cache.lookup("a"));
+  EXPECT_EQ(1, cache.size());
+
+  cache.remove("a");
+  EXPECT_TRUE(cache.lookup("a").empty());
+  EXPECT_EQ(0, cache.size());
+  cache.remove("a");
+}
+
+// The least recently used session is evicted.
+TEST(SessionCacheImplTest, Lru) {
+  SessionCacheImpl cache(2);
+  cache.store("a", {1});
+  cache.store("b", {2});
+  EXPECT_FALSE(cache.lookup("a").empty());
+
+  cache.store("c", {3});
+  EXPECT_EQ(2, cache.size());
+  EXPECT_FALSE(cache.lookup("a").empty());
+  EXPECT_TRUE(cache.lookup("b").empty());
+  EXPECT_FALSE(cache.lookup("c").empty());
+}
+
+// The sessions are iterated the least recently used first.
+TEST(SessionCacheImplTest, Iterate) {
+  SessionCacheImpl cache(3);
+  cache.store("a", {1});
+  cache.store("b", {2});
+  cache.store("c", {3});
+  EXPECT_FALSE(cache.lookup("a").empty());
+
+  std::vector<std::string> keys;
+  cache.iterate([&keys](const std::string& key, const std::vector<uint8_t>&) {
+    keys.push_back(key);
+  });
+  EXPECT_EQ(std::vector<std::string>({"b", "c", "a"}), keys);
+
+  // Storing the sessions in the same order in another cache reproduces their recency.
+  SessionCacheImpl copy(2);
+  cache.iterate([&copy](const std::string& key, const std::vector<uint8_t>& session) {
+    copy.store(key, std::vector<uint8_t>(session));
+  });
+  EXPECT_TRUE(copy.lookup("b").empty());
+  EXPECT_EQ(std::vector<uint8_t>({3}), copy.lookup("c"));
+  EXPECT_EQ(std::vector<uint8_t>({1}), copy.lookup("a"));
+}
+
+TEST(SessionCacheImplTest, Disabled) {
+  SessionCacheImpl cache(0);
+  cache.store("a", {1});
+  EXPECT_TRUE(cache.lookup("a").empty());
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -2537,6 +2537,99 @@ TEST_P(SslSocketTest, TicketSessionResumptionWithClientCA) {
                               GetParam());
 }
 
+// Sessions stored in the shared session cache are resumed by session ID across server contexts,
+// by connections of other client contexts.
+TEST_P(SslSocketTest, SharedSessionCacheResumption) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+  shared_session_cache: true
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+  shared_session_cache: true
+)EOF";
+
+  Event::SimulatedTimeSystem time_system;
+  ContextManagerImpl manager(*time_system);
+  Stats::IsolatedStoreImpl server_stats_store;
+  Stats::IsolatedStoreImpl client_stats_store;
+  Api::ApiPtr api = Api::createApiForTest(server_stats_store, time_system);
+  testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+
+  envoy::api::v2::auth::DownstreamTlsContext server_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+  envoy::api::v2::auth::UpstreamTlsContext client_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml), client_tls_context);
+
+  // Each connection has server and client contexts of its own.
+  std::vector<std::unique_ptr<ServerSslSocketFactory>> server_factories;
+  std::vector<std::unique_ptr<ClientSslSocketFactory>> client_factories;
+  for (int i = 0; i < 2; i++) {
+    server_factories.push_back(std::make_unique<ServerSslSocketFactory>(
+        std::make_unique<ServerContextConfigImpl>(server_tls_context, factory_context), manager,
+        server_stats_store, std::vector<std::string>{}));
+    client_factories.push_back(std::make_unique<ClientSslSocketFactory>(
+        std::make_unique<ClientContextConfigImpl>(client_tls_context, factory_context), manager,
+        client_stats_store));
+  }
+
+  Network::TcpListenSocket socket(Network::Test::getCanonicalLoopbackAddress(GetParam()), nullptr,
+                                  true);
+  NiceMock<Network::MockListenerCallbacks> callbacks;
+  Event::DispatcherPtr dispatcher(api->allocateDispatcher());
+  Network::ListenerPtr listener = dispatcher->createListener(socket, callbacks, true, false);
+
+  for (size_t i = 0; i < 2; i++) {
+    Network::ClientConnectionPtr client_connection = dispatcher->createClientConnection(
+        socket.localAddress(), Network::Address::InstanceConstSharedPtr(),
+        client_factories[i]->createTransportSocket(nullptr), nullptr);
+    // Without tickets, the sessions are resumed by session ID.
+    SSL_set_options(dynamic_cast<const SslSocket*>(client_connection->ssl())->rawSslForTest(),
+                    SSL_OP_NO_TICKET);
+    NiceMock<Network::MockConnectionCallbacks> client_connection_callbacks;
+    client_connection->addConnectionCallbacks(client_connection_callbacks);
+    client_connection->connect();
+
+    Network::ConnectionPtr server_connection;
+    NiceMock<Network::MockConnectionCallbacks> server_connection_callbacks;
+    EXPECT_CALL(callbacks, onAccept_(_, _))
+        .WillOnce(Invoke([&](Network::ConnectionSocketPtr& accepted, bool) -> void {
+          server_connection = dispatcher->createServerConnection(
+              std::move(accepted), server_factories[i]->createTransportSocket(nullptr));
+          server_connection->addConnectionCallbacks(server_connection_callbacks);
+        }));
+
+    size_t connect_count = 0;
+    auto on_connected = [&](Network::ConnectionEvent) -> void {
+      if (++connect_count == 2) {
+        client_connection->close(Network::ConnectionCloseType::NoFlush);
+        server_connection->close(Network::ConnectionCloseType::NoFlush);
+        dispatcher->exit();
+      }
+    };
+    EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::Connected))
+        .WillOnce(Invoke(on_connected));
+    EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::Connected))
+        .WillOnce(Invoke(on_connected));
+    dispatcher->run(Event::Dispatcher::RunType::Block);
+  }
+
+  EXPECT_EQ(1UL, server_stats_store.counter("ssl.session_reused").value());
+  EXPECT_EQ(1UL, server_stats_store.counter("ssl.session_cache_hit").value());
+  EXPECT_EQ(1UL, client_stats_store.counter("ssl.session_reused").value());
+  EXPECT_EQ(1UL, client_stats_store.counter("ssl.session_cache_hit").value());
+  EXPECT_EQ(1UL, client_stats_store.counter("ssl.session_cache_miss").value());
+}
+
 TEST_P(SslSocketTest, TicketSessionResumptionRotateKey) {
   const std::string server_ctx_yaml1 = R"EOF(
   common_tls_context:
@@ -3834,6 +3927,22 @@ protected:
     listener_ = dispatcher_->createListener(socket_, listener_callbacks_, true, false);
 
     TestUtility::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml_), upstream_tls_context_);
+    if (client_kernel_tls_offload_) {
+      // Negotiate a version and cipher the kernel can encrypt.
+      auto* common_tls_context = upstream_tls_context_.mutable_common_tls_context();
+      common_tls_context->set_kernel_tls_offload(true);
+      common_tls_context->mutable_tls_params()->set_tls_maximum_protocol_version(
+          envoy::api::v2::auth::TlsParameters::TLSv1_2);
+      common_tls_context->mutable_tls_params()->add_cipher_suites("ECDHE-RSA-AES128-GCM-SHA256");
+    }
+    if (client_dynamic_record_sizing_) {
+      auto* sizing =
+          upstream_tls_context_.mutable_common_tls_context()->mutable_dynamic_record_sizing();
+      sizing->mutable_initial_record_size()->set_value(1024);
+      sizing->mutable_ramp_up_bytes()->set_value(64 * 1024);
+      // Long enough for slow test runs not to ramp up again during the transfer.
+      sizing->mutable_idle_timeout()->set_seconds(3600);
+    }
     auto client_cfg =
         std::make_unique<ClientContextConfigImpl>(upstream_tls_context_, factory_context_);
 
@@ -4024,6 +4133,8 @@ protected:
   std::shared_ptr<Network::MockReadFilter> read_filter_;
   StrictMock<Network::MockConnectionCallbacks> client_callbacks_;
   Network::Address::InstanceConstSharedPtr source_address_;
+  bool client_kernel_tls_offload_{};
+  bool client_dynamic_record_sizing_{};
 };
 
 INSTANTIATE_TEST_SUITE_P(IpVersions, SslReadBufferLimitTest,
@@ -4044,6 +4155,32 @@ TEST_P(SslReadBufferLimitTest, SomeLimit) {
   readBufferLimitTest(32 * 1024, 32 * 1024, 256 * 1024, 1, false);
 }
 
+// The client writes through the kernel TLS layer when the host supports it, in which case the
+// server decrypts records encrypted by the kernel. Otherwise the client falls back to BoringSSL.
+TEST_P(SslReadBufferLimitTest, KernelTlsOffload) {
+  client_kernel_tls_offload_ = true;
+  readBufferLimitTest(0, 256 * 1024, 256 * 1024, 1, false);
+  EXPECT_EQ(1UL, client_stats_store_.counter("ssl.ktls_tx_enabled").value() +
+                     client_stats_store_.counter("ssl.ktls_tx_unsupported").value());
+  EXPECT_EQ(0UL, server_stats_store_.counter("ssl.ktls_tx_unsupported").value());
+}
+
+// The first 64KB are written in 1KB records, and the rest in full-size records.
+TEST_P(SslReadBufferLimitTest, DynamicRecordSizing) {
+  client_dynamic_record_sizing_ = true;
+  readBufferLimitTest(0, 256 * 1024, 256 * 1024, 1, false);
+  EXPECT_EQ(64UL, client_stats_store_.counter("ssl.write_record_small").value());
+  EXPECT_EQ(12UL, client_stats_store_.counter("ssl.write_record_full").value());
+  EXPECT_LE(1UL, client_stats_store_.counter("ssl.write_flush").value());
+}
+
+// Without dynamic sizing, records are always full-size.
+TEST_P(SslReadBufferLimitTest, FullSizeRecords) {
+  readBufferLimitTest(0, 256 * 1024, 256 * 1024, 1, false);
+  EXPECT_EQ(0UL, client_stats_store_.counter("ssl.write_record_small").value());
+  EXPECT_EQ(16UL, client_stats_store_.counter("ssl.write_record_full").value());
+}
+
 TEST_P(SslReadBufferLimitTest, WritesSmallerThanBufferLimit) { singleWriteTest(5 * 1024, 1024); }
 
 TEST_P(SslReadBufferLimitTest, WritesLargerThanBufferLimit) { singleWriteTest(1024, 5 * 1024); }
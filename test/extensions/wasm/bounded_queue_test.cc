@@ -0,0 +1,85 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "extensions/common/wasm/bounded_queue.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Wasm {
+namespace {
+
+using Common::Wasm::BoundedQueue;
+
+TEST(BoundedQueueTest, CapacityRoundedUpToPowerOfTwo) {
+  EXPECT_EQ(1, BoundedQueue<int>(1).capacity());
+  EXPECT_EQ(4, BoundedQueue<int>(3).capacity());
+  EXPECT_EQ(4096, BoundedQueue<int>(4096).capacity());
+}
+
+TEST(BoundedQueueTest, PushPop) {
+  BoundedQueue<std::string> queue(2);
+  std::string value;
+  EXPECT_FALSE(queue.tryPop(&value));
+
+  EXPECT_TRUE(queue.tryPush("one"));
+  EXPECT_TRUE(queue.tryPush("two"));
+  std::string rejected = "three";
+  EXPECT_FALSE(queue.tryPush(std::move(rejected)));
+  // The rejected value is not moved from.
+  EXPECT_EQ("three", rejected);
+  EXPECT_EQ(2, queue.size());
+
+  EXPECT_TRUE(queue.tryPop(&value));
+  EXPECT_EQ("one", value);
+  EXPECT_TRUE(queue.tryPush("three"));
+  EXPECT_TRUE(queue.tryPop(&value));
+  EXPECT_EQ("two", value);
+  EXPECT_TRUE(queue.tryPop(&value));
+  EXPECT_EQ("three", value);
+  EXPECT_FALSE(queue.tryPop(&value));
+  EXPECT_EQ(0, queue.size());
+}
+
+TEST(BoundedQueueTest, ConcurrentProducersAndConsumers) {
+  constexpr int kThreads = 4;
+  constexpr int kEntriesPerThread = 10000;
+  BoundedQueue<int> queue(64);
+  std::vector<std::thread> threads;
+  std::vector<int64_t> sums(kThreads, 0);
+  for (int i = 0; i < kThreads; i++) {
+    threads.emplace_back([&queue] {
+      for (int j = 1; j <= kEntriesPerThread; j++) {
+        int value = j;
+        while (!queue.tryPush(std::move(value))) {
+          std::this_thread::yield();
+        }
+      }
+    });
+    threads.emplace_back([&queue, &sums, i] {
+      for (int j = 0; j < kEntriesPerThread; j++) {
+        int value;
+        while (!queue.tryPop(&value)) {
+          std::this_thread::yield();
+        }
+        sums[i] += value;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  int64_t total = 0;
+  for (auto sum : sums) {
+    total += sum;
+  }
+  EXPECT_EQ(int64_t(kThreads) * kEntriesPerThread * (kEntriesPerThread + 1) / 2, total);
+  EXPECT_EQ(0, queue.size());
+}
+
+} // namespace
+} // namespace Wasm
+} // namespace Extensions
+} // namespace Envoy
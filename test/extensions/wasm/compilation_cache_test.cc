@@ -0,0 +1,70 @@
+#include "envoy/common/exception.h"
+
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/common/wasm/compilation_cache.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Wasm {
+namespace {
+
+using Common::Wasm::CompilationCache;
+
+class CompilationCacheTest : public testing::Test {
+protected:
+  CompilationCacheTest()
+      : api_(Api::createApiForTest(stats_store_)),
+        directory_(TestEnvironment::temporaryPath("wasm_compilation_cache")) {
+    TestEnvironment::removePath(directory_);
+    TestEnvironment::createPath(directory_);
+  }
+  ~CompilationCacheTest() override { TestEnvironment::removePath(directory_); }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  Api::ApiPtr api_;
+  const std::string directory_;
+};
+
+TEST_F(CompilationCacheTest, MissingDirectory) {
+  EXPECT_THROW_WITH_MESSAGE(
+      CompilationCache(*api_, directory_ + "/missing"), EnvoyException,
+      absl::StrCat("Wasm compilation cache directory does not exist: ", directory_, "/missing"));
+}
+
+TEST_F(CompilationCacheTest, Key) {
+  const auto key = CompilationCache::key("envoy.wasm.vm.v8", "code");
+  EXPECT_EQ(64, key.size());
+  EXPECT_EQ(key, CompilationCache::key("envoy.wasm.vm.v8", "code"));
+  EXPECT_NE(key, CompilationCache::key("envoy.wasm.vm.wavm", "code"));
+  EXPECT_NE(key, CompilationCache::key("envoy.wasm.vm.v8", "other code"));
+  EXPECT_FALSE(CompilationCache::cpuFeatures().empty());
+}
+
+TEST_F(CompilationCacheTest, InsertAndLookup) {
+  CompilationCache cache(*api_, directory_);
+  const auto key = CompilationCache::key("envoy.wasm.vm.v8", "code");
+  EXPECT_FALSE(cache.lookup(key).has_value());
+
+  // Empty native code is never cached.
+  cache.insert(key, "");
+  EXPECT_FALSE(cache.lookup(key).has_value());
+
+  cache.insert(key, "native code");
+  EXPECT_EQ("native code", cache.lookup(key).value());
+
+  // Entries are visible to other instances using the same directory (e.g. after a restart).
+  CompilationCache other_cache(*api_, directory_);
+  EXPECT_EQ("native code", other_cache.lookup(key).value());
+  EXPECT_FALSE(other_cache.lookup(CompilationCache::key("envoy.wasm.vm.v8", "x")).has_value());
+}
+
+} // namespace
+} // namespace Wasm
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,242 @@
+// Benchmarks for the Wasm host ABI and the VM runtimes. The same sample plugin is run on each
+// available runtime: the null VM runs the natively compiled null_vm_plugin and V8/WAVM run the
+// equivalent headers_cpp.wasm module.
+//
+// Handler benchmarks call the host side of the ABI directly with arguments in guest memory, so
+// they measure the per-call cost of the handler including guest memory translation and the
+// allocation of returned values in the guest. The guest callback benchmarks add the cost of the
+// VM transitions.
+
+#include "common/buffer/buffer_impl.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/common/wasm/wasm.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace Wasm {
+namespace {
+
+using Common::Wasm::Context;
+using Common::Wasm::HeaderMapType;
+using Common::Wasm::SaveRestoreContext;
+
+// A stream context which allows the handlers to be called without first calling into the guest
+// and which discards guest logging.
+class BenchmarkContext : public Context {
+public:
+  BenchmarkContext(Common::Wasm::Wasm* wasm, uint32_t root_context_id)
+      : Context(wasm, root_context_id) {}
+
+  void scriptLog(spdlog::level::level_enum, absl::string_view) override {}
+
+  void setRequestHeaders(Http::HeaderMap* headers) { request_headers_ = headers; }
+  void setRequestBody(Buffer::Instance* body) { requestBodyBuffer_ = body; }
+};
+
+class WasmBenchmark {
+public:
+  explicit WasmBenchmark(absl::string_view runtime)
+      : api_(Api::createApiForTest(stats_store_)), dispatcher_(api_->allocateDispatcher()),
+        scope_(stats_store_.createScope("wasm.")), runtime_(runtime) {
+    if (runtime_ == "null") {
+      code_ = "null_vm_plugin";
+    } else {
+      code_ = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+          "{{ test_rundir }}/test/extensions/filters/http/wasm/test_data/headers_cpp.wasm"));
+    }
+  }
+
+  std::shared_ptr<Common::Wasm::Wasm> createWasm() {
+    auto wasm = std::make_shared<Common::Wasm::Wasm>(
+        absl::StrCat("envoy.wasm.vm.", runtime_), "", "", cluster_manager_, *dispatcher_, *scope_,
+        Common::Wasm::PluginDirection::Inbound, local_info_, nullptr, scope_);
+    RELEASE_ASSERT(wasm->initialize(code_, "<benchmark>", false), "");
+    wasm->start("", "");
+    return wasm;
+  }
+
+  // Creates a VM and a stream context on it.
+  void setupStream() {
+    wasm_ = createWasm();
+    context_ = std::make_unique<BenchmarkContext>(wasm_.get(), wasm_->getRootContext("")->id());
+    context_->setDecoderFilterCallbacks(decoder_callbacks_);
+    // Room for a returned pointer and size, which are a Word on the null VM.
+    wasm_->allocMemory(2 * sizeof(uint64_t), &result_ptr_);
+    result_size_ptr_ = result_ptr_ + sizeof(uint64_t);
+  }
+
+  // Frees the value returned in guest memory by the last handler call.
+  void freeResult() {
+    const size_t word_size = runtime_ == "null" ? sizeof(uint64_t) : sizeof(uint32_t);
+    uint64_t pointer = 0;
+    memcpy(&pointer, wasm_->wasmVm()->getMemory(result_ptr_, word_size).value().data(), word_size);
+    if (pointer) {
+      wasm_->freeMemoryOffset(pointer);
+    }
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Stats::ScopeSharedPtr scope_;
+  NiceMock<Upstream::MockClusterManager> cluster_manager_;
+  NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  const std::string runtime_;
+  std::string code_;
+  std::shared_ptr<Common::Wasm::Wasm> wasm_;
+  std::unique_ptr<BenchmarkContext> context_;
+  uint64_t result_ptr_{};
+  uint64_t result_size_ptr_{};
+};
+
+/** Measure the time to create, load and start a VM. */
+static void WasmCreate(benchmark::State& state, const char* runtime) {
+  WasmBenchmark bench(runtime);
+  for (auto _ : state) {
+    auto wasm = bench.createWasm();
+    benchmark::DoNotOptimize(wasm.get());
+  }
+}
+
+/** Measure the time to clone a loaded VM and start the clone, as is done for each worker. */
+static void WasmClone(benchmark::State& state, const char* runtime) {
+  WasmBenchmark bench(runtime);
+  auto base_wasm = bench.createWasm();
+  const auto cloneable = base_wasm->wasmVm()->cloneable();
+  if (cloneable == Common::Wasm::Cloneable::NotCloneable) {
+    state.SkipWithError("VM is not cloneable");
+    return;
+  }
+  for (auto _ : state) {
+    auto wasm = std::make_shared<Common::Wasm::Wasm>(*base_wasm, *bench.dispatcher_);
+    if (cloneable == Common::Wasm::Cloneable::CompiledBytecode) {
+      RELEASE_ASSERT(wasm->initialize("", "<benchmark>", false), "");
+    }
+    wasm->start("", "");
+    benchmark::DoNotOptimize(wasm.get());
+  }
+}
+
+/** Measure proxy_getHeaderMapValue, which copies the value into guest memory. */
+static void WasmGetHeaderMapValue(benchmark::State& state, const char* runtime) {
+  WasmBenchmark bench(runtime);
+  bench.setupStream();
+  Http::TestHeaderMapImpl headers{{":path", "/"}, {"server", "envoy"}};
+  bench.context_->setRequestHeaders(&headers);
+  const absl::string_view key = "server";
+  const uint64_t key_ptr = bench.wasm_->copyString(key);
+  SaveRestoreContext saved_context(bench.context_.get());
+  for (auto _ : state) {
+    auto result = Common::Wasm::getHeaderMapValueHandler(
+        bench.context_.get(), static_cast<uint64_t>(HeaderMapType::RequestHeaders), key_ptr,
+        key.size(), bench.result_ptr_, bench.result_size_ptr_);
+    benchmark::DoNotOptimize(result);
+    bench.freeResult();
+  }
+  bench.context_->setRequestHeaders(nullptr);
+}
+
+/** Measure proxy_setSharedData with a small value. */
+static void WasmSetSharedData(benchmark::State& state, const char* runtime) {
+  WasmBenchmark bench(runtime);
+  bench.setupStream();
+  const absl::string_view key = "shared_data_key";
+  const absl::string_view value = "shared_data_value";
+  const uint64_t key_ptr = bench.wasm_->copyString(key);
+  const uint64_t value_ptr = bench.wasm_->copyString(value);
+  SaveRestoreContext saved_context(bench.context_.get());
+  for (auto _ : state) {
+    auto result = Common::Wasm::setSharedDataHandler(bench.context_.get(), key_ptr, key.size(),
+                                                     value_ptr, value.size(), 0);
+    benchmark::DoNotOptimize(result);
+  }
+}
+
+/** Measure proxy_incrementMetric on a counter. */
+static void WasmIncrementMetric(benchmark::State& state, const char* runtime) {
+  WasmBenchmark bench(runtime);
+  bench.setupStream();
+  uint32_t metric_id;
+  RELEASE_ASSERT(bench.context_->defineMetric(Context::MetricType::Counter, "benchmark_counter",
+                                              &metric_id) == Common::Wasm::WasmResult::Ok,
+                 "");
+  SaveRestoreContext saved_context(bench.context_.get());
+  for (auto _ : state) {
+    auto result = Common::Wasm::incrementMetricHandler(bench.context_.get(), metric_id, 1);
+    benchmark::DoNotOptimize(result);
+  }
+}
+
+/**
+ * Measure proxy_getRequestBodyBufferBytes. The numeric Arg passed by the BENCHMARK(...) macro
+ * call below is the size of the body, all of which is copied into guest memory.
+ */
+static void WasmGetRequestBody(benchmark::State& state, const char* runtime) {
+  WasmBenchmark bench(runtime);
+  bench.setupStream();
+  Buffer::OwnedImpl body(std::string(state.range(0), 'a'));
+  bench.context_->setRequestBody(&body);
+  SaveRestoreContext saved_context(bench.context_.get());
+  for (auto _ : state) {
+    auto result = Common::Wasm::getRequestBodyBufferBytesHandler(
+        bench.context_.get(), 0, body.length(), bench.result_ptr_, bench.result_size_ptr_);
+    benchmark::DoNotOptimize(result);
+    bench.freeResult();
+  }
+  bench.context_->setRequestBody(nullptr);
+}
+
+/**
+ * Measure a full onRequestHeaders guest callback of the sample plugin, which reads, adds and
+ * replaces request headers and logs.
+ */
+static void WasmOnRequestHeaders(benchmark::State& state, const char* runtime) {
+  WasmBenchmark bench(runtime);
+  bench.setupStream();
+  for (auto _ : state) {
+    Http::TestHeaderMapImpl headers{{":path", "/"}, {"server", "envoy"}};
+    auto status = bench.context_->decodeHeaders(headers, false);
+    benchmark::DoNotOptimize(status);
+  }
+}
+
+#define WASM_BENCHMARKS(_runtime)                                                                  \
+  BENCHMARK_CAPTURE(WasmCreate, _runtime, #_runtime)->Unit(benchmark::kMicrosecond);               \
+  BENCHMARK_CAPTURE(WasmClone, _runtime, #_runtime)->Unit(benchmark::kMicrosecond);                \
+  BENCHMARK_CAPTURE(WasmGetHeaderMapValue, _runtime, #_runtime);                                   \
+  BENCHMARK_CAPTURE(WasmSetSharedData, _runtime, #_runtime);                                       \
+  BENCHMARK_CAPTURE(WasmIncrementMetric, _runtime, #_runtime);                                     \
+  BENCHMARK_CAPTURE(WasmGetRequestBody, _runtime, #_runtime)->Arg(16)->Arg(1024)->Arg(65536);      \
+  BENCHMARK_CAPTURE(WasmOnRequestHeaders, _runtime, #_runtime)
+
+WASM_BENCHMARKS(null);
+#if defined(ENVOY_WASM_V8)
+WASM_BENCHMARKS(v8);
+#endif
+#if defined(ENVOY_WASM_WAVM)
+WASM_BENCHMARKS(wavm);
+#endif
+
+#undef WASM_BENCHMARKS
+
+} // namespace
+} // namespace Wasm
+} // namespace Extensions
+} // namespace Envoy
+
+BENCHMARK_MAIN();
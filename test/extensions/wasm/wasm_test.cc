@@ -90,6 +90,44 @@ TEST_P(WasmTestMatrix, Logging) {
   wasm->tickHandler(root_context->id());
 }
 
+TEST_P(WasmTestMatrix, LoggingClone) {
+  Stats::IsolatedStoreImpl stats_store;
+  Api::ApiPtr api = Api::createApiForTest(stats_store);
+  Upstream::MockClusterManager cluster_manager;
+  Event::DispatcherPtr dispatcher(api->allocateDispatcher());
+  auto scope = Stats::ScopeSharedPtr(stats_store.createScope("wasm."));
+  NiceMock<LocalInfo::MockLocalInfo> local_info;
+  auto base_wasm = std::make_shared<Extensions::Common::Wasm::Wasm>(
+      absl::StrCat("envoy.wasm.vm.", std::get<0>(GetParam())), "", "", cluster_manager, *dispatcher,
+      *scope, Common::Wasm::PluginDirection::Unspecified, local_info, nullptr, scope);
+  EXPECT_NE(base_wasm, nullptr);
+  const auto code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      absl::StrCat("{{ test_rundir }}/test/extensions/wasm/test_data/logging_",
+                   std::get<1>(GetParam()), ".wasm")));
+  EXPECT_FALSE(code.empty());
+  EXPECT_TRUE(base_wasm->initialize(code, "<test>", false));
+  EXPECT_NE(base_wasm->wasmVm()->cloneable(), Common::Wasm::Cloneable::NotCloneable);
+
+  auto wasm = std::make_shared<Extensions::Common::Wasm::Wasm>(*base_wasm, *dispatcher);
+  if (base_wasm->wasmVm()->cloneable() == Common::Wasm::Cloneable::CompiledBytecode) {
+    // The clone shares the compiled module, so the code passed here is not loaded again.
+    EXPECT_TRUE(wasm->initialize("", "<test>", false));
+  }
+  auto context = std::make_unique<TestContext>(wasm.get());
+
+  EXPECT_CALL(*context, scriptLog_(spdlog::level::warn, Eq("warn configure-test")));
+  EXPECT_CALL(*context, scriptLog_(spdlog::level::trace, Eq("test trace logging")));
+  EXPECT_CALL(*context, scriptLog_(spdlog::level::debug, Eq("test debug logging")));
+  EXPECT_CALL(*context, scriptLog_(spdlog::level::err, Eq("test error logging")));
+  EXPECT_CALL(*context, scriptLog_(spdlog::level::info, Eq("test tick logging")));
+
+  wasm->setContext(context.get());
+  auto root_context = context.get();
+  wasm->startForTesting(std::move(context));
+  wasm->configure(root_context, "configure-test");
+  wasm->tickHandler(root_context->id());
+}
+
 TEST_P(WasmTest, BadSignature) {
   Stats::IsolatedStoreImpl stats_store;
   Api::ApiPtr api = Api::createApiForTest(stats_store);
@@ -228,6 +266,37 @@ TEST_P(WasmTest, Asm2Wasm) {
   wasm->startForTesting(std::move(context));
 }
 
+TEST_P(WasmTest, CompilationCache) {
+  Stats::IsolatedStoreImpl stats_store;
+  Api::ApiPtr api = Api::createApiForTest(stats_store);
+  Upstream::MockClusterManager cluster_manager;
+  Event::DispatcherPtr dispatcher(api->allocateDispatcher());
+  auto scope = Stats::ScopeSharedPtr(stats_store.createScope("wasm."));
+  NiceMock<LocalInfo::MockLocalInfo> local_info;
+  const auto directory = TestEnvironment::temporaryPath("wasm_test_compilation_cache");
+  TestEnvironment::removePath(directory);
+  TestEnvironment::createPath(directory);
+  auto cache = std::make_shared<Common::Wasm::CompilationCache>(*api, directory);
+  const auto code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/wasm/test_data/asm2wasm_cpp.wasm"));
+  EXPECT_FALSE(code.empty());
+
+  // The first VM compiles the code and populates the cache, the second one loads from it.
+  for (int i = 0; i < 2; i++) {
+    auto wasm = std::make_shared<Extensions::Common::Wasm::Wasm>(
+        absl::StrCat("envoy.wasm.vm.", GetParam()), "", "", cluster_manager, *dispatcher, *scope,
+        Common::Wasm::PluginDirection::Unspecified, local_info, nullptr, scope);
+    wasm->setCompilationCache(cache);
+    auto context = std::make_unique<TestContext>(wasm.get());
+    EXPECT_CALL(*context, scriptLog_(spdlog::level::info, Eq("out 0 0 0")));
+    EXPECT_TRUE(wasm->initialize(code, "<test>", false));
+    wasm->startForTesting(std::move(context));
+    EXPECT_TRUE(cache->lookup(Common::Wasm::CompilationCache::key(wasm->wasmVm()->vm(), code))
+                    .has_value());
+  }
+  TestEnvironment::removePath(directory);
+}
+
 TEST_P(WasmTest, Stats) {
   Stats::IsolatedStoreImpl stats_store;
   Api::ApiPtr api = Api::createApiForTest(stats_store);
@@ -0,0 +1,125 @@
+// NOLINT(namespace-envoy)
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+#include "common/memory/stats.h"
+
+#include "exe/process_wide.h"
+
+#include "test/integration/http_integration.h"
+#include "test/test_common/environment.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace {
+
+/**
+ * Proxies requests end to end through an in-process Envoy: the client codec, the listener, the
+ * HTTP connection manager and its filter chain, the router, the upstream connection pool and
+ * codecs, and an autonomous upstream answering each request with a 10 byte body. Envoy runs its
+ * single worker on its own thread, while the client and the upstream share the benchmark thread,
+ * all connected over loopback sockets.
+ */
+class HttpProxyBenchmark : public HttpIntegrationTest {
+public:
+  HttpProxyBenchmark(Http::CodecClient::Type downstream_protocol,
+                     FakeHttpConnection::Type upstream_protocol, uint32_t filters)
+      : HttpIntegrationTest(downstream_protocol, Network::Address::IpVersion::v4) {
+    autonomous_upstream_ = true;
+    setUpstreamProtocol(upstream_protocol);
+    for (uint32_t i = 0; i < filters; i++) {
+      config_helper_.addFilter("name: passthrough-filter");
+    }
+    initialize();
+    codec_client_ = makeHttpConnection(lookupPort("http"));
+  }
+
+  // Sends a header only request and waits for the complete response.
+  void request() {
+    IntegrationStreamDecoderPtr response =
+        codec_client_->makeHeaderOnlyRequest(default_request_headers_);
+    response->waitForEndStream();
+  }
+};
+
+std::chrono::microseconds processCpuTime() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return std::chrono::seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+         std::chrono::microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+/**
+ * The Args are the downstream protocol, the upstream protocol (0 for HTTP/1, 1 for HTTP/2) and
+ * the number of pass-through filters added in front of the router. Besides the time of each
+ * request, it reports:
+ * - requests_per_cpu_second, the requests proxied per second of CPU time of the whole process,
+ *   which includes the client and the upstream.
+ * - p50_us and p99_us, the latencies of the requests.
+ * - retained_bytes_per_request, the growth of the allocated memory over the run.
+ */
+void BM_HttpProxyRequest(benchmark::State& state) {
+  HttpProxyBenchmark proxy(
+      state.range(0) == 0 ? Http::CodecClient::Type::HTTP1 : Http::CodecClient::Type::HTTP2,
+      state.range(1) == 0 ? FakeHttpConnection::Type::HTTP1 : FakeHttpConnection::Type::HTTP2,
+      state.range(2));
+  // The first request sets up the upstream connection.
+  proxy.request();
+
+  std::vector<std::chrono::nanoseconds> latencies;
+  const uint64_t start_bytes = Memory::Stats::totalCurrentlyAllocated();
+  const std::chrono::microseconds start_cpu_time = processCpuTime();
+  for (auto _ : state) {
+    const auto start = std::chrono::steady_clock::now();
+    proxy.request();
+    latencies.push_back(std::chrono::steady_clock::now() - start);
+  }
+  const std::chrono::microseconds cpu_time = processCpuTime() - start_cpu_time;
+  const int64_t retained_bytes = Memory::Stats::totalCurrentlyAllocated() - start_bytes;
+
+  std::sort(latencies.begin(), latencies.end());
+  const auto percentile = [&latencies](double p) {
+    return std::chrono::duration<double, std::micro>(
+               latencies[static_cast<size_t>(p * (latencies.size() - 1))])
+        .count();
+  };
+  state.counters["requests_per_cpu_second"] = latencies.size() * 1e6 / cpu_time.count();
+  state.counters["p50_us"] = percentile(0.5);
+  state.counters["p99_us"] = percentile(0.99);
+  state.counters["retained_bytes_per_request"] =
+      static_cast<double>(retained_bytes) / latencies.size();
+}
+BENCHMARK(BM_HttpProxyRequest)
+    ->Args({0, 0, 0})
+    ->Args({0, 0, 4})
+    ->Args({1, 0, 0})
+    ->Args({0, 1, 0})
+    ->Args({1, 1, 0})
+    ->Args({1, 1, 4})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+} // namespace
+} // namespace Envoy
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  Envoy::ProcessWide process_wide;
+  // The configuration templates are not read from the runfiles, which only bazel test sets up.
+  Envoy::TestEnvironment::setEnvVar("TEST_RUNDIR", ".", 0);
+  Envoy::TestEnvironment::initializeOptions(argc, argv);
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -357,6 +357,9 @@ protected:
   // True if test will use a fixed RNG value.
   bool deterministic_{};
 
+  // The number of worker threads of the server.
+  uint32_t concurrency_{1};
+
   // Set true when your test will itself take care of ensuring listeners are up, and registering
   // them in the port_map_.
   bool defer_listener_finalization_{false};
@@ -0,0 +1,449 @@
+// NOLINT(namespace-envoy)
+#include <sys/resource.h>
+#include <time.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/api/v2/cds.pb.h"
+#include "envoy/api/v2/eds.pb.h"
+#include "envoy/api/v2/lds.pb.h"
+#include "envoy/api/v2/rds.pb.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/fmt.h"
+#include "common/common/lock_guard.h"
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+#include "common/config/protobuf_link_hacks.h"
+#include "common/config/resources.h"
+#include "common/memory/stats.h"
+
+#include "exe/process_wide.h"
+
+#include "test/integration/http_integration.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/synchronization/notification.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace {
+
+const std::string& xdsUpdateBenchmarkConfig() {
+  CONSTRUCT_ON_FIRST_USE(std::string, R"EOF(
+dynamic_resources:
+  lds_config: {ads: {}}
+  cds_config: {ads: {}}
+  ads_config:
+    api_type: GRPC
+    set_node_on_first_message_only: true
+static_resources:
+  clusters:
+    name: dummy_cluster
+    connect_timeout: { seconds: 5 }
+    type: STATIC
+    hosts:
+      socket_address:
+        address: 127.0.0.1
+        port_value: 0
+    lb_policy: ROUND_ROBIN
+    http2_protocol_options: {}
+admin:
+  access_log_path: /dev/null
+  address:
+    socket_address:
+      address: 127.0.0.1
+      port_value: 0
+)EOF");
+}
+
+/**
+ * The CPU time spent by a thread of the server, as last sampled on the thread itself.
+ */
+struct ThreadCpuTime : public ThreadLocal::ThreadLocalObject {
+  void sample() {
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    cpu_time_ = std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec);
+  }
+
+  bool main_thread_{};
+  std::chrono::nanoseconds cpu_time_{};
+};
+
+using ThreadCpuTimeSharedPtr = std::shared_ptr<ThreadCpuTime>;
+
+/**
+ * Applies large xDS updates to an in-process Envoy, through the same path as a management server's:
+ * the ADS gRPC stream and GrpcMuxImpl, then CdsApiImpl and the cluster manager for the clusters,
+ * EdsClusterImpl for their endpoints, LdsApiImpl and the listener manager for the listeners, and
+ * RdsRouteConfigProviderImpl for their route configurations. The clusters and listeners are then
+ * propagated to the workers, which serve no traffic.
+ *
+ * Each update changes every resource, so that none is skipped as unchanged.
+ */
+class XdsUpdateBenchmark : public HttpIntegrationTest {
+public:
+  // The number of listeners, each with its own route configuration.
+  static constexpr uint32_t Listeners = 10;
+
+  struct UpdateTimes {
+    // The wall time of each update, from sending its discovery response to the main thread having
+    // applied it.
+    std::chrono::nanoseconds cds_{};
+    std::chrono::nanoseconds eds_{};
+    std::chrono::nanoseconds lds_{};
+    std::chrono::nanoseconds rds_{};
+    // The wall time the workers then took to apply the changes the main thread posted to them.
+    std::chrono::nanoseconds propagation_{};
+    // The CPU time spent by the main thread and by each worker over the updates.
+    std::chrono::nanoseconds main_cpu_{};
+    std::vector<std::chrono::nanoseconds> worker_cpu_;
+
+    std::chrono::nanoseconds total() const { return cds_ + eds_ + lds_ + rds_ + propagation_; }
+  };
+
+  XdsUpdateBenchmark(uint32_t clusters, uint32_t endpoints_per_cluster, uint32_t routes,
+                     uint32_t workers)
+      : HttpIntegrationTest(Http::CodecClient::Type::HTTP2, Network::Address::IpVersion::v4,
+                            xdsUpdateBenchmarkConfig()),
+        clusters_(clusters), endpoints_per_cluster_(endpoints_per_cluster),
+        routes_per_listener_(routes / Listeners) {
+    use_lds_ = false;
+    create_xds_upstream_ = true;
+    concurrency_ = workers;
+    config_helper_.addConfigModifier([](envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
+      bootstrap.mutable_dynamic_resources()
+          ->mutable_ads_config()
+          ->add_grpc_services()
+          ->mutable_envoy_grpc()
+          ->set_cluster_name("ads_cluster");
+      auto* ads_cluster = bootstrap.mutable_static_resources()->add_clusters();
+      ads_cluster->MergeFrom(bootstrap.static_resources().clusters()[0]);
+      ads_cluster->set_name("ads_cluster");
+    });
+    setUpstreamProtocol(FakeHttpConnection::Type::HTTP2);
+    HttpIntegrationTest::initialize();
+    createXdsConnection();
+    AssertionResult result = xds_connection_->waitForNewStream(*dispatcher_, xds_stream_);
+    RELEASE_ASSERT(result, result.message());
+    xds_stream_->startGrpcStream();
+
+    // The server initializes with no clusters nor listeners. The requests which follow are not
+    // read.
+    result = compareDiscoveryRequest(Config::TypeUrl::get().Cluster, "", {}, {}, {}, true);
+    RELEASE_ASSERT(result, result.message());
+    sendSotwDiscoveryResponse<envoy::api::v2::Cluster>(Config::TypeUrl::get().Cluster, {}, "0");
+    result = compareDiscoveryRequest(Config::TypeUrl::get().Cluster, "0", {}, {}, {});
+    RELEASE_ASSERT(result, result.message());
+    result = compareDiscoveryRequest(Config::TypeUrl::get().Listener, "", {}, {}, {});
+    RELEASE_ASSERT(result, result.message());
+    sendSotwDiscoveryResponse<envoy::api::v2::Listener>(Config::TypeUrl::get().Listener, {}, "0");
+
+    cds_update_success_ = findCounter("cluster_manager.cds.update_success");
+    lds_update_success_ = findCounter("listener_manager.lds.update_success");
+    waitFor(lds_update_success_, [](uint64_t value) { return value >= 1; });
+    warming_clusters_ = test_server_->gauge("cluster_manager.warming_clusters");
+    warming_listeners_ = test_server_->gauge("listener_manager.total_listeners_warming");
+
+    runOnMainThread([this] {
+      Event::Dispatcher* main_dispatcher = &test_server_->server().dispatcher();
+      cpu_time_slot_ = test_server_->server().threadLocal().allocateSlot();
+      cpu_time_slot_->set([this, main_dispatcher](Event::Dispatcher& dispatcher) {
+        auto thread = std::make_shared<ThreadCpuTime>();
+        thread->main_thread_ = &dispatcher == main_dispatcher;
+        Thread::LockGuard lock(threads_lock_);
+        threads_.push_back(thread);
+        return thread;
+      });
+    });
+  }
+
+  ~XdsUpdateBenchmark() override {
+    runOnMainThread([this] { cpu_time_slot_.reset(); });
+    cleanUpXdsConnection();
+    test_server_.reset();
+    fake_upstreams_.clear();
+  }
+
+  /**
+   * Updates all the clusters, endpoints, listeners and route configurations to the given version,
+   * waiting for each update to be applied before sending the next one.
+   */
+  UpdateTimes update(uint32_t version) {
+    UpdateTimes times;
+    const std::vector<ThreadCpuTimeSharedPtr> threads = sampleThreads();
+    std::vector<std::chrono::nanoseconds> start_cpu_times;
+    for (const auto& thread : threads) {
+      start_cpu_times.push_back(thread->cpu_time_);
+    }
+
+    // The new version of every cluster warms until its endpoints are received.
+    std::vector<envoy::api::v2::Cluster> clusters = buildClusters(version);
+    auto start = std::chrono::steady_clock::now();
+    sendSotwDiscoveryResponse(Config::TypeUrl::get().Cluster, clusters, std::to_string(version));
+    waitFor(cds_update_success_, [version](uint64_t value) { return value >= version + 1; });
+    times.cds_ = std::chrono::steady_clock::now() - start;
+    clusters.clear();
+
+    std::vector<envoy::api::v2::ClusterLoadAssignment> load_assignments =
+        buildLoadAssignments(version);
+    start = std::chrono::steady_clock::now();
+    sendSotwDiscoveryResponse(Config::TypeUrl::get().ClusterLoadAssignment, load_assignments,
+                              std::to_string(version));
+    waitFor(warming_clusters_, [](uint64_t value) { return value == 0; });
+    times.eds_ = std::chrono::steady_clock::now() - start;
+    load_assignments.clear();
+
+    // The listeners of the first version warm until their route configurations are received.
+    std::vector<envoy::api::v2::Listener> listeners = buildListeners(version);
+    start = std::chrono::steady_clock::now();
+    sendSotwDiscoveryResponse(Config::TypeUrl::get().Listener, listeners, std::to_string(version));
+    waitFor(lds_update_success_, [version](uint64_t value) { return value >= version + 1; });
+    times.lds_ = std::chrono::steady_clock::now() - start;
+    listeners.clear();
+
+    if (rds_update_success_.empty()) {
+      for (uint32_t i = 0; i < Listeners; i++) {
+        rds_update_success_.push_back(
+            findCounter(fmt::format("http.bench.rds.route_config_{}.update_success", i)));
+      }
+    }
+    std::vector<envoy::api::v2::RouteConfiguration> route_configs = buildRouteConfigs(version);
+    start = std::chrono::steady_clock::now();
+    sendSotwDiscoveryResponse(Config::TypeUrl::get().RouteConfiguration, route_configs,
+                              std::to_string(version));
+    for (const Stats::CounterSharedPtr& update_success : rds_update_success_) {
+      waitFor(update_success, [version](uint64_t value) { return value >= version; });
+    }
+    waitFor(warming_listeners_, [](uint64_t value) { return value == 0; });
+    times.rds_ = std::chrono::steady_clock::now() - start;
+    route_configs.clear();
+
+    start = std::chrono::steady_clock::now();
+    sampleThreads();
+    times.propagation_ = std::chrono::steady_clock::now() - start;
+
+    for (size_t i = 0; i < threads.size(); i++) {
+      const std::chrono::nanoseconds cpu_time = threads[i]->cpu_time_ - start_cpu_times[i];
+      if (threads[i]->main_thread_) {
+        times.main_cpu_ = cpu_time;
+      } else {
+        times.worker_cpu_.push_back(cpu_time);
+      }
+    }
+    return times;
+  }
+
+private:
+  std::vector<envoy::api::v2::Cluster> buildClusters(uint32_t version) const {
+    std::vector<envoy::api::v2::Cluster> clusters(clusters_);
+    for (uint32_t i = 0; i < clusters_; i++) {
+      envoy::api::v2::Cluster& cluster = clusters[i];
+      cluster.set_name(fmt::format("cluster_{}", i));
+      cluster.set_type(envoy::api::v2::Cluster::EDS);
+      cluster.mutable_eds_cluster_config()->mutable_eds_config()->mutable_ads();
+      cluster.mutable_connect_timeout()->set_seconds(5);
+      cluster.mutable_connect_timeout()->set_nanos(version);
+    }
+    return clusters;
+  }
+
+  std::vector<envoy::api::v2::ClusterLoadAssignment> buildLoadAssignments(uint32_t version) const {
+    std::vector<envoy::api::v2::ClusterLoadAssignment> load_assignments(clusters_);
+    for (uint32_t i = 0; i < clusters_; i++) {
+      envoy::api::v2::ClusterLoadAssignment& load_assignment = load_assignments[i];
+      load_assignment.set_cluster_name(fmt::format("cluster_{}", i));
+      auto* locality_endpoints = load_assignment.add_endpoints();
+      for (uint32_t j = 0; j < endpoints_per_cluster_; j++) {
+        auto* lb_endpoint = locality_endpoints->add_lb_endpoints();
+        auto* address =
+            lb_endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
+        address->set_address("127.0.0.1");
+        address->set_port_value(10000 + j);
+        lb_endpoint->mutable_load_balancing_weight()->set_value(version);
+      }
+    }
+    return load_assignments;
+  }
+
+  std::vector<envoy::api::v2::Listener> buildListeners(uint32_t version) const {
+    std::vector<envoy::api::v2::Listener> listeners;
+    for (uint32_t i = 0; i < Listeners; i++) {
+      const std::string yaml = fmt::format(R"EOF(
+      name: listener_{0}
+      address:
+        socket_address:
+          address: 127.0.0.1
+          port_value: 0
+      per_connection_buffer_limit_bytes: {1}
+      filter_chains:
+        filters:
+        - name: envoy.http_connection_manager
+          config:
+            stat_prefix: bench
+            codec_type: HTTP2
+            rds:
+              route_config_name: route_config_{0}
+              config_source: {{ ads: {{}} }}
+            http_filters: [{{ name: envoy.router }}]
+    )EOF",
+                                           i, 1048576 + version);
+      listeners.push_back(TestUtility::parseYaml<envoy::api::v2::Listener>(yaml));
+    }
+    return listeners;
+  }
+
+  std::vector<envoy::api::v2::RouteConfiguration> buildRouteConfigs(uint32_t version) const {
+    std::vector<envoy::api::v2::RouteConfiguration> route_configs(Listeners);
+    for (uint32_t i = 0; i < Listeners; i++) {
+      envoy::api::v2::RouteConfiguration& route_config = route_configs[i];
+      route_config.set_name(fmt::format("route_config_{}", i));
+      auto* virtual_host = route_config.add_virtual_hosts();
+      virtual_host->set_name("bench");
+      virtual_host->add_domains("*");
+      for (uint32_t j = 0; j < routes_per_listener_; j++) {
+        auto* route = virtual_host->add_routes();
+        route->mutable_match()->set_prefix(fmt::format("/v{}/route_{}", version, j));
+        route->mutable_route()->set_cluster(
+            fmt::format("cluster_{}", (i * routes_per_listener_ + j) % clusters_));
+      }
+    }
+    return route_configs;
+  }
+
+  // Looks up a stat of the server once it exists. A lookup goes through all the stats of the
+  // server, so the stats waited for are only looked up once.
+  Stats::CounterSharedPtr findCounter(const std::string& name) {
+    Stats::CounterSharedPtr counter;
+    while ((counter = test_server_->counter(name)) == nullptr) {
+      timeSystem().sleep(std::chrono::milliseconds(10));
+    }
+    return counter;
+  }
+
+  template <class StatSharedPtr>
+  void waitFor(const StatSharedPtr& stat, const std::function<bool(uint64_t)>& condition) {
+    while (!condition(stat->value())) {
+      timeSystem().sleep(std::chrono::microseconds(100));
+    }
+  }
+
+  void runOnMainThread(std::function<void()> cb) {
+    absl::Notification done;
+    test_server_->server().dispatcher().post([&cb, &done]() -> void {
+      cb();
+      done.Notify();
+    });
+    done.WaitForNotification();
+  }
+
+  // Samples the CPU time of the main thread and of the workers. The samples are sequenced after
+  // the changes the main thread posted to the workers before, and this returns once the workers
+  // have applied them.
+  std::vector<ThreadCpuTimeSharedPtr> sampleThreads() {
+    absl::Notification done;
+    test_server_->server().dispatcher().post([this, &done]() -> void {
+      cpu_time_slot_->runOnAllThreads(
+          [this]() -> void { cpu_time_slot_->getTyped<ThreadCpuTime>().sample(); },
+          [&done]() -> void { done.Notify(); });
+    });
+    done.WaitForNotification();
+    Thread::LockGuard lock(threads_lock_);
+    return threads_;
+  }
+
+  const uint32_t clusters_;
+  const uint32_t endpoints_per_cluster_;
+  const uint32_t routes_per_listener_;
+  Stats::CounterSharedPtr cds_update_success_;
+  Stats::CounterSharedPtr lds_update_success_;
+  std::vector<Stats::CounterSharedPtr> rds_update_success_;
+  Stats::GaugeSharedPtr warming_clusters_;
+  Stats::GaugeSharedPtr warming_listeners_;
+  ThreadLocal::SlotPtr cpu_time_slot_;
+  Thread::MutexBasicLockable threads_lock_;
+  std::vector<ThreadCpuTimeSharedPtr> threads_ GUARDED_BY(threads_lock_);
+};
+
+constexpr uint32_t XdsUpdateBenchmark::Listeners;
+
+double toMilliseconds(std::chrono::nanoseconds duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+/**
+ * The Args are the number of clusters, the number of endpoints of each cluster, the number of
+ * routes, spread over XdsUpdateBenchmark::Listeners route configurations, and the number of
+ * workers. The time of an iteration is the wall time of a whole update. Besides, it reports
+ * averaged over the iterations:
+ * - cds_ms, eds_ms, lds_ms and rds_ms, the wall time of each update.
+ * - propagation_ms, the wall time the workers then took to apply the changes.
+ * - main_cpu_ms and worker_<n>_cpu_ms, the CPU time spent by each thread over the updates.
+ * and once the updates are done:
+ * - peak_rss_mb, the peak resident memory of the process, which includes the management server.
+ * - allocated_mb, the memory allocated by the process.
+ */
+void BM_XdsUpdate(benchmark::State& state) {
+  XdsUpdateBenchmark xds(state.range(0), state.range(1), state.range(2), state.range(3));
+  uint32_t version = 0;
+  for (auto _ : state) {
+    const XdsUpdateBenchmark::UpdateTimes times = xds.update(++version);
+    state.SetIterationTime(std::chrono::duration<double>(times.total()).count());
+
+    const auto add = [&state](const std::string& name, std::chrono::nanoseconds duration) {
+      auto it = state.counters.find(name);
+      if (it == state.counters.end()) {
+        it = state.counters.emplace(name, benchmark::Counter(0, benchmark::Counter::kAvgIterations))
+                 .first;
+      }
+      it->second.value += toMilliseconds(duration);
+    };
+    add("cds_ms", times.cds_);
+    add("eds_ms", times.eds_);
+    add("lds_ms", times.lds_);
+    add("rds_ms", times.rds_);
+    add("propagation_ms", times.propagation_);
+    add("main_cpu_ms", times.main_cpu_);
+    for (size_t i = 0; i < times.worker_cpu_.size(); i++) {
+      add(fmt::format("worker_{}_cpu_ms", i), times.worker_cpu_[i]);
+    }
+  }
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  // ru_maxrss is in kilobytes.
+  state.counters["peak_rss_mb"] = usage.ru_maxrss / 1024.0;
+  state.counters["allocated_mb"] = Memory::Stats::totalCurrentlyAllocated() / (1024.0 * 1024.0);
+}
+BENCHMARK(BM_XdsUpdate)
+    ->Args({1000, 10, 5000, 2})
+    ->Args({10000, 10, 50000, 2})
+    ->Args({10000, 10, 50000, 8})
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime();
+
+} // namespace
+} // namespace Envoy
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  Envoy::ProcessWide process_wide;
+  // The configuration templates are not read from the runfiles, which only bazel test sets up.
+  Envoy::TestEnvironment::setEnvVar("TEST_RUNDIR", ".", 0);
+  Envoy::TestEnvironment::initializeOptions(argc, argv);
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+  benchmark::RunSpecifiedBenchmarks();
+}
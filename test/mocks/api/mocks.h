@@ -67,6 +67,10 @@ public:
   MOCK_METHOD6(recvfrom, SysCallSizeResult(int sockfd, void* buffer, size_t length, int flags,
                                            struct sockaddr* addr, socklen_t* addrlen));
   MOCK_METHOD3(recvmsg, SysCallSizeResult(int socket, struct msghdr* msg, int flags));
+  MOCK_METHOD5(recvmmsg, SysCallIntResult(int socket, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags, struct timespec* timeout));
+  MOCK_METHOD4(sendmmsg, SysCallIntResult(int socket, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags));
   MOCK_METHOD2(ftruncate, SysCallIntResult(int fd, off_t length));
   MOCK_METHOD6(mmap, SysCallPtrResult(void* addr, size_t length, int prot, int flags, int fd,
                                       off_t offset));
@@ -87,6 +91,9 @@ class MockLinuxOsSysCalls : public LinuxOsSysCallsImpl {
 public:
   // Api::LinuxOsSysCalls
   MOCK_METHOD3(sched_getaffinity, SysCallIntResult(pid_t pid, size_t cpusetsize, cpu_set_t* mask));
+  MOCK_METHOD2(pipe2, SysCallIntResult(int pipefd[2], int flags));
+  MOCK_METHOD6(splice, SysCallSizeResult(int fd_in, loff_t* off_in, int fd_out, loff_t* off_out,
+                                         size_t len, unsigned int flags));
 };
 #endif
 
@@ -32,6 +32,7 @@ public:
 
   // Dispatcher
   TimeSource& timeSource() override { return time_system_; }
+  MonotonicTime approximateMonotonicTime() override { return time_system_.monotonicTime(); }
   Network::ConnectionPtr
   createServerConnection(Network::ConnectionSocketPtr&& socket,
                          Network::TransportSocketPtr&& transport_socket) override {
@@ -72,6 +73,9 @@ public:
     return Event::TimerPtr{createTimer_(cb)};
   }
 
+  // Coarse timers are plain mock timers, so tests need not tell the two kinds apart.
+  Event::TimerPtr createCoarseTimer(Event::TimerCb cb) override { return createTimer(cb); }
+
   void deferredDelete(DeferredDeletablePtr&& to_delete) override {
     deferredDelete_(to_delete.get());
     if (to_delete) {
@@ -83,6 +87,9 @@ public:
     return SignalEventPtr{listenForSignal_(signal_num, cb)};
   }
 
+  // Posts of any priority go to the same mock method, so tests need not tell them apart.
+  void post(std::function<void()> callback, PostPriority) override { post(callback); }
+
   // Event::Dispatcher
   MOCK_METHOD2(initializeStats, void(Stats::Scope&, const std::string&));
   MOCK_METHOD0(clearDeferredDeleteList, void());
@@ -114,6 +121,7 @@ public:
   MOCK_METHOD1(post, void(std::function<void()> callback));
   MOCK_METHOD1(run, void(RunType type));
   MOCK_METHOD1(setTrackedObject, const ScopeTrackedObject*(const ScopeTrackedObject* object));
+  MOCK_CONST_METHOD0(trackedObject, const ScopeTrackedObject*());
   MOCK_CONST_METHOD0(isThreadSafe, bool());
   Buffer::WatermarkFactory& getWatermarkFactory() override { return buffer_factory_; }
 
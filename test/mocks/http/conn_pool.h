@@ -32,6 +32,7 @@ public:
   MOCK_CONST_METHOD0(hasActiveConnections, bool());
   MOCK_METHOD2(newStream, Cancellable*(Http::StreamDecoder& response_decoder,
                                        Http::ConnectionPool::Callbacks& callbacks));
+  MOCK_METHOD1(preconnect, void(uint32_t expected_requests));
   MOCK_CONST_METHOD0(host, Upstream::HostDescriptionConstSharedPtr());
 
   std::shared_ptr<testing::NiceMock<Upstream::MockHostDescription>> host_;
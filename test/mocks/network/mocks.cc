@@ -27,11 +27,16 @@ namespace Network {
 MockListenerConfig::MockListenerConfig() {
   ON_CALL(*this, filterChainFactory()).WillByDefault(ReturnRef(filter_chain_factory_));
   ON_CALL(*this, socket()).WillByDefault(ReturnRef(socket_));
+  ON_CALL(*this, workerSocket(_)).WillByDefault(ReturnRef(socket_));
   ON_CALL(*this, listenerScope()).WillByDefault(ReturnRef(scope_));
+  ON_CALL(*this, connectionBalancer()).WillByDefault(ReturnRef(connection_balancer_));
   ON_CALL(*this, name()).WillByDefault(ReturnRef(name_));
 }
 MockListenerConfig::~MockListenerConfig() = default;
 
+MockConnectionBalancer::MockConnectionBalancer() = default;
+MockConnectionBalancer::~MockConnectionBalancer() = default;
+
 MockActiveDnsQuery::MockActiveDnsQuery() = default;
 MockActiveDnsQuery::~MockActiveDnsQuery() = default;
 
@@ -102,6 +107,11 @@ MockListenerFilter::~MockListenerFilter() = default;
 
 MockListenerFilterCallbacks::MockListenerFilterCallbacks() {
   ON_CALL(*this, socket()).WillByDefault(ReturnRef(socket_));
+  ON_CALL(*this, setDynamicMetadata(_, _))
+      .WillByDefault(Invoke([this](const std::string& name, const ProtobufWkt::Struct& value) {
+        (*metadata_.mutable_filter_metadata())[name].MergeFrom(value);
+      }));
+  ON_CALL(*this, dynamicMetadata()).WillByDefault(ReturnRef(metadata_));
 }
 MockListenerFilterCallbacks::~MockListenerFilterCallbacks() = default;
 
@@ -167,6 +177,7 @@ MockTransportSocketFactory::~MockTransportSocketFactory() = default;
 
 MockTransportSocketCallbacks::MockTransportSocketCallbacks() {
   ON_CALL(*this, connection()).WillByDefault(ReturnRef(connection_));
+  ON_CALL(*this, readSizeHint()).WillByDefault(Return(16384));
 }
 MockTransportSocketCallbacks::~MockTransportSocketCallbacks() = default;
 
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "envoy/api/v2/core/address.pb.h"
+#include "envoy/api/v2/core/base.pb.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/drain_decision.h"
 #include "envoy/network/filter.h"
@@ -13,6 +14,7 @@
 #include "envoy/network/transport_socket.h"
 #include "envoy/stats/scope.h"
 
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/filter_manager_impl.h"
 #include "common/stats/isolated_store_impl.h"
 
@@ -290,8 +292,11 @@ public:
   MOCK_METHOD0(socket, ConnectionSocket&());
   MOCK_METHOD0(dispatcher, Event::Dispatcher&());
   MOCK_METHOD1(continueFilterChain, void(bool));
+  MOCK_METHOD2(setDynamicMetadata, void(const std::string&, const ProtobufWkt::Struct&));
+  MOCK_CONST_METHOD0(dynamicMetadata, const envoy::api::v2::core::Metadata&());
 
   NiceMock<MockConnectionSocket> socket_;
+  envoy::api::v2::core::Metadata metadata_;
 };
 
 class MockListenerConfig : public ListenerConfig {
@@ -303,21 +308,36 @@ public:
   MOCK_METHOD0(filterChainFactory, FilterChainFactory&());
   MOCK_METHOD0(socket, Socket&());
   MOCK_CONST_METHOD0(socket, const Socket&());
+  MOCK_METHOD1(workerSocket, Socket&(uint32_t worker_index));
   MOCK_METHOD0(bindToPort, bool());
   MOCK_CONST_METHOD0(handOffRestoredDestinationConnections, bool());
   MOCK_CONST_METHOD0(perConnectionBufferLimitBytes, uint32_t());
+  MOCK_CONST_METHOD0(perConnectionReadBudgetBytes, uint32_t());
   MOCK_CONST_METHOD0(listenerFiltersTimeout, std::chrono::milliseconds());
   MOCK_CONST_METHOD0(continueOnListenerFiltersTimeout, bool());
   MOCK_METHOD0(listenerScope, Stats::Scope&());
+  MOCK_METHOD0(connectionBalancer, ConnectionBalancer&());
   MOCK_CONST_METHOD0(listenerTag, uint64_t());
   MOCK_CONST_METHOD0(name, const std::string&());
 
   testing::NiceMock<MockFilterChainFactory> filter_chain_factory_;
   testing::NiceMock<MockListenSocket> socket_;
   Stats::IsolatedStoreImpl scope_;
+  NopConnectionBalancerImpl connection_balancer_;
   std::string name_;
 };
 
+class MockConnectionBalancer : public ConnectionBalancer {
+public:
+  MockConnectionBalancer();
+  ~MockConnectionBalancer() override;
+
+  MOCK_METHOD1(registerHandler, void(BalancedConnectionHandler& handler));
+  MOCK_METHOD1(unregisterHandler, void(BalancedConnectionHandler& handler));
+  MOCK_METHOD1(pickTargetHandler,
+               BalancedConnectionHandler&(BalancedConnectionHandler& current_handler));
+};
+
 class MockListener : public Listener {
 public:
   MockListener();
@@ -342,6 +362,9 @@ public:
   MOCK_METHOD0(stopListeners, void());
   MOCK_METHOD0(disableListeners, void());
   MOCK_METHOD0(enableListeners, void());
+  MOCK_METHOD0(disableConnectionReads, void());
+  MOCK_METHOD0(enableConnectionReads, void());
+  MOCK_METHOD1(topBufferedConnections, std::vector<BufferedConnection>(uint32_t limit));
 };
 
 class MockIp : public Address::Ip {
@@ -421,6 +444,7 @@ public:
   MOCK_METHOD0(connection, Connection&());
   MOCK_METHOD0(shouldDrainReadBuffer, bool());
   MOCK_METHOD0(setReadBufferReady, void());
+  MOCK_METHOD0(readSizeHint, uint64_t());
   MOCK_METHOD1(raiseEvent, void(ConnectionEvent));
 
   testing::NiceMock<MockConnection> connection_;
@@ -437,6 +461,7 @@ public:
   MOCK_METHOD0(dispatcher, Event::Dispatcher&());
   MOCK_CONST_METHOD0(localAddress, Address::InstanceConstSharedPtr&());
   MOCK_METHOD1(send, Api::IoCallUint64Result(const UdpSendData&));
+  MOCK_METHOD1(sendBatch, Api::IoCallUint64Result(const UdpSendBatchData&));
 };
 
 class MockUdpReadFilterCallbacks : public UdpReadFilterCallbacks {
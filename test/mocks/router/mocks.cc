@@ -2,10 +2,13 @@
 
 #include <chrono>
 
+#include "common/router/per_filter_config_ids.h"
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnPointee;
@@ -53,6 +56,9 @@ MockRateLimitPolicy::~MockRateLimitPolicy() = default;
 MockShadowWriter::MockShadowWriter() = default;
 MockShadowWriter::~MockShadowWriter() = default;
 
+MockShadowStream::MockShadowStream() = default;
+MockShadowStream::~MockShadowStream() = default;
+
 MockVirtualHost::MockVirtualHost() {
   ON_CALL(*this, name()).WillByDefault(ReturnRef(name_));
   ON_CALL(*this, rateLimitPolicy()).WillByDefault(ReturnRef(rate_limit_policy_));
@@ -113,6 +119,19 @@ MockRoute::MockRoute() {
   ON_CALL(*this, routeEntry()).WillByDefault(Return(&route_entry_));
   ON_CALL(*this, decorator()).WillByDefault(Return(&decorator_));
   ON_CALL(*this, tracingConfig()).WillByDefault(Return(nullptr));
+  // Resolves the configs mocked by filter name, from the most specific level to the least.
+  ON_CALL(*this, mostSpecificPerFilterConfig(_))
+      .WillByDefault(Invoke([this](uint32_t filter_id) -> const RouteSpecificFilterConfig* {
+        const std::string name = PerFilterConfigIds::name(filter_id);
+        for (const RouteSpecificFilterConfig* config :
+             {route_entry_.perFilterConfig(name), perFilterConfig(name),
+              route_entry_.virtual_host_.perFilterConfig(name)}) {
+          if (config != nullptr) {
+            return config;
+          }
+        }
+        return nullptr;
+      }));
 }
 MockRoute::~MockRoute() = default;
 
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
+#include <regex>
 #include <string>
 #include <vector>
 
@@ -52,6 +54,16 @@ public:
   // Router::CorsPolicy
   const std::list<std::string>& allowOrigins() const override { return allow_origin_; };
   const std::list<std::regex>& allowOriginRegexes() const override { return allow_origin_regex_; };
+  bool allowOriginsContain(absl::string_view origin) const override {
+    return std::any_of(allow_origin_.begin(), allow_origin_.end(),
+                       [origin](const std::string& o) { return o == "*" || o == origin; });
+  }
+  bool allowOriginRegexesMatch(absl::string_view origin) const override {
+    return std::any_of(allow_origin_regex_.begin(), allow_origin_regex_.end(),
+                       [origin](const std::regex& regex) {
+                         return std::regex_match(origin.begin(), origin.end(), regex);
+                       });
+  }
   const std::string& allowMethods() const override { return allow_methods_; };
   const std::string& allowHeaders() const override { return allow_headers_; };
   const std::string& exposeHeaders() const override { return expose_headers_; };
@@ -79,10 +91,16 @@ public:
     return additional_request_chance_;
   }
   bool hedgeOnPerTryTimeout() const override { return hedge_on_per_try_timeout_; }
+  absl::optional<double> hedgeOnLatencyPercentile() const override {
+    return hedge_on_latency_percentile_;
+  }
+  double hedgeBudgetPercent() const override { return hedge_budget_percent_; }
 
   uint32_t initial_requests_{};
   envoy::type::FractionalPercent additional_request_chance_{};
   bool hedge_on_per_try_timeout_{};
+  absl::optional<double> hedge_on_latency_percentile_;
+  double hedge_budget_percent_{10};
 };
 
 class TestRetryPolicy : public RetryPolicy {
@@ -173,10 +191,12 @@ public:
   const std::string& cluster() const override { return cluster_; }
   const std::string& runtimeKey() const override { return runtime_key_; }
   const envoy::type::FractionalPercent& defaultValue() const override { return default_value_; }
+  bool streamBody() const override { return stream_body_; }
 
   std::string cluster_;
   std::string runtime_key_;
   envoy::type::FractionalPercent default_value_;
+  bool stream_body_{};
 };
 
 class MockShadowWriter : public ShadowWriter {
@@ -190,8 +210,29 @@ public:
     shadow_(cluster, request, timeout);
   }
 
+  ShadowStreamPtr streamingShadow(const std::string& cluster, Http::HeaderMapPtr&& headers,
+                                  std::chrono::milliseconds timeout, uint32_t buffer_limit,
+                                  bool end_stream) override {
+    return ShadowStreamPtr{streamingShadow_(cluster, *headers, timeout, buffer_limit, end_stream)};
+  }
+
   MOCK_METHOD3(shadow_, void(const std::string& cluster, Http::MessagePtr& request,
                              std::chrono::milliseconds timeout));
+  MOCK_METHOD5(streamingShadow_,
+               ShadowStream*(const std::string& cluster, Http::HeaderMap& headers,
+                             std::chrono::milliseconds timeout, uint32_t buffer_limit,
+                             bool end_stream));
+};
+
+class MockShadowStream : public ShadowStream {
+public:
+  MockShadowStream();
+  ~MockShadowStream() override;
+
+  // Router::ShadowStream
+  MOCK_METHOD2(sendData, void(Buffer::Instance& data, bool end_stream));
+  MOCK_METHOD1(sendTrailers, void(const Http::HeaderMap& trailers));
+  MOCK_CONST_METHOD0(aboveBufferLimit, bool());
 };
 
 class TestVirtualCluster : public VirtualCluster {
@@ -212,7 +253,7 @@ public:
   MOCK_CONST_METHOD0(name, const std::string&());
   MOCK_CONST_METHOD0(rateLimitPolicy, const RateLimitPolicy&());
   MOCK_CONST_METHOD0(corsPolicy, const CorsPolicy*());
-  MOCK_CONST_METHOD0(routeConfig, const Config&());
+  MOCK_CONST_METHOD0(routeConfig, const CommonConfig&());
   MOCK_CONST_METHOD1(perFilterConfig, const RouteSpecificFilterConfig*(const std::string&));
   MOCK_CONST_METHOD0(includeAttemptCount, bool());
   MOCK_METHOD0(retryPriority, Upstream::RetryPrioritySharedPtr());
@@ -357,6 +398,7 @@ public:
   MOCK_CONST_METHOD0(decorator, const Decorator*());
   MOCK_CONST_METHOD0(tracingConfig, const RouteTracing*());
   MOCK_CONST_METHOD1(perFilterConfig, const RouteSpecificFilterConfig*(const std::string&));
+  MOCK_CONST_METHOD1(mostSpecificPerFilterConfig, const RouteSpecificFilterConfig*(uint32_t));
 
   testing::NiceMock<MockRouteEntry> route_entry_;
   testing::NiceMock<MockDecorator> decorator_;
@@ -4,6 +4,8 @@
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::An;
+using testing::Invoke;
 using testing::Return;
 using testing::ReturnArg;
 
@@ -14,7 +16,35 @@ MockRandomGenerator::MockRandomGenerator() { ON_CALL(*this, uuid()).WillByDefaul
 
 MockRandomGenerator::~MockRandomGenerator() = default;
 
-MockSnapshot::MockSnapshot() { ON_CALL(*this, getInteger(_, _)).WillByDefault(ReturnArg<1>()); }
+MockSnapshot::MockSnapshot() {
+  ON_CALL(*this, getInteger(An<const std::string&>(), _)).WillByDefault(ReturnArg<1>());
+
+  ON_CALL(*this, featureEnabled(An<const Key&>(), An<uint64_t>()))
+      .WillByDefault(Invoke([this](const Key& key, uint64_t default_value) -> bool {
+        return featureEnabled(key.name(), default_value);
+      }));
+  ON_CALL(*this, featureEnabled(An<const Key&>(), An<uint64_t>(), _))
+      .WillByDefault(
+          Invoke([this](const Key& key, uint64_t default_value, uint64_t random_value) -> bool {
+            return featureEnabled(key.name(), default_value, random_value);
+          }));
+  ON_CALL(*this, featureEnabled(An<const Key&>(), An<const envoy::type::FractionalPercent&>()))
+      .WillByDefault(Invoke(
+          [this](const Key& key, const envoy::type::FractionalPercent& default_value) -> bool {
+            return featureEnabled(key.name(), default_value);
+          }));
+  ON_CALL(*this,
+          featureEnabled(An<const Key&>(), An<const envoy::type::FractionalPercent&>(), _))
+      .WillByDefault(Invoke([this](const Key& key,
+                                   const envoy::type::FractionalPercent& default_value,
+                                   uint64_t random_value) -> bool {
+        return featureEnabled(key.name(), default_value, random_value);
+      }));
+  ON_CALL(*this, getInteger(An<const Key&>(), _))
+      .WillByDefault(Invoke([this](const Key& key, uint64_t default_value) -> uint64_t {
+        return getInteger(key.name(), default_value);
+      }));
+}
 
 MockSnapshot::~MockSnapshot() = default;
 
@@ -7,6 +7,8 @@
 #include "envoy/runtime/runtime.h"
 #include "envoy/upstream/cluster_manager.h"
 
+#include "common/runtime/runtime_keys.h"
+
 #include "gmock/gmock.h"
 
 namespace Envoy {
@@ -54,6 +56,17 @@ public:
                                           uint64_t random_value));
   MOCK_CONST_METHOD1(get, const std::string&(const std::string& key));
   MOCK_CONST_METHOD2(getInteger, uint64_t(const std::string& key, uint64_t default_value));
+  // The variants taking a registered key forward to those taking its name by default, so that
+  // expectations can be set on the names.
+  MOCK_CONST_METHOD2(featureEnabled, bool(const Key& key, uint64_t default_value));
+  MOCK_CONST_METHOD3(featureEnabled,
+                     bool(const Key& key, uint64_t default_value, uint64_t random_value));
+  MOCK_CONST_METHOD2(featureEnabled,
+                     bool(const Key& key, const envoy::type::FractionalPercent& default_value));
+  MOCK_CONST_METHOD3(featureEnabled,
+                     bool(const Key& key, const envoy::type::FractionalPercent& default_value,
+                          uint64_t random_value));
+  MOCK_CONST_METHOD2(getInteger, uint64_t(const Key& key, uint64_t default_value));
   MOCK_CONST_METHOD0(getLayers, const std::vector<OverrideLayerConstPtr>&());
 };
 
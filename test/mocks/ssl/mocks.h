@@ -29,6 +29,13 @@ public:
                                       const std::vector<std::string>& server_names));
   MOCK_CONST_METHOD0(daysUntilFirstCertExpires, size_t());
   MOCK_METHOD1(iterateContexts, void(std::function<void(const Context&)> callback));
+  MOCK_METHOD0(sessionCache, SessionCacheSharedPtr());
+  MOCK_METHOD4(preloadCertificates,
+               CertificatePreloadPtr(
+                   const std::vector<const envoy::api::v2::auth::TlsCertificate*>& tls_certificates,
+                   const std::vector<const envoy::api::v2::auth::CertificateValidationContext*>&
+                       validation_contexts,
+                   Api::Api& api, uint32_t max_threads));
 };
 
 class MockConnectionInfo : public ConnectionInfo {
@@ -79,12 +86,15 @@ public:
   MOCK_CONST_METHOD0(certificateValidationContext, const CertificateValidationContextConfig*());
   MOCK_CONST_METHOD0(minProtocolVersion, unsigned());
   MOCK_CONST_METHOD0(maxProtocolVersion, unsigned());
+  MOCK_CONST_METHOD0(kernelTlsOffload, bool());
+  MOCK_CONST_METHOD0(dynamicRecordSizing, const DynamicRecordSizing*());
   MOCK_CONST_METHOD0(isReady, bool());
   MOCK_METHOD1(setSecretUpdateCallback, void(std::function<void()> callback));
 
   MOCK_CONST_METHOD0(serverNameIndication, const std::string&());
   MOCK_CONST_METHOD0(allowRenegotiation, bool());
   MOCK_CONST_METHOD0(maxSessionKeys, size_t());
+  MOCK_CONST_METHOD0(sharedSessionCache, bool());
   MOCK_CONST_METHOD0(signingAlgorithmsForTest, const std::string&());
 };
 
@@ -101,11 +111,15 @@ public:
   MOCK_CONST_METHOD0(certificateValidationContext, const CertificateValidationContextConfig*());
   MOCK_CONST_METHOD0(minProtocolVersion, unsigned());
   MOCK_CONST_METHOD0(maxProtocolVersion, unsigned());
+  MOCK_CONST_METHOD0(kernelTlsOffload, bool());
+  MOCK_CONST_METHOD0(dynamicRecordSizing, const DynamicRecordSizing*());
   MOCK_CONST_METHOD0(isReady, bool());
   MOCK_METHOD1(setSecretUpdateCallback, void(std::function<void()> callback));
 
   MOCK_CONST_METHOD0(requireClientCertificate, bool());
   MOCK_CONST_METHOD0(sessionTicketKeys, const std::vector<SessionTicketKey>&());
+  MOCK_CONST_METHOD0(privateKeyOffloadPool, PrivateKeyOffloadPoolSharedPtr());
+  MOCK_CONST_METHOD0(sharedSessionCache, bool());
 };
 
 } // namespace Ssl
@@ -56,6 +56,8 @@ MockMetricSnapshot::MockMetricSnapshot() {
   ON_CALL(*this, counters()).WillByDefault(ReturnRef(counters_));
   ON_CALL(*this, gauges()).WillByDefault(ReturnRef(gauges_));
   ON_CALL(*this, histograms()).WillByDefault(ReturnRef(histograms_));
+  ON_CALL(*this, changedCounters()).WillByDefault(ReturnRef(changed_counters_));
+  ON_CALL(*this, changedGauges()).WillByDefault(ReturnRef(changed_gauges_));
 }
 
 MockMetricSnapshot::~MockMetricSnapshot() = default;
@@ -33,6 +33,7 @@ public:
   MOCK_CONST_METHOD1(successRate, double(DetectorHostMonitor::SuccessRateMonitorType type));
   MOCK_METHOD2(successRate,
                void(DetectorHostMonitor::SuccessRateMonitorType type, double new_success_rate));
+  MOCK_CONST_METHOD0(latency, double());
 };
 
 class MockEventLogger : public EventLogger {
@@ -61,6 +62,8 @@ public:
   MOCK_CONST_METHOD1(successRateAverage, double(DetectorHostMonitor::SuccessRateMonitorType));
   MOCK_CONST_METHOD1(successRateEjectionThreshold,
                      double(DetectorHostMonitor::SuccessRateMonitorType));
+  MOCK_CONST_METHOD0(latencyMedian, double());
+  MOCK_CONST_METHOD0(latencyEjectionThreshold, double());
 
   std::list<ChangeStateCb> callbacks_;
 };
@@ -121,10 +121,17 @@ MockLoadBalancer::~MockLoadBalancer() = default;
 MockThreadAwareLoadBalancer::MockThreadAwareLoadBalancer() = default;
 MockThreadAwareLoadBalancer::~MockThreadAwareLoadBalancer() = default;
 
+MockHedgeTracker::MockHedgeTracker() {
+  ON_CALL(*this, hedgeBudgetAvailable(_)).WillByDefault(Return(true));
+}
+
+MockHedgeTracker::~MockHedgeTracker() = default;
+
 MockThreadLocalCluster::MockThreadLocalCluster() {
   ON_CALL(*this, prioritySet()).WillByDefault(ReturnRef(cluster_.priority_set_));
   ON_CALL(*this, info()).WillByDefault(Return(cluster_.info_));
   ON_CALL(*this, loadBalancer()).WillByDefault(ReturnRef(lb_));
+  ON_CALL(*this, hedgeTracker()).WillByDefault(Return(hedge_tracker_));
 }
 
 MockThreadLocalCluster::~MockThreadLocalCluster() = default;
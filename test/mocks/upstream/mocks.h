@@ -225,6 +225,19 @@ public:
   MOCK_METHOD0(initialize, void());
 };
 
+class MockHedgeTracker : public HedgeTracker {
+public:
+  MockHedgeTracker();
+  ~MockHedgeTracker() override;
+
+  // Upstream::HedgeTracker
+  MOCK_METHOD1(recordResponseTime, void(std::chrono::microseconds response_time));
+  MOCK_METHOD1(responseTimePercentile,
+               absl::optional<std::chrono::microseconds>(double percentile));
+  MOCK_METHOD1(hedgeBudgetAvailable, bool(double budget_percent));
+  MOCK_METHOD0(onHedge, void());
+};
+
 class MockThreadLocalCluster : public ThreadLocalCluster {
 public:
   MockThreadLocalCluster();
@@ -234,9 +247,11 @@ public:
   MOCK_METHOD0(prioritySet, const PrioritySet&());
   MOCK_METHOD0(info, ClusterInfoConstSharedPtr());
   MOCK_METHOD0(loadBalancer, LoadBalancer&());
+  MOCK_METHOD0(hedgeTracker, HedgeTrackerSharedPtr());
 
   NiceMock<MockClusterMockPrioritySet> cluster_;
   NiceMock<MockLoadBalancer> lb_;
+  std::shared_ptr<NiceMock<MockHedgeTracker>> hedge_tracker_{new NiceMock<MockHedgeTracker>()};
 };
 
 class MockClusterManagerFactory : public ClusterManagerFactory {
@@ -246,6 +261,8 @@ public:
 
   Secret::MockSecretManager& secretManager() override { return secret_manager_; };
 
+  MOCK_METHOD0(dnsResolver, Network::DnsResolverSharedPtr());
+
   MOCK_METHOD1(clusterManagerFromProto,
                ClusterManagerPtr(const envoy::config::bootstrap::v2::Bootstrap& bootstrap));
 
@@ -328,6 +345,10 @@ public:
                ClusterUpdateCallbacksHandle*(ClusterUpdateCallbacks& callbacks));
   MOCK_CONST_METHOD0(warmingClusterCount, std::size_t());
   MOCK_METHOD0(subscriptionFactory, Config::SubscriptionFactory&());
+  MOCK_METHOD0(offloadThreads, OffloadThreads*());
+  MOCK_METHOD0(dnsResolver, Network::DnsResolverSharedPtr());
+  MOCK_METHOD1(initializeLazyCluster, bool(const std::string& cluster));
+  MOCK_METHOD0(lazyClusters, std::vector<std::string>());
 
   NiceMock<Http::ConnectionPool::MockInstance> conn_pool_;
   NiceMock<Http::MockAsyncClient> async_client_;
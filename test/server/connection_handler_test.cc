@@ -2,6 +2,7 @@
 
 #include "common/common/utility.h"
 #include "common/network/address_impl.h"
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/raw_buffer_socket.h"
 #include "common/network/utility.h"
 
@@ -52,11 +53,13 @@ public:
     Network::FilterChainFactory& filterChainFactory() override { return parent_.factory_; }
     Network::Socket& socket() override { return socket_; }
     const Network::Socket& socket() const override { return socket_; }
+    Network::Socket& workerSocket(uint32_t) override { return socket_; }
     bool bindToPort() override { return bind_to_port_; }
     bool handOffRestoredDestinationConnections() const override {
       return hand_off_restored_destination_connections_;
     }
     uint32_t perConnectionBufferLimitBytes() const override { return 0; }
+    uint32_t perConnectionReadBudgetBytes() const override { return read_budget_bytes_; }
     std::chrono::milliseconds listenerFiltersTimeout() const override {
       return listener_filters_timeout_;
     }
@@ -64,6 +67,7 @@ public:
       return continue_on_listener_filters_timeout_;
     }
     Stats::Scope& listenerScope() override { return parent_.stats_store_; }
+    Network::ConnectionBalancer& connectionBalancer() override { return *connection_balancer_; }
     uint64_t listenerTag() const override { return tag_; }
     const std::string& name() const override { return name_; }
 
@@ -75,6 +79,9 @@ public:
     const std::string name_;
     const std::chrono::milliseconds listener_filters_timeout_;
     const bool continue_on_listener_filters_timeout_;
+    uint32_t read_budget_bytes_{};
+    std::shared_ptr<Network::ConnectionBalancer> connection_balancer_{
+        std::make_shared<Network::NopConnectionBalancerImpl>()};
   };
 
   using TestListenerPtr = std::unique_ptr<TestListener>;
@@ -259,6 +266,189 @@ TEST_F(ConnectionHandlerTest, CloseConnectionOnEmptyFilterChain) {
   EXPECT_CALL(*listener, onDestroy());
 }
 
+TEST_F(ConnectionHandlerTest, ReadBudget) {
+  InSequence s;
+
+  Network::MockListener* listener = new Network::MockListener();
+  Network::ListenerCallbacks* listener_callbacks;
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  test_listener->read_budget_bytes_ = 65536;
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+          }));
+  EXPECT_CALL(test_listener->socket_, localAddress());
+  handler_->addListener(*test_listener);
+
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(filter_chain_.get()));
+  Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).WillOnce(Return(connection));
+  // The connection updates the listener's counters.
+  EXPECT_CALL(*connection, setReadBudget(65536, _))
+      .WillOnce(Invoke([](uint32_t, const Network::Connection::ReadBudgetStats& stats) {
+        stats.read_budget_yield_.inc();
+        stats.read_size_grow_.inc();
+        stats.read_size_shrink_.inc();
+      }));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillOnce(Return(true));
+  Network::MockConnectionSocket* accepted_socket = new NiceMock<Network::MockConnectionSocket>();
+  listener_callbacks->onAccept(Network::ConnectionSocketPtr{accepted_socket}, true);
+  EXPECT_EQ(1UL, handler_->numConnections());
+  EXPECT_EQ(1UL, stats_store_.counter("downstream_cx_read_budget_yield").value());
+  EXPECT_EQ(1UL, stats_store_.counter("downstream_cx_read_size_grow").value());
+  EXPECT_EQ(1UL, stats_store_.counter("downstream_cx_read_size_shrink").value());
+
+  EXPECT_CALL(*connection, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(dispatcher_, clearDeferredDeleteList());
+  EXPECT_CALL(*listener, onDestroy());
+  handler_.reset();
+}
+
+TEST_F(ConnectionHandlerTest, DisableConnectionReads) {
+  Network::MockListener* listener = new NiceMock<Network::MockListener>();
+  Network::ListenerCallbacks* listener_callbacks;
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+          }));
+  EXPECT_CALL(test_listener->socket_, localAddress());
+  handler_->addListener(*test_listener);
+
+  Network::MockConnection* connection1 = new NiceMock<Network::MockConnection>();
+  listener_callbacks->onNewConnection(Network::ConnectionPtr{connection1});
+
+  // Repeated calls are only passed once to the connection, as its calls are counted.
+  EXPECT_CALL(*connection1, readDisable(true));
+  handler_->disableConnectionReads();
+  handler_->disableConnectionReads();
+
+  // The connections accepted while reads are disabled start disabled.
+  Network::MockConnection* connection2 = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(*connection2, readDisable(true));
+  listener_callbacks->onNewConnection(Network::ConnectionPtr{connection2});
+
+  // A closing connection is left alone.
+  connection2->state_ = Network::Connection::State::Closing;
+  EXPECT_CALL(*connection1, readDisable(false));
+  EXPECT_CALL(*connection2, readDisable(false)).Times(0);
+  handler_->enableConnectionReads();
+  handler_->enableConnectionReads();
+
+  Network::MockConnection* connection3 = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(*connection3, readDisable(_)).Times(0);
+  listener_callbacks->onNewConnection(Network::ConnectionPtr{connection3});
+
+  EXPECT_CALL(dispatcher_, clearDeferredDeleteList());
+  EXPECT_CALL(*listener, onDestroy());
+  handler_.reset();
+}
+
+TEST_F(ConnectionHandlerTest, TopBufferedConnections) {
+  Network::MockListener* listener = new NiceMock<Network::MockListener>();
+  Network::ListenerCallbacks* listener_callbacks;
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+          }));
+  EXPECT_CALL(test_listener->socket_, localAddress());
+  handler_->addListener(*test_listener);
+
+  const std::vector<uint64_t> buffered_bytes{200, 0, 500, 100};
+  for (size_t i = 0; i < buffered_bytes.size(); i++) {
+    Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
+    ON_CALL(*connection, id()).WillByDefault(Return(i));
+    ON_CALL(*connection, bufferedBytes()).WillByDefault(Return(buffered_bytes[i]));
+    listener_callbacks->onNewConnection(Network::ConnectionPtr{connection});
+  }
+
+  std::vector<Network::BufferedConnection> connections = handler_->topBufferedConnections(2);
+  ASSERT_EQ(2, connections.size());
+  EXPECT_EQ(2, connections[0].id_);
+  EXPECT_EQ(500, connections[0].buffered_bytes_);
+  EXPECT_EQ("test_listener", connections[0].listener_name_);
+  EXPECT_EQ("10.0.0.3:50000", connections[0].remote_address_);
+  EXPECT_EQ(0, connections[1].id_);
+  EXPECT_EQ(200, connections[1].buffered_bytes_);
+
+  // The connections without buffered data are left out.
+  connections = handler_->topBufferedConnections(10);
+  ASSERT_EQ(3, connections.size());
+  EXPECT_EQ(3, connections[2].id_);
+  EXPECT_TRUE(handler_->topBufferedConnections(0).empty());
+
+  EXPECT_CALL(dispatcher_, clearDeferredDeleteList());
+  EXPECT_CALL(*listener, onDestroy());
+  handler_.reset();
+}
+
+// An exact balancer hands an accepted socket to the worker with the fewest connections.
+TEST_F(ConnectionHandlerTest, ExactConnectionBalancing) {
+  auto connection_balancer = std::make_shared<Network::ExactConnectionBalancerImpl>();
+  NiceMock<Event::MockDispatcher> dispatcher2;
+  Network::ConnectionHandlerPtr handler2(new ConnectionHandlerImpl(ENVOY_LOGGER(), dispatcher2, 1));
+
+  Network::MockListener* listener1 = new Network::MockListener();
+  Network::ListenerCallbacks* listener_callbacks1;
+  TestListener* test_listener1 = addListener(1, true, false, "test_listener");
+  test_listener1->connection_balancer_ = connection_balancer;
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks1 = &cb;
+            return listener1;
+          }));
+  EXPECT_CALL(test_listener1->socket_, localAddress());
+  handler_->addListener(*test_listener1);
+
+  Network::MockListener* listener2 = new Network::MockListener();
+  TestListener* test_listener2 = addListener(1, true, false, "test_listener");
+  test_listener2->connection_balancer_ = connection_balancer;
+  EXPECT_CALL(dispatcher2, createListener_(_, _, _, _)).WillOnce(Return(listener2));
+  EXPECT_CALL(test_listener2->socket_, localAddress());
+  handler2->addListener(*test_listener2);
+
+  // The first worker already has a connection.
+  Network::MockConnection* connection1 = new NiceMock<Network::MockConnection>();
+  listener_callbacks1->onNewConnection(Network::ConnectionPtr{connection1});
+  EXPECT_EQ(1UL, handler_->numConnections());
+
+  // So a socket it accepts is posted to the second worker.
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(filter_chain_.get()));
+  Network::MockConnection* connection2 = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(dispatcher_, post(_)).Times(0);
+  EXPECT_CALL(dispatcher2, post(_));
+  EXPECT_CALL(dispatcher2, createServerConnection_(_, _)).WillOnce(Return(connection2));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillOnce(Return(true));
+  listener_callbacks1->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, true);
+  EXPECT_EQ(1UL, handler_->numConnections());
+  EXPECT_EQ(1UL, handler2->numConnections());
+  EXPECT_EQ(1UL, stats_store_.counter("worker_0.downstream_cx_total").value());
+  EXPECT_EQ(1UL, stats_store_.gauge("worker_0.downstream_cx_active",
+                                    Stats::Gauge::ImportMode::Accumulate)
+                     .value());
+  EXPECT_EQ(1UL, stats_store_.counter("worker_1.downstream_cx_total").value());
+  EXPECT_EQ(1UL, stats_store_.gauge("worker_1.downstream_cx_active",
+                                    Stats::Gauge::ImportMode::Accumulate)
+                     .value());
+  EXPECT_EQ(2UL, stats_store_.counter("downstream_cx_total").value());
+
+  EXPECT_CALL(*connection2, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*listener2, onDestroy());
+  handler2.reset();
+  EXPECT_CALL(*connection1, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*listener1, onDestroy());
+  handler_.reset();
+}
+
 TEST_F(ConnectionHandlerTest, FindListenerByAddress) {
   TestListener* test_listener1 = addListener(1, true, true, "test_listener1");
   Network::Address::InstanceConstSharedPtr alt_address(
@@ -141,5 +141,34 @@ TEST_F(FilterChainManagerImplTest, AddSingleFilterChain) {
   auto* filter_chain = findFilterChainHelper(10000, "127.0.0.1", "", "tls", {}, "8.8.8.8", 111);
   EXPECT_NE(filter_chain, nullptr);
 }
+
+// The longest wildcard domain matching the server name wins, whatever the depth of the name.
+TEST_F(FilterChainManagerImplTest, WildcardServerNames) {
+  std::vector<envoy::api::v2::listener::FilterChain> filter_chains(3, filter_chain_template_);
+  filter_chains[0].mutable_filter_chain_match()->add_server_names("*.com");
+  filter_chains[1].mutable_filter_chain_match()->add_server_names("*.example.com");
+  filter_chains[2].mutable_filter_chain_match()->add_server_names("www.example.com");
+  filter_chain_manager_.addFilterChain(
+      std::vector<const envoy::api::v2::listener::FilterChain*>{
+          &filter_chains[0], &filter_chains[1], &filter_chains[2]},
+      filter_chain_factory_builder_);
+
+  auto find = [this](const std::string& server_name) {
+    return findFilterChainHelper(10000, "127.0.0.1", server_name, "tls", {}, "8.8.8.8", 111);
+  };
+  const auto* com = find("example.com");
+  const auto* example_com = find("a.b.c.example.com");
+  const auto* www_example_com = find("www.example.com");
+  ASSERT_NE(nullptr, com);
+  ASSERT_NE(nullptr, example_com);
+  ASSERT_NE(nullptr, www_example_com);
+  EXPECT_NE(com, example_com);
+  EXPECT_NE(example_com, www_example_com);
+  EXPECT_EQ(example_com, find("www2.example.com"));
+  EXPECT_EQ(com, find("www.example2.com"));
+  EXPECT_EQ(nullptr, find("example.org"));
+  EXPECT_EQ(nullptr, find(".com"));
+  EXPECT_EQ(nullptr, find("com."));
+}
 } // namespace Server
 } // namespace Envoy
\ No newline at end of file
@@ -220,6 +220,38 @@ TEST_P(GuardDogMissTest, MissTest) {
   unpet_dog = nullptr;
 }
 
+// A miss samples the stack of the stalled thread and the object tracked by its dispatcher.
+TEST_P(GuardDogMissTest, StallSampleTest) {
+  // The stalled for duration is only exact in simulated time.
+  if (GetParam() == TimeSystemType::Real) {
+    return;
+  }
+
+  initGuardDog(stats_store_, config_miss_);
+  Event::DispatcherPtr dispatcher = api_->allocateDispatcher();
+  auto unpet_dog = guard_dog_->createWatchDog(api_->threadFactory().currentThreadId());
+  unpet_dog->startWatchdog(*dispatcher);
+  MockScopedTrackedObject tracked_object;
+  dispatcher->setTrackedObject(&tracked_object);
+  time_system_->sleep(std::chrono::milliseconds(550));
+  guard_dog_->forceCheckForTest();
+  EXPECT_EQ(1UL, stats_store_.counter("server.watchdog_miss").value());
+  EXPECT_TRUE(guard_dog_->recentStalls().empty());
+
+  // The thread takes the sample as soon as it runs, and the next check collects it.
+  guard_dog_->forceCheckForTest();
+  const std::vector<StallReport> stalls = guard_dog_->recentStalls();
+  ASSERT_EQ(1, stalls.size());
+  EXPECT_EQ(api_->threadFactory().currentThreadId().debugString(), stalls[0].thread_id_);
+  EXPECT_EQ(std::chrono::milliseconds(550), stalls[0].stalled_for_);
+  EXPECT_THAT(stalls[0].tracked_object_, testing::HasSubstr("MockScopedTrackedObject"));
+  EXPECT_FALSE(stalls[0].frames_.empty());
+
+  dispatcher->setTrackedObject(nullptr);
+  guard_dog_->stopWatching(unpet_dog);
+  unpet_dog = nullptr;
+}
+
 TEST_P(GuardDogMissTest, MegaMissTest) {
   // TODO(#6464): This test fails in real-time 1/1000 times, but passes in simulated time.
   if (GetParam() == TimeSystemType::Real) {
@@ -0,0 +1,90 @@
+#include <string>
+
+#include "common/stats/fake_symbol_table_impl.h"
+#include "common/stats/symbol_table_impl.h"
+
+#include "server/hot_restart_stats_snapshot.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+class StatsSnapshotTest : public testing::Test {
+public:
+  std::string name(Stats::StatName stat_name) { return symbol_table_.toString(stat_name); }
+
+  Stats::FakeSymbolTableImpl symbol_table_;
+  Stats::StatNamePool pool_{symbol_table_};
+};
+
+TEST_F(StatsSnapshotTest, RoundTrip) {
+  StatsSnapshotEncoder encoder(symbol_table_);
+  encoder.addCounter(pool_.add("cluster.foo.upstream_rq_total"), 1);
+  encoder.addCounter(pool_.add("cluster.bar.upstream_rq_total"), 300);
+  encoder.addGauge(pool_.add("cluster.foo.upstream_cx_active"), 0);
+  encoder.addGauge(pool_.add("server.memory_allocated"), 1ULL << 40);
+  const std::string encoded = encoder.finish();
+
+  StatsSnapshot snapshot(symbol_table_);
+  ASSERT_TRUE(snapshot.decode(encoded));
+  ASSERT_EQ(2UL, snapshot.counterDeltas().size());
+  EXPECT_EQ("cluster.foo.upstream_rq_total", name(snapshot.counterDeltas()[0].first));
+  EXPECT_EQ(1UL, snapshot.counterDeltas()[0].second);
+  EXPECT_EQ("cluster.bar.upstream_rq_total", name(snapshot.counterDeltas()[1].first));
+  EXPECT_EQ(300UL, snapshot.counterDeltas()[1].second);
+  ASSERT_EQ(2UL, snapshot.gauges().size());
+  EXPECT_EQ("cluster.foo.upstream_cx_active", name(snapshot.gauges()[0].first));
+  EXPECT_EQ(0UL, snapshot.gauges()[0].second);
+  EXPECT_EQ("server.memory_allocated", name(snapshot.gauges()[1].first));
+  EXPECT_EQ(1ULL << 40, snapshot.gauges()[1].second);
+}
+
+TEST_F(StatsSnapshotTest, TokensWrittenOnce) {
+  StatsSnapshotEncoder encoder(symbol_table_);
+  encoder.addCounter(pool_.add("cluster.some_long_cluster_name.upstream_rq_total"), 1);
+  const size_t one_stat_size = encoder.finish().size();
+  encoder.addCounter(pool_.add("cluster.some_long_cluster_name.upstream_rq_total"), 1);
+  // The second stat only adds the indices of its tokens and its value.
+  EXPECT_EQ(one_stat_size + 5, encoder.finish().size());
+}
+
+TEST_F(StatsSnapshotTest, Empty) {
+  StatsSnapshotEncoder encoder(symbol_table_);
+  StatsSnapshot snapshot(symbol_table_);
+  ASSERT_TRUE(snapshot.decode(encoder.finish()));
+  EXPECT_TRUE(snapshot.counterDeltas().empty());
+  EXPECT_TRUE(snapshot.gauges().empty());
+}
+
+TEST_F(StatsSnapshotTest, Malformed) {
+  StatsSnapshotEncoder encoder(symbol_table_);
+  encoder.addCounter(pool_.add("a.b"), 1);
+  encoder.addGauge(pool_.add("a.c"), 2);
+  const std::string encoded = encoder.finish();
+
+  StatsSnapshot snapshot(symbol_table_);
+  // Any truncation of the snapshot is detected.
+  for (size_t size = 0; size < encoded.size(); ++size) {
+    EXPECT_FALSE(snapshot.decode(encoded.substr(0, size))) << size;
+    EXPECT_TRUE(snapshot.counterDeltas().empty());
+    EXPECT_TRUE(snapshot.gauges().empty());
+  }
+  EXPECT_FALSE(snapshot.decode(encoded + "x"));
+
+  // 3 symbols "a", "b", "c", 1 counter with 2 tokens 0 and 1, then the gauge.
+  ASSERT_EQ(std::string("\x03\x01" "a\x01" "b\x01" "c\x01\x02\x00\x01", 11),
+            encoded.substr(0, 11));
+  // A token index past the symbols.
+  std::string bad_index = encoded;
+  bad_index[10] = '\x03';
+  EXPECT_FALSE(snapshot.decode(bad_index));
+
+  EXPECT_TRUE(snapshot.decode(encoded));
+  EXPECT_EQ(1UL, snapshot.counterDeltas().size());
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
@@ -1,12 +1,20 @@
+#include <sys/mman.h>
+
 #include <memory>
 
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/utility.h"
+
+#include "server/hot_restart_stats_snapshot.h"
 #include "server/hot_restarting_parent.h"
 
+#include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
 
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
 
@@ -41,6 +49,41 @@ TEST_F(HotRestartingParentTest, getListenSocketsForChildNotFound) {
   EXPECT_EQ(-1, message.reply().pass_listen_socket().fd());
 }
 
+TEST_F(HotRestartingParentTest, getListenSocketsForChildWorkerIndex) {
+  MockListenerManager listener_manager;
+  Network::MockListenerConfig shared_listener;
+  Network::MockListenerConfig reuse_port_listener;
+  NiceMock<Network::MockListenSocket> worker_socket;
+  Network::IoSocketHandleImpl shared_handle(::socket(AF_INET, SOCK_STREAM, 0));
+  Network::IoSocketHandleImpl worker_handle(::socket(AF_INET, SOCK_STREAM, 0));
+  ON_CALL(testing::Const(shared_listener.socket_), ioHandle())
+      .WillByDefault(ReturnRef(shared_handle));
+  ON_CALL(testing::Const(worker_socket), ioHandle()).WillByDefault(ReturnRef(worker_handle));
+  shared_listener.socket_.local_address_ =
+      Network::Utility::parseInternetAddressAndPort("127.0.0.1:80");
+  reuse_port_listener.socket_.local_address_ =
+      Network::Utility::parseInternetAddressAndPort("127.0.0.1:81");
+  EXPECT_CALL(reuse_port_listener, workerSocket(1)).WillRepeatedly(ReturnRef(worker_socket));
+  std::vector<std::reference_wrapper<Network::ListenerConfig>> listeners{shared_listener,
+                                                                          reuse_port_listener};
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, listeners()).WillRepeatedly(Return(listeners));
+
+  HotRestartMessage::Request request;
+  request.mutable_pass_listen_socket()->set_address("tcp://127.0.0.1:80");
+  HotRestartMessage message = hot_restarting_parent_.getListenSocketsForChild(request);
+  EXPECT_EQ(shared_handle.fd(), message.reply().pass_listen_socket().fd());
+
+  // A socket shared by all workers is only passed once, for the first worker.
+  request.mutable_pass_listen_socket()->set_worker_index(1);
+  message = hot_restarting_parent_.getListenSocketsForChild(request);
+  EXPECT_EQ(-1, message.reply().pass_listen_socket().fd());
+
+  request.mutable_pass_listen_socket()->set_address("tcp://127.0.0.1:81");
+  message = hot_restarting_parent_.getListenSocketsForChild(request);
+  EXPECT_EQ(worker_handle.fd(), message.reply().pass_listen_socket().fd());
+}
+
 TEST_F(HotRestartingParentTest, exportStatsToChild) {
   Stats::IsolatedStoreImpl store;
   MockListenerManager listener_manager;
@@ -77,6 +120,57 @@ TEST_F(HotRestartingParentTest, exportStatsToChild) {
   }
 }
 
+TEST_F(HotRestartingParentTest, exportStatsSnapshotToChild) {
+  Stats::IsolatedStoreImpl store;
+  MockListenerManager listener_manager;
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(3));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(store));
+
+  store.counter("c1").inc();
+  store.counter("c2");
+  store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
+  HotRestartMessage::Reply::Stats stats;
+  ASSERT_TRUE(hot_restarting_parent_.exportStatsSnapshotToChild(&stats));
+  EXPECT_TRUE(stats.counter_deltas().empty());
+  EXPECT_TRUE(stats.gauges().empty());
+  EXPECT_EQ(3, stats.num_connections());
+
+  const int fd = stats.snapshot().fd();
+  const uint64_t size = stats.snapshot().size();
+  void* memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ASSERT_NE(MAP_FAILED, memory);
+  StatsSnapshot snapshot(store.symbolTable());
+  ASSERT_TRUE(snapshot.decode(absl::string_view(static_cast<const char*>(memory), size)));
+  munmap(memory, size);
+  close(fd);
+
+  // Counters which have not changed since their last export are left out.
+  ASSERT_EQ(1, snapshot.counterDeltas().size());
+  EXPECT_EQ("c1", store.symbolTable().toString(snapshot.counterDeltas()[0].first));
+  EXPECT_EQ(1, snapshot.counterDeltas()[0].second);
+  ASSERT_EQ(1, snapshot.gauges().size());
+  EXPECT_EQ("g1", store.symbolTable().toString(snapshot.gauges()[0].first));
+  EXPECT_EQ(123, snapshot.gauges()[0].second);
+  EXPECT_EQ(0, store.counter("c1").latch());
+}
+
+TEST_F(HotRestartingParentTest, exportTlsSessionsToChild) {
+  const Ssl::SessionCacheSharedPtr session_cache = server_.sslContextManager().sessionCache();
+  session_cache->store("a", {1});
+  session_cache->store("b", {2, 3});
+  EXPECT_FALSE(session_cache->lookup("a").empty());
+
+  HotRestartMessage::Reply::TlsSessions sessions;
+  hot_restarting_parent_.exportTlsSessionsToChild(&sessions);
+  ASSERT_EQ(2, sessions.sessions_size());
+  // The least recently used session first.
+  EXPECT_EQ("b", sessions.sessions(0).key());
+  EXPECT_EQ(std::string("\x02\x03"), sessions.sessions(0).session());
+  EXPECT_EQ("a", sessions.sessions(1).key());
+  EXPECT_EQ(std::string("\x01"), sessions.sessions(1).session());
+}
+
 TEST_F(HotRestartingParentTest, drainListeners) {
   EXPECT_CALL(server_, drainListeners());
   hot_restarting_parent_.drainListeners();
@@ -3,18 +3,22 @@
 #include <regex>
 #include <unordered_map>
 
+#include "envoy/admin/v2alpha/config_dump.pb.h"
 #include "envoy/admin/v2alpha/memory.pb.h"
 #include "envoy/admin/v2alpha/server_info.pb.h"
+#include "envoy/admin/v2alpha/stalls.pb.h"
 #include "envoy/json/json_object.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/stats.h"
 
 #include "common/http/message_impl.h"
 #include "common/json/json_loader.h"
+#include "common/memory/allocation_tracker.h"
 #include "common/profiler/profiler.h"
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
 #include "common/stats/thread_local_store.h"
+#include "common/upstream/upstream_impl.h"
 
 #include "server/http/admin.h"
 
@@ -39,6 +43,7 @@ using testing::HasSubstr;
 using testing::InSequence;
 using testing::Invoke;
 using testing::NiceMock;
+using testing::Not;
 using testing::Property;
 using testing::Ref;
 using testing::Return;
@@ -578,6 +583,67 @@ TEST_P(AdminFilterTest, Trailers) {
   EXPECT_EQ(Http::FilterTrailersStatus::StopIteration, filter_.decodeTrailers(request_headers_));
 }
 
+TEST_P(AdminFilterTest, StreamStats) {
+  for (size_t i = 0; i < 4000; i++) {
+    server_.stats_store_.counter(fmt::format("streamed.counter_{:04}", i)).inc();
+  }
+  server_.stats_store_.counter("other.counter").inc();
+
+  Http::TestHeaderMapImpl request_headers{{":path", "/stats?prefix=streamed."}};
+  Event::MockTimer* timer = new Event::MockTimer(&callbacks_.dispatcher_);
+  std::string body;
+  bool end_stream = false;
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  EXPECT_CALL(callbacks_, addDownstreamWatermarkCallbacks(Ref(filter_)));
+  EXPECT_CALL(callbacks_, encodeData(_, _))
+      .WillRepeatedly(Invoke([&body, &end_stream](Buffer::Instance& data, bool end) {
+        body += data.toString();
+        end_stream = end;
+      }));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.decodeHeaders(request_headers, true));
+
+  // The first chunk is written right away, the next one in a later event loop iteration.
+  EXPECT_GE(body.size(), StatsResponse::ChunkSize);
+  EXPECT_FALSE(end_stream);
+  EXPECT_TRUE(timer->enabled_);
+
+  // Nothing is written while the downstream is above its high watermark.
+  const size_t first_chunk_size = body.size();
+  filter_.onAboveWriteBufferHighWatermark();
+  timer->invokeCallback();
+  EXPECT_EQ(first_chunk_size, body.size());
+
+  filter_.onBelowWriteBufferLowWatermark();
+  EXPECT_TRUE(timer->enabled_);
+  EXPECT_CALL(callbacks_, removeDownstreamWatermarkCallbacks(Ref(filter_)));
+  timer->invokeCallback();
+  EXPECT_TRUE(end_stream);
+  EXPECT_FALSE(timer->enabled_);
+
+  EXPECT_TRUE(absl::StartsWith(body, "streamed.counter_0000: 1\n"));
+  EXPECT_TRUE(absl::EndsWith(body, "streamed.counter_3999: 1\n"));
+  EXPECT_EQ(4000, std::count(body.begin(), body.end(), '\n'));
+  EXPECT_THAT(body, Not(HasSubstr("other.counter")));
+}
+
+TEST_P(AdminFilterTest, StreamStatsStoppedOnDestroy) {
+  for (size_t i = 0; i < 4000; i++) {
+    server_.stats_store_.counter(fmt::format("streamed.counter_{:04}", i)).inc();
+  }
+
+  Http::TestHeaderMapImpl request_headers{{":path", "/stats"}};
+  Event::MockTimer* timer = new Event::MockTimer(&callbacks_.dispatcher_);
+  EXPECT_CALL(callbacks_, encodeData(_, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.decodeHeaders(request_headers, true));
+  EXPECT_TRUE(timer->enabled_);
+
+  EXPECT_CALL(callbacks_, removeDownstreamWatermarkCallbacks(Ref(filter_)));
+  filter_.onDestroy();
+  EXPECT_FALSE(timer->enabled_);
+}
+
 class AdminInstanceTest : public testing::TestWithParam<Network::Address::IpVersion> {
 public:
   AdminInstanceTest()
@@ -654,6 +720,38 @@ TEST_P(AdminInstanceTest, AdminCpuProfiler) {
   EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
 }
 
+TEST_P(AdminInstanceTest, AdminCpuProfilerWorkers) {
+  Buffer::OwnedImpl data;
+  Http::HeaderMapImpl header_map;
+
+#ifdef PROFILER_AVAILABLE
+  EXPECT_EQ(Http::Code::OK,
+            postCallback("/cpuprofiler?enable=y&threads=workers", header_map, data));
+  EXPECT_TRUE(Profiler::Cpu::profilerEnabled());
+#else
+  EXPECT_EQ(Http::Code::InternalServerError,
+            postCallback("/cpuprofiler?enable=y&threads=workers", header_map, data));
+  EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
+#endif
+
+  EXPECT_EQ(Http::Code::OK, postCallback("/cpuprofiler?enable=n", header_map, data));
+  EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
+}
+
+TEST_P(AdminInstanceTest, AdminCpuProfilerBadParams) {
+  Buffer::OwnedImpl data;
+  Http::HeaderMapImpl header_map;
+
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/cpuprofiler", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler?enable=y&threads=main", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler?threads=workers", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler?enable=y&threads=all&other=1", header_map, data));
+  EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
+}
+
 TEST_P(AdminInstanceTest, AdminHeapProfilerOnRepeatedRequest) {
   Buffer::OwnedImpl data;
   Http::HeaderMapImpl header_map;
@@ -881,6 +979,46 @@ TEST_P(AdminInstanceTest, ConfigDumpMaintainsOrder) {
   }
 }
 
+TEST_P(AdminInstanceTest, ConfigDumpResourceAndFormat) {
+  envoy::admin::v2alpha::ClustersConfigDump clusters;
+  clusters.add_dynamic_active_clusters()->mutable_cluster()->set_name("foo");
+  clusters.add_dynamic_active_clusters()->mutable_cluster()->set_name("bar");
+  auto entry = admin_.getConfigTracker().add("clusters", [&clusters] {
+    return std::make_unique<envoy::admin::v2alpha::ClustersConfigDump>(clusters);
+  });
+
+  {
+    Buffer::OwnedImpl response;
+    Http::HeaderMapImpl header_map;
+    EXPECT_EQ(Http::Code::OK,
+              getCallback("/config_dump?resource=dynamic_active_clusters&name_regex=^b",
+                          header_map, response));
+    envoy::admin::v2alpha::ConfigDump expected;
+    expected.add_configs()->PackFrom(clusters.dynamic_active_clusters(1));
+    EXPECT_EQ(MessageUtil::getJsonStringFromMessage(expected, true), response.toString());
+  }
+
+  {
+    Buffer::OwnedImpl response;
+    Http::HeaderMapImpl header_map;
+    EXPECT_EQ(Http::Code::OK, getCallback("/config_dump?format=proto", header_map, response));
+    EXPECT_EQ(Http::Headers::get().ContentTypeValues.Protobuf,
+              header_map.ContentType()->value().getStringView());
+    envoy::admin::v2alpha::ConfigDump dump;
+    ASSERT_TRUE(dump.ParseFromString(response.toString()));
+    envoy::admin::v2alpha::ConfigDump expected;
+    expected.add_configs()->PackFrom(clusters);
+    EXPECT_TRUE(TestUtility::protoEqual(expected, dump));
+  }
+
+  {
+    Buffer::OwnedImpl response;
+    Http::HeaderMapImpl header_map;
+    EXPECT_EQ(Http::Code::BadRequest,
+              getCallback("/config_dump?name_regex=[", header_map, response));
+  }
+}
+
 TEST_P(AdminInstanceTest, Memory) {
   Http::HeaderMapImpl header_map;
   Buffer::OwnedImpl response;
@@ -896,6 +1034,129 @@ TEST_P(AdminInstanceTest, Memory) {
                     Property(&envoy::admin::v2alpha::Memory::total_thread_cache, Ge(0))));
 }
 
+TEST_P(AdminInstanceTest, ConnectionsMemory) {
+  std::vector<Network::BufferedConnection> connections{{1, "listener_a", "10.0.0.1:1000", 300},
+                                                       {5, "listener_b", "10.0.0.2:2000", 100}};
+  EXPECT_CALL(server_.listener_manager_, topBufferedConnections(10)).WillOnce(Return(connections));
+  Http::HeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::OK, getCallback("/memory/connections", header_map, response));
+  envoy::admin::v2alpha::ConnectionsMemory output_proto;
+  TestUtility::loadFromJson(response.toString(), output_proto);
+  ASSERT_EQ(2, output_proto.connections_size());
+  EXPECT_EQ(1, output_proto.connections(0).id());
+  EXPECT_EQ("listener_a", output_proto.connections(0).listener());
+  EXPECT_EQ("10.0.0.1:1000", output_proto.connections(0).remote_address());
+  EXPECT_EQ(300, output_proto.connections(0).buffered_bytes());
+  EXPECT_EQ(5, output_proto.connections(1).id());
+  EXPECT_EQ(100, output_proto.connections(1).buffered_bytes());
+
+  EXPECT_CALL(server_.listener_manager_, topBufferedConnections(1))
+      .WillOnce(Return(std::vector<Network::BufferedConnection>{}));
+  response.drain(response.length());
+  EXPECT_EQ(Http::Code::OK, getCallback("/memory/connections?limit=1", header_map, response));
+
+  response.drain(response.length());
+  EXPECT_EQ(Http::Code::BadRequest,
+            getCallback("/memory/connections?limit=many", header_map, response));
+}
+
+TEST_P(AdminInstanceTest, HostMemory) {
+  Http::HeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::OK, getCallback("/memory/hosts", header_map, response));
+  envoy::admin::v2alpha::HostMemory output_proto;
+  TestUtility::loadFromJson(response.toString(), output_proto);
+  EXPECT_EQ(sizeof(Upstream::HostImpl), output_proto.host_bytes());
+  EXPECT_EQ(sizeof(Upstream::HostStatsBlock), output_proto.stats_bytes());
+  EXPECT_LE(output_proto.hosts_with_stats(), output_proto.hosts());
+}
+
+TEST_P(AdminInstanceTest, AllocationTracker) {
+  Buffer::OwnedImpl data;
+  Http::HeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/allocationtracker?enable=x", header_map, data));
+#ifdef TCMALLOC
+  EXPECT_EQ(Http::Code::OK, postCallback("/allocationtracker?enable=y", header_map, data));
+  EXPECT_TRUE(Memory::AllocationTracker::enabled());
+#else
+  EXPECT_EQ(Http::Code::NotImplemented,
+            postCallback("/allocationtracker?enable=y", header_map, data));
+#endif
+
+  Memory::AllocationCounts counts;
+  counts.allocations_ = 3;
+  counts.bytes_ = 96;
+  Memory::AllocationTracker::record("admin_test", counts);
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::OK, getCallback("/memory/allocations", header_map, response));
+  envoy::admin::v2alpha::AllocationsMemory output_proto;
+  TestUtility::loadFromJson(response.toString(), output_proto);
+  EXPECT_EQ(Memory::AllocationTracker::enabled(), output_proto.enabled());
+  bool found = false;
+  for (const auto& subsystem : output_proto.subsystems()) {
+    if (subsystem.name() == "admin_test") {
+      found = true;
+      EXPECT_EQ(1, subsystem.requests());
+      EXPECT_EQ(3, subsystem.allocations());
+      EXPECT_EQ(96, subsystem.allocated_bytes());
+    }
+  }
+  EXPECT_TRUE(found);
+
+  EXPECT_EQ(Http::Code::OK, postCallback("/allocationtracker?enable=n", header_map, data));
+  EXPECT_FALSE(Memory::AllocationTracker::enabled());
+}
+
+TEST_P(AdminInstanceTest, StatsMemory) {
+  server_.stats_store_.counter("memory.counter").inc();
+  server_.stats_store_.gauge("memory.gauge", Stats::Gauge::ImportMode::Accumulate).set(1);
+  Http::HeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::OK, getCallback("/memory/stats", header_map, response));
+  envoy::admin::v2alpha::StatsMemory output_proto;
+  TestUtility::loadFromJson(response.toString(), output_proto);
+  EXPECT_EQ(server_.stats_store_.counters().size(), output_proto.counters().stats());
+  EXPECT_EQ(server_.stats_store_.gauges().size(), output_proto.gauges().stats());
+  EXPECT_LT(0, output_proto.counters().name_bytes());
+  EXPECT_LT(0, output_proto.symbols());
+  // The isolated store does not extract tags, so the tag-extracted names are the names, and are
+  // not stored separately.
+  EXPECT_EQ(0, output_proto.counters().tag_extracted_name_bytes());
+  EXPECT_EQ(0, output_proto.counters().tag_bytes());
+  EXPECT_EQ(output_proto.counters().stats(), output_proto.counters().unique_tag_extracted_names());
+}
+
+TEST_P(AdminInstanceTest, Stalls) {
+  Http::HeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  // No stalls until the guard dog is started.
+  EXPECT_EQ(Http::Code::OK, getCallback("/stalls", header_map, response));
+  envoy::admin::v2alpha::Stalls output_proto;
+  TestUtility::loadFromJson(response.toString(), output_proto);
+  EXPECT_EQ(0, output_proto.stalls_size());
+
+  MockGuardDog guard_dog;
+  StallReport report;
+  report.thread_id_ = "1234";
+  report.time_ = SystemTime(std::chrono::seconds(1));
+  report.stalled_for_ = std::chrono::milliseconds(250);
+  report.tracked_object_ = "Envoy::Http::ConnectionManagerImpl::ActiveStream";
+  report.frames_ = {"foo() [0x1]", "[0x2]"};
+  EXPECT_CALL(server_, guardDog()).WillRepeatedly(Return(&guard_dog));
+  EXPECT_CALL(guard_dog, recentStalls()).WillOnce(Return(std::vector<StallReport>{report}));
+  response.drain(response.length());
+  EXPECT_EQ(Http::Code::OK, getCallback("/stalls", header_map, response));
+  TestUtility::loadFromJson(response.toString(), output_proto);
+  ASSERT_EQ(1, output_proto.stalls_size());
+  const envoy::admin::v2alpha::Stall& stall = output_proto.stalls(0);
+  EXPECT_EQ("1234", stall.thread_id());
+  EXPECT_EQ(1, stall.time().seconds());
+  EXPECT_EQ(250, Protobuf::util::TimeUtil::DurationToMilliseconds(stall.stalled_for()));
+  EXPECT_EQ("Envoy::Http::ConnectionManagerImpl::ActiveStream", stall.tracked_object());
+  EXPECT_THAT(stall.frames(), testing::ElementsAre("foo() [0x1]", "[0x2]"));
+}
+
 TEST_P(AdminInstanceTest, ContextThatReturnsNullCertDetails) {
   Http::HeaderMapImpl header_map;
   Buffer::OwnedImpl response;
@@ -1338,6 +1599,36 @@ TEST_P(AdminInstanceTest, GetRequestJson) {
               HasSubstr("application/json"));
 }
 
+TEST_P(AdminInstanceTest, GetRequestStatsPrefix) {
+  server_.stats_store_.counter("foo.requests").add(3);
+  server_.stats_store_.gauge("foo.active", Stats::Gauge::ImportMode::Accumulate).set(2);
+  server_.stats_store_.counter("bar.requests").inc();
+
+  {
+    Http::HeaderMapImpl response_headers;
+    std::string body;
+    EXPECT_EQ(Http::Code::OK, admin_.request("/stats?prefix=foo.", "GET", response_headers, body));
+    EXPECT_EQ("foo.active: 2\nfoo.requests: 3\n", body);
+  }
+
+  {
+    Http::HeaderMapImpl response_headers;
+    std::string body;
+    EXPECT_EQ(Http::Code::OK,
+              admin_.request("/stats/prometheus?prefix=foo.", "GET", response_headers, body));
+    EXPECT_THAT(body, HasSubstr("envoy_foo_requests{} 3\n"));
+    EXPECT_THAT(body, HasSubstr("envoy_foo_active{} 2\n"));
+    EXPECT_THAT(body, Not(HasSubstr("bar")));
+  }
+
+  Http::HeaderMapImpl response_headers;
+  std::string body;
+  EXPECT_EQ(Http::Code::OK,
+            admin_.request("/stats?format=json&prefix=foo.", "GET", response_headers, body));
+  EXPECT_THAT(body, HasSubstr("foo.requests"));
+  EXPECT_THAT(body, Not(HasSubstr("bar.requests")));
+}
+
 TEST_P(AdminInstanceTest, PostRequest) {
   Http::HeaderMapImpl response_headers;
   std::string body;
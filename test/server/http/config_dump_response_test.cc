@@ -0,0 +1,131 @@
+#include <string>
+
+#include "envoy/admin/v2alpha/config_dump.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/protobuf/utility.h"
+
+#include "server/http/config_dump_response.h"
+#include "server/http/config_tracker_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+class ConfigDumpResponseTest : public testing::Test {
+protected:
+  ConfigDumpResponseTest() {
+    clusters_.set_version_info("1");
+    clusters_.add_static_clusters()->mutable_cluster()->set_name("static");
+    for (const std::string name : {"foo", "bar", "baz"}) {
+      auto* cluster = clusters_.add_dynamic_active_clusters();
+      cluster->set_version_info("2");
+      cluster->mutable_cluster()->set_name(name);
+    }
+    clusters_entry_ = tracker_.add("clusters", [this] {
+      return std::make_unique<envoy::admin::v2alpha::ClustersConfigDump>(clusters_);
+    });
+    string_entry_ = tracker_.add("string", [] {
+      auto msg = std::make_unique<ProtobufWkt::StringValue>();
+      msg->set_value("bar");
+      return msg;
+    });
+  }
+
+  // Drains a response, returning its body and the number of chunks it took.
+  std::pair<std::string, uint32_t> drain(ConfigDumpResponse& response) {
+    Buffer::OwnedImpl body;
+    uint32_t chunks = 1;
+    while (response.nextChunk(body)) {
+      chunks++;
+    }
+    return {body.toString(), chunks};
+  }
+
+  std::string dumpJson(ConfigDumpResponse::Format format, const std::string& resource = "",
+                       const absl::optional<std::regex>& name_regex = absl::nullopt) {
+    ConfigDumpResponse response(tracker_, format, resource, name_regex);
+    return drain(response).first;
+  }
+
+  envoy::admin::v2alpha::ConfigDump expectedDump() {
+    envoy::admin::v2alpha::ConfigDump dump;
+    dump.add_configs()->PackFrom(clusters_);
+    ProtobufWkt::StringValue string;
+    string.set_value("bar");
+    dump.add_configs()->PackFrom(string);
+    return dump;
+  }
+
+  envoy::admin::v2alpha::ClustersConfigDump clusters_;
+  ConfigTrackerImpl tracker_;
+  ConfigTracker::EntryOwnerPtr clusters_entry_;
+  ConfigTracker::EntryOwnerPtr string_entry_;
+};
+
+// The resources streamed one at a time read as the whole dump did.
+TEST_F(ConfigDumpResponseTest, Json) {
+  EXPECT_EQ(MessageUtil::getJsonStringFromMessage(expectedDump(), true),
+            dumpJson(ConfigDumpResponse::Format::Json));
+}
+
+TEST_F(ConfigDumpResponseTest, Proto) {
+  envoy::admin::v2alpha::ConfigDump dump;
+  ASSERT_TRUE(dump.ParseFromString(dumpJson(ConfigDumpResponse::Format::Proto)));
+  EXPECT_TRUE(TestUtility::protoEqual(expectedDump(), dump));
+}
+
+TEST_F(ConfigDumpResponseTest, Empty) {
+  string_entry_.reset();
+  ConfigDumpResponse response(tracker_, ConfigDumpResponse::Format::Json, "", absl::nullopt);
+  // A config removed before the response reaches it is skipped.
+  clusters_entry_.reset();
+  EXPECT_EQ(MessageUtil::getJsonStringFromMessage(envoy::admin::v2alpha::ConfigDump(), true),
+            drain(response).first);
+}
+
+TEST_F(ConfigDumpResponseTest, NameRegex) {
+  clusters_.mutable_static_clusters()->Clear();
+  envoy::admin::v2alpha::ConfigDump expected = expectedDump();
+  clusters_.mutable_dynamic_active_clusters()->DeleteSubrange(1, 2);
+  expected.mutable_configs(0)->PackFrom(clusters_);
+
+  EXPECT_EQ(MessageUtil::getJsonStringFromMessage(expected, true),
+            dumpJson(ConfigDumpResponse::Format::Json, "", std::regex("^f")));
+}
+
+// Each resource of a field is a config of its own, and the configs without the field are left
+// out.
+TEST_F(ConfigDumpResponseTest, Resource) {
+  envoy::admin::v2alpha::ConfigDump expected;
+  expected.add_configs()->PackFrom(clusters_.dynamic_active_clusters(1));
+  expected.add_configs()->PackFrom(clusters_.dynamic_active_clusters(2));
+
+  EXPECT_EQ(MessageUtil::getJsonStringFromMessage(expected, true),
+            dumpJson(ConfigDumpResponse::Format::Json, "dynamic_active_clusters",
+                     std::regex("^ba")));
+
+  envoy::admin::v2alpha::ConfigDump dump;
+  ASSERT_TRUE(dump.ParseFromString(dumpJson(ConfigDumpResponse::Format::Proto,
+                                            "dynamic_active_clusters", std::regex("^ba"))));
+  EXPECT_TRUE(TestUtility::protoEqual(expected, dump));
+}
+
+TEST_F(ConfigDumpResponseTest, Chunks) {
+  for (uint32_t i = 0; i < 1000; i++) {
+    auto* cluster = clusters_.add_dynamic_warming_clusters();
+    cluster->mutable_cluster()->set_name(std::string(100, 'a') + std::to_string(i));
+  }
+  ConfigDumpResponse response(tracker_, ConfigDumpResponse::Format::Json, "", absl::nullopt);
+  const auto body_and_chunks = drain(response);
+  EXPECT_EQ(MessageUtil::getJsonStringFromMessage(expectedDump(), true), body_and_chunks.first);
+  EXPECT_LT(1, body_and_chunks.second);
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
@@ -2,6 +2,7 @@
 
 #include "envoy/api/v2/lds.pb.h"
 
+#include "common/api/api_impl.h"
 #include "common/protobuf/utility.h"
 
 #include "server/lds_api.h"
@@ -37,7 +38,7 @@ public:
     envoy::api::v2::core::ConfigSource lds_config;
     EXPECT_CALL(init_manager_, add(_));
     lds_ = std::make_unique<LdsApiImpl>(lds_config, cluster_manager_, init_manager_, store_,
-                                        listener_manager_, validation_visitor_);
+                                        listener_manager_, validation_visitor_, *api_);
     EXPECT_CALL(*cluster_manager_.subscription_factory_.subscription_, start(_));
     init_target_handle_->initialize(init_watcher_);
     lds_callbacks_ = cluster_manager_.subscription_factory_.callbacks_;
@@ -89,6 +90,7 @@ public:
   Init::ExpectableWatcherImpl init_watcher_;
   Init::TargetHandlePtr init_target_handle_;
   Stats::IsolatedStoreImpl store_;
+  Api::ApiPtr api_{Api::createApiForTest(store_)};
   MockListenerManager listener_manager_;
   Config::SubscriptionCallbacks* lds_callbacks_{};
   std::unique_ptr<LdsApiImpl> lds_;
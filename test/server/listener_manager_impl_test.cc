@@ -11,6 +11,7 @@
 #include "common/api/os_sys_calls_impl.h"
 #include "common/config/metadata.h"
 #include "common/network/address_impl.h"
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/io_socket_handle_impl.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/network/socket_option_impl.h"
@@ -34,6 +35,7 @@
 
 #include "absl/strings/escaping.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_replace.h"
 #include "gtest/gtest.h"
 
 using testing::_;
@@ -1151,6 +1153,28 @@ filter_chains:
                EnvoyException);
 }
 
+TEST_F(ListenerManagerImplTest, TopBufferedConnections) {
+  // The workers are only asked once they run.
+  EXPECT_CALL(*worker_, topBufferedConnections(_, _)).Times(0);
+  EXPECT_TRUE(manager_->topBufferedConnections(2).empty());
+
+  EXPECT_CALL(*worker_, start(_));
+  manager_->startWorkers(guard_dog_);
+
+  EXPECT_CALL(*worker_, topBufferedConnections(2, _))
+      .WillOnce(Invoke([](uint32_t, Worker::BufferedConnectionsCompletion completion) -> void {
+        completion({{1, "foo", "10.0.0.1:1000", 100},
+                    {2, "foo", "10.0.0.2:1000", 300},
+                    {3, "bar", "10.0.0.3:1000", 200}});
+      }));
+  const std::vector<Network::BufferedConnection> connections = manager_->topBufferedConnections(2);
+  ASSERT_EQ(2, connections.size());
+  EXPECT_EQ(2, connections[0].id_);
+  EXPECT_EQ(300, connections[0].buffered_bytes_);
+  EXPECT_EQ(3, connections[1].id_);
+  EXPECT_EQ("bar", connections[1].listener_name_);
+}
+
 TEST_F(ListenerManagerImplTest, ListenerDraining) {
   InSequence s;
 
@@ -2110,6 +2134,66 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, MultipleFilterChainsWithServerNam
   EXPECT_EQ(server_names.front(), "*.example.com");
 }
 
+// Updating a listener only builds the transport sockets of the filter chains whose transport
+// socket configuration changed.
+TEST_F(ListenerManagerImplWithRealFiltersTest, UpdateReusesUnchangedTransportSockets) {
+  const std::string yaml = R"EOF(
+    name: foo
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 1234 }
+    listener_filters:
+    - name: "envoy.listener.tls_inspector"
+      config: {}
+    filter_chains:
+    - filter_chain_match:
+        server_names: "server1.example.com"
+      tls_context:
+        common_tls_context:
+          tls_certificates:
+            - certificate_chain: { filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem" }
+              private_key: { filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_key.pem" }
+    - filter_chain_match:
+        server_names: "*.com"
+      tls_context:
+        common_tls_context:
+          tls_certificates:
+            - certificate_chain: { filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_multiple_dns_cert.pem" }
+              private_key: { filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_multiple_dns_key.pem" }
+  )EOF";
+
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, true));
+  manager_->addOrUpdateListener(
+      parseListenerFromV2Yaml(TestEnvironment::substitute(yaml, Network::Address::IpVersion::v4)),
+      "", true);
+  const Network::TransportSocketFactory* exact_factory =
+      &findFilterChain(1234, "127.0.0.1", "server1.example.com", "tls", {}, "127.0.0.1", 111)
+           ->transportSocketFactory();
+
+  // Only the certificate of the wildcard filter chain changes.
+  const std::string updated_yaml = absl::StrReplaceAll(
+      yaml, {{"san_multiple_dns_cert.pem", "san_uri_cert.pem"},
+             {"san_multiple_dns_key.pem", "san_uri_key.pem"}});
+  EXPECT_TRUE(manager_->addOrUpdateListener(
+      parseListenerFromV2Yaml(
+          TestEnvironment::substitute(updated_yaml, Network::Address::IpVersion::v4)),
+      "", true));
+  EXPECT_EQ(1U, manager_->listeners().size());
+  EXPECT_EQ(1UL, server_.stats_store_.counter("listener_manager.transport_socket_factory_reused")
+                     .value());
+
+  auto filter_chain =
+      findFilterChain(1234, "127.0.0.1", "server1.example.com", "tls", {}, "127.0.0.1", 111);
+  ASSERT_NE(filter_chain, nullptr);
+  EXPECT_EQ(exact_factory, &filter_chain->transportSocketFactory());
+
+  filter_chain = findFilterChain(1234, "127.0.0.1", "www.example.com", "tls", {}, "127.0.0.1", 111);
+  ASSERT_NE(filter_chain, nullptr);
+  auto transport_socket = filter_chain->transportSocketFactory().createTransportSocket(nullptr);
+  auto ssl_socket =
+      dynamic_cast<Extensions::TransportSockets::Tls::SslSocket*>(transport_socket.get());
+  EXPECT_EQ("spiffe://lyft.com/test-team", ssl_socket->uriSanLocalCertificate()[0]);
+}
+
 TEST_F(ListenerManagerImplWithRealFiltersTest, MultipleFilterChainsWithTransportProtocolMatch) {
   const std::string yaml = TestEnvironment::substitute(R"EOF(
     address:
@@ -2960,6 +3044,77 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, FastOpenListenerEnabled) {
                    ENVOY_SOCKET_TCP_FASTOPEN, /* expected_value */ 1);
 }
 
+// Validate that a reuse_port listener gets its sockets from createReusePortListenSocket(), one
+// per worker, with SO_REUSEPORT applied before bind().
+TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortListenerEnabled) {
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  auto listener = createIPv4Listener("ReusePortListener");
+  listener.mutable_reuse_port();
+
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, _)).Times(0);
+  EXPECT_CALL(listener_factory_,
+              createReusePortListenSocket(_, Network::Address::SocketType::Stream, _, 0))
+      .WillOnce(Invoke([this](Network::Address::InstanceConstSharedPtr,
+                              Network::Address::SocketType,
+                              const Network::Socket::OptionsSharedPtr& options,
+                              uint32_t) -> Network::SocketSharedPtr {
+        EXPECT_EQ(1U, options->size());
+        EXPECT_TRUE(Network::Socket::applyOptions(
+            options, *listener_factory_.socket_, envoy::api::v2::core::SocketOption::STATE_PREBIND));
+        return listener_factory_.socket_;
+      }));
+  expectSetsockopt(os_sys_calls, ENVOY_SOCKET_SO_REUSEPORT.level(),
+                   ENVOY_SOCKET_SO_REUSEPORT.option(), /* expected_value */ 1);
+  manager_->addOrUpdateListener(listener, "", true);
+  EXPECT_EQ(1U, manager_->listeners().size());
+  EXPECT_EQ(listener_factory_.socket_.get(), &manager_->listeners()[0].get().workerSocket(0));
+}
+
+TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortRequiresBoundIpAddress) {
+  auto listener = createIPv4Listener("ReusePortListener");
+  listener.mutable_reuse_port();
+  listener.mutable_deprecated_v1()->mutable_bind_to_port()->set_value(false);
+
+  EXPECT_THROW_WITH_MESSAGE(
+      manager_->addOrUpdateListener(listener, "", true), EnvoyException,
+      "error adding listener '127.0.0.1:1111': reuse_port requires a bound IP address");
+  EXPECT_EQ(0U, manager_->listeners().size());
+}
+
+// Turning reuse_port on or off changes how the listen sockets are created, so it cannot be done
+// by an update that shares the existing sockets.
+TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortChangeRejected) {
+  auto listener = createIPv4Listener("ReusePortListener");
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, true));
+  manager_->addOrUpdateListener(listener, "", true);
+  EXPECT_EQ(1U, manager_->listeners().size());
+
+  listener.mutable_reuse_port();
+  EXPECT_THROW_WITH_MESSAGE(manager_->addOrUpdateListener(listener, "", true), EnvoyException,
+                            "error updating listener: 'ReusePortListener' has a different "
+                            "reuse_port from existing listener");
+  EXPECT_EQ(1U, manager_->listeners().size());
+}
+
+TEST_F(ListenerManagerImplWithRealFiltersTest, ExactConnectionBalancer) {
+  auto listener = createIPv4Listener("BalancedListener");
+  listener.mutable_connection_balance_config()->mutable_exact_balance();
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, true));
+  manager_->addOrUpdateListener(listener, "", true);
+  EXPECT_EQ(1U, manager_->listeners().size());
+  EXPECT_NE(nullptr, dynamic_cast<Network::ExactConnectionBalancerImpl*>(
+                         &manager_->listeners()[0].get().connectionBalancer()));
+}
+
+TEST_F(ListenerManagerImplWithRealFiltersTest, NoConnectionBalancer) {
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, true));
+  manager_->addOrUpdateListener(createIPv4Listener("Listener"), "", true);
+  EXPECT_EQ(1U, manager_->listeners().size());
+  EXPECT_NE(nullptr, dynamic_cast<Network::NopConnectionBalancerImpl*>(
+                         &manager_->listeners()[0].get().connectionBalancer()));
+}
+
 TEST_F(ListenerManagerImplWithRealFiltersTest, LiteralSockoptListenerEnabled) {
   NiceMock<Api::MockOsSysCalls> os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
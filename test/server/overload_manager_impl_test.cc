@@ -210,6 +210,36 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   manager->stop();
 }
 
+TEST_F(OverloadManagerImplTest, ThreadLocalCallbacks) {
+  setDispatcherExpectation();
+
+  auto manager(createOverloadManager(getConfig()));
+  manager->start();
+
+  // Thread local callbacks can be added once the manager started.
+  std::vector<OverloadActionState> states;
+  Common::CallbackHandle* handle = manager->getThreadLocalOverloadState().addActionCallback(
+      "envoy.overload_actions.dummy_action",
+      [&](OverloadActionState state) { states.push_back(state); });
+
+  factory1_.monitor_->setPressure(0.95);
+  timer_cb_();
+  factory1_.monitor_->setPressure(0.94);
+  timer_cb_();
+  factory1_.monitor_->setPressure(0.5);
+  timer_cb_();
+  const std::vector<OverloadActionState> expected_states{OverloadActionState::Active,
+                                                         OverloadActionState::Inactive};
+  EXPECT_EQ(expected_states, states);
+
+  handle->remove();
+  factory1_.monitor_->setPressure(0.95);
+  timer_cb_();
+  EXPECT_EQ(2, states.size());
+
+  manager->stop();
+}
+
 TEST_F(OverloadManagerImplTest, FailedUpdates) {
   setDispatcherExpectation();
   auto manager(createOverloadManager(getConfig()));
@@ -78,6 +78,41 @@ TEST(ServerInstanceUtil, flushHelper) {
   InstanceUtil::flushMetricsToSinks(sinks, mock_store);
 }
 
+TEST(ServerInstanceUtil, flushChangedMetrics) {
+  InSequence s;
+
+  Stats::IsolatedStoreImpl store;
+  Stats::Counter& changed_counter = store.counter("changed_counter");
+  store.counter("unchanged_counter").inc();
+  Stats::Gauge& changed_gauge = store.gauge("changed_gauge", Stats::Gauge::ImportMode::Accumulate);
+  store.gauge("unchanged_gauge", Stats::Gauge::ImportMode::Accumulate).set(5);
+
+  std::list<Stats::SinkPtr> sinks;
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+
+  Stats::MockSink* sink = new StrictMock<Stats::MockSink>();
+  sinks.emplace_back(sink);
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_EQ(snapshot.counters().size(), 2);
+    ASSERT_EQ(snapshot.changedCounters().size(), 1);
+    EXPECT_EQ(snapshot.changedCounters()[0].counter_.get().name(), "changed_counter");
+    EXPECT_EQ(snapshot.changedCounters()[0].delta_, 2);
+
+    EXPECT_EQ(snapshot.gauges().size(), 2);
+    ASSERT_EQ(snapshot.changedGauges().size(), 1);
+    EXPECT_EQ(snapshot.changedGauges()[0].get().name(), "changed_gauge");
+  }));
+  changed_counter.add(2);
+  changed_gauge.set(3);
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_TRUE(snapshot.changedCounters().empty());
+    EXPECT_TRUE(snapshot.changedGauges().empty());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+}
+
 class RunHelperTest : public testing::Test {
 public:
   RunHelperTest() {
@@ -269,6 +304,7 @@ public:
 
   // Stats::Sink
   void flush(Stats::MetricSnapshot&) override { stats_flushed_.inc(); }
+  bool flushesOnAnyThread() const override { return false; }
 
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
 
@@ -0,0 +1,61 @@
+#include <memory>
+#include <thread>
+
+#include "common/api/api_impl.h"
+#include "common/thread_local/thread_local_impl.h"
+
+#include "server/stats_flush_thread.h"
+
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/synchronization/notification.h"
+#include "gtest/gtest.h"
+
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Ref;
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+// The sinks flush on the thread, which is busy until they are done.
+TEST(StatsFlushThreadTest, FlushesOnThread) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr main_dispatcher = api->allocateDispatcher();
+  ThreadLocal::InstanceImpl tls;
+  tls.registerThread(*main_dispatcher, true);
+  StatsFlushThread flush_thread(*api, tls);
+
+  NiceMock<Stats::MockSink> sink;
+  auto snapshot = std::make_shared<NiceMock<Stats::MockMetricSnapshot>>();
+  absl::Notification started;
+  absl::Notification release;
+  std::thread::id flush_thread_id;
+  EXPECT_CALL(sink, flush(Ref(*snapshot))).WillOnce(Invoke([&](Stats::MetricSnapshot&) -> void {
+    flush_thread_id = std::this_thread::get_id();
+    started.Notify();
+    release.WaitForNotification();
+  }));
+
+  EXPECT_FALSE(flush_thread.busy());
+  flush_thread.flush(snapshot, {sink});
+  started.WaitForNotification();
+  EXPECT_TRUE(flush_thread.busy());
+  EXPECT_NE(std::this_thread::get_id(), flush_thread_id);
+  release.Notify();
+  while (flush_thread.busy()) {
+    std::this_thread::yield();
+  }
+  // The thread released the snapshot before it was done.
+  EXPECT_EQ(1, snapshot.use_count());
+
+  tls.shutdownGlobalThreading();
+  flush_thread.stop();
+  tls.shutdownThread();
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
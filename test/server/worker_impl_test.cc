@@ -133,6 +133,28 @@ TEST_F(WorkerImplTest, BasicFlow) {
   worker_.stop();
 }
 
+TEST_F(WorkerImplTest, TopBufferedConnections) {
+  std::thread::id current_thread_id = std::this_thread::get_id();
+  ConditionalInitializer ci;
+
+  worker_.start(guard_dog_);
+  EXPECT_CALL(*handler_, topBufferedConnections(5))
+      .WillOnce(Invoke([current_thread_id](uint32_t) -> std::vector<Network::BufferedConnection> {
+        EXPECT_NE(current_thread_id, std::this_thread::get_id());
+        return {{1, "listener", "10.0.0.1:1000", 100}};
+      }));
+  worker_.topBufferedConnections(
+      5, [current_thread_id, &ci](std::vector<Network::BufferedConnection>&& connections) -> void {
+        EXPECT_NE(current_thread_id, std::this_thread::get_id());
+        ASSERT_EQ(1, connections.size());
+        EXPECT_EQ(100, connections[0].buffered_bytes_);
+        ci.setReady();
+      });
+  ci.waitReady();
+
+  worker_.stop();
+}
+
 TEST_F(WorkerImplTest, ListenerException) {
   InSequence s;
 
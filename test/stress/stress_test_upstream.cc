@@ -567,11 +567,14 @@ Network::Socket& Server::socket() { return listening_socket_; }
 
 const Network::Socket& Server::socket() const { return listening_socket_; }
 
+Network::Socket& Server::workerSocket(uint32_t) { return listening_socket_; }
+
 bool Server::bindToPort() { return true; }
 
 bool Server::handOffRestoredDestinationConnections() const { return false; }
 
 uint32_t Server::perConnectionBufferLimitBytes() const { return connection_buffer_limit_bytes_; }
+uint32_t Server::perConnectionReadBudgetBytes() const { return 0; }
 
 std::chrono::milliseconds Server::listenerFiltersTimeout() const {
   return std::chrono::milliseconds(0);
@@ -581,6 +584,8 @@ bool Server::continueOnListenerFiltersTimeout() const { return false; }
 
 Stats::Scope& Server::listenerScope() { return stats_; }
 
+Network::ConnectionBalancer& Server::connectionBalancer() { return connection_balancer_; }
+
 uint64_t Server::listenerTag() const { return 0; }
 
 const std::string& Server::name() const { return name_; }
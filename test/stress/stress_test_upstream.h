@@ -4,6 +4,7 @@
 #include "common/common/thread.h"
 #include "common/grpc/common.h"
 #include "common/http/codec_client.h"
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/stats/isolated_store_impl.h"
 
@@ -286,12 +287,14 @@ public:
   Network::Socket& socket() override;
 
   const Network::Socket& socket() const override;
+  Network::Socket& workerSocket(uint32_t worker_index) override;
 
   bool bindToPort() override;
 
   bool handOffRestoredDestinationConnections() const override;
 
   uint32_t perConnectionBufferLimitBytes() const override;
+  uint32_t perConnectionReadBudgetBytes() const override;
 
   std::chrono::milliseconds listenerFiltersTimeout() const override;
 
@@ -299,6 +302,8 @@ public:
 
   Stats::Scope& listenerScope() override;
 
+  Network::ConnectionBalancer& connectionBalancer() override;
+
   uint64_t listenerTag() const override;
 
   const std::string& name() const override;
@@ -324,6 +329,7 @@ public:
 private:
   std::string name_;
   Stats::IsolatedStoreImpl stats_;
+  Network::NopConnectionBalancerImpl connection_balancer_;
   Event::TestRealTimeSystem time_system_;
   Api::Impl api_;
   Event::DispatcherPtr dispatcher_;
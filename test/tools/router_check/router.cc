@@ -84,7 +84,8 @@ RouterCheckTool::RouterCheckTool(
     : factory_context_(std::move(factory_context)), config_(std::move(config)),
       stats_(std::move(stats)), api_(std::move(api)), coverage_(std::move(coverage)) {
   ON_CALL(factory_context_->runtime_loader_.snapshot_,
-          featureEnabled(_, testing::An<const envoy::type::FractionalPercent&>(),
+          featureEnabled(testing::An<const std::string&>(),
+                         testing::An<const envoy::type::FractionalPercent&>(),
                          testing::An<uint64_t>()))
       .WillByDefault(testing::Invoke(this, &RouterCheckTool::runtimeMock));
 }
@@ -151,6 +151,7 @@ UNOWNED_EXTENSIONS = {
   "extensions/tracers/common/ot",
   "extensions/resource_monitors/injected_resource",
   "extensions/resource_monitors/fixed_heap",
+  "extensions/resource_monitors/wasm",
   "extensions/resource_monitors/common",
   "extensions/retry/priority",
   "extensions/retry/priority/previous_priorities",